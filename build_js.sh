@@ -9,11 +9,20 @@ set -e
 
 BULLET=false
 WEB_APPS=true
+THREADS=false
+SIMD=false
 
 while [[ "$#" -gt 0 ]]; do
     case $1 in
         --bullet) BULLET=true ;;
         --no-web-apps) WEB_APPS=false ;;
+        # Navmesh building, asset prefetching and decoding on worker threads.
+        # Needs a browser with SharedArrayBuffer, i.e. a page served with the
+        # Cross-Origin-Opener-Policy: same-origin and
+        # Cross-Origin-Embedder-Policy: require-corp headers.
+        --threads) THREADS=true ;;
+        # WebAssembly SIMD for the batched geometry math
+        --simd) SIMD=true ;;
         *) echo "Unknown parameter passed: $1"; exit 1 ;;
     esac
     shift
@@ -34,7 +43,18 @@ mkdir -p build_js
 cd build_js
 
 
+# C sources of the dependencies need the same threading and SIMD flags, or
+# linking with shared memory fails
+C_FLAGS=""
 EXE_LINKER_FLAGS="-s USE_WEBGL2=1"
+if ${THREADS} ; then
+    C_FLAGS="${C_FLAGS} -pthread"
+    EXE_LINKER_FLAGS="${EXE_LINKER_FLAGS} -pthread -s PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"
+fi
+if ${SIMD} ; then
+    C_FLAGS="${C_FLAGS} -msimd128"
+fi
+CXX_FLAGS="-s FORCE_FILESYSTEM=1 -s ALLOW_MEMORY_GROWTH=1 -s ASSERTIONS=0${C_FLAGS}"
 cmake ../src \
     -DCORRADE_RC_EXECUTABLE=../build_corrade-rc/RelWithDebInfo/bin/corrade-rc \
     -DBUILD_GUI_VIEWERS="$( if ${WEB_APPS} ; then echo ON ; else echo OFF; fi )" \
@@ -46,7 +66,8 @@ cmake ../src \
     -DCMAKE_TOOLCHAIN_FILE="../src/deps/corrade/toolchains/generic/Emscripten-wasm.cmake" \
     -DCMAKE_INSTALL_PREFIX="." \
     -DCMAKE_INTERPROCEDURAL_OPTIMIZATION=ON \
-    -DCMAKE_CXX_FLAGS="-s FORCE_FILESYSTEM=1 -s ALLOW_MEMORY_GROWTH=1 -s ASSERTIONS=0" \
+    -DCMAKE_C_FLAGS="${C_FLAGS}" \
+    -DCMAKE_CXX_FLAGS="${CXX_FLAGS}" \
     -DCMAKE_EXE_LINKER_FLAGS="${EXE_LINKER_FLAGS}" \
     -DBUILD_WITH_BULLET="$( if ${BULLET} ; then echo ON ; else echo OFF; fi )" \
     -DBUILD_WEB_APPS="$( if ${WEB_APPS} ; then echo ON ; else echo OFF; fi )"
@@ -61,6 +82,9 @@ if [ -o ${WEB_APPS} ]
     echo "python2 -m SimpleHTTPServer 8000"
     echo "Or:"
     echo "python3 -m http.server"
+    if ${THREADS} ; then
+      echo "The --threads build needs a server sending the COOP/COEP headers."
+    fi
     echo "Then open in a browser:"
     echo "http://0.0.0.0:8000/build_js/esp/bindings_js/bindings.html?scene=skokloster-castle.glb"
 fi
@@ -6,7 +6,9 @@ r"""
 Simple example showing how to overlap physics and rendering in Habitat-Sim.  The general
 pattern is to call sim.start_async_render_and_step_physics instead of sim.step_physics for
 the *first* step_physics call and then retrieve observations using sim.get_sensor_observations_async_finish
-instead of sim.get_sensor_observations
+instead of sim.get_sensor_observations.  The poses of the drawables and sensors are
+captured when the render starts, so physics is free to move them while it is drawn on the
+background thread.
 
 
 Known limitations/issues:
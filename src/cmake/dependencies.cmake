@@ -156,6 +156,9 @@ if(BUILD_WITH_BULLET AND NOT USE_SYSTEM_BULLET)
   set(BUILD_CLSOCKET OFF CACHE BOOL "" FORCE)
   set(BUILD_EXTRAS OFF CACHE BOOL "" FORCE)
   set(BUILD_BULLET3 OFF CACHE BOOL "" FORCE)
+  # Makes Bullet's internals thread-safe and its default task scheduler
+  # available, which BulletPhysicsManager uses for parallel collision dispatch
+  set(BULLET2_MULTITHREADING ${BUILD_WITH_BULLET_MULTITHREADING} CACHE BOOL "" FORCE)
   # This is needed in case BUILD_EXTRAS is enabled, as you'd get a CMake syntax
   # error otherwise
   set(PKGCONFIG_INSTALL_PREFIX "lib${LIB_SUFFIX}/pkgconfig/")
@@ -187,6 +190,11 @@ if(BUILD_WITH_BULLET AND NOT USE_SYSTEM_BULLET)
   # that causes rigid objects to never come to rest.
   # This needs to be further examined on bullet side
   add_definitions(-DBT_DISABLE_CONVEX_CONCAVE_EARLY_OUT=1)
+  # Bullet's built-in profiler records into a single global tree unless built
+  # with BULLET2_MULTITHREADING, which would break stepping independent worlds
+  # on multiple threads (see esp::physics::MultiWorldStepper). The profiler
+  # isn't used anywhere, so disable it altogether.
+  add_definitions(-DBT_NO_PROFILE=1)
   add_subdirectory(${DEPS_DIR}/bullet3 EXCLUDE_FROM_ALL)
   set(CMAKE_CXX_FLAGS ${_PREV_CMAKE_CXX_FLAGS})
 endif()
@@ -263,6 +271,8 @@ if(NOT USE_SYSTEM_MAGNUM)
     # ImageConverter tool for basis
     set(MAGNUM_WITH_IMAGECONVERTER ON CACHE BOOL "" FORCE)
     set(MAGNUM_WITH_BASISIMAGECONVERTER ON CACHE BOOL "" FORCE)
+    # Writing precooked assets with the Datatool
+    set(MAGNUM_WITH_GLTFSCENECONVERTER ON CACHE BOOL "" FORCE)
   endif()
 
   # OpenEXR. Use a system package, if preferred.
@@ -7,6 +7,8 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include <iterator>
+
 #include "esp/scene/ObjectControls.h"
 #include "esp/sensor/Sensor.h"
 
@@ -32,24 +34,53 @@ Agent::~Agent() {
 
 bool Agent::act(const std::string& actionName) {
   if (hasAction(actionName)) {
-    const ActionSpec& actionSpec = *configuration_.actionSpace.at(actionName);
-    if (BodyActions.find(actionSpec.name) != BodyActions.end()) {
-      controls_->action(object(), actionSpec.name,
-                        actionSpec.actuation.at("amount"),
-                        /*applyFilter=*/true);
-    } else {
-      for (const auto& p : node().getNodeSensors()) {
-        controls_->action(p.second.get().object(), actionSpec.name,
-                          actionSpec.actuation.at("amount"),
-                          /*applyFilter=*/false);
-      }
-    }
+    applyAction(*configuration_.actionSpace.at(actionName));
     return true;
   } else {
     return false;
   }
 }
 
+bool Agent::act(const int actionIndex) {
+  const ActionSpec::ptr actionSpec = getActionSpec(actionIndex);
+  if (!actionSpec) {
+    return false;
+  }
+  applyAction(*actionSpec);
+  return true;
+}
+
+std::vector<std::string> Agent::getActionNames() const {
+  std::vector<std::string> names;
+  names.reserve(configuration_.actionSpace.size());
+  for (const auto& action : configuration_.actionSpace) {
+    names.push_back(action.first);
+  }
+  return names;
+}
+
+ActionSpec::ptr Agent::getActionSpec(const int actionIndex) const {
+  const ActionSpace& actionSpace = configuration_.actionSpace;
+  if (actionIndex < 0 || actionIndex >= int(actionSpace.size())) {
+    return nullptr;
+  }
+  return std::next(actionSpace.begin(), actionIndex)->second;
+}
+
+void Agent::applyAction(const ActionSpec& actionSpec) {
+  if (BodyActions.find(actionSpec.name) != BodyActions.end()) {
+    controls_->action(object(), actionSpec.name,
+                      actionSpec.actuation.at("amount"),
+                      /*applyFilter=*/true);
+  } else {
+    for (const auto& p : node().getNodeSensors()) {
+      controls_->action(p.second.get().object(), actionSpec.name,
+                        actionSpec.actuation.at("amount"),
+                        /*applyFilter=*/false);
+    }
+  }
+}
+
 bool Agent::hasAction(const std::string& actionName) const {
   auto actionSpace = configuration_.actionSpace;
   return !(actionSpace.find(actionName) == actionSpace.end());
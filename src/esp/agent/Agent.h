@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
@@ -178,6 +179,26 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
    */
   bool act(const std::string& actionName);
 
+  /**
+   * @brief Perform an action by index, see @ref getActionNames().
+   * @param actionIndex the index of the action to perform
+   * @return Whether the action index is valid for the agent
+   */
+  bool act(int actionIndex);
+
+  /**
+   * @brief Names of the actions in the agent's @ref ActionSpace, in the order
+   * of the indices taken by @ref act(int) and @ref
+   * esp::sim::Simulator::actAgents()
+   */
+  std::vector<std::string> getActionNames() const;
+
+  /**
+   * @brief The action with index @p actionIndex, see @ref getActionNames().
+   * @return The action, or nullptr if the index is out of range
+   */
+  ActionSpec::ptr getActionSpec(int actionIndex) const;
+
   /**
    * @brief Verify whether the named action is available to the agent.
    * @param actionName the name of the action to perform
@@ -260,6 +281,11 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
   static const std::set<std::string> BodyActions;
 
  private:
+  /**
+   * @brief Apply @p actionSpec to the body or the sensors of the agent.
+   */
+  void applyAction(const ActionSpec& actionSpec);
+
   /**
    * @brief The configuration of this agent.
    */
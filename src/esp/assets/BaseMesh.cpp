@@ -18,6 +18,22 @@ namespace Mn = Magnum;
 namespace esp {
 namespace assets {
 
+core::MemoryUsage BaseMesh::getMemoryUsage() const {
+  core::MemoryUsage usage;
+  if (meshData_) {
+    const std::size_t size =
+        meshData_->vertexData().size() + meshData_->indexData().size();
+    // data mapped from a SharedMemoryAssetStore isn't held by this process
+    if (meshData_->vertexDataFlags() & Mn::Trade::DataFlag::Owned) {
+      usage.cpuBytes = size;
+    }
+    if (buffersOnGPU_) {
+      usage.gpuBytes = size;
+    }
+  }
+  return usage;
+}
+
 bool BaseMesh::setMeshType(SupportedMeshType type) {
   if (type < SupportedMeshType::NOT_DEFINED ||
       type >= SupportedMeshType::NUM_SUPPORTED_MESH_TYPES) {
@@ -51,7 +67,7 @@ void BaseMesh::convertMeshColors(
 
 void BaseMesh::buildColorMapToUse(
     Cr::Containers::Array<Magnum::UnsignedInt>& vertIDs,
-    const Cr::Containers::Array<Mn::Color3ub>& vertColors,
+    Cr::Containers::ArrayView<const Mn::Color3ub> vertColors,
     bool useVertexColors,
     std::vector<Mn::Vector3ub>& colorMapToUse) const {
   colorMapToUse.clear();
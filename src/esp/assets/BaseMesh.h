@@ -12,11 +12,13 @@
 
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/GL.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/Trade/MeshData.h>
 #include "CollisionMeshData.h"
 #include "MeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/core/MemoryUsage.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -134,6 +136,32 @@ class BaseMesh {
     return collisionMeshData_;
   }
 
+  /**
+   * @brief Transformation from the positions of the render data to the
+   * original mesh positions.
+   *
+   * Identity unless the render data were quantized, see
+   * @ref GenericMeshData::quantizeForRendering(). The collision data and
+   * @ref BB always use the original positions.
+   */
+  const Magnum::Matrix4& getPositionDequantization() const {
+    return positionDequantization_;
+  }
+
+  /**
+   * @brief Estimated memory of the render data, on the CPU and once uploaded
+   * with @ref uploadBuffersToGPU() also on the GPU.
+   *
+   * For @ref BaseMesh the size of @ref meshData_.
+   */
+  virtual core::MemoryUsage getMemoryUsage() const;
+
+  /**
+   * @brief Estimated CPU memory of the geometry copied for @ref
+   * collisionMeshData_, 0 if it references the render data.
+   */
+  virtual std::size_t getCollisionMemoryUsage() const { return 0; }
+
   /**
    * @brief Axis aligned bounding box of the mesh.
    *
@@ -155,7 +183,7 @@ class BaseMesh {
    */
   void buildColorMapToUse(
       Corrade::Containers::Array<Magnum::UnsignedInt>& vertIDs,
-      const Cr::Containers::Array<Mn::Color3ub>& vertColors,
+      Cr::Containers::ArrayView<const Mn::Color3ub> vertColors,
       bool useVertexColors,
       std::vector<Mn::Vector3ub>& colorMapToUse) const;
 
@@ -191,6 +219,12 @@ class BaseMesh {
    */
   Corrade::Containers::Optional<Magnum::Trade::MeshData> meshData_ =
       Corrade::Containers::NullOpt;
+
+  /**
+   * @brief Transformation restoring the original positions from the ones in
+   * @ref meshData_. See @ref getPositionDequantization().
+   */
+  Magnum::Matrix4 positionDequantization_;
   // ==== non-rendering ===
   /**
    * @brief Stores references to mesh geometry and topology for use in CPU side
@@ -36,9 +36,10 @@ struct CollisionMeshData {
    * Bullet requires positions to be stored in a contiguous array, but MeshData
    * usually doesn't store them like that (and moreover the data might be
    * packed to smaller type). Thus the data are unpacked into a contiguous
-   * array which is then referenced here.
+   * array which is then referenced here. The array may be mapped read-only
+   * from a @ref SharedMemoryAssetStore.
    */
-  Corrade::Containers::ArrayView<Magnum::Vector3> positions;
+  Corrade::Containers::ArrayView<const Magnum::Vector3> positions;
 
   /**
    * @brief Reference to vertex indices.
@@ -48,7 +49,7 @@ struct CollisionMeshData {
    * the data are unpacked to an internal data store and this view references
    * that instead.
    */
-  Corrade::Containers::ArrayView<Magnum::UnsignedInt> indices;
+  Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices;
 };
 
 }  // namespace assets
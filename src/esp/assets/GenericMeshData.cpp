@@ -6,9 +6,13 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Interleave.h>
+
+#include "esp/gfx_batch/MeshQuantization.h"
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -53,6 +57,8 @@ void GenericMeshData::setMeshData(Magnum::Trade::MeshData&& meshData) {
    * incorrectly calculated */
 
   meshData_ = Mn::MeshTools::interleave(std::move(meshData));
+  renderOnlyDataReleased_ = false;
+  sharedCollisionData_ = nullptr;
 
   collisionMeshData_.primitive = meshData_->primitive();
 
@@ -80,6 +86,99 @@ void GenericMeshData::setMeshData(Magnum::Trade::MeshData&& meshData) {
   }
 }  // setMeshData
 
+void GenericMeshData::releaseRenderOnlyData() {
+  CORRADE_ASSERT(!buffersOnGPU_,
+                 "GenericMeshData::releaseRenderOnlyData(): the mesh is "
+                 "already uploaded to the GPU", );
+  if (!meshData_) {
+    return;
+  }
+
+  Cr::Containers::Array<char> indexData{
+      Cr::NoInit, collisionMeshData_.indices.size() * sizeof(Mn::UnsignedInt)};
+  const Cr::Containers::ArrayView<Mn::UnsignedInt> indices =
+      Cr::Containers::arrayCast<Mn::UnsignedInt>(indexData);
+  Cr::Utility::copy(collisionMeshData_.indices, indices);
+
+  Cr::Containers::Array<char> vertexData{
+      Cr::NoInit, collisionMeshData_.positions.size() * sizeof(Mn::Vector3)};
+  const Cr::Containers::ArrayView<Mn::Vector3> positions =
+      Cr::Containers::arrayCast<Mn::Vector3>(vertexData);
+  Cr::Utility::copy(collisionMeshData_.positions, positions);
+
+  const Mn::Trade::MeshIndexData indexView{indices};
+  const Mn::Trade::MeshAttributeData positionView{
+      Mn::Trade::MeshAttribute::Position, positions};
+  meshData_ = Mn::Trade::MeshData{meshData_->primitive(), std::move(indexData),
+                                  indexView, std::move(vertexData),
+                                  {positionView}};
+
+  // the collision data now references the new mesh data directly
+  collisionMeshData_.positions = positions;
+  collisionMeshData_.indices = indices;
+  positionData_ = nullptr;
+  indexData_ = nullptr;
+  renderOnlyDataReleased_ = true;
+  sharedCollisionData_ = nullptr;
+}  // releaseRenderOnlyData
+
+void GenericMeshData::shareCollisionData(
+    std::shared_ptr<const void> storage,
+    Cr::Containers::ArrayView<const Mn::Vector3> positions,
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> indices) {
+  CORRADE_ASSERT(positions.size() == collisionMeshData_.positions.size() &&
+                     indices.size() == collisionMeshData_.indices.size(),
+                 "GenericMeshData::shareCollisionData(): expected"
+                     << collisionMeshData_.positions.size() << "positions and"
+                     << collisionMeshData_.indices.size() << "indices, got"
+                     << positions.size() << "and" << indices.size(), );
+
+  // the mesh data is nothing but the collision data, reference the shared
+  // copy instead of holding one
+  if (renderOnlyDataReleased_ && meshData_) {
+    meshData_ = Mn::Trade::MeshData{
+        meshData_->primitive(),
+        Mn::Trade::DataFlags{},
+        indices,
+        Mn::Trade::MeshIndexData{indices},
+        Mn::Trade::DataFlags{},
+        positions,
+        Cr::Containers::Array<Mn::Trade::MeshAttributeData>{
+            Cr::InPlaceInit,
+            {Mn::Trade::MeshAttributeData{Mn::Trade::MeshAttribute::Position,
+                                          positions}}}};
+  }
+
+  collisionMeshData_.positions = positions;
+  collisionMeshData_.indices = indices;
+  positionData_ = nullptr;
+  indexData_ = nullptr;
+  sharedCollisionData_ = std::move(storage);
+}  // shareCollisionData
+
+void GenericMeshData::quantizeForRendering() {
+  CORRADE_ASSERT(!buffersOnGPU_,
+                 "GenericMeshData::quantizeForRendering(): the mesh is "
+                 "already uploaded to the GPU", );
+  if (!meshData_) {
+    return;
+  }
+
+  // the collision indices may reference the mesh data, keep a copy
+  if (indexData_.isEmpty()) {
+    indexData_ = Cr::Containers::Array<Mn::UnsignedInt>{
+        Cr::NoInit, collisionMeshData_.indices.size()};
+    Cr::Utility::copy(collisionMeshData_.indices, indexData_);
+    collisionMeshData_.indices = indexData_;
+  }
+  // already quantized data are returned unchanged with an identity
+  // transformation, so calling this twice is harmless
+  Mn::Matrix4 dequantization;
+  meshData_ = gfx_batch::quantizeMesh(*std::move(meshData_), dequantization);
+  renderOnlyDataReleased_ = false;
+  positionDequantization_ = positionDequantization_ * dequantization;
+}  // quantizeForRendering
+
 void GenericMeshData::importAndSetMeshData(
     Magnum::Trade::AbstractImporter& importer,
     int meshID) {
@@ -83,6 +83,45 @@ class GenericMeshData : public BaseMesh {
   void importAndSetMeshData(Magnum::Trade::AbstractImporter& importer,
                             const std::string& meshName);
 
+  /**
+   * @brief Drop every vertex attribute except positions and keep the indices
+   * as @ref Magnum::MeshIndexType::UnsignedInt, so the mesh data only holds
+   * what @ref collisionMeshData_ references.
+   *
+   * Used when no renderer is created, where normals, texture coordinates,
+   * colors and the likes are never read. Can't be called once the buffers
+   * are on the GPU.
+   */
+  void releaseRenderOnlyData();
+
+  /**
+   * @brief Pack the vertex attributes of the render data into 16-bit formats
+   * with @ref gfx_batch::quantizeMesh().
+   *
+   * The transformation restoring the original positions is available through
+   * @ref getPositionDequantization(), drawables of the mesh have to apply it.
+   * The collision data keep the original positions. Can't be called once the
+   * buffers are on the GPU.
+   */
+  void quantizeForRendering();
+
+  /**
+   * @brief Make the collision data reference positions and indices held by
+   * someone else
+   * @param storage    Kept alive for as long as the mesh references it
+   * @param positions  The same positions as the current collision data
+   * @param indices    The same indices as the current collision data
+   *
+   * Frees the positions and indices unpacked for the collision data. After
+   * @ref releaseRenderOnlyData() the mesh data references @p positions and
+   * @p indices as well. Used by
+   * @ref SharedMemoryAssetStore::shareCollisionMeshes().
+   */
+  void shareCollisionData(
+      std::shared_ptr<const void> storage,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+      Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices);
+
   /**
    * @brief Returns a pointer to the compiled render data storage structure.
    * @return Pointer to the @ref renderingBuffer_.
@@ -98,6 +137,15 @@ class GenericMeshData : public BaseMesh {
    */
   Magnum::GL::Mesh* getMagnumGLMesh() override;
 
+  /**
+   * @brief Estimated CPU memory of the positions and indices unpacked for
+   * the collision data
+   */
+  std::size_t getCollisionMemoryUsage() const override {
+    return positionData_.size() * sizeof(Magnum::Vector3) +
+           indexData_.size() * sizeof(Magnum::UnsignedInt);
+  }
+
  protected:
   /**
    * @brief Storage structure for compiled render data. We will use a smart
@@ -116,6 +164,13 @@ class GenericMeshData : public BaseMesh {
      MeshData doesn't have them in desired type */
   Corrade::Containers::Array<Magnum::Vector3> positionData_;
   Corrade::Containers::Array<Magnum::UnsignedInt> indexData_;
+
+  /* Whether meshData_ holds only what collisionMeshData_ references, see
+     releaseRenderOnlyData() */
+  bool renderOnlyDataReleased_ = false;
+
+  /* Keeps the data passed to shareCollisionData() alive */
+  std::shared_ptr<const void> sharedCollisionData_;
 };
 }  // namespace assets
 }  // namespace esp
@@ -4,21 +4,34 @@
 
 #include "GenericSemanticMeshData.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
 #include <set>
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/DebugTools/ColorMap.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/PackingBatch.h>
 #include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/MeshTools/RemoveDuplicates.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Shaders/GenericGL.h>
 
+#include "esp/core/AtomicFile.h"
+#include "esp/core/ParallelFor.h"
 #include "esp/geo/Geo.h"
 #include "esp/scene/SemanticScene.h"
 
@@ -34,7 +47,8 @@ GenericSemanticMeshData::buildSemanticMeshData(
     const std::string& semanticFilename,
     std::vector<Mn::Vector3ub>& colorMapToUse,
     bool convertToSRGB,
-    const std::shared_ptr<scene::SemanticScene>& semanticScene) {
+    const std::shared_ptr<scene::SemanticScene>& semanticScene,
+    int numThreads) {
   // build text prefix used in log messages
   const std::string dbgMsgPrefix = Cr::Utility::formatString(
       "Parsing Semantic File {} w/prim:{} :", semanticFilename,
@@ -82,6 +96,30 @@ GenericSemanticMeshData::buildSemanticMeshData(
   Cr::Utility::copy(meshColors,
                     Cr::Containers::arrayView(semanticMeshData->cpu_cbo_));
 
+  // Per-mesh vertex semantic object ids, if provided
+  Cr::Containers::Optional<Cr::Containers::Array<Mn::UnsignedInt>> objectIds;
+  if (srcMeshData.hasAttribute(Mn::Trade::MeshAttribute::ObjectId)) {
+    objectIds = srcMeshData.objectIdsAsArray();
+  }
+
+  return finishSemanticMeshData(std::move(semanticMeshData),
+                                std::move(objectIds), dbgMsgPrefix,
+                                colorMapToUse, semanticScene, numThreads);
+}  // GenericSemanticMeshData::buildSemanticMeshData
+
+std::unique_ptr<GenericSemanticMeshData>
+GenericSemanticMeshData::finishSemanticMeshData(
+    std::unique_ptr<GenericSemanticMeshData> semanticMeshData,
+    Cr::Containers::Optional<Cr::Containers::Array<Mn::UnsignedInt>>
+        srcObjectIds,
+    const std::string& dbgMsgPrefix,
+    std::vector<Mn::Vector3ub>& colorMapToUse,
+    const std::shared_ptr<scene::SemanticScene>& semanticScene,
+    int numThreads) {
+  const std::size_t numVerts = semanticMeshData->cpu_vbo_.size();
+  const Cr::Containers::ArrayView<const Mn::Color3ub> meshColors =
+      Cr::Containers::arrayView(semanticMeshData->cpu_cbo_);
+
   // Check we actually have object IDs before copying them, and that those are
   // in a range we expect them to be
   Cr::Containers::Array<Mn::UnsignedInt> objectIds;
@@ -100,10 +138,10 @@ GenericSemanticMeshData::buildSemanticMeshData(
   semanticMeshData->nonSSDVertColorIDs.clear();
   semanticMeshData->nonSSDVertColorCounts.clear();
 
-  if (srcMeshData.hasAttribute(Mn::Trade::MeshAttribute::ObjectId)) {
+  if (srcObjectIds) {
     // Per-mesh vertex semantic object ids are provided - this will override any
     // vertex colors provided in file
-    objectIds = srcMeshData.objectIdsAsArray();
+    objectIds = *std::move(srcObjectIds);
     objIdsFromSrcMesh = true;
     const int maxVal = Mn::Math::max(objectIds);
     ESP_CHECK(maxVal <= 65535, Cr::Utility::formatString(
@@ -173,33 +211,48 @@ GenericSemanticMeshData::buildSemanticMeshData(
       // verts (via index)
       semanticMeshData->objectIds_.resize(numVerts);
 
-      // only go through all verts one time
-      // derive semantic ID and color and region/room ID for culling
-      int regionID = 0;
-      int semanticID = 0;
-
-      for (int vertIdx = 0; vertIdx < numVerts; ++vertIdx) {
-        Mn::Color3ub meshColor = meshColors[vertIdx];
-        // Convert color to an int @ vertex
-        const uint32_t meshColorInt = (unsigned(meshColor[0]) << 16) |
-                                      (unsigned(meshColor[1]) << 8) |
-                                      unsigned(meshColor[2]);
-
-        std::unordered_map<uint32_t, std::pair<int, int>>::const_iterator
-            ssdColorToIDAndRegionIter =
-                tmpColorMapToSSDidAndRegionIndex.find(meshColorInt);
-
-        if (ssdColorToIDAndRegionIter !=
-            tmpColorMapToSSDidAndRegionIndex.end()) {
-          // color is found in ssd mapping, so is legal color
-          semanticID = ssdColorToIDAndRegionIter->second.first;
-          regionID = ssdColorToIDAndRegionIter->second.second;
-
-        } else {
+      // derive semantic ID and color and region/room ID for culling. Colors
+      // found in the SSD are mapped in parallel, the verts with unknown colors
+      // are collected per chunk and assigned their IDs below in vertex order,
+      // so the result doesn't depend on the number of threads.
+      constexpr std::size_t VertsPerChunk = 1 << 16;
+      const std::size_t numChunks =
+          (numVerts + VertsPerChunk - 1) / VertsPerChunk;
+      std::vector<std::vector<uint32_t>> unknownColorVerts(numChunks);
+      core::parallelFor(numChunks, numThreads, [&](std::size_t chunk, int) {
+        const std::size_t end =
+            Mn::Math::min(std::size_t(numVerts), (chunk + 1) * VertsPerChunk);
+        for (std::size_t vertIdx = chunk * VertsPerChunk; vertIdx != end;
+             ++vertIdx) {
+          const uint32_t meshColorInt =
+              geo::getValueAsUInt(meshColors[vertIdx]);
+
+          std::unordered_map<uint32_t, std::pair<int, int>>::const_iterator
+              ssdColorToIDAndRegionIter =
+                  tmpColorMapToSSDidAndRegionIndex.find(meshColorInt);
+
+          if (ssdColorToIDAndRegionIter !=
+              tmpColorMapToSSDidAndRegionIndex.end()) {
+            // color is found in ssd mapping, so is legal color
+            // assign semantic ID for vertex
+            semanticMeshData->objectIds_[vertIdx] =
+                ssdColorToIDAndRegionIter->second.first;
+            // partition Ids for each vertex, for multi-mesh construction.
+            semanticMeshData->partitionIds_[vertIdx] =
+                ssdColorToIDAndRegionIter->second.second;
+          } else {
+            unknownColorVerts[chunk].push_back(vertIdx);
+          }
+        }
+      });
+
+      for (const std::vector<uint32_t>& chunkVerts : unknownColorVerts) {
+        for (const uint32_t vertIdx : chunkVerts) {
+          Mn::Color3ub meshColor = meshColors[vertIdx];
+          const uint32_t meshColorInt = geo::getValueAsUInt(meshColor);
           // color is not found in ssd mapping, so not legal color
           // use currently assigned unknown color's semantic ID for this vertex
-          semanticID = nonSSDObjID;
-          regionID = maxRegion;
+          const int semanticID = nonSSDObjID;
 
           // check if we've assigned a semantic ID to this color before, and if
           // not do so
@@ -223,13 +276,13 @@ GenericSemanticMeshData::buildSemanticMeshData(
           } else {
             ++nonSSDClrCountRes.first->second;
           }
-        }
 
-        // assign semantic ID for vertex
-        semanticMeshData->objectIds_[vertIdx] = semanticID;
-        // partition Ids for each vertex, for multi-mesh construction.
-        semanticMeshData->partitionIds_[vertIdx] = regionID;
-      }  // for each vertex
+          // assign semantic ID for vertex
+          semanticMeshData->objectIds_[vertIdx] = semanticID;
+          // partition Ids for each vertex, for multi-mesh construction.
+          semanticMeshData->partitionIds_[vertIdx] = maxRegion;
+        }
+      }  // for each vertex with an unknown color
 
     } else {
       // Per vertex colors provided, but no semantic scene provided to provide
@@ -273,75 +326,806 @@ GenericSemanticMeshData::buildSemanticMeshData(
   semanticMeshData->collisionMeshData_.primitive = Mn::MeshPrimitive::Triangles;
   semanticMeshData->updateCollisionMeshData();
 
-  if (semanticScene && (semanticScene->buildBBoxFromVertColors())) {
-    float fractionOfMaxBBoxSize = semanticScene->CCFractionToUseForBBox();
-
-    if (fractionOfMaxBBoxSize > 0.0f) {
-      // build adj list to use to derive CCs
-      // Assumes that index buffer defines triangle polys in sequential groups
-      // of 3 vert idxs
-      const std::vector<std::set<uint32_t>> adjList = geo::buildAdjList(
-          semanticMeshData->cpu_vbo_.size(), semanticMeshData->cpu_ibo_);
-
-      // find all connected components based on adj list and vertex color.
-      const std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
-          clrsToComponents =
-              geo::findCCsByGivenColor(adjList, semanticMeshData->cpu_cbo_);
-
-      // FOR VERT-BASED OBB CALC build semantic (actually AABBs currently)
-      // only use CCs that have some fraction of largest CC's bbox volume.
-      // Currently uses only max volume CC bbox for disjoint semantic regions.
-      semanticMeshData->unMappedObjectIDXs =
-          scene::SemanticScene::buildSemanticOBBsFromCCs(
-              semanticMeshData->cpu_vbo_, clrsToComponents, semanticScene,
-              fractionOfMaxBBoxSize, dbgMsgPrefix);
-    } else {
-      // FOR VERT-BASED OBB CALC build semantic (actually AABBs currently)
-      // uses all vertex annotations, including disconnected components.
-      semanticMeshData->unMappedObjectIDXs =
-          scene::SemanticScene::buildSemanticOBBs(
-              semanticMeshData->cpu_vbo_, semanticMeshData->objectIds_,
-              semanticScene->objects(), dbgMsgPrefix);
-    }
-  }
+  semanticMeshData->buildVertexBasedSemanticOBBs(semanticScene, dbgMsgPrefix,
+                                                 numThreads);
   // display or save report denoting presence of semantic object-defined colors
   // in mesh
   return semanticMeshData;
-}  // GenericSemanticMeshData::buildSemanticMeshData
+}  // GenericSemanticMeshData::finishSemanticMeshData
+
+namespace {
+
+// Scalar types of binary PLY properties
+enum class PlyType : Mn::UnsignedByte {
+  Char,
+  UnsignedChar,
+  Short,
+  UnsignedShort,
+  Int,
+  UnsignedInt,
+  Float,
+  Double
+};
+
+Cr::Containers::Optional<PlyType> plyType(Cr::Containers::StringView name) {
+  if (name == "char" || name == "int8") {
+    return PlyType::Char;
+  }
+  if (name == "uchar" || name == "uint8") {
+    return PlyType::UnsignedChar;
+  }
+  if (name == "short" || name == "int16") {
+    return PlyType::Short;
+  }
+  if (name == "ushort" || name == "uint16") {
+    return PlyType::UnsignedShort;
+  }
+  if (name == "int" || name == "int32") {
+    return PlyType::Int;
+  }
+  if (name == "uint" || name == "uint32") {
+    return PlyType::UnsignedInt;
+  }
+  if (name == "float" || name == "float32") {
+    return PlyType::Float;
+  }
+  if (name == "double" || name == "float64") {
+    return PlyType::Double;
+  }
+  return {};
+}
+
+std::size_t plyTypeSize(PlyType type) {
+  switch (type) {
+    case PlyType::Char:
+    case PlyType::UnsignedChar:
+      return 1;
+    case PlyType::Short:
+    case PlyType::UnsignedShort:
+      return 2;
+    case PlyType::Int:
+    case PlyType::UnsignedInt:
+    case PlyType::Float:
+      return 4;
+    case PlyType::Double:
+      return 8;
+  }
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
+bool isPlyIntegerType(PlyType type) {
+  return type != PlyType::Float && type != PlyType::Double;
+}
+
+struct PlyProperty {
+  std::string name;
+  // type of the property, or of the items of a list property
+  PlyType type;
+  // type of the item count of a list property
+  Cr::Containers::Optional<PlyType> listCountType;
+};
+
+struct PlyElement {
+  std::string name;
+  std::size_t count = 0;
+  std::vector<PlyProperty> properties;
+};
+
+// Parse the header of a binary little-endian PLY file, returning the offset
+// of the data following it, or nothing if the file isn't one
+Cr::Containers::Optional<std::size_t> parsePlyHeader(
+    Cr::Containers::StringView data,
+    std::vector<PlyElement>& elements) {
+  std::size_t offset = 0;
+  bool formatFound = false;
+  for (std::size_t lineIdx = 0;; ++lineIdx) {
+    const Cr::Containers::StringView rest = data.exceptPrefix(offset);
+    const Cr::Containers::StringView newline = rest.findOr('\n', rest.end());
+    if (newline.begin() == rest.end()) {
+      return {};
+    }
+    const std::size_t lineSize = newline.begin() - rest.begin();
+    const Cr::Containers::StringView line = rest.prefix(lineSize).trimmed();
+    offset += lineSize + 1;
+
+    const Cr::Containers::Array<Cr::Containers::StringView> tokens =
+        line.splitOnWhitespaceWithoutEmptyParts();
+    if (lineIdx == 0) {
+      if (line != "ply") {
+        return {};
+      }
+    } else if (tokens.isEmpty() || tokens[0] == "comment" ||
+               tokens[0] == "obj_info") {
+      continue;
+    } else if (tokens[0] == "format") {
+      if (tokens.size() != 3 || tokens[1] != "binary_little_endian") {
+        return {};
+      }
+      formatFound = true;
+    } else if (tokens[0] == "element") {
+      if (tokens.size() != 3) {
+        return {};
+      }
+      char* end = nullptr;
+      const std::string countString{tokens[2]};
+      const unsigned long long count =
+          std::strtoull(countString.c_str(), &end, 10);
+      if (end == countString.c_str() || *end != '\0') {
+        return {};
+      }
+      elements.emplace_back();
+      elements.back().name = std::string{tokens[1]};
+      elements.back().count = count;
+    } else if (tokens[0] == "property") {
+      if (elements.empty()) {
+        return {};
+      }
+      PlyProperty property;
+      if (tokens.size() == 5 && tokens[1] == "list") {
+        const Cr::Containers::Optional<PlyType> countType = plyType(tokens[2]);
+        const Cr::Containers::Optional<PlyType> type = plyType(tokens[3]);
+        if (!countType || !type || !isPlyIntegerType(*countType)) {
+          return {};
+        }
+        property.listCountType = countType;
+        property.type = *type;
+        property.name = std::string{tokens[4]};
+      } else if (tokens.size() == 3) {
+        const Cr::Containers::Optional<PlyType> type = plyType(tokens[1]);
+        if (!type) {
+          return {};
+        }
+        property.type = *type;
+        property.name = std::string{tokens[2]};
+      } else {
+        return {};
+      }
+      elements.back().properties.push_back(std::move(property));
+    } else if (tokens[0] == "end_header") {
+      if (!formatFound) {
+        return {};
+      }
+      return offset;
+    } else {
+      return {};
+    }
+  }
+}
+
+template <class T>
+T readUnaligned(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+// Read an integer property, the type is expected to be an integer type
+Mn::Long readPlyInteger(const char* data, PlyType type) {
+  switch (type) {
+    case PlyType::Char:
+      return readUnaligned<Mn::Byte>(data);
+    case PlyType::UnsignedChar:
+      return readUnaligned<Mn::UnsignedByte>(data);
+    case PlyType::Short:
+      return readUnaligned<Mn::Short>(data);
+    case PlyType::UnsignedShort:
+      return readUnaligned<Mn::UnsignedShort>(data);
+    case PlyType::Int:
+      return readUnaligned<Mn::Int>(data);
+    case PlyType::UnsignedInt:
+      return readUnaligned<Mn::UnsignedInt>(data);
+    case PlyType::Float:
+    case PlyType::Double:
+      break;
+  }
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
+// Elements are decoded in chunks of this many items per parallel task
+constexpr std::size_t PlyItemsPerChunk = 1 << 16;
+
+}  // namespace
+
+std::unique_ptr<GenericSemanticMeshData>
+GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+    const std::string& filename,
+    const Mn::Matrix4& reframeTransform,
+    std::vector<Mn::Vector3ub>& colorMapToUse,
+    const std::shared_ptr<scene::SemanticScene>& semanticScene,
+    int numThreads) {
+  // the data is read in place, which needs a little-endian machine
+  if (Cr::Utility::Endianness::isBigEndian()) {
+    return nullptr;
+  }
+  Cr::Containers::Optional<
+      Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+      mapped = Cr::Utility::Path::mapRead(filename);
+  if (!mapped) {
+    return nullptr;
+  }
+  const Cr::Containers::StringView data{mapped->data(), mapped->size()};
+  std::vector<PlyElement> elements;
+  const Cr::Containers::Optional<std::size_t> dataOffset =
+      parsePlyHeader(data, elements);
+  if (!dataOffset) {
+    return nullptr;
+  }
+
+  // Locate the vertex and face data. Every element has to have a fixed size
+  // to be skipped, the face indices are assumed to be triangles and verified
+  // while decoding.
+  const PlyElement* vertexElement = nullptr;
+  const PlyElement* faceElement = nullptr;
+  std::size_t vertexOffset = 0;
+  std::size_t vertexStride = 0;
+  std::size_t faceOffset = 0;
+  std::size_t faceStride = 0;
+  std::size_t offset = *dataOffset;
+  for (const PlyElement& element : elements) {
+    const bool isFace = element.name == "face";
+    std::size_t stride = 0;
+    for (const PlyProperty& property : element.properties) {
+      if (property.listCountType) {
+        if (!isFace || stride != 0 ||
+            (property.name != "vertex_indices" &&
+             property.name != "vertex_index")) {
+          return nullptr;
+        }
+        stride += plyTypeSize(*property.listCountType) +
+                  3 * plyTypeSize(property.type);
+      } else {
+        stride += plyTypeSize(property.type);
+      }
+    }
+    if (element.name == "vertex") {
+      vertexElement = &element;
+      vertexOffset = offset;
+      vertexStride = stride;
+    } else if (isFace) {
+      faceElement = &element;
+      faceOffset = offset;
+      faceStride = stride;
+    }
+    if (stride != 0 && element.count > (data.size() - offset) / stride) {
+      return nullptr;
+    }
+    offset += element.count * stride;
+  }
+  // a size mismatch means the faces aren't all triangles, or the file is
+  // damaged, either way the importer handles it
+  if (!vertexElement || !faceElement || offset != data.size() ||
+      faceElement->properties.empty() ||
+      !faceElement->properties[0].listCountType) {
+    return nullptr;
+  }
+
+  // offsets of the vertex properties within a vertex
+  std::size_t positionOffsets[3]{};
+  std::size_t colorOffsets[3]{};
+  int positionsFound = 0;
+  int colorsFound = 0;
+  Cr::Containers::Optional<std::size_t> objectIdOffset;
+  PlyType objectIdType = PlyType::UnsignedInt;
+  std::size_t propertyOffset = 0;
+  for (const PlyProperty& property : vertexElement->properties) {
+    const char* const positionNames[]{"x", "y", "z"};
+    const char* const colorNames[]{"red", "green", "blue"};
+    for (int i = 0; i != 3; ++i) {
+      if (property.name == positionNames[i]) {
+        if (property.type != PlyType::Float) {
+          return nullptr;
+        }
+        positionOffsets[i] = propertyOffset;
+        ++positionsFound;
+      } else if (property.name == colorNames[i]) {
+        if (property.type != PlyType::UnsignedChar) {
+          return nullptr;
+        }
+        colorOffsets[i] = propertyOffset;
+        ++colorsFound;
+      }
+    }
+    if (property.name == "object_id") {
+      if (!isPlyIntegerType(property.type)) {
+        return nullptr;
+      }
+      objectIdOffset = propertyOffset;
+      objectIdType = property.type;
+    }
+    propertyOffset += plyTypeSize(property.type);
+  }
+  // per-face object IDs need the faces split to per-vertex ones
+  for (const PlyProperty& property : faceElement->properties) {
+    if (property.name == "object_id") {
+      return nullptr;
+    }
+  }
+  if (positionsFound != 3 || colorsFound != 3) {
+    return nullptr;
+  }
+  const PlyProperty& indicesProperty = faceElement->properties[0];
+  if (!isPlyIntegerType(indicesProperty.type)) {
+    return nullptr;
+  }
+  const std::size_t indexCountSize =
+      plyTypeSize(*indicesProperty.listCountType);
+  const std::size_t indexSize = plyTypeSize(indicesProperty.type);
+
+  const std::size_t numVerts = vertexElement->count;
+  const std::size_t numFaces = faceElement->count;
+  auto semanticMeshData = GenericSemanticMeshData::create_unique();
+  semanticMeshData->cpu_vbo_.resize(numVerts);
+  semanticMeshData->cpu_cbo_.resize(numVerts);
+  semanticMeshData->objectIds_.resize(numVerts);
+  semanticMeshData->cpu_ibo_.resize(3 * numFaces);
+  Cr::Containers::Optional<Cr::Containers::Array<Mn::UnsignedInt>> objectIds;
+  if (objectIdOffset) {
+    objectIds.emplace(Mn::NoInit, numVerts);
+  }
+
+  // Generic Semantic PLY meshes have -Z gravity, applied after the reframe
+  // transform like in buildSemanticMeshData()
+  const Mn::Matrix4 transform =
+      Mn::Matrix4::from(Mn::Quaternion{quatf::FromTwoVectors(
+                                           -vec3f::UnitZ(), geo::ESP_GRAVITY)}
+                            .toMatrix(),
+                        {}) *
+      reframeTransform;
+
+  const char* const vertexData = data.data() + vertexOffset;
+  core::parallelFor(
+      (numVerts + PlyItemsPerChunk - 1) / PlyItemsPerChunk, numThreads,
+      [&](std::size_t chunk, int) {
+        const std::size_t end =
+            Mn::Math::min(numVerts, (chunk + 1) * PlyItemsPerChunk);
+        for (std::size_t i = chunk * PlyItemsPerChunk; i != end; ++i) {
+          const char* const vertex = vertexData + i * vertexStride;
+          semanticMeshData->cpu_vbo_[i] = transform.transformPoint(
+              {readUnaligned<float>(vertex + positionOffsets[0]),
+               readUnaligned<float>(vertex + positionOffsets[1]),
+               readUnaligned<float>(vertex + positionOffsets[2])});
+          semanticMeshData->cpu_cbo_[i] = {
+              Mn::UnsignedByte(vertex[colorOffsets[0]]),
+              Mn::UnsignedByte(vertex[colorOffsets[1]]),
+              Mn::UnsignedByte(vertex[colorOffsets[2]])};
+          if (objectIds) {
+            (*objectIds)[i] = Mn::UnsignedInt(
+                readPlyInteger(vertex + *objectIdOffset, objectIdType));
+          }
+        }
+      });
+
+  // non-triangle faces or out-of-range indices are flagged per chunk, the
+  // importer reports them properly
+  const std::size_t numFaceChunks =
+      (numFaces + PlyItemsPerChunk - 1) / PlyItemsPerChunk;
+  std::vector<char> faceChunkValid(numFaceChunks, 1);
+  const char* const faceData = data.data() + faceOffset;
+  core::parallelFor(numFaceChunks, numThreads, [&](std::size_t chunk, int) {
+    const std::size_t end =
+        Mn::Math::min(numFaces, (chunk + 1) * PlyItemsPerChunk);
+    for (std::size_t i = chunk * PlyItemsPerChunk; i != end; ++i) {
+      const char* const face = faceData + i * faceStride;
+      if (readPlyInteger(face, *indicesProperty.listCountType) != 3) {
+        faceChunkValid[chunk] = 0;
+        return;
+      }
+      for (std::size_t j = 0; j != 3; ++j) {
+        const Mn::Long index = readPlyInteger(
+            face + indexCountSize + j * indexSize, indicesProperty.type);
+        if (index < 0 || std::size_t(index) >= numVerts) {
+          faceChunkValid[chunk] = 0;
+          return;
+        }
+        semanticMeshData->cpu_ibo_[3 * i + j] = uint32_t(index);
+      }
+    }
+  });
+  if (std::find(faceChunkValid.begin(), faceChunkValid.end(), 0) !=
+      faceChunkValid.end()) {
+    return nullptr;
+  }
+  // everything is decoded, unmap the file before mapping colors to IDs
+  mapped = Cr::Containers::NullOpt;
+
+  const std::string dbgMsgPrefix = Cr::Utility::formatString(
+      "Parsing Semantic File {} w/prim:{} :",
+      Cr::Utility::Path::split(filename).second(),
+      static_cast<Mn::UnsignedInt>(Mn::MeshPrimitive::Triangles));
+  return finishSemanticMeshData(std::move(semanticMeshData),
+                                std::move(objectIds), dbgMsgPrefix,
+                                colorMapToUse, semanticScene, numThreads);
+}  // GenericSemanticMeshData::buildSemanticMeshDataFromPly
 
 std::vector<std::unique_ptr<GenericSemanticMeshData>>
 GenericSemanticMeshData::partitionSemanticMeshData(
-    const std::unique_ptr<GenericSemanticMeshData>& semanticMeshData) {
-  // build output vector of meshdata unique pointers
-  std::vector<GenericSemanticMeshData::uptr> splitMeshData;
-  std::unordered_map<uint16_t, PerPartitionIdMeshBuilder>
-      partitionIdToObjectData;
+    const std::unique_ptr<GenericSemanticMeshData>& semanticMeshData,
+    int numThreads) {
   const std::vector<uint16_t>& meshPartitionIds =
       semanticMeshData->getPartitionIDs();
-  for (size_t i = 0; i < semanticMeshData->cpu_ibo_.size(); ++i) {
-    const uint32_t globalIndex = semanticMeshData->cpu_ibo_[i];
-    const uint16_t objectId = semanticMeshData->objectIds_[globalIndex];
+  // collect the indices of every partition, with the partitions ordered by
+  // their first use in the index buffer
+  std::unordered_map<uint16_t, std::size_t> partitionIdToIndex;
+  std::vector<uint16_t> partitionIds;
+  std::vector<std::vector<uint32_t>> partitionIndices;
+  for (const uint32_t globalIndex : semanticMeshData->cpu_ibo_) {
     const uint16_t partitionId = meshPartitionIds[globalIndex];
+    auto result =
+        partitionIdToIndex.emplace(partitionId, partitionIndices.size());
     // if not found in map to data create new mesh
-    if (partitionIdToObjectData.find(partitionId) ==
-        partitionIdToObjectData.end()) {
-      auto instanceMesh = GenericSemanticMeshData::create_unique();
-      partitionIdToObjectData.emplace(
-          partitionId, PerPartitionIdMeshBuilder{*instanceMesh, partitionId});
-      splitMeshData.emplace_back(std::move(instanceMesh));
+    if (result.second) {
+      partitionIds.push_back(partitionId);
+      partitionIndices.emplace_back();
     }
-    partitionIdToObjectData.at(partitionId)
-        .addVertex(globalIndex, semanticMeshData->cpu_vbo_[globalIndex],
-                   semanticMeshData->cpu_cbo_[globalIndex], objectId);
-  }
-  // Update collision mesh data for each mesh
-  for (size_t i = 0; i < splitMeshData.size(); ++i) {
-    splitMeshData[i]->updateCollisionMeshData();
+    partitionIndices[result.first->second].push_back(globalIndex);
   }
+
+  // build output vector of meshdata unique pointers, the partitions are
+  // independent of each other so they're built in parallel
+  std::vector<GenericSemanticMeshData::uptr> splitMeshData(
+      partitionIndices.size());
+  core::parallelFor(
+      partitionIndices.size(), numThreads, [&](std::size_t i, int) {
+        splitMeshData[i] = GenericSemanticMeshData::create_unique();
+        PerPartitionIdMeshBuilder builder{*splitMeshData[i], partitionIds[i]};
+        for (const uint32_t globalIndex : partitionIndices[i]) {
+          builder.addVertex(globalIndex,
+                            semanticMeshData->cpu_vbo_[globalIndex],
+                            semanticMeshData->cpu_cbo_[globalIndex],
+                            semanticMeshData->objectIds_[globalIndex]);
+        }
+        // Update collision mesh data for each mesh
+        splitMeshData[i]->updateCollisionMeshData();
+      });
   return splitMeshData;
 
 }  // GenericSemanticMeshData::partitionSemanticMeshData
 
+namespace {
+
+// interleave the lower 10 bits of v with two zero bits between each
+uint32_t spreadMortonBits(uint32_t v) {
+  v &= 0x3ff;
+  v = (v | (v << 16)) & 0x030000ff;
+  v = (v | (v << 8)) & 0x0300f00f;
+  v = (v | (v << 4)) & 0x030c30c3;
+  v = (v | (v << 2)) & 0x09249249;
+  return v;
+}
+
+}  // namespace
+
+void GenericSemanticMeshData::clusterTriangles(
+    const std::size_t trianglesPerCluster) {
+  CORRADE_ASSERT(trianglesPerCluster > 0,
+                 "GenericSemanticMeshData::clusterTriangles() : Clusters have "
+                 "to contain at least one triangle", );
+  const std::size_t triangleCount = cpu_ibo_.size() / 3;
+  const auto centroid = [&](std::size_t triangle) {
+    return (cpu_vbo_[cpu_ibo_[3 * triangle]] +
+            cpu_vbo_[cpu_ibo_[3 * triangle + 1]] +
+            cpu_vbo_[cpu_ibo_[3 * triangle + 2]]) /
+           3.0f;
+  };
+
+  // Morton code of each triangle centroid, quantized to 10 bits per axis of
+  // the mesh bounds
+  Mn::Range3D bounds;
+  if (!cpu_vbo_.empty()) {
+    bounds = Mn::Math::minmax(cpu_vbo_);
+  }
+  const Mn::Vector3 scale =
+      1023.0f / Mn::Math::max(bounds.size(), Mn::Vector3{1.0e-6f});
+  std::vector<uint32_t> codes(triangleCount);
+  for (std::size_t i = 0; i != triangleCount; ++i) {
+    const Mn::Vector3ui cell{(centroid(i) - bounds.min()) * scale};
+    codes[i] = (spreadMortonBits(cell.x()) << 2) |
+               (spreadMortonBits(cell.y()) << 1) | spreadMortonBits(cell.z());
+  }
+  std::vector<uint32_t> order(triangleCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return codes[a] < codes[b];
+  });
+
+  // reorder in place, the collision mesh data keeps pointing to cpu_ibo_
+  const std::vector<uint32_t> indices = cpu_ibo_;
+  for (std::size_t i = 0; i != triangleCount; ++i) {
+    for (std::size_t j = 0; j != 3; ++j) {
+      cpu_ibo_[3 * i + j] = indices[3 * order[i] + j];
+    }
+  }
+
+  auto clusters = std::make_shared<std::vector<gfx::MeshCluster>>();
+  clusters->reserve((triangleCount + trianglesPerCluster - 1) /
+                    trianglesPerCluster);
+  for (std::size_t first = 0; first < triangleCount;
+       first += trianglesPerCluster) {
+    const std::size_t last =
+        std::min(first + trianglesPerCluster, triangleCount);
+    gfx::MeshCluster cluster;
+    cluster.indexOffset = 3 * first;
+    cluster.indexCount = 3 * (last - first);
+    cluster.aabb = {cpu_vbo_[cpu_ibo_[3 * first]],
+                    cpu_vbo_[cpu_ibo_[3 * first]]};
+    for (std::size_t i = 3 * first; i != 3 * last; ++i) {
+      cluster.aabb = Mn::Math::join(cluster.aabb, cpu_vbo_[cpu_ibo_[i]]);
+    }
+    clusters->push_back(cluster);
+  }
+  meshClusters_ = std::move(clusters);
+}  // GenericSemanticMeshData::clusterTriangles
+
+void GenericSemanticMeshData::buildVertexBasedSemanticOBBs(
+    const std::shared_ptr<scene::SemanticScene>& semanticScene,
+    const std::string& dbgMsgPrefix,
+    int numThreads) {
+  if (!semanticScene || !semanticScene->buildBBoxFromVertColors()) {
+    return;
+  }
+  float fractionOfMaxBBoxSize = semanticScene->CCFractionToUseForBBox();
+
+  if (fractionOfMaxBBoxSize > 0.0f) {
+    // build adj list to use to derive CCs
+    // Assumes that index buffer defines triangle polys in sequential groups
+    // of 3 vert idxs
+    const geo::CsrAdjList adjList =
+        geo::buildCsrAdjList(cpu_vbo_.size(), cpu_ibo_);
+
+    // find all connected components based on adj list and vertex color.
+    const std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
+        clrsToComponents = geo::findCCsByGivenColor(adjList, cpu_cbo_);
+
+    // FOR VERT-BASED OBB CALC build semantic (actually AABBs currently)
+    // only use CCs that have some fraction of largest CC's bbox volume.
+    // Currently uses only max volume CC bbox for disjoint semantic regions.
+    unMappedObjectIDXs = scene::SemanticScene::buildSemanticOBBsFromCCs(
+        cpu_vbo_, clrsToComponents, semanticScene, fractionOfMaxBBoxSize,
+        dbgMsgPrefix, numThreads);
+  } else {
+    // FOR VERT-BASED OBB CALC build semantic (actually AABBs currently)
+    // uses all vertex annotations, including disconnected components.
+    unMappedObjectIDXs = scene::SemanticScene::buildSemanticOBBs(
+        cpu_vbo_, objectIds_, semanticScene->objects(), dbgMsgPrefix);
+  }
+}
+
+namespace {
+
+// Bump when the layout below changes, older cache files are then rebuilt
+constexpr char SemanticMeshCacheMagic[8]{'E', 'S', 'P', 'S',
+                                         'M', 'C', '0', '2'};
+
+struct SemanticMeshCacheHeader {
+  char magic[8];
+  // bit 0 is meshHasPartitionIDXs, bit 1 meshUsesSSDPartitionIDs, bit 2 set if
+  // the vertex-based semantic OBBs are stored
+  uint32_t flags;
+  uint32_t numNonSSDColors;
+  uint64_t numVerts;
+  uint64_t numIndices;
+  uint64_t numPartitionIds;
+  uint64_t numColorMapColors;
+  uint64_t numSemanticOBBs;
+  uint64_t numUnMappedObjects;
+  // the SemanticScene::CCFractionToUseForBBox() the OBBs were built with
+  float obbCCFraction;
+  uint32_t padding;
+};
+
+// the vertex-based OBB of a semantic object, along with the object's color
+// to detect a changed SSD
+struct SemanticMeshCacheOBB {
+  uint32_t color;
+  float center[3];
+  float halfExtents[3];
+  float rotation[4];
+};
+
+struct SemanticMeshCacheNonSSDColor {
+  uint32_t color;
+  int32_t semanticID;
+  int32_t count;
+};
+
+template <class T>
+void appendToCache(std::string& out, const std::vector<T>& data) {
+  out.append(reinterpret_cast<const char*>(data.data()),
+             data.size() * sizeof(T));
+}
+
+template <class T>
+bool readFromCache(Cr::Containers::ArrayView<const char>& in,
+                   std::size_t count,
+                   std::vector<T>& out) {
+  if (count > in.size() / sizeof(T)) {
+    return false;
+  }
+  out.resize(count);
+  if (count) {
+    std::memcpy(out.data(), in.data(), count * sizeof(T));
+  }
+  in = in.exceptPrefix(count * sizeof(T));
+  return true;
+}
+
+}  // namespace
+
+bool GenericSemanticMeshData::saveToCache(
+    const std::string& cacheFilename,
+    const std::vector<Mn::Vector3ub>& colorMapToUse,
+    const std::shared_ptr<scene::SemanticScene>& semanticScene) const {
+  std::vector<SemanticMeshCacheNonSSDColor> nonSSDColors;
+  nonSSDColors.reserve(nonSSDVertColorIDs.size());
+  for (const auto& colorID : nonSSDVertColorIDs) {
+    auto count = nonSSDVertColorCounts.find(colorID.first);
+    nonSSDColors.push_back(
+        {colorID.first, colorID.second,
+         count != nonSSDVertColorCounts.end() ? count->second : 0});
+  }
+
+  // the OBBs buildVertexBasedSemanticOBBs() gave the semantic objects
+  std::vector<SemanticMeshCacheOBB> obbs;
+  const bool hasOBBs =
+      semanticScene && semanticScene->buildBBoxFromVertColors();
+  if (hasOBBs) {
+    obbs.reserve(semanticScene->objects().size());
+    for (const auto& obj : semanticScene->objects()) {
+      const geo::OBB obb = obj->obb();
+      const vec3f center = obb.center();
+      const vec3f halfExtents = obb.halfExtents();
+      const quatf rotation = obb.rotation();
+      const vec4f rotationCoeffs = rotation.coeffs();
+      obbs.push_back(
+          {obj->getColorAsInt(),
+           {center.x(), center.y(), center.z()},
+           {halfExtents.x(), halfExtents.y(), halfExtents.z()},
+           {rotationCoeffs[0], rotationCoeffs[1], rotationCoeffs[2],
+            rotationCoeffs[3]}});
+    }
+  }
+
+  SemanticMeshCacheHeader header{};
+  std::memcpy(header.magic, SemanticMeshCacheMagic, sizeof(header.magic));
+  header.flags = (meshHasPartitionIDXs ? 1u : 0u) |
+                 (meshUsesSSDPartitionIDs ? 2u : 0u) | (hasOBBs ? 4u : 0u);
+  header.numNonSSDColors = nonSSDColors.size();
+  header.numVerts = cpu_vbo_.size();
+  header.numIndices = cpu_ibo_.size();
+  header.numPartitionIds = partitionIds_.size();
+  header.numColorMapColors = colorMapToUse.size();
+  if (hasOBBs) {
+    header.numSemanticOBBs = obbs.size();
+    header.numUnMappedObjects = unMappedObjectIDXs.size();
+    header.obbCCFraction = semanticScene->CCFractionToUseForBBox();
+  }
+
+  std::string data;
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  appendToCache(data, cpu_vbo_);
+  appendToCache(data, cpu_cbo_);
+  appendToCache(data, cpu_ibo_);
+  appendToCache(data, objectIds_);
+  appendToCache(data, partitionIds_);
+  appendToCache(data, colorMapToUse);
+  appendToCache(data, nonSSDColors);
+  appendToCache(data, obbs);
+  if (hasOBBs) {
+    appendToCache(data, unMappedObjectIDXs);
+  }
+
+  if (!core::writeFileAtomically(
+          cacheFilename,
+          Cr::Containers::ArrayView<const void>{data.data(), data.size()})) {
+    ESP_WARNING() << "Unable to write the semantic mesh cache" << cacheFilename;
+    return false;
+  }
+  return true;
+}  // GenericSemanticMeshData::saveToCache
+
+std::unique_ptr<GenericSemanticMeshData> GenericSemanticMeshData::loadFromCache(
+    const std::string& cacheFilename,
+    const std::string& semanticFilename,
+    std::vector<Mn::Vector3ub>& colorMapToUse,
+    const std::shared_ptr<scene::SemanticScene>& semanticScene,
+    int numThreads) {
+  if (!Cr::Utility::Path::exists(cacheFilename)) {
+    return nullptr;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(cacheFilename);
+  if (!file) {
+    return nullptr;
+  }
+  Cr::Containers::ArrayView<const char> in = *file;
+
+  SemanticMeshCacheHeader header;
+  auto semanticMeshData = GenericSemanticMeshData::create_unique();
+  std::vector<Mn::Vector3ub> colorMap;
+  std::vector<SemanticMeshCacheNonSSDColor> nonSSDColors;
+  std::vector<SemanticMeshCacheOBB> obbs;
+  std::vector<uint32_t> unMappedObjectIDXs;
+  bool valid = in.size() >= sizeof(header);
+  if (valid) {
+    std::memcpy(&header, in.data(), sizeof(header));
+    in = in.exceptPrefix(sizeof(header));
+    valid = std::memcmp(header.magic, SemanticMeshCacheMagic,
+                        sizeof(header.magic)) == 0 &&
+            readFromCache(in, header.numVerts, semanticMeshData->cpu_vbo_) &&
+            readFromCache(in, header.numVerts, semanticMeshData->cpu_cbo_) &&
+            readFromCache(in, header.numIndices, semanticMeshData->cpu_ibo_) &&
+            readFromCache(in, header.numVerts, semanticMeshData->objectIds_) &&
+            readFromCache(in, header.numPartitionIds,
+                          semanticMeshData->partitionIds_) &&
+            readFromCache(in, header.numColorMapColors, colorMap) &&
+            readFromCache(in, header.numNonSSDColors, nonSSDColors) &&
+            readFromCache(in, header.numSemanticOBBs, obbs) &&
+            readFromCache(in, header.numUnMappedObjects, unMappedObjectIDXs) &&
+            in.isEmpty();
+  }
+  if (valid) {
+    for (const uint32_t index : semanticMeshData->cpu_ibo_) {
+      if (index >= header.numVerts) {
+        valid = false;
+        break;
+      }
+    }
+  }
+  if (!valid) {
+    ESP_WARNING() << "Ignoring the invalid or outdated semantic mesh cache"
+                  << cacheFilename;
+    return nullptr;
+  }
+
+  semanticMeshData->meshHasPartitionIDXs = header.flags & 1u;
+  semanticMeshData->meshUsesSSDPartitionIDs = header.flags & 2u;
+  for (const SemanticMeshCacheNonSSDColor& color : nonSSDColors) {
+    semanticMeshData->nonSSDVertColorIDs.emplace(color.color,
+                                                 color.semanticID);
+    semanticMeshData->nonSSDVertColorCounts.emplace(color.color, color.count);
+  }
+  colorMapToUse = std::move(colorMap);
+
+  semanticMeshData->collisionMeshData_.primitive = Mn::MeshPrimitive::Triangles;
+  semanticMeshData->updateCollisionMeshData();
+
+  // reuse the stored OBBs if they were built for the same semantic objects
+  // with the same settings, otherwise rebuild them from the loaded data
+  if (!semanticScene || !semanticScene->buildBBoxFromVertColors()) {
+    return semanticMeshData;
+  }
+  const auto& ssdObjs = semanticScene->objects();
+  bool obbsUpToDate =
+      (header.flags & 4u) && obbs.size() == ssdObjs.size() &&
+      header.obbCCFraction == semanticScene->CCFractionToUseForBBox();
+  for (std::size_t i = 0; obbsUpToDate && i < obbs.size(); ++i) {
+    obbsUpToDate = obbs[i].color == ssdObjs[i]->getColorAsInt();
+  }
+  for (std::size_t i = 0; obbsUpToDate && i < unMappedObjectIDXs.size(); ++i) {
+    obbsUpToDate = unMappedObjectIDXs[i] < ssdObjs.size();
+  }
+  if (!obbsUpToDate) {
+    semanticMeshData->buildVertexBasedSemanticOBBs(
+        semanticScene,
+        Cr::Utility::formatString("Parsing Semantic File {} from cache :",
+                                  semanticFilename),
+        numThreads);
+    return semanticMeshData;
+  }
+  for (std::size_t i = 0; i < obbs.size(); ++i) {
+    const SemanticMeshCacheOBB& obb = obbs[i];
+    const vec3f halfExtents{obb.halfExtents[0], obb.halfExtents[1],
+                            obb.halfExtents[2]};
+    ssdObjs[i]->setObb(geo::OBB{
+        vec3f{obb.center[0], obb.center[1], obb.center[2]}, 2 * halfExtents,
+        quatf{obb.rotation[3], obb.rotation[0], obb.rotation[1],
+              obb.rotation[2]}});
+  }
+  semanticMeshData->unMappedObjectIDXs = std::move(unMappedObjectIDXs);
+  return semanticMeshData;
+}  // GenericSemanticMeshData::loadFromCache
+
+
 std::vector<std::string> GenericSemanticMeshData::getVertColorSSDReport(
     const std::string& semanticFilename,
     const std::vector<Mn::Vector3ub>& colorMapToUse,
@@ -392,8 +1176,8 @@ std::unordered_map<uint32_t, std::vector<scene::CCSemanticObject::ptr>>
 GenericSemanticMeshData::buildCCBasedSemanticObjs(
     const std::shared_ptr<scene::SemanticScene>& semanticScene) {
   // build adj list
-  std::vector<std::set<uint32_t>> adjList =
-      geo::buildAdjList(cpu_vbo_.size(), cpu_ibo_);
+  const geo::CsrAdjList adjList =
+      geo::buildCsrAdjList(cpu_vbo_.size(), cpu_ibo_);
   // find all connected components based on vertex color.
   std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
       clrsToComponents = geo::findCCsByGivenColor(adjList, cpu_cbo_);
@@ -439,6 +1223,24 @@ void GenericSemanticMeshData::uploadBuffersToGPU(bool forceReload) {
   buffersOnGPU_ = true;
 }
 
+core::MemoryUsage GenericSemanticMeshData::getMemoryUsage() const {
+  core::MemoryUsage usage;
+  usage.cpuBytes = cpu_vbo_.capacity() * sizeof(Mn::Vector3) +
+                   cpu_cbo_.capacity() * sizeof(Mn::Color3ub) +
+                   cpu_ibo_.capacity() * sizeof(uint32_t) +
+                   objectIds_.capacity() * sizeof(uint16_t) +
+                   partitionIds_.capacity() * sizeof(uint16_t);
+  if (buffersOnGPU_) {
+    // interleaved position, color, object ID and padding, see
+    // uploadBuffersToGPU()
+    const std::size_t vertexSize = sizeof(Mn::Vector3) + sizeof(Mn::Color3ub) +
+                                   1 + sizeof(uint16_t) + 2;
+    usage.gpuBytes =
+        cpu_vbo_.size() * vertexSize + cpu_ibo_.size() * sizeof(uint32_t);
+  }
+  return usage;
+}
+
 Mn::GL::Mesh* GenericSemanticMeshData::getMagnumGLMesh() {
   if (renderingBuffer_ == nullptr) {
     return nullptr;
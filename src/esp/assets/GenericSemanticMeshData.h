@@ -5,6 +5,7 @@
 #ifndef ESP_ASSETS_GENERICSEMANTICMESHDATA_H_
 #define ESP_ASSETS_GENERICSEMANTICMESHDATA_H_
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
@@ -16,6 +17,7 @@
 
 #include "BaseMesh.h"
 #include "esp/core/Esp.h"
+#include "esp/gfx/MeshCluster.h"
 #include "esp/scene/SemanticScene.h"
 
 namespace esp {
@@ -65,6 +67,8 @@ class GenericSemanticMeshData : public BaseMesh {
    * @param convertToSRGB Whether the source vertex colors from the @p meshData
    * should be converted to SRGB
    * @param semanticScene The SSD for the semantic mesh being loaded.
+   * @param numThreads The number of threads mapping vertex colors to semantic
+   * IDs, see @ref core::resolveNumThreads().
    * @return reference to the @ref GenericSemanticMeshData.
    */
   static std::unique_ptr<GenericSemanticMeshData> buildSemanticMeshData(
@@ -72,16 +76,112 @@ class GenericSemanticMeshData : public BaseMesh {
       const std::string& semanticFilename,
       std::vector<Magnum::Vector3ub>& colorMapToUse,
       bool convertToSRGB,
-      const std::shared_ptr<scene::SemanticScene>& semanticScene = nullptr);
+      const std::shared_ptr<scene::SemanticScene>& semanticScene = nullptr,
+      int numThreads = 0);
+
+  /**
+   * @brief Build the @ref GenericSemanticMeshData of a binary PLY file
+   * directly, without an importer.
+   *
+   * The file is memory-mapped and its positions, colors, per-vertex object
+   * IDs and triangles are decoded in parallel straight into the arrays of the
+   * mesh data, skipping the intermediate @ref Magnum::Trade::MeshData the
+   * importer path of @ref buildSemanticMeshData() goes through. The result is
+   * the same as importing the file, flattening it with @p reframeTransform and
+   * passing it to @ref buildSemanticMeshData() without SRGB conversion.
+   *
+   * Only little-endian binary files with float positions, 8-bit colors and
+   * triangle faces are handled. For anything else, such as ASCII files,
+   * polygons with more vertices or per-face object IDs, nullptr is returned
+   * and the file is expected to go through the importer instead.
+   * @param filename Path of the PLY file.
+   * @param reframeTransform Transformation applied to the positions.
+   * @param [out] colorMapToUse An array holding the semantic colors to use for
+   * visualization or matching to semantic IDs.
+   * @param semanticScene The SSD for the semantic mesh being loaded.
+   * @param numThreads The number of threads decoding the file and mapping
+   * vertex colors to semantic IDs, see @ref core::resolveNumThreads().
+   * @return The built mesh data, or nullptr if the file can't be handled.
+   */
+  static std::unique_ptr<GenericSemanticMeshData> buildSemanticMeshDataFromPly(
+      const std::string& filename,
+      const Magnum::Matrix4& reframeTransform,
+      std::vector<Magnum::Vector3ub>& colorMapToUse,
+      const std::shared_ptr<scene::SemanticScene>& semanticScene = nullptr,
+      int numThreads = 0);
+
+  /**
+   * @brief Load a @ref GenericSemanticMeshData saved with
+   * @ref saveToCache().
+   *
+   * If the @p semanticScene requests vertex-based semantic bboxes, the ones
+   * stored by @ref saveToCache() are applied to its objects. They are rebuilt
+   * from the loaded data instead if the objects or the bbox settings changed
+   * since.
+   * @param cacheFilename The cache file to load.
+   * @param semanticFilename Path-less Filename of source mesh.
+   * @param [out] colorMapToUse Set to the color map the data was built with.
+   * @param semanticScene The SSD for the semantic mesh being loaded.
+   * @param numThreads The number of threads rebuilding the bboxes, see
+   * @ref core::resolveNumThreads().
+   * @return The loaded mesh data, or nullptr if the file doesn't exist or
+   * isn't a valid cache file of this version.
+   */
+  static std::unique_ptr<GenericSemanticMeshData> loadFromCache(
+      const std::string& cacheFilename,
+      const std::string& semanticFilename,
+      std::vector<Magnum::Vector3ub>& colorMapToUse,
+      const std::shared_ptr<scene::SemanticScene>& semanticScene = nullptr,
+      int numThreads = 0);
+
+  /**
+   * @brief Save the mesh data built by @ref buildSemanticMeshData() along
+   * with the @p colorMapToUse it produced, so @ref loadFromCache() can skip
+   * importing and building it again. Returns whether the file was written.
+   *
+   * If @p semanticScene requests vertex-based semantic bboxes, the ones its
+   * objects got from @ref buildSemanticMeshData() are stored too, so loading
+   * skips the connected component calculation.
+   */
+  bool saveToCache(const std::string& cacheFilename,
+                   const std::vector<Magnum::Vector3ub>& colorMapToUse,
+                   const std::shared_ptr<scene::SemanticScene>& semanticScene =
+                       nullptr) const;
 
   /**
    * @brief Partition the passed @ref GenericSemanticMeshData to facilitate culling.
    * @param semanticMeshData
+   * @param numThreads The number of threads building the partitions, see
+   * @ref core::resolveNumThreads().
    * @return vector holding one or more @ref GenericSemanticMeshData
    */
   static std::vector<std::unique_ptr<GenericSemanticMeshData>>
   partitionSemanticMeshData(
-      const std::unique_ptr<GenericSemanticMeshData>& semanticMeshData);
+      const std::unique_ptr<GenericSemanticMeshData>& semanticMeshData,
+      int numThreads = 0);
+
+  /**
+   * @brief Reorder the triangles into spatially compact clusters, to draw the
+   * mesh whole while culling its clusters instead of partitioning it with
+   * @ref partitionSemanticMeshData().
+   * @param trianglesPerCluster Number of triangles of every cluster but the
+   * last.
+   *
+   * The triangles are sorted along a Morton curve through their centroids, so
+   * consecutive triangles are close to each other. Has to be called before
+   * @ref uploadBuffersToGPU(). The clusters are available through
+   * @ref getMeshClusters() afterwards.
+   */
+  void clusterTriangles(std::size_t trianglesPerCluster = 256);
+
+  /**
+   * @brief The clusters built by @ref clusterTriangles(), nullptr if it wasn't
+   * called
+   */
+  const std::shared_ptr<const std::vector<gfx::MeshCluster>>& getMeshClusters()
+      const {
+    return meshClusters_;
+  }
 
   /**
    * @brief Build a per-color/per-semantic ID map of all bounding boxes for each
@@ -111,6 +211,12 @@ class GenericSemanticMeshData : public BaseMesh {
    */
   Magnum::GL::Mesh* getMagnumGLMesh() override;
 
+  /**
+   * @brief Estimated memory of the per-vertex CPU buffers and, once
+   * uploaded, of the interleaved GPU buffers
+   */
+  core::MemoryUsage getMemoryUsage() const override;
+
   /**
    * @brief Retrive a reference to this @ref GenericSemanticMeshData 's vertex buffer
    */
@@ -236,6 +342,34 @@ class GenericSemanticMeshData : public BaseMesh {
    */
   void updateCollisionMeshData();
 
+  /**
+   * @brief Assign the semantic object IDs and build the collision data and
+   * bboxes of @p semanticMeshData, whose positions, colors and indices are
+   * filled in already. Shared by @ref buildSemanticMeshData() and
+   * @ref buildSemanticMeshDataFromPly().
+   * @param srcObjectIds Per-vertex object IDs provided by the source mesh, if
+   * any. Otherwise the IDs are derived from the vertex colors.
+   */
+  static std::unique_ptr<GenericSemanticMeshData> finishSemanticMeshData(
+      std::unique_ptr<GenericSemanticMeshData> semanticMeshData,
+      Cr::Containers::Optional<Cr::Containers::Array<Mn::UnsignedInt>>
+          srcObjectIds,
+      const std::string& dbgMsgPrefix,
+      std::vector<Mn::Vector3ub>& colorMapToUse,
+      const std::shared_ptr<scene::SemanticScene>& semanticScene,
+      int numThreads);
+
+  /**
+   * @brief Build the vertex-based semantic bboxes of the objects in
+   * @p semanticScene, if it requests them.
+   * @param numThreads The number of threads fitting the bboxes, see
+   * @ref core::resolveNumThreads().
+   */
+  void buildVertexBasedSemanticOBBs(
+      const std::shared_ptr<scene::SemanticScene>& semanticScene,
+      const std::string& dbgMsgPrefix,
+      int numThreads = 0);
+
  private:
   // ==== rendering ====
   std::unique_ptr<RenderingBuffer> renderingBuffer_ = nullptr;
@@ -245,6 +379,8 @@ class GenericSemanticMeshData : public BaseMesh {
   std::vector<uint16_t> objectIds_;
   // only for mesh paritioning - either points to objectIds_ or to new data
   std::vector<uint16_t> partitionIds_{};
+  // index ranges of cpu_ibo_ culled separately, see clusterTriangles()
+  std::shared_ptr<const std::vector<gfx::MeshCluster>> meshClusters_;
 
   ESP_SMART_POINTERS(GenericSemanticMeshData)
 };
@@ -0,0 +1,65 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshData.h"
+
+#include "esp/core/ParallelFor.h"
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+// Joins with fewer vertices than this aren't worth spawning threads for
+constexpr std::size_t MinParallelJoinVertices = 1 << 16;
+
+}  // namespace
+
+void joinMeshParts(MeshData& mesh,
+                   const std::vector<MeshJoinPart>& parts,
+                   int numThreads) {
+  // first pass: the final place of every part in the output buffers
+  std::vector<std::size_t> vertexOffsets(parts.size());
+  std::vector<std::size_t> indexOffsets(parts.size());
+  std::size_t numVertices = mesh.vbo.size();
+  std::size_t numIndices = mesh.ibo.size();
+  for (std::size_t i = 0; i != parts.size(); ++i) {
+    vertexOffsets[i] = numVertices;
+    indexOffsets[i] = numIndices;
+    numVertices += parts[i].numVertices;
+    numIndices += parts[i].numIndices;
+  }
+  const std::size_t numJoinedVertices = numVertices - mesh.vbo.size();
+  mesh.vbo.resize(numVertices);
+  mesh.ibo.resize(numIndices);
+
+  if (numJoinedVertices < MinParallelJoinVertices) {
+    numThreads = 1;
+  }
+
+  // second pass: transform all vertices of a part at once, which lets Eigen
+  // vectorize the whole batch
+  core::parallelFor(parts.size(), numThreads, [&](std::size_t i, int) {
+    const MeshJoinPart& part = parts[i];
+    if (part.numVertices == 0) {
+      return;
+    }
+    const Eigen::Map<const Eigen::Matrix4f> transform{part.transform.data()};
+    const Eigen::Map<const Eigen::Matrix3Xf> input{
+        part.positions, 3, Eigen::Index(part.numVertices)};
+    Eigen::Map<Eigen::Matrix3Xf> output{mesh.vbo[vertexOffsets[i]].data(), 3,
+                                        Eigen::Index(part.numVertices)};
+    output.noalias() = transform.topLeftCorner<3, 3>() * input;
+    output.colwise() += transform.topRightCorner<3, 1>();
+
+    const auto offset = static_cast<uint32_t>(vertexOffsets[i]);
+    uint32_t* indices = mesh.ibo.data() + indexOffsets[i];
+    for (std::size_t j = 0; j != part.numIndices; ++j) {
+      indices[j] = part.indices[j] + offset;
+    }
+  });
+}
+
+}  // namespace assets
+}  // namespace esp
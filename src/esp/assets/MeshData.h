@@ -5,8 +5,12 @@
 #ifndef ESP_ASSETS_MESHDATA_H_
 #define ESP_ASSETS_MESHDATA_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include <Magnum/Math/Matrix4.h>
+
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
 
@@ -29,6 +33,36 @@ struct MeshData {
   ESP_SMART_POINTERS(MeshData)
 };
 
+/**
+ * @brief A triangle mesh to be transformed and appended by
+ * @ref joinMeshParts(). The referenced data has to stay alive until the join
+ * is done.
+ */
+struct MeshJoinPart {
+  //! Tightly packed XYZ vertex positions
+  const float* positions = nullptr;
+  //! Number of vertices in @ref positions
+  std::size_t numVertices = 0;
+  //! Indices into @ref positions
+  const uint32_t* indices = nullptr;
+  //! Number of indices
+  std::size_t numIndices = 0;
+  //! Transformation applied to the positions
+  Magnum::Matrix4 transform;
+};
+
+/**
+ * @brief Append the transformed positions and the offset indices of @p parts
+ * to the @ref MeshData::vbo and @ref MeshData::ibo of @p mesh.
+ *
+ * The output buffers are grown once for all parts, which are then transformed
+ * into their final place in parallel on up to @p numThreads threads, see
+ * @ref core::resolveNumThreads(). Small joins run on the calling thread only.
+ */
+void joinMeshParts(MeshData& mesh,
+                   const std::vector<MeshJoinPart>& parts,
+                   int numThreads = 0);
+
 }  // namespace assets
 }  // namespace esp
 
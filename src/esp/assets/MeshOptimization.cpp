@@ -0,0 +1,271 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshOptimization.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/MeshTools/Duplicate.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
+#include <Magnum/MeshTools/Tipsify.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Esp.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+// Size of the post-transform vertex cache the triangles are ordered for,
+// conservative for current GPUs
+constexpr std::size_t VertexCacheSize = 24;
+
+// Bump when the layout below changes, older files are then rebuilt
+constexpr char OptimizedMeshMagic[8]{'E', 'S', 'P', 'O', 'M', 'D', '0', '1'};
+
+struct OptimizedMeshHeader {
+  char magic[8];
+  uint32_t primitive;
+  uint32_t indexType;
+  uint32_t indexCount;
+  uint32_t vertexCount;
+  uint32_t attributeCount;
+  uint32_t reserved;
+  uint64_t indexDataSize;
+  uint64_t vertexDataSize;
+};
+
+struct OptimizedMeshAttribute {
+  uint32_t name;
+  uint32_t format;
+  uint64_t offset;
+  int32_t stride;
+  uint16_t arraySize;
+  uint16_t reserved;
+};
+
+bool usesImplementationSpecificFormats(const Mn::Trade::MeshData& mesh) {
+  if (mesh.isIndexed() &&
+      Mn::isMeshIndexTypeImplementationSpecific(mesh.indexType())) {
+    return true;
+  }
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    if (Mn::isVertexFormatImplementationSpecific(mesh.attributeFormat(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+Mn::Trade::MeshData optimizeMeshForRendering(Mn::Trade::MeshData&& mesh) {
+  if (mesh.primitive() != Mn::MeshPrimitive::Triangles ||
+      !mesh.vertexCount() || usesImplementationSpecificFormats(mesh)) {
+    return std::move(mesh);
+  }
+
+  // Indexed and interleaved, each unique vertex once
+  Mn::Trade::MeshData deduplicated =
+      Mn::MeshTools::removeDuplicates(std::move(mesh));
+  const Mn::UnsignedInt indexCount = deduplicated.indexCount();
+  Cr::Containers::Array<char> indexData{
+      Cr::NoInit, indexCount * sizeof(Mn::UnsignedInt)};
+  const auto indices = Cr::Containers::arrayCast<Mn::UnsignedInt>(indexData);
+  deduplicated.indicesInto(indices);
+
+  // Triangle order for the post-transform vertex cache
+  Mn::MeshTools::tipsify(Cr::Containers::stridedArrayView(indices),
+                         deduplicated.vertexCount(), VertexCacheSize);
+
+  // Vertex order for the pre-transform cache and memory locality of vertex
+  // fetch: in which the triangles first use the vertices
+  constexpr Mn::UnsignedInt Unused = ~Mn::UnsignedInt{};
+  Cr::Containers::Array<Mn::UnsignedInt> oldToNew{
+      Cr::DirectInit, deduplicated.vertexCount(), Unused};
+  Cr::Containers::Array<Mn::UnsignedInt> newToOld{
+      Cr::NoInit, deduplicated.vertexCount()};
+  Mn::UnsignedInt vertexCount = 0;
+  for (Mn::UnsignedInt& index : indices) {
+    if (oldToNew[index] == Unused) {
+      newToOld[vertexCount] = index;
+      oldToNew[index] = vertexCount++;
+    }
+    index = oldToNew[index];
+  }
+
+  // Gather the vertices in the new order, indexing the deduplicated ones
+  // with the new to old mapping
+  const Cr::Containers::ArrayView<const Mn::UnsignedInt> order =
+      newToOld.prefix(vertexCount);
+  Mn::Trade::MeshData reordered = Mn::MeshTools::duplicate(Mn::Trade::MeshData{
+      Mn::MeshPrimitive::Triangles, {}, order, Mn::Trade::MeshIndexData{order},
+      {}, deduplicated.vertexData(),
+      Mn::Trade::meshAttributeDataNonOwningArray(deduplicated.attributeData()),
+      deduplicated.vertexCount()});
+
+  const Mn::Trade::MeshIndexData indexView{indices};
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributeData =
+      reordered.releaseAttributeData();
+  Cr::Containers::Array<char> vertexData = reordered.releaseVertexData();
+  return Mn::Trade::MeshData{Mn::MeshPrimitive::Triangles,
+                             std::move(indexData),
+                             indexView,
+                             std::move(vertexData),
+                             std::move(attributeData),
+                             vertexCount};
+}  // optimizeMeshForRendering
+
+bool saveOptimizedMesh(const std::string& filename,
+                       const Mn::Trade::MeshData& mesh) {
+  if (!mesh.isIndexed() || usesImplementationSpecificFormats(mesh)) {
+    return false;
+  }
+
+  const Cr::Containers::StridedArrayView2D<const char> indices =
+      mesh.indices();
+  const std::size_t indexDataSize =
+      mesh.indexCount() * Mn::meshIndexTypeSize(mesh.indexType());
+
+  OptimizedMeshHeader header{};
+  std::memcpy(header.magic, OptimizedMeshMagic, sizeof(header.magic));
+  header.primitive = Mn::UnsignedInt(mesh.primitive());
+  header.indexType = Mn::UnsignedInt(mesh.indexType());
+  header.indexCount = mesh.indexCount();
+  header.vertexCount = mesh.vertexCount();
+  header.attributeCount = mesh.attributeCount();
+  header.indexDataSize = indexDataSize;
+  header.vertexDataSize = mesh.vertexData().size();
+
+  std::string data;
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    OptimizedMeshAttribute attribute{};
+    attribute.name = Mn::UnsignedInt(mesh.attributeName(i));
+    attribute.format = Mn::UnsignedInt(mesh.attributeFormat(i));
+    attribute.offset = mesh.attributeOffset(i);
+    attribute.stride = mesh.attributeStride(i);
+    attribute.arraySize = mesh.attributeArraySize(i);
+    data.append(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+  }
+  // the index view may not span the whole index data, copy just the indices
+  const std::size_t indexStart = data.size();
+  data.resize(indexStart + indexDataSize);
+  Cr::Utility::copy(
+      indices, Cr::Containers::StridedArrayView2D<char>{
+                   Cr::Containers::ArrayView<char>{&data[indexStart],
+                                                   indexDataSize},
+                   indices.size()});
+  data.append(mesh.vertexData().data(), mesh.vertexData().size());
+
+  if (!core::writeFileAtomically(
+          filename,
+          Cr::Containers::ArrayView<const void>{data.data(), data.size()})) {
+    ESP_WARNING() << "Unable to write the optimized mesh" << filename;
+    return false;
+  }
+  return true;
+}  // saveOptimizedMesh
+
+Cr::Containers::Optional<Mn::Trade::MeshData> loadOptimizedMesh(
+    const std::string& filename) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return Cr::Containers::NullOpt;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    return Cr::Containers::NullOpt;
+  }
+  Cr::Containers::ArrayView<const char> in = *file;
+
+  // Everything is validated up front, the MeshData constructor asserts on
+  // out-of-bounds views
+  OptimizedMeshHeader header;
+  bool valid = in.size() >= sizeof(header);
+  if (valid) {
+    std::memcpy(&header, in.data(), sizeof(header));
+    in = in.exceptPrefix(sizeof(header));
+    const auto indexType = Mn::MeshIndexType(header.indexType);
+    valid = std::memcmp(header.magic, OptimizedMeshMagic,
+                        sizeof(header.magic)) == 0 &&
+            (indexType == Mn::MeshIndexType::UnsignedByte ||
+             indexType == Mn::MeshIndexType::UnsignedShort ||
+             indexType == Mn::MeshIndexType::UnsignedInt) &&
+            header.indexDataSize ==
+                std::uint64_t(header.indexCount) *
+                    Mn::meshIndexTypeSize(indexType) &&
+            !Mn::isMeshPrimitiveImplementationSpecific(
+                Mn::MeshPrimitive(header.primitive)) &&
+            in.size() ==
+                header.attributeCount * sizeof(OptimizedMeshAttribute) +
+                    header.indexDataSize + header.vertexDataSize;
+  }
+
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributeData;
+  if (valid) {
+    attributeData = Cr::Containers::Array<Mn::Trade::MeshAttributeData>{
+        header.attributeCount};
+    for (uint32_t i = 0; valid && i != header.attributeCount; ++i) {
+      OptimizedMeshAttribute attribute;
+      std::memcpy(&attribute, in.data(), sizeof(attribute));
+      in = in.exceptPrefix(sizeof(attribute));
+      const auto format = Mn::VertexFormat(attribute.format);
+      if (Mn::isVertexFormatImplementationSpecific(format) ||
+          !attribute.format || attribute.stride <= 0) {
+        valid = false;
+        break;
+      }
+      const std::uint64_t end =
+          attribute.offset +
+          std::uint64_t(header.vertexCount ? header.vertexCount - 1 : 0) *
+              attribute.stride +
+          Mn::vertexFormatSize(format) *
+              (attribute.arraySize ? attribute.arraySize : 1);
+      valid = end <= header.vertexDataSize;
+      attributeData[i] = Mn::Trade::MeshAttributeData{
+          Mn::Trade::MeshAttribute(attribute.name), format, attribute.offset,
+          header.vertexCount, attribute.stride, attribute.arraySize};
+    }
+  }
+  if (!valid) {
+    ESP_WARNING() << "Ignoring the invalid or outdated optimized mesh"
+                  << filename;
+    return Cr::Containers::NullOpt;
+  }
+
+  Cr::Containers::Array<char> indexData{Cr::NoInit, header.indexDataSize};
+  Cr::Utility::copy(in.prefix(header.indexDataSize), indexData);
+  in = in.exceptPrefix(header.indexDataSize);
+  Cr::Containers::Array<char> vertexData{Cr::NoInit, header.vertexDataSize};
+  Cr::Utility::copy(in, vertexData);
+
+  const Mn::Trade::MeshIndexData indexView{
+      Mn::MeshIndexType(header.indexType), indexData};
+  Mn::Trade::MeshData mesh{Mn::MeshPrimitive(header.primitive),
+                           std::move(indexData),
+                           indexView,
+                           std::move(vertexData),
+                           std::move(attributeData),
+                           header.vertexCount};
+  for (const Mn::UnsignedInt index : mesh.indicesAsArray()) {
+    if (index >= header.vertexCount) {
+      ESP_WARNING() << "Ignoring the invalid optimized mesh" << filename;
+      return Cr::Containers::NullOpt;
+    }
+  }
+  return Cr::Containers::optional(std::move(mesh));
+}  // loadOptimizedMesh
+
+}  // namespace assets
+}  // namespace esp
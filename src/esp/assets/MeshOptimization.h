@@ -0,0 +1,54 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_MESHOPTIMIZATION_H_
+#define ESP_ASSETS_MESHOPTIMIZATION_H_
+
+/** @file
+ * @brief Functions @ref esp::assets::optimizeMeshForRendering(),
+ * @ref esp::assets::saveOptimizedMesh(), @ref esp::assets::loadOptimizedMesh()
+ */
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include <string>
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Optimize a triangle mesh for rendering.
+ *
+ * Merges bit-identical vertices, reorders the triangles for the
+ * post-transform vertex cache and then the vertices in the order the
+ * triangles first use them, dropping unused ones. The result is indexed with
+ * 32-bit indices and interleaved. Meshes that aren't triangle meshes or use
+ * implementation-specific formats are returned unchanged.
+ */
+Magnum::Trade::MeshData optimizeMeshForRendering(
+    Magnum::Trade::MeshData&& mesh);
+
+/**
+ * @brief Write a mesh returned by @ref optimizeMeshForRendering() to
+ * @p filename, to be read back with @ref loadOptimizedMesh(). The file is
+ * written to a temporary file first and then moved into place.
+ * @return Whether the mesh was written. Fails for meshes that aren't indexed
+ * or use implementation-specific formats.
+ */
+bool saveOptimizedMesh(const std::string& filename,
+                       const Magnum::Trade::MeshData& mesh);
+
+/**
+ * @brief Read a mesh written by @ref saveOptimizedMesh().
+ * @return The mesh, or @ref Corrade::Containers::NullOpt if the file doesn't
+ * exist or is invalid or outdated.
+ */
+Corrade::Containers::Optional<Magnum::Trade::MeshData> loadOptimizedMesh(
+    const std::string& filename);
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_MESHOPTIMIZATION_H_
@@ -22,8 +22,11 @@
 #include <Corrade/Utility/String.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureArray.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
@@ -50,18 +53,29 @@
 #include <Magnum/Trade/TextureData.h>
 #include <Magnum/VertexFormat.h>
 
+#include <algorithm>
 #include <memory>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "esp/assets/BaseMesh.h"
 #include "esp/assets/CollisionMeshData.h"
 #include "esp/assets/GenericSemanticMeshData.h"
 #include "esp/assets/MeshMetaData.h"
+#include "esp/assets/MeshOptimization.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
+#include "esp/assets/SharedAssetPool.h"
+#include "esp/assets/SharedMemoryAssetStore.h"
+#include "esp/core/Hash.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/Profiler.h"
 #include "esp/geo/Geo.h"
 #include "esp/gfx/DrawableConfiguration.h"
 #include "esp/gfx/GenericDrawable.h"
 #include "esp/gfx/PbrDrawable.h"
+#include "esp/gfx/SemanticColorToId.h"
 #include "esp/gfx/SkinData.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/io/Json.h"
@@ -113,6 +127,109 @@ using Mn::Trade::MaterialAttribute;
 
 namespace assets {
 
+namespace {
+
+// Plugin configuration shared by importerManager_ and the asset decoding
+// workers, so every scene importer picks the same plugins for a file
+void configureImporterPlugins(
+    Cr::PluginManager::Manager<Mn::Trade::AbstractImporter>& manager) {
+#ifdef ESP_BUILD_ASSIMP_SUPPORT
+  manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
+  Cr::PluginManager::PluginMetadata* const assimpmetadata =
+      manager.metadata("AssimpImporter");
+  assimpmetadata->configuration().setValue("ImportColladaIgnoreUpDirection",
+                                           "true");
+#else
+  static_cast<void>(manager);
+#endif
+}
+
+// The file to actually open for a render asset, see precookedAssetFilename()
+std::string renderAssetFileToOpen(const std::string& filename) {
+  const std::string precooked =
+      ResourceManager::precookedAssetFilename(filename);
+  return Cr::Utility::Path::exists(precooked) ? precooked : filename;
+}
+
+// File callback serving files from, and reading missing files into, a cache
+// that's kept until the whole asset is loaded
+Cr::Containers::Optional<Cr::Containers::ArrayView<const char>> loadCachedFile(
+    const std::string& filename,
+    Mn::InputFileCallbackPolicy policy,
+    std::unordered_map<std::string, Cr::Containers::Array<char>>& files) {
+  if (policy == Mn::InputFileCallbackPolicy::Close) {
+    return {};
+  }
+  auto found = files.find(filename);
+  if (found == files.end()) {
+    Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(filename);
+    if (!data) {
+      return {};
+    }
+    found = files.emplace(filename, *std::move(data)).first;
+  }
+  return Cr::Containers::ArrayView<const char>{found->second};
+}
+
+}  // namespace
+
+struct ResourceManager::AssetDecodeWorker {
+  AssetDecodeWorker()
+#ifdef MAGNUM_BUILD_STATIC
+      // avoid using plugins that might depend on different library versions
+      : manager{"nonexistent"}
+#endif
+  {
+    configureImporterPlugins(manager);
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        importer = manager.loadAndInstantiate("AnySceneImporter"));
+  }
+
+  // Match the importer flags and the Basis target format
+  // configureImporterManagerGLExtensions() chose for the main importer
+  void configureLike(Cr::PluginManager::Manager<Importer>& mainManager,
+                     const Importer& mainImporter) {
+    importer->setFlags(mainImporter.flags());
+    Cr::PluginManager::PluginMetadata* const mainBasisMetadata =
+        mainManager.metadata("BasisImporter");
+    Cr::PluginManager::PluginMetadata* const basisMetadata =
+        manager.metadata("BasisImporter");
+    if (mainBasisMetadata && basisMetadata) {
+      basisMetadata->configuration().setValue(
+          "format", mainBasisMetadata->configuration().value("format"));
+    }
+  }
+
+  Cr::PluginManager::Manager<Importer> manager;
+  Cr::Containers::Pointer<Importer> importer;
+  // whether opening the current asset was attempted, and whether it worked
+  bool opened = false;
+  bool usable = false;
+};
+
+struct ResourceManager::PrefetchedAsset {
+  // contents of the asset file and all files it references, by name
+  std::unordered_map<std::string, Cr::Containers::Array<char>> files;
+  // decoded texture images by image ID and mip level
+  std::map<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>,
+           Cr::Containers::Optional<Mn::Trade::ImageData2D>>
+      images;
+};
+
+struct ResourceManager::AssetPrefetch {
+  ~AssetPrefetch() {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  AssetDecodeWorker worker;
+  std::thread thread;
+  // written only by the thread, read only once it's joined
+  std::unordered_map<std::string, PrefetchedAsset> assets;
+};
+
 ResourceManager::ResourceManager(
     metadata::MetadataMediator::ptr _metadataMediator)
     : metadataMediator_(std::move(_metadataMediator))
@@ -132,13 +249,7 @@ ResourceManager::~ResourceManager() = default;
 
 void ResourceManager::buildImporters() {
   // Preferred plugins, Basis target GPU format
-#ifdef ESP_BUILD_ASSIMP_SUPPORT
-  importerManager_.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
-  Cr::PluginManager::PluginMetadata* const assimpmetadata =
-      importerManager_.metadata("AssimpImporter");
-  assimpmetadata->configuration().setValue("ImportColladaIgnoreUpDirection",
-                                           "true");
-#endif
+  configureImporterPlugins(importerManager_);
 
   // instantiate a primitive importer
   CORRADE_INTERNAL_ASSERT_OUTPUT(
@@ -251,20 +362,10 @@ ResourceManager::buildSemanticCCObjects(
 
   AssetInfo semanticInfo = assetInfoMap.at("semantic");
 
-  const std::string& filename = semanticInfo.filepath;
   if (!infoSemanticMeshData_) {
-    /* Open the file. On error the importer already prints a diagnostic message,
-   so no need to do that here. The importer implicitly converts per-face
-   attributes to per-vertex, so nothing extra needs to be done. */
-    ESP_CHECK((fileImporter_->openFile(filename) &&
-               (fileImporter_->meshCount() > 0u)),
-              Cr::Utility::formatString(
-                  "Error loading semantic mesh data from file {}", filename));
-
     // flatten source meshes, preserving transforms, build semanticMeshData and
     // construct vertex-based semantic bboxes, if requested for dataset.
-    infoSemanticMeshData_ =
-        flattenImportedMeshAndBuildSemantic(*fileImporter_, semanticInfo);
+    infoSemanticMeshData_ = flattenImportedMeshAndBuildSemantic(semanticInfo);
   }
 
   // return connectivity query results - per color map of vectors of CC-based
@@ -287,18 +388,9 @@ std::vector<std::string> ResourceManager::buildVertexColorMapReport(
 
   const std::string& filename = semanticInfo.filepath;
   if (!infoSemanticMeshData_) {
-    /* Open the file. On error the importer already prints a diagnostic message,
-       so no need to do that here. The importer implicitly converts per-face
-       attributes to per-vertex, so nothing extra needs to be done. */
-    ESP_CHECK((fileImporter_->openFile(filename) &&
-               (fileImporter_->meshCount() > 0u)),
-              Cr::Utility::formatString(
-                  "Error loading semantic mesh data from file {}", filename));
-
     // flatten source meshes, preserving transforms, build semanticMeshData and
     // construct vertex-based semantic bboxes, if requested for dataset.
-    infoSemanticMeshData_ =
-        flattenImportedMeshAndBuildSemantic(*fileImporter_, semanticInfo);
+    infoSemanticMeshData_ = flattenImportedMeshAndBuildSemantic(semanticInfo);
   }
 
   return infoSemanticMeshData_->getVertColorSSDReport(
@@ -376,6 +468,7 @@ bool ResourceManager::loadStage(
     const std::shared_ptr<physics::PhysicsManager>& _physicsManager,
     esp::scene::SceneManager* sceneManagerPtr,
     std::vector<int>& activeSceneIDs) {
+  ESP_TRACE_SCOPE("loadStage");
   // If the semantic mesh should be created, based on SimulatorConfiguration
   const bool createSemanticMesh =
       metadataMediator_->getSimulatorConfiguration().loadSemanticMesh;
@@ -504,6 +597,7 @@ bool ResourceManager::loadStage(
   auto colInfoIter = assetInfoMap.find("collision");
   if (colInfoIter != assetInfoMap.end()) {
     AssetInfo colInfo = colInfoIter->second;
+    markAssetUsed(colInfo.filepath);
     if (resourceDict_.count(colInfo.filepath) == 0) {
       ESP_DEBUG() << "Start load collision asset" << colInfo.filepath << ".";
       // will not reload if already present
@@ -552,6 +646,7 @@ bool ResourceManager::loadStage(
 bool ResourceManager::buildMeshGroups(
     const AssetInfo& info,
     std::vector<CollisionMeshData>& meshGroup) {
+  ESP_PROFILE_SCOPE("createCollisionShapes");
   auto colMeshGroupIter = collisionMeshGroups_.find(info.filepath);
   if (colMeshGroupIter == collisionMeshGroups_.end()) {
     //! Collect collision mesh group
@@ -800,6 +895,7 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
   bool registerMaterialOverride =
       (info.overridePhongMaterial != Cr::Containers::NullOpt);
   bool fileAssetIsLoaded = resourceDict_.count(info.filepath) > 0;
+  markAssetUsed(info.filepath);
 
   bool meshSuccess = fileAssetIsLoaded;
   // first load the file asset as-is if necessary
@@ -895,6 +991,7 @@ scene::SceneNode* ResourceManager::createRenderAssetInstance(
                  nullptr);
 
   const LoadedAssetData& loadedAssetData = resourceDictIter->second;
+  markAssetUsed(loadedAssetData.assetInfo.filepath);
   if (!isLightSetupCompatible(loadedAssetData, creation.lightSetupKey)) {
     ESP_WARNING(Mn::Debug::Flag::NoSpace)
         << "Instantiating render asset `" << creation.filepath
@@ -985,6 +1082,8 @@ bool ResourceManager::buildStageCollisionMeshGroup(
     std::vector<CollisionMeshData>& meshGroup) {
   // TODO : refactor to manage any mesh groups, not just scene
 
+  shareCollisionMeshes(filename);
+
   //! Collect collision mesh group
   const MeshMetaData& metaData = getMeshMetaData(filename);
   auto indexPair = metaData.meshIndex;
@@ -1007,11 +1106,35 @@ bool ResourceManager::buildStageCollisionMeshGroup(
   return true;
 }  // ResourceManager::buildStageCollisionMeshGroup
 
+void ResourceManager::shareCollisionMeshes(const std::string& filename) {
+  if (!sharedMemoryAssetStore_) {
+    return;
+  }
+  const MeshMetaData& metaData = getMeshMetaData(filename);
+  std::vector<GenericMeshData*> meshes;
+  for (int mesh_i = metaData.meshIndex.first;
+       mesh_i <= metaData.meshIndex.second; ++mesh_i) {
+    const std::shared_ptr<BaseMesh>& mesh = meshes_.at(mesh_i);
+    auto* meshData = dynamic_cast<GenericMeshData*>(mesh.get());
+    // meshes from the SharedAssetPool are used by other resource managers
+    // and must not be modified
+    if (meshData == nullptr || mesh.use_count() > 1) {
+      return;
+    }
+    meshes.push_back(meshData);
+  }
+  if (!meshes.empty() &&
+      !sharedMemoryAssetStore_->shareCollisionMeshes(meshes)) {
+    ESP_DEBUG() << "Collision data of" << filename << "not shared.";
+  }
+}  // ResourceManager::shareCollisionMeshes
+
 bool ResourceManager::loadObjectMeshDataFromFile(
     const std::string& filename,
     const metadata::attributes::ObjectAttributes::ptr& objectAttributes,
     const std::string& meshType,
     const bool forceFlatShading) {
+  ESP_TRACE_SCOPE("loadObjectMeshData");
   bool success = false;
   if (!filename.empty()) {
     AssetInfo meshInfo{AssetType::UNKNOWN, filename};
@@ -1065,7 +1188,11 @@ void ResourceManager::computeGeneralMeshAbsoluteAABBs(
          ++jArray) {
       Cr::Containers::Array<Mn::Vector3> pos =
           meshData->positions3DAsArray(jArray);
-      Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry], pos);
+      // quantized render positions are dequantized first
+      Mn::MeshTools::transformPointsInPlace(
+          absTransforms[iEntry] *
+              meshes_.at(meshID)->getPositionDequantization(),
+          pos);
 
       std::pair<Mn::Vector3, Mn::Vector3> bb = Mn::Math::minmax(pos);
       bbPos.push_back(bb.first);
@@ -1204,6 +1331,8 @@ void ResourceManager::buildPrimitiveAssetData(
 
   if (getCreateRenderer()) {
     primMeshData->uploadBuffersToGPU(false);
+  } else {
+    primMeshData->releaseRenderOnlyData();
   }
 
   // make assetInfo
@@ -1259,18 +1388,14 @@ scene::SceneNode* ResourceManager::createSemanticRenderAssetInstance(
 
 }  // ResourceManager::createSemanticRenderAssetInstance
 
-GenericSemanticMeshData::uptr
-ResourceManager::flattenImportedMeshAndBuildSemantic(Importer& fileImporter,
-                                                     const AssetInfo& info) {
-  const std::string& filename = info.filepath;
-
-  // Transform meshData by reframing frame rotation.  Doing this here so that
-  // transformation is caught in OBB calc.
-  const Mn::Matrix4 reframeTransform = Mn::Matrix4::from(
-      Mn::Quaternion(info.frame.rotationFrameToWorld()).toMatrix(),
-      Mn::Vector3());
+namespace {
 
-  auto sceneID = fileImporter.defaultScene();
+// Flatten all meshes of the default scene of the importer into a single mesh,
+// with the reframe transform applied
+Mn::Trade::MeshData flattenImportedMesh(
+    Mn::Trade::AbstractImporter& importer,
+    const Mn::Matrix4& reframeTransform) {
+  auto sceneID = importer.defaultScene();
   // The meshData to build
   Cr::Containers::Optional<Mn::Trade::MeshData> meshData;
 
@@ -1279,12 +1404,12 @@ ResourceManager::flattenImportedMeshAndBuildSemantic(Importer& fileImporter,
     // already verified at least one mesh exists, this means only one mesh,
     // so no need to merge/flatten anything
     meshData =
-        Mn::MeshTools::transform3D(*fileImporter.mesh(0), reframeTransform);
+        Mn::MeshTools::transform3D(*importer.mesh(0), reframeTransform);
   } else {
     // flatten multi-submesh source meshes, since GenericSemanticMeshData
     // re-partitions based on ID.
     Cr::Containers::Optional<Mn::Trade::SceneData> scene =
-        fileImporter.scene(sceneID);
+        importer.scene(sceneID);
 
     // To access the mesh id
     Cr::Containers::Array<Cr::Containers::Pair<
@@ -1302,7 +1427,7 @@ ResourceManager::flattenImportedMeshAndBuildSemantic(Importer& fileImporter,
     for (std::size_t i = 0; i != meshesMaterials.size(); ++i) {
       Mn::UnsignedInt iMesh = meshesMaterials[i].second().first();
       if (Cr::Containers::Optional<Mn::Trade::MeshData> mesh =
-              fileImporter.mesh(iMesh)) {
+              importer.mesh(iMesh)) {
         arrayAppend(flattenedMeshes,
                     Mn::MeshTools::transform3D(*mesh, transformations[i]));
       }
@@ -1330,16 +1455,164 @@ ResourceManager::flattenImportedMeshAndBuildSemantic(Importer& fileImporter,
 
   }  // flatten/reframe src meshes
 
+  return *std::move(meshData);
+}
+
+}  // namespace
+
+std::string ResourceManager::semanticMeshCacheFilename(
+    const std::string& filename,
+    const Mn::Matrix4& reframeTransform,
+    bool convertToSRGB) const {
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    return {};
+  }
+
+  // everything the built mesh depends on: the file contents, its reframing,
+  // and the SSD color maps
+  core::Fnv1aHash hash;
+  hash.add(file->data(), file->size());
+  hash.add(reframeTransform);
+  hash.add(convertToSRGB);
+  hash.add(semanticColorMapBeingUsed_.data(),
+           semanticColorMapBeingUsed_.size() * sizeof(Mn::Vector3ub));
+  const bool ssdVertColors =
+      semanticScene_ && semanticScene_->hasVertColorsDefined();
+  hash.add(ssdVertColors);
+  if (ssdVertColors) {
+    const auto& colorToIdAndRegion =
+        semanticScene_->getSemanticColorToIdAndRegionMap();
+    std::vector<std::pair<uint32_t, std::pair<int, int>>> sortedColors(
+        colorToIdAndRegion.begin(), colorToIdAndRegion.end());
+    std::sort(sortedColors.begin(), sortedColors.end());
+    for (const auto& color : sortedColors) {
+      hash.add(color.first);
+      hash.add(color.second.first);
+      hash.add(color.second.second);
+    }
+  }
+
+  const std::string hashString = core::hashHexString(hash.value());
+  return Cr::Utility::Path::join(
+      semanticMeshCacheDirectory_,
+      Cr::Utility::formatString("{}.{}.semanticmesh",
+                                Cr::Utility::Path::split(filename).second(),
+                                hashString));
+}  // ResourceManager::semanticMeshCacheFilename
+
+std::string ResourceManager::optimizedMeshCacheFilename(
+    const std::string& filename) const {
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    return {};
+  }
+
+  core::Fnv1aHash hash;
+  hash.add(file->data(), file->size());
+  const std::string hashString = core::hashHexString(hash.value());
+  return Cr::Utility::Path::join(
+      optimizedMeshCacheDirectory_,
+      Cr::Utility::formatString(
+          "{}.{}", Cr::Utility::Path::split(filename).second(), hashString));
+}  // ResourceManager::optimizedMeshCacheFilename
+
+std::string ResourceManager::iblMapCacheFilename(
+    const std::string& envMapFilename,
+    const Cr::Utility::Resource& rs) const {
+  // found where loadIBLImageIntoTexture() looks for it
+  const std::string prefixedFilename =
+      Cr::Utility::formatString("env_maps/{}", envMapFilename);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file;
+  Cr::Containers::ArrayView<const char> data;
+  if (rs.hasFile(envMapFilename)) {
+    data = rs.getRaw(envMapFilename);
+  } else if (rs.hasFile(prefixedFilename)) {
+    data = rs.getRaw(prefixedFilename);
+  } else if ((file = Cr::Utility::Path::read(envMapFilename))) {
+    data = *file;
+  } else {
+    return {};
+  }
+
+  core::Fnv1aHash hash;
+  hash.add(data.data(), data.size());
+  const std::string hashString = core::hashHexString(hash.value());
+  return Cr::Utility::Path::join(
+      iblMapCacheDirectory_,
+      Cr::Utility::formatString(
+          "{}.{}", Cr::Utility::Path::split(envMapFilename).second(),
+          hashString));
+}  // ResourceManager::iblMapCacheFilename
+
+GenericSemanticMeshData::uptr
+ResourceManager::flattenImportedMeshAndBuildSemantic(const AssetInfo& info,
+                                                     Importer* fileImporter) {
+  const std::string& filename = info.filepath;
+  const std::string semanticFilename =
+      Cr::Utility::Path::split(filename).second();
+  const bool isPly = filename.find(".ply") != std::string::npos;
+  const bool convertToSRGB = !isPly;
+
+  // Transform meshData by reframing frame rotation.  Doing this here so that
+  // transformation is caught in OBB calc.
+  const Mn::Matrix4 reframeTransform = Mn::Matrix4::from(
+      Mn::Quaternion(info.frame.rotationFrameToWorld()).toMatrix(),
+      Mn::Vector3());
+
   // build semanticColorMapBeingUsed_ if semanticScene_ is not nullptr
   if (semanticScene_) {
     buildSemanticColorMap();
   }
 
-  GenericSemanticMeshData::uptr semanticMeshData =
-      GenericSemanticMeshData::buildSemanticMeshData(
-          *meshData, Cr::Utility::Path::split(filename).second(),
-          semanticColorMapBeingUsed_,
-          (filename.find(".ply") == std::string::npos), semanticScene_);
+  // skip the import if the same mesh was built with the same semantic
+  // mapping before
+  std::string cacheFilename;
+  GenericSemanticMeshData::uptr semanticMeshData;
+  if (!semanticMeshCacheDirectory_.empty()) {
+    cacheFilename = semanticMeshCacheFilename(filename, reframeTransform,
+                                              convertToSRGB);
+    if (!cacheFilename.empty()) {
+      semanticMeshData = GenericSemanticMeshData::loadFromCache(
+          cacheFilename, semanticFilename, semanticColorMapBeingUsed_,
+          semanticScene_, numAssetDecodeThreads_);
+    }
+  }
+
+  if (!semanticMeshData) {
+    // binary PLY files are decoded directly if they have a layout the
+    // reader handles, everything else goes through the importer
+    if (isPly && !fileImporter) {
+      semanticMeshData = GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+          filename, reframeTransform, semanticColorMapBeingUsed_,
+          semanticScene_, numAssetDecodeThreads_);
+    }
+    if (!semanticMeshData) {
+      if (!fileImporter) {
+        /* Open the file. On error the importer already prints a diagnostic
+           message, so no need to do that here. The importer implicitly
+           converts per-face attributes to per-vertex, so nothing extra needs
+           to be done. */
+        ESP_CHECK((fileImporter_->openFile(filename) &&
+                   (fileImporter_->meshCount() > 0u)),
+                  Cr::Utility::formatString(
+                      "Error loading semantic mesh data from file {}",
+                      filename));
+        fileImporter = fileImporter_.get();
+      }
+      Mn::Trade::MeshData meshData =
+          flattenImportedMesh(*fileImporter, reframeTransform);
+      semanticMeshData = GenericSemanticMeshData::buildSemanticMeshData(
+          meshData, semanticFilename, semanticColorMapBeingUsed_,
+          convertToSRGB, semanticScene_, numAssetDecodeThreads_);
+    }
+    if (!cacheFilename.empty()) {
+      semanticMeshData->saveToCache(cacheFilename, semanticColorMapBeingUsed_,
+                                    semanticScene_);
+    }
+  }
 
   // augment colors_as_int array to handle if un-expected colors have been found
   // in mesh verts.
@@ -1350,6 +1623,7 @@ ResourceManager::flattenImportedMeshAndBuildSemantic(Importer& fileImporter,
 }  // ResourceManager::loadAndFlattenImportedMeshData
 
 bool ResourceManager::loadRenderAssetSemantic(const AssetInfo& info) {
+  ESP_PROFILE_SCOPE("importAsset");
   CORRADE_INTERNAL_ASSERT(info.type == AssetType::INSTANCE_MESH);
 
   const std::string& filename = info.filepath;
@@ -1357,24 +1631,21 @@ bool ResourceManager::loadRenderAssetSemantic(const AssetInfo& info) {
   CORRADE_INTERNAL_ASSERT(resourceDict_.count(filename) == 0);
   configureImporterManagerGLExtensions();
 
-  /* Open the file. On error the importer already prints a diagnostic message,
-     so no need to do that here. The importer implicitly converts per-face
-     attributes to per-vertex, so nothing extra needs to be done. */
-  ESP_CHECK(
-      (fileImporter_->openFile(filename) && (fileImporter_->meshCount() > 0u)),
-      Cr::Utility::formatString("Error loading semantic mesh data from file {}",
-                                filename));
-
   // flatten source meshes, preserving transforms, build semanticMeshData and
   // construct vertex-based semantic bboxes, if requested for dataset.
   GenericSemanticMeshData::uptr semanticMeshData =
-      flattenImportedMeshAndBuildSemantic(*fileImporter_, info);
+      flattenImportedMeshAndBuildSemantic(info);
 
-  // partition semantic mesh for culling
+  // partition semantic mesh for culling, or cluster it to cull it in a single
+  // draw
   std::vector<GenericSemanticMeshData::uptr> instanceMeshes;
-  if (info.splitInstanceMesh && semanticMeshData->meshCanBePartitioned()) {
-    instanceMeshes =
-        GenericSemanticMeshData::partitionSemanticMeshData(semanticMeshData);
+  if (info.splitInstanceMesh && clusterSemanticMeshes_) {
+    semanticMeshData->clusterTriangles();
+    instanceMeshes.emplace_back(std::move(semanticMeshData));
+  } else if (info.splitInstanceMesh &&
+             semanticMeshData->meshCanBePartitioned()) {
+    instanceMeshes = GenericSemanticMeshData::partitionSemanticMeshData(
+        semanticMeshData, numAssetDecodeThreads_);
   } else {
     instanceMeshes.emplace_back(std::move(semanticMeshData));
   }
@@ -1394,6 +1665,7 @@ bool ResourceManager::loadRenderAssetSemantic(const AssetInfo& info) {
   for (int meshIDLocal = 0; meshIDLocal < instanceMeshes.size();
        ++meshIDLocal) {
     if (getCreateRenderer()) {
+      ESP_PROFILE_SCOPE("uploadAsset");
       instanceMeshes[meshIDLocal]->uploadBuffersToGPU(false);
     }
     meshes_.emplace(meshStart + meshIDLocal,
@@ -1453,10 +1725,15 @@ scene::SceneNode* ResourceManager::createRenderAssetInstanceVertSemantic(
     // That means One CANNOT query the data like e.g.,
     // meshes_.at(iMesh)->getMeshData()->hasAttribute(Mn::Trade::MeshAttribute::Tangent)
     // It will SEGFAULT!
-    createDrawable(meshes_.at(iMesh)->getMagnumGLMesh(),  // render mesh
-                   meshAttributeFlags,  // mesh attribute flags
-                   node,                // scene node
-                   drawableConfig);
+    gfx::Drawable& drawable =
+        createDrawable(meshes_.at(iMesh)->getMagnumGLMesh(),  // render mesh
+                       meshAttributeFlags,  // mesh attribute flags
+                       node,                // scene node
+                       drawableConfig);
+    // clustered meshes cull their triangles in the draw itself
+    drawable.setMeshClusters(
+        dynamic_cast<GenericSemanticMeshData&>(*meshes_.at(iMesh))
+            .getMeshClusters());
 
     if (computeAbsoluteAABBs) {
       staticDrawableInfo.emplace_back(StaticDrawableInfo{node, iMesh});
@@ -1470,7 +1747,8 @@ scene::SceneNode* ResourceManager::createRenderAssetInstanceVertSemantic(
   return instanceRoot;
 }  // ResourceManager::createRenderAssetInstanceVertSemantic
 
-void ResourceManager::configureImporterManagerGLExtensions() {
+void ResourceManager::configureImporterManagerGLExtensions(
+    bool precookedAsset) {
   if (!getCreateRenderer()) {
     return;
   }
@@ -1481,6 +1759,38 @@ void ResourceManager::configureImporterManagerGLExtensions() {
     return;
 
   Mn::GL::Context& context = Mn::GL::Context::current();
+  /* Precooked assets are stored Y up, so the transcoded images don't need to
+     be flipped and can use the best formats the GPU has. */
+  if (precookedAsset) {
+#ifdef MAGNUM_TARGET_WEBGL
+    if (context.isExtensionSupported<
+            Mn::GL::Extensions::EXT::texture_compression_bptc>())
+#elif defined(MAGNUM_TARGET_GLES)
+    if (context.isExtensionSupported<
+            Mn::GL::Extensions::EXT::texture_compression_bptc>())
+#else
+    if (context.isExtensionSupported<
+            Mn::GL::Extensions::ARB::texture_compression_bptc>())
+#endif
+    {
+      ESP_DEBUG() << "Importing precooked Basis files as BC7.";
+      metadata->configuration().setValue("format", "Bc7RGBA");
+      return;
+    }
+#ifdef MAGNUM_TARGET_WEBGL
+    if (context.isExtensionSupported<
+            Mn::GL::Extensions::WEBGL::compressed_texture_astc>())
+#else
+    if (context.isExtensionSupported<
+            Mn::GL::Extensions::KHR::texture_compression_astc_ldr>())
+#endif
+    {
+      ESP_DEBUG() << "Importing precooked Basis files as ASTC 4x4.";
+      metadata->configuration().setValue("format", "Astc4x4RGBA");
+      return;
+    }
+  }
+
   /* This is reduced to formats that Magnum currently can Y-flip. More formats
      will get added back with new additions to Magnum/Math/ColorBatch.h. */
 #ifdef MAGNUM_TARGET_WEBGL
@@ -1526,6 +1836,7 @@ void setMeshTransformNodeChildren(
 }  // namespace
 
 bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
+  ESP_PROFILE_SCOPE("importAsset");
   // verify either is general render asset, or else is semantic/instance asset
   // w/texture annotations
   CORRADE_INTERNAL_ASSERT(
@@ -1534,22 +1845,120 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
 
   const std::string& filename = info.filepath;
   CORRADE_INTERNAL_ASSERT(resourceDict_.count(filename) == 0);
-  configureImporterManagerGLExtensions();
+  const std::string fileToOpen = renderAssetFileToOpen(filename);
+  if (fileToOpen != filename) {
+    ESP_DEBUG() << "Loading precooked" << fileToOpen << "for" << filename;
+  }
+  configureImporterManagerGLExtensions(fileToOpen != filename);
+
+  // Read files through what prefetchAssets() loaded for this asset, if
+  // anything. The file callback can only be changed with no file opened.
+  finishAssetPrefetch();
+  fileImporter_->close();
+  openedPrefetchedAsset_ = nullptr;
+  if (assetPrefetch_) {
+    auto found = assetPrefetch_->assets.find(filename);
+    if (found != assetPrefetch_->assets.end()) {
+      openedPrefetchedAsset_.emplace(std::move(found->second));
+      assetPrefetch_->assets.erase(found);
+    }
+  }
+  if (openedPrefetchedAsset_) {
+    fileImporter_->setFileCallback(loadCachedFile,
+                                   openedPrefetchedAsset_->files);
+  } else {
+    fileImporter_->setFileCallback(nullptr);
+  }
 
   ESP_CHECK(
-      (fileImporter_->openFile(filename) && (fileImporter_->meshCount() > 0u)),
+      (fileImporter_->openFile(fileToOpen) &&
+       (fileImporter_->meshCount() > 0u)),
       Cr::Utility::formatString(
           "Error loading general mesh data from file '{}'", filename));
 
+  // Reuse the GPU resources another resource manager uploaded for this
+  // asset, if any. Materials, skins and the hierarchy are still per manager.
+  // Flat shading changes whether the meshes get normals generated.
+  const bool shareAsset = sharedAssetPool_ && getCreateRenderer() &&
+                          requiresTextures_ && !packTextureArrays_;
+  const std::string sharedAssetKey =
+      info.forceFlatShading ? filename + "#flat" : filename;
+  std::shared_ptr<const SharedRenderAsset> sharedAsset;
+  if (shareAsset) {
+    sharedAsset = sharedAssetPool_->find(sharedAssetKey);
+    if (sharedAsset &&
+        (sharedAsset->meshes.size() != fileImporter_->meshCount() ||
+         sharedAsset->textures.size() != fileImporter_->textureCount())) {
+      ESP_WARNING() << "Shared GPU resources of" << filename
+                    << "don't match the file, loading it again";
+      sharedAsset = nullptr;
+    }
+  }
+
   // load file and add it to the dictionary
   LoadedAssetData loadedAssetData{info};
   if (requiresTextures_) {
-    loadTextures(*fileImporter_, loadedAssetData);
+    if (sharedAsset) {
+      const int textureStart = nextTextureID_;
+      nextTextureID_ += sharedAsset->textures.size();
+      loadedAssetData.meshMetaData.setTextureIndices(textureStart,
+                                                     nextTextureID_ - 1);
+      for (std::size_t i = 0; i != sharedAsset->textures.size(); ++i) {
+        textures_.emplace(textureStart + i, sharedAsset->textures[i]);
+      }
+      loadedAssetData.textureBytes = sharedAsset->textureBytes;
+    } else {
+      loadTextures(*fileImporter_, loadedAssetData);
+    }
     loadMaterials(*fileImporter_, loadedAssetData);
   }
-  loadMeshes(*fileImporter_, loadedAssetData);
+  if (sharedAsset) {
+    const int meshStart = nextMeshID_;
+    nextMeshID_ += sharedAsset->meshes.size();
+    loadedAssetData.meshMetaData.setMeshIndices(meshStart, nextMeshID_ - 1);
+    for (std::size_t i = 0; i != sharedAsset->meshes.size(); ++i) {
+      meshes_.emplace(meshStart + i, sharedAsset->meshes[i]);
+    }
+  } else {
+    loadMeshes(*fileImporter_, loadedAssetData);
+  }
   loadSkins(*fileImporter_, loadedAssetData);
 
+  if (shareAsset && !sharedAsset) {
+    SharedRenderAsset asset;
+    const MeshMetaData& meshMetaData = loadedAssetData.meshMetaData;
+    for (int i = meshMetaData.meshIndex.first;
+         i <= meshMetaData.meshIndex.second; ++i) {
+      asset.meshes.push_back(meshes_.at(i));
+    }
+    for (int i = meshMetaData.textureIndex.first;
+         i <= meshMetaData.textureIndex.second; ++i) {
+      asset.textures.push_back(textures_.at(i));
+    }
+    asset.textureBytes = loadedAssetData.textureBytes;
+    // the other contexts may use the resources as soon as they're in the pool
+    Mn::GL::Renderer::finish();
+    sharedAssetPool_->add(sharedAssetKey, std::move(asset));
+  }
+
+  // Register with the asset cache. Meshes keep their data on the CPU, and
+  // another copy on the GPU when rendering.
+  AssetCacheEntry cacheEntry;
+  cacheEntry.numBytes = loadedAssetData.textureBytes;
+  for (int iMesh = loadedAssetData.meshMetaData.meshIndex.first;
+       iMesh <= loadedAssetData.meshMetaData.meshIndex.second; ++iMesh) {
+    const Cr::Containers::Optional<Mn::Trade::MeshData>& meshData =
+        meshes_.at(iMesh)->getMeshData();
+    if (meshData) {
+      const std::size_t meshBytes =
+          meshData->vertexData().size() + meshData->indexData().size();
+      cacheEntry.numBytes += getCreateRenderer() ? 2 * meshBytes : meshBytes;
+    }
+  }
+  assetCacheSize_ += cacheEntry.numBytes;
+  assetCacheEntries_[filename] = cacheEntry;
+  markAssetUsed(filename);
+
   auto inserted = resourceDict_.emplace(filename, std::move(loadedAssetData));
   MeshMetaData& meshMetaData = inserted.first->second.meshMetaData;
 
@@ -1642,6 +2051,165 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
   return true;
 }  // ResourceManager::loadRenderAssetGeneral
 
+void ResourceManager::prefetchAssets(const std::vector<AssetInfo>& assetInfos) {
+#if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // no background thread in single-threaded WebAssembly builds, the assets
+  // get loaded when used
+  static_cast<void>(assetInfos);
+#else
+  finishAssetPrefetch();
+  if (!assetPrefetch_) {
+    assetPrefetch_.emplace();
+  }
+
+  // pairs of file name and whether to decode its textures
+  std::vector<std::pair<std::string, bool>> files;
+  for (const AssetInfo& info : assetInfos) {
+    const std::string& filename = info.filepath;
+    if (!isRenderAssetGeneral(info.type) || resourceDict_.count(filename) ||
+        assetPrefetch_->assets.count(filename) ||
+        std::any_of(files.begin(), files.end(),
+                    [&](const std::pair<std::string, bool>& file) {
+                      return file.first == filename;
+                    })) {
+      continue;
+    }
+    // semantic textures get remapped when loading, see loadTextures(), and
+    // precooked images are transcoded to a different format than the one
+    // configured here
+    files.emplace_back(filename, requiresTextures_ &&
+                                     !info.hasSemanticTextures &&
+                                     renderAssetFileToOpen(filename) ==
+                                         filename);
+  }
+  if (files.empty()) {
+    return;
+  }
+  ESP_DEBUG() << "Prefetching" << files.size() << "render assets";
+
+  // needs the GL context, so do it here before handing over to the thread
+  configureImporterManagerGLExtensions();
+  AssetPrefetch& prefetch = *assetPrefetch_;
+  prefetch.worker.configureLike(importerManager_, *fileImporter_);
+  prefetch.thread = std::thread{[&prefetch, files]() {
+    Importer& importer = *prefetch.worker.importer;
+    for (const std::pair<std::string, bool>& file : files) {
+      PrefetchedAsset asset;
+      importer.setFileCallback(loadCachedFile, asset.files);
+      // failures get reported when the asset is actually loaded
+      if (importer.openFile(renderAssetFileToOpen(file.first))) {
+        for (Mn::UnsignedInt iTexture = 0;
+             file.second && iTexture != importer.textureCount(); ++iTexture) {
+          Cr::Containers::Optional<Mn::Trade::TextureData> textureData =
+              importer.texture(iTexture);
+          if (!textureData ||
+              textureData->type() != Mn::Trade::TextureType::Texture2D) {
+            continue;
+          }
+          const Mn::UnsignedInt imageId = textureData->image();
+          const Mn::UnsignedInt levelCount =
+              importer.image2DLevelCount(imageId);
+          for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
+            const std::pair<Mn::UnsignedInt, Mn::UnsignedInt> key{imageId,
+                                                                  level};
+            if (!asset.images.count(key)) {
+              asset.images.emplace(key, importer.image2D(imageId, level));
+            }
+          }
+        }
+        // pulls vertex and index buffers the meshes reference into the cache
+        for (Mn::UnsignedInt iMesh = 0; iMesh != importer.meshCount();
+             ++iMesh) {
+          importer.mesh(iMesh);
+        }
+        importer.close();
+      }
+      importer.setFileCallback(nullptr);
+      prefetch.assets.emplace(file.first, std::move(asset));
+    }
+  }};
+#endif
+}  // ResourceManager::prefetchAssets
+
+void ResourceManager::markAssetUsed(const std::string& filename) {
+  auto found = assetCacheEntries_.find(filename);
+  if (found != assetCacheEntries_.end()) {
+    found->second.lastUse = ++assetCacheClock_;
+    found->second.lastUseScene = assetCacheScene_;
+  }
+}
+
+int ResourceManager::evictUnusedAssets() {
+  if (assetCacheBudget_ == 0 || assetCacheSize_ <= assetCacheBudget_) {
+    return 0;
+  }
+
+  // candidates, least recently used first
+  std::vector<std::pair<std::uint64_t, std::string>> candidates;
+  for (const auto& entry : assetCacheEntries_) {
+    if (entry.second.lastUseScene != assetCacheScene_ &&
+        !pinnedAssets_.count(entry.first)) {
+      candidates.emplace_back(entry.second.lastUse, entry.first);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  int numEvicted = 0;
+  for (const auto& candidate : candidates) {
+    if (assetCacheSize_ <= assetCacheBudget_) {
+      break;
+    }
+    evictAsset(candidate.second);
+    ++numEvicted;
+  }
+  ESP_DEBUG() << "Evicted" << numEvicted << "render assets, the cache now uses"
+              << assetCacheSize_ << "of" << assetCacheBudget_ << "bytes";
+  return numEvicted;
+}  // ResourceManager::evictUnusedAssets
+
+void ResourceManager::evictAsset(const std::string& filename) {
+  auto cacheEntry = assetCacheEntries_.find(filename);
+  CORRADE_INTERNAL_ASSERT(cacheEntry != assetCacheEntries_.end());
+  assetCacheSize_ -= cacheEntry->second.numBytes;
+  assetCacheEntries_.erase(cacheEntry);
+
+  // the asset's data is owned by its own entry, material override variants
+  // share it and carry the same file path in their asset info
+  const MeshMetaData& meshMetaData = resourceDict_.at(filename).meshMetaData;
+  for (int i = meshMetaData.meshIndex.first;
+       i != ID_UNDEFINED && i <= meshMetaData.meshIndex.second; ++i) {
+    meshes_.erase(i);
+  }
+  for (int i = meshMetaData.textureIndex.first;
+       i != ID_UNDEFINED && i <= meshMetaData.textureIndex.second; ++i) {
+    textures_.erase(i);
+    textureArrayLayers_.erase(i);
+  }
+  for (int i = meshMetaData.skinIndex.first;
+       i != ID_UNDEFINED && i <= meshMetaData.skinIndex.second; ++i) {
+    skins_.erase(i);
+  }
+
+  for (auto it = resourceDict_.begin(); it != resourceDict_.end();) {
+    if (it->first == filename || it->second.assetInfo.filepath == filename) {
+      collisionMeshGroups_.erase(it->first);
+      it = resourceDict_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (const auto& callback : assetEvictionCallbacks_) {
+    callback.second(filename);
+  }
+}  // ResourceManager::evictAsset
+
+void ResourceManager::finishAssetPrefetch() {
+  if (assetPrefetch_ && assetPrefetch_->thread.joinable()) {
+    assetPrefetch_->thread.join();
+  }
+}
+
 scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
     const RenderAssetInstanceCreationInfo& creation,
     scene::SceneNode* parent,
@@ -1725,15 +2293,12 @@ scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
   return &newNode;
 }  // ResourceManager::createRenderAssetInstanceGeneralPrimitive
 
-bool ResourceManager::buildTrajectoryVisualization(
-    const std::string& trajVisName,
-    const std::vector<Mn::Vector3>& pts,
-    const std::vector<Mn::Color3>& colorVec,
-    int numSegments,
-    float radius,
-    bool smooth,
-    int numInterp) {
-  // enforce required minimum/reasonable values if illegal values specified
+namespace {
+// enforce required minimum/reasonable values if illegal values specified
+void sanitizeTrajectoryParameters(int& numSegments,
+                                  float& radius,
+                                  bool smooth,
+                                  int& numInterp) {
   if (numSegments < 3) {  // required by circle prim
     numSegments = 3;
   }
@@ -1745,6 +2310,18 @@ bool ResourceManager::buildTrajectoryVisualization(
   if (radius <= 0) {
     radius = .001;
   }
+}
+}  // namespace
+
+bool ResourceManager::buildTrajectoryVisualization(
+    const std::string& trajVisName,
+    const std::vector<Mn::Vector3>& pts,
+    const std::vector<Mn::Color3>& colorVec,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp) {
+  sanitizeTrajectoryParameters(numSegments, radius, smooth, numInterp);
   if (pts.size() < 2) {
     ESP_ERROR() << "Cannot build a trajectory from fewer than 2 points, so "
                    "trajectory build failed.";
@@ -1763,13 +2340,60 @@ bool ResourceManager::buildTrajectoryVisualization(
                                     numInterp);
   ESP_VERY_VERBOSE() << "Successfully returned from trajectoryTubeSolid";
 
+  return loadTrajectoryVisualization(trajVisName, *std::move(trajTubeMesh));
+}  // ResourceManager::buildTrajectoryVisualization
+
+bool ResourceManager::buildTrajectoryVisualization(
+    const std::string& trajVisName,
+    const std::vector<std::vector<Mn::Vector3>>& trajectories,
+    const std::vector<std::vector<Mn::Color3>>& colorVecs,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp,
+    int numThreads) {
+  sanitizeTrajectoryParameters(numSegments, radius, smooth, numInterp);
+  if (trajectories.empty()) {
+    ESP_ERROR() << "Cannot build a trajectory visualization without "
+                   "trajectories, so trajectory build failed.";
+    return false;
+  }
+  for (const auto& pts : trajectories) {
+    if (pts.size() < 2) {
+      ESP_ERROR() << "Cannot build a trajectory from fewer than 2 points, so "
+                     "trajectory build failed.";
+      return false;
+    }
+  }
+  if (colorVecs.size() != 1 && colorVecs.size() != trajectories.size()) {
+    ESP_ERROR() << "Expected one or" << trajectories.size()
+                << "color arrays but got" << colorVecs.size()
+                << "so trajectory build failed.";
+    return false;
+  }
+
+  ESP_VERY_VERBOSE() << "Calling trajectoryTubesSolid to build"
+                     << trajectories.size() << "tubes named" << trajVisName
+                     << "with tube radius" << radius << "," << numSegments
+                     << "circular segments and" << numInterp
+                     << "interpolated points between each trajectory point.";
+
+  return loadTrajectoryVisualization(
+      trajVisName, geo::buildTrajectoryTubesSolid(
+                       trajectories, colorVecs, numSegments, radius, smooth,
+                       numInterp, geo::ColorSpace::HSV, numThreads));
+}  // ResourceManager::buildTrajectoryVisualization
+
+bool ResourceManager::loadTrajectoryVisualization(
+    const std::string& trajVisName,
+    Mn::Trade::MeshData&& trajTubeMesh) {
   // make assetInfo
   AssetInfo info{AssetType::PRIMITIVE};
   info.forceFlatShading = false;
   // set up primitive mesh
   // make  primitive mesh structure
   auto visMeshData = std::make_unique<GenericMeshData>(false);
-  visMeshData->setMeshData(*std::move(trajTubeMesh));
+  visMeshData->setMeshData(std::move(trajTubeMesh));
   // compute the mesh bounding box
   visMeshData->BB = computeMeshBB(visMeshData.get());
 
@@ -1828,9 +2452,30 @@ bool ResourceManager::buildTrajectoryVisualization(
   return true;
 }  // ResourceManager::loadTrajectoryVisualization
 
+ResourceManager::AssetMemoryUsage ResourceManager::getAssetMemoryUsage()
+    const {
+  AssetMemoryUsage usage;
+  for (const auto& mesh : meshes_) {
+    if (!mesh.second) {
+      continue;
+    }
+    if (dynamic_cast<const GenericSemanticMeshData*>(mesh.second.get())) {
+      usage.semanticMeshes += mesh.second->getMemoryUsage();
+    } else {
+      usage.meshes += mesh.second->getMemoryUsage();
+    }
+    usage.collisionMeshes.cpuBytes += mesh.second->getCollisionMemoryUsage();
+  }
+  for (const auto& asset : resourceDict_) {
+    usage.textures.gpuBytes += asset.second.textureBytes;
+  }
+  return usage;
+}  // ResourceManager::getAssetMemoryUsage
+
 int ResourceManager::loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
                                               scene::SceneNode* parent,
                                               DrawableGroup* drawables) {
+  ESP_TRACE_SCOPE("loadNavMeshVisualization");
   int navMeshPrimitiveID = ID_UNDEFINED;
 
   if (!pathFinder.isLoaded()) {
@@ -1841,28 +2486,48 @@ int ResourceManager::loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
     return navMeshPrimitiveID;
   }
 
+  Mn::Range3D bounds;
+  navMeshPrimitiveID =
+      createNavMeshVisualizationPrimitive(*pathFinder.getNavMeshData(), &bounds);
+
+  if (parent != nullptr && drawables != nullptr &&
+      navMeshPrimitiveID != ID_UNDEFINED) {
+    // create the drawable
+    addPrimitiveToDrawables(navMeshPrimitiveID, *parent, drawables);
+    parent->setMeshBB(bounds);
+    parent->computeCumulativeBB();
+  }
+
+  return navMeshPrimitiveID;
+}  // ResourceManager::loadNavMeshVisualization
+
+int ResourceManager::createNavMeshVisualizationPrimitive(
+    const MeshData& navMeshData,
+    Mn::Range3D* bounds) {
+  if (!getCreateRenderer() || navMeshData.ibo.empty()) {
+    return ID_UNDEFINED;
+  }
+
   // create the mesh
   std::vector<Mn::UnsignedInt> indices;
   std::vector<Mn::Vector3> positions;
 
-  const MeshData::ptr navMeshData = pathFinder.getNavMeshData();
-
   // add the vertices
-  positions.resize(navMeshData->vbo.size());
-  for (size_t vix = 0; vix < navMeshData->vbo.size(); ++vix) {
-    positions[vix] = Mn::Vector3{navMeshData->vbo[vix]};
+  positions.resize(navMeshData.vbo.size());
+  for (size_t vix = 0; vix < navMeshData.vbo.size(); ++vix) {
+    positions[vix] = Mn::Vector3{navMeshData.vbo[vix]};
   }
 
-  indices.resize(navMeshData->ibo.size() * 2);
-  for (size_t ix = 0; ix < navMeshData->ibo.size();
+  indices.resize(navMeshData.ibo.size() * 2);
+  for (size_t ix = 0; ix < navMeshData.ibo.size();
        ix += 3) {  // for each triangle, create lines
     size_t nix = ix * 2;
-    indices[nix] = navMeshData->ibo[ix];
-    indices[nix + 1] = navMeshData->ibo[ix + 1];
-    indices[nix + 2] = navMeshData->ibo[ix + 1];
-    indices[nix + 3] = navMeshData->ibo[ix + 2];
-    indices[nix + 4] = navMeshData->ibo[ix + 2];
-    indices[nix + 5] = navMeshData->ibo[ix];
+    indices[nix] = navMeshData.ibo[ix];
+    indices[nix + 1] = navMeshData.ibo[ix + 1];
+    indices[nix + 2] = navMeshData.ibo[ix + 1];
+    indices[nix + 3] = navMeshData.ibo[ix + 2];
+    indices[nix + 4] = navMeshData.ibo[ix + 2];
+    indices[nix + 5] = navMeshData.ibo[ix];
   }
 
   // create a temporary mesh object referencing the above data
@@ -1877,20 +2542,15 @@ int ResourceManager::loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
                                     Cr::Containers::arrayView(positions)}}};
 
   // compile and add the new mesh to the structure
-  navMeshPrimitiveID = nextPrimitiveMeshId;
+  const int navMeshPrimitiveID = nextPrimitiveMeshId;
   primitive_meshes_[nextPrimitiveMeshId++] =
       std::make_unique<Mn::GL::Mesh>(Mn::MeshTools::compile(visualNavMesh));
 
-  if (parent != nullptr && drawables != nullptr &&
-      navMeshPrimitiveID != ID_UNDEFINED) {
-    // create the drawable
-    addPrimitiveToDrawables(navMeshPrimitiveID, *parent, drawables);
-    parent->setMeshBB(Mn::Math::minmax(positions));
-    parent->computeCumulativeBB();
+  if (bounds) {
+    *bounds = Mn::Math::minmax(positions);
   }
-
   return navMeshPrimitiveID;
-}  // ResourceManager::loadNavMeshVisualization
+}  // ResourceManager::createNavMeshVisualizationPrimitive
 
 namespace {
 /**
@@ -2118,6 +2778,16 @@ Mn::Trade::MaterialData createUniversalMaterial(
   return newMaterialData;
 }  // createUniversalMaterial
 
+/**
+ * @brief Whether @p attrName is one of the base layer material textures the
+ * PBR shader can sample from a texture array.
+ */
+bool isArrayPackableTextureName(Cr::Containers::StringView attrName) {
+  return attrName == "BaseColorTexture" ||
+         attrName == "NoneRoughnessMetallicTexture" ||
+         attrName == "NormalTexture" || attrName == "EmissiveTexture";
+}
+
 }  // namespace
 
 // Specifically for building materials that relied on old defaults
@@ -2460,6 +3130,25 @@ void ResourceManager::loadMaterials(Importer& importer,
                                         newAttrName,
                                         (textureBaseIndex + txtrIdx), layerIdx);
               }
+              // Packed textures are referenced by their texture array and
+              // layer, only the base layer textures the PBR shader reads
+              // can be packed
+              auto arrayLayerIter =
+                  textureArrayLayers_.find(textureBaseIndex + txtrIdx);
+              if (arrayLayerIter != textureArrayLayers_.end()) {
+                if (layerIdx == 0 && isArrayPackableTextureName(attrName)) {
+                  const std::string arrayAttrName = Cr::Utility::formatString(
+                      "{}{}Array",
+                      Cr::Utility::String::lowercase(attrName.slice(0, 1)),
+                      attrName.slice(1, attrName.size()));
+                  arrayAppend(newAttributes,
+                              {arrayAttrName + "Pointer",
+                               arrayLayerIter->second.array.get()});
+                  arrayAppend(newAttributes, {arrayAttrName + "Layer",
+                                              arrayLayerIter->second.layer});
+                }
+                continue;
+              }
               arrayAppend(newAttributes,
                           {newAttrName,
                            textures_.at(textureBaseIndex + txtrIdx).get()});
@@ -2630,16 +3319,66 @@ void ResourceManager::loadMeshes(Importer& importer,
   nextMeshID_ = meshEnd + 1;
   loadedAssetData.meshMetaData.setMeshIndices(meshStart, meshEnd);
 
-  for (int iMesh = 0; iMesh < importer.meshCount(); ++iMesh) {
+  // Import all meshes up front when optimizing, so the optimization can run
+  // on several threads. Meshes found in the cache skip both.
+  const int meshCount = importer.meshCount();
+  std::vector<Cr::Containers::Optional<Mn::Trade::MeshData>> meshData(
+      meshCount);
+  if (optimizeMeshes_) {
+    std::string cachePrefix;
+    if (!optimizedMeshCacheDirectory_.empty()) {
+      cachePrefix = optimizedMeshCacheFilename(
+          renderAssetFileToOpen(loadedAssetData.assetInfo.filepath));
+    }
+    const auto cacheFilename = [&](int iMesh) {
+      return Cr::Utility::formatString("{}.{}.mesh", cachePrefix, iMesh);
+    };
+
+    std::vector<int> meshesToOptimize;
+    for (int iMesh = 0; iMesh < meshCount; ++iMesh) {
+      if (!cachePrefix.empty()) {
+        meshData[iMesh] = loadOptimizedMesh(cacheFilename(iMesh));
+      }
+      if (!meshData[iMesh]) {
+        meshData[iMesh] = importer.mesh(iMesh);
+        CORRADE_INTERNAL_ASSERT(meshData[iMesh]);
+        meshesToOptimize.push_back(iMesh);
+      }
+    }
+    core::parallelFor(
+        meshesToOptimize.size(), numAssetDecodeThreads_,
+        [&](std::size_t i, int) {
+          const int iMesh = meshesToOptimize[i];
+          meshData[iMesh] =
+              optimizeMeshForRendering(*std::move(meshData[iMesh]));
+          if (!cachePrefix.empty()) {
+            saveOptimizedMesh(cacheFilename(iMesh), *meshData[iMesh]);
+          }
+        });
+  }
+
+  for (int iMesh = 0; iMesh < meshCount; ++iMesh) {
     // don't need normals if we aren't using lighting
     auto gltfMeshData = std::make_unique<GenericMeshData>(
         !loadedAssetData.assetInfo.forceFlatShading);
-    gltfMeshData->importAndSetMeshData(importer, iMesh);
+    if (meshData[iMesh]) {
+      gltfMeshData->setMeshData(*std::move(meshData[iMesh]));
+      meshData[iMesh] = Cr::Containers::NullOpt;
+    } else {
+      gltfMeshData->importAndSetMeshData(importer, iMesh);
+    }
 
     // compute the mesh bounding box
     gltfMeshData->BB = computeMeshBB(gltfMeshData.get());
     if (getCreateRenderer()) {
+      ESP_PROFILE_SCOPE("uploadAsset");
+      if (quantizeMeshes_) {
+        gltfMeshData->quantizeForRendering();
+      }
       gltfMeshData->uploadBuffersToGPU(false);
+    } else {
+      // without a renderer only the collision data is ever read
+      gltfMeshData->releaseRenderOnlyData();
     }
     meshes_.emplace(meshStart + iMesh, std::move(gltfMeshData));
   }
@@ -2702,6 +3441,90 @@ Mn::Image2D ResourceManager::convertRGBToSemanticId(
   }
   return resImage;
 }  // ResourceManager::convertRGBToSemanticId
+
+std::vector<bool> ResourceManager::findArrayPackableTextures(
+    Importer& importer,
+    const AssetInfo& info,
+    const std::vector<bool>& loadedTextures) const {
+  const ObjectInstanceShaderType shaderTypeToUse = getMaterialShaderType(info);
+  const std::size_t textureCount = loadedTextures.size();
+  std::vector<bool> packable = loadedTextures;
+  // Base layer textures of each material rendered with the PBR shader
+  std::vector<std::vector<Mn::UnsignedInt>> materialTextures;
+
+  for (Mn::UnsignedInt iMaterial = 0; iMaterial != importer.materialCount();
+       ++iMaterial) {
+    Cr::Containers::Optional<Mn::Trade::MaterialData> materialData =
+        importer.material(iMaterial);
+    if (!materialData) {
+      continue;
+    }
+    // Same shader selection as in loadMaterials()
+    if ((shaderTypeToUse != ObjectInstanceShaderType::Material) &&
+        (shaderTypeToUse != ObjectInstanceShaderType::Flat) &&
+        !(compareShaderTypeToMnMatType(shaderTypeToUse, *materialData))) {
+      materialData = createUniversalMaterial(*materialData);
+    }
+    const bool isPbr =
+        checkForPassedShaderType(
+            shaderTypeToUse, *materialData, ObjectInstanceShaderType::PBR,
+            Mn::Trade::MaterialType::PbrMetallicRoughness) ||
+        checkForPassedShaderType(shaderTypeToUse, *materialData,
+                                 ObjectInstanceShaderType::PBR,
+                                 Mn::Trade::MaterialType::PbrClearCoat);
+
+    std::vector<Mn::UnsignedInt> baseTextures;
+    for (Mn::UnsignedInt layerIdx = 0; layerIdx != materialData->layerCount();
+         ++layerIdx) {
+      for (Mn::UnsignedInt mIdx = 0;
+           mIdx != materialData->attributeCount(layerIdx); ++mIdx) {
+        const auto attrName = materialData->attributeName(layerIdx, mIdx);
+        if (materialData->attributeType(layerIdx, mIdx) !=
+                Mn::Trade::MaterialAttributeType::UnsignedInt ||
+            !attrName.hasSuffix("Texture")) {
+          continue;
+        }
+        const Mn::UnsignedInt txtrIdx =
+            materialData->attribute<Mn::UnsignedInt>(layerIdx, mIdx);
+        if (txtrIdx >= textureCount) {
+          continue;
+        }
+        if (!isPbr || layerIdx != 0) {
+          // Other shaders and material layers only sample 2D textures
+          packable[txtrIdx] = false;
+        } else if (isArrayPackableTextureName(attrName)) {
+          baseTextures.push_back(txtrIdx);
+        }
+        // Other base layer textures are unused by the PBR shader
+      }
+    }
+    if (isPbr) {
+      materialTextures.push_back(std::move(baseTextures));
+    }
+  }
+
+  // The shader samples either all or none of a material's base textures from
+  // texture arrays, so unpack the rest of any material with an unpackable
+  // one until no more textures change
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const std::vector<Mn::UnsignedInt>& textures : materialTextures) {
+      if (std::all_of(textures.begin(), textures.end(),
+                      [&](Mn::UnsignedInt idx) { return packable[idx]; })) {
+        continue;
+      }
+      for (const Mn::UnsignedInt idx : textures) {
+        if (packable[idx]) {
+          packable[idx] = false;
+          changed = true;
+        }
+      }
+    }
+  }
+  return packable;
+}  // ResourceManager::findArrayPackableTextures
+
 void ResourceManager::loadTextures(Importer& importer,
                                    LoadedAssetData& loadedAssetData) {
   int textureStart = nextTextureID_;
@@ -2713,27 +3536,19 @@ void ResourceManager::loadTextures(Importer& importer,
     // and save results to informational SemanticMeshData, to facilitate future
     // reporting
     infoSemanticMeshData_ = flattenImportedMeshAndBuildSemantic(
-        importer, loadedAssetData.assetInfo);
+        loadedAssetData.assetInfo, &importer);
 
     // We are assuming that the only textures that exist are the semantic
-    // textures. We build table of all possible colors holding ushorts
-    // representing semantic IDs for those colors. We then assign known semantic
-    // IDs to table entries corresponding the ID's specified color. Unknown
-    // entries have semantic id 0x0 (corresponding to Unknown object in semantic
-    // scene).
+    // textures. 8-bit color images are converted to semantic IDs on the GPU,
+    // looking their colors up in the semantic color map. Other formats go
+    // through a table of all possible colors holding ushorts representing
+    // semantic IDs for those colors, built when first needed. We assign known
+    // semantic IDs to table entries corresponding the ID's specified color.
+    // Unknown entries have semantic id 0x0 (corresponding to Unknown object in
+    // semantic scene).
     //
-    Cr::Containers::Array<Mn::UnsignedShort> clrToSemanticId{
-        Mn::DirectInit, 256 * 256 * 256, Mn::UnsignedShort(0x0)};
-
-    for (std::size_t i = 0; i < semanticColorAsInt_.size(); ++i) {
-      // skip '0x0' (black) color - already mapped 0
-      if (semanticColorAsInt_[i] == 0) {
-        continue;
-      }
-      // assign semantic ID to list at colorAsInt idx
-      clrToSemanticId[semanticColorAsInt_[i]] =
-          static_cast<Mn::UnsignedShort>(i);
-    }
+    gfx::SemanticColorToId gpuClrToSemanticId{semanticColorAsInt_};
+    Cr::Containers::Array<Mn::UnsignedShort> clrToSemanticId;
 
     for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
       auto currentTextureID = textureStart + iTexture;
@@ -2762,54 +3577,182 @@ void ResourceManager::loadTextures(Importer& importer,
         continue;
       }
       // Convert color-based image to semantic image here
+      Cr::Containers::Optional<Mn::GL::TextureFormat> gpuColorFormat;
+      if (!image->isCompressed()) {
+        switch (image->format()) {
+          case Mn::PixelFormat::RGB8Unorm:
+          case Mn::PixelFormat::RGB8Srgb:
+            gpuColorFormat = Mn::GL::TextureFormat::RGB8;
+            break;
+          case Mn::PixelFormat::RGBA8Unorm:
+          case Mn::PixelFormat::RGBA8Srgb:
+            gpuColorFormat = Mn::GL::TextureFormat::RGBA8;
+            break;
+          default:
+            break;
+        }
+      }
+      if (gpuColorFormat) {
+        // upload the colors as they are and convert them in place into the
+        // semantic ID texture, sRGB or not
+        Mn::GL::Texture2D colorTexture;
+        colorTexture.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+            .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+            .setStorage(1, *gpuColorFormat, image->size())
+            .setSubImage(
+                0, {},
+                Mn::ImageView2D{image->storage(),
+                                *gpuColorFormat == Mn::GL::TextureFormat::RGB8
+                                    ? Mn::PixelFormat::RGB8Unorm
+                                    : Mn::PixelFormat::RGBA8Unorm,
+                                image->size(), image->data()});
+        currentTexture->setStorage(1, Mn::GL::TextureFormat::R16UI,
+                                   image->size());
+        gpuClrToSemanticId.convert(colorTexture, *currentTexture,
+                                   image->size());
+        loadedAssetData.textureBytes +=
+            std::size_t(image->size().product()) *
+            pixelFormatSize(Mn::PixelFormat::R16UI);
+        continue;
+      }
+
+      if (clrToSemanticId.isEmpty()) {
+        clrToSemanticId = Cr::Containers::Array<Mn::UnsignedShort>{
+            Mn::DirectInit, 256 * 256 * 256, Mn::UnsignedShort(0x0)};
+        for (std::size_t i = 0; i < semanticColorAsInt_.size(); ++i) {
+          // skip '0x0' (black) color - already mapped 0
+          if (semanticColorAsInt_[i] == 0) {
+            continue;
+          }
+          // assign semantic ID to list at colorAsInt idx
+          clrToSemanticId[semanticColorAsInt_[i]] =
+              static_cast<Mn::UnsignedShort>(i);
+        }
+      }
       auto newImage = convertRGBToSemanticId(*image, clrToSemanticId);
 
       currentTexture
           ->setStorage(1, Mn::GL::TextureFormat::R16UI, newImage.size())
           .setSubImage(0, {}, newImage);
+      loadedAssetData.textureBytes += newImage.data().size();
 
       // Whether semantic RGB or not
     }
   } else {
-    for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
+    // Decode all mip levels of all textures first, possibly on several
+    // threads, so only the upload below is left for the GL context thread.
+    // Textures referencing the same image share its decoded levels.
+    const int textureCount = importer.textureCount();
+    std::vector<Cr::Containers::Optional<Mn::Trade::TextureData>> textureData(
+        textureCount);
+    std::vector<std::vector<std::size_t>> textureImageLevels(textureCount);
+    std::vector<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>> imageLevels;
+    std::map<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>, std::size_t>
+        imageLevelIndices;
+    for (int iTexture = 0; iTexture < textureCount; ++iTexture) {
+      textureData[iTexture] = importer.texture(iTexture);
+      if (!textureData[iTexture] ||
+          textureData[iTexture]->type() != Mn::Trade::TextureType::Texture2D) {
+        continue;
+      }
+      const Mn::UnsignedInt imageId = textureData[iTexture]->image();
+      const std::uint32_t levelCount = importer.image2DLevelCount(imageId);
+      for (std::uint32_t level = 0; level != levelCount; ++level) {
+        auto inserted = imageLevelIndices.emplace(
+            std::make_pair(imageId, level), imageLevels.size());
+        if (inserted.second) {
+          imageLevels.emplace_back(imageId, level);
+        }
+        textureImageLevels[iTexture].push_back(inserted.first->second);
+      }
+    }
+    const std::vector<Cr::Containers::Optional<Mn::Trade::ImageData2D>>
+        images = decodeImageLevels(
+            importer, renderAssetFileToOpen(loadedAssetData.assetInfo.filepath),
+            imageLevels);
+
+    // Textures going into texture arrays, keyed by everything the layers of
+    // one array have to share: GL format, size, mip level count, whether the
+    // mips are generated and the sampler state
+    std::vector<bool> packTexture(textureCount, false);
+    if (packTextureArrays_) {
+      std::vector<bool> loadedTextures(textureCount, false);
+      for (int iTexture = 0; iTexture < textureCount; ++iTexture) {
+        const std::vector<std::size_t>& levels = textureImageLevels[iTexture];
+        loadedTextures[iTexture] =
+            !levels.empty() &&
+            std::all_of(levels.begin(), levels.end(),
+                        [&](std::size_t i) { return bool(images[i]); });
+      }
+      packTexture = findArrayPackableTextures(
+          importer, loadedAssetData.assetInfo, loadedTextures);
+    }
+    typedef std::tuple<Mn::UnsignedInt, Mn::Int, Mn::Int, Mn::UnsignedInt, bool,
+                       Mn::UnsignedInt, Mn::UnsignedInt, Mn::UnsignedInt,
+                       Mn::UnsignedInt, Mn::UnsignedInt>
+        TextureArrayKey;
+    std::map<TextureArrayKey, std::vector<int>> textureArrays;
+
+    for (int iTexture = 0; iTexture < textureCount; ++iTexture) {
       auto currentTextureID = textureStart + iTexture;
       auto txtrIter = textures_.emplace(currentTextureID,
                                         std::make_shared<Mn::GL::Texture2D>());
       auto& currentTexture = txtrIter.first->second;
 
-      auto textureData = importer.texture(iTexture);
-      if (!textureData ||
-          textureData->type() != Mn::Trade::TextureType::Texture2D) {
+      if (!textureData[iTexture] ||
+          textureData[iTexture]->type() != Mn::Trade::TextureType::Texture2D) {
         ESP_ERROR() << "Cannot load texture" << iTexture << "so skipping";
         currentTexture = nullptr;
         continue;
       }
 
+      if (packTexture[iTexture]) {
+        // Uploaded into its texture array below
+        currentTexture = nullptr;
+        const Mn::Trade::TextureData& texture = *textureData[iTexture];
+        const Mn::Trade::ImageData2D& image =
+            *images[textureImageLevels[iTexture][0]];
+        const std::uint32_t levelCount = textureImageLevels[iTexture].size();
+        const bool generateMipmap = levelCount == 1 && !image.isCompressed();
+        const Mn::GL::TextureFormat format =
+            image.isCompressed()
+                ? Mn::GL::textureFormat(image.compressedFormat())
+                : Mn::GL::textureFormat(image.format());
+        textureArrays[TextureArrayKey{
+                          Mn::UnsignedInt(format), image.size().x(),
+                          image.size().y(),
+                          generateMipmap
+                              ? Mn::Math::log2(image.size().max()) + 1
+                              : levelCount,
+                          generateMipmap,
+                          Mn::UnsignedInt(texture.magnificationFilter()),
+                          Mn::UnsignedInt(texture.minificationFilter()),
+                          Mn::UnsignedInt(texture.mipmapFilter()),
+                          Mn::UnsignedInt(texture.wrapping()[0]),
+                          Mn::UnsignedInt(texture.wrapping()[1])}]
+            .push_back(iTexture);
+        continue;
+      }
+
       // Configure the texture
-      // Mn::GL::Texture2D& texture = *(textures_.at(textureStart +
-      // iTexture).get());
-      currentTexture->setMagnificationFilter(textureData->magnificationFilter())
-          .setMinificationFilter(textureData->minificationFilter(),
-                                 textureData->mipmapFilter())
-          .setWrapping(textureData->wrapping().xy());
+      currentTexture
+          ->setMagnificationFilter(textureData[iTexture]->magnificationFilter())
+          .setMinificationFilter(textureData[iTexture]->minificationFilter(),
+                                 textureData[iTexture]->mipmapFilter())
+          .setWrapping(textureData[iTexture]->wrapping().xy());
 
-      // Load all mip levels
-      const std::uint32_t levelCount =
-          importer.image2DLevelCount(textureData->image());
+      // Upload all mip levels
+      const std::uint32_t levelCount = textureImageLevels[iTexture].size();
 
       bool generateMipmap = false;
       for (std::uint32_t level = 0; level != levelCount; ++level) {
-        // TODO:
-        // it seems we have a way to just load the image once in this case,
-        // as long as the image2DName include the full path to the image
-        Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-            importer.image2D(textureData->image(), level);
+        const Cr::Containers::Optional<Mn::Trade::ImageData2D>& image =
+            images[textureImageLevels[iTexture][level]];
         if (!image) {
           ESP_ERROR() << "Cannot load texture image, skipping";
           currentTexture = nullptr;
           break;
         }
-
         Mn::GL::TextureFormat format;
         if (image->isCompressed()) {
           format = Mn::GL::textureFormat(image->compressedFormat());
@@ -2840,6 +3783,7 @@ void ResourceManager::loadTextures(Importer& importer,
           }
         }
 
+        ESP_PROFILE_SCOPE("uploadAsset");
         // For the very first level, allocate the texture
         if (level == 0) {
           // If there is just one level and the image is not compressed, we'll
@@ -2858,6 +3802,7 @@ void ResourceManager::loadTextures(Importer& importer,
         } else {
           currentTexture->setSubImage(level, {}, *image);
         }
+        loadedAssetData.textureBytes += image->data().size();
       }
 
       // Mip level loading failed, fail the whole texture
@@ -2865,14 +3810,172 @@ void ResourceManager::loadTextures(Importer& importer,
         continue;
       }
 
-      // Generate a mipmap if requested
+      // Generate a mipmap if requested, the extra levels add about a third
       if (generateMipmap) {
+        ESP_PROFILE_SCOPE("uploadAsset");
         currentTexture->generateMipmap();
+        loadedAssetData.textureBytes +=
+            images[textureImageLevels[iTexture][0]]->data().size() / 3;
+      }
+    }
+
+    // Upload the packed textures, one array per key and at most as many
+    // layers as the GPU supports
+    const std::size_t maxLayerCount = Mn::GL::Texture2DArray::maxSize().z();
+    for (const auto& textureArray : textureArrays) {
+      const std::vector<int>& arrayTextures = textureArray.second;
+      const Mn::UnsignedInt levelCount = std::get<3>(textureArray.first);
+      const bool generateMipmap = std::get<4>(textureArray.first);
+      for (std::size_t first = 0; first < arrayTextures.size();
+           first += maxLayerCount) {
+        const std::size_t layerCount =
+            std::min(arrayTextures.size() - first, maxLayerCount);
+        const Mn::Trade::TextureData& texture =
+            *textureData[arrayTextures[first]];
+        const Mn::Trade::ImageData2D& firstImage =
+            *images[textureImageLevels[arrayTextures[first]][0]];
+
+        auto array = std::make_shared<Mn::GL::Texture2DArray>();
+        array->setMagnificationFilter(texture.magnificationFilter())
+            .setMinificationFilter(texture.minificationFilter(),
+                                   texture.mipmapFilter())
+            .setWrapping(texture.wrapping());
+        if (!firstImage.isCompressed()) {
+          // Same greyscale expansion as for separate textures
+          const Mn::UnsignedInt channelCount =
+              pixelFormatChannelCount(firstImage.format());
+#ifndef MAGNUM_TARGET_WEBGL
+          if (channelCount == 1) {
+            array->setSwizzle<'r', 'r', 'r', '1'>();
+          } else if (channelCount == 2) {
+            array->setSwizzle<'r', 'r', 'r', 'g'>();
+          }
+#else
+          if (channelCount <= 2) {
+            ESP_WARNING() << "Greyscale texture array incorrectly displays "
+                             "due to greyscale expansion not yet implemented "
+                             "in WebGL.";
+          }
+#endif
+        }
+        ESP_PROFILE_SCOPE("uploadAsset");
+        array->setStorage(
+            levelCount,
+            Mn::GL::TextureFormat(std::get<0>(textureArray.first)),
+            {firstImage.size(), Mn::Int(layerCount)});
+
+        for (std::size_t layer = 0; layer != layerCount; ++layer) {
+          const int iTexture = arrayTextures[first + layer];
+          const Mn::Vector3i offset{0, 0, Mn::Int(layer)};
+          const std::vector<std::size_t>& levels = textureImageLevels[iTexture];
+          for (std::uint32_t level = 0; level != levels.size(); ++level) {
+            const Mn::Trade::ImageData2D& image = *images[levels[level]];
+            if (image.isCompressed()) {
+              array->setCompressedSubImage(
+                  level, offset,
+                  Mn::CompressedImageView3D{image.compressedStorage(),
+                                            image.compressedFormat(),
+                                            {image.size(), 1},
+                                            image.data()});
+            } else {
+              array->setSubImage(
+                  level, offset,
+                  Mn::ImageView3D{image.storage(), image.format(),
+                                  {image.size(), 1}, image.data()});
+            }
+            loadedAssetData.textureBytes += image.data().size();
+          }
+          if (generateMipmap) {
+            loadedAssetData.textureBytes +=
+                images[levels[0]]->data().size() / 3;
+          }
+          textureArrayLayers_[textureStart + iTexture] =
+              TextureArrayLayer{array, Mn::UnsignedInt(layer)};
+        }
+
+        if (generateMipmap) {
+          array->generateMipmap();
+        }
       }
     }
   }  // Whether semantic RGB or not
 }  // ResourceManager::loadTextures
 
+std::vector<Cr::Containers::Optional<Mn::Trade::ImageData2D>>
+ResourceManager::decodeImageLevels(
+    Importer& importer,
+    const std::string& filename,
+    const std::vector<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>>&
+        imageLevels) {
+  std::vector<Cr::Containers::Optional<Mn::Trade::ImageData2D>> images(
+      imageLevels.size());
+
+  // take what prefetchAssets() decoded already
+  std::vector<std::size_t> pending;
+  for (std::size_t i = 0; i != imageLevels.size(); ++i) {
+    if (openedPrefetchedAsset_) {
+      auto found = openedPrefetchedAsset_->images.find(imageLevels[i]);
+      if (found != openedPrefetchedAsset_->images.end() && found->second) {
+        images[i] = std::move(found->second);
+        continue;
+      }
+    }
+    pending.push_back(i);
+  }
+  const int numThreads =
+      core::resolveNumThreads(numAssetDecodeThreads_, pending.size());
+
+  // The calling thread decodes with the asset's own importer, the others open
+  // the asset again with importers of their own. Workers are created here so
+  // plugin initialization doesn't race.
+  while (assetDecodeWorkers_.size() + 1 < std::size_t(numThreads)) {
+    assetDecodeWorkers_.emplace_back(Cr::InPlaceInit);
+  }
+  for (int i = 0; i + 1 < numThreads; ++i) {
+    AssetDecodeWorker& worker = *assetDecodeWorkers_[i];
+    worker.opened = false;
+    worker.usable = false;
+    worker.configureLike(importerManager_, importer);
+  }
+
+  // items of a worker that can't open the file are decoded afterwards
+  std::vector<char> decoded(pending.size(), 0);
+  core::parallelFor(
+      pending.size(), numThreads, [&](std::size_t i, int workerIndex) {
+        Importer* workerImporter = &importer;
+        if (workerIndex != 0) {
+          AssetDecodeWorker& worker = *assetDecodeWorkers_[workerIndex - 1];
+          if (!worker.opened) {
+            worker.opened = true;
+            worker.usable = worker.importer->openFile(filename);
+          }
+          if (!worker.usable) {
+            return;
+          }
+          workerImporter = worker.importer.get();
+        }
+        const std::pair<Mn::UnsignedInt, Mn::UnsignedInt>& imageLevel =
+            imageLevels[pending[i]];
+        images[pending[i]] =
+            workerImporter->image2D(imageLevel.first, imageLevel.second);
+        decoded[i] = 1;
+      });
+
+  for (std::size_t i = 0; i != pending.size(); ++i) {
+    if (!decoded[i]) {
+      const std::pair<Mn::UnsignedInt, Mn::UnsignedInt>& imageLevel =
+          imageLevels[pending[i]];
+      images[pending[i]] =
+          importer.image2D(imageLevel.first, imageLevel.second);
+    }
+  }
+  // don't keep the file data around until the next asset
+  for (int i = 0; i + 1 < numThreads; ++i) {
+    assetDecodeWorkers_[i]->importer->close();
+  }
+  return images;
+}  // ResourceManager::decodeImageLevels
+
 bool ResourceManager::instantiateAssetsOnDemand(
     const metadata::attributes::ObjectAttributes::ptr& objectAttributes) {
   if (!objectAttributes) {
@@ -2902,6 +4005,7 @@ bool ResourceManager::instantiateAssetsOnDemand(
   // whether attributes requires lighting
   bool forceFlatShading = objectAttributes->getForceFlatShading();
   bool renderMeshSuccess = false;
+  markAssetUsed(renderAssetHandle);
   // no resource dict entry exists for renderAssetHandle
   if (resourceDict_.count(renderAssetHandle) == 0) {
     if (objectAttributes->getRenderAssetIsPrimitive()) {
@@ -2933,6 +4037,7 @@ bool ResourceManager::instantiateAssetsOnDemand(
   if (!objectAttributes->getCollisionAssetIsPrimitive()) {
     const auto collisionAssetHandle =
         objectAttributes->getCollisionAssetHandle();
+    markAssetUsed(collisionAssetHandle);
     if (resourceDict_.count(collisionAssetHandle) == 0) {
       bool collisionMeshSuccess = loadObjectMeshDataFromFile(
           collisionAssetHandle, objectAttributes, "collision",
@@ -2946,6 +4051,7 @@ bool ResourceManager::instantiateAssetsOnDemand(
     // then instance
     if (collisionMeshGroups_.count(collisionAssetHandle) == 0) {
       // set collision mesh data
+      shareCollisionMeshes(collisionAssetHandle);
       const MeshMetaData& meshMetaData = getMeshMetaData(collisionAssetHandle);
 
       int start = meshMetaData.meshIndex.first;
@@ -3135,7 +4241,9 @@ void ResourceManager::addComponent(
     createDrawable(mesh,                // render mesh
                    meshAttributeFlags,  // mesh attribute flags
                    node,                // scene node
-                   drawableConfig);     // instance skinning data
+                   drawableConfig)      // instance skinning data
+        .setMeshTransformation(
+            meshes_.at(meshID)->getPositionDequantization());
 
     // compute the bounding box for the mesh we are adding
     if (computeAbsoluteAABBs) {
@@ -3224,21 +4332,23 @@ void ResourceManager::removePrimitiveMesh(int primitiveID) {
   primitive_meshes_.erase(primMeshIter);
 }
 
-void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
-                                     gfx::Drawable::Flags& meshAttributeFlags,
-                                     scene::SceneNode& node,
-                                     gfx::DrawableConfiguration& drawableCfg) {
+gfx::Drawable& ResourceManager::createDrawable(
+    Mn::GL::Mesh* mesh,
+    gfx::Drawable::Flags& meshAttributeFlags,
+    scene::SceneNode& node,
+    gfx::DrawableConfiguration& drawableCfg) {
+  gfx::Drawable* drawable = nullptr;
   switch (drawableCfg.materialDataType_) {
     case ObjectInstanceShaderType::Flat:
     case ObjectInstanceShaderType::Phong:
-      node.addFeature<gfx::GenericDrawable>(
+      drawable = &node.addFeature<gfx::GenericDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
           drawableCfg);
       break;
     case ObjectInstanceShaderType::PBR:
-      node.addFeature<gfx::PbrDrawable>(
+      drawable = &node.addFeature<gfx::PbrDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
@@ -3252,7 +4362,7 @@ void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
   if (mesh) {
     drawableCountAndNumFaces_.second += mesh->count() / 3;
   }
-
+  return *drawable;
 }  // ResourceManager::createDrawable
 
 void ResourceManager::initDefaultLightSetups() {
@@ -3317,8 +4427,12 @@ std::shared_ptr<gfx::PbrIBLHelper> ResourceManager::getOrBuildPBRIBLHelper(
     // images were found and successfully converted into textures.
 
     if (blutTexture && envMapTexture) {
+      std::string bakedMapsPrefix;
+      if (!iblMapCacheDirectory_.empty()) {
+        bakedMapsPrefix = iblMapCacheFilename(envMapFilename, rs);
+      }
       pbrIBLHelper = std::make_shared<gfx::PbrIBLHelper>(
-          shaderManager_, blutTexture, envMapTexture);
+          shaderManager_, blutTexture, envMapTexture, bakedMapsPrefix);
       pbrIBLHelpers_.emplace(helperKey, pbrIBLHelper);
     }
   }  // if found else create
@@ -3470,7 +4584,7 @@ bool ResourceManager::isLightSetupCompatible(
 //! recursively join all sub-components of a mesh into a single unified
 //! MeshData.
 void ResourceManager::joinHierarchy(
-    MeshData& mesh,
+    std::vector<MeshJoinPart>& parts,
     const MeshMetaData& metaData,
     const MeshTransformNode& node,
     const Mn::Matrix4& transformFromParentToWorld) const {
@@ -3481,24 +4595,24 @@ void ResourceManager::joinHierarchy(
     CollisionMeshData& meshData =
         meshes_.at(node.meshIDLocal + metaData.meshIndex.first)
             ->getCollisionMeshData();
-    int lastIndex = mesh.vbo.size();
     if (meshData.primitive != Mn::MeshPrimitive::Triangles) {
       ESP_WARNING(Mn::Debug::Flag::NoSpace)
           << "Unsupported mesh primitive in join: `" << meshData.primitive
           << "` so skipping join.";
     } else {
-      for (const auto& pos : meshData.positions) {
-        mesh.vbo.push_back(Mn::EigenIntegration::cast<vec3f>(
-            transformFromLocalToWorld.transformPoint(pos)));
-      }
-      for (const auto& index : meshData.indices) {
-        mesh.ibo.push_back(index + lastIndex);
-      }
+      MeshJoinPart part;
+      part.positions =
+          reinterpret_cast<const float*>(meshData.positions.data());
+      part.numVertices = meshData.positions.size();
+      part.indices = meshData.indices.data();
+      part.numIndices = meshData.indices.size();
+      part.transform = transformFromLocalToWorld;
+      parts.push_back(part);
     }
   }
 
   for (const auto& child : node.children) {
-    joinHierarchy(mesh, metaData, child, transformFromLocalToWorld);
+    joinHierarchy(parts, metaData, child, transformFromLocalToWorld);
   }
 }
 
@@ -3570,6 +4684,7 @@ void ResourceManager::setLightSetup(gfx::LightSetup setup,
 
   shaderManager_.set(key, std::move(setup), Mn::ResourceDataState::Mutable,
                      Mn::ResourcePolicy::Manual);
+  ++lightSetupVersion_;
 }
 
 std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
@@ -3579,11 +4694,21 @@ std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
   const MeshMetaData& metaData = getMeshMetaData(filename);
 
   Mn::Matrix4 identity;
-  joinHierarchy(*mesh, metaData, metaData.root, identity);
+  std::vector<MeshJoinPart> parts;
+  joinHierarchy(parts, metaData, metaData.root, identity);
+  joinMeshParts(*mesh, parts);
 
   return mesh;
 }
 
+void ResourceManager::appendCollisionMeshJoinParts(
+    std::vector<MeshJoinPart>& parts,
+    const std::string& filename,
+    const Mn::Matrix4& transform) const {
+  const MeshMetaData& metaData = getMeshMetaData(filename);
+  joinHierarchy(parts, metaData, metaData.root, transform);
+}
+
 std::unique_ptr<MeshData> ResourceManager::createJoinedSemanticCollisionMesh(
     std::vector<std::uint16_t>& objectIds,
     const std::string& filename) const {
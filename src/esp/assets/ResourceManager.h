@@ -10,8 +10,10 @@
  */
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -21,6 +23,7 @@
 #include "Asset.h"
 #include "MeshMetaData.h"
 #include "RigManager.h"
+#include "esp/core/MemoryUsage.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/ShaderManager.h"
 #include "esp/gfx/SkinData.h"
@@ -32,6 +35,8 @@ namespace Mn = Magnum;
 namespace esp {
 namespace assets {
 struct PhongMaterialColor;
+class SharedAssetPool;
+class SharedMemoryAssetStore;
 }
 namespace gfx {
 class Drawable;
@@ -85,6 +90,7 @@ class BaseMesh;
 struct CollisionMeshData;
 class GenericSemanticMeshData;
 struct MeshData;
+struct MeshJoinPart;
 struct RenderAssetInstanceCreationInfo;
 // used for shadertype specification
 using metadata::attributes::ObjectInstanceShaderType;
@@ -181,7 +187,8 @@ class ResourceManager {
 
   /**
    * @brief Remap a semantic annotation texture to have the semantic IDs per
-   * pxl.
+   * pxl. 8-bit RGB and RGBA textures are converted on the GPU by
+   * @ref gfx::SemanticColorToId instead.
    * @param srcImage The source texture with the semantic colors.
    * @param clrToSemanticId Large table of all possible colors to their semantic
    * IDs. initialized to 0xffff
@@ -250,6 +257,13 @@ class ResourceManager {
   bool buildStageCollisionMeshGroup(const std::string& filename,
                                     std::vector<CollisionMeshData>& meshGroup);
 
+  /**
+   * @brief Move the collision data of the meshes of @p filename into the
+   * @ref setSharedMemoryAssetStore() store, if any. Does nothing unless all
+   * meshes of the asset are @ref GenericMeshData.
+   */
+  void shareCollisionMeshes(const std::string& filename);
+
   /**
    * @brief Load/instantiate any required render and collision assets for an
    * object, if they do not already exist in @ref resourceDict_ or @ref
@@ -370,6 +384,12 @@ class ResourceManager {
                      const Mn::ResourceKey& key = Mn::ResourceKey{
                          DEFAULT_LIGHTING_KEY});
 
+  /**
+   * @brief Number of @ref setLightSetup() calls so far, to detect changed
+   * lighting
+   */
+  std::uint64_t lightSetupVersion() const { return lightSetupVersion_; }
+
   /**
    * @brief Construct a unified @ref MeshData from a loaded asset's collision
    * meshes.
@@ -382,6 +402,23 @@ class ResourceManager {
   std::unique_ptr<MeshData> createJoinedCollisionMesh(
       const std::string& filename) const;
 
+  /**
+   * @brief Append the collision meshes of a loaded asset to @p parts for
+   * @ref joinMeshParts(), without copying them.
+   *
+   * Unlike @ref createJoinedCollisionMesh(), the parts reference the
+   * collision data of the asset directly, so joining several instances of
+   * assets doesn't keep an intermediate copy of each. The parts are valid
+   * until the asset is unloaded.
+   * @param[out] parts Where to append the parts
+   * @param filename The identifying string key for the asset. See @ref
+   * resourceDict_ and @ref meshes_.
+   * @param transform Transformation of the asset instance
+   */
+  void appendCollisionMeshJoinParts(std::vector<MeshJoinPart>& parts,
+                                    const std::string& filename,
+                                    const Mn::Matrix4& transform) const;
+
   /**
    * @brief Construct a unified @ref MeshData from a loaded asset's semantic
    * meshes.
@@ -450,12 +487,13 @@ class ResourceManager {
    * attached.
    * @param drawableCfg The @ref esp::gfx::DrawableConfiguration that describes
    * the drawable being created.
+   * @return The created drawable.
    */
 
-  void createDrawable(Mn::GL::Mesh* mesh,
-                      gfx::Drawable::Flags& meshAttributeFlags,
-                      scene::SceneNode& node,
-                      gfx::DrawableConfiguration& drawableCfg);
+  gfx::Drawable& createDrawable(Mn::GL::Mesh* mesh,
+                                gfx::Drawable::Flags& meshAttributeFlags,
+                                scene::SceneNode& node,
+                                gfx::DrawableConfiguration& drawableCfg);
 
   /**
    * @brief Remove the specified primitive mesh.
@@ -480,6 +518,19 @@ class ResourceManager {
                                scene::SceneNode* parent,
                                DrawableGroup* drawables);
 
+  /**
+   * @brief Compile the triangle edges of NavMesh triangles, such as from
+   * @ref nav::PathFinder::getNavMeshTileData, into a line primitive for
+   * visualization. Attach it with @ref addPrimitiveToDrawables and release it
+   * with @ref removePrimitiveMesh.
+   * @param navMeshData The triangulated NavMesh polys.
+   * @param[out] bounds If not null, receives the bounds of the lines.
+   * @return The primitive ID of the new mesh or @ref ID_UNDEFINED if
+   * @p navMeshData is empty or there's no renderer.
+   */
+  int createNavMeshVisualizationPrimitive(const MeshData& navMeshData,
+                                          Mn::Range3D* bounds = nullptr);
+
   /**
    * @brief Generate a tube following the passed trajectory of points.
    * @param trajVisName The name to use for the trajectory visualization mesh.
@@ -501,6 +552,33 @@ class ResourceManager {
                                     bool smooth = false,
                                     int numInterp = 10);
 
+  /**
+   * @brief Generate a single asset holding tubes following each of the passed
+   * trajectories of points, so many trajectories draw with one draw call.
+   * @param trajVisName The name to use for the trajectory visualization mesh.
+   * @param trajectories The points of each trajectory, in order
+   * @param colorVecs Array of Colors for each trajectory tube. A single array
+   * is used for all tubes.
+   * @param numSegments The number of the segments around the circumference of
+   * the tubes. Must be greater than or equal to 3.
+   * @param radius The radius of the tubes.
+   * @param smooth Whether to smooth the points in the trajectories or not
+   * @param numInterp The number of interpolations between each trajectory
+   * point, if smoothing.
+   * @param numThreads The number of threads building the tube meshes, see
+   * @ref core::resolveNumThreads().
+   * @return Whether the process was a success or not
+   */
+  bool buildTrajectoryVisualization(
+      const std::string& trajVisName,
+      const std::vector<std::vector<Mn::Vector3>>& trajectories,
+      const std::vector<std::vector<Mn::Color3>>& colorVecs,
+      int numSegments = 3,
+      float radius = .001,
+      bool smooth = false,
+      int numInterp = 10,
+      int numThreads = 1);
+
   /**
    * @brief Build a configuration frame from specified up and front vectors
    * and return it.  If up is not orthogonal to front, will return default
@@ -526,6 +604,337 @@ class ResourceManager {
    */
   inline void setRequiresTextures(bool newVal) { requiresTextures_ = newVal; }
 
+  /**
+   * @brief Set the number of threads decoding the texture images of general
+   * render assets. Each thread beyond the calling one opens the asset with
+   * its own importer, GPU upload stays on the calling thread. The same
+   * threads map the vertex colors of semantic meshes and partition them.
+   * Values <= 0 select the hardware concurrency of the machine, 1 decodes
+   * everything on the calling thread.
+   */
+  void setNumAssetDecodeThreads(int numThreads) {
+    numAssetDecodeThreads_ = numThreads;
+  }
+
+  /**
+   * @brief Get the number of threads decoding the texture images of general
+   * render assets. See @ref setNumAssetDecodeThreads.
+   */
+  int getNumAssetDecodeThreads() const { return numAssetDecodeThreads_; }
+
+  /**
+   * @brief Set a directory caching the semantic meshes built from
+   * vertex-annotated semantic assets.
+   *
+   * The files are keyed by a hash of the asset contents and the semantic
+   * color maps it's built with, so a later load of the same asset skips
+   * importing, flattening and mapping it. An empty path disables the cache.
+   * The directory has to exist.
+   */
+  void setSemanticMeshCacheDirectory(const std::string& directory) {
+    semanticMeshCacheDirectory_ = directory;
+  }
+
+  /**
+   * @brief Directory set with @ref setSemanticMeshCacheDirectory().
+   */
+  const std::string& getSemanticMeshCacheDirectory() const {
+    return semanticMeshCacheDirectory_;
+  }
+
+  /**
+   * @brief Draw vertex-annotated semantic meshes whole, culling clusters of
+   * their triangles, instead of partitioning them into a mesh per semantic
+   * region.
+   *
+   * Each mesh keeps its per-vertex semantic IDs and is drawn by a single
+   * drawable with one multi-draw call of its clusters in view, see
+   * @ref GenericSemanticMeshData::clusterTriangles(). Applies to assets loaded
+   * with frustum culling enabled.
+   */
+  void setClusterSemanticMeshes(bool clusterSemanticMeshes) {
+    clusterSemanticMeshes_ = clusterSemanticMeshes;
+  }
+
+  /**
+   * @brief Whether semantic meshes are drawn with culled clusters. See
+   * @ref setClusterSemanticMeshes.
+   */
+  bool getClusterSemanticMeshes() const { return clusterSemanticMeshes_; }
+
+  /**
+   * @brief Share the GPU resources of general render assets through @p pool.
+   *
+   * Assets another resource manager using the same pool already loaded reuse
+   * its meshes and textures instead of uploading them again, and assets
+   * loaded here are added to the pool. All users of the pool must render with
+   * GL contexts sharing their objects, see
+   * @ref gfx::WindowlessContext::createShared(). Pass nullptr to stop
+   * sharing. Used only when rendering with textures.
+   */
+  void setSharedAssetPool(std::shared_ptr<SharedAssetPool> pool) {
+    sharedAssetPool_ = std::move(pool);
+  }
+
+  /** @brief The pool set with @ref setSharedAssetPool(), if any */
+  const std::shared_ptr<SharedAssetPool>& getSharedAssetPool() const {
+    return sharedAssetPool_;
+  }
+
+  /**
+   * @brief Share the collision data of general assets with other processes
+   * through @p store.
+   *
+   * The positions and indices of collision meshes are moved into the store
+   * when their mesh group is built, so simulator workers on the same node
+   * loading the same scene hold them once, mapped read-only. Semantic meshes
+   * keep their own copies, their vertices are also needed for semantic
+   * queries. Pass nullptr to stop sharing, already shared meshes keep
+   * referencing the store.
+   */
+  void setSharedMemoryAssetStore(
+      std::shared_ptr<SharedMemoryAssetStore> store) {
+    sharedMemoryAssetStore_ = std::move(store);
+  }
+
+  /** @brief The store set with @ref setSharedMemoryAssetStore(), if any */
+  const std::shared_ptr<SharedMemoryAssetStore>& getSharedMemoryAssetStore()
+      const {
+    return sharedMemoryAssetStore_;
+  }
+
+  /**
+   * @brief Optimize the meshes of general render assets for rendering when
+   * importing them.
+   *
+   * Duplicate vertices are merged, and triangles and vertices are reordered
+   * for the GPU vertex caches, see @ref optimizeMeshForRendering(). The
+   * meshes of an asset are optimized on @ref setNumAssetDecodeThreads()
+   * threads.
+   */
+  void setOptimizeMeshes(bool optimizeMeshes) {
+    optimizeMeshes_ = optimizeMeshes;
+  }
+
+  /**
+   * @brief Whether meshes are optimized when importing them. See
+   * @ref setOptimizeMeshes.
+   */
+  bool getOptimizeMeshes() const { return optimizeMeshes_; }
+
+  /**
+   * @brief Quantize the vertex attributes of general render asset meshes to
+   * 16-bit formats when importing them.
+   *
+   * Cuts the GPU memory and vertex fetch bandwidth of the meshes, see
+   * @ref gfx_batch::quantizeMesh(). Drawables apply the per-mesh position
+   * dequantization, collision data and bounding boxes are unaffected. Only
+   * done when a renderer is created.
+   */
+  void setQuantizeMeshes(bool quantizeMeshes) {
+    quantizeMeshes_ = quantizeMeshes;
+  }
+
+  /**
+   * @brief Whether meshes are quantized when importing them. See
+   * @ref setQuantizeMeshes.
+   */
+  bool getQuantizeMeshes() const { return quantizeMeshes_; }
+
+  /**
+   * @brief Set a directory caching the meshes optimized with
+   * @ref setOptimizeMeshes().
+   *
+   * The files are keyed by a hash of the asset contents, so a later load of
+   * the same asset reads the optimized meshes instead of importing and
+   * optimizing them. An empty path disables the cache. The directory has to
+   * exist.
+   */
+  void setOptimizedMeshCacheDirectory(const std::string& directory) {
+    optimizedMeshCacheDirectory_ = directory;
+  }
+
+  /**
+   * @brief Directory set with @ref setOptimizedMeshCacheDirectory().
+   */
+  const std::string& getOptimizedMeshCacheDirectory() const {
+    return optimizedMeshCacheDirectory_;
+  }
+
+  /**
+   * @brief Set a directory caching the irradiance and prefiltered environment
+   * maps computed for image based lighting.
+   *
+   * The maps are keyed by a hash of the environment map contents, so a later
+   * load of the same environment map, also from another process, reads the
+   * maps instead of computing them. An empty path disables the cache. The
+   * directory has to exist.
+   */
+  void setIBLMapCacheDirectory(const std::string& directory) {
+    iblMapCacheDirectory_ = directory;
+  }
+
+  /**
+   * @brief Directory set with @ref setIBLMapCacheDirectory().
+   */
+  const std::string& getIBLMapCacheDirectory() const {
+    return iblMapCacheDirectory_;
+  }
+
+  /**
+   * @brief Set a directory caching the BVHs of stage collision meshes.
+   *
+   * The files are keyed by a hash of the collision mesh and its scaling, so
+   * a later load of the same stage, also from another process, reads the
+   * quantized BVHs instead of building them. Used by the Bullet physics
+   * backend. An empty path disables the cache. The directory has to exist.
+   */
+  void setCollisionBvhCacheDirectory(const std::string& directory) {
+    collisionBvhCacheDirectory_ = directory;
+  }
+
+  /**
+   * @brief Directory set with @ref setCollisionBvhCacheDirectory().
+   */
+  const std::string& getCollisionBvhCacheDirectory() const {
+    return collisionBvhCacheDirectory_;
+  }
+
+  /**
+   * @brief Pack the material textures of general render assets into texture
+   * arrays.
+   *
+   * The base color, metallic-roughness, normal and emissive textures of
+   * materials rendered with the PBR shader are uploaded as layers of one
+   * texture array per size, format and sampler state instead of as separate
+   * textures. Textures used by other shaders or material layers aren't
+   * packed, and neither are the textures of a material any of whose base
+   * textures can't be. Assets loaded with a shared asset pool, see
+   * @ref setSharedAssetPool(), are never packed.
+   */
+  void setPackTextureArrays(bool packTextureArrays) {
+    packTextureArrays_ = packTextureArrays;
+  }
+
+  /**
+   * @brief Whether material textures are packed into texture arrays. See
+   * @ref setPackTextureArrays.
+   */
+  bool getPackTextureArrays() const { return packTextureArrays_; }
+
+  /**
+   * @brief Set the memory budget of the render asset cache, in bytes.
+   *
+   * Loaded general render assets stay resident across scene switches so
+   * assets shared by many scenes aren't loaded again. When their estimated
+   * CPU and GPU memory exceeds the budget, @ref evictUnusedAssets() unloads
+   * the least recently used ones. 0, the default, disables eviction.
+   */
+  void setAssetCacheBudget(std::size_t numBytes) {
+    assetCacheBudget_ = numBytes;
+  }
+
+  /**
+   * @brief Get the memory budget of the render asset cache, in bytes. See
+   * @ref setAssetCacheBudget.
+   */
+  std::size_t getAssetCacheBudget() const { return assetCacheBudget_; }
+
+  /**
+   * @brief Estimated CPU and GPU memory of all loaded general render assets,
+   * in bytes.
+   */
+  std::size_t getAssetCacheSize() const { return assetCacheSize_; }
+
+  /**
+   * @brief Estimated memory of the loaded render assets, by kind. See @ref
+   * getAssetMemoryUsage.
+   */
+  struct AssetMemoryUsage {
+    /** @brief Render meshes, except semantic meshes */
+    core::MemoryUsage meshes;
+    /**
+     * @brief Textures, only on the GPU as the images are released after
+     * upload
+     */
+    core::MemoryUsage textures;
+    /**
+     * @brief Geometry copied for collision shape construction, see @ref
+     * BaseMesh::getCollisionMemoryUsage
+     */
+    core::MemoryUsage collisionMeshes;
+    /** @brief Semantic meshes */
+    core::MemoryUsage semanticMeshes;
+  };
+
+  /**
+   * @brief Estimated CPU and GPU memory of the loaded render assets.
+   *
+   * Assets shared with other simulators through the shared asset pool are
+   * counted by each of them.
+   */
+  AssetMemoryUsage getAssetMemoryUsage() const;
+
+  /**
+   * @brief Set whether a render asset is exempt from eviction. Can be set
+   * before the asset is loaded.
+   *
+   * Assets instanced outside of the current scene, e.g. by a gfx-replay
+   * player, must be pinned to be kept across scene switches.
+   */
+  void setAssetPinned(const std::string& filename, bool pinned) {
+    if (pinned) {
+      pinnedAssets_.insert(filename);
+    } else {
+      pinnedAssets_.erase(filename);
+    }
+  }
+
+  /**
+   * @brief Start a new scene for the render asset cache. Assets loaded or
+   * instanced afterwards count as used by the current scene and are not
+   * evicted by @ref evictUnusedAssets().
+   */
+  void beginAssetCacheScene() { ++assetCacheScene_; }
+
+  /**
+   * @brief Unload the least recently used general render assets not used by
+   * the current scene until the cache is within its budget.
+   *
+   * Instances of evicted assets must not exist anymore, which holds once the
+   * scene graph and physics world of the previous scene are replaced. Data
+   * derived from an evicted asset elsewhere is dropped through the callbacks
+   * registered with @ref addAssetEvictionCallback(). Does nothing if
+   * @ref setAssetCacheBudget() is 0.
+   * @return The number of evicted assets.
+   */
+  int evictUnusedAssets();
+
+  /**
+   * @brief Called with the file name of each asset unloaded by
+   * @ref evictUnusedAssets().
+   */
+  typedef std::function<void(const std::string&)> AssetEvictionCallback;
+
+  /**
+   * @brief Register a callback for dropping data derived from evicted assets,
+   * such as collision shapes built from their collision meshes, so a later
+   * reload of the same file doesn't reuse it.
+   * @return ID to pass to @ref removeAssetEvictionCallback().
+   */
+  int addAssetEvictionCallback(AssetEvictionCallback callback) {
+    assetEvictionCallbacks_.emplace(++lastAssetEvictionCallbackId_,
+                                    std::move(callback));
+    return lastAssetEvictionCallbackId_;
+  }
+
+  /**
+   * @brief Remove a callback registered with @ref addAssetEvictionCallback().
+   */
+  void removeAssetEvictionCallback(int id) {
+    assetEvictionCallbacks_.erase(id);
+  }
+
   /**
    * @brief Set a replay recorder so that ResourceManager can notify it about
    * render assets.
@@ -600,6 +1009,40 @@ class ResourceManager {
    */
   bool loadRenderAsset(const AssetInfo& info);
 
+  /**
+   * @brief Start reading the files and decoding the texture images of general
+   * render assets on a background thread, ahead of loading them.
+   *
+   * Meant for assets of an upcoming scene, prefetched while the current one is
+   * still in use. A later @ref loadRenderAsset() of a prefetched asset only
+   * processes its meshes and uploads everything to the GPU. Assets that are
+   * already loaded or prefetched and assets of other types are ignored.
+   * Loading any general render asset first waits for a running prefetch to
+   * finish. Starting another prefetch likewise waits for a running one, the
+   * results of both are kept until the assets are loaded. Does nothing in
+   * WebAssembly builds without pthreads.
+   */
+  void prefetchAssets(const std::vector<AssetInfo>& assetInfos);
+
+  /**
+   * @brief Name of the precooked variant of a render asset file.
+   *
+   * The Datatool @cb{.sh} precook_asset @ce task writes it as a glTF binary
+   * with interleaved meshes and Basis-compressed KTX2 images with full mip
+   * chains. If the file exists, @ref loadRenderAsset() loads it instead of
+   * @p filename, which takes less CPU time and, when the GPU supports BC7 or
+   * ASTC, less GPU memory.
+   */
+  static std::string precookedAssetFilename(const std::string& filename) {
+    return filename + ".precooked.glb";
+  }
+
+  /**
+   * @brief Wait for a prefetch started with @ref prefetchAssets() to finish.
+   * Does nothing if no prefetch is running.
+   */
+  void finishAssetPrefetch();
+
   /**
    * @brief Get the shader manager.
    */
@@ -726,6 +1169,16 @@ class ResourceManager {
    */
   void buildPrimitiveAssetData(const std::string& primTemplateHandle,
                                const std::string& materialKey);
+
+  /**
+   * @brief Upload a trajectory tube mesh and register it as an asset with
+   * the default trajectory material.
+   * @param trajVisName The name to use for the trajectory visualization mesh.
+   * @param trajTubeMesh The tube mesh.
+   * @return Whether the process was a success or not
+   */
+  bool loadTrajectoryVisualization(const std::string& trajVisName,
+                                   Mn::Trade::MeshData&& trajTubeMesh);
   /**
    * @brief this will build a MaterialData compatible with Flat, Phong and
    * PBR @ref Magnum::Trade::MaterialData, using default attributes
@@ -760,8 +1213,12 @@ class ResourceManager {
    * @brief Configure the importerManager_ GL Extensions appropriately based on
    * compilation flags, before any general assets are imported.  This should
    * only occur if a gl context exists.
+   *
+   * @param precookedAsset Whether the next asset is a precooked one, see
+   * @ref precookedAssetFilename(). Its Basis images need no Y-flip, which
+   * allows transcoding them to BC7 or ASTC.
    */
-  void configureImporterManagerGLExtensions();
+  void configureImporterManagerGLExtensions(bool precookedAsset = false);
 
  protected:
   // ======== Structs and Types only used locally ========
@@ -773,6 +1230,8 @@ class ResourceManager {
   struct LoadedAssetData {
     AssetInfo assetInfo;
     MeshMetaData meshMetaData;
+    /** @brief Estimated GPU memory of the asset's textures, in bytes */
+    std::size_t textureBytes = 0;
   };
 
   /**
@@ -859,6 +1318,41 @@ class ResourceManager {
    */
   void loadTextures(Importer& importer, LoadedAssetData& loadedAssetData);
 
+  /**
+   * @brief Find the textures of an asset that can be packed into texture
+   * arrays, see @ref setPackTextureArrays.
+   *
+   * @param importer The importer already loaded with information for the
+   * asset.
+   * @param info The asset's @ref AssetInfo, selecting the shader its
+   * materials are rendered with.
+   * @param loadedTextures Whether each texture of the asset was loaded
+   * successfully.
+   * @return Whether each texture of the asset can be packed.
+   */
+  std::vector<bool> findArrayPackableTextures(
+      Importer& importer,
+      const AssetInfo& info,
+      const std::vector<bool>& loadedTextures) const;
+
+  /**
+   * @brief Decode the given image levels of the asset opened in @p importer,
+   * distributed over @ref numAssetDecodeThreads_ threads.
+   *
+   * @param importer The importer already loaded with information for the
+   * asset. Used by the calling thread.
+   * @param filename The asset file, opened again by the other threads.
+   * @param imageLevels Pairs of image ID and mip level to decode.
+   * @return The decoded images in the order of @p imageLevels, with
+   * @ref Corrade::Containers::NullOpt for images that failed to decode.
+   */
+  std::vector<Corrade::Containers::Optional<Magnum::Trade::ImageData2D>>
+  decodeImageLevels(
+      Importer& importer,
+      const std::string& filename,
+      const std::vector<std::pair<Magnum::UnsignedInt, Magnum::UnsignedInt>>&
+          imageLevels);
+
   /**
    * @brief Load meshes from importer into assets.
    *
@@ -880,17 +1374,18 @@ class ResourceManager {
   void loadSkins(Importer& importer, LoadedAssetData& loadedAssetData);
 
   /**
-   * @brief Recursively build a unified @ref MeshData from loaded assets via a
-   * tree of @ref MeshTransformNode.
+   * @brief Recursively collect the parts of a unified @ref MeshData from
+   * loaded assets via a tree of @ref MeshTransformNode.
    *
-   * @param[in,out] mesh The @ref MeshData being constructed.
+   * The parts are joined with @ref joinMeshParts().
+   * @param[in,out] parts The parts of the @ref MeshData being constructed.
    * @param metaData The @ref MeshMetaData for the object hierarchy being
    * joined.
    * @param node The current @ref MeshTransformNode in the recursion.
    * @param transformFromParentToWorld The cumulative transformation up to but
    * not including the current @ref MeshTransformNode.
    */
-  void joinHierarchy(MeshData& mesh,
+  void joinHierarchy(std::vector<MeshJoinPart>& parts,
                      const MeshMetaData& metaData,
                      const MeshTransformNode& node,
                      const Mn::Matrix4& transformFromParentToWorld) const;
@@ -1052,13 +1547,42 @@ class ResourceManager {
    * Meshdata, built from the meshes provided by the importer, preserving all
    * transformations.  This building process will also synthesize bounding boxes
    * if requested from the @ref semanticScene_ .
-   * @param fileImporter Importer used to load the scene.
+   *
+   * Without @p fileImporter, the mesh is taken from the cache, or decoded
+   * directly with @ref GenericSemanticMeshData::buildSemanticMeshDataFromPly()
+   * for binary PLY files, and the file is opened in @ref fileImporter_ only if
+   * neither works.
    * @param info AssetInfo describing asset.
+   * @param fileImporter Importer the asset is opened in already, if any.
    * @return The GenericSemanticMeshData being built.
    */
   std::unique_ptr<GenericSemanticMeshData> flattenImportedMeshAndBuildSemantic(
-      Importer& fileImporter,
-      const AssetInfo& info);
+      const AssetInfo& info,
+      Importer* fileImporter = nullptr);
+
+  /**
+   * @brief Path of the file in @ref semanticMeshCacheDirectory_ holding the
+   * semantic mesh of @p filename built with the current semantic color maps,
+   * or an empty string if the asset file can't be read.
+   */
+  std::string semanticMeshCacheFilename(const std::string& filename,
+                                        const Mn::Matrix4& reframeTransform,
+                                        bool convertToSRGB) const;
+
+  /**
+   * @brief Path prefix of the files in @ref optimizedMeshCacheDirectory_
+   * holding the optimized meshes of @p filename, or an empty string if the
+   * asset file can't be read.
+   */
+  std::string optimizedMeshCacheFilename(const std::string& filename) const;
+
+  /**
+   * @brief Path prefix of the files in @ref iblMapCacheDirectory_ holding the
+   * IBL maps computed from the environment map @p envMapFilename, or an empty
+   * string if the environment map can't be read.
+   */
+  std::string iblMapCacheFilename(const std::string& envMapFilename,
+                                  const Cr::Utility::Resource& rs) const;
 
   /**
    * @brief Semantic Mesh backend for loadRenderAsset.  Either use
@@ -1204,6 +1728,20 @@ class ResourceManager {
    */
   std::map<int, std::shared_ptr<Mn::GL::Texture2D>> textures_;
 
+  /**
+   * @brief A texture packed into a layer of a texture array
+   */
+  struct TextureArrayLayer {
+    std::shared_ptr<Mn::GL::Texture2DArray> array;
+    Mn::UnsignedInt layer = 0;
+  };
+
+  /**
+   * @brief Textures of @ref textures_ packed into texture arrays, which have
+   * a null entry there. See @ref setPackTextureArrays.
+   */
+  std::map<int, TextureArrayLayer> textureArrayLayers_;
+
   /**
    * @brief The next available unique ID for loaded materials
    */
@@ -1269,6 +1807,19 @@ class ResourceManager {
    */
   Corrade::Containers::Pointer<Importer> primitiveImporter_;
 
+  /**
+   * @brief File data and decoded images @ref prefetchAssets() produced for one
+   * asset.
+   */
+  struct PrefetchedAsset;
+
+  /**
+   * @brief Prefetched data of the asset last opened in @ref fileImporter_,
+   * which reads files through it. Declared before the importer so it outlives
+   * the opened file.
+   */
+  Corrade::Containers::Pointer<PrefetchedAsset> openedPrefetchedAsset_;
+
   /**
    * @brief Importer used to load generic mesh files (AnySceneImporter)
    */
@@ -1279,6 +1830,151 @@ class ResourceManager {
    */
   Corrade::Containers::Pointer<Importer> imageImporter_;
 
+  /**
+   * @brief Plugin manager and scene importer owned by one texture decoding
+   * thread. Plugin managers aren't thread-safe, so each thread gets its own.
+   */
+  struct AssetDecodeWorker;
+
+  /**
+   * @brief Texture decoding workers, created on first use and kept for later
+   * assets. See @ref setNumAssetDecodeThreads.
+   */
+  std::vector<Corrade::Containers::Pointer<AssetDecodeWorker>>
+      assetDecodeWorkers_;
+
+  /**
+   * @brief See @ref setNumAssetDecodeThreads.
+   */
+  int numAssetDecodeThreads_ = 0;
+
+  /**
+   * @brief See @ref setSemanticMeshCacheDirectory.
+   */
+  std::string semanticMeshCacheDirectory_;
+
+  /**
+   * @brief Bookkeeping for a general render asset in the asset cache
+   */
+  struct AssetCacheEntry {
+    /** @brief Estimated CPU and GPU memory, in bytes */
+    std::size_t numBytes = 0;
+    /** @brief Value of @ref assetCacheClock_ at the last use */
+    std::uint64_t lastUse = 0;
+    /** @brief Value of @ref assetCacheScene_ at the last use */
+    std::size_t lastUseScene = 0;
+  };
+
+  /**
+   * @brief Record a use of a loaded asset for the eviction order. Does
+   * nothing for assets that aren't in the cache.
+   */
+  void markAssetUsed(const std::string& filename);
+
+  /**
+   * @brief Unload an asset, along with its material override variants,
+   * meshes, textures, skins and collision mesh groups, and notify the
+   * @ref addAssetEvictionCallback() callbacks.
+   */
+  void evictAsset(const std::string& filename);
+
+  /**
+   * @brief Cached general render assets by file name. See
+   * @ref setAssetCacheBudget.
+   */
+  std::map<std::string, AssetCacheEntry> assetCacheEntries_;
+
+  /**
+   * @brief Assets exempt from eviction. See @ref setAssetPinned.
+   */
+  std::set<std::string> pinnedAssets_;
+
+  /**
+   * @brief See @ref setAssetCacheBudget.
+   */
+  std::size_t assetCacheBudget_ = 0;
+
+  /**
+   * @brief Sum of @ref AssetCacheEntry::numBytes of all cached assets.
+   */
+  std::size_t assetCacheSize_ = 0;
+
+  /**
+   * @brief Incremented on every asset use, orders the uses.
+   */
+  std::uint64_t assetCacheClock_ = 0;
+
+  /**
+   * @brief Incremented by @ref beginAssetCacheScene.
+   */
+  std::size_t assetCacheScene_ = 0;
+
+  /**
+   * @brief See @ref addAssetEvictionCallback.
+   */
+  std::map<int, AssetEvictionCallback> assetEvictionCallbacks_;
+
+  /**
+   * @brief ID of the last callback added with @ref addAssetEvictionCallback.
+   */
+  int lastAssetEvictionCallbackId_ = 0;
+
+  /**
+   * @brief See @ref setSharedAssetPool.
+   */
+  std::shared_ptr<SharedAssetPool> sharedAssetPool_;
+
+  /**
+   * @brief See @ref setSharedMemoryAssetStore.
+   */
+  std::shared_ptr<SharedMemoryAssetStore> sharedMemoryAssetStore_;
+
+  /**
+   * @brief See @ref setPackTextureArrays.
+   */
+  bool packTextureArrays_ = false;
+
+  /**
+   * @brief See @ref setOptimizeMeshes.
+   */
+  bool optimizeMeshes_ = false;
+
+  /**
+   * @brief See @ref setQuantizeMeshes.
+   */
+  bool quantizeMeshes_ = false;
+
+  /**
+   * @brief See @ref setOptimizedMeshCacheDirectory.
+   */
+  std::string optimizedMeshCacheDirectory_;
+
+  /**
+   * @brief See @ref setIBLMapCacheDirectory.
+   */
+  std::string iblMapCacheDirectory_;
+
+  /**
+   * @brief See @ref setCollisionBvhCacheDirectory.
+   */
+  std::string collisionBvhCacheDirectory_;
+
+  /**
+   * @brief See @ref setClusterSemanticMeshes.
+   */
+  bool clusterSemanticMeshes_ = false;
+
+  /**
+   * @brief Background thread, importer and results of @ref prefetchAssets().
+   */
+  struct AssetPrefetch;
+  Corrade::Containers::Pointer<AssetPrefetch> assetPrefetch_;
+
+  /**
+   * @brief See @ref lightSetupVersion.
+   */
+  std::uint64_t lightSetupVersion_ = 0;
+
   /**
    * @brief Reference to the currently loaded semanticScene Descriptor
    */
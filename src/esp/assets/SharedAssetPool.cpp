@@ -0,0 +1,60 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SharedAssetPool.h"
+
+#include <Magnum/GL/Texture.h>
+
+#include <utility>
+
+#include "esp/assets/BaseMesh.h"
+
+namespace esp {
+namespace assets {
+
+std::shared_ptr<SharedAssetPool> SharedAssetPool::global() {
+  // Held only by its users, so the GL resources are destroyed along with the
+  // last resource manager, while a context is still current
+  static std::mutex mutex;
+  static std::weak_ptr<SharedAssetPool> global;
+  std::lock_guard<std::mutex> lock{mutex};
+  std::shared_ptr<SharedAssetPool> pool = global.lock();
+  if (!pool) {
+    pool = SharedAssetPool::create();
+    global = pool;
+  }
+  return pool;
+}
+
+std::shared_ptr<const SharedRenderAsset> SharedAssetPool::find(
+    const std::string& key) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto found = assets_.find(key);
+  return found != assets_.end() ? found->second : nullptr;
+}
+
+std::shared_ptr<const SharedRenderAsset> SharedAssetPool::add(
+    const std::string& key,
+    SharedRenderAsset asset) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto inserted = assets_.emplace(key, nullptr);
+  if (inserted.second) {
+    inserted.first->second =
+        std::make_shared<const SharedRenderAsset>(std::move(asset));
+  }
+  return inserted.first->second;
+}
+
+std::size_t SharedAssetPool::size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return assets_.size();
+}
+
+void SharedAssetPool::clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  assets_.clear();
+}
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,100 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_SHAREDASSETPOOL_H_
+#define ESP_ASSETS_SHAREDASSETPOOL_H_
+
+/** @file
+ * @brief Class @ref esp::assets::SharedAssetPool, struct
+ * @ref esp::assets::SharedRenderAsset
+ */
+
+#include <Magnum/GL/GL.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace assets {
+
+class BaseMesh;
+
+/**
+ * @brief GPU resources of a render asset, uploaded once and shared by all
+ * @ref ResourceManager instances using the same @ref SharedAssetPool.
+ */
+struct SharedRenderAsset {
+  /** @brief Meshes of the asset, in importer order */
+  std::vector<std::shared_ptr<BaseMesh>> meshes;
+
+  /**
+   * @brief Textures of the asset, in importer order. Null for textures that
+   * failed to load.
+   */
+  std::vector<std::shared_ptr<Magnum::GL::Texture2D>> textures;
+
+  /** @brief Estimated GPU memory of @ref textures, in bytes */
+  std::size_t textureBytes = 0;
+};
+
+/**
+ * @brief Process-wide pool of immutable render asset GPU resources.
+ *
+ * Lets several simulators in one process, each with its own
+ * @ref ResourceManager and GL context, use a single copy of the meshes and
+ * textures of assets they have in common. All contexts using the pool must
+ * share their GL objects, see @ref gfx::WindowlessContext::createShared().
+ * The pool is thread-safe, the shared resources must not be modified.
+ */
+class SharedAssetPool {
+ public:
+  /**
+   * @brief The pool used by simulators sharing GPU resources. Lives as long
+   * as anybody holds a reference, a later call creates a new one.
+   */
+  static std::shared_ptr<SharedAssetPool> global();
+
+  /**
+   * @brief Find the resources of an asset
+   * @param key Identifies the asset and the options it was loaded with
+   * @return The resources or nullptr if the asset isn't in the pool
+   */
+  std::shared_ptr<const SharedRenderAsset> find(const std::string& key) const;
+
+  /**
+   * @brief Add the resources of an asset
+   *
+   * If another @ref ResourceManager added the same asset in the meantime, its
+   * resources are kept and returned instead.
+   * @return The resources in the pool for @p key.
+   */
+  std::shared_ptr<const SharedRenderAsset> add(const std::string& key,
+                                               SharedRenderAsset asset);
+
+  /** @brief Number of assets in the pool */
+  std::size_t size() const;
+
+  /**
+   * @brief Remove all assets. Resource managers keep the resources they
+   * already use.
+   */
+  void clear();
+
+  ESP_SMART_POINTERS(SharedAssetPool)
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<const SharedRenderAsset>> assets_;
+};
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_SHAREDASSETPOOL_H_
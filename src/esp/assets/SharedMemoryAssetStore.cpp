@@ -0,0 +1,190 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SharedMemoryAssetStore.h"
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <cstring>
+#include <utility>
+
+#include "esp/assets/GenericMeshData.h"
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Hash.h"
+#include "esp/core/Logging.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+// Bump whenever the collision block layout changes
+constexpr Mn::UnsignedInt CollisionBlockVersion = 1;
+
+struct CollisionBlockHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedInt meshCount;
+  Mn::UnsignedInt reserved;
+};
+
+// followed by the positions and then the indices of the mesh, the block
+// starts with a table of these
+struct CollisionBlockMesh {
+  Mn::UnsignedInt vertexCount;
+  Mn::UnsignedInt indexCount;
+};
+
+}  // namespace
+
+SharedMemoryAssetStore::SharedMemoryAssetStore(const std::string& directory)
+    : directory_{directory} {
+  if (!Cr::Utility::Path::make(directory_)) {
+    ESP_WARNING() << "Unable to create the shared asset memory directory"
+                  << directory_ << Mn::Debug::nospace
+                  << ", asset data won't be shared";
+  }
+}
+
+std::shared_ptr<const SharedMemoryAssetStore::Block>
+SharedMemoryAssetStore::findLocked(const std::string& key) {
+  auto found = mapped_.find(key);
+  if (found != mapped_.end()) {
+    if (std::shared_ptr<const Block> block = found->second.lock()) {
+      return block;
+    }
+  }
+
+  const std::string filename = Cr::Utility::Path::join(directory_, key);
+  if (!Cr::Utility::Path::exists(filename)) {
+    return nullptr;
+  }
+  Cr::Containers::Optional<Block> mapping =
+      Cr::Utility::Path::mapRead(filename);
+  if (!mapping) {
+    return nullptr;
+  }
+  auto block = std::make_shared<const Block>(*std::move(mapping));
+  mapped_[key] = block;
+  return block;
+}
+
+std::shared_ptr<const SharedMemoryAssetStore::Block>
+SharedMemoryAssetStore::find(const std::string& key) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return findLocked(key);
+}
+
+std::shared_ptr<const SharedMemoryAssetStore::Block>
+SharedMemoryAssetStore::publish(
+    const std::string& key,
+    Cr::Containers::ArrayView<const char> data) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (std::shared_ptr<const Block> block = findLocked(key)) {
+    return block;
+  }
+
+  // other processes may publish the same block at the same time
+  const std::string filename = Cr::Utility::Path::join(directory_, key);
+  if (!core::writeFileAtomically(filename, data)) {
+    ESP_WARNING() << "Unable to write the shared asset block" << filename;
+    return nullptr;
+  }
+  return findLocked(key);
+}
+
+bool SharedMemoryAssetStore::shareCollisionMeshes(
+    const std::vector<GenericMeshData*>& meshes) {
+  std::size_t size = sizeof(CollisionBlockHeader) +
+                     meshes.size() * sizeof(CollisionBlockMesh);
+  for (GenericMeshData* mesh : meshes) {
+    const CollisionMeshData& collision = mesh->getCollisionMeshData();
+    size += collision.positions.size() * sizeof(Mn::Vector3) +
+            collision.indices.size() * sizeof(Mn::UnsignedInt);
+  }
+
+  Cr::Containers::Array<char> data{Cr::ValueInit, size};
+  CollisionBlockHeader header{};
+  std::memcpy(header.magic, "ESPC", sizeof(header.magic));
+  header.version = CollisionBlockVersion;
+  header.meshCount = meshes.size();
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::size_t offset = sizeof(CollisionBlockHeader) +
+                       meshes.size() * sizeof(CollisionBlockMesh);
+  for (std::size_t i = 0; i != meshes.size(); ++i) {
+    const CollisionMeshData& collision = meshes[i]->getCollisionMeshData();
+    const CollisionBlockMesh entry{Mn::UnsignedInt(collision.positions.size()),
+                                   Mn::UnsignedInt(collision.indices.size())};
+    std::memcpy(data.data() + sizeof(CollisionBlockHeader) +
+                    i * sizeof(CollisionBlockMesh),
+                &entry, sizeof(entry));
+    const std::size_t positionBytes =
+        collision.positions.size() * sizeof(Mn::Vector3);
+    const std::size_t indexBytes =
+        collision.indices.size() * sizeof(Mn::UnsignedInt);
+    Cr::Utility::copy(
+        Cr::Containers::arrayCast<const char>(collision.positions),
+        data.slice(offset, offset + positionBytes));
+    Cr::Utility::copy(
+        Cr::Containers::arrayCast<const char>(collision.indices),
+        data.slice(offset + positionBytes,
+                   offset + positionBytes + indexBytes));
+    offset += positionBytes + indexBytes;
+  }
+
+  // the key has to be the same in every process
+  core::Fnv1aHash hash;
+  hash.add(data.data(), data.size());
+  const std::string hashString = core::hashHexString(hash.value());
+  const std::shared_ptr<const Block> block =
+      publish(Cr::Utility::formatString("collision.{}", hashString), data);
+  // a truncated file or a hash collision, keep the process' own copies
+  if (!block || block->size() != data.size() ||
+      std::memcmp(block->data(), data.data(), data.size()) != 0) {
+    if (block) {
+      ESP_WARNING() << "Shared collision block" << hashString
+                    << "doesn't match the collision data, not sharing it";
+    }
+    return false;
+  }
+
+  offset = sizeof(CollisionBlockHeader) +
+           meshes.size() * sizeof(CollisionBlockMesh);
+  for (GenericMeshData* mesh : meshes) {
+    const CollisionMeshData& collision = mesh->getCollisionMeshData();
+    const std::size_t positionBytes =
+        collision.positions.size() * sizeof(Mn::Vector3);
+    const std::size_t indexBytes =
+        collision.indices.size() * sizeof(Mn::UnsignedInt);
+    const auto positions = Cr::Containers::arrayCast<const Mn::Vector3>(
+        block->slice(offset, offset + positionBytes));
+    const auto indices = Cr::Containers::arrayCast<const Mn::UnsignedInt>(
+        block->slice(offset + positionBytes,
+                     offset + positionBytes + indexBytes));
+    mesh->shareCollisionData(block, positions, indices);
+    offset += positionBytes + indexBytes;
+  }
+  return true;
+}
+
+std::size_t SharedMemoryAssetStore::mappedByteSize() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::size_t size = 0;
+  for (const auto& mapped : mapped_) {
+    if (std::shared_ptr<const Block> block = mapped.second.lock()) {
+      size += block->size();
+    }
+  }
+  return size;
+}
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,108 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_SHAREDMEMORYASSETSTORE_H_
+#define ESP_ASSETS_SHAREDMEMORYASSETSTORE_H_
+
+/** @file
+ * @brief Class @ref esp::assets::SharedMemoryAssetStore
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Path.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace assets {
+
+class GenericMeshData;
+
+/**
+ * @brief Store of immutable CPU asset data shared by all processes on a node.
+ *
+ * Blocks are files in a directory on a memory-backed file system such as
+ * `/dev/shm`, named by a hash of their contents. The first process needing a
+ * block writes it, every process then maps it read-only, so the pages are
+ * held once no matter how many simulator workers use the same scene. Blocks
+ * are written to a temporary file and moved in place once complete, a
+ * process never sees a partially written block. Nothing is ever deleted by
+ * the store, the directory is expected to be cleaned up by whoever created
+ * it, e.g. along with the job.
+ *
+ * The store is thread-safe. Blocks stay mapped as long as anybody holds a
+ * reference to them.
+ */
+class SharedMemoryAssetStore {
+ public:
+  /** @brief A read-only mapped block */
+  typedef Corrade::Containers::Array<const char,
+                                     Corrade::Utility::Path::MapDeleter>
+      Block;
+
+  /**
+   * @brief Constructor
+   * @param directory Directory holding the blocks, created if it doesn't
+   *    exist. Should be on a memory-backed file system, otherwise the data is
+   *    still shared but paged in from disk.
+   */
+  explicit SharedMemoryAssetStore(const std::string& directory);
+
+  /** @brief Directory holding the blocks */
+  const std::string& directory() const { return directory_; }
+
+  /**
+   * @brief Find a block
+   * @return The block mapped read-only or nullptr if no process published
+   *    @p key yet
+   */
+  std::shared_ptr<const Block> find(const std::string& key);
+
+  /**
+   * @brief Publish a block
+   *
+   * If the block doesn't exist yet, @p data is written to it.
+   * @return The block for @p key mapped read-only, nullptr if it can't be
+   *    written or mapped.
+   */
+  std::shared_ptr<const Block> publish(
+      const std::string& key,
+      Corrade::Containers::ArrayView<const char> data);
+
+  /**
+   * @brief Make the collision data of @p meshes reference shared memory
+   *
+   * The positions and indices of all meshes are published as a single block
+   * keyed by their contents, and the meshes are switched to it with
+   * @ref GenericMeshData::shareCollisionData(), freeing their own copies.
+   * @return Whether the meshes now reference the store
+   */
+  bool shareCollisionMeshes(const std::vector<GenericMeshData*>& meshes);
+
+  /** @brief Total size of the blocks currently mapped by this process */
+  std::size_t mappedByteSize() const;
+
+  ESP_SMART_POINTERS(SharedMemoryAssetStore)
+
+ private:
+  // expects mutex_ held
+  std::shared_ptr<const Block> findLocked(const std::string& key);
+
+  std::string directory_;
+  mutable std::mutex mutex_;
+  // blocks mapped by this process, so a key is mapped only once
+  std::map<std::string, std::weak_ptr<const Block>> mapped_;
+};
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_SHAREDMEMORYASSETSTORE_H_
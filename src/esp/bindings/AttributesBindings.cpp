@@ -622,6 +622,16 @@ void initAttributesBindings(py::module& m) {
           https://media.disneyanimation.com/uploads/production/publication_asset/48/asset/s2012_pbs_disney_brdf_notes_v3.pdf
                 otherwise, the shader will use a standard Lambertian model, which is easier
                 to calculate but doesn't look as nice, and sometimes can appear washed out.)")
+      .def_property(
+          "pbr_quality",
+          [](PbrShaderAttributes& self) {
+            return Attrs::getPbrShaderQualityName(self.getPbrQuality());
+          },
+          &PbrShaderAttributes::setPbrQuality,
+          R"(The quality tier of the shader, "full" or "fast". The fast tier skips the clearcoat,
+                specular and anisotropy layers, uses Lambertian diffuse and looks up the IBL
+                specular lobe from the irradiance map, for faster rendering of low-resolution
+                observations, e.g. for training.)")
       .def_property(
           "skip_clearcoat_calc",
           &PbrShaderAttributes::getSkipCalcClearcoatLayer,
@@ -713,8 +723,8 @@ void initAttributesBindings(py::module& m) {
                     R"(The timestep to use for forward simulation.)")
       .def_property("max_substeps", &PhysicsManagerAttributes::getMaxSubsteps,
                     &PhysicsManagerAttributes::setMaxSubsteps,
-                    R"(Maximum simulation steps between each rendering step.
-                    (Not currently implemented).)")
+                    R"(Maximum number of fixed timesteps a single physics step may take. Simulation
+                    time beyond that is dropped.)")
       .def_property(
           "gravity", &PhysicsManagerAttributes::getGravity,
           &PhysicsManagerAttributes::setGravity,
@@ -731,7 +741,14 @@ void initAttributesBindings(py::module& m) {
           &PhysicsManagerAttributes::getRestitutionCoefficient,
           &PhysicsManagerAttributes::setRestitutionCoefficient,
           R"(Default restitution coefficient for contact modeling.  Can be overridden by
-          stage and object values.)");
+          stage and object values.)")
+      .def_property(
+          "num_collision_threads",
+          &PhysicsManagerAttributes::getNumCollisionThreads,
+          &PhysicsManagerAttributes::setNumCollisionThreads,
+          R"(Number of threads Bullet uses for collision detection. 1 (default) is
+          single-threaded, values <= 0 use all hardware threads. Requires Bullet built
+          with thread support.)");
 
   // ==== AbstractPrimitiveAttributes ====
   py::class_<AbstractPrimitiveAttributes, AbstractAttributes,
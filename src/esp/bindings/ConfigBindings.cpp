@@ -185,7 +185,9 @@ void initConfigBindings(py::module& m) {
           "key"_a)
 
       .def(
-          "has_value", &Configuration::hasValue,
+          "has_value",
+          py::overload_cast<const std::string&>(&Configuration::hasValue,
+                                                py::const_),
           R"(Returns whether or not this Configuration has the passed key. Does not check subconfigurations.)",
           "key"_a)
       .def(
@@ -3,7 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "esp/bindings/Bindings.h"
+#include "esp/core/AsyncLogSink.h"
+#include "esp/core/MemoryUsage.h"
+#include "esp/core/Profiler.h"
 #include "esp/core/Random.h"
+#include "esp/core/Tracing.h"
 #include "esp/core/Utility.h"
 
 namespace py = pybind11;
@@ -47,9 +51,97 @@ void initCoreBindings(py::module& m) {
       .def_property_readonly("sim_is_quiet", [](LoggingContext& self) -> bool {
         return self.levelFor(logging::Subsystem::sim) >=
                logging::LoggingLevel::Debug;
-      });
+      })
+      .def(
+          "enable_async_sink",
+          [](LoggingContext& self, float messagesPerSecond,
+             bool suppressDuplicates, int flushIntervalMs) {
+            Corrade::Containers::Pointer<logging::AsyncLogSink> sink{
+                Corrade::InPlaceInit,
+                std::chrono::milliseconds{flushIntervalMs}};
+            sink->setRateLimit(messagesPerSecond);
+            sink->setDuplicateSuppression(suppressDuplicates);
+            self.setAsyncSink(std::move(sink));
+          },
+          "messages_per_second"_a = 0.0f, "suppress_duplicates"_a = true,
+          "flush_interval_ms"_a = 100,
+          R"(Write log messages from a background thread, limiting each subsystem to messages_per_second (0 for no limit) and suppressing repeated messages. Errors are never dropped.)")
+      .def(
+          "disable_async_sink",
+          [](LoggingContext& self) { self.setAsyncSink(nullptr); },
+          R"(Flush the async sink and write log messages synchronously again.)")
+      .def(
+          "flush",
+          [](LoggingContext& self) {
+            if (logging::AsyncLogSink* sink = self.asyncSink()) {
+              sink->flush();
+            }
+          },
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Write all log messages queued in the async sink, if any.)");
   core.attr("_logging_context") = new LoggingContext{};
 
+  py::class_<MemoryUsage>(core, "MemoryUsage",
+                          R"(Estimated CPU and GPU memory of a subsystem.)")
+      .def_readonly("cpu_bytes", &MemoryUsage::cpuBytes)
+      .def_readonly("gpu_bytes", &MemoryUsage::gpuBytes);
+
+  py::class_<ProfileSectionStats>(
+      core, "ProfileSectionStats",
+      R"(Timing statistics of a profiled section over its rolling window of samples.)")
+      .def_readonly("name", &ProfileSectionStats::name)
+      .def_readonly("total_count", &ProfileSectionStats::totalCount,
+                    R"(Samples recorded since the last clear.)")
+      .def_readonly("window_count", &ProfileSectionStats::windowCount,
+                    R"(Samples in the window.)")
+      .def_readonly("total_ms", &ProfileSectionStats::totalMs,
+                    R"(Summed duration of the samples since the last clear.)")
+      .def_readonly("mean_ms", &ProfileSectionStats::meanMs)
+      .def_readonly("min_ms", &ProfileSectionStats::minMs)
+      .def_readonly("max_ms", &ProfileSectionStats::maxMs)
+      .def_readonly("p50_ms", &ProfileSectionStats::p50Ms)
+      .def_readonly("p95_ms", &ProfileSectionStats::p95Ms)
+      .def_readonly("p99_ms", &ProfileSectionStats::p99Ms)
+      .def_property_readonly(
+          "histogram",
+          [](const ProfileSectionStats& self) {
+            return std::vector<std::size_t>(
+                std::begin(self.histogram), std::end(self.histogram));
+          },
+          R"(Sample counts in power-of-two buckets, bucket 0 below 1 us, bucket i in [2^(i-1), 2^i) us and the last one everything above.)");
+
+  py::class_<Profiler>(
+      core, "Profiler",
+      R"(Durations of the sections timed by the simulator, see Simulator.set_profiling_enabled.)")
+      .def_static("global_profiler", &Profiler::global,
+                  py::return_value_policy::reference,
+                  R"(The profiler the simulator sections are recorded to.)")
+      .def_property("enabled", &Profiler::isEnabled, &Profiler::setEnabled)
+      .def_property(
+          "gpu_timers_enabled", &Profiler::isGpuTimersEnabled,
+          &Profiler::setGpuTimersEnabled,
+          R"(Whether the renderers measure the GPU durations of drawing, HBAO, cube map faces and readback with GL timer queries.)")
+      .def(
+          "set_trace_enabled", &Profiler::setTraceEnabled, "enabled"_a,
+          "max_trace_events"_a = 1 << 20,
+          R"(Keep every sample as a trace event for write_chrome_trace, dropping events past max_trace_events.)")
+      .def("stats", py::overload_cast<>(&Profiler::stats, py::const_),
+           R"(Statistics of all recorded sections, ordered by name.)")
+      .def("stats",
+           py::overload_cast<const std::string&>(&Profiler::stats, py::const_),
+           "section"_a, R"(Statistics of one section.)")
+      .def_property_readonly("trace_event_count", &Profiler::traceEventCount)
+      .def(
+          "write_chrome_trace", &Profiler::writeChromeTrace, "filename"_a,
+          R"(Write the kept trace events as Chrome trace event JSON, viewable in chrome://tracing or Perfetto. Returns whether the file was written.)")
+      .def("clear", &Profiler::clear, R"(Drop all samples and trace events.)");
+
+  core.def(
+      "write_trace", &esp::logging::writeTrace, "filename"_a,
+      R"(Write the trace spans of all threads as Chrome trace event JSON, viewable in chrome://tracing or Perfetto. Spans are only recorded in builds with BUILD_WITH_TRACING. Returns whether the file was written.)");
+  core.def("clear_trace", &esp::logging::clearTrace,
+           R"(Drop all recorded trace spans.)");
+
   core.def("orthonormalize_rotation_shear",
            &orthonormalizeRotationShear<float>);
   core.def("orthonormalize_rotation_shear",
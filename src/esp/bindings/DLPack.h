@@ -0,0 +1,126 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_BINDINGS_DLPACK_H_
+#define ESP_BINDINGS_DLPACK_H_
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "esp/core/Buffer.h"
+
+namespace esp {
+
+/* The part of the DLPack ABI (https://github.com/dmlc/dlpack) needed to export
+   tensors, declared here to not depend on its header */
+namespace dlpack {
+
+enum DeviceType : std::int32_t { CPU = 1, CUDA = 2 };
+
+struct Device {
+  std::int32_t deviceType;
+  std::int32_t deviceId;
+};
+
+struct DataType {
+  std::uint8_t code;
+  std::uint8_t bits;
+  std::uint16_t lanes;
+};
+
+struct Tensor {
+  void* data;
+  Device device;
+  std::int32_t ndim;
+  DataType dtype;
+  std::int64_t* shape;
+  std::int64_t* strides;
+  std::uint64_t byteOffset;
+};
+
+struct ManagedTensor {
+  Tensor tensor;
+  void* managerContext;
+  void (*deleter)(ManagedTensor*);
+};
+
+}  // namespace dlpack
+
+namespace Implementation {
+
+struct DLPackContext {
+  dlpack::ManagedTensor managed;
+  std::shared_ptr<void> owner;
+  std::vector<std::int64_t> shape;
+};
+
+inline dlpack::DataType dlpackDataType(const core::DataType type) {
+  enum : std::uint8_t { Int = 0, UInt = 1, Float = 2 };
+  const auto bits = std::uint8_t(core::getDataTypeByteSize(type) * 8);
+  switch (type) {
+    case core::DataType::DT_INT8:
+    case core::DataType::DT_INT16:
+    case core::DataType::DT_INT32:
+    case core::DataType::DT_INT64:
+      return {Int, bits, 1};
+    case core::DataType::DT_FLOAT16:
+    case core::DataType::DT_FLOAT:
+    case core::DataType::DT_DOUBLE:
+      return {Float, bits, 1};
+    default:
+      return {UInt, bits, 1};
+  }
+}
+
+}  // namespace Implementation
+
+/* Wrap contiguous row-major memory into a DLPack capsule, as returned by
+   __dlpack__() and consumed with e.g. torch.from_dlpack(), without copying
+   it. The consumer keeps owner alive until it releases the tensor. */
+inline pybind11::capsule dlpackCapsule(std::shared_ptr<void> owner,
+                                       void* data,
+                                       const dlpack::Device device,
+                                       const core::DataType type,
+                                       const std::vector<size_t>& shape) {
+  auto* context = new Implementation::DLPackContext{};
+  context->owner = std::move(owner);
+  context->shape.assign(shape.begin(), shape.end());
+
+  dlpack::Tensor& tensor = context->managed.tensor;
+  tensor.data = data;
+  tensor.device = device;
+  tensor.ndim = std::int32_t(shape.size());
+  tensor.dtype = Implementation::dlpackDataType(type);
+  tensor.shape = context->shape.data();
+  tensor.strides = nullptr;
+  tensor.byteOffset = 0;
+  context->managed.managerContext = context;
+  context->managed.deleter = [](dlpack::ManagedTensor* self) {
+    delete static_cast<Implementation::DLPackContext*>(self->managerContext);
+  };
+
+  /* Consumers rename the capsule to used_dltensor and call the deleter
+     themselves, otherwise it's called once the capsule is collected */
+  PyObject* capsule =
+      PyCapsule_New(&context->managed, "dltensor", [](PyObject* self) {
+        if (PyCapsule_IsValid(self, "dltensor")) {
+          auto* managed = static_cast<dlpack::ManagedTensor*>(
+              PyCapsule_GetPointer(self, "dltensor"));
+          managed->deleter(managed);
+        }
+      });
+  if (!capsule) {
+    context->managed.deleter(&context->managed);
+    throw pybind11::error_already_set{};
+  }
+  return pybind11::reinterpret_steal<pybind11::capsule>(capsule);
+}
+
+}  // namespace esp
+
+#endif  // ESP_BINDINGS_DLPACK_H_
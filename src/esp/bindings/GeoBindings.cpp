@@ -6,6 +6,7 @@
 
 #include "esp/geo/Geo.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OBBTree.h"
 
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 
@@ -36,13 +37,34 @@ void initGeoBindings(py::module& m) {
            "center"_a, "dimensions"_a, "rotation"_a)
       .def(py::init<box3f&>())
       .def(
-          "contains", &OBB::contains,
+          "contains",
+          static_cast<bool (OBB::*)(const vec3f&, float) const>(
+              &OBB::contains),
           R"(Returns whether world coordinate point p is contained in this OBB within threshold distance epsilon.)")
-      .def("closest_point", &OBB::closestPoint,
+      .def("closest_point",
+           static_cast<vec3f (OBB::*)(const vec3f&) const>(&OBB::closestPoint),
            R"(Return closest point to p within OBB.  If p is inside return p.)")
       .def(
-          "distance", &OBB::distance,
+          "distance",
+          static_cast<float (OBB::*)(const vec3f&) const>(&OBB::distance),
           R"(Returns distance to p from closest point on OBB surface (0 if point p is inside box))")
+      .def(
+          "contains_points",
+          static_cast<std::vector<bool> (OBB::*)(const std::vector<vec3f>&,
+                                                 float) const>(&OBB::contains),
+          R"(Returns whether each of a list of world coordinate points is contained in this OBB within threshold distance epsilon.)",
+          "points"_a, "epsilon"_a = 1e-6f)
+      .def("closest_points",
+           static_cast<std::vector<vec3f> (OBB::*)(const std::vector<vec3f>&)
+                           const>(&OBB::closestPoint),
+           R"(Return the closest point within this OBB for each of a list of points.)",
+           "points"_a)
+      .def(
+          "distances",
+          static_cast<std::vector<float> (OBB::*)(const std::vector<vec3f>&)
+                          const>(&OBB::distance),
+          R"(Returns the distance to the OBB surface for each of a list of points (0 for points inside the box).)",
+          "points"_a)
       .def("to_aabb", &OBB::toAABB,
            R"(Returns an axis aligned bounding box bounding this OBB.)")
       .def(
@@ -70,6 +92,36 @@ void initGeoBindings(py::module& m) {
           [](const OBB& self) { return self.worldToLocal().matrix(); },
           R"(Transform from world coordinates to local [0,1]^3 coordinates.)");
 
+  // ==== OBBTree ====
+  py::class_<OBBTree>(
+      m, "OBBTree",
+      R"(Axis-aligned bounding box tree over a set of OBBs, for containment and closest OBB queries of many points.)")
+      .def(py::init<const std::vector<OBB>&, const std::vector<int>&>(),
+           "obbs"_a, "ids"_a = std::vector<int>{})
+      .def_property_readonly("size", &OBBTree::size,
+                             R"(The number of OBBs.)")
+      .def(
+          "containing",
+          static_cast<std::vector<int> (OBBTree::*)(const vec3f&, float)
+                          const>(&OBBTree::containing),
+          R"(Returns the IDs of all OBBs containing world coordinate point p within threshold distance epsilon.)",
+          "p"_a, "epsilon"_a = 1e-6f)
+      .def(
+          "containing_points",
+          static_cast<std::vector<std::vector<int>> (OBBTree::*)(
+              const std::vector<vec3f>&, float) const>(&OBBTree::containing),
+          R"(Returns the IDs of the OBBs containing each of a list of points.)",
+          "points"_a, "epsilon"_a = 1e-6f)
+      .def(
+          "closest",
+          [](const OBBTree& self, const std::vector<vec3f>& points) {
+            std::vector<float> distances;
+            std::vector<int> ids = self.closest(points, &distances);
+            return py::make_tuple(ids, distances);
+          },
+          R"(Returns a tuple of the ID of the closest OBB to each of a list of points, -1 if there are no OBBs, and the distance to it.)",
+          "points"_a);
+
   geo.def(
       "compute_gravity_aligned_MOBB", &geo::computeGravityAlignedMOBB,
       R"(Compute a minimum area OBB containing given points, and constrained to have -Z axis along given gravity orientation.)");
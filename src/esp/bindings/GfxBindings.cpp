@@ -15,9 +15,11 @@
 #include "esp/bindings/EnumOperators.h"
 #include "esp/gfx/DebugLineRender.h"
 #include "esp/gfx/LightSetup.h"
+#include "esp/gfx/ObjectIdHistogram.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/gfx/VideoRecorder.h"
 #include "esp/scene/SemanticScene.h"
 #include "esp/sensor/CameraSensor.h"
 #include "esp/sim/Simulator.h"
@@ -53,6 +55,11 @@ void initGfxBindings(py::module& m) {
 
   flags.value("FRUSTUM_CULLING", RenderCamera::Flag::FrustumCulling)
       .value("OBJECTS_ONLY", RenderCamera::Flag::ObjectsOnly)
+      .value("SORT_BY_DRAW_STATE", RenderCamera::Flag::SortByDrawState)
+      .value("USE_INSTANCING", RenderCamera::Flag::UseInstancing)
+      .value("DEPTH_AND_OBJECT_ID_ONLY",
+             RenderCamera::Flag::DepthAndObjectIdOnly)
+      .value("DEPTH_PRE_PASS", RenderCamera::Flag::DepthPrePass)
       .value("NONE", RenderCamera::Flag{});
   pybindEnumOperators(flags);
 
@@ -75,7 +82,18 @@ void initGfxBindings(py::module& m) {
       .def_property_readonly("node", nodeGetter<RenderCamera>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<RenderCamera>,
-                             "Alias to node");
+                             "Alias to node")
+      .def_property_readonly(
+          "previous_num_state_changes",
+          &RenderCamera::getPreviousNumStateChanges,
+          R"(Number of shader, material and mesh changes between consecutive drawables in the most recent render pass.)")
+      .def_property_readonly(
+          "previous_num_state_changes_saved",
+          &RenderCamera::getPreviousNumStateChangesSaved,
+          R"(Number of state changes saved by SORT_BY_DRAW_STATE in the most recent render pass.)")
+      .def_property_readonly(
+          "previous_num_draw_calls", &RenderCamera::getPreviousNumDrawCalls,
+          R"(Number of draw calls issued by the most recent render pass, reduced by USE_INSTANCING.)");
 
   // ==== Renderer ====
   py::class_<Renderer, Renderer::ptr> renderer(m, "Renderer");
@@ -83,6 +101,9 @@ void initGfxBindings(py::module& m) {
   py::enum_<Renderer::Flag> rendererFlags{renderer, "Flags", "Flags"};
 
   rendererFlags.value("VISUALIZE_TEXTURE", Renderer::Flag::VisualizeTexture)
+      .value("ALL_ATTACHMENTS", Renderer::Flag::AllAttachments)
+      .value("DEPTH_PRE_PASS", Renderer::Flag::DepthPrePass)
+      .value("SKIP_UNCHANGED_FRAMES", Renderer::Flag::SkipUnchangedFrames)
       .value("NONE", Renderer::Flag{});
   pybindEnumOperators(rendererFlags);
 
@@ -93,28 +114,41 @@ void initGfxBindings(py::module& m) {
              scene::SceneGraph& sceneGraph, RenderCamera::Flag flags) {
             self.draw(camera, sceneGraph, RenderCamera::Flags{flags});
           },
-          R"(Draw given scene using the camera)", "camera"_a, "scene"_a,
-          "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
+          R"(Draw given scene using the camera. Releases the GIL while drawing.)",
+          "camera"_a, "scene"_a,
+          "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling},
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "draw",
           [](Renderer& self, sensor::VisualSensor& visualSensor,
              sim::Simulator& sim) { self.draw(visualSensor, sim); },
-          R"(Draw the active scene in current simulator using the visual sensor)",
-          "visualSensor"_a, "sim"_a)
+          R"(Draw the active scene in current simulator using the visual sensor. Releases the GIL while drawing.)",
+          "visualSensor"_a, "sim"_a, py::call_guard<py::gil_scoped_release>())
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
       .def(
           "enqueue_async_draw_job",
           [](Renderer& self, sensor::VisualSensor& visualSensor,
              scene::SceneGraph& sceneGraph, const Mn::MutableImageView2D& view,
              RenderCamera::Flag flags) {
-            self.enqueueAsyncDrawJob(visualSensor, sceneGraph, view,
-                                     RenderCamera::Flags{flags});
+            return self.enqueueAsyncDrawJob(visualSensor, sceneGraph, view,
+                                            RenderCamera::Flags{flags});
           },
-          R"(Draw given scene using the visual sensor. See tutorials/async_rendering.py)",
+          R"(Draw given scene using the visual sensor. Returns the index of the job to pass to wait_draw_job. See tutorials/async_rendering.py)",
           "visualSensor"_a, "scene"_a, "view"_a,
           "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
       .def("wait_draw_jobs", &Renderer::waitDrawJobs,
            R"(See tutorials/async_rendering.py)")
+      .def(
+          "is_draw_job_done", &Renderer::isDrawJobDone,
+          R"(Whether the observation of the given job of the started frame was read into its view)",
+          "job"_a)
+      .def(
+          "wait_draw_job", &Renderer::waitDrawJob,
+          R"(Wait until the observation of the given job of the started frame is read into its view, while the other jobs may still run)",
+          "job"_a)
+      .def(
+          "snapshot_draw_jobs", &Renderer::snapshotDrawJobs,
+          R"(Capture the scene state of the enqueued draw jobs, so that the scene can change while they are drawn. See tutorials/async_rendering.py)")
       .def("start_draw_jobs", &Renderer::startDrawJobs,
            R"(See tutorials/async_rendering.py)")
 #endif
@@ -127,10 +161,28 @@ void initGfxBindings(py::module& m) {
              Renderer::Flag flags) {
             self.bindRenderTarget(visualSensor, Renderer::Flags{flags});
           },
-          R"(Binds a RenderTarget to the sensor)", "visualSensor"_a,
-          "flags"_a = Renderer::Flag{});
+          R"(Binds a RenderTarget to the sensor. A sensor bound again, e.g. after its resolution changed, leaves its previous RenderTarget for reuse by a later binding of the same size and flags.)",
+          "visualSensor"_a, "flags"_a = Renderer::Flag{})
+      .def_property_readonly(
+          "pooled_render_target_count", &Renderer::pooledRenderTargetCount,
+          R"(Count of the RenderTargets kept for reuse by bind_render_target)")
+      .def("clear_render_target_pool", &Renderer::clearRenderTargetPool,
+           R"(Free the RenderTargets kept for reuse by bind_render_target)");
 
-  py::class_<RenderTarget>(m, "RenderTarget")
+  py::class_<RenderTarget> renderTarget(m, "RenderTarget");
+
+  py::enum_<RenderTarget::ReadSource>(renderTarget, "ReadSource")
+      .value("RGBA", RenderTarget::ReadSource::Rgba)
+      .value("DEPTH", RenderTarget::ReadSource::Depth)
+      .value("OBJECT_ID", RenderTarget::ReadSource::ObjectId);
+
+  py::class_<RenderTarget::AsyncRead>(
+      renderTarget, "AsyncRead",
+      R"(Handle of a read started by RenderTarget.read_frame_async.)")
+      .def_readonly("source", &RenderTarget::AsyncRead::source)
+      .def_readonly("id", &RenderTarget::AsyncRead::id);
+
+  renderTarget
       .def("__enter__",
            [](RenderTarget& self) {
              self.renderEnter();
@@ -143,6 +195,19 @@ void initGfxBindings(py::module& m) {
            "Reads RGBA frame into passed img in uint8 byte format.")
       .def("read_frame_depth", &RenderTarget::readFrameDepth)
       .def("read_frame_object_id", &RenderTarget::readFrameObjectId)
+      .def("read_frame_async", &RenderTarget::readFrameAsync, "source"_a,
+           "format"_a,
+           R"(Starts reading the given rendering result into a pixel buffer in the given pixel format without waiting for the GPU. Finish the read with finish_read_frame_async.)")
+      .def("is_async_read_ready", &RenderTarget::isAsyncReadReady, "read"_a,
+           R"(Whether finish_read_frame_async would not block for the read.)")
+      .def("finish_read_frame_async", &RenderTarget::finishReadFrameAsync,
+           "read"_a, "view"_a,
+           R"(Waits for the read started by read_frame_async and copies its result into view.)")
+      .def("downsampled_size", &RenderTarget::downsampledSize, "level"_a,
+           R"(The size of the rendering result downsampled level times.)")
+      .def("read_frame_downsampled", &RenderTarget::readFrameDownsampled,
+           "source"_a, "level"_a, "view"_a,
+           R"(Reads the given rendering result downsampled level times on the GPU into view.)")
       .def("blit_rgba_to_default", &RenderTarget::blitRgbaToDefault)
 #ifdef ESP_BUILD_WITH_CUDA
       .def("read_frame_rgba_gpu",
@@ -176,6 +241,62 @@ void initGfxBindings(py::module& m) {
       .def("render_enter", &RenderTarget::renderEnter)
       .def("render_exit", &RenderTarget::renderExit);
 
+  // ==== ObjectIdHistogram ====
+  py::class_<ObjectIdHistogram, ObjectIdHistogram::ptr>(
+      m, "ObjectIdHistogram",
+      R"(Counts the pixels of each ID in the object ID attachment of a RenderTarget on the GPU, reading back only the counts instead of the frame.)")
+      .def(py::init(&ObjectIdHistogram::create<Mn::UnsignedInt>),
+           "bin_count"_a,
+           R"(Count the IDs from 0 to bin_count - 1. Larger IDs are ignored.)")
+      .def_property_readonly("bin_count", &ObjectIdHistogram::binCount)
+      .def(
+          "compute", &ObjectIdHistogram::compute, "render_target"_a,
+          R"(Returns the pixel count of each ID rendered into the render target. Call after the render target's render_exit.)");
+
+  // ==== VideoRecorder ====
+  py::class_<VideoRecorder::Configuration>(
+      m, "VideoRecorderConfiguration",
+      R"(Configuration of a VideoRecorder.)")
+      .def(py::init())
+      .def_readwrite("filename", &VideoRecorder::Configuration::filename,
+                     R"(Output video file.)")
+      .def_readwrite("size", &VideoRecorder::Configuration::size,
+                     R"(Frame size in pixels.)")
+      .def_readwrite("fps", &VideoRecorder::Configuration::fps,
+                     R"(Frames per second.)")
+      .def_readwrite(
+          "encoder", &VideoRecorder::Configuration::encoder,
+          R"(The ffmpeg video codec, h264_nvenc by default. Use libx264 without NVENC.)")
+      .def_readwrite("ffmpeg", &VideoRecorder::Configuration::ffmpeg,
+                     R"(The ffmpeg executable.)")
+      .def_readwrite(
+          "max_queued_frames", &VideoRecorder::Configuration::maxQueuedFrames,
+          R"(Frames waiting for the encoder after which add_frame blocks.)");
+
+  py::class_<VideoRecorder, VideoRecorder::ptr>(
+      m, "VideoRecorder",
+      R"(Encodes rendered frames into a video file with ffmpeg on a background thread. Reads render targets asynchronously so the GPU isn't stalled every frame.)")
+      .def(py::init(
+               &VideoRecorder::create<const VideoRecorder::Configuration&>),
+           "config"_a)
+      .def_property_readonly("config", &VideoRecorder::configuration)
+      .def_property_readonly("is_open", &VideoRecorder::isOpen)
+      .def_property_readonly("frame_count", &VideoRecorder::frameCount)
+      .def(
+          "add_frame",
+          py::overload_cast<RenderTarget&>(&VideoRecorder::addFrame),
+          "render_target"_a,
+          R"(Add the color attachment of the render target as the next frame. The render target has to stay alive until the recorder is closed.)")
+      .def(
+          "add_frame",
+          py::overload_cast<const Magnum::ImageView2D&>(
+              &VideoRecorder::addFrame),
+          "image"_a,
+          R"(Add an RGBA8 image of the configured size, bottom row first, as the next frame.)")
+      .def(
+          "close", &VideoRecorder::close,
+          R"(Finish all frames and close the file. Returns whether encoding succeeded.)");
+
   py::enum_<LightPositionModel>(
       m, "LightPositionModel",
       R"(Defines the coordinate frame of a light source.)")
@@ -213,6 +334,11 @@ void initGfxBindings(py::module& m) {
           R"(Push (multiply) a transform onto the transform stack, affecting all line-drawing until popped. Must be paired with popTransform().)")
       .def("pop_transform", &DebugLineRender::popTransform,
            R"(See push_transform.)")
+      .def(
+          "bake_static_lines", &DebugLineRender::bakeStaticLines,
+          R"(Move everything drawn since the last flush to the static lines, which are kept on the GPU and drawn every frame until clear_static_lines(). Use this for geometry that doesn't change, such as recorded trajectories.)")
+      .def("clear_static_lines", &DebugLineRender::clearStaticLines,
+           R"(Remove all static lines, see bake_static_lines().)")
       .def("draw_box", &DebugLineRender::drawBox,
            R"(Draw a box in world-space or local-space (see pushTransform).)")
       .def(
@@ -7,6 +7,7 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/ReplayManager.h"
 
@@ -18,6 +19,21 @@ namespace gfx {
 namespace replay {
 
 void initGfxReplayBindings(py::module& m) {
+  py::class_<KeyframeRingBuffer, KeyframeRingBuffer::ptr>(m,
+                                                          "KeyframeRingBuffer")
+      .def(py::init(&KeyframeRingBuffer::create<const std::string&,
+                                                std::size_t>),
+           "name"_a, "capacity"_a = DEFAULT_KEYFRAME_RING_BUFFER_CAPACITY,
+           R"(Create a shared-memory ring buffer for passing keyframes to another process. The memory is released when this object is destroyed.)")
+      .def_static("open", &KeyframeRingBuffer::open, "name"_a,
+                  R"(Open a ring buffer created by another process.)")
+      .def_property_readonly("name", &KeyframeRingBuffer::name,
+                             R"(Name of the shared memory object.)")
+      .def_property_readonly("capacity", &KeyframeRingBuffer::capacity,
+                             R"(Capacity in bytes.)")
+      .def_property_readonly("used_size", &KeyframeRingBuffer::usedSize,
+                             R"(Bytes used by keyframes not yet popped.)");
+
   py::class_<Player, Player::ptr>(m, "Player")
       .def("get_num_keyframes", &Player::getNumKeyframes,
            R"(Get the currently-set keyframe, or -1 if no keyframe is set.)")
@@ -29,6 +45,13 @@ void initGfxReplayBindings(py::module& m) {
       .def("get_keyframe_index", &Player::getKeyframeIndex,
            R"(Get the number of keyframes read from file.)")
 
+      .def(
+          "set_checkpoint_interval", &Player::setCheckpointInterval,
+          R"(Set how often full-state checkpoints are made for seeking with set_keyframe_index. Pass 0 to disable checkpoints.)")
+
+      .def("get_checkpoint_interval", &Player::getCheckpointInterval,
+           R"(Get the interval of full-state checkpoints.)")
+
       .def(
           "get_user_transform",
           [](Player& self, const std::string& name) {
@@ -41,6 +64,11 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Get a previously-added user transform. See also ReplayManager.add_user_transform_to_keyframe.)")
 
+      .def(
+          "append_keyframes_from_ring_buffer",
+          &Player::appendKeyframesFromRingBuffer, "ring_buffer"_a,
+          R"(Append all keyframes available in a KeyframeRingBuffer. Returns the number of keyframes appended.)")
+
       .def(
           "close", &Player::close,
           R"(Unload all keyframes. The Player is unusable after it is closed.)");
@@ -98,6 +126,47 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to a file, then discard the keyframes.)")
 
+      .def(
+          "write_saved_keyframes_to_binary_file",
+          [](ReplayManager& self, const std::string& filepath) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->writeSavedKeyframesToBinaryFile(filepath);
+          },
+          R"(Write all saved keyframes to a file in the compact binary format, then discard the keyframes. The file can be read back with read_keyframes_from_file.)")
+
+      .def(
+          "start_streaming_to_file",
+          [](ReplayManager& self, const std::string& filepath,
+             std::size_t maxQueuedKeyframes) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->startStreamingToFile(filepath,
+                                                     maxQueuedKeyframes);
+          },
+          "filepath"_a,
+          "max_queued_keyframes"_a =
+              esp::gfx::replay::DEFAULT_MAX_QUEUED_KEYFRAMES,
+          R"(Write each saved keyframe to a file on a background thread instead of keeping it in memory, until stop_streaming is called.)")
+
+      .def(
+          "stop_streaming",
+          [](ReplayManager& self) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->stopStreaming();
+          },
+          R"(Finish writing streamed keyframes and close the file.)")
+
       .def(
           "write_saved_keyframes_to_string",
           [](ReplayManager& self) {
@@ -123,6 +192,20 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to individual strings. See Recorder.h for details.)")
 
+      .def(
+          "write_saved_keyframes_to_ring_buffer",
+          [](ReplayManager& self, KeyframeRingBuffer& ringBuffer) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            return self.getRecorder()->writeSavedKeyframesToRingBuffer(
+                ringBuffer);
+          },
+          "ring_buffer"_a,
+          R"(Push saved keyframes to a KeyframeRingBuffer until it's full and discard the pushed keyframes. Returns the number of keyframes pushed. Incremental like write_incremental_saved_keyframes_to_string_array.)")
+
       .def("read_keyframes_from_file", &ReplayManager::readKeyframesFromFile,
            R"(Create a Player object from a replay file.)")
 
@@ -4,6 +4,7 @@
 
 #include "esp/bindings/Bindings.h"
 #include "esp/bindings/EnumOperators.h"
+#include "esp/physics/MultiWorldStepper.h"
 #include "esp/physics/PhysicsManager.h"
 
 namespace py = pybind11;
@@ -133,7 +134,10 @@ void initPhysicsBindings(py::module& m) {
           R"(Constraint orientation frame in local space of objectA as 3x3 rotation matrix for RigidConstraintType::Fixed.)")
       .def_readwrite(
           "frame_b", &RigidConstraintSettings::frameB,
-          R"(Constraint orientation frame in local space of objectB as 3x3 rotation matrix for RigidConstraintType::Fixed.)");
+          R"(Constraint orientation frame in local space of objectB as 3x3 rotation matrix for RigidConstraintType::Fixed.)")
+      .def_readwrite(
+          "enabled", &RigidConstraintSettings::enabled,
+          R"(Whether the constraint is applied. Toggling this through an update is cheaper than removing the constraint and creating it again.)");
 
   // ==== struct object RayHitInfo ====
   py::class_<RayHitInfo, RayHitInfo::ptr>(m, "RayHitInfo")
@@ -190,6 +194,55 @@ void initPhysicsBindings(py::module& m) {
           "is_active", &ContactPointData::isActive,
           R"(Whether or not the contact is between active objects. Deactivated objects may produce contact points but no reaction.)");
 
+  // ==== struct object PhysicsStepProfile ====
+  py::class_<PhysicsStepProfile, PhysicsStepProfile::ptr>(
+      m, "PhysicsStepProfile",
+      R"(Substep counts and wall-clock timings in milliseconds of the most recent physics step.)")
+      .def_readonly(
+          "num_substeps_requested", &PhysicsStepProfile::numSubstepsRequested,
+          R"(Number of fixed substeps the requested step duration called for.)")
+      .def_readonly("num_substeps_taken", &PhysicsStepProfile::numSubstepsTaken,
+                    R"(Number of fixed substeps taken, at most max_substeps.)")
+      .def_readonly(
+          "num_substeps_dropped_total",
+          &PhysicsStepProfile::numSubstepsDroppedTotal,
+          R"(Substeps dropped because of max_substeps over the lifetime of the world.)")
+      .def_readonly("step_ms", &PhysicsStepProfile::stepMs,
+                    R"(Total time spent in the step.)")
+      .def_readonly(
+          "broadphase_ms", &PhysicsStepProfile::broadphaseMs,
+          R"(Time spent updating bounding boxes and finding overlapping pairs.)")
+      .def_readonly("narrowphase_ms", &PhysicsStepProfile::narrowphaseMs,
+                    R"(Time spent computing contacts of overlapping pairs.)")
+      .def_readonly("solver_ms", &PhysicsStepProfile::solverMs,
+                    R"(Time spent solving contacts and constraints.)")
+      .def_readonly(
+          "update_nodes_ms", &PhysicsStepProfile::updateNodesMs,
+          R"(Time spent syncing the simulation state to the scene graph.)")
+      .def_readonly(
+          "num_articulated_object_syncs_skipped",
+          &PhysicsStepProfile::numArticulatedObjectSyncsSkipped,
+          R"(Articulated objects whose scene graph sync was skipped because they are asleep and unchanged since their last sync.)");
+
+  // ==== struct object PhysicsStateSnapshot ====
+  py::class_<PhysicsStateSnapshot, PhysicsStateSnapshot::ptr>(
+      m, "PhysicsStateSnapshot",
+      R"(Transformations, motion types, velocities and joint states of the objects of a physical world.)")
+      .def_readonly("world_time", &PhysicsStateSnapshot::worldTime,
+                    R"(World time when the state was captured.)")
+      .def_property_readonly(
+          "num_rigid_objects",
+          [](const PhysicsStateSnapshot& self) {
+            return self.rigidObjects.size();
+          },
+          R"(Number of rigid objects in the snapshot.)")
+      .def_property_readonly(
+          "num_articulated_objects",
+          [](const PhysicsStateSnapshot& self) {
+            return self.articulatedObjects.size();
+          },
+          R"(Number of articulated objects in the snapshot.)");
+
   // ==== enum object CollisionGroup ====
   py::enum_<CollisionGroup> collisionGroups{m, "CollisionGroups",
                                             "CollisionGroups"};
@@ -252,6 +305,17 @@ void initPhysicsBindings(py::module& m) {
       .def_static("get_all_group_names",
                   &CollisionGroupHelper::getAllGroupNames,
                   R"(Get a list of all configured collision group names.)");
+
+  // ==== class object MultiWorldStepper ====
+  py::class_<MultiWorldStepper, MultiWorldStepper::ptr>(m, "MultiWorldStepper",
+                                                        R"(
+        A thread pool shared by the physics worlds of several Simulators, which
+        steps them concurrently. Pass it to Simulator.step_worlds().)")
+      .def(py::init(&MultiWorldStepper::create<int>), "num_threads"_a = 0,
+           R"(Create a stepper with num_threads threads including the calling
+           thread. Values <= 0 select the hardware concurrency of the machine.)")
+      .def_property_readonly("num_threads", &MultiWorldStepper::numThreads,
+                             R"(Number of threads stepping the worlds.)");
 }
 
 }  // namespace physics
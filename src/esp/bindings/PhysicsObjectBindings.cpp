@@ -549,6 +549,19 @@ void declareArticulatedObjectWrapper(py::module& m,
             "JointMotors.")
                .c_str(),
            "state_targets"_a, "velocities"_a = false)
+      .def("set_joint_motor_targets",
+           &ManagedArticulatedObject::setJointMotorTargets,
+           ("Update the position targets, velocity targets and max impulses "
+            "of all of this " +
+            objType +
+            "'s joint motors at once. Position targets are indexed by joint "
+            "position, velocity targets and max impulses by degree of "
+            "freedom. Settings passed as an empty array are left unchanged "
+            "and values for joints without motors are ignored.")
+               .c_str(),
+           "position_targets"_a = std::vector<float>{},
+           "velocity_targets"_a = std::vector<float>{},
+           "max_impulses"_a = std::vector<float>{})
       .def("create_joint_motor", &ManagedArticulatedObject::createJointMotor,
            ("Create a joint motor for the specified DOF on this " + objType +
             " using the provided JointMotorSettings")
@@ -4,6 +4,12 @@
 
 #include "esp/bindings/Bindings.h"
 
+#include <pybind11/numpy.h>
+
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/Check.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletArticulatedObject.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
@@ -26,6 +32,91 @@ using PhysWraps::RigidObjectManager;
 
 namespace esp {
 namespace physics {
+
+namespace {
+using ObjectIdArray =
+    py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+using StateArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+using AwakeArray =
+    py::array_t<bool, py::array::c_style | py::array::forcecast>;
+
+static_assert(sizeof(Magnum::Vector3) == 3 * sizeof(float) &&
+                  sizeof(Magnum::Quaternion) == 4 * sizeof(float),
+              "vectors and quaternions must be tightly packed to view numpy "
+              "arrays");
+
+//! View a 1D int array of object IDs without copying
+Corrade::Containers::ArrayView<const int> objectIdsView(
+    const ObjectIdArray& ids) {
+  ESP_CHECK(ids.ndim() == 1, "Expected a 1D array of object IDs");
+  return {ids.data(), static_cast<std::size_t>(ids.size())};
+}
+
+//! View an NxC float array as N values of type T without copying
+template <class T>
+Corrade::Containers::ArrayView<const T> stateView(const StateArray& values) {
+  constexpr py::ssize_t components = sizeof(T) / sizeof(float);
+  ESP_CHECK(values.ndim() == 2 && values.shape(1) == components,
+            "Expected an Nx" << components << "array of values");
+  return {reinterpret_cast<const T*>(values.data()),
+          static_cast<std::size_t>(values.shape(0))};
+}
+
+//! Query a batched state of objects into a new NxC float array
+template <class T>
+StateArray getBatchedState(const RigidObjectManager& self,
+                           const ObjectIdArray& ids,
+                           void (RigidObjectManager::*getter)(
+                               Corrade::Containers::ArrayView<const int>,
+                               Corrade::Containers::ArrayView<T>) const) {
+  const Corrade::Containers::ArrayView<const int> idsView = objectIdsView(ids);
+  StateArray values({static_cast<py::ssize_t>(idsView.size()),
+                     static_cast<py::ssize_t>(sizeof(T) / sizeof(float))});
+  (self.*getter)(idsView,
+                 {reinterpret_cast<T*>(values.mutable_data()), idsView.size()});
+  return values;
+}
+
+//! View a 1D bool array of awake states without copying
+Corrade::Containers::ArrayView<const bool> awakeView(const AwakeArray& values) {
+  ESP_CHECK(values.ndim() == 1, "Expected a 1D array of awake states");
+  return {values.data(), static_cast<std::size_t>(values.size())};
+}
+
+//! View a writable 2D float32 array of joint values, without copying
+Corrade::Containers::StridedArrayView2D<float> jointStateView(
+    py::array& values) {
+  ESP_CHECK(values.ndim() == 2 && values.dtype().is(py::dtype::of<float>()),
+            "Expected a 2D float32 array of joint values");
+  ESP_CHECK(values.writeable(), "Expected a writable array of joint values");
+  ESP_CHECK(values.strides(0) >= 0 && values.strides(1) >= 0,
+            "Expected an array of joint values with non-negative strides");
+  const std::size_t rows = values.shape(0);
+  const std::size_t columns = values.shape(1);
+  const std::size_t bytes =
+      rows && columns ? (rows - 1) * values.strides(0) +
+                            (columns - 1) * values.strides(1) + sizeof(float)
+                      : 0;
+  return {{values.mutable_data(), bytes},
+          static_cast<float*>(values.mutable_data()),
+          {rows, columns},
+          {values.strides(0), values.strides(1)}};
+}
+
+//! View a 2D float array of joint values, without copying
+Corrade::Containers::StridedArrayView2D<const float> jointStateView(
+    const StateArray& values) {
+  ESP_CHECK(values.ndim() == 2, "Expected a 2D array of joint values");
+  return {{values.data(), std::size_t(values.nbytes())},
+          values.data(),
+          {std::size_t(values.shape(0)), std::size_t(values.shape(1))},
+          {values.strides(0), values.strides(1)}};
+}
+}  // namespace
+
 /**
  * @brief instance class template base classes for object wrapper managers.
  * @tparam The type used to specialize class template for each object wrapper
@@ -256,7 +347,155 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
           &RigidObjectManager::removePhysObjectByHandle, "handle"_a,
           "delete_object_node"_a = true, "delete_visual_node"_a = true,
           R"(This removes the RigidObject referenced by the passed handle from the library, while allowing "
-          "for the optional retention of the object's scene node and/or the visual node)");
+          "for the optional retention of the object's scene node and/or the visual node)")
+      .def(
+          "get_translations",
+          [](const RigidObjectManager& self, const ObjectIdArray& ids) {
+            return getBatchedState(self, ids,
+                                   &RigidObjectManager::getTranslations);
+          },
+          "object_ids"_a,
+          R"(Get the translations of the RigidObjects with the passed IDs as an Nx3 float32 array in
+          one call, without creating a wrapper for each object.)")
+      .def(
+          "set_translations",
+          [](RigidObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setTranslations(objectIdsView(ids),
+                                 stateView<Magnum::Vector3>(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the translations of the RigidObjects with the passed IDs from an Nx3 array in one
+          call, without creating a wrapper for each object.)")
+      .def(
+          "get_rotations",
+          [](const RigidObjectManager& self, const ObjectIdArray& ids) {
+            return getBatchedState(self, ids,
+                                   &RigidObjectManager::getRotations);
+          },
+          "object_ids"_a,
+          R"(Get the rotations of the RigidObjects with the passed IDs as an Nx4 float32 array of
+          [x, y, z, w] quaternions in one call, without creating a wrapper for each object.)")
+      .def(
+          "set_rotations",
+          [](RigidObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setRotations(objectIdsView(ids),
+                              stateView<Magnum::Quaternion>(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the rotations of the RigidObjects with the passed IDs from an Nx4 array of
+          [x, y, z, w] quaternions in one call, without creating a wrapper for each object.)")
+      .def(
+          "get_linear_velocities",
+          [](const RigidObjectManager& self, const ObjectIdArray& ids) {
+            return getBatchedState(self, ids,
+                                   &RigidObjectManager::getLinearVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the linear velocities of the RigidObjects with the passed IDs as an Nx3 float32 array in
+          one call, without creating a wrapper for each object.)")
+      .def(
+          "set_linear_velocities",
+          [](RigidObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setLinearVelocities(objectIdsView(ids),
+                                     stateView<Magnum::Vector3>(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the linear velocities of the RigidObjects with the passed IDs from an Nx3 array in one
+          call, without creating a wrapper for each object.)")
+      .def(
+          "get_angular_velocities",
+          [](const RigidObjectManager& self, const ObjectIdArray& ids) {
+            return getBatchedState(self, ids,
+                                   &RigidObjectManager::getAngularVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the angular velocities of the RigidObjects with the passed IDs as an Nx3 float32 array in
+          one call, without creating a wrapper for each object.)")
+      .def(
+          "set_angular_velocities",
+          [](RigidObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setAngularVelocities(objectIdsView(ids),
+                                      stateView<Magnum::Vector3>(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the angular velocities of the RigidObjects with the passed IDs from an Nx3 array in one
+          call, without creating a wrapper for each object.)")
+      .def(
+          "get_awake",
+          [](const RigidObjectManager& self, const ObjectIdArray& ids) {
+            const Corrade::Containers::ArrayView<const int> idsView =
+                objectIdsView(ids);
+            AwakeArray awake(static_cast<py::ssize_t>(idsView.size()));
+            self.getAwake(idsView, {awake.mutable_data(), idsView.size()});
+            return awake;
+          },
+          "object_ids"_a,
+          R"(Get whether the RigidObjects with the passed IDs are awake as an N bool array in one call,
+          without creating a wrapper for each object.)")
+      .def(
+          "set_awake",
+          [](RigidObjectManager& self, const ObjectIdArray& ids,
+             const AwakeArray& values) {
+            self.setAwake(objectIdsView(ids), awakeView(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Wake up or put to sleep the RigidObjects with the passed IDs from an N bool array in one
+          call, without creating a wrapper for each object.)")
+      .def(
+          "get_states",
+          [](const RigidObjectManager& self, const py::object& objectIds) {
+            const ObjectIdArray ids =
+                objectIds.is_none()
+                    ? ObjectIdArray{py::cast(self.getExistingObjectIDs())}
+                    : objectIds.cast<ObjectIdArray>();
+            const Corrade::Containers::ArrayView<const int> idsView =
+                objectIdsView(ids);
+            const auto count = static_cast<py::ssize_t>(idsView.size());
+            StateArray translations({count, py::ssize_t{3}});
+            StateArray rotations({count, py::ssize_t{4}});
+            StateArray linearVelocities({count, py::ssize_t{3}});
+            StateArray angularVelocities({count, py::ssize_t{3}});
+            AwakeArray awake(count);
+            self.getStates(
+                idsView,
+                {reinterpret_cast<Magnum::Vector3*>(
+                     translations.mutable_data()),
+                 idsView.size()},
+                {reinterpret_cast<Magnum::Quaternion*>(
+                     rotations.mutable_data()),
+                 idsView.size()},
+                {reinterpret_cast<Magnum::Vector3*>(
+                     linearVelocities.mutable_data()),
+                 idsView.size()},
+                {reinterpret_cast<Magnum::Vector3*>(
+                     angularVelocities.mutable_data()),
+                 idsView.size()},
+                {awake.mutable_data(), idsView.size()});
+            py::dict states;
+            states["object_ids"] = ids;
+            states["translations"] = translations;
+            states["rotations"] = rotations;
+            states["linear_velocities"] = linearVelocities;
+            states["angular_velocities"] = angularVelocities;
+            states["awake"] = awake;
+            return states;
+          },
+          "object_ids"_a = py::none(),
+          R"(Get the whole state of the RigidObjects with the passed IDs, or of all existing ones if
+          None, in one call. Returns a dict of numpy arrays with the keys object_ids, translations
+          (Nx3), rotations (Nx4 [x, y, z, w] quaternions), linear_velocities (Nx3),
+          angular_velocities (Nx3) and awake (N bools).)")
+      .def(
+          "get_existing_object_ids",
+          [](const RigidObjectManager& self) {
+            return ObjectIdArray{py::cast(self.getExistingObjectIDs())};
+          },
+          R"(Get the IDs of all existing RigidObjects as an int32 array, to pass to the batched state
+          getters and setters.)");
 
   // initialize bindings for articulated objects
 
@@ -314,7 +553,64 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
           R"(Load and parse a URDF file using the given 'filepath' into a model,
           then use this model to instantiate an Articulated Object in the world.
-          Returns a reference to the created object.)");
+          Returns a reference to the created object.)")
+      .def(
+          "get_joint_positions",
+          [](const ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             py::array& out) {
+            self.getJointPositions(objectIdsView(ids), jointStateView(out));
+          },
+          "object_ids"_a, "out"_a,
+          R"(Write the joint positions of the ArticulatedObjects with the passed IDs into the
+          caller-provided NxC float32 array 'out', with one row per object and one column per
+          joint position, without allocating. All objects need to have the same number of columns.)")
+      .def(
+          "set_joint_positions",
+          [](ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setJointPositions(objectIdsView(ids), jointStateView(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the joint positions of the ArticulatedObjects with the passed IDs from an NxC
+          array, with one row per object and one column per joint position.)")
+      .def(
+          "get_joint_velocities",
+          [](const ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             py::array& out) {
+            self.getJointVelocities(objectIdsView(ids), jointStateView(out));
+          },
+          "object_ids"_a, "out"_a,
+          R"(Write the joint velocities of the ArticulatedObjects with the passed IDs into the
+          caller-provided NxC float32 array 'out', with one row per object and one column per
+          degree of freedom, without allocating. All objects need to have the same number of columns.)")
+      .def(
+          "set_joint_velocities",
+          [](ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setJointVelocities(objectIdsView(ids), jointStateView(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the joint velocities of the ArticulatedObjects with the passed IDs from an NxC
+          array, with one row per object and one column per degree of freedom.)")
+      .def(
+          "get_joint_forces",
+          [](const ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             py::array& out) {
+            self.getJointForces(objectIdsView(ids), jointStateView(out));
+          },
+          "object_ids"_a, "out"_a,
+          R"(Write the joint forces/torques of the ArticulatedObjects with the passed IDs into the
+          caller-provided NxC float32 array 'out', with one row per object and one column per
+          degree of freedom, without allocating. All objects need to have the same number of columns.)")
+      .def(
+          "set_joint_forces",
+          [](ArticulatedObjectManager& self, const ObjectIdArray& ids,
+             const StateArray& values) {
+            self.setJointForces(objectIdsView(ids), jointStateView(values));
+          },
+          "object_ids"_a, "values"_a,
+          R"(Set the joint forces/torques of the ArticulatedObjects with the passed IDs from an NxC
+          array, with one row per object and one column per degree of freedom.)");
 }  // initPhysicsWrapperManagerBindings
 
 }  // namespace physics
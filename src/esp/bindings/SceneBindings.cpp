@@ -4,6 +4,8 @@
 
 #include "esp/bindings/Bindings.h"
 
+#include <pybind11/numpy.h>
+
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
@@ -226,6 +228,19 @@ void initSceneBindings(py::module& m) {
         `SemanticScene`.
       )",
           "file"_a, "scene"_a, "rotation"_a)
+      .def_static(
+          "load_houses",
+          [](const std::vector<std::string>& filenames, int numThreads) {
+            py::gil_scoped_release release;
+            return SemanticScene::loadHouses(filenames, numThreads);
+          },
+          R"(
+        Loads the SemanticScenes of a list of HM3D or Matterport3D house files
+        in parallel, with the format of each determined by its header. Returns
+        the scenes in the order of the files, None for the ones that failed to
+        load. num_threads <= 0 uses all hardware threads.
+      )",
+          "files"_a, "num_threads"_a = 0)
       .def_property_readonly("aabb", &SemanticScene::aabb)
       .def_property_readonly("categories", &SemanticScene::categories,
                              "All semantic categories in the scene")
@@ -259,7 +274,27 @@ void initSceneBindings(py::module& m) {
               the percentage of points contained by that region. In the case of nested
               regions, points are considered belonging to every region the point is
               found in.)",
-           "points"_a);
+           "points"_a)
+      .def(
+          "get_regions_for_points_batched",
+          [](const SemanticScene& self, const std::vector<Mn::Vector3>& points,
+             int numThreads) {
+            std::vector<int> offsets;
+            std::vector<int> regionIndices;
+            {
+              py::gil_scoped_release release;
+              self.getRegionsForPointsBatched(points, offsets, regionIndices,
+                                              numThreads);
+            }
+            return py::make_tuple(
+                py::array_t<int>(offsets.size(), offsets.data()),
+                py::array_t<int>(regionIndices.size(), regionIndices.data()));
+          },
+          R"(Compute SemanticRegion containment for each of a batch of points. Return a tuple of offsets and region_indices arrays, where the regions containing point i are region_indices[offsets[i]:offsets[i + 1]]. num_threads <= 0 uses all hardware threads.)",
+          "points"_a, "num_threads"_a = 0)
+      .def(
+          "build_object_obb_tree", &SemanticScene::buildObjectOBBTree,
+          R"(Build an OBBTree over the OBBs of all objects, with the index of each object in objects as its ID.)");
 
   // ==== ObjectControls ====
   py::class_<ObjectControls, ObjectControls::ptr>(m, "ObjectControls")
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "esp/bindings/Bindings.h"
+#include "esp/bindings/DLPack.h"
 
 #include <Corrade/Containers/OptionalPythonBindings.h>
 #include <Magnum/Magnum.h>
@@ -10,6 +11,7 @@
 
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
+#include <pybind11/numpy.h>
 
 #include <utility>
 
@@ -17,6 +19,7 @@
 #include "esp/sensor/CubeMapSensorBase.h"
 #include "esp/sensor/EquirectangularSensor.h"
 #include "esp/sensor/FisheyeSensor.h"
+#include "esp/sensor/NoiseModel.h"
 #include "esp/sensor/VisualSensor.h"
 #ifdef ESP_BUILD_WITH_CUDA
 #include "esp/sensor/RedwoodNoiseModel.h"
@@ -40,6 +43,43 @@ esp::scene::SceneNode* nodeGetter(T& self) {
     throw py::value_error{"feature not valid"};
   return &self.node();
 };
+
+// buffer protocol format of an element of type
+std::string bufferFormat(const esp::core::DataType type) {
+  using esp::core::DataType;
+  switch (type) {
+    case DataType::DT_INT8:
+      return py::format_descriptor<int8_t>::format();
+    case DataType::DT_INT16:
+      return py::format_descriptor<int16_t>::format();
+    case DataType::DT_UINT16:
+      return py::format_descriptor<uint16_t>::format();
+    case DataType::DT_INT32:
+      return py::format_descriptor<int32_t>::format();
+    case DataType::DT_UINT32:
+      return py::format_descriptor<uint32_t>::format();
+    case DataType::DT_INT64:
+      return py::format_descriptor<int64_t>::format();
+    case DataType::DT_UINT64:
+      return py::format_descriptor<uint64_t>::format();
+    case DataType::DT_FLOAT:
+      return py::format_descriptor<float>::format();
+    case DataType::DT_DOUBLE:
+      return py::format_descriptor<double>::format();
+    case DataType::DT_FLOAT16:
+      return "e";
+    default:
+      return py::format_descriptor<uint8_t>::format();
+  }
+}
+
+const esp::core::Buffer& observationBuffer(
+    const esp::sensor::Observation& obs) {
+  if (!obs.buffer) {
+    throw py::value_error{"the observation has no host buffer"};
+  }
+  return *obs.buffer;
+}
 }  // namespace
 
 namespace esp {
@@ -47,8 +87,47 @@ namespace sensor {
 
 void initSensorBindings(py::module& m) {
   // ==== Observation ====
-  // NOLINTNEXTLINE(bugprone-unused-raii)
-  py::class_<Observation, Observation::ptr>(m, "Observation");
+  py::class_<Observation, Observation::ptr>(
+      m, "Observation", py::buffer_protocol(),
+      R"(An observation read by a sensor. Exposes the buffer it was read into without copies, through the buffer protocol (numpy.asarray()) and DLPack (torch.from_dlpack()). The views keep the buffer alive, but the sensor reads its next observation into the same buffer, so copy what has to outlive it. Rows are stored bottom first, as read from GL.)")
+      .def(py::init(&Observation::create<>))
+      .def_buffer([](Observation& self) {
+        const core::Buffer& buffer = observationBuffer(self);
+        const auto itemSize =
+            py::ssize_t(core::getDataTypeByteSize(buffer.dataType));
+        std::vector<py::ssize_t> shape(buffer.shape.begin(),
+                                       buffer.shape.end());
+        std::vector<py::ssize_t> strides(shape.size());
+        py::ssize_t stride = itemSize;
+        for (std::size_t i = shape.size(); i != 0; --i) {
+          strides[i - 1] = stride;
+          stride *= shape[i - 1];
+        }
+        return py::buffer_info{const_cast<uint8_t*>(buffer.data.data()),
+                               itemSize,
+                               bufferFormat(buffer.dataType),
+                               py::ssize_t(shape.size()),
+                               std::move(shape),
+                               std::move(strides)};
+      })
+      .def_property_readonly(
+          "shape",
+          [](Observation& self) { return observationBuffer(self).shape; },
+          R"(The shape of the observation.)")
+      .def(
+          "__dlpack__",
+          // newer consumers also pass max_version, which is ignored
+          [](Observation& self, const py::object&, const py::kwargs&) {
+            const core::Buffer& buffer = observationBuffer(self);
+            return dlpackCapsule(self.buffer,
+                                 const_cast<uint8_t*>(buffer.data.data()),
+                                 {dlpack::CPU, 0}, buffer.dataType,
+                                 buffer.shape);
+          },
+          "stream"_a = py::none())
+      .def("__dlpack_device__", [](Observation&) {
+        return py::make_tuple(int(dlpack::CPU), 0);
+      });
 
   // TODO fill out other SensorTypes
   // ==== enum SensorType ====
@@ -73,9 +152,57 @@ void initSensorBindings(py::module& m) {
       .value("SEMANTIC_ID", SemanticSensorTarget::SEMANTIC_ID)
       .value("OBJECT_ID", SemanticSensorTarget::OBJECT_ID);
 
+  py::enum_<ObservationFormat>(m, "ObservationFormat")
+      .value("DEFAULT", ObservationFormat::Default,
+             R"(RGBA8 color, 32-bit float depth, 32-bit unsigned semantic IDs)")
+      .value("RGB8", ObservationFormat::RGB8, R"(RGB8 color without alpha)")
+      .value("DEPTH_HALF", ObservationFormat::DepthHalf,
+             R"(16-bit float depth)")
+      .value("DEPTH_UNORM16", ObservationFormat::DepthUnorm16,
+             R"(16-bit unsigned normalized depth, 65535 at the far plane)")
+      .value("SEMANTIC_UNSIGNED_SHORT",
+             ObservationFormat::SemanticUnsignedShort,
+             R"(16-bit unsigned semantic IDs, which then need to fit into 16 bits)");
+
   py::enum_<FisheyeSensorModelType>(m, "FisheyeSensorModelType")
       .value("DOUBLE_SPHERE", FisheyeSensorModelType::DoubleSphere);
 
+  // ==== NoiseModel ====
+  py::class_<NoiseModel, NoiseModel::ptr>(
+      m, "NoiseModel",
+      R"(Noise applied on the GPU to the render target of a visual sensor
+      before its observation is read. Set through
+      VisualSensorSpec.render_target_noise_model.)")
+      .def("is_valid_sensor_type", &NoiseModel::isValidSensorType);
+
+  py::class_<RgbNoiseModel, RgbNoiseModel::ptr, NoiseModel> rgbNoiseModel(
+      m, "RgbNoiseModel",
+      R"(GPU counterpart of the Gaussian, salt and pepper, Poisson and speckle
+      noise models for color sensors. The noise is reproducible from the seed
+      and the number of frames noised since it was set.)");
+
+  py::enum_<RgbNoiseModel::Type>(rgbNoiseModel, "Type")
+      .value("GAUSSIAN", RgbNoiseModel::Type::Gaussian)
+      .value("SALT_AND_PEPPER", RgbNoiseModel::Type::SaltAndPepper)
+      .value("POISSON", RgbNoiseModel::Type::Poisson)
+      .value("SPECKLE", RgbNoiseModel::Type::Speckle);
+
+  rgbNoiseModel
+      .def(py::init(&RgbNoiseModel::create<RgbNoiseModel::Type, unsigned int>),
+           "type"_a, "seed"_a = 0)
+      .def_property_readonly("type", &RgbNoiseModel::type)
+      .def_property("seed", &RgbNoiseModel::seed, &RgbNoiseModel::setSeed,
+                    R"(Setting the seed restarts the frame count.)")
+      .def_property_readonly(
+          "frame", &RgbNoiseModel::frame,
+          R"(Number of frames noised since the seed was set.)")
+      .def_readwrite("intensity_constant", &RgbNoiseModel::intensityConstant)
+      .def_readwrite("mean", &RgbNoiseModel::mean)
+      .def_readwrite("sigma", &RgbNoiseModel::sigma)
+      .def_readwrite("amount", &RgbNoiseModel::amount)
+      .def_readwrite("salt_vs_pepper", &RgbNoiseModel::saltVsPepper)
+      .def_readwrite("levels", &RgbNoiseModel::levels);
+
   // ==== SensorSpec ====
   py::class_<SensorSpec, SensorSpec::ptr>(m, "SensorSpec", py::dynamic_attr())
       .def(py::init(&SensorSpec::create<>))
@@ -85,6 +212,9 @@ void initSensorBindings(py::module& m) {
       .def_readwrite("position", &SensorSpec::position)
       .def_readwrite("orientation", &SensorSpec::orientation)
       .def_readwrite("noise_model", &SensorSpec::noiseModel)
+      .def_readwrite(
+          "update_period", &SensorSpec::updatePeriod,
+          R"(Update the observation once every update_period calls of get_sensor_observations, the calls in between return the observation of the last update. 1 by default.)")
       .def_property(
           "noise_model_kwargs",
           // Note: self remains a python object handle
@@ -114,7 +244,22 @@ void initSensorBindings(py::module& m) {
           "semantic_target", &VisualSensorSpec::semanticTarget,
           R"(The type of information rendered by the semantic sensor. If this sensor is not semantic,
             this is ignored. Acceptable values : [SEMANTIC_ID(default), OBJECT_ID])")
-      .def_readwrite("clear_color", &VisualSensorSpec::clearColor);
+      .def_readwrite("clear_color", &VisualSensorSpec::clearColor)
+      .def_readwrite(
+          "observation_format", &VisualSensorSpec::observationFormat,
+          R"(The format observations are read as, converted on the GPU before the readback. Reduced
+            formats need to match the sensor type and aren't supported with gpu2gpu_transfer.)")
+      .def_readwrite(
+          "render_target_noise_model",
+          &VisualSensorSpec::renderTargetNoiseModel,
+          R"(Noise applied on the GPU before the observation is read, also for gpu2gpu transfers.
+            None by default. Independent of noise_model, which is applied afterwards.)")
+      .def_readwrite(
+          "downsample_levels", &VisualSensorSpec::downsampleLevels,
+          R"(Number of additional observations downsampled on the GPU from the rendered one, each at
+            half the resolution of the previous. Stored under downsampled_uuid(level).)")
+      .def("downsampled_uuid", &VisualSensorSpec::downsampledUuid, "level"_a,
+           R"(The uuid of the observation downsampled level times.)");
 
   // ====CameraSensorSpec ====
   py::class_<CameraSensorSpec, CameraSensorSpec::ptr, VisualSensorSpec>(
@@ -147,7 +292,7 @@ void initSensorBindings(py::module& m) {
                      &FisheyeSensorSpec::principalPointOffset)
       .def_readwrite(
           "cubemap_size", &FisheyeSensorSpec::cubemapSize,
-          R"(If not set, will be the min(height, width) of resolution)")
+          R"(If not set, sized so a cubemap texel covers about the angle of an observation pixel, at most the min(height, width) of resolution)")
       .def_readwrite("sensor_model_type", &FisheyeSensorSpec::fisheyeModelType);
 
   // ====FisheyeSensorDoubleSphereSpec ====
@@ -193,6 +338,11 @@ void initSensorBindings(py::module& m) {
       .def("set_transformation_from_spec", &Sensor::setTransformationFromSpec)
       .def("is_visual_sensor", &Sensor::isVisualSensor)
       .def("get_observation", &Sensor::getObservation)
+      .def(
+          "advance_update_schedule", &Sensor::advanceUpdateSchedule,
+          R"(Advance the update schedule given by SensorSpec.update_period by one step, returns whether the sensor has to update its observation in this step.)")
+      .def("reset_update_schedule", &Sensor::resetUpdateSchedule,
+           R"(Make the next update schedule step due.)")
       .def_property_readonly("node", nodeGetter<Sensor>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<Sensor>, "Alias to node");
@@ -215,7 +365,51 @@ void initSensorBindings(py::module& m) {
           "hfov", [](VisualSensor& self) { return Mn::Degd(self.getFOV()); },
           R"(The Field of View this VisualSensor uses.)")
       .def_property_readonly("framebuffer_size", &VisualSensor::framebufferSize)
-      .def_property_readonly("render_target", &VisualSensor::renderTarget);
+      .def_property_readonly(
+          "observation_pixel_format", &VisualSensor::observationPixelFormat,
+          R"(The pixel format observations of this sensor are read as, see VisualSensorSpec.observation_format.)")
+      .def("downsampled_framebuffer_size",
+           &VisualSensor::downsampledFramebufferSize, "level"_a,
+           R"(The [W, H] size of the observation downsampled level times.)")
+      .def(
+          "read_observation",
+          [](VisualSensor& self) {
+            Observation::ptr obs = Observation::create();
+            {
+              py::gil_scoped_release release;
+              self.readObservation(*obs);
+            }
+            return obs;
+          },
+          R"(Read the drawn observation into the buffer of the sensor and return it as an Observation, a view of the buffer that converts to numpy or torch without copies.)")
+#ifdef ESP_BUILD_WITH_CUDA
+      .def(
+          "read_observation_gpu_dlpack",
+          [](VisualSensor& self) {
+            VisualSensor::GpuObservation gpuObs;
+            {
+              py::gil_scoped_release release;
+              gpuObs = self.readObservationGpu();
+            }
+            ObservationSpace space;
+            self.getObservationSpace(space);
+            void* devPtr = gpuObs.data.get();
+            return dlpackCapsule(std::move(gpuObs.data), devPtr,
+                                 {dlpack::CUDA, gpuObs.device},
+                                 space.dataType, space.shape);
+          },
+          R"(Read the drawn observation into CUDA memory owned by the sensor and return it as a DLPack capsule for torch.utils.dlpack.from_dlpack(), so it never goes through host memory. The tensor keeps the memory alive, but the next read overwrites it. Rows are stored bottom first, as read from GL.)")
+#endif
+      .def_property_readonly("render_target", &VisualSensor::renderTarget)
+      .def_property_readonly(
+          "is_observation_unchanged", &VisualSensor::isObservationUnchanged,
+          R"(Whether the last draw was skipped because the camera, the light setups and the drawables the sensor sees didn't change, see SimulatorConfiguration.skip_unchanged_frames. The render target then still holds the previous observation.)")
+      .def(
+          "reset_observation_cache", &VisualSensor::resetObservationCache,
+          R"(Make the next draw happen even if nothing changed, e.g. after changing materials or semantic ids, which aren't detected.)")
+      .def_property_readonly(
+          "observation_render_target", &VisualSensor::observationRenderTarget,
+          R"(The render target the observation of this sensor is read from. This is the render target of another sensor if both were drawn in a single pass by Simulator.draw_agent_observations.)");
 
   // === CameraSensor ====
   py::class_<CameraSensor, Magnum::SceneGraph::PyFeature<CameraSensor>,
@@ -294,7 +488,18 @@ void initSensorBindings(py::module& m) {
                                    const int cols, std::size_t devNoisyDepth) {
         self.simulateFromGPU(reinterpret_cast<const float*>(devDepth), rows,
                              cols, reinterpret_cast<float*>(devNoisyDepth));
-      });
+      })
+      .def(
+          "simulate_tiles_from_gpu",
+          [](RedwoodNoiseModelGPUImpl& self, std::size_t devDepth,
+             const int tileRows, const int tileCols, const int tileCountRows,
+             const int tileCountCols, std::size_t devNoisyDepth) {
+            self.simulateTilesFromGPU(
+                reinterpret_cast<const float*>(devDepth), tileRows, tileCols,
+                tileCountRows, tileCountCols,
+                reinterpret_cast<float*>(devNoisyDepth));
+          },
+          R"(Noise a row-major grid of tileCountRows x tileCountCols depth images of tileRows x tileCols each, such as a batch renderer depth buffer, in one kernel launch.)");
 #endif
 
 #ifdef ESP_BUILD_WITH_AUDIO
@@ -437,7 +642,10 @@ void initSensorBindings(py::module& m) {
           R"(RLRAudioPropagationConfiguration | Defined in the relevant section | Acoustic configuration struct that defines simulation parameters)")
       .def_readwrite(
           "channelLayout", &AudioSensorSpec::channelLayout_,
-          R"(RLRAudioPropagationChannelLayout | Defined in the relevant section | Channel layout for simulated output audio)");
+          R"(RLRAudioPropagationChannelLayout | Defined in the relevant section | Channel layout for simulated output audio)")
+      .def_readwrite(
+          "inMemoryIR", &AudioSensorSpec::inMemoryIR_,
+          R"(bool | false | Keep the simulation output in memory only. No simulation folder, impulse response or wave files are written, and observations are returned as a float32 array of shape (channelCount, sampleCount))");
 #else
   py::class_<AudioSensorSpec, AudioSensorSpec::ptr, SensorSpec>(
       m, "AudioSensorSpec", py::dynamic_attr())
@@ -455,6 +663,44 @@ void initSensorBindings(py::module& m) {
       .def("runSimulation", &AudioSensor::runSimulation)
       .def("setAudioMaterialsJSON", &AudioSensor::setAudioMaterialsJSON)
       .def("getIR", &AudioSensor::getIR)
+      .def(
+          "getIRArray",
+          [](AudioSensor& self) {
+            ObservationSpace obsSpace;
+            self.getObservationSpace(obsSpace);
+            py::array_t<float> ir{{obsSpace.shape[0], obsSpace.shape[1]}};
+            self.readIR({ir.mutable_data(), std::size_t(ir.size())});
+            return ir;
+          },
+          R"(Return the last impulse response as a contiguous float32 array of shape (channelCount, sampleCount), without the nested lists of getIR())")
+      .def(
+          "runSimulations",
+          [](AudioSensor& self, sim::Simulator& sim,
+             const std::vector<Mn::Vector3>& sourcePositions,
+             const std::vector<Mn::Vector3>& agentPositions,
+             const std::vector<Mn::Vector4>& agentRotQuats, int numThreads) {
+            ESP_CHECK(sourcePositions.size() == agentPositions.size() &&
+                          sourcePositions.size() == agentRotQuats.size(),
+                      "AudioSensor.runSimulations(): expected the same "
+                      "number of source positions, agent positions and "
+                      "agent rotations");
+            std::vector<AudioSensor::SimulationRequest> requests;
+            requests.reserve(sourcePositions.size());
+            for (std::size_t i = 0; i != sourcePositions.size(); ++i) {
+              requests.push_back(
+                  {sourcePositions[i], agentPositions[i], agentRotQuats[i]});
+            }
+            py::gil_scoped_release release;
+            return self.runSimulations(sim, requests, numThreads);
+          },
+          "sim"_a, "source_positions"_a, "agent_positions"_a,
+          "agent_rotations"_a, "num_threads"_a = 0,
+          R"(Compute the impulse responses of many source/listener pairs concurrently on a thread pool,
+            returning one getIR()-shaped result per pair. The acousticsConfig threadCount applies to
+            each worker simulator.)")
+      .def_static("clearMeshCache", &AudioSensor::clearMeshCache,
+                  R"(Drop the acoustic meshes shared by all audio sensors, e.g. after the static
+                  geometry of a scene changed.)")
       .def("reset", &AudioSensor::reset);
 #else
   py::class_<AudioSensor, Magnum::SceneGraph::PyFeature<AudioSensor>, Sensor,
@@ -6,12 +6,18 @@
 
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/OptionalPythonBindings.h>
 #include <Magnum/Math/Vector3.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "esp/assets/MeshData.h"
+#include "esp/core/Check.h"
 #include "esp/core/Esp.h"
 #include "esp/nav/GreedyFollower.h"
 #include "esp/nav/PathFinder.h"
@@ -25,6 +31,36 @@ using py::literals::operator""_a;
 namespace esp {
 namespace nav {
 
+namespace {
+using PointArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+using PolyRefArray =
+    py::array_t<uint64_t, py::array::c_style | py::array::forcecast>;
+
+static_assert(sizeof(vec3f) == 3 * sizeof(float),
+              "vec3f must be tightly packed to view numpy points");
+
+//! View an Nx3 float32 array as points without copying
+Corrade::Containers::ArrayView<const vec3f> pointsView(
+    const PointArray& points) {
+  ESP_CHECK(points.ndim() == 2 && points.shape(1) == 3,
+            "Expected an Nx3 array of points");
+  return {reinterpret_cast<const vec3f*>(points.data()),
+          static_cast<std::size_t>(points.shape(0))};
+}
+
+//! Copy points into a new Nx3 float32 array
+PointArray pointsArray(const std::vector<vec3f>& points) {
+  PointArray array({static_cast<py::ssize_t>(points.size()), py::ssize_t{3}});
+  if (!points.empty()) {
+    std::memcpy(array.mutable_data(), points.data(),
+                points.size() * sizeof(vec3f));
+  }
+  return array;
+}
+}  // namespace
+
 void initShortestPathBindings(py::module& m) {
   py::class_<HitRecord>(m, "HitRecord",
                         R"(Struct for recording closest obstacle information.)")
@@ -37,6 +73,24 @@ void initShortestPathBindings(py::module& m) {
           "hit_dist", &HitRecord::hitDist,
           R"(Distance from query point to closest obstacle. Inf if no valid point was found.)");
 
+  py::class_<IslandStatistics>(
+      m, "IslandStatistics",
+      R"(Precomputed properties of a NavMesh island. See PathFinder.island_statistics().)")
+      .def(py::init())
+      .def_readwrite("area", &IslandStatistics::area,
+                     R"(Walkable area of the island's polygons.)")
+      .def_readwrite(
+          "radius", &IslandStatistics::radius,
+          R"(Max distance of the island's polygon vertices from their mean.)")
+      .def_readwrite("centroid", &IslandStatistics::centroid,
+                     R"(Mean of the island's polygon vertices.)")
+      .def_readwrite("bounds_min", &IslandStatistics::boundsMin,
+                     R"(Minimum corner of the island's bounding box.)")
+      .def_readwrite("bounds_max", &IslandStatistics::boundsMax,
+                     R"(Maximum corner of the island's bounding box.)")
+      .def_readwrite("num_polys", &IslandStatistics::numPolys,
+                     R"(Number of polygons in the island.)");
+
   py::class_<ShortestPath, ShortestPath::ptr>(
       m, "ShortestPath",
       R"(Struct for shortest path finding. Used in conjunction with PathFinder.findPath().)")
@@ -145,17 +199,38 @@ void initShortestPathBindings(py::module& m) {
       .def(
           "get_bounds", &PathFinder::bounds,
           R"(Get the axis aligned bounding box containing the navigation mesh.)")
+      .def(
+          "set_build_tiling", &PathFinder::setBuildTiling, "tile_size"_a,
+          "num_threads"_a = 0,
+          R"(Configure tiled NavMesh construction: the navigable region is split into tiles of tile_size cells which are built in parallel across num_threads worker threads (default uses all cores). tile_size <= 0 (default) builds a single tile.)")
+      .def_property_readonly(
+          "build_tile_size", &PathFinder::getBuildTileSize,
+          R"(The tile edge length in cells used for NavMesh construction, <= 0 for a single tile.)")
       .def(
           "seed", &PathFinder::seed,
           R"(Seed the pathfinder.  Useful for get_random_navigable_point(). Seeds the global c rand function.)")
       .def(
-          "get_topdown_view", &PathFinder::getTopDownView,
-          R"(Returns the topdown view of the PathFinder's navmesh at a given vertical slice with eps slack.)",
-          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5)
+          "get_topdown_view",
+          [](PathFinder& self, float metersPerPixel, float height, float eps,
+             bool rasterize, int numThreads) {
+            py::gil_scoped_release release;
+            return self.getTopDownView(metersPerPixel, height, eps, rasterize,
+                                       numThreads);
+          },
+          R"(Returns the topdown view of the PathFinder's navmesh at a given vertical slice with eps slack. If rasterize is True, the navmesh polygons are rasterized into the grid instead of querying each cell, which is much faster and differs only for cells within millimeters of polygon boundaries. Rows are processed across num_threads worker threads (default uses all cores).)",
+          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5,
+          "rasterize"_a = false, "num_threads"_a = 0)
       .def(
-          "get_topdown_island_view", &PathFinder::getTopDownIslandView,
-          R"(Returns the topdown view of the PathFinder's navmesh with island indices at each point or -1 for non-navigable cells for a given vertical slice with eps slack.)",
-          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5)
+          "get_topdown_island_view",
+          [](PathFinder& self, float metersPerPixel, float height, float eps,
+             bool rasterize, int numThreads) {
+            py::gil_scoped_release release;
+            return self.getTopDownIslandView(metersPerPixel, height, eps,
+                                             rasterize, numThreads);
+          },
+          R"(Returns the topdown view of the PathFinder's navmesh with island indices at each point or -1 for non-navigable cells for a given vertical slice with eps slack. See get_topdown_view() for rasterize and num_threads.)",
+          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5,
+          "rasterize"_a = false, "num_threads"_a = 0)
       // detailed docs in docs/docs.rst
       .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint,
            "max_tries"_a = 10, "island_index"_a = ID_UNDEFINED)
@@ -164,15 +239,111 @@ void initShortestPathBindings(py::module& m) {
           &PathFinder::getRandomNavigablePointAroundSphere, "circle_center"_a,
           "radius"_a, "max_tries"_a = 100, "island_index"_a = ID_UNDEFINED,
           R"(Returns a random navigable point within a specified radius about a given point. Optionally specify the island from which to sample the point. Default -1 queries the full navmesh.)")
+      .def(
+          "get_random_navigable_points",
+          [](PathFinder& self, int numPoints, int islandIndex,
+             const Corrade::Containers::Optional<uint32_t>& seed,
+             int numThreads) {
+            std::vector<vec3f> points;
+            {
+              py::gil_scoped_release release;
+              points = self.getRandomNavigablePoints(numPoints, islandIndex,
+                                                     seed, numThreads);
+            }
+            return pointsArray(points);
+          },
+          "num_points"_a, "island_index"_a = ID_UNDEFINED,
+          "seed"_a = Corrade::Containers::NullOpt, "num_threads"_a = 0,
+          R"(Returns an Nx3 array of random navigable points sampled uniformly over the navigable area of the island (default -1 for the full navmesh). The result is reproducible for a given seed independent of num_threads. If no seed is given, one is drawn from the generator set by seed().)")
+      .def(
+          "get_random_navigable_points_near",
+          [](PathFinder& self, const vec3f& circleCenter, float radius,
+             int numPoints, int maxTries, int islandIndex,
+             const Corrade::Containers::Optional<uint32_t>& seed,
+             int numThreads) {
+            std::vector<vec3f> points;
+            {
+              py::gil_scoped_release release;
+              points = self.getRandomNavigablePointsAroundSphere(
+                  circleCenter, radius, numPoints, maxTries, islandIndex,
+                  seed, numThreads);
+            }
+            return pointsArray(points);
+          },
+          "circle_center"_a, "radius"_a, "num_points"_a, "max_tries"_a = 100,
+          "island_index"_a = ID_UNDEFINED,
+          "seed"_a = Corrade::Containers::NullOpt, "num_threads"_a = 0,
+          R"(Returns an Nx3 array of random navigable points within a specified radius about a given point. Rows are NaN for points that couldn't be sampled within max_tries. See get_random_navigable_points() for seed and num_threads.)")
       .def(
           "find_path", py::overload_cast<ShortestPath&>(&PathFinder::findPath),
-          "path"_a,
-          R"(Finds the shortest path between two points on the navigation mesh using ShortestPath module. Path variable is filled if successful. Returns boolean success.)")
+          "path"_a, py::call_guard<py::gil_scoped_release>(),
+          R"(Finds the shortest path between two points on the navigation mesh using ShortestPath module. Path variable is filled if successful. Returns boolean success. Releases the GIL while searching.)")
       .def(
           "find_path",
           py::overload_cast<MultiGoalShortestPath&>(&PathFinder::findPath),
+          "path"_a, py::call_guard<py::gil_scoped_release>(),
+          R"(Finds the shortest path between a start point and the closest of a set of end points (in geodesic distance) on the navigation mesh using MultiGoalShortestPath module. Path variable is filled if successful. Returns boolean success. Releases the GIL while searching.)")
+      .def(
+          "find_paths",
+          [](PathFinder& self, const std::vector<ShortestPath::ptr>& paths,
+             int numThreads) {
+            std::vector<ShortestPath> batch;
+            batch.reserve(paths.size());
+            for (const auto& path : paths) {
+              batch.emplace_back(*path);
+            }
+            int numFound = 0;
+            {
+              py::gil_scoped_release release;
+              numFound = self.findPaths(batch, numThreads);
+            }
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+              *paths[i] = std::move(batch[i]);
+            }
+            return numFound;
+          },
+          "paths"_a, "num_threads"_a = 0,
+          R"(Finds the shortest paths for a list of ShortestPath objects in parallel across num_threads worker threads (default uses all cores). Each path variable is filled if successful. Returns the number of paths found.)")
+      .def(
+          "get_geodesic_distances",
+          [](PathFinder& self, const std::vector<vec3f>& starts,
+             const std::vector<vec3f>& ends, int numThreads) {
+            py::gil_scoped_release release;
+            return self.getGeodesicDistances(starts, ends, numThreads);
+          },
+          "starts"_a, "ends"_a, "num_threads"_a = 0,
+          R"(Computes the geodesic distance between each pair of start and end points in parallel across num_threads worker threads (default uses all cores). Distances are inf for pairs with no path.)")
+      .def(
+          "build_distance_oracle",
+          [](PathFinder& self, std::size_t maxMemoryBytes, int numThreads) {
+            py::gil_scoped_release release;
+            return self.buildDistanceOracle(maxMemoryBytes, numThreads);
+          },
+          "max_memory_bytes"_a = 64 * 1024 * 1024, "num_threads"_a = 0,
+          R"(Precompute a landmark distance table over the NavMesh polygons within the max_memory_bytes budget. All-pairs if the budget allows. Discarded when a new NavMesh is loaded or built.)")
+      .def_property_readonly(
+          "has_distance_oracle", &PathFinder::hasDistanceOracle,
+          R"(Whether a distance oracle was built or loaded for the current NavMesh.)")
+      .def(
+          "get_oracle_distance", &PathFinder::getOracleDistance, "a"_a, "b"_a,
+          R"(Approximate geodesic distance between two points from the precomputed distance oracle. Inf if no path exists.)")
+      .def(
+          "get_oracle_distance_bounds", &PathFinder::getOracleDistanceBounds,
+          "a"_a, "b"_a,
+          R"(Lower and upper bounds on the geodesic distance between two points from the precomputed distance oracle.)")
+      .def(
+          "save_distance_oracle", &PathFinder::saveDistanceOracle, "path"_a,
+          R"(Save the distance oracle, typically alongside the .navmesh file.)")
+      .def(
+          "load_distance_oracle", &PathFinder::loadDistanceOracle, "path"_a,
+          R"(Load a distance oracle saved with save_distance_oracle() for the current NavMesh.)")
+      .def(
+          "build_goal_distance_field", &PathFinder::buildGoalDistanceField,
           "path"_a,
-          R"(Finds the shortest path between a start point and the closest of a set of end points (in geodesic distance) on the navigation mesh using MultiGoalShortestPath module. Path variable is filled if successful. Returns boolean success.)")
+          R"(Precompute a distance-to-goal field for the requested ends of a MultiGoalShortestPath so get_goal_distance() can answer distance queries toward the goal set without a path search. Returns boolean success.)")
+      .def(
+          "get_goal_distance", &PathFinder::getGoalDistance, "path"_a, "pt"_a,
+          R"(Approximate geodesic distance from pt to the closest goal of a field built with build_goal_distance_field(). Inf if no goal is reachable.)")
       .def("try_step", &PathFinder::tryStep<Magnum::Vector3>, "start"_a,
            "end"_a)
       .def("try_step", &PathFinder::tryStep<vec3f>, "start"_a, "end"_a)
@@ -180,6 +351,38 @@ void initShortestPathBindings(py::module& m) {
            &PathFinder::tryStepNoSliding<Magnum::Vector3>, "start"_a, "end"_a)
       .def("try_step_no_sliding", &PathFinder::tryStepNoSliding<vec3f>,
            "start"_a, "end"_a)
+      .def(
+          "try_steps",
+          [](PathFinder& self, const PointArray& starts, const PointArray& ends,
+             const Corrade::Containers::Optional<PolyRefArray>& polyRefs,
+             bool allowSliding, int numThreads) {
+            const auto startsView = pointsView(starts);
+            const auto endsView = pointsView(ends);
+            ESP_CHECK(!polyRefs || polyRefs->size() == starts.shape(0),
+                      "Expected one poly ref per start");
+            PointArray stepped({starts.shape(0), py::ssize_t{3}});
+            PolyRefArray newPolyRefs(starts.shape(0));
+            if (polyRefs && polyRefs->size() > 0) {
+              std::memcpy(newPolyRefs.mutable_data(), polyRefs->data(),
+                          polyRefs->size() * sizeof(uint64_t));
+            } else {
+              std::fill_n(newPolyRefs.mutable_data(), newPolyRefs.size(), 0);
+            }
+            {
+              py::gil_scoped_release release;
+              self.trySteps(
+                  startsView, endsView,
+                  {reinterpret_cast<vec3f*>(stepped.mutable_data()),
+                   startsView.size()},
+                  {newPolyRefs.mutable_data(), startsView.size()},
+                  allowSliding, numThreads);
+            }
+            return py::make_tuple(stepped, newPolyRefs);
+          },
+          "starts"_a, "ends"_a,
+          "poly_refs"_a = Corrade::Containers::NullOpt,
+          "allow_sliding"_a = true, "num_threads"_a = 0,
+          R"(Step a batch of agents from an Nx3 array of starts towards an Nx3 array of ends in parallel across num_threads worker threads (default uses all cores). Returns the stepped Nx3 points and the NavMesh poly of each of them, pass these back as poly_refs on the next step to skip searching for the start polys.)")
       .def("snap_point", &PathFinder::snapPoint<Magnum::Vector3>, "point"_a,
            "island_index"_a = ID_UNDEFINED)
       .def("snap_point", &PathFinder::snapPoint<vec3f>, "point"_a,
@@ -190,6 +393,38 @@ void initShortestPathBindings(py::module& m) {
       .def(
           "get_island", &PathFinder::getIsland<vec3f>, "point"_a,
           R"(Query the island closest to a point. Snaps the point to the NavMesh first, so check the snap distance also if unsure.)")
+      .def(
+          "snap_points",
+          [](PathFinder& self, const PointArray& points, int islandIndex,
+             int numThreads) {
+            const auto view = pointsView(points);
+            PointArray snapped({points.shape(0), py::ssize_t{3}});
+            {
+              py::gil_scoped_release release;
+              self.snapPoints(
+                  view,
+                  {reinterpret_cast<vec3f*>(snapped.mutable_data()),
+                   view.size()},
+                  islandIndex, numThreads);
+            }
+            return snapped;
+          },
+          "points"_a, "island_index"_a = ID_UNDEFINED, "num_threads"_a = 0,
+          R"(Snap an Nx3 array of points to the NavMesh in parallel across num_threads worker threads (default uses all cores). Rows are NaN where snapping failed.)")
+      .def(
+          "get_islands",
+          [](PathFinder& self, const PointArray& points, int numThreads) {
+            const auto view = pointsView(points);
+            py::array_t<int> islands(points.shape(0));
+            {
+              py::gil_scoped_release release;
+              self.getIslands(view, {islands.mutable_data(), view.size()},
+                              numThreads);
+            }
+            return islands;
+          },
+          "points"_a, "num_threads"_a = 0,
+          R"(Query the islands of an Nx3 array of points in parallel across num_threads worker threads (default uses all cores). Entries are -1 where the query failed.)")
       .def(
           "island_radius",
           [](PathFinder& self, const vec3f& pt) {
@@ -207,6 +442,9 @@ void initShortestPathBindings(py::module& m) {
       .def_property_readonly(
           "num_islands", &PathFinder::numIslands,
           R"(The number of connected components making up the navmesh.)")
+      .def(
+          "island_statistics", &PathFinder::islandStatistics,
+          R"(The area, radius, centroid, bounds and polygon count of every island, indexed by island. Precomputed per NavMesh, so much cheaper than querying islands one by one.)")
       .def_property_readonly(
           "is_loaded", &PathFinder::isLoaded,
           R"(Whether a valid navigation mesh is currently loaded or not.)")
@@ -234,9 +472,25 @@ void initShortestPathBindings(py::module& m) {
           R"(Returns an array of triangle index data for the triangulated NavMesh poly vertices returned by build_navmesh_vertices(). Optionally limit results to a specific island. Default (island_index==-1) queries all islands.)")
       .def("load_nav_mesh", &PathFinder::loadNavMesh, "path"_a,
            R"(Load a .navmesh file overriding this PathFinder instance.)")
+      .def(
+          "load_nav_mesh_mapped", &PathFinder::loadNavMeshMapped, "path"_a,
+          R"(Load a .navmesh file by memory mapping it instead of copying it, sharing the unmodified tile data with all other processes mapping the same file.)")
       .def(
           "save_nav_mesh", &PathFinder::saveNavMesh, "path"_a,
           R"(Serialize this PathFinder instance and current NavMesh settings to a .navmesh file.)")
+      .def(
+          "set_obstacle_distance_field",
+          [](PathFinder& self, float metersPerCell, float maxRadius,
+             int numThreads) {
+            py::gil_scoped_release release;
+            return self.setObstacleDistanceField(metersPerCell, maxRadius,
+                                                 numThreads);
+          },
+          "meters_per_cell"_a, "max_radius"_a = 2.0, "num_threads"_a = 0,
+          R"(Precompute distance_to_closest_obstacle() on a grid with meters_per_cell spacing for each NavMesh layer, now and whenever a NavMesh is loaded or built. Queries interpolate it and fall back to the exact search where it can't answer. A meters_per_cell <= 0 disables it.)")
+      .def_property_readonly(
+          "has_obstacle_distance_field", &PathFinder::hasObstacleDistanceField,
+          R"(Whether an obstacle distance field was built for the current NavMesh.)")
       .def("distance_to_closest_obstacle",
            &PathFinder::distanceToClosestObstacle,
            R"(Returns the distance to the closest obstacle.)", "pt"_a,
@@ -250,6 +504,21 @@ void initShortestPathBindings(py::module& m) {
       .def("is_navigable", &PathFinder::isNavigable,
            R"(Checks to see if the agent can stand at the specified point.)",
            "pt"_a, "max_y_delta"_a = 0.5)
+      .def(
+          "are_navigable",
+          [](PathFinder& self, const PointArray& points, float maxYDelta,
+             int numThreads) {
+            const auto view = pointsView(points);
+            py::array_t<bool> navigable(points.shape(0));
+            {
+              py::gil_scoped_release release;
+              self.areNavigable(view, {navigable.mutable_data(), view.size()},
+                                maxYDelta, numThreads);
+            }
+            return navigable;
+          },
+          "points"_a, "max_y_delta"_a = 0.5, "num_threads"_a = 0,
+          R"(Checks an Nx3 array of points for navigability in parallel across num_threads worker threads (default uses all cores).)")
       .def_property_readonly("nav_mesh_settings",
                              &PathFinder::getNavMeshSettings,
                              R"(The settings for the current NavMesh.)");
@@ -291,6 +560,17 @@ void initShortestPathBindings(py::module& m) {
            py::overload_cast<const core::RigidState&, const Mn::Vector3&>(
                &GreedyGeodesicFollowerImpl::findPath),
            py::return_value_policy::move)
+      .def("find_path_with_goal_field",
+           py::overload_cast<const Mn::Quaternion&, const Mn::Vector3&,
+                             const Mn::Vector3&, bool>(
+               &GreedyGeodesicFollowerImpl::findPathWithGoalField),
+           "start_rot"_a, "start_pos"_a, "end"_a, "allow_sliding"_a = true,
+           py::return_value_policy::move)
+      .def("find_path_with_goal_field",
+           py::overload_cast<const core::RigidState&, const Mn::Vector3&, bool>(
+               &GreedyGeodesicFollowerImpl::findPathWithGoalField),
+           "start"_a, "end"_a, "allow_sliding"_a = true,
+           py::return_value_policy::move)
       .def("reset", &GreedyGeodesicFollowerImpl::reset);
 }
 
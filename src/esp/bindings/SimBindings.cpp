@@ -4,6 +4,9 @@
 
 #include "esp/bindings/Bindings.h"
 
+#include <pybind11/numpy.h>
+
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
@@ -11,7 +14,9 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/core/Check.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/ReplayManager.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
@@ -20,8 +25,10 @@
 #include "esp/sim/AbstractReplayRenderer.h"
 #include "esp/sim/BatchReplayRenderer.h"
 #include "esp/sim/ClassicReplayRenderer.h"
+#include "esp/sim/ShardedBatchReplayRenderer.h"
 #include "esp/sim/Simulator.h"
 #include "esp/sim/SimulatorConfiguration.h"
+#include "esp/sim/VectorSimulator.h"
 
 namespace py = pybind11;
 using py::literals::operator""_a;
@@ -29,6 +36,148 @@ using py::literals::operator""_a;
 namespace esp {
 namespace sim {
 
+namespace {
+
+using RayArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+using StateArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+//! Cast the rays of two Nx3 origin and direction arrays, returning the
+//! object IDs, distances, points and normals of the closest hits as arrays
+py::tuple castRays(Simulator& sim,
+                   const RayArray& origins,
+                   const RayArray& directions,
+                   double maxDistance,
+                   int numThreads) {
+  ESP_CHECK(origins.ndim() == 2 && origins.shape(1) == 3,
+            "Expected an Nx3 array of ray origins");
+  ESP_CHECK(directions.ndim() == 2 && directions.shape(1) == 3 &&
+                directions.shape(0) == origins.shape(0),
+            "Expected an Nx3 array of ray directions matching the origins");
+
+  const py::ssize_t count = origins.shape(0);
+  const auto o = origins.unchecked<2>();
+  const auto d = directions.unchecked<2>();
+  std::vector<geo::Ray> rays;
+  rays.reserve(count);
+  for (py::ssize_t i = 0; i != count; ++i) {
+    rays.emplace_back(Mn::Vector3{o(i, 0), o(i, 1), o(i, 2)},
+                      Mn::Vector3{d(i, 0), d(i, 1), d(i, 2)});
+  }
+
+  std::vector<physics::RayHitInfo> hits(count);
+  {
+    py::gil_scoped_release release;
+    sim.castRays(rays, maxDistance, hits, numThreads);
+  }
+
+  py::array_t<int> objectIds(count);
+  py::array_t<double> distances(count);
+  py::array_t<float> points({count, py::ssize_t{3}});
+  py::array_t<float> normals({count, py::ssize_t{3}});
+  auto ids = objectIds.mutable_unchecked<1>();
+  auto dist = distances.mutable_unchecked<1>();
+  auto p = points.mutable_unchecked<2>();
+  auto n = normals.mutable_unchecked<2>();
+  for (py::ssize_t i = 0; i != count; ++i) {
+    ids(i) = hits[i].objectId;
+    dist(i) = hits[i].rayDistance;
+    for (py::ssize_t j = 0; j != 3; ++j) {
+      p(i, j) = hits[i].point[j];
+      n(i, j) = hits[i].normal[j];
+    }
+  }
+  return py::make_tuple(objectIds, distances, points, normals);
+}
+
+//! Test a rigid object for contacts at the poses of Nx3 translation and Nx4
+//! xyzw rotation arrays, returning a bool array
+py::array_t<bool> contactTestRigidObjectPoses(Simulator& sim,
+                                              int objectId,
+                                              const StateArray& translations,
+                                              const StateArray& rotations) {
+  ESP_CHECK(translations.ndim() == 2 && translations.shape(1) == 3,
+            "Expected an Nx3 array of translations");
+  ESP_CHECK(rotations.ndim() == 2 && rotations.shape(1) == 4 &&
+                rotations.shape(0) == translations.shape(0),
+            "Expected an Nx4 array of xyzw rotations matching the "
+            "translations");
+
+  const py::ssize_t count = translations.shape(0);
+  const auto t = translations.unchecked<2>();
+  const auto r = rotations.unchecked<2>();
+  std::vector<Mn::Matrix4> poses;
+  poses.reserve(count);
+  for (py::ssize_t i = 0; i != count; ++i) {
+    poses.push_back(Mn::Matrix4::from(
+        Mn::Quaternion{{r(i, 0), r(i, 1), r(i, 2)}, r(i, 3)}
+            .normalized()
+            .toMatrix(),
+        {t(i, 0), t(i, 1), t(i, 2)}));
+  }
+
+  py::array_t<bool> inContact(count);
+  sim.contactTestRigidObjectPoses(
+      objectId, poses,
+      {inContact.mutable_data(), static_cast<std::size_t>(count)});
+  return inContact;
+}
+
+//! Test an articulated object for contacts in the joint configurations of
+//! an NxC array, returning a bool array
+py::array_t<bool> contactTestArticulatedObjectJointPositions(
+    Simulator& sim,
+    int objectId,
+    const StateArray& jointPositions) {
+  ESP_CHECK(jointPositions.ndim() == 2,
+            "Expected an NxC array of joint positions");
+  const std::size_t rows = jointPositions.shape(0);
+  const std::size_t columns = jointPositions.shape(1);
+  py::array_t<bool> inContact(rows);
+  sim.contactTestArticulatedObjectJointPositions(
+      objectId,
+      Cr::Containers::StridedArrayView2D<const float>{
+          {jointPositions.data(), rows * columns}, {rows, columns}},
+      {inContact.mutable_data(), rows});
+  return inContact;
+}
+
+//! Sample random agent states, returning Nx3 positions and Nx4 xyzw
+//! rotations
+py::tuple sampleRandomAgentStates(Simulator& sim,
+                                  int numStates,
+                                  float minIslandArea,
+                                  float minObstacleDistance,
+                                  int islandIndex,
+                                  int maxTries,
+                                  int numThreads) {
+  std::vector<agent::AgentState> states;
+  {
+    py::gil_scoped_release release;
+    states = sim.sampleRandomAgentStates(numStates, minIslandArea,
+                                         minObstacleDistance, islandIndex,
+                                         maxTries, numThreads);
+  }
+
+  const py::ssize_t count = states.size();
+  py::array_t<float> positions({count, py::ssize_t{3}});
+  py::array_t<float> rotations({count, py::ssize_t{4}});
+  auto p = positions.mutable_unchecked<2>();
+  auto r = rotations.mutable_unchecked<2>();
+  for (py::ssize_t i = 0; i != count; ++i) {
+    for (py::ssize_t j = 0; j != 3; ++j) {
+      p(i, j) = states[i].position[j];
+    }
+    for (py::ssize_t j = 0; j != 4; ++j) {
+      r(i, j) = states[i].rotation[j];
+    }
+  }
+  return py::make_tuple(positions, rotations);
+}
+
+}  // namespace
+
 void initSimBindings(py::module& m) {
   // ==== SimulatorConfiguration ====
   py::class_<SimulatorConfiguration, SimulatorConfiguration::ptr>(
@@ -96,15 +245,116 @@ void initSimBindings(py::module& m) {
       .def_readwrite(
           "requires_textures", &SimulatorConfiguration::requiresTextures,
           R"(Whether or not to load textures for the meshes. This MUST be true for RGB rendering.)")
+      .def_readwrite(
+          "num_asset_decode_threads",
+          &SimulatorConfiguration::numAssetDecodeThreads,
+          R"(Number of threads decoding texture images while loading render assets. Values <= 0 select the hardware concurrency of the machine, 1 decodes on the calling thread only.)")
+      .def_readwrite(
+          "asset_cache_budget", &SimulatorConfiguration::assetCacheBudget,
+          R"(Memory budget in bytes for render assets kept loaded across scene switches. When exceeded after a scene is created, the least recently used assets the scene doesn't use are unloaded. 0 keeps every asset loaded until close().)")
+      .def_readwrite(
+          "share_gpu_resources", &SimulatorConfiguration::shareGpuResources,
+          R"(Create the GL context in a process-wide share group and share the GPU resources of render assets with all other simulators in the process doing the same, instead of uploading a copy per simulator. Supported only for windowless contexts on desktop GL.)")
+      .def_readwrite(
+          "pool_gl_contexts", &SimulatorConfiguration::poolGlContexts,
+          R"(Take the windowless GL context from a process-wide pool and give it back on close(), so simulators created again later in the process reuse it instead of creating a new one.)")
+      .def_readwrite(
+          "semantic_mesh_cache_directory",
+          &SimulatorConfiguration::semanticMeshCacheDirectory,
+          R"(Existing directory caching the semantic meshes built from vertex-annotated semantic assets, so later loads of the same asset skip building them. Empty disables the cache.)")
+      .def_readwrite(
+          "cluster_semantic_meshes",
+          &SimulatorConfiguration::clusterSemanticMeshes,
+          R"(Draw each vertex-annotated semantic mesh with a single drawable, culling clusters of its triangles, instead of partitioning it into a mesh per semantic region.)")
+      .def_readwrite(
+          "pack_texture_arrays", &SimulatorConfiguration::packTextureArrays,
+          R"(Pack the base color, metallic-roughness, normal and emissive textures of materials rendered with the PBR shader into texture arrays sharing size, format and sampler state. Not used together with share_gpu_resources.)")
+      .def_readwrite(
+          "optimize_meshes", &SimulatorConfiguration::optimizeMeshes,
+          R"(Merge duplicate vertices and reorder the triangles and vertices of render asset meshes for the GPU vertex caches when importing them.)")
+      .def_readwrite(
+          "quantize_meshes", &SimulatorConfiguration::quantizeMeshes,
+          R"(Store the positions, normals and texture coordinates of render asset meshes in 16-bit formats, cutting their GPU memory and vertex bandwidth.)")
+      .def_readwrite(
+          "optimized_mesh_cache_directory",
+          &SimulatorConfiguration::optimizedMeshCacheDirectory,
+          R"(Existing directory caching the meshes optimized with optimize_meshes, so later loads of the same asset read them instead of optimizing them again. Empty disables the cache.)")
+      .def_readwrite(
+          "ibl_map_cache_directory",
+          &SimulatorConfiguration::iblMapCacheDirectory,
+          R"(Existing directory caching the irradiance and prefiltered environment maps computed for image based lighting, so later loads of the same environment map, also in other processes, read them instead of computing them. Empty disables the cache.)")
+      .def_readwrite(
+          "collision_bvh_cache_directory",
+          &SimulatorConfiguration::collisionBvhCacheDirectory,
+          R"(Existing directory caching the BVHs of stage collision meshes, so later loads of the same stage, also in other processes, read them instead of building them. Empty disables the cache.)")
+      .def_readwrite(
+          "shared_asset_memory_directory",
+          &SimulatorConfiguration::sharedAssetMemoryDirectory,
+          R"(Directory on a memory-backed file system, e.g. under /dev/shm, through which all processes on a node share a single read-only copy of the collision data of the scenes they load. Created if it doesn't exist, never cleaned up. Empty disables sharing.)")
+      .def_readwrite(
+          "shader_program_cache_directory",
+          &SimulatorConfiguration::shaderProgramCacheDirectory,
+          R"(Existing directory caching the linked PBR shader programs, so later processes on the same GL driver load them instead of compiling them. Empty disables the cache. Applies to all simulators in the process.)")
+      .def_readwrite(
+          "metadata_cache_directory",
+          &SimulatorConfiguration::metadataCacheDirectory,
+          R"(Existing directory holding snapshots of the JSON files and directory listings read while loading scene datasets, so later processes loading the same dataset read a single file instead of walking the dataset. Outdated entries are refreshed automatically. Empty disables the snapshots.)")
       .def_readwrite(
           "navmesh_settings", &SimulatorConfiguration::navMeshSettings,
           R"(Optionally provide a pre-configured NavMeshSettings. If provided, the NavMesh will be recomputed with the provided settings if: A. no NavMesh was loaded, or B. the loaded NavMesh's settings differ from the configured settings. If not provided, no NavMesh recompute will be done automatically.)")
+      .def_readwrite(
+          "map_navmesh_file", &SimulatorConfiguration::mapNavMeshFile,
+          R"(Memory map the scene's .navmesh file instead of copying it, sharing the tile data across all processes loading the same file.)")
       .def_readwrite(
           "enable_hbao", &SimulatorConfiguration::enableHBAO,
           R"(Whether or not to enable horizon-based ambient occlusion, which provides soft shadows in corners and crevices.)")
+      .def_readwrite(
+          "enable_depth_pre_pass", &SimulatorConfiguration::enableDepthPrePass,
+          R"(Draw a depth-only pre-pass before the color pass of color sensors, so the full shaders run only once per pixel in scenes with a lot of overdraw.)")
+      .def_readwrite(
+          "enable_shared_sensor_rendering",
+          &SimulatorConfiguration::enableSharedSensorRendering,
+          R"(Draw co-located camera sensors of an agent that share their projection, resolution and clear color in a single pass, see draw_agent_observations.)")
+      .def_readwrite(
+          "skip_unchanged_frames", &SimulatorConfiguration::skipUnchangedFrames,
+          R"(Return the previous observation of camera sensors without drawing or reading it again when their camera, the light setups and the objects they see didn't change.)")
+      .def_readwrite(
+          "scene_streaming_cell_size",
+          &SimulatorConfiguration::sceneStreamingCellSize,
+          R"(Edge length in meters of the grid cells the scene's object instances are streamed in. If positive, only objects in cells within scene_streaming_radius of an agent are instanced, see update_scene_streaming. 0 instances all objects up front.)")
+      .def_readwrite(
+          "scene_streaming_radius",
+          &SimulatorConfiguration::sceneStreamingRadius,
+          R"(Distance from an agent within which the cells of a streamed scene are loaded.)")
       .def(py::self == py::self)
       .def(py::self != py::self);
 
+  // ==== SimulatorStateSnapshot ====
+  py::class_<SimulatorStateSnapshot, SimulatorStateSnapshot::ptr>(
+      m, "SimulatorStateSnapshot",
+      R"(State of the objects and agents of a simulator, see Simulator.capture_state_snapshot.)")
+      .def_readonly("physics", &SimulatorStateSnapshot::physics,
+                    R"(State of the physical world.)");
+
+  // ==== MemoryReport ====
+  py::class_<MemoryReport, MemoryReport::ptr>(
+      m, "MemoryReport",
+      R"(Estimated memory held by a simulator per subsystem, see Simulator.get_memory_report.)")
+      .def_readonly("meshes", &MemoryReport::meshes,
+                    R"(Render meshes, except for semantic meshes.)")
+      .def_readonly("textures", &MemoryReport::textures)
+      .def_readonly("collision_meshes", &MemoryReport::collisionMeshes,
+                    R"(Mesh data copied for building collision shapes.)")
+      .def_readonly("nav_mesh", &MemoryReport::navMesh)
+      .def_readonly("semantic_scene", &MemoryReport::semanticScene,
+                    R"(Semantic meshes and the semantic scene annotations.)")
+      .def_readonly("replay_keyframes", &MemoryReport::replayKeyframes,
+                    R"(Keyframes held by the gfx-replay recorder.)")
+      .def_readonly(
+          "attributes", &MemoryReport::attributes,
+          R"(Attribute templates of the active dataset, subconfigurations shared between templates counted once.)")
+      .def("total", &MemoryReport::total, R"(Sum of all subsystems.)");
+
   // ==== Simulator ====
   py::class_<Simulator, Simulator::ptr>(m, "Simulator")
       // modify constructor to pass MetadataMediator
@@ -129,7 +379,10 @@ void initSimBindings(py::module& m) {
           "gfx_replay_manager", &Simulator::getGfxReplayManager,
           R"(Use gfx_replay_manager for replay recording and playback.)")
       .def("seed", &Simulator::seed, "new_seed"_a)
-      .def("reconfigure", &Simulator::reconfigure, "configuration"_a)
+      .def(
+          "reconfigure", &Simulator::reconfigure, "configuration"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Reconfigure the simulator, loading the scene and agents of the new configuration. Releases the GIL, so other Python threads can run meanwhile, but don't use the simulator from them until it returns.)")
       .def("reset", &Simulator::reset)
       .def(
           "close", &Simulator::close, "destroy"_a = true,
@@ -152,6 +405,12 @@ void initSimBindings(py::module& m) {
           "semantic_color_map", &Simulator::getSemanticSceneColormap,
           R"(The list of semantic colors being used for semantic rendering. The index
             in the list corresponds to the semantic ID.)")
+      .def(
+          "act_agents", &Simulator::actAgents, "action_indices"_a,
+          R"(Perform one action with each agent added in C++, given as the index into the sorted action names of the agent; negative indices skip the agent. The moves of all agents are filtered against the navmesh in one batched try_steps call. Returns whether each agent acted.)")
+      .def("draw_agent_observations", &Simulator::drawAgentObservations,
+           "agent_id"_a, py::call_guard<py::gil_scoped_release>(),
+           R"(Draw the observations of all visual sensors of an agent. With enable_shared_sensor_rendering, co-located camera sensors are drawn in a single pass and read their observations from its render target, see VisualSensor.observation_render_target. Returns the number of passes drawn. Releases the GIL while drawing.)")
       .def_property("frustum_culling", &Simulator::isFrustumCullingEnabled,
                     &Simulator::setFrustumCullingEnabled,
                     R"(Enable or disable the frustum culling)")
@@ -223,7 +482,17 @@ void initSimBindings(py::module& m) {
       /* --- Kinematics and dynamics --- */
       .def(
           "step_world", &Simulator::stepWorld, "dt"_a = 1.0 / 60.0,
-          R"(Step the physics simulation by a desired timestep (dt). Note that resulting world time after step may not be exactly t+dt. Use get_world_time to query current simulation time.)")
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Step the physics simulation by a desired timestep (dt). Note that resulting world time after step may not be exactly t+dt. Use get_world_time to query current simulation time. Releases the GIL while stepping, so other Python threads can run meanwhile, but don't use the simulator from them until it returns.)")
+      .def_static(
+          "step_worlds",
+          [](const std::vector<Simulator*>& simulators,
+             esp::physics::MultiWorldStepper& stepper, double dt) {
+            py::gil_scoped_release release;
+            return Simulator::stepWorlds(simulators, stepper, dt);
+          },
+          "simulators"_a, "stepper"_a, "dt"_a = 1.0 / 60.0,
+          R"(Step the physics simulations of several distinct simulators by a desired timestep (dt) concurrently on the threads of a MultiWorldStepper, returning once all of them are done. Returns the resulting world time of each simulator.)")
       .def("get_world_time", &Simulator::getWorldTime,
            R"(Query the current simulation world time.)")
       .def("get_physics_time_step", &Simulator::getPhysicsTimeStep,
@@ -253,9 +522,16 @@ void initSimBindings(py::module& m) {
           "get_physics_step_collision_summary",
           &Simulator::getPhysicsStepCollisionSummary,
           R"(Get a summary of collision-processing from the last physics step.)")
+      .def(
+          "get_physics_step_profile", &Simulator::getPhysicsStepProfile,
+          R"(Get the substep counts and per-phase timings of the last physics step.)")
       .def("get_physics_contact_points", &Simulator::getPhysicsContactPoints,
            R"(Return a list of ContactPointData "
           "objects describing the contacts from the most recent physics substep.)")
+      .def(
+          "get_physics_object_contact_points",
+          &Simulator::getPhysicsObjectContactPoints, "object_id"_a,
+          R"(Return a list of ContactPointData objects describing the contacts of a single object from the most recent physics substep. Only the first query after a step scans all contacts, so querying a few objects each step is cheaper than filtering get_physics_contact_points.)")
       .def(
           "perform_discrete_collision_detection",
           &Simulator::performDiscreteCollisionDetection,
@@ -263,13 +539,37 @@ void initSimBindings(py::module& m) {
       .def(
           "cast_ray", &Simulator::castRay, "ray"_a, "max_distance"_a = 100.0,
           R"(Cast a ray into the collidable scene and return hit results. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays", &castRays, "origins"_a, "directions"_a,
+          "max_distance"_a = 100.0, "num_threads"_a = 0,
+          R"(Cast a batch of rays given as Nx3 origin and direction arrays and return a tuple of object_ids, distances, points and normals arrays describing the closest hit of each ray. Rays that hit nothing get an object id of -1 and a negative distance. Physics must be enabled. max_distance in units of ray length, num_threads <= 0 uses all hardware threads.)")
+      .def(
+          "contact_test_object_poses", &contactTestRigidObjectPoses,
+          "object_id"_a, "translations"_a, "rotations"_a,
+          R"(Check for each pose given by Nx3 translation and Nx4 xyzw rotation arrays whether the rigid object would be in contact with any other objects or the scene there, returning a bool array. The object is back at its current pose afterwards. Physics must be enabled.)")
+      .def(
+          "contact_test_articulated_object_joint_positions",
+          &contactTestArticulatedObjectJointPositions, "object_id"_a,
+          "joint_positions"_a,
+          R"(Check for each row of an NxC array of joint positions whether the articulated object would be in contact with any other objects or the scene in that configuration, returning a bool array. The object is back in its current configuration afterwards. Physics must be enabled.)")
+      .def(
+          "sample_random_agent_states", &sampleRandomAgentStates,
+          "num_states"_a, "min_island_area"_a = 0.0f,
+          "min_obstacle_distance"_a = 0.0f, "island_index"_a = ID_UNDEFINED,
+          "max_tries"_a = 10, "num_threads"_a = 0,
+          R"(Sample random agent states on the navmesh in parallel, rejecting positions on islands smaller than min_island_area or closer than min_obstacle_distance to an obstacle, and resampling rejected ones for up to max_tries rounds. Returns a tuple of Nx3 positions and Nx4 xyzw rotations, with fewer than num_states rows if too many samples were rejected.)")
       .def("set_object_bb_draw", &Simulator::setObjectBBDraw, "draw_bb"_a,
            "object_id"_a,
            R"(Enable or disable bounding box visualization for an object.)")
       .def(
           "recompute_navmesh", &Simulator::recomputeNavMesh, "pathfinder"_a,
-          "navmesh_settings"_a,
-          R"(Recompute the NavMesh for a given PathFinder instance using configured NavMeshSettings.)")
+          "navmesh_settings"_a, py::call_guard<py::gil_scoped_release>(),
+          R"(Recompute the NavMesh for a given PathFinder instance using configured NavMeshSettings. Releases the GIL while building.)")
+      .def(
+          "recompute_navmesh_regions", &Simulator::recomputeNavMeshRegions,
+          "pathfinder"_a, "navmesh_settings"_a, "dirty_regions"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Update a tiled NavMesh after local scene changes by rebuilding only the tiles overlapping the changed world space regions. Falls back to a full recompute if the NavMesh isn't tiled or the settings differ.)")
 
       .def(
           "add_trajectory_object",
@@ -309,6 +609,18 @@ void initSimBindings(py::module& m) {
               spline interpolating spline. num_interpolations : (Integer) the
               number of interpolation points to find between successive key
               points.)")
+      .def("add_trajectory_objects", &Simulator::addTrajectoryObjects,
+           "traj_vis_name"_a, "trajectories"_a, "colors"_a,
+           "num_segments"_a = 3, "radius"_a = .001, "smooth"_a = false,
+           "num_interpolations"_a = 10, "num_threads"_a = 0,
+           R"(Build a single visualization object holding tubes around each of the passed trajectories of points, drawn with one draw call.
+              trajectories : (list of lists of 3-tuples of floats) key point locations of each trajectory.
+              colors : (list of lists of 3-tuples of floats) the gradient colors of each trajectory tube, or a single list used for all tubes.
+              num_segments : (Integer) the number of segments around the tubes.
+              radius : (Float) the radius of the resultant tubes.
+              smooth : (Bool) whether or not to smooth trajectories using a Catmull-Rom spline interpolating spline.
+              num_interpolations : (Integer) the number of interpolation points to find between successive key points.
+              num_threads : (Integer) the number of threads building the tubes, <= 0 uses all hardware threads.)")
       .def(
           "save_current_scene_config",
           static_cast<bool (Simulator::*)(const std::string&) const>(
@@ -327,6 +639,31 @@ void initSimBindings(py::module& m) {
           This can be used to reload the stage, objects, articulated
           objects and other values as they currently are.)",
           "overwrite"_a = false)
+      .def(
+          "capture_state_snapshot", &Simulator::captureStateSnapshot,
+          R"(Capture the transformations, motion types, velocities and joint states of all objects along with the agent states, to return to them with restore_state_snapshot.)")
+      .def(
+          "restore_state_snapshot", &Simulator::restoreStateSnapshot,
+          "snapshot"_a,
+          R"(Put the objects and agents back into the state of a snapshot in place, without loading the scene again. Objects added since the capture are removed. Returns whether all objects and agents of the snapshot were restored.)")
+      .def(
+          "save_physics_state",
+          [](Simulator& self) {
+            std::vector<char> state;
+            self.savePhysicsState(state);
+            return py::bytes(state.data(), state.size());
+          },
+          R"(Save the state of all objects and constraints of the physical world as a compact binary blob, to rewind to with restore_physics_state.)")
+      .def(
+          "restore_physics_state",
+          [](Simulator& self, const py::bytes& state) {
+            char* data;
+            py::ssize_t size;
+            PyBytes_AsStringAndSize(state.ptr(), &data, &size);
+            return self.restorePhysicsState({data, std::size_t(size)});
+          },
+          "state"_a,
+          R"(Put the physical world back into a state saved by save_physics_state. The world has to contain the same objects and constraints as when saving. Returns whether the state was restored.)")
       .def("get_light_setup", &Simulator::getLightSetup,
            "key"_a = DEFAULT_LIGHTING_KEY,
            R"(Get a copy of the LightSetup registered with a specific key.)")
@@ -338,6 +675,12 @@ void initSimBindings(py::module& m) {
           R"(Register a LightSetup with a specific key. If a LightSetup is already registered with
           this key, it will be overridden. All Drawables referencing the key will use the newly
           registered LightSetup.)")
+      .def("prefetch_render_assets", &Simulator::prefetchRenderAssets,
+           "filepaths"_a,
+           R"(Start reading and decoding the given render asset files on a background thread, so a later reconfigure or object instantiation loading them is faster.)")
+      .def(
+          "update_scene_streaming", &Simulator::updateSceneStreaming,
+          R"(Instance the object instances of a streamed scene near the agents, prefetch the assets of objects further away and remove objects the agents moved away from. Does nothing unless scene_streaming_cell_size is positive. Called by step_world.)")
       /* --- P2P/Fixed Constraints API --- */
       .def(
           "create_rigid_constraint", &Simulator::createRigidConstraint,
@@ -351,12 +694,27 @@ void initSimBindings(py::module& m) {
            R"(Get a copy of the settings for an existing rigid constraint.)")
       .def("remove_rigid_constraint", &Simulator::removeRigidConstraint,
            "constraint_id"_a, R"(Remove a rigid constraint by id.)")
+      .def(
+          "get_memory_report", &Simulator::getMemoryReport,
+          R"(Estimate how much CPU and GPU memory the loaded scene takes, per subsystem. The sizes are computed from element counts and don't include allocator, Bullet, Recast or driver internals. Assets in a shared pool are counted in every simulator using them.)")
       .def(
           "get_runtime_perf_stat_names", &Simulator::getRuntimePerfStatNames,
           R"(Runtime perf stats are various scalars helpful for troubleshooting runtime perf. This can be called once at startup. See also get_runtime_perf_stat_values.)")
       .def(
           "get_runtime_perf_stat_values", &Simulator::getRuntimePerfStatValues,
-          R"(Runtime perf stats are various scalars helpful for troubleshooting runtime perf. These values generally change after every sim step. See also get_runtime_perf_stat_names.)")
+          R"(Runtime perf stats are various scalars helpful for troubleshooting runtime perf. These values generally change after every sim step. The timing stats are rolling means in milliseconds and stay zero unless profiling is enabled. See also get_runtime_perf_stat_names.)")
+      .def(
+          "get_scene_load_perf_stat_names",
+          &Simulator::getSceneLoadPerfStatNames,
+          R"(Scene load perf stats break the duration of the last reconfigure down into its phases. This can be called once at startup. See also get_scene_load_perf_stat_values.)")
+      .def(
+          "get_scene_load_perf_stat_values",
+          &Simulator::getSceneLoadPerfStatValues,
+          R"(Durations in milliseconds of the last reconfigure and of its metadata parsing, asset import, GPU upload, collision shape construction, navmesh loading and semantic scene loading phases. The GPU upload is part of the asset import. The values stay zero unless profiling was enabled before the reconfigure. See also get_scene_load_perf_stat_names.)")
+      .def(
+          "set_profiling_enabled", &Simulator::setProfilingEnabled,
+          "enabled"_a, "keep_trace"_a = false, "gpu_timers"_a = false,
+          R"(Time physics stepping, scene node updates, culling, drawing, readback, replay recording and the scene load phases in the process-wide core.Profiler, optionally keeping every sample for Profiler.write_chrome_trace. With gpu_timers, the GPU durations of drawing, HBAO, cube map faces and readback are measured with GL timer queries as well, lagging a frame or two behind.)")
       .def("get_debug_line_render", &Simulator::getDebugLineRender,
            pybind11::return_value_policy::reference,
            R"(Get visualization helper for rendering lines.)");
@@ -380,6 +738,16 @@ void initSimBindings(py::module& m) {
       .def_readwrite("enable_frustum_culling",
                      &ReplayRendererConfiguration::enableFrustumCulling,
                      R"(Controls whether frustum culling is enabled.)")
+      .def_readwrite(
+          "quantize_meshes", &ReplayRendererConfiguration::quantizeMeshes,
+          R"(Store mesh positions, normals and texture coordinates in 16-bit formats, cutting their GPU memory and vertex bandwidth.)")
+      .def_readwrite(
+          "enable_semantic_output",
+          &ReplayRendererConfiguration::enableSemanticOutput,
+          R"(Controls whether semantic IDs are rendered. Batch renderer only.)")
+      .def_readwrite(
+          "max_joint_count", &ReplayRendererConfiguration::maxJointCount,
+          R"(Max count of skinned joints per environment. Batch renderer only, set to 0 to disable skinning.)")
       .def_readwrite(
           "enable_hbao", &ReplayRendererConfiguration::enableHBAO,
           R"(Controls whether horizon-based ambient occlusion is enabled.)")
@@ -393,6 +761,14 @@ void initSimBindings(py::module& m) {
           &ReplayRendererConfiguration::leaveContextWithBackgroundRenderer,
           R"(See See tutorials/async_rendering.py.)");
 
+  // ==== ReplayRendererPickResult ====
+  py::class_<ReplayRendererPickResult>(m, "ReplayRendererPickResult")
+      .def_readonly("object_id", &ReplayRendererPickResult::objectId,
+                    R"(Semantic ID of the instance at the pixel, 0 if none.)")
+      .def_readonly(
+          "depth", &ReplayRendererPickResult::depth,
+          R"(Camera-space depth at the pixel, 0 if nothing was drawn there.)");
+
   // ==== ReplayRenderer ====
   py::class_<AbstractReplayRenderer, AbstractReplayRenderer::ptr>(
       m, "ReplayRenderer")
@@ -403,6 +779,18 @@ void initSimBindings(py::module& m) {
             return std::make_shared<ClassicReplayRenderer>(cfg);
           },
           R"(Create a replay renderer using the classic render pipeline.)")
+      .def(
+          "set_navmesh_visualization",
+          [](AbstractReplayRenderer& self, unsigned envIndex,
+             const esp::nav::PathFinder* pathFinder) {
+            auto* classic = dynamic_cast<ClassicReplayRenderer*>(&self);
+            ESP_CHECK(classic,
+                      "NavMesh visualization is only supported by the classic "
+                      "replay renderer");
+            classic->setNavMeshVisualization(envIndex, pathFinder);
+          },
+          R"(Show the NavMesh of the path finder in an environment, or hide it if None. Call again after the NavMesh changed to upload just the changed tiles. Only supported by the classic replay renderer.)",
+          "env_index"_a, "pathfinder"_a)
       .def_static(
           "create_batch_replay_renderer",
           [](const ReplayRendererConfiguration& cfg)
@@ -410,6 +798,17 @@ void initSimBindings(py::module& m) {
             return std::make_shared<BatchReplayRenderer>(cfg);
           },
           R"(Create a replay renderer using the batch render pipeline.)")
+      .def_static(
+          "create_sharded_batch_replay_renderer",
+          [](const ReplayRendererConfiguration& cfg,
+             const std::vector<unsigned>& cudaDevices)
+              -> AbstractReplayRenderer::ptr {
+            return std::make_shared<ShardedBatchReplayRenderer>(
+                cfg, Corrade::Containers::ArrayView<const Mn::UnsignedInt>{
+                         cudaDevices.data(), cudaDevices.size()});
+          },
+          R"(Create a replay renderer using the batch render pipeline, with the environments split across the given CUDA devices.)",
+          "cfg"_a, "cuda_devices"_a)
       .def("close", &AbstractReplayRenderer::close,
            "Releases the graphics context and resources used by the replay "
            "renderer.")
@@ -422,6 +821,9 @@ void initSimBindings(py::module& m) {
       .def_property_readonly("environment_count",
                              &AbstractReplayRenderer::environmentCount,
                              "Get the batch size.")
+      .def_property_readonly(
+          "sensor_count", &AbstractReplayRenderer::sensorCount,
+          "Get the number of sensors rendered for each environment.")
       .def("sensor_size", &AbstractReplayRenderer::sensorSize,
            "Get the resolution of a sensor.")
       .def("clear_environment", &AbstractReplayRenderer::clearEnvironment,
@@ -438,7 +840,8 @@ void initSimBindings(py::module& m) {
              std::vector<Mn::MutableImageView2D> depthImageViews) {
             self.render(colorImageViews, depthImageViews);
           },
-          R"(Render sensors into the specified image vectors (one per environment).
+          R"(Render sensors into the specified image vectors (one per environment
+          and sensor, with all sensors of an environment next to each other).
           Blocks the thread during the GPU-to-CPU memory transfer operation.
           Empty lists can be supplied to skip the copying render targets.
           The images are required to be pre-allocated.)",
@@ -450,9 +853,25 @@ void initSimBindings(py::module& m) {
           R"(Set the sensor transforms from a keyframe. Sensors are stored as user data and identified using a prefix in their name.)")
       .def("set_sensor_transform", &AbstractReplayRenderer::setSensorTransform,
            R"(Set the transform of a specific sensor.)")
+      .def(
+          "set_sensor_transforms",
+          [](AbstractReplayRenderer& self,
+             const std::vector<Mn::Matrix4>& transforms) {
+            self.setSensorTransforms(transforms);
+          },
+          R"(Set the transforms of all sensors of all environments in a single call, one per environment and sensor with all sensors of an environment next to each other.)",
+          "transforms"_a)
       .def("set_environment_keyframe",
            &AbstractReplayRenderer::setEnvironmentKeyframe,
            R"(Set the keyframe for a specific environment.)")
+      .def("set_environment_keyframes",
+           &AbstractReplayRenderer::setEnvironmentKeyframes, "keyframes"_a,
+           "num_threads"_a = 0, py::call_guard<py::gil_scoped_release>(),
+           R"(Set the keyframes of all environments, parsing them in parallel. Pass num_threads <= 0 to use all hardware threads.)")
+      .def("set_environment_keyframes_from_ring_buffer",
+           &AbstractReplayRenderer::setEnvironmentKeyframesFromRingBuffer,
+           "env_index"_a, "ring_buffer"_a,
+           R"(Apply all keyframes available in a KeyframeRingBuffer to a specific environment. Returns the number of keyframes applied.)")
       .def_static(
           "environment_grid_size", &AbstractReplayRenderer::environmentGridSize,
           R"(Get the dimensions (tile counts) of the environment grid.)")
@@ -468,10 +887,91 @@ void initSimBindings(py::module& m) {
             return py::capsule(self.getCudaColorBufferDevicePointer());
           },
           R"(Retrieve the depth buffer as a CUDA device pointer.)")
+      .def(
+          "cuda_semantic_buffer_device_pointer",
+          [](AbstractReplayRenderer& self) {
+            return py::capsule(self.getCudaSemanticBufferDevicePointer());
+          },
+          R"(Retrieve the semantic ID buffer as a CUDA device pointer.)")
       .def("debug_line_render", &AbstractReplayRenderer::getDebugLineRender,
            R"(Get visualization helper for rendering lines.)")
-      .def("unproject", &AbstractReplayRenderer::unproject,
-           R"(Unproject a screen-space point to a world-space ray.)");
+      .def("unproject",
+           static_cast<esp::geo::Ray (AbstractReplayRenderer::*)(
+               unsigned, const Mn::Vector2i&)>(
+               &AbstractReplayRenderer::unproject),
+           R"(Unproject a screen-space point to a world-space ray.)")
+      .def("unproject",
+           static_cast<std::vector<esp::geo::Ray> (AbstractReplayRenderer::*)(
+               const std::vector<unsigned>&, const std::vector<Mn::Vector2i>&)>(
+               &AbstractReplayRenderer::unproject),
+           R"(Unproject screen-space points of many environments to world-space rays at once.)",
+           "env_indices"_a, "viewport_positions"_a)
+      .def("pick", &AbstractReplayRenderer::pick,
+           R"(Pick the semantic IDs and depths at screen-space points of many environments from the last render, with a single GPU readback.
+          Requires the batch renderer with enable_semantic_output.)",
+           "env_indices"_a, "viewport_positions"_a);
+
+  // ==== ShardedBatchReplayRenderer ====
+  py::class_<ShardedBatchReplayRenderer, AbstractReplayRenderer,
+             ShardedBatchReplayRenderer::ptr>(m, "ShardedBatchReplayRenderer")
+      .def_property_readonly("shard_count",
+                             &ShardedBatchReplayRenderer::shardCount,
+                             R"(Number of shards.)")
+      .def("shard_cuda_device", &ShardedBatchReplayRenderer::shardCudaDevice,
+           R"(CUDA device of a shard.)", "shard"_a)
+      .def("shard_environment_offset",
+           &ShardedBatchReplayRenderer::shardEnvironmentOffset,
+           R"(Index of the first environment drawn by a shard.)", "shard"_a)
+      .def("shard_environment_count",
+           &ShardedBatchReplayRenderer::shardEnvironmentCount,
+           R"(Number of environments drawn by a shard.)", "shard"_a)
+      .def(
+          "cuda_color_buffer_device_pointer",
+          [](ShardedBatchReplayRenderer& self, unsigned shard) {
+            return py::capsule(self.getCudaColorBufferDevicePointer(shard));
+          },
+          R"(Retrieve the color buffer of a shard as a CUDA device pointer on the device of the shard.)",
+          "shard"_a)
+      .def(
+          "cuda_depth_buffer_device_pointer",
+          [](ShardedBatchReplayRenderer& self, unsigned shard) {
+            return py::capsule(self.getCudaDepthBufferDevicePointer(shard));
+          },
+          R"(Retrieve the depth buffer of a shard as a CUDA device pointer on the device of the shard.)",
+          "shard"_a)
+      .def(
+          "cuda_semantic_buffer_device_pointer",
+          [](ShardedBatchReplayRenderer& self, unsigned shard) {
+            return py::capsule(self.getCudaSemanticBufferDevicePointer(shard));
+          },
+          R"(Retrieve the semantic ID buffer of a shard as a CUDA device pointer on the device of the shard.)",
+          "shard"_a);
+
+  // ==== VectorSimulator ====
+  py::class_<VectorSimulator, VectorSimulator::ptr>(m, "VectorSimulator")
+      .def(py::init(&VectorSimulator::create<
+                    const std::vector<SimulatorConfiguration>&, int>),
+           "cfgs"_a, "num_threads"_a = 0,
+           R"(Create one environment per configuration. All of them share the metadata mediator and the GPU resources of their render assets, and have to use the same scene dataset and physics configuration. Pass num_threads <= 0 to step physics on all hardware threads.)")
+      .def(py::init(&VectorSimulator::create<const SimulatorConfiguration&,
+                                             std::size_t, int>),
+           "cfg"_a, "num_environments"_a, "num_threads"_a = 0,
+           R"(Create num_environments environments from the same configuration, environment i seeded with cfg.random_seed + i.)")
+      .def_property_readonly("num_environments",
+                             &VectorSimulator::numEnvironments,
+                             R"(Number of environments.)")
+      .def_property_readonly("num_threads", &VectorSimulator::numThreads,
+                             R"(Number of threads stepping the physics worlds.)")
+      .def("environment", &VectorSimulator::environment, "env_index"_a,
+           py::return_value_policy::reference_internal,
+           R"(The simulator of an environment.)")
+      .def("reset", &VectorSimulator::reset, R"(Reset all environments.)")
+      .def(
+          "step", &VectorSimulator::step, "actions"_a, "agent_id"_a = 0,
+          "dt"_a = 1.0 / 60.0, py::call_guard<py::gil_scoped_release>(),
+          R"(Perform one action per environment with the agent agent_id of each (empty names are skipped), then step all physics worlds by dt concurrently. Returns the resulting world time of each environment.)")
+      .def("close", &VectorSimulator::close,
+           R"(Close and destroy all environments.)");
 }
 
 }  // namespace sim
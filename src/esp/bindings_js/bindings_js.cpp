@@ -7,6 +7,11 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include <atomic>
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <thread>
+#endif
+
 namespace em = emscripten;
 
 #include "esp/gfx/replay/Recorder.h"
@@ -139,6 +144,72 @@ bool isBuildWithBulletPhysics() {
 #endif
 }
 
+bool isBuildWithThreads() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Recompute the navmesh of a simulator without blocking the main thread
+ *
+ * The scene geometry is gathered on construction. In builds with pthreads the
+ * navmesh is then built into a new PathFinder on a worker thread, so the page
+ * keeps rendering; poll @ref isReady() once per frame and call @ref finish()
+ * when it's true. Without pthreads the constructor builds it right away.
+ */
+class NavMeshRecomputeJob {
+ public:
+  NavMeshRecomputeJob(Simulator& sim, const NavMeshSettings& settings)
+      : mesh_{sim.getJoinedMesh(settings.includeStaticObjects)},
+        pathfinder_{PathFinder::create()} {
+    const auto build = [this, settings]() {
+      succeeded_ = pathfinder_->build(settings, *mesh_);
+      ready_ = true;
+    };
+#ifdef __EMSCRIPTEN_PTHREADS__
+    thread_ = std::thread{build};
+#else
+    build();
+#endif
+  }
+
+  ~NavMeshRecomputeJob() { join(); }
+
+  bool isReady() const { return ready_; }
+
+  /**
+   * @brief Wait for the build and make the new navmesh the simulator's
+   * pathfinder if it succeeded
+   */
+  bool finish(Simulator& sim) {
+    join();
+    if (succeeded_) {
+      sim.setPathFinder(pathfinder_);
+    }
+    return succeeded_;
+  }
+
+ private:
+  void join() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+#endif
+  }
+
+  assets::MeshData::ptr mesh_;
+  PathFinder::ptr pathfinder_;
+  bool succeeded_ = false;
+  std::atomic<bool> ready_{false};
+#ifdef __EMSCRIPTEN_PTHREADS__
+  std::thread thread_;
+#endif
+};
+
 EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
   em::class_<LoggingContext>("LoggingContext");
   em::constant("_loggingContext", std::make_shared<LoggingContext>());
@@ -148,6 +219,7 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
   em::function("toVec4f", &toVec4f);
   em::function("loadAllObjectConfigsFromPath", &loadAllObjectConfigsFromPath);
   em::function("isBuildWithBulletPhysics", &isBuildWithBulletPhysics);
+  em::function("isBuildWithThreads", &isBuildWithThreads);
 
   em::register_vector<SensorSpec::ptr>("VectorSensorSpec");
   em::register_vector<size_t>("VectorSizeT");
@@ -286,6 +358,23 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .property("bounds", &PathFinder::bounds)
       .function("isNavigable", &PathFinder::isNavigable);
 
+  em::class_<NavMeshSettings>("NavMeshSettings")
+      .constructor<>()
+      .function("setDefaults", &NavMeshSettings::setDefaults)
+      .property("cellSize", &NavMeshSettings::cellSize)
+      .property("cellHeight", &NavMeshSettings::cellHeight)
+      .property("agentHeight", &NavMeshSettings::agentHeight)
+      .property("agentRadius", &NavMeshSettings::agentRadius)
+      .property("agentMaxClimb", &NavMeshSettings::agentMaxClimb)
+      .property("agentMaxSlope", &NavMeshSettings::agentMaxSlope)
+      .property("includeStaticObjects",
+                &NavMeshSettings::includeStaticObjects);
+
+  em::class_<NavMeshRecomputeJob>("NavMeshRecomputeJob")
+      .constructor<Simulator&, const NavMeshSettings&>()
+      .function("isReady", &NavMeshRecomputeJob::isReady)
+      .function("finish", &NavMeshRecomputeJob::finish);
+
   em::enum_<SensorType>("SensorType")
       .value("NONE", SensorType::None)
       .value("COLOR", SensorType::Color)
@@ -604,6 +693,8 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .function("getLightSetup", &Simulator::getLightSetup)
       .function("setLightSetup", &Simulator::setLightSetup)
       .function("stepWorld", &Simulator::stepWorld)
+      .function("recomputeNavMesh", &Simulator::recomputeNavMesh)
+      .function("prefetchRenderAssets", &Simulator::prefetchRenderAssets)
       .function("castRay", &Simulator::castRay)
       .function("getGfxReplayManager", &Simulator::getGfxReplayManager);
 }
@@ -89,6 +89,29 @@ class SimEnv {
     return this.sim.getPathFinder();
   }
 
+  /**
+   * Recompute the navmesh of the scene. In builds with threads the navmesh is
+   * built on a worker thread while the page keeps rendering.
+   * @param {NavMeshSettings} settings - navmesh settings
+   * @returns {Promise<boolean>} resolves with whether the build succeeded,
+   *   after the new navmesh replaced the pathfinder of the scene
+   */
+  recomputeNavMesh(settings) {
+    const job = new Module.NavMeshRecomputeJob(this.sim, settings);
+    return new Promise(resolve => {
+      const poll = () => {
+        if (!job.isReady()) {
+          window.requestAnimationFrame(poll);
+          return;
+        }
+        const succeeded = job.finish(this.sim);
+        job.delete();
+        resolve(succeeded);
+      };
+      poll();
+    });
+  }
+
   /**
    * Display an observation from the given sensorId
    * to canvas selected as default frame buffer.
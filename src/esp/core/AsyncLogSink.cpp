@@ -0,0 +1,291 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AsyncLogSink.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Utility/FormatStl.h>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace logging {
+
+namespace {
+
+typedef std::chrono::steady_clock SinkClock;
+
+// the queue is written right away once it gets this long, without waiting
+// for the flush interval
+constexpr std::size_t EagerFlushMessageCount = 256;
+
+// Duplicate detection ignores the timestamp the message prefix starts with,
+// see buildMessagePrefix()
+std::string messageKey(const std::string& message) {
+  if (!message.empty() && message[0] == '[') {
+    const std::size_t end = message.find(']');
+    if (end != std::string::npos) {
+      return message.substr(end + 1);
+    }
+  }
+  return message;
+}
+
+}  // namespace
+
+struct AsyncLogSink::State {
+  struct Entry {
+    std::ostream* output;
+    std::string text;
+  };
+
+  struct SubsystemState {
+    // token bucket, rate of 0 means unlimited
+    float messagesPerSecond = 0.0f;
+    float tokens = 0.0f;
+    SinkClock::time_point lastRefill;
+    std::size_t pendingDropped = 0;
+    std::ostream* droppedOutput = nullptr;
+
+    // last message, for duplicate suppression
+    std::string lastKey;
+    std::ostream* lastOutput = nullptr;
+    std::size_t pendingRepeats = 0;
+  };
+
+  std::chrono::milliseconds flushInterval;
+  std::size_t maxQueuedMessages;
+  std::thread flusher;
+
+  // protects everything below
+  mutable std::mutex mutex;
+  std::condition_variable wakeup;
+  std::condition_variable drained;
+  std::deque<Entry> queue;
+  SubsystemState subsystems[uint8_t(Subsystem::NumSubsystems)];
+  bool suppressDuplicates = true;
+  bool stop = false;
+  bool flushRequested = false;
+  bool urgent = false;
+  std::size_t enqueued = 0;
+  std::size_t written = 0;
+  std::size_t queueDropped = 0;
+  std::ostream* queueDroppedOutput = nullptr;
+  std::size_t totalDropped = 0;
+  std::size_t totalSuppressed = 0;
+
+  // expects mutex held
+  void enqueue(std::ostream* output, std::string text) {
+    queue.push_back({output, std::move(text)});
+    ++enqueued;
+  }
+
+  // expects mutex held
+  void reportRepeats(Subsystem subsystem) {
+    SubsystemState& state = subsystems[uint8_t(subsystem)];
+    if (state.pendingRepeats != 0) {
+      enqueue(state.lastOutput,
+              Cr::Utility::formatString(
+                  "[{}] previous message repeated {} more times\n",
+                  subsystemNames[uint8_t(subsystem)], state.pendingRepeats));
+      state.pendingRepeats = 0;
+    }
+  }
+
+  // expects mutex held
+  void reportDropped(Subsystem subsystem) {
+    SubsystemState& state = subsystems[uint8_t(subsystem)];
+    if (state.pendingDropped != 0) {
+      enqueue(state.droppedOutput,
+              Cr::Utility::formatString(
+                  "[{}] {} messages dropped by the logging rate limit\n",
+                  subsystemNames[uint8_t(subsystem)], state.pendingDropped));
+      state.pendingDropped = 0;
+    }
+  }
+
+  // expects mutex held
+  void reportAllPending() {
+    for (uint8_t i = 0; i < uint8_t(Subsystem::NumSubsystems); ++i) {
+      reportRepeats(Subsystem(i));
+      reportDropped(Subsystem(i));
+    }
+    if (queueDropped != 0) {
+      enqueue(queueDroppedOutput,
+              Cr::Utility::formatString(
+                  "{} messages dropped by a full logging queue\n",
+                  queueDropped));
+      queueDropped = 0;
+    }
+  }
+
+  // expects mutex held, refills the bucket and takes a token if available
+  bool takeToken(SubsystemState& state) {
+    if (state.messagesPerSecond <= 0.0f) {
+      return true;
+    }
+    const SinkClock::time_point now = SinkClock::now();
+    const float elapsed =
+        std::chrono::duration<float>(now - state.lastRefill).count();
+    state.lastRefill = now;
+    state.tokens = std::min(std::max(state.messagesPerSecond, 1.0f),
+                            state.tokens + elapsed * state.messagesPerSecond);
+    if (state.tokens < 1.0f) {
+      return false;
+    }
+    state.tokens -= 1.0f;
+    return true;
+  }
+
+  void flusherLoop() {
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;) {
+      wakeup.wait_for(lock, flushInterval, [&] {
+        return stop || flushRequested || urgent ||
+               queue.size() >= EagerFlushMessageCount;
+      });
+      // counts are reported on every pass, so long repeat storms still show
+      // up periodically
+      reportAllPending();
+      const bool stopping = stop;
+      flushRequested = false;
+      urgent = false;
+
+      std::deque<Entry> batch;
+      batch.swap(queue);
+      lock.unlock();
+      std::vector<std::ostream*> outputs;
+      for (const Entry& entry : batch) {
+        if (entry.output == nullptr) {
+          continue;
+        }
+        entry.output->write(entry.text.data(), entry.text.size());
+        if (std::find(outputs.begin(), outputs.end(), entry.output) ==
+            outputs.end()) {
+          outputs.push_back(entry.output);
+        }
+      }
+      for (std::ostream* output : outputs) {
+        output->flush();
+      }
+      lock.lock();
+
+      written += batch.size();
+      drained.notify_all();
+      if (stopping && queue.empty()) {
+        return;
+      }
+    }
+  }
+};
+
+AsyncLogSink::AsyncLogSink(const std::chrono::milliseconds flushInterval,
+                           const std::size_t maxQueuedMessages)
+    : state_{Cr::InPlaceInit} {
+  state_->flushInterval = flushInterval;
+  state_->maxQueuedMessages = maxQueuedMessages;
+  state_->flusher = std::thread{[this] { state_->flusherLoop(); }};
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->stop = true;
+  }
+  state_->wakeup.notify_one();
+  state_->flusher.join();
+}
+
+void AsyncLogSink::setRateLimit(const Subsystem subsystem,
+                                const float messagesPerSecond) {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  State::SubsystemState& state = state_->subsystems[uint8_t(subsystem)];
+  state.messagesPerSecond = messagesPerSecond;
+  // start with a full bucket
+  state.tokens = std::max(messagesPerSecond, 1.0f);
+  state.lastRefill = SinkClock::now();
+}
+
+void AsyncLogSink::setRateLimit(const float messagesPerSecond) {
+  for (uint8_t i = 0; i < uint8_t(Subsystem::NumSubsystems); ++i) {
+    setRateLimit(Subsystem(i), messagesPerSecond);
+  }
+}
+
+void AsyncLogSink::setDuplicateSuppression(const bool enabled) {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  state_->suppressDuplicates = enabled;
+}
+
+void AsyncLogSink::submit(const Subsystem subsystem,
+                          const LoggingLevel level,
+                          std::ostream* const output,
+                          std::string message) {
+  const bool isError = level >= LoggingLevel::Error;
+  std::string key = messageKey(message);
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    State::SubsystemState& state = state_->subsystems[uint8_t(subsystem)];
+
+    if (state_->suppressDuplicates && state.lastOutput == output &&
+        state.lastKey == key) {
+      ++state.pendingRepeats;
+      ++state_->totalSuppressed;
+      return;
+    }
+
+    if (!isError && (!state_->takeToken(state) ||
+                     state_->queue.size() >= state_->maxQueuedMessages)) {
+      if (state_->queue.size() >= state_->maxQueuedMessages) {
+        ++state_->queueDropped;
+        state_->queueDroppedOutput = output;
+      } else {
+        ++state.pendingDropped;
+        state.droppedOutput = output;
+      }
+      ++state_->totalDropped;
+      return;
+    }
+
+    state_->reportRepeats(subsystem);
+    state_->reportDropped(subsystem);
+    state.lastKey = std::move(key);
+    state.lastOutput = output;
+    state_->enqueue(output, std::move(message));
+    state_->urgent = state_->urgent || isError;
+  }
+  if (isError) {
+    state_->wakeup.notify_one();
+  }
+}
+
+void AsyncLogSink::flush() {
+  std::unique_lock<std::mutex> lock{state_->mutex};
+  state_->flushRequested = true;
+  state_->wakeup.notify_one();
+  state_->drained.wait(lock, [&] {
+    return !state_->flushRequested && state_->written == state_->enqueued;
+  });
+}
+
+std::size_t AsyncLogSink::droppedMessageCount() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->totalDropped;
+}
+
+std::size_t AsyncLogSink::suppressedMessageCount() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->totalSuppressed;
+}
+
+}  // namespace logging
+}  // namespace esp
@@ -0,0 +1,124 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_ASYNCLOGSINK_H_
+#define ESP_CORE_ASYNCLOGSINK_H_
+
+/** @file
+ * @brief Class @ref esp::logging::AsyncLogSink
+ */
+
+#include <Corrade/Containers/Pointer.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "esp/core/Logging.h"
+
+namespace esp {
+namespace logging {
+
+/**
+ * @brief Sink writing the logging statements of a @ref LoggingContext from a
+ * background thread.
+ *
+ * Installed with @ref LoggingContext::setAsyncSink(). Logging statements are
+ * formatted on the logging thread as usual, but instead of being written to
+ * their stream right away they are queued and written in batches by a flusher
+ * thread, so threads emitting many messages don't serialize on the terminal
+ * or the log pipe. Messages keep the stream they would have been written to,
+ * and error messages wake the flusher right away.
+ *
+ * Before being queued, messages go through two filters, both per subsystem:
+ *
+ * -    A message equal to the previous message of its subsystem, ignoring the
+ *      timestamp in the prefix, is suppressed. The number of suppressed
+ *      repeats is reported once a different message arrives or the sink is
+ *      flushed.
+ * -    An optional rate limit, see @ref setRateLimit(). Messages over the
+ *      limit are dropped and counted, the count is reported with the next
+ *      message the limit lets through or when the sink is flushed. Errors are
+ *      never dropped.
+ *
+ * All functions are thread-safe.
+ */
+class AsyncLogSink {
+ public:
+  /**
+   * @brief Constructor
+   * @param flushInterval     Longest time a message is held before written
+   * @param maxQueuedMessages Messages queued beyond this count are dropped
+   *    until the flusher catches up, errors excepted
+   *
+   * Starts the flusher thread.
+   */
+  explicit AsyncLogSink(
+      std::chrono::milliseconds flushInterval = std::chrono::milliseconds{100},
+      std::size_t maxQueuedMessages = 4096);
+
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink(AsyncLogSink&&) = delete;
+
+  /** @brief Destructor. Writes all queued messages and joins the flusher. */
+  ~AsyncLogSink();
+
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(AsyncLogSink&&) = delete;
+
+  /**
+   * @brief Limit the messages of @p subsystem to @p messagesPerSecond
+   *
+   * The limit is a token bucket holding up to one second worth of messages,
+   * so short bursts pass. A limit of @cpp 0.0f @ce, the default, disables
+   * limiting.
+   */
+  void setRateLimit(Subsystem subsystem, float messagesPerSecond);
+
+  /** @brief Limit the messages of every subsystem, see above */
+  void setRateLimit(float messagesPerSecond);
+
+  /**
+   * @brief Enable or disable suppression of repeated messages. Enabled by
+   * default.
+   */
+  void setDuplicateSuppression(bool enabled);
+
+  /**
+   * @brief Queue a formatted message
+   * @param subsystem Subsystem the message was logged from
+   * @param level     Level the message was logged with
+   * @param output    Stream the message is written to
+   * @param message   The message, including its prefix and trailing newline
+   *
+   * Called by the logging macros, there's usually no need to call it
+   * directly.
+   */
+  void submit(Subsystem subsystem,
+              LoggingLevel level,
+              std::ostream* output,
+              std::string message);
+
+  /**
+   * @brief Write all queued messages and pending repeat and drop counts,
+   * blocking until done
+   */
+  void flush();
+
+  /** @brief Messages dropped by the rate limit or a full queue so far */
+  std::size_t droppedMessageCount() const;
+
+  /** @brief Repeated messages suppressed so far */
+  std::size_t suppressedMessageCount() const;
+
+ private:
+  struct State;
+  Corrade::Containers::Pointer<State> state_;
+};
+
+}  // namespace logging
+}  // namespace esp
+
+#endif  // ESP_CORE_ASYNCLOGSINK_H_
@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AtomicFile.h"
+
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include <random>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+bool writeFileAtomically(const std::string& filename,
+                         const Cr::Containers::ArrayView<const void> data) {
+  const std::string temporaryFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, std::random_device{}());
+  if (!Cr::Utility::Path::write(temporaryFilename, data) ||
+      !Cr::Utility::Path::move(temporaryFilename, filename)) {
+    Cr::Utility::Path::remove(temporaryFilename);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace esp
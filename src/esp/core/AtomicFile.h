@@ -0,0 +1,34 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_ATOMICFILE_H_
+#define ESP_CORE_ATOMICFILE_H_
+
+/** @file
+ * @brief Function @ref esp::core::writeFileAtomically()
+ */
+
+#include <Corrade/Containers/ArrayView.h>
+
+#include <string>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Write @p data to @p filename so readers never see a partial file
+ *
+ * The data is written to a temporary file with a random suffix next to
+ * @p filename and then moved in place, so processes writing the same cache
+ * file at the same time don't overwrite each other's partial output. On
+ * failure the temporary file is removed and @p filename is left untouched.
+ * @return Whether the file was written.
+ */
+bool writeFileAtomically(const std::string& filename,
+                         Corrade::Containers::ArrayView<const void> data);
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_ATOMICFILE_H_
@@ -4,11 +4,99 @@
 
 #include "Buffer.h"
 
+#include <Corrade/Utility/Assert.h>
 #include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
 
 namespace esp {
 namespace core {
 
+namespace {
+
+struct BufferPool {
+  std::mutex mutex;
+  // unused memory by byte size, [0] pageable and [1] page-locked
+  std::unordered_multimap<size_t, uint8_t*> unused[2];
+  size_t pooledBytes = 0;
+  size_t maxPooledBytes = size_t{256} * 1024 * 1024;
+  bool pinned = false;
+};
+
+BufferPool& bufferPool() {
+  // never destroyed, so that buffers in static storage can still return their
+  // memory at exit
+  static BufferPool* pool = new BufferPool;
+  return *pool;
+}
+
+void freeMemory(uint8_t* data, bool pinned) {
+#ifdef ESP_BUILD_WITH_CUDA
+  if (pinned) {
+    cudaFreeHost(data);
+    return;
+  }
+#else
+  CORRADE_INTERNAL_ASSERT(!pinned);
+#endif
+  delete[] data;
+}
+
+uint8_t* allocateMemory(size_t size, bool& pinned) {
+  BufferPool& pool = bufferPool();
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    pinned = pool.pinned;
+    auto found = pool.unused[pinned].find(size);
+    if (found != pool.unused[pinned].end()) {
+      uint8_t* data = found->second;
+      pool.unused[pinned].erase(found);
+      pool.pooledBytes -= size;
+      std::memset(data, 0, size);
+      return data;
+    }
+  }
+#ifdef ESP_BUILD_WITH_CUDA
+  if (pinned) {
+    void* data = nullptr;
+    if (cudaHostAlloc(&data, size, cudaHostAllocDefault) == cudaSuccess) {
+      std::memset(data, 0, size);
+      return static_cast<uint8_t*>(data);
+    }
+    // fall back to pageable memory, e.g. if no device is available
+    pinned = false;
+  }
+#endif
+  return new uint8_t[size]();
+}
+
+void releaseMemory(uint8_t* data, size_t size, bool pinned) {
+  BufferPool& pool = bufferPool();
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    if (pool.pooledBytes + size <= pool.maxPooledBytes) {
+      pool.unused[pinned].emplace(size, data);
+      pool.pooledBytes += size;
+      return;
+    }
+  }
+  freeMemory(data, pinned);
+}
+
+void releasePageableMemory(uint8_t* data, size_t size) {
+  releaseMemory(data, size, false);
+}
+
+void releasePinnedMemory(uint8_t* data, size_t size) {
+  releaseMemory(data, size, true);
+}
+
+}  // namespace
+
 size_t getDataTypeByteSize(DataType dt) {
   switch (dt) {
     case DataType::DT_INT8:
@@ -16,6 +104,7 @@ size_t getDataTypeByteSize(DataType dt) {
       return 1;
     case DataType::DT_INT16:
     case DataType::DT_UINT16:
+    case DataType::DT_FLOAT16:
       return 2;
     case DataType::DT_INT32:
     case DataType::DT_UINT32:
@@ -32,6 +121,23 @@ size_t getDataTypeByteSize(DataType dt) {
   }
 }
 
+Buffer::Buffer(Corrade::Containers::ArrayView<uint8_t> external,
+               const std::vector<size_t>& shape,
+               const DataType dataType)
+    : dataType(dataType), shape(shape) {
+  size_t size = 1;
+  for (size_t i = 0; i < this->shape.size(); ++i) {
+    size *= this->shape[i];
+  }
+  CORRADE_ASSERT(external.size() >= size * getDataTypeByteSize(dataType),
+                 "Buffer::Buffer(): external memory too small for the shape", );
+  this->totalSize = size;
+  // the no-op deleter leaves the memory to its owner
+  this->data = Corrade::Containers::Array<uint8_t>{
+      external.data(), size * getDataTypeByteSize(dataType),
+      [](uint8_t*, std::size_t) {}};
+}
+
 void Buffer::clear() {
   if (this->data != nullptr) {
     std::memset(this->data, 0, this->data.size());
@@ -45,8 +151,66 @@ void Buffer::alloc() {
   }
   if (size != this->totalSize) {
     this->totalSize = size;
+    const size_t byteSize = size * getDataTypeByteSize(dataType);
+    if (byteSize == 0) {
+      this->data = Corrade::Containers::Array<uint8_t>{};
+      return;
+    }
+    bool pinned = false;
+    uint8_t* memory = allocateMemory(byteSize, pinned);
     this->data = Corrade::Containers::Array<uint8_t>{
-        size * getDataTypeByteSize(dataType)};
+        memory, byteSize,
+        pinned ? releasePinnedMemory : releasePageableMemory};
+  }
+}
+
+void Buffer::setPinnedMemory(bool pinned) {
+#ifdef ESP_BUILD_WITH_CUDA
+  BufferPool& pool = bufferPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  pool.pinned = pinned;
+#else
+  static_cast<void>(pinned);
+#endif
+}
+
+bool Buffer::isPinnedMemory() {
+  BufferPool& pool = bufferPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  return pool.pinned;
+}
+
+void Buffer::setMaxPooledBytes(size_t bytes) {
+  BufferPool& pool = bufferPool();
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    pool.maxPooledBytes = bytes;
+  }
+  if (pooledBytes() > bytes) {
+    releasePooledMemory();
+  }
+}
+
+size_t Buffer::pooledBytes() {
+  BufferPool& pool = bufferPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  return pool.pooledBytes;
+}
+
+void Buffer::releasePooledMemory() {
+  BufferPool& pool = bufferPool();
+  std::unordered_multimap<size_t, uint8_t*> unused[2];
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    for (int pinned = 0; pinned != 2; ++pinned) {
+      unused[pinned].swap(pool.unused[pinned]);
+    }
+    pool.pooledBytes = 0;
+  }
+  for (int pinned = 0; pinned != 2; ++pinned) {
+    for (const auto& entry : unused[pinned]) {
+      freeMemory(entry.second, pinned);
+    }
   }
 }
 
@@ -6,6 +6,8 @@
 #define ESP_CORE_BUFFER_H_
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <vector>
 
 #include "esp/core/Esp.h"
 
@@ -27,10 +29,22 @@ enum class DataType {
   DT_UINT64 = 8,
   DT_FLOAT = 9,
   DT_DOUBLE = 10,
+  DT_FLOAT16 = 11,
 };
 
+/**
+ * @brief Size of one element of @p dt in bytes, 0 for @ref DataType::DT_NONE
+ */
+size_t getDataTypeByteSize(DataType dt);
+
 /**
  * @brief A class act as a data buffer.
+ *
+ * The memory of buffers is recycled through a pool keyed by its byte size:
+ * when a buffer is destroyed or reshaped, its memory is kept and handed to the
+ * next buffer of the same size, so that observations that are re-created every
+ * step don't go through the heap allocator. Memory taken from the pool is
+ * zeroed, same as fresh allocations.
  */
 class Buffer {
  public:
@@ -39,9 +53,48 @@ class Buffer {
       : dataType(dataType), shape(shape) {
     alloc();
   }
+  /**
+   * @brief Wrap memory owned by the caller instead of allocating it
+   *
+   * @p external has to hold @p shape elements of @p dataType and outlive the
+   * buffer, which never frees it.
+   */
+  explicit Buffer(Corrade::Containers::ArrayView<uint8_t> external,
+                  const std::vector<size_t>& shape,
+                  const DataType dataType);
   void clear();
   virtual ~Buffer() { dealloc(); }
 
+  /**
+   * @brief Allocate the memory of buffers created or reshaped from now on as
+   * page-locked host memory
+   *
+   * Copies from page-locked memory to a CUDA device run at full bandwidth,
+   * without staging. Without CUDA support this is a no-op. Off by default.
+   */
+  static void setPinnedMemory(bool pinned);
+
+  /**
+   * @brief Whether buffer memory is allocated as page-locked host memory
+   */
+  static bool isPinnedMemory();
+
+  /**
+   * @brief Set the upper bound on the number of bytes of unused memory the
+   * pool keeps for reuse. 0 disables pooling. Default is 256 MB.
+   */
+  static void setMaxPooledBytes(size_t bytes);
+
+  /**
+   * @brief Number of bytes of unused memory currently kept by the pool
+   */
+  static size_t pooledBytes();
+
+  /**
+   * @brief Free all unused memory kept by the pool
+   */
+  static void releasePooledMemory();
+
  protected:
   void alloc();
   void dealloc();
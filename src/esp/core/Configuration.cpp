@@ -3,6 +3,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Configuration.h"
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Math/ConfigurationValue.h>
@@ -64,6 +67,8 @@ void moveConstructorFunc(
     char* const dst) {  // NOLINT(readability-non-const-parameter)
   T** tmpSrc = reinterpret_cast<T**>(src);
   new (dst) T* {std::move(*tmpSrc)};
+  // the source no longer owns the value
+  *tmpSrc = nullptr;
 }
 template <class T>
 void destructorFunc(
@@ -80,6 +85,37 @@ bool comparisonFunc(const char* const a, const char* const b) {
          **reinterpret_cast<const T* const*>(b);
 }
 
+// free functions for interned strings. ConfigValue._data is a pointer into
+// the interning table, which owns the string, so copies share the pointer.
+void internedCopyFunc(const char* const src, char* const dst) {
+  std::memcpy(dst, src, sizeof(const std::string*));
+}
+void internedMoveFunc(char* const src, char* const dst) {
+  std::memcpy(dst, src, sizeof(const std::string*));
+}
+void internedDestructorFunc(char* const src) {
+  *reinterpret_cast<const std::string**>(src) = nullptr;
+}
+bool internedComparisonFunc(const char* const a, const char* const b) {
+  return *reinterpret_cast<const std::string* const*>(a) ==
+         *reinterpret_cast<const std::string* const*>(b);
+}
+
+/**
+ * @brief Process-wide table of the interned string values. Node-based, so
+ * pointers to its entries survive rehashing.
+ */
+struct InternedStringTable {
+  std::mutex mutex;
+  std::unordered_set<std::string> strings;
+};
+
+InternedStringTable& internedStringTable() {
+  // deliberately leaked, so values in static objects can outlive it
+  static InternedStringTable* table = new InternedStringTable;
+  return *table;
+}
+
 /**
  * @brief This struct handles pointer-to-data typed (i.e.non-trivial types)
  * ConfigValues by providing a copy constructor, a move constructor and a
@@ -97,6 +133,11 @@ struct PointerBasedTypeHandler {
     return {copyConstructorFunc<T>, moveConstructorFunc<T>, destructorFunc<T>,
             comparisonFunc<T>};
   }
+
+  static constexpr PointerBasedTypeHandler makeInterned() {
+    return {internedCopyFunc, internedMoveFunc, internedDestructorFunc,
+            internedComparisonFunc};
+  }
 };
 
 /**
@@ -120,7 +161,7 @@ constexpr PointerBasedTypeHandler pointerBasedTypeHandlers[]{
     PointerBasedTypeHandler::make<Mn::Matrix3>(),
     PointerBasedTypeHandler::make<Mn::Matrix4>(),
     //_nonTrivialTypes start
-    PointerBasedTypeHandler::make<std::string>(),
+    PointerBasedTypeHandler::makeInterned(),
 };
 
 PointerBasedTypeHandler pointerBasedConfigTypeHandlerFor(ConfigValType type) {
@@ -132,6 +173,18 @@ PointerBasedTypeHandler pointerBasedConfigTypeHandlerFor(ConfigValType type) {
 
 }  // namespace
 
+const std::string* internConfigString(const std::string& value) {
+  InternedStringTable& table = internedStringTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return &*table.strings.insert(value).first;
+}
+
+std::size_t getNumInternedConfigStrings() {
+  InternedStringTable& table = internedStringTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return table.strings.size();
+}
+
 std::string getNameForStoredType(const ConfigValType& value) {
   auto valName = ConfigTypeNamesMap.find(value);
   if (valName != ConfigTypeNamesMap.end()) {
@@ -204,16 +257,11 @@ bool operator==(const ConfigValue& a, const ConfigValue& b) {
   if (a._type != b._type) {
     return false;
   }
-  // Pointer-backed data types need to have _data dereffed
+  // Pointer-backed data types need to have _data dereffed. Interned strings
+  // compare by pointer.
   if (isConfigValTypePointerBased(a._type)) {
-    // Pointer-backed data (i.e. nontrival types)
-    if (a._type == ConfigValType::String) {
-      return a.get<std::string>() == b.get<std::string>();
-    } else {
-      // Shouldn't get here
-      CORRADE_ASSERT_UNREACHABLE(
-          "Unknown/unsupported Type in ConfigValue equality check", false);
-    }
+    return pointerBasedConfigTypeHandlerFor(a._type).comparator(a._data,
+                                                                b._data);
   }
 
   // Trivial type : a._data holds the actual value
@@ -703,11 +751,9 @@ std::vector<std::string> Configuration::findValue(
 
 Configuration& Configuration::operator=(const Configuration& otr) {
   if (this != &otr) {
-    configMap_.clear();
+    configMap_ = otr.configMap_;
     valueMap_ = otr.valueMap_;
-    for (const auto& entry : otr.configMap_) {
-      configMap_[entry.first] = std::make_shared<Configuration>(*entry.second);
-    }
+    markSubconfigsShared();
   }
   return *this;
 }
@@ -9,11 +9,18 @@
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Magnum.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "esp/core/Check.h"
 #include "esp/core/Esp.h"
+#include "esp/core/Hash.h"
 #include "esp/io/Json.h"
 
 namespace Cr = Corrade;
@@ -229,6 +236,22 @@ constexpr ConfigValType configValTypeFor<Mn::Rad>() {
   return ConfigValType::MagnumRad;
 }
 
+/**
+ * @brief Return the interned copy of @p value from the process-wide table of
+ * @ref ConfigValType::String values, adding it if not yet present.
+ *
+ * Interned strings are immutable and never freed, so the returned pointer
+ * stays valid for the lifetime of the process and two values are equal exactly
+ * when their interned pointers are. Thread-safe.
+ */
+const std::string* internConfigString(const std::string& value);
+
+/**
+ * @brief Number of distinct strings interned by @ref internConfigString() so
+ * far.
+ */
+std::size_t getNumInternedConfigStrings();
+
 /**
  * @brief Stream operator to support display of @ref ConfigValType enum tags
  */
@@ -238,6 +261,10 @@ MAGNUM_EXPORT Mn::Debug& operator<<(Mn::Debug& debug,
 /**
  * @brief This class uses an anonymous tagged union to store values of different
  * types, as well as providing access to the values in a type safe manner.
+ *
+ * String values are interned with @ref internConfigString(), so copying a
+ * string value only copies a pointer and comparing two of them compares
+ * pointers.
  */
 class ConfigValue {
  private:
@@ -382,6 +409,11 @@ class ConfigValue {
                              Cr::Utility::ConfigurationGroup& cfg) const;
 
  private:
+  // strings point into the interning table instead of owning a copy
+  void setInternal(const std::string& value) {
+    *reinterpret_cast<const std::string**>(_data) = internConfigString(value);
+  }
+
   template <typename T>
   EnableIf<isConfigValTypePointerBased(configValTypeFor<T>()), void>
   setInternal(const T& value) {
@@ -429,17 +461,160 @@ class ConfigValue {
  */
 MAGNUM_EXPORT Mn::Debug& operator<<(Mn::Debug& debug, const ConfigValue& value);
 
+/**
+ * @brief Key of a @ref Configuration value with its hash computed up front.
+ *
+ * Looking a value up by string hashes the string on every call. Code querying
+ * the same key over and over, like the getters of the attributes classes, can
+ * keep a ConfigKey around instead, e.g. as a function-local static constant.
+ */
+class ConfigKey {
+ public:
+  explicit ConfigKey(std::string name)
+      : name_{std::move(name)}, hash_{hashOf(name_)} {}
+
+  explicit ConfigKey(const char* name) : ConfigKey{std::string{name}} {}
+
+  /** @brief The key */
+  const std::string& name() const { return name_; }
+
+  /** @brief Hash of the key */
+  std::size_t hash() const { return hash_; }
+
+  /** @brief Hash of @p name, as used by @ref ConfigValueMap */
+  static std::size_t hashOf(const std::string& name) {
+    // FNV-1a, keys are short
+    Fnv1aHash hash;
+    hash.add(name.data(), name.size());
+    return static_cast<std::size_t>(hash.value());
+  }
+
+ private:
+  std::string name_;
+  std::size_t hash_;
+};
+
+/**
+ * @brief Flat storage for the values of a @ref Configuration.
+ *
+ * Holds the entries in a single array ordered by the hash of their keys, next
+ * to an array of these hashes, so a lookup is a binary search over integers
+ * followed by a single string comparison, and a configuration's values take
+ * two allocations instead of one per value. Provides the subset of the
+ * std::unordered_map interface @ref Configuration uses. Inserting and erasing
+ * entries invalidates all iterators.
+ */
+class ConfigValueMap {
+ public:
+  typedef std::pair<std::string, ConfigValue> value_type;
+  typedef std::vector<value_type>::iterator iterator;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  const_iterator cbegin() const { return entries_.cbegin(); }
+  const_iterator cend() const { return entries_.cend(); }
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  void clear() {
+    hashes_.clear();
+    entries_.clear();
+  }
+
+  const_iterator find(const std::string& key) const {
+    return find(key, ConfigKey::hashOf(key));
+  }
+  const_iterator find(const ConfigKey& key) const {
+    return find(key.name(), key.hash());
+  }
+  iterator find(const std::string& key) {
+    return toIterator(find(key, ConfigKey::hashOf(key)));
+  }
+  iterator find(const ConfigKey& key) {
+    return toIterator(find(key.name(), key.hash()));
+  }
+
+  std::size_t count(const std::string& key) const {
+    return find(key) != end() ? 1 : 0;
+  }
+  std::size_t count(const ConfigKey& key) const {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  /**
+   * @brief The value at @p key, inserting an empty one if not present
+   */
+  ConfigValue& operator[](const std::string& key) {
+    return findOrInsert(key, ConfigKey::hashOf(key));
+  }
+  ConfigValue& operator[](const ConfigKey& key) {
+    return findOrInsert(key.name(), key.hash());
+  }
+
+  iterator erase(const_iterator pos) {
+    hashes_.erase(hashes_.begin() + (pos - entries_.cbegin()));
+    return entries_.erase(pos);
+  }
+
+ private:
+  std::size_t lowerBound(std::size_t hash) const {
+    return std::lower_bound(hashes_.begin(), hashes_.end(), hash) -
+           hashes_.begin();
+  }
+
+  const_iterator find(const std::string& key, std::size_t hash) const {
+    for (std::size_t i = lowerBound(hash);
+         i != hashes_.size() && hashes_[i] == hash; ++i) {
+      if (entries_[i].first == key) {
+        return entries_.begin() + i;
+      }
+    }
+    return entries_.end();
+  }
+
+  ConfigValue& findOrInsert(const std::string& key, std::size_t hash) {
+    std::size_t i = lowerBound(hash);
+    for (; i != hashes_.size() && hashes_[i] == hash; ++i) {
+      if (entries_[i].first == key) {
+        return entries_[i].second;
+      }
+    }
+    hashes_.insert(hashes_.begin() + i, hash);
+    return entries_.emplace(entries_.begin() + i, key, ConfigValue{})->second;
+  }
+
+  iterator toIterator(const_iterator pos) {
+    return entries_.begin() + (pos - entries_.cbegin());
+  }
+
+  std::vector<std::size_t> hashes_;
+  std::vector<value_type> entries_;
+};
+
 /**
  * @brief This class holds configuration data in a map of ConfigValues, and
  * also supports nested configurations via a map of smart pointers to this
  * type.
+ *
+ * Copies share their subconfigurations with the source until either side
+ * edits one through @ref editSubconfig, which is when the edited
+ * subconfiguration gets copied (copy-on-write). Subconfigurations of types
+ * derived from Configuration are always shared between copies, as the
+ * attributes classes holding them already do. Pointers returned by
+ * @ref editSubconfig should therefore not be written to after the
+ * configuration holding them has been copied, and views of a shared
+ * subconfiguration keep showing its old values once it gets edited.
  */
 class Configuration {
  public:
   /**
    * @brief Convenience typedef for the value map
    */
-  typedef std::unordered_map<std::string, ConfigValue> ValueMapType;
+  typedef ConfigValueMap ValueMapType;
   /**
    * @brief Convenience typedef for the subconfiguration map
    */
@@ -454,10 +629,8 @@ class Configuration {
    * @brief Copy Constructor
    */
   Configuration(const Configuration& otr)
-      : configMap_(), valueMap_(otr.valueMap_) {
-    for (const auto& entry : otr.configMap_) {
-      configMap_[entry.first] = std::make_shared<Configuration>(*entry.second);
-    }
+      : configMap_(otr.configMap_), valueMap_(otr.valueMap_) {
+    markSubconfigsShared();
   }  // copy ctor
 
   /**
@@ -479,7 +652,11 @@ class Configuration {
   /**
    * @brief Move Assignment.
    */
-  Configuration& operator=(Configuration&& otr) noexcept = default;
+  Configuration& operator=(Configuration&& otr) noexcept {
+    configMap_ = std::move(otr.configMap_);
+    valueMap_ = std::move(otr.valueMap_);
+    return *this;
+  }
 
   // ****************** Getters ******************
   /**
@@ -510,15 +687,16 @@ class Configuration {
    */
   template <typename T>
   T get(const std::string& key) const {
-    ValueMapType::const_iterator mapIter = valueMap_.find(key);
-    const ConfigValType desiredType = configValTypeFor<T>();
-    if (mapIter != valueMap_.end() &&
-        (mapIter->second.getType() == desiredType)) {
-      return mapIter->second.get<T>();
-    }
-    ESP_ERROR() << "Key :" << key << "not present in configuration as"
-                << getNameForStoredType(desiredType);
-    return {};
+    return getFound<T>(valueMap_.find(key), key);
+  }
+
+  /**
+   * @brief Get value specified by the precomputed @p key, see
+   * @ref get(const std::string&) const.
+   */
+  template <typename T>
+  T get(const ConfigKey& key) const {
+    return getFound<T>(valueMap_.find(key), key.name());
   }
 
   /**
@@ -611,6 +789,14 @@ class Configuration {
   void set(const std::string& key, const T& value) {
     valueMap_[key].set<T>(value);
   }
+
+  /**
+   * @brief Save the passed @p value using the precomputed @p key
+   */
+  template <typename T>
+  void set(const ConfigKey& key, const T& value) {
+    valueMap_[key].set<T>(value);
+  }
   /**
    * @brief Save the passed @p value char* as a string to the configuration at
    * the passed @p key.
@@ -631,6 +817,22 @@ class Configuration {
     valueMap_[key].set<double>(static_cast<double>(value));
   }
 
+  /**
+   * @brief Save the passed @p value char* as a string using the precomputed
+   * @p key .
+   */
+  void set(const ConfigKey& key, const char* value) {
+    valueMap_[key].set<std::string>(std::string(value));
+  }
+
+  /**
+   * @brief Save the passed float @p value as a double using the precomputed
+   * @p key .
+   */
+  void set(const ConfigKey& key, float value) {
+    valueMap_[key].set<double>(static_cast<double>(value));
+  }
+
   // ****************** Value removal ******************
 
   /**
@@ -644,8 +846,9 @@ class Configuration {
   ConfigValue remove(const std::string& key) {
     ValueMapType::const_iterator mapIter = valueMap_.find(key);
     if (mapIter != valueMap_.end()) {
+      ConfigValue removed = mapIter->second;
       valueMap_.erase(mapIter);
-      return mapIter->second;
+      return removed;
     }
     ESP_WARNING() << "Key :" << key << "not present in configuration";
     return {};
@@ -667,8 +870,9 @@ class Configuration {
     const ConfigValType desiredType = configValTypeFor<T>();
     if (mapIter != valueMap_.end() &&
         (mapIter->second.getType() == desiredType)) {
+      T removed = mapIter->second.get<T>();
       valueMap_.erase(mapIter);
-      return mapIter->second.get<T>();
+      return removed;
     }
     ESP_WARNING() << "Key :" << key << "not present in configuration as"
                   << getNameForStoredType(desiredType);
@@ -736,6 +940,14 @@ class Configuration {
     return valueMap_.count(key) > 0;
   }
 
+  /**
+   * @brief Returns whether this @ref Configuration has the precomputed @p key
+   * as a non-configuration value. Does not check subconfigurations.
+   */
+  bool hasValue(const ConfigKey& key) const {
+    return valueMap_.count(key) > 0;
+  }
+
   /**
    * @brief Whether passed @p key references a @ref ConfigValue of passed @ref ConfigValType @p desiredType
    * @param key The key to check the type of.
@@ -1034,6 +1246,23 @@ class Configuration {
   std::string getAllValsAsString(const std::string& newLineStr = "\n") const;
 
  protected:
+  /**
+   * @brief Return the value at @p mapIter if it is of type @p T, or log an
+   * error about @p key and return a default value otherwise.
+   */
+  template <typename T>
+  T getFound(ValueMapType::const_iterator mapIter,
+             const std::string& key) const {
+    const ConfigValType desiredType = configValTypeFor<T>();
+    if (mapIter != valueMap_.end() &&
+        (mapIter->second.getType() == desiredType)) {
+      return mapIter->second.get<T>();
+    }
+    ESP_ERROR() << "Key :" << key << "not present in configuration as"
+                << getNameForStoredType(desiredType);
+    return {};
+  }
+
   /**
    * @brief Process passed json object into this Configuration, using passed
    * key.
@@ -1095,10 +1324,40 @@ class Configuration {
     // configuration
     if (result.second) {
       result.first->second = std::make_shared<Configuration>();
+    } else {
+      detachSubconfig(result.first->second);
     }
     return result.first->second;
   }
 
+  /**
+   * @brief Mark all subconfigurations as shared with a copy of this
+   * configuration, see @ref detachSubconfig.
+   */
+  void markSubconfigsShared() {
+    for (const auto& entry : configMap_) {
+      if (typeid(*entry.second) == typeid(Configuration)) {
+        entry.second->sharedWithCopies_.store(true, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Replace @p subconfig with a copy of it if it is still shared with
+   * a copy of this configuration, so it can be written to.
+   */
+  static void detachSubconfig(std::shared_ptr<Configuration>& subconfig) {
+    if (!subconfig->sharedWithCopies_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (subconfig.use_count() == 1) {
+      // every other holder has let go of it already
+      subconfig->sharedWithCopies_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    subconfig = std::make_shared<Configuration>(*subconfig);
+  }
+
   /**
    * @brief Map to hold configurations as subgroups
    */
@@ -1109,6 +1368,12 @@ class Configuration {
    */
   ValueMapType valueMap_{};
 
+  /**
+   * @brief Whether this configuration is a subconfiguration shared between
+   * copies of its parent, which have to copy it before writing to it.
+   */
+  std::atomic<bool> sharedWithCopies_{false};
+
   ESP_SMART_POINTERS(Configuration)
 };  // class Configuration
 
@@ -0,0 +1,22 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Hash.h"
+
+#include <cstdio>
+
+namespace esp {
+namespace core {
+
+constexpr std::uint64_t Fnv1aHash::Prime;
+
+std::string hashHexString(const std::uint64_t hash) {
+  char string[17];
+  std::snprintf(string, sizeof(string), "%016llx",
+                static_cast<unsigned long long>(hash));
+  return string;
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,84 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_HASH_H_
+#define ESP_CORE_HASH_H_
+
+/** @file
+ * @brief Class @ref esp::core::Fnv1aHash, function
+ * @ref esp::core::hashHexString()
+ */
+
+#include <Corrade/Containers/StringView.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Incremental 64-bit FNV-1a hash
+ *
+ * Unlike @ref std::hash the value is the same across platforms, builds and
+ * processes, so it can name cache files and shared memory blocks. Not
+ * suitable where collisions have to be impossible, compare the hashed data as
+ * well in that case.
+ */
+class Fnv1aHash {
+ public:
+  /** @brief Add @p size bytes at @p data */
+  void add(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i != size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * Prime;
+    }
+  }
+
+  /** @brief Add the bytes of a trivially copyable value */
+  template <class T>
+  void add(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable values can be hashed bytewise");
+    add(&value, sizeof(T));
+  }
+
+  /**
+   * @brief Add a string followed by a terminator, so consecutive strings
+   * hash differently from their concatenation
+   */
+  void addString(Corrade::Containers::StringView string) {
+    add(string.data(), string.size());
+    add("", 1);
+  }
+
+  /**
+   * @brief Add a whole 64-bit word in a single step
+   *
+   * A cheaper variant for hashing in-memory signatures, doesn't give the same
+   * value as adding the bytes of @p word.
+   */
+  void addWord(std::uint64_t word) { hash_ = (hash_ ^ word) * Prime; }
+
+  /** @brief The hash value */
+  std::uint64_t value() const { return hash_; }
+
+ private:
+  static constexpr std::uint64_t Prime = 1099511628211ull;
+
+  std::uint64_t hash_ = 14695981039346656037ull;
+};
+
+/**
+ * @brief A 64-bit hash as 16 lowercase hexadecimal digits, as used in cache
+ * file names
+ */
+std::string hashHexString(std::uint64_t hash);
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_HASH_H_
@@ -3,11 +3,14 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Logging.h"
+#include "AsyncLogSink.h"
 #include "Check.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <sstream>
+#include <utility>
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Pair.h>
@@ -133,6 +136,10 @@ LoggingLevel LoggingContext::levelFor(Subsystem subsystem) const {
   return loggingLevels_[uint8_t(subsystem)];
 }
 
+void LoggingContext::setAsyncSink(Cr::Containers::Pointer<AsyncLogSink> sink) {
+  asyncSink_ = std::move(sink);
+}
+
 bool isLevelEnabled(Subsystem subsystem, LoggingLevel level) {
   return level >= LoggingContext::current().levelFor(subsystem);
 }
@@ -162,5 +169,28 @@ Cr::Containers::String buildMessagePrefix(Subsystem subsystem,
       function);
 }
 
+namespace impl {
+
+LogMessage::~LogMessage() {
+  if (sink_ != nullptr) {
+    sink_->submit(subsystem_, level_, target_, buffer_->str());
+  }
+}
+
+std::ostream* LogMessage::output(std::ostream* const output) {
+  target_ = output;
+  // a null output disables the statement, nothing to submit then
+  if (output != nullptr && LoggingContext::hasCurrent()) {
+    sink_ = LoggingContext::current().asyncSink();
+  }
+  if (sink_ == nullptr) {
+    return output;
+  }
+  buffer_ = std::make_unique<std::ostringstream>();
+  return buffer_.get();
+}
+
+}  // namespace impl
+
 }  // namespace logging
 }  // namespace esp
@@ -8,6 +8,7 @@
 #include "esp/core/configure.h"
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Debug.h>
@@ -15,6 +16,13 @@
 #include <Corrade/Utility/String.h>
 #include <Magnum/Magnum.h> /* for Magnum::Debug alias, mainly */
 
+#include <iosfwd>
+#include <memory>
+
+#ifdef ESP_BUILD_WITH_TRACING
+#include "esp/core/Tracing.h"
+#endif
+
 namespace esp {
 namespace logging {
 /**
@@ -168,6 +176,8 @@ enum class LoggingLevel : uint8_t {
 
 LoggingLevel levelFromName(Corrade::Containers::StringView name);
 
+class AsyncLogSink;
+
 /**
  * @brief Logging context that tracks which logging statements are enabled.
  *
@@ -177,6 +187,11 @@ LoggingLevel levelFromName(Corrade::Containers::StringView name);
  *
  * Due to the use of @ref ESP_LOG_IF, logging statements that are not printed
  * are as close to free as reasonably possible.
+ *
+ * By default the statements are written synchronously to their stream. With
+ * an @ref AsyncLogSink installed through @ref setAsyncSink(), they are
+ * written by a background thread instead, with optional rate limiting and
+ * suppression of repeated messages.
  */
 class LoggingContext {
  public:
@@ -229,6 +244,22 @@ class LoggingContext {
    */
   LoggingLevel levelFor(Subsystem subsystem) const;
 
+  /**
+   * @brief Route the logging statements of this context through @p sink
+   *
+   * Pass @cpp nullptr @ce to write them synchronously again. The context
+   * takes ownership, a previously installed sink is flushed and destroyed.
+   * Not synchronized with logging statements in flight, so install the sink
+   * before starting threads that log.
+   */
+  void setAsyncSink(Corrade::Containers::Pointer<AsyncLogSink> sink);
+
+  /**
+   * @brief The installed async sink or @cpp nullptr @ce if statements are
+   * written synchronously
+   */
+  AsyncLogSink* asyncSink() const { return asyncSink_.get(); }
+
   /**
    * @brief Whether or not there is a current context or not.  Whichever context
    * class was most recently constructed is the current one.
@@ -243,6 +274,7 @@ class LoggingContext {
  private:
   Corrade::Containers::Array<LoggingLevel> loggingLevels_;
   const LoggingContext* prevContext_;
+  Corrade::Containers::Pointer<AsyncLogSink> asyncSink_;
 };
 
 /**
@@ -268,6 +300,41 @@ Corrade::Containers::String buildMessagePrefix(Subsystem subsystem,
                                                int line);
 
 namespace impl {
+
+/**
+ * @brief Destination of a single logging statement
+ *
+ * Created by the logging macros before the statement's
+ * @ref Corrade::Utility::Debug, so it's destroyed after the debug object has
+ * written the whole message. If
+ * the current context has an @ref AsyncLogSink, the message is collected in a
+ * buffer and submitted to the sink on destruction, otherwise it goes straight
+ * to the stream it would have been written to.
+ */
+class LogMessage {
+ public:
+  LogMessage(Subsystem subsystem, LoggingLevel level)
+      : subsystem_{subsystem}, level_{level} {}
+
+  LogMessage(const LogMessage&) = delete;
+  LogMessage& operator=(const LogMessage&) = delete;
+
+  ~LogMessage();
+
+  /**
+   * @brief Stream for the debug object to write to, @p output itself unless
+   * an async sink is installed
+   */
+  std::ostream* output(std::ostream* output);
+
+ private:
+  Subsystem subsystem_;
+  LoggingLevel level_;
+  std::ostream* target_ = nullptr;
+  AsyncLogSink* sink_ = nullptr;
+  std::unique_ptr<std::ostringstream> buffer_;
+};
+
 class LogMessageVoidify {
  public:
   // This has to be an operator with a precedence lower than << but
@@ -327,36 +394,74 @@ class LogMessageVoidify {
                                           (__FUNCTION__), (__LINE__))          \
       << Corrade::Utility::Debug::nospace
 
+// Output of the debug object of a logging statement, passing through the
+// async sink of the current context if there is one
+#define ESP_LOG_OUTPUT(level, stream)                                  \
+  esp::logging::impl::LogMessage{espLoggingSubsystem(), (level)}.output( \
+      (stream))
+
 #define ESP_LOG_LEVEL_ENABLED(level) \
   esp::logging::isLevelEnabled(espLoggingSubsystem(), (level))
 
 /**
  * @brief Very verbose level logging macro.
  */
-#define ESP_VERY_VERBOSE(...)                                            \
-  ESP_SUBSYS_LOG_IF(                                                     \
-      espLoggingSubsystem(), esp::logging::LoggingLevel::VeryVerbose,    \
-      (Corrade::Utility::Debug{Corrade::Utility::Debug::defaultOutput(), \
-                               __VA_ARGS__}),                            \
+#define ESP_VERY_VERBOSE(...)                                               \
+  ESP_SUBSYS_LOG_IF(                                                        \
+      espLoggingSubsystem(), esp::logging::LoggingLevel::VeryVerbose,       \
+      (Corrade::Utility::Debug{                                             \
+          ESP_LOG_OUTPUT(esp::logging::LoggingLevel::VeryVerbose,           \
+                         Corrade::Utility::Debug::defaultOutput()),         \
+          __VA_ARGS__}),                                                    \
       "Verbose")
 /**
  * @brief Debug level logging macro.
  */
 #define ESP_DEBUG(...)                                                        \
   ESP_SUBSYS_LOG_IF(espLoggingSubsystem(), esp::logging::LoggingLevel::Debug, \
-                    Corrade::Utility::Debug{__VA_ARGS__}, "Debug")
+                    (Corrade::Utility::Debug{                                 \
+                        ESP_LOG_OUTPUT(esp::logging::LoggingLevel::Debug,     \
+                                       Corrade::Utility::Debug::output()),    \
+                        __VA_ARGS__}),                                        \
+                    "Debug")
 /**
  * @brief Warning level logging macro.
  */
-#define ESP_WARNING(...)                                 \
-  ESP_SUBSYS_LOG_IF(espLoggingSubsystem(),               \
-                    esp::logging::LoggingLevel::Warning, \
-                    Corrade::Utility::Warning{__VA_ARGS__}, "Warning")
+#define ESP_WARNING(...)                                                    \
+  ESP_SUBSYS_LOG_IF(espLoggingSubsystem(),                                  \
+                    esp::logging::LoggingLevel::Warning,                    \
+                    (Corrade::Utility::Warning{                             \
+                        ESP_LOG_OUTPUT(esp::logging::LoggingLevel::Warning, \
+                                       Corrade::Utility::Warning::output()), \
+                        __VA_ARGS__}),                                      \
+                    "Warning")
 /**
  * @brief Error level logging macro.
  */
 #define ESP_ERROR(...)                                                        \
   ESP_SUBSYS_LOG_IF(espLoggingSubsystem(), esp::logging::LoggingLevel::Error, \
-                    Corrade::Utility::Error{__VA_ARGS__}, "Error")
+                    (Corrade::Utility::Error{                                 \
+                        ESP_LOG_OUTPUT(esp::logging::LoggingLevel::Error,     \
+                                       Corrade::Utility::Error::output()),    \
+                        __VA_ARGS__}),                                        \
+                    "Error")
+
+/**
+ * @brief Record the rest of the enclosing scope as a trace span
+ *
+ * The span is categorized by the logging subsystem of the enclosing
+ * namespace and can be written out with @ref esp::logging::writeTrace().
+ * Compiles to nothing unless Habitat-Sim is built with `BUILD_WITH_TRACING`,
+ * so it can be used in hot code.
+ */
+#ifdef ESP_BUILD_WITH_TRACING
+#define ESP_TRACE_SCOPE(name)                                  \
+  const ::esp::logging::TraceSpan espTraceScope {              \
+    (name), ::esp::logging::subsystemNames[uint8_t(            \
+                espLoggingSubsystem())]                        \
+  }
+#else
+#define ESP_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
 
 #endif  // ESP_CORE_LOGGING_H_
@@ -0,0 +1,51 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_MEMORYUSAGE_H_
+#define ESP_CORE_MEMORYUSAGE_H_
+
+/** @file
+ * @brief Struct @ref esp::core::MemoryUsage, function
+ * @ref esp::core::heapByteSize()
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Estimated CPU and GPU memory held by a subsystem
+ *
+ * The estimates count the payload of the data, such as vertex buffers and
+ * texture levels, not allocator or driver overhead.
+ */
+struct MemoryUsage {
+  /** @brief Estimated CPU memory in bytes */
+  std::size_t cpuBytes = 0;
+
+  /** @brief Estimated GPU memory in bytes */
+  std::size_t gpuBytes = 0;
+
+  /** @brief Add other usage */
+  MemoryUsage& operator+=(const MemoryUsage& other) {
+    cpuBytes += other.cpuBytes;
+    gpuBytes += other.gpuBytes;
+    return *this;
+  }
+};
+
+/**
+ * @brief Heap memory of a string, none for short strings stored inline
+ */
+inline std::size_t heapByteSize(const std::string& string) {
+  return string.capacity() > std::string{}.capacity() ? string.capacity() + 1
+                                                      : 0;
+}
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_MEMORYUSAGE_H_
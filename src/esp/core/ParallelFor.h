@@ -0,0 +1,124 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_PARALLELFOR_H_
+#define ESP_CORE_PARALLELFOR_H_
+
+/** @file
+ * @brief Function @ref esp::core::parallelFor(), @ref
+ * esp::core::resolveNumThreads()
+ */
+
+#include <Corrade/Corrade.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Resolve a user-requested worker thread count.
+ *
+ * @param numThreads The requested number of threads. Values <= 0 select the
+ * hardware concurrency of the machine.
+ * @param numItems The number of work items. The result is never larger than
+ * this (but always at least 1).
+ *
+ * @return The number of worker threads to use.
+ */
+inline int resolveNumThreads(int numThreads, std::size_t numItems) {
+#if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // no threads available in single-threaded WebAssembly builds
+  static_cast<void>(numThreads);
+  static_cast<void>(numItems);
+  return 1;
+#else
+  if (numThreads <= 0) {
+    numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  numThreads = std::max(numThreads, 1);
+  if (numItems < static_cast<std::size_t>(numThreads)) {
+    numThreads = std::max(static_cast<int>(numItems), 1);
+  }
+  return numThreads;
+#endif
+}
+
+/**
+ * @brief Run @p func for every index in [0, @p numItems) across a set of
+ * worker threads.
+ *
+ * Work items are handed out dynamically from a shared atomic counter so that
+ * uneven per-item cost is balanced across workers. The calling thread
+ * participates as worker 0, so a single-threaded call spawns no threads.
+ *
+ * @param numItems The number of work items.
+ * @param numThreads The number of worker threads, resolved via @ref
+ * resolveNumThreads. Callers that keep per-worker state (e.g. scratch
+ * buffers) should resolve the count themselves first and pass it here.
+ * @param func Callable with signature `void(std::size_t item, int worker)`.
+ * @p worker is in [0, numThreads) and is unique to each concurrently running
+ * thread.
+ *
+ * If @p func throws, remaining items are skipped and the first exception is
+ * rethrown on the calling thread after all workers have joined.
+ */
+template <typename F>
+void parallelFor(std::size_t numItems, int numThreads, F&& func) {
+  if (numItems == 0) {
+    return;
+  }
+  numThreads = resolveNumThreads(numThreads, numItems);
+  if (numThreads == 1) {
+    for (std::size_t i = 0; i < numItems; ++i) {
+      func(i, 0);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto worker = [&](int workerIndex) {
+    try {
+      for (std::size_t i = next.fetch_add(1); i < numItems;
+           i = next.fetch_add(1)) {
+        func(i, workerIndex);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{errorMutex};
+      if (!error) {
+        error = std::current_exception();
+      }
+      // drain the counter so other workers stop early
+      next.store(numItems);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (int t = 1; t < numThreads; ++t) {
+    threads.emplace_back(worker, t);
+  }
+  worker(0);
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_PARALLELFOR_H_
@@ -0,0 +1,249 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace esp {
+namespace core {
+
+namespace {
+struct Section {
+  // ring buffer of the most recent durations in microseconds
+  std::vector<double> windowUs;
+  std::size_t next = 0;
+  std::size_t totalCount = 0;
+  double totalUs = 0.0;
+};
+
+struct TraceEvent {
+  const char* name;
+  uint32_t thread;
+  int64_t beginUs;
+  int64_t durationUs;
+};
+
+// sections are keyed by their name pointers, which for the same literal may
+// differ between translation units, so compare the contents
+struct NameLess {
+  bool operator()(const char* a, const char* b) const {
+    return std::strcmp(a, b) < 0;
+  }
+};
+
+// nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, const double p) {
+  const std::size_t rank = std::size_t(std::ceil(p * sorted.size()));
+  return sorted[std::min(std::max(rank, std::size_t{1}), sorted.size()) - 1];
+}
+
+ProfileSectionStats computeStats(const char* name, const Section& section) {
+  ProfileSectionStats stats;
+  stats.name = name;
+  stats.totalCount = section.totalCount;
+  stats.windowCount = section.windowUs.size();
+  stats.totalMs = section.totalUs / 1000.0;
+  if (section.windowUs.empty()) {
+    return stats;
+  }
+
+  std::vector<double> sorted = section.windowUs;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0.0;
+  for (const double us : sorted) {
+    sum += us;
+    std::size_t bucket = 0;
+    if (us >= 1.0) {
+      bucket = std::min(ProfileHistogramBuckets - 1,
+                        1 + std::size_t(std::floor(std::log2(us))));
+    }
+    ++stats.histogram[bucket];
+  }
+  stats.meanMs = sum / sorted.size() / 1000.0;
+  stats.minMs = sorted.front() / 1000.0;
+  stats.maxMs = sorted.back() / 1000.0;
+  stats.p50Ms = percentile(sorted, 0.50) / 1000.0;
+  stats.p95Ms = percentile(sorted, 0.95) / 1000.0;
+  stats.p99Ms = percentile(sorted, 0.99) / 1000.0;
+  return stats;
+}
+
+void addSample(Section& s, const std::size_t windowSize,
+               const double durationUs) {
+  if (s.windowUs.size() < windowSize) {
+    s.windowUs.push_back(durationUs);
+  } else {
+    s.windowUs[s.next] = durationUs;
+    s.next = (s.next + 1) % windowSize;
+  }
+  ++s.totalCount;
+  s.totalUs += durationUs;
+}
+
+void writeJsonString(std::ostream& out, const char* string) {
+  out << '"';
+  for (const char* c = string; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+}  // namespace
+
+struct Profiler::State {
+  explicit State(std::size_t windowSize)
+      : windowSize{std::max(windowSize, std::size_t{1})},
+        epoch{Clock::now()} {}
+
+  mutable std::mutex mutex;
+  const std::size_t windowSize;
+  Clock::time_point epoch;
+  std::map<const char*, Section, NameLess> sections;
+
+  bool traceEnabled = false;
+  std::size_t maxTraceEvents = 0;
+  std::vector<TraceEvent> traceEvents;
+  // small ids for the trace, in order of the first sample of each thread
+  std::unordered_map<std::thread::id, uint32_t> threadIds;
+};
+
+Profiler& Profiler::global() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler(const std::size_t windowSize)
+    : state_{Corrade::Containers::pointer<State>(windowSize)} {}
+
+Profiler::~Profiler() = default;
+
+void Profiler::setEnabled(const bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setGpuTimersEnabled(const bool enabled) {
+  gpuTimersEnabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isTraceEnabled() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->traceEnabled;
+}
+
+void Profiler::setTraceEnabled(const bool enabled,
+                               const std::size_t maxTraceEvents) {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  state_->traceEnabled = enabled;
+  state_->maxTraceEvents = maxTraceEvents;
+}
+
+void Profiler::record(const char* section,
+                      const Clock::time_point begin,
+                      const Clock::time_point end) {
+  if (!isEnabled()) {
+    return;
+  }
+  const double durationUs =
+      std::chrono::duration<double, std::micro>(end - begin).count();
+
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  addSample(state_->sections[section], state_->windowSize, durationUs);
+
+  if (state_->traceEnabled &&
+      state_->traceEvents.size() < state_->maxTraceEvents) {
+    const auto inserted = state_->threadIds.emplace(
+        std::this_thread::get_id(), uint32_t(state_->threadIds.size()));
+    state_->traceEvents.push_back(
+        {section, inserted.first->second,
+         std::chrono::duration_cast<std::chrono::microseconds>(begin -
+                                                               state_->epoch)
+             .count(),
+         std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+             .count()});
+  }
+}
+
+void Profiler::recordDuration(const char* section,
+                              const Clock::duration duration) {
+  if (!isEnabled()) {
+    return;
+  }
+  const double durationUs =
+      std::chrono::duration<double, std::micro>(duration).count();
+
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  addSample(state_->sections[section], state_->windowSize, durationUs);
+}
+
+std::vector<ProfileSectionStats> Profiler::stats() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  std::vector<ProfileSectionStats> stats;
+  stats.reserve(state_->sections.size());
+  for (const auto& section : state_->sections) {
+    stats.push_back(computeStats(section.first, section.second));
+  }
+  return stats;
+}
+
+ProfileSectionStats Profiler::stats(const std::string& section) const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  const auto found = state_->sections.find(section.c_str());
+  if (found == state_->sections.end()) {
+    ProfileSectionStats stats;
+    stats.name = section;
+    return stats;
+  }
+  return computeStats(found->first, found->second);
+}
+
+std::size_t Profiler::traceEventCount() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->traceEvents.size();
+}
+
+bool Profiler::writeChromeTrace(const std::string& filename) const {
+  std::ofstream out{filename};
+  if (!out) {
+    ESP_ERROR() << "Can't open" << filename << "for writing";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (std::size_t i = 0; i != state_->traceEvents.size(); ++i) {
+    const TraceEvent& event = state_->traceEvents[i];
+    if (i != 0) {
+      out << ',';
+    }
+    out << "\n{\"name\":";
+    writeJsonString(out, event.name);
+    out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+        << ",\"ts\":" << event.beginUs << ",\"dur\":" << event.durationUs
+        << '}';
+  }
+  out << "\n]}\n";
+  return bool(out);
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  state_->sections.clear();
+  state_->traceEvents.clear();
+  state_->threadIds.clear();
+  state_->epoch = Clock::now();
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,231 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_PROFILER_H_
+#define ESP_CORE_PROFILER_H_
+
+/** @file
+ * @brief Class @ref esp::core::Profiler, @ref esp::core::ScopedProfile, struct
+ * @ref esp::core::ProfileSectionStats, macro @ref ESP_PROFILE_SCOPE()
+ */
+
+#include <Corrade/Containers/Pointer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Number of buckets of @ref ProfileSectionStats::histogram
+ */
+constexpr std::size_t ProfileHistogramBuckets = 16;
+
+/**
+ * @brief Timing statistics of a profiled section, see @ref Profiler::stats()
+ *
+ * Everything except @ref totalCount is computed over the rolling window of
+ * the most recent samples of the section.
+ */
+struct ProfileSectionStats {
+  /** @brief Section name */
+  std::string name;
+
+  /** @brief Number of samples recorded since the last @ref Profiler::clear()
+   */
+  std::size_t totalCount = 0;
+
+  /** @brief Number of samples in the window */
+  std::size_t windowCount = 0;
+
+  /**
+   * @brief Summed duration of all samples since the last @ref
+   * Profiler::clear(), for sections that run many times per operation
+   */
+  double totalMs = 0.0;
+
+  double meanMs = 0.0;
+  double minMs = 0.0;
+  double maxMs = 0.0;
+  double p50Ms = 0.0;
+  double p95Ms = 0.0;
+  double p99Ms = 0.0;
+
+  /**
+   * @brief Sample counts in power-of-two buckets. Bucket 0 counts samples
+   * below 1 µs, bucket @f$ i @f$ samples in @f$ [2^{i - 1}, 2^i) @f$ µs and
+   * the last bucket everything above.
+   */
+  std::size_t histogram[ProfileHistogramBuckets]{};
+};
+
+/**
+ * @brief Collects the durations of named code sections
+ *
+ * Sections are timed with @ref ScopedProfile, usually through @ref
+ * ESP_PROFILE_SCOPE(), on any thread. The simulator times physics stepping,
+ * scene node updates, culling, drawing, render target readback and replay
+ * keyframe recording this way. Recording is disabled by default, when
+ * disabled the timers don't even query the clock.
+ *
+ * Each section keeps a rolling window of its most recent durations, from
+ * which @ref stats() computes means, percentiles and histograms. With @ref
+ * setTraceEnabled(), every sample is also kept as an event for @ref
+ * writeChromeTrace(), which can be opened in `chrome://tracing` or Perfetto.
+ */
+class Profiler {
+ public:
+  /** @brief Clock the samples are measured with */
+  typedef std::chrono::steady_clock Clock;
+
+  /** @brief The profiler the simulator sections are recorded to */
+  static Profiler& global();
+
+  /**
+   * @brief Constructor
+   * @param windowSize Number of most recent samples of each section the
+   * statistics are computed from
+   */
+  explicit Profiler(std::size_t windowSize = 512);
+
+  ~Profiler();
+
+  /** @brief Whether samples are recorded */
+  bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /** @brief Enable or disable recording of samples */
+  void setEnabled(bool enabled);
+
+  /** @brief Whether the samples are kept as trace events */
+  bool isTraceEnabled() const;
+
+  /**
+   * @brief Keep every recorded sample as a trace event for @ref
+   * writeChromeTrace()
+   * @param enabled         Whether to keep the events
+   * @param maxTraceEvents  Events recorded after that many are dropped, so a
+   *    forgotten trace doesn't grow forever
+   */
+  void setTraceEnabled(bool enabled, std::size_t maxTraceEvents = 1 << 20);
+
+  /**
+   * @brief Whether GPU durations of render stages are measured
+   *
+   * The renderers then bracket drawing, HBAO, cube map faces and readback
+   * with GL timestamp queries and record the durations with @ref
+   * recordDuration() once available, usually a frame or two later. Has no
+   * effect if the GL context doesn't support timer queries.
+   */
+  bool isGpuTimersEnabled() const {
+    return gpuTimersEnabled_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Enable or disable measuring of GPU durations */
+  void setGpuTimersEnabled(bool enabled);
+
+  /**
+   * @brief Record a sample of @p section. Thread-safe.
+   *
+   * The @p section string is referenced, not copied, so it has to outlive the
+   * profiler, e.g. by being a string literal. Ignored if not enabled.
+   */
+  void record(const char* section,
+              Clock::time_point begin,
+              Clock::time_point end);
+
+  /**
+   * @brief Record a sample of @p section measured by other means than the
+   * clock, such as a GPU timer query. Thread-safe.
+   *
+   * Same as @ref record(), except that the sample isn't kept as a trace
+   * event, as it has no meaningful begin time.
+   */
+  void recordDuration(const char* section, Clock::duration duration);
+
+  /** @brief Statistics of all recorded sections, ordered by name */
+  std::vector<ProfileSectionStats> stats() const;
+
+  /**
+   * @brief Statistics of one section
+   *
+   * Has zero counts if the section wasn't recorded.
+   */
+  ProfileSectionStats stats(const std::string& section) const;
+
+  /** @brief Number of kept trace events */
+  std::size_t traceEventCount() const;
+
+  /**
+   * @brief Write the kept trace events to @p filename in the Chrome trace
+   * event JSON format
+   * @return Whether the file was written
+   */
+  bool writeChromeTrace(const std::string& filename) const;
+
+  /** @brief Drop all samples and trace events */
+  void clear();
+
+  ESP_SMART_POINTERS(Profiler)
+
+ private:
+  struct State;
+  Corrade::Containers::Pointer<State> state_;
+  std::atomic<bool> enabled_{false};
+  std::atomic<bool> gpuTimersEnabled_{false};
+};
+
+/**
+ * @brief Records the lifetime of the instance as a sample of a section
+ *
+ * Does nothing if @p profiler is disabled on construction.
+ */
+class ScopedProfile {
+ public:
+  /**
+   * @brief Constructor
+   * @param section   Section name, has to outlive @p profiler, see @ref
+   *    Profiler::record()
+   * @param profiler  The profiler to record to
+   */
+  explicit ScopedProfile(const char* section,
+                         Profiler& profiler = Profiler::global())
+      : profiler_{profiler.isEnabled() ? &profiler : nullptr},
+        section_{section} {
+    if (profiler_) {
+      begin_ = Profiler::Clock::now();
+    }
+  }
+
+  ScopedProfile(const ScopedProfile&) = delete;
+  ScopedProfile& operator=(const ScopedProfile&) = delete;
+
+  ~ScopedProfile() {
+    if (profiler_) {
+      profiler_->record(section_, begin_, Profiler::Clock::now());
+    }
+  }
+
+ private:
+  Profiler* profiler_;
+  const char* section_;
+  Profiler::Clock::time_point begin_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+/**
+ * @brief Time the rest of the enclosing scope as a sample of @p section in
+ * @ref esp::core::Profiler::global()
+ */
+#define ESP_PROFILE_SCOPE(section) \
+  const ::esp::core::ScopedProfile espProfileScope { section }
+
+#endif  // ESP_CORE_PROFILER_H_
@@ -0,0 +1,145 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "esp/core/ParallelFor.h"
+
+namespace esp {
+namespace core {
+
+struct ThreadPool::State {
+  std::vector<std::thread> threads;
+
+  // serializes parallelFor() calls from multiple threads
+  std::mutex callMutex;
+
+  // protects everything below except next
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  std::condition_variable done;
+  std::size_t generation = 0;
+  bool stop = false;
+  int busyWorkers = 0;
+  const std::function<void(std::size_t, int)>* func = nullptr;
+  std::size_t numItems = 0;
+  std::exception_ptr error;
+
+  std::atomic<std::size_t> next{0};
+
+  void runItems(int workerIndex) {
+    try {
+      for (std::size_t i = next.fetch_add(1); i < numItems;
+           i = next.fetch_add(1)) {
+        (*func)(i, workerIndex);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (!error) {
+        error = std::current_exception();
+      }
+      // drain the counter so other workers stop early
+      next.store(numItems);
+    }
+  }
+
+  void workerLoop(int workerIndex) {
+    std::size_t seenGeneration = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        wakeup.wait(lock,
+                    [&] { return stop || generation != seenGeneration; });
+        if (stop) {
+          return;
+        }
+        seenGeneration = generation;
+      }
+
+      runItems(workerIndex);
+
+      std::lock_guard<std::mutex> lock{mutex};
+      if (--busyWorkers == 0) {
+        done.notify_one();
+      }
+    }
+  }
+};
+
+ThreadPool::ThreadPool(int numThreads) : state_{Corrade::InPlaceInit} {
+  // the item count isn't known yet, so don't let it limit the thread count
+  numThreads = resolveNumThreads(numThreads, ~std::size_t{});
+  state_->threads.reserve(numThreads - 1);
+  for (int t = 1; t < numThreads; ++t) {
+    state_->threads.emplace_back(&State::workerLoop, state_.get(), t);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->stop = true;
+  }
+  state_->wakeup.notify_all();
+  for (std::thread& t : state_->threads) {
+    t.join();
+  }
+}
+
+int ThreadPool::numThreads() const {
+  return int(state_->threads.size()) + 1;
+}
+
+void ThreadPool::parallelFor(
+    const std::size_t numItems,
+    const std::function<void(std::size_t, int)>& func) {
+  if (numItems == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> callLock{state_->callMutex};
+
+  // not worth waking anybody up
+  if (state_->threads.empty() || numItems == 1) {
+    for (std::size_t i = 0; i < numItems; ++i) {
+      func(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->func = &func;
+    state_->numItems = numItems;
+    state_->next.store(0);
+    state_->error = nullptr;
+    state_->busyWorkers = int(state_->threads.size());
+    ++state_->generation;
+  }
+  state_->wakeup.notify_all();
+
+  state_->runItems(0);
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock{state_->mutex};
+    state_->done.wait(lock, [&] { return state_->busyWorkers == 0; });
+    state_->func = nullptr;
+    error = state_->error;
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace core
+}  // namespace esp
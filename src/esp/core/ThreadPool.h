@@ -0,0 +1,81 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_THREADPOOL_H_
+#define ESP_CORE_THREADPOOL_H_
+
+/** @file
+ * @brief Class @ref esp::core::ThreadPool
+ */
+
+#include <Corrade/Containers/Pointer.h>
+
+#include <cstddef>
+#include <functional>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Persistent set of worker threads for repeated parallel loops.
+ *
+ * Unlike @ref parallelFor(), which spawns and joins its threads on every call,
+ * the workers are created once and sleep between calls. That makes it suitable
+ * for loops that run every simulation step, where spawning threads would be a
+ * significant part of the cost.
+ *
+ * The calling thread participates as worker 0, so a pool of a single thread
+ * spawns no threads at all. Calls to @ref parallelFor(std::size_t, const
+ * std::function<void(std::size_t, int)>&) from multiple threads are
+ * serialized, calling it from inside a work item deadlocks.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Constructor
+   * @param numThreads The number of threads including the calling thread.
+   * Values <= 0 select the hardware concurrency of the machine, see
+   * @ref resolveNumThreads().
+   */
+  explicit ThreadPool(int numThreads = 0);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+
+  /** @brief Destructor. Wakes up and joins all worker threads. */
+  ~ThreadPool();
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  /** @brief Number of threads, including the calling thread */
+  int numThreads() const;
+
+  /**
+   * @brief Run @p func for every index in [0, @p numItems) on the pool.
+   *
+   * Blocks until all items are done. Items are handed out dynamically from a
+   * shared atomic counter, @p func gets the item index and the index of the
+   * worker running it, which is in [0, @ref numThreads()) and unique to each
+   * concurrently running thread.
+   *
+   * If @p func throws, remaining items are skipped and the first exception is
+   * rethrown on the calling thread after all workers are done.
+   */
+  void parallelFor(std::size_t numItems,
+                   const std::function<void(std::size_t, int)>& func);
+
+  ESP_SMART_POINTERS(ThreadPool)
+
+ private:
+  struct State;
+  Corrade::Containers::Pointer<State> state_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_THREADPOOL_H_
@@ -0,0 +1,169 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Tracing.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace esp {
+namespace logging {
+
+namespace {
+// spans kept per thread, about 2 MB each
+constexpr std::uint64_t ThreadBufferCapacity = 1 << 16;
+
+struct Span {
+  const char* name;
+  const char* category;
+  std::int64_t beginNs;
+  std::int64_t durationNs;
+};
+
+// written only by its thread. The count is published with release semantics
+// after each span is written, so readers see complete spans up to it, and
+// spans the writer overwrote meanwhile are detected by re-reading it.
+struct ThreadBuffer {
+  explicit ThreadBuffer(std::uint32_t id)
+      : id{id}, spans{new Span[ThreadBufferCapacity]} {}
+
+  const std::uint32_t id;
+  std::unique_ptr<Span[]> spans;
+  std::atomic<std::uint64_t> count{0};
+  // spans below this index were dropped by clearTrace()
+  std::atomic<std::uint64_t> firstKept{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  const TraceClock::time_point epoch = TraceClock::now();
+  // buffers outlive their threads so their spans stay in the trace
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer& threadBuffer() {
+  thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.buffers.push_back(
+        std::make_shared<ThreadBuffer>(std::uint32_t(r.buffers.size())));
+    return r.buffers.back();
+  }();
+  return *buffer;
+}
+
+// index of the first span of buffer that's still kept, up to count
+std::uint64_t firstKeptSpan(const ThreadBuffer& buffer,
+                            const std::uint64_t count) {
+  const std::uint64_t firstInRing =
+      count > ThreadBufferCapacity ? count - ThreadBufferCapacity : 0;
+  return std::max(firstInRing,
+                  buffer.firstKept.load(std::memory_order_relaxed));
+}
+
+void writeJsonString(std::ostream& out, const char* string) {
+  out << '"';
+  for (const char* c = string; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+}  // namespace
+
+void recordTraceSpan(const char* name,
+                     const char* category,
+                     const TraceClock::time_point begin,
+                     const TraceClock::time_point end) {
+  ThreadBuffer& buffer = threadBuffer();
+  const std::uint64_t index = buffer.count.load(std::memory_order_relaxed);
+  buffer.spans[index % ThreadBufferCapacity] = {
+      name, category,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(begin -
+                                                           registry().epoch)
+          .count(),
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+          .count()};
+  buffer.count.store(index + 1, std::memory_order_release);
+}
+
+bool writeTrace(const std::string& filename) {
+  std::ofstream out{filename};
+  if (!out) {
+    ESP_ERROR() << "Can't open" << filename << "for writing";
+    return false;
+  }
+
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::fixed
+      << std::setprecision(3);
+  bool first = true;
+  std::vector<Span> spans;
+  for (const auto& buffer : r.buffers) {
+    const std::uint64_t count = buffer->count.load(std::memory_order_acquire);
+    const std::uint64_t begin = firstKeptSpan(*buffer, count);
+    spans.clear();
+    for (std::uint64_t i = begin; i != count; ++i) {
+      spans.push_back(buffer->spans[i % ThreadBufferCapacity]);
+    }
+    // drop the spans the thread overwrote while they were copied, including
+    // the one it may be writing right now
+    const std::uint64_t valid = firstKeptSpan(
+        *buffer, buffer->count.load(std::memory_order_acquire) + 1);
+    const std::size_t overwritten =
+        std::min(std::size_t(std::max(valid, begin) - begin), spans.size());
+
+    for (std::size_t i = overwritten; i != spans.size(); ++i) {
+      const Span& span = spans[i];
+      out << (first ? "\n" : ",\n") << "{\"name\":";
+      first = false;
+      writeJsonString(out, span.name);
+      out << ",\"cat\":";
+      writeJsonString(out, span.category);
+      out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->id
+          << ",\"ts\":" << span.beginNs / 1000.0
+          << ",\"dur\":" << span.durationNs / 1000.0 << '}';
+    }
+  }
+  out << "\n]}\n";
+  return bool(out);
+}
+
+std::size_t traceSpanCount() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  std::size_t spanCount = 0;
+  for (const auto& buffer : r.buffers) {
+    const std::uint64_t count = buffer->count.load(std::memory_order_acquire);
+    spanCount += count - firstKeptSpan(*buffer, count);
+  }
+  return spanCount;
+}
+
+void clearTrace() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  for (const auto& buffer : r.buffers) {
+    buffer->firstKept.store(buffer->count.load(std::memory_order_acquire),
+                            std::memory_order_relaxed);
+  }
+}
+
+}  // namespace logging
+}  // namespace esp
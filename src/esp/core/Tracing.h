@@ -0,0 +1,93 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_TRACING_H_
+#define ESP_CORE_TRACING_H_
+
+/** @file
+ * @brief Class @ref esp::logging::TraceSpan, functions
+ * @ref esp::logging::writeTrace(), @ref esp::logging::clearTrace()
+ *
+ * The spans are recorded through @ref ESP_TRACE_SCOPE(), defined in
+ * @ref Logging.h next to the logging macros.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace esp {
+namespace logging {
+
+/** @brief Clock the trace spans are measured with */
+typedef std::chrono::steady_clock TraceClock;
+
+/**
+ * @brief Record a span to the trace buffer of the calling thread
+ * @param name      Span name
+ * @param category  Span category, usually the logging subsystem name
+ * @param begin     Begin of the span
+ * @param end       End of the span
+ *
+ * Each thread writes into its own fixed-size ring buffer without locking,
+ * only the first span of a thread takes a lock to register its buffer. Once
+ * full, the oldest spans of the thread get overwritten, so the trace always
+ * covers the most recent activity. Both strings are referenced, not copied,
+ * so they have to outlive the trace, e.g. by being string literals.
+ */
+void recordTraceSpan(const char* name,
+                     const char* category,
+                     TraceClock::time_point begin,
+                     TraceClock::time_point end);
+
+/**
+ * @brief Write the spans of all threads to @p filename in the Chrome trace
+ * event JSON format
+ * @return Whether the file was written
+ *
+ * Can be called while other threads keep recording, spans overwritten during
+ * the write are left out. The file can be opened in `chrome://tracing` or
+ * Perfetto.
+ */
+bool writeTrace(const std::string& filename);
+
+/** @brief Number of spans currently kept in the trace buffers */
+std::size_t traceSpanCount();
+
+/** @brief Drop all recorded spans */
+void clearTrace();
+
+/**
+ * @brief Records the lifetime of the instance as a trace span
+ *
+ * Use through @ref ESP_TRACE_SCOPE(), which compiles to nothing unless
+ * Habitat-Sim is built with `BUILD_WITH_TRACING`.
+ */
+class TraceSpan {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * See @ref recordTraceSpan() for the lifetime requirements of the strings.
+   */
+  explicit TraceSpan(const char* name, const char* category)
+      : name_{name}, category_{category}, begin_{TraceClock::now()} {}
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  ~TraceSpan() {
+    recordTraceSpan(name_, category_, begin_, TraceClock::now());
+  }
+
+ private:
+  const char* name_;
+  const char* category_;
+  TraceClock::time_point begin_;
+};
+
+}  // namespace logging
+}  // namespace esp
+
+#endif  // ESP_CORE_TRACING_H_
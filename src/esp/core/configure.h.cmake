@@ -13,4 +13,8 @@
 
 #cmakedefine ESP_BUILD_WITH_BACKGROUND_RENDERER
 
+#cmakedefine ESP_BUILD_BASIS_COMPRESSOR
+
+#cmakedefine ESP_BUILD_WITH_TRACING
+
 #endif  //  ESP_CORE_CONFIGURE_H_
@@ -260,8 +260,8 @@ class ManagedContainer : public ManagedContainerBase {
   std::unordered_map<std::string, ManagedPtr> getObjectsByHandleSubstring(
       const std::string& subStr = "",
       bool contains = true) {
-    std::vector<std::string> keys = this->getObjectHandlesBySubStringPerType(
-        objectLibKeyByID_, subStr, contains, false);
+    std::vector<std::string> keys =
+        this->getObjectHandlesBySubstring(subStr, contains, false);
 
     std::unordered_map<std::string, ManagedPtr> res;
     res.reserve(keys.size());
@@ -294,8 +294,8 @@ class ManagedContainer : public ManagedContainerBase {
   std::unordered_map<std::string, std::shared_ptr<U>>
   getObjectsByHandleSubstring(const std::string& subStr = "",
                               bool contains = true) {
-    std::vector<std::string> keys = this->getObjectHandlesBySubStringPerType(
-        objectLibKeyByID_, subStr, contains, false);
+    std::vector<std::string> keys =
+        this->getObjectHandlesBySubstring(subStr, contains, false);
 
     std::unordered_map<std::string, std::shared_ptr<U>> res;
     res.reserve(keys.size());
@@ -762,9 +762,12 @@ class ManagedContainer : public ManagedContainerBase {
     // set handle for managed object - might not have been set during
     // construction
     object->setHandle(objectHandle);
+    // the ID lookup and the insertion have to be atomic for concurrent
+    // readers to never see a half-registered object
+    auto lock = this->writeLockLibrary();
     // return either the ID of the existing managed object referenced by
     // objectHandle, or the next available ID if not found.
-    object->setID(getObjectIDByHandleOrNew(objectHandle, true));
+    object->setID(getObjectIDByHandleOrNewLocked(objectHandle));
     // use object's ID for ID in container - may not match ID synthesized by
     // getObjectIDByHandle, for managed objects that control their own IDs
     int objectID = object->getID();
@@ -774,7 +777,9 @@ class ManagedContainer : public ManagedContainerBase {
     ManagedPtr managedObjectCopy = copyObject(object);
     // add to libraries
     setObjectInternal(managedObjectCopy, objectHandle);
-    objectLibKeyByID_.emplace(objectID, objectHandle);
+    if (objectLibKeyByID_.emplace(objectID, objectHandle).second) {
+      this->indexObjectHandle(objectID, objectHandle);
+    }
     return objectID;
   }  // ManagedContainer::addObjectToLibrary
 
@@ -20,6 +20,7 @@ bool ManagedContainerBase::setLock(const std::string& objectHandle, bool lock) {
     return false;
   }
   // if setting lock else clearing lock
+  auto libraryLock = writeLockLibrary();
   if (lock) {
     userLockedObjectNames_.insert(objectHandle);
   } else {
@@ -113,8 +114,80 @@ std::vector<std::string> getHandlesBySubStringPerTypeInternal(
   }
   return res;
 }
+/**
+ * @brief Key in the handle trigram index of the 3 characters of the lowercased
+ * @p str starting at @p pos.
+ */
+uint32_t trigramAt(const std::string& str, std::size_t pos) {
+  return (uint32_t(static_cast<unsigned char>(str[pos])) << 16) |
+         (uint32_t(static_cast<unsigned char>(str[pos + 1])) << 8) |
+         uint32_t(static_cast<unsigned char>(str[pos + 2]));
+}
 }  // namespace
 
+void ManagedContainerBase::indexObjectHandle(int objectID,
+                                             const std::string& objectHandle) {
+  const std::string key = Cr::Utility::String::lowercase(objectHandle);
+  for (std::size_t i = 0; i + 3 <= key.length(); ++i) {
+    handleTrigramIndex_[trigramAt(key, i)].insert(objectID);
+  }
+}  // ManagedContainerBase::indexObjectHandle
+
+void ManagedContainerBase::unindexObjectHandle(
+    int objectID,
+    const std::string& objectHandle) {
+  const std::string key = Cr::Utility::String::lowercase(objectHandle);
+  for (std::size_t i = 0; i + 3 <= key.length(); ++i) {
+    auto found = handleTrigramIndex_.find(trigramAt(key, i));
+    if (found == handleTrigramIndex_.end()) {
+      continue;
+    }
+    found->second.erase(objectID);
+    if (found->second.empty()) {
+      handleTrigramIndex_.erase(found);
+    }
+  }
+}  // ManagedContainerBase::unindexObjectHandle
+
+std::vector<std::string> ManagedContainerBase::getObjectHandlesBySubstring(
+    const std::string& subStr,
+    bool contains,
+    bool sorted) const {
+  auto lock = readLockLibrary();
+  // exclusion searches and search strings too short to hold a trigram need to
+  // look at every handle
+  if (!contains || subStr.length() < 3) {
+    return getObjectHandlesBySubStringPerType(objectLibKeyByID_, subStr,
+                                              contains, sorted);
+  }
+  const std::string strToLookFor = Cr::Utility::String::lowercase(subStr);
+  // every match holds all of the search string's trigrams, so only the IDs
+  // under its rarest trigram need to be checked
+  const std::unordered_set<int>* candidates = nullptr;
+  for (std::size_t i = 0; i + 3 <= strToLookFor.length(); ++i) {
+    auto found = handleTrigramIndex_.find(trigramAt(strToLookFor, i));
+    if (found == handleTrigramIndex_.end()) {
+      return {};
+    }
+    if (candidates == nullptr || found->second.size() < candidates->size()) {
+      candidates = &found->second;
+    }
+  }
+  std::vector<std::string> res;
+  res.reserve(candidates->size());
+  for (const int objectID : *candidates) {
+    const std::string& rawKey = objectLibKeyByID_.at(objectID);
+    if (Cr::Utility::String::lowercase(rawKey).find(strToLookFor) !=
+        std::string::npos) {
+      res.emplace_back(rawKey);
+    }
+  }
+  if (sorted) {
+    std::sort(res.begin(), res.end());
+  }
+  return res;
+}  // ManagedContainerBase::getObjectHandlesBySubstring
+
 std::vector<std::string>
 ManagedContainerBase::getObjectHandlesBySubStringPerType(
     const std::unordered_map<int, std::string>& mapOfHandles,
@@ -141,8 +214,8 @@ std::vector<std::string> ManagedContainerBase::getObjectInfoStrings(
     const std::string& subStr,
     bool contains) const {
   // get all handles that match query elements first
-  std::vector<std::string> handles = getHandlesBySubStringPerTypeInternal<1>(
-      objectLibKeyByID_, subStr, contains, true);
+  std::vector<std::string> handles =
+      getObjectHandlesBySubstring(subStr, contains, true);
   std::vector<std::string> res(handles.size() + 1);
   if (handles.empty()) {
     res[0] = "No " + objectType_ + " constructs available.";
@@ -171,20 +244,34 @@ std::vector<std::string> ManagedContainerBase::getObjectInfoStrings(
 int ManagedContainerBase::getObjectIDByHandleOrNew(
     const std::string& objectHandle,
     bool getNext) {
-  if (getObjectLibHasHandle(objectHandle)) {
-    return this->getObjectInternal<AbstractManagedObject>(objectHandle)
-        ->getID();
+  if (getNext) {
+    // allocating an ID modifies the library
+    auto lock = writeLockLibrary();
+    return getObjectIDByHandleOrNewLocked(objectHandle);
   }
-  if (!getNext) {
-    ESP_ERROR(Magnum::Debug::Flag::NoSpace)
-        << "<" << this->objectType_ << "> : No " << objectType_
-        << " managed object with handle " << objectHandle
-        << " exists, so aborting ID query.";
-    return ID_UNDEFINED;
+  {
+    auto lock = readLockLibrary();
+    auto found = objectLibrary_.find(objectHandle);
+    if (found != objectLibrary_.end()) {
+      return static_cast<AbstractManagedObject*>(found->second.get())->getID();
+    }
   }
-  return getUnusedObjectID();
+  ESP_ERROR(Magnum::Debug::Flag::NoSpace)
+      << "<" << this->objectType_ << "> : No " << objectType_
+      << " managed object with handle " << objectHandle
+      << " exists, so aborting ID query.";
+  return ID_UNDEFINED;
 }  // ManagedContainerBase::getObjectIDByHandle
 
+int ManagedContainerBase::getObjectIDByHandleOrNewLocked(
+    const std::string& objectHandle) {
+  auto found = objectLibrary_.find(objectHandle);
+  if (found != objectLibrary_.end()) {
+    return static_cast<AbstractManagedObject*>(found->second.get())->getID();
+  }
+  return getUnusedObjectID();
+}  // ManagedContainerBase::getObjectIDByHandleOrNewLocked
+
 std::string ManagedContainerBase::getObjectInfoCSVString(
     const std::string& subStr,
     bool contains) const {
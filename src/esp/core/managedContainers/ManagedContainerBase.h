@@ -11,10 +11,14 @@
  * esp::core::managedContainers::ManagedContainer to cut down on code bload.
  */
 
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <Corrade/Utility/String.h>
 
@@ -28,6 +32,15 @@ namespace managedContainers {
 /**
  * @brief Base class of Managed Container, holding template-type-independent
  * functionality
+ *
+ * The library maps are guarded by a reader-writer lock, so queries and
+ * retrieval of registered objects can run concurrently from several threads,
+ * also while another thread registers or removes objects. Each query takes the
+ * lock on its own, so a sequence of queries may observe registrations that
+ * happened in between. Objects are replaced rather than modified on
+ * re-registration, so a retrieved object stays valid. Editing a retrieved
+ * object in place, setting defaults and loading configurations are not
+ * synchronized.
  */
 class ManagedContainerBase {
  public:
@@ -103,6 +116,7 @@ class ManagedContainerBase {
    * managed object, or empty string if none found
    */
   std::string getRandomObjectHandle() const {
+    auto lock = readLockLibrary();
     return getRandomObjectHandlePerType(objectLibKeyByID_, "");
   }  // ManagedContainerBase::getRandomObjectHandle
 
@@ -117,6 +131,7 @@ class ManagedContainerBase {
    * @return A valid, unique name to use for a potential managed object.
    */
   std::string getUniqueHandleFromCandidate(const std::string& name) const {
+    auto lock = readLockLibrary();
     return getUniqueHandleFromCandidatePerType(objectLibKeyByID_, name);
   }
 
@@ -126,16 +141,14 @@ class ManagedContainerBase {
    * @param subStr substring key to search for within existing managed objects.
    * @param contains whether to search for keys containing, or excluding,
    * passed @p subStr
+   * @param sorted whether the returned handles should be sorted
    * @return vector of 0 or more managed object handles containing the passed
    * substring
    */
   std::vector<std::string> getObjectHandlesBySubstring(
       const std::string& subStr = "",
       bool contains = true,
-      bool sorted = true) const {
-    return getObjectHandlesBySubStringPerType(objectLibKeyByID_, subStr,
-                                              contains, sorted);
-  }  // ManagedContainerBase::getObjectHandlesBySubstring
+      bool sorted = true) const;
 
   /**
    * @brief returns a vector of managed object handles representing the
@@ -143,6 +156,7 @@ class ManagedContainerBase {
    * managed objects cannot be deleted, although they can be edited.
    */
   std::vector<std::string> getUndeletableObjectHandles() const {
+    auto lock = readLockLibrary();
     std::vector<std::string> res(this->undeletableObjectNames_.begin(),
                                  this->undeletableObjectNames_.end());
     return res;
@@ -154,6 +168,7 @@ class ManagedContainerBase {
    * @return True if handle exists and is undeletable.
    */
   bool getIsUndeletable(const std::string& key) const {
+    auto lock = readLockLibrary();
     return (this->undeletableObjectNames_.count(key) > 0);
   }
 
@@ -164,6 +179,7 @@ class ManagedContainerBase {
    * locked.
    */
   std::vector<std::string> getUserLockedObjectHandles() const {
+    auto lock = readLockLibrary();
     std::vector<std::string> res(this->userLockedObjectNames_.begin(),
                                  this->userLockedObjectNames_.end());
     return res;
@@ -175,6 +191,7 @@ class ManagedContainerBase {
    * @return True if handle exists and is user-locked.
    */
   bool getIsUserLocked(const std::string& key) const {
+    auto lock = readLockLibrary();
     return (this->userLockedObjectNames_.count(key) > 0);
   }
 
@@ -182,11 +199,15 @@ class ManagedContainerBase {
    * @brief clears maps of handle-keyed managed object and ID-keyed handles.
    */
   void reset() {
-    objectLibKeyByID_.clear();
-    objectLibrary_.clear();
-    availableObjectIDs_.clear();
-    undeletableObjectNames_.clear();
-    userLockedObjectNames_.clear();
+    {
+      auto lock = writeLockLibrary();
+      objectLibKeyByID_.clear();
+      handleTrigramIndex_.clear();
+      objectLibrary_.clear();
+      availableObjectIDs_.clear();
+      undeletableObjectNames_.clear();
+      userLockedObjectNames_.clear();
+    }
     resetFinalize();
   }  // ManagedContainerBase::reset
 
@@ -200,15 +221,17 @@ class ManagedContainerBase {
    * objectLibrary_, or nullptr if does not exist.
    */
   std::string getObjectHandleByID(const int objectID) const {
-    auto objKeyByIDIter = objectLibKeyByID_.find(objectID);
-    if (objKeyByIDIter == objectLibKeyByID_.end()) {
-      ESP_ERROR() << "Unknown" << objectType_
-                  << "managed object ID:" << objectID
-                  << ", so unable to retrieve handle.";
-      // never will have registered object with registration handle == ""
-      return "";
+    {
+      auto lock = readLockLibrary();
+      auto objKeyByIDIter = objectLibKeyByID_.find(objectID);
+      if (objKeyByIDIter != objectLibKeyByID_.end()) {
+        return objKeyByIDIter->second;
+      }
     }
-    return objKeyByIDIter->second;
+    ESP_ERROR() << "Unknown" << objectType_ << "managed object ID:" << objectID
+                << ", so unable to retrieve handle.";
+    // never will have registered object with registration handle == ""
+    return "";
   }  // ManagedContainerBase::getObjectHandleByID
 
   /**
@@ -217,7 +240,10 @@ class ManagedContainerBase {
    *
    * @return The size of the @ref objectLibrary_.
    */
-  int getNumObjects() const { return objectLibrary_.size(); }
+  int getNumObjects() const {
+    auto lock = readLockLibrary();
+    return objectLibrary_.size();
+  }
 
   /**
    * @brief Checks whether managed object library has passed string handle as
@@ -225,6 +251,7 @@ class ManagedContainerBase {
    * @param handle the key to look for
    */
   bool getObjectLibHasHandle(const std::string& handle) const {
+    auto lock = readLockLibrary();
     return objectLibrary_.count(handle) > 0;
   }  // ManagedContainerBase::getObjectLibHasHandle
 
@@ -234,6 +261,7 @@ class ManagedContainerBase {
    * @param ID the ID to look for
    */
   bool getObjectLibHasID(int ID) const {
+    auto lock = readLockLibrary();
     return objectLibKeyByID_.count(ID) > 0;
   }  // ManagedContainerBase::getObjectLibHasHandle
 
@@ -271,6 +299,32 @@ class ManagedContainerBase {
 
  protected:
   //======== Internally accessed getter/setter/utilities ================
+  /**
+   * @brief Take the library lock for reading. Held by every query of the
+   * library maps; subclasses reading the maps directly have to hold it too.
+   * Must not be held while calling another locking function of the container.
+   */
+  std::shared_lock<std::shared_timed_mutex> readLockLibrary() const {
+    return std::shared_lock<std::shared_timed_mutex>{libraryMutex_};
+  }
+
+  /**
+   * @brief Take the library lock for writing. Held while modifying any of the
+   * library maps. Must not be held while calling another locking function of
+   * the container.
+   */
+  std::unique_lock<std::shared_timed_mutex> writeLockLibrary() const {
+    return std::unique_lock<std::shared_timed_mutex>{libraryMutex_};
+  }
+
+  /**
+   * @brief Mark the managed object with @p objectHandle as undeletable.
+   */
+  void addUndeletableObjectName(const std::string& objectHandle) {
+    auto lock = writeLockLibrary();
+    undeletableObjectNames_.insert(objectHandle);
+  }
+
   /**
    * @brief Used Internally. Get the ID of the managed object in @ref
    * objectLibrary_ for the given managed object Handle, if exists. If
@@ -286,18 +340,26 @@ class ManagedContainerBase {
    */
   int getObjectIDByHandleOrNew(const std::string& objectHandle, bool getNext);
 
+  /**
+   * @brief Same as @ref getObjectIDByHandleOrNew() with getNext set, for
+   * callers already holding the library lock for writing.
+   */
+  int getObjectIDByHandleOrNewLocked(const std::string& objectHandle);
+
   /**
    * @brief Retrieve shared pointer to object held in library, NOT a copy.
    * @param handle the name of the object held in the smart pointer
    */
   template <class U>
   auto getObjectInternal(const std::string& handle) const {
+    auto lock = readLockLibrary();
     return std::static_pointer_cast<U>(objectLibrary_.at(handle));
   }
 
   /**
    * @brief Only used from class template AddObject method.  put the passed
-   * smart poitner in the library.
+   * smart poitner in the library. Expects the library lock to be held for
+   * writing.
    * @param ptr the smart pointer to the object being managed
    * @param handle the name (key) to use for the object in the library
    */
@@ -337,7 +399,8 @@ class ManagedContainerBase {
 
   /**
    * @brief Used Internally. Get an unused/available ID to be assigned to an
-   * object as it is being added to the library.
+   * object as it is being added to the library. Expects the library lock to
+   * be held for writing.
    * @return The managed object's ID if found. The next available ID if not
    * found and getNext is true. Otherwise ID_UNDEFINED.
    */
@@ -427,14 +490,33 @@ class ManagedContainerBase {
    * @param objectHandle the handle of the object to remove.
    */
   void deleteObjectInternal(int objectID, const std::string& objectHandle) {
-    objectLibKeyByID_.erase(objectID);
-    objectLibrary_.erase(objectHandle);
-    availableObjectIDs_.emplace_front(objectID);
+    {
+      auto lock = writeLockLibrary();
+      if (objectLibKeyByID_.erase(objectID) > 0) {
+        unindexObjectHandle(objectID, objectHandle);
+      }
+      objectLibrary_.erase(objectHandle);
+      availableObjectIDs_.emplace_front(objectID);
+    }
     // call instance-specific delete code to remove managed object handle from
     // any local lists and perform any other manager-specific delete functions.
     deleteObjectInternalFinalize(objectID, objectHandle);
   }  // ManagedContainerBase::deleteObjectInternal
 
+  /**
+   * @brief Add @p objectHandle, registered with @p objectID, to @ref
+   * handleTrigramIndex_. Called whenever a handle is added to @ref
+   * objectLibKeyByID_, with the library lock held for writing.
+   */
+  void indexObjectHandle(int objectID, const std::string& objectHandle);
+
+  /**
+   * @brief Remove @p objectHandle, registered with @p objectID, from @ref
+   * handleTrigramIndex_. Called whenever a handle is removed from @ref
+   * objectLibKeyByID_, with the library lock held for writing.
+   */
+  void unindexObjectHandle(int objectID, const std::string& objectHandle);
+
   /**
    * @brief Any implementation-specific resetting that needs to happen on reset.
    */
@@ -457,6 +539,14 @@ class ManagedContainerBase {
    */
   std::unordered_map<int, std::string> objectLibKeyByID_;
 
+  /**
+   * @brief Maps every 3-character sequence found in the lowercased handles in
+   * @ref objectLibKeyByID_ to the IDs of the handles containing it, so that
+   * substring searches only need to check the handles sharing all of the
+   * search string's trigrams.
+   */
+  std::unordered_map<uint32_t, std::unordered_set<int>> handleTrigramIndex_;
+
   /**
    * @brief Deque holding all IDs of deleted objects. These ID's should be
    * recycled before using map-size-based IDs
@@ -477,6 +567,12 @@ class ManagedContainerBase {
    */
   std::set<std::string> userLockedObjectNames_;
 
+  /**
+   * @brief Reader-writer lock guarding all of the maps and sets above, see
+   * @ref readLockLibrary() and @ref writeLockLibrary()
+   */
+  mutable std::shared_timed_mutex libraryMutex_;
+
  public:
   ESP_SMART_POINTERS(ManagedContainerBase)
 };  // class ManagedContainerBase
@@ -14,13 +14,16 @@
 
 #include "AbstractFileBasedManagedObject.h"
 #include "ManagedContainer.h"
+#include "esp/core/ParallelFor.h"
 #include "esp/io/Json.h"
+#include "esp/io/JsonSnapshot.h"
 
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <typeinfo>
+#include <unordered_map>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -344,6 +347,24 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
       const std::string& srcFilename,
       const std::vector<std::string>& extensions) const;
 
+  /**
+   * @brief Parse the JSON files in @p filenames in parallel and hold on to
+   * the resulting documents, so that subsequent @ref verifyLoadDocument
+   * calls for these files on the owning thread only have to take them
+   * instead of reading and parsing the files themselves. Nothing but the
+   * parsing happens off-thread, so objects are still built and registered
+   * in the order the caller requests them.
+   * @param filenames The JSON files to parse. Files that do not exist are
+   * skipped and left for @ref verifyLoadDocument to report.
+   */
+  void preParseJSONFiles(const std::vector<std::string>& filenames);
+
+  /**
+   * @brief Drop any documents parsed by @ref preParseJSONFiles that were not
+   * consumed.
+   */
+  void clearPreParsedJSONFiles() { preParsedDocuments_.clear(); }
+
   /**
    * @brief Saves @p managedObject to a JSON file using the given @p
    * fileName in the given @p fileDirectory .
@@ -508,6 +529,13 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
    */
   const std::string JSONTypeExt_;
 
+  /**
+   * @brief Documents parsed ahead of time by @ref preParseJSONFiles, keyed by
+   * filename. A null document records a file that failed to parse.
+   */
+  std::unordered_map<std::string, std::unique_ptr<io::JsonDocument>>
+      preParsedDocuments_;
+
  public:
   ESP_SMART_POINTERS(ManagedFileBasedContainer<T, Access>)
 
@@ -582,13 +610,56 @@ std::string ManagedFileBasedContainer<T, Access>::convertFilenameToPassedExt(
   return resHandle;
 }  // ManagedFileBasedContainer<T, Access>::convertFilenameToPassedExt
 
+template <class T, ManagedObjectAccess Access>
+void ManagedFileBasedContainer<T, Access>::preParseJSONFiles(
+    const std::vector<std::string>& filenames) {
+  std::vector<std::unique_ptr<io::JsonDocument>> docs(filenames.size());
+  std::vector<char> parsed(filenames.size(), 0);
+  // the current snapshot is per thread, so look it up before fanning out
+  io::JsonSnapshot* snapshot = io::JsonSnapshot::current();
+  // Only parsing happens on the workers; the parse errors are logged by
+  // io::parseJsonFile itself, the rest is reported by verifyLoadDocument.
+  core::parallelFor(filenames.size(), 0, [&](std::size_t i, int) {
+    if (!Cr::Utility::Path::exists(filenames[i])) {
+      return;
+    }
+    parsed[i] = 1;
+    try {
+      docs[i] = std::make_unique<io::JsonDocument>(
+          snapshot ? snapshot->parseJsonFile(filenames[i])
+                   : io::parseJsonFile(filenames[i]));
+    } catch (...) {
+    }
+  });
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (parsed[i]) {
+      preParsedDocuments_[filenames[i]] = std::move(docs[i]);
+    }
+  }
+}  // ManagedFileBasedContainer<T, Access>::preParseJSONFiles
+
 template <class T, ManagedObjectAccess Access>
 bool ManagedFileBasedContainer<T, Access>::verifyLoadDocument(
     const std::string& filename,
     std::unique_ptr<io::JsonDocument>& jsonDoc) {
+  auto preParsed = preParsedDocuments_.find(filename);
+  if (preParsed != preParsedDocuments_.end()) {
+    jsonDoc = std::move(preParsed->second);
+    preParsedDocuments_.erase(preParsed);
+    if (!jsonDoc) {
+      ESP_ERROR(Mn::Debug::Flag::NoSpace)
+          << "<" << this->objectType_ << "> : Failed to parse `" << filename
+          << "` as JSON.";
+      return false;
+    }
+    return true;
+  }
   if (Cr::Utility::Path::exists(filename)) {
     try {
-      jsonDoc = std::make_unique<io::JsonDocument>(io::parseJsonFile(filename));
+      io::JsonSnapshot* snapshot = io::JsonSnapshot::current();
+      jsonDoc = std::make_unique<io::JsonDocument>(
+          snapshot ? snapshot->parseJsonFile(filename)
+                   : io::parseJsonFile(filename));
     } catch (...) {
       ESP_ERROR(Mn::Debug::Flag::NoSpace)
           << "<" << this->objectType_ << "> : Failed to parse `" << filename
@@ -4,14 +4,30 @@
 
 #include "esp/geo/Geo.h"
 
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Reference.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/MeshTools/Concatenate.h>
 #include <Magnum/Primitives/Circle.h>
 #include <Magnum/Trade/MeshData.h>
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
+#include "esp/core/Check.h"
+#include "esp/core/ParallelFor.h"
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#elif defined(CORRADE_TARGET_SIMD128)
+#include <wasm_simd128.h>
+#endif
+
 namespace Mn = Magnum;
 namespace Cr = Corrade;
 using Magnum::Math::Literals::operator""_rgb;
@@ -125,6 +141,80 @@ Mn::Range3D getTransformedBB(const Mn::Range3D& range,
   return Mn::Range3D::fromCenter(newCenter, newExtent);
 }
 
+void getTransformedBBs(Cr::Containers::ArrayView<const Mn::Range3D> ranges,
+                       Cr::Containers::ArrayView<const Mn::Matrix4> xforms,
+                       Cr::Containers::ArrayView<Mn::Range3D> out) {
+  CORRADE_ASSERT(xforms.size() == ranges.size() && out.size() == ranges.size(),
+                 "geo::getTransformedBBs(): expected" << ranges.size()
+                     << "transforms and outputs but got" << xforms.size()
+                     << "and" << out.size(), );
+  for (std::size_t i = 0; i != ranges.size(); ++i) {
+#if defined(CORRADE_TARGET_SSE2) || defined(CORRADE_TARGET_NEON) || \
+    defined(CORRADE_TARGET_SIMD128)
+    // Same as getTransformedBB(), with the four lanes of a register holding a
+    // matrix column. The last lane is unused.
+    const Mn::Vector3 center = ranges[i].center();
+    const Mn::Vector3 extent = ranges[i].size() / 2.0;
+    const float* m = xforms[i].data();
+    alignas(16) float newMin[4];
+    alignas(16) float newMax[4];
+#if defined(CORRADE_TARGET_SSE2)
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+    // the absolute value clears the sign bit
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 newCenter = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(center.x())),
+                   _mm_mul_ps(c1, _mm_set1_ps(center.y()))),
+        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(center.z())), c3));
+    const __m128 newExtent = _mm_add_ps(
+        _mm_add_ps(
+            _mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_set1_ps(extent.x())),
+            _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_set1_ps(extent.y()))),
+        _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_set1_ps(extent.z())));
+    _mm_store_ps(newMin, _mm_sub_ps(newCenter, newExtent));
+    _mm_store_ps(newMax, _mm_add_ps(newCenter, newExtent));
+#elif defined(CORRADE_TARGET_NEON)
+    const float32x4_t c0 = vld1q_f32(m);
+    const float32x4_t c1 = vld1q_f32(m + 4);
+    const float32x4_t c2 = vld1q_f32(m + 8);
+    const float32x4_t c3 = vld1q_f32(m + 12);
+    const float32x4_t newCenter = vmlaq_n_f32(
+        vmlaq_n_f32(vmlaq_n_f32(c3, c0, center.x()), c1, center.y()), c2,
+        center.z());
+    const float32x4_t newExtent =
+        vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vabsq_f32(c0), extent.x()),
+                                vabsq_f32(c1), extent.y()),
+                    vabsq_f32(c2), extent.z());
+    vst1q_f32(newMin, vsubq_f32(newCenter, newExtent));
+    vst1q_f32(newMax, vaddq_f32(newCenter, newExtent));
+#else
+    const v128_t c0 = wasm_v128_load(m);
+    const v128_t c1 = wasm_v128_load(m + 4);
+    const v128_t c2 = wasm_v128_load(m + 8);
+    const v128_t c3 = wasm_v128_load(m + 12);
+    const v128_t newCenter = wasm_f32x4_add(
+        wasm_f32x4_add(wasm_f32x4_mul(c0, wasm_f32x4_splat(center.x())),
+                       wasm_f32x4_mul(c1, wasm_f32x4_splat(center.y()))),
+        wasm_f32x4_add(wasm_f32x4_mul(c2, wasm_f32x4_splat(center.z())), c3));
+    const v128_t newExtent = wasm_f32x4_add(
+        wasm_f32x4_add(
+            wasm_f32x4_mul(wasm_f32x4_abs(c0), wasm_f32x4_splat(extent.x())),
+            wasm_f32x4_mul(wasm_f32x4_abs(c1), wasm_f32x4_splat(extent.y()))),
+        wasm_f32x4_mul(wasm_f32x4_abs(c2), wasm_f32x4_splat(extent.z())));
+    wasm_v128_store(newMin, wasm_f32x4_sub(newCenter, newExtent));
+    wasm_v128_store(newMax, wasm_f32x4_add(newCenter, newExtent));
+#endif
+    out[i] = {{newMin[0], newMin[1], newMin[2]},
+              {newMax[0], newMax[1], newMax[2]}};
+#else
+    out[i] = getTransformedBB(ranges[i], xforms[i]);
+#endif
+  }
+}
+
 float calcWeightedDistance(const Mn::Vector3& a,
                            const Mn::Vector3& b,
                            float alpha) {
@@ -265,77 +355,72 @@ Mn::Color3ub convertInterpClrVecToUBClr(const Mn::Vector3& clrVec,
   return resClr;
 }  // convertInterpClrVecToUBClr
 
-}  // namespace
-
-Mn::Trade::MeshData buildTrajectoryTubeSolid(
-    const std::vector<Mn::Vector3>& pts,
-    const std::vector<Mn::Color3>& interpColors,
-    int numSegments,
-    float radius,
-    bool smooth,
-    int numInterp,
-    ColorSpace clrSpace) {
-  // 1. Build smoothed trajectory through passed points if requested
-  // points in trajectory
-  // A centripetal CR spline (alpha == .5) will not have cusps, while remaining
-  // true to underlying key point trajectory.
-  float alpha = .5;
-  std::vector<Mn::Vector3> trajectory =
-      smooth ? buildCatmullRomTrajOfPoints(pts, numInterp, alpha) : pts;
-
-  // size of trajectory
-  const Mn::UnsignedInt trajSize = trajectory.size();
-
-  // 2. Build list of interpolating colors for each ring of trajectory.
-  // want to evenly interpolate between colors provided
-  const Mn::UnsignedInt numColors = interpColors.size();
-  std::vector<Mn::Vector3> trajColors;
-
-  if (numColors == 1) {
-    trajColors.reserve(trajSize);
-    // with only 1 color, just make duplicates of color for every trajectory
-    // point/vertex
-    for (const auto& pt : trajectory) {
-      trajColors.emplace_back(
-          convertClrToInterpClrVector(interpColors[0], clrSpace));
-    }
+// a circle of tube vertices of the given radius around the Z axis, and their
+// normals
+struct TubeCircle {
+  Cr::Containers::Array<Mn::Vector3> verts;
+  Cr::Containers::Array<Mn::Vector3> normals;
+};
 
-  } else {
-    // interpolate in hsv space - first convert src colors to HSV
-    std::vector<Mn::Vector3> srcClrs;
-    srcClrs.reserve(numColors);
-    for (const auto& clr : interpColors) {
-      srcClrs.emplace_back(convertClrToInterpClrVector(clr, clrSpace));
-    }
-    // determine how many interpolations we should have : trajColors should be
-    // trajSize in size
-    int numClrInterp = (trajSize / (numColors - 1)) + 1;
-    // now build interpolated vector of colors
-    trajColors = buildCatmullRomTrajOfPoints(srcClrs, numClrInterp, alpha);
-    // fill end of trajColors array with final color if smaller than size of
-    // trajectory
-    while (trajColors.size() < trajSize) {
-      trajColors.push_back(trajColors.back());
-    }
-  }
-
-  // 3. Build mesh vertex points around each trajectory point at appropriate
-  // distance (radius). For each point in trajectory, add a wireframe circle
-  // centered at that point, appropriately oriented based on tangents
-
-  Cr::Containers::Array<Magnum::Vector3> circleVerts =
+TubeCircle buildTubeCircle(int numSegments, float radius) {
+  TubeCircle circle;
+  circle.verts =
       Mn::Primitives::circle3DWireframe(numSegments).positions3DAsArray();
   // normalized verts will provide vert normals.
-  Cr::Containers::Array<Magnum::Vector3> circleNormVerts{
-      Cr::NoInit, sizeof(Magnum::Vector3) * numSegments};
-
+  circle.normals =
+      Cr::Containers::Array<Mn::Vector3>{Cr::NoInit, std::size_t(numSegments)};
   // transform points to be on circle of given radius, and make copy to
   // normalize points
   for (int i = 0; i < numSegments; ++i) {
-    circleVerts[i] *= radius;
-    circleNormVerts[i] = circleVerts[i].normalized();
+    circle.verts[i] *= radius;
+    circle.normals[i] = circle.verts[i].normalized();
   }
+  return circle;
+}
 
+// the orientation of the tube ring around the idx-th trajectory point,
+// following the tangent of the trajectory
+Mn::Matrix4 tubeRingOrientation(const std::vector<Mn::Vector3>& trajectory,
+                                std::size_t idx) {
+  const std::size_t lastIdx = trajectory.size() - 1;
+  Mn::Vector3 tangent;
+  if (idx == 0) {
+    tangent = trajectory[1] - trajectory[0];
+  } else if (idx == lastIdx) {
+    tangent = trajectory[lastIdx] - trajectory[lastIdx - 1];
+  } else {
+    const Mn::Vector3 pTangent = trajectory[idx] - trajectory[idx - 1];
+    const Mn::Vector3 nTangent = trajectory[idx + 1] - trajectory[idx];
+    tangent = (pTangent + nTangent) / 2.0;
+  }
+  // get the orientation matrix assuming y-up preference
+  return Mn::Matrix4::lookAt(trajectory[idx], trajectory[idx] + tangent,
+                             Mn::Vector3{0, 1.0, 0});
+}
+
+// transform the circle into the ring of a tube, writing circle.verts.size()
+// positions and normals
+void buildTubeRing(const TubeCircle& circle,
+                   const Mn::Matrix4& orientation,
+                   Mn::Vector3* positions,
+                   Mn::Vector3* normals) {
+  for (std::size_t i = 0; i < circle.verts.size(); ++i) {
+    // build vertex (circle.verts[i] is at radius)
+    positions[i] = orientation.transformPoint(circle.verts[i]);
+    // pre-rotated normal for circle is normalized point
+    normals[i] = orientation.transformVector(circle.normals[i]);
+  }
+}
+
+// build the mesh of a tube from the rings around each trajectory point,
+// adding end caps
+Mn::Trade::MeshData buildTubeMeshData(
+    const std::vector<Mn::Vector3>& trajectory,
+    const std::vector<Mn::Vector3>& ringPositions,
+    const std::vector<Mn::Vector3>& ringNormals,
+    const std::vector<Mn::Color3ub>& ringColors,
+    Mn::UnsignedInt numSegments) {
+  const Mn::UnsignedInt trajSize = trajectory.size();
   // # of vertices in resultant tube == # circle verts * # points in trajectory
   const Mn::UnsignedInt vertexCount = numSegments * trajSize + 2;
   // a function-local struct representing a vertex
@@ -360,75 +445,26 @@ Mn::Trade::MeshData buildTrajectoryTubeSolid(
   Cr::Containers::StridedArrayView1D<Mn::Color3ub> colors =
       vertices.slice(&Vertex::color);
 
-  // Beginning Endcap
-  Mn::UnsignedInt circlePtIDX = 0;
-  Mn::Vector3 tangent = trajectory[1] - trajectory[0];
-  // get the orientation matrix assuming y-up preference
-  Mn::Matrix4 tangentOrientation = Mn::Matrix4::lookAt(
-      trajectory[0], trajectory[0] + tangent, Mn::Vector3{0, 1.0, 0});
-  for (int i = 0; i < numSegments; ++i) {
-    // build vertex (circleVerts[i] is at radius)
-    positions[circlePtIDX] = tangentOrientation.transformPoint(circleVerts[i]);
-    // pre-rotated normal for circle is normalized point
-    normals[circlePtIDX] =
-        tangentOrientation.transformVector(circleNormVerts[i]);
-    colors[circlePtIDX] = convertInterpClrVecToUBClr(trajColors[0], clrSpace);
-    ++circlePtIDX;
+  for (Mn::UnsignedInt ix = 0; ix < numSegments * trajSize; ++ix) {
+    positions[ix] = ringPositions[ix];
+    normals[ix] = ringNormals[ix];
+    colors[ix] = ringColors[ix / numSegments];
   }
+
   // add beginning cap vert at the end of the list
-  // build vertex (circleVerts[i] is at radius)
+  const Mn::UnsignedInt idx = trajSize - 1;
   positions[vertexCount - 2] = trajectory[0];
   // normal points out at beginning cap vert
-  normals[vertexCount - 2] =
-      tangentOrientation.transformVector({0.0f, 0.0f, -1.0f});
-  colors[vertexCount - 2] = convertInterpClrVecToUBClr(trajColors[0], clrSpace);
-
-  for (Mn::UnsignedInt vertIx = 1; vertIx < trajSize - 1; ++vertIx) {
-    const Mn::Vector3& vert = trajectory[vertIx];
-    Mn::Vector3 pTangent = vert - trajectory[vertIx - 1];
-    Mn::Vector3 nTangent = trajectory[vertIx + 1] - vert;
-    tangent = (pTangent + nTangent) / 2.0;
-    // get the orientation matrix assuming y-up preference
-    tangentOrientation =
-        Mn::Matrix4::lookAt(vert, vert + tangent, Mn::Vector3{0, 1.0, 0});
-    for (int i = 0; i < numSegments; ++i) {
-      // build vertex (circleVerts[i] is at radius)
-      positions[circlePtIDX] =
-          tangentOrientation.transformPoint(circleVerts[i]);
-      // pre-rotated normal for circle is normalized point
-      normals[circlePtIDX] =
-          tangentOrientation.transformVector(circleNormVerts[i]);
-      colors[circlePtIDX] =
-          convertInterpClrVecToUBClr(trajColors[vertIx], clrSpace);
-      ++circlePtIDX;
-    }
-  }
-
-  // Ending Endcap
-  int idx = trajSize - 1;
-  tangent = trajectory[idx] - trajectory[idx - 1];
-  // get the orientation matrix assuming y-up preference
-  tangentOrientation = Mn::Matrix4::lookAt(
-      trajectory[idx], trajectory[idx] + tangent, Mn::Vector3{0, 1.0, 0});
-  for (int i = 0; i < numSegments; ++i) {
-    // build vertex (circleVerts[i] is at radius)
-    positions[circlePtIDX] = tangentOrientation.transformPoint(circleVerts[i]);
-    // pre-rotated normal for circle is normalized point
-    normals[circlePtIDX] =
-        tangentOrientation.transformVector(circleNormVerts[i]);
-    colors[circlePtIDX] = convertInterpClrVecToUBClr(trajColors[idx], clrSpace);
-    ++circlePtIDX;
-  }
+  normals[vertexCount - 2] = tubeRingOrientation(trajectory, 0)
+                                 .transformVector({0.0f, 0.0f, -1.0f});
+  colors[vertexCount - 2] = ringColors[0];
   // add end cap vert
-  // build vertex (circleVerts[i] is at radius)
   positions[vertexCount - 1] = trajectory[idx];
   // normal points out at end cap vert
-  normals[vertexCount - 1] =
-      tangentOrientation.transformVector({0.0f, 0.0f, 1.0f});
-  colors[vertexCount - 1] =
-      convertInterpClrVecToUBClr(trajColors[idx], clrSpace);
+  normals[vertexCount - 1] = tubeRingOrientation(trajectory, idx)
+                                 .transformVector({0.0f, 0.0f, 1.0f});
+  colors[vertexCount - 1] = ringColors[idx];
 
-  // 4. Create polys between all points
   Cr::Containers::Array<char> indexData{
       Cr::NoInit, 6 * numSegments * trajSize * sizeof(Mn::UnsignedInt)};
   Cr::Containers::ArrayView<Mn::UnsignedInt> indices =
@@ -505,8 +541,194 @@ Mn::Trade::MeshData buildTrajectoryTubeSolid(
       static_cast<Mn::UnsignedInt>(positions.size())};
 
   return meshData;
+}  // buildTubeMeshData
+
+}  // namespace
+
+Mn::Trade::MeshData buildTrajectoryTubeSolid(
+    const std::vector<Mn::Vector3>& pts,
+    const std::vector<Mn::Color3>& interpColors,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp,
+    ColorSpace clrSpace) {
+  // 1. Build smoothed trajectory through passed points if requested
+  // points in trajectory
+  // A centripetal CR spline (alpha == .5) will not have cusps, while remaining
+  // true to underlying key point trajectory.
+  float alpha = .5;
+  std::vector<Mn::Vector3> trajectory =
+      smooth ? buildCatmullRomTrajOfPoints(pts, numInterp, alpha) : pts;
+
+  // size of trajectory
+  const Mn::UnsignedInt trajSize = trajectory.size();
+
+  // 2. Build list of interpolating colors for each ring of trajectory.
+  // want to evenly interpolate between colors provided
+  const Mn::UnsignedInt numColors = interpColors.size();
+  std::vector<Mn::Vector3> trajColors;
+
+  if (numColors == 1) {
+    trajColors.reserve(trajSize);
+    // with only 1 color, just make duplicates of color for every trajectory
+    // point/vertex
+    for (const auto& pt : trajectory) {
+      trajColors.emplace_back(
+          convertClrToInterpClrVector(interpColors[0], clrSpace));
+    }
+
+  } else {
+    // interpolate in hsv space - first convert src colors to HSV
+    std::vector<Mn::Vector3> srcClrs;
+    srcClrs.reserve(numColors);
+    for (const auto& clr : interpColors) {
+      srcClrs.emplace_back(convertClrToInterpClrVector(clr, clrSpace));
+    }
+    // determine how many interpolations we should have : trajColors should be
+    // trajSize in size
+    int numClrInterp = (trajSize / (numColors - 1)) + 1;
+    // now build interpolated vector of colors
+    trajColors = buildCatmullRomTrajOfPoints(srcClrs, numClrInterp, alpha);
+    // fill end of trajColors array with final color if smaller than size of
+    // trajectory
+    while (trajColors.size() < trajSize) {
+      trajColors.push_back(trajColors.back());
+    }
+  }
+
+  // 3. Build mesh vertex points around each trajectory point at appropriate
+  // distance (radius). For each point in trajectory, add a wireframe circle
+  // centered at that point, appropriately oriented based on tangents
+  const TubeCircle circle = buildTubeCircle(numSegments, radius);
+  std::vector<Mn::Vector3> ringPositions(numSegments * trajSize);
+  std::vector<Mn::Vector3> ringNormals(numSegments * trajSize);
+  std::vector<Mn::Color3ub> ringColors;
+  ringColors.reserve(trajSize);
+  for (Mn::UnsignedInt vertIx = 0; vertIx < trajSize; ++vertIx) {
+    buildTubeRing(circle, tubeRingOrientation(trajectory, vertIx),
+                  &ringPositions[vertIx * numSegments],
+                  &ringNormals[vertIx * numSegments]);
+    ringColors.push_back(
+        convertInterpClrVecToUBClr(trajColors[vertIx], clrSpace));
+  }
+
+  // 4. Create polys between all points, and the end caps
+  return buildTubeMeshData(trajectory, ringPositions, ringNormals, ringColors,
+                           numSegments);
 }  // buildTrajectoryTubeSolid
 
+Mn::Trade::MeshData buildTrajectoryTubesSolid(
+    const std::vector<std::vector<Mn::Vector3>>& trajectories,
+    const std::vector<std::vector<Mn::Color3>>& interpColors,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp,
+    ColorSpace clrSpace,
+    int numThreads) {
+  ESP_CHECK(!trajectories.empty(),
+            "buildTrajectoryTubesSolid(): expected at least one trajectory");
+  ESP_CHECK(interpColors.size() == 1 ||
+                interpColors.size() == trajectories.size(),
+            "buildTrajectoryTubesSolid(): expected one or"
+                << trajectories.size() << "lists of colors but got"
+                << interpColors.size());
+  // the tubes are independent, so they are built in parallel and then
+  // concatenated into one mesh
+  std::vector<Cr::Containers::Optional<Mn::Trade::MeshData>> tubes(
+      trajectories.size());
+  core::parallelFor(trajectories.size(), numThreads, [&](std::size_t i, int) {
+    tubes[i] = buildTrajectoryTubeSolid(
+        trajectories[i], interpColors[interpColors.size() == 1 ? 0 : i],
+        numSegments, radius, smooth, numInterp, clrSpace);
+  });
+
+  Cr::Containers::Array<Cr::Containers::Reference<const Mn::Trade::MeshData>>
+      tubeViews;
+  Cr::Containers::arrayReserve(tubeViews, tubes.size());
+  for (const auto& tube : tubes) {
+    arrayAppend(tubeViews, *tube);
+  }
+  return Mn::MeshTools::concatenate(tubeViews);
+}  // buildTrajectoryTubesSolid
+
+TrajectoryTubeBuilder::TrajectoryTubeBuilder(const Mn::Color3& color,
+                                             int numSegments,
+                                             float radius,
+                                             bool smooth,
+                                             int numInterp,
+                                             ColorSpace clrSpace)
+    // same conversion as buildTrajectoryTubeSolid() does for a single color
+    : color_{convertInterpClrVecToUBClr(
+          convertClrToInterpClrVector(color, clrSpace),
+          clrSpace)},
+      numSegments_{numSegments},
+      radius_{radius},
+      smooth_{smooth},
+      numInterp_{numInterp} {}
+
+void TrajectoryTubeBuilder::append(const std::vector<Mn::Vector3>& pts) {
+  const std::size_t oldKeyCount = keyPoints_.size();
+  for (const Mn::Vector3& pt : pts) {
+    if (keyPoints_.empty() || pt != keyPoints_.back()) {
+      keyPoints_.push_back(pt);
+    }
+  }
+  regeneratedRingCount_ = 0;
+  if (keyPoints_.size() < 2 || keyPoints_.size() == oldKeyCount) {
+    return;
+  }
+
+  // 1. Keep the trajectory points that don't depend on the new key points
+  // and extend the trajectory from there
+  std::size_t keptCount = 0;
+  if (!smooth_) {
+    keptCount = oldKeyCount;
+    trajectory_ = keyPoints_;
+  } else if (oldKeyCount < 3) {
+    trajectory_ = buildCatmullRomTrajOfPoints(keyPoints_, numInterp_, .5f);
+  } else {
+    // spline segment i between key points i and i + 1 depends on key points
+    // i - 1 to i + 2, with a ghost point past the end. So the last old
+    // segment changes, the ones before it don't.
+    const std::size_t firstSegment = oldKeyCount - 2;
+    keptCount = firstSegment * numInterp_;
+    trajectory_.resize(keptCount);
+    // the spline restarted one key point earlier matches the full spline
+    // from the second segment on, its first one uses a ghost point instead
+    const std::vector<Mn::Vector3> tailKeyPoints(
+        keyPoints_.begin() + firstSegment - 1, keyPoints_.end());
+    const std::vector<Mn::Vector3> tail =
+        buildCatmullRomTrajOfPoints(tailKeyPoints, numInterp_, .5f);
+    trajectory_.insert(trajectory_.end(), tail.begin() + numInterp_,
+                       tail.end());
+  }
+
+  // 2. Regenerate the rings whose tangent changed, which is the one around
+  // the last kept point, and the new ones
+  const std::size_t firstRing = keptCount > 0 ? keptCount - 1 : 0;
+  const TubeCircle circle = buildTubeCircle(numSegments_, radius_);
+  ringPositions_.resize(trajectory_.size() * numSegments_);
+  ringNormals_.resize(trajectory_.size() * numSegments_);
+  for (std::size_t i = firstRing; i < trajectory_.size(); ++i) {
+    buildTubeRing(circle, tubeRingOrientation(trajectory_, i),
+                  &ringPositions_[i * numSegments_],
+                  &ringNormals_[i * numSegments_]);
+  }
+  regeneratedRingCount_ = trajectory_.size() - firstRing;
+}
+
+Mn::Trade::MeshData TrajectoryTubeBuilder::mesh() const {
+  ESP_CHECK(keyPoints_.size() >= 2,
+            "TrajectoryTubeBuilder::mesh(): expected at least two distinct "
+            "points but got"
+                << keyPoints_.size());
+  const std::vector<Mn::Color3ub> ringColors(trajectory_.size(), color_);
+  return buildTubeMeshData(trajectory_, ringPositions_, ringNormals_,
+                           ringColors, numSegments_);
+}
+
 namespace {
 // TODO remove when/if Magnum ever supports this function for Color3ub
 constexpr const char Hex[]{"0123456789abcdef"};
@@ -546,6 +768,65 @@ std::vector<std::set<uint32_t>> buildAdjList(
 
 }  // buildAdjList
 
+CsrAdjList buildCsrAdjList(int numVerts,
+                           const std::vector<uint32_t>& indexBuffer,
+                           int numThreads) {
+  CsrAdjList adjList;
+  // count the neighbors of each vert, every vert of a triangle gets two
+  adjList.offsets.assign(numVerts + 1, 0);
+  const std::size_t numTriIndices = indexBuffer.size() - indexBuffer.size() % 3;
+  for (std::size_t i = 0; i != numTriIndices; ++i) {
+    adjList.offsets[indexBuffer[i] + 1] += 2;
+  }
+  std::partial_sum(adjList.offsets.begin(), adjList.offsets.end(),
+                   adjList.offsets.begin());
+
+  // scatter the triangle edges into the rows
+  adjList.neighbors.resize(adjList.offsets.back());
+  std::vector<std::size_t> cursors(adjList.offsets.begin(),
+                                   adjList.offsets.end() - 1);
+  for (std::size_t i = 0; i != numTriIndices; i += 3) {
+    const uint32_t idx0 = indexBuffer[i];
+    const uint32_t idx1 = indexBuffer[i + 1];
+    const uint32_t idx2 = indexBuffer[i + 2];
+    adjList.neighbors[cursors[idx0]++] = idx1;
+    adjList.neighbors[cursors[idx0]++] = idx2;
+    adjList.neighbors[cursors[idx1]++] = idx0;
+    adjList.neighbors[cursors[idx1]++] = idx2;
+    adjList.neighbors[cursors[idx2]++] = idx0;
+    adjList.neighbors[cursors[idx2]++] = idx1;
+  }
+
+  // sort and deduplicate the rows independently, with the new row sizes
+  // stored in the cursors
+  constexpr std::size_t VertsPerChunk = 1 << 14;
+  const std::size_t numChunks = (numVerts + VertsPerChunk - 1) / VertsPerChunk;
+  core::parallelFor(numChunks, numThreads, [&](std::size_t chunk, int) {
+    const std::size_t end =
+        std::min(std::size_t(numVerts), (chunk + 1) * VertsPerChunk);
+    for (std::size_t vIDX = chunk * VertsPerChunk; vIDX != end; ++vIDX) {
+      auto rowBegin = adjList.neighbors.begin() + adjList.offsets[vIDX];
+      auto rowEnd = adjList.neighbors.begin() + adjList.offsets[vIDX + 1];
+      std::sort(rowBegin, rowEnd);
+      cursors[vIDX] = std::unique(rowBegin, rowEnd) - rowBegin;
+    }
+  });
+
+  // compact the rows
+  std::size_t numNeighbors = 0;
+  for (int vIDX = 0; vIDX < numVerts; ++vIDX) {
+    const std::size_t rowBegin = adjList.offsets[vIDX];
+    adjList.offsets[vIDX] = numNeighbors;
+    std::copy_n(adjList.neighbors.begin() + rowBegin, cursors[vIDX],
+                adjList.neighbors.begin() + numNeighbors);
+    numNeighbors += cursors[vIDX];
+  }
+  adjList.offsets[numVerts] = numNeighbors;
+  adjList.neighbors.resize(numNeighbors);
+  adjList.neighbors.shrink_to_fit();
+  return adjList;
+}  // buildCsrAdjList
+
 uint32_t getValueAsUInt(const Mn::Color3ub& color) {
   return (unsigned(color[0]) << 16) | (unsigned(color[1]) << 8) |
          unsigned(color[2]);
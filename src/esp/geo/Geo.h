@@ -5,6 +5,8 @@
 #ifndef ESP_GEO_GEO_H_
 #define ESP_GEO_GEO_H_
 
+#include <cstddef>
+#include <numeric>
 #include <set>
 #include <typeinfo>
 #include <unordered_map>
@@ -13,6 +15,8 @@
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Color.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/Trade.h>
 
@@ -68,6 +72,21 @@ std::vector<vec2f> convexHull2D(const std::vector<vec2f>& points);
 Magnum::Range3D getTransformedBB(const Magnum::Range3D& range,
                                  const Magnum::Matrix4& xform);
 
+/**
+ * @brief Batched @ref getTransformedBB() for many bounding boxes
+ *
+ * @param ranges The initial axis-aligned bounding boxes.
+ * @param xforms The transform to apply to each box.
+ * @param[out] out The resulting boxes. May be the same memory as @p ranges.
+ *
+ * Transforms each box with SSE2, NEON or WebAssembly SIMD if the target
+ * supports it, with one matrix column per vector register, and with
+ * @ref getTransformedBB() otherwise.
+ */
+void getTransformedBBs(Cr::Containers::ArrayView<const Magnum::Range3D> ranges,
+                       Cr::Containers::ArrayView<const Magnum::Matrix4> xforms,
+                       Cr::Containers::ArrayView<Magnum::Range3D> out);
+
 /**
  * @brief Return a vector of L2/Euclidean distances of points along a
  * trajectory. First point will always be 0, and last point will give length of
@@ -157,6 +176,97 @@ Mn::Trade::MeshData buildTrajectoryTubeSolid(
     int numInterp,
     ColorSpace clrSpace = ColorSpace::HSV);
 
+/**
+ * @brief Build a single mesh holding a tube around each of the passed
+ * trajectories, so they all are drawn with one draw call.
+ * @param trajectories The key points of each trajectory, in order
+ * @param interpColors The colors of each trajectory, see
+ * @ref buildTrajectoryTubeSolid(). If there is only one list of colors, it is
+ * used for all trajectories.
+ * @param numSegments The number of segments around the circumference of the
+ * tubes.
+ * @param radius The radius of the tubes
+ * @param smooth Whether to smooth the points or not
+ * @param numInterp The number of interpolations between each trajectory
+ * point, if smoothing
+ * @param clrSpace The color space to interpolate the given colrs in
+ * @param numThreads The number of threads building the tubes, see
+ * @ref core::resolveNumThreads().
+ * @return The meshes of all tubes, concatenated
+ */
+Mn::Trade::MeshData buildTrajectoryTubesSolid(
+    const std::vector<std::vector<Mn::Vector3>>& trajectories,
+    const std::vector<std::vector<Mn::Color3>>& interpColors,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp,
+    ColorSpace clrSpace = ColorSpace::HSV,
+    int numThreads = 1);
+
+/**
+ * @brief Builds the tube of @ref buildTrajectoryTubeSolid() around a growing
+ * trajectory of a single color, regenerating only its tail.
+ *
+ * Appending points only changes the rings of the tube around the end of the
+ * trajectory, so an agent path can be visualized as it is recorded without
+ * rebuilding the whole tube each step. The resulting mesh is the same as the
+ * one of @ref buildTrajectoryTubeSolid() for all points appended so far.
+ */
+class TrajectoryTubeBuilder {
+ public:
+  /**
+   * @brief Constructor
+   * @param color The color of the tube
+   * @param numSegments The number of segments around the circumference of the
+   * tube.
+   * @param radius The radius of the tube
+   * @param smooth Whether to smooth the points or not
+   * @param numInterp The number of interpolations between each trajectory
+   * point, if smoothing
+   * @param clrSpace The color space of the tube color, see
+   * @ref buildTrajectoryTubeSolid()
+   */
+  explicit TrajectoryTubeBuilder(const Mn::Color3& color,
+                                 int numSegments,
+                                 float radius,
+                                 bool smooth,
+                                 int numInterp,
+                                 ColorSpace clrSpace = ColorSpace::HSV);
+
+  /**
+   * @brief Append key points to the trajectory. Points repeating the
+   * previous point are skipped.
+   */
+  void append(const std::vector<Mn::Vector3>& pts);
+
+  //! The number of key points in the trajectory
+  std::size_t pointCount() const { return keyPoints_.size(); }
+
+  //! The number of tube rings generated by the last @ref append()
+  std::size_t regeneratedRingCount() const { return regeneratedRingCount_; }
+
+  /**
+   * @brief The mesh of the tube. Expects at least two distinct key points.
+   */
+  Mn::Trade::MeshData mesh() const;
+
+  ESP_SMART_POINTERS(TrajectoryTubeBuilder)
+
+ private:
+  Mn::Color3ub color_;
+  int numSegments_;
+  float radius_;
+  bool smooth_;
+  int numInterp_;
+  std::vector<Mn::Vector3> keyPoints_;
+  std::vector<Mn::Vector3> trajectory_;
+  //! numSegments_ positions and normals for each trajectory point
+  std::vector<Mn::Vector3> ringPositions_;
+  std::vector<Mn::Vector3> ringNormals_;
+  std::size_t regeneratedRingCount_ = 0;
+};
+
 /**
  * @brief Returns a nicely formatted hex string representation of @p color.
  * @param color Color to build string from.
@@ -291,6 +401,118 @@ findCCsByGivenColor(const std::vector<std::set<uint32_t>>& adjList,
   return clrsToComponents;
 }  // findCCsByGivenColor
 
+/**
+ * @brief Per-vertex adjacency of a mesh in compressed sparse row form. The
+ * verts adjacent to vert `i` are @ref neighbors from index `offsets[i]` up to
+ * but not including `offsets[i + 1]`, sorted and without duplicates.
+ */
+struct CsrAdjList {
+  //! Start of each vert's neighbors in @ref neighbors, plus the total count.
+  std::vector<std::size_t> offsets;
+  //! Indices of adjacent verts.
+  std::vector<uint32_t> neighbors;
+
+  //! Number of verts in the adjacency list.
+  std::size_t numVerts() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+};
+
+/**
+ * @brief Build a @ref CsrAdjList using the passed index buffer. Assumes each
+ * sequence of 3 indices describes a poly.
+ *
+ * Equivalent to @ref buildAdjList(), but stores all neighbors in two flat
+ * arrays instead of a set per vertex. The neighbors are counted first so the
+ * arrays are allocated once, each vertex's neighbors are then sorted on up to
+ * @p numThreads threads, see @ref core::resolveNumThreads().
+ * @param numVerts Number of verts found in mesh.
+ * @param indexBuffer Index buffer.
+ * @param numThreads Number of threads sorting the neighbors.
+ */
+CsrAdjList buildCsrAdjList(int numVerts,
+                           const std::vector<uint32_t>& indexBuffer,
+                           int numThreads = 0);
+
+/**
+ * @brief Find and return all connected components in a graph (represented by
+ * the @p adjList ), that match some specified per-vertex tag/"color".
+ *
+ * Gives the same result as the @ref findCCsByGivenColor() overload taking a
+ * set-based adjacency list, but merges the verts of same-colored edges with a
+ * union-find instead of a recursive DFS, so it doesn't overflow the stack on
+ * large components.
+ * @tparam The type of the CC conditioning variable.
+ * @param adjList The mesh's per-vertex adjacency, see @ref buildCsrAdjList().
+ * @param clrVec A reference to the per-vertex identifiers used to condition
+ * the CC (not necessarily a color).
+ * @return an unordered map, keyed by tag/color value encoded as int, where
+ * the value is a vector of all sets of CCs consisting of verts with specified
+ * tag/"color".
+ */
+template <class T>
+std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
+findCCsByGivenColor(const CsrAdjList& adjList, const std::vector<T>& clrVec) {
+  const uint32_t numVerts = adjList.numVerts();
+  // Union-find where the root of every set is its smallest vert, so the
+  // components are found in the same order as by the DFS-based version
+  std::vector<uint32_t> parent(numVerts);
+  std::iota(parent.begin(), parent.end(), 0);
+  const auto findRoot = [&parent](uint32_t vIDX) {
+    while (parent[vIDX] != vIDX) {
+      // path halving
+      parent[vIDX] = parent[parent[vIDX]];
+      vIDX = parent[vIDX];
+    }
+    return vIDX;
+  };
+  for (uint32_t vIDX = 0; vIDX < numVerts; ++vIDX) {
+    for (std::size_t i = adjList.offsets[vIDX];
+         i != adjList.offsets[vIDX + 1]; ++i) {
+      const uint32_t adjIDX = adjList.neighbors[i];
+      // every edge is in the list twice, only merge it once
+      if (adjIDX <= vIDX || !(clrVec[adjIDX] == clrVec[vIDX])) {
+        continue;
+      }
+      const uint32_t root = findRoot(vIDX);
+      const uint32_t adjRoot = findRoot(adjIDX);
+      if (root < adjRoot) {
+        parent[adjRoot] = root;
+      } else if (adjRoot < root) {
+        parent[root] = adjRoot;
+      }
+    }
+  }
+
+  // Parents are never larger than their verts, so one pass in ascending
+  // order points every vert directly at its root, and the root of a
+  // component is seen before any of its other verts
+  std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
+      clrsToComponents;
+  // map values are never moved, so roots can point at their color's vector
+  std::vector<std::vector<std::set<uint32_t>>*> componentsOfRoot(numVerts);
+  std::vector<uint32_t> componentIdxOfRoot(numVerts);
+  for (uint32_t vIDX = 0; vIDX < numVerts; ++vIDX) {
+    const uint32_t root = parent[vIDX] = parent[parent[vIDX]];
+    if (root == vIDX) {
+      // convert color/tag to key for map
+      const uint32_t colorKey = getValueAsUInt(clrVec[vIDX]);
+      if (colorKey == ~uint32_t(0)) {
+        return {};
+      }
+      // find or build map entry keyed by color of vert set for CC
+      std::vector<std::set<uint32_t>>& components = clrsToComponents[colorKey];
+      componentsOfRoot[vIDX] = &components;
+      componentIdxOfRoot[vIDX] = components.size();
+      components.emplace_back();
+    }
+    std::set<uint32_t>& setOfVerts =
+        (*componentsOfRoot[root])[componentIdxOfRoot[root]];
+    setOfVerts.emplace_hint(setOfVerts.end(), vIDX);
+  }
+  return clrsToComponents;
+}  // findCCsByGivenColor
+
 template <typename T>
 T clamp(const T& n, const T& low, const T& high) {
   return std::max(low, std::min(n, high));
@@ -5,6 +5,7 @@
 #include "OBB.h"
 
 #include <array>
+#include <cmath>
 #include <vector>
 
 #include "esp/core/Check.h"
@@ -95,6 +96,54 @@ vec3f OBB::closestPoint(const vec3f& p) const {
   return closest;
 }
 
+std::vector<float> OBB::distance(const std::vector<vec3f>& points) const {
+  // the rotation matrix is computed once for all points
+  const mat3f R = rotation_.matrix();
+  std::vector<float> distances(points.size());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    const vec3f d = points[i] - center_;
+    float squaredDistance = 0.0f;
+    for (int j = 0; j < 3; ++j) {
+      const float projection = R.col(j).dot(d);
+      const float outside = std::abs(projection) - halfExtents_[j];
+      if (outside > 0.0f) {
+        squaredDistance += outside * outside;
+      }
+    }
+    distances[i] = std::sqrt(squaredDistance);
+  }
+  return distances;
+}
+
+std::vector<vec3f> OBB::closestPoint(const std::vector<vec3f>& points) const {
+  const mat3f R = rotation_.matrix();
+  std::vector<vec3f> closest;
+  closest.reserve(points.size());
+  for (const vec3f& p : points) {
+    const vec3f d = p - center_;
+    vec3f point = center_;
+    for (int i = 0; i < 3; ++i) {
+      point +=
+          clamp(R.col(i).dot(d), -halfExtents_[i], halfExtents_[i]) * R.col(i);
+    }
+    closest.push_back(point);
+  }
+  return closest;
+}
+
+std::vector<bool> OBB::contains(const std::vector<vec3f>& points,
+                                float eps /* = 1e-6f */) const {
+  const mat3f linear = worldToLocal_.linear();
+  const vec3f translation = worldToLocal_.translation();
+  const float bound = 1.0f + eps;
+  std::vector<bool> result(points.size());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    const vec3f pLocal = linear * points[i] + translation;
+    result[i] = pLocal.cwiseAbs().maxCoeff() <= bound;
+  }
+  return result;
+}
+
 OBB& OBB::rotate(const quatf& q) {
   rotation_ = q * rotation_;
   recomputeTransforms();
@@ -59,6 +59,16 @@ class OBB {
   //! threshold distance epsilon
   bool contains(const vec3f& p, float epsilon = 1e-6f) const;
 
+  //! Batched @ref distance(), returns the distance of each point
+  std::vector<float> distance(const std::vector<vec3f>& points) const;
+
+  //! Batched @ref closestPoint(), returns the closest point for each point
+  std::vector<vec3f> closestPoint(const std::vector<vec3f>& points) const;
+
+  //! Batched @ref contains(), returns whether each point is contained
+  std::vector<bool> contains(const std::vector<vec3f>& points,
+                             float epsilon = 1e-6f) const;
+
   //! Rotate this OBB by the given rotation and return reference to self
   OBB& rotate(const quatf& rotation);
 
@@ -0,0 +1,179 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "OBBTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "esp/core/Check.h"
+
+namespace esp {
+namespace geo {
+
+namespace {
+constexpr int MaxLeafSize = 4;
+constexpr int MaxDepth = 32;
+}  // namespace
+
+OBBTree::OBBTree(const std::vector<OBB>& obbs, const std::vector<int>& ids)
+    : obbs_{obbs}, ids_{ids} {
+  ESP_CHECK(ids_.empty() || ids_.size() == obbs_.size(),
+            "OBBTree: expected" << obbs_.size() << "IDs but got"
+                                << ids_.size());
+  if (ids_.empty()) {
+    ids_.resize(obbs_.size());
+    for (std::size_t i = 0; i < ids_.size(); ++i) {
+      ids_[i] = static_cast<int>(i);
+    }
+  }
+  boxes_.reserve(obbs_.size());
+  order_.resize(obbs_.size());
+  for (std::size_t i = 0; i < obbs_.size(); ++i) {
+    boxes_.push_back(obbs_[i].toAABB());
+    order_[i] = static_cast<int>(i);
+  }
+  if (!obbs_.empty()) {
+    nodes_.reserve(2 * (obbs_.size() / MaxLeafSize + 1));
+    nodes_.emplace_back();
+    buildNode(0, 0, static_cast<int>(obbs_.size()), 0);
+  }
+}
+
+void OBBTree::buildNode(const int node,
+                        const int first,
+                        const int count,
+                        const int depth) {
+  box3f bounds;
+  box3f centroidBounds;
+  float maxHalfExtent = 0.0f;
+  for (int i = first; i < first + count; ++i) {
+    const box3f& box = boxes_[order_[i]];
+    bounds.extend(box);
+    centroidBounds.extend(box.center());
+    maxHalfExtent =
+        std::max(maxHalfExtent, obbs_[order_[i]].halfExtents().maxCoeff());
+  }
+  nodes_[node].bounds = bounds;
+  nodes_[node].maxHalfExtent = maxHalfExtent;
+  nodes_[node].first = first;
+  nodes_[node].count = count;
+
+  int axis = 0;
+  const float extent = centroidBounds.sizes().maxCoeff(&axis);
+  if (count <= MaxLeafSize || depth >= MaxDepth || extent == 0) {
+    return;
+  }
+
+  // median split along the longest axis of the centroids
+  const int half = count / 2;
+  std::nth_element(order_.begin() + first, order_.begin() + first + half,
+                   order_.begin() + first + count, [&](int a, int b) {
+                     return boxes_[a].center()[axis] <
+                            boxes_[b].center()[axis];
+                   });
+
+  const int firstChild = static_cast<int>(nodes_.size());
+  nodes_.emplace_back();
+  nodes_.emplace_back();
+  nodes_[node].firstChild = firstChild;
+  buildNode(firstChild, first, half, depth + 1);
+  buildNode(firstChild + 1, first + half, count - half, depth + 1);
+}
+
+std::vector<int> OBBTree::containing(const vec3f& p,
+                                     const float epsilon) const {
+  std::vector<int> result;
+  if (nodes_.empty()) {
+    return result;
+  }
+  std::vector<int> stack{0};
+  while (!stack.empty()) {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    // the tolerance is relative to the half extents, which it can stretch
+    // by up to sqrt(3) times along the box diagonal
+    const float reach = 2.0f * epsilon * node.maxHalfExtent;
+    if (node.bounds.squaredExteriorDistance(p) > reach * reach) {
+      continue;
+    }
+    if (node.firstChild != -1) {
+      stack.push_back(node.firstChild);
+      stack.push_back(node.firstChild + 1);
+      continue;
+    }
+    for (int i = node.first; i < node.first + node.count; ++i) {
+      if (obbs_[order_[i]].contains(p, epsilon)) {
+        result.push_back(ids_[order_[i]]);
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<std::vector<int>> OBBTree::containing(
+    const std::vector<vec3f>& points,
+    const float epsilon) const {
+  std::vector<std::vector<int>> result;
+  result.reserve(points.size());
+  for (const vec3f& p : points) {
+    result.push_back(containing(p, epsilon));
+  }
+  return result;
+}
+
+int OBBTree::closest(const vec3f& p, float* distance) const {
+  int best = ID_UNDEFINED;
+  float bestDistance = std::numeric_limits<float>::infinity();
+  if (!nodes_.empty()) {
+    std::vector<int> stack{0};
+    while (!stack.empty() && bestDistance > 0.0f) {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      // the bounds are a lower bound on the distance to all OBBs inside
+      if (node.bounds.squaredExteriorDistance(p) >=
+          bestDistance * bestDistance) {
+        continue;
+      }
+      if (node.firstChild != -1) {
+        const int a = node.firstChild;
+        const int b = node.firstChild + 1;
+        const bool aNearer = nodes_[a].bounds.squaredExteriorDistance(p) <=
+                             nodes_[b].bounds.squaredExteriorDistance(p);
+        // the nearer child goes on top, so the farther one gets pruned more
+        // often
+        stack.push_back(aNearer ? b : a);
+        stack.push_back(aNearer ? a : b);
+        continue;
+      }
+      for (int i = node.first; i < node.first + node.count; ++i) {
+        const float d = obbs_[order_[i]].distance(p);
+        if (d < bestDistance) {
+          bestDistance = d;
+          best = ids_[order_[i]];
+        }
+      }
+    }
+  }
+  if (distance) {
+    *distance = bestDistance;
+  }
+  return best;
+}
+
+std::vector<int> OBBTree::closest(const std::vector<vec3f>& points,
+                                  std::vector<float>* distances) const {
+  std::vector<int> result(points.size());
+  if (distances) {
+    distances->resize(points.size());
+  }
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    result[i] = closest(points[i], distances ? &(*distances)[i] : nullptr);
+  }
+  return result;
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,82 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GEO_OBBTREE_H_
+#define ESP_GEO_OBBTREE_H_
+
+#include <vector>
+
+#include "esp/core/Esp.h"
+#include "esp/geo/OBB.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Axis-aligned bounding box tree over a set of OBBs
+ *
+ * Answers point containment and closest-OBB queries without testing every
+ * OBB, e.g. for checking many agent or goal positions against the OBBs of all
+ * objects of a @ref scene::SemanticScene. Every OBB has an ID, which queries
+ * return.
+ */
+class OBBTree {
+ public:
+  /**
+   * @brief Constructor
+   * @param obbs The OBBs
+   * @param ids ID of each OBB. If empty, the index in @p obbs is used.
+   */
+  explicit OBBTree(const std::vector<OBB>& obbs,
+                   const std::vector<int>& ids = {});
+
+  //! Number of OBBs
+  std::size_t size() const { return obbs_.size(); }
+
+  //! Returns the IDs of all OBBs containing world coordinate point p, see
+  //! @ref OBB::contains()
+  std::vector<int> containing(const vec3f& p, float epsilon = 1e-6f) const;
+
+  //! Batched @ref containing(), returns the IDs for each point
+  std::vector<std::vector<int>> containing(const std::vector<vec3f>& points,
+                                           float epsilon = 1e-6f) const;
+
+  //! Returns the ID of the OBB closest to p, @ref ID_UNDEFINED if the tree is
+  //! empty. If distance isn't null, sets it to the distance to that OBB.
+  int closest(const vec3f& p, float* distance = nullptr) const;
+
+  //! Batched @ref closest(), returns the ID for each point and, if distances
+  //! isn't null, fills it with the distance for each point
+  std::vector<int> closest(const std::vector<vec3f>& points,
+                           std::vector<float>* distances = nullptr) const;
+
+ private:
+  struct Node {
+    box3f bounds;
+    // largest half extent of the OBBs in the subtree, bounding how far
+    // containment tolerances reach outside the bounds
+    float maxHalfExtent = 0.0f;
+    // children are firstChild and firstChild + 1 for inner nodes
+    int firstChild = -1;
+    // range in order_ of the OBBs in the subtree
+    int first = 0;
+    int count = 0;
+  };
+
+  void buildNode(int node, int first, int count, int depth);
+
+  std::vector<OBB> obbs_;
+  std::vector<int> ids_;
+  std::vector<box3f> boxes_;
+  std::vector<Node> nodes_;
+  //! OBB indices in leaf order
+  std::vector<int> order_;
+
+  ESP_SMART_POINTERS(OBBTree)
+};
+
+}  // namespace geo
+}  // namespace esp
+
+#endif  // ESP_GEO_OBBTREE_H_
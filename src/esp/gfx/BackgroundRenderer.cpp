@@ -39,6 +39,7 @@ void BackgroundRenderer::ensureThreadInit() {
 
 BackgroundRenderer::~BackgroundRenderer() {
   if (wasInitialized()) {
+    waitThreadJobs();
     task_ = Task::Exit;
     startThreadJobs();
     t_.join();
@@ -54,6 +55,7 @@ void BackgroundRenderer::startThreadJobs() {
 }
 
 void BackgroundRenderer::waitThreadJobs() {
+  ESP_TRACE_SCOPE("waitThreadJobs");
   CORRADE_INTERNAL_ASSERT(threadIsWorking_ || jobsWaiting_ == 0);
   if (jobsWaiting_ != 0) {
     cpp20::atomic_wait_explicit(&done_, 0, std::memory_order_acquire);
@@ -68,33 +70,128 @@ void BackgroundRenderer::waitThreadJobs() {
 }
 
 void BackgroundRenderer::waitSceneGraph() {
+  ESP_TRACE_SCOPE("waitSceneGraph");
   if (threadIsWorking_)
     cpp20::atomic_wait_explicit(&sgLock_, 1, std::memory_order_acquire);
 }
 
-void BackgroundRenderer::submitRenderJob(sensor::VisualSensor& sensor,
-                                         scene::SceneGraph& sceneGraph,
-                                         const Mn::MutableImageView2D& view,
-                                         RenderCamera::Flags flags) {
+int BackgroundRenderer::submitRenderJob(sensor::VisualSensor& sensor,
+                                        scene::SceneGraph& sceneGraph,
+                                        scene::SceneGraph* sharedSceneGraph,
+                                        const Mn::MutableImageView2D& view,
+                                        RenderCamera::Flags flags) {
   ESP_CHECK(
       sensor.specification()->sensorSubType == sensor::SensorSubType::Pinhole ||
           sensor.specification()->sensorSubType ==
               sensor::SensorSubType::Orthographic,
       "BackgroundRenderer:: Only Pinhole and Orthographic sensors are "
       "supported");
-  jobs_.emplace_back(std::ref(sensor), std::ref(sceneGraph), std::cref(view),
-                     flags);
+  jobs_.push_back(
+      {std::ref(sensor), std::ref(sceneGraph), sharedSceneGraph, view, flags});
+  return jobs_.size() - 1;
+}
+
+void BackgroundRenderer::takeSnapshot(std::vector<Job>& jobs,
+                                      FrameSnapshot& snapshot) {
+  ESP_TRACE_SCOPE("takeSnapshot");
+  snapshot.jobs.clear();
+  snapshot.jobs.reserve(jobs.size());
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    sensor::VisualSensor& sensor = jobs[i].sensor;
+    scene::SceneGraph& sg = jobs[i].sceneGraph;
+    RenderCamera& camera = *sensor.getRenderCamera();
+
+    if (i == snapshot.proxyCameras.size()) {
+      scene::SceneNode& node = snapshot.proxyScene.getRootNode().createChild();
+      snapshot.proxyCameras.push_back(
+          {&node,
+           new RenderCamera{node, static_cast<scene::SceneNodeSemanticDataIDX>(
+                                      camera.getSemanticDataIDX())}});
+    }
+    ProxyCamera& proxy = snapshot.proxyCameras[i];
+    if (proxy.camera->getSemanticDataIDX() != camera.getSemanticDataIDX()) {
+      // the camera is a feature of the node, owned and deleted by it
+      delete proxy.camera;
+      proxy.camera =
+          new RenderCamera{*proxy.node,
+                           static_cast<scene::SceneNodeSemanticDataIDX>(
+                               camera.getSemanticDataIDX())};
+    }
+    proxy.node->setTransformation(
+        camera.node().absoluteTransformationMatrix());
+    Mn::Matrix4 projection = camera.projectionMatrix();
+    proxy.camera->setProjectionMatrix(camera.viewport().x(),
+                                      camera.viewport().y(), projection);
+
+    SnapshotJob job{jobs[i].sensor, jobs[i].view, jobs[i].flags, proxy.camera,
+                    {}};
+    scene::SceneGraph* sharedSg = jobs[i].sharedSceneGraph;
+    job.transforms.reserve(
+        sg.getDrawableGroups().size() +
+        (sharedSg ? sharedSg->getDrawableGroups().size() : 0));
+    for (scene::SceneGraph* graph : {&sg, sharedSg}) {
+      if (!graph)
+        continue;
+      for (auto& it : graph->getDrawableGroups()) {
+        it.second.prepareForDraw(camera);
+        auto transforms = camera.drawableTransformations(it.second);
+        camera.filterTransforms(transforms, jobs[i].flags);
+
+        job.transforms.emplace_back(std::move(transforms));
+      }
+    }
+    snapshot.jobs.emplace_back(std::move(job));
+  }
+  jobs.clear();
+}
+
+void BackgroundRenderer::snapshotRenderJobs() {
+  // the thread may still be snapshotting the scene graphs itself
+  waitSceneGraph();
+  takeSnapshot(jobs_, snapshots_[frontSnapshot_ ^ 1]);
+  backSnapshotPending_ = true;
 }
 
 void BackgroundRenderer::startRenderJobs() {
+  ESP_TRACE_SCOPE("startRenderJobs");
   waitThreadJobs();
   ensureThreadInit();
   task_ = Task::Render;
-  sgLock_.store(1, std::memory_order_relaxed);
-  jobsWaiting_ = jobs_.size();
+  if (backSnapshotPending_) {
+    frontSnapshot_ ^= 1;
+    backSnapshotPending_ = false;
+    // jobs submitted after the snapshot are left for the next frame
+    threadTakesSnapshot_ = false;
+    jobsWaiting_ = snapshots_[frontSnapshot_].jobs.size();
+  } else {
+    threadJobs_ = std::move(jobs_);
+    jobs_.clear();
+    threadTakesSnapshot_ = true;
+    sgLock_.store(1, std::memory_order_relaxed);
+    jobsWaiting_ = threadJobs_.size();
+  }
+  jobsRead_.store(0, std::memory_order_relaxed);
   startThreadJobs();
 }
 
+bool BackgroundRenderer::isRenderJobDone(const int job) const {
+  return !threadIsWorking_ || jobsRead_.load(std::memory_order_acquire) > job;
+}
+
+void BackgroundRenderer::waitRenderJob(const int job) {
+  ESP_TRACE_SCOPE("waitRenderJob");
+  if (!threadIsWorking_)
+    return;
+  CORRADE_ASSERT(job < jobsWaiting_,
+                 "BackgroundRenderer::waitRenderJob(): job" << job
+                     << "wasn't started, the frame has" << jobsWaiting_
+                     << "jobs", );
+  for (int read = jobsRead_.load(std::memory_order_acquire); read <= job;
+       read = jobsRead_.load(std::memory_order_acquire)) {
+    cpp20::atomic_wait_explicit(&jobsRead_, read, std::memory_order_acquire);
+  }
+}
+
 void BackgroundRenderer::releaseContext() {
   if (!wasInitialized())
     return;
@@ -109,77 +206,59 @@ void BackgroundRenderer::releaseContext() {
 }
 
 int BackgroundRenderer::threadRender() {
+  ESP_TRACE_SCOPE("threadRender");
   if (!threadOwnsContext_) {
     ESP_VERY_VERBOSE() << "Background thread acquired GL Context";
     context_->makeCurrent();
     threadOwnsContext_ = true;
   }
 
-  std::vector<std::vector<RenderCamera::DrawableTransforms>> jobTransforms(
-      jobs_.size());
-
-  for (size_t i = 0; i < jobs_.size(); ++i) {
-    auto& job = jobs_[i];
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    scene::SceneGraph& sg = std::get<1>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
-
-    auto* camera = sensor.getRenderCamera();
-    jobTransforms[i].reserve(sg.getDrawableGroups().size());
-    for (auto& it : sg.getDrawableGroups()) {
-      it.second.prepareForDraw(*camera);
-      auto transforms = camera->drawableTransformations(it.second);
-      camera->filterTransforms(transforms, flags);
-
-      jobTransforms[i].emplace_back(std::move(transforms));
-    }
+  FrameSnapshot& snapshot = snapshots_[frontSnapshot_];
+  if (threadTakesSnapshot_) {
+    takeSnapshot(threadJobs_, snapshot);
+    sgLock_.store(0, std::memory_order_release);
+    cpp20::atomic_notify_all(&sgLock_);
   }
 
-  sgLock_.store(0, std::memory_order_release);
-  cpp20::atomic_notify_all(&sgLock_);
-
-  for (size_t i = 0; i < jobs_.size(); ++i) {
-    auto& job = jobs_[i];
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
+  for (SnapshotJob& job : snapshot.jobs) {
+    sensor::VisualSensor& sensor = job.sensor;
 
-    if (!(flags & RenderCamera::Flag::ObjectsOnly))
+    if (!(job.flags & RenderCamera::Flag::ObjectsOnly))
       sensor.renderTarget().renderEnter();
 
-    auto* camera = sensor.getRenderCamera();
-
-    for (auto& transforms : jobTransforms[i]) {
-      camera->draw(transforms, flags);
+    for (auto& transforms : job.transforms) {
+      job.camera->draw(transforms, job.flags);
     }
     auto sensorType = sensor.specification()->sensorType;
     if (sensorType == sensor::SensorType::Color) {
       sensor.renderTarget().tryDrawHbao();
     }
 
-    if (!(flags & RenderCamera::Flag::ObjectsOnly))
+    if (!(job.flags & RenderCamera::Flag::ObjectsOnly))
       sensor.renderTarget().renderExit();
   }
 
-  for (auto& job : jobs_) {
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    const Mn::MutableImageView2D& view = std::get<2>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
-    if (flags & RenderCamera::Flag::ObjectsOnly)
-      continue;
+  for (SnapshotJob& job : snapshot.jobs) {
+    sensor::VisualSensor& sensor = job.sensor;
+    if (!(job.flags & RenderCamera::Flag::ObjectsOnly)) {
+      auto sensorType = sensor.specification()->sensorType;
+      if (sensorType == sensor::SensorType::Color)
+        sensor.renderTarget().readFrameRgba(job.view);
 
-    auto sensorType = sensor.specification()->sensorType;
-    if (sensorType == sensor::SensorType::Color)
-      sensor.renderTarget().readFrameRgba(view);
+      if (sensorType == sensor::SensorType::Depth)
+        sensor.renderTarget().readFrameDepth(job.view);
 
-    if (sensorType == sensor::SensorType::Depth)
-      sensor.renderTarget().readFrameDepth(view);
+      if (sensorType == sensor::SensorType::Semantic)
+        sensor.renderTarget().readFrameObjectId(job.view);
+    }
 
-    if (sensorType == sensor::SensorType::Semantic)
-      sensor.renderTarget().readFrameObjectId(view);
+    // the observation can be consumed while the next ones are read
+    jobsRead_.fetch_add(1, std::memory_order_release);
+    cpp20::atomic_notify_all(&jobsRead_);
   }
 
-  int jobsDone = jobs_.size();
-  jobs_.clear();
+  int jobsDone = snapshot.jobs.size();
+  snapshot.jobs.clear();
   return jobsDone;
 }
 
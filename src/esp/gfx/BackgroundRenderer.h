@@ -9,7 +9,9 @@
 
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
 
+#include <functional>
 #include <thread>
+#include <vector>
 
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/Renderer.h"
@@ -19,6 +21,21 @@
 
 namespace esp {
 namespace gfx {
+/**
+ * @brief Thread drawing @ref sensor::VisualSensor observations in the
+ * background, see @ref Renderer::enqueueAsyncDrawJob.
+ *
+ * The scene state the jobs of a frame need (drawable transformations after
+ * culling, camera transformations and projections) is captured in a snapshot,
+ * which the thread renders without touching the scene graphs. There are two
+ * snapshots: while the thread renders one, the main thread may capture the
+ * next frame into the other one with @ref snapshotRenderJobs and step physics
+ * in the meantime.
+ *
+ * All jobs of a frame are run as one batch, drawing all of them before reading
+ * them back in the order they were submitted. Each job signals completion on
+ * its own once its observation is read, see @ref waitRenderJob.
+ */
 class BackgroundRenderer {
  public:
   explicit BackgroundRenderer(WindowlessContext* context);
@@ -37,11 +54,53 @@ class BackgroundRenderer {
   void startThreadJobs();
   void waitThreadJobs();
 
-  void submitRenderJob(sensor::VisualSensor& sensor,
-                       scene::SceneGraph& sceneGraph,
-                       const Mn::MutableImageView2D& view,
-                       RenderCamera::Flags flags);
+  // returns the index of the job in its frame. The drawables of
+  // sharedSceneGraph, if not null, are drawn after the ones of sceneGraph.
+  int submitRenderJob(sensor::VisualSensor& sensor,
+                      scene::SceneGraph& sceneGraph,
+                      scene::SceneGraph* sharedSceneGraph,
+                      const Mn::MutableImageView2D& view,
+                      RenderCamera::Flags flags);
+  // captures the submitted jobs into the back snapshot on the calling thread,
+  // can run while the thread renders the front one
+  void snapshotRenderJobs();
   void startRenderJobs();
+  // whether the job-th job of the started frame was read back
+  bool isRenderJobDone(int job) const;
+  void waitRenderJob(int job);
+
+  struct Job {
+    std::reference_wrapper<sensor::VisualSensor> sensor;
+    std::reference_wrapper<scene::SceneGraph> sceneGraph;
+    scene::SceneGraph* sharedSceneGraph;
+    Mn::MutableImageView2D view;
+    RenderCamera::Flags flags;
+  };
+
+  // camera standing in for the camera of a sensor while its snapshot is
+  // rendered, so that the sensor can move meanwhile
+  struct ProxyCamera {
+    scene::SceneNode* node;
+    RenderCamera* camera;
+  };
+
+  struct SnapshotJob {
+    std::reference_wrapper<sensor::VisualSensor> sensor;
+    Mn::MutableImageView2D view;
+    RenderCamera::Flags flags;
+    RenderCamera* camera;
+    // transformations of the drawables of each drawable group
+    std::vector<RenderCamera::DrawableTransforms> transforms;
+  };
+
+  struct FrameSnapshot {
+    // scene owning the proxy camera nodes
+    scene::SceneGraph proxyScene;
+    std::vector<ProxyCamera> proxyCameras;
+    std::vector<SnapshotJob> jobs;
+  };
+
+  void takeSnapshot(std::vector<Job>& jobs, FrameSnapshot& snapshot);
 
   // run loop for the thread.
   void runLoopThread();
@@ -53,16 +112,23 @@ class BackgroundRenderer {
   WindowlessContext* context_;
 
   std::atomic<int> done_, sgLock_, start_;
+  // number of jobs of the started frame that were read back
+  std::atomic<int> jobsRead_{0};
   std::thread t_;
   bool threadIsWorking_, threadInitialized_;
 
   bool threadOwnsContext_;
   Task task_;
-  std::vector<std::tuple<std::reference_wrapper<sensor::VisualSensor>,
-                         std::reference_wrapper<scene::SceneGraph>,
-                         std::reference_wrapper<const Mn::MutableImageView2D>,
-                         RenderCamera::Flags>>
-      jobs_;
+  std::vector<Job> jobs_;
+  // jobs handed to the thread to snapshot itself, used when the main thread
+  // didn't call snapshotRenderJobs
+  std::vector<Job> threadJobs_;
+  FrameSnapshot snapshots_[2];
+  // index of the snapshot the thread renders, the other one is filled by
+  // snapshotRenderJobs
+  int frontSnapshot_ = 0;
+  bool backSnapshotPending_ = false;
+  bool threadTakesSnapshot_ = false;
   int jobsWaiting_ = 0;
 };
 }  // namespace gfx
@@ -498,6 +498,50 @@ void CubeMap::loadTexture(TextureType type,
   generateMipmap(type);
 }
 
+bool CubeMap::loadTextureLevel(const std::string& imageFilePrefix,
+                               unsigned int mipLevel) {
+  textureTypeSanityCheck("CubeMap::loadTextureLevel():", flags_,
+                         TextureType::Color);
+  mipLevelSanityCheck("CubeMap::loadTextureLevel():", flags_, mipLevel,
+                      mipmapLevels_);
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("AnyImageImporter");
+  if (!importer) {
+    return false;
+  }
+  importer->addFlags(Mn::Trade::ImporterFlag::Quiet);
+
+  const int size = imageSize_ >> mipLevel;
+  const char* coordStrings[6] = {"+X", "-X", "+Y", "-Y", "+Z", "-Z"};
+  // read all faces before uploading any, so a cube map that fails to load
+  // keeps its contents
+  Cr::Containers::Optional<Mn::Trade::ImageData2D> images[6];
+  for (int iFace = 0; iFace < 6; ++iFace) {
+    // the filenames written by saveTexture()
+    const std::string filename = Cr::Utility::formatString(
+        "{}.{}.mip_{}.{}.png", imageFilePrefix,
+        getTextureTypeFilenameString(TextureType::Color), mipLevel,
+        coordStrings[iFace]);
+    if (!importer->openFile(filename) ||
+        !(images[iFace] = importer->image2D(0)) ||
+        images[iFace]->isCompressed() ||
+        images[iFace]->format() != getPixelFormat(TextureType::Color) ||
+        images[iFace]->size() != Mn::Vector2i{size}) {
+      return false;
+    }
+  }
+
+  Mn::GL::CubeMapTexture& tex = texture(TextureType::Color);
+  for (int iFace = 0; iFace < 6; ++iFace) {
+    tex.setSubImage(convertFaceIndexToCubeMapCoordinate(iFace), mipLevel, {},
+                    *images[iFace]);
+  }
+  ESP_DEBUG() << "Loaded mip level" << mipLevel << "from" << imageFilePrefix;
+  return true;
+}
+
 void CubeMap::generateMipmap(TextureType type) {
   CORRADE_INTERNAL_ASSERT(type == TextureType::Color);
   CORRADE_INTERNAL_ASSERT(flags_ & Flag::ColorTexture);
@@ -551,7 +595,8 @@ void CubeMap::copySubImage(unsigned int cubeSideIndex,
 void CubeMap::renderToTexture(CubeMapCamera& camera,
                               scene::SceneGraph& sceneGraph,
                               const char* drawableGroupName,
-                              RenderCamera::Flags renderCameraFlags) {
+                              RenderCamera::Flags renderCameraFlags,
+                              Mn::UnsignedInt faces) {
   CORRADE_ASSERT(camera.isInSceneGraph(sceneGraph),
                  "CubeMap::renderToTexture(): camera is NOT attached to the "
                  "current scene graph.", );
@@ -574,17 +619,48 @@ void CubeMap::renderToTexture(CubeMapCamera& camera,
   // the camera MUST be updated as well.
   camera.updateOriginalViewingMatrix();
 
+  // TODO:
+  // should have different drawable groups that can do "low quality"
+  // rendering, e.g., no normal maps, no specular lighting, low-poly meshes,
+  // low-quality textures.
+  DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
+  group.prepareForDraw(camera);
+
+  // The faces only differ by the rotation of the camera around its origin, so
+  // the scene graph is traversed once, relative to the unrotated camera, and
+  // every face rotates these transformations into its own view before culling
+  // and drawing them.
+  RenderCamera::DrawableTransforms cameraTransforms =
+      camera.drawableTransformations(group);
+  if (renderCameraFlags & RenderCamera::Flag::ObjectsOnly) {
+    cameraTransforms.erase(
+        cameraTransforms.begin() + camera.removeNonObjects(cameraTransforms),
+        cameraTransforms.end());
+  }
+  const RenderCamera::Flags faceFlags =
+      renderCameraFlags & ~RenderCamera::Flags{RenderCamera::Flag::ObjectsOnly};
+
+  RenderCamera::DrawableTransforms faceTransforms;
+  faceTransforms.reserve(cameraTransforms.size());
   for (int iFace = 0; iFace < 6; ++iFace) {
+    if (!(faces & (1u << iFace))) {
+      continue;
+    }
     camera.switchToFace(iFace);
     prepareToDraw(iFace, renderCameraFlags);
 
-    // TODO:
-    // should have different drawable groups that can do "low quality"
-    // rendering, e.g., no normal maps, no specular lighting, low-poly meshes,
-    // low-quality textures.
-    DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
-    group.prepareForDraw(camera);
-    camera.draw(group, renderCameraFlags);
+    const Mn::Matrix4 faceRotation =
+        CubeMapCamera::getCameraLocalTransform(
+            CubeMapCamera::cubeMapCoordinate(iFace))
+            .invertedRigid();
+    faceTransforms.clear();
+    for (const auto& drawableTransform : cameraTransforms) {
+      faceTransforms.emplace_back(drawableTransform.first,
+                                  faceRotation * drawableTransform.second);
+    }
+    camera.filterTransforms(faceTransforms, faceFlags);
+    ScopedGpuProfile gpuProfile{gpuFaceProfile_};
+    camera.draw(faceTransforms, faceFlags);
   }  // iFace
 
   // CAREFUL!!!
@@ -18,6 +18,7 @@
 #include <Magnum/Shaders/GenericGL.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include "esp/gfx/CubeMapCamera.h"
+#include "esp/gfx/GpuProfile.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/scene/SceneGraph.h"
 #include "esp/scene/SceneNode.h"
@@ -64,6 +65,13 @@ class CubeMap {
 
   };
 
+  /**
+   * @brief Face mask with all six faces set, see @ref renderToTexture(). Bit
+   * i stands for the face with index i in @ref
+   * CubeMapCamera::switchToFace(unsigned int).
+   */
+  static constexpr Magnum::UnsignedInt AllFaces = 0x3f;
+
   enum class Flag : Magnum::UnsignedShort {
     /**
      *  create color cubemap
@@ -191,18 +199,37 @@ class CubeMap {
                    const std::string& imageFilePrefix,
                    const std::string& imageFileExtension);
 
+  /**
+   * @brief Load one mip level of the color texture from the images written by
+   * @ref saveTexture()
+   * @param imageFilePrefix the filename prefix passed to @ref saveTexture()
+   * @param mipLevel the mip level to load
+   * @return true if all 6 images were read and fit the level, otherwise false
+   *
+   * Unlike @ref loadTexture(), neither resizes the cube map nor builds the
+   * mipmaps, so the levels of a cube map with
+   * @ref Flag::ManuallyBuildMipmap can each be loaded from their own images.
+   * Missing or unreadable images aren't an error, so this can be used to test
+   * whether a saved cube map exists.
+   */
+  bool loadTextureLevel(const std::string& imageFilePrefix,
+                        unsigned int mipLevel = 0);
+
   /**
    * @brief Render to cubemap texture using the camera
    * @param camera a cubemap camera
+   * @param faces mask of the faces to render, see @ref AllFaces. The other
+   * faces keep their previous contents.
    * NOTE: It will NOT automatically generate the mipmap for the user
    */
   void renderToTexture(CubeMapCamera& camera,
                        scene::SceneGraph& sceneGraph,
                        const char* drawableGroupName = "",
-                       RenderCamera::Flags flags = {
-                           RenderCamera::Flag::FrustumCulling |
-                           RenderCamera::Flag::ClearColor |
-                           RenderCamera::Flag::ClearDepth});
+                       RenderCamera::Flags flags =
+                           {RenderCamera::Flag::FrustumCulling |
+                            RenderCamera::Flag::ClearColor |
+                            RenderCamera::Flag::ClearDepth},
+                       Magnum::UnsignedInt faces = AllFaces);
 
   /**
    * @brief copy the texture from a specified cube face to a given texture
@@ -278,6 +305,10 @@ class CubeMap {
   Corrade::Containers::StaticArray<6, Magnum::GL::Renderbuffer>
       optionalDepthBuffer_{Corrade::DirectInit, Magnum::NoCreate};
 
+  // GPU duration of drawing each face, recorded if GPU timers are enabled.
+  // Enough queries for up to three renders in flight.
+  GpuProfile gpuFaceProfile_{"gpuCubeMapFace", 18};
+
   /**
    * @brief recreate the frame buffer
    * @param cubeSideIndex the index of the cube side, can be 0,
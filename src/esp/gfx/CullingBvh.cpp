@@ -0,0 +1,191 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CullingBvh.h"
+
+#include <Magnum/Math/Functions.h>
+#include <algorithm>
+#include <utility>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+constexpr int MaxLeafSize = 4;
+constexpr int MaxDepth = 32;
+
+enum class PlaneSide { Outside, Intersecting, Inside };
+
+PlaneSide planeSide(const Mn::Range3D& box, const Mn::Vector4& plane) {
+  // same test as the flat culling, on doubled center and extent
+  const Mn::Vector3 center = box.min() + box.max();
+  const Mn::Vector3 extent = box.max() - box.min();
+  const float d = Mn::Math::dot(center, plane.xyz());
+  const float r = Mn::Math::dot(extent, Mn::Math::abs(plane.xyz()));
+  const float threshold = -2.0f * plane.w();
+  if (d + r < threshold)
+    return PlaneSide::Outside;
+  if (d - r >= threshold)
+    return PlaneSide::Inside;
+  return PlaneSide::Intersecting;
+}
+}  // namespace
+
+void CullingBvh::build(const std::vector<Mn::Range3D>& boxes) {
+  boxes_ = boxes;
+  nodes_.clear();
+  order_.resize(boxes_.size());
+  leafOf_.resize(boxes_.size());
+  for (std::size_t i = 0; i < order_.size(); ++i) {
+    order_[i] = static_cast<int>(i);
+  }
+  dirty_ = false;
+  if (!boxes_.empty()) {
+    nodes_.reserve(2 * (boxes_.size() / MaxLeafSize + 1));
+    nodes_.emplace_back();
+    buildNode(0, 0, static_cast<int>(boxes_.size()), 0);
+  }
+}
+
+void CullingBvh::buildNode(const int node,
+                           const int first,
+                           const int count,
+                           const int depth) {
+  Mn::Range3D bounds = boxes_[order_[first]];
+  Mn::Range3D centroidBounds{bounds.center(), bounds.center()};
+  for (int i = first + 1; i < first + count; ++i) {
+    const Mn::Range3D& box = boxes_[order_[i]];
+    bounds = Mn::Math::join(bounds, box);
+    centroidBounds = Mn::Math::join(
+        centroidBounds, Mn::Range3D{box.center(), box.center()});
+  }
+  nodes_[node].bounds = bounds;
+  nodes_[node].first = first;
+  nodes_[node].count = count;
+
+  const Mn::Vector3 centroidSize = centroidBounds.size();
+  const int axis = centroidSize.x() > centroidSize.y()
+                       ? (centroidSize.x() > centroidSize.z() ? 0 : 2)
+                       : (centroidSize.y() > centroidSize.z() ? 1 : 2);
+  if (count <= MaxLeafSize || depth >= MaxDepth || centroidSize[axis] == 0) {
+    for (int i = first; i < first + count; ++i) {
+      leafOf_[order_[i]] = node;
+    }
+    return;
+  }
+
+  // median split along the longest axis of the centroids
+  const int half = count / 2;
+  std::nth_element(order_.begin() + first, order_.begin() + first + half,
+                   order_.begin() + first + count, [&](int a, int b) {
+                     return boxes_[a].center()[axis] <
+                            boxes_[b].center()[axis];
+                   });
+
+  const int firstChild = static_cast<int>(nodes_.size());
+  nodes_.emplace_back();
+  nodes_.emplace_back();
+  nodes_[node].firstChild = firstChild;
+  nodes_[firstChild].parent = node;
+  nodes_[firstChild + 1].parent = node;
+  buildNode(firstChild, first, half, depth + 1);
+  buildNode(firstChild + 1, first + half, count - half, depth + 1);
+}
+
+void CullingBvh::markDirty(int node) {
+  dirty_ = true;
+  while (node != -1 && !nodes_[node].dirty) {
+    nodes_[node].dirty = true;
+    node = nodes_[node].parent;
+  }
+}
+
+void CullingBvh::refit() {
+  if (!dirty_)
+    return;
+  // children always come after their parent, so a reverse pass is bottom-up
+  for (int i = static_cast<int>(nodes_.size()) - 1; i >= 0; --i) {
+    Node& node = nodes_[i];
+    if (!node.dirty)
+      continue;
+    if (node.firstChild == -1) {
+      node.bounds = boxes_[order_[node.first]];
+      for (int j = node.first + 1; j < node.first + node.count; ++j) {
+        node.bounds = Mn::Math::join(node.bounds, boxes_[order_[j]]);
+      }
+    } else {
+      node.bounds = Mn::Math::join(nodes_[node.firstChild].bounds,
+                                   nodes_[node.firstChild + 1].bounds);
+    }
+    node.dirty = false;
+  }
+  dirty_ = false;
+}
+
+std::size_t CullingBvh::cull(const Mn::Frustum& frustum,
+                             std::int8_t* culledPlane) {
+  if (nodes_.empty())
+    return 0;
+  refit();
+
+  std::size_t numVisible = 0;
+  auto markRange = [&](const Node& node, const std::int8_t plane) {
+    for (int i = node.first; i < node.first + node.count; ++i) {
+      culledPlane[order_[i]] = plane;
+    }
+    if (plane < 0)
+      numVisible += node.count;
+  };
+
+  // nodes to visit along with the mask of planes they still intersect
+  constexpr unsigned AllPlanes = (1 << 6) - 1;
+  std::vector<std::pair<int, unsigned>> stack{{0, AllPlanes}};
+  while (!stack.empty()) {
+    const int nodeIndex = stack.back().first;
+    unsigned planes = stack.back().second;
+    stack.pop_back();
+    const Node& node = nodes_[nodeIndex];
+
+    int outsidePlane = -1;
+    for (int iPlane = 0; iPlane < 6 && outsidePlane == -1; ++iPlane) {
+      if (!(planes & (1 << iPlane)))
+        continue;
+      const PlaneSide side = planeSide(node.bounds, frustum[iPlane]);
+      if (side == PlaneSide::Outside)
+        outsidePlane = iPlane;
+      else if (side == PlaneSide::Inside)
+        planes &= ~(1 << iPlane);
+    }
+
+    if (outsidePlane != -1) {
+      // the whole subtree is culled at once
+      markRange(node, static_cast<std::int8_t>(outsidePlane));
+    } else if (planes == 0) {
+      // the whole subtree is inside the frustum
+      markRange(node, -1);
+    } else if (node.firstChild != -1) {
+      stack.emplace_back(node.firstChild, planes);
+      stack.emplace_back(node.firstChild + 1, planes);
+    } else {
+      for (int i = node.first; i < node.first + node.count; ++i) {
+        std::int8_t plane = -1;
+        for (int iPlane = 0; iPlane < 6 && plane == -1; ++iPlane) {
+          if ((planes & (1 << iPlane)) &&
+              planeSide(boxes_[order_[i]], frustum[iPlane]) ==
+                  PlaneSide::Outside)
+            plane = static_cast<std::int8_t>(iPlane);
+        }
+        culledPlane[order_[i]] = plane;
+        if (plane < 0)
+          ++numVisible;
+      }
+    }
+  }
+  return numVisible;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,92 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_CULLINGBVH_H_
+#define ESP_GFX_CULLINGBVH_H_
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Range.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Bounding volume hierarchy over the bounding boxes of a set of
+ * drawables, used by @ref RenderCamera::cull to reject whole groups of
+ * drawables against the camera frustum at once.
+ *
+ * The hierarchy is built once for a set of boxes and afterwards only refit
+ * along the paths of the boxes that changed, which keeps updates cheap for
+ * scenes that are mostly static (e.g. stage geometry with a few moving
+ * objects).
+ */
+class CullingBvh {
+ public:
+  /**
+   * @brief Rebuild the hierarchy from scratch for @p boxes.
+   */
+  void build(const std::vector<Magnum::Range3D>& boxes);
+
+  /**
+   * @brief Number of boxes the hierarchy was built for.
+   */
+  std::size_t size() const { return boxes_.size(); }
+
+  /**
+   * @brief Update the box of the @p index-th drawable. The hierarchy is refit
+   * on the next @ref cull if it changed.
+   */
+  void setBox(std::size_t index, const Magnum::Range3D& box) {
+    if (boxes_[index] != box) {
+      boxes_[index] = box;
+      markDirty(leafOf_[index]);
+    }
+  }
+
+  /**
+   * @brief Frustum cull all boxes.
+   * @param frustum the frustum
+   * @param[out] culledPlane Set to a frustum plane culling each box, -1 if it
+   * intersects the frustum. Must have @ref size elements.
+   * @return The number of boxes intersecting the frustum.
+   */
+  std::size_t cull(const Magnum::Frustum& frustum, std::int8_t* culledPlane);
+
+ private:
+  struct Node {
+    Magnum::Range3D bounds;
+    // children are firstChild and firstChild + 1 for inner nodes
+    int firstChild = -1;
+    // range in order_ of the boxes in the subtree
+    int first = 0;
+    int count = 0;
+    int parent = -1;
+    bool dirty = false;
+  };
+
+  void buildNode(int node, int first, int count, int depth);
+  void markDirty(int node);
+  void refit();
+
+  std::vector<Magnum::Range3D> boxes_;
+  std::vector<Node> nodes_;
+  //! box indices in leaf order
+  std::vector<int> order_;
+  //! leaf node of each box
+  std::vector<int> leafOf_;
+  bool dirty_ = false;
+
+  ESP_SMART_POINTERS(CullingBvh)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_CULLINGBVH_H_
@@ -62,6 +62,47 @@ DebugLineRender::DebugLineRender()
   _glResources->mesh.addVertexBuffer(_glResources->buffer, 0,
                                      Mn::Shaders::FlatGL3D::Position{},
                                      Mn::Shaders::FlatGL3D::Color4{});
+  _glResources->staticMesh.addVertexBuffer(_glResources->staticBuffer, 0,
+                                           Mn::Shaders::FlatGL3D::Position{},
+                                           Mn::Shaders::FlatGL3D::Color4{});
+
+  // the 12 edges of the [0, 1] cube, 4 along each axis
+  for (int axis = 0; axis != 3; ++axis) {
+    for (int corner = 0; corner != 4; ++corner) {
+      Mn::Vector3 from;
+      from[(axis + 1) % 3] = float(corner & 1);
+      from[(axis + 2) % 3] = float(corner >> 1);
+      Mn::Vector3 to = from;
+      to[axis] = 1.0f;
+      arrayAppend(_unitBoxVerts, {from, to});
+    }
+  }
+
+  // a unit circle in the XY plane
+  for (int seg = 0; seg != InstancedCircleSegments; ++seg) {
+    const auto point = [](const int i) {
+      const Mn::Deg angle = Mn::Deg(360.f * float(i) / InstancedCircleSegments);
+      return Mn::Vector3(Mn::Math::cos(angle), Mn::Math::sin(angle), 0.f);
+    };
+    arrayAppend(_unitCircleVerts, {point(seg), point(seg + 1)});
+  }
+
+  const auto setupInstancedMesh =
+      [](Mn::GL::Mesh& mesh, Mn::GL::Buffer& buffer,
+         Mn::GL::Buffer& instanceBuffer,
+         Cr::Containers::ArrayView<const Mn::Vector3> unitVerts) {
+        buffer.setData(unitVerts, Mn::GL::BufferUsage::StaticDraw);
+        mesh.setCount(unitVerts.size())
+            .addVertexBuffer(buffer, 0, Mn::Shaders::FlatGL3D::Position{})
+            .addVertexBufferInstanced(
+                instanceBuffer, 1, 0,
+                Mn::Shaders::FlatGL3D::TransformationMatrix{},
+                Mn::Shaders::FlatGL3D::Color4{});
+      };
+  setupInstancedMesh(_glResources->boxMesh, _glResources->boxBuffer,
+                     _glResources->boxInstanceBuffer, _unitBoxVerts);
+  setupInstancedMesh(_glResources->circleMesh, _glResources->circleBuffer,
+                     _glResources->circleInstanceBuffer, _unitCircleVerts);
 }
 
 void DebugLineRender::releaseGLResources() {
@@ -77,6 +118,44 @@ void DebugLineRender::drawLine(const Mn::Vector3& from,
   arrayAppend(_verts, {v1, v2});
 }
 
+void DebugLineRender::appendInstanceLines(
+    Cr::Containers::Array<VertexRecord>& verts,
+    Cr::Containers::ArrayView<const Mn::Vector3> unitVerts,
+    Cr::Containers::ArrayView<const InstanceRecord> instances) {
+  arrayReserve(verts, verts.size() + unitVerts.size() * instances.size());
+  for (const InstanceRecord& instance : instances) {
+    for (const Mn::Vector3& pos : unitVerts) {
+      arrayAppend(verts,
+                  VertexRecord{instance.transform.transformPoint(pos),
+                               instance.color});
+    }
+  }
+}
+
+void DebugLineRender::bakeStaticLines() {
+  CORRADE_ASSERT(_glResources,
+                 "DebugLineRender::bakeStaticLines: no GL resources; see "
+                 "also releaseGLResources", );
+  appendInstanceLines(_staticVerts, _unitBoxVerts, _boxInstances);
+  appendInstanceLines(_staticVerts, _unitCircleVerts, _circleInstances);
+  arrayAppend(_staticVerts, _verts);
+  arrayResize(_verts, 0);
+  arrayResize(_boxInstances, 0);
+  arrayResize(_circleInstances, 0);
+
+  _glResources->staticBuffer.setData(_staticVerts,
+                                     Mn::GL::BufferUsage::StaticDraw);
+  _glResources->staticMesh.setCount(_staticVerts.size());
+}
+
+void DebugLineRender::clearStaticLines() {
+  arrayResize(_staticVerts, 0);
+  if (_glResources) {
+    _glResources->staticBuffer.setData({}, Mn::GL::BufferUsage::StaticDraw);
+    _glResources->staticMesh.setCount(0);
+  }
+}
+
 void DebugLineRender::setLineWidth(float lineWidth) {
   // This is derived from experiments with glLineWidth on Nvidia hardware.
   const float maxLineWidth = 20.f;
@@ -100,7 +179,7 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
                  "DebugLineRender::flushLines: no GL resources; see "
                  "also releaseGLResources", );
 
-  if (_verts.isEmpty()) {
+  if (!hasPendingLines()) {
     return;
   }
 
@@ -114,11 +193,21 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
     Mn::GL::Renderer::setBlendEquation(Mn::GL::Renderer::BlendEquation::Add);
   }
 
-  // Update buffer with new data
-  _glResources->buffer.setData(_verts, Mn::GL::BufferUsage::DynamicDraw);
-
-  // Update shader
+  // Update buffers with new data
+  if (!_verts.isEmpty()) {
+    _glResources->buffer.setData(_verts, Mn::GL::BufferUsage::DynamicDraw);
+  }
   _glResources->mesh.setCount(_verts.size());
+  if (!_boxInstances.isEmpty()) {
+    _glResources->boxInstanceBuffer.setData(_boxInstances,
+                                            Mn::GL::BufferUsage::DynamicDraw);
+  }
+  _glResources->boxMesh.setInstanceCount(_boxInstances.size());
+  if (!_circleInstances.isEmpty()) {
+    _glResources->circleInstanceBuffer.setData(
+        _circleInstances, Mn::GL::BufferUsage::DynamicDraw);
+  }
+  _glResources->circleMesh.setInstanceCount(_circleInstances.size());
 
   Mn::GL::Renderer::setLineWidth(_internalLineWidth);
 
@@ -149,17 +238,34 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
           offset * Mn::Vector3(1.f / viewport.x(), 1.f / viewport.y(), 0.f));
       Magnum::Matrix4 transProj = offset0Matrix * projCam;
       _glResources->shader.setTransformationProjectionMatrix(transProj);
-      _glResources->shader.draw(_glResources->mesh);
+      if (!_verts.isEmpty()) {
+        _glResources->shader.draw(_glResources->mesh);
+      }
+      if (!_staticVerts.isEmpty()) {
+        _glResources->shader.draw(_glResources->staticMesh);
+      }
+      if (!_boxInstances.isEmpty() || !_circleInstances.isEmpty()) {
+        _glResources->instancedShader.setTransformationProjectionMatrix(
+            transProj);
+      }
+      if (!_boxInstances.isEmpty()) {
+        _glResources->instancedShader.draw(_glResources->boxMesh);
+      }
+      if (!_circleInstances.isEmpty()) {
+        _glResources->instancedShader.draw(_glResources->circleMesh);
+      }
     }
   };
 
   _glResources->shader.setColor({1.0f, 1.0f, 1.0f, 1.0});
+  _glResources->instancedShader.setColor({1.0f, 1.0f, 1.0f, 1.0});
 
   submitLinesWithOffsets();
 
   // modify all colors to be semi-transparent
   static float opacity = 0.1;
   _glResources->shader.setColor({1.0f, 1.0f, 1.0f, opacity});
+  _glResources->instancedShader.setColor({1.0f, 1.0f, 1.0f, opacity});
 
   // Here, we re-draw lines with a reversed depth function. This causes
   // occluded lines to be visualized as semi-transparent, which is useful for
@@ -170,8 +276,10 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
   // restore to a reasonable default
   Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
 
-  // Clear _verts to receive new data
+  // Clear _verts and the instances to receive new data
   arrayResize(_verts, 0);
+  arrayResize(_boxInstances, 0);
+  arrayResize(_circleInstances, 0);
 
   // restore blending state if necessary
   if (doToggleBlend) {
@@ -207,35 +315,12 @@ void DebugLineRender::drawTransformedLine(const Magnum::Vector3& from,
 void DebugLineRender::drawBox(const Magnum::Vector3& min,
                               const Magnum::Vector3& max,
                               const Magnum::Color4& color) {
-  // 4 lines along x axis
-  drawTransformedLine(Mn::Vector3(min.x(), min.y(), min.z()),
-                      Mn::Vector3(max.x(), min.y(), min.z()), color);
-  drawTransformedLine(Mn::Vector3(min.x(), min.y(), max.z()),
-                      Mn::Vector3(max.x(), min.y(), max.z()), color);
-  drawTransformedLine(Mn::Vector3(min.x(), max.y(), min.z()),
-                      Mn::Vector3(max.x(), max.y(), min.z()), color);
-  drawTransformedLine(Mn::Vector3(min.x(), max.y(), max.z()),
-                      Mn::Vector3(max.x(), max.y(), max.z()), color);
-
-  // 4 lines along y axis
-  drawTransformedLine(Mn::Vector3(min.x(), min.y(), min.z()),
-                      Mn::Vector3(min.x(), max.y(), min.z()), color);
-  drawTransformedLine(Mn::Vector3(max.x(), min.y(), min.z()),
-                      Mn::Vector3(max.x(), max.y(), min.z()), color);
-  drawTransformedLine(Mn::Vector3(min.x(), min.y(), max.z()),
-                      Mn::Vector3(min.x(), max.y(), max.z()), color);
-  drawTransformedLine(Mn::Vector3(max.x(), min.y(), max.z()),
-                      Mn::Vector3(max.x(), max.y(), max.z()), color);
-
-  // 4 lines along z axis
-  drawTransformedLine(Mn::Vector3(min.x(), min.y(), min.z()),
-                      Mn::Vector3(min.x(), min.y(), max.z()), color);
-  drawTransformedLine(Mn::Vector3(max.x(), min.y(), min.z()),
-                      Mn::Vector3(max.x(), min.y(), max.z()), color);
-  drawTransformedLine(Mn::Vector3(min.x(), max.y(), min.z()),
-                      Mn::Vector3(min.x(), max.y(), max.z()), color);
-  drawTransformedLine(Mn::Vector3(max.x(), max.y(), min.z()),
-                      Mn::Vector3(max.x(), max.y(), max.z()), color);
+  // an instance of the unit cube, scaled to the box
+  arrayAppend(_boxInstances,
+              InstanceRecord{_cachedInputTransform *
+                                 Mn::Matrix4::translation(min) *
+                                 Mn::Matrix4::scaling(max - min),
+                             remapAlpha(color)});
 }
 
 void DebugLineRender::drawCircle(const Magnum::Vector3& pos,
@@ -248,8 +333,18 @@ void DebugLineRender::drawCircle(const Magnum::Vector3& pos,
                            ? Mn::Vector3(normal.y(), -normal.x(), 0)
                            : Mn::Vector3(0, -normal.z(), normal.y());
 
-  pushTransform(Mn::Matrix4::lookAt(pos, pos + normal, randomPerpVec) *
-                Mn::Matrix4::scaling(Mn::Vector3(radius, radius, 0.f)));
+  const Mn::Matrix4 circleTransform =
+      Mn::Matrix4::lookAt(pos, pos + normal, randomPerpVec) *
+      Mn::Matrix4::scaling(Mn::Vector3(radius, radius, 0.f));
+
+  if (numSegments == InstancedCircleSegments) {
+    arrayAppend(_circleInstances,
+                InstanceRecord{_cachedInputTransform * circleTransform,
+                               remapAlpha(color)});
+    return;
+  }
+
+  pushTransform(circleTransform);
 
   Mn::Vector3 prevPt;
   for (int seg = 0; seg <= numSegments; ++seg) {
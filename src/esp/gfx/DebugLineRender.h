@@ -29,9 +29,20 @@ namespace gfx {
  * addition, if you're interested to integrate Magnum's line-based primitives,
  * see src/deps/magnum/doc/generated/primitives.cpp and also this discussion:
  * https://github.com/facebookresearch/habitat-sim/pull/1349#discussion_r660092144
+ *
+ * Boxes and circles with the default segment count are drawn as instances of a
+ * unit primitive, so they cost one transform each instead of their line
+ * vertices. Geometry that doesn't change frame-to-frame, such as recorded
+ * trajectories, can be moved to a persistent GPU buffer with bakeStaticLines,
+ * after which it is drawn by every flushLines without being re-submitted.
  */
 class DebugLineRender {
  public:
+  /**
+   * @brief Segment count of circles drawn as instances, see drawCircle.
+   */
+  static constexpr int InstancedCircleSegments = 24;
+
   /**
    * @brief Constructor. This allocates GPU resources so it should persist
    * frame-to-frame (don't recreate it every frame).
@@ -69,6 +80,34 @@ class DebugLineRender {
                 const Magnum::Color4& fromColor,
                 const Magnum::Color4& toColor);
 
+  /**
+   * @brief Whether any lines were drawn since the last @ref flushLines or
+   * there are static lines, i.e. whether @ref flushLines draws anything.
+   */
+  bool hasPendingLines() const {
+    return !_verts.isEmpty() || !_boxInstances.isEmpty() ||
+           !_circleInstances.isEmpty() || !_staticVerts.isEmpty();
+  }
+
+  /**
+   * @brief Move everything drawn since the last @ref flushLines to the static
+   * lines, which are kept in a persistent GPU buffer and drawn by every
+   * following @ref flushLines until @ref clearStaticLines. Repeated calls
+   * append to the static lines; each call re-uploads them, so bake once and
+   * not every frame.
+   */
+  void bakeStaticLines();
+
+  /**
+   * @brief Remove all static lines, see @ref bakeStaticLines.
+   */
+  void clearStaticLines();
+
+  /**
+   * @brief Number of line vertices of the static lines.
+   */
+  std::size_t staticLineVertexCount() const { return _staticVerts.size(); }
+
   /**
    * @brief Submit lines to the GL renderer. Call this once per frame.
    * Because this uses transparency, you should ideally call this *after*
@@ -122,12 +161,13 @@ class DebugLineRender {
 
   /**
    * @brief Draw a circle in world-space or local-space (see pushTransform).
-   * The circle is an approximation; see numSegments.
+   * The circle is an approximation; see numSegments. Circles with
+   * @ref InstancedCircleSegments segments are drawn as instances.
    */
   void drawCircle(const Magnum::Vector3& pos,
                   float radius,
                   const Magnum::Color4& color,
-                  int numSegments = 24,
+                  int numSegments = InstancedCircleSegments,
                   const Magnum::Vector3& normal = Magnum::Vector3(0.0,
                                                                   1.0,
                                                                   0.0));
@@ -170,12 +210,36 @@ class DebugLineRender {
     Magnum::Color4 color;
   };
 
+  struct InstanceRecord {
+    Magnum::Matrix4 transform;
+    Magnum::Color4 color;
+  };
+
+  // append the lines of unitVerts transformed by each of the instances
+  static void appendInstanceLines(
+      Magnum::Containers::Array<VertexRecord>& verts,
+      Magnum::Containers::ArrayView<const Magnum::Vector3> unitVerts,
+      Magnum::Containers::ArrayView<const InstanceRecord> instances);
+
   struct GLResourceSet {
     Magnum::GL::Buffer buffer;
     Magnum::GL::Mesh mesh{Magnum::GL::MeshPrimitive::Lines};
+    Magnum::GL::Buffer staticBuffer;
+    Magnum::GL::Mesh staticMesh{Magnum::GL::MeshPrimitive::Lines};
+    // unit primitives and their per-instance transform and color
+    Magnum::GL::Buffer boxBuffer;
+    Magnum::GL::Buffer boxInstanceBuffer;
+    Magnum::GL::Mesh boxMesh{Magnum::GL::MeshPrimitive::Lines};
+    Magnum::GL::Buffer circleBuffer;
+    Magnum::GL::Buffer circleInstanceBuffer;
+    Magnum::GL::Mesh circleMesh{Magnum::GL::MeshPrimitive::Lines};
     Magnum::Shaders::FlatGL3D shader{
         Magnum::Shaders::FlatGL3D::Configuration{}.setFlags(
             Magnum::Shaders::FlatGL3D::Flag::VertexColor)};
+    Magnum::Shaders::FlatGL3D instancedShader{
+        Magnum::Shaders::FlatGL3D::Configuration{}.setFlags(
+            Magnum::Shaders::FlatGL3D::Flag::VertexColor |
+            Magnum::Shaders::FlatGL3D::Flag::InstancedTransformation)};
   };
 
   std::vector<Magnum::Matrix4> _inputTransformStack;
@@ -183,6 +247,11 @@ class DebugLineRender {
   float _internalLineWidth = 1.0f;
   std::unique_ptr<GLResourceSet> _glResources;
   Magnum::Containers::Array<VertexRecord> _verts;
+  Magnum::Containers::Array<InstanceRecord> _boxInstances;
+  Magnum::Containers::Array<InstanceRecord> _circleInstances;
+  Magnum::Containers::Array<VertexRecord> _staticVerts;
+  Magnum::Containers::Array<Magnum::Vector3> _unitBoxVerts;
+  Magnum::Containers::Array<Magnum::Vector3> _unitCircleVerts;
 };
 
 }  // namespace gfx
@@ -3,13 +3,84 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Drawable.h"
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Intersection.h>
+#include <cstring>
 #include "DrawableGroup.h"
+#include "RenderCamera.h"
+#include "esp/core/Hash.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
 namespace gfx {
+
+namespace {
+// Shader parameters of one light setup seen from one camera
+struct LightCacheEntry {
+  // copy of the light setup, to notice changes of it
+  LightSetup lights;
+  Mn::Matrix4 cameraMatrix;
+  Drawable::LightSpace space{};
+  bool hasObjectLights = false;
+  std::vector<Mn::Vector4> positions;
+  std::vector<Mn::Color3> colors;
+  std::vector<float> ranges;
+};
+
+// Scenes rarely use more than a few light setups at once
+constexpr std::size_t LightCacheSize = 4;
+
+struct LightCache {
+  LightCacheEntry entries[LightCacheSize];
+  std::size_t numEntries = 0;
+  // entry replaced on the next miss once all are used
+  std::size_t nextEntry = 0;
+  // positions of a setup with object lights, redone for each drawable
+  std::vector<Mn::Vector4> objectPositions;
+};
+
+// every thread rendering has its own cache
+thread_local LightCache lightCache;
+
+// A merged range of visible mesh clusters, in the layout the multi-draw takes
+struct ClusterDrawRange {
+#ifndef CORRADE_TARGET_32BIT
+  Mn::UnsignedLong
+#else
+  Mn::UnsignedInt
+#endif
+      indexOffsetInBytes;
+  Mn::UnsignedInt indexCount;
+};
+
+// reused by all drawables drawn on the thread, to not allocate per draw
+thread_local std::vector<ClusterDrawRange> clusterDrawRanges;
+
+Mn::Vector4 shaderLightPosition(const LightInfo& light,
+                                const Mn::Matrix4& transformationMatrix,
+                                const Mn::Matrix4& cameraMatrix,
+                                const Drawable::LightSpace space) {
+  Mn::Vector4 pos =
+      space == Drawable::LightSpace::Camera
+          ? getLightPositionRelativeToCamera(light, transformationMatrix,
+                                             cameraMatrix)
+          : getLightPositionRelativeToWorld(light, transformationMatrix,
+                                            cameraMatrix);
+  // flip directional lights to facilitate faster, non-forking calc in
+  // shader.  Leave non-directional lights unchanged
+  pos *= (pos[3] * 2) - 1;
+  return pos;
+}
+}  // namespace
+
 uint64_t Drawable::drawableIdCounter = 0;
 Drawable::Drawable(scene::SceneNode& node,
                    Magnum::GL::Mesh* mesh,
@@ -22,7 +93,6 @@ Drawable::Drawable(scene::SceneNode& node,
       drawableId_(drawableIdCounter++),
       lightSetup_(std::move(lightSetup)),
       skinData_(cfg.getSkinData()),
-      jointTransformations_(),
       mesh_(mesh) {
   // Every drawable scene node holds a reference to its drawable ID
   node_.setDrawableId(drawableId_);
@@ -31,6 +101,63 @@ Drawable::Drawable(scene::SceneNode& node,
   }
 }
 
+Drawable::LightShaderParameters Drawable::computeLightShaderParameters(
+    const Mn::Matrix4& transformationMatrix,
+    const Mn::Matrix4& cameraMatrix,
+    const LightSpace space) const {
+  const LightSetup& lights = *lightSetup_;
+  LightCache& cache = lightCache;
+
+  LightCacheEntry* entry = nullptr;
+  for (std::size_t i = 0; i != cache.numEntries; ++i) {
+    LightCacheEntry& candidate = cache.entries[i];
+    if (candidate.space == space && candidate.cameraMatrix == cameraMatrix &&
+        candidate.lights == lights) {
+      entry = &candidate;
+      break;
+    }
+  }
+
+  if (!entry) {
+    if (cache.numEntries < LightCacheSize) {
+      entry = &cache.entries[cache.numEntries++];
+    } else {
+      entry = &cache.entries[cache.nextEntry];
+      cache.nextEntry = (cache.nextEntry + 1) % LightCacheSize;
+    }
+    entry->lights = lights;
+    entry->cameraMatrix = cameraMatrix;
+    entry->space = space;
+    entry->hasObjectLights = false;
+    entry->positions.clear();
+    entry->colors.clear();
+    // TODO derive ranges appropriately?
+    entry->ranges.assign(lights.size(), Mn::Constants::inf());
+    for (const LightInfo& light : lights) {
+      // lights relative to the object are redone for each drawable below
+      entry->positions.push_back(
+          shaderLightPosition(light, Mn::Matrix4{}, cameraMatrix, space));
+      entry->colors.push_back(light.color);
+      entry->hasObjectLights |= light.model == LightPositionModel::Object;
+    }
+  }
+
+  LightShaderParameters parameters{entry->positions, entry->colors,
+                                   entry->ranges};
+  if (entry->hasObjectLights) {
+    cache.objectPositions.assign(entry->positions.begin(),
+                                 entry->positions.end());
+    for (std::size_t i = 0; i != lights.size(); ++i) {
+      if (lights[i].model == LightPositionModel::Object) {
+        cache.objectPositions[i] = shaderLightPosition(
+            lights[i], transformationMatrix, cameraMatrix, space);
+      }
+    }
+    parameters.positions = cache.objectPositions;
+  }
+  return parameters;
+}
+
 Drawable::~Drawable() {
   DrawableGroup* group = drawables();
   if (group) {
@@ -49,16 +176,188 @@ DrawableGroup* Drawable::drawables() {
   return static_cast<DrawableGroup*>(group);
 }
 
-void Drawable::buildSkinJointTransforms() {
+std::size_t Drawable::drawInstanced(
+    Corrade::Containers::ArrayView<const DrawableTransform> instances,
+    Mn::SceneGraph::Camera3D& camera) {
+  for (const DrawableTransform& instance : instances) {
+    instance.first.get().draw(instance.second, camera);
+  }
+  return instances.size();
+}
+
+void Drawable::drawDepthAndObjectId(const Mn::Matrix4& transformationMatrix,
+                                    Mn::SceneGraph::Camera3D& camera) {
+  draw(transformationMatrix, camera);
+}
+
+void Drawable::drawDepthAndObjectIdWith(
+    ShaderManager& shaderManager,
+    const Mn::Matrix4& transformationMatrix,
+    Mn::SceneGraph::Camera3D& camera,
+    Mn::Shaders::FlatGL3D::Flags objectIdFlags,
+    Mn::GL::Texture2D* objectIdTexture,
+    const Mn::Matrix3& textureMatrix,
+    bool doubleSided) {
+  const Mn::UnsignedInt jointCount =
+      skinData_ ? skinData_->skinData->skin->joints().size() : 0;
+  const Mn::UnsignedInt perVertexJointCount =
+      skinData_ ? skinData_->skinData->perVertexJointCount : 0;
+  Mn::Shaders::FlatGL3D::Flags flags =
+      Mn::Shaders::FlatGL3D::Flag::ObjectId | objectIdFlags;
+  if (objectIdFlags >= Mn::Shaders::FlatGL3D::Flag::ObjectIdTexture) {
+    flags |= Mn::Shaders::FlatGL3D::Flag::TextureTransformation;
+  }
+
+  Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::FlatGL3D>& shader =
+      depthAndObjectIdShader_;
+  if (!shader || shader->flags() != flags ||
+      shader->jointCount() != jointCount) {
+    shader =
+        shaderManager.get<Mn::GL::AbstractShaderProgram, Mn::Shaders::FlatGL3D>(
+            getShaderKey(
+                "DepthAndObjectId", 0,
+                static_cast<Mn::Shaders::FlatGL3D::Flags::UnderlyingType>(
+                    flags),
+                jointCount));
+    if (!shader) {
+      shaderManager.set<Mn::GL::AbstractShaderProgram>(
+          shader.key(),
+          new Mn::Shaders::FlatGL3D{
+              Mn::Shaders::FlatGL3D::Configuration{}
+                  .setFlags(flags)
+                  .setJointCount(jointCount, perVertexJointCount)},
+          Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
+    }
+    CORRADE_INTERNAL_ASSERT(shader && shader->flags() == flags);
+  }
+
+  // Flip winding direction to correct handle backface culling
+  const bool flipWinding =
+      transformationMatrix.rotationScaling().determinant() < 0;
+  if (flipWinding) {
+    Mn::GL::Renderer::setFrontFace(Mn::GL::Renderer::FrontFace::ClockWise);
+  }
+  const bool disableCulling = doubleSided && glIsEnabled(GL_CULL_FACE);
+  if (disableCulling) {
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+
+  (*shader)
+      .setTransformationProjectionMatrix(camera.projectionMatrix() *
+                                         transformationMatrix *
+                                         meshTransformation_)
+      // per-vertex and texture object ids need no uniform, as in draw()
+      .setObjectId(objectIdFlags
+                       ? 0
+                       : node_.getShaderObjectID(
+                             static_cast<RenderCamera&>(camera)
+                                 .getSemanticDataIDX()));
+  if (objectIdFlags >= Mn::Shaders::FlatGL3D::Flag::ObjectIdTexture) {
+    shader->setTextureMatrix(textureMatrix)
+        .bindObjectIdTexture(*objectIdTexture);
+  }
+  if (skinData_) {
+    shader->setJointMatrices(buildSkinJointTransforms(camera));
+  }
+
+  drawMesh(*shader, transformationMatrix, camera);
+
+  if (disableCulling) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+  if (flipWinding) {
+    Mn::GL::Renderer::setFrontFace(
+        Mn::GL::Renderer::FrontFace::CounterClockWise);
+  }
+}  // Drawable::drawDepthAndObjectIdWith
+
+void Drawable::drawMesh(Mn::GL::AbstractShaderProgram& shader,
+                        const Mn::Matrix4& transformationMatrix,
+                        Mn::SceneGraph::Camera3D& camera) {
+  Mn::GL::Mesh& mesh = getMesh();
+  if (!meshClusters_) {
+    shader.draw(mesh);
+    return;
+  }
+
+  // the frustum planes in mesh space, so the cluster boxes are tested as is
+  const Mn::Frustum frustum =
+      Mn::Frustum::fromMatrix(camera.projectionMatrix() * transformationMatrix);
+  const std::size_t indexSize = mesh.indexTypeSize();
+  std::vector<ClusterDrawRange>& ranges = clusterDrawRanges;
+  ranges.clear();
+  for (const MeshCluster& cluster : *meshClusters_) {
+    if (!Mn::Math::Intersection::rangeFrustum(cluster.aabb, frustum)) {
+      continue;
+    }
+    // clusters adjacent in the index buffer are drawn as one range
+    const std::size_t offset = cluster.indexOffset * indexSize;
+    if (!ranges.empty() && ranges.back().indexOffsetInBytes +
+                                   ranges.back().indexCount * indexSize ==
+                               offset) {
+      ranges.back().indexCount += cluster.indexCount;
+    } else {
+      ranges.push_back({offset, cluster.indexCount});
+    }
+  }
+  if (ranges.empty()) {
+    return;
+  }
+
+  const Cr::Containers::StridedArrayView1D<ClusterDrawRange> view =
+      Cr::Containers::arrayView(ranges);
+  shader.draw(mesh, view.slice(&ClusterDrawRange::indexCount), nullptr,
+              view.slice(&ClusterDrawRange::indexOffsetInBytes));
+}  // Drawable::drawMesh
+
+void Drawable::addSkinPoseToHash(core::Fnv1aHash& hash) const {
   if (!skinData_) {
     return;
   }
-  // Gather joint transformations
-  const auto& skin = skinData_->skinData->skin;
-  const auto& transformNodes = skinData_->jointIdToTransformNode;
+  // the joint palette is relative to the root node, which the drawable's own
+  // transformation already covers
+  const Mn::Matrix4 invRootTransform =
+      skinData_->rootArticulatedObjectNode->absoluteTransformationMatrix()
+          .inverted();
+  for (const auto& jointNode : skinData_->jointIdToTransformNode) {
+    hash.addWord(std::uint64_t(jointNode.first));
+    const Mn::Matrix4 jointTransform =
+        invRootTransform * jointNode.second->absoluteTransformationMatrix();
+    std::uint32_t words[16];
+    std::memcpy(words, jointTransform.data(), sizeof(words));
+    for (const std::uint32_t word : words) {
+      hash.addWord(word);
+    }
+  }
+}
 
-  ESP_CHECK(jointTransformations_.size() == skin->joints().size(),
-            "Joint transformation count doesn't match bone count.");
+const Corrade::Containers::Array<Mn::Matrix4>&
+Drawable::buildSkinJointTransforms(Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_INTERNAL_ASSERT(skinData_);
+  auto& palette = skinData_->jointTransformations;
+  // Other drawables of the instance already built it for this render pass
+  const std::uint64_t drawPass =
+      static_cast<RenderCamera&>(camera).getDrawPass();
+  if (drawPass && skinData_->jointTransformationsDrawPass == drawPass) {
+    return palette;
+  }
+  skinData_->jointTransformationsDrawPass = drawPass;
+
+  const auto& skin = skinData_->skinData->skin;
+  const auto joints = skin->joints();
+  auto& jointNodes = skinData_->jointTransformNodes;
+  if (jointNodes.size() != joints.size()) {
+    // Resolve the joint nodes once instead of a lookup per joint and draw
+    const auto& transformNodes = skinData_->jointIdToTransformNode;
+    jointNodes.assign(joints.size(), nullptr);
+    for (std::size_t i = 0; i != joints.size(); ++i) {
+      const auto jointNodeIt = transformNodes.find(joints[i]);
+      if (jointNodeIt != transformNodes.end()) {
+        jointNodes[i] = jointNodeIt->second;
+      }
+    }
+    Corrade::Containers::arrayResize(palette, joints.size());
+  }
 
   // Undo root node transform so that the model origin matches the root
   // articulated object link.
@@ -66,26 +365,19 @@ void Drawable::buildSkinJointTransforms() {
       skinData_->rootArticulatedObjectNode->absoluteTransformationMatrix()
           .inverted();
 
-  for (std::size_t i = 0; i != jointTransformations_.size(); ++i) {
-    const auto jointNodeIt = transformNodes.find(skin->joints()[i]);
-    if (jointNodeIt != transformNodes.end()) {
-      jointTransformations_[i] =
-          invRootTransform *
-          jointNodeIt->second->absoluteTransformationMatrix() *
-          skin->inverseBindMatrices()[i];
+  const auto inverseBindMatrices = skin->inverseBindMatrices();
+  for (std::size_t i = 0; i != palette.size(); ++i) {
+    if (jointNodes[i]) {
+      palette[i] = invRootTransform *
+                   jointNodes[i]->absoluteTransformationMatrix() *
+                   inverseBindMatrices[i];
     } else {
       // Joint not found, use placeholder matrix.
-      jointTransformations_[i] = Mn::Matrix4{Mn::Math::IdentityInit};
+      palette[i] = Mn::Matrix4{Mn::Math::IdentityInit};
     }
   }
-
+  return palette;
 }  // Drawable::buildSkinJointTransforms
 
-void Drawable::resizeJointTransformArray(Mn::UnsignedInt jointCount) {
-  if (jointTransformations_.size() != jointCount) {
-    Corrade::Containers::arrayResize(jointTransformations_, jointCount);
-  }
-}
-
 }  // namespace gfx
 }  // namespace esp
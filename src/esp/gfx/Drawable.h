@@ -5,16 +5,29 @@
 #ifndef ESP_GFX_DRAWABLE_H_
 #define ESP_GFX_DRAWABLE_H_
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/EnumSet.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/GL/GL.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/Shaders/FlatGL.h>
 #include <Magnum/Trade/MaterialData.h>
 #include "esp/core/Esp.h"
 #include "esp/gfx/DrawableConfiguration.h"
+#include "esp/gfx/MeshCluster.h"
+#include "esp/gfx/ShaderManager.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace esp {
+namespace core {
+class Fnv1aHash;
+}
 namespace scene {
 class SceneNode;
 }
@@ -23,6 +36,19 @@ namespace gfx {
 struct InstanceSkinData;
 class DrawableGroup;
 
+/**
+ * @brief GL state a @ref Drawable binds when it is drawn. Used to order draw
+ * submission so that drawables sharing state are drawn back to back.
+ */
+struct DrawState {
+  /** @brief Shader program of the last draw, nullptr if not known yet */
+  const Magnum::GL::AbstractShaderProgram* shader = nullptr;
+  /** @brief Identifies the material, nullptr for drawables without one */
+  const void* material = nullptr;
+  /** @brief The GL mesh */
+  const Magnum::GL::Mesh* mesh = nullptr;
+};
+
 enum class DrawableType : uint8_t {
   None = 0,
   Generic = 1,
@@ -62,6 +88,11 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   /** @brief Flags */
   typedef Corrade::Containers::EnumSet<Flag> Flags;
 
+  /** @brief A drawable and its transformation relative to the camera */
+  typedef std::pair<std::reference_wrapper<Magnum::SceneGraph::Drawable3D>,
+                    Magnum::Matrix4>
+      DrawableTransform;
+
   /// @brief Key template for entry in shader map
   static constexpr const char* SHADER_KEY_TEMPLATE =
       "{}-lights={}-flags={}-joints={}";
@@ -96,6 +127,15 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    */
   uint64_t getDrawableId() const { return drawableId_; }
 
+  /**
+   * @brief Add the pose of the skinned instance the drawable belongs to, if
+   * any, to @p hash
+   *
+   * Skinned drawables are posed from their joint nodes rather than their own
+   * node, so their transformation alone doesn't tell whether they moved.
+   */
+  void addSkinPoseToHash(core::Fnv1aHash& hash) const;
+
   /**
    * @brief setup the lights.
    * NOTE: sub-class should override this function
@@ -119,6 +159,85 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   /** @brief get the drawable type */
   DrawableType getDrawableType() const { return type_; }
 
+  /**
+   * @brief Draw only the clusters of the mesh that intersect the view frustum
+   *
+   * @param clusters Index ranges of the mesh, sorted by their offset, or
+   * nullptr to always draw the whole mesh.
+   *
+   * The visible clusters are drawn with a single multi-draw call, so a large
+   * mesh doesn't need to be split into many drawables to be culled.
+   */
+  void setMeshClusters(
+      std::shared_ptr<const std::vector<MeshCluster>> clusters) {
+    meshClusters_ = std::move(clusters);
+  }
+
+  /** @brief The clusters set with @ref setMeshClusters(), if any */
+  const std::shared_ptr<const std::vector<MeshCluster>>& getMeshClusters()
+      const {
+    return meshClusters_;
+  }
+
+  /**
+   * @brief Set a transformation applied to the mesh positions before the
+   * drawable's own transformation
+   *
+   * Used for meshes with quantized positions, see
+   * @ref assets::BaseMesh::getPositionDequantization(). Expected to be a
+   * translation and uniform scaling, normals and lights aren't affected.
+   * Identity by default.
+   */
+  void setMeshTransformation(const Magnum::Matrix4& transformation) {
+    meshTransformation_ = transformation;
+  }
+
+  /** @brief The transformation set with @ref setMeshTransformation() */
+  const Magnum::Matrix4& getMeshTransformation() const {
+    return meshTransformation_;
+  }
+
+  /** @brief get the GL state this drawable binds when drawn */
+  DrawState getDrawState() const {
+    return {shaderProgram_, materialStateKey_, mesh_};
+  }
+
+  /**
+   * @brief Whether this drawable can be drawn in the same instanced draw call
+   * as @p other, see @ref drawInstanced(). False by default.
+   */
+  virtual bool canDrawInstancedWith(CORRADE_UNUSED Drawable& other) {
+    return false;
+  }
+
+  /**
+   * @brief Draw several drawables sharing this drawable's mesh, material and
+   * shader at once
+   *
+   * @param instances The drawables, each of which @ref canDrawInstancedWith()
+   * this one, and their transformations relative to @p camera.
+   * @param camera Camera to draw from.
+   * @return The number of draw calls issued.
+   *
+   * The default implementation draws every instance separately.
+   */
+  virtual std::size_t drawInstanced(
+      Corrade::Containers::ArrayView<const DrawableTransform> instances,
+      Magnum::SceneGraph::Camera3D& camera);
+
+  /**
+   * @brief Draw only depth and the object ID, for @ref
+   * RenderCamera::Flag::DepthAndObjectIdOnly
+   *
+   * @param transformationMatrix Transformation relative to camera.
+   * @param camera Camera to draw from.
+   *
+   * Skips the material, light and texture setup, except for an object ID
+   * texture. The default implementation does a full draw.
+   */
+  virtual void drawDepthAndObjectId(const Magnum::Matrix4& transformationMatrix,
+                                    Magnum::SceneGraph::Camera3D& camera);
+
   /**
    * @brief Get the Magnum GL mesh for visualization, highlighting (e.g., used
    * in object picking)
@@ -157,6 +276,22 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
     setMaterialValuesInternal(material, true);
   }
 
+  /**
+   * @brief Space the shader expects the light positions in
+   */
+  enum class LightSpace : uint8_t {
+    /**
+     * Relative to the camera, see
+     * @ref esp::gfx::getLightPositionRelativeToCamera()
+     */
+    Camera,
+    /**
+     * Relative to the world, see
+     * @ref esp::gfx::getLightPositionRelativeToWorld()
+     */
+    World
+  };
+
  private:
   /**
    * Set or change this drawable's @ref Magnum::Trade::MaterialData values from passed material.
@@ -171,10 +306,6 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
       CORRADE_UNUSED bool reset) {}
 
  protected:
-  /**
-   * @brief resize the jointTransformArray_
-   */
-  void resizeJointTransformArray(Mn::UnsignedInt jointCount);
   /**
    * @brief Draw the object using given camera
    *
@@ -196,9 +327,13 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    * @param flags The flags used by the owning drawable.
    * @param jointCount The number of joints if an articulated object with a
    * skin, 0 otherwise
+   *
+   * Builds a string, so drawables look up their shader with it only when
+   * their flags or light count change and keep the resolved resource
+   * otherwise.
    */
   template <class FlagsType>
-  std::string getShaderKey(const std::string& shaderType,
+  std::string getShaderKey(const char* shaderType,
                            Magnum::UnsignedInt lightCount,
                            FlagsType flags,
                            Magnum::UnsignedInt jointCount) const {
@@ -207,9 +342,70 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   }
 
   /**
-   * @brief Build the joint transformations on every draw if skinData exists
+   * @brief Draw the mesh with a flat shader from @p shaderManager that
+   * outputs only depth and object IDs, see @ref drawDepthAndObjectId()
+   *
+   * @param shaderManager The manager the shader is cached in.
+   * @param transformationMatrix Transformation relative to camera.
+   * @param camera Camera to draw from.
+   * @param objectIdFlags @ref
+   * Magnum::Shaders::FlatGL3D::Flag::InstancedObjectId for per-vertex object
+   * IDs, @ref Magnum::Shaders::FlatGL3D::Flag::ObjectIdTexture for IDs from
+   * @p objectIdTexture, or empty for the ID of the node.
+   * @param objectIdTexture The object ID texture, if any.
+   * @param textureMatrix Transformation of the object ID texture coordinates.
+   * @param doubleSided Whether to draw back faces too.
+   */
+  void drawDepthAndObjectIdWith(ShaderManager& shaderManager,
+                                const Mn::Matrix4& transformationMatrix,
+                                Mn::SceneGraph::Camera3D& camera,
+                                Mn::Shaders::FlatGL3D::Flags objectIdFlags,
+                                Mn::GL::Texture2D* objectIdTexture,
+                                const Mn::Matrix3& textureMatrix,
+                                bool doubleSided);
+
+  /**
+   * @brief Draw the mesh with @p shader, culling its clusters against the
+   * frustum of @p camera if set with @ref setMeshClusters()
+   */
+  void drawMesh(Mn::GL::AbstractShaderProgram& shader,
+                const Mn::Matrix4& transformationMatrix,
+                Mn::SceneGraph::Camera3D& camera);
+
+  /**
+   * @brief Build the joint transformations of the skinned instance for the
+   * render pass of @p camera
+   *
+   * The palette is shared by all drawables of the instance, so it's computed
+   * only by the first of them drawn in each render pass.
+   */
+  const Corrade::Containers::Array<Magnum::Matrix4>& buildSkinJointTransforms(
+      Mn::SceneGraph::Camera3D& camera);
+
+  /**
+   * @brief Light positions, colors and ranges of @ref lightSetup_ in the
+   * form the shaders take them
    */
-  void buildSkinJointTransforms();
+  struct LightShaderParameters {
+    Corrade::Containers::ArrayView<const Mn::Vector4> positions;
+    Corrade::Containers::ArrayView<const Mn::Color3> colors;
+    Corrade::Containers::ArrayView<const float> ranges;
+  };
+
+  /**
+   * @brief Compute the shader parameters of @ref lightSetup_
+   *
+   * The parameters are computed once per light setup, camera matrix and
+   * @p space, and shared by all drawables drawn with them on the calling
+   * thread, so that drawing thousands of drawables doesn't rebuild and
+   * transform the lights for each of them. Only lights positioned relative
+   * to the object are transformed per drawable. The views stay valid until
+   * the next call on the same thread.
+   */
+  LightShaderParameters computeLightShaderParameters(
+      const Mn::Matrix4& transformationMatrix,
+      const Mn::Matrix4& cameraMatrix,
+      LightSpace space) const;
 
   /**
    * @brief Update lighting-related parameters on every draw call
@@ -219,20 +415,15 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    * drawables draw function.
    * @param camera The camera passed to this drawable's draw function
    * @param shader The shader this drawable consumes.
-   * @param getLightPosition The function to query for each light to acquire its
-   * proper position in the world. Flat/Phong objects query
-   * esp::gfx::getLightPositionRelativeToCamera(), while PBR objects query
-   * esp::gfx::getLightPositionRelativeToWorld()
+   * @param space The space the shader expects the light positions in.
+   * Flat/Phong objects use @ref LightSpace::Camera, while PBR objects use
+   * @ref LightSpace::World.
    */
   template <class ShaderType>
-  void updateShaderLightingParameters(
-      const Mn::Matrix4& transformationMatrix,
-      Mn::SceneGraph::Camera3D& camera,
-      ShaderType shader,
-      const std::function<Magnum::Vector4(const LightInfo&,
-                                          const Magnum::Matrix4&,
-                                          const Magnum::Matrix4&)>&
-          getLightPosition);
+  void updateShaderLightingParameters(const Mn::Matrix4& transformationMatrix,
+                                      Mn::SceneGraph::Camera3D& camera,
+                                      ShaderType shader,
+                                      LightSpace space);
 
   /**
    * @brief Drawable-specific update called at the end of
@@ -251,12 +442,27 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
 
   std::shared_ptr<InstanceSkinData> skinData_{nullptr};
 
-  Corrade::Containers::Array<Magnum::Matrix4> jointTransformations_;
-
   bool glMeshExists() const { return mesh_ != nullptr; }
 
+  //! shader program and material reported by getDrawState(), to be set by
+  //! sub-classes whenever they change
+  const Magnum::GL::AbstractShaderProgram* shaderProgram_ = nullptr;
+  const void* materialStateKey_ = nullptr;
+
  private:
   Magnum::GL::Mesh* mesh_ = nullptr;
+
+  //! see setMeshClusters()
+  std::shared_ptr<const std::vector<MeshCluster>> meshClusters_;
+
+  //! see setMeshTransformation()
+  Magnum::Matrix4 meshTransformation_;
+
+  //! shader of drawDepthAndObjectIdWith(), fetched again only when the
+  //! flags or joint count it needs change
+  Magnum::Resource<Magnum::GL::AbstractShaderProgram,
+                   Magnum::Shaders::FlatGL3D>
+      depthAndObjectIdShader_;
 };
 
 CORRADE_ENUMSET_OPERATORS(Drawable::Flags)
@@ -266,47 +472,13 @@ void Drawable::updateShaderLightingParameters(
     const Mn::Matrix4& transformationMatrix,
     Mn::SceneGraph::Camera3D& camera,
     ShaderType shader,
-    const std::function<Magnum::Vector4(const LightInfo&,
-                                        const Magnum::Matrix4&,
-                                        const Magnum::Matrix4&)>&
-        getLightPosition) {
-  const Mn::Matrix4 cameraMatrix = camera.cameraMatrix();
-
-  std::vector<Mn::Vector4> lightPositions;
-  lightPositions.reserve(lightSetup_->size());
-  std::vector<Mn::Color3> lightColors;
-  lightColors.reserve(lightSetup_->size());
-  // TODO derive ranges appropriately?
-  constexpr float dummyRange = Mn::Constants::inf();
-  std::vector<float> lightRanges(lightSetup_->size(), dummyRange);
-
-  // std::vector<Mn::Color3> lightSpecularColors;
-  // lightSpecularColors.reserve(lightSetup_->size());
-
-  for (Mn::UnsignedInt i = 0; i < lightSetup_->size(); ++i) {
-    const auto& lightInfo = (*lightSetup_)[i];
-    Mn::Vector4 pos =
-        getLightPosition(lightInfo, transformationMatrix, cameraMatrix);
-    // flip directional lights to facilitate faster, non-forking calc in
-    // shader.  Leave non-directional lights unchanged
-    pos *= (pos[3] * 2) - 1;
-    lightPositions.emplace_back(pos);
-
-    const auto& lightColor = (*lightSetup_)[i].color;
-    lightColors.emplace_back(lightColor);
-
-    // In general, a light's specular color should match its base color.
-    // However, negative lights have zero (black) specular.
-    // constexpr Mn::Color3 blackColor(0.0, 0.0, 0.0);
-    // bool isNegativeLight = (lightColor.r() < 0 || lightColor.g() < 0 ||
-    // lightColor.b() < 0); lightSpecularColors.emplace_back(isNegativeLight ?
-    // blackColor : lightColor);
-  }
+    const LightSpace space) {
+  const LightShaderParameters lights = computeLightShaderParameters(
+      transformationMatrix, camera.cameraMatrix(), space);
   (*shader)
-      //.setLightSpecularColors(lightSpecularColors)
-      .setLightPositions(lightPositions)
-      .setLightColors(lightColors)
-      .setLightRanges(lightRanges);
+      .setLightPositions(lights.positions)
+      .setLightColors(lights.colors)
+      .setLightRanges(lights.ranges);
 
   updateShaderLightingParametersInternal();
 }
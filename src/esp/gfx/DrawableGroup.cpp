@@ -37,6 +37,13 @@ Drawable* DrawableGroup::getDrawable(uint64_t id) const {
   return nullptr;
 }
 
+Magnum::GL::Buffer& DrawableGroup::getInstanceBuffer() {
+  if (!instanceBuffer_.id()) {
+    instanceBuffer_ = Magnum::GL::Buffer{};
+  }
+  return instanceBuffer_;
+}
+
 bool DrawableGroup::registerDrawable(Drawable& drawable) {
   // if it is already registered, emplace will do nothing
   return idToDrawable_.emplace(drawable.getDrawableId(), &drawable).second;
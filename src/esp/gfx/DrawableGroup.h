@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_DRAWABLEGROUP_H_
 #define ESP_GFX_DRAWABLEGROUP_H_
 
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/FeatureGroup.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
@@ -64,6 +65,13 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
    */
   virtual bool prepareForDraw(const RenderCamera&) { return true; }
 
+  /**
+   * @brief Buffer holding the per-instance data of instanced draws of
+   * drawables in this group, see @ref Drawable::drawInstanced(). Created on
+   * first use.
+   */
+  Magnum::GL::Buffer& getInstanceBuffer();
+
  protected:
   /**
    * Why a friend class here?
@@ -87,6 +95,8 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
    * a lookup table, that maps a drawable id to the drawable object
    */
   std::unordered_map<uint64_t, Drawable*> idToDrawable_;
+
+  Magnum::GL::Buffer instanceBuffer_{Magnum::NoCreate};
   ESP_SMART_POINTERS(DrawableGroup)
 };
 
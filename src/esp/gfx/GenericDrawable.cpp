@@ -124,6 +124,7 @@ void GenericDrawable::setMaterialValuesInternal(
   if (!reset) {
     flags_ = oldFlags;
   }
+  materialStateKey_ = &*materialData;
 
 }  // GenericDrawable::setMaterialValuesInternal
 
@@ -155,13 +156,7 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
   // In Drawable.h
   // Phong uses light position relative to camera
   updateShaderLightingParameters(transformationMatrix, camera, shader_,
-                                 [](const LightInfo& lightInfo,
-                                    const Magnum::Matrix4& transformationMatrix,
-                                    const Magnum::Matrix4& cameraMatrix) {
-                                   return getLightPositionRelativeToCamera(
-                                       lightInfo, transformationMatrix,
-                                       cameraMatrix);
-                                 });
+                                 LightSpace::Camera);
 
   Mn::Matrix3x3 rotScale = transformationMatrix.rotationScaling();
   // Find determinant to calculate backface culling winding dir
@@ -189,7 +184,7 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
               ? 0
               : node_.getShaderObjectID(
                     static_cast<RenderCamera&>(camera).getSemanticDataIDX()))
-      .setTransformationMatrix(transformationMatrix)
+      .setTransformationMatrix(transformationMatrix * getMeshTransformation())
       .setProjectionMatrix(camera.projectionMatrix())
       .setNormalMatrix(normalMatrix);
 
@@ -214,11 +209,10 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
   }
 
   if (skinData_) {
-    buildSkinJointTransforms();
-    shader_->setJointMatrices(jointTransformations_);
+    shader_->setJointMatrices(buildSkinJointTransforms(camera));
   }
 
-  shader_->draw(getMesh());
+  drawMesh(*shader_, transformationMatrix, camera);
 
   // Reset winding direction
   if (normalDet < 0) {
@@ -227,6 +221,24 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
   }
 }
 
+void GenericDrawable::drawDepthAndObjectId(
+    const Mn::Matrix4& transformationMatrix,
+    Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(
+      glMeshExists(),
+      "GenericDrawable::drawDepthAndObjectId() : GL mesh doesn't exist", );
+
+  Mn::Shaders::FlatGL3D::Flags objectIdFlags;
+  if (flags_ >= Mn::Shaders::PhongGL::Flag::InstancedObjectId) {
+    objectIdFlags |= Mn::Shaders::FlatGL3D::Flag::InstancedObjectId;
+  } else if (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture) {
+    objectIdFlags |= Mn::Shaders::FlatGL3D::Flag::ObjectIdTexture;
+  }
+  drawDepthAndObjectIdWith(shaderManager_, transformationMatrix, camera,
+                           objectIdFlags, matCache.objectIdTexture,
+                           matCache.textureMatrix, false);
+}
+
 void GenericDrawable::updateShader() {
   const Mn::UnsignedInt lightCount = lightSetup_->size();
   const Mn::UnsignedInt jointCount =
@@ -234,10 +246,6 @@ void GenericDrawable::updateShader() {
   const Mn::UnsignedInt perVertexJointCount =
       skinData_ ? skinData_->skinData->perVertexJointCount : 0;
 
-  if (skinData_) {
-    resizeJointTransformArray(jointCount);
-  }
-
   if (!shader_ || shader_->lightCount() != lightCount ||
       shader_->flags() != flags_) {
     // if the number of lights or flags have changed, we need to fetch a
@@ -265,6 +273,7 @@ void GenericDrawable::updateShader() {
     CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
                             shader_->flags() == flags_);
   }
+  shaderProgram_ = &*shader_;
 }
 
 }  // namespace gfx
@@ -47,6 +47,13 @@ class GenericDrawable : public Drawable {
 
   void setLightSetup(const Mn::ResourceKey& lightSetupKey) override;
 
+  /**
+   * @brief Draw only depth and the object ID with a flat shader, without
+   * binding the material textures and lights
+   */
+  void drawDepthAndObjectId(const Mn::Matrix4& transformationMatrix,
+                            Mn::SceneGraph::Camera3D& camera) override;
+
  private:
   /**
    * @brief Internal implementation of material setting, so that it can be
@@ -0,0 +1,32 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GpuProfile.h"
+
+#include <chrono>
+
+#include "esp/core/Profiler.h"
+
+namespace esp {
+namespace gfx {
+
+GpuProfile::GpuProfile(const char* section, const std::size_t queryCount)
+    : section_{section}, timer_{queryCount} {}
+
+void GpuProfile::begin() {
+  core::Profiler& profiler = core::Profiler::global();
+  while (const auto duration = timer_.takeDuration()) {
+    profiler.recordDuration(section_, std::chrono::nanoseconds{*duration});
+  }
+  if (profiler.isEnabled() && profiler.isGpuTimersEnabled()) {
+    timer_.begin();
+  }
+}
+
+void GpuProfile::end() {
+  timer_.end();
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,70 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_GPUPROFILE_H_
+#define ESP_GFX_GPUPROFILE_H_
+
+#include <cstddef>
+
+#include "esp/gfx_batch/GpuTimer.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Records the GPU durations of a render stage to the global
+@ref core::Profiler
+
+Measures the stage with a @ref gfx_batch::GpuTimer if both
+@ref core::Profiler::isEnabled() and @ref core::Profiler::isGpuTimersEnabled()
+are set, and records finished measurements of earlier frames as samples of
+the section on the next @ref begin(). The samples thus lag a frame or two
+behind the CPU sections, and the last ones of a run are never recorded.
+
+Belongs to the GL context current on the first measurement, see
+@ref gfx_batch::GpuTimer.
+*/
+class GpuProfile {
+ public:
+  /**
+   * @brief Constructor
+   * @param section     Section name, has to outlive the profiler, see
+   *    @ref core::Profiler::record()
+   * @param queryCount  How many measurements can be in flight at once
+   */
+  explicit GpuProfile(const char* section, std::size_t queryCount = 3);
+
+  /** @brief Record finished measurements and begin measuring the stage */
+  void begin();
+
+  /** @brief End measuring the stage begun with @ref begin() */
+  void end();
+
+ private:
+  const char* section_;
+  gfx_batch::GpuTimer timer_;
+};
+
+/**
+@brief Measures the lifetime of the instance with a @ref GpuProfile
+*/
+class ScopedGpuProfile {
+ public:
+  explicit ScopedGpuProfile(GpuProfile& profile) : profile_(profile) {
+    profile_.begin();
+  }
+
+  ScopedGpuProfile(const ScopedGpuProfile&) = delete;
+  ScopedGpuProfile& operator=(const ScopedGpuProfile&) = delete;
+
+  ~ScopedGpuProfile() { profile_.end(); }
+
+ private:
+  GpuProfile& profile_;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_GPUPROFILE_H_
@@ -0,0 +1,226 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LightClusters.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferTextureFormat.h>
+#endif
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+// squared distance of value to the [min, max] range
+float distanceSquaredToRange(const float value,
+                             const float min,
+                             const float max) {
+  const float d = value < min ? min - value : std::max(value - max, 0.0f);
+  return d * d;
+}
+}  // namespace
+
+bool LightClusters::isClusteringUseful(const LightSetup& lights) {
+  if (lights.size() < MinLightCount) {
+    return false;
+  }
+  for (const LightInfo& light : lights) {
+    if (light.model == LightPositionModel::Object) {
+      return false;
+    }
+  }
+  return true;
+}
+
+float LightClusters::lightRange(const LightInfo& light) {
+  if (light.vector.w() == 0.0f) {
+    return Infinity;
+  }
+  return std::sqrt(std::max(light.color.max(), 0.0f) / IrradianceCutoff);
+}
+
+void LightClusters::build(const LightSetup& lights,
+                          const Mn::Matrix4& cameraMatrix,
+                          const Mn::Matrix4& projectionMatrix) {
+  const std::size_t lightCount = lights.size();
+  lightRanges_.resize(lightCount);
+  lightSpheres_.resize(lightCount);
+  for (std::size_t i = 0; i != lightCount; ++i) {
+    lightRanges_[i] = lightRange(lights[i]);
+    const Mn::Vector4 position = getLightPositionRelativeToCamera(
+        lights[i], Mn::Matrix4{}, cameraMatrix);
+    // lights are tested in (x, y, depth) space, depth being -z
+    lightSpheres_[i] = {position.x(), position.y(), -position.z(),
+                        position.w() == 0.0f ? Infinity : lightRanges_[i]};
+  }
+  depthPlane_ = -cameraMatrix.row(2);
+
+  // near and far plane of a perspective projection
+  const float a = projectionMatrix[2][2];
+  const float b = projectionMatrix[3][2];
+  const float near = b / (a - 1.0f);
+  const float far = b / (a + 1.0f);
+  if (projectionMatrix[2][3] != -1.0f || !(near > 0.0f) || !(far > near) ||
+      far == Infinity) {
+    // a single cluster with all lights, which the tile and slice scales of
+    // zero map every fragment to
+    clusters_.assign(1, {0, Mn::UnsignedInt(lightCount)});
+    lightIndices_.resize(lightCount);
+    std::iota(lightIndices_.begin(), lightIndices_.end(), 0u);
+    sliceScaleBias_ = {};
+    return;
+  }
+
+  const float sliceScale = DepthSlices / std::log(far / near);
+  sliceScaleBias_ = {sliceScale, -std::log(near) * sliceScale};
+  const auto sliceOf = [&](const float depth) {
+    const float slice = std::log(depth) * sliceScale + sliceScaleBias_.y();
+    return Mn::UnsignedInt(
+        std::min(std::max(slice, 0.0f), float(DepthSlices - 1)));
+  };
+  float sliceDepths[DepthSlices + 1];
+  for (Mn::UnsignedInt k = 0; k <= DepthSlices; ++k) {
+    sliceDepths[k] = near * std::pow(far / near, float(k) / DepthSlices);
+  }
+
+  // view-space x and y of the tile edges are their slope times the depth,
+  // including the offset of off-center projections
+  float slopesX[TilesX + 1];
+  float slopesY[TilesY + 1];
+  for (Mn::UnsignedInt i = 0; i <= TilesX; ++i) {
+    slopesX[i] = (-1.0f + 2.0f * i / TilesX + projectionMatrix[2][0]) /
+                 projectionMatrix[0][0];
+  }
+  for (Mn::UnsignedInt i = 0; i <= TilesY; ++i) {
+    slopesY[i] = (-1.0f + 2.0f * i / TilesY + projectionMatrix[2][1]) /
+                 projectionMatrix[1][1];
+  }
+  // extent of the tile between two edges in the depth range [d0, d1]
+  const auto tileRange = [](const float* slopes, const Mn::UnsignedInt i,
+                            const float d0, const float d1) {
+    return Mn::Vector2{slopes[i] * (slopes[i] < 0.0f ? d1 : d0),
+                       slopes[i + 1] * (slopes[i + 1] > 0.0f ? d1 : d0)};
+  };
+
+  // calls visit(cluster, light) for every light overlapping a cluster, in
+  // the order of the lights
+  const auto forEachClusterLight = [&](auto&& visit) {
+    for (Mn::UnsignedInt light = 0; light != lightCount; ++light) {
+      const Mn::Vector4& sphere = lightSpheres_[light];
+      const float radius = sphere.w();
+      if (radius == Infinity) {
+        for (Mn::UnsignedInt cluster = 0; cluster != ClusterCount; ++cluster) {
+          visit(cluster, light);
+        }
+        continue;
+      }
+      if (sphere.z() + radius < near || sphere.z() - radius > far) {
+        continue;
+      }
+      const float radiusSquared = radius * radius;
+      const Mn::UnsignedInt firstSlice =
+          sliceOf(std::max(sphere.z() - radius, near));
+      const Mn::UnsignedInt lastSlice =
+          sliceOf(std::min(sphere.z() + radius, far));
+      for (Mn::UnsignedInt k = firstSlice; k <= lastSlice; ++k) {
+        const float d0 = sliceDepths[k];
+        const float d1 = sliceDepths[k + 1];
+        const float dz = distanceSquaredToRange(sphere.z(), d0, d1);
+        for (Mn::UnsignedInt y = 0; y != TilesY; ++y) {
+          const Mn::Vector2 rangeY = tileRange(slopesY, y, d0, d1);
+          const float dyz =
+              dz + distanceSquaredToRange(sphere.y(), rangeY[0], rangeY[1]);
+          if (dyz > radiusSquared) {
+            continue;
+          }
+          for (Mn::UnsignedInt x = 0; x != TilesX; ++x) {
+            const Mn::Vector2 rangeX = tileRange(slopesX, x, d0, d1);
+            if (dyz + distanceSquaredToRange(sphere.x(), rangeX[0],
+                                             rangeX[1]) <= radiusSquared) {
+              visit(clusterIndex(x, y, k), light);
+            }
+          }
+        }
+      }
+    }
+  };
+
+  // count the lights of each cluster, then fill the lists at the prefix sums
+  clusterLightCounts_.assign(ClusterCount, 0);
+  forEachClusterLight([&](const Mn::UnsignedInt cluster, Mn::UnsignedInt) {
+    ++clusterLightCounts_[cluster];
+  });
+  clusters_.resize(ClusterCount);
+  Mn::UnsignedInt offset = 0;
+  for (Mn::UnsignedInt cluster = 0; cluster != ClusterCount; ++cluster) {
+    clusters_[cluster] = {offset, 0};
+    offset += clusterLightCounts_[cluster];
+  }
+  lightIndices_.resize(offset);
+  forEachClusterLight(
+      [&](const Mn::UnsignedInt cluster, const Mn::UnsignedInt light) {
+        Mn::Vector2ui& entry = clusters_[cluster];
+        lightIndices_[entry[0] + entry[1]++] = light;
+      });
+}
+
+#ifndef MAGNUM_TARGET_GLES
+void LightClusters::update(const LightSetup& lights,
+                           const Mn::Matrix4& cameraMatrix,
+                           const Mn::Matrix4& projectionMatrix,
+                           const Mn::Vector2i& viewport) {
+  if (updated_ && lights == updatedLights_ &&
+      cameraMatrix == updatedCameraMatrix_ &&
+      projectionMatrix == updatedProjectionMatrix_ &&
+      viewport == updatedViewport_) {
+    return;
+  }
+  updated_ = true;
+  updatedLights_ = lights;
+  updatedCameraMatrix_ = cameraMatrix;
+  updatedProjectionMatrix_ = projectionMatrix;
+  updatedViewport_ = viewport;
+
+  build(lights, cameraMatrix, projectionMatrix);
+  tileScale_ = clusters_.size() == 1
+                   ? Mn::Vector2{}
+                   : Mn::Vector2{float(TilesX), float(TilesY)} /
+                         Mn::Vector2{viewport};
+
+  if (!clusterTexture_.id()) {
+    clusterBuffer_ = Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::Texture};
+    lightIndexBuffer_ = Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::Texture};
+    clusterTexture_ = Mn::GL::BufferTexture{};
+    lightIndexTexture_ = Mn::GL::BufferTexture{};
+  }
+  clusterBuffer_.setData(clusters_, Mn::GL::BufferUsage::StreamDraw);
+  // buffer textures can't be empty, keep an unused index if there are none
+  if (lightIndices_.empty()) {
+    const Mn::UnsignedInt unused = 0;
+    lightIndexBuffer_.setData(Cr::Containers::arrayView(&unused, 1),
+                              Mn::GL::BufferUsage::StreamDraw);
+  } else {
+    lightIndexBuffer_.setData(lightIndices_, Mn::GL::BufferUsage::StreamDraw);
+  }
+  clusterTexture_.setBuffer(Mn::GL::BufferTextureFormat::RG32UI,
+                            clusterBuffer_);
+  lightIndexTexture_.setBuffer(Mn::GL::BufferTextureFormat::R32UI,
+                               lightIndexBuffer_);
+}
+#endif
+
+}  // namespace gfx
+}  // namespace esp
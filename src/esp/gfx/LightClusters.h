@@ -0,0 +1,200 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_LIGHTCLUSTERS_H_
+#define ESP_GFX_LIGHTCLUSTERS_H_
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Math/Vector4.h>
+#include <vector>
+
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/BufferTexture.h>
+#endif
+
+#include "esp/core/Esp.h"
+#include "esp/gfx/LightSetup.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Assignment of the lights of a @ref LightSetup to the cells of a grid
+ * over the view frustum of a camera, for clustered forward shading with
+ * @ref PbrShader::Flag::ClusteredLighting.
+ *
+ * The frustum is split into @ref TilesX by @ref TilesY screen tiles and
+ * @ref DepthSlices slices growing exponentially with the distance from the
+ * camera. @ref build() lists for every cluster the point lights whose sphere
+ * of influence (see @ref lightRange()) overlaps it, plus all directional
+ * lights, so that a fragment only shades the lights of its cluster instead
+ * of all lights of the scene.
+ *
+ * Cameras without a perspective projection get a single cluster with all
+ * lights. The GL side is only available on desktop GL, as GLES and WebGL
+ * lack buffer textures.
+ */
+class LightClusters {
+ public:
+  enum : Magnum::UnsignedInt {
+    TilesX = 16,
+    TilesY = 9,
+    DepthSlices = 24,
+    ClusterCount = TilesX * TilesY * DepthSlices,
+  };
+
+  /**
+   * @brief Smallest number of lights clustered shading is used for. Below
+   * that, looping over all lights is cheaper than finding the cluster.
+   */
+  static constexpr Magnum::UnsignedInt MinLightCount = 8;
+
+  /**
+   * @brief Irradiance below which a point light is considered to not
+   * contribute anymore, see @ref lightRange()
+   */
+  static constexpr float IrradianceCutoff = 1.0f / 256.0f;
+
+  /**
+   * @brief Whether @p lights should be drawn with clustered shading
+   *
+   * True if there are at least @ref MinLightCount lights and none of them is
+   * positioned relative to the object being drawn, as those differ for each
+   * drawable.
+   */
+  static bool isClusteringUseful(const LightSetup& lights);
+
+  /**
+   * @brief The distance beyond which a light is ignored
+   *
+   * The distance at which the inverse-square falloff of the brightest
+   * channel of the light color drops below @ref IrradianceCutoff, infinity
+   * for directional lights. Passed to the shader as the light range, so the
+   * light fades out smoothly before reaching the clusters it isn't assigned
+   * to.
+   */
+  static float lightRange(const LightInfo& light);
+
+  /**
+   * @brief Assign @p lights to the clusters of a camera
+   * @param lights            The lights. Lights relative to the object are
+   *    not supported.
+   * @param cameraMatrix      Camera matrix, transforming world to view space
+   * @param projectionMatrix  Projection matrix of the camera
+   */
+  void build(const LightSetup& lights,
+             const Magnum::Matrix4& cameraMatrix,
+             const Magnum::Matrix4& projectionMatrix);
+
+#ifndef MAGNUM_TARGET_GLES
+  /**
+   * @brief Assign @p lights and upload the result to @ref clusterTexture()
+   * and @ref lightIndexTexture()
+   * @param lights            The lights
+   * @param cameraMatrix      Camera matrix
+   * @param projectionMatrix  Projection matrix of the camera
+   * @param viewport          Viewport size of the camera, in pixels
+   *
+   * Does nothing if called with the same arguments as the last time, so all
+   * drawables drawn by a camera with the same lights share the work. Needs a
+   * GL context.
+   */
+  void update(const LightSetup& lights,
+              const Magnum::Matrix4& cameraMatrix,
+              const Magnum::Matrix4& projectionMatrix,
+              const Magnum::Vector2i& viewport);
+#endif
+
+  /** @brief Index of a cluster, as used by @ref clusters() */
+  static Magnum::UnsignedInt clusterIndex(Magnum::UnsignedInt tileX,
+                                      Magnum::UnsignedInt tileY,
+                                      Magnum::UnsignedInt slice) {
+    return (slice * TilesY + tileY) * TilesX + tileX;
+  }
+
+  /**
+   * @brief Offset into @ref lightIndices() and light count of each cluster
+   *
+   * Has @ref ClusterCount elements, or just one if the projection isn't a
+   * perspective one.
+   */
+  const std::vector<Magnum::Vector2ui>& clusters() const { return clusters_; }
+
+  /** @brief Indices of the lights of all clusters, see @ref clusters() */
+  const std::vector<Magnum::UnsignedInt>& lightIndices() const {
+    return lightIndices_;
+  }
+
+  /** @brief @ref lightRange() of each light */
+  const std::vector<float>& lightRanges() const { return lightRanges_; }
+
+  /**
+   * @brief Plane whose dot product with a world position is the view depth
+   * of the position
+   */
+  Magnum::Vector4 depthPlane() const { return depthPlane_; }
+
+  /**
+   * @brief Scale and bias of the logarithm of the view depth giving the
+   * depth slice
+   */
+  Magnum::Vector2 sliceScaleBias() const { return sliceScaleBias_; }
+
+  /**
+   * @brief Scale of fragment coordinates giving the tile, set by @ref
+   * update()
+   */
+  Magnum::Vector2 tileScale() const { return tileScale_; }
+
+#ifndef MAGNUM_TARGET_GLES
+  /**
+   * @brief Buffer texture with the @ref clusters(), in
+   * @ref Magnum::GL::BufferTextureFormat::RG32UI, set by @ref update()
+   */
+  Magnum::GL::BufferTexture& clusterTexture() { return clusterTexture_; }
+
+  /**
+   * @brief Buffer texture with the @ref lightIndices(), in
+   * @ref Magnum::GL::BufferTextureFormat::R32UI, set by @ref update()
+   */
+  Magnum::GL::BufferTexture& lightIndexTexture() { return lightIndexTexture_; }
+#endif
+
+  ESP_SMART_POINTERS(LightClusters)
+
+ private:
+  // view-space center and radius of each point light, radius of infinity for
+  // lights in all clusters
+  std::vector<Magnum::Vector4> lightSpheres_;
+  std::vector<Magnum::UnsignedInt> clusterLightCounts_;
+
+  std::vector<Magnum::Vector2ui> clusters_;
+  std::vector<Magnum::UnsignedInt> lightIndices_;
+  std::vector<float> lightRanges_;
+  Magnum::Vector4 depthPlane_;
+  Magnum::Vector2 sliceScaleBias_;
+  Magnum::Vector2 tileScale_;
+
+#ifndef MAGNUM_TARGET_GLES
+  // arguments of the last update()
+  bool updated_ = false;
+  LightSetup updatedLights_;
+  Magnum::Matrix4 updatedCameraMatrix_;
+  Magnum::Matrix4 updatedProjectionMatrix_;
+  Magnum::Vector2i updatedViewport_;
+
+  Magnum::GL::Buffer clusterBuffer_{Magnum::NoCreate};
+  Magnum::GL::Buffer lightIndexBuffer_{Magnum::NoCreate};
+  Magnum::GL::BufferTexture clusterTexture_{Magnum::NoCreate};
+  Magnum::GL::BufferTexture lightIndexTexture_{Magnum::NoCreate};
+#endif
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_LIGHTCLUSTERS_H_
@@ -0,0 +1,31 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_MESHCLUSTER_H_
+#define ESP_GFX_MESHCLUSTER_H_
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief A contiguous range of the indices of an indexed triangle mesh,
+ * culled against the view frustum as a whole. See
+ * @ref Drawable::setMeshClusters().
+ */
+struct MeshCluster {
+  /** @brief Offset of the first index of the cluster, in indices */
+  Magnum::UnsignedInt indexOffset = 0;
+  /** @brief Number of indices of the cluster */
+  Magnum::UnsignedInt indexCount = 0;
+  /** @brief Bounding box of the cluster's triangles, in mesh space */
+  Magnum::Range3D aabb;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_MESHCLUSTER_H_
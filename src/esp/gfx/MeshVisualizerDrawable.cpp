@@ -18,7 +18,9 @@ MeshVisualizerDrawable::MeshVisualizerDrawable(
     DrawableConfiguration& cfg)
     : Drawable{node, &mesh, DrawableType::MeshVisualizer, cfg,
                Magnum::Resource<LightSetup>()},
-      shader_(shader) {}
+      shader_(shader) {
+  shaderProgram_ = &shader_;
+}
 
 void MeshVisualizerDrawable::draw(const Magnum::Matrix4& transformationMatrix,
                                   Magnum::SceneGraph::Camera3D& camera) {
@@ -29,7 +31,7 @@ void MeshVisualizerDrawable::draw(const Magnum::Matrix4& transformationMatrix,
   Mn::GL::Renderer::setPolygonOffset(-5.0f, -5.0f);
 
   shader_.setProjectionMatrix(camera.projectionMatrix())
-      .setTransformationMatrix(transformationMatrix);
+      .setTransformationMatrix(transformationMatrix * getMeshTransformation());
 
   shader_.draw(getMesh());
 
@@ -0,0 +1,209 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObjectIdHistogram.h"
+
+#include <algorithm>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/GenericGL.h>
+
+#include "RenderTarget.h"
+#include "esp/core/Check.h"
+#include "esp/core/Profiler.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+enum {
+  ObjectIdTextureUnit = 1,
+};
+
+// the widest bin texture, further bins continue on the next row
+constexpr Mn::UnsignedInt MaxBinsPerRow = 4096;
+
+class ObjectIdHistogramShader : public Mn::GL::AbstractShaderProgram {
+ public:
+  enum : Mn::UnsignedInt {
+    ColorOutput = Mn::Shaders::GenericGL3D::ColorOutput,
+  };
+
+  explicit ObjectIdHistogramShader() {
+    if (!Cr::Utility::Resource::hasGroup("gfx-shaders")) {
+      importShaderResources();
+    }
+
+    const Cr::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+    Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+    Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+    Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+    Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+    vert.addSource(rs.getString("objectIdHistogram.vert"));
+    frag.addSource(Cr::Utility::formatString(
+                       "#define OUTPUT_ATTRIBUTE_LOCATION_COLOR {}\n",
+                       ColorOutput))
+        .addSource(rs.getString("objectIdHistogram.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+    attachShaders({vert, frag});
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    // setup texture binding point
+    setUniform(uniformLocation("ObjectIdTexture"), ObjectIdTextureUnit);
+
+    // setup uniforms
+    binCountUniform_ = uniformLocation("BinCount");
+    CORRADE_INTERNAL_ASSERT(binCountUniform_ >= 0);
+    binsPerRowUniform_ = uniformLocation("BinsPerRow");
+    CORRADE_INTERNAL_ASSERT(binsPerRowUniform_ >= 0);
+    binTextureSizeUniform_ = uniformLocation("BinTextureSize");
+    CORRADE_INTERNAL_ASSERT(binTextureSizeUniform_ >= 0);
+  }
+
+  ObjectIdHistogramShader& bindObjectIdTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(ObjectIdTextureUnit);
+    return *this;
+  }
+
+  ObjectIdHistogramShader& setBins(const Mn::UnsignedInt binCount,
+                                   const Mn::Vector2i& binTextureSize) {
+    setUniform(binCountUniform_, binCount);
+    setUniform(binsPerRowUniform_, binTextureSize.x());
+    setUniform(binTextureSizeUniform_, Mn::Vector2{binTextureSize});
+    return *this;
+  }
+
+ private:
+  GLint binCountUniform_ = -1;
+  GLint binsPerRowUniform_ = -1;
+  GLint binTextureSizeUniform_ = -1;
+};
+
+}  // namespace
+
+struct ObjectIdHistogram::Impl {
+  explicit Impl(const Mn::UnsignedInt binCount)
+      : binCount{binCount},
+        binTextureSize{int(std::min(binCount, MaxBinsPerRow)),
+                       int((binCount + MaxBinsPerRow - 1) / MaxBinsPerRow)},
+        binFramebuffer{{{}, binTextureSize}} {
+    ESP_CHECK(binCount > 0, "ObjectIdHistogram: expected at least one bin");
+    binTexture.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32F, binTextureSize);
+    binFramebuffer
+        .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0}, binTexture, 0)
+        .mapForDraw({{ObjectIdHistogramShader::ColorOutput,
+                      Mn::GL::Framebuffer::ColorAttachment{0}}});
+    CORRADE_INTERNAL_ASSERT(
+        binFramebuffer.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+        Mn::GL::Framebuffer::Status::Complete);
+    shader.setBins(binCount, binTextureSize);
+    mesh.setPrimitive(Mn::GL::MeshPrimitive::Points);
+  }
+
+  const Mn::UnsignedInt binCount;
+  const Mn::Vector2i binTextureSize;
+  Mn::GL::Texture2D binTexture;
+  Mn::GL::Framebuffer binFramebuffer;
+  ObjectIdHistogramShader shader;
+  // one point per pixel, positioned by the shader from gl_VertexID
+  Mn::GL::Mesh mesh;
+};
+
+ObjectIdHistogram::ObjectIdHistogram(const Mn::UnsignedInt binCount)
+    : pimpl_{spimpl::make_unique_impl<Impl>(binCount)} {}
+
+Mn::UnsignedInt ObjectIdHistogram::binCount() const {
+  return pimpl_->binCount;
+}
+
+std::vector<Mn::UnsignedInt> ObjectIdHistogram::compute(RenderTarget& target) {
+  ESP_PROFILE_SCOPE("ObjectIdHistogram::compute");
+  Mn::GL::Texture2D& objectIdTexture = target.getObjectIdTexture();
+
+  pimpl_->binFramebuffer.clearColor(0, Mn::Color4{0.0f}).bind();
+  pimpl_->mesh.setCount(target.framebufferSize().product());
+
+  // the counting needs additive blending without depth test, put back
+  // whatever the caller had set up afterwards
+  const bool depthTestWasEnabled = glIsEnabled(GL_DEPTH_TEST);
+  const bool blendingWasEnabled = glIsEnabled(GL_BLEND);
+  GLint blendSourceRgb, blendDestinationRgb, blendSourceAlpha,
+      blendDestinationAlpha, blendEquationRgb, blendEquationAlpha;
+  glGetIntegerv(GL_BLEND_SRC_RGB, &blendSourceRgb);
+  glGetIntegerv(GL_BLEND_DST_RGB, &blendDestinationRgb);
+  glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSourceAlpha);
+  glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDestinationAlpha);
+  glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquationRgb);
+  glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquationAlpha);
+
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
+  Mn::GL::Renderer::setBlendFunction(Mn::GL::Renderer::BlendFunction::One,
+                                     Mn::GL::Renderer::BlendFunction::One);
+  Mn::GL::Renderer::setBlendEquation(Mn::GL::Renderer::BlendEquation::Add);
+  pimpl_->shader.bindObjectIdTexture(objectIdTexture).draw(pimpl_->mesh);
+
+  Mn::GL::Renderer::setFeature(Mn::GL::Renderer::Feature::DepthTest,
+                               depthTestWasEnabled);
+  Mn::GL::Renderer::setFeature(Mn::GL::Renderer::Feature::Blending,
+                               blendingWasEnabled);
+  Mn::GL::Renderer::setBlendFunction(
+      Mn::GL::Renderer::BlendFunction(blendSourceRgb),
+      Mn::GL::Renderer::BlendFunction(blendDestinationRgb),
+      Mn::GL::Renderer::BlendFunction(blendSourceAlpha),
+      Mn::GL::Renderer::BlendFunction(blendDestinationAlpha));
+  Mn::GL::Renderer::setBlendEquation(
+      Mn::GL::Renderer::BlendEquation(blendEquationRgb),
+      Mn::GL::Renderer::BlendEquation(blendEquationAlpha));
+
+  // only the bins are read back, not the frame
+  const Mn::Image2D bins = pimpl_->binFramebuffer.read(
+      {{}, pimpl_->binTextureSize}, {Mn::PixelFormat::R32F});
+  const Cr::Containers::ArrayView<const float> binData =
+      Cr::Containers::arrayCast<const float>(bins.data());
+  std::vector<Mn::UnsignedInt> counts(pimpl_->binCount);
+  for (Mn::UnsignedInt i = 0; i != pimpl_->binCount; ++i) {
+    counts[i] = Mn::UnsignedInt(binData[i]);
+  }
+  return counts;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,63 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_OBJECTIDHISTOGRAM_H_
+#define ESP_GFX_OBJECTIDHISTOGRAM_H_
+
+#include <Magnum/Magnum.h>
+
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+
+class RenderTarget;
+
+/**
+@brief Counts the pixels of each ID in the object ID attachment of a
+@ref RenderTarget on the GPU
+
+Meant for visibility metrics such as "how much of the goal object is in
+view", without reading back and scanning the whole frame on the CPU. Every
+pixel of @ref RenderTarget::getObjectIdTexture() is drawn as a point onto the
+texel of its ID in a small floating-point bin texture with additive blending,
+and only the bins are read back.
+
+IDs from @ref binCount() on are not counted. Counts are exact up to
+@f$ 2^{24} @f$ pixels per ID. On WebGL, the float blending this relies on
+needs the `EXT_float_blend` extension.
+*/
+class ObjectIdHistogram {
+ public:
+  /**
+   * @brief Constructor
+   * @param binCount Number of IDs to count the pixels of, starting at 0
+   *
+   * Needs a GL context.
+   */
+  explicit ObjectIdHistogram(Magnum::UnsignedInt binCount);
+
+  /** @brief Number of IDs counted */
+  Magnum::UnsignedInt binCount() const;
+
+  /**
+   * @brief Count the pixels of each ID rendered into @p target
+   * @return The pixel counts of the IDs from 0 to @ref binCount() - 1
+   *
+   * The target has to be created with
+   * @ref RenderTarget::Flag::ObjectIdAttachment. Call after
+   * @ref RenderTarget::renderExit(), as this draws into its own framebuffer.
+   * The depth test and blending state are restored afterwards.
+   */
+  std::vector<Magnum::UnsignedInt> compute(RenderTarget& target);
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(ObjectIdHistogram)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_OBJECTIDHISTOGRAM_H_
@@ -9,7 +9,12 @@
 #include <Magnum/Trade/PbrClearCoatMaterialData.h>
 #include <Magnum/Trade/PbrMetallicRoughnessMaterialData.h>
 
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureArray.h>
+#include <vector>
+
+#include "esp/gfx/DrawableGroup.h"
 
 using Magnum::Math::Literals::operator""_radf;
 namespace Mn = Magnum;
@@ -76,6 +81,14 @@ void PbrDrawable::setMaterialValuesInternal(
               "baseColorTexturePointer")) {
     flags_ |= PbrShader::Flag::BaseColorTexture;
     matCache.baseColorTexture = *baseColorTexturePtr;
+  } else if (const auto baseColorArrayPtr =
+                 materialData->findAttribute<Mn::GL::Texture2DArray*>(
+                     "baseColorTextureArrayPointer")) {
+    flags_ |=
+        PbrShader::Flag::BaseColorTexture | PbrShader::Flag::TextureArrays;
+    matCache.baseColorTextureArray = *baseColorArrayPtr;
+    matCache.textureLayers[0] = materialData->attribute<Mn::UnsignedInt>(
+        "baseColorTextureArrayLayer");
   }
 
   if (const auto noneRoughMetalTexturePtr =
@@ -83,13 +96,31 @@ void PbrDrawable::setMaterialValuesInternal(
               "noneRoughnessMetallicTexturePointer")) {
     flags_ |= PbrShader::Flag::NoneRoughnessMetallicTexture;
     matCache.noneRoughnessMetallicTexture = *noneRoughMetalTexturePtr;
-  }
-
-  if (const auto normalTexturePtr =
-          materialData->findAttribute<Mn::GL::Texture2D*>(
-              "normalTexturePointer")) {
+  } else if (const auto noneRoughMetalArrayPtr =
+                 materialData->findAttribute<Mn::GL::Texture2DArray*>(
+                     "noneRoughnessMetallicTextureArrayPointer")) {
+    flags_ |= PbrShader::Flag::NoneRoughnessMetallicTexture |
+              PbrShader::Flag::TextureArrays;
+    matCache.noneRoughnessMetallicTextureArray = *noneRoughMetalArrayPtr;
+    matCache.textureLayers[1] = materialData->attribute<Mn::UnsignedInt>(
+        "noneRoughnessMetallicTextureArrayLayer");
+  }
+
+  const auto normalTexturePtr =
+      materialData->findAttribute<Mn::GL::Texture2D*>("normalTexturePointer");
+  const auto normalArrayPtr =
+      materialData->findAttribute<Mn::GL::Texture2DArray*>(
+          "normalTextureArrayPointer");
+  if (normalTexturePtr || normalArrayPtr) {
     flags_ |= PbrShader::Flag::NormalTexture;
-    matCache.normalTexture = *normalTexturePtr;
+    if (normalTexturePtr) {
+      matCache.normalTexture = *normalTexturePtr;
+    } else {
+      flags_ |= PbrShader::Flag::TextureArrays;
+      matCache.normalTextureArray = *normalArrayPtr;
+      matCache.textureLayers[2] = materialData->attribute<Mn::UnsignedInt>(
+          "normalTextureArrayLayer");
+    }
     if (meshAttributeFlags_ & gfx::Drawable::Flag::HasTangent) {
       flags_ |= PbrShader::Flag::PrecomputedTangent;
     }
@@ -102,6 +133,14 @@ void PbrDrawable::setMaterialValuesInternal(
               "emissiveTexturePointer")) {
     flags_ |= PbrShader::Flag::EmissiveTexture;
     matCache.emissiveTexture = *emissiveTexturePtr;
+  } else if (const auto emissiveArrayPtr =
+                 materialData->findAttribute<Mn::GL::Texture2DArray*>(
+                     "emissiveTextureArrayPointer")) {
+    flags_ |=
+        PbrShader::Flag::EmissiveTexture | PbrShader::Flag::TextureArrays;
+    matCache.emissiveTextureArray = *emissiveArrayPtr;
+    matCache.textureLayers[3] = materialData->attribute<Mn::UnsignedInt>(
+        "emissiveTextureArrayLayer");
   }
   if (materialData->attribute<bool>("hasPerVertexObjectId")) {
     flags_ |= PbrShader::Flag::InstancedObjectId;
@@ -341,6 +380,7 @@ void PbrDrawable::setMaterialValuesInternal(
   if (!reset) {
     flags_ = oldFlags;
   }
+  materialStateKey_ = &*materialData;
 
 }  // PbrDrawable::setMaterialValuesInternal
 
@@ -357,8 +397,15 @@ void PbrDrawable::setShaderAttributesValues(
       ? flags_ |= PbrShader::Flag::ImageBasedLighting
       : flags_ &= ~PbrShader::Flag::ImageBasedLighting;
 
+  // The fast quality tier compiles out the expensive lobes regardless of the
+  // settings below
+  const bool fastQuality = pbrShaderConfig->getPbrQuality() ==
+                           metadata::attributes::PbrShaderQuality::Fast;
+  fastQuality ? flags_ |= PbrShader::Flag::FastIBLSpecular
+              : flags_ &= ~PbrShader::Flag::FastIBLSpecular;
+
   // If using Burley/disney diffuse
-  pbrShaderConfig->getUseBurleyDiffuse()
+  (pbrShaderConfig->getUseBurleyDiffuse() && !fastQuality)
       ? flags_ |= PbrShader::Flag::UseBurleyDiffuse
       : flags_ &= ~PbrShader::Flag::UseBurleyDiffuse;
 
@@ -383,17 +430,17 @@ void PbrDrawable::setShaderAttributesValues(
       : flags_ &= ~PbrShader::Flag::UseIBLTonemap;
 
   // If clear coat calculations should be skipped
-  pbrShaderConfig->getSkipCalcClearcoatLayer()
+  (pbrShaderConfig->getSkipCalcClearcoatLayer() || fastQuality)
       ? flags_ |= PbrShader::Flag::SkipClearCoatLayer
       : flags_ &= ~PbrShader::Flag::SkipClearCoatLayer;
 
   // If specular layer calculations should be skipped
-  pbrShaderConfig->getSkipCalcSpecularLayer()
+  (pbrShaderConfig->getSkipCalcSpecularLayer() || fastQuality)
       ? flags_ |= PbrShader::Flag::SkipSpecularLayer
       : flags_ &= ~PbrShader::Flag::SkipSpecularLayer;
 
   // If anisotropy layer calculations should be skipped
-  pbrShaderConfig->getSkipCalcAnisotropyLayer()
+  (pbrShaderConfig->getSkipCalcAnisotropyLayer() || fastQuality)
       ? flags_ |= PbrShader::Flag::SkipAnisotropyLayer
       : flags_ &= ~PbrShader::Flag::SkipAnisotropyLayer;
 
@@ -451,16 +498,7 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
                  "PbrDrawable::draw() : GL mesh doesn't exist", );
 
   updateShader();
-  // In Drawable.h
-  // Pbr uses light position relative to world.
-  updateShaderLightingParameters(transformationMatrix, camera, shader_,
-                                 [](const LightInfo& lightInfo,
-                                    const Magnum::Matrix4& transformationMatrix,
-                                    const Magnum::Matrix4& cameraMatrix) {
-                                   return getLightPositionRelativeToWorld(
-                                       lightInfo, transformationMatrix,
-                                       cameraMatrix);
-                                 });
+  updateShaderLights(transformationMatrix, camera, *shader_);
 
   // ABOUT PbrShader::Flag::DoubleSided:
   //
@@ -504,10 +542,169 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
               ? 0
               : node_.getShaderObjectID(
                     static_cast<RenderCamera&>(camera).getSemanticDataIDX()))
-      .setProjectionMatrix(camera.projectionMatrix())
+      // NOT modelview matrix!
+      .setModelMatrix(modelMatrix * getMeshTransformation())
+      .setNormalMatrix(normalMatrix);
+  setSharedShaderUniforms(*shader_, camera);
+
+  if (skinData_) {
+    shader_->setJointMatrices(buildSkinJointTransforms(camera));
+  }
+
+  drawMesh(*shader_, transformationMatrix, camera);
+
+  // Reset winding direction
+  if (normalDet < 0) {
+    Mn::GL::Renderer::setFrontFace(
+        Mn::GL::Renderer::FrontFace::CounterClockWise);
+  }
+
+  if ((flags_ >= PbrShader::Flag::DoubleSided) && !glIsEnabled(GL_CULL_FACE)) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+
+}  // PbrDrawable::draw
+
+void PbrDrawable::drawDepthAndObjectId(const Mn::Matrix4& transformationMatrix,
+                                       Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(glMeshExists(),
+                 "PbrDrawable::drawDepthAndObjectId() : GL mesh doesn't "
+                 "exist", );
+
+  drawDepthAndObjectIdWith(
+      shaderManager_, transformationMatrix, camera,
+      flags_ >= PbrShader::Flag::InstancedObjectId
+          ? Mn::Shaders::FlatGL3D::Flag::InstancedObjectId
+          : Mn::Shaders::FlatGL3D::Flags{},
+      nullptr, {}, flags_ >= PbrShader::Flag::DoubleSided);
+}
+
+bool PbrDrawable::isInstanceable() {
+  // skinning, per-vertex object ids and lights following the object all need
+  // per-drawable data the instanced shader doesn't have
+  if (skinData_ || (flags_ >= PbrShader::Flag::InstancedObjectId) ||
+      !glMeshExists()) {
+    return false;
+  }
+  for (Mn::UnsignedInt i = 0; i < lightSetup_->size(); ++i) {
+    if ((*lightSetup_)[i].model == LightPositionModel::Object) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PbrDrawable::canDrawInstancedWith(Drawable& other) {
+  if (other.getDrawableType() != DrawableType::Pbr) {
+    return false;
+  }
+  auto& pbrOther = static_cast<PbrDrawable&>(other);
+  const PBRShaderConfig& config = shaderConfig_;
+  const PBRShaderConfig& otherConfig = pbrOther.shaderConfig_;
+  return flags_ == pbrOther.flags_ &&
+         materialStateKey_ == pbrOther.materialStateKey_ &&
+         &getMesh() == &pbrOther.getMesh() &&
+         lightSetup_.key() == pbrOther.lightSetup_.key() &&
+         pbrIbl_ == pbrOther.pbrIbl_ &&
+         config.directLightingIntensity ==
+             otherConfig.directLightingIntensity &&
+         config.tonemapExposure == otherConfig.tonemapExposure &&
+         config.gamma == otherConfig.gamma &&
+         config.eqScales.directDiffuse == otherConfig.eqScales.directDiffuse &&
+         config.eqScales.directSpecular ==
+             otherConfig.eqScales.directSpecular &&
+         config.eqScales.iblDiffuse == otherConfig.eqScales.iblDiffuse &&
+         config.eqScales.iblSpecular == otherConfig.eqScales.iblSpecular &&
+         isInstanceable() && pbrOther.isInstanceable();
+}
+
+std::size_t PbrDrawable::drawInstanced(
+    Corrade::Containers::ArrayView<const DrawableTransform> instances,
+    Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(glMeshExists(),
+                 "PbrDrawable::drawInstanced() : GL mesh doesn't exist", 0);
+
+  // layout matching the TransformationMatrix, NormalMatrix and ObjectId
+  // attributes below
+  struct InstanceData {
+    Mn::Matrix4 transformationMatrix;
+    Mn::Matrix3x3 normalMatrix;
+    Mn::UnsignedInt objectId;
+  };
+  std::vector<InstanceData> instanceData;
+  instanceData.reserve(instances.size());
+
+  const Mn::Matrix4 cameraMatrixInverted = camera.cameraMatrix().inverted();
+  const int semanticDataIDX =
+      static_cast<RenderCamera&>(camera).getSemanticDataIDX();
+  std::size_t numDrawCalls = 0;
+  for (const DrawableTransform& instance : instances) {
+    auto& drawable = static_cast<PbrDrawable&>(instance.first.get());
+    const Mn::Matrix4 modelMatrix = cameraMatrixInverted * instance.second;
+    const Mn::Matrix3x3 rotScale = modelMatrix.rotationScaling();
+    const float normalDet = rotScale.determinant();
+    if (normalDet < 0) {
+      // mirrored instances need the opposite winding, draw them on their own
+      drawable.draw(instance.second, camera);
+      ++numDrawCalls;
+      continue;
+    }
+    // see draw() for the normal matrix calculation
+    instanceData.push_back(
+        {modelMatrix * drawable.getMeshTransformation(),
+         rotScale.comatrix() / normalDet,
+         static_cast<Mn::UnsignedInt>(
+             drawable.node_.getShaderObjectID(semanticDataIDX))});
+  }
+  if (instanceData.empty()) {
+    return numDrawCalls;
+  }
+
+  // keep shader_ up to date for getDrawState()
+  updateShader();
+  fetchShader(instancedShader_,
+              flags_ | PbrShader::Flag::InstancedTransformation |
+                  PbrShader::Flag::InstancedObjectId,
+              0, 0);
+  // no lights are relative to the object, so any transformation will do
+  updateShaderLights(instances.front().second, camera, *instancedShader_);
+
+  if ((flags_ >= PbrShader::Flag::DoubleSided) && glIsEnabled(GL_CULL_FACE)) {
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+
+  // the instance transformations already are the model matrices, and the
+  // instance object ids are the full ids
+  (*instancedShader_)
+      .setObjectId(0)
+      .setModelMatrix(Mn::Matrix4{})
+      .setNormalMatrix(Mn::Matrix3x3{});
+  setSharedShaderUniforms(*instancedShader_, camera);
+
+  // Re-adding the buffer every batch only updates the attribute bindings of
+  // the mesh's vertex array object. The attributes are not read by the other
+  // shaders drawing this mesh.
+  Mn::GL::Buffer& instanceBuffer = drawables()->getInstanceBuffer();
+  instanceBuffer.setData(instanceData, Mn::GL::BufferUsage::StreamDraw);
+  Mn::GL::Mesh& mesh = getMesh();
+  mesh.addVertexBufferInstanced(
+          instanceBuffer, 1, 0, PbrShader::TransformationMatrix{},
+          PbrShader::NormalMatrix{}, PbrShader::ObjectId{})
+      .setInstanceCount(instanceData.size());
+  instancedShader_->draw(mesh);
+  mesh.setInstanceCount(1);
+
+  if ((flags_ >= PbrShader::Flag::DoubleSided) && !glIsEnabled(GL_CULL_FACE)) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+
+  return numDrawCalls + 1;
+}  // PbrDrawable::drawInstanced
+
+void PbrDrawable::setSharedShaderUniforms(PbrShader& shader,
+                                          Mn::SceneGraph::Camera3D& camera) {
+  shader.setProjectionMatrix(camera.projectionMatrix())
       .setViewMatrix(camera.cameraMatrix())
-      .setModelMatrix(modelMatrix)  // NOT modelview matrix!
-      .setNormalMatrix(normalMatrix)
       .setCameraWorldPosition(
           camera.object().absoluteTransformationMatrix().translation())
       .setBaseColor(matCache.baseColor)
@@ -516,42 +713,60 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
       .setIndexOfRefraction(matCache.ior_Index)
       .setEmissiveColor(matCache.emissiveColor);
 
-  if (flags_ >= PbrShader::Flag::BaseColorTexture) {
-    shader_->bindBaseColorTexture(*matCache.baseColorTexture);
-  }
+  if (flags_ >= PbrShader::Flag::TextureArrays) {
+    // All base layer textures of the material are layers of texture arrays
+    if (flags_ >= PbrShader::Flag::BaseColorTexture) {
+      shader.bindBaseColorTexture(*matCache.baseColorTextureArray);
+    }
+    if (flags_ >= PbrShader::Flag::NoneRoughnessMetallicTexture) {
+      shader.bindMetallicRoughnessTexture(
+          *matCache.noneRoughnessMetallicTextureArray);
+    }
+    if (flags_ >= PbrShader::Flag::NormalTexture) {
+      shader.bindNormalTexture(*matCache.normalTextureArray);
+      shader.setNormalTextureScale(matCache.normalTextureScale);
+    }
+    if (flags_ >= PbrShader::Flag::EmissiveTexture) {
+      shader.bindEmissiveTexture(*matCache.emissiveTextureArray);
+    }
+    shader.setTextureLayers(matCache.textureLayers);
+  } else {
+    if (flags_ >= PbrShader::Flag::BaseColorTexture) {
+      shader.bindBaseColorTexture(*matCache.baseColorTexture);
+    }
 
-  if (flags_ >= PbrShader::Flag::NoneRoughnessMetallicTexture) {
-    shader_->bindMetallicRoughnessTexture(
-        *matCache.noneRoughnessMetallicTexture);
-  }
+    if (flags_ >= PbrShader::Flag::NoneRoughnessMetallicTexture) {
+      shader.bindMetallicRoughnessTexture(
+          *matCache.noneRoughnessMetallicTexture);
+    }
 
-  if (flags_ >= PbrShader::Flag::NormalTexture) {
-    shader_->bindNormalTexture(*matCache.normalTexture);
-    shader_->setNormalTextureScale(matCache.normalTextureScale);
-  }
+    if (flags_ >= PbrShader::Flag::NormalTexture) {
+      shader.bindNormalTexture(*matCache.normalTexture);
+      shader.setNormalTextureScale(matCache.normalTextureScale);
+    }
 
-  if (flags_ >= PbrShader::Flag::EmissiveTexture) {
-    shader_->bindEmissiveTexture(*matCache.emissiveTexture);
+    if (flags_ >= PbrShader::Flag::EmissiveTexture) {
+      shader.bindEmissiveTexture(*matCache.emissiveTexture);
+    }
   }
 
   if (flags_ >= PbrShader::Flag::TextureTransformation) {
-    shader_->setTextureMatrix(matCache.textureMatrix);
+    shader.setTextureMatrix(matCache.textureMatrix);
   }
 
   // clearcoat data
   if (flags_ >= PbrShader::Flag::ClearCoatLayer) {
-    (*shader_)
-        .setClearCoatFactor(matCache.clearCoat.factor)
+    shader.setClearCoatFactor(matCache.clearCoat.factor)
         .setClearCoatRoughness(matCache.clearCoat.roughnessFactor);
     if (flags_ >= PbrShader::Flag::ClearCoatTexture) {
-      shader_->bindClearCoatFactorTexture(*matCache.clearCoat.texture);
+      shader.bindClearCoatFactorTexture(*matCache.clearCoat.texture);
     }
     if (flags_ >= PbrShader::Flag::ClearCoatRoughnessTexture) {
-      shader_->bindClearCoatRoughnessTexture(
+      shader.bindClearCoatRoughnessTexture(
           *matCache.clearCoat.roughnessTexture);
     }
     if (flags_ >= PbrShader::Flag::ClearCoatNormalTexture) {
-      (*shader_)
+      shader
           .setClearCoatNormalTextureScale(matCache.clearCoat.normalTextureScale)
           .bindClearCoatNormalTexture(*matCache.clearCoat.normalTexture);
     }
@@ -559,114 +774,139 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
 
   // specular layer data
   if (flags_ >= PbrShader::Flag::SpecularLayer) {
-    (*shader_)
-        .setSpecularLayerFactor(matCache.specularLayer.factor)
+    shader.setSpecularLayerFactor(matCache.specularLayer.factor)
         .setSpecularLayerColorFactor(matCache.specularLayer.colorFactor);
 
     if (flags_ >= PbrShader::Flag::SpecularLayerTexture) {
-      shader_->bindSpecularLayerTexture(*matCache.specularLayer.texture);
+      shader.bindSpecularLayerTexture(*matCache.specularLayer.texture);
     }
     if (flags_ >= PbrShader::Flag::SpecularLayerColorTexture) {
-      shader_->bindSpecularLayerColorTexture(
+      shader.bindSpecularLayerColorTexture(
           *matCache.specularLayer.colorTexture);
     }
   }
 
   // anisotropy layer data
   if (flags_ >= PbrShader::Flag::AnisotropyLayer) {
-    (*shader_)
-        .setAnisotropyLayerFactor(matCache.anisotropyLayer.factor)
+    shader.setAnisotropyLayerFactor(matCache.anisotropyLayer.factor)
         .setAnisotropyLayerDirection(matCache.anisotropyLayer.direction);
 
     if (flags_ >= PbrShader::Flag::AnisotropyLayerTexture) {
-      shader_->bindAnisotropyLayerTexture(*matCache.anisotropyLayer.texture);
+      shader.bindAnisotropyLayerTexture(*matCache.anisotropyLayer.texture);
     }
   }
 
   // Set gamma value to use for srgb remapping if being used
   // Setter does appropriate checking
-  shader_->setGamma(shaderConfig_.gamma);
+  shader.setGamma(shaderConfig_.gamma);
 
   // Tonemap exposure
   if (flags_ >= (PbrShader::Flag::UseIBLTonemap) ||
       flags_ >= (PbrShader::Flag::UseDirectLightTonemap)) {
-    shader_->setTonemapExposure(shaderConfig_.tonemapExposure);
+    shader.setTonemapExposure(shaderConfig_.tonemapExposure);
   }
   if (flags_ >= PbrShader::Flag::DirectLighting) {
     // Intensity of direct lighting
-    shader_->setDirectLightIntensity(shaderConfig_.directLightingIntensity);
+    shader.setDirectLightIntensity(shaderConfig_.directLightingIntensity);
     if (flags_ >= PbrShader::Flag::ImageBasedLighting) {
-      shader_->setPbrEquationScales(shaderConfig_.eqScales);
+      shader.setPbrEquationScales(shaderConfig_.eqScales);
     }
   }
 
   // setup image based lighting for the shader
   if (flags_ >= PbrShader::Flag::ImageBasedLighting) {
     CORRADE_INTERNAL_ASSERT(pbrIbl_);
-    shader_->bindIrradianceCubeMap(
+    shader.bindIrradianceCubeMap(
         pbrIbl_->getIrradianceMap().getTexture(CubeMap::TextureType::Color));
-    shader_->bindBrdfLUT(pbrIbl_->getBrdfLookupTable());
-    shader_->bindPrefilteredMap(
+    shader.bindBrdfLUT(pbrIbl_->getBrdfLookupTable());
+    shader.bindPrefilteredMap(
         pbrIbl_->getPrefilteredMap().getTexture(CubeMap::TextureType::Color));
-    shader_->setPrefilteredMapMipLevels(
+    shader.setPrefilteredMapMipLevels(
         pbrIbl_->getPrefilteredMap().getMipmapLevels());
   }
-
-  if (skinData_) {
-    buildSkinJointTransforms();
-    shader_->setJointMatrices(jointTransformations_);
-  }
-
-  shader_->draw(getMesh());
-
-  // Reset winding direction
-  if (normalDet < 0) {
-    Mn::GL::Renderer::setFrontFace(
-        Mn::GL::Renderer::FrontFace::CounterClockWise);
-  }
-
-  if ((flags_ >= PbrShader::Flag::DoubleSided) && !glIsEnabled(GL_CULL_FACE)) {
-    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
-  }
-
-}  // PbrDrawable::draw
+}  // PbrDrawable::setSharedShaderUniforms
+
+void PbrDrawable::updateShaderLights(const Mn::Matrix4& transformationMatrix,
+                                     Mn::SceneGraph::Camera3D& camera,
+                                     PbrShader& shader) {
+#ifndef MAGNUM_TARGET_GLES
+  if (flags_ >= PbrShader::Flag::ClusteredLighting) {
+    LightClusters& clusters =
+        static_cast<RenderCamera&>(camera).lightClusters();
+    clusters.update(*lightSetup_, camera.cameraMatrix(),
+                    camera.projectionMatrix(), camera.viewport());
+    const LightShaderParameters lights = computeLightShaderParameters(
+        transformationMatrix, camera.cameraMatrix(), LightSpace::World);
+    // the lights have to fade out within the clusters they're assigned to
+    shader.setLightPositions(lights.positions)
+        .setLightColors(lights.colors)
+        .setLightRanges(clusters.lightRanges())
+        .setLightClusterParameters(clusters.depthPlane(),
+                                   clusters.tileScale(),
+                                   clusters.sliceScaleBias())
+        .bindLightClusters(clusters.clusterTexture(),
+                           clusters.lightIndexTexture());
+    updateShaderLightingParametersInternal();
+    return;
+  }
+#endif
+  // In Drawable.h
+  // Pbr uses light position relative to world.
+  updateShaderLightingParameters(transformationMatrix, camera, &shader,
+                                 LightSpace::World);
+}  // PbrDrawable::updateShaderLights
 
 void PbrDrawable::updateShader() {
-  const Mn::UnsignedInt lightCount = lightSetup_->size();
   Mn::UnsignedInt jointCount = 0;
   Mn::UnsignedInt perVertexJointCount = 0;
 
+#ifndef MAGNUM_TARGET_GLES
+  // many lights are shaded per cluster of the view frustum
+  LightClusters::isClusteringUseful(*lightSetup_)
+      ? flags_ |= PbrShader::Flag::ClusteredLighting
+      : flags_ &= ~PbrShader::Flag::ClusteredLighting;
+#endif
+
   if (flags_ >= PbrShader::Flag::SkinnedMesh) {
     jointCount = skinData_->skinData->skin->joints().size();
     perVertexJointCount = skinData_->skinData->perVertexJointCount;
-    resizeJointTransformArray(jointCount);
   }
 
-  if (!shader_ || shader_->lightCount() != lightCount ||
-      shader_->flags() != flags_) {
+  fetchShader(shader_, flags_, jointCount, perVertexJointCount);
+  shaderProgram_ = &*shader_;
+}  // PbrDrawable::updateShader
+
+void PbrDrawable::fetchShader(
+    Mn::Resource<Mn::GL::AbstractShaderProgram, PbrShader>& shader,
+    PbrShader::Flags flags,
+    Mn::UnsignedInt jointCount,
+    Mn::UnsignedInt perVertexJointCount) {
+  const Mn::UnsignedInt lightCount = lightSetup_->size();
+  if (!shader || shader->lightCount() != lightCount ||
+      shader->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ = shaderManager_.get<Mn::GL::AbstractShaderProgram, PbrShader>(
+    shader = shaderManager_.get<Mn::GL::AbstractShaderProgram, PbrShader>(
         getShaderKey("PBR", lightCount,
-                     static_cast<PbrShader::Flags::UnderlyingType>(flags_),
+                     static_cast<PbrShader::Flags::UnderlyingType>(flags),
                      jointCount));
 
     // if no shader with desired number of lights and flags exists, create
     // one
-    if (!shader_) {
+    if (!shader) {
       shaderManager_.set<Mn::GL::AbstractShaderProgram>(
-          shader_.key(),
+          shader.key(),
           new PbrShader{PbrShader::Configuration{}
-                            .setFlags(flags_)
+                            .setFlags(flags)
                             .setLightCount(lightCount)
                             .setJointCount(jointCount, perVertexJointCount)},
           Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
     }
 
-    CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
-                            shader_->flags() == flags_);
+    CORRADE_INTERNAL_ASSERT(shader && shader->lightCount() == lightCount &&
+                            shader->flags() == flags);
   }
-}  // namespace gfx
+}  // PbrDrawable::fetchShader
 
 }  // namespace gfx
 }  // namespace esp
@@ -44,6 +44,21 @@ class PbrDrawable : public Drawable {
 
     float normalTextureScale = 1.0f;
 
+    /**
+     * Texture arrays holding the base layer textures above if the
+     * ResourceManager packed them, see @ref PbrShader::Flag::TextureArrays.
+     */
+    Mn::GL::Texture2DArray* baseColorTextureArray = nullptr;
+    Mn::GL::Texture2DArray* noneRoughnessMetallicTextureArray = nullptr;
+    Mn::GL::Texture2DArray* emissiveTextureArray = nullptr;
+    Mn::GL::Texture2DArray* normalTextureArray = nullptr;
+
+    /**
+     * Layers of the base color, noneRoughnessMetallic, normal and emissive
+     * textures in their texture arrays.
+     */
+    Mn::Vector4ui textureLayers{};
+
     ////////////////
     // ClearCoat layer
 
@@ -277,6 +292,30 @@ class PbrDrawable : public Drawable {
       const std::shared_ptr<metadata::attributes::PbrShaderAttributes>&
           _pbrShaderConfig);
 
+  /**
+   * @brief Whether this drawable can share an instanced draw call with
+   * @p other. Requires the same mesh, material, shader configuration and
+   * light setup, and neither drawable being skinned, having per-vertex
+   * object ids or being lit by lights attached to the object.
+   */
+  bool canDrawInstancedWith(Drawable& other) override;
+
+  /**
+   * @brief Draw @p instances with a single instanced draw call, using the
+   * instance buffer of this drawable's @ref DrawableGroup. Mirrored instances
+   * are drawn separately.
+   */
+  std::size_t drawInstanced(
+      Corrade::Containers::ArrayView<const DrawableTransform> instances,
+      Mn::SceneGraph::Camera3D& camera) override;
+
+  /**
+   * @brief Draw only depth and the object ID with a flat shader, without the
+   * PBR material, lights and image based lighting
+   */
+  void drawDepthAndObjectId(const Mn::Matrix4& transformationMatrix,
+                            Mn::SceneGraph::Camera3D& camera) override;
+
  private:
   /**
    * @brief Internal implementation of material setting, so that it can be
@@ -304,10 +343,43 @@ class PbrDrawable : public Drawable {
    */
   void updateShader();
 
+  /**
+   * @brief Fetch the shader matching @p flags and the current light setup
+   * into @p shader, creating it if it doesn't exist yet.
+   */
+  void fetchShader(
+      Mn::Resource<Mn::GL::AbstractShaderProgram, PbrShader>& shader,
+      PbrShader::Flags flags,
+      Mn::UnsignedInt jointCount,
+      Mn::UnsignedInt perVertexJointCount);
+
+  /**
+   * @brief Set the uniforms that don't depend on the drawable's
+   * transformation: camera, material, lighting configuration and textures.
+   */
+  void setSharedShaderUniforms(PbrShader& shader,
+                               Mn::SceneGraph::Camera3D& camera);
+
+  /**
+   * @brief Set the lights of @p shader, together with the light clusters of
+   * @p camera if drawing with @ref PbrShader::Flag::ClusteredLighting
+   */
+  void updateShaderLights(const Mn::Matrix4& transformationMatrix,
+                          Mn::SceneGraph::Camera3D& camera,
+                          PbrShader& shader);
+
+  /**
+   * @brief Whether this drawable can be drawn instanced at all, see
+   * @ref canDrawInstancedWith()
+   */
+  bool isInstanceable();
+
   // shader parameters
   PbrShader::Flags flags_;
   ShaderManager& shaderManager_;
   Mn::Resource<Mn::GL::AbstractShaderProgram, PbrShader> shader_;
+  //! variant of shader_ with per-instance transformations and object ids
+  Mn::Resource<Mn::GL::AbstractShaderProgram, PbrShader> instancedShader_;
   std::shared_ptr<PbrIBLHelper> pbrIbl_ = nullptr;
 
   /**
@@ -3,6 +3,8 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PbrIBLHelper.h"
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
@@ -32,6 +34,10 @@ constexpr unsigned int environmentMapSize = 1024;
 constexpr unsigned int prefilteredMapSize = 1024;
 constexpr unsigned int irradianceMapSize = 128;
 
+// Written after all baked maps, so a process never loads a set another one
+// is still writing
+constexpr const char* bakedMapsCompleteSuffix = ".complete";
+
 Mn::Matrix4 buildDfltPerspectiveMatrix() {
   using Mn::Math::Literals::operator""_degf;
   return Mn::Matrix4::perspectiveProjection(
@@ -46,12 +52,71 @@ Mn::Matrix4 buildDfltPerspectiveMatrix() {
 PbrIBLHelper::PbrIBLHelper(
     ShaderManager& shaderManager,
     const std::shared_ptr<Mn::GL::Texture2D>& brdfLUT,
-    const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture)
+    const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture,
+    const std::string& bakedMapsPrefix)
     : shaderManager_(shaderManager), brdfLUT_(brdfLUT) {
+  if (!bakedMapsPrefix.empty() && loadBakedMaps(bakedMapsPrefix)) {
+    return;
+  }
   // convert the loaded texture into a cubemap
   convertEquirectangularToCubeMap(envMapTexture);
+  if (!bakedMapsPrefix.empty()) {
+    saveBakedMaps(bakedMapsPrefix);
+  }
 }
 
+bool PbrIBLHelper::loadBakedMaps(const std::string& prefix) {
+  if (!Cr::Utility::Path::exists(prefix + bakedMapsCompleteSuffix)) {
+    return false;
+  }
+
+  Cr::Containers::Optional<CubeMap> irradianceMap{
+      Cr::InPlaceInit, irradianceMapSize, CubeMap::Flag::ColorTexture};
+  if (!irradianceMap->loadTextureLevel(prefix + ".irradiance")) {
+    return false;
+  }
+  Cr::Containers::Optional<CubeMap> prefilteredMap{
+      Cr::InPlaceInit, prefilteredMapSize,
+      CubeMap::Flag::ColorTexture | CubeMap::Flag::ManuallyBuildMipmap};
+  for (unsigned int iMip = 0; iMip < prefilteredMap->getMipmapLevels();
+       ++iMip) {
+    if (!prefilteredMap->loadTextureLevel(prefix + ".prefiltered", iMip)) {
+      return false;
+    }
+  }
+
+  irradianceMap_ = std::move(irradianceMap);
+  prefilteredMap_ = std::move(prefilteredMap);
+  ESP_DEBUG() << "Loaded baked IBL maps from" << prefix;
+  return true;
+}  // loadBakedMaps
+
+void PbrIBLHelper::saveBakedMaps(const std::string& prefix) {
+#ifndef MAGNUM_TARGET_WEBGL
+  const std::string completeFilename = prefix + bakedMapsCompleteSuffix;
+  // another process finished baking them in the meantime
+  if (Cr::Utility::Path::exists(completeFilename)) {
+    return;
+  }
+  bool saved = irradianceMap_->saveTexture(CubeMap::TextureType::Color,
+                                           prefix + ".irradiance");
+  for (unsigned int iMip = 0;
+       saved && iMip < prefilteredMap_->getMipmapLevels(); ++iMip) {
+    saved = prefilteredMap_->saveTexture(CubeMap::TextureType::Color,
+                                         prefix + ".prefiltered", iMip);
+  }
+  if (saved) {
+    saved = Cr::Utility::Path::write(completeFilename,
+                                     Cr::Containers::ArrayView<const void>{});
+  }
+  if (!saved) {
+    ESP_WARNING() << "Unable to bake the IBL maps to" << prefix;
+  }
+#else
+  static_cast<void>(prefix);
+#endif
+}  // saveBakedMaps
+
 void PbrIBLHelper::convertEquirectangularToCubeMap(
     const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture) {
   // prepare a mesh to be displayed
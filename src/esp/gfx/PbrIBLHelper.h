@@ -31,11 +31,16 @@ class PbrIBLHelper {
    * @param[in] brdfLUT the brdf lookup table texture being used.
    * @param[in] envMapTexture the texture to use to build the environment cube
    * maps.
+   * @param[in] bakedMapsPrefix if not empty, the filename prefix of baked
+   * irradiance and prefiltered maps of @p envMapTexture. If maps were baked
+   * with this prefix before they are loaded instead of computed, otherwise
+   * they are computed and baked for the next helper using the prefix.
    */
   explicit PbrIBLHelper(
       ShaderManager& shaderManager,
       const std::shared_ptr<Mn::GL::Texture2D>& brdfLUT,
-      const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture);
+      const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture,
+      const std::string& bakedMapsPrefix = "");
 
   /**
    * @brief get the irradiance cube map
@@ -62,6 +67,19 @@ class PbrIBLHelper {
   void convertEquirectangularToCubeMap(
       const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture);
 
+  /**
+   * @brief load the irradiance and prefiltered maps written by
+   * @ref saveBakedMaps()
+   * @return false if no complete set of maps was baked with @p prefix
+   */
+  bool loadBakedMaps(const std::string& prefix);
+
+  /**
+   * @brief write the irradiance and prefiltered maps for
+   * @ref loadBakedMaps()
+   */
+  void saveBakedMaps(const std::string& prefix);
+
   /**
    * @brief 2D BRDF lookup table, an HDR image (16-bits per channel) that
    * contains BRDF values for roughness and view angle. This is for the indirect
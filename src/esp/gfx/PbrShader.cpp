@@ -3,21 +3,30 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PbrShader.h"
+#include "LightClusters.h"
 #include "PbrTextureUnit.h"
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/Resource.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferTexture.h>
+#endif
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/CubeMapTexture.h>
 #include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureArray.h>
 #include <Magnum/GL/Version.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Color.h>
@@ -25,8 +34,14 @@
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/PixelFormat.h>
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Hash.h"
+
 // This is to import the "resources" at runtime. When the resource is
 // compiled into static library, it must be explicitly initialized via this
 // macro, and should be called *outside* of any namespace.
@@ -41,6 +56,45 @@ namespace esp {
 namespace gfx {
 
 using Cr::Containers::Literals::operator""_s;
+
+namespace {
+std::mutex programBinaryCacheMutex;
+std::string programBinaryCacheDirectoryValue;
+
+// Resources the fragment and vertex shaders are built from
+const char* const ShaderSourceFiles[]{
+    "pbr.vert",         "pbrCommon.glsl",   "pbrStructs.glsl",
+    "pbrUniforms.glsl", "pbrLighting.glsl", "pbrBSDF.glsl",
+    "pbrMaterials.glsl", "pbr.frag"};
+
+constexpr char ProgramBinaryMagic[8]{'E', 'S', 'P', 'P', 'B', 'I', 'N', '2'};
+
+// Header of the program binary cache files, followed by the binary. Stores
+// the variant in full, as different variants may end up with the same hash
+// in the filename.
+struct ProgramBinaryHeader {
+  char magic[8];
+  Mn::UnsignedInt format;
+  Mn::UnsignedInt size;
+  Mn::UnsignedLong flags;
+  Mn::UnsignedInt lightCount;
+  Mn::UnsignedInt jointCount;
+  Mn::UnsignedInt perVertexJointCount;
+  Mn::UnsignedInt secondaryPerVertexJointCount;
+};
+
+}  // namespace
+
+void PbrShader::setProgramBinaryCacheDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock{programBinaryCacheMutex};
+  programBinaryCacheDirectoryValue = directory;
+}
+
+std::string PbrShader::programBinaryCacheDirectory() {
+  std::lock_guard<std::mutex> lock{programBinaryCacheMutex};
+  return programBinaryCacheDirectoryValue;
+}
+
 PbrShader::PbrShader(const Configuration& config)
     : flags_(config.flags()),
       lightCount_(config.lightCount()),
@@ -62,6 +116,13 @@ PbrShader::PbrShader(const Configuration& config)
       (directLightingIsEnabled_ || flags_ >= Flag::ImageBasedLighting);
   directAndIBLisEnabled_ =
       (directLightingIsEnabled_ && flags_ >= Flag::ImageBasedLighting);
+#ifdef MAGNUM_TARGET_GLES
+  CORRADE_ASSERT(!(flags_ >= Flag::ClusteredLighting),
+                 "PbrShader::PbrShader(): clustered lighting is only "
+                 "available on desktop GL", );
+#endif
+  const bool clusteredLighting =
+      (directLightingIsEnabled_ && flags_ >= Flag::ClusteredLighting);
 
   bool mapMatInToLinear = (flags_ >= Flag::MapMatTxtrToLinear &&
                            ((flags_ >= Flag::BaseColorTexture) ||
@@ -120,6 +181,16 @@ PbrShader::PbrShader(const Configuration& config)
         << Cr::Utility::formatString("#define ATTRIBUTE_LOCATION_TEXCOORD {}\n",
                                      TextureCoordinates::Location);
   }
+  if (flags_ >= Flag::InstancedObjectId) {
+    attributeLocationsStream << Cr::Utility::formatString(
+        "#define ATTRIBUTE_LOCATION_OBJECT_ID {}\n", ObjectId::Location);
+  }
+  if (flags_ >= Flag::InstancedTransformation) {
+    attributeLocationsStream << Cr::Utility::formatString(
+        "#define ATTRIBUTE_LOCATION_TRANSFORMATION_MATRIX {}\n"
+        "#define ATTRIBUTE_LOCATION_NORMAL_MATRIX {}\n",
+        TransformationMatrix::Location, NormalMatrix::Location);
+  }
   // Skin attributes
   if (flags_ >= Flag::SkinnedMesh) {
     if (perVertexJointCount_ > 0) {
@@ -147,7 +218,13 @@ PbrShader::PbrShader(const Configuration& config)
       .addSource(isTextured_ && (flags_ >= Flag::TextureTransformation)
                      ? "#define TEXTURE_TRANSFORMATION\n"
                      : "")
-      .addSource(flags_ >= Flag::VertexColor ? "#define VERTEX_COLOR\n" : "");
+      .addSource(flags_ >= Flag::VertexColor ? "#define VERTEX_COLOR\n" : "")
+      .addSource(flags_ >= Flag::InstancedObjectId
+                     ? "#define INSTANCED_OBJECT_ID\n"
+                     : "")
+      .addSource(flags_ >= Flag::InstancedTransformation
+                     ? "#define INSTANCED_TRANSFORMATION\n"
+                     : "");
 
   // If skinned mesh, added joint values to vertex shader
   if (flags_ >= Flag::SkinnedMesh) {
@@ -188,7 +265,12 @@ PbrShader::PbrShader(const Configuration& config)
                      : "")
       .addSource(flags_ >= Flag::NormalTexture ? "#define NORMAL_TEXTURE\n"
                                                : "")
+      .addSource(flags_ >= Flag::TextureArrays ? "#define TEXTURE_ARRAYS\n"
+                                               : "")
       .addSource(flags_ >= Flag::ObjectId ? "#define OBJECT_ID\n" : "")
+      .addSource(flags_ >= Flag::InstancedObjectId
+                     ? "#define INSTANCED_OBJECT_ID\n"
+                     : "")
       .addSource(flags_ >= Flag::VertexColor ? "#define VERTEX_COLOR\n" : "")
 
       // Clearcoat layer
@@ -263,12 +345,24 @@ PbrShader::PbrShader(const Configuration& config)
                      ? "#define DIRECT_TONE_MAP\n"
                      : "")
       .addSource(flags_ >= Flag::UseIBLTonemap ? "#define IBL_TONE_MAP\n" : "")
+      .addSource(flags_ >= Flag::FastIBLSpecular
+                     ? "#define FAST_IBL_SPECULAR\n"
+                     : "")
 
       .addSource(flags_ >= Flag::DebugDisplay ? "#define PBR_DEBUG_DISPLAY\n"
                                               : "")
 
       .addSource(
           Cr::Utility::formatString("#define LIGHT_COUNT {}\n", lightCount_))
+      .addSource(clusteredLighting
+                     ? Cr::Utility::formatString(
+                           "#define CLUSTERED_LIGHTING\n"
+                           "#define CLUSTER_TILES_X {}\n"
+                           "#define CLUSTER_TILES_Y {}\n"
+                           "#define CLUSTER_DEPTH_SLICES {}\n",
+                           LightClusters::TilesX, LightClusters::TilesY,
+                           LightClusters::DepthSlices)
+                     : "")
       .addSource(rs.getString("pbrCommon.glsl"))
       .addSource(rs.getString("pbrStructs.glsl"))
       .addSource(rs.getString("pbrUniforms.glsl"))
@@ -277,11 +371,24 @@ PbrShader::PbrShader(const Configuration& config)
       .addSource(rs.getString("pbrMaterials.glsl"))
       .addSource(rs.getString("pbr.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+  const std::string binaryFilename = programBinaryFilename(rs);
+  if (binaryFilename.empty() || !loadProgramBinary(binaryFilename)) {
+    CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+    attachShaders({vert, frag});
+
+#ifndef MAGNUM_TARGET_GLES
+    if (!binaryFilename.empty()) {
+      glProgramParameteri(id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
 
-  attachShaders({vert, frag});
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+    if (!binaryFilename.empty()) {
+      saveProgramBinary(binaryFilename);
+    }
+  }
 
   // set texture binding points in the shader;
   // see PBR vertex, fragment shader code for details
@@ -334,6 +441,9 @@ PbrShader::PbrShader(const Configuration& config)
   if (isTextured_ && (flags_ >= Flag::TextureTransformation)) {
     textureMatrixUniform_ = uniformLocation("uTextureMatrix");
   }
+  if (flags_ >= Flag::TextureArrays) {
+    textureLayersUniform_ = uniformLocation("uTextureLayers");
+  }
 
   // materials
   baseColorUniform_ = uniformLocation("uMaterial.baseColor");
@@ -392,6 +502,9 @@ PbrShader::PbrShader(const Configuration& config)
   }  // if lighting is enabled
 
   // lights
+  uploadedLightPositions_.resize(lightCount_);
+  uploadedLightColors_.resize(lightCount_);
+  uploadedLightRanges_.resize(lightCount_);
   if (directLightingIsEnabled_) {
     lightRangesUniform_ = uniformLocation("uLightRanges");
     lightColorsUniform_ = uniformLocation("uLightColors");
@@ -399,6 +512,14 @@ PbrShader::PbrShader(const Configuration& config)
     // global light intensity across all direct lights
     directLightingIntensityUniform_ = uniformLocation("uDirectLightIntensity");
   }
+  if (clusteredLighting) {
+    clusterDepthPlaneUniform_ = uniformLocation("uClusterDepthPlane");
+    clusterScaleUniform_ = uniformLocation("uClusterScale");
+    setUniform(uniformLocation("uLightClusters"),
+               pbrTextureUnitSpace::TextureUnit::LightClusters);
+    setUniform(uniformLocation("uLightClusterIndices"),
+               pbrTextureUnitSpace::TextureUnit::LightClusterIndices);
+  }
 
   cameraWorldPosUniform_ = uniformLocation("uCameraWorldPos");
 
@@ -512,6 +633,122 @@ PbrShader::PbrShader(const Configuration& config)
   }
 }  // constructor
 
+std::string PbrShader::programBinaryFilename(
+    const Cr::Utility::Resource& sources) const {
+#ifndef MAGNUM_TARGET_GLES
+  const std::string directory = programBinaryCacheDirectory();
+  Mn::GL::Context& context = Mn::GL::Context::current();
+  if (directory.empty() ||
+      !context.isExtensionSupported<
+          Mn::GL::Extensions::ARB::get_program_binary>()) {
+    return {};
+  }
+
+  // everything the program depends on: the variant, which selects the
+  // defines, the sources and the driver compiling them
+  core::Fnv1aHash hash;
+  hash.add(static_cast<Flags::UnderlyingType>(flags_));
+  for (const Mn::UnsignedInt count : {lightCount_, jointCount_,
+                                      perVertexJointCount_,
+                                      secondaryPerVertexJointCount_}) {
+    hash.add(count);
+  }
+  for (const char* file : ShaderSourceFiles) {
+    hash.addString(sources.getString(file));
+  }
+  hash.addString(context.vendorString());
+  hash.addString(context.rendererString());
+  hash.addString(context.versionString());
+
+  return Cr::Utility::Path::join(
+      directory,
+      Cr::Utility::formatString("pbr.{}.program",
+                                core::hashHexString(hash.value())));
+#else
+  static_cast<void>(sources);
+  return {};
+#endif
+}
+
+bool PbrShader::loadProgramBinary(const std::string& filename) {
+#ifndef MAGNUM_TARGET_GLES
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  ProgramBinaryHeader header;
+  if (!data || data->size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (std::memcmp(header.magic, ProgramBinaryMagic, sizeof(header.magic)) !=
+          0 ||
+      data->size() != sizeof(header) + header.size) {
+    return false;
+  }
+  if (header.flags != static_cast<Flags::UnderlyingType>(flags_) ||
+      header.lightCount != lightCount_ || header.jointCount != jointCount_ ||
+      header.perVertexJointCount != perVertexJointCount_ ||
+      header.secondaryPerVertexJointCount != secondaryPerVertexJointCount_) {
+    ESP_DEBUG() << "Ignoring the program binary" << filename
+                << "of a different shader variant";
+    return false;
+  }
+
+  // the driver rejects binaries it can't use anymore, e.g. after an update
+  // that didn't change the version string
+  glProgramBinary(id(), header.format, data->data() + sizeof(header),
+                  header.size);
+  GLint linked = GL_FALSE;
+  glGetProgramiv(id(), GL_LINK_STATUS, &linked);
+  if (linked != GL_TRUE) {
+    ESP_DEBUG() << "Ignoring the outdated program binary" << filename;
+    return false;
+  }
+  return true;
+#else
+  static_cast<void>(filename);
+  return false;
+#endif
+}
+
+void PbrShader::saveProgramBinary(const std::string& filename) {
+#ifndef MAGNUM_TARGET_GLES
+  GLint size = 0;
+  glGetProgramiv(id(), GL_PROGRAM_BINARY_LENGTH, &size);
+  if (size <= 0) {
+    return;
+  }
+  Cr::Containers::Array<char> data{Cr::NoInit,
+                                   sizeof(ProgramBinaryHeader) + size};
+  ProgramBinaryHeader header{};
+  std::memcpy(header.magic, ProgramBinaryMagic, sizeof(header.magic));
+  GLenum format = 0;
+  GLsizei written = 0;
+  glGetProgramBinary(id(), size, &written, &format,
+                     data.data() + sizeof(header));
+  if (written != size) {
+    return;
+  }
+  header.format = format;
+  header.size = Mn::UnsignedInt(size);
+  header.flags = static_cast<Flags::UnderlyingType>(flags_);
+  header.lightCount = lightCount_;
+  header.jointCount = jointCount_;
+  header.perVertexJointCount = perVertexJointCount_;
+  header.secondaryPerVertexJointCount = secondaryPerVertexJointCount_;
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  // other processes may create the same variant at the same time
+  if (!core::writeFileAtomically(filename, data)) {
+    ESP_WARNING() << "Unable to write the program binary" << filename;
+  }
+#else
+  static_cast<void>(filename);
+#endif
+}
+
 // Note: the texture binding points are explicitly specified above.
 // Cannot use "explicit uniform location" directly in shader since
 // it requires GL4.3 (We stick to GL4.1 for MacOS).
@@ -559,6 +796,51 @@ PbrShader& PbrShader::bindEmissiveTexture(Mn::GL::Texture2D& texture) {
   return *this;
 }
 
+PbrShader& PbrShader::bindBaseColorTexture(Mn::GL::Texture2DArray& texture) {
+  CORRADE_ASSERT(flags_ >= (Flag::BaseColorTexture | Flag::TextureArrays),
+                 "PbrShader::bindBaseColorTexture(): the shader was not "
+                 "created with base color texture arrays enabled",
+                 *this);
+  if (lightingIsEnabled_) {
+    texture.bind(pbrTextureUnitSpace::TextureUnit::BaseColor);
+  }
+  return *this;
+}
+
+PbrShader& PbrShader::bindMetallicRoughnessTexture(
+    Mn::GL::Texture2DArray& texture) {
+  CORRADE_ASSERT(
+      flags_ >= (Flag::NoneRoughnessMetallicTexture | Flag::TextureArrays),
+      "PbrShader::bindMetallicRoughnessTexture(): the shader was not "
+      "created with metallicRoughness texture arrays enabled.",
+      *this);
+  if (lightingIsEnabled_) {
+    texture.bind(pbrTextureUnitSpace::TextureUnit::MetallicRoughness);
+  }
+  return *this;
+}
+
+PbrShader& PbrShader::bindNormalTexture(Mn::GL::Texture2DArray& texture) {
+  CORRADE_ASSERT(flags_ >= (Flag::NormalTexture | Flag::TextureArrays),
+                 "PbrShader::bindNormalTexture(): the shader was not "
+                 "created with normal texture arrays enabled",
+                 *this);
+  if (lightingIsEnabled_) {
+    texture.bind(pbrTextureUnitSpace::TextureUnit::Normal);
+  }
+  return *this;
+}
+
+PbrShader& PbrShader::bindEmissiveTexture(Mn::GL::Texture2DArray& texture) {
+  CORRADE_ASSERT(flags_ >= (Flag::EmissiveTexture | Flag::TextureArrays),
+                 "PbrShader::bindEmissiveTexture(): the shader was not "
+                 "created with emissive texture arrays enabled",
+                 *this);
+  // emissive texture does not depend on lights
+  texture.bind(pbrTextureUnitSpace::TextureUnit::Emissive);
+  return *this;
+}
+
 PbrShader& PbrShader::bindClearCoatFactorTexture(Mn::GL::Texture2D& texture) {
   CORRADE_ASSERT(flags_ >= Flag::ClearCoatTexture,
                  "PbrShader::bindClearCoatFactorTexture(): the shader was not "
@@ -656,8 +938,26 @@ PbrShader& PbrShader::bindPrefilteredMap(Mn::GL::CubeMapTexture& texture) {
   return *this;
 }
 
+#ifndef MAGNUM_TARGET_GLES
+PbrShader& PbrShader::bindLightClusters(Mn::GL::BufferTexture& clusters,
+                                        Mn::GL::BufferTexture& lightIndices) {
+  CORRADE_ASSERT(flags_ >= Flag::ClusteredLighting,
+                 "PbrShader::bindLightClusters(): the shader was not "
+                 "created with clustered lighting enabled",
+                 *this);
+  if (directLightingIsEnabled_) {
+    clusters.bind(pbrTextureUnitSpace::TextureUnit::LightClusters);
+    lightIndices.bind(pbrTextureUnitSpace::TextureUnit::LightClusterIndices);
+  }
+  return *this;
+}
+#endif
+
 PbrShader& PbrShader::setProjectionMatrix(const Mn::Matrix4& matrix) {
-  setUniform(projMatrixUniform_, matrix);
+  if (matrix != uploadedProjectionMatrix_) {
+    setUniform(projMatrixUniform_, matrix);
+    uploadedProjectionMatrix_ = matrix;
+  }
   return *this;
 }
 
@@ -667,7 +967,10 @@ PbrShader& PbrShader::setNormalMatrix(const Mn::Matrix3x3& matrix) {
 }
 
 PbrShader& PbrShader::setViewMatrix(const Mn::Matrix4& matrix) {
-  setUniform(viewMatrixUniform_, matrix);
+  if (matrix != uploadedViewMatrix_) {
+    setUniform(viewMatrixUniform_, matrix);
+    uploadedViewMatrix_ = matrix;
+  }
   return *this;
 }
 
@@ -692,35 +995,66 @@ PbrShader& PbrShader::setPrefilteredMapMipLevels(unsigned int mipLevels) {
   return *this;
 }
 
+PbrShader& PbrShader::setLightClusterParameters(
+    const Mn::Vector4& depthPlane,
+    const Mn::Vector2& tileScale,
+    const Mn::Vector2& sliceScaleBias) {
+  CORRADE_ASSERT(flags_ >= Flag::ClusteredLighting,
+                 "PbrShader::setLightClusterParameters(): the shader was not "
+                 "created with clustered lighting enabled",
+                 *this);
+  if (!directLightingIsEnabled_) {
+    return *this;
+  }
+  const Mn::Vector4 scale{tileScale.x(), tileScale.y(), sliceScaleBias.x(),
+                          sliceScaleBias.y()};
+  if (depthPlane != uploadedClusterDepthPlane_) {
+    setUniform(clusterDepthPlaneUniform_, depthPlane);
+    uploadedClusterDepthPlane_ = depthPlane;
+  }
+  if (scale != uploadedClusterScale_) {
+    setUniform(clusterScaleUniform_, scale);
+    uploadedClusterScale_ = scale;
+  }
+  return *this;
+}
+
 PbrShader& PbrShader::setBaseColor(const Mn::Color4& color) {
-  if (lightingIsEnabled_) {
+  if (lightingIsEnabled_ && color != uploadedBaseColor_) {
     setUniform(baseColorUniform_, color);
+    uploadedBaseColor_ = color;
   }
   return *this;
 }
 
 PbrShader& PbrShader::setEmissiveColor(const Mn::Color3& color) {
-  setUniform(emissiveColorUniform_, color);
+  if (color != uploadedEmissiveColor_) {
+    setUniform(emissiveColorUniform_, color);
+    uploadedEmissiveColor_ = color;
+  }
   return *this;
 }
 
 PbrShader& PbrShader::setRoughness(float roughness) {
-  if (lightingIsEnabled_) {
+  if (lightingIsEnabled_ && roughness != uploadedRoughness_) {
     setUniform(roughnessUniform_, roughness);
+    uploadedRoughness_ = roughness;
   }
   return *this;
 }
 
 PbrShader& PbrShader::setMetallic(float metallic) {
-  if (lightingIsEnabled_) {
+  if (lightingIsEnabled_ && metallic != uploadedMetallic_) {
     setUniform(metallicUniform_, metallic);
+    uploadedMetallic_ = metallic;
   }
   return *this;
 }
 
 PbrShader& PbrShader::setIndexOfRefraction(float ior) {
-  if (lightingIsEnabled_) {
+  if (lightingIsEnabled_ && ior != uploadedIor_) {
     setUniform(iorUniform_, ior);
+    uploadedIor_ = ior;
   }
   return *this;
 }
@@ -795,7 +1129,10 @@ PbrShader& PbrShader::setDebugDisplay(PbrDebugDisplay index) {
 
 PbrShader& PbrShader::setCameraWorldPosition(
     const Mn::Vector3& cameraWorldPos) {
-  setUniform(cameraWorldPosUniform_, cameraWorldPos);
+  if (cameraWorldPos != uploadedCameraWorldPos_) {
+    setUniform(cameraWorldPosUniform_, cameraWorldPos);
+    uploadedCameraWorldPos_ = cameraWorldPos;
+  }
   return *this;
 }
 
@@ -818,7 +1155,11 @@ PbrShader& PbrShader::setLightPositions(
                  "PbrShader::setLightPositions(): expected"
                      << lightCount_ << "items but got" << vectors.size(),
                  *this);
-  setUniform(lightDirectionsUniform_, vectors);
+  if (!std::equal(vectors.begin(), vectors.end(),
+                  uploadedLightPositions_.begin())) {
+    setUniform(lightDirectionsUniform_, vectors);
+    std::copy(vectors.begin(), vectors.end(), uploadedLightPositions_.begin());
+  }
   return *this;
 }
 
@@ -835,6 +1176,7 @@ PbrShader& PbrShader::setLightPosition(unsigned int lightIndex,
       *this);
 
   setUniform(lightDirectionsUniform_ + lightIndex, Mn::Vector4{pos, 1.0});
+  uploadedLightPositions_[lightIndex] = Mn::Vector4{pos, 1.0};
   return *this;
 }
 
@@ -845,6 +1187,7 @@ PbrShader& PbrShader::setLightDirection(unsigned int lightIndex,
       "PbrShader::setLightDirection: lightIndex" << lightIndex << "is illegal.",
       *this);
   setUniform(lightDirectionsUniform_ + lightIndex, Mn::Vector4{dir, 0.0});
+  uploadedLightPositions_[lightIndex] = Mn::Vector4{dir, 0.0};
   return *this;
 }
 
@@ -863,6 +1206,7 @@ PbrShader& PbrShader::setLightVector(unsigned int lightIndex,
                  *this);
 
   setUniform(lightDirectionsUniform_ + lightIndex, vec);
+  uploadedLightPositions_[lightIndex] = vec;
 
   return *this;
 }
@@ -873,6 +1217,7 @@ PbrShader& PbrShader::setLightRange(unsigned int lightIndex, float range) {
       "PbrShader::setLightRange: lightIndex" << lightIndex << "is illegal.",
       *this);
   setUniform(lightRangesUniform_ + lightIndex, range);
+  uploadedLightRanges_[lightIndex] = range;
   return *this;
 }
 PbrShader& PbrShader::setLightColor(unsigned int lightIndex,
@@ -883,7 +1228,10 @@ PbrShader& PbrShader::setLightColor(unsigned int lightIndex,
       "PbrShader::setLightColor: lightIndex" << lightIndex << "is illegal.",
       *this);
   Mn::Vector3 finalColor = intensity * color;
-  setUniform(lightColorsUniform_ + lightIndex, finalColor);
+  if (finalColor != uploadedLightColors_[lightIndex]) {
+    setUniform(lightColorsUniform_ + lightIndex, finalColor);
+    uploadedLightColors_[lightIndex] = finalColor;
+  }
   return *this;
 }
 
@@ -945,6 +1293,18 @@ PbrShader& PbrShader::setNormalTextureScale(float scale) {
   return *this;
 }
 
+PbrShader& PbrShader::setTextureLayers(const Mn::Vector4ui& layers) {
+  CORRADE_ASSERT(flags_ >= Flag::TextureArrays,
+                 "PbrShader::setTextureLayers(): the shader was not "
+                 "created with texture arrays enabled",
+                 *this);
+  if (layers != uploadedTextureLayers_) {
+    setUniform(textureLayersUniform_, layers);
+    uploadedTextureLayers_ = layers;
+  }
+  return *this;
+}
+
 PbrShader& PbrShader::setLightRanges(
     Corrade::Containers::ArrayView<const float> ranges) {
   CORRADE_ASSERT(lightCount_ == ranges.size(),
@@ -952,7 +1312,11 @@ PbrShader& PbrShader::setLightRanges(
                      << lightCount_ << "items but got" << ranges.size(),
                  *this);
 
-  setUniform(lightRangesUniform_, ranges);
+  if (!std::equal(ranges.begin(), ranges.end(),
+                  uploadedLightRanges_.begin())) {
+    setUniform(lightRangesUniform_, ranges);
+    std::copy(ranges.begin(), ranges.end(), uploadedLightRanges_.begin());
+  }
   return *this;
 }
 
@@ -6,11 +6,16 @@
 #define ESP_GFX_PBRSHADER_H_
 
 #include <initializer_list>
+#include <string>
+#include <vector>
 
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/EnumSet.h>
+#include <Corrade/Utility/Utility.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/GL.h>  // header with all forward declarations for the Magnum::GL namespace
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Shaders/GenericGL.h>
 
 #include "esp/core/Esp.h"
@@ -84,6 +89,28 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   typedef Magnum::Shaders::GenericGL3D::Color4 Color4;
 
+  /**
+   * @brief Per-vertex or per-instance object ID
+   *
+   * Used only if @ref Flag::InstancedObjectId is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::ObjectId ObjectId;
+
+  /**
+   * @brief Per-instance transformation, applied before the model matrix
+   *
+   * Used only if @ref Flag::InstancedTransformation is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::TransformationMatrix
+      TransformationMatrix;
+
+  /**
+   * @brief Per-instance normal matrix, applied before the normal matrix
+   *
+   * Used only if @ref Flag::InstancedTransformation is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::NormalMatrix NormalMatrix;
+
   enum : Magnum::UnsignedInt {
     /**
      * Color shader output. @ref shaders-generic "Generic output",
@@ -181,8 +208,9 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
 
     /**
      * Support Instanced object ID. Retrieves a per-instance / per-vertex
-     * object ID from the @ref ObjectId attribute. If this is false, the shader
-     * will use the node's semantic ID
+     * object ID from the @ref ObjectId attribute, which is added to the
+     * value set by @ref setObjectId(). If this is false, the shader will use
+     * the node's semantic ID
      */
     InstancedObjectId = (1ULL << 9) | ObjectId,
 
@@ -357,6 +385,39 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
      * PbrDebugDisplay in the fragment shader for debugging
      */
     DebugDisplay = 1ULL << 37,
+
+    /**
+     * Enable instanced transformation. Retrieves a per-instance
+     * transformation and normal matrix from the @ref TransformationMatrix
+     * and @ref NormalMatrix attributes, applied before the matrices set by
+     * @ref setModelMatrix() and @ref setNormalMatrix().
+     */
+    InstancedTransformation = 1ULL << 38,
+
+    /**
+     * The base color, metallic-roughness, normal and emissive textures are
+     * layers of texture arrays instead of separate 2D textures. Bind them
+     * with the @ref Magnum::GL::Texture2DArray overloads and select the
+     * layers with @ref setTextureLayers().
+     */
+    TextureArrays = 1ULL << 39,
+
+    /**
+     * Shade each fragment only with the lights of its cell in a grid over the
+     * view frustum, see @ref LightClusters, instead of with all lights. Bind
+     * the clusters with @ref bindLightClusters() and set them up with
+     * @ref setLightClusterParameters(). Lights are then cut off at their
+     * ranges set with @ref setLightRanges(). Only available on desktop GL.
+     */
+    ClusteredLighting = 1ULL << 40,
+
+    /**
+     * Look up the IBL specular lobe from the irradiance map instead of the
+     * prefiltered environment map, as if every surface was fully rough. Used
+     * by the fast quality tier, see
+     * @ref metadata::attributes::PbrShaderQuality::Fast.
+     */
+    FastIBLSpecular = 1ULL << 41,
     /*
      * TODO: alphaMask
      */
@@ -375,6 +436,25 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   explicit PbrShader(const Configuration& config);
 
+  /**
+   * @brief Set a directory caching the linked program binaries of all PBR
+   * shaders created afterwards in the process
+   *
+   * The binaries are keyed by the shader variant, the shader sources and the
+   * GL vendor, renderer and version, so a later process creating the same
+   * variant on the same driver loads the binary instead of compiling and
+   * linking the shaders. The files also store the flags and counts of the
+   * variant, a binary of a different variant is never loaded. Used only if the context supports
+   * @gl_extension{ARB,get_program_binary}. An empty path disables the cache.
+   * The directory has to exist.
+   */
+  static void setProgramBinaryCacheDirectory(const std::string& directory);
+
+  /**
+   * @brief Directory set with @ref setProgramBinaryCacheDirectory()
+   */
+  static std::string programBinaryCacheDirectory();
+
   /** @brief Copying is not allowed */
   PbrShader(const PbrShader&) = delete;
 
@@ -434,6 +514,34 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   PbrShader& bindEmissiveTexture(Magnum::GL::Texture2D& texture);
 
+  /**
+   * @brief Bind the texture array holding the BaseColor texture
+   * Expects that the shader was created with @ref Flag::TextureArrays.
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& bindBaseColorTexture(Magnum::GL::Texture2DArray& texture);
+
+  /**
+   * @brief Bind the texture array holding the metallic-roughness texture
+   * Expects that the shader was created with @ref Flag::TextureArrays.
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& bindMetallicRoughnessTexture(Magnum::GL::Texture2DArray& texture);
+
+  /**
+   * @brief Bind the texture array holding the normal texture
+   * Expects that the shader was created with @ref Flag::TextureArrays.
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& bindNormalTexture(Magnum::GL::Texture2DArray& texture);
+
+  /**
+   * @brief Bind the texture array holding the emissive texture
+   * Expects that the shader was created with @ref Flag::TextureArrays.
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& bindEmissiveTexture(Magnum::GL::Texture2DArray& texture);
+
   /**
    * @brief Bind the clearcoat factor texture
    * @return Reference to self (for method chaining)
@@ -490,6 +598,17 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   PbrShader& bindPrefilteredMap(Magnum::GL::CubeMapTexture& texture);
 
+#ifndef MAGNUM_TARGET_GLES
+  /**
+   * @brief Bind the light clusters of @ref LightClusters::clusterTexture()
+   * and @ref LightClusters::lightIndexTexture()
+   * NOTE: requires Flag::ClusteredLighting is set
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& bindLightClusters(Magnum::GL::BufferTexture& clusters,
+                               Magnum::GL::BufferTexture& lightIndices);
+#endif
+
   // ======== set uniforms ===========
   /**
    * @brief set the texture transformation matrix
@@ -613,6 +732,21 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   PbrShader& setPrefilteredMapMipLevels(unsigned int mipLevels);
 
+  /**
+   * @brief Set how fragments find their light cluster
+   * @param depthPlane      Plane giving the view depth of a world position,
+   *    see @ref LightClusters::depthPlane()
+   * @param tileScale       Scale of fragment coordinates giving the tile,
+   *    see @ref LightClusters::tileScale()
+   * @param sliceScaleBias  Scale and bias of the log depth giving the depth
+   *    slice, see @ref LightClusters::sliceScaleBias()
+   * NOTE: requires Flag::ClusteredLighting is set
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& setLightClusterParameters(const Magnum::Vector4& depthPlane,
+                                       const Magnum::Vector2& tileScale,
+                                       const Magnum::Vector2& sliceScaleBias);
+
   /**
    * @brief Set light positions or directions
    * @param vectors an array of the light vectors
@@ -748,6 +882,14 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   PbrShader& setNormalTextureScale(float scale);
 
+  /**
+   *  @brief Set the texture array layers of the base color,
+   *  metallic-roughness, normal and emissive textures, in this order
+   *  Expects that the shader was created with @ref Flag::TextureArrays.
+   *  @return Reference to self (for method chaining)
+   */
+  PbrShader& setTextureLayers(const Magnum::Vector4ui& layers);
+
   /**
    * @brief Set joint matrices
    * (See Magnum/Shaders/PhongGL.h)
@@ -869,6 +1011,7 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
   int objectIdUniform_ = ID_UNDEFINED;
   int textureMatrixUniform_ = ID_UNDEFINED;
   int normalTextureScaleUniform_ = ID_UNDEFINED;
+  int textureLayersUniform_ = ID_UNDEFINED;
   int lightColorsUniform_ = ID_UNDEFINED;
   int lightRangesUniform_ = ID_UNDEFINED;
 
@@ -893,6 +1036,8 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
 
   int cameraWorldPosUniform_ = ID_UNDEFINED;
   int prefilteredMapMipLevelsUniform_ = ID_UNDEFINED;
+  int clusterDepthPlaneUniform_ = ID_UNDEFINED;
+  int clusterScaleUniform_ = ID_UNDEFINED;
 
   // Clearcoat layer
   int clearCoatFactorUniform_ = ID_UNDEFINED;
@@ -915,6 +1060,41 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
 
   // pbr debug info
   int pbrDebugDisplayUniform_ = ID_UNDEFINED;
+
+  // ======= uploaded values =======
+  // Values last uploaded to the uniforms that are set for every draw but
+  // mostly shared by consecutive drawables: the camera, the lights and the
+  // material factors. Setting the same value again skips the upload, so with
+  // drawables sorted by draw state only the per-drawable transformations
+  // change between draws. GL initializes uniforms to zero, as are these.
+  Magnum::Matrix4 uploadedProjectionMatrix_{Magnum::Math::ZeroInit};
+  Magnum::Matrix4 uploadedViewMatrix_{Magnum::Math::ZeroInit};
+  Magnum::Vector3 uploadedCameraWorldPos_;
+  Magnum::Color4 uploadedBaseColor_;
+  Magnum::Float uploadedRoughness_{};
+  Magnum::Float uploadedMetallic_{};
+  Magnum::Float uploadedIor_{};
+  Magnum::Color3 uploadedEmissiveColor_;
+  Magnum::Vector4ui uploadedTextureLayers_;
+  Magnum::Vector4 uploadedClusterDepthPlane_;
+  Magnum::Vector4 uploadedClusterScale_;
+  std::vector<Magnum::Vector4> uploadedLightPositions_;
+  std::vector<Magnum::Vector3> uploadedLightColors_;
+  std::vector<Magnum::Float> uploadedLightRanges_;
+
+ private:
+  /**
+   * @brief Path of the file in @ref programBinaryCacheDirectory() holding
+   * the binary of this variant, or an empty string if binaries aren't cached
+   */
+  std::string programBinaryFilename(
+      const Corrade::Utility::Resource& sources) const;
+
+  /** @brief Load the program from @p filename instead of linking it */
+  bool loadProgramBinary(const std::string& filename);
+
+  /** @brief Write the linked program to @p filename */
+  void saveProgramBinary(const std::string& filename);
 };
 
 /**
@@ -4,11 +4,20 @@
 
 #include "RenderCamera.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/Renderer.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Drawable.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "esp/core/Hash.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/Profiler.h"
+#include "esp/gfx/Drawable.h"
 #include "esp/scene/SceneGraph.h"
 
 namespace Mn = Magnum;
@@ -17,35 +26,79 @@ namespace Cr = Corrade;
 namespace esp {
 namespace gfx {
 
+namespace {
+//! last render pass identifier handed out by RenderCamera::draw()
+std::uint64_t drawPassCounter = 0;
+
+//! Order-independent signature of drawables and their transformations, a sum
+//! of a 64-bit FNV-1a variant over the id and matrix words of each, and the
+//! joint transformations of skinned ones
+std::uint64_t signatureOf(
+    const RenderCamera::DrawableTransforms& drawableTransforms) {
+  std::uint64_t signature = drawableTransforms.size();
+  for (const auto& drawableTransform : drawableTransforms) {
+    const auto* drawable =
+        dynamic_cast<const Drawable*>(&drawableTransform.first.get());
+    core::Fnv1aHash hash;
+    hash.addWord(drawable ? drawable->getDrawableId()
+                          : std::uint64_t(reinterpret_cast<std::uintptr_t>(
+                                &drawableTransform.first.get())));
+    std::uint32_t words[16];
+    std::memcpy(words, drawableTransform.second.data(), sizeof(words));
+    for (const std::uint32_t word : words) {
+      hash.addWord(word);
+    }
+    if (drawable) {
+      drawable->addSkinPoseToHash(hash);
+    }
+    signature += hash.value();
+  }
+  return signature;
+}
+
 /**
- * @brief do frustum culling with temporal coherence
- * @param range the axis-aligned bounding box
+ * @brief Frustum cull a range of bounding boxes in SoA layout
+ * @param buffers the boxes as center (min + max) and extent (max - min)
  * @param frustum the frustum
- * @param frustumPlaneIndex the frustum plane in last frame that culled the
- * aabb (default: 0)
- * @return NullOpt if aabb intersects the frustum, otherwise the frustum plane
- * that culls the aabb
+ * @param begin first box to test
+ * @param end one past the last box to test
+ *
+ * Sets @p buffers.culledPlane to the first frustum plane culling the box, -1
+ * if it intersects the frustum. Branchless over the boxes so that the compiler
+ * can vectorize the plane tests.
  */
-Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
-                                           const Mn::Frustum& frustum,
-                                           int frustumPlaneIndex = 0) {
-  const Mn::Vector3 center = range.min() + range.max();
-  const Mn::Vector3 extent = range.max() - range.min();
-
+template <class Buffers>
+void cullBoxes(Buffers& buffers,
+               const Mn::Frustum& frustum,
+               std::size_t begin,
+               std::size_t end) {
+  const float* cx = buffers.centerX.data();
+  const float* cy = buffers.centerY.data();
+  const float* cz = buffers.centerZ.data();
+  const float* ex = buffers.extentX.data();
+  const float* ey = buffers.extentY.data();
+  const float* ez = buffers.extentZ.data();
+  std::int8_t* culledPlane = buffers.culledPlane.data();
+
+  std::fill(culledPlane + begin, culledPlane + end, std::int8_t{-1});
   for (int iPlane = 0; iPlane < 6; ++iPlane) {
-    int index = (iPlane + frustumPlaneIndex) % 6;
-    const Mn::Vector4& plane = frustum[index];
-
+    const Mn::Vector4& plane = frustum[iPlane];
     const Mn::Vector3 absPlaneNormal = Mn::Math::abs(plane.xyz());
-
-    const float d = Mn::Math::dot(center, plane.xyz());
-    const float r = Mn::Math::dot(extent, absPlaneNormal);
-    if (d + r < -2.0f * plane.w())
-      return Cr::Containers::Optional<int>{index};
+    const float nx = plane.x(), ny = plane.y(), nz = plane.z();
+    const float ax = absPlaneNormal.x(), ay = absPlaneNormal.y(),
+                az = absPlaneNormal.z();
+    const float threshold = -2.0f * plane.w();
+    for (std::size_t i = begin; i < end; ++i) {
+      const float d = cx[i] * nx + cy[i] * ny + cz[i] * nz;
+      const float r = ex[i] * ax + ey[i] * ay + ez[i] * az;
+      const bool outside = d + r < threshold;
+      culledPlane[i] = (culledPlane[i] < 0 && outside)
+                           ? static_cast<std::int8_t>(iPlane)
+                           : culledPlane[i];
+    }
   }
-
-  return Cr::Containers::NullOpt;
 }
+}  // namespace
 
 RenderCamera::RenderCamera(scene::SceneNode& node,
                            esp::scene::SceneNodeSemanticDataIDX semanticDataIDX)
@@ -117,26 +170,106 @@ size_t RenderCamera::cull(DrawableTransforms& drawableTransforms) {
   const Mn::Frustum frustum =
       Mn::Frustum::fromMatrix(projectionMatrix() * cameraMatrix());
 
-  auto newEndIter = std::remove_if(
-      drawableTransforms.begin(), drawableTransforms.end(),
-      [&](const std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
-                          Mn::Matrix4>& a) {
-        // obtain the absolute aabb
-        auto& node = static_cast<scene::SceneNode&>(a.first.get().object());
-        // This updates the AABB for dynamic objects if needed
-        node.setClean();
-        const Mn::Range3D& aabb = node.getAbsoluteAABB();
-
-        Cr::Containers::Optional<int> culledPlane =
-            rangeFrustum(aabb, frustum, node.getFrustumPlaneIndex());
-        if (culledPlane) {
-          node.setFrustumPlaneIndex(*culledPlane);
-        }
-        // if it has value, it means the aabb is culled
-        return (culledPlane != Cr::Containers::NullOpt);
-      });
+  const std::size_t numDrawables = drawableTransforms.size();
+  CullingBuffers& buffers = cullingBuffers_;
+  buffers.culledPlane.resize(numDrawables);
+  if (hierarchicalCulling_) {
+    cullHierarchical(drawableTransforms, frustum);
+  } else {
+    cullFlat(drawableTransforms, frustum);
+  }
 
-  return (newEndIter - drawableTransforms.begin());
+  // compact the visible drawables to the front, keeping their order
+  std::size_t numVisible = 0;
+  for (std::size_t i = 0; i < numDrawables; ++i) {
+    const int culledPlane = buffers.culledPlane[i];
+    if (culledPlane < 0) {
+      if (numVisible != i) {
+        drawableTransforms[numVisible] = drawableTransforms[i];
+      }
+      ++numVisible;
+    } else {
+      static_cast<scene::SceneNode&>(drawableTransforms[i].first.get().object())
+          .setFrustumPlaneIndex(culledPlane);
+    }
+  }
+
+  return numVisible;
+}
+
+void RenderCamera::cleanAbsoluteAABBs(
+    const DrawableTransforms& drawableTransforms) {
+  cullingNodes_.resize(drawableTransforms.size());
+  for (std::size_t i = 0; i < drawableTransforms.size(); ++i) {
+    auto& node = static_cast<scene::SceneNode&>(
+        drawableTransforms[i].first.get().object());
+    // This updates the AABB for dynamic objects if needed
+    node.setClean();
+    cullingNodes_[i] = &node;
+  }
+  scene::SceneNode::updateAbsoluteAABBs(cullingNodes_);
+}
+
+void RenderCamera::cullFlat(DrawableTransforms& drawableTransforms,
+                            const Mn::Frustum& frustum) {
+  const std::size_t numDrawables = drawableTransforms.size();
+  CullingBuffers& buffers = cullingBuffers_;
+  for (auto* buffer : {&buffers.centerX, &buffers.centerY, &buffers.centerZ,
+                       &buffers.extentX, &buffers.extentY, &buffers.extentZ}) {
+    buffer->resize(numDrawables);
+  }
+
+  // gather the absolute aabbs, serially as updating them may touch shared
+  // parent nodes
+  cleanAbsoluteAABBs(drawableTransforms);
+  for (std::size_t i = 0; i < numDrawables; ++i) {
+    const Mn::Range3D& aabb = cullingNodes_[i]->getAbsoluteAABB();
+    const Mn::Vector3 center = aabb.min() + aabb.max();
+    const Mn::Vector3 extent = aabb.max() - aabb.min();
+    buffers.centerX[i] = center.x();
+    buffers.centerY[i] = center.y();
+    buffers.centerZ[i] = center.z();
+    buffers.extentX[i] = extent.x();
+    buffers.extentY[i] = extent.y();
+    buffers.extentZ[i] = extent.z();
+  }
+
+  constexpr std::size_t chunkSize = 1024;
+  const std::size_t numChunks = (numDrawables + chunkSize - 1) / chunkSize;
+  core::parallelFor(numChunks, cullingNumThreads_,
+                    [&](std::size_t chunk, int) {
+                      const std::size_t begin = chunk * chunkSize;
+                      const std::size_t end =
+                          std::min(begin + chunkSize, numDrawables);
+                      cullBoxes(buffers, frustum, begin, end);
+                    });
+}
+
+void RenderCamera::cullHierarchical(DrawableTransforms& drawableTransforms,
+                                    const Mn::Frustum& frustum) {
+  const std::size_t numDrawables = drawableTransforms.size();
+  bool rebuild = cullingBvhDrawables_.size() != numDrawables;
+  for (std::size_t i = 0; i < numDrawables && !rebuild; ++i) {
+    rebuild = cullingBvhDrawables_[i] != &drawableTransforms[i].first.get();
+  }
+
+  cleanAbsoluteAABBs(drawableTransforms);
+  if (rebuild) {
+    cullingBvhDrawables_.resize(numDrawables);
+    cullingBvhBoxes_.resize(numDrawables);
+    for (std::size_t i = 0; i < numDrawables; ++i) {
+      cullingBvhDrawables_[i] = &drawableTransforms[i].first.get();
+      cullingBvhBoxes_[i] = cullingNodes_[i]->getAbsoluteAABB();
+    }
+    cullingBvh_.build(cullingBvhBoxes_);
+  } else {
+    // only the paths to the changed boxes get refit
+    for (std::size_t i = 0; i < numDrawables; ++i) {
+      cullingBvh_.setBox(i, cullingNodes_[i]->getAbsoluteAABB());
+    }
+  }
+
+  cullingBvh_.cull(frustum, cullingBuffers_.culledPlane.data());
 }
 
 size_t RenderCamera::removeNonObjects(DrawableTransforms& drawableTransforms) {
@@ -153,13 +286,49 @@ size_t RenderCamera::removeNonObjects(DrawableTransforms& drawableTransforms) {
 
 uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
                             Flags flags) {
+  ESP_PROFILE_SCOPE("draw");
+  ScopedGpuProfile gpuProfile{gpuDrawProfile_};
   previousNumVisibleDrawables_ = drawableTransforms.size();
+  drawPass_ = ++drawPassCounter;
+  previousDrawSignature_ = signatureOf(drawableTransforms);
 
   if (flags & Flag::UseDrawableIdAsObjectId) {
     semanticIDXToUse_ = esp::scene::SceneNodeSemanticDataIDX::DRAWABLE_ID;
   }
 
-  MagnumCamera::draw(drawableTransforms);
+  if (flags & Flag::DepthAndObjectIdOnly) {
+    previousNumDrawCalls_ = drawDepthAndObjectId(drawableTransforms);
+  } else {
+    const bool depthPrePass = bool(flags & Flag::DepthPrePass);
+    std::size_t numPrePassDrawCalls = 0;
+    if (depthPrePass) {
+      ESP_PROFILE_SCOPE("depthPrePass");
+      // The pre-pass and the full pass use different shaders, which don't
+      // compute bit-identical depths, so an Equal test would drop pixels.
+      // Instead the pre-pass depth is pushed back slightly and the full pass
+      // tests less-or-equal, writing the exact depth of the surfaces it
+      // shades.
+      Mn::GL::Renderer::setColorMask(false, false, false, false);
+      numPrePassDrawCalls = drawDepthAndObjectId(drawableTransforms, true);
+      Mn::GL::Renderer::setPolygonOffset(0.0f, 0.0f);
+      Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::PolygonOffsetFill);
+      Mn::GL::Renderer::setColorMask(true, true, true, true);
+      Mn::GL::Renderer::setDepthFunction(
+          Mn::GL::Renderer::DepthFunction::LessOrEqual);
+    }
+
+    if (flags & Flag::UseInstancing) {
+      drawInstanced(drawableTransforms);
+    } else {
+      MagnumCamera::draw(drawableTransforms);
+      previousNumDrawCalls_ = drawableTransforms.size();
+    }
+
+    if (depthPrePass) {
+      Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
+      previousNumDrawCalls_ += numPrePassDrawCalls;
+    }
+  }
 
   // Reset to using the base semantic idx assigned to this camera
   semanticIDXToUse_ = semanticInfoIDX_;
@@ -173,8 +342,75 @@ uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
   return draw(drawableTransforms, flags);
 }
 
+size_t RenderCamera::drawDepthAndObjectId(
+    DrawableTransforms& drawableTransforms,
+    const bool depthOffset) {
+  for (auto& drawableTransform : drawableTransforms) {
+    if (depthOffset) {
+      // set for every drawable, as drawables doing a full draw may change it
+      Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::PolygonOffsetFill);
+      Mn::GL::Renderer::setPolygonOffset(1.0f, 1.0f);
+    }
+    auto* drawable = dynamic_cast<Drawable*>(&drawableTransform.first.get());
+    if (drawable) {
+      drawable->drawDepthAndObjectId(drawableTransform.second, *this);
+    } else {
+      drawableTransform.first.get().draw(drawableTransform.second, *this);
+    }
+  }
+  return drawableTransforms.size();
+}
+
+void RenderCamera::drawInstanced(DrawableTransforms& drawableTransforms) {
+  previousNumDrawCalls_ = 0;
+  std::size_t first = 0;
+  while (first < drawableTransforms.size()) {
+    auto* drawable =
+        dynamic_cast<Drawable*>(&drawableTransforms[first].first.get());
+    std::size_t end = first + 1;
+    if (drawable) {
+      while (end < drawableTransforms.size()) {
+        auto* other =
+            dynamic_cast<Drawable*>(&drawableTransforms[end].first.get());
+        if (!other || !drawable->canDrawInstancedWith(*other)) {
+          break;
+        }
+        ++end;
+      }
+    }
+
+    if (end - first > 1) {
+      previousNumDrawCalls_ += drawable->drawInstanced(
+          {drawableTransforms.data() + first, end - first}, *this);
+    } else {
+      drawableTransforms[first].first.get().draw(
+          drawableTransforms[first].second, *this);
+      ++previousNumDrawCalls_;
+    }
+    first = end;
+  }
+}
+
+std::uint64_t RenderCamera::drawSignature(MagnumDrawableGroup& drawables,
+                                          Flags flags) {
+  auto drawableTransforms = drawableTransformations(drawables);
+  // the order doesn't matter for the signature
+  filterTransforms(drawableTransforms, flags & ~Flag::SortByDrawState);
+  return signatureOf(drawableTransforms);
+}
+
+std::uint64_t RenderCamera::drawSignature(scene::SceneGraph& sceneGraph,
+                                          Flags flags) {
+  std::uint64_t signature = 0;
+  for (auto& group : sceneGraph.getDrawableGroups()) {
+    signature += drawSignature(group.second, flags);
+  }
+  return signature;
+}
+
 size_t RenderCamera::filterTransforms(DrawableTransforms& drawableTransforms,
                                       Flags flags) {
+  ESP_PROFILE_SCOPE("cull");
   if (flags & Flag::ObjectsOnly) {
     // draw just the OBJECTS
     size_t numObjects = removeNonObjects(drawableTransforms);
@@ -191,9 +427,66 @@ size_t RenderCamera::filterTransforms(DrawableTransforms& drawableTransforms,
         drawableTransforms.end());
   }
 
+  sortByDrawState(drawableTransforms, bool(flags & Flag::SortByDrawState));
+
   return drawableTransforms.size();
 }
 
+void RenderCamera::sortByDrawState(DrawableTransforms& drawableTransforms,
+                                   bool sort) {
+  std::vector<std::pair<DrawState, std::size_t>> states;
+  states.reserve(drawableTransforms.size());
+  for (std::size_t i = 0; i < drawableTransforms.size(); ++i) {
+    const auto* drawable =
+        dynamic_cast<const Drawable*>(&drawableTransforms[i].first.get());
+    states.emplace_back(drawable ? drawable->getDrawState() : DrawState{}, i);
+  }
+
+  auto countStateChanges = [&]() {
+    std::size_t numChanges = 0;
+    const DrawState* previous = nullptr;
+    for (const auto& state : states) {
+      const DrawState& current = state.first;
+      numChanges += !previous || previous->shader != current.shader;
+      numChanges += !previous || previous->material != current.material;
+      numChanges += !previous || previous->mesh != current.mesh;
+      previous = &current;
+    }
+    return numChanges;
+  };
+
+  previousNumStateChanges_ = countStateChanges();
+  previousNumStateChangesSaved_ = 0;
+  if (!sort || states.size() < 2) {
+    return;
+  }
+
+  // shader switches are the most expensive, then material (textures and
+  // uniforms), then mesh (vertex array) bindings
+  std::less<const void*> less;
+  std::stable_sort(states.begin(), states.end(),
+                   [&](const auto& a, const auto& b) {
+                     const DrawState& x = a.first;
+                     const DrawState& y = b.first;
+                     if (x.shader != y.shader)
+                       return less(x.shader, y.shader);
+                     if (x.material != y.material)
+                       return less(x.material, y.material);
+                     return less(x.mesh, y.mesh);
+                   });
+
+  const std::size_t numSortedChanges = countStateChanges();
+  previousNumStateChangesSaved_ = previousNumStateChanges_ - numSortedChanges;
+  previousNumStateChanges_ = numSortedChanges;
+
+  DrawableTransforms sorted;
+  sorted.reserve(drawableTransforms.size());
+  for (const auto& state : states) {
+    sorted.emplace_back(std::move(drawableTransforms[state.second]));
+  }
+  drawableTransforms = std::move(sorted);
+}
+
 esp::geo::Ray RenderCamera::unproject(const Mn::Vector2i& viewportPosition,
                                       bool normalized) {
   esp::geo::Ray ray;
@@ -6,8 +6,13 @@
 #define ESP_GFX_RENDERCAMERA_H_
 
 #include <Magnum/SceneGraph/Camera.h>
+#include <cstdint>
+#include <vector>
 #include "esp/core/Esp.h"
 #include "esp/geo/Geo.h"
+#include "esp/gfx/CullingBvh.h"
+#include "esp/gfx/GpuProfile.h"
+#include "esp/gfx/LightClusters.h"
 #include "esp/gfx/magnum.h"
 #include "esp/scene/SceneNode.h"
 
@@ -53,6 +58,40 @@ class RenderCamera : public MagnumCamera {
      * Clear object id, used in the sub-class CubeMapCamera
      */
     ClearObjectId = 1 << 5,
+
+    /**
+     * Sort the Drawables that remain after culling by shader, material and
+     * mesh before drawing them, so that fewer GL state changes are needed.
+     * The order of Drawables sharing the same state is kept.
+     */
+    SortByDrawState = 1 << 6,
+
+    /**
+     * Draw consecutive Drawables that share mesh, material and shader with a
+     * single instanced draw call, see @ref Drawable::drawInstanced(). Most
+     * effective together with @ref Flag::SortByDrawState.
+     */
+    UseInstancing = 1 << 7,
+
+    /**
+     * Draw only depth and object IDs with @ref
+     * Drawable::drawDepthAndObjectId(), skipping the material, light and
+     * texture setup. For render targets without a color attachment, such as
+     * the ones of depth and semantic sensors. Overrides @ref
+     * Flag::UseInstancing.
+     */
+    DepthAndObjectIdOnly = 1 << 8,
+
+    /**
+     * Draw the depth of all Drawables with @ref
+     * Drawable::drawDepthAndObjectId() and color writes disabled first, then
+     * the full pass with a less-or-equal depth test. The expensive fragment
+     * shaders then run only for the visible surface of each pixel, which pays
+     * off in scenes with a lot of overdraw. Drawables that don't write depth
+     * in the full pass still occlude in the pre-pass. Ignored with @ref
+     * Flag::DepthAndObjectIdOnly, which is the pre-pass alone.
+     */
+    DepthPrePass = 1 << 9,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -219,6 +258,51 @@ class RenderCamera : public MagnumCamera {
    */
   size_t cull(DrawableTransforms& drawableTransforms);
 
+  /**
+   * @brief Set the number of worker threads @ref cull uses to test the
+   * bounding boxes against the frustum.
+   *
+   * Only pays off with many thousands of drawables, smaller sets are culled on
+   * the calling thread regardless. Values <= 0 use the hardware concurrency.
+   * Default is 1.
+   */
+  RenderCamera& setCullingNumThreads(int numThreads) {
+    cullingNumThreads_ = numThreads;
+    return *this;
+  }
+
+  /**
+   * @brief The number of worker threads @ref cull uses.
+   */
+  int getCullingNumThreads() const { return cullingNumThreads_; }
+
+  /**
+   * @brief Cull through a bounding volume hierarchy over the drawables instead
+   * of testing every drawable.
+   *
+   * The hierarchy is built on the first @ref cull and kept while the same
+   * drawables are culled in the same order, refitting only the parts whose
+   * bounding boxes changed. Pays off for large, mostly static scenes where
+   * big parts are outside of the frustum. The result is the same as without
+   * the hierarchy. Default is disabled.
+   */
+  RenderCamera& setHierarchicalCullingEnabled(bool enabled) {
+    hierarchicalCulling_ = enabled;
+    return *this;
+  }
+
+  /**
+   * @brief Whether @ref cull uses a bounding volume hierarchy.
+   */
+  bool isHierarchicalCullingEnabled() const { return hierarchicalCulling_; }
+
+  /**
+   * @brief Lights of the current light setup assigned to clusters of the view
+   * frustum of this camera, updated by the drawables drawn with
+   * @ref PbrShader::Flag::ClusteredLighting and shared by all of them
+   */
+  LightClusters& lightClusters() { return lightClusters_; }
+
   /**
    * @brief Cull Drawables for SceneNodes which are not OBJECT type.
    *
@@ -260,12 +344,147 @@ class RenderCamera : public MagnumCamera {
     return previousNumVisibleDrawables_;
   }
 
+  /**
+   * @brief Query the number of shader, material and mesh changes between
+   * consecutive Drawables of the most recent render pass.
+   */
+  size_t getPreviousNumStateChanges() const {
+    return previousNumStateChanges_;
+  }
+
+  /**
+   * @brief Query the number of state changes saved by @ref
+   * Flag::SortByDrawState in the most recent render pass, 0 if it was not
+   * set.
+   */
+  size_t getPreviousNumStateChangesSaved() const {
+    return previousNumStateChangesSaved_;
+  }
+
+  /**
+   * @brief Query the number of draw calls issued by the most recent render
+   * pass. Lower than @ref getPreviousNumVisibleDrawables with @ref
+   * Flag::UseInstancing.
+   */
+  size_t getPreviousNumDrawCalls() const { return previousNumDrawCalls_; }
+
+  /**
+   * @brief Identifier of the render pass in progress or most recently done,
+   * unique across all cameras. 0 if the camera never drew.
+   *
+   * Drawables use it to compute per-pass state, such as the joint palette of
+   * a skinned model, once for all the drawables sharing it.
+   */
+  std::uint64_t getDrawPass() const { return drawPass_; }
+
+  /**
+   * @brief Signature of the drawables drawn by the most recent @ref draw(), 0
+   * if the camera never drew
+   *
+   * Combines the id and camera-relative transformation of every drawn
+   * drawable, independently of their order. Two passes with the same camera
+   * and the same signature drew, barring a hash collision, the same
+   * drawables at the same places.
+   */
+  std::uint64_t getPreviousDrawSignature() const {
+    return previousDrawSignature_;
+  }
+
+  /**
+   * @brief Signature @p drawables would get if drawn with @p flags now,
+   * without drawing anything
+   *
+   * Filters and culls the drawables like @ref draw() does, so comparing the
+   * result to @ref getPreviousDrawSignature() tells whether anything visible
+   * moved, appeared or disappeared since the last pass.
+   */
+  std::uint64_t drawSignature(MagnumDrawableGroup& drawables, Flags flags);
+
+  /**
+   * @brief Signature all drawable groups of @p sceneGraph would get if drawn
+   * with @p flags now, without drawing anything
+   *
+   * Sums @ref drawSignature(MagnumDrawableGroup&, Flags) over the groups, to
+   * compare to @ref getPreviousSceneDrawSignature().
+   */
+  std::uint64_t drawSignature(scene::SceneGraph& sceneGraph, Flags flags);
+
+  /**
+   * @brief Sum of the signatures of all drawable groups drawn by the most
+   * recent @ref Renderer::draw() of a whole scene graph, 0 if there was none
+   */
+  std::uint64_t getPreviousSceneDrawSignature() const {
+    return previousSceneDrawSignature_;
+  }
+
+  /**
+   * @brief Set the signature returned by
+   * @ref getPreviousSceneDrawSignature(). Called by the renderer after it
+   * drew all groups of a scene graph.
+   */
+  void setPreviousSceneDrawSignature(std::uint64_t signature) {
+    previousSceneDrawSignature_ = signature;
+  }
+
  protected:
   //! cached inverted projection matrix to save compute on repeated calls (e.g.
   //! to unproject) without moving the camera
   Mn::Matrix4 invertedProjectionMatrix;
   size_t previousNumVisibleDrawables_ = 0;
+  size_t previousNumStateChanges_ = 0;
+  size_t previousNumStateChangesSaved_ = 0;
+  size_t previousNumDrawCalls_ = 0;
+  std::uint64_t drawPass_ = 0;
+  std::uint64_t previousDrawSignature_ = 0;
+  std::uint64_t previousSceneDrawSignature_ = 0;
   bool useDrawableIds_ = false;
+  //! GPU duration of draw(), recorded if GPU timers are enabled
+  GpuProfile gpuDrawProfile_{"gpuDraw"};
+
+  //! Stable sort drawableTransforms by draw state, updates the state change
+  //! counters
+  void sortByDrawState(DrawableTransforms& drawableTransforms, bool sort);
+
+  //! Draw the depth and object ids of drawableTransforms only, returns the
+  //! number of draw calls. With depthOffset the depth is pushed back slightly,
+  //! for a pre-pass.
+  size_t drawDepthAndObjectId(DrawableTransforms& drawableTransforms,
+                              bool depthOffset = false);
+
+  //! Draw drawableTransforms, batching runs of drawables that can be drawn
+  //! instanced together, updates previousNumDrawCalls_
+  void drawInstanced(DrawableTransforms& drawableTransforms);
+
+  //! Bounding boxes of the drawables being culled in SoA layout, so that the
+  //! frustum plane tests vectorize, and the first plane culling each (-1 if
+  //! visible). Kept between frames to avoid reallocating.
+  struct CullingBuffers {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+    std::vector<std::int8_t> culledPlane;
+  } cullingBuffers_;
+  int cullingNumThreads_ = 1;
+  //! The nodes of the drawables being culled, in order
+  std::vector<scene::SceneNode*> cullingNodes_;
+
+  //! Clean the nodes of drawableTransforms into cullingNodes_ and compute
+  //! their absolute AABBs in one batch
+  void cleanAbsoluteAABBs(const DrawableTransforms& drawableTransforms);
+
+  //! Cull by testing every drawable, fills cullingBuffers_.culledPlane
+  void cullFlat(DrawableTransforms& drawableTransforms,
+                const Magnum::Frustum& frustum);
+  //! Cull through cullingBvh_, fills cullingBuffers_.culledPlane
+  void cullHierarchical(DrawableTransforms& drawableTransforms,
+                        const Magnum::Frustum& frustum);
+
+  bool hierarchicalCulling_ = false;
+  CullingBvh cullingBvh_;
+  //! The drawables cullingBvh_ was built for, in order
+  std::vector<const Magnum::SceneGraph::Drawable3D*> cullingBvhDrawables_;
+  std::vector<Magnum::Range3D> cullingBvhBoxes_;
+
+  LightClusters lightClusters_;
 
   //! index of semantic id type held in scene nodes that this camera is made to
   //! render for semantic sensors. This may be overridden by object picking
@@ -2,11 +2,13 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Utility/Algorithms.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/PixelFormat.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
@@ -16,10 +18,17 @@
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Shaders/GenericGL.h>
 
+#include <vector>
+
+#include "GpuProfile.h"
 #include "RenderTarget.h"
+#include "RgbNoiseShader.h"
+#include "esp/core/Profiler.h"
+#include "esp/sensor/NoiseModel.h"
 #include "esp/sensor/VisualSensor.h"
 
 #include "esp/gfx_batch/DepthUnprojection.h"
@@ -43,8 +52,32 @@ const Mn::GL::Framebuffer::ColorAttachment ObjectIdTextureColorAttachment =
     Mn::GL::Framebuffer::ColorAttachment{1};
 const Mn::GL::Framebuffer::ColorAttachment UnprojectedDepthBufferAttachment =
     Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment DownsampledBufferAttachment =
+    Mn::GL::Framebuffer::ColorAttachment{0};
+
+#ifndef MAGNUM_TARGET_WEBGL
+// how long a single fence wait blocks before it's retried, in nanoseconds
+constexpr GLuint64 AsyncReadWaitTimeout = 1000000;
+#endif
 
 struct RenderTarget::Impl {
+  // a level of the chain readFrameDownsampled() reads a ReadSource from
+  struct DownsampledLevel {
+    // color or object ID blit target, or the unprojected depth
+    Mn::GL::Renderbuffer buffer{Mn::NoCreate};
+    // depth blit target
+    Mn::GL::Texture2D depth{Mn::NoCreate};
+    Mn::GL::Framebuffer framebuffer{Mn::NoCreate};
+    // separate from framebuffer, so the depth texture isn't sampled while
+    // being attached
+    Mn::GL::Framebuffer unprojectionFramebuffer{Mn::NoCreate};
+  };
+  struct DownsampledChain {
+    std::vector<DownsampledLevel> levels;
+    // number of levels computed since the last draw
+    std::size_t upToDate = 0;
+  };
+
   Impl(const Mn::Vector2i& size,
        const Mn::Vector2& depthUnprojection,
        gfx_batch::DepthShader* depthShader,
@@ -59,6 +92,11 @@ struct RenderTarget::Impl {
         unprojectedDepth_{Mn::NoCreate},
         depthUnprojectionMesh_{Mn::NoCreate},
         depthUnprojectionFrameBuffer_{Mn::NoCreate},
+        reducedDepth_{Mn::NoCreate},
+        reducedDepthFrameBuffer_{Mn::NoCreate},
+        noiseSourceTexture_{Mn::NoCreate},
+        noiseSourceFramebuffer_{Mn::NoCreate},
+        noiseMesh_{Mn::NoCreate},
         flags_{flags},
         visualSensor_{visualSensor} {
     if (depthShader_) {
@@ -66,6 +104,11 @@ struct RenderTarget::Impl {
           depthShader_->flags() &
           gfx_batch::DepthShader::Flag::UnprojectExistingDepth);
     }
+    if (visualSensor_) {
+      farPlane_ = static_cast<esp::sensor::VisualSensorSpec*>(
+                      visualSensor_->specification().get())
+                      ->far;
+    }
 
     if (flags_ & Flag::RgbaAttachment) {
       colorBuffer_.setStorage(Mn::GL::RenderbufferFormat::RGBA8, size);
@@ -105,15 +148,7 @@ struct RenderTarget::Impl {
           Mn::GL::Framebuffer::BufferAttachment::Depth, unprojectedDepth_);
     }
 
-    framebuffer_.mapForDraw(
-        {{Mn::Shaders::GenericGL3D::ColorOutput,
-          (flags_ & Flag::RgbaAttachment
-               ? RgbaBufferAttachment
-               : Mn::GL::Framebuffer::DrawAttachment::None)},
-         {Mn::Shaders::GenericGL3D::ObjectIdOutput,
-          (flags_ & Flag::ObjectIdAttachment
-               ? ObjectIdTextureColorAttachment
-               : Mn::GL::Framebuffer::DrawAttachment::None)}});
+    mapForDraw();
 
     CORRADE_INTERNAL_ASSERT(
         framebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
@@ -138,6 +173,18 @@ struct RenderTarget::Impl {
     }
   }
 
+  void mapForDraw() {
+    framebuffer_.mapForDraw(
+        {{Mn::Shaders::GenericGL3D::ColorOutput,
+          (flags_ & Flag::RgbaAttachment
+               ? RgbaBufferAttachment
+               : Mn::GL::Framebuffer::DrawAttachment::None)},
+         {Mn::Shaders::GenericGL3D::ObjectIdOutput,
+          (flags_ & Flag::ObjectIdAttachment
+               ? ObjectIdTextureColorAttachment
+               : Mn::GL::Framebuffer::DrawAttachment::None)}});
+  }
+
   void initDepthUnprojector() {
     CORRADE_ASSERT(
         flags_ & Flag::DepthTextureAttachment,
@@ -179,7 +226,59 @@ struct RenderTarget::Impl {
         .draw(depthUnprojectionMesh_);
   }
 
+  static bool isReducedDepthFormat(Mn::PixelFormat format) {
+    return format == Mn::PixelFormat::R16F ||
+           format == Mn::PixelFormat::R16Unorm;
+  }
+
+  /**
+   * Unproject the depth into a 16-bit renderbuffer of @p format, converting
+   * it on the GPU, and return the framebuffer to read it from
+   */
+  Mn::GL::Framebuffer& unprojectReducedDepthGPU(Mn::PixelFormat format) {
+    CORRADE_ASSERT(
+        depthShader_,
+        "RenderTarget::Impl::unprojectReducedDepthGPU(): reading depth as"
+            << format << "requires a depth shader",
+        reducedDepthFrameBuffer_);
+    // the unprojection buffer is initialized for the mesh
+    initDepthUnprojector();
+
+    if (reducedDepth_.id() == 0 || reducedDepthFormat_ != format) {
+      reducedDepth_ = Mn::GL::Renderbuffer{};
+      reducedDepth_.setStorage(format == Mn::PixelFormat::R16F
+                                   ? Mn::GL::RenderbufferFormat::R16F
+                                   : Mn::GL::RenderbufferFormat::R16,
+                               framebufferSize());
+      reducedDepthFrameBuffer_ = Mn::GL::Framebuffer{{{}, framebufferSize()}};
+      reducedDepthFrameBuffer_
+          .attachRenderbuffer(UnprojectedDepthBufferAttachment, reducedDepth_)
+          .mapForDraw({{0, UnprojectedDepthBufferAttachment}});
+      CORRADE_INTERNAL_ASSERT(
+          reducedDepthFrameBuffer_.checkStatus(
+              Mn::GL::FramebufferTarget::Draw) ==
+          Mn::GL::Framebuffer::Status::Complete);
+      reducedDepthFormat_ = format;
+    }
+
+    // the unprojected depth is linear in the second parameter, scaling it
+    // normalizes the depth to the far plane, which the unorm storage needs
+    Mn::Vector2 unprojection = depthUnprojection_;
+    if (format == Mn::PixelFormat::R16Unorm) {
+      unprojection[1] /= farPlane_;
+    }
+
+    reducedDepthFrameBuffer_.bind();
+    (*depthShader_)
+        .bindDepthTexture(depthRenderTexture_)
+        .setDepthUnprojection(unprojection)
+        .draw(depthUnprojectionMesh_);
+    reducedDepthFrameBuffer_.mapForRead(UnprojectedDepthBufferAttachment);
+    return reducedDepthFrameBuffer_;
+  }
+
   void renderEnter() {
+    invalidateDownsampled();
     framebuffer_.clearDepth(1.0);
     if (flags_ & Flag::RgbaAttachment) {
       if (visualSensor_) {
@@ -196,20 +295,87 @@ struct RenderTarget::Impl {
     framebuffer_.bind();
   }
 
-  void renderReEnter() { framebuffer_.bind(); }
+  void renderReEnter() {
+    invalidateDownsampled();
+    framebuffer_.bind();
+  }
 
   void renderExit() {}
 
+  const sensor::VisualSensor* visualSensor() const { return visualSensor_; }
+
+  void reuse(const Mn::Vector2& depthUnprojection,
+             const sensor::VisualSensor* visualSensor) {
+    depthUnprojection_ = depthUnprojection;
+    visualSensor_ = visualSensor;
+    farPlane_ = visualSensor_ ? static_cast<esp::sensor::VisualSensorSpec*>(
+                                    visualSensor_->specification().get())
+                                    ->far
+                              : 1.0f;
+    invalidateDownsampled();
+    for (AsyncReadSlot& slot : asyncReads_) {
+#ifndef MAGNUM_TARGET_WEBGL
+      if (slot.fence) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+      }
+#endif
+      slot.id = 0;
+    }
+  }
+
+  void applyRgbaNoise(RgbNoiseShader& shader) {
+    CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
+                   "RenderTarget::Impl::applyRgbaNoise(): this render target "
+                   "was not created with rgba render buffer enabled.", );
+
+    if (noiseMesh_.id() == 0) {
+      noiseSourceTexture_ = Mn::GL::Texture2D{};
+      noiseSourceTexture_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::RGBA8, framebufferSize());
+      noiseSourceFramebuffer_ = Mn::GL::Framebuffer{{{}, framebufferSize()}};
+      noiseSourceFramebuffer_
+          .attachTexture(RgbaBufferAttachment, noiseSourceTexture_, 0)
+          .mapForDraw({{0, RgbaBufferAttachment}});
+      CORRADE_INTERNAL_ASSERT(noiseSourceFramebuffer_.checkStatus(
+                                  Mn::GL::FramebufferTarget::Draw) ==
+                              Mn::GL::Framebuffer::Status::Complete);
+
+      noiseMesh_ = Mn::GL::Mesh{};
+      noiseMesh_.setCount(3);
+    }
+
+    // copy the clean image, then draw the noisy one over the rgba buffer only
+    framebuffer_.mapForRead(RgbaBufferAttachment);
+    Mn::GL::AbstractFramebuffer::blit(
+        framebuffer_, noiseSourceFramebuffer_, framebuffer_.viewport(),
+        Mn::GL::FramebufferBlit::Color);
+
+    framebuffer_.mapForDraw(
+        {{RgbNoiseShader::ColorOutput, RgbaBufferAttachment}});
+    framebuffer_.bind();
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+    shader.bindSourceTexture(noiseSourceTexture_).draw(noiseMesh_);
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
+
+    mapForDraw();
+  }
+
   void tryDrawHbao() {
     if (!hbao_) {
       return;
     }
 
+    ScopedGpuProfile gpuProfile{gpuHbaoProfile_};
     hbao_->drawEffect(visualSensor_->getProjectionMatrix(),
                       gfx_batch::HbaoType::CacheAware, depthRenderTexture_,
                       framebuffer_);
   }
 
+  GpuProfile& gpuReadbackProfile() { return gpuReadbackProfile_; }
+
   void blitRgbaTo(Mn::GL::AbstractFramebuffer& target,
                   const Mn::Range2Di& targetRectangle) {
     CORRADE_ASSERT(
@@ -236,7 +402,10 @@ struct RenderTarget::Impl {
     CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
                    "RenderTarget::Impl::readFrameDepth(): this render target "
                    "was not created with depth texture enabled.", );
-    if (depthShader_) {
+    if (isReducedDepthFormat(view.format())) {
+      unprojectReducedDepthGPU(view.format())
+          .read(framebuffer_.viewport(), view);
+    } else if (depthShader_) {
       unprojectDepthGPU();
       depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBufferAttachment)
           .read(framebuffer_.viewport(), view);
@@ -258,10 +427,292 @@ struct RenderTarget::Impl {
         .read(framebuffer_.viewport(), view);
   }
 
+  Mn::Vector2i downsampledSize(Mn::UnsignedInt level) const {
+    return Mn::Math::max(framebufferSize() >> Mn::Int(level),
+                         Mn::Vector2i{1});
+  }
+
+  void invalidateDownsampled() {
+    for (DownsampledChain& chain : downsampled_) {
+      chain.upToDate = 0;
+    }
+  }
+
+  /**
+   * Create the levels of @p source up to @p level if not done yet, bring them
+   * up to date with the last draw and return @p level
+   */
+  DownsampledLevel& downsample(ReadSource source, Mn::UnsignedInt level) {
+    DownsampledChain& chain = downsampled_[std::size_t(source)];
+    while (chain.levels.size() < level) {
+      const Mn::Vector2i size =
+          downsampledSize(Mn::UnsignedInt(chain.levels.size() + 1));
+      DownsampledLevel next;
+      next.framebuffer = Mn::GL::Framebuffer{{{}, size}};
+      if (source == ReadSource::Depth) {
+        next.depth = Mn::GL::Texture2D{};
+        next.depth.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+            .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+            .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+            .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, size);
+        next.framebuffer.attachTexture(
+            Mn::GL::Framebuffer::BufferAttachment::Depth, next.depth, 0);
+        if (depthShader_) {
+          next.buffer = Mn::GL::Renderbuffer{};
+          next.buffer.setStorage(Mn::GL::RenderbufferFormat::R32F, size);
+          next.unprojectionFramebuffer = Mn::GL::Framebuffer{{{}, size}};
+          next.unprojectionFramebuffer
+              .attachRenderbuffer(UnprojectedDepthBufferAttachment,
+                                  next.buffer)
+              .mapForDraw({{0, UnprojectedDepthBufferAttachment}});
+        }
+      } else {
+        next.buffer = Mn::GL::Renderbuffer{};
+        next.buffer.setStorage(source == ReadSource::Rgba
+                                   ? Mn::GL::RenderbufferFormat::RGBA8
+                                   : Mn::GL::RenderbufferFormat::R32UI,
+                               size);
+        next.framebuffer
+            .attachRenderbuffer(DownsampledBufferAttachment, next.buffer)
+            .mapForDraw({{0, DownsampledBufferAttachment}});
+      }
+      CORRADE_INTERNAL_ASSERT(
+          next.framebuffer.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+          Mn::GL::Framebuffer::Status::Complete);
+      chain.levels.push_back(std::move(next));
+    }
+
+    for (; chain.upToDate < level; ++chain.upToDate) {
+      Mn::GL::Framebuffer& from =
+          chain.upToDate == 0 ? framebuffer_
+                              : chain.levels[chain.upToDate - 1].framebuffer;
+      Mn::GL::Framebuffer& to = chain.levels[chain.upToDate].framebuffer;
+      if (source == ReadSource::Depth) {
+        Mn::GL::AbstractFramebuffer::blit(
+            from, to, from.viewport(), to.viewport(),
+            Mn::GL::FramebufferBlit::Depth,
+            Mn::GL::FramebufferBlitFilter::Nearest);
+        continue;
+      }
+      from.mapForRead(chain.upToDate == 0 && source == ReadSource::ObjectId
+                          ? ObjectIdTextureColorAttachment
+                          : DownsampledBufferAttachment);
+      Mn::GL::AbstractFramebuffer::blit(
+          from, to, from.viewport(), to.viewport(),
+          Mn::GL::FramebufferBlit::Color,
+          source == ReadSource::Rgba ? Mn::GL::FramebufferBlitFilter::Linear
+                                     : Mn::GL::FramebufferBlitFilter::Nearest);
+    }
+    return chain.levels[level - 1];
+  }
+
+  void readFrameDownsampled(ReadSource source,
+                            Mn::UnsignedInt level,
+                            const Mn::MutableImageView2D& view) {
+    if (level == 0) {
+      switch (source) {
+        case ReadSource::Rgba:
+          readFrameRgba(view);
+          return;
+        case ReadSource::Depth:
+          readFrameDepth(view);
+          return;
+        case ReadSource::ObjectId:
+          readFrameObjectId(view);
+          return;
+      }
+    }
+    CORRADE_ASSERT(view.size() == downsampledSize(level),
+                   "RenderTarget::Impl::readFrameDownsampled(): expected a "
+                   "view of size"
+                       << downsampledSize(level) << "for level" << level
+                       << "but got" << view.size(), );
+    const Mn::Range2Di rectangle{{}, view.size()};
+    switch (source) {
+      case ReadSource::Rgba:
+        CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
+                       "RenderTarget::Impl::readFrameDownsampled(): this "
+                       "render target was not created with rgba render "
+                       "buffer enabled.", );
+        break;
+      case ReadSource::Depth:
+        CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
+                       "RenderTarget::Impl::readFrameDownsampled(): this "
+                       "render target was not created with depth texture "
+                       "enabled.", );
+        break;
+      case ReadSource::ObjectId:
+        CORRADE_ASSERT(flags_ & Flag::ObjectIdAttachment,
+                       "RenderTarget::Impl::readFrameDownsampled(): this "
+                       "render target was not created with objectId render "
+                       "texture enabled.", );
+        break;
+    }
+    DownsampledLevel& downsampled = downsample(source, level);
+
+    if (source != ReadSource::Depth) {
+      downsampled.framebuffer.mapForRead(DownsampledBufferAttachment)
+          .read(rectangle, view);
+    } else if (depthShader_) {
+      // only the mesh is needed from the full-size unprojection
+      initDepthUnprojector();
+      downsampled.unprojectionFramebuffer.bind();
+      (*depthShader_)
+          .bindDepthTexture(downsampled.depth)
+          .setDepthUnprojection(depthUnprojection_)
+          .draw(depthUnprojectionMesh_);
+      downsampled.unprojectionFramebuffer
+          .mapForRead(UnprojectedDepthBufferAttachment)
+          .read(rectangle, view);
+    } else {
+      Mn::MutableImageView2D depthBufferView{
+          Mn::GL::PixelFormat::DepthComponent, Mn::GL::PixelType::Float,
+          view.size(), view.data()};
+      downsampled.framebuffer.read(rectangle, depthBufferView);
+      gfx_batch::unprojectDepth(depthUnprojection_, view.pixels<Mn::Float>());
+    }
+  }
+
+  AsyncRead readFrameAsync(ReadSource source, Mn::PixelFormat format) {
+    AsyncReadSlot& slot = asyncReads_[nextAsyncReadId_ % AsyncReadBufferCount];
+    const AsyncRead read{source, nextAsyncReadId_++};
+    slot.id = read.id;
+    slot.format = format;
+    slot.unprojectDepth = false;
+
+    Mn::GL::AbstractFramebuffer* readFramebuffer = &framebuffer_;
+    switch (source) {
+      case ReadSource::Rgba:
+        CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
+                       "RenderTarget::Impl::readFrameAsync(): this render "
+                       "target was not created with rgba render buffer "
+                       "enabled.",
+                       {});
+        framebuffer_.mapForRead(RgbaBufferAttachment);
+        break;
+      case ReadSource::Depth:
+        CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
+                       "RenderTarget::Impl::readFrameAsync(): this render "
+                       "target was not created with depth texture enabled.",
+                       {});
+        if (isReducedDepthFormat(format)) {
+          readFramebuffer = &unprojectReducedDepthGPU(format);
+        } else if (depthShader_) {
+          unprojectDepthGPU();
+          depthUnprojectionFrameBuffer_.mapForRead(
+              UnprojectedDepthBufferAttachment);
+          readFramebuffer = &depthUnprojectionFrameBuffer_;
+        } else {
+          slot.unprojectDepth = true;
+        }
+        break;
+      case ReadSource::ObjectId:
+        CORRADE_ASSERT(flags_ & Flag::ObjectIdAttachment,
+                       "RenderTarget::Impl::readFrameAsync(): this render "
+                       "target was not created with objectId render texture "
+                       "enabled.",
+                       {});
+        framebuffer_.mapForRead(ObjectIdTextureColorAttachment);
+        break;
+    }
+
+#ifndef MAGNUM_TARGET_WEBGL
+    if (slot.fence) {
+      glDeleteSync(slot.fence);
+    }
+    // the depth buffer is read as is and unprojected on the CPU once mapped
+    const Mn::GL::PixelFormat glFormat =
+        slot.unprojectDepth ? Mn::GL::PixelFormat::DepthComponent
+                            : Mn::GL::pixelFormat(format);
+    const Mn::GL::PixelType glType = slot.unprojectDepth
+                                         ? Mn::GL::PixelType::Float
+                                         : Mn::GL::pixelType(format);
+    if (!slot.image.buffer().id() || slot.image.format() != glFormat ||
+        slot.image.type() != glType) {
+      slot.image = Mn::GL::BufferImage2D{glFormat, glType};
+    }
+    readFramebuffer->read(framebuffer_.viewport(), slot.image,
+                          Mn::GL::BufferUsage::StreamRead);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+    const std::size_t dataSize =
+        framebufferSize().product() * Mn::pixelFormatSize(format);
+    slot.image = Mn::Image2D{format, framebufferSize(),
+                             Cr::Containers::Array<char>{Cr::NoInit, dataSize}};
+    if (slot.unprojectDepth) {
+      readFramebuffer->read(
+          framebuffer_.viewport(),
+          Mn::MutableImageView2D{Mn::GL::PixelFormat::DepthComponent,
+                                 Mn::GL::PixelType::Float, slot.image.size(),
+                                 slot.image.data()});
+    } else {
+      readFramebuffer->read(framebuffer_.viewport(), slot.image);
+    }
+#endif
+    return read;
+  }
+
+  AsyncReadSlot& asyncReadSlot(const AsyncRead& read) {
+    AsyncReadSlot& slot = asyncReads_[read.id % AsyncReadBufferCount];
+    CORRADE_ASSERT(read.id && slot.id == read.id,
+                   "RenderTarget::Impl::asyncReadSlot(): the read was "
+                   "already finished or its buffer was reused",
+                   slot);
+    return slot;
+  }
+
+  bool isAsyncReadReady(const AsyncRead& read) {
+#ifndef MAGNUM_TARGET_WEBGL
+    const GLenum status = glClientWaitSync(asyncReadSlot(read).fence,
+                                           GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+#else
+    asyncReadSlot(read);
+    return true;
+#endif
+  }
+
+  void finishReadFrameAsync(const AsyncRead& read,
+                            const Mn::MutableImageView2D& view) {
+    AsyncReadSlot& slot = asyncReadSlot(read);
+    CORRADE_ASSERT(view.format() == slot.format &&
+                       view.size() == framebufferSize(),
+                   "RenderTarget::Impl::finishReadFrameAsync(): expected a "
+                   "view of"
+                       << slot.format << "and size" << framebufferSize()
+                       << "but got" << view.format() << "and"
+                       << view.size(), );
+
+#ifndef MAGNUM_TARGET_WEBGL
+    // block until the GPU has written the pixel buffer
+    while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                            AsyncReadWaitTimeout) == GL_TIMEOUT_EXPIRED) {
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    Cr::Containers::ArrayView<const char> data = slot.image.buffer().map(
+        0, slot.image.dataSize(), Mn::GL::Buffer::MapFlag::Read);
+    Cr::Utility::copy(Mn::ImageView2D{slot.image.storage(), slot.format,
+                                      slot.image.size(), data}
+                          .pixels(),
+                      view.pixels());
+    slot.image.buffer().unmap();
+#else
+    Cr::Utility::copy(slot.image.pixels(), view.pixels());
+#endif
+    if (slot.unprojectDepth) {
+      gfx_batch::unprojectDepth(depthUnprojection_, view.pixels<Mn::Float>());
+    }
+    slot.id = 0;
+  }
+
   Mn::Vector2i framebufferSize() const {
     return framebuffer_.viewport().size();
   }
 
+  Flags flags() const { return flags_; }
+
   Magnum::GL::Texture2D& getDepthTexture() {
     CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
                    "RenderTarget::Impl::getDepthTexture(): this render target "
@@ -357,18 +808,22 @@ struct RenderTarget::Impl {
   }
 #endif
 
-#ifdef ESP_BUILD_WITH_CUDA
   ~Impl() {
+#ifndef MAGNUM_TARGET_WEBGL
+    for (AsyncReadSlot& slot : asyncReads_) {
+      if (slot.fence)
+        glDeleteSync(slot.fence);
+    }
+#endif
+#ifdef ESP_BUILD_WITH_CUDA
     if (colorBufferCugl_ != nullptr)
       checkCudaErrors(cudaGraphicsUnregisterResource(colorBufferCugl_));
     if (depthBufferCugl_ != nullptr)
       checkCudaErrors(cudaGraphicsUnregisterResource(depthBufferCugl_));
     if (objecIdBufferCugl_ != nullptr)
       checkCudaErrors(cudaGraphicsUnregisterResource(objecIdBufferCugl_));
-  }
-#else
-  ~Impl() = default;
 #endif
+  }
 
  private:
   Mn::GL::Renderbuffer colorBuffer_;
@@ -382,6 +837,26 @@ struct RenderTarget::Impl {
   Mn::GL::Mesh depthUnprojectionMesh_;
   Mn::GL::Framebuffer depthUnprojectionFrameBuffer_;
 
+  // depth converted to 16 bits before readback, see readFrameDepth()
+  Mn::GL::Renderbuffer reducedDepth_;
+  Mn::GL::Framebuffer reducedDepthFrameBuffer_;
+  Mn::PixelFormat reducedDepthFormat_ = Mn::PixelFormat::R16F;
+  // depth of the far plane, mapped to 1 by R16Unorm depth reads
+  float farPlane_ = 1.0f;
+
+  // copy of the rgba buffer the noise of a sensor::NoiseModel is applied to
+  Mn::GL::Texture2D noiseSourceTexture_;
+  Mn::GL::Framebuffer noiseSourceFramebuffer_;
+  Mn::GL::Mesh noiseMesh_;
+
+  // indexed by ReadSource
+  DownsampledChain downsampled_[3];
+
+  // GPU durations of tryDrawHbao() and the readFrame*() calls, recorded if
+  // GPU timers are enabled
+  GpuProfile gpuHbaoProfile_{"gpuHbao"};
+  GpuProfile gpuReadbackProfile_{"gpuReadback"};
+
   Flags flags_;
 
   const sensor::VisualSensor* visualSensor_ = nullptr;
@@ -393,6 +868,24 @@ struct RenderTarget::Impl {
 #endif
 
   Cr::Containers::Optional<gfx_batch::Hbao> hbao_{};
+
+  struct AsyncReadSlot {
+#ifndef MAGNUM_TARGET_WEBGL
+    Mn::GL::BufferImage2D image{Mn::NoCreate};
+    GLsync fence = nullptr;
+#else
+    Mn::Image2D image{Mn::PixelFormat::RGBA8Unorm};
+#endif
+    //! pixel format the read was started with
+    Mn::PixelFormat format = Mn::PixelFormat::RGBA8Unorm;
+    //! id of the read currently using the slot, 0 if none
+    std::uint64_t id = 0;
+    //! whether the raw depth buffer was read and has to be unprojected
+    bool unprojectDepth = false;
+  };
+  AsyncReadSlot asyncReads_[AsyncReadBufferCount];
+  // 0 is reserved for invalid handles
+  std::uint64_t nextAsyncReadId_ = 1;
 };  // namespace gfx
 
 RenderTarget::RenderTarget(const Mn::Vector2i& size,
@@ -406,6 +899,11 @@ RenderTarget::RenderTarget(const Mn::Vector2i& size,
                                             flags,
                                             visualSensor)) {}
 
+void RenderTarget::reuse(const Mn::Vector2& depthUnprojection,
+                         const sensor::VisualSensor* visualSensor) {
+  pimpl_->reuse(depthUnprojection, visualSensor);
+}
+
 void RenderTarget::renderEnter() {
   pimpl_->renderEnter();
 }
@@ -416,20 +914,62 @@ void RenderTarget::renderReEnter() {
 
 void RenderTarget::renderExit() {
   pimpl_->renderExit();
+  const sensor::VisualSensor* visualSensor = pimpl_->visualSensor();
+  if (visualSensor && (pimpl_->flags() & Flag::RgbaAttachment)) {
+    const sensor::NoiseModel::ptr& noiseModel =
+        static_cast<const sensor::VisualSensorSpec*>(
+            visualSensor->specification().get())
+            ->renderTargetNoiseModel;
+    if (noiseModel) {
+      noiseModel->apply(*this);
+    }
+  }
 }
 
 void RenderTarget::readFrameRgba(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("readback");
+  ScopedGpuProfile gpuProfile{pimpl_->gpuReadbackProfile()};
   pimpl_->readFrameRgba(view);
 }
 
 void RenderTarget::readFrameDepth(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("readback");
+  ScopedGpuProfile gpuProfile{pimpl_->gpuReadbackProfile()};
   pimpl_->readFrameDepth(view);
 }
 
 void RenderTarget::readFrameObjectId(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("readback");
+  ScopedGpuProfile gpuProfile{pimpl_->gpuReadbackProfile()};
   pimpl_->readFrameObjectId(view);
 }
 
+RenderTarget::AsyncRead RenderTarget::readFrameAsync(ReadSource source,
+                                                     Mn::PixelFormat format) {
+  return pimpl_->readFrameAsync(source, format);
+}
+
+bool RenderTarget::isAsyncReadReady(const AsyncRead& read) {
+  return pimpl_->isAsyncReadReady(read);
+}
+
+void RenderTarget::finishReadFrameAsync(const AsyncRead& read,
+                                        const Mn::MutableImageView2D& view) {
+  pimpl_->finishReadFrameAsync(read, view);
+}
+
+Mn::Vector2i RenderTarget::downsampledSize(Mn::UnsignedInt level) const {
+  return pimpl_->downsampledSize(level);
+}
+
+void RenderTarget::readFrameDownsampled(ReadSource source,
+                                        Mn::UnsignedInt level,
+                                        const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("readback");
+  ScopedGpuProfile gpuProfile{pimpl_->gpuReadbackProfile()};
+  pimpl_->readFrameDownsampled(source, level, view);
+}
+
 void RenderTarget::blitRgbaTo(Mn::GL::AbstractFramebuffer& target,
                               const Mn::Range2Di& targetRectangle) {
   pimpl_->blitRgbaTo(target, targetRectangle);
@@ -444,6 +984,10 @@ Mn::Vector2i RenderTarget::framebufferSize() const {
   return pimpl_->framebufferSize();
 }
 
+RenderTarget::Flags RenderTarget::flags() const {
+  return pimpl_->flags();
+}
+
 Mn::GL::Texture2D& RenderTarget::getDepthTexture() {
   return pimpl_->getDepthTexture();
 }
@@ -456,6 +1000,10 @@ void RenderTarget::tryDrawHbao() {
   return pimpl_->tryDrawHbao();
 }
 
+void RenderTarget::applyRgbaNoise(RgbNoiseShader& shader) {
+  pimpl_->applyRgbaNoise(shader);
+}
+
 #ifdef ESP_BUILD_WITH_CUDA
 void RenderTarget::readFrameRgbaGPU(uint8_t* devPtr) {
   pimpl_->readFrameRgbaGPU(devPtr);
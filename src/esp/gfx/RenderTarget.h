@@ -7,6 +7,8 @@
 
 #include <Corrade/Containers/EnumSet.h>
 #include <Magnum/Magnum.h>
+#include <cstddef>
+#include <cstdint>
 
 #include "esp/core/Esp.h"
 
@@ -23,6 +25,8 @@ class DepthShader;
 
 namespace gfx {
 
+class RgbNoiseShader;
+
 /**
  * Holds a framebuffer and encapsulates the logic of retrieving rendering
  * results of various types (RGB, Depth, ObjectID) from the framebuffer.
@@ -62,6 +66,27 @@ class RenderTarget {
   typedef Corrade::Containers::EnumSet<Flag> Flags;
   CORRADE_ENUMSET_FRIEND_OPERATORS(Flags)
 
+  /**
+   * @brief Rendering result fetched by @ref readFrameAsync()
+   */
+  enum class ReadSource : Magnum::UnsignedByte { Rgba, Depth, ObjectId };
+
+  /**
+   * @brief Number of pixel buffers the reads started by @ref readFrameAsync()
+   * cycle through, and thus the number of reads that can be in flight at once
+   */
+  static constexpr std::size_t AsyncReadBufferCount = 3;
+
+  /**
+   * @brief Handle of a read started by @ref readFrameAsync()
+   */
+  struct AsyncRead {
+    //! The rendering result being read
+    ReadSource source = ReadSource::Rgba;
+    //! Sequence number of the read within the render target, 0 if invalid
+    std::uint64_t id = 0;
+  };
+
   /**
    * @brief Constructor
    * @param size               The size of the underlying framebuffers in WxH
@@ -100,6 +125,20 @@ class RenderTarget {
 
   ~RenderTarget() = default;
 
+  /**
+   * @brief Retarget to another sensor, keeping the GPU allocations
+   * @param depthUnprojection  Depth unprojection parameters of the sensor.
+   *                           See @ref calculateDepthUnprojection()
+   * @param visualSensor       (optional) The visual sensor for this render
+   * target
+   *
+   * Used to reuse the render target for a sensor of the same size and flags
+   * instead of creating a new one. Downsampled results are invalidated and
+   * asynchronous reads that were not finished yet can't be finished anymore.
+   */
+  void reuse(const Magnum::Vector2& depthUnprojection,
+             const sensor::VisualSensor* visualSensor = nullptr);
+
   /**
    * @brief Called before any draw calls that target this RenderTarget
    * Clears the framebuffer to the color specified by the VisualSensorSpec and
@@ -123,6 +162,11 @@ class RenderTarget {
    */
   Magnum::Vector2i framebufferSize() const;
 
+  /**
+   * @brief The flags the render target was created with
+   */
+  Flags flags() const;
+
   /**
    * @brief Retrieve the RGBA rendering results.
    *
@@ -136,7 +180,10 @@ class RenderTarget {
    *
    * @param[in, out] view Preallocated memory that will be populated with the
    * result.  The PixelFormat of the image must only specify the R channel,
-   * generally @ref Magnum::PixelFormat::R32F
+   * generally @ref Magnum::PixelFormat::R32F. With a DepthShader, the depth
+   * can also be converted to @ref Magnum::PixelFormat::R16F or to
+   * @ref Magnum::PixelFormat::R16Unorm on the GPU before it's read, the
+   * latter being 1 at the far plane of the visual sensor.
    */
   void readFrameDepth(const Magnum::MutableImageView2D& view);
 
@@ -152,6 +199,66 @@ class RenderTarget {
    */
   void readFrameObjectId(const Magnum::MutableImageView2D& view);
 
+  /**
+   * @brief Start reading rendering results without waiting for the GPU
+   *
+   * @param source  The rendering result to read
+   * @param format  The pixel format the result will be read as, with the same
+   * restrictions as for @ref readFrameRgba(), @ref readFrameDepth() or @ref
+   * readFrameObjectId()
+   * @return A handle to pass to @ref finishReadFrameAsync()
+   *
+   * The result is copied into one of @ref AsyncReadBufferCount pixel buffers
+   * owned by the render target and a fence is placed after the copy, so the
+   * caller can go on submitting the next frame while the GPU finishes this
+   * one. Starting more than @ref AsyncReadBufferCount reads without finishing
+   * them invalidates the oldest ones. On WebGL, which can't map buffers, the
+   * pixels are read synchronously here instead.
+   */
+  AsyncRead readFrameAsync(ReadSource source, Magnum::PixelFormat format);
+
+  /**
+   * @brief Whether the GPU is done with the read started by @p read, i.e.
+   * whether @ref finishReadFrameAsync() would not block
+   */
+  bool isAsyncReadReady(const AsyncRead& read);
+
+  /**
+   * @brief Wait on the fence of the read started by @p read and copy its result
+   * into @p view
+   *
+   * @param read A handle returned by @ref readFrameAsync() that was not
+   * finished or invalidated yet
+   * @param[in, out] view Preallocated memory that will be populated with the
+   * result. Must have the size of the framebuffer and the pixel format passed
+   * to @ref readFrameAsync().
+   */
+  void finishReadFrameAsync(const AsyncRead& read,
+                            const Magnum::MutableImageView2D& view);
+
+  /**
+   * @brief Size of the rendering result downsampled @p level times, halving
+   * each dimension every time down to at least one pixel
+   */
+  Magnum::Vector2i downsampledSize(Magnum::UnsignedInt level) const;
+
+  /**
+   * @brief Read the rendering result of @p source downsampled @p level times
+   * on the GPU into @p view of @ref downsampledSize()
+   *
+   * Each level is a blit of the previous one, with linear filtering for color,
+   * which averages 2x2 pixel blocks, and nearest filtering for depth and
+   * object IDs, as averaging those would produce values present nowhere in
+   * the scene. The levels are computed by the first read after a draw and
+   * reused by the following reads. Level 0 reads the same as @ref
+   * readFrameRgba(), @ref readFrameDepth() or @ref readFrameObjectId(), higher
+   * levels need @p view to be RGBA8, 32-bit float depth or 32-bit unsigned
+   * object IDs.
+   */
+  void readFrameDownsampled(ReadSource source,
+                            Magnum::UnsignedInt level,
+                            const Magnum::MutableImageView2D& view);
+
   /**
    * @brief Blits the rgba buffer from internal FBO to given framebuffer
    * rectangle
@@ -180,6 +287,16 @@ class RenderTarget {
    */
   void tryDrawHbao();
 
+  /**
+   * @brief Replace the rgba buffer by the output of @p shader drawn with a
+   * copy of it bound as the source texture
+   *
+   * Used to add noise to the rendering before it is read, so every read path,
+   * including @ref readFrameRgbaGPU(), gets the noisy image. The shader's
+   * uniforms other than the source texture need to be set by the caller.
+   */
+  void applyRgbaNoise(RgbNoiseShader& shader);
+
   // @brief Delete copy Constructor
   RenderTarget(const RenderTarget&) = delete;
   // @brief Delete copy operator
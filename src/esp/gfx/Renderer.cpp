@@ -4,6 +4,8 @@
 
 #include "Renderer.h"
 
+#include <algorithm>
+
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/BufferImage.h>
@@ -45,6 +47,14 @@ namespace Mn = Magnum;
 namespace esp {
 namespace gfx {
 
+namespace {
+
+// render targets released by rebinding sensors that are kept for reuse, the
+// least recently released are freed first
+constexpr std::size_t MaxPooledRenderTargets = 8;
+
+}  // namespace
+
 void Renderer::setupMagnumFeatures() {
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
@@ -71,17 +81,33 @@ struct Renderer::Impl {
     ESP_DEBUG() << "Deconstructing Renderer";
   }
 
+  // the camera flags with the renderer-wide ones added
+  RenderCamera::Flags cameraFlags(RenderCamera::Flags flags) const {
+    if ((flags_ & Flag::DepthPrePass) &&
+        !(flags & RenderCamera::Flag::DepthAndObjectIdOnly)) {
+      flags |= RenderCamera::Flag::DepthPrePass;
+    }
+    return flags;
+  }
+
+  Flags flags() const { return flags_; }
+
   void draw(RenderCamera& camera,
             scene::SceneGraph& sceneGraph,
             RenderCamera::Flags flags) {
     acquireGlContext();
+    flags = cameraFlags(flags);
+    // the signatures of all groups make up the one of the scene graph
+    std::uint64_t signature = 0;
     for (auto& it : sceneGraph.getDrawableGroups()) {
       // TODO: remove || true and NOLINT below
       // NOLINTNEXTLINE (readability-simplify-boolean-expr)
       if (it.second.prepareForDraw(camera) || true) {
         camera.draw(it.second, flags);
+        signature += camera.getPreviousDrawSignature();
       }
     }
+    camera.setPreviousSceneDrawSignature(signature);
   }
 
   void draw(sensor::VisualSensor& visualSensor, sim::Simulator& sim) {
@@ -269,13 +295,20 @@ struct Renderer::Impl {
               "thread, cannot do async drawing");
   }
 
-  void enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
-                           scene::SceneGraph& sceneGraph,
-                           const Mn::MutableImageView2D& view,
-                           RenderCamera::Flags flags) {
+  int enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
+                          scene::SceneGraph& sceneGraph,
+                          scene::SceneGraph* sharedSceneGraph,
+                          const Mn::MutableImageView2D& view,
+                          RenderCamera::Flags flags) {
     checkHasBackgroundRenderer();
 
-    backgroundRenderer_->submitRenderJob(visualSensor, sceneGraph, view, flags);
+    return backgroundRenderer_->submitRenderJob(
+        visualSensor, sceneGraph, sharedSceneGraph, view, cameraFlags(flags));
+  }
+
+  void snapshotDrawJobs() {
+    checkHasBackgroundRenderer();
+    backgroundRenderer_->snapshotRenderJobs();
   }
 
   void startDrawJobs() {
@@ -295,6 +328,15 @@ struct Renderer::Impl {
       acquireGlContext();
   }
 
+  bool isDrawJobDone(int job) const {
+    return !backgroundRenderer_ || backgroundRenderer_->isRenderJobDone(job);
+  }
+
+  void waitDrawJob(int job) {
+    checkHasBackgroundRenderer();
+    backgroundRenderer_->waitRenderJob(job);
+  }
+
   void waitSceneGraph() {
     if (backgroundRenderer_)
       backgroundRenderer_->waitSceneGraph();
@@ -371,9 +413,58 @@ struct Renderer::Impl {
         break;
     }
 
-    sensor.bindRenderTarget(RenderTarget::create_unique(
-        sensor.framebufferSize(), *depthUnprojection, depthShader_.get(),
-        renderTargetFlags, &sensor));
+    if (bindingFlags & Flag::AllAttachments) {
+      renderTargetFlags |= RenderTarget::Flag::RgbaAttachment |
+                           RenderTarget::Flag::DepthTextureAttachment |
+                           RenderTarget::Flag::ObjectIdAttachment;
+    }
+
+    // Reuse the GPU allocations of a render target of the same size and
+    // flags if there is one, either the sensor's own or one released by an
+    // earlier rebinding
+    const Mn::Vector2i size = sensor.framebufferSize();
+    const auto matches = [&](const RenderTarget::uptr& target) {
+      return target->framebufferSize() == size &&
+             target->flags() == renderTargetFlags;
+    };
+    RenderTarget::uptr target;
+    if (sensor.hasRenderTarget()) {
+      RenderTarget::uptr previous = sensor.releaseRenderTarget();
+      if (matches(previous)) {
+        target = std::move(previous);
+      } else {
+        if (renderTargetPool_.size() == MaxPooledRenderTargets) {
+          renderTargetPool_.erase(renderTargetPool_.begin());
+        }
+        renderTargetPool_.push_back(std::move(previous));
+      }
+    }
+    if (!target) {
+      auto found = std::find_if(renderTargetPool_.begin(),
+                                renderTargetPool_.end(), matches);
+      if (found != renderTargetPool_.end()) {
+        target = std::move(*found);
+        renderTargetPool_.erase(found);
+      }
+    }
+
+    if (target) {
+      target->reuse(*depthUnprojection, &sensor);
+    } else {
+      target = RenderTarget::create_unique(size, *depthUnprojection,
+                                           depthShader_.get(),
+                                           renderTargetFlags, &sensor);
+    }
+    sensor.bindRenderTarget(std::move(target));
+  }
+
+  std::size_t pooledRenderTargetCount() const {
+    return renderTargetPool_.size();
+  }
+
+  void clearRenderTargetPool() {
+    acquireGlContext();
+    renderTargetPool_.clear();
   }
 
  private:
@@ -381,6 +472,7 @@ struct Renderer::Impl {
   bool contextIsOwned_ = true;
   // TODO: shall we use shader resource manager from now?
   std::unique_ptr<gfx_batch::DepthShader> depthShader_;
+  std::vector<RenderTarget::uptr> renderTargetPool_;
   const Flags flags_;
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
   std::unique_ptr<BackgroundRenderer> backgroundRenderer_ = nullptr;
@@ -462,13 +554,19 @@ Renderer::Renderer(Flags flags) : Renderer{nullptr, flags} {}
 Renderer::Renderer(WindowlessContext* context, Flags flags)
     : pimpl_(spimpl::make_unique_impl<Impl>(context, flags)) {}
 
+Renderer::Flags Renderer::flags() const {
+  return pimpl_->flags();
+}
+
 void Renderer::draw(RenderCamera& camera,
                     scene::SceneGraph& sceneGraph,
                     RenderCamera::Flags flags) {
+  ESP_TRACE_SCOPE("draw");
   pimpl_->draw(camera, sceneGraph, flags);
 }
 
 void Renderer::draw(sensor::VisualSensor& visualSensor, sim::Simulator& sim) {
+  ESP_TRACE_SCOPE("drawSensor");
   pimpl_->draw(visualSensor, sim);
 }
 
@@ -477,18 +575,48 @@ void Renderer::bindRenderTarget(sensor::VisualSensor& sensor,
   pimpl_->bindRenderTarget(sensor, bindingFlags);
 }
 
+std::size_t Renderer::pooledRenderTargetCount() const {
+  return pimpl_->pooledRenderTargetCount();
+}
+
+void Renderer::clearRenderTargetPool() {
+  pimpl_->clearRenderTargetPool();
+}
+
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
-void Renderer::enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
-                                   scene::SceneGraph& sceneGraph,
-                                   const Mn::MutableImageView2D& view,
-                                   RenderCamera::Flags flags) {
-  pimpl_->enqueueAsyncDrawJob(visualSensor, sceneGraph, view, flags);
+int Renderer::enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
+                                  scene::SceneGraph& sceneGraph,
+                                  const Mn::MutableImageView2D& view,
+                                  RenderCamera::Flags flags) {
+  return pimpl_->enqueueAsyncDrawJob(visualSensor, sceneGraph, nullptr, view,
+                                     flags);
+}
+
+int Renderer::enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
+                                  scene::SceneGraph& sceneGraph,
+                                  scene::SceneGraph& sharedSceneGraph,
+                                  const Mn::MutableImageView2D& view,
+                                  RenderCamera::Flags flags) {
+  return pimpl_->enqueueAsyncDrawJob(visualSensor, sceneGraph,
+                                     &sharedSceneGraph, view, flags);
 }
 
 void Renderer::waitDrawJobs() {
   pimpl_->waitDrawJobs();
 }
 
+bool Renderer::isDrawJobDone(int job) const {
+  return pimpl_->isDrawJobDone(job);
+}
+
+void Renderer::waitDrawJob(int job) {
+  pimpl_->waitDrawJob(job);
+}
+
+void Renderer::snapshotDrawJobs() {
+  pimpl_->snapshotDrawJobs();
+}
+
 void Renderer::startDrawJobs() {
   pimpl_->startDrawJobs();
 }
@@ -57,6 +57,29 @@ class Renderer {
      */
     HorizonBasedAmbientOcclusion = 1 << 4,
 
+    /**
+     * When binding the render target to a sensor, setting this flag gives the
+     * render target color, depth texture and object id attachments regardless
+     * of the sensor type, so that co-located sensors drawn in a single pass
+     * can all read their observations from it.
+     * see bindRenderTarget for more info.
+     */
+    AllAttachments = 1 << 5,
+
+    /**
+     * Draw scenes with @ref RenderCamera::Flag::DepthPrePass, so the full
+     * shaders run only once per pixel in scenes with a lot of overdraw. Depth
+     * and semantic sensors are unaffected, they already draw nothing but the
+     * pre-pass.
+     */
+    DepthPrePass = 1 << 6,
+
+    /**
+     * Let camera sensors skip drawing an observation when their camera, the
+     * light setups and the drawables they'd draw didn't change since their
+     * last draw, see @ref sensor::VisualSensor::isObservationUnchanged.
+     */
+    SkipUnchangedFrames = 1 << 7,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -74,11 +97,21 @@ class Renderer {
    */
   explicit Renderer(WindowlessContext* context, Flags flags = {});
 
+  /**
+   * @brief Flags the renderer was created with
+   */
+  Flags flags() const;
+
   /*
    * @brief draw the scene graph with the camera specified by user
    * @param[in] camera the render camera to render the scene
    * @param[in] sceneGraph the scene to render
    * @param[in] flags flags to control the rendering
+   *
+   * Each drawable group of @p sceneGraph is drawn in a separate pass. With
+   * @ref RenderCamera::Flag::SortByDrawState the drawables of each group are
+   * ordered by shader, material and mesh, see @ref
+   * RenderCamera::getPreviousNumStateChangesSaved.
    */
   void draw(RenderCamera& camera,
             scene::SceneGraph& sceneGraph,
@@ -111,26 +144,81 @@ class Renderer {
    *
    * Jobs are started by a call to @ref startDrawJobs.  Note that after calling
    * @ref startDrawJobs, you must call @ref waitSceneGraph before doing anything
-   * that changes the scene graph.
+   * that changes the scene graph, unless the jobs were captured with @ref
+   * snapshotDrawJobs.
+   *
+   * All jobs enqueued for a frame, of any number of sensors and agents, are
+   * drawn as one batch and read back in the order they were enqueued.
+   * @return The index of the job in its frame, to wait for it alone with @ref
+   * waitDrawJob
+   */
+  int enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
+                          scene::SceneGraph& sceneGraph,
+                          const Mn::MutableImageView2D& view,
+                          RenderCamera::Flags flags = {
+                              RenderCamera::Flag::FrustumCulling});
+
+  /**
+   * @brief Enqueue a async draw job of two scene graphs
+   *
+   * Same as above, except that the drawables of @p sharedSceneGraph are drawn
+   * with the sensor as well, after the ones of @p sceneGraph. Meant for static
+   * content such as a stage shared by several scene graphs that are otherwise
+   * drawn separately.
    */
-  void enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
-                           scene::SceneGraph& sceneGraph,
-                           const Mn::MutableImageView2D& view,
-                           RenderCamera::Flags flags = {
-                               RenderCamera::Flag::FrustumCulling});
+  int enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
+                          scene::SceneGraph& sceneGraph,
+                          scene::SceneGraph& sharedSceneGraph,
+                          const Mn::MutableImageView2D& view,
+                          RenderCamera::Flags flags = {
+                              RenderCamera::Flag::FrustumCulling});
+
+  /**
+   * @brief Captures the scene state the draw jobs enqueued by @ref
+   * enqueueAsyncDrawJob need on the calling thread.
+   *
+   * The drawable transformations after culling and the camera poses and
+   * projections are copied into one of two snapshot buffers, so that the next
+   * @ref startDrawJobs doesn't take ownership of the scene graphs and they can
+   * be modified (e.g. by stepping physics) while the snapshot is rendered. This
+   * may be called while the previous @ref startDrawJobs is still rendering the
+   * other snapshot. Only transformations may change while a snapshot is in
+   * flight, adding or removing drawables or sensors requires @ref waitDrawJobs
+   * first.
+   */
+  void snapshotDrawJobs();
 
   /**
    * @brief Begins all the draw jobs enqueued by @ref enqueueAsyncDrawJob.
    *
    * This method implicitly transfers ownership of the OpenGL context and scene
    * graphs to the thread, use @ref waitSceneGraph and @ref acquireGlContext to
-   * transfer ownership back
+   * transfer ownership back. If the jobs were captured by @ref
+   * snapshotDrawJobs, the scene graphs stay with the calling thread.
    */
   void startDrawJobs();
   /**
    * @brief Waits on all started
    */
   void waitDrawJobs();
+
+  /**
+   * @brief Whether the @p job-th job started by the last @ref startDrawJobs
+   * was drawn and its observation read into the view, see @ref waitDrawJob.
+   */
+  bool isDrawJobDone(int job) const;
+
+  /**
+   * @brief Waits until the observation of the @p job-th job started by the
+   * last @ref startDrawJobs is read into its view
+   *
+   * Unlike @ref waitDrawJobs, the other jobs may still be running and the
+   * OpenGL context stays with the thread, so e.g. a color observation can be
+   * consumed while a depth one is still being read. @p job is the index
+   * returned by @ref enqueueAsyncDrawJob. @ref waitDrawJobs still has to be
+   * called before starting the next frame.
+   */
+  void waitDrawJob(int job);
 #endif
   /**
    * @brief Sets the colormap for the @ref TextureVisualizerShader used for
@@ -172,6 +260,23 @@ class Renderer {
    */
   void bindRenderTarget(sensor::VisualSensor& sensor, Flags bindingFlags = {});
 
+  /**
+   * @brief Count of the render targets kept for reuse by @ref
+   * bindRenderTarget
+   *
+   * When a sensor that already has a render target gets bound again, e.g.
+   * after its resolution changed, the previous render target is kept, and a
+   * later binding with its size and flags gets it back instead of allocating
+   * new framebuffers and textures. At most a few most recently released ones
+   * are kept.
+   */
+  std::size_t pooledRenderTargetCount() const;
+
+  /**
+   * @brief Free the render targets kept for reuse by @ref bindRenderTarget
+   */
+  void clearRenderTargetPool();
+
   /**
    * @brief apply gaussian filtering to source cubemap and store the result in
    * target cubemap
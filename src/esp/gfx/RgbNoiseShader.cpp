@@ -0,0 +1,140 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RgbNoiseShader.h"
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+enum {
+  SourceTextureUnit = 1,
+};
+
+RgbNoiseShader::RgbNoiseShader(Type type) : type_{type} {
+  if (!Corrade::Utility::Resource::hasGroup("gfx-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  vert.addSource(rs.getString("bigTriangle.vert"));
+
+  const char* typeDefine = nullptr;
+  switch (type_) {
+    case Type::Gaussian:
+      typeDefine = "#define GAUSSIAN\n";
+      break;
+    case Type::SaltAndPepper:
+      typeDefine = "#define SALT_AND_PEPPER\n";
+      break;
+    case Type::Poisson:
+      typeDefine = "#define POISSON\n";
+      break;
+    case Type::Speckle:
+      typeDefine = "#define SPECKLE\n";
+      break;
+  }
+  CORRADE_INTERNAL_ASSERT(typeDefine);
+
+  frag.addSource(typeDefine)
+      .addSource(Cr::Utility::formatString(
+          "#define OUTPUT_ATTRIBUTE_LOCATION_COLOR {}\n", ColorOutput))
+      .addSource(rs.getString("rgbNoise.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+  attachShaders({vert, frag});
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+  // setup texture binding point
+  setUniform(uniformLocation("SourceTexture"), SourceTextureUnit);
+
+  // setup uniforms
+  seedUniform_ = uniformLocation("Seed");
+  CORRADE_INTERNAL_ASSERT(seedUniform_ >= 0);
+  frameUniform_ = uniformLocation("Frame");
+  CORRADE_INTERNAL_ASSERT(frameUniform_ >= 0);
+  if (type_ == Type::Gaussian || type_ == Type::Speckle) {
+    intensityConstantUniform_ = uniformLocation("IntensityConstant");
+    CORRADE_INTERNAL_ASSERT(intensityConstantUniform_ >= 0);
+    meanUniform_ = uniformLocation("Mean");
+    CORRADE_INTERNAL_ASSERT(meanUniform_ >= 0);
+    sigmaUniform_ = uniformLocation("Sigma");
+    CORRADE_INTERNAL_ASSERT(sigmaUniform_ >= 0);
+  } else if (type_ == Type::SaltAndPepper) {
+    amountUniform_ = uniformLocation("Amount");
+    CORRADE_INTERNAL_ASSERT(amountUniform_ >= 0);
+    saltVsPepperUniform_ = uniformLocation("SaltVsPepper");
+    CORRADE_INTERNAL_ASSERT(saltVsPepperUniform_ >= 0);
+  } else if (type_ == Type::Poisson) {
+    levelsUniform_ = uniformLocation("Levels");
+    CORRADE_INTERNAL_ASSERT(levelsUniform_ >= 0);
+  }
+}
+
+RgbNoiseShader& RgbNoiseShader::bindSourceTexture(
+    Magnum::GL::Texture2D& texture) {
+  texture.bind(SourceTextureUnit);
+  return *this;
+}
+
+RgbNoiseShader& RgbNoiseShader::setSeed(Mn::UnsignedInt seed,
+                                        Mn::UnsignedInt frame) {
+  setUniform(seedUniform_, seed);
+  setUniform(frameUniform_, frame);
+  return *this;
+}
+
+RgbNoiseShader& RgbNoiseShader::setNormalNoise(float intensityConstant,
+                                               float mean,
+                                               float sigma) {
+  if (intensityConstantUniform_ >= 0) {
+    setUniform(intensityConstantUniform_, intensityConstant);
+    setUniform(meanUniform_, mean);
+    setUniform(sigmaUniform_, sigma);
+  }
+  return *this;
+}
+
+RgbNoiseShader& RgbNoiseShader::setSaltAndPepper(float amount,
+                                                 float saltVsPepper) {
+  if (amountUniform_ >= 0) {
+    setUniform(amountUniform_, amount);
+    setUniform(saltVsPepperUniform_, saltVsPepper);
+  }
+  return *this;
+}
+
+RgbNoiseShader& RgbNoiseShader::setPoissonLevels(float levels) {
+  if (levelsUniform_ >= 0) {
+    setUniform(levelsUniform_, levels);
+  }
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
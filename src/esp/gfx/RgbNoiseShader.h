@@ -0,0 +1,99 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_RGBNOISESHADER_H_
+#define ESP_GFX_RGBNOISESHADER_H_
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Shaders/GenericGL.h>
+
+namespace esp {
+namespace gfx {
+/**
+@brief A shader adding noise to a color image, the GPU counterpart of the
+Gaussian, salt and pepper, Poisson and speckle noise models in
+habitat_sim.sensors.noise_models
+
+The noise only depends on the seed, the frame and the pixel, so drawing the
+same image with the same uniforms gives the same result.
+*/
+class RgbNoiseShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  enum : Magnum::UnsignedInt {
+    /**
+     * Color shader output. @ref shaders-generic "Generic output",
+     * present always. Expects three- or four-component floating-point
+     * or normalized buffer attachment.
+     */
+    ColorOutput = Magnum::Shaders::GenericGL3D::ColorOutput,
+  };
+
+  enum class Type {
+    /** Adds (normal * sigma + mean) * intensityConstant */
+    Gaussian,
+    /** Sets a channel to 1 or 0 with the probability of amount */
+    SaltAndPepper,
+    /** Replaces a channel by a Poisson sample of it times the levels */
+    Poisson,
+    /** Adds the channel times (normal * sigma + mean) * intensityConstant */
+    Speckle,
+  };
+
+  /** @brief Constructor */
+  explicit RgbNoiseShader(Type type);
+
+  /** @brief The noise type */
+  Type type() const { return type_; }
+
+  /**
+   * @brief Bind the texture holding the clean image.
+   * @return Reference to self (for method chaining)
+   */
+  RgbNoiseShader& bindSourceTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Set the seed and frame the noise is derived from.
+   * @return Reference to self (for method chaining)
+   */
+  RgbNoiseShader& setSeed(Magnum::UnsignedInt seed, Magnum::UnsignedInt frame);
+
+  /**
+   * @brief Set the parameters of @ref Type::Gaussian and @ref Type::Speckle
+   * noise, ignored otherwise.
+   * @return Reference to self (for method chaining)
+   */
+  RgbNoiseShader& setNormalNoise(float intensityConstant,
+                                 float mean,
+                                 float sigma);
+
+  /**
+   * @brief Set the parameters of @ref Type::SaltAndPepper noise, ignored
+   * otherwise.
+   * @return Reference to self (for method chaining)
+   */
+  RgbNoiseShader& setSaltAndPepper(float amount, float saltVsPepper);
+
+  /**
+   * @brief Set the number of intensity levels of @ref Type::Poisson noise,
+   * ignored otherwise.
+   * @return Reference to self (for method chaining)
+   */
+  RgbNoiseShader& setPoissonLevels(float levels);
+
+ private:
+  Type type_;
+  GLint seedUniform_ = -1;
+  GLint frameUniform_ = -1;
+  GLint intensityConstantUniform_ = -1;
+  GLint meanUniform_ = -1;
+  GLint sigmaUniform_ = -1;
+  GLint amountUniform_ = -1;
+  GLint saltVsPepperUniform_ = -1;
+  GLint levelsUniform_ = -1;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif
@@ -0,0 +1,205 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticColorToId.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/GenericGL.h>
+
+#include "esp/core/Profiler.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+enum {
+  ColorTextureUnit = 1,
+  ColorTableTextureUnit = 2,
+};
+
+// the widest color table texture, further colors continue on the next row
+constexpr Mn::UnsignedInt MaxColorsPerRow = 4096;
+
+class SemanticColorToIdShader : public Mn::GL::AbstractShaderProgram {
+ public:
+  enum : Mn::UnsignedInt {
+    IdOutput = Mn::Shaders::GenericGL3D::ColorOutput,
+  };
+
+  explicit SemanticColorToIdShader() {
+    if (!Cr::Utility::Resource::hasGroup("gfx-shaders")) {
+      importShaderResources();
+    }
+
+    const Cr::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+    Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+    Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+    Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+    Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+    vert.addSource(rs.getString("bigTriangle.vert"));
+    frag.addSource(Cr::Utility::formatString(
+                       "#define OUTPUT_ATTRIBUTE_LOCATION_ID {}\n", IdOutput))
+        .addSource(rs.getString("semanticColorToId.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+    attachShaders({vert, frag});
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    // setup texture binding points
+    setUniform(uniformLocation("ColorTexture"), ColorTextureUnit);
+    setUniform(uniformLocation("ColorTable"), ColorTableTextureUnit);
+
+    // setup uniforms
+    colorCountUniform_ = uniformLocation("ColorCount");
+    CORRADE_INTERNAL_ASSERT(colorCountUniform_ >= 0);
+    colorsPerRowUniform_ = uniformLocation("ColorsPerRow");
+    CORRADE_INTERNAL_ASSERT(colorsPerRowUniform_ >= 0);
+  }
+
+  SemanticColorToIdShader& bindColorTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(ColorTextureUnit);
+    return *this;
+  }
+
+  SemanticColorToIdShader& bindColorTable(Mn::GL::Texture2D& texture,
+                                          const Mn::Int colorCount,
+                                          const Mn::Int colorsPerRow) {
+    texture.bind(ColorTableTextureUnit);
+    setUniform(colorCountUniform_, colorCount);
+    setUniform(colorsPerRowUniform_, colorsPerRow);
+    return *this;
+  }
+
+ private:
+  GLint colorCountUniform_ = -1;
+  GLint colorsPerRowUniform_ = -1;
+};
+
+}  // namespace
+
+struct SemanticColorToId::Impl {
+  explicit Impl(const Cr::Containers::ArrayView<const Mn::UnsignedInt> colors) {
+    // (color, ID) pairs sorted by color. Black stays unmapped, and of colors
+    // listed several times the last ID wins, same as in the CPU table.
+    std::vector<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>> entries;
+    entries.reserve(colors.size());
+    for (std::size_t id = 0; id != colors.size(); ++id) {
+      if (colors[id] != 0) {
+        entries.emplace_back(colors[id], Mn::UnsignedInt(id));
+      }
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const std::pair<Mn::UnsignedInt, Mn::UnsignedInt>& a,
+                        const std::pair<Mn::UnsignedInt, Mn::UnsignedInt>& b) {
+                       return a.first < b.first;
+                     });
+    std::vector<std::pair<Mn::UnsignedInt, Mn::UnsignedInt>> unique;
+    unique.reserve(entries.size());
+    for (const auto& entry : entries) {
+      if (!unique.empty() && unique.back().first == entry.first) {
+        unique.back() = entry;
+      } else {
+        unique.push_back(entry);
+      }
+    }
+
+    colorCount = Mn::UnsignedInt(unique.size());
+    // an empty table still gets a texel, it's just never read
+    const Mn::UnsignedInt tableEntries = std::max(colorCount, 1u);
+    const Mn::Vector2i tableSize{
+        int(std::min(tableEntries, MaxColorsPerRow)),
+        int((tableEntries + MaxColorsPerRow - 1) / MaxColorsPerRow)};
+    colorsPerRow = tableSize.x();
+    std::vector<Mn::Vector2ui> table(tableSize.product(),
+                                     Mn::Vector2ui{~Mn::UnsignedInt{}, 0});
+    for (std::size_t i = 0; i != unique.size(); ++i) {
+      table[i] = {unique[i].first, unique[i].second};
+    }
+    colorTable.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RG32UI, tableSize)
+        .setSubImage(0, {},
+                     Mn::ImageView2D{Mn::PixelFormat::RG32UI, tableSize,
+                                     Cr::Containers::arrayView(table)});
+    mesh.setCount(3);
+  }
+
+  Mn::UnsignedInt colorCount = 0;
+  Mn::Int colorsPerRow = 1;
+  Mn::GL::Texture2D colorTable;
+  SemanticColorToIdShader shader;
+  // the big triangle, positioned by the shader from gl_VertexID
+  Mn::GL::Mesh mesh;
+};
+
+SemanticColorToId::SemanticColorToId(
+    const Cr::Containers::ArrayView<const Mn::UnsignedInt> colors)
+    : pimpl_{spimpl::make_unique_impl<Impl>(colors)} {}
+
+Mn::UnsignedInt SemanticColorToId::colorCount() const {
+  return pimpl_->colorCount;
+}
+
+void SemanticColorToId::convert(Mn::GL::Texture2D& colorTexture,
+                                Mn::GL::Texture2D& idTexture,
+                                const Mn::Vector2i& size) {
+  ESP_PROFILE_SCOPE("SemanticColorToId::convert");
+  Mn::GL::Framebuffer framebuffer{{{}, size}};
+  framebuffer
+      .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0}, idTexture, 0)
+      .mapForDraw({{SemanticColorToIdShader::IdOutput,
+                    Mn::GL::Framebuffer::ColorAttachment{0}}});
+  CORRADE_INTERNAL_ASSERT(
+      framebuffer.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+      Mn::GL::Framebuffer::Status::Complete);
+  framebuffer.bind();
+
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+  pimpl_->shader.bindColorTexture(colorTexture)
+      .bindColorTable(pimpl_->colorTable, pimpl_->colorCount,
+                      pimpl_->colorsPerRow)
+      .draw(pimpl_->mesh);
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
+
+  Mn::GL::defaultFramebuffer.bind();
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,64 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_SEMANTICCOLORTOID_H_
+#define ESP_GFX_SEMANTICCOLORTOID_H_
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/GL.h>
+#include <Magnum/Magnum.h>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Converts images of semantic colors to semantic IDs on the GPU
+
+The GPU counterpart of @ref assets::ResourceManager::convertRGBToSemanticId(),
+for semantic annotation textures and rendered color frames. The color of every
+pixel of a color texture is binary-searched in a small table of the semantic
+colors, and its ID is written straight into an integer texture, so the image
+never goes through a per-pixel conversion on the CPU nor the 16M-entry color
+table the CPU conversion indexes.
+*/
+class SemanticColorToId {
+ public:
+  /**
+   * @brief Constructor
+   * @param colors Semantic colors packed with @ref geo::getValueAsUInt(),
+   *    with the index being the semantic ID
+   *
+   * Black and colors not in @p colors map to ID 0. A color listed for several
+   * IDs maps to the last of them, same as on the CPU. Needs a GL context.
+   */
+  explicit SemanticColorToId(
+      Corrade::Containers::ArrayView<const Magnum::UnsignedInt> colors);
+
+  /** @brief Number of distinct colors mapped to nonzero IDs */
+  Magnum::UnsignedInt colorCount() const;
+
+  /**
+   * @brief Convert the colors in @p colorTexture to IDs in @p idTexture
+   * @param colorTexture Texture with a normalized, non-sRGB RGB or RGBA format.
+   *    Level 0 is read.
+   * @param idTexture Texture with @ref Magnum::GL::TextureFormat::R16UI or
+   *    @ref Magnum::GL::TextureFormat::R32UI storage. Level 0 is written.
+   * @param size Size of both textures.
+   *
+   * Draws into its own framebuffer and binds the default framebuffer again
+   * afterwards.
+   */
+  void convert(Magnum::GL::Texture2D& colorTexture,
+               Magnum::GL::Texture2D& idTexture,
+               const Magnum::Vector2i& size);
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(SemanticColorToId)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_SEMANTICCOLORTOID_H_
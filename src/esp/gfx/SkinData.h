@@ -5,9 +5,13 @@
 #ifndef ESP_GFX_SKINDATA_H_
 #define ESP_GFX_SKINDATA_H_
 
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Trade/SkinData.h>
 #include <esp/scene/SceneNode.h>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace esp {
 namespace gfx {
@@ -27,7 +31,8 @@ struct SkinData {
 /**
  * @brief Stores skinning data for an instance.
  * Contains association information of graphics bones and articulated object
- * links.
+ * links. Shared by all drawables of the instance, which also share the joint
+ * palette computed from the rig pose.
  */
 struct InstanceSkinData {
   /** @brief Pointer to loaded skin data for the instance. */
@@ -37,6 +42,17 @@ struct InstanceSkinData {
   /** @brief Map between skin joint IDs and articulated object transform nodes.
    */
   std::unordered_map<int, const scene::SceneNode*> jointIdToTransformNode{};
+  /** @brief Transform node of each skin joint in skin joint order, nullptr
+   * for joints without one. Resolved from @ref jointIdToTransformNode on the
+   * first palette update.
+   */
+  std::vector<const scene::SceneNode*> jointTransformNodes{};
+  /** @brief Joint palette uploaded by all drawables of the instance. */
+  Corrade::Containers::Array<Magnum::Matrix4> jointTransformations{};
+  /** @brief Render pass @ref jointTransformations was computed for, 0 if
+   * none.
+   */
+  std::uint64_t jointTransformationsDrawPass{0};
 
   explicit InstanceSkinData(const std::shared_ptr<SkinData>& skinData)
       : skinData(skinData){};
@@ -0,0 +1,233 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "VideoRecorder.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include "esp/core/Check.h"
+#include "esp/core/Logging.h"
+#include "esp/gfx/RenderTarget.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+// single-quote a string for the shell
+std::string shellQuote(const std::string& string) {
+  std::string quoted = "'";
+  for (const char c : string) {
+    if (c == '\'') {
+      quoted += "'\\''";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "'";
+}
+}  // namespace
+
+struct VideoRecorder::State {
+  explicit State(const Configuration& config) : config{config} {}
+
+  const Configuration config;
+  std::size_t frameBytes = 0;
+  std::size_t frameCount = 0;
+  bool open = false;
+  bool succeeded = false;
+
+  // reads started by addFrame(RenderTarget&), oldest first
+  std::deque<std::pair<RenderTarget*, RenderTarget::AsyncRead>> pendingReads;
+
+  // frames waiting for the worker, guarded by mutex
+  std::mutex mutex;
+  std::condition_variable queueChanged;
+  std::deque<Cr::Containers::Array<char>> queue;
+  bool finishing = false;
+  bool writeFailed = false;
+
+  std::FILE* pipe = nullptr;
+  std::thread worker;
+
+  Cr::Containers::Array<char> takeFrame() {
+    return Cr::Containers::Array<char>{Cr::NoInit, frameBytes};
+  }
+  void enqueue(Cr::Containers::Array<char>&& frame);
+  void finishOldestRead();
+  void writeFrames();
+};
+
+void VideoRecorder::State::enqueue(Cr::Containers::Array<char>&& frame) {
+  std::unique_lock<std::mutex> lock{mutex};
+  queueChanged.wait(lock,
+                    [&] { return queue.size() < config.maxQueuedFrames; });
+  queue.push_back(std::move(frame));
+  ++frameCount;
+  queueChanged.notify_all();
+}
+
+void VideoRecorder::State::finishOldestRead() {
+  Cr::Containers::Array<char> frame = takeFrame();
+  pendingReads.front().first->finishReadFrameAsync(
+      pendingReads.front().second,
+      Mn::MutableImageView2D{Mn::PixelFormat::RGBA8Unorm, config.size, frame});
+  pendingReads.pop_front();
+  enqueue(std::move(frame));
+}
+
+void VideoRecorder::State::writeFrames() {
+  // a dead encoder should fail the writes instead of killing the process
+  sigset_t sigpipe;
+  sigemptyset(&sigpipe);
+  sigaddset(&sigpipe, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &sigpipe, nullptr);
+
+  for (;;) {
+    Cr::Containers::Array<char> frame;
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      queueChanged.wait(lock, [&] { return finishing || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      frame = std::move(queue.front());
+      queue.pop_front();
+      queueChanged.notify_all();
+    }
+    // after a failure the frames are still drained so addFrame() never blocks
+    if (!writeFailed &&
+        std::fwrite(frame.data(), 1, frame.size(), pipe) != frame.size()) {
+      writeFailed = true;
+    }
+  }
+}
+
+VideoRecorder::VideoRecorder(const Configuration& config)
+    : state_{Cr::Containers::pointer<State>(config)} {
+  ESP_CHECK(config.size.product() > 0,
+            "VideoRecorder: expected a non-empty frame size but got"
+                << config.size);
+  ESP_CHECK(config.fps > 0,
+            "VideoRecorder: expected a positive frame rate but got"
+                << config.fps);
+  ESP_CHECK(config.maxQueuedFrames > 0,
+            "VideoRecorder: expected at least one queued frame");
+  state_->frameBytes = std::size_t(config.size.product()) * 4;
+
+  // GL images have the bottom row first, so flip them
+  std::ostringstream command;
+  command << shellQuote(config.ffmpeg)
+          << " -loglevel error -y -f rawvideo -pix_fmt rgba -s "
+          << config.size.x() << 'x' << config.size.y() << " -r " << config.fps
+          << " -i - -vf vflip -c:v " << shellQuote(config.encoder)
+          << " -pix_fmt yuv420p " << shellQuote(config.filename);
+  state_->pipe = popen(command.str().c_str(), "w");
+  ESP_CHECK(state_->pipe,
+            "VideoRecorder: can't start the encoder for" << config.filename);
+  state_->open = true;
+  state_->worker = std::thread{&State::writeFrames, state_.get()};
+}
+
+VideoRecorder::~VideoRecorder() {
+  close();
+}
+
+const VideoRecorder::Configuration& VideoRecorder::configuration() const {
+  return state_->config;
+}
+
+bool VideoRecorder::isOpen() const {
+  return state_->open;
+}
+
+std::size_t VideoRecorder::frameCount() const {
+  return state_->frameCount + state_->pendingReads.size();
+}
+
+void VideoRecorder::addFrame(RenderTarget& target) {
+  ESP_CHECK(state_->open, "VideoRecorder::addFrame(): the recorder is closed");
+  ESP_CHECK(target.framebufferSize() == state_->config.size,
+            "VideoRecorder::addFrame(): expected a render target of size"
+                << state_->config.size << "but got"
+                << target.framebufferSize());
+  // keep a buffer free so the read started here doesn't invalidate one
+  while (!state_->pendingReads.empty() &&
+         (state_->pendingReads.size() >=
+              RenderTarget::AsyncReadBufferCount - 1 ||
+          state_->pendingReads.front().first->isAsyncReadReady(
+              state_->pendingReads.front().second))) {
+    state_->finishOldestRead();
+  }
+  state_->pendingReads.emplace_back(
+      &target, target.readFrameAsync(RenderTarget::ReadSource::Rgba,
+                                     Mn::PixelFormat::RGBA8Unorm));
+}
+
+void VideoRecorder::addFrame(const Mn::ImageView2D& image) {
+  ESP_CHECK(state_->open, "VideoRecorder::addFrame(): the recorder is closed");
+  ESP_CHECK(image.format() == Mn::PixelFormat::RGBA8Unorm &&
+                image.size() == state_->config.size,
+            "VideoRecorder::addFrame(): expected a"
+                << Mn::PixelFormat::RGBA8Unorm << "image of size"
+                << state_->config.size << "but got" << image.format() << "of"
+                << image.size());
+  // frames added before stay in order
+  while (!state_->pendingReads.empty()) {
+    state_->finishOldestRead();
+  }
+  Cr::Containers::Array<char> frame = state_->takeFrame();
+  Cr::Utility::copy(image.pixels(),
+                    Mn::MutableImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                                           state_->config.size, frame}
+                        .pixels());
+  state_->enqueue(std::move(frame));
+}
+
+bool VideoRecorder::close() {
+  if (!state_->open) {
+    return state_->succeeded;
+  }
+  while (!state_->pendingReads.empty()) {
+    state_->finishOldestRead();
+  }
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->finishing = true;
+  }
+  state_->queueChanged.notify_all();
+  state_->worker.join();
+  state_->open = false;
+
+  const int status = pclose(state_->pipe);
+  state_->pipe = nullptr;
+  state_->succeeded = !state_->writeFailed && status != -1 &&
+                      WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  if (!state_->succeeded) {
+    ESP_ERROR() << "VideoRecorder: encoding" << state_->config.filename
+                << "with" << state_->config.encoder << "failed";
+  }
+  return state_->succeeded;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,135 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_VIDEORECORDER_H_
+#define ESP_GFX_VIDEORECORDER_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::VideoRecorder
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include <cstddef>
+#include <string>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+
+class RenderTarget;
+
+/**
+ * @brief Encodes rendered frames into a video file in the background
+ *
+ * Frames are streamed as raw RGBA to an `ffmpeg` process, which encodes them
+ * with @ref Configuration::encoder, by default `h264_nvenc` so the encoding
+ * happens on the GPU. Use `libx264` on machines without NVENC. The file
+ * format follows from the extension of @ref Configuration::filename.
+ *
+ * @ref addFrame(RenderTarget&) reads the color attachment with
+ * @ref RenderTarget::readFrameAsync() and only waits for a read once
+ * @ref RenderTarget::AsyncReadBufferCount - 1 are in flight, so the GPU isn't
+ * stalled every frame. Finished frames are written to the encoder on a worker
+ * thread. Frames of a @ref gfx_batch::RendererStandalone can be passed to
+ * @ref addFrame(const Magnum::ImageView2D&) after @ref
+ * gfx_batch::RendererStandalone::colorImageInto() of one environment's tile.
+ *
+ * Use one recorder per environment to get one video each.
+ */
+class VideoRecorder {
+ public:
+  /** @brief Recorder configuration */
+  struct Configuration {
+    /** @brief Output video file */
+    std::string filename;
+
+    /** @brief Frame size in pixels */
+    Magnum::Vector2i size;
+
+    /** @brief Frames per second */
+    int fps = 30;
+
+    /** @brief The `ffmpeg` video codec */
+    std::string encoder = "h264_nvenc";
+
+    /** @brief The `ffmpeg` executable */
+    std::string ffmpeg = "ffmpeg";
+
+    /**
+     * @brief Frames waiting for the encoder after which @ref addFrame()
+     * blocks, bounding the memory used when encoding can't keep up
+     */
+    std::size_t maxQueuedFrames = 8;
+  };
+
+  /**
+   * @brief Constructor
+   *
+   * Starts the encoder process. Failures of the encoder, such as a missing
+   * `ffmpeg` or an unavailable codec, are reported by @ref close().
+   */
+  explicit VideoRecorder(const Configuration& config);
+
+  /** @brief Copying is not allowed */
+  VideoRecorder(const VideoRecorder&) = delete;
+
+  /** @brief Copying is not allowed */
+  VideoRecorder& operator=(const VideoRecorder&) = delete;
+
+  /** @brief Destructor. Calls @ref close(). */
+  ~VideoRecorder();
+
+  /** @brief The configuration */
+  const Configuration& configuration() const;
+
+  /** @brief Whether the recorder accepts frames, i.e. isn't closed */
+  bool isOpen() const;
+
+  /**
+   * @brief Add the color attachment of @p target as the next frame
+   *
+   * The target has to have the configured size and an RGBA attachment and
+   * has to stay alive until the read is finished by a later @ref addFrame()
+   * or @ref close(). Reads are started with @ref
+   * RenderTarget::readFrameAsync(), which cycles through buffers shared with
+   * other async reads of the target, so don't keep other async reads of the
+   * target in flight while recording.
+   */
+  void addFrame(RenderTarget& target);
+
+  /**
+   * @brief Add @p image as the next frame
+   *
+   * The image has to be @ref Magnum::PixelFormat::RGBA8Unorm, of the
+   * configured size and with the bottom row first, as read from GL.
+   */
+  void addFrame(const Magnum::ImageView2D& image);
+
+  /** @brief Number of frames added so far */
+  std::size_t frameCount() const;
+
+  /**
+   * @brief Finish the pending reads, wait until all frames are encoded and
+   * close the file
+   * @return Whether all frames were encoded successfully
+   *
+   * Does nothing and returns the earlier result when called again.
+   */
+  bool close();
+
+  ESP_SMART_POINTERS(VideoRecorder)
+
+ private:
+  struct State;
+  Corrade::Containers::Pointer<State> state_;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_VIDEORECORDER_H_
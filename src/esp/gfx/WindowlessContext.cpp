@@ -4,6 +4,7 @@
 
 #include "WindowlessContext.h"
 
+#include <Corrade/Utility/Assert.h>
 #include <Corrade/configure.h>
 
 #ifdef MAGNUM_TARGET_EGL
@@ -25,8 +26,14 @@
 #error unsupported platform
 #endif
 
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/Platform/GLContext.h>
 
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 namespace Mn = Magnum;
 namespace Cr = Corrade;
 
@@ -34,11 +41,17 @@ namespace esp {
 namespace gfx {
 
 struct WindowlessContext::Impl {
-  explicit Impl(int device)
+  Impl(int device, Impl* shareWith, bool shared)
       : device_{device},
+        shared_{shared},
         magnumGLContext_{Mn::NoCreate},
         windowlessGLContext_{Mn::NoCreate} {
     Mn::Platform::WindowlessGLContext::Configuration config;
+    if (shareWith) {
+      CORRADE_INTERNAL_ASSERT(shareWith->shared_ &&
+                              shareWith->device_ == device);
+      config.setSharedContext(shareWith->windowlessGLContext_.glContext());
+    }
 
 #if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE)
 #ifdef MAGNUM_TARGET_EGL
@@ -62,7 +75,19 @@ struct WindowlessContext::Impl {
 
     makeCurrentPlatform();
 
-    if (!magnumGLContext_.tryCreate())
+    Mn::Platform::GLContext::Configuration glConfig;
+    if (shared) {
+#ifdef MAGNUM_TARGET_GLES
+      Mn::Fatal{} << "WindowlessContext: Shared contexts are not supported on "
+                     "OpenGL ES";
+#else
+      // Vertex array objects can't be shared between contexts, without them
+      // GL meshes only reference the shared buffers
+      glConfig.addDisabledExtensions<
+          Mn::GL::Extensions::ARB::vertex_array_object>();
+#endif
+    }
+    if (!magnumGLContext_.tryCreate(glConfig))
       Mn::Fatal{} << "WindowlessContext: Failed to create OpenGL context";
   }
 
@@ -87,14 +112,131 @@ struct WindowlessContext::Impl {
 
   int gpuDevice() const { return device_; }
 
+  bool isShared() const { return shared_; }
+
  private:
   int device_;
+  bool shared_;
   Mn::Platform::GLContext magnumGLContext_;
   Mn::Platform::WindowlessGLContext windowlessGLContext_;
 };
 
-WindowlessContext::WindowlessContext(int device /* = 0 */)
-    : pimpl_(spimpl::make_unique_impl<Impl>(device)) {}
+namespace {
+
+// Hidden contexts every shared context on a GPU shares its objects with,
+// keeping the share groups alive for the whole process
+struct ShareGroupRoots {
+  std::mutex mutex;
+  std::map<int, std::unique_ptr<WindowlessContext>> roots;
+};
+
+ShareGroupRoots& shareGroupRoots() {
+  static ShareGroupRoots roots;
+  return roots;
+}
+
+// Released contexts waiting to be reused, keyed by GPU and whether they're
+// in the share group of the GPU
+struct ContextPool {
+  std::mutex mutex;
+  std::map<std::pair<int, bool>,
+           std::vector<std::unique_ptr<WindowlessContext>>>
+      contexts;
+};
+
+ContextPool& contextPool() {
+  static ContextPool pool;
+  return pool;
+}
+
+}  // namespace
+
+WindowlessContext::WindowlessContext(int device /* = 0 */,
+                                     WindowlessContext* shareWith)
+    : pimpl_(spimpl::make_unique_impl<Impl>(
+          device,
+          shareWith ? shareWith->pimpl_.get() : nullptr,
+          shareWith != nullptr)) {}
+
+WindowlessContext::WindowlessContext(int device, ShareGroupRoot)
+    : pimpl_(spimpl::make_unique_impl<Impl>(device, nullptr, true)) {}
+
+std::unique_ptr<WindowlessContext> WindowlessContext::createShared(
+    int gpuDevice) {
+  ShareGroupRoots& groups = shareGroupRoots();
+  std::lock_guard<std::mutex> lock{groups.mutex};
+  std::unique_ptr<WindowlessContext>& root = groups.roots[gpuDevice];
+  if (!root) {
+    root.reset(new WindowlessContext{gpuDevice, ShareGroupRoot{}});
+    root->release();
+  }
+  return std::make_unique<WindowlessContext>(gpuDevice, root.get());
+}
+
+std::unique_ptr<WindowlessContext> WindowlessContext::acquirePooled(
+    int gpuDevice,
+    bool shared) {
+  {
+    ContextPool& pool = contextPool();
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    std::vector<std::unique_ptr<WindowlessContext>>& contexts =
+        pool.contexts[{gpuDevice, shared}];
+    if (!contexts.empty()) {
+      std::unique_ptr<WindowlessContext> context = std::move(contexts.back());
+      contexts.pop_back();
+      return context;
+    }
+  }
+  std::unique_ptr<WindowlessContext> context =
+      shared ? createShared(gpuDevice)
+             : std::make_unique<WindowlessContext>(gpuDevice);
+  context->release();
+  return context;
+}
+
+void WindowlessContext::releaseToPool(
+    std::unique_ptr<WindowlessContext> context) {
+  CORRADE_ASSERT(context,
+                 "WindowlessContext::releaseToPool(): expected a context", );
+  // the next user may expect the GL defaults, and Magnum's state tracker
+  // has to match whatever the previous user left bound
+  context->makeCurrent();
+  Mn::GL::Context::current().resetState();
+  context->release();
+
+  ContextPool& pool = contextPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  pool.contexts[{context->gpuDevice(), context->isShared()}].push_back(
+      std::move(context));
+}
+
+std::size_t WindowlessContext::pooledContextCount(int gpuDevice) {
+  ContextPool& pool = contextPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  std::size_t count = 0;
+  for (const auto& contexts : pool.contexts) {
+    if (contexts.first.first == gpuDevice) {
+      count += contexts.second.size();
+    }
+  }
+  return count;
+}
+
+void WindowlessContext::clearPool() {
+  std::map<std::pair<int, bool>,
+           std::vector<std::unique_ptr<WindowlessContext>>>
+      contexts;
+  {
+    ContextPool& pool = contextPool();
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    std::swap(contexts, pool.contexts);
+  }
+  // the contexts are destroyed here, outside of the lock
+}
+
+bool WindowlessContext::isShared() const {
+  return pimpl_->isShared();
+}
 
 void WindowlessContext::makeCurrent() {
   pimpl_->makeCurrent();
@@ -5,6 +5,9 @@
 #ifndef ESP_GFX_WINDOWLESSCONTEXT_H_
 #define ESP_GFX_WINDOWLESSCONTEXT_H_
 
+#include <cstddef>
+#include <memory>
+
 #include "esp/core/Esp.h"
 
 namespace esp {
@@ -12,7 +15,58 @@ namespace gfx {
 
 class WindowlessContext {
  public:
-  explicit WindowlessContext(int gpuDevice = 0);
+  /**
+   * @brief Constructor
+   * @param gpuDevice The GPU to create the context on
+   * @param shareWith If not null, the context shares GL objects with this
+   * one, which must be on the same GPU and belong to a share group, see
+   * @ref createShared().
+   */
+  explicit WindowlessContext(int gpuDevice = 0,
+                             WindowlessContext* shareWith = nullptr);
+
+  /**
+   * @brief Create a context in the process-wide share group of @p gpuDevice.
+   *
+   * All contexts created this way on the same GPU share buffers and textures,
+   * so GL resources uploaded through one of them can be used by all others.
+   * GL meshes are shared as well, which is done by not using vertex array
+   * objects in these contexts. The group is held alive by a hidden context
+   * created on the first call, so contexts can be destroyed in any order.
+   * Supported only on desktop GL.
+   */
+  static std::unique_ptr<WindowlessContext> createShared(int gpuDevice = 0);
+
+  /**
+   * @brief Take a context of @p gpuDevice from the process-wide pool
+   * @param gpuDevice The GPU the context should be on
+   * @param shared Whether the context should be in the share group of the
+   *    GPU, see @ref createShared()
+   *
+   * Creates a new context if the pool has none matching. Contexts given back
+   * with @ref releaseToPool() keep their driver state, so taking one skips
+   * the EGL device initialization and context creation. The returned context
+   * isn't current.
+   */
+  static std::unique_ptr<WindowlessContext> acquirePooled(int gpuDevice = 0,
+                                                          bool shared = false);
+
+  /**
+   * @brief Give a context back to the pool for a later @ref acquirePooled()
+   *
+   * All GL objects created in the context have to be destroyed before. The
+   * GL state is reset and the context is released from the calling thread.
+   */
+  static void releaseToPool(std::unique_ptr<WindowlessContext> context);
+
+  /** @brief Number of contexts of @p gpuDevice waiting in the pool */
+  static std::size_t pooledContextCount(int gpuDevice = 0);
+
+  /** @brief Destroy all contexts waiting in the pool */
+  static void clearPool();
+
+  /** @brief Whether the context is in a share group */
+  bool isShared() const;
 
   ~WindowlessContext() { ESP_DEBUG() << "Deconstructing WindowlessContext"; }
 
@@ -25,6 +79,11 @@ class WindowlessContext {
   int gpuDevice() const;
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(WindowlessContext)
+
+ private:
+  struct ShareGroupRoot {};
+  // Creates the hidden context of a share group, see createShared()
+  WindowlessContext(int gpuDevice, ShareGroupRoot);
 };
 
 }  // namespace gfx
@@ -0,0 +1,467 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KeyframeBinary.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Magnum/Math/Packing.h>
+
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+constexpr char Magic[8]{'\x89', 'G', 'F', 'X', 'R', 'P', 'L', '\n'};
+
+/* Bits of the per-update mask saying which parts of RenderAssetInstanceState
+   are stored, the rest is taken from the previous state of the instance */
+enum : Mn::UnsignedByte {
+  StateTranslation = 1 << 0,
+  StateRotation = 1 << 1,
+  StateSemanticId = 1 << 2,
+  StateAll = StateTranslation | StateRotation | StateSemanticId
+};
+
+/* Bits of the AssetInfo boolean properties */
+enum : Mn::UnsignedByte {
+  AssetForceFlatShading = 1 << 0,
+  AssetSplitInstanceMesh = 1 << 1,
+  AssetHasSemanticTextures = 1 << 2,
+  AssetHasOverridePhongMaterial = 1 << 3
+};
+
+class BinaryWriter {
+ public:
+  template <class T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be written as-is");
+    Cr::Containers::arrayAppend(
+        data_, Cr::Containers::arrayView(
+                   reinterpret_cast<const char*>(&value), sizeof(T)));
+  }
+
+  void writeString(const std::string& string) {
+    auto found = stringIds_.find(string);
+    if (found == stringIds_.end()) {
+      found =
+          stringIds_.emplace(string, Mn::UnsignedInt(strings_.size())).first;
+      strings_.push_back(string);
+    }
+    write(found->second);
+  }
+
+  void writeVector(const esp::vec3f& value) {
+    write(Mn::Vector3{value.x(), value.y(), value.z()});
+  }
+
+  void writeTransform(const Transform& transform) {
+    write(transform.translation);
+    writeRotation(transform.rotation);
+  }
+
+  void writeRotation(const Mn::Quaternion& rotation) {
+    write(Mn::Math::pack<Mn::Vector4s>(
+        Mn::Vector4{rotation.vector(), rotation.scalar()}));
+  }
+
+  /* Assembles the header, string table and the data written so far */
+  Cr::Containers::Array<char> finish(Mn::UnsignedInt keyframeCount) {
+    BinaryWriter out;
+    Cr::Containers::arrayAppend(out.data_,
+                                Cr::Containers::arrayView(Magic));
+    out.write(BinaryKeyframeVersion);
+    out.write(Mn::UnsignedInt(strings_.size()));
+    for (const std::string& string : strings_) {
+      out.write(Mn::UnsignedInt(string.size()));
+      Cr::Containers::arrayAppend(
+          out.data_, Cr::Containers::arrayView(string.data(), string.size()));
+    }
+    out.write(keyframeCount);
+    Cr::Containers::arrayAppend(out.data_, data_);
+    return std::move(out.data_);
+  }
+
+ private:
+  Cr::Containers::Array<char> data_;
+  std::unordered_map<std::string, Mn::UnsignedInt> stringIds_;
+  std::vector<std::string> strings_;
+};
+
+class BinaryReader {
+ public:
+  explicit BinaryReader(Cr::Containers::ArrayView<const char> data)
+      : data_{data} {}
+
+  bool failed() const { return failed_; }
+
+  bool atEnd() const { return offset_ == data_.size(); }
+
+  template <class T>
+  T read() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be read as-is");
+    T value{};
+    if (failed_ || data_.size() - offset_ < sizeof(T)) {
+      failed_ = true;
+      return value;
+    }
+    std::memcpy(&value, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  /* Reads an element count, failing if there's not enough data left for
+     that many elements of given minimal size. Prevents huge allocations when
+     reading garbage. */
+  std::size_t readCount(std::size_t minElementSize) {
+    const std::size_t count = read<Mn::UnsignedInt>();
+    if (failed_ || (data_.size() - offset_) / minElementSize < count) {
+      failed_ = true;
+      return 0;
+    }
+    return count;
+  }
+
+  std::string readRawString() {
+    const std::size_t size = readCount(1);
+    std::string out{data_.data() + offset_, size};
+    offset_ += size;
+    return out;
+  }
+
+  void readStringTable() {
+    const std::size_t count = readCount(sizeof(Mn::UnsignedInt));
+    strings_.reserve(count);
+    for (std::size_t i = 0; i != count && !failed_; ++i)
+      strings_.push_back(readRawString());
+  }
+
+  std::string readString() {
+    const Mn::UnsignedInt id = read<Mn::UnsignedInt>();
+    if (failed_ || id >= strings_.size()) {
+      failed_ = true;
+      return {};
+    }
+    return strings_[id];
+  }
+
+  esp::vec3f readVector() {
+    const Mn::Vector3 value = read<Mn::Vector3>();
+    return esp::vec3f{value.x(), value.y(), value.z()};
+  }
+
+  Transform readTransform() {
+    Transform transform;
+    transform.translation = read<Mn::Vector3>();
+    transform.rotation = readRotation();
+    return transform;
+  }
+
+  Mn::Quaternion readRotation() {
+    const Mn::Vector4 v = Mn::Math::unpack<Mn::Vector4>(read<Mn::Vector4s>());
+    const Mn::Quaternion rotation{v.xyz(), v.w()};
+    /* An all-zero quaternion can only come from garbage data, don't divide
+       by zero */
+    return rotation.isNormalized() || rotation.dot() == 0.0f
+               ? rotation
+               : rotation.normalized();
+  }
+
+ private:
+  Cr::Containers::ArrayView<const char> data_;
+  std::size_t offset_ = 0;
+  bool failed_ = false;
+  std::vector<std::string> strings_;
+};
+
+using InstanceStates =
+    std::unordered_map<RenderAssetInstanceKey, RenderAssetInstanceState>;
+
+void writeAssetInfo(BinaryWriter& out, const esp::assets::AssetInfo& info) {
+  out.write(Mn::UnsignedByte(info.type));
+  out.writeString(info.filepath);
+  out.writeVector(info.frame.up());
+  out.writeVector(info.frame.front());
+  out.writeVector(info.frame.origin());
+  out.write(info.virtualUnitToMeters);
+  out.write(Mn::UnsignedByte(
+      (info.forceFlatShading ? AssetForceFlatShading : 0) |
+      (info.splitInstanceMesh ? AssetSplitInstanceMesh : 0) |
+      (info.hasSemanticTextures ? AssetHasSemanticTextures : 0) |
+      (info.overridePhongMaterial ? AssetHasOverridePhongMaterial : 0)));
+  if (info.overridePhongMaterial) {
+    out.write(info.overridePhongMaterial->ambientColor);
+    out.write(info.overridePhongMaterial->diffuseColor);
+    out.write(info.overridePhongMaterial->specularColor);
+  }
+  out.write(Mn::UnsignedByte(info.shaderTypeToUse));
+}
+
+esp::assets::AssetInfo readAssetInfo(BinaryReader& in) {
+  esp::assets::AssetInfo info;
+  info.type = esp::assets::AssetType(in.read<Mn::UnsignedByte>());
+  info.filepath = in.readString();
+  const esp::vec3f up = in.readVector();
+  const esp::vec3f front = in.readVector();
+  const esp::vec3f origin = in.readVector();
+  if (!in.failed())
+    info.frame = esp::geo::CoordinateFrame{up, front, origin};
+  info.virtualUnitToMeters = in.read<float>();
+  const Mn::UnsignedByte flags = in.read<Mn::UnsignedByte>();
+  info.forceFlatShading = flags & AssetForceFlatShading;
+  info.splitInstanceMesh = flags & AssetSplitInstanceMesh;
+  info.hasSemanticTextures = flags & AssetHasSemanticTextures;
+  if (flags & AssetHasOverridePhongMaterial) {
+    esp::assets::PhongMaterialColor material;
+    material.ambientColor = in.read<Mn::Color4>();
+    material.diffuseColor = in.read<Mn::Color4>();
+    material.specularColor = in.read<Mn::Color4>();
+    info.overridePhongMaterial = material;
+  }
+  info.shaderTypeToUse = metadata::attributes::ObjectInstanceShaderType(
+      in.read<Mn::UnsignedByte>());
+  return info;
+}
+
+void writeKeyframe(BinaryWriter& out,
+                   const Keyframe& keyframe,
+                   InstanceStates& states) {
+  out.write(Mn::UnsignedInt(keyframe.loads.size()));
+  for (const auto& load : keyframe.loads)
+    writeAssetInfo(out, load);
+
+  out.write(Mn::UnsignedInt(keyframe.rigCreations.size()));
+  for (const auto& rigCreation : keyframe.rigCreations) {
+    out.write(Mn::Int(rigCreation.id));
+    out.write(Mn::UnsignedInt(rigCreation.boneNames.size()));
+    for (const auto& boneName : rigCreation.boneNames)
+      out.writeString(boneName);
+  }
+
+  out.write(Mn::UnsignedInt(keyframe.creations.size()));
+  for (const auto& pair : keyframe.creations) {
+    const auto& creation = pair.second;
+    out.write(Mn::Int(pair.first));
+    out.writeString(creation.filepath);
+    out.write(Mn::UnsignedByte(bool(creation.scale)));
+    if (creation.scale)
+      out.write(*creation.scale);
+    out.write(Mn::UnsignedInt(creation.flags));
+    out.writeString(creation.lightSetupKey);
+    out.write(Mn::Int(creation.rigId));
+  }
+
+  out.write(Mn::UnsignedInt(keyframe.deletions.size()));
+  for (const RenderAssetInstanceKey key : keyframe.deletions) {
+    out.write(Mn::Int(key));
+    states.erase(key);
+  }
+
+  out.write(Mn::UnsignedInt(keyframe.stateUpdates.size()));
+  for (const auto& pair : keyframe.stateUpdates) {
+    const RenderAssetInstanceState& state = pair.second;
+    Mn::UnsignedByte mask = StateAll;
+    auto found = states.find(pair.first);
+    if (found != states.end()) {
+      const RenderAssetInstanceState& prev = found->second;
+      mask = 0;
+      if (state.absTransform.translation != prev.absTransform.translation)
+        mask |= StateTranslation;
+      if (state.absTransform.rotation != prev.absTransform.rotation)
+        mask |= StateRotation;
+      if (state.semanticId != prev.semanticId)
+        mask |= StateSemanticId;
+    }
+    out.write(Mn::Int(pair.first));
+    out.write(mask);
+    if (mask & StateTranslation)
+      out.write(state.absTransform.translation);
+    if (mask & StateRotation)
+      out.writeRotation(state.absTransform.rotation);
+    if (mask & StateSemanticId)
+      out.write(Mn::Int(state.semanticId));
+    states[pair.first] = state;
+  }
+
+  out.write(Mn::UnsignedInt(keyframe.rigUpdates.size()));
+  for (const auto& rigUpdate : keyframe.rigUpdates) {
+    out.write(Mn::Int(rigUpdate.id));
+    out.write(Mn::UnsignedInt(rigUpdate.pose.size()));
+    for (const Transform& transform : rigUpdate.pose)
+      out.writeTransform(transform);
+  }
+
+  out.write(Mn::UnsignedInt(keyframe.userTransforms.size()));
+  for (const auto& pair : keyframe.userTransforms) {
+    out.writeString(pair.first);
+    out.writeTransform(pair.second);
+  }
+
+  out.write(Mn::UnsignedByte(keyframe.lightsChanged));
+  out.write(Mn::UnsignedInt(keyframe.lights.size()));
+  for (const LightInfo& light : keyframe.lights) {
+    out.write(light.vector);
+    out.write(light.color);
+    out.write(Mn::UnsignedByte(light.model));
+  }
+}
+
+Keyframe readKeyframe(BinaryReader& in, InstanceStates& states) {
+  Keyframe keyframe;
+
+  const std::size_t loadCount = in.readCount(1);
+  keyframe.loads.reserve(loadCount);
+  for (std::size_t i = 0; i != loadCount && !in.failed(); ++i)
+    keyframe.loads.push_back(readAssetInfo(in));
+
+  const std::size_t rigCreationCount = in.readCount(1);
+  keyframe.rigCreations.reserve(rigCreationCount);
+  for (std::size_t i = 0; i != rigCreationCount && !in.failed(); ++i) {
+    RigCreation rigCreation;
+    rigCreation.id = in.read<Mn::Int>();
+    const std::size_t boneCount = in.readCount(sizeof(Mn::UnsignedInt));
+    rigCreation.boneNames.reserve(boneCount);
+    for (std::size_t j = 0; j != boneCount && !in.failed(); ++j)
+      rigCreation.boneNames.push_back(in.readString());
+    keyframe.rigCreations.push_back(std::move(rigCreation));
+  }
+
+  const std::size_t creationCount = in.readCount(1);
+  keyframe.creations.reserve(creationCount);
+  for (std::size_t i = 0; i != creationCount && !in.failed(); ++i) {
+    const RenderAssetInstanceKey key = in.read<Mn::Int>();
+    esp::assets::RenderAssetInstanceCreationInfo creation;
+    creation.filepath = in.readString();
+    if (in.read<Mn::UnsignedByte>())
+      creation.scale = in.read<Mn::Vector3>();
+    creation.flags = esp::assets::RenderAssetInstanceCreationInfo::Flag(
+        in.read<Mn::UnsignedInt>());
+    creation.lightSetupKey = in.readString();
+    creation.rigId = in.read<Mn::Int>();
+    keyframe.creations.emplace_back(key, std::move(creation));
+  }
+
+  const std::size_t deletionCount = in.readCount(sizeof(Mn::Int));
+  keyframe.deletions.reserve(deletionCount);
+  for (std::size_t i = 0; i != deletionCount && !in.failed(); ++i) {
+    const RenderAssetInstanceKey key = in.read<Mn::Int>();
+    keyframe.deletions.push_back(key);
+    states.erase(key);
+  }
+
+  const std::size_t stateUpdateCount = in.readCount(sizeof(Mn::Int) + 1);
+  keyframe.stateUpdates.reserve(stateUpdateCount);
+  for (std::size_t i = 0; i != stateUpdateCount && !in.failed(); ++i) {
+    const RenderAssetInstanceKey key = in.read<Mn::Int>();
+    const Mn::UnsignedByte mask = in.read<Mn::UnsignedByte>();
+    RenderAssetInstanceState& state = states[key];
+    if (mask & StateTranslation)
+      state.absTransform.translation = in.read<Mn::Vector3>();
+    if (mask & StateRotation)
+      state.absTransform.rotation = in.readRotation();
+    if (mask & StateSemanticId)
+      state.semanticId = in.read<Mn::Int>();
+    keyframe.stateUpdates.emplace_back(key, state);
+  }
+
+  const std::size_t rigUpdateCount = in.readCount(1);
+  keyframe.rigUpdates.reserve(rigUpdateCount);
+  for (std::size_t i = 0; i != rigUpdateCount && !in.failed(); ++i) {
+    RigUpdate rigUpdate;
+    rigUpdate.id = in.read<Mn::Int>();
+    const std::size_t boneCount =
+        in.readCount(sizeof(Mn::Vector3) + sizeof(Mn::Vector4s));
+    rigUpdate.pose.reserve(boneCount);
+    for (std::size_t j = 0; j != boneCount && !in.failed(); ++j)
+      rigUpdate.pose.push_back(in.readTransform());
+    keyframe.rigUpdates.push_back(std::move(rigUpdate));
+  }
+
+  const std::size_t userTransformCount = in.readCount(1);
+  for (std::size_t i = 0; i != userTransformCount && !in.failed(); ++i) {
+    std::string name = in.readString();
+    keyframe.userTransforms[std::move(name)] = in.readTransform();
+  }
+
+  keyframe.lightsChanged = in.read<Mn::UnsignedByte>();
+  const std::size_t lightCount = in.readCount(1);
+  keyframe.lights.reserve(lightCount);
+  for (std::size_t i = 0; i != lightCount && !in.failed(); ++i) {
+    LightInfo light;
+    light.vector = in.read<Mn::Vector4>();
+    light.color = in.read<Mn::Color3>();
+    light.model = LightPositionModel(in.read<Mn::UnsignedByte>());
+    keyframe.lights.push_back(light);
+  }
+
+  return keyframe;
+}
+
+}  // namespace
+
+bool isBinaryKeyframeData(const Cr::Containers::ArrayView<const char> data) {
+  return data.size() >= sizeof(Magic) &&
+         std::memcmp(data.data(), Magic, sizeof(Magic)) == 0;
+}
+
+Cr::Containers::Array<char> writeKeyframesToBinary(
+    const std::vector<Keyframe>& keyframes) {
+  BinaryWriter out;
+  InstanceStates states;
+  for (const Keyframe& keyframe : keyframes)
+    writeKeyframe(out, keyframe, states);
+  return out.finish(Mn::UnsignedInt(keyframes.size()));
+}
+
+Cr::Containers::Array<char> writeKeyframeToBinary(const Keyframe& keyframe) {
+  BinaryWriter out;
+  InstanceStates states;
+  writeKeyframe(out, keyframe, states);
+  return out.finish(1);
+}
+
+std::vector<Keyframe> readKeyframesFromBinary(
+    const Cr::Containers::ArrayView<const char> data) {
+  if (!isBinaryKeyframeData(data)) {
+    ESP_ERROR() << "Data is not in the binary keyframe format.";
+    return {};
+  }
+
+  BinaryReader in{data.exceptPrefix(sizeof(Magic))};
+  const Mn::UnsignedInt version = in.read<Mn::UnsignedInt>();
+  if (!in.failed() && version != BinaryKeyframeVersion) {
+    ESP_ERROR() << "Unsupported binary keyframe format version" << version
+                << "(expected" << BinaryKeyframeVersion << Mn::Debug::nospace
+                << ").";
+    return {};
+  }
+
+  in.readStringTable();
+  const std::size_t keyframeCount = in.readCount(1);
+  std::vector<Keyframe> keyframes;
+  keyframes.reserve(keyframeCount);
+  InstanceStates states;
+  for (std::size_t i = 0; i != keyframeCount && !in.failed(); ++i)
+    keyframes.push_back(readKeyframe(in, states));
+
+  if (in.failed() || !in.atEnd()) {
+    ESP_ERROR() << "Binary keyframe data is truncated or corrupted.";
+    return {};
+  }
+
+  return keyframes;
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
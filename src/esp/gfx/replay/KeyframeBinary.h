@@ -0,0 +1,76 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_KEYFRAMEBINARY_H_
+#define ESP_GFX_REPLAY_KEYFRAMEBINARY_H_
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+
+#include "Keyframe.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief Version of the binary keyframe format written by
+ * @ref writeKeyframesToBinary()
+ *
+ * Bumped every time the layout changes in an incompatible way. Files with a
+ * different version are rejected by @ref readKeyframesFromBinary().
+ */
+constexpr std::uint32_t BinaryKeyframeVersion = 1;
+
+/**
+ * @brief Whether given data is in the binary keyframe format
+ *
+ * Checks only the file signature, not the version or the contents. Used by
+ * @ref Player::readKeyframesFromFile() to tell binary files from JSON.
+ */
+bool isBinaryKeyframeData(Corrade::Containers::ArrayView<const char> data);
+
+/**
+ * @brief Serialize keyframes to the binary keyframe format
+ *
+ * A compact alternative to the JSON produced by
+ * @ref Recorder::writeSavedKeyframesToFile(). All strings (asset filepaths,
+ * bone names, light setup keys and user transform names) are stored once in a
+ * string table and referenced by index. Instance state updates are
+ * delta-encoded against the previous state of the same instance, storing only
+ * the translation, rotation or semantic ID if it changed. Rotations are
+ * quantized to 16-bit normalized integers, which makes the format slightly
+ * lossy. Everything else is stored at full precision.
+ *
+ * The data is stored in the native byte order, which is little-endian on all
+ * platforms we support.
+ */
+Corrade::Containers::Array<char> writeKeyframesToBinary(
+    const std::vector<Keyframe>& keyframes);
+
+/**
+ * @brief Serialize a single keyframe to the binary keyframe format
+ *
+ * Same as calling @ref writeKeyframesToBinary() with just @p keyframe, but
+ * without copying it. As there's no previous keyframe, the state updates
+ * aren't delta-encoded.
+ */
+Corrade::Containers::Array<char> writeKeyframeToBinary(
+    const Keyframe& keyframe);
+
+/**
+ * @brief Deserialize keyframes from the binary keyframe format
+ *
+ * Prints a message to the error output and returns an empty vector if the
+ * data is not in the binary keyframe format, has an unsupported version or is
+ * truncated.
+ */
+std::vector<Keyframe> readKeyframesFromBinary(
+    Corrade::Containers::ArrayView<const char> data);
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
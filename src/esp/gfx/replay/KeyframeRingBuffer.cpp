@@ -0,0 +1,252 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KeyframeRingBuffer.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "KeyframeBinary.h"
+#include "esp/core/Check.h"
+#include "esp/core/Logging.h"
+
+#ifdef CORRADE_TARGET_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+constexpr char RingBufferMagic[8]{'\x89', 'G', 'F', 'X', 'R', 'I', 'N', 'G'};
+constexpr std::uint32_t RingBufferVersion = 1;
+
+// The counters are only ever incremented and never wrap in practice, the
+// position in the data is the counter modulo the capacity. Each message is a
+// 32-bit payload size followed by the payload, both possibly wrapping around
+// the end of the data.
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t headerSize;
+  std::uint64_t capacity;
+  // Separate cache lines so the producer and consumer don't fight over them
+  alignas(64) std::atomic<std::uint64_t> writeOffset;
+  alignas(64) std::atomic<std::uint64_t> readOffset;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "lock-free 64-bit atomics are needed for use across processes");
+
+}  // namespace
+
+struct KeyframeRingBuffer::State {
+  std::string name;
+  bool owner = false;
+  Header* header = nullptr;
+  char* data = nullptr;
+  std::size_t capacity = 0;
+  std::size_t mappedSize = 0;
+
+  void copyIn(std::uint64_t offset, const void* src, std::size_t size) {
+    const std::size_t begin = offset % capacity;
+    const std::size_t first = std::min(size, capacity - begin);
+    std::memcpy(data + begin, src, first);
+    std::memcpy(data, static_cast<const char*>(src) + first, size - first);
+  }
+
+  void copyOut(std::uint64_t offset, void* dst, std::size_t size) const {
+    const std::size_t begin = offset % capacity;
+    const std::size_t first = std::min(size, capacity - begin);
+    std::memcpy(dst, data + begin, first);
+    std::memcpy(static_cast<char*>(dst) + first, data, size - first);
+  }
+};
+
+#ifdef CORRADE_TARGET_UNIX
+KeyframeRingBuffer::KeyframeRingBuffer(const std::string& name,
+                                       std::size_t capacity)
+    : state_{Cr::InPlaceInit} {
+  ESP_CHECK(capacity > sizeof(std::uint32_t),
+            "KeyframeRingBuffer: capacity of" << capacity
+                                              << "bytes is too small");
+
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  ESP_CHECK(fd != -1, "KeyframeRingBuffer: can't create shared memory"
+                          << name << Cr::Utility::Debug::nospace << ":"
+                          << std::strerror(errno));
+
+  const std::size_t mappedSize = sizeof(Header) + capacity;
+  void* mapped = MAP_FAILED;
+  if (ftruncate(fd, mappedSize) == 0)
+    mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+  const int error = errno;
+  close(fd);
+  if (mapped == MAP_FAILED)
+    shm_unlink(name.c_str());
+  ESP_CHECK(mapped != MAP_FAILED, "KeyframeRingBuffer: can't map shared memory"
+                                      << name << Cr::Utility::Debug::nospace
+                                      << ":" << std::strerror(error));
+
+  // The memory is zero-filled by ftruncate(), so the atomics start at zero
+  Header* header = new (mapped) Header{};
+  header->version = RingBufferVersion;
+  header->headerSize = sizeof(Header);
+  header->capacity = capacity;
+  std::memcpy(header->magic, RingBufferMagic, sizeof(RingBufferMagic));
+
+  state_->name = name;
+  state_->owner = true;
+  state_->header = header;
+  state_->data = static_cast<char*>(mapped) + sizeof(Header);
+  state_->capacity = capacity;
+  state_->mappedSize = mappedSize;
+}
+
+KeyframeRingBuffer::ptr KeyframeRingBuffer::open(const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  ESP_CHECK(fd != -1, "KeyframeRingBuffer::open(): can't open shared memory"
+                          << name << Cr::Utility::Debug::nospace << ":"
+                          << std::strerror(errno));
+
+  struct stat st {};
+  void* mapped = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && std::size_t(st.st_size) > sizeof(Header))
+    mapped = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+  close(fd);
+  ESP_CHECK(mapped != MAP_FAILED,
+            "KeyframeRingBuffer::open(): can't map shared memory" << name);
+
+  const auto* header = static_cast<const Header*>(mapped);
+  const bool valid =
+      std::memcmp(header->magic, RingBufferMagic, sizeof(RingBufferMagic)) ==
+          0 &&
+      header->version == RingBufferVersion &&
+      header->headerSize == sizeof(Header) &&
+      header->capacity == std::size_t(st.st_size) - sizeof(Header);
+  if (!valid)
+    munmap(mapped, st.st_size);
+  ESP_CHECK(valid, "KeyframeRingBuffer::open():"
+                       << name << "is not a keyframe ring buffer of version"
+                       << RingBufferVersion);
+
+  Cr::Containers::Pointer<State> state{Cr::InPlaceInit};
+  state->name = name;
+  state->header = static_cast<Header*>(mapped);
+  state->data = static_cast<char*>(mapped) + sizeof(Header);
+  state->capacity = header->capacity;
+  state->mappedSize = st.st_size;
+  return ptr{new KeyframeRingBuffer{std::move(state)}};
+}
+
+KeyframeRingBuffer::~KeyframeRingBuffer() {
+  munmap(state_->header, state_->mappedSize);
+  if (state_->owner)
+    shm_unlink(state_->name.c_str());
+}
+#else
+KeyframeRingBuffer::KeyframeRingBuffer(const std::string&, std::size_t) {
+  ESP_CHECK(false, "KeyframeRingBuffer: not supported on this platform");
+}
+
+KeyframeRingBuffer::ptr KeyframeRingBuffer::open(const std::string&) {
+  ESP_CHECK(false,
+            "KeyframeRingBuffer::open(): not supported on this platform");
+  return nullptr;
+}
+
+KeyframeRingBuffer::~KeyframeRingBuffer() = default;
+#endif
+
+KeyframeRingBuffer::KeyframeRingBuffer(Cr::Containers::Pointer<State>&& state)
+    : state_{std::move(state)} {}
+
+const std::string& KeyframeRingBuffer::name() const {
+  return state_->name;
+}
+
+std::size_t KeyframeRingBuffer::capacity() const {
+  return state_->capacity;
+}
+
+bool KeyframeRingBuffer::isOwner() const {
+  return state_->owner;
+}
+
+std::size_t KeyframeRingBuffer::usedSize() const {
+  const std::uint64_t read =
+      state_->header->readOffset.load(std::memory_order_acquire);
+  const std::uint64_t write =
+      state_->header->writeOffset.load(std::memory_order_acquire);
+  return write - read;
+}
+
+bool KeyframeRingBuffer::push(const Keyframe& keyframe) {
+  const Cr::Containers::Array<char> payload = writeKeyframeToBinary(keyframe);
+  const std::size_t messageSize = sizeof(std::uint32_t) + payload.size();
+  if (messageSize > state_->capacity) {
+    ESP_WARNING() << "Keyframe of" << payload.size()
+                  << "bytes doesn't fit into a ring buffer of"
+                  << state_->capacity << "bytes";
+    return false;
+  }
+
+  // Only the producer modifies the write offset, the acquire on the read
+  // offset makes sure the consumer is done with the space before it's reused
+  Header& header = *state_->header;
+  const std::uint64_t write =
+      header.writeOffset.load(std::memory_order_relaxed);
+  const std::uint64_t read = header.readOffset.load(std::memory_order_acquire);
+  if (state_->capacity - (write - read) < messageSize)
+    return false;
+
+  const auto payloadSize = std::uint32_t(payload.size());
+  state_->copyIn(write, &payloadSize, sizeof(payloadSize));
+  state_->copyIn(write + sizeof(payloadSize), payload.data(), payload.size());
+  header.writeOffset.store(write + messageSize, std::memory_order_release);
+  return true;
+}
+
+Cr::Containers::Optional<Keyframe> KeyframeRingBuffer::pop() {
+  Header& header = *state_->header;
+  const std::uint64_t read = header.readOffset.load(std::memory_order_relaxed);
+  const std::uint64_t write =
+      header.writeOffset.load(std::memory_order_acquire);
+  if (read == write)
+    return Cr::Containers::NullOpt;
+
+  std::uint32_t payloadSize;
+  state_->copyOut(read, &payloadSize, sizeof(payloadSize));
+  CORRADE_INTERNAL_ASSERT(sizeof(payloadSize) + payloadSize <= write - read);
+  Cr::Containers::Array<char> payload{Cr::NoInit, payloadSize};
+  state_->copyOut(read + sizeof(payloadSize), payload.data(), payloadSize);
+  header.readOffset.store(read + sizeof(payloadSize) + payloadSize,
+                          std::memory_order_release);
+
+  std::vector<Keyframe> keyframes = readKeyframesFromBinary(payload);
+  if (keyframes.size() != 1) {
+    ESP_ERROR() << "Expected one keyframe in a ring buffer message but got"
+                << keyframes.size();
+    return Cr::Containers::NullOpt;
+  }
+  return std::move(keyframes.front());
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,119 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_KEYFRAMERINGBUFFER_H_
+#define ESP_GFX_REPLAY_KEYFRAMERINGBUFFER_H_
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <string>
+
+#include "Keyframe.h"
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief Default capacity of a @ref KeyframeRingBuffer in bytes
+ */
+constexpr std::size_t DEFAULT_KEYFRAME_RING_BUFFER_CAPACITY = 16 * 1024 * 1024;
+
+/**
+ * @brief Ring buffer of keyframes in shared memory
+ *
+ * Transports keyframes from a simulation process to a rendering process
+ * without serializing to JSON and copying through a pipe. Each keyframe is
+ * stored in the binary keyframe format from @ref writeKeyframeToBinary(), so
+ * the consumer only has to decode a compact blob.
+ *
+ * One process creates the buffer under a name with
+ * @ref KeyframeRingBuffer(const std::string&, std::size_t), other processes
+ * then open it with @ref KeyframeRingBuffer(const std::string&). The shared
+ * memory is removed when the creating instance is destroyed, already opened
+ * instances stay valid until they're destroyed as well.
+ *
+ * The buffer is lock-free and supports exactly one producer calling
+ * @ref push() and one consumer calling @ref pop() at the same time,
+ * typically a @ref Recorder in a sim worker and a @ref Player in the renderer.
+ *
+ * Available only on Unix platforms, elsewhere the constructors throw.
+ */
+class KeyframeRingBuffer {
+ public:
+  ESP_SMART_POINTERS(KeyframeRingBuffer)
+
+  /**
+   * @brief Create a ring buffer
+   * @param name      Name of the shared memory object. Should start with a
+   *    slash and contain no other slashes, such as `/habitat-env0`.
+   * @param capacity  Capacity in bytes
+   *
+   * Fails if a shared memory object of the same name already exists.
+   */
+  explicit KeyframeRingBuffer(
+      const std::string& name,
+      std::size_t capacity = DEFAULT_KEYFRAME_RING_BUFFER_CAPACITY);
+
+  /**
+   * @brief Open a ring buffer created by another instance
+   *
+   * Fails if there's no shared memory object called @p name or if it isn't a
+   * keyframe ring buffer.
+   */
+  static ptr open(const std::string& name);
+
+  KeyframeRingBuffer(const KeyframeRingBuffer&) = delete;
+  KeyframeRingBuffer(KeyframeRingBuffer&&) = delete;
+
+  ~KeyframeRingBuffer();
+
+  KeyframeRingBuffer& operator=(const KeyframeRingBuffer&) = delete;
+  KeyframeRingBuffer& operator=(KeyframeRingBuffer&&) = delete;
+
+  /** @brief Name of the shared memory object */
+  const std::string& name() const;
+
+  /** @brief Capacity in bytes */
+  std::size_t capacity() const;
+
+  /** @brief Whether this instance created the shared memory object */
+  bool isOwner() const;
+
+  /**
+   * @brief Bytes currently used by keyframes pushed and not yet popped
+   *
+   * May be outdated by the time it returns if the other side is active.
+   */
+  std::size_t usedSize() const;
+
+  /**
+   * @brief Push a keyframe
+   *
+   * Returns @cpp false @ce without pushing anything if there isn't enough
+   * free space. A keyframe that can never fit, i.e. is larger than
+   * @ref capacity(), additionally prints a warning.
+   */
+  bool push(const Keyframe& keyframe);
+
+  /**
+   * @brief Pop the oldest keyframe
+   *
+   * Returns @ref Corrade::Containers::NullOpt if the buffer is empty.
+   */
+  Corrade::Containers::Optional<Keyframe> pop();
+
+ private:
+  struct State;
+  explicit KeyframeRingBuffer(Corrade::Containers::Pointer<State>&& state);
+
+  Corrade::Containers::Pointer<State> state_;
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
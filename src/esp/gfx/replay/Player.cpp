@@ -4,11 +4,19 @@
 
 #include "Player.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Path.h>
 
+#include "KeyframeBinary.h"
+#include "KeyframeRingBuffer.h"
+#include "esp/core/ParallelFor.h"
 #include "esp/io/Json.h"
 
+#include <algorithm>
+
 namespace esp {
 namespace gfx {
 namespace replay {
@@ -36,8 +44,27 @@ std::string removeMaterialOverrideFromFilepathAndWarn(const std::string& src) {
 
 static_assert(std::is_nothrow_move_constructible<Player>::value, "");
 
+bool AbstractPlayerImplementation::canDeleteAssetInstance() const {
+  return false;
+}
+
 void AbstractPlayerImplementation::setNodeSemanticId(NodeHandle, unsigned) {}
 
+void AbstractPlayerImplementation::setNodeStates(
+    const Cr::Containers::ArrayView<const NodeHandle> nodes,
+    const Cr::Containers::StridedArrayView1D<const RenderAssetInstanceState>&
+        states) {
+  CORRADE_INTERNAL_ASSERT(nodes.size() == states.size());
+  for (std::size_t i = 0; i != nodes.size(); ++i) {
+    if (!nodes[i]) {
+      continue;
+    }
+    setNodeTransform(nodes[i], states[i].absTransform.translation,
+                     states[i].absTransform.rotation);
+    setNodeSemanticId(nodes[i], states[i].semanticId);
+  }
+}
+
 void AbstractPlayerImplementation::changeLightSetup(const LightSetup&) {}
 
 void AbstractSceneGraphPlayerImplementation::deleteAssetInstance(
@@ -123,8 +150,37 @@ void Player::readKeyframesFromFile(const std::string& filepath) {
     ESP_ERROR() << "File" << filepath << "not found.";
     return;
   }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Corrade::Utility::Path::read(filepath);
+  if (!data) {
+    ESP_ERROR() << "Failed to read keyframes from" << filepath << ".";
+    return;
+  }
+  // binary files are recognized by their signature, anything else is
+  // expected to be JSON
+  if (isBinaryKeyframeData(*data)) {
+    keyframes_ = readKeyframesFromBinary(*data);
+    if (keyframes_.empty()) {
+      ESP_ERROR() << "Failed to parse keyframes from" << filepath << ".";
+    }
+    return;
+  }
+  // stream through the file and parse each keyframe into its own small
+  // document instead of building a DOM of the whole file
+  std::vector<Cr::Containers::StringView> keyframeElements;
+  if (esp::io::findJsonArrayElements({data->data(), data->size()},
+                                     "keyframes", keyframeElements)) {
+    keyframes_.resize(keyframeElements.size());
+    core::parallelFor(keyframeElements.size(), 0,
+                      [&](std::size_t i, int) {
+                        keyframes_[i] =
+                            keyframeFromStringUnwrapped(keyframeElements[i]);
+                      });
+    return;
+  }
   try {
-    auto newDoc = esp::io::parseJsonFile(filepath);
+    auto newDoc =
+        esp::io::parseJsonString(std::string{data->data(), data->size()});
     readKeyframesFromJsonDocument(newDoc);
   } catch (...) {
     ESP_ERROR() << "Failed to parse keyframes from" << filepath << ".";
@@ -147,7 +203,26 @@ void Player::setKeyframeIndex(int frameIndex) {
   CORRADE_INTERNAL_ASSERT(frameIndex == -1 ||
                           (frameIndex >= 0 && frameIndex < getNumKeyframes()));
 
-  if (frameIndex < frameIndex_) {
+  // find the last checkpoint not after the target frame
+  updateCheckpoints(frameIndex);
+  auto checkpoint = std::upper_bound(
+      checkpoints_.begin(), checkpoints_.end(), frameIndex,
+      [](int index, const std::pair<int, Keyframe>& checkpoint) {
+        return index < checkpoint.first;
+      });
+
+  // Jump to it when going back, as everything has to be recreated anyway, or
+  // when going more than a checkpoint interval forward. Otherwise applying
+  // the keyframes in between is cheaper than recreating all instances.
+  if (checkpoint != checkpoints_.begin() &&
+      (frameIndex < frameIndex_ ||
+       ((checkpoint - 1)->first > frameIndex_ &&
+        frameIndex - frameIndex_ > checkpointInterval_))) {
+    --checkpoint;
+    clearFrame();
+    applyKeyframe(checkpoint->second);
+    frameIndex_ = checkpoint->first;
+  } else if (frameIndex < frameIndex_) {
     clearFrame();
   }
 
@@ -156,6 +231,91 @@ void Player::setKeyframeIndex(int frameIndex) {
   }
 }
 
+void Player::setCheckpointInterval(int interval) {
+  CORRADE_ASSERT(interval >= 0,
+                 "Player::setCheckpointInterval(): expected a non-negative "
+                 "interval, got"
+                     << interval, );
+  checkpointInterval_ = interval;
+  clearCheckpoints();
+}
+
+void Player::clearCheckpoints() {
+  checkpoints_.clear();
+  checkpointAccumulator_ = CheckpointAccumulator{};
+}
+
+void Player::updateCheckpoints(int frameIndex) {
+  if (checkpointInterval_ == 0) {
+    return;
+  }
+
+  auto& acc = checkpointAccumulator_;
+  for (; acc.nextFrameIndex <= frameIndex; ++acc.nextFrameIndex) {
+    const Keyframe& keyframe = keyframes_[acc.nextFrameIndex];
+    for (const auto& assetInfo : keyframe.loads) {
+      acc.loads[assetInfo.filepath] = assetInfo;
+    }
+    for (const auto& rigCreation : keyframe.rigCreations) {
+      acc.rigCreations[rigCreation.id] = rigCreation;
+    }
+    for (const auto& pair : keyframe.creations) {
+      acc.creations[pair.first] = pair.second;
+    }
+    for (const auto& deletionInstanceKey : keyframe.deletions) {
+      const auto found = acc.creations.find(deletionInstanceKey);
+      if (found == acc.creations.end()) {
+        continue;
+      }
+      const int rigId = found->second.rigId;
+      if (rigId != ID_UNDEFINED) {
+        acc.rigCreations.erase(rigId);
+        acc.rigPoses.erase(rigId);
+      }
+      acc.creations.erase(found);
+      acc.states.erase(deletionInstanceKey);
+    }
+    for (const auto& pair : keyframe.stateUpdates) {
+      acc.states[pair.first] = pair.second;
+    }
+    for (const auto& rigUpdate : keyframe.rigUpdates) {
+      acc.rigPoses[rigUpdate.id] = rigUpdate.pose;
+    }
+    if (keyframe.lightsChanged) {
+      acc.lights = keyframe.lights;
+      acc.lightsChanged = true;
+    }
+
+    // the first keyframe needs no checkpoint, applying it is as fast
+    if (acc.nextFrameIndex == 0 ||
+        acc.nextFrameIndex % checkpointInterval_ != 0) {
+      continue;
+    }
+
+    Keyframe checkpoint;
+    checkpoint.loads.reserve(acc.loads.size());
+    for (const auto& pair : acc.loads) {
+      checkpoint.loads.push_back(pair.second);
+    }
+    for (const auto& pair : acc.rigCreations) {
+      checkpoint.rigCreations.push_back(pair.second);
+    }
+    checkpoint.creations.assign(acc.creations.begin(), acc.creations.end());
+    for (const auto& pair : acc.creations) {
+      const auto found = acc.states.find(pair.first);
+      if (found != acc.states.end()) {
+        checkpoint.stateUpdates.emplace_back(*found);
+      }
+    }
+    for (const auto& pair : acc.rigPoses) {
+      checkpoint.rigUpdates.push_back(RigUpdate{pair.first, pair.second});
+    }
+    checkpoint.lights = acc.lights;
+    checkpoint.lightsChanged = acc.lightsChanged;
+    checkpoints_.emplace_back(acc.nextFrameIndex, std::move(checkpoint));
+  }
+}
+
 bool Player::getUserTransform(const std::string& name,
                               Magnum::Vector3* translation,
                               Magnum::Quaternion* rotation) const {
@@ -176,6 +336,7 @@ bool Player::getUserTransform(const std::string& name,
 void Player::close() {
   clearFrame();
   keyframes_.clear();
+  clearCheckpoints();
 }
 
 void Player::clearFrame() {
@@ -185,6 +346,7 @@ void Player::clearFrame() {
   if (implementation_)
     implementation_->deleteAssetInstances(createdInstances_);
   createdInstances_.clear();
+  instanceNodes_.clear();
   assetInfos_.clear();
   creationInfos_.clear();
   frameIndex_ = -1;
@@ -234,24 +396,13 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
 
     const auto& instanceKey = pair.first;
     CORRADE_INTERNAL_ASSERT(createdInstances_.count(instanceKey) == 0);
-    createdInstances_[instanceKey] = node;
+    setInstanceNode(instanceKey, node);
     creationInfos_[instanceKey] = adjustedCreation;
   }
 
   hackProcessDeletions(keyframe);
 
-  for (const auto& pair : keyframe.stateUpdates) {
-    const auto& it = createdInstances_.find(pair.first);
-    if (it == createdInstances_.end()) {
-      // Missing instance for this key due to a failed instance creation
-      continue;
-    }
-    auto* node = it->second;
-    const auto& state = pair.second;
-    implementation_->setNodeTransform(node, state.absTransform.translation,
-                                      state.absTransform.rotation);
-    implementation_->setNodeSemanticId(node, state.semanticId);
-  }
+  applyStateUpdates(keyframe);
 
   for (const auto& rigUpdate : keyframe.rigUpdates) {
     implementation_->setRigPose(rigUpdate.id, rigUpdate.pose);
@@ -263,15 +414,11 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
 }
 
 void Player::hackProcessDeletions(const Keyframe& keyframe) {
-  // HACK: Classic and batch renderers currently handle deletions differently.
-  // The batch renderer can only clear the scene entirely; it cannot delete
-  // individual objects. To process deletions, all instances are deleted,
-  // remaining instances are re-created and latest transform updates are
-  // re-applied.
-  bool isClassicReplayRenderer =
-      dynamic_cast<AbstractSceneGraphPlayerImplementation*>(
-          implementation_.get()) != nullptr;
-  if (isClassicReplayRenderer) {
+  // HACK: Implementations that can't delete individual instances can only
+  // clear the scene entirely. To process deletions for those, all instances
+  // are deleted, remaining instances are re-created and latest transform
+  // updates are re-applied.
+  if (implementation_->canDeleteAssetInstance()) {
     for (const auto& deletionInstanceKey : keyframe.deletions) {
       const auto& it = createdInstances_.find(deletionInstanceKey);
       if (it == createdInstances_.end()) {
@@ -280,7 +427,7 @@ void Player::hackProcessDeletions(const Keyframe& keyframe) {
       }
 
       implementation_->deleteAssetInstance(it->second);
-      createdInstances_.erase(deletionInstanceKey);
+      eraseInstanceNode(deletionInstanceKey);
 
       int rigId = creationInfos_[deletionInstanceKey].rigId;
       if (rigId != ID_UNDEFINED) {
@@ -307,18 +454,21 @@ void Player::hackProcessDeletions(const Keyframe& keyframe) {
         // Missing instance for this key due to a failed instance creation
         continue;
       }
-      createdInstances_.erase(createInstanceIt);
+      eraseInstanceNode(deletion);
       creationInfos_.erase(deletion);
     }
 
-    for (const auto& pair : createdInstances_) {
+    for (auto& pair : createdInstances_) {
       const auto key = pair.first;
       const auto& creationInfo = creationInfos_[key];
       auto* instance = implementation_->loadAndCreateRenderAssetInstance(
           assetInfos_[creationInfo.filepath], creationInfo);
 
       // Replace dangling reference
-      createdInstances_[key] = instance;
+      pair.second = instance;
+      if (key >= 0) {
+        instanceNodes_[key] = instance;
+      }
 
       // Re-apply latest transform updates
       implementation_->setNodeTransform(instance, latestTransformCache_[key]);
@@ -328,6 +478,58 @@ void Player::hackProcessDeletions(const Keyframe& keyframe) {
   }
 }
 
+void Player::applyStateUpdates(const Keyframe& keyframe) {
+  if (keyframe.stateUpdates.empty()) {
+    return;
+  }
+
+  // Look the nodes up in the dense array and hand all of them to the
+  // implementation at once, which for steady-state keyframes, with only state
+  // and rig updates, is all the work there is
+  stateUpdateNodes_.clear();
+  for (const auto& pair : keyframe.stateUpdates) {
+    const RenderAssetInstanceKey key = pair.first;
+    NodeHandle node = nullptr;
+    if (key >= 0) {
+      if (std::size_t(key) < instanceNodes_.size()) {
+        node = instanceNodes_[key];
+      }
+    } else {
+      const auto found = createdInstances_.find(key);
+      if (found != createdInstances_.end()) {
+        node = found->second;
+      }
+    }
+    // Null for a missing instance due to a failed instance creation
+    stateUpdateNodes_.push_back(node);
+  }
+
+  const auto& updates = keyframe.stateUpdates;
+  implementation_->setNodeStates(
+      stateUpdateNodes_,
+      Cr::Containers::StridedArrayView1D<const RenderAssetInstanceState>{
+          Cr::Containers::arrayView(updates), &updates[0].second,
+          updates.size(), sizeof(updates[0])});
+}
+
+void Player::setInstanceNode(const RenderAssetInstanceKey key,
+                             const NodeHandle node) {
+  createdInstances_[key] = node;
+  if (key >= 0) {
+    if (std::size_t(key) >= instanceNodes_.size()) {
+      instanceNodes_.resize(key + 1, nullptr);
+    }
+    instanceNodes_[key] = node;
+  }
+}
+
+void Player::eraseInstanceNode(const RenderAssetInstanceKey key) {
+  createdInstances_.erase(key);
+  if (key >= 0 && std::size_t(key) < instanceNodes_.size()) {
+    instanceNodes_[key] = nullptr;
+  }
+}
+
 void Player::appendKeyframe(Keyframe&& keyframe) {
   keyframes_.emplace_back(std::move(keyframe));
 }
@@ -336,8 +538,18 @@ void Player::appendJSONKeyframe(const std::string& keyframe) {
   appendKeyframe(keyframeFromString(keyframe));
 }
 
+int Player::appendKeyframesFromRingBuffer(KeyframeRingBuffer& ringBuffer) {
+  int count = 0;
+  while (Cr::Containers::Optional<Keyframe> keyframe = ringBuffer.pop()) {
+    appendKeyframe(std::move(*keyframe));
+    ++count;
+  }
+  return count;
+}
+
 void Player::setSingleKeyframe(Keyframe&& keyframe) {
   keyframes_.clear();
+  clearCheckpoints();
   frameIndex_ = -1;
   keyframes_.emplace_back(std::move(keyframe));
   setKeyframeIndex(0);
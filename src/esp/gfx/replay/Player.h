@@ -10,13 +10,23 @@
 #include "esp/assets/Asset.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 
+#include <Corrade/Containers/Containers.h>
 #include <rapidjson/document.h>
 
+#include <map>
+
 namespace esp {
 namespace gfx {
 namespace replay {
 
 class Player;
+class KeyframeRingBuffer;
+
+/**
+ * @brief Default interval of full-state checkpoints used by @ref Player for
+ * seeking. See @ref Player::setCheckpointInterval.
+ */
+constexpr int DEFAULT_CHECKPOINT_INTERVAL = 100;
 
 /**
 @brief Node handle
@@ -71,6 +81,15 @@ class AbstractPlayerImplementation {
    */
   virtual void deleteAssetInstance(NodeHandle node) = 0;
 
+  /**
+   * @brief Whether @ref deleteAssetInstance() can delete individual instances
+   *
+   * If not, the player processes deletions by deleting all instances with
+   * @ref deleteAssetInstances() and creating the remaining ones again.
+   * Default implementation returns @cpp false @ce.
+   */
+  virtual bool canDeleteAssetInstance() const;
+
   /**
    * @brief Clear all asset instances
    *
@@ -120,6 +139,21 @@ class AbstractPlayerImplementation {
    */
   virtual void setNodeSemanticId(NodeHandle node, unsigned id);
 
+  /**
+   * @brief Set transforms and semantic IDs of several nodes at once
+   *
+   * The @p nodes are expected to be returned from earlier calls to
+   * @ref loadAndCreateRenderAssetInstance() on the same instance, or be
+   * @cpp nullptr @ce for instances that failed to be created, which are
+   * skipped. The @p states have the same size as @p nodes. Default
+   * implementation calls @ref setNodeTransform() and
+   * @ref setNodeSemanticId() for each node.
+   */
+  virtual void setNodeStates(
+      Corrade::Containers::ArrayView<const NodeHandle> nodes,
+      const Corrade::Containers::StridedArrayView1D<
+          const RenderAssetInstanceState>& states);
+
   /**
    * @brief Change light setup
    *
@@ -164,6 +198,8 @@ class AbstractSceneGraphPlayerImplementation
 
   void deleteAssetInstance(NodeHandle node) override;
 
+  bool canDeleteAssetInstance() const override { return true; }
+
   void deleteAssetInstances(
       const std::unordered_map<RenderAssetInstanceKey, NodeHandle>& instances)
       override;
@@ -214,6 +250,10 @@ class Player {
   /**
    * @brief Read keyframes. See also @ref Recorder::writeSavedKeyframesToFile.
    * After calling this, use @ref setKeyframeIndex to set a keyframe.
+   *
+   * Both JSON and the binary format written by
+   * @ref Recorder::writeSavedKeyframesToBinaryFile are accepted, the format
+   * is detected from the file contents.
    * @param filepath
    */
   void readKeyframesFromFile(const std::string& filepath);
@@ -252,9 +292,30 @@ class Player {
   /**
    * @brief Set a keyframe by index, or pass -1 to clear the currently-set
    * keyframe.
+   *
+   * Keyframes only store changes, so the state at @p frameIndex is
+   * reconstructed by applying all keyframes before it. When seeking backwards
+   * or far forwards, the Player starts from the nearest full-state checkpoint
+   * instead of the first keyframe, see @ref setCheckpointInterval.
    */
   void setKeyframeIndex(int frameIndex);
 
+  /**
+   * @brief Set how often full-state checkpoints are made for seeking.
+   *
+   * Checkpoints are computed lazily from the loaded keyframes, one every
+   * @p interval keyframes; each holds all loads, live instances and their
+   * latest state, rig poses and lights. Seeking then applies at most
+   * @p interval keyframes on top of a checkpoint. Pass 0 to disable
+   * checkpoints. Default is @ref DEFAULT_CHECKPOINT_INTERVAL.
+   */
+  void setCheckpointInterval(int interval);
+
+  /**
+   * @brief Interval of full-state checkpoints.
+   */
+  int getCheckpointInterval() const { return checkpointInterval_; }
+
   /**
    * @brief Get a user transform. See @ref Recorder::addUserTransformToKeyframe
    * for usage tips.
@@ -273,6 +334,7 @@ class Player {
    */
   void debugSetKeyframes(std::vector<Keyframe>&& keyframes) {
     keyframes_ = std::move(keyframes);
+    clearCheckpoints();
   }
 
   /**
@@ -292,11 +354,41 @@ class Player {
    */
   void appendJSONKeyframe(const std::string& keyframe);
 
+  /**
+   * @brief Appends all keyframes available in a shared-memory ring buffer
+   * @return Number of keyframes appended
+   *
+   * Pops keyframes pushed by e.g.
+   * @ref Recorder::writeSavedKeyframesToRingBuffer() until the buffer is
+   * empty.
+   */
+  int appendKeyframesFromRingBuffer(KeyframeRingBuffer& ringBuffer);
+
  private:
   void applyKeyframe(const Keyframe& keyframe);
   void readKeyframesFromJsonDocument(const rapidjson::Document& d);
   void clearFrame();
   void hackProcessDeletions(const Keyframe& keyframe);
+  void applyStateUpdates(const Keyframe& keyframe);
+  void setInstanceNode(RenderAssetInstanceKey key, NodeHandle node);
+  void eraseInstanceNode(RenderAssetInstanceKey key);
+  void clearCheckpoints();
+  void updateCheckpoints(int frameIndex);
+
+  // Cumulative state of all keyframes up to nextFrameIndex, from which the
+  // checkpoints get made
+  struct CheckpointAccumulator {
+    int nextFrameIndex = 0;
+    std::unordered_map<std::string, esp::assets::AssetInfo> loads;
+    std::map<int, RigCreation> rigCreations;
+    std::map<RenderAssetInstanceKey, assets::RenderAssetInstanceCreationInfo>
+        creations;
+    std::unordered_map<RenderAssetInstanceKey, RenderAssetInstanceState>
+        states;
+    std::map<int, std::vector<Transform>> rigPoses;
+    std::vector<LightInfo> lights;
+    bool lightsChanged = false;
+  };
 
   std::shared_ptr<AbstractPlayerImplementation> implementation_;
 
@@ -304,12 +396,23 @@ class Player {
   std::vector<Keyframe> keyframes_;
   std::unordered_map<std::string, esp::assets::AssetInfo> assetInfos_;
   std::unordered_map<RenderAssetInstanceKey, NodeHandle> createdInstances_;
+  // createdInstances_ indexed by the (non-negative) instance key, for state
+  // updates without hash lookups, with null handles for unused keys
+  std::vector<NodeHandle> instanceNodes_;
+  // nodes of the state updates of the keyframe being applied
+  std::vector<NodeHandle> stateUpdateNodes_;
   std::unordered_map<RenderAssetInstanceKey,
                      assets::RenderAssetInstanceCreationInfo>
       creationInfos_;
   std::unordered_map<RenderAssetInstanceKey, Mn::Matrix4> latestTransformCache_;
   std::set<std::string> failedFilepaths_;
 
+  int checkpointInterval_ = DEFAULT_CHECKPOINT_INTERVAL;
+  // Index of the keyframe each checkpoint corresponds to, and the checkpoint
+  // itself, sorted by index
+  std::vector<std::pair<int, Keyframe>> checkpoints_;
+  CheckpointAccumulator checkpointAccumulator_;
+
   ESP_SMART_POINTERS(Player)
 };
 
@@ -4,15 +4,54 @@
 
 #include "Recorder.h"
 
+#include <Corrade/Utility/Path.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "KeyframeBinary.h"
+#include "KeyframeRingBuffer.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/core/Check.h"
+#include "esp/core/MemoryUsage.h"
+#include "esp/core/Profiler.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/SkinData.h"
 #include "esp/io/Json.h"
 #include "esp/io/JsonAllTypes.h"
+#include "esp/io/JsonWriter.h"
 #include "esp/scene/SceneNode.h"
 
 namespace {
+
+// Write {"keyframes": [...]}, or null if there are no keyframes, the same as
+// accepting the equivalent document but without building it
+template <class Writer>
+bool writeKeyframesJson(
+    Writer& writer,
+    const std::vector<esp::gfx::replay::Keyframe>& keyframes) {
+  if (keyframes.empty()) {
+    ESP_WARNING() << "No saved keyframes to write";
+    return writer.Null();
+  }
+  esp::io::JsonAllocator allocator;
+  writer.StartObject();
+  writer.Key("keyframes");
+  writer.StartArray();
+  for (const auto& keyframe : keyframes) {
+    esp::io::writeJson(writer, keyframe, allocator);
+    // the allocator only grows, reset it for every keyframe
+    allocator.Clear();
+  }
+  writer.EndArray();
+  return writer.EndObject();
+}
+
 esp::gfx::replay::Transform createReplayTransform(
     const Magnum::Matrix4& absTransformMat) {
   auto rotationShear = absTransformMat.rotationShear();
@@ -28,6 +67,41 @@ esp::gfx::replay::Transform createReplayTransform(
       absTransformMat.translation(),
       Magnum::Quaternion::fromMatrix(rotationShear)};
 };
+
+std::size_t keyframeByteSize(const esp::gfx::replay::Keyframe& keyframe) {
+  std::size_t size = sizeof(keyframe);
+  size += keyframe.loads.capacity() * sizeof(esp::assets::AssetInfo);
+  for (const auto& load : keyframe.loads) {
+    size += esp::core::heapByteSize(load.filepath);
+  }
+  size += keyframe.rigCreations.capacity() *
+          sizeof(esp::gfx::replay::RigCreation);
+  for (const auto& rig : keyframe.rigCreations) {
+    size += rig.boneNames.capacity() * sizeof(std::string);
+    for (const auto& name : rig.boneNames) {
+      size += esp::core::heapByteSize(name);
+    }
+  }
+  size += keyframe.creations.capacity() * sizeof(keyframe.creations[0]);
+  for (const auto& creation : keyframe.creations) {
+    size += esp::core::heapByteSize(creation.second.filepath) +
+            esp::core::heapByteSize(creation.second.lightSetupKey);
+  }
+  size += keyframe.deletions.capacity() * sizeof(keyframe.deletions[0]);
+  size += keyframe.stateUpdates.capacity() * sizeof(keyframe.stateUpdates[0]);
+  size +=
+      keyframe.rigUpdates.capacity() * sizeof(esp::gfx::replay::RigUpdate);
+  for (const auto& rig : keyframe.rigUpdates) {
+    size += rig.pose.capacity() * sizeof(esp::gfx::replay::Transform);
+  }
+  // each hash map node holds the entry and a pointer to the next node
+  for (const auto& user : keyframe.userTransforms) {
+    size += sizeof(user) + sizeof(void*) + esp::core::heapByteSize(user.first);
+  }
+  size += keyframe.userTransforms.bucket_count() * sizeof(void*);
+  size += keyframe.lights.capacity() * sizeof(keyframe.lights[0]);
+  return size;
+}
 }  // namespace
 
 namespace esp {
@@ -36,7 +110,7 @@ namespace replay {
 
 /**
  * @brief Helper class to get notified when a SceneNode is about to be
- * destroyed.
+ * destroyed or when its absolute transformation changes.
  */
 class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
  public:
@@ -49,17 +123,115 @@ class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
     recorder_->onDeleteRenderAssetInstance(node);
   }
 
+  // Set when the node or any of its parents got transformed. The scene graph
+  // notifies only on the clean -> dirty transition, so the Recorder cleans
+  // the node when clearing this.
+  bool transformDirty = true;
+
  private:
+  void markDirty() override { transformDirty = true; }
+
   Recorder* recorder_ = nullptr;
   const scene::SceneNode* node = nullptr;
 };
 
+/**
+ * @brief Writes keyframes to a file on a background thread.
+ *
+ * Keyframes are serialized to JSON on the thread as well, the file has the
+ * same layout as the one produced by @ref Recorder::writeSavedKeyframesToFile.
+ */
+class KeyframeStreamWriter {
+ public:
+  KeyframeStreamWriter(const std::string& filepath,
+                       std::size_t maxQueuedKeyframes,
+                       int maxDecimalPlaces)
+      : file_(filepath, std::ios::binary),
+        maxQueuedKeyframes_(maxQueuedKeyframes),
+        maxDecimalPlaces_(maxDecimalPlaces) {
+    ESP_CHECK(file_, "startStreamingToFile: unable to open " << filepath);
+    file_ << "{\"keyframes\":[";
+    thread_ = std::thread(&KeyframeStreamWriter::run, this);
+  }
+
+  ~KeyframeStreamWriter() {
+    if (thread_.joinable()) {
+      finish();
+    }
+  }
+
+  // Writes all queued keyframes and closes the file. Returns false if any
+  // write failed.
+  bool finish() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    notEmpty_.notify_one();
+    thread_.join();
+    file_ << "]}";
+    file_.close();
+    return bool(file_);
+  }
+
+  // Blocks if there's too many keyframes waiting already
+  void push(Keyframe&& keyframe) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [&] { return queue_.size() < maxQueuedKeyframes_; });
+    queue_.push_back(std::move(keyframe));
+    lock.unlock();
+    notEmpty_.notify_one();
+  }
+
+ private:
+  void run() {
+    esp::io::JsonAllocator allocator;
+    rapidjson::StringBuffer buffer;
+    for (bool first = true;; first = false) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      notEmpty_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+      Keyframe keyframe = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      notFull_.notify_one();
+
+      buffer.Clear();
+      rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+      if (maxDecimalPlaces_ != -1) {
+        writer.SetMaxDecimalPlaces(maxDecimalPlaces_);
+      }
+      esp::io::writeJson(writer, keyframe, allocator);
+      // the allocator only grows, reset it for every keyframe
+      allocator.Clear();
+      if (!first)
+        file_ << ',';
+      file_.write(buffer.GetString(), buffer.GetSize());
+    }
+  }
+
+  std::ofstream file_;
+  std::size_t maxQueuedKeyframes_;
+  int maxDecimalPlaces_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::deque<Keyframe> queue_;
+  bool stopping_ = false;
+};
+
 Recorder::~Recorder() {
+  if (streamWriter_ && !streamWriter_->finish()) {
+    ESP_ERROR() << "Writing streamed keyframes failed";
+  }
   // Delete NodeDeletionHelpers. This is important because they hold raw
   // pointers to this Recorder and these pointers would become dangling
   // (invalid) after this Recorder is destroyed.
-  for (auto& instanceRecord : instanceRecords_) {
-    delete instanceRecord.deletionHelper;
+  // Each deletion removes its record through onDeleteRenderAssetInstance.
+  while (!instanceRecords_.empty()) {
+    delete instanceRecords_.back().deletionHelper;
   }
 }
 
@@ -81,6 +253,7 @@ void Recorder::onCreateRenderAssetInstance(
   // manually later if necessary.
   NodeDeletionHelper* deletionHelper = new NodeDeletionHelper{*node, this};
 
+  instanceIndices_.emplace(node, instanceRecords_.size());
   instanceRecords_.emplace_back(InstanceRecord{node, instanceKey,
                                                Corrade::Containers::NullOpt,
                                                deletionHelper, creation.rigId});
@@ -110,6 +283,8 @@ void Recorder::onHideSceneGraph(const esp::scene::SceneGraph& sceneGraph) {
 }
 
 void Recorder::saveKeyframe() {
+  ESP_PROFILE_SCOPE("replayRecording");
+  ESP_TRACE_SCOPE("saveKeyframe");
   updateStates();
   advanceKeyframe();
 }
@@ -122,6 +297,9 @@ Keyframe Recorder::extractKeyframe() {
 }
 
 const Keyframe& Recorder::getLatestKeyframe() {
+  if (streamWriter_) {
+    return latestStreamedKeyframe_;
+  }
   CORRADE_ASSERT(!savedKeyframes_.empty(),
                  "Recorder::getLatestKeyframe() : Trying to access latest "
                  "keyframe when there are none",
@@ -186,7 +364,13 @@ void Recorder::onDeleteRenderAssetInstance(const scene::SceneNode* node) {
 
   checkAndAddDeletion(&getKeyframe(), instanceKey);
 
-  instanceRecords_.erase(instanceRecords_.begin() + index);
+  // Swap-remove the record, fixing up the index of the one that got moved
+  instanceIndices_.erase(node);
+  if (index != int(instanceRecords_.size()) - 1) {
+    instanceRecords_[index] = std::move(instanceRecords_.back());
+    instanceIndices_[instanceRecords_[index].node] = index;
+  }
+  instanceRecords_.pop_back();
   rigNodes_.erase(rigId);
   rigNodeTransformCache_.erase(rigId);
 }
@@ -200,14 +384,8 @@ RenderAssetInstanceKey Recorder::getNewInstanceKey() {
 }
 
 int Recorder::findInstance(const scene::SceneNode* queryNode) {
-  auto it = std::find_if(instanceRecords_.begin(), instanceRecords_.end(),
-                         [&queryNode](const InstanceRecord& record) {
-                           return record.node == queryNode;
-                         });
-
-  return it == instanceRecords_.end()
-             ? ID_UNDEFINED
-             : static_cast<int>(it - instanceRecords_.begin());
+  auto it = instanceIndices_.find(queryNode);
+  return it == instanceIndices_.end() ? ID_UNDEFINED : it->second;
 }
 
 RenderAssetInstanceState Recorder::getInstanceState(
@@ -224,7 +402,19 @@ void Recorder::updateStates() {
 
 void Recorder::updateInstanceStates() {
   for (auto& instanceRecord : instanceRecords_) {
+    // Skip nodes whose absolute transformation didn't change since the last
+    // update, the semantic ID isn't tracked by the scene graph so compare it
+    // directly
+    auto* deletionHelper = instanceRecord.deletionHelper;
+    if (instanceRecord.recentState && !deletionHelper->transformDirty &&
+        instanceRecord.node->getSemanticId() ==
+            instanceRecord.recentState->semanticId) {
+      continue;
+    }
+
     auto state = getInstanceState(instanceRecord.node);
+    instanceRecord.node->setClean();
+    deletionHelper->transformDirty = false;
     if (!instanceRecord.recentState || state != instanceRecord.recentState) {
       getKeyframe().stateUpdates.emplace_back(instanceRecord.instanceKey,
                                               state);
@@ -274,24 +464,103 @@ void Recorder::updateRigInstanceStates() {
 void Recorder::advanceKeyframe() {
   savedKeyframes_.emplace_back(std::move(currKeyframe_));
   currKeyframe_ = Keyframe{};
+  if (streamWriter_) {
+    streamSavedKeyframes();
+  }
+}
+
+void Recorder::startStreamingToFile(const std::string& filepath,
+                                    std::size_t maxQueuedKeyframes) {
+  ESP_CHECK(!streamWriter_,
+            "startStreamingToFile: already streaming, call stopStreaming() "
+            "first");
+  ESP_CHECK(maxQueuedKeyframes > 0,
+            "startStreamingToFile: expected a non-zero queue size");
+  streamWriter_ = std::make_unique<KeyframeStreamWriter>(
+      filepath, maxQueuedKeyframes, maxDecimalPlaces_);
+  streamedLoadsCreations_ = Keyframe{};
+  streamSavedKeyframes();
+}
+
+void Recorder::stopStreaming() {
+  if (!streamWriter_) {
+    return;
+  }
+  const bool ok = streamWriter_->finish();
+  streamWriter_ = nullptr;
+  ESP_CHECK(ok, "stopStreaming: writing streamed keyframes failed");
+
+  // keyframes saved from now on are kept in memory again, make sure the
+  // first of them has everything that was loaded and created so far
+  std::vector<Keyframe> streamed(1);
+  std::swap(streamed[0], streamedLoadsCreations_);
+  addLoadsCreationsDeletions(streamed.begin(), streamed.end(), &getKeyframe());
+  latestStreamedKeyframe_ = Keyframe{};
+  for (auto& instanceRecord : instanceRecords_) {
+    instanceRecord.recentState = Corrade::Containers::NullOpt;
+  }
+}
+
+void Recorder::streamSavedKeyframes() {
+  CORRADE_INTERNAL_ASSERT(streamWriter_);
+  addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
+                             &streamedLoadsCreations_);
+  for (auto& keyframe : savedKeyframes_) {
+    latestStreamedKeyframe_ = keyframe;
+    streamWriter_->push(std::move(keyframe));
+  }
+  savedKeyframes_.clear();
+}
+
+std::size_t Recorder::getKeyframesByteSize() const {
+  std::size_t size = keyframeByteSize(currKeyframe_) +
+                     keyframeByteSize(streamedLoadsCreations_) +
+                     keyframeByteSize(latestStreamedKeyframe_);
+  size += (savedKeyframes_.capacity() - savedKeyframes_.size()) *
+          sizeof(Keyframe);
+  for (const Keyframe& keyframe : savedKeyframes_) {
+    size += keyframeByteSize(keyframe);
+  }
+  return size;
 }
 
 void Recorder::writeSavedKeyframesToFile(const std::string& filepath,
                                          bool usePrettyWriter) {
-  auto document = writeKeyframesToJsonDocument();
-  auto ok = esp::io::writeJsonToFile(document, filepath, usePrettyWriter,
-                                     maxDecimalPlaces_);
+  ESP_TRACE_SCOPE("writeSavedKeyframes");
+  auto ok = esp::io::writeJsonToFile(
+      filepath, usePrettyWriter, maxDecimalPlaces_, [&](auto& writer) {
+        return writeKeyframesJson(writer, savedKeyframes_);
+      });
   ESP_CHECK(ok, "writeSavedKeyframesToFile: unable to write to " << filepath);
 
   consolidateSavedKeyframes();
 }
 
+void Recorder::writeSavedKeyframesToBinaryFile(const std::string& filepath) {
+  ESP_TRACE_SCOPE("writeSavedKeyframesBinary");
+  if (savedKeyframes_.empty()) {
+    ESP_WARNING() << "No saved keyframes to write";
+  }
+  const Corrade::Containers::Array<char> data =
+      writeKeyframesToBinary(savedKeyframes_);
+  auto ok = Corrade::Utility::Path::write(filepath, data);
+  ESP_CHECK(ok,
+            "writeSavedKeyframesToBinaryFile: unable to write to " << filepath);
+
+  consolidateSavedKeyframes();
+}
+
 std::string Recorder::writeSavedKeyframesToString() {
-  auto document = writeKeyframesToJsonDocument();
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+  if (maxDecimalPlaces_ != -1) {
+    writer.SetMaxDecimalPlaces(maxDecimalPlaces_);
+  }
+  writeKeyframesJson(writer, savedKeyframes_);
 
   consolidateSavedKeyframes();
 
-  return esp::io::jsonToString(document, maxDecimalPlaces_);
+  return {buffer.GetString(), buffer.GetSize()};
 }
 
 std::vector<std::string>
@@ -313,6 +582,20 @@ Recorder::writeIncrementalSavedKeyframesToStringArray() {
   return results;
 }
 
+std::size_t Recorder::writeSavedKeyframesToRingBuffer(
+    KeyframeRingBuffer& ringBuffer) {
+  ESP_TRACE_SCOPE("writeSavedKeyframesRingBuffer");
+  std::size_t count = 0;
+  while (count != savedKeyframes_.size() &&
+         ringBuffer.push(savedKeyframes_[count]))
+    ++count;
+
+  // as with writeIncrementalSavedKeyframesToStringArray, no consolidation
+  savedKeyframes_.erase(savedKeyframes_.begin(),
+                        savedKeyframes_.begin() + count);
+  return count;
+}
+
 void Recorder::setMaxDecimalPlaces(int maxDecimalPlaces) {
   maxDecimalPlaces_ = maxDecimalPlaces;
 }
@@ -322,10 +605,17 @@ int Recorder::getMaxDecimalPlaces() const {
 }
 
 std::string Recorder::keyframeToString(const Keyframe& keyframe) const {
-  rapidjson::Document d(rapidjson::kObjectType);
-  rapidjson::Document::AllocatorType& allocator = d.GetAllocator();
-  esp::io::addMember(d, "keyframe", keyframe, allocator);
-  return esp::io::jsonToString(d, maxDecimalPlaces_);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+  if (maxDecimalPlaces_ != -1) {
+    writer.SetMaxDecimalPlaces(maxDecimalPlaces_);
+  }
+  esp::io::JsonAllocator allocator;
+  writer.StartObject();
+  writer.Key("keyframe");
+  esp::io::writeJson(writer, keyframe, allocator);
+  writer.EndObject();
+  return {buffer.GetString(), buffer.GetSize()};
 }
 
 void Recorder::consolidateSavedKeyframes() {
@@ -340,18 +630,6 @@ void Recorder::consolidateSavedKeyframes() {
   savedKeyframes_.clear();
 }
 
-rapidjson::Document Recorder::writeKeyframesToJsonDocument() {
-  if (savedKeyframes_.empty()) {
-    ESP_WARNING() << "No saved keyframes to write";
-    return rapidjson::Document();
-  }
-
-  rapidjson::Document d(rapidjson::kObjectType);
-  rapidjson::Document::AllocatorType& allocator = d.GetAllocator();
-  esp::io::addMember(d, "keyframes", savedKeyframes_, allocator);
-  return d;
-}
-
 }  // namespace replay
 }  // namespace gfx
 }  // namespace esp
@@ -9,6 +9,7 @@
 
 #include <rapidjson/document.h>
 
+#include <memory>
 #include <string>
 
 namespace esp {
@@ -26,7 +27,11 @@ namespace replay {
 
 const int DEFAULT_MAX_DECIMAL_PLACES = 7;
 
+const std::size_t DEFAULT_MAX_QUEUED_KEYFRAMES = 64;
+
 class NodeDeletionHelper;
+class KeyframeStreamWriter;
+class KeyframeRingBuffer;
 
 /**
  * @brief Recording for "render replay".
@@ -38,6 +43,10 @@ class NodeDeletionHelper;
  * transforms" which can be used to store cameras, agents, or other
  * application-specific objects. See also @ref Player. See
  * examples/replay_tutorial.py for usage of this class through bindings.
+ *
+ * By default, saved keyframes are kept in memory until they're written with
+ * @ref writeSavedKeyframesToFile or similar. For long episodes, use
+ * @ref startStreamingToFile to write them to a file as they're saved instead.
  */
 class Recorder {
  public:
@@ -136,6 +145,51 @@ class Recorder {
   void writeSavedKeyframesToFile(const std::string& filepath,
                                  bool usePrettyWriter = false);
 
+  /**
+   * @brief Write saved keyframes to a file in the binary keyframe format.
+   *
+   * Like @ref writeSavedKeyframesToFile, but much smaller and faster to read
+   * back, see @ref writeKeyframesToBinary for details. Rotations are
+   * quantized, @ref setMaxDecimalPlaces has no effect. The file can be read
+   * with @ref Player::readKeyframesFromFile.
+   */
+  void writeSavedKeyframesToBinaryFile(const std::string& filepath);
+
+  /**
+   * @brief Start streaming saved keyframes to a file.
+   * @param filepath File to write to. Existing contents are overwritten.
+   * @param maxQueuedKeyframes How many keyframes can wait for being written
+   * before @ref saveKeyframe blocks.
+   *
+   * Already saved keyframes are written first, then each @ref saveKeyframe
+   * appends the keyframe to the file. Serialization and file I/O happen on a
+   * background thread, so memory use stays bounded by
+   * @p maxQueuedKeyframes instead of growing with the episode length. The
+   * file uses the same JSON layout as @ref writeSavedKeyframesToFile and is
+   * complete once @ref stopStreaming is called or the Recorder is destroyed.
+   *
+   * While streaming, there are no saved keyframes kept in memory and
+   * @ref writeSavedKeyframesToFile and similar have nothing to write.
+   */
+  void startStreamingToFile(
+      const std::string& filepath,
+      std::size_t maxQueuedKeyframes = DEFAULT_MAX_QUEUED_KEYFRAMES);
+
+  /**
+   * @brief Finish writing all streamed keyframes and close the file.
+   *
+   * Blocks until the background thread has written all queued keyframes.
+   * Loads and creations from the streamed keyframes are consolidated into the
+   * current keyframe, so keyframes saved afterwards can be written to a new
+   * file that's playable on its own. Does nothing if not streaming.
+   */
+  void stopStreaming();
+
+  /**
+   * @brief Whether keyframes are being streamed to a file.
+   */
+  bool isStreaming() const { return bool(streamWriter_); }
+
   /**
    * @brief write saved keyframes to string. '{"keyframes": [{...},{...},...]}'
    */
@@ -152,6 +206,18 @@ class Recorder {
    */
   std::vector<std::string> writeIncrementalSavedKeyframesToStringArray();
 
+  /**
+   * @brief Push saved keyframes to a shared-memory ring buffer
+   * @return Number of keyframes pushed
+   *
+   * Incremental like @ref writeIncrementalSavedKeyframesToStringArray(), but
+   * the keyframes are passed to the consumer in the binary keyframe format
+   * instead of as JSON. Keyframes are pushed in order until the buffer is
+   * full, only the pushed ones are discarded and the rest is kept for the
+   * next call.
+   */
+  std::size_t writeSavedKeyframesToRingBuffer(KeyframeRingBuffer& ringBuffer);
+
   /**
    * @brief Set the precision of the floating points serialized by this
    * recorder.
@@ -169,6 +235,12 @@ class Recorder {
    */
   std::string keyframeToString(const Keyframe& keyframe) const;
 
+  /**
+   * @brief Estimated CPU memory of the saved keyframes and those kept for
+   * streaming, in bytes.
+   */
+  std::size_t getKeyframesByteSize() const;
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -191,7 +263,6 @@ class Recorder {
 
   using KeyframeIterator = std::vector<Keyframe>::const_iterator;
 
-  rapidjson::Document writeKeyframesToJsonDocument();
   void onDeleteRenderAssetInstance(const scene::SceneNode* node);
   Keyframe& getKeyframe();
   void advanceKeyframe();
@@ -207,8 +278,12 @@ class Recorder {
                                   KeyframeIterator end,
                                   Keyframe* dest);
   void consolidateSavedKeyframes();
+  void streamSavedKeyframes();
 
+  // Order of the records changes on deletion, instanceIndices_ maps nodes to
+  // their current position
   std::vector<InstanceRecord> instanceRecords_;
+  std::unordered_map<const scene::SceneNode*, int> instanceIndices_;
   Keyframe currKeyframe_;
   std::vector<Keyframe> savedKeyframes_;
   RenderAssetInstanceKey nextInstanceKey_ = 0;
@@ -216,6 +291,13 @@ class Recorder {
   std::unordered_map<int, std::vector<Magnum::Matrix4>> rigNodeTransformCache_;
   int maxDecimalPlaces_ = DEFAULT_MAX_DECIMAL_PLACES;
 
+  // Set while streaming. streamedLoadsCreations_ accumulates loads and
+  // creations of the streamed keyframes, as they aren't in savedKeyframes_
+  // for consolidateSavedKeyframes to find.
+  std::unique_ptr<KeyframeStreamWriter> streamWriter_;
+  Keyframe streamedLoadsCreations_;
+  Keyframe latestStreamedKeyframe_;
+
   ESP_SMART_POINTERS(Recorder)
 };
 
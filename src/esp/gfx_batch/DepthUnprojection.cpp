@@ -29,6 +29,8 @@ enum { DepthTextureUnit = 1 };
 }
 
 DepthShader::DepthShader(Flags flags) : flags_{flags} {
+  CORRADE_INTERNAL_ASSERT(!(flags & Flag::UnprojectToPoints) ||
+                          (flags & Flag::UnprojectExistingDepth));
   if (!Corrade::Utility::Resource::hasGroup("gfx-batch-shaders")) {
     importShaderResources();
   }
@@ -50,6 +52,8 @@ DepthShader::DepthShader(Flags flags) : flags_{flags} {
 
   if (flags & Flag::NoFarPlanePatching)
     frag.addSource("#define NO_FAR_PLANE_PATCHING\n");
+  if (flags & Flag::UnprojectToPoints)
+    frag.addSource("#define UNPROJECT_TO_POINTS\n");
 
   vert.addSource(rs.getString("depth.vert"));
   frag.addSource(rs.getString("depth.frag"));
@@ -60,7 +64,11 @@ DepthShader::DepthShader(Flags flags) : flags_{flags} {
 
   CORRADE_INTERNAL_ASSERT_OUTPUT(link());
 
-  if (flags & Flag::UnprojectExistingDepth) {
+  if (flags & Flag::UnprojectToPoints) {
+    projectionMatrixOrDepthUnprojectionUniform_ =
+        uniformLocation("inverseProjectionMatrix");
+    setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
+  } else if (flags & Flag::UnprojectExistingDepth) {
     projectionMatrixOrDepthUnprojectionUniform_ =
         uniformLocation("depthUnprojection");
     setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
@@ -73,7 +81,8 @@ DepthShader::DepthShader(Flags flags) : flags_{flags} {
 
 DepthShader& DepthShader::setDepthUnprojection(
     const Mn::Vector2& depthUnprojection) {
-  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectExistingDepth);
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectExistingDepth &&
+                          !(flags_ & Flag::UnprojectToPoints));
   setUniform(projectionMatrixOrDepthUnprojectionUniform_, depthUnprojection);
   return *this;
 }
@@ -85,7 +94,9 @@ DepthShader& DepthShader::setTransformationMatrix(const Mn::Matrix4& matrix) {
 }
 
 DepthShader& DepthShader::setProjectionMatrix(const Mn::Matrix4& matrix) {
-  if (flags_ & Flag::UnprojectExistingDepth) {
+  if (flags_ & Flag::UnprojectToPoints) {
+    setUniform(projectionMatrixOrDepthUnprojectionUniform_, matrix.inverted());
+  } else if (flags_ & Flag::UnprojectExistingDepth) {
     setUniform(projectionMatrixOrDepthUnprojectionUniform_,
                calculateDepthUnprojection(matrix));
   } else {
@@ -15,7 +15,8 @@ namespace gfx_batch {
 @brief Depth-only shader
 
 Outputs depth values without projection applied. Can also unproject existing
-depth buffer if @ref Flag::UnprojectExistingDepth is enabled.
+depth buffer if @ref Flag::UnprojectExistingDepth is enabled, either to depth
+values or to camera-space points with @ref Flag::UnprojectToPoints.
 @see @ref calculateDepthUnprojection(), @ref unprojectDepth()
 */
 class DepthShader : public Magnum::GL::AbstractShaderProgram {
@@ -37,7 +38,20 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
      * set to). This might have some performance penalty and can be turned off
      * with this flag.
      */
-    NoFarPlanePatching = 1 << 1
+    NoFarPlanePatching = 1 << 1,
+
+    /**
+     * Unproject an existing depth buffer to camera-space points instead of
+     * depth values. Expects that @ref Flag::UnprojectExistingDepth is set as
+     * well. The output is a four-component float with XYZ being the position
+     * and W being @cpp 1.0f @ce. Points on the far plane are patched to be
+     * all zeros unless @ref Flag::NoFarPlanePatching is set.
+     *
+     * Unlike with just @ref Flag::UnprojectExistingDepth, the depth texture
+     * is fetched at the window position of each pixel, so it can be a single
+     * texture spanning all tiles with the viewport set to each tile in turn.
+     */
+    UnprojectToPoints = 1 << 2
   };
 
   /** @brief Flags */
@@ -57,12 +71,17 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
   /**
    * @brief Set the depth unprojection parameters directly
    * @return Reference to self (for method chaining)
+   *
+   * Expects that @ref Flag::UnprojectToPoints is not set.
    */
   DepthShader& setDepthUnprojection(const Magnum::Vector2& depthUnprojection);
 
   /**
    * @brief Set projection matrix for unprojection
    * @return Reference to self (for method chaining)
+   *
+   * With @ref Flag::UnprojectToPoints the full matrix is inverted, otherwise
+   * only the coefficients from @ref calculateDepthUnprojection() are used.
    */
   DepthShader& setProjectionMatrix(const Magnum::Matrix4& matrix);
 
@@ -0,0 +1,86 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GpuTimer.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+
+namespace esp {
+namespace gfx_batch {
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+bool GpuTimer::isSupported() {
+#ifndef MAGNUM_TARGET_GLES
+  return Mn::GL::Context::hasCurrent() &&
+         Mn::GL::Context::current()
+             .isExtensionSupported<Mn::GL::Extensions::ARB::timer_query>();
+#else
+  return false;
+#endif
+}
+
+GpuTimer::GpuTimer(const std::size_t queryCount)
+    : queries_{Cr::ValueInit, queryCount} {
+  CORRADE_ASSERT(queryCount, "GpuTimer: expected at least one query", );
+}
+
+GpuTimer::GpuTimer(GpuTimer&&) noexcept = default;
+
+GpuTimer::~GpuTimer() = default;
+
+GpuTimer& GpuTimer::operator=(GpuTimer&&) noexcept = default;
+
+void GpuTimer::begin() {
+  CORRADE_ASSERT(!measuring_, "GpuTimer::begin(): already measuring", );
+#ifndef MAGNUM_TARGET_GLES
+  if (inFlight_ == queries_.size() || !isSupported()) {
+    return;
+  }
+  Query& query = queries_[(oldest_ + inFlight_) % queries_.size()];
+  if (!query.begin.id()) {
+    query.begin = Mn::GL::TimeQuery{Mn::GL::TimeQuery::Target::Timestamp};
+    query.end = Mn::GL::TimeQuery{Mn::GL::TimeQuery::Target::Timestamp};
+  }
+  query.begin.timestamp();
+  measuring_ = true;
+#endif
+}
+
+void GpuTimer::end() {
+#ifndef MAGNUM_TARGET_GLES
+  if (!measuring_) {
+    return;
+  }
+  queries_[(oldest_ + inFlight_) % queries_.size()].end.timestamp();
+  ++inFlight_;
+  measuring_ = false;
+#endif
+}
+
+Cr::Containers::Optional<Mn::UnsignedLong> GpuTimer::takeDuration() {
+#ifndef MAGNUM_TARGET_GLES
+  if (!inFlight_) {
+    return {};
+  }
+  // the end timestamp being available implies the begin one is
+  Query& query = queries_[oldest_];
+  if (!query.end.resultAvailable()) {
+    return {};
+  }
+  const auto begin = query.begin.result<Mn::UnsignedLong>();
+  const auto end = query.end.result<Mn::UnsignedLong>();
+  oldest_ = (oldest_ + 1) % queries_.size();
+  --inFlight_;
+  return end > begin ? end - begin : 0;
+#else
+  return {};
+#endif
+}
+
+}  // namespace gfx_batch
+}  // namespace esp
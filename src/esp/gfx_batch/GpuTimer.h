@@ -0,0 +1,101 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_BATCH_GPUTIMER_H_
+#define ESP_GFX_BATCH_GPUTIMER_H_
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/GL.h>
+#include <Magnum/Magnum.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/TimeQuery.h>
+#endif
+
+#include <cstddef>
+
+namespace esp {
+namespace gfx_batch {
+
+/**
+@brief Measures the GPU duration of a repeatedly executed section
+
+Brackets the section between @ref begin() and @ref end() with a pair of
+timestamp queries, which unlike time elapsed queries can be nested inside
+other timed sections. The results are not waited for --- @ref takeDuration()
+returns them once the GPU finished the section, usually a frame or two later.
+To not stall, the queries are multi-buffered: if all of them are still in
+flight, the next @ref begin() doesn't measure anything.
+
+The queries are created on the first @ref begin() and belong to the GL
+context current at that point, so the instance has to be used and destroyed
+with that same context. Nothing is measured if @ref isSupported() is
+@cpp false @ce, which is the case on OpenGL ES and WebGL.
+*/
+class GpuTimer {
+ public:
+  /** @brief Whether the current GL context supports timestamp queries */
+  static bool isSupported();
+
+  /**
+   * @brief Constructor
+   * @param queryCount  How many measurements can be in flight at once. Use
+   *    more when the section runs several times a frame.
+   *
+   * Doesn't need a GL context.
+   */
+  explicit GpuTimer(std::size_t queryCount = 3);
+
+  /** @brief Copying is not allowed */
+  GpuTimer(const GpuTimer&) = delete;
+
+  /** @brief Move constructor */
+  GpuTimer(GpuTimer&&) noexcept;
+
+  ~GpuTimer();
+
+  /** @brief Copying is not allowed */
+  GpuTimer& operator=(const GpuTimer&) = delete;
+
+  /** @brief Move assignment */
+  GpuTimer& operator=(GpuTimer&&) noexcept;
+
+  /**
+   * @brief Begin measuring the section
+   *
+   * Does nothing if @ref isSupported() is @cpp false @ce or all queries are
+   * in flight.
+   */
+  void begin();
+
+  /** @brief End measuring the section begun with @ref begin() */
+  void end();
+
+  /**
+   * @brief Take the oldest finished measurement
+   * @return The GPU duration of the section in nanoseconds, or
+   *    @relativeref{Corrade,Containers::NullOpt} if no measurement finished
+   *    on the GPU yet
+   */
+  Corrade::Containers::Optional<Magnum::UnsignedLong> takeDuration();
+
+ private:
+  /* Timestamp queries are desktop-only, the queries stay empty elsewhere */
+  struct Query {
+#ifndef MAGNUM_TARGET_GLES
+    Magnum::GL::TimeQuery begin{Magnum::NoCreate};
+    Magnum::GL::TimeQuery end{Magnum::NoCreate};
+#endif
+  };
+
+  Corrade::Containers::Array<Query> queries_;
+  std::size_t oldest_ = 0;
+  std::size_t inFlight_ = 0;
+  bool measuring_ = false;
+};
+
+}  // namespace gfx_batch
+}  // namespace esp
+
+#endif  // ESP_GFX_BATCH_GPUTIMER_H_
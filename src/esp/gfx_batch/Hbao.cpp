@@ -29,6 +29,7 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/PixelFormat.h>
 #include <random>
 
@@ -124,6 +125,65 @@ class HbaoBlurShader : public Mn::GL::AbstractShaderProgram {
   bool bilateral_;
 };
 
+class HbaoUpsampleShader : public Mn::GL::AbstractShaderProgram {
+ private:
+  enum : Mn::Int {
+    SourceTextureBinding = 0,
+    ReducedLinearDepthTextureBinding = 1,
+    LinearDepthTextureBinding = 2
+  };
+
+ public:
+  explicit HbaoUpsampleShader(Mn::NoCreateT)
+      : Mn::GL::AbstractShaderProgram{Mn::NoCreate} {}
+
+  explicit HbaoUpsampleShader() {
+    Cr::Utility::Resource rs{"gfx-batch-shaders"};
+
+    Mn::GL::Shader vert{GlslVersion, Mn::GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("hbao/fullscreenquad.vert"));
+
+    Mn::GL::Shader frag{GlslVersion, Mn::GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("hbao/bilateralupsample.frag"));
+
+    CORRADE_INTERNAL_ASSERT(vert.compile());
+    CORRADE_INTERNAL_ASSERT(frag.compile());
+
+    attachShaders({vert, frag});
+    CORRADE_INTERNAL_ASSERT(link());
+
+    sharpnessUniform_ = uniformLocation("uGaussSharpness");
+    setUniform(uniformLocation("uTexSource"), SourceTextureBinding);
+    setUniform(uniformLocation("uTexReducedLinearDepth"),
+               ReducedLinearDepthTextureBinding);
+    setUniform(uniformLocation("uTexLinearDepth"), LinearDepthTextureBinding);
+  }
+
+  HbaoUpsampleShader& setSharpness(Mn::Float sharpness) {
+    setUniform(sharpnessUniform_, sharpness);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindSourceTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(SourceTextureBinding);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindReducedLinearDepthTexture(
+      Mn::GL::Texture2D& texture) {
+    texture.bind(ReducedLinearDepthTextureBinding);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindLinearDepthTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(LinearDepthTextureBinding);
+    return *this;
+  }
+
+ private:
+  Mn::Int sharpnessUniform_;
+};
+
 // TODO replace with own
 class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
  private:
@@ -151,6 +211,7 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
     CORRADE_INTERNAL_ASSERT(link());
 
     clipInfoUniform_ = uniformLocation("uClipInfo");
+    inputOffsetUniform_ = uniformLocation("uInputOffset");
     if (msaa) {
       sampleIndexUniform_ = uniformLocation("uSampleIndex");
     }
@@ -162,6 +223,11 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
     return *this;
   }
 
+  DepthLinearizeShader& setInputOffset(const Mn::Vector2i& offset) {
+    setUniform(inputOffsetUniform_, offset);
+    return *this;
+  }
+
   DepthLinearizeShader& setSampleIndex(Mn::Int index) {
     CORRADE_INTERNAL_ASSERT(msaa_);
     setUniform(sampleIndexUniform_, index);
@@ -184,7 +250,7 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
 #endif
 
  private:
-  Mn::Int clipInfoUniform_, sampleIndexUniform_;
+  Mn::Int clipInfoUniform_, inputOffsetUniform_, sampleIndexUniform_;
   bool msaa_;
 };
 
@@ -503,13 +569,22 @@ class HbaoReinterleaveShader : public Mn::GL::AbstractShaderProgram {
     attachShaders({vert, frag});
     CORRADE_INTERNAL_ASSERT(link());
 
+    outputOffsetUniform_ = uniformLocation("uOutputOffset");
     setUniform(uniformLocation("uTexResultsArray"), ResultsTextureBinding);
   }
 
+  HbaoReinterleaveShader& setOutputOffset(const Mn::Vector2i& offset) {
+    setUniform(outputOffsetUniform_, offset);
+    return *this;
+  }
+
   HbaoReinterleaveShader& bindResultsTexture(Mn::GL::Texture2DArray& texture) {
     texture.bind(ResultsTextureBinding);
     return *this;
   }
+
+ private:
+  Mn::Int outputOffsetUniform_;
 };
 
 /**
@@ -548,6 +623,11 @@ struct Hbao::State {
   Mn::GL::Texture2D sceneDepthLinear;
   Mn::GL::Framebuffer depthLinear{Mn::NoCreate};
 
+  /* Linear depth downsampled to aoSize, created only if the resolution
+     divisor isn't 1 */
+  Mn::GL::Texture2D sceneDepthLinearReduced{Mn::NoCreate};
+  Mn::GL::Framebuffer depthLinearReduced{Mn::NoCreate};
+
   Mn::GL::Texture2D sceneViewNormal;
   Mn::GL::Framebuffer viewNormal{Mn::NoCreate};
 
@@ -586,6 +666,8 @@ struct Hbao::State {
   HbaoReinterleaveShader hbao2ReinterleaveShader{/*specialBlur*/ false};
   HbaoReinterleaveShader hbao2ReinterleaveSpecialBlurShader{
       /*specialBlur*/ true};
+  /* Created in the constructor if the resolution divisor isn't 1 */
+  HbaoUpsampleShader upsampleShader{Mn::NoCreate};
 
   Mn::GL::Buffer hbaoUniform{Mn::GL::Buffer::TargetHint::Uniform};
   HbaoUniformData hbaoUniformData;
@@ -594,6 +676,17 @@ struct Hbao::State {
 
   HbaoConfiguration configuration;
 
+  /* Size the AO is calculated and blurred at, the configured size divided by
+     the resolution divisor */
+  Mn::Vector2i aoSize;
+
+  /* The linear depth the AO is calculated from, either sceneDepthLinear or
+     sceneDepthLinearReduced */
+  Mn::GL::Texture2D& aoDepthLinear() {
+    return configuration.resolutionDivisor() == 1 ? sceneDepthLinear
+                                                  : sceneDepthLinearReduced;
+  }
+
   Mn::Vector4 random[HbaoRandomNumElements * MaxSamples];
 };
 
@@ -623,6 +716,18 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
       !(configuration.flags() & HbaoFlag::LayeredGeometryShader) ||
       !(configuration.flags() & HbaoFlag::LayeredImageLoadStore));
 
+  CORRADE_ASSERT(configuration.resolutionDivisor() == 1 ||
+                     configuration.resolutionDivisor() == 2 ||
+                     configuration.resolutionDivisor() == 4,
+                 "Hbao::setConfiguration(): expected a resolution divisor of "
+                 "1, 2 or 4 but got"
+                     << configuration.resolutionDivisor(), );
+
+  const Mn::Vector2i aoSize =
+      (configuration.size() + Mn::Vector2i{configuration.resolutionDivisor()} -
+       Mn::Vector2i{1}) /
+      configuration.resolutionDivisor();
+
   /* "init misc" */
   {
     std::mt19937 rmt;
@@ -673,13 +778,27 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
     state_->depthLinear.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                                       state_->sceneDepthLinear, 0);
 
+    if (configuration.resolutionDivisor() != 1) {
+      state_->sceneDepthLinearReduced = Mn::GL::Texture2D{};
+      state_->sceneDepthLinearReduced
+          .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::R32F, aoSize);
+
+      state_->depthLinearReduced = Mn::GL::Framebuffer{{{}, aoSize}};
+      state_->depthLinearReduced.attachTexture(
+          Mn::GL::Framebuffer::ColorAttachment{0},
+          state_->sceneDepthLinearReduced, 0);
+    }
+
     state_->sceneViewNormal
         .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, Mn::GL::TextureFormat::RGBA8, configuration.size());
+        .setStorage(1, Mn::GL::TextureFormat::RGBA8, aoSize);
 
-    state_->viewNormal = Mn::GL::Framebuffer{{{}, configuration.size()}};
+    state_->viewNormal = Mn::GL::Framebuffer{{{}, aoSize}};
     state_->viewNormal.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                                      state_->sceneViewNormal, 0);
 
@@ -688,9 +807,9 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
             ? Mn::GL::TextureFormat::RG16F
             : Mn::GL::TextureFormat::R8;
     state_->hbaoResult.setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, aoFormat, configuration.size());
+        .setStorage(1, aoFormat, aoSize);
     state_->hbaoBlur.setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, aoFormat, configuration.size());
+        .setStorage(1, aoFormat, aoSize);
 
 #ifndef MAGNUM_TARGET_WEBGL
     if (configuration.flags() & HbaoFlag::UseAoSpecialBlur) {
@@ -702,15 +821,14 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
     }
 #endif
 
-    state_->hbaoCalc = Mn::GL::Framebuffer{{{}, configuration.size()}};
+    state_->hbaoCalc = Mn::GL::Framebuffer{{{}, aoSize}};
     state_->hbaoCalc
         .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                        state_->hbaoResult, 0)
         .attachTexture(Mn::GL::Framebuffer::ColorAttachment{1},
                        state_->hbaoBlur, 0);
 
-    const Mn::Vector2i quarterSize =
-        (configuration.size() + Mn::Vector2i{3}) / 4;
+    const Mn::Vector2i quarterSize = (aoSize + Mn::Vector2i{3}) / 4;
 
     state_->hbao2DepthArray
         .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
@@ -768,9 +886,14 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
                        textureArrayLayer};
   }
 
+  if (configuration.resolutionDivisor() != 1) {
+    state_->upsampleShader = HbaoUpsampleShader{};
+  }
+
   state_->triangle.setCount(3);
   state_->triangleLayered.setCount(3 * HbaoRandomNumElements);
   state_->configuration = configuration;
+  state_->aoSize = aoSize;
 }
 
 Magnum::Vector2i Hbao::getFrameBufferSize() const {
@@ -781,10 +904,13 @@ namespace {
 
 /**
  * Populate uniform data with appropriate values from configuration. Should only
- * be performed when configuration changes.
+ * be performed when configuration changes. The @p aoSize is the size the AO is
+ * calculated at, which is smaller than the configured size if a resolution
+ * divisor is set.
  */
 void prepareHbaoData(
     const HbaoConfiguration& configuration,
+    const Mn::Vector2i& aoSize,
     const Mn::Matrix4& projection,
     HbaoUniformData& uniformData,
     Mn::GL::Buffer& uniform,
@@ -797,9 +923,9 @@ void prepareHbaoData(
   uniformData.negInvR2 = -1.0f / uniformData.r2;
   const Mn::Float projectionScale =
       (uniformData.projOrtho != 0
-           ? configuration.size().y() / uniformData.projInfo[1]  // ortho
+           ? aoSize.y() / uniformData.projInfo[1]  // ortho
            // For perspective, projection[0][0] is 1/tan(fov/2)
-           : 0.5f * configuration.size().y() * projection[0][0]);  // persp
+           : 0.5f * aoSize.y() * projection[0][0]);  // persp
   uniformData.radiusToScreen = r * 0.5f * projectionScale;
 
   /* AO */
@@ -808,11 +934,10 @@ void prepareHbaoData(
   uniformData.aoMultiplier = 1.0f / (1.0f - uniformData.nDotVBias);
 
   /* Resolution */
-  const Mn::Vector2i quarterSize = (configuration.size() + Mn::Vector2i{3}) / 4;
+  const Mn::Vector2i quarterSize = (aoSize + Mn::Vector2i{3}) / 4;
   uniformData.invQuarterResolution =
       Mn::Vector2{1.0f} / Mn::Vector2{quarterSize};
-  uniformData.invFullResolution =
-      Mn::Vector2{1.0f} / Mn::Vector2{configuration.size()};
+  uniformData.invFullResolution = Mn::Vector2{1.0f} / Mn::Vector2{aoSize};
 
   if (configuration.flags() &
       (HbaoFlag::LayeredGeometryShader | HbaoFlag::LayeredImageLoadStore))
@@ -845,34 +970,30 @@ Mn::Vector4 buildClipInfo(const Mn::Matrix4& projectionMatrix,
 }  // namespace
 
 void Hbao::drawLinearDepth(const Mn::Matrix4& projection,
-                           Mn::GL::Texture2D& depthStencilInput) {
+                           Mn::GL::Texture2D& depthStencilInput,
+                           const Mn::Vector2i& inputOffset) {
   state_->depthLinear.bind();
   state_->depthLinearizeShader
       .setClipInfo(
           buildClipInfo(projection, state_->hbaoUniformData.projOrtho == 1))
+      .setInputOffset(inputOffset)
       .bindInputTexture(depthStencilInput)
       .draw(state_->triangle);
-}
-
-void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
-  constexpr Mn::Float meters2viewspace = 1.0f;
 
-  state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{1}).bind();
-  // Only special blur
-  HbaoBlurShader& shader =
-      state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
-          ? state_->hbaoSpecialBlurShaderFirstPass
-          : state_->bilateralBlurShader;
-  shader.setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
-      .setInverseResolutionDirection(
-          {1.0f / state_->configuration.size().x(), 0.0f})
-      .bindSourceTexture(state_->hbaoResult);
-  if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
-    shader.bindLinearDepthTexture(state_->sceneDepthLinear);
+  /* The AO at a reduced resolution is calculated from a downsampled copy of
+     the full-resolution linear depth, which is kept for the upsampling */
+  if (state_->configuration.resolutionDivisor() != 1) {
+    Mn::GL::AbstractFramebuffer::blit(
+        state_->depthLinear, state_->depthLinearReduced,
+        {{}, state_->configuration.size()}, {{}, state_->aoSize},
+        Mn::GL::FramebufferBlit::Color, Mn::GL::FramebufferBlitFilter::Nearest);
   }
-  shader.draw(state_->triangle);
+}
 
-  output.bind();
+namespace {
+
+/* Multiply the output with the AO */
+void setupOutputBlending() {
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
   Mn::GL::Renderer::setBlendFunction(
@@ -881,28 +1002,112 @@ void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
       Mn::GL::Renderer::BlendFunction::Zero,
       Mn::GL::Renderer::BlendFunction::One);
   // TODO multi samples masking
+}
 
-  // Only special blur
-  HbaoBlurShader& secondShader =
-      state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
-          ? state_->hbaoSpecialBlurShader2ndPass
-          : state_->bilateralBlurShader;
-  secondShader
-      .setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
-      .setInverseResolutionDirection(
-          {0.0f, 1.0f / state_->configuration.size().y()})
-      .bindSourceTexture(state_->hbaoBlur);
-  if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
-    secondShader.bindLinearDepthTexture(state_->sceneDepthLinear);
+}  // namespace
+
+void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
+  constexpr Mn::Float meters2viewspace = 1.0f;
+  const bool upsample = state_->configuration.resolutionDivisor() != 1;
+
+  if (!(state_->configuration.flags() & HbaoFlag::NoBlur)) {
+    state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{1})
+        .bind();
+    // Only special blur
+    HbaoBlurShader& shader =
+        state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
+            ? state_->hbaoSpecialBlurShaderFirstPass
+            : state_->bilateralBlurShader;
+    shader
+        .setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
+        .setInverseResolutionDirection({1.0f / state_->aoSize.x(), 0.0f})
+        .bindSourceTexture(state_->hbaoResult);
+    if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
+      shader.bindLinearDepthTexture(state_->aoDepthLinear());
+    }
+    shader.draw(state_->triangle);
+
+    /* At a reduced resolution the second pass goes back to hbaoResult, which
+       then gets upsampled to the output below */
+    if (upsample) {
+      state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0})
+          .bind();
+    } else {
+      output.bind();
+      setupOutputBlending();
+    }
+
+    // Only special blur
+    HbaoBlurShader& secondShader =
+        state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
+            ? state_->hbaoSpecialBlurShader2ndPass
+            : state_->bilateralBlurShader;
+    secondShader
+        .setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
+        .setInverseResolutionDirection({0.0f, 1.0f / state_->aoSize.y()})
+        .bindSourceTexture(state_->hbaoBlur);
+    if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
+      secondShader.bindLinearDepthTexture(state_->aoDepthLinear());
+    }
+
+    secondShader.draw(state_->triangle);
   }
 
-  secondShader.draw(state_->triangle);
+  if (!upsample) {
+    return;
+  }
+
+  /* Depth-aware upsampling of the reduced-resolution AO, guided by the
+     full-resolution linear depth */
+  output.bind();
+  setupOutputBlending();
+  state_->upsampleShader
+      .setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
+      .bindSourceTexture(state_->hbaoResult)
+      .bindReducedLinearDepthTexture(state_->sceneDepthLinearReduced)
+      .bindLinearDepthTexture(state_->sceneDepthLinear)
+      .draw(state_->triangle);
 }
 
 void Hbao::drawEffect(const Mn::Matrix4& projection,
                       HbaoType algType,
                       Mn::GL::Texture2D& depthStencilInput,
                       Mn::GL::AbstractFramebuffer& output) {
+  drawEffectInternal(projection, algType, depthStencilInput, {}, output);
+}
+
+void Hbao::drawEffect(
+    const Cr::Containers::ArrayView<const Mn::Matrix4> projections,
+    const Mn::Vector2i& tileCount,
+    HbaoType algType,
+    Mn::GL::Texture2D& depthStencilInput,
+    Mn::GL::AbstractFramebuffer& output) {
+  CORRADE_ASSERT(projections.size() == std::size_t(tileCount.product()),
+                 "Hbao::drawEffect(): expected" << tileCount.product()
+                     << "projections but got" << projections.size(), );
+
+  /* The intermediate buffers are all tile-sized and get reused for every
+     tile, so the sampling never crosses to a neighboring tile. Only the
+     input and output are addressed with the tile offset. */
+  const Mn::Vector2i tileSize = state_->configuration.size();
+  const Mn::Range2Di previousViewport = output.viewport();
+  for (Mn::Int y = 0; y != tileCount.y(); ++y) {
+    for (Mn::Int x = 0; x != tileCount.x(); ++x) {
+      const Mn::Range2Di tile =
+          Mn::Range2Di::fromSize(Mn::Vector2i{x, y} * tileSize, tileSize);
+      output.setViewport(tile);
+      drawEffectInternal(projections[y * tileCount.x() + x], algType,
+                         depthStencilInput, tile.min(), output);
+    }
+  }
+  output.setViewport(previousViewport);
+}
+
+void Hbao::drawEffectInternal(const Mn::Matrix4& projection,
+                              HbaoType algType,
+                              Mn::GL::Texture2D& depthStencilInput,
+                              const Mn::Vector2i& inputOffset,
+                              Mn::GL::AbstractFramebuffer& output) {
   if (projection[3][3] != 0) {
     // Orthographic rendering
     state_->hbaoUniformData.projInfo = {
@@ -924,18 +1129,23 @@ void Hbao::drawEffect(const Mn::Matrix4& projection,
   }
 
   // TODO much of this data mapping does not need to be redone every frame
-  prepareHbaoData(state_->configuration, projection, state_->hbaoUniformData,
+  prepareHbaoData(state_->configuration, state_->aoSize, projection,
+                  state_->hbaoUniformData,
                   state_->hbaoUniform, state_->random);
-  drawLinearDepth(projection, depthStencilInput);
+  drawLinearDepth(projection, depthStencilInput, inputOffset);
   if (algType == HbaoType::CacheAware) {
     drawCacheAwareInternal(output);
   } else {
     drawClassicInternal(output);
   }
-}  // Hbao::draw
+}  // Hbao::drawEffectInternal
 
 void Hbao::drawClassicInternal(Mn::GL::AbstractFramebuffer& output) {
-  if (state_->configuration.flags() & HbaoFlag::NoBlur) {
+  /* Without blur the output is written directly, unless the AO needs to be
+     upsampled first */
+  const bool direct = state_->configuration.flags() & HbaoFlag::NoBlur &&
+                      state_->configuration.resolutionDivisor() == 1;
+  if (direct) {
     output.bind();
     Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
@@ -954,12 +1164,12 @@ void Hbao::drawClassicInternal(Mn::GL::AbstractFramebuffer& output) {
       state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
           ? state_->hbaoCalcSpecialBlurShader
           : state_->hbaoCalcShader;
-  shader.bindLinearDepthTexture(state_->sceneDepthLinear)
+  shader.bindLinearDepthTexture(state_->aoDepthLinear())
       .bindRandomTexture(state_->hbaoRandom, 0)
       .bindUniformBuffer(state_->hbaoUniform)
       .draw(state_->triangle);
 
-  if (!(state_->configuration.flags() & HbaoFlag::NoBlur)) {
+  if (!direct) {
     drawHbaoBlur(output);
   }
 
@@ -974,12 +1184,12 @@ void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
   state_->viewNormalShader.setProjectionInfo(state_->hbaoUniformData.projInfo)
       .setProjectionOrthographic(state_->hbaoUniformData.projOrtho)
       .setInverseFullResolution(state_->hbaoUniformData.invFullResolution)
-      .bindLinearDepthTexture(state_->sceneDepthLinear)
+      .bindLinearDepthTexture(state_->aoDepthLinear())
       .draw(state_->triangle);
 
   state_->hbao2Deinterleave.bind();
   state_->hbao2DeinterleaveShader.bindLinearDepthTexture(
-      state_->sceneDepthLinear);
+      state_->aoDepthLinear());
 
   for (Mn::Int i = 0; i < HbaoRandomNumElements; i += FragmentOutputCount) {
     for (Mn::UnsignedInt layer = 0; layer != FragmentOutputCount; ++layer) {
@@ -1047,7 +1257,11 @@ void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
   }
 #endif
 
-  if (state_->configuration.flags() & HbaoFlag::NoBlur) {
+  /* Without blur the output is written directly, unless the AO needs to be
+     upsampled first */
+  const bool direct = state_->configuration.flags() & HbaoFlag::NoBlur &&
+                      state_->configuration.resolutionDivisor() == 1;
+  if (direct) {
     output.bind();
     Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
@@ -1068,10 +1282,13 @@ void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
           ? state_->hbao2ReinterleaveSpecialBlurShader
           : state_->hbao2ReinterleaveShader;
 
-  reinterleaveShader.bindResultsTexture(state_->hbao2ResultArray)
+  /* When written directly, the output may be just a tile of it */
+  reinterleaveShader
+      .setOutputOffset(direct ? output.viewport().min() : Mn::Vector2i{})
+      .bindResultsTexture(state_->hbao2ResultArray)
       .draw(state_->triangle);
 
-  if (!(state_->configuration.flags() & HbaoFlag::NoBlur)) {
+  if (!direct) {
     drawHbaoBlur(output);
   }
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
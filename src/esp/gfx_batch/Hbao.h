@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_BATCH_HBAO_H_
 #define ESP_GFX_BATCH_HBAO_H_
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/GL.h>
 #include <Magnum/Magnum.h>
@@ -73,6 +74,17 @@ class HbaoConfiguration {
     return *this;
   }
 
+  Magnum::Int resolutionDivisor() const { return resolutionDivisor_; }
+
+  // Compute the AO at 1/2 or 1/4 of size() in each direction and upsample it
+  // to the output with the full-resolution depth as a guide, so it doesn't
+  // bleed over depth discontinuities. 1, the default, computes the AO at full
+  // resolution.
+  HbaoConfiguration& setResolutionDivisor(Magnum::Int divisor) {
+    resolutionDivisor_ = divisor;
+    return *this;
+  }
+
   Magnum::Int samples() const { return samples_; }
 
   HbaoConfiguration& setSamples(Magnum::Int samples) {
@@ -127,6 +139,7 @@ class HbaoConfiguration {
  private:
   Magnum::Vector2i size_;
   HbaoFlags flags_{};
+  Magnum::Int resolutionDivisor_ = 1;
   Magnum::Int samples_ = 1;
   Magnum::Float intensity_ = 0.732f, bias_ = 0.05f, radius_ = 1.84f,
                 blurSharpness_ = 10.0f;
@@ -167,6 +180,29 @@ class Hbao {
                   Magnum::GL::Texture2D& inputDepthStencil,
                   Magnum::GL::AbstractFramebuffer& output);
 
+  /**
+   * @brief Draw the HBAO effect on top of all tiles of a framebuffer.
+   * @param projections Projection matrix of each tile, in the same order as
+   * the scenes of @ref Renderer, i.e. row by row from the bottom left. The
+   * size is expected to be the product of @p tileCount.
+   * @param tileCount Count of tiles in each direction.
+   * @param algType Either the classic algorithm or the cache-aware algorithm
+   * @param inputDepthStencil Depth texture spanning all tiles, such as the
+   * depth output of @ref Renderer.
+   * @param output Framebuffer spanning all tiles the effect is to be written
+   * to. Its viewport is restored after.
+   *
+   * The size passed to @ref HbaoConfiguration::setSize() is expected to be
+   * the size of a single tile. Each tile uses its own projection and samples
+   * only from its own area.
+   */
+  void drawEffect(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> projections,
+      const Magnum::Vector2i& tileCount,
+      HbaoType algType,
+      Magnum::GL::Texture2D& inputDepthStencil,
+      Magnum::GL::AbstractFramebuffer& output);
+
   /**
    * @brief Retrieve the size of the framebuffer used to build the components of
    * the HBAO algorithms.
@@ -174,8 +210,14 @@ class Hbao {
   Magnum::Vector2i getFrameBufferSize() const;
 
  private:
+  void drawEffectInternal(const Magnum::Matrix4& projection,
+                          HbaoType algType,
+                          Magnum::GL::Texture2D& inputDepthStencil,
+                          const Magnum::Vector2i& inputOffset,
+                          Magnum::GL::AbstractFramebuffer& output);
   void drawLinearDepth(const Magnum::Matrix4& projection,
-                       Magnum::GL::Texture2D& inputDepthStencil);
+                       Magnum::GL::Texture2D& inputDepthStencil,
+                       const Magnum::Vector2i& inputOffset);
   void drawHbaoBlur(Magnum::GL::AbstractFramebuffer& output);
   void drawClassicInternal(Magnum::GL::AbstractFramebuffer& output);
   void drawCacheAwareInternal(Magnum::GL::AbstractFramebuffer& output);
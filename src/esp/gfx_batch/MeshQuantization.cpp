@@ -0,0 +1,187 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshQuantization.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Packing.h>
+#include <utility>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx_batch {
+
+namespace {
+
+/* Format a vertex attribute is quantized to, the original format if it's
+   kept */
+Mn::VertexFormat quantizedFormat(const Mn::Trade::MeshData& mesh,
+                                 const Mn::UnsignedInt id) {
+  const Mn::VertexFormat format = mesh.attributeFormat(id);
+  if (mesh.attributeArraySize(id))
+    return format;
+
+  switch (mesh.attributeName(id)) {
+    case Mn::Trade::MeshAttribute::Position:
+    case Mn::Trade::MeshAttribute::Normal:
+    case Mn::Trade::MeshAttribute::Bitangent:
+      if (format == Mn::VertexFormat::Vector3)
+        return Mn::VertexFormat::Vector3sNormalized;
+      break;
+    case Mn::Trade::MeshAttribute::Tangent:
+      if (format == Mn::VertexFormat::Vector3)
+        return Mn::VertexFormat::Vector3sNormalized;
+      if (format == Mn::VertexFormat::Vector4)
+        return Mn::VertexFormat::Vector4sNormalized;
+      break;
+    case Mn::Trade::MeshAttribute::TextureCoordinates:
+      if (format == Mn::VertexFormat::Vector2) {
+        /* NaNs fail both comparisons and keep the coordinates as floats */
+        const std::pair<Mn::Vector2, Mn::Vector2> range =
+            Mn::Math::minmax(mesh.attribute<Mn::Vector2>(id));
+        if (range.first.min() >= 0.0f && range.second.max() <= 1.0f)
+          return Mn::VertexFormat::Vector2usNormalized;
+        if (range.first.min() >= -1.0f && range.second.max() <= 1.0f)
+          return Mn::VertexFormat::Vector2sNormalized;
+      }
+      break;
+    default:
+      break;
+  }
+  return format;
+}
+
+template <class T, class U>
+void packAttribute(const Cr::Containers::StridedArrayView1D<const U>& src,
+                   const Cr::Containers::StridedArrayView1D<T>& dst,
+                   const U& offset,
+                   const Mn::Float scale,
+                   const Mn::Float min) {
+  for (std::size_t i = 0; i != src.size(); ++i)
+    dst[i] = Mn::Math::pack<T>(
+        Mn::Math::clamp((src[i] - offset) * scale, min, 1.0f));
+}
+
+bool usesImplementationSpecificFormats(const Mn::Trade::MeshData& mesh) {
+  if (mesh.isIndexed() &&
+      Mn::isMeshIndexTypeImplementationSpecific(mesh.indexType()))
+    return true;
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+    if (Mn::isVertexFormatImplementationSpecific(mesh.attributeFormat(i)))
+      return true;
+  return false;
+}
+
+}  // namespace
+
+Mn::Trade::MeshData quantizeMesh(Mn::Trade::MeshData&& mesh,
+                                 Mn::Matrix4& dequantization) {
+  dequantization = Mn::Matrix4{};
+  if (!mesh.vertexCount() || usesImplementationSpecificFormats(mesh) ||
+      mesh.attributeCount(Mn::Trade::MeshAttribute::Position) != 1 ||
+      mesh.attributeFormat(Mn::Trade::MeshAttribute::Position) !=
+          Mn::VertexFormat::Vector3 ||
+      mesh.hasAttribute(Mn::Trade::MeshAttribute::JointIds))
+    return std::move(mesh);
+
+  /* Positions relative to the bounding box center, uniformly scaled into the
+     [-1, 1] cube */
+  const std::pair<Mn::Vector3, Mn::Vector3> bounds = Mn::Math::minmax(
+      mesh.attribute<Mn::Vector3>(Mn::Trade::MeshAttribute::Position));
+  const Mn::Vector3 center = (bounds.first + bounds.second) * 0.5f;
+  Mn::Float scale = ((bounds.second - bounds.first) * 0.5f).max();
+  if (scale == 0.0f)
+    scale = 1.0f;
+  dequantization = Mn::Matrix4::translation(center) *
+                   Mn::Matrix4::scaling(Mn::Vector3{scale});
+
+  /* Interleaved layout with every attribute aligned to four bytes */
+  const Mn::UnsignedInt vertexCount = mesh.vertexCount();
+  const Mn::UnsignedInt attributeCount = mesh.attributeCount();
+  Cr::Containers::Array<Mn::VertexFormat> formats{Cr::NoInit, attributeCount};
+  Cr::Containers::Array<std::size_t> offsets{Cr::NoInit, attributeCount};
+  std::size_t stride = 0;
+  for (Mn::UnsignedInt i = 0; i != attributeCount; ++i) {
+    formats[i] = quantizedFormat(mesh, i);
+    offsets[i] = stride;
+    const std::size_t size =
+        Mn::vertexFormatSize(formats[i]) *
+        Mn::Math::max(Mn::UnsignedInt(mesh.attributeArraySize(i)), 1u);
+    stride += (size + 3) & ~std::size_t{3};
+  }
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributeData{
+      attributeCount};
+  for (Mn::UnsignedInt i = 0; i != attributeCount; ++i)
+    attributeData[i] = Mn::Trade::MeshAttributeData{
+        mesh.attributeName(i), formats[i], offsets[i], vertexCount,
+        std::ptrdiff_t(stride), mesh.attributeArraySize(i)};
+
+  /* The index view may not span the whole index data, copy just the
+     indices */
+  Cr::Containers::Array<char> indexData;
+  Mn::Trade::MeshIndexData indexView;
+  if (mesh.isIndexed()) {
+    const Cr::Containers::StridedArrayView2D<const char> indices =
+        mesh.indices();
+    indexData = Cr::Containers::Array<char>{
+        Cr::NoInit, indices.size()[0] * indices.size()[1]};
+    Cr::Utility::copy(indices, Cr::Containers::StridedArrayView2D<char>{
+                                   indexData, indices.size()});
+    indexView = Mn::Trade::MeshIndexData{mesh.indexType(), indexData};
+  }
+
+  Mn::Trade::MeshData quantized{
+      mesh.primitive(),
+      std::move(indexData),
+      indexView,
+      Cr::Containers::Array<char>{Cr::ValueInit, stride * vertexCount},
+      std::move(attributeData),
+      vertexCount};
+  for (Mn::UnsignedInt i = 0; i != attributeCount; ++i) {
+    if (formats[i] == mesh.attributeFormat(i)) {
+      Cr::Utility::copy(mesh.attribute(i), quantized.mutableAttribute(i));
+      continue;
+    }
+
+    switch (formats[i]) {
+      case Mn::VertexFormat::Vector3sNormalized:
+        if (mesh.attributeName(i) == Mn::Trade::MeshAttribute::Position)
+          packAttribute(mesh.attribute<Mn::Vector3>(i),
+                        quantized.mutableAttribute<Mn::Vector3s>(i), center,
+                        1.0f / scale, -1.0f);
+        else
+          packAttribute(mesh.attribute<Mn::Vector3>(i),
+                        quantized.mutableAttribute<Mn::Vector3s>(i),
+                        Mn::Vector3{}, 1.0f, -1.0f);
+        break;
+      case Mn::VertexFormat::Vector4sNormalized:
+        packAttribute(mesh.attribute<Mn::Vector4>(i),
+                      quantized.mutableAttribute<Mn::Vector4s>(i),
+                      Mn::Vector4{}, 1.0f, -1.0f);
+        break;
+      case Mn::VertexFormat::Vector2usNormalized:
+        packAttribute(mesh.attribute<Mn::Vector2>(i),
+                      quantized.mutableAttribute<Mn::Vector2us>(i),
+                      Mn::Vector2{}, 1.0f, 0.0f);
+        break;
+      case Mn::VertexFormat::Vector2sNormalized:
+        packAttribute(mesh.attribute<Mn::Vector2>(i),
+                      quantized.mutableAttribute<Mn::Vector2s>(i),
+                      Mn::Vector2{}, 1.0f, -1.0f);
+        break;
+      default:
+        CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    }
+  }
+  return quantized;
+}
+
+}  // namespace gfx_batch
+}  // namespace esp
@@ -0,0 +1,42 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_BATCH_MESHQUANTIZATION_H_
+#define ESP_GFX_BATCH_MESHQUANTIZATION_H_
+
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace esp {
+namespace gfx_batch {
+
+/**
+@brief Pack vertex attributes of a mesh into 16-bit formats for rendering
+@param mesh                 Mesh to quantize
+@param[out] dequantization  Transformation restoring the original positions
+    from the quantized ones, to be applied before the mesh's own
+    transformation
+
+Positions are stored as @ref Magnum::VertexFormat::Vector3sNormalized relative
+to the center of the mesh bounding box, divided by its largest half-extent.
+The scale is the same along all axes, so @p dequantization doesn't change the
+normal matrix. Normals, tangents and bitangents become signed normalized 16-bit
+vectors and texture coordinates unsigned or signed normalized 16-bit vectors
+if all of them are in the @f$ [0, 1] @f$ or @f$ [-1, 1] @f$ range,
+respectively. Shaders read these formats natively, there's nothing to decode.
+Attributes that aren't 32-bit float vectors are copied unchanged, every
+attribute is aligned to four bytes and indices are kept as they are.
+
+Skinned meshes, meshes without exactly one position attribute in
+@ref Magnum::VertexFormat::Vector3 or with implementation-specific formats are
+returned unchanged, with @p dequantization set to identity. Used by
+@ref RendererFlag::QuantizeVertices.
+*/
+Magnum::Trade::MeshData quantizeMesh(Magnum::Trade::MeshData&& mesh,
+                                     Magnum::Matrix4& dequantization);
+
+}  // namespace gfx_batch
+}  // namespace esp
+
+#endif  // ESP_GFX_BATCH_MESHQUANTIZATION_H_
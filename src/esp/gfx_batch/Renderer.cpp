@@ -25,7 +25,11 @@
 #include <Magnum/GL/TextureArray.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Mesh.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/RemoveDuplicates.h>
@@ -41,8 +45,12 @@
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/PhongMaterialData.h>
 #include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/SkinData.h>
 #include <Magnum/Trade/TextureData.h>
 #include <esp/gfx_batch/DepthUnprojection.h>
+#include <esp/gfx_batch/GpuTimer.h>
+#include <esp/gfx_batch/MeshQuantization.h>
+#include <algorithm>
 #include <unordered_map>
 
 namespace Cr = Corrade;
@@ -59,18 +67,38 @@ struct RendererConfiguration::State {
   RendererFlags flags;
   Mn::Vector2i tileSize{128, 128};
   Mn::Vector2i tileCount{1, 1};
+  Mn::UnsignedInt viewCount{1};
   Mn::UnsignedInt maxLightCount{0};
+  Mn::UnsignedInt maxJointCount{0};
   Mn::Float ambientFactor{0.1f};
+  std::size_t gpuMemoryBudget{0};
 };
 
 RendererConfiguration::RendererConfiguration() : state{Cr::InPlaceInit} {}
+RendererConfiguration::RendererConfiguration(
+    const RendererConfiguration& other)
+    : state{Cr::InPlaceInit, *other.state} {}
+RendererConfiguration::RendererConfiguration(
+    RendererConfiguration&&) noexcept = default;
 RendererConfiguration::~RendererConfiguration() = default;
+RendererConfiguration& RendererConfiguration::operator=(
+    const RendererConfiguration& other) {
+  *state = *other.state;
+  return *this;
+}
+RendererConfiguration& RendererConfiguration::operator=(
+    RendererConfiguration&&) noexcept = default;
 
 RendererConfiguration& RendererConfiguration::setFlags(RendererFlags flags) {
   state->flags = flags;
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::addFlags(RendererFlags flags) {
+  state->flags |= flags;
+  return *this;
+}
+
 RendererConfiguration& RendererConfiguration::setTileSizeCount(
     const Mn::Vector2i& tileSize,
     const Mn::Vector2i& tileCount) {
@@ -79,18 +107,40 @@ RendererConfiguration& RendererConfiguration::setTileSizeCount(
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::setViewCount(
+    Mn::UnsignedInt count) {
+  CORRADE_ASSERT(count,
+                 "RendererConfiguration::setViewCount(): expected a non-zero "
+                 "count",
+                 *this);
+  state->viewCount = count;
+  return *this;
+}
+
 RendererConfiguration& RendererConfiguration::setMaxLightCount(
     Mn::UnsignedInt count) {
   state->maxLightCount = count;
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::setMaxJointCount(
+    Mn::UnsignedInt count) {
+  state->maxJointCount = count;
+  return *this;
+}
+
 RendererConfiguration& RendererConfiguration::setAmbientFactor(
     Mn::Float factor) {
   state->ambientFactor = factor;
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::setGpuMemoryBudget(
+    std::size_t bytes) {
+  state->gpuMemoryBudget = bytes;
+  return *this;
+}
+
 namespace {
 
 struct MeshView {
@@ -98,11 +148,26 @@ struct MeshView {
   Mn::UnsignedInt indexOffsetInBytes;
   Mn::UnsignedInt indexCount;
   Mn::Int materialId; /* is never -1 tho */
+  Mn::Int skinId; /* -1 if not skinned */
   // TODO also parent, when we are able to fetch the whole hierarchy for a
   //  particular root object name instead of having the hierarchy flattened
   Mn::Matrix4 transformation;
 };
 
+/* Joints of a skin, referenced by name from Renderer::jointId() */
+struct Skin {
+  Cr::Containers::Array<Cr::Containers::String> jointNames;
+  Cr::Containers::Array<Mn::Matrix4> inverseBindMatrices;
+};
+
+/* Skinned node hierarchy added to a scene. Its joint transformations and
+   joint matrices start at jointOffset. */
+struct SkinInstance {
+  std::size_t node;
+  Mn::UnsignedInt skinId;
+  Mn::UnsignedInt jointOffset;
+};
+
 struct Light {
   std::size_t node;
   RendererLightType type;
@@ -151,17 +216,41 @@ Mn::UnsignedInt drawBatchId(
   return drawBatches.size() - 1;
 }
 
-struct Scene {
-  /* Camera unprojection. Updated from updateCamera(). */
-  Mn::Vector2 cameraUnprojection;
+/* Lower level of detail of a node hierarchy, used when the projected size of
+   the hierarchy is below screenSize */
+struct Lod {
+  Mn::UnsignedInt meshViewBegin, meshViewEnd;
+  Mn::Float screenSize;
+};
+
+/* Node hierarchy with levels of detail added to a scene. All levels have
+   their draws added, the unselected ones are submitted with zero index
+   count. */
+struct LodInstance {
+  std::size_t node;
+  /* Bounds of the full-detail level relative to the node */
+  Mn::Range3D bounds;
+  /* Copied from Lod, level 0 isn't included */
+  Cr::Containers::Array<Mn::Float> screenSizes;
+  Mn::UnsignedInt selectedLevel;
+};
 
+struct Scene {
   /* Node parents and transformations. Appended to with add(). Some of these
      (but not all) are referenced from the transformationIds array below. */
   Cr::Containers::Array<Mn::Int> parents; /* parents[i] < i, always */
   Cr::Containers::Array<Mn::Matrix4> transformations;
+  /* Object IDs of all nodes, draws use the ID of their top-level node */
+  Cr::Containers::Array<Mn::UnsignedInt> objectIds;
   /* Lights, with node IDs referencing transformations from above */
   Cr::Containers::Array<Light> lights;
 
+  /* Skinned hierarchies, their joint transformations relative to the
+     top-level node and joint matrices calculated from them in draw() */
+  Cr::Containers::Array<SkinInstance> skinInstances;
+  Cr::Containers::Array<Mn::Matrix4> jointTransformations;
+  Cr::Containers::Array<Mn::Shaders::TransformationUniform3D> jointMatrices;
+
   /* Draw batches, each being a unique combination of a mesh and a texture,
      thus requiring a dedicated draw call. See also drawBatchId(). */
   // TODO might make sense to order this (by shader,) by mesh, then by texture
@@ -188,6 +277,27 @@ struct Scene {
   Cr::Containers::Array<Mn::UnsignedInt> drawBatchOffsets;
   Cr::Containers::Array<DrawCommand> drawCommandsSorted;
 
+  /* With RendererFlag::FrustumCulling, mesh-local bounds of each draw in the
+     order of add() and sorted the same way as drawCommandsSorted. The culled
+     copy of drawCommandsSorted has zero index counts for draws outside of
+     the frustum, which keeps the draw offsets of the remaining draws intact.
+     Updated in draw(). */
+  Cr::Containers::Array<Mn::Range3D> drawBounds;
+  Cr::Containers::Array<Mn::Range3D> drawBoundsSorted;
+  Cr::Containers::Array<DrawCommand> drawCommandsCulled;
+  std::size_t culledDrawCount = 0;
+
+  /* Hierarchies with levels of detail, and the instance and level of each
+     draw in the order of add() and sorted. Draws without levels of detail
+     have the instance set to -1. If there are any instances, draw() uses
+     drawCommandsCulled also without RendererFlag::FrustumCulling. */
+  Cr::Containers::Array<LodInstance> lodInstances;
+  Cr::Containers::Array<Cr::Containers::Pair<Mn::Int, Mn::UnsignedInt>>
+      drawLods;
+  Cr::Containers::Array<Cr::Containers::Pair<Mn::Int, Mn::UnsignedInt>>
+      drawLodsSorted;
+  std::size_t inactiveLodDrawCount = 0;
+
   /* Updated every frame */
   // TODO make these two global, uploaded just once (plus accounting for
   //  padding)
@@ -198,6 +308,7 @@ struct Scene {
   bool dirty = false;
   Mn::GL::Buffer drawUniform;
   Mn::GL::Buffer textureTransformationUniform;
+  Mn::GL::Buffer jointUniform;
 };
 
 struct TextureTransformation {
@@ -206,18 +317,294 @@ struct TextureTransformation {
   Mn::Matrix3 transformation;
 };
 
+/* Axis-aligned box containing a transformed box, given by its center and
+   half-size. The half-size is projected onto the transformed axes. */
+Cr::Containers::Pair<Mn::Vector3, Mn::Vector3> transformBox(
+    const Mn::Matrix4& transformation,
+    const Mn::Range3D& box) {
+  const Mn::Vector3 localHalfSize = box.size() * 0.5f;
+  Mn::Vector3 halfSize;
+  for (std::size_t i = 0; i != 3; ++i)
+    halfSize += Mn::Math::abs(transformation[i].xyz()) * localHalfSize[i];
+  return {transformation.transformPoint(box.center()), halfSize};
+}
+
+/* Whether a box given by its center and half-size is fully outside of any
+   frustum plane */
+bool isOutsideFrustum(const Mn::Vector3& center,
+                      const Mn::Vector3& halfSize,
+                      const Mn::Frustum& frustum) {
+  for (std::size_t i = 0; i != 6; ++i) {
+    const Mn::Vector4& plane = frustum[i];
+    if (Mn::Math::dot(center, plane.xyz()) +
+            Mn::Math::dot(halfSize, Mn::Math::abs(plane.xyz())) <
+        -plane.w())
+      return true;
+  }
+  return false;
+}
+
 /* NVidia requires uniform buffer bindings to have an INSANE 256-byte
    alignment, so we give in and pad our stuff */
 struct ProjectionPadded : Mn::Shaders::ProjectionUniform3D {
   char padding[256 - sizeof(Mn::Shaders::ProjectionUniform3D)];
 };
 
+/* Where a texture or a mesh came from and whether it's currently on the GPU.
+   Used to evict unused data under a memory budget and stream them back in
+   once needed again. */
+struct Residency {
+  /* Index into the files array, or ~0 for builtin data that never get
+     evicted */
+  Mn::UnsignedInt fileId;
+  /* Texture or mesh ID in the file */
+  Mn::UnsignedInt importId;
+  /* Estimated GPU memory size in bytes */
+  std::size_t size;
+  /* Value of the frame counter when it was last drawn or added */
+  std::size_t lastUsedFrame;
+  bool resident;
+};
+
+struct FileSource {
+  Cr::Containers::String filename;
+  Cr::Containers::String importerPlugin;
+  RendererFileFlags flags;
+};
+
+constexpr Mn::UnsignedInt BuiltinFileId = ~Mn::UnsignedInt{};
+
+/* Sets up importer options needed for composite files. Used by addFile() and
+   to stream evicted data back in. */
+void setupImporter(
+    Cr::PluginManager::Manager<Mn::Trade::AbstractImporter>& manager,
+    Mn::Trade::AbstractImporter& importer,
+    const Cr::Containers::StringView filename,
+    const Cr::Containers::StringView importerPlugin) {
+  /* Set up options for glTF import. We can also import any other files (such
+     as serialized magnum blobs or BPS files), assume these don't need any
+     custom setup. */
+  if (importerPlugin.contains("GltfImporter") ||
+      (importerPlugin.contains("AnySceneImporter") &&
+       (filename.contains(".gltf") || filename.contains(".glb")))) {
+    // TODO implement and use a singular
+    // ignoreRequiredExtension=MAGNUMX_mesh_views
+    //  that doesn't produce warnings
+    importer.configuration().setValue("ignoreRequiredExtensions", true);
+    importer.configuration().setValue("experimentalKhrTextureKtx", true);
+
+    /* Desired imported types for custom glTF scene fields. If the group
+       doesn't exist (which is the case for AnySceneImporter), add it first */
+    Cr::Utility::ConfigurationGroup* types =
+        importer.configuration().group("customSceneFieldTypes");
+    if (!types)
+      types = importer.configuration().addGroup("customSceneFieldTypes");
+    types->addValue("meshViewIndexOffset", "UnsignedInt");
+    types->addValue("meshViewIndexCount", "UnsignedInt");
+    types->addValue("meshViewMaterial", "Int");
+  }
+
+  /* Basis options. Don't want to bother with all platform variations right
+     now, so it's always ASTC, sorry. */
+  if (Cr::PluginManager::PluginMetadata* const metadata =
+          manager.metadata("BasisImporter")) {
+    metadata->configuration().setValue("format", "Astc4x4RGBA");
+  }
+}
+
+/* Imports a texture as a texture array, together with its estimated GPU
+   memory size. Used by addFile() and to stream evicted textures back in. */
+Cr::Containers::Optional<
+    Cr::Containers::Pair<Mn::GL::Texture2DArray, std::size_t>>
+importTexture(Mn::Trade::AbstractImporter& importer,
+              const Mn::UnsignedInt id,
+              const RendererFileFlags flags,
+              const Cr::Containers::StringView filename,
+              const char* const messagePrefix) {
+  const Cr::Containers::Optional<Mn::Trade::TextureData> textureData =
+      importer.texture(id);
+  if (!textureData) {
+    Mn::Error{} << messagePrefix << "can't import texture" << id << "of"
+                << filename;
+    return {};
+  }
+
+  /* 2D textures are imported as single-layer 2D array textures */
+  Mn::GL::Texture2DArray texture;
+  std::size_t size = 0;
+  if (textureData->type() == Mn::Trade::TextureType::Texture2DArray) {
+    const Mn::UnsignedInt levelCount =
+        importer.image3DLevelCount(textureData->image());
+    Cr::Containers::Optional<Mn::Trade::ImageData3D> image =
+        importer.image3D(textureData->image());
+    if (!image) {
+      Mn::Error{} << messagePrefix << "can't import 3D image"
+                  << textureData->image() << "of" << filename;
+      return {};
+    }
+
+    /* Generate a full mipmap if there's just one level and if the image is
+       not compressed. It's opt-in to force people to learn how to make
+       assets Vulkan-ready. */
+    const bool generateMipmap = levelCount == 1 &&
+                                (flags & RendererFileFlag::GenerateMipmap) &&
+                                !image->isCompressed();
+    const Mn::UnsignedInt desiredLevelCount =
+        generateMipmap ? Mn::Math::log2(image->size().xy().min()) + 1
+                       : levelCount;
+
+    texture
+        .setMinificationFilter(textureData->minificationFilter(),
+                               textureData->mipmapFilter())
+        .setMagnificationFilter(textureData->magnificationFilter())
+        .setWrapping(textureData->wrapping().xy());
+    size = image->data().size();
+    if (image->isCompressed()) {
+      texture
+          .setStorage(levelCount,
+                      Mn::GL::textureFormat(image->compressedFormat()),
+                      image->size())
+          .setCompressedSubImage(0, {}, *image);
+      for (Mn::UnsignedInt level = 1; level != levelCount; ++level) {
+        Cr::Containers::Optional<Mn::Trade::ImageData3D> levelImage =
+            importer.image3D(textureData->image(), level);
+        CORRADE_INTERNAL_ASSERT(levelImage && levelImage->isCompressed() &&
+                                levelImage->compressedFormat() ==
+                                    image->compressedFormat());
+        texture.setCompressedSubImage(level, {}, *levelImage);
+        size += levelImage->data().size();
+      }
+    } else {
+      texture
+          .setStorage(desiredLevelCount,
+                      Mn::GL::textureFormat(image->format()), image->size())
+          .setSubImage(0, {}, *image);
+      if (generateMipmap)
+        texture.generateMipmap();
+      /* A full mip chain adds roughly a third */
+      if (desiredLevelCount > 1)
+        size += size / 3;
+    }
+  } else if (textureData->type() == Mn::Trade::TextureType::Texture2D) {
+    const Mn::UnsignedInt levelCount =
+        importer.image2DLevelCount(textureData->image());
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+        importer.image2D(textureData->image());
+    if (!image) {
+      Mn::Error{} << messagePrefix << "can't import 2D image"
+                  << textureData->image() << "of" << filename;
+      return {};
+    }
+
+    /* Generate a full mipmap if there's just one level and if the image is
+       not compressed. It's opt-in to force people to learn how to make
+       assets Vulkan-ready. */
+    const bool generateMipmap = levelCount == 1 &&
+                                (flags & RendererFileFlag::GenerateMipmap) &&
+                                !image->isCompressed();
+    const Mn::UnsignedInt desiredLevelCount =
+        generateMipmap ? Mn::Math::log2(image->size().min()) + 1 : levelCount;
+
+    texture
+        .setMinificationFilter(textureData->minificationFilter(),
+                               textureData->mipmapFilter())
+        .setMagnificationFilter(textureData->magnificationFilter())
+        .setWrapping(textureData->wrapping().xy());
+    size = image->data().size();
+    if (image->isCompressed()) {
+      texture
+          .setStorage(levelCount,
+                      Mn::GL::textureFormat(image->compressedFormat()),
+                      {image->size(), 1})
+          .setCompressedSubImage(0, {}, Mn::CompressedImageView2D{*image});
+      for (Mn::UnsignedInt level = 1; level != levelCount; ++level) {
+        Cr::Containers::Optional<Mn::Trade::ImageData2D> levelImage =
+            importer.image2D(textureData->image(), level);
+        CORRADE_INTERNAL_ASSERT(levelImage && levelImage->isCompressed() &&
+                                levelImage->compressedFormat() ==
+                                    image->compressedFormat());
+        texture.setCompressedSubImage(level, {},
+                                      Mn::CompressedImageView2D{*levelImage});
+        size += levelImage->data().size();
+      }
+    } else {
+      texture
+          .setStorage(desiredLevelCount,
+                      Mn::GL::textureFormat(image->format()),
+                      {image->size(), 1})
+          .setSubImage(0, {}, Mn::ImageView2D{*image});
+      if (generateMipmap)
+        texture.generateMipmap();
+      /* A full mip chain adds roughly a third */
+      if (desiredLevelCount > 1)
+        size += size / 3;
+    }
+  } else
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+  return Cr::Containers::Pair<Mn::GL::Texture2DArray, std::size_t>{
+      std::move(texture), size};
+}
+
+/* Imports and compiles a mesh, together with shader flags it needs and its
+   GPU memory size. With quantize set, vertex attributes are packed and the
+   matrix restoring the original positions is written to dequantization,
+   otherwise it's set to identity. Used by addFile() and to stream evicted
+   meshes back in. */
+Cr::Containers::Optional<Cr::Containers::Triple<Mn::Shaders::PhongGL::Flags,
+                                                Mn::GL::Mesh,
+                                                std::size_t>>
+importMesh(Mn::Trade::AbstractImporter& importer,
+           const Mn::UnsignedInt id,
+           const Cr::Containers::StringView filename,
+           const char* const messagePrefix,
+           const bool quantize,
+           Mn::Matrix4& dequantization,
+           Cr::Containers::Optional<Mn::Trade::MeshData>* const meshData =
+               nullptr) {
+  Cr::Containers::Optional<Mn::Trade::MeshData> mesh = importer.mesh(id);
+  if (!mesh) {
+    Mn::Error{} << messagePrefix << "can't import mesh" << id << "of"
+                << filename;
+    return {};
+  }
+
+  /* Make the mesh indexed if it isn't */
+  if (!mesh->isIndexed())
+    mesh = Mn::MeshTools::removeDuplicates(*mesh);
+
+  dequantization = Mn::Matrix4{};
+  if (quantize)
+    mesh = quantizeMesh(*std::move(mesh), dequantization);
+
+  /* Decide what extra shader feature the mesh needs */
+  Mn::Shaders::PhongGL::Flags flags;
+  if (mesh->hasAttribute(Mn::Trade::MeshAttribute::Color))
+    flags |= Mn::Shaders::PhongGL::Flag::VertexColor;
+  /* Skinned meshes use shaders with a per-vertex joint count set at draw
+     time */
+  if (mesh->hasAttribute(Mn::Trade::MeshAttribute::JointIds))
+    flags |= Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount;
+
+  const std::size_t size = mesh->vertexData().size() + mesh->indexData().size();
+  Cr::Containers::Triple<Mn::Shaders::PhongGL::Flags, Mn::GL::Mesh,
+                         std::size_t>
+      out{flags, Mn::MeshTools::compile(*mesh), size};
+
+  /* Pass the CPU-side data out if the caller needs them for something */
+  if (meshData)
+    *meshData = std::move(mesh);
+  return out;
+}
+
 }  // namespace
 
 struct Renderer::State {
   RendererFlags flags;
   Mn::Vector2i tileSize, tileCount;
+  Mn::UnsignedInt viewCount;
   Mn::UnsignedInt maxLightCount;
+  Mn::UnsignedInt maxJointCount;
   Mn::Float ambientFactor;
   /* Indexed with Mn::Shaders::PhongGL::Flag, but I don't want to bother with
      writing a hash function for EnumSet */
@@ -232,6 +619,13 @@ struct Renderer::State {
   Cr::Containers::Array<
       Cr::Containers::Pair<Mn::Shaders::PhongGL::Flags, Mn::GL::Mesh>>
       meshes;
+  /* Primary and secondary per-vertex joint count of each mesh, zero for meshes
+     that aren't skinned */
+  Cr::Containers::Array<Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt>>
+      meshJointCounts;
+  /* Skins referenced from mesh views, populated only if maxJointCount is
+     non-zero */
+  Cr::Containers::Array<Skin> skins;
   // TODO clear this array once/if the materialUniform is populated on first
   //  draw() and adding more files is forbidden
   Cr::Containers::Array<Mn::Shaders::PhongMaterialUniform> materials;
@@ -239,10 +633,32 @@ struct Renderer::State {
      populate the draw list. */
   Cr::Containers::Array<TextureTransformation> materialTextureTransformations;
 
+  /* Parallel to the textures and meshes arrays, with evicted entries being
+     NoCreate'd. The files array references where to stream them in from. */
+  Cr::Containers::Array<Residency> textureResidency;
+  Cr::Containers::Array<Residency> meshResidency;
+  Cr::Containers::Array<FileSource> files;
+  std::size_t gpuMemoryBudget;
+  std::size_t residentSize = 0;
+  std::size_t streamedCount = 0;
+  std::size_t evictedCount = 0;
+  /* Incremented on every draw() */
+  std::size_t frame = 0;
+
+  /* Measures the scene draws in draw() if enabled */
+  bool gpuTimerEnabled = false;
+  GpuTimer gpuDrawTimer;
+
   /* Mesh views (mesh ID, index byte offset and count), material IDs and
      initial transformations for draws. Used by add() to populate the draw
      list. */
   Cr::Containers::Array<MeshView> meshViews;
+  /* Mesh-local bounds of each mesh view */
+  Cr::Containers::Array<Mn::Range3D> meshViewBounds;
+  /* Lower levels of detail for a particular name, ordered by decreasing
+     screen size. Added with addNodeHierarchyLod(). */
+  std::unordered_map<Cr::Containers::String, Cr::Containers::Array<Lod>>
+      lodsForName;
   /* Range of mesh views and materials corresponding to a particular name */
   std::unordered_map<Cr::Containers::String,
                      Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt>>
@@ -250,8 +666,12 @@ struct Renderer::State {
 
   /* Updated from addFile() */
   Mn::GL::Buffer materialUniform;
-  /* Combined view and projection matrices. Updated from updateCamera() */
+  /* Combined view and projection matrices, camera projections alone and
+     their depth unprojections, for each tile. Views of a scene are in
+     consecutive tiles. Updated from updateCamera() */
   Cr::Containers::Array<ProjectionPadded> cameraMatrices;
+  Cr::Containers::Array<Mn::Matrix4> cameraProjections;
+  Cr::Containers::Array<Mn::Vector2> cameraUnprojections;
   /* Updated from draw() every frame */
   Mn::GL::Buffer projectionUniform;
 
@@ -265,8 +685,137 @@ struct Renderer::State {
   Cr::Containers::Array<Mn::Shaders::TransformationUniform3D>
       absoluteTransformationsSorted;
   Cr::Containers::Array<Mn::Shaders::PhongLightUniform> absoluteLights;
+
+  void streamIn();
+  void evictUnused();
 };
 
+void Renderer::State::streamIn() {
+  /* Mark everything referenced by the scenes as used in this frame, collect
+     what got evicted before */
+  Cr::Containers::Array<Cr::Containers::Pair<Mn::UnsignedInt, bool>> missing;
+  for (const Scene& scene : scenes) {
+    for (const DrawBatch& drawBatch : scene.drawBatches) {
+      Residency& mesh = meshResidency[drawBatch.meshId];
+      if (mesh.lastUsedFrame != frame) {
+        mesh.lastUsedFrame = frame;
+        if (!mesh.resident)
+          arrayAppend(missing, Cr::InPlaceInit, drawBatch.meshId, false);
+      }
+      if (flags >= RendererFlag::NoTextures)
+        continue;
+      Residency& texture = textureResidency[drawBatch.textureId];
+      if (texture.lastUsedFrame != frame) {
+        texture.lastUsedFrame = frame;
+        if (!texture.resident)
+          arrayAppend(missing, Cr::InPlaceInit, drawBatch.textureId, true);
+      }
+    }
+  }
+  if (missing.isEmpty())
+    return;
+
+  /* Open each file just once. There's usually very few files. */
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+  std::unordered_map<Mn::UnsignedInt,
+                     Cr::Containers::Pointer<Mn::Trade::AbstractImporter>>
+      importers;
+  for (const Cr::Containers::Pair<Mn::UnsignedInt, bool>& item : missing) {
+    Residency& residency = item.second() ? textureResidency[item.first()]
+                                         : meshResidency[item.first()];
+    const FileSource& file = files[residency.fileId];
+    Cr::Containers::Pointer<Mn::Trade::AbstractImporter>& importer =
+        importers[residency.fileId];
+    if (!importer) {
+      importer = manager.loadAndInstantiate(file.importerPlugin);
+      CORRADE_INTERNAL_ASSERT(importer);
+      setupImporter(manager, *importer, file.filename, file.importerPlugin);
+      if (!importer->openFile(file.filename)) {
+        Mn::Error{} << "Renderer::draw(): can't reopen" << file.filename
+                    << "to stream evicted data back in";
+        continue;
+      }
+    } else if (!importer->isOpened())
+      continue;
+
+    /* The draw batches referencing data that failed to import get skipped in
+       draw() */
+    if (item.second()) {
+      Cr::Containers::Optional<
+          Cr::Containers::Pair<Mn::GL::Texture2DArray, std::size_t>>
+          texture = importTexture(*importer, residency.importId, file.flags,
+                                  file.filename, "Renderer::draw():");
+      if (!texture)
+        continue;
+      textures[item.first()] = std::move(texture->first());
+    } else {
+      /* Quantizing the same mesh again gives the same dequantization as in
+         addFile(), which is already in the mesh view transformations */
+      Mn::Matrix4 dequantization;
+      Cr::Containers::Optional<Cr::Containers::Triple<
+          Mn::Shaders::PhongGL::Flags, Mn::GL::Mesh, std::size_t>>
+          mesh = importMesh(*importer, residency.importId, file.filename,
+                            "Renderer::draw():",
+                            flags >= RendererFlag::QuantizeVertices,
+                            dequantization);
+      if (!mesh)
+        continue;
+      meshes[item.first()].second() = std::move(mesh->second());
+    }
+
+    residency.resident = true;
+    residentSize += residency.size;
+    ++streamedCount;
+  }
+}
+
+void Renderer::State::evictUnused() {
+  if (!gpuMemoryBudget || residentSize <= gpuMemoryBudget)
+    return;
+
+  /* Candidates are data not used in the current frame, least recently used
+     first. Data used in the current frame are never evicted, which means the
+     budget can be exceeded if the scenes reference more than fits. */
+  Cr::Containers::Array<Cr::Containers::Pair<Mn::UnsignedInt, bool>>
+      candidates;
+  for (Mn::UnsignedInt i = 0; i != textureResidency.size(); ++i) {
+    const Residency& residency = textureResidency[i];
+    if (residency.resident && residency.fileId != BuiltinFileId &&
+        residency.lastUsedFrame != frame)
+      arrayAppend(candidates, Cr::InPlaceInit, i, true);
+  }
+  for (Mn::UnsignedInt i = 0; i != meshResidency.size(); ++i) {
+    const Residency& residency = meshResidency[i];
+    if (residency.resident && residency.lastUsedFrame != frame)
+      arrayAppend(candidates, Cr::InPlaceInit, i, false);
+  }
+  const auto residencyOf =
+      [&](const Cr::Containers::Pair<Mn::UnsignedInt, bool>& item)
+      -> Residency& {
+    return item.second() ? textureResidency[item.first()]
+                         : meshResidency[item.first()];
+  };
+  std::sort(candidates.begin(), candidates.end(),
+            [&](const Cr::Containers::Pair<Mn::UnsignedInt, bool>& a,
+                const Cr::Containers::Pair<Mn::UnsignedInt, bool>& b) {
+              return residencyOf(a).lastUsedFrame <
+                     residencyOf(b).lastUsedFrame;
+            });
+
+  for (const Cr::Containers::Pair<Mn::UnsignedInt, bool>& item : candidates) {
+    if (residentSize <= gpuMemoryBudget)
+      break;
+    if (item.second())
+      textures[item.first()] = Mn::GL::Texture2DArray{Mn::NoCreate};
+    else
+      meshes[item.first()].second() = Mn::GL::Mesh{Mn::NoCreate};
+    Residency& residency = residencyOf(item);
+    residency.resident = false;
+    residentSize -= residency.size;
+    ++evictedCount;
+  }
+}
+
 Renderer::Renderer(Mn::NoCreateT) {}
 
 void Renderer::create(const RendererConfiguration& configurationWrapper) {
@@ -278,11 +827,21 @@ void Renderer::create(const RendererConfiguration& configurationWrapper) {
   state_->flags = configuration.flags;
   state_->tileSize = configuration.tileSize;
   state_->tileCount = configuration.tileCount;
+  state_->viewCount = configuration.viewCount;
   state_->maxLightCount = configuration.maxLightCount;
+  state_->maxJointCount = configuration.maxJointCount;
   state_->ambientFactor = configuration.ambientFactor;
-  const std::size_t sceneCount = configuration.tileCount.product();
-  state_->cameraMatrices = Cr::Containers::Array<ProjectionPadded>{sceneCount};
-  state_->scenes = Cr::Containers::Array<Scene>{sceneCount};
+  state_->gpuMemoryBudget = configuration.gpuMemoryBudget;
+  const std::size_t tileCount = configuration.tileCount.product();
+  CORRADE_ASSERT(tileCount % configuration.viewCount == 0,
+                 "Renderer: tile count" << configuration.tileCount
+                                        << "not divisible by"
+                                        << configuration.viewCount << "views", );
+  state_->cameraMatrices = Cr::Containers::Array<ProjectionPadded>{tileCount};
+  state_->cameraProjections = Cr::Containers::Array<Mn::Matrix4>{tileCount};
+  state_->cameraUnprojections = Cr::Containers::Array<Mn::Vector2>{tileCount};
+  state_->scenes =
+      Cr::Containers::Array<Scene>{tileCount / configuration.viewCount};
 
   /* Texture 0 is reserved as a white pixel */
   // TODO drop this altogether and use an untextured shader instead? since it's
@@ -297,6 +856,9 @@ void Renderer::create(const RendererConfiguration& configurationWrapper) {
           0, {},
           Mn::ImageView3D{
               Mn::PixelFormat::RGBA8Unorm, {1, 1, 1}, "\xff\xff\xff\xff"});
+  arrayAppend(state_->textureResidency, Cr::InPlaceInit, BuiltinFileId, 0u,
+              std::size_t{4}, std::size_t{0}, true);
+  state_->residentSize += 4;
 
   /* Material 0 is reserved as a white ambient with no texture */
   arrayAppend(state_->materials, Cr::InPlaceInit)
@@ -326,14 +888,45 @@ Mn::Vector2i Renderer::tileSize() const {
   return state_->tileSize;
 }
 
+Mn::UnsignedInt Renderer::viewCount() const {
+  return state_->viewCount;
+}
+
 std::size_t Renderer::sceneCount() const {
   return state_->scenes.size();
 }
 
+void Renderer::setTileSizeCount(const Mn::Vector2i& tileSize,
+                                const Mn::Vector2i& tileCount) {
+  CORRADE_ASSERT(tileCount.product() % state_->viewCount == 0,
+                 "Renderer::setTileSizeCount(): tile count"
+                     << tileCount << "not divisible by" << state_->viewCount
+                     << "views", );
+  state_->tileSize = tileSize;
+  state_->tileCount = tileCount;
+
+  /* Only the per-scene state is resized, existing scenes and their cameras
+     are kept. Data from addFile() is shared by all scenes and isn't touched.
+     New scenes get the same default camera as in create(). */
+  const std::size_t tileCountTotal = tileCount.product();
+  arrayResize(state_->scenes, tileCountTotal / state_->viewCount);
+  arrayResize(state_->cameraMatrices, Cr::DefaultInit, tileCountTotal);
+  arrayResize(state_->cameraProjections, tileCountTotal);
+  arrayResize(state_->cameraUnprojections, tileCountTotal);
+}
+
 Mn::UnsignedInt Renderer::maxLightCount() const {
   return state_->maxLightCount;
 }
 
+Mn::UnsignedInt Renderer::maxJointCount() const {
+  return state_->maxJointCount;
+}
+
+std::size_t Renderer::gpuMemoryBudget() const {
+  return state_->gpuMemoryBudget;
+}
+
 bool Renderer::addFile(const Cr::Containers::StringView filename,
                        const RendererFileFlags flags) {
   return addFile(filename, "AnySceneImporter", flags);
@@ -370,35 +963,7 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
   //  importer->addFlags(Mn::Trade::ImporterFlag::Verbose);
   //}
 
-  /* Set up options for glTF import. We can also import any other files (such
-     as serialized magnum blobs or BPS files), assume these don't need any
-     custom setup. */
-  if (importerPlugin.contains("GltfImporter") ||
-      (importerPlugin.contains("AnySceneImporter") &&
-       (filename.contains(".gltf") || filename.contains(".glb")))) {
-    // TODO implement and use a singular
-    // ignoreRequiredExtension=MAGNUMX_mesh_views
-    //  that doesn't produce warnings
-    importer->configuration().setValue("ignoreRequiredExtensions", true);
-    importer->configuration().setValue("experimentalKhrTextureKtx", true);
-
-    /* Desired imported types for custom glTF scene fields. If the group
-       doesn't exist (which is the case for AnySceneImporter), add it first */
-    Cr::Utility::ConfigurationGroup* types =
-        importer->configuration().group("customSceneFieldTypes");
-    if (!types)
-      types = importer->configuration().addGroup("customSceneFieldTypes");
-    types->addValue("meshViewIndexOffset", "UnsignedInt");
-    types->addValue("meshViewIndexCount", "UnsignedInt");
-    types->addValue("meshViewMaterial", "Int");
-  }
-
-  /* Basis options. Don't want to bother with all platform variations right
-     now, so it's always ASTC, sorry. */
-  if (Cr::PluginManager::PluginMetadata* const metadata =
-          manager.metadata("BasisImporter")) {
-    metadata->configuration().setValue("format", "Astc4x4RGBA");
-  }
+  setupImporter(manager, *importer, filename, importerPlugin);
 
   // TODO memory-map self-contained files (have a config option? do implicitly
   //  for glb, bps and ply?)
@@ -407,153 +972,95 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     return {};
   }
 
+  /* Remember where the data came from to be able to stream them back in after
+     being evicted */
+  const Mn::UnsignedInt fileId = state_->files.size();
+  arrayAppend(state_->files, Cr::InPlaceInit,
+              Cr::Containers::String{filename},
+              Cr::Containers::String{importerPlugin}, flags);
+
   /* Remember the count of data already present to offset the references with
      them */
   const Mn::UnsignedInt textureOffset = state_->textures.size();
   const Mn::UnsignedInt meshOffset = state_->meshes.size();
   const Mn::UnsignedInt meshViewOffset = state_->meshViews.size();
   const Mn::UnsignedInt materialOffset = state_->materials.size();
+  const Mn::UnsignedInt skinOffset = state_->skins.size();
 
   /* Import all textures */
   if (!(state_->flags & RendererFlag::NoTextures)) {
     for (Mn::UnsignedInt i = 0, iMax = importer->textureCount(); i != iMax;
          ++i) {
-      const Cr::Containers::Optional<Mn::Trade::TextureData> textureData =
-          importer->texture(i);
-      if (!textureData) {
-        Mn::Error{} << "Renderer::addFile(): can't import texture" << i << "of"
-                    << filename;
+      Cr::Containers::Optional<
+          Cr::Containers::Pair<Mn::GL::Texture2DArray, std::size_t>>
+          texture = importTexture(*importer, i, flags, filename,
+                                  "Renderer::addFile():");
+      if (!texture)
         return {};
-      }
-
-      /* 2D textures are imported as single-layer 2D array textures */
-      Mn::GL::Texture2DArray texture;
-      if (textureData->type() == Mn::Trade::TextureType::Texture2DArray) {
-        const Mn::UnsignedInt levelCount =
-            importer->image3DLevelCount(textureData->image());
-        Cr::Containers::Optional<Mn::Trade::ImageData3D> image =
-            importer->image3D(textureData->image());
-        if (!image) {
-          Mn::Error{} << "Renderer::addFile(): can't import 3D image"
-                      << textureData->image() << "of" << filename;
-          return {};
-        }
-
-        /* Generate a full mipmap if there's just one level and if the image is
-           not compressed. It's opt-in to force people to learn how to make
-           assets Vulkan-ready. */
-        const bool generateMipmap =
-            levelCount == 1 && (flags & RendererFileFlag::GenerateMipmap) &&
-            !image->isCompressed();
-        const Mn::UnsignedInt desiredLevelCount =
-            generateMipmap ? Mn::Math::log2(image->size().xy().min()) + 1
-                           : levelCount;
-
-        texture
-            .setMinificationFilter(textureData->minificationFilter(),
-                                   textureData->mipmapFilter())
-            .setMagnificationFilter(textureData->magnificationFilter())
-            .setWrapping(textureData->wrapping().xy());
-        if (image->isCompressed()) {
-          texture
-              .setStorage(levelCount,
-                          Mn::GL::textureFormat(image->compressedFormat()),
-                          image->size())
-              .setCompressedSubImage(0, {}, *image);
-          for (Mn::UnsignedInt level = 1; level != levelCount; ++level) {
-            Cr::Containers::Optional<Mn::Trade::ImageData3D> levelImage =
-                importer->image3D(textureData->image(), level);
-            CORRADE_INTERNAL_ASSERT(levelImage && levelImage->isCompressed() &&
-                                    levelImage->compressedFormat() ==
-                                        image->compressedFormat());
-            texture.setCompressedSubImage(level, {}, *levelImage);
-          }
-        } else {
-          texture
-              .setStorage(desiredLevelCount,
-                          Mn::GL::textureFormat(image->format()), image->size())
-              .setSubImage(0, {}, *image);
-          if (generateMipmap)
-            texture.generateMipmap();
-        }
-      } else if (textureData->type() == Mn::Trade::TextureType::Texture2D) {
-        const Mn::UnsignedInt levelCount =
-            importer->image2DLevelCount(textureData->image());
-        Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-            importer->image2D(textureData->image());
-        if (!image) {
-          Mn::Error{} << "Renderer::addFile(): can't import 2D image"
-                      << textureData->image() << "of" << filename;
-          return {};
-        }
 
-        /* Generate a full mipmap if there's just one level and if the image is
-           not compressed. It's opt-in to force people to learn how to make
-           assets Vulkan-ready. */
-        const bool generateMipmap =
-            levelCount == 1 && (flags & RendererFileFlag::GenerateMipmap) &&
-            !image->isCompressed();
-        const Mn::UnsignedInt desiredLevelCount =
-            generateMipmap ? Mn::Math::log2(image->size().min()) + 1
-                           : levelCount;
-
-        texture
-            .setMinificationFilter(textureData->minificationFilter(),
-                                   textureData->mipmapFilter())
-            .setMagnificationFilter(textureData->magnificationFilter())
-            .setWrapping(textureData->wrapping().xy());
-        if (image->isCompressed()) {
-          texture
-              .setStorage(levelCount,
-                          Mn::GL::textureFormat(image->compressedFormat()),
-                          {image->size(), 1})
-              .setCompressedSubImage(0, {}, Mn::CompressedImageView2D{*image});
-          for (Mn::UnsignedInt level = 1; level != levelCount; ++level) {
-            Cr::Containers::Optional<Mn::Trade::ImageData2D> levelImage =
-                importer->image2D(textureData->image(), level);
-            CORRADE_INTERNAL_ASSERT(levelImage && levelImage->isCompressed() &&
-                                    levelImage->compressedFormat() ==
-                                        image->compressedFormat());
-            texture.setCompressedSubImage(
-                level, {}, Mn::CompressedImageView2D{*levelImage});
-          }
-        } else {
-          texture
-              .setStorage(desiredLevelCount,
-                          Mn::GL::textureFormat(image->format()),
-                          {image->size(), 1})
-              .setSubImage(0, {}, Mn::ImageView2D{*image});
-          if (generateMipmap)
-            texture.generateMipmap();
-        }
-      } else
-        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-
-      arrayAppend(state_->textures, std::move(texture));
+      arrayAppend(state_->textures, std::move(texture->first()));
+      arrayAppend(state_->textureResidency, Cr::InPlaceInit, fileId, i,
+                  texture->second(), state_->frame, true);
+      state_->residentSize += texture->second();
     }
   }
 
-  /* Import all meshes */
+  /* Import all meshes. The CPU-side data are kept until the end of this
+     function to calculate mesh view bounds from them. */
+  Cr::Containers::Array<Cr::Containers::Optional<Mn::Trade::MeshData>>
+      meshData{importer->meshCount()};
+  /* Position dequantization of each mesh, identity if not quantized. Folded
+     into the mesh view transformations below. */
+  Cr::Containers::Array<Mn::Matrix4> meshDequantizations{
+      importer->meshCount()};
   for (Mn::UnsignedInt i = 0, iMax = importer->meshCount(); i != iMax; ++i) {
-    Cr::Containers::Optional<Mn::Trade::MeshData> mesh = importer->mesh(i);
-    if (!mesh) {
-      Mn::Error{} << "Renderer::addFile(): can't import mesh" << i << "of"
-                  << filename;
+    Cr::Containers::Optional<Cr::Containers::Triple<
+        Mn::Shaders::PhongGL::Flags, Mn::GL::Mesh, std::size_t>>
+        mesh = importMesh(*importer, i, filename, "Renderer::addFile():",
+                          state_->flags >= RendererFlag::QuantizeVertices,
+                          meshDequantizations[i], &meshData[i]);
+    if (!mesh)
       return {};
+
+    /* Without joints to use, skinned meshes are drawn in their bind pose */
+    if (state_->maxJointCount)
+      arrayAppend(state_->meshJointCounts,
+                  Mn::MeshTools::compiledPerVertexJointCount(*meshData[i]));
+    else {
+      mesh->first() &= ~Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount;
+      arrayAppend(state_->meshJointCounts, Cr::InPlaceInit, 0u, 0u);
     }
 
-    /* Make the mesh indexed if it isn't */
-    if (!mesh->isIndexed())
-      mesh = Mn::MeshTools::removeDuplicates(*mesh);
+    arrayAppend(state_->meshes, Cr::InPlaceInit, mesh->first(),
+                std::move(mesh->second()));
+    arrayAppend(state_->meshResidency, Cr::InPlaceInit, fileId, i,
+                mesh->third(), state_->frame, true);
+    state_->residentSize += mesh->third();
+  }
 
-    /* Decide what extra shader feature the mesh needs. Currently just vertex
-       colors. */
-    Mn::Shaders::PhongGL::Flags flags;
-    if (mesh->hasAttribute(Mn::Trade::MeshAttribute::Color))
-      flags |= Mn::Shaders::PhongGL::Flag::VertexColor;
+  /* Import all skins, keeping just joint names and inverse bind matrices.
+     The joint hierarchy isn't needed, joint transformations are supplied
+     from outside. */
+  if (state_->maxJointCount) {
+    for (Mn::UnsignedInt i = 0, iMax = importer->skin3DCount(); i != iMax;
+         ++i) {
+      Cr::Containers::Optional<Mn::Trade::SkinData3D> skin =
+          importer->skin3D(i);
+      if (!skin) {
+        Mn::Error{} << "Renderer::addFile(): can't import skin" << i << "of"
+                    << filename;
+        return {};
+      }
 
-    arrayAppend(state_->meshes, Cr::InPlaceInit, flags,
-                Mn::MeshTools::compile(*mesh));
+      Skin& out = arrayAppend(state_->skins, Cr::InPlaceInit);
+      out.jointNames =
+          Cr::Containers::Array<Cr::Containers::String>{skin->joints().size()};
+      for (std::size_t j = 0; j != skin->joints().size(); ++j)
+        out.jointNames[j] = importer->objectName(skin->joints()[j]);
+      out.inverseBindMatrices = Cr::Containers::Array<Mn::Matrix4>{
+          Cr::NoInit, skin->inverseBindMatrices().size()};
+      Cr::Utility::copy(skin->inverseBindMatrices(), out.inverseBindMatrices);
+    }
   }
 
   /* Immutable material data. Save texture IDs, transformations and layers to a
@@ -647,6 +1154,7 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     view.indexOffsetInBytes = 0;
     view.indexCount = state_->meshes[meshOffset].second().count();
     view.materialId = 0;
+    view.skinId = -1;
 
     /* Adding a scene-less file as a whole should be explicitly requested to
        avoid accidents */
@@ -737,6 +1245,23 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
                                  meshViews.slice(&MeshView::materialId));
     }
 
+    /* Skins of all mesh views, assuming the Skin field has the same mapping
+       as the mesh-related fields */
+    for (MeshView& view : meshViews)
+      view.skinId = -1;
+    if (state_->maxJointCount &&
+        scene->hasField(Mn::Trade::SceneField::Skin)) {
+      const Cr::Containers::StridedArrayView1D<const Mn::UnsignedInt>
+          meshViewMapping =
+              scene->mapping<Mn::UnsignedInt>(Mn::Trade::SceneField::Mesh);
+      for (std::size_t i = 0; i != meshViewMapping.size(); ++i) {
+        const Cr::Containers::Array<Mn::UnsignedInt> skins =
+            scene->skinsFor(meshViewMapping[i]);
+        if (!skins.isEmpty())
+          meshViews[i].skinId = skins[0] + skinOffset;
+      }
+    }
+
     /* Add material offset to all material IDs. If the material is -1, use the
        default material (0). */
     for (Mn::Int& materialId : meshViews.slice(&MeshView::materialId)) {
@@ -825,6 +1350,50 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     }
   }
 
+  /* Apply the position dequantization of quantized meshes before the mesh
+     view transformation. The bounds below are then calculated from the
+     quantized positions, which the transformation maps to the original
+     ones. */
+  for (std::size_t i = meshViewOffset; i != state_->meshViews.size(); ++i) {
+    MeshView& view = state_->meshViews[i];
+    view.transformation =
+        view.transformation * meshDequantizations[view.meshId - meshOffset];
+  }
+
+  /* Calculate mesh-local bounds of all new mesh views for frustum culling and
+     LOD selection */
+  {
+    Cr::Containers::Array<Cr::Containers::Array<Mn::Vector3>> positions{
+        meshData.size()};
+    Cr::Containers::Array<Cr::Containers::Array<Mn::UnsignedInt>> indices{
+        meshData.size()};
+    for (std::size_t i = meshViewOffset; i != state_->meshViews.size(); ++i) {
+      const MeshView& view = state_->meshViews[i];
+      const Mn::UnsignedInt meshId = view.meshId - meshOffset;
+      const Mn::Trade::MeshData& mesh = *meshData[meshId];
+      if (indices[meshId].isEmpty()) {
+        positions[meshId] = mesh.positions3DAsArray();
+        indices[meshId] = mesh.indicesAsArray();
+      }
+
+      const std::size_t first =
+          view.indexOffsetInBytes / Mn::meshIndexTypeSize(mesh.indexType());
+      Mn::Range3D bounds;
+      if (view.indexCount) {
+        const Mn::Vector3 firstPosition =
+            positions[meshId][indices[meshId][first]];
+        bounds = {firstPosition, firstPosition};
+        for (std::size_t j = first + 1; j != first + view.indexCount; ++j)
+          bounds = Mn::Math::join(
+              bounds, Mn::Range3D::fromSize(
+                          positions[meshId][indices[meshId][j]], {}));
+      }
+      arrayAppend(state_->meshViewBounds, bounds);
+    }
+    CORRADE_INTERNAL_ASSERT(state_->meshViewBounds.size() ==
+                            state_->meshViews.size());
+  }
+
   /* Setup a zero-light (flat) shader in desired combinations. For simplicity
      and stutter-free experience instantiate all possibly needed combinations
      upfront instead of lazy-compiling them once needed. */
@@ -833,12 +1402,24 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
   // TODO also might make sense to use async compilation when the combination
   //  count grows further
   for (Mn::Shaders::PhongGL::Flags extraFlags :
-       {{}, Mn::Shaders::PhongGL::Flag::VertexColor}) {
+       {Mn::Shaders::PhongGL::Flags{},
+        Mn::Shaders::PhongGL::Flags{Mn::Shaders::PhongGL::Flag::VertexColor},
+        Mn::Shaders::PhongGL::Flags{
+            Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount},
+        Mn::Shaders::PhongGL::Flag::VertexColor |
+            Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount}) {
+    /* Skinned variants are needed only if skinning is enabled */
+    if (!state_->maxJointCount &&
+        (extraFlags & Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount))
+      continue;
+
     Mn::Shaders::PhongGL::Flags shaderFlags =
         extraFlags | Mn::Shaders::PhongGL::Flag::MultiDraw |
         Mn::Shaders::PhongGL::Flag::UniformBuffers |
         Mn::Shaders::PhongGL::Flag::NoSpecular |
         Mn::Shaders::PhongGL::Flag::LightCulling;
+    if (state_->flags & RendererFlag::ObjectId)
+      shaderFlags |= Mn::Shaders::PhongGL::Flag::ObjectId;
     if (!(state_->flags >= RendererFlag::NoTextures)) {
       shaderFlags |= Mn::Shaders::PhongGL::Flag::AmbientTexture |
                      Mn::Shaders::PhongGL::Flag::TextureArrays |
@@ -852,20 +1433,79 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     // TODO 1024 is 64K divided by 64 bytes needed for one draw uniform, have
     //  that fetched from actual GL limits instead once I get to actually
     //  splitting draws by this limit
-    state_->shaders[Mn::UnsignedInt(extraFlags)] = Mn::Shaders::PhongGL{
-        Mn::Shaders::PhongGL::Configuration{}
-            .setFlags(shaderFlags)
-            .setLightCount(state_->maxLightCount)
-            .setMaterialCount(Mn::UnsignedInt(state_->materials.size()))
-            .setDrawCount(1024)};
+    Mn::Shaders::PhongGL::Configuration configuration;
+    configuration.setFlags(shaderFlags)
+        .setLightCount(state_->maxLightCount)
+        .setMaterialCount(Mn::UnsignedInt(state_->materials.size()))
+        .setDrawCount(1024);
+    /* The per-vertex counts are upper bounds, actual counts are set for each
+       mesh in draw() */
+    if (extraFlags & Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount)
+      configuration.setJointCount(state_->maxJointCount, 4, 4);
+    state_->shaders[Mn::UnsignedInt(extraFlags)] =
+        Mn::Shaders::PhongGL{configuration};
   }
 
   /* Bind buffers that don't change per-view. All shaders share the same
      binding points so it's fine to use an arbitrary one */
   state_->shaders.begin()->second.bindMaterialBuffer(state_->materialUniform);
+
+  /* Make room for the new data if over the budget */
+  state_->evictUnused();
+  return true;
+}
+
+bool Renderer::addNodeHierarchyLod(const Cr::Containers::StringView name,
+                                   const Cr::Containers::StringView lodName,
+                                   const Mn::Float screenSize) {
+  const auto found = state_->meshViewRangeForName.find(
+      Cr::Containers::String::nullTerminatedView(lodName));
+  if (found == state_->meshViewRangeForName.end() ||
+      !hasNodeHierarchy(name)) {
+    Mn::Error{} << "Renderer::addNodeHierarchyLod(): name"
+                << (found == state_->meshViewRangeForName.end() ? lodName
+                                                                 : name)
+                << "not found";
+    return false;
+  }
+  if (name == lodName) {
+    Mn::Error{} << "Renderer::addNodeHierarchyLod(): can't use" << name
+                << "as its own level of detail";
+    return false;
+  }
+
+  /* Keep the levels ordered by decreasing screen size */
+  Cr::Containers::Array<Lod>& lods = state_->lodsForName[name];
+  arrayAppend(lods,
+              Lod{found->second.first(), found->second.second(), screenSize});
+  for (std::size_t i = lods.size() - 1;
+       i && lods[i - 1].screenSize < lods[i].screenSize; --i)
+    std::swap(lods[i - 1], lods[i]);
   return true;
 }
 
+Mn::Int Renderer::jointId(const Cr::Containers::StringView name,
+                           const Cr::Containers::StringView jointName) const {
+  const auto found = state_->meshViewRangeForName.find(
+      Cr::Containers::String::nullTerminatedView(name));
+  CORRADE_ASSERT(found != state_->meshViewRangeForName.end(),
+                 "Renderer::jointId(): name" << name << "not found", {});
+
+  /* Same as in addNodeHierarchy(), the first skinned mesh view decides */
+  for (std::size_t i = found->second.first(); i != found->second.second();
+       ++i) {
+    const Mn::Int skinId = state_->meshViews[i].skinId;
+    if (skinId == -1)
+      continue;
+    const Skin& skin = state_->skins[skinId];
+    for (std::size_t j = 0; j != skin.jointNames.size(); ++j)
+      if (skin.jointNames[j] == jointName)
+        return j;
+    break;
+  }
+  return -1;
+}
+
 bool Renderer::hasNodeHierarchy(const Cr::Containers::StringView name) const {
   /* Using a non-owning wrapper over the view to avoid an allocated string copy
      because yes hello STL you're uhhmazing */
@@ -912,47 +1552,128 @@ std::size_t Renderer::addNodeHierarchy(const Mn::UnsignedInt sceneId,
   CORRADE_INTERNAL_ASSERT(scene.drawCommandsSorted.size() ==
                           scene.drawBatchIds.size());
 
+  /* If the hierarchy is skinned, it gets its own set of joints. All skinned
+     mesh views in it are expected to use the same skin. */
+  Mn::Int skinId = -1;
+  for (std::size_t i = found->second.first(); i != found->second.second();
+       ++i) {
+    const Mn::Int viewSkinId = state_->meshViews[i].skinId;
+    if (viewSkinId == -1)
+      continue;
+    CORRADE_ASSERT(skinId == -1 || skinId == viewSkinId,
+                   "Renderer::addNodeHierarchy(): hierarchy"
+                       << name << "references more than one skin",
+                   {});
+    skinId = viewSkinId;
+  }
+  const Mn::UnsignedInt jointOffset = scene.jointTransformations.size();
+  if (skinId != -1) {
+    const Skin& skin = state_->skins[skinId];
+    CORRADE_ASSERT(
+        jointOffset + skin.inverseBindMatrices.size() <= state_->maxJointCount,
+        "Renderer::addNodeHierarchy(): adding" << name << "to scene" << sceneId
+                                               << "would exceed"
+                                               << state_->maxJointCount
+                                               << "joints",
+        {});
+
+    /* Joints are in the bind pose by default */
+    for (const Mn::Matrix4& inverseBindMatrix : skin.inverseBindMatrices)
+      arrayAppend(scene.jointTransformations, inverseBindMatrix.inverted());
+    arrayAppend(scene.jointMatrices, Cr::NoInit,
+                skin.inverseBindMatrices.size());
+  }
+
   /* Add a top-level object with no attached mesh */
   const std::size_t topLevelId = scene.transformations.size();
   arrayAppend(scene.parents, -1);
   arrayAppend(scene.transformations, Cr::InPlaceInit);
+  arrayAppend(scene.objectIds, 0u);
+  if (skinId != -1)
+    arrayAppend(scene.skinInstances, Cr::InPlaceInit, topLevelId,
+                Mn::UnsignedInt(skinId), jointOffset);
+
+  /* If there are levels of detail, the draws of all levels are added under
+     the top-level object, tagged with the level */
+  const auto foundLods = state_->lodsForName.find(
+      Cr::Containers::String::nullTerminatedView(name));
+  Mn::Int lodInstance = -1;
+  if (foundLods != state_->lodsForName.end()) {
+    lodInstance = scene.lodInstances.size();
+    LodInstance& instance = arrayAppend(scene.lodInstances, Cr::InPlaceInit);
+    instance.node = topLevelId;
+    instance.selectedLevel = 0;
+    arrayResize(instance.screenSizes, Cr::NoInit, foundLods->second.size());
+    for (std::size_t i = 0; i != foundLods->second.size(); ++i)
+      instance.screenSizes[i] = foundLods->second[i].screenSize;
+    for (std::size_t i = found->second.first(); i != found->second.second();
+         ++i) {
+      const Cr::Containers::Pair<Mn::Vector3, Mn::Vector3> box = transformBox(
+          bakeTransformation * state_->meshViews[i].transformation,
+          state_->meshViewBounds[i]);
+      const Mn::Range3D range{box.first() - box.second(),
+                              box.first() + box.second()};
+      instance.bounds = i == found->second.first()
+                            ? range
+                            : Mn::Math::join(instance.bounds, range);
+    }
+  }
+  const std::size_t levelCount =
+      lodInstance == -1 ? 1 : foundLods->second.size() + 1;
 
   /* Add the whole hierarchy under this name, with a mesh for each */
   // TODO the hierarchy can eventually also have meshless "grouping nodes" or
   //  also more meshes per node, account for that
-  for (std::size_t i = found->second.first(); i != found->second.second();
-       ++i) {
-    const MeshView& meshView = state_->meshViews[i];
-    /* The following meshes are children of the first one, inheriting its
-       transformation */
-    const std::size_t id = scene.transformations.size();
-    arrayAppend(scene.parents, topLevelId);
-    arrayAppend(scene.transformations,
-                bakeTransformation * meshView.transformation);
-
-    /* Get a batch ID for given shader/mesh/texture combination */
-    const Mn::UnsignedInt batchId = drawBatchId(
-        scene.drawBatches, state_->shaders,
-        state_->meshes[meshView.meshId].first(), meshView.meshId,
-        state_->materialTextureTransformations[meshView.materialId].textureId);
-
-    arrayAppend(scene.drawBatchIds, batchId);
-    arrayAppend(scene.transformationIds, id);
-    arrayAppend(scene.draws, Cr::InPlaceInit)
-        .setMaterialId(meshView.materialId);
-    arrayAppend(scene.textureTransformations, Cr::InPlaceInit)
-        .setTextureMatrix(
-            state_->materialTextureTransformations[meshView.materialId]
-                .transformation)
-        .setLayer(
-            state_->materialTextureTransformations[meshView.materialId].layer);
-    arrayAppend(scene.drawCommands, Cr::InPlaceInit,
-                meshView.indexOffsetInBytes, meshView.indexCount);
-    /* Just to have them with the right size, they get filled in a next dirty
-       state update in draw() */
-    arrayAppend(scene.drawsSorted, Cr::NoInit, 1);
-    arrayAppend(scene.transformationIdsSorted, Cr::NoInit, 1);
-    arrayAppend(scene.drawCommandsSorted, Cr::NoInit, 1);
+  for (std::size_t level = 0; level != levelCount; ++level) {
+    const Mn::UnsignedInt begin =
+        level == 0 ? found->second.first()
+                   : foundLods->second[level - 1].meshViewBegin;
+    const Mn::UnsignedInt end = level == 0
+                                    ? found->second.second()
+                                    : foundLods->second[level - 1].meshViewEnd;
+    for (std::size_t i = begin; i != end; ++i) {
+      const MeshView& meshView = state_->meshViews[i];
+      /* The following meshes are children of the first one, inheriting its
+         transformation */
+      const std::size_t id = scene.transformations.size();
+      arrayAppend(scene.parents, topLevelId);
+      arrayAppend(scene.transformations,
+                  bakeTransformation * meshView.transformation);
+      arrayAppend(scene.objectIds, 0u);
+
+      /* Get a batch ID for given shader/mesh/texture combination */
+      const Mn::UnsignedInt batchId = drawBatchId(
+          scene.drawBatches, state_->shaders,
+          state_->meshes[meshView.meshId].first(), meshView.meshId,
+          state_->materialTextureTransformations[meshView.materialId]
+              .textureId);
+
+      arrayAppend(scene.drawBatchIds, batchId);
+      arrayAppend(scene.transformationIds, id);
+      arrayAppend(scene.draws, Cr::InPlaceInit)
+          .setMaterialId(meshView.materialId)
+          .setJointOffset(meshView.skinId == -1 ? 0 : jointOffset);
+      arrayAppend(scene.textureTransformations, Cr::InPlaceInit)
+          .setTextureMatrix(
+              state_->materialTextureTransformations[meshView.materialId]
+                  .transformation)
+          .setLayer(state_->materialTextureTransformations[meshView.materialId]
+                        .layer);
+      arrayAppend(scene.drawCommands, Cr::InPlaceInit,
+                  meshView.indexOffsetInBytes, meshView.indexCount);
+      arrayAppend(scene.drawLods, Cr::InPlaceInit, lodInstance,
+                  Mn::UnsignedInt(level));
+      /* Just to have them with the right size, they get filled in a next
+         dirty state update in draw() */
+      arrayAppend(scene.drawsSorted, Cr::NoInit, 1);
+      arrayAppend(scene.transformationIdsSorted, Cr::NoInit, 1);
+      arrayAppend(scene.drawCommandsSorted, Cr::NoInit, 1);
+      arrayAppend(scene.drawLodsSorted, Cr::NoInit, 1);
+      if (state_->flags & RendererFlag::FrustumCulling) {
+        arrayAppend(scene.drawBounds, state_->meshViewBounds[i]);
+        arrayAppend(scene.drawBoundsSorted, Cr::NoInit, 1);
+      }
+    }
   }
 
   /* Schedule an update next time draw() is called */
@@ -981,6 +1702,7 @@ std::size_t Renderer::addEmptyNode(const Mn::UnsignedInt sceneId) {
   const std::size_t id = scene.transformations.size();
   arrayAppend(scene.parents, -1);
   arrayAppend(scene.transformations, Cr::InPlaceInit);
+  arrayAppend(scene.objectIds, 0u);
 
   /* Not marking the dirty bit as nothing changed rendering-wise, and the
      transformations are processed every frame anyway */
@@ -1025,7 +1747,11 @@ void Renderer::clear(const Mn::UnsignedInt sceneId) {
   /* Resizing instead of `= {}` to not discard the memory */
   arrayResize(scene.parents, 0);
   arrayResize(scene.transformations, 0);
+  arrayResize(scene.objectIds, 0);
   arrayResize(scene.lights, 0);
+  arrayResize(scene.skinInstances, Cr::NoInit, 0);
+  arrayResize(scene.jointTransformations, Cr::NoInit, 0);
+  arrayResize(scene.jointMatrices, Cr::NoInit, 0);
   arrayResize(scene.drawBatchIds, 0);
   arrayResize(scene.transformationIds, 0);
   arrayResize(scene.drawBatches, Cr::NoInit, 0);
@@ -1035,6 +1761,13 @@ void Renderer::clear(const Mn::UnsignedInt sceneId) {
   arrayResize(scene.drawsSorted, 0);
   arrayResize(scene.transformationIdsSorted, 0);
   arrayResize(scene.drawCommandsSorted, 0);
+  arrayResize(scene.drawBounds, Cr::NoInit, 0);
+  arrayResize(scene.drawBoundsSorted, Cr::NoInit, 0);
+  scene.culledDrawCount = 0;
+  arrayResize(scene.lodInstances, 0);
+  arrayResize(scene.drawLods, Cr::NoInit, 0);
+  arrayResize(scene.drawLodsSorted, Cr::NoInit, 0);
+  scene.inactiveLodDrawCount = 0;
 
   /* There's nothing in the scene, so there's no dirty state to process */
   scene.dirty = false;
@@ -1056,37 +1789,108 @@ void Renderer::clearLights(const Mn::UnsignedInt sceneId) {
 }
 
 Magnum::Matrix4 Renderer::camera(Magnum::UnsignedInt sceneId) const {
+  return camera(sceneId, 0);
+}
+
+Magnum::Matrix4 Renderer::camera(Magnum::UnsignedInt sceneId,
+                                 Magnum::UnsignedInt viewId) const {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
                  "Renderer::camera(): index" << sceneId << "out of range for"
                                              << state_->scenes.size()
                                              << "scenes",
                  {});
+  CORRADE_ASSERT(viewId < state_->viewCount,
+                 "Renderer::camera(): view" << viewId << "out of range for"
+                                            << state_->viewCount << "views",
+                 {});
 
-  return state_->cameraMatrices[sceneId].projectionMatrix;
+  return state_->cameraMatrices[sceneId * state_->viewCount + viewId]
+      .projectionMatrix;
 }
 
 Magnum::Vector2 Renderer::cameraDepthUnprojection(
     Magnum::UnsignedInt sceneId) const {
+  return cameraDepthUnprojection(sceneId, 0);
+}
+
+Magnum::Vector2 Renderer::cameraDepthUnprojection(
+    Magnum::UnsignedInt sceneId,
+    Magnum::UnsignedInt viewId) const {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
                  "Renderer::cameraDepthUnprojection(): index"
                      << sceneId << "out of range for" << state_->scenes.size()
                      << "scenes",
                  {});
+  CORRADE_ASSERT(viewId < state_->viewCount,
+                 "Renderer::cameraDepthUnprojection(): view"
+                     << viewId << "out of range for" << state_->viewCount
+                     << "views",
+                 {});
 
-  return state_->scenes[sceneId].cameraUnprojection;
+  return state_->cameraUnprojections[sceneId * state_->viewCount + viewId];
+}
+
+Magnum::Matrix4 Renderer::cameraProjection(
+    Magnum::UnsignedInt sceneId) const {
+  return cameraProjection(sceneId, 0);
+}
+
+Magnum::Matrix4 Renderer::cameraProjection(Magnum::UnsignedInt sceneId,
+                                           Magnum::UnsignedInt viewId) const {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::cameraProjection(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes",
+                 {});
+  CORRADE_ASSERT(viewId < state_->viewCount,
+                 "Renderer::cameraProjection(): view"
+                     << viewId << "out of range for" << state_->viewCount
+                     << "views",
+                 {});
+
+  return state_->cameraProjections[sceneId * state_->viewCount + viewId];
 }
 
 void Renderer::updateCamera(Magnum::UnsignedInt sceneId,
                             const Magnum::Matrix4& projection,
                             const Magnum::Matrix4& view) {
+  updateCamera(sceneId, 0, projection, view);
+}
+
+void Renderer::updateCamera(Magnum::UnsignedInt sceneId,
+                            Magnum::UnsignedInt viewId,
+                            const Magnum::Matrix4& projection,
+                            const Magnum::Matrix4& view) {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
                  "Renderer::updateCamera(): index"
                      << sceneId << "out of range for" << state_->scenes.size()
                      << "scenes", );
+  CORRADE_ASSERT(viewId < state_->viewCount,
+                 "Renderer::updateCamera(): view"
+                     << viewId << "out of range for" << state_->viewCount
+                     << "views", );
+
+  const std::size_t tileId = sceneId * state_->viewCount + viewId;
+  state_->cameraMatrices[tileId].projectionMatrix = projection * view;
+  state_->cameraProjections[tileId] = projection;
+  state_->cameraUnprojections[tileId] = calculateDepthUnprojection(projection);
+}
 
-  state_->cameraMatrices[sceneId].projectionMatrix = projection * view;
-  state_->scenes[sceneId].cameraUnprojection =
-      calculateDepthUnprojection(projection);
+void Renderer::updateCameras(
+    const Cr::Containers::StridedArrayView1D<const Mn::Matrix4>& projections,
+    const Cr::Containers::StridedArrayView1D<const Mn::Matrix4>& views) {
+  const std::size_t tileCount = state_->cameraMatrices.size();
+  CORRADE_ASSERT(projections.size() == tileCount && views.size() == tileCount,
+                 "Renderer::updateCameras(): expected"
+                     << tileCount << "projections and views but got"
+                     << projections.size() << "and" << views.size(), );
+
+  for (std::size_t i = 0; i != tileCount; ++i) {
+    state_->cameraMatrices[i].projectionMatrix = projections[i] * views[i];
+    state_->cameraProjections[i] = projections[i];
+    state_->cameraUnprojections[i] =
+        calculateDepthUnprojection(projections[i]);
+  }
 }
 
 Cr::Containers::StridedArrayView1D<Mn::Matrix4> Renderer::transformations(
@@ -1100,6 +1904,67 @@ Cr::Containers::StridedArrayView1D<Mn::Matrix4> Renderer::transformations(
   return state_->scenes[sceneId].transformations;
 }
 
+void Renderer::updateTransformations(
+    const Cr::Containers::StridedArrayView1D<const Mn::UnsignedInt>& sceneIds,
+    const Cr::Containers::StridedArrayView1D<const Mn::UnsignedInt>& nodeIds,
+    const Cr::Containers::StridedArrayView1D<const Mn::Matrix4>&
+        transformations) {
+  CORRADE_ASSERT(sceneIds.size() == nodeIds.size() &&
+                     sceneIds.size() == transformations.size(),
+                 "Renderer::updateTransformations(): expected"
+                     << sceneIds.size()
+                     << "node IDs and transformations but got"
+                     << nodeIds.size() << "and" << transformations.size(), );
+
+  for (std::size_t i = 0; i != sceneIds.size(); ++i) {
+    CORRADE_ASSERT(sceneIds[i] < state_->scenes.size(),
+                   "Renderer::updateTransformations(): index"
+                       << sceneIds[i] << "out of range for"
+                       << state_->scenes.size() << "scenes", );
+    Scene& scene = state_->scenes[sceneIds[i]];
+    CORRADE_ASSERT(nodeIds[i] < scene.transformations.size(),
+                   "Renderer::updateTransformations(): node"
+                       << nodeIds[i] << "out of range for"
+                       << scene.transformations.size() << "nodes in scene"
+                       << sceneIds[i], );
+    scene.transformations[nodeIds[i]] = transformations[i];
+  }
+}
+
+Cr::Containers::StridedArrayView1D<Mn::Matrix4> Renderer::jointTransformations(
+    const Mn::UnsignedInt sceneId,
+    const std::size_t nodeId) {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::jointTransformations(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes",
+                 {});
+
+  Scene& scene = state_->scenes[sceneId];
+  for (const SkinInstance& instance : scene.skinInstances) {
+    if (instance.node != nodeId)
+      continue;
+    return scene.jointTransformations.sliceSize(
+        instance.jointOffset,
+        state_->skins[instance.skinId].inverseBindMatrices.size());
+  }
+  CORRADE_ASSERT_UNREACHABLE("Renderer::jointTransformations(): node"
+                                 << nodeId << "in scene" << sceneId
+                                 << "isn't a skinned hierarchy",
+                             {});
+}
+
+Cr::Containers::StridedArrayView1D<Mn::UnsignedInt> Renderer::objectIds(
+    const Mn::UnsignedInt sceneId) {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::objectIds(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes",
+                 {});
+
+  return state_->scenes[sceneId].objectIds;
+}
+
 Cr::Containers::StridedArrayView1D<Mn::Color3> Renderer::lightColors(
     const Mn::UnsignedInt sceneId) {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
@@ -1130,6 +1995,12 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
     return;
   }
 
+  /* Bring back data the scenes need that were evicted before, then evict
+     what isn't used in this frame if over the budget */
+  ++state_->frame;
+  state_->streamIn();
+  state_->evictUnused();
+
   /* Process scenes that are marked as dirty */
   // TODO this could be a separate step to allow the user to control when it
   //  runs
@@ -1186,6 +2057,9 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
         textureTransformationsSorted[offset] = scene.textureTransformations[i];
         scene.transformationIdsSorted[offset] = scene.transformationIds[i];
         scene.drawCommandsSorted[offset] = scene.drawCommands[i];
+        scene.drawLodsSorted[offset] = scene.drawLods[i];
+        if (state_->flags & RendererFlag::FrustumCulling)
+          scene.drawBoundsSorted[offset] = scene.drawBounds[i];
         ++offset;
       }
       CORRADE_INTERNAL_ASSERT(scene.drawBatchOffsets.front() == 0);
@@ -1257,9 +2131,94 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
           // TODO light culling should happen here
           .setLightOffsetCount(0, scene.lights.size());
     }
+    if (state_->flags & RendererFlag::ObjectId) {
+      for (std::size_t i = 0; i != scene.transformationIdsSorted.size(); ++i) {
+        const Mn::UnsignedInt node = scene.transformationIdsSorted[i];
+        const Mn::Int parent = scene.parents[node];
+        scene.drawsSorted[i].setObjectId(
+            scene.objectIds[parent == -1 ? node : parent]);
+      }
+    }
     // TODO have a single buffer for this
     scene.drawUniform.setData(scene.drawsSorted);
 
+    /* Select levels of detail and cull the draws for each view of the scene.
+       The transformations above are shared by all views, only the camera
+       differs. */
+    const bool frustumCulling =
+        bool(state_->flags & RendererFlag::FrustumCulling);
+    const std::size_t drawCount = scene.drawCommandsSorted.size();
+    scene.culledDrawCount = 0;
+    scene.inactiveLodDrawCount = 0;
+    if (frustumCulling || !scene.lodInstances.isEmpty())
+      arrayResize(scene.drawCommandsCulled, Cr::NoInit,
+                  drawCount * state_->viewCount);
+    for (std::size_t viewId = 0; viewId != state_->viewCount; ++viewId) {
+      const Mn::Matrix4& projectionView =
+          state_->cameraMatrices[sceneId * state_->viewCount + viewId]
+              .projectionMatrix;
+
+      /* Select a level of detail for each hierarchy that has them, based on
+         the projected size of its bounds relative to the tile height. The
+         size of a unit vector in clip space is the length of the second row
+         of the projection-view matrix, divided by W. */
+      for (LodInstance& instance : scene.lodInstances) {
+        const Mn::Matrix4& transformation =
+            state_->absoluteTransformations[instance.node + 1]
+                .transformationMatrix;
+        const Cr::Containers::Pair<Mn::Vector3, Mn::Vector3> box =
+            transformBox(transformation, instance.bounds);
+        const Mn::Float w = Mn::Math::dot(projectionView.row(3),
+                                          Mn::Vector4{box.first(), 1.0f});
+        const Mn::Float screenSize =
+            w > 0.0f ? box.second().length() *
+                           projectionView.row(1).xyz().length() / w
+                     : 0.0f;
+        instance.selectedLevel = 0;
+        while (instance.selectedLevel != instance.screenSizes.size() &&
+               screenSize < instance.screenSizes[instance.selectedLevel])
+          ++instance.selectedLevel;
+      }
+
+      /* Cull draws against the camera frustum and disable the draws of
+         unselected levels of detail. Stats are counted for the first view
+         only. */
+      if (!frustumCulling && scene.lodInstances.isEmpty())
+        continue;
+      const Mn::Frustum frustum = Mn::Frustum::fromMatrix(projectionView);
+      const Cr::Containers::ArrayView<DrawCommand> drawCommandsCulled =
+          scene.drawCommandsCulled.sliceSize(viewId * drawCount, drawCount);
+      std::size_t culledDrawCount = 0;
+      std::size_t inactiveLodDrawCount = 0;
+      for (std::size_t i = 0; i != drawCount; ++i) {
+        drawCommandsCulled[i] = scene.drawCommandsSorted[i];
+
+        const Cr::Containers::Pair<Mn::Int, Mn::UnsignedInt>& lod =
+            scene.drawLodsSorted[i];
+        if (lod.first() != -1 &&
+            scene.lodInstances[lod.first()].selectedLevel != lod.second()) {
+          drawCommandsCulled[i].indexCount = 0;
+          ++inactiveLodDrawCount;
+          continue;
+        }
+
+        if (!frustumCulling)
+          continue;
+        const Cr::Containers::Pair<Mn::Vector3, Mn::Vector3> box =
+            transformBox(
+                state_->absoluteTransformationsSorted[i].transformationMatrix,
+                scene.drawBoundsSorted[i]);
+        if (isOutsideFrustum(box.first(), box.second(), frustum)) {
+          drawCommandsCulled[i].indexCount = 0;
+          ++culledDrawCount;
+        }
+      }
+      if (viewId == 0) {
+        scene.culledDrawCount = culledDrawCount;
+        scene.inactiveLodDrawCount = inactiveLodDrawCount;
+      }
+    }
+
     /* Copy light properties and cherry-pick transformations for them. Resize
        the temp destination if it's too small. */
     if (state_->absoluteLights.size() < scene.lights.size())
@@ -1289,6 +2248,21 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
     if (!scene.lights.isEmpty())
       scene.lightUniform.setData(
           state_->absoluteLights.prefix(scene.lights.size()));
+
+    /* Calculate joint matrices of skinned hierarchies. The joint
+       transformations are relative to the top-level node, so the draw
+       transformation applies on top. */
+    if (!scene.skinInstances.isEmpty()) {
+      for (const SkinInstance& instance : scene.skinInstances) {
+        const Skin& skin = state_->skins[instance.skinId];
+        for (std::size_t i = 0; i != skin.inverseBindMatrices.size(); ++i)
+          scene.jointMatrices[instance.jointOffset + i]
+              .setTransformationMatrix(
+                  scene.jointTransformations[instance.jointOffset + i] *
+                  skin.inverseBindMatrices[i]);
+      }
+      scene.jointUniform.setData(scene.jointMatrices);
+    }
   }
 
   /* Remember the original viewport to set it back to where it was after.
@@ -1297,12 +2271,18 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
      wants to draw HUD etc. on top. */
   const Mn::Range2Di previousViewport = framebuffer.viewport();
 
+  if (state_->gpuTimerEnabled)
+    state_->gpuDrawTimer.begin();
+
   for (Mn::Int y = 0; y != state_->tileCount.y(); ++y) {
     for (Mn::Int x = 0; x != state_->tileCount.x(); ++x) {
       framebuffer.setViewport(Mn::Range2Di::fromSize(
           Mn::Vector2i{x, y} * state_->tileSize, state_->tileSize));
 
-      const std::size_t sceneId = y * state_->tileCount.x() + x;
+      /* Consecutive tiles are views of the same scene */
+      const std::size_t tileId = y * state_->tileCount.x() + x;
+      const std::size_t sceneId = tileId / state_->viewCount;
+      const std::size_t viewId = tileId % state_->viewCount;
       Scene& scene = state_->scenes[sceneId];
 
       /* Bind buffers. Again, all shaders share the same binding points so it
@@ -1313,7 +2293,7 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
           ->second
           // TODO bind all buffers together with a multi API
           .bindProjectionBuffer(state_->projectionUniform,
-                                sceneId * sizeof(ProjectionPadded),
+                                tileId * sizeof(ProjectionPadded),
                                 sizeof(ProjectionPadded))
           .bindTransformationBuffer(scene.transformationUniform)
           .bindLightBuffer(scene.lightUniform)
@@ -1321,11 +2301,26 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
       if (!(state_->flags & RendererFlag::NoTextures))
         state_->shaders.begin()->second.bindTextureTransformationBuffer(
             scene.textureTransformationUniform);
+      if (!scene.skinInstances.isEmpty())
+        state_->shaders
+            .at(Mn::UnsignedInt(
+                Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount))
+            .bindJointBuffer(scene.jointUniform);
 
       /* Submit all draw batches */
+      const bool filteredDraws =
+          (state_->flags & RendererFlag::FrustumCulling) ||
+          !scene.lodInstances.isEmpty();
       for (std::size_t i = 0; i != scene.drawBatches.size(); ++i) {
         const DrawBatch& drawBatch = scene.drawBatches[i];
 
+        /* Skip data that failed to be streamed back in, streamIn() printed
+           a message already */
+        if (!state_->meshResidency[drawBatch.meshId].resident ||
+            (!(state_->flags >= RendererFlag::NoTextures) &&
+             !state_->textureResidency[drawBatch.textureId].resident))
+          continue;
+
         if (!(state_->flags >= RendererFlag::NoTextures)) {
           drawBatch.shader->bindAmbientTexture(
               state_->textures[drawBatch.textureId]);
@@ -1341,8 +2336,29 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
             drawBatchCommands =
                 // TODO if unsorted scene.drawCommands is here, the unit test
                 //  still passes -- fix!
-            scene.drawCommandsSorted.slice(drawBatchOffset,
-                                           nextDrawBatchOffset);
+            (filteredDraws
+                 ? scene.drawCommandsCulled.sliceSize(
+                       viewId * scene.drawCommandsSorted.size(),
+                       scene.drawCommandsSorted.size())
+                 : Cr::Containers::arrayView(scene.drawCommandsSorted))
+                .slice(drawBatchOffset, nextDrawBatchOffset);
+
+        /* Skip the whole batch if all its draws got culled */
+        if (filteredDraws) {
+          bool anyVisible = false;
+          for (const DrawCommand& command : drawBatchCommands)
+            anyVisible = anyVisible || command.indexCount;
+          if (!anyVisible)
+            continue;
+        }
+
+        if (drawBatch.shader->flags() &
+            Mn::Shaders::PhongGL::Flag::DynamicPerVertexJointCount) {
+          const Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt>&
+              jointCounts = state_->meshJointCounts[drawBatch.meshId];
+          drawBatch.shader->setPerVertexJointCount(jointCounts.first(),
+                                                   jointCounts.second());
+        }
 
         drawBatch.shader->setDrawOffset(drawBatchOffset)
             .draw(state_->meshes[drawBatch.meshId].second(),
@@ -1352,9 +2368,24 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
     }
   }
 
+  if (state_->gpuTimerEnabled)
+    state_->gpuDrawTimer.end();
+
   framebuffer.setViewport(previousViewport);
 }
 
+bool Renderer::isGpuTimerEnabled() const {
+  return state_->gpuTimerEnabled;
+}
+
+void Renderer::setGpuTimerEnabled(const bool enabled) {
+  state_->gpuTimerEnabled = enabled;
+}
+
+Cr::Containers::Optional<Mn::UnsignedLong> Renderer::takeGpuDrawDuration() {
+  return state_->gpuDrawTimer.takeDuration();
+}
+
 SceneStats Renderer::sceneStats(Mn::UnsignedInt sceneId) const {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
                  "Renderer::sceneStats(): index"
@@ -1373,6 +2404,56 @@ SceneStats Renderer::sceneStats(Mn::UnsignedInt sceneId) const {
      again would be up-to-date only after draw() -- people should just learn to
      only fetch stats after a draw, and not before. */
   out.drawBatchCount = scene.drawBatches.size();
+  out.culledDrawCount = scene.culledDrawCount;
+  out.inactiveLodDrawCount = scene.inactiveLodDrawCount;
+  out.visibleDrawCount = scene.draws.size() - scene.culledDrawCount -
+                         scene.inactiveLodDrawCount;
+
+  /* Unique meshes and textures referenced by the draw batches. Again a linear
+     search, there shouldn't be many. */
+  out.meshCount = 0;
+  out.textureCount = 0;
+  out.residentSize = 0;
+  for (std::size_t i = 0; i != scene.drawBatches.size(); ++i) {
+    const DrawBatch& drawBatch = scene.drawBatches[i];
+    bool meshSeen = false, textureSeen = false;
+    for (std::size_t j = 0; j != i; ++j) {
+      meshSeen = meshSeen || scene.drawBatches[j].meshId == drawBatch.meshId;
+      textureSeen =
+          textureSeen || scene.drawBatches[j].textureId == drawBatch.textureId;
+    }
+    if (!meshSeen) {
+      ++out.meshCount;
+      const Residency& mesh = state_->meshResidency[drawBatch.meshId];
+      if (mesh.resident)
+        out.residentSize += mesh.size;
+    }
+    if (!textureSeen && !(state_->flags >= RendererFlag::NoTextures)) {
+      ++out.textureCount;
+      const Residency& texture = state_->textureResidency[drawBatch.textureId];
+      if (texture.resident)
+        out.residentSize += texture.size;
+    }
+  }
+  return out;
+}
+
+ResidencyStats Renderer::residencyStats() const {
+  ResidencyStats out;
+  out.gpuMemoryBudget = state_->gpuMemoryBudget;
+  out.residentSize = state_->residentSize;
+  out.meshCount = state_->meshResidency.size();
+  out.residentMeshCount = 0;
+  for (const Residency& mesh : state_->meshResidency)
+    if (mesh.resident)
+      ++out.residentMeshCount;
+  out.textureCount = state_->textureResidency.size();
+  out.residentTextureCount = 0;
+  for (const Residency& texture : state_->textureResidency)
+    if (texture.resident)
+      ++out.residentTextureCount;
+  out.streamedCount = state_->streamedCount;
+  out.evictedCount = state_->evictedCount;
   return out;
 }
 
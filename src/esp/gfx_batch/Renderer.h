@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_BATCH_RENDERER_H_
 #define ESP_GFX_BATCH_RENDERER_H_
 
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/GL.h>
 #include <Magnum/Magnum.h>
@@ -25,7 +26,42 @@ enum class RendererFlag {
    * Causes textures to not even get loaded, potentially saving significant
    * amount of memory. Only material and vertex colors are used for rendering.
    */
-  NoTextures = 1 << 0
+  NoTextures = 1 << 0,
+
+  /**
+   * Frustum-cull draws.
+   *
+   * Bounds of each mesh view are calculated in @ref Renderer::addFile() and
+   * every @ref Renderer::draw() tests them, transformed with the absolute
+   * node transformation, against the camera frustum of each scene. Culled
+   * draws are submitted with zero index count and draw batches with all
+   * draws culled are skipped. The culled and visible counts are reported in
+   * @ref SceneStats.
+   */
+  FrustumCulling = 1 << 1,
+
+  /**
+   * Output object IDs.
+   *
+   * The shaders write an object ID of each draw to a second color output,
+   * taken from @ref Renderer::objectIds() of its top-level node. The
+   * framebuffer passed to @ref Renderer::draw() is expected to have an
+   * integer attachment mapped to it, @ref RendererStandalone adds it
+   * implicitly.
+   */
+  ObjectId = 1 << 2,
+
+  /**
+   * Quantize mesh vertex attributes.
+   *
+   * Positions, normals, tangents and texture coordinates of meshes added with
+   * @ref Renderer::addFile() are packed into 16-bit formats with
+   * @ref quantizeMesh(), roughly halving their GPU memory and vertex fetch
+   * bandwidth. The position dequantization is folded into the mesh view
+   * transformations, so it's transparent to the nodes added with
+   * @ref Renderer::addNodeHierarchy(). Skinned meshes are kept as-is.
+   */
+  QuantizeVertices = 1 << 3
 
   // TODO memory-map
 };
@@ -50,8 +86,26 @@ Passed to @ref Renderer::Renderer(const RendererConfiguration&) and
 */
 struct RendererConfiguration {
   explicit RendererConfiguration();
+
+  /**
+   * @brief Copy constructor
+   *
+   * Useful for creating several renderers with the same configuration, such as
+   * one per GPU.
+   */
+  RendererConfiguration(const RendererConfiguration& other);
+
+  /** @brief Move constructor */
+  RendererConfiguration(RendererConfiguration&& other) noexcept;
+
   ~RendererConfiguration();
 
+  /** @brief Copy assignment */
+  RendererConfiguration& operator=(const RendererConfiguration& other);
+
+  /** @brief Move assignment */
+  RendererConfiguration& operator=(RendererConfiguration&& other) noexcept;
+
   /**
    * @brief Set renderer flags
    *
@@ -60,6 +114,13 @@ struct RendererConfiguration {
    */
   RendererConfiguration& setFlags(RendererFlags flags);
 
+  /**
+   * @brief Add renderer flags
+   *
+   * Calls @ref setFlags() with the existing flags ORed with @p flags.
+   */
+  RendererConfiguration& addFlags(RendererFlags flags);
+
   /**
    * @brief Set tile size and count
    *
@@ -81,6 +142,20 @@ struct RendererConfiguration {
   RendererConfiguration& setTileSizeCount(const Magnum::Vector2i& tileSize,
                                           const Magnum::Vector2i& tileCount);
 
+  /**
+   * @brief Set view count per scene
+   *
+   * By default each scene is rendered once, into a single tile. With
+   * @p count larger than @cpp 1 @ce, each scene is rendered into @p count
+   * consecutive tiles, each with its own camera set with
+   * @ref Renderer::updateCamera(Magnum::UnsignedInt, Magnum::UnsignedInt, const Magnum::Matrix4&, const Magnum::Matrix4&).
+   * Node transformations, lights and joints of a scene are calculated and
+   * uploaded just once for all its views. The product of the tile count is
+   * expected to be divisible by @p count.
+   * @see @ref Renderer::viewCount()
+   */
+  RendererConfiguration& setViewCount(Magnum::UnsignedInt count);
+
   /**
    * @brief Set max light count per draw
    *
@@ -91,6 +166,18 @@ struct RendererConfiguration {
    */
   RendererConfiguration& setMaxLightCount(Magnum::UnsignedInt count);
 
+  /**
+   * @brief Set max joint count per scene
+   *
+   * By default no joints are used, i.e. skinned meshes are drawn in their
+   * bind pose and skins aren't imported. If non-zero, skins referenced from
+   * the files are imported in @ref Renderer::addFile() and each skinned
+   * hierarchy added with @ref Renderer::addNodeHierarchy() takes as many
+   * joints as its skin has, posed with @ref Renderer::jointTransformations().
+   * @see @ref Renderer::maxJointCount()
+   */
+  RendererConfiguration& setMaxJointCount(Magnum::UnsignedInt count);
+
   /**
    * @brief Set ambient factor
    *
@@ -106,6 +193,27 @@ struct RendererConfiguration {
    */
   RendererConfiguration& setAmbientFactor(Magnum::Float factor);
 
+  /**
+   * @brief Set GPU memory budget for meshes and textures
+   *
+   * By default it's @cpp 0 @ce, which means no budget, and everything added
+   * with @ref Renderer::addFile() stays resident for the renderer lifetime.
+   * Otherwise, whenever the estimated size of resident meshes and textures
+   * exceeds @p bytes, meshes and textures that weren't used by any scene in
+   * the last @ref Renderer::draw() get evicted, least recently used first.
+   * Evicted data are streamed back in from the originating file once a scene
+   * references them again in @ref Renderer::draw().
+   *
+   * Eviction works on whole meshes and textures, so a composite file with a
+   * single texture array and mesh for all hierarchies is resident as long as
+   * any of its hierarchies is used. Split large datasets into several
+   * composite files to make use of this. Data used in a frame are never
+   * evicted, so the budget gets exceeded if the scenes need more.
+   * @see @ref Renderer::gpuMemoryBudget(), @ref Renderer::residencyStats(),
+   *    @ref SceneStats::residentSize
+   */
+  RendererConfiguration& setGpuMemoryBudget(std::size_t bytes);
+
  private:
   friend Renderer;
   struct State;
@@ -173,6 +281,7 @@ enum class RendererLightType {
 };
 
 struct SceneStats;
+struct ResidencyStats;
 
 // Even though Clang Format is told to skip formatting comments containing
 //  @section or @ref which can't be wrapped to prevent Doxygen bugs, it still
@@ -473,15 +582,41 @@ class Renderer {
    */
   Magnum::Vector2i tileCount() const;
 
+  /**
+   * @brief View count per scene
+   *
+   * By default each scene has a single view.
+   * @see @ref RendererConfiguration::setViewCount()
+   */
+  Magnum::UnsignedInt viewCount() const;
+
   /**
    * @brief Scene count
    *
    * Same as the @ref Magnum::Math::Vector::product() "product()" of
-   * @ref tileCount(). Empty scenes are not rendered, they only occupy space in
-   * the output framebuffer.
+   * @ref tileCount() divided by @ref viewCount(). Views of scene @cpp i @ce
+   * are rendered into tiles @cpp i*viewCount() @ce to
+   * @cpp (i + 1)*viewCount() - 1 @ce, counted row by row. Empty scenes are
+   * not rendered, they only occupy space in the output framebuffer.
    */
   std::size_t sceneCount() const;
 
+  /**
+   * @brief Change tile size and count
+   *
+   * Scenes with IDs less than the new @ref sceneCount() keep their contents
+   * and camera, scenes past it are discarded and newly added scenes are empty.
+   * The product of @p tileCount is expected to be divisible by
+   * @ref viewCount().
+   * Meshes, textures and materials added with @ref addFile() stay resident,
+   * so changing the batch size doesn't require reloading any file. The same
+   * GPU limits as described in @ref RendererConfiguration::setTileSizeCount()
+   * apply. @ref RendererStandalone resizes its framebuffer as well.
+   * @see @ref tileSize(), @ref tileCount()
+   */
+  virtual void setTileSizeCount(const Magnum::Vector2i& tileSize,
+                                const Magnum::Vector2i& tileCount);
+
   /**
    * @brief Max light count
    *
@@ -490,6 +625,22 @@ class Renderer {
    */
   Magnum::UnsignedInt maxLightCount() const;
 
+  /**
+   * @brief Max joint count per scene
+   *
+   * By default there's zero joints, i.e. no skinning.
+   * @see @ref RendererConfiguration::setMaxJointCount()
+   */
+  Magnum::UnsignedInt maxJointCount() const;
+
+  /**
+   * @brief GPU memory budget for meshes and textures
+   *
+   * By default there's no budget, i.e. @cpp 0 @ce.
+   * @see @ref RendererConfiguration::setGpuMemoryBudget()
+   */
+  std::size_t gpuMemoryBudget() const;
+
 #ifdef DOXYGEN_GENERATING_OUTPUT
   /**
    * @brief Add a file
@@ -563,6 +714,46 @@ class Renderer {
    */
   bool hasNodeHierarchy(Corrade::Containers::StringView name) const;
 
+  /**
+   * @brief Joint ID in a mesh hierarchy skin
+   * @param name            *Node hierarchy template* name, added with
+   *    @ref addFile() earlier
+   * @param jointName       Joint name, as named in the file
+   *
+   * Returns an index into @ref jointTransformations() for hierarchies added
+   * from @p name, or @cpp -1 @ce if the hierarchy isn't skinned or has no
+   * joint of given name. Always @cpp -1 @ce if @ref maxJointCount() is
+   * @cpp 0 @ce.
+   */
+  Magnum::Int jointId(Corrade::Containers::StringView name,
+                      Corrade::Containers::StringView jointName) const;
+
+  /**
+   * @brief Add a lower level of detail to a mesh hierarchy
+   * @param name            *Node hierarchy template* name, added with
+   *    @ref addFile() earlier
+   * @param lodName         Name of a node hierarchy template to use as the
+   *    lower level of detail, added with @ref addFile() earlier
+   * @param screenSize      Projected size of @p name relative to the tile
+   *    height below which @p lodName is drawn instead
+   * @return @cpp true @ce on success, prints a message to
+   *    @relativeref{Magnum,Error} and returns @cpp false @ce if either name
+   *    doesn't exist or they're the same
+   *
+   * Can be called several times to add more levels, a level with the
+   * smallest @p screenSize above the projected size is drawn, or @p name
+   * itself if the projected size is larger than all of them. The projected
+   * size is calculated in @ref draw() for each scene from bounds of @p name
+   * and the scene camera. Affects only hierarchies added with
+   * @ref addNodeHierarchy() after this call. The draws of all levels are
+   * added directly under the returned top-level node, which means the IDs of
+   * subsequently added nodes are shifted by the draw count of the lower
+   * levels.
+   */
+  bool addNodeHierarchyLod(Corrade::Containers::StringView name,
+                           Corrade::Containers::StringView lodName,
+                           Magnum::Float screenSize);
+
 #ifdef DOXYGEN_GENERATING_OUTPUT
   /**
    * @brief Add a mesh hierarchy
@@ -643,18 +834,60 @@ class Renderer {
    * @brief Get the combined projection and view matrices of a camera
    * (read-only)
    * @param sceneId Scene ID, expected to be less than @ref sceneCount()
+   * @param viewId  View ID, expected to be less than @ref viewCount()
+   */
+  Magnum::Matrix4 camera(Magnum::UnsignedInt sceneId,
+                         Magnum::UnsignedInt viewId) const;
+
+  /**
+   * @brief Get the combined projection and view matrices of the first camera
+   * (read-only)
+   *
+   * Same as calling @ref camera(Magnum::UnsignedInt, Magnum::UnsignedInt) const
+   * with @p viewId set to @cpp 0 @ce.
    */
   Magnum::Matrix4 camera(Magnum::UnsignedInt sceneId) const;
 
   /**
    * @brief Get the depth unprojection parameters of a camera (read-only)
    * @param sceneId Scene ID, expected to be less than @ref sceneCount()
+   * @param viewId  View ID, expected to be less than @ref viewCount()
+   */
+  Magnum::Vector2 cameraDepthUnprojection(Magnum::UnsignedInt sceneId,
+                                          Magnum::UnsignedInt viewId) const;
+
+  /**
+   * @brief Get the depth unprojection parameters of the first camera
+   * (read-only)
+   *
+   * Same as calling @ref cameraDepthUnprojection(Magnum::UnsignedInt, Magnum::UnsignedInt) const
+   * with @p viewId set to @cpp 0 @ce.
    */
   Magnum::Vector2 cameraDepthUnprojection(Magnum::UnsignedInt sceneId) const;
 
+  /**
+   * @brief Get the projection matrix of a camera alone (read-only)
+   * @param sceneId Scene ID, expected to be less than @ref sceneCount()
+   * @param viewId  View ID, expected to be less than @ref viewCount()
+   *
+   * Used for unprojecting the depth output to camera-space points, see
+   * @ref RendererStandalone::pointCloudImage().
+   */
+  Magnum::Matrix4 cameraProjection(Magnum::UnsignedInt sceneId,
+                                   Magnum::UnsignedInt viewId) const;
+
+  /**
+   * @brief Get the projection matrix of the first camera alone (read-only)
+   *
+   * Same as calling @ref cameraProjection(Magnum::UnsignedInt, Magnum::UnsignedInt) const
+   * with @p viewId set to @cpp 0 @ce.
+   */
+  Magnum::Matrix4 cameraProjection(Magnum::UnsignedInt sceneId) const;
+
   /**
    * @brief Set the camera projection and view matrices
    * @param sceneId     Scene ID, expected to be less than @ref sceneCount()
+   * @param viewId      View ID, expected to be less than @ref viewCount()
    * @param view        View matrix of the camera (inverse transform)
    * @param projection  Projection matrix of the camera
    *
@@ -663,9 +896,40 @@ class Renderer {
    * @ref draw().
    */
   void updateCamera(Magnum::UnsignedInt sceneId,
+                    Magnum::UnsignedInt viewId,
                     const Magnum::Matrix4& projection,
                     const Magnum::Matrix4& view);
 
+  /**
+   * @brief Set the projection and view matrices of the first camera
+   *
+   * Same as calling @ref updateCamera(Magnum::UnsignedInt, Magnum::UnsignedInt, const Magnum::Matrix4&, const Magnum::Matrix4&)
+   * with @p viewId set to @cpp 0 @ce.
+   */
+  void updateCamera(Magnum::UnsignedInt sceneId,
+                    const Magnum::Matrix4& projection,
+                    const Magnum::Matrix4& view);
+
+  /**
+   * @brief Set projection and view matrices of all cameras at once
+   * @param projections Projection matrices of all cameras
+   * @param views       View matrices of all cameras (inverse transforms)
+   *
+   * Both views are expected to have a size of @ref sceneCount() multiplied by
+   * @ref viewCount(), ordered by scene and then by view, i.e. in the same
+   * order as the tiles. Equivalent to calling
+   * @ref updateCamera(Magnum::UnsignedInt, Magnum::UnsignedInt, const Magnum::Matrix4&, const Magnum::Matrix4&)
+   * for every scene and view, but without the per-call checks, which matters
+   * when the matrices come from a language binding. The matrices are
+   * uploaded in a single call in the next @ref draw(), same as with
+   * @ref updateCamera().
+   */
+  void updateCameras(
+      const Corrade::Containers::StridedArrayView1D<const Magnum::Matrix4>&
+          projections,
+      const Corrade::Containers::StridedArrayView1D<const Magnum::Matrix4>&
+          views);
+
   /**
    * @brief Transformations of all nodes in the scene
    * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
@@ -682,6 +946,58 @@ class Renderer {
   Corrade::Containers::StridedArrayView1D<Magnum::Matrix4> transformations(
       Magnum::UnsignedInt sceneId);
 
+  /**
+   * @brief Update node transformations in any scenes at once
+   * @param sceneIds        Scene IDs, expected to be less than
+   *    @ref sceneCount()
+   * @param nodeIds         Node IDs, expected to be in bounds of
+   *    @ref transformations() of the corresponding scene
+   * @param transformations New transformations of the nodes
+   *
+   * All three views are expected to have the same size. Equivalent to
+   * assigning @p transformations to @ref transformations() of every scene and
+   * node, but in a single call instead of one per scene, which matters when
+   * the transformations come from a language binding. Modifications are taken
+   * into account in the next @ref draw().
+   */
+  void updateTransformations(
+      const Corrade::Containers::StridedArrayView1D<const Magnum::UnsignedInt>&
+          sceneIds,
+      const Corrade::Containers::StridedArrayView1D<const Magnum::UnsignedInt>&
+          nodeIds,
+      const Corrade::Containers::StridedArrayView1D<const Magnum::Matrix4>&
+          transformations);
+
+  /**
+   * @brief Joint transformations of a skinned hierarchy
+   * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
+   * @param nodeId    Node ID returned from @ref addNodeHierarchy() for a
+   *    skinned hierarchy
+   *
+   * Returns a view on transformations of all joints of the hierarchy skin,
+   * relative to the node @p nodeId, indexed by @ref jointId(). Modifications
+   * are taken into account in the next @ref draw(). By default, the joints
+   * are in the bind pose of the skin.
+   */
+  Corrade::Containers::StridedArrayView1D<Magnum::Matrix4> jointTransformations(
+      Magnum::UnsignedInt sceneId,
+      std::size_t nodeId);
+
+  /**
+   * @brief Object IDs of all nodes in the scene
+   * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
+   *
+   * Returns a view on object IDs of all nodes in given scene, of the same size
+   * as @ref transformations(). Draws use the ID of the root node they're
+   * under, i.e. the node returned from @ref addNodeHierarchy() or
+   * @ref addEmptyNode(), so updating IDs at other indices has no effect.
+   * Modifications are taken into account in the next @ref draw(). By
+   * default, all IDs are @cpp 0 @ce. Used only if @ref RendererFlag::ObjectId
+   * is enabled.
+   */
+  Corrade::Containers::StridedArrayView1D<Magnum::UnsignedInt> objectIds(
+      Magnum::UnsignedInt sceneId);
+
   /**
    * @brief Colors of all lights in the scene
    * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
@@ -721,6 +1037,33 @@ class Renderer {
    */
   void draw(Magnum::GL::AbstractFramebuffer& framebuffer);
 
+  /**
+   * @brief Whether the GPU duration of @ref draw() is measured
+   *
+   * Disabled by default.
+   */
+  bool isGpuTimerEnabled() const;
+
+  /**
+   * @brief Enable or disable measuring the GPU duration of @ref draw()
+   *
+   * The scene draws are then bracketed with timestamp queries, collected with
+   * @ref takeGpuDrawDuration() without stalling the pipeline. Measures
+   * nothing if @ref GpuTimer::isSupported() is @cpp false @ce.
+   */
+  void setGpuTimerEnabled(bool enabled);
+
+  /**
+   * @brief Take the GPU duration of the oldest finished measured @ref draw()
+   * @return Duration in nanoseconds, or
+   *    @relativeref{Corrade,Containers::NullOpt} if no measured draw finished
+   *    on the GPU yet
+   *
+   * Call repeatedly to take all finished measurements.
+   * @see @ref setGpuTimerEnabled()
+   */
+  Corrade::Containers::Optional<Magnum::UnsignedLong> takeGpuDrawDuration();
+
   /**
    * @brief Scene stats
    *
@@ -729,6 +1072,14 @@ class Renderer {
    */
   SceneStats sceneStats(Magnum::UnsignedInt sceneId) const;
 
+  /**
+   * @brief Mesh and texture residency stats
+   *
+   * Up-to-date after each @ref addFile() and @ref draw().
+   * @see @ref RendererConfiguration::setGpuMemoryBudget()
+   */
+  ResidencyStats residencyStats() const;
+
 #ifndef DOXYGEN_GENERATING_OUTPUT
  protected:
   /* used by RendererStandalone */
@@ -771,6 +1122,97 @@ struct SceneStats {
    * @ref drawCount.
    */
   std::size_t drawBatchCount;
+
+  /**
+   * @brief Count of draws culled in the last draw
+   *
+   * Counted for the first view if @ref Renderer::viewCount() is larger than
+   * @cpp 1 @ce. Always zero if @ref RendererFlag::FrustumCulling isn't
+   * enabled. The returned info is up-to-date only if @ref Renderer::draw()
+   * has been called before.
+   */
+  std::size_t culledDrawCount;
+
+  /**
+   * @brief Count of draws of levels of detail not selected in the last draw
+   *
+   * Counted for the first view if @ref Renderer::viewCount() is larger than
+   * @cpp 1 @ce. Always zero if no hierarchies with levels of detail were
+   * added, see @ref Renderer::addNodeHierarchyLod(). The returned info is
+   * up-to-date only if @ref Renderer::draw() has been called before.
+   */
+  std::size_t inactiveLodDrawCount;
+
+  /**
+   * @brief Count of draws submitted in the last draw
+   *
+   * Same as @ref drawCount minus @ref culledDrawCount and
+   * @ref inactiveLodDrawCount.
+   */
+  std::size_t visibleDrawCount;
+
+  /**
+   * @brief Count of unique meshes referenced by the draw batches
+   *
+   * Never larger than @ref drawBatchCount.
+   */
+  std::size_t meshCount;
+
+  /**
+   * @brief Count of unique textures referenced by the draw batches
+   *
+   * Never larger than @ref drawBatchCount. Untextured draws reference a
+   * builtin texture. Zero with @ref RendererFlag::NoTextures.
+   */
+  std::size_t textureCount;
+
+  /**
+   * @brief Estimated GPU memory size of resident meshes and textures
+   *    referenced by the scene, in bytes
+   *
+   * After @ref Renderer::draw() all data referenced by a scene are resident.
+   * Data can be shared by several scenes, so the sum across scenes may be
+   * larger than @ref ResidencyStats::residentSize.
+   * @see @ref RendererConfiguration::setGpuMemoryBudget()
+   */
+  std::size_t residentSize;
+};
+
+/**
+@brief Mesh and texture residency statistics
+
+Returned by @ref Renderer::residencyStats().
+@see @ref RendererConfiguration::setGpuMemoryBudget()
+*/
+struct ResidencyStats {
+  /** @brief GPU memory budget in bytes, @cpp 0 @ce if there's none */
+  std::size_t gpuMemoryBudget;
+
+  /** @brief Estimated GPU memory size of all resident data, in bytes */
+  std::size_t residentSize;
+
+  /** @brief Count of meshes added with @ref Renderer::addFile() */
+  std::size_t meshCount;
+
+  /** @brief Count of meshes currently resident */
+  std::size_t residentMeshCount;
+
+  /**
+   * @brief Count of textures
+   *
+   * Includes a builtin texture used by untextured draws, which is never
+   * evicted.
+   */
+  std::size_t textureCount;
+
+  /** @brief Count of textures currently resident */
+  std::size_t residentTextureCount;
+
+  /** @brief Total count of meshes and textures streamed back in */
+  std::size_t streamedCount;
+
+  /** @brief Total count of meshes and textures evicted */
+  std::size_t evictedCount;
 };
 
 }  // namespace gfx_batch
@@ -7,12 +7,20 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/BufferImage.h>
+#include <Magnum/GL/Context.h>
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Sampler.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/PhongGL.h>
+
+#include "DepthUnprojection.h"
 
 #ifdef MAGNUM_TARGET_EGL
 #include <Magnum/Platform/WindowlessEglApplication.h>
@@ -66,13 +74,27 @@ struct RendererStandalone::State {
   RendererStandaloneFlags flags;
   Mn::Platform::WindowlessGLContext context;
   Mn::Platform::GLContext magnumContext{Mn::NoCreate};
-  Mn::GL::Renderbuffer color{Mn::NoCreate}, depth{Mn::NoCreate};
+  Mn::GL::Renderbuffer color{Mn::NoCreate}, depth{Mn::NoCreate},
+      objectId{Mn::NoCreate};
   Mn::GL::Framebuffer framebuffer{Mn::NoCreate};
   Mn::GL::BufferImage2D colorBuffer{Mn::NoCreate};
   Mn::GL::BufferImage2D depthBuffer{Mn::NoCreate};
+  /* Created only with RendererFlag::ObjectId */
+  Mn::GL::BufferImage2D objectIdBuffer{Mn::NoCreate};
+  /* Created on the first point cloud retrieval. The depth renderbuffer can't
+     be sampled, so it's blitted to a texture first. */
+  Cr::Containers::Optional<DepthShader> pointCloudShader;
+  Mn::GL::Mesh fullscreenTriangle{Mn::NoCreate};
+  Mn::GL::Texture2D pointCloudDepth{Mn::NoCreate};
+  Mn::GL::Framebuffer pointCloudDepthFramebuffer{Mn::NoCreate};
+  Mn::GL::Renderbuffer pointCloud{Mn::NoCreate};
+  Mn::GL::Framebuffer pointCloudFramebuffer{Mn::NoCreate};
+  Mn::GL::BufferImage2D pointCloudBuffer{Mn::NoCreate};
 #ifdef ESP_BUILD_WITH_CUDA
   cudaGraphicsResource* cudaColorBuffer{};
   cudaGraphicsResource* cudaDepthBuffer{};
+  cudaGraphicsResource* cudaObjectIdBuffer{};
+  cudaGraphicsResource* cudaPointCloudBuffer{};
 #endif
 
   explicit State(const RendererStandaloneConfiguration& configuration)
@@ -97,17 +119,87 @@ struct RendererStandalone::State {
     depth = Mn::GL::Renderbuffer{};
   }
 
+  /* Unprojects the depth of each tile into pointCloudFramebuffer, using the
+     projection of the scene view drawn to the tile */
+  void drawPointCloud(const RendererStandalone& renderer) {
+    const Mn::Vector2i tileSize = renderer.tileSize();
+    const Mn::Vector2i tileCount = renderer.tileCount();
+    const Mn::Vector2i size = tileSize * tileCount;
+
+    if (!pointCloudShader) {
+      pointCloudShader.emplace(DepthShader::Flag::UnprojectExistingDepth |
+                               DepthShader::Flag::UnprojectToPoints);
+      /* Vertex positions are generated from gl_VertexID */
+      fullscreenTriangle = Mn::GL::Mesh{};
+      fullscreenTriangle.setCount(3);
+    }
+
+    /* (Re)created lazily, also after a tile size / count change */
+    if (!pointCloudDepth.id()) {
+      pointCloudDepth = Mn::GL::Texture2D{};
+      pointCloudDepth.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, size);
+      pointCloudDepthFramebuffer = Mn::GL::Framebuffer{Mn::Range2Di{{}, size}};
+      pointCloudDepthFramebuffer.attachTexture(
+          Mn::GL::Framebuffer::BufferAttachment::Depth, pointCloudDepth, 0);
+      pointCloud = Mn::GL::Renderbuffer{};
+      pointCloud.setStorage(Mn::GL::RenderbufferFormat::RGBA32F, size);
+      pointCloudFramebuffer = Mn::GL::Framebuffer{Mn::Range2Di{{}, size}};
+      pointCloudFramebuffer.attachRenderbuffer(
+          Mn::GL::Framebuffer::ColorAttachment{0}, pointCloud);
+    }
+
+    Mn::GL::AbstractFramebuffer::blit(framebuffer, pointCloudDepthFramebuffer,
+                                      {{}, size},
+                                      Mn::GL::FramebufferBlit::Depth);
+
+    /* The point cloud framebuffer has no depth attachment, so depth test
+       passes always and every pixel of every tile gets written */
+    pointCloudFramebuffer.bind();
+    pointCloudShader->bindDepthTexture(pointCloudDepth);
+    const Mn::UnsignedInt viewCount = renderer.viewCount();
+    for (Mn::Int y = 0; y != tileCount.y(); ++y) {
+      for (Mn::Int x = 0; x != tileCount.x(); ++x) {
+        const Mn::UnsignedInt tileId = y * tileCount.x() + x;
+        pointCloudFramebuffer.setViewport(
+            Mn::Range2Di::fromSize(Mn::Vector2i{x, y} * tileSize, tileSize));
+        pointCloudShader
+            ->setProjectionMatrix(renderer.cameraProjection(
+                tileId / viewCount, tileId % viewCount))
+            .draw(fullscreenTriangle);
+      }
+    }
+  }
+
 #ifdef ESP_BUILD_WITH_CUDA
-  ~State() {
-    /* Should be unmapped before the GL object gets destroyed, I guess? */
+  void unregisterCudaBuffers() {
     if (cudaColorBuffer) {
       checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaColorBuffer, 0));
       checkCudaErrors(cudaGraphicsUnregisterResource(cudaColorBuffer));
+      cudaColorBuffer = nullptr;
     }
     if (cudaDepthBuffer) {
       checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaDepthBuffer, 0));
       checkCudaErrors(cudaGraphicsUnregisterResource(cudaDepthBuffer));
+      cudaDepthBuffer = nullptr;
+    }
+    if (cudaObjectIdBuffer) {
+      checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaObjectIdBuffer, 0));
+      checkCudaErrors(cudaGraphicsUnregisterResource(cudaObjectIdBuffer));
+      cudaObjectIdBuffer = nullptr;
     }
+    if (cudaPointCloudBuffer) {
+      checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaPointCloudBuffer, 0));
+      checkCudaErrors(cudaGraphicsUnregisterResource(cudaPointCloudBuffer));
+      cudaPointCloudBuffer = nullptr;
+    }
+  }
+
+  ~State() {
+    /* Should be unmapped before the GL object gets destroyed, I guess? */
+    unregisterCudaBuffers();
   }
 #endif
 };
@@ -128,10 +220,27 @@ RendererStandalone::RendererStandalone(
                           state_->color)
       .attachRenderbuffer(Mn::GL::Framebuffer::BufferAttachment::Depth,
                           state_->depth);
+  /* Object IDs go to a second color attachment, mapped to the shader output
+     location */
+  if (flags() & RendererFlag::ObjectId) {
+    state_->objectId = Mn::GL::Renderbuffer{};
+    state_->objectId.setStorage(Mn::GL::RenderbufferFormat::R32UI, size);
+    state_->framebuffer
+        .attachRenderbuffer(Mn::GL::Framebuffer::ColorAttachment{1},
+                            state_->objectId)
+        .mapForDraw({{Mn::Shaders::PhongGL::ColorOutput,
+                      Mn::GL::Framebuffer::ColorAttachment{0}},
+                     {Mn::Shaders::PhongGL::ObjectIdOutput,
+                      Mn::GL::Framebuffer::ColorAttachment{1}}});
+  }
   /* Defer the buffer initialization to the point when it's actually read
      into */
   state_->colorBuffer = Mn::GL::BufferImage2D{colorFramebufferFormat()};
   state_->depthBuffer = Mn::GL::BufferImage2D{depthFramebufferFormat()};
+  if (flags() & RendererFlag::ObjectId)
+    state_->objectIdBuffer = Mn::GL::BufferImage2D{objectIdFramebufferFormat()};
+  state_->pointCloudBuffer =
+      Mn::GL::BufferImage2D{pointCloudFramebufferFormat()};
 }
 
 RendererStandalone::~RendererStandalone() {
@@ -144,6 +253,16 @@ RendererStandaloneFlags RendererStandalone::standaloneFlags() const {
   return state_->flags;
 }
 
+void RendererStandalone::makeContextCurrent() {
+  state_->context.makeCurrent();
+  Mn::GL::Context::makeCurrent(&state_->magnumContext);
+}
+
+void RendererStandalone::releaseContext() {
+  Mn::GL::Context::makeCurrent(nullptr);
+  state_->context.release();
+}
+
 Mn::PixelFormat RendererStandalone::colorFramebufferFormat() const {
   return Mn::PixelFormat::RGBA8Unorm;
 }
@@ -152,9 +271,48 @@ Mn::PixelFormat RendererStandalone::depthFramebufferFormat() const {
   return Mn::PixelFormat::Depth32F;
 }
 
+Mn::PixelFormat RendererStandalone::objectIdFramebufferFormat() const {
+  return Mn::PixelFormat::R32UI;
+}
+
+Mn::PixelFormat RendererStandalone::pointCloudFramebufferFormat() const {
+  return Mn::PixelFormat::RGBA32F;
+}
+
+void RendererStandalone::setTileSizeCount(const Mn::Vector2i& tileSize,
+                                          const Mn::Vector2i& tileCount) {
+  Renderer::setTileSizeCount(tileSize, tileCount);
+
+#ifdef ESP_BUILD_WITH_CUDA
+  /* The buffers get reallocated on the next read, the registrations would
+     refer to the old storage */
+  state_->unregisterCudaBuffers();
+#endif
+
+  /* The renderbuffers stay attached, only their storage is respecified */
+  const Mn::Vector2i size = tileSize * tileCount;
+  state_->color.setStorage(Mn::GL::RenderbufferFormat::RGBA8, size);
+  state_->depth.setStorage(Mn::GL::RenderbufferFormat::DepthComponent32F, size);
+  if (flags() & RendererFlag::ObjectId)
+    state_->objectId.setStorage(Mn::GL::RenderbufferFormat::R32UI, size);
+  state_->framebuffer.setViewport(Mn::Range2Di{{}, size});
+
+  /* The point cloud texture storage is immutable, recreate everything on the
+     next retrieval instead */
+  state_->pointCloudDepth = Mn::GL::Texture2D{Mn::NoCreate};
+  state_->pointCloudDepthFramebuffer = Mn::GL::Framebuffer{Mn::NoCreate};
+  state_->pointCloud = Mn::GL::Renderbuffer{Mn::NoCreate};
+  state_->pointCloudFramebuffer = Mn::GL::Framebuffer{Mn::NoCreate};
+}
+
 void RendererStandalone::draw() {
   state_->framebuffer.clear(Mn::GL::FramebufferClear::Color |
                             Mn::GL::FramebufferClear::Depth);
+  /* The float clear color is undefined for integer attachments, clear the
+     object IDs explicitly */
+  if (flags() & RendererFlag::ObjectId)
+    state_->framebuffer.clearColor(Mn::Shaders::PhongGL::ObjectIdOutput,
+                                   Mn::Vector4ui{});
   Renderer::draw(state_->framebuffer);
 }
 
@@ -201,6 +359,45 @@ void RendererStandalone::depthImageInto(const Magnum::Range2Di& rectangle,
   return state_->framebuffer.read(rectangle, image);
 }
 
+Mn::Image2D RendererStandalone::objectIdImage() {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdImage(): RendererFlag::ObjectId "
+                 "not enabled",
+                 (Mn::Image2D{objectIdFramebufferFormat()}));
+  /* Not using state_->framebuffer.viewport() as it's left pointing to whatever
+     tile was rendered last */
+  state_->framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{1});
+  Mn::Image2D out = state_->framebuffer.read({{}, tileCount() * tileSize()},
+                                             objectIdFramebufferFormat());
+  state_->framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+  return out;
+}
+
+void RendererStandalone::objectIdImageInto(
+    const Magnum::Range2Di& rectangle,
+    const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdImageInto(): "
+                 "RendererFlag::ObjectId not enabled", );
+  CORRADE_ASSERT(rectangle.max() <= tileCount() * tileSize(),
+                 "RendererStandalone::objectIdImageInto():"
+                     << rectangle << "doesn't fit in a size of"
+                     << tileCount() * tileSize(), );
+  CORRADE_ASSERT(image.size() == rectangle.size(),
+                 "RendererStandalone::objectIdImageInto(): expected image size "
+                 "of" << rectangle.size()
+                      << "pixels but got" << image.size(), );
+  state_->framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{1})
+      .read(rectangle, image);
+  state_->framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+}
+
+Mn::Image2D RendererStandalone::pointCloudImage() {
+  state_->drawPointCloud(*this);
+  return state_->pointCloudFramebuffer.read({{}, tileCount() * tileSize()},
+                                            pointCloudFramebufferFormat());
+}
+
 #ifdef ESP_BUILD_WITH_CUDA
 const void* RendererStandalone::colorCudaBufferDevicePointer() {
   /* If the CUDA buffer exists already, it's mapped from the previous call.
@@ -261,6 +458,78 @@ const void* RendererStandalone::depthCudaBufferDevicePointer() {
                                       state_->depthBuffer.pixelSize());
   return pointer;
 }
+
+const void* RendererStandalone::objectIdCudaBufferDevicePointer() {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdCudaBufferDevicePointer(): "
+                 "RendererFlag::ObjectId not enabled",
+                 nullptr);
+
+  /* If the CUDA buffer exists already, it's mapped from the previous call.
+     Unmap it first so we can read into it from GL. */
+  if (state_->cudaObjectIdBuffer)
+    checkCudaErrors(
+        cudaGraphicsUnmapResources(1, &state_->cudaObjectIdBuffer, 0));
+
+  /* Read to the buffer image, allocating it if it's not already. Can't really
+     return a pointer directly to the renderbuffer because the returned device
+     pointer is expected to be linearized. */
+  state_->framebuffer
+      .mapForRead(Mn::GL::Framebuffer::ColorAttachment{1})
+      .read({{}, tileCount() * tileSize()}, state_->objectIdBuffer,
+            Mn::GL::BufferUsage::DynamicRead);
+  state_->framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+
+  /* Initialize the CUDA buffer from the GL buffer image if it's not already */
+  if (!state_->cudaObjectIdBuffer) {
+    checkCudaErrors(cudaGraphicsGLRegisterBuffer(
+        &state_->cudaObjectIdBuffer, state_->objectIdBuffer.buffer().id(),
+        cudaGraphicsRegisterFlagsReadOnly));
+  }
+
+  /* Map the buffer and return the device pointer */
+  checkCudaErrors(cudaGraphicsMapResources(1, &state_->cudaObjectIdBuffer, 0));
+  void* pointer;
+  std::size_t size;
+  checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
+      &pointer, &size, state_->cudaObjectIdBuffer));
+  CORRADE_INTERNAL_ASSERT(size == state_->objectIdBuffer.size().product() *
+                                      state_->objectIdBuffer.pixelSize());
+  return pointer;
+}
+
+const void* RendererStandalone::pointCloudCudaBufferDevicePointer() {
+  /* If the CUDA buffer exists already, it's mapped from the previous call.
+     Unmap it first so we can read into it from GL. */
+  if (state_->cudaPointCloudBuffer)
+    checkCudaErrors(
+        cudaGraphicsUnmapResources(1, &state_->cudaPointCloudBuffer, 0));
+
+  /* Unproject on the GPU and read to the buffer image, allocating it if it's
+     not already. The data never leave the GPU. */
+  state_->drawPointCloud(*this);
+  state_->pointCloudFramebuffer.read({{}, tileCount() * tileSize()},
+                                     state_->pointCloudBuffer,
+                                     Mn::GL::BufferUsage::DynamicRead);
+
+  /* Initialize the CUDA buffer from the GL buffer image if it's not already */
+  if (!state_->cudaPointCloudBuffer) {
+    checkCudaErrors(cudaGraphicsGLRegisterBuffer(
+        &state_->cudaPointCloudBuffer, state_->pointCloudBuffer.buffer().id(),
+        cudaGraphicsRegisterFlagsReadOnly));
+  }
+
+  /* Map the buffer and return the device pointer */
+  checkCudaErrors(
+      cudaGraphicsMapResources(1, &state_->cudaPointCloudBuffer, 0));
+  void* pointer;
+  std::size_t size;
+  checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
+      &pointer, &size, state_->cudaPointCloudBuffer));
+  CORRADE_INTERNAL_ASSERT(size == state_->pointCloudBuffer.size().product() *
+                                      state_->pointCloudBuffer.pixelSize());
+  return pointer;
+}
 #endif
 
 }  // namespace gfx_batch
@@ -138,6 +138,25 @@ class RendererStandalone : public Renderer {
    */
   RendererStandaloneFlags standaloneFlags() const;
 
+  /**
+   * @brief Make the GPU context of this renderer current
+   *
+   * The context is made current on the thread constructing the renderer. When
+   * several standalone renderers are used in one process, such as one per GPU,
+   * or the renderer is used from another thread, call this before calling any
+   * other function. A context can be current on only one thread at a time,
+   * release it with @ref releaseContext() before making it current on
+   * another thread.
+   */
+  void makeContextCurrent();
+
+  /**
+   * @brief Release the GPU context from the calling thread
+   *
+   * @see @ref makeContextCurrent()
+   */
+  void releaseContext();
+
   /**
    * @brief Color framebuffer format
    *
@@ -158,6 +177,42 @@ class RendererStandalone : public Renderer {
    */
   Magnum::PixelFormat depthFramebufferFormat() const;
 
+  /**
+   * @brief Object ID framebuffer format
+   *
+   * Format in which @ref objectIdImage() and
+   * @ref objectIdCudaBufferDevicePointer() is returned. At the moment
+   * @ref Magnum::PixelFormat::R32UI. Framebuffer size is @ref tileSize()
+   * multiplied by @ref tileCount(). The framebuffer is present only if
+   * @ref RendererFlag::ObjectId is enabled.
+   * @see @ref Magnum::pixelFormatSize()
+   */
+  Magnum::PixelFormat objectIdFramebufferFormat() const;
+
+  /**
+   * @brief Point cloud framebuffer format
+   *
+   * Format in which @ref pointCloudImage() and
+   * @ref pointCloudCudaBufferDevicePointer() is returned. At the moment
+   * @ref Magnum::PixelFormat::RGBA32F. Framebuffer size is @ref tileSize()
+   * multiplied by @ref tileCount().
+   * @see @ref Magnum::pixelFormatSize()
+   */
+  Magnum::PixelFormat pointCloudFramebufferFormat() const;
+
+  /**
+   * @brief Change tile size and count
+   *
+   * In addition to @ref Renderer::setTileSizeCount(), resizes the internal
+   * framebuffer to the new @ref tileSize() multiplied by @ref tileCount().
+   * Pointers previously returned from @ref colorCudaBufferDevicePointer(),
+   * @ref depthCudaBufferDevicePointer(),
+   * @ref objectIdCudaBufferDevicePointer() and
+   * @ref pointCloudCudaBufferDevicePointer() are invalidated.
+   */
+  void setTileSizeCount(const Magnum::Vector2i& tileSize,
+                        const Magnum::Vector2i& tileCount) override;
+
   /**
    * @brief Draw all scenes
    *
@@ -213,6 +268,44 @@ class RendererStandalone : public Renderer {
   void depthImageInto(const Magnum::Range2Di& rectangle,
                       const Magnum::MutableImageView2D& image);
 
+  /**
+   * @brief Retrieve the rendered object ID output
+   *
+   * Expects that @ref RendererFlag::ObjectId is enabled. Stalls the CPU until
+   * the GPU finishes the last @ref draw() and then returns an image in
+   * @ref objectIdFramebufferFormat() and with size being @ref tileSize()
+   * multiplied by @ref tileCount(). Pixels not covered by any draw are
+   * @cpp 0 @ce.
+   */
+  Magnum::Image2D objectIdImage();
+
+  /**
+   * @brief Retrieve the rendered object ID output into a pre-allocated
+   * location
+   *
+   * Expects that @ref RendererFlag::ObjectId is enabled, that @p rectangle
+   * is contained in a size defined by @ref tileSize() multiplied by
+   * @ref tileCount(), that @p image size corresponds to @p rectangle size and
+   * that its format is compatible with @ref objectIdFramebufferFormat().
+   */
+  void objectIdImageInto(const Magnum::Range2Di& rectangle,
+                         const Magnum::MutableImageView2D& image);
+
+  /**
+   * @brief Retrieve the depth output unprojected to a point cloud
+   *
+   * Unprojects the depth of each tile on the GPU using
+   * @ref cameraProjection() of the scene drawn to it. Stalls the CPU until the
+   * GPU finishes and then returns an image in
+   * @ref pointCloudFramebufferFormat() and with size being @ref tileSize()
+   * multiplied by @ref tileCount(). The XYZ channels of each pixel are a
+   * position in the space of the camera, i.e. with Y up and -Z forward, W is
+   * @cpp 1.0f @ce. Pixels on the far plane are all zeros. Intended mainly for
+   * testing and debugging, use @ref pointCloudCudaBufferDevicePointer() to
+   * consume the data without a CPU round trip.
+   */
+  Magnum::Image2D pointCloudImage();
+
 #if defined(ESP_BUILD_WITH_CUDA) || defined(DOXYGEN_GENERATING_OUTPUT)
   /**
    * @brief Retrieve the rendered color output as a CUDA device pointer
@@ -233,6 +326,29 @@ class RendererStandalone : public Renderer {
    * and @ref tileCount(), and returns its device pointer.
    */
   const void* depthCudaBufferDevicePointer();
+
+  /**
+   * @brief Retrieve the rendered object ID output as a CUDA device pointer
+   *
+   * Expects that @ref RendererFlag::ObjectId is enabled. Copies the internal
+   * framebuffer into a linearized and tightly-packed CUDA buffer of
+   * @ref objectIdFramebufferFormat() and with size given by the
+   * @ref Magnum::Math::Vector::product() "product()" of @ref tileSize()
+   * and @ref tileCount(), and returns its device pointer.
+   */
+  const void* objectIdCudaBufferDevicePointer();
+
+  /**
+   * @brief Retrieve the depth output unprojected to a point cloud as a CUDA
+   * device pointer
+   *
+   * Performs the same unprojection as @ref pointCloudImage() on the GPU and
+   * copies the result into a linearized and tightly-packed CUDA buffer of
+   * @ref pointCloudFramebufferFormat() and with size given by the
+   * @ref Magnum::Math::Vector::product() "product()" of @ref tileSize()
+   * and @ref tileCount(), and returns its device pointer.
+   */
+  const void* pointCloudCudaBufferDevicePointer();
 #endif
 
  private:
@@ -9,6 +9,7 @@
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <glob.h>
+#include <sys/stat.h>
 
 namespace Cr = Corrade;
 namespace esp {
@@ -59,5 +60,25 @@ std::vector<std::string> globDirs(const std::string& pattern) {
   return ret;
 }
 
+bool getFileStamp(const std::string& path,
+                  std::uint64_t& modified,
+                  std::uint64_t& size) {
+  struct stat info {};
+  if (stat(path.c_str(), &info) != 0) {
+    return false;
+  }
+#if defined(CORRADE_TARGET_APPLE)
+  modified = std::uint64_t(info.st_mtimespec.tv_sec) * 1000000000ull +
+             std::uint64_t(info.st_mtimespec.tv_nsec);
+#elif defined(CORRADE_TARGET_UNIX)
+  modified = std::uint64_t(info.st_mtim.tv_sec) * 1000000000ull +
+             std::uint64_t(info.st_mtim.tv_nsec);
+#else
+  modified = std::uint64_t(info.st_mtime) * 1000000000ull;
+#endif
+  size = std::uint64_t(info.st_size);
+  return true;
+}  // getFileStamp
+
 }  // namespace io
 }  // namespace esp
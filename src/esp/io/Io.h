@@ -5,6 +5,7 @@
 #ifndef ESP_IO_IO_H_
 #define ESP_IO_IO_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,20 @@ std::string normalizePath(const std::string& srcPath);
  */
 std::vector<std::string> globDirs(const std::string& pattern);
 
+/**
+ * @brief Get the modification time, in nanoseconds, and the size of the file
+ * or directory at @p path, so callers can tell whether it changed since they
+ * last read it.
+ * @param path The path to query
+ * @param[out] modified The modification time
+ * @param[out] size The size in bytes
+ * @return false if @p path does not exist, in which case the outputs are left
+ * untouched.
+ */
+bool getFileStamp(const std::string& path,
+                  std::uint64_t& modified,
+                  std::uint64_t& size);
+
 }  // namespace io
 }  // namespace esp
 
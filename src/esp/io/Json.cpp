@@ -9,10 +9,13 @@
 #include <Corrade/Utility/String.h>
 #include <rapidjson/filereadstream.h>
 #include <rapidjson/filewritestream.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include "esp/core/Configuration.h"
+#include "esp/io/JsonWriter.h"
 
 #include "esp/core/Esp.h"
 
@@ -26,36 +29,8 @@ bool writeJsonToFile(const JsonDocument& document,
                      bool usePrettyWriter,
                      int maxDecimalPlaces) {
   assert(!filepath.empty());
-  std::string outFilePath = filepath;
-  if (!Cr::Utility::String::endsWith(outFilePath, ".json")) {
-    outFilePath += ".json";
-  }
-
-  auto* f = fopen(outFilePath.c_str(), "w");
-  if (!f) {
-    return false;
-  }
-
-  char writeBuffer[65536];
-  rapidjson::FileWriteStream os(f, writeBuffer, sizeof(writeBuffer));
-
-  bool writeSuccess = false;
-  if (usePrettyWriter) {
-    rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
-    if (maxDecimalPlaces != -1) {
-      writer.SetMaxDecimalPlaces(maxDecimalPlaces);
-    }
-    writeSuccess = document.Accept(writer);
-  } else {
-    rapidjson::Writer<rapidjson::FileWriteStream> writer(os);
-    if (maxDecimalPlaces != -1) {
-      writer.SetMaxDecimalPlaces(maxDecimalPlaces);
-    }
-    writeSuccess = document.Accept(writer);
-  }
-  fclose(f);
-
-  return writeSuccess;
+  return writeJsonToFile(filepath, usePrettyWriter, maxDecimalPlaces,
+                         [&](auto& writer) { return document.Accept(writer); });
 }
 
 JsonDocument parseJsonFile(const std::string& file) {
@@ -86,6 +61,125 @@ JsonDocument parseJsonString(const std::string& jsonString) {
   return d;
 }
 
+namespace {
+
+/**
+ * @brief SAX handler recording where each element of the array member of the
+ * top-level object starts and ends in the source text, without building any
+ * values. Stops the parse once the array is closed.
+ */
+class ArrayElementLocator
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          ArrayElementLocator> {
+ public:
+  ArrayElementLocator(const rapidjson::MemoryStream& stream,
+                      Cr::Containers::StringView json,
+                      Cr::Containers::StringView tag,
+                      std::vector<Cr::Containers::StringView>& elements)
+      : stream_(stream), json_(json), tag_(tag), elements_(elements) {}
+
+  bool done() const { return done_; }
+
+  // scalar values
+  bool Default() {
+    // the member or its elements need to be arrays or objects
+    return !((tagPending_ && depth_ == 1) || isElementDepth());
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool) {
+    if (depth_ == 1) {
+      tagPending_ = arrayDepth_ == 0 &&
+                    Cr::Containers::StringView{str, length} == tag_;
+    }
+    return true;
+  }
+
+  bool StartObject() {
+    if (tagPending_ && depth_ == 1) {
+      return false;
+    }
+    beginElement();
+    ++depth_;
+    return true;
+  }
+
+  bool EndObject(rapidjson::SizeType) {
+    --depth_;
+    endElement();
+    return true;
+  }
+
+  bool StartArray() {
+    if (tagPending_ && depth_ == 1) {
+      tagPending_ = false;
+      arrayDepth_ = ++depth_;
+      return true;
+    }
+    beginElement();
+    ++depth_;
+    return true;
+  }
+
+  bool EndArray(rapidjson::SizeType) {
+    --depth_;
+    if (arrayDepth_ != 0 && depth_ == arrayDepth_ - 1) {
+      // found everything, no need to scan the rest of the text
+      done_ = true;
+      return false;
+    }
+    endElement();
+    return true;
+  }
+
+ private:
+  bool isElementDepth() const {
+    return arrayDepth_ != 0 && depth_ == arrayDepth_;
+  }
+
+  // the stream is past the opening bracket when the handler is called
+  void beginElement() {
+    if (isElementDepth()) {
+      elementBegin_ = stream_.Tell() - 1;
+    }
+  }
+
+  // and past the closing bracket
+  void endElement() {
+    if (isElementDepth()) {
+      elements_.emplace_back(
+          json_.slice(elementBegin_, std::size_t(stream_.Tell())));
+    }
+  }
+
+  const rapidjson::MemoryStream& stream_;
+  const Cr::Containers::StringView json_;
+  const Cr::Containers::StringView tag_;
+  std::vector<Cr::Containers::StringView>& elements_;
+  int depth_ = 0;
+  int arrayDepth_ = 0;
+  bool tagPending_ = false;
+  bool done_ = false;
+  std::size_t elementBegin_ = 0;
+};
+
+}  // namespace
+
+bool findJsonArrayElements(
+    Cr::Containers::StringView json,
+    const char* tag,
+    std::vector<Cr::Containers::StringView>& elements) {
+  elements.clear();
+  rapidjson::MemoryStream stream{json.data(), json.size()};
+  ArrayElementLocator handler{stream, json, tag, elements};
+  rapidjson::Reader reader;
+  reader.Parse(stream, handler);
+  if (!handler.done()) {
+    elements.clear();
+    return false;
+  }
+  return true;
+}  // findJsonArrayElements
+
 std::string jsonToString(const JsonDocument& d, int maxDecimalPlaces) {
   rapidjson::StringBuffer buffer{};
   rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
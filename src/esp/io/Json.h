@@ -7,6 +7,7 @@
 
 #include "JsonAllTypes.h"
 
+#include <Corrade/Containers/StringView.h>
 #include <cstdint>
 #define RAPIDJSON_NO_INT64DEFINE
 #include <rapidjson/document.h>
@@ -47,6 +48,26 @@ JsonDocument parseJsonFile(const std::string& file);
 //! Parse JSON string and return as JsonDocument object
 JsonDocument parseJsonString(const std::string& jsonString);
 
+/**
+ * @brief Locate the elements of the array member @p tag of the top-level JSON
+ * object in @p json by streaming through the text, without building a DOM.
+ *
+ * Lets callers parse the elements of very large arrays one at a time, or in
+ * parallel, into small documents instead of holding the whole file's DOM. The
+ * scan stops at the end of the array, so errors later in the text are not
+ * detected.
+ * @param json The JSON text to scan
+ * @param tag The name of the array member
+ * @param[out] elements Views on @p json of each object or array element
+ * @return false if the text is not valid JSON up to the end of the array, if
+ * the member is missing or not an array, or if it holds values other than
+ * objects or arrays, in which case @p elements is left empty.
+ */
+bool findJsonArrayElements(
+    Corrade::Containers::StringView json,
+    const char* tag,
+    std::vector<Corrade::Containers::StringView>& elements);
+
 //! Return string representation of given JsonDocument
 std::string jsonToString(const JsonDocument& d, int maxDecimalPlaces = -1);
 
@@ -0,0 +1,248 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "JsonSnapshot.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Io.h"
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Esp.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace io {
+
+namespace {
+
+thread_local JsonSnapshot* currentSnapshot = nullptr;
+
+// Bump when the layout below changes, older snapshots are then rebuilt
+constexpr char JsonSnapshotMagic[8]{'E', 'S', 'P', 'J', 'S', 'S', '0', '1'};
+
+struct JsonSnapshotHeader {
+  char magic[8];
+  uint32_t fileCount;
+  uint32_t directoryCount;
+};
+
+struct JsonSnapshotEntry {
+  uint64_t modified;
+  uint64_t size;
+  uint64_t pathSize;
+  uint64_t dataSize;
+};
+
+}  // namespace
+
+JsonSnapshot::Scope::Scope(JsonSnapshot& snapshot)
+    : previous_{currentSnapshot} {
+  currentSnapshot = &snapshot;
+}
+
+JsonSnapshot::Scope::~Scope() {
+  currentSnapshot = previous_;
+}
+
+JsonSnapshot* JsonSnapshot::current() {
+  return currentSnapshot;
+}
+
+bool JsonSnapshot::load(const std::string& filename) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  files_.clear();
+  directories_.clear();
+  dirty_ = false;
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    return false;
+  }
+  Cr::Containers::ArrayView<const char> in = *file;
+
+  JsonSnapshotHeader header;
+  if (in.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, in.data(), sizeof(header));
+  if (std::memcmp(header.magic, JsonSnapshotMagic, sizeof(header.magic)) !=
+      0) {
+    return false;
+  }
+  in = in.exceptPrefix(sizeof(header));
+
+  const std::size_t entryCount =
+      std::size_t(header.fileCount) + header.directoryCount;
+  for (std::size_t i = 0; i != entryCount; ++i) {
+    JsonSnapshotEntry entry;
+    if (in.size() < sizeof(entry)) {
+      files_.clear();
+      directories_.clear();
+      return false;
+    }
+    std::memcpy(&entry, in.data(), sizeof(entry));
+    in = in.exceptPrefix(sizeof(entry));
+    if (in.size() < entry.pathSize ||
+        in.size() - entry.pathSize < entry.dataSize) {
+      files_.clear();
+      directories_.clear();
+      return false;
+    }
+    std::string path{in.data(), std::size_t(entry.pathSize)};
+    in = in.exceptPrefix(entry.pathSize);
+    std::string data{in.data(), std::size_t(entry.dataSize)};
+    in = in.exceptPrefix(entry.dataSize);
+
+    // keep only the entries whose source is unchanged
+    uint64_t modified = 0;
+    uint64_t size = 0;
+    if (!getFileStamp(path, modified, size) || modified != entry.modified ||
+        size != entry.size) {
+      dirty_ = true;
+      continue;
+    }
+    auto& entries = i < header.fileCount ? files_ : directories_;
+    entries[std::move(path)] = Entry{modified, size, std::move(data)};
+  }
+  ESP_DEBUG() << "Loaded" << files_.size() << "files and"
+              << directories_.size()
+              << "directories from the metadata snapshot" << filename;
+  return true;
+}  // JsonSnapshot::load
+
+bool JsonSnapshot::save(const std::string& filename) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  JsonSnapshotHeader header{};
+  std::memcpy(header.magic, JsonSnapshotMagic, sizeof(header.magic));
+  header.fileCount = files_.size();
+  header.directoryCount = directories_.size();
+
+  std::string out;
+  out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto* entries : {&files_, &directories_}) {
+    for (const auto& item : *entries) {
+      JsonSnapshotEntry entry{};
+      entry.modified = item.second.modified;
+      entry.size = item.second.size;
+      entry.pathSize = item.first.size();
+      entry.dataSize = item.second.data.size();
+      out.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+      out.append(item.first);
+      out.append(item.second.data);
+    }
+  }
+
+  if (!core::writeFileAtomically(
+          filename,
+          Cr::Containers::ArrayView<const void>{out.data(), out.size()})) {
+    ESP_WARNING() << "Unable to write the metadata snapshot" << filename;
+    return false;
+  }
+  dirty_ = false;
+  return true;
+}  // JsonSnapshot::save
+
+bool JsonSnapshot::isDirty() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return dirty_;
+}
+
+std::size_t JsonSnapshot::size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return files_.size() + directories_.size();
+}
+
+JsonDocument JsonSnapshot::parseJsonFile(const std::string& filename) {
+  uint64_t modified = 0;
+  uint64_t size = 0;
+  if (!getFileStamp(filename, modified, size)) {
+    ESP_ERROR() << "Unable to read" << filename;
+    throw std::runtime_error("JSON file not found");
+  }
+  std::string data;
+  bool upToDate = false;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto found = files_.find(filename);
+    if (found != files_.end() && found->second.modified == modified &&
+        found->second.size == size) {
+      data = found->second.data;
+      upToDate = true;
+    }
+  }
+  if (!upToDate) {
+    Cr::Containers::Optional<Cr::Containers::String> contents =
+        Cr::Utility::Path::readString(filename);
+    if (!contents) {
+      ESP_ERROR() << "Unable to read" << filename;
+      throw std::runtime_error("JSON file not readable");
+    }
+    data = *contents;
+    std::lock_guard<std::mutex> lock{mutex_};
+    files_[filename] = Entry{modified, size, data};
+    dirty_ = true;
+  }
+
+  JsonDocument d;
+  d.Parse(data.data(), data.size());
+  if (d.HasParseError()) {
+    ESP_ERROR() << "Parse error reading" << filename << "Error code"
+                << d.GetParseError() << "at" << d.GetErrorOffset();
+    throw std::runtime_error("JSON parse error");
+  }
+  return d;
+}  // JsonSnapshot::parseJsonFile
+
+Cr::Containers::Optional<std::vector<std::string>> JsonSnapshot::listDirectory(
+    const std::string& path) {
+  uint64_t modified = 0;
+  uint64_t size = 0;
+  if (!getFileStamp(path, modified, size)) {
+    return Cr::Containers::NullOpt;
+  }
+  std::vector<std::string> listing;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto found = directories_.find(path);
+    if (found != directories_.end() && found->second.modified == modified &&
+        found->second.size == size) {
+      const std::string& data = found->second.data;
+      for (std::size_t begin = 0, end; begin < data.size(); begin = end + 1) {
+        end = data.find('\0', begin);
+        listing.emplace_back(data, begin, end - begin);
+      }
+      return listing;
+    }
+  }
+
+  namespace Dir = Cr::Utility::Path;
+  Cr::Containers::Optional<Cr::Containers::Array<Cr::Containers::String>>
+      list = Dir::list(path, Dir::ListFlag::SortAscending);
+  if (!list) {
+    return Cr::Containers::NullOpt;
+  }
+  std::string data;
+  for (const Cr::Containers::String& name : *list) {
+    listing.emplace_back(name);
+    data.append(name.data(), name.size());
+    data.push_back('\0');
+  }
+  std::lock_guard<std::mutex> lock{mutex_};
+  directories_[path] = Entry{modified, size, std::move(data)};
+  dirty_ = true;
+  return listing;
+}  // JsonSnapshot::listDirectory
+
+}  // namespace io
+}  // namespace esp
@@ -0,0 +1,117 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_IO_JSONSNAPSHOT_H_
+#define ESP_IO_JSONSNAPSHOT_H_
+
+/** @file
+ * @brief Class @ref esp::io::JsonSnapshot
+ */
+
+#include <Corrade/Containers/Optional.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Json.h"
+
+namespace esp {
+namespace io {
+
+/**
+ * @brief Snapshot of the JSON files and directory listings read while loading
+ * metadata, stored in a single file.
+ *
+ * Loading a scene dataset reads a large tree of small JSON files and walks
+ * the directories they reference. A snapshot keeps the contents of every file
+ * and the listing of every directory visited, each stamped with the size and
+ * modification time of its source, so later processes can load the whole
+ * dataset from a single read. Entries whose source changed on disk are
+ * dropped when the snapshot is loaded and are recorded again on next use.
+ *
+ * While a snapshot is made current on a thread with @ref Scope, the metadata
+ * managers route their file reads on that thread through it. All member
+ * functions are thread-safe.
+ */
+class JsonSnapshot {
+ public:
+  /**
+   * @brief Makes a snapshot current on the calling thread for its lifetime,
+   * restoring the previously current one on destruction.
+   */
+  class Scope {
+   public:
+    explicit Scope(JsonSnapshot& snapshot);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    JsonSnapshot* previous_;
+  };
+
+  /** @brief The snapshot current on the calling thread, or nullptr */
+  static JsonSnapshot* current();
+
+  /**
+   * @brief Replace the entries by the ones stored in @p filename, dropping
+   * all entries that are out of date.
+   * @return false if @p filename does not exist or is not a valid snapshot,
+   * in which case the snapshot is left empty.
+   */
+  bool load(const std::string& filename);
+
+  /**
+   * @brief Save all entries to @p filename and mark the snapshot clean.
+   * @return whether successful or not
+   */
+  bool save(const std::string& filename);
+
+  /**
+   * @brief Whether entries were recorded or dropped since the last @ref load
+   * or @ref save.
+   */
+  bool isDirty() const;
+
+  /** @brief Number of files and directories held */
+  std::size_t size() const;
+
+  /**
+   * @brief Parse the JSON file @p filename, using the held copy if it is up
+   * to date and recording the file otherwise. Throws like @ref parseJsonFile
+   * on a parse error and if the file cannot be read.
+   */
+  JsonDocument parseJsonFile(const std::string& filename);
+
+  /**
+   * @brief The names of the entries of the directory @p path in ascending
+   * order, using the held listing if it is up to date and recording it
+   * otherwise.
+   * @return the listing, or NullOpt if @p path cannot be listed.
+   */
+  Corrade::Containers::Optional<std::vector<std::string>> listDirectory(
+      const std::string& path);
+
+ private:
+  struct Entry {
+    std::uint64_t modified = 0;
+    std::uint64_t size = 0;
+    // file contents, or the directory entries separated by '\0'
+    std::string data;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Entry> files_;
+  std::map<std::string, Entry> directories_;
+  bool dirty_ = false;
+};
+
+}  // namespace io
+}  // namespace esp
+
+#endif  // ESP_IO_JSONSNAPSHOT_H_
@@ -0,0 +1,281 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_IO_JSONWRITER_H_
+#define ESP_IO_JSONWRITER_H_
+
+/** @file
+ * @brief Direct serialization of replay keyframes to a rapidjson writer,
+ * without building a document first
+ */
+
+#include <Corrade/Utility/String.h>
+#include <rapidjson/filewritestream.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/writer.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "JsonAllTypes.h"
+#include "JsonUtils.h"
+
+namespace esp {
+namespace io {
+
+/**
+ * @brief Write JSON to @p file with a @ref rapidjson::Writer, or a
+ * @ref rapidjson::PrettyWriter if @p usePrettyWriter, by calling @p write with
+ * it. A ".json" extension is appended to @p file if missing.
+ *
+ * @param file The file to write
+ * @param usePrettyWriter Whether to indent the output
+ * @param maxDecimalPlaces Set this to a positive integer to shorten how
+ * floats/doubles are written.
+ * @param write Callable taking the writer by reference and returning whether
+ * it succeeded. Needs to accept both writer types.
+ * @return whether successful or not
+ */
+template <class F>
+bool writeJsonToFile(const std::string& file,
+                     bool usePrettyWriter,
+                     int maxDecimalPlaces,
+                     F&& write) {
+  std::string outFilePath = file;
+  if (!Corrade::Utility::String::endsWith(outFilePath, ".json")) {
+    outFilePath += ".json";
+  }
+
+  auto* f = fopen(outFilePath.c_str(), "w");
+  if (!f) {
+    return false;
+  }
+
+  char writeBuffer[65536];
+  rapidjson::FileWriteStream os(f, writeBuffer, sizeof(writeBuffer));
+
+  bool writeSuccess = false;
+  if (usePrettyWriter) {
+    rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
+    if (maxDecimalPlaces != -1) {
+      writer.SetMaxDecimalPlaces(maxDecimalPlaces);
+    }
+    writeSuccess = write(writer);
+  } else {
+    rapidjson::Writer<rapidjson::FileWriteStream> writer(os);
+    if (maxDecimalPlaces != -1) {
+      writer.SetMaxDecimalPlaces(maxDecimalPlaces);
+    }
+    writeSuccess = write(writer);
+  }
+  fclose(f);
+
+  return writeSuccess;
+}
+
+// The writeJson() overloads produce the same output as accepting @p writer
+// on the value returned by the matching toJsonValue() overload, without
+// building that value first.
+
+template <class Writer>
+void writeJson(Writer& writer, float x) {
+  writer.Double(x);
+}
+
+template <class Writer>
+void writeJson(Writer& writer, int x) {
+  writer.Int(x);
+}
+
+template <class Writer>
+void writeJson(Writer& writer, const std::string& x) {
+  writer.String(x.data(), rapidjson::SizeType(x.size()));
+}
+
+template <class Writer>
+void writeJson(Writer& writer, const Magnum::Vector3& vec) {
+  writer.StartArray();
+  for (int i = 0; i < 3; ++i) {
+    writer.Double(vec[i]);
+  }
+  writer.EndArray();
+}
+
+template <class Writer>
+void writeJson(Writer& writer, const Magnum::Quaternion& quat) {
+  writer.StartArray();
+  writer.Double(squashTinyDecimals(quat.scalar()));
+  for (int i = 0; i < 3; ++i) {
+    writer.Double(squashTinyDecimals(quat.vector()[i]));
+  }
+  writer.EndArray();
+}
+
+template <class Writer>
+void writeJson(Writer& writer, const gfx::replay::Transform& x) {
+  writer.StartObject();
+  writer.Key("translation");
+  writeJson(writer, x.translation);
+  writer.Key("rotation");
+  writeJson(writer, x.rotation);
+  writer.EndObject();
+}
+
+template <class Writer>
+void writeJson(Writer& writer,
+               const gfx::replay::RenderAssetInstanceState& x) {
+  writer.StartObject();
+  writer.Key("absTransform");
+  writeJson(writer, x.absTransform);
+  writer.Key("semanticId");
+  writeJson(writer, x.semanticId);
+  writer.EndObject();
+}
+
+/**
+ * @brief Write the member @p name holding the array @p vec unless it is
+ * empty, as @ref addMember does for vectors.
+ */
+template <class Writer, class T>
+void writeJsonMember(Writer& writer,
+                     const char* name,
+                     const std::vector<T>& vec) {
+  if (vec.empty()) {
+    return;
+  }
+  writer.Key(name);
+  writer.StartArray();
+  for (const T& x : vec) {
+    writeJson(writer, x);
+  }
+  writer.EndArray();
+}
+
+/**
+ * @brief Write the member @p name holding @p x through a temporary value
+ * built in @p allocator. Used for the parts of a keyframe that are rarely
+ * present, so have no direct serialization.
+ */
+template <class Writer, class T>
+void writeJsonMemberThroughValue(Writer& writer,
+                                 const char* name,
+                                 const T& x,
+                                 JsonAllocator& allocator) {
+  writer.Key(name);
+  toJsonValue(x, allocator).Accept(writer);
+}
+
+/**
+ * @brief Write @p keyframe to @p writer, producing the same output as
+ * @ref toJsonValue(const gfx::replay::Keyframe&, JsonAllocator&).
+ *
+ * The per-frame instance state, rig and user transform updates are written
+ * directly. Asset loads, instance creations and lights go through temporary
+ * values in @p allocator, which the caller can clear between keyframes.
+ */
+template <class Writer>
+void writeJson(Writer& writer,
+               const gfx::replay::Keyframe& keyframe,
+               JsonAllocator& allocator) {
+  writer.StartObject();
+
+  if (!keyframe.loads.empty()) {
+    writeJsonMemberThroughValue(writer, "loads", keyframe.loads, allocator);
+  }
+
+  if (!keyframe.rigCreations.empty()) {
+    writer.Key("rigCreations");
+    writer.StartArray();
+    for (const auto& rig : keyframe.rigCreations) {
+      writer.StartObject();
+      writer.Key("id");
+      writeJson(writer, rig.id);
+      writeJsonMember(writer, "boneNames", rig.boneNames);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+
+  if (!keyframe.creations.empty()) {
+    writer.Key("creations");
+    writer.StartArray();
+    for (const auto& pair : keyframe.creations) {
+      writer.StartObject();
+      writer.Key("instanceKey");
+      writeJson(writer, pair.first);
+      writeJsonMemberThroughValue(writer, "creation", pair.second, allocator);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+
+  writeJsonMember(writer, "deletions", keyframe.deletions);
+
+  if (!keyframe.stateUpdates.empty()) {
+    writer.Key("stateUpdates");
+    writer.StartArray();
+    for (const auto& pair : keyframe.stateUpdates) {
+      writer.StartObject();
+      writer.Key("instanceKey");
+      writeJson(writer, pair.first);
+      writer.Key("state");
+      writeJson(writer, pair.second);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+
+  if (!keyframe.rigUpdates.empty()) {
+    writer.Key("rigUpdates");
+    writer.StartArray();
+    for (const auto& rig : keyframe.rigUpdates) {
+      writer.StartObject();
+      writer.Key("id");
+      writeJson(writer, rig.id);
+      writer.Key("pose");
+      writer.StartArray();
+      for (const auto& bone : rig.pose) {
+        writer.StartObject();
+        writer.Key("t");
+        writeJson(writer, bone.translation);
+        writer.Key("r");
+        writeJson(writer, bone.rotation);
+        writer.EndObject();
+      }
+      writer.EndArray();
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+
+  if (!keyframe.userTransforms.empty()) {
+    writer.Key("userTransforms");
+    writer.StartArray();
+    for (const auto& pair : keyframe.userTransforms) {
+      writer.StartObject();
+      writer.Key("name");
+      writeJson(writer, pair.first);
+      writer.Key("transform");
+      writeJson(writer, pair.second);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+
+  if (keyframe.lightsChanged) {
+    writer.Key("lightsChanged");
+    writer.Bool(true);
+    if (!keyframe.lights.empty()) {
+      writeJsonMemberThroughValue(writer, "lights", keyframe.lights, allocator);
+    }
+  }
+
+  writer.EndObject();
+}
+
+}  // namespace io
+}  // namespace esp
+
+#endif  // ESP_IO_JSONWRITER_H_
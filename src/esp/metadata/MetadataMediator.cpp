@@ -4,6 +4,12 @@
 
 #include "MetadataMediator.h"
 
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include "esp/core/Hash.h"
+#include "esp/io/JsonSnapshot.h"
+
 namespace esp {
 namespace metadata {
 
@@ -152,8 +158,21 @@ bool MetadataMediator::createSceneDataset(const std::string& sceneDatasetName,
   }
   // by here dataset either does not exist or exists but is unlocked and
   // overwrite is specified. attempt to create new/overwrite
-  auto datasetAttribs =
-      sceneDatasetAttributesManager_->createObject(sceneDatasetName, true);
+  const std::string snapshotFilename =
+      sceneDatasetSnapshotFilename(sceneDatasetName);
+  io::JsonSnapshot snapshot;
+  if (!snapshotFilename.empty()) {
+    snapshot.load(snapshotFilename);
+  }
+  attributes::SceneDatasetAttributes::ptr datasetAttribs;
+  {
+    io::JsonSnapshot::Scope snapshotScope{snapshot};
+    datasetAttribs =
+        sceneDatasetAttributesManager_->createObject(sceneDatasetName, true);
+  }
+  if (!snapshotFilename.empty() && datasetAttribs && snapshot.isDirty()) {
+    snapshot.save(snapshotFilename);
+  }
   // Failure here means some catastrophic error attempting to create the dataset
   // attributes. Should fail code
   ESP_CHECK(datasetAttribs,
@@ -173,6 +192,26 @@ bool MetadataMediator::createSceneDataset(const std::string& sceneDatasetName,
   return true;
 }  // MetadataMediator::createSceneDataset
 
+std::string MetadataMediator::sceneDatasetSnapshotFilename(
+    const std::string& sceneDatasetName) const {
+  namespace Path = Cr::Utility::Path;
+  if (simConfig_.metadataCacheDirectory.empty() ||
+      !Path::exists(sceneDatasetName)) {
+    return {};
+  }
+  // the same file name may be reached through different paths, key the
+  // snapshot on the absolute one
+  const std::string datasetPath =
+      Path::join(*Path::currentDirectory(), sceneDatasetName);
+  core::Fnv1aHash hash;
+  hash.add(datasetPath.data(), datasetPath.size());
+  return Path::join(
+      simConfig_.metadataCacheDirectory,
+      Cr::Utility::formatString("{}.{}.snapshot",
+                                Path::split(sceneDatasetName).second(),
+                                core::hashHexString(hash.value())));
+}  // MetadataMediator::sceneDatasetSnapshotFilename
+
 bool MetadataMediator::removeSceneDataset(const std::string& sceneDatasetName) {
   // First check if SceneDatasetAttributes exists
   if (!sceneDatasetExists(sceneDatasetName)) {
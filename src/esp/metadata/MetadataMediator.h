@@ -60,7 +60,9 @@ class MetadataMediator {
    * @brief Creates a dataset attributes using @p sceneDatasetName, and
    * registers it. NOTE If an existing dataset attributes exists with this
    * handle, then this will only overwrite this existing dataset if @p overwrite
-   * is set to true.
+   * is set to true. If @ref sim::SimulatorConfiguration::metadataCacheDirectory
+   * is set, the dataset files are read through a snapshot kept there, see
+   * @ref io::JsonSnapshot.
    * @param sceneDatasetName The name of the dataset to load or create.
    * @param overwrite Whether to overwrite an existing dataset or not
    * @return Whether a dataset with @p sceneDatasetName exists (either new or
@@ -580,6 +582,14 @@ class MetadataMediator {
       const std::map<std::string, std::string>& assetMapping,
       const std::string& msgString);
 
+  /**
+   * @brief Return the file holding the snapshot of the files loaded for the
+   * scene dataset @p sceneDatasetName, or an empty string if the metadata
+   * cache directory is not set or the dataset is not backed by a file.
+   */
+  std::string sceneDatasetSnapshotFilename(
+      const std::string& sceneDatasetName) const;
+
   /**
    * @brief This will create a new, empty @ref esp::metadata::attributes::SceneInstanceAttributes
    * with the passed name, and create a SceneObjectInstance for the stage also
@@ -85,7 +85,10 @@ class AbstractAttributes
    * @param handle the handle to set.
    */
   void setHandle(const std::string& handle) override { set("handle", handle); }
-  std::string getHandle() const override { return get<std::string>("handle"); }
+  std::string getHandle() const override {
+    static const core::config::ConfigKey key{"handle"};
+    return get<std::string>(key);
+  }
 
   /**
    * @brief Set the directory where files used to construct ManagedObject can be
@@ -123,7 +126,10 @@ class AbstractAttributes
    *  @brief Unique ID referencing attributes
    */
   void setID(int ID) override { set("ID", ID); }
-  int getID() const override { return get<int>("ID"); }
+  int getID() const override {
+    static const core::config::ConfigKey key{"ID"};
+    return get<int>(key);
+  }
 
   /**
    * @brief Gets a smart pointer reference to a copy of the user-specified
@@ -204,6 +204,28 @@ std::string getTranslationOriginName(
   return "default";
 }  // getTranslationOriginName
 
+const std::map<std::string, PbrShaderQuality> PbrShaderQualityNamesMap = {
+    {"full", PbrShaderQuality::Full},
+    {"fast", PbrShaderQuality::Fast},
+};
+
+std::string getPbrShaderQualityName(PbrShaderQuality quality) {
+  // this verifies that enum value being checked is supported by string-keyed
+  // map. The values below should be the minimum and maximum enums supported by
+  // PbrShaderQualityNamesMap
+  if ((quality < PbrShaderQuality::Full) ||
+      (quality >= PbrShaderQuality::EndPbrShaderQuality)) {
+    return "full";
+  }
+  // Must always be valid value
+  for (const auto& it : PbrShaderQualityNamesMap) {
+    if (it.second == quality) {
+      return it.first;
+    }
+  }
+  return "full";
+}  // getPbrShaderQualityName
+
 // All keys must be lowercase
 const std::map<std::string, esp::physics::MotionType> MotionTypeNamesMap = {
     {"static", esp::physics::MotionType::STATIC},
@@ -208,6 +208,29 @@ enum class SceneInstanceTranslationOrigin {
   EndTransOrigin,
 };
 
+/**
+ * @brief This enum class defines the quality tiers of the PBR shader, trading
+ * visual fidelity for rendering speed.
+ */
+enum class PbrShaderQuality {
+  /**
+   * @brief Evaluate every lobe the materials and the configuration specify.
+   */
+  Full,
+  /**
+   * @brief Skip the clearcoat, specular and anisotropy layers, use Lambertian
+   * diffuse, and look up the IBL specular lobe from the baked irradiance map
+   * instead of the prefiltered environment map. Meant for low-resolution
+   * observations where those details aren't visible, e.g. for training.
+   */
+  Fast,
+  /**
+   * @brief End cap value - no PBR shader quality enums should be defined at or
+   * past this enum.
+   */
+  EndPbrShaderQuality,
+};
+
 /**
  * @brief Constant map to provide mappings from string tags to @ref
  * ArticulatedObjectBaseType values. This will be used to map values set
@@ -296,6 +319,19 @@ const extern std::map<std::string, SceneInstanceTranslationOrigin>
 std::string getTranslationOriginName(
     SceneInstanceTranslationOrigin translationOrigin);
 
+/**
+ * @brief Constant map to provide mappings from string tags to @ref
+ * PbrShaderQuality values. This will be used to map values set in json for
+ * PBR shader quality to @ref PbrShaderQuality. Keys must be lowercase.
+ */
+const extern std::map<std::string, PbrShaderQuality> PbrShaderQualityNamesMap;
+
+/**
+ * @brief This method will convert a @ref PbrShaderQuality value to the string
+ * key that maps to it in the PbrShaderQualityNamesMap
+ */
+std::string getPbrShaderQualityName(PbrShaderQuality quality);
+
 /**
  * @brief Constant static map to provide mappings from string tags to @ref
  * esp::gfx::LightType values. This will be used to map values set in json
@@ -18,6 +18,7 @@ PbrShaderAttributes::PbrShaderAttributes(const std::string& handle)
   setUseMikkelsenTBN(false);
   setUseDirectLightTonemap(false);
   setUseBurleyDiffuse(true);
+  setPbrQuality(getPbrShaderQualityName(PbrShaderQuality::Full));
   // Layer calcs
   setSkipCalcClearcoatLayer(false);
   setSkipCalcSpecularLayer(false);
@@ -60,6 +61,7 @@ void PbrShaderAttributes::writeValuesToJson(
   writeValueToJson("use_mikkelsen_tbn", jsonObj, allocator);
   writeValueToJson("use_direct_tonemap", jsonObj, allocator);
   writeValueToJson("use_burley_diffuse", jsonObj, allocator);
+  writeValueToJson("pbr_quality", jsonObj, allocator);
   writeValueToJson("skip_clearcoat_calc", jsonObj, allocator);
   writeValueToJson("skip_specular_layer_calc", jsonObj, allocator);
   writeValueToJson("skip_anisotropy_layer_calc", jsonObj, allocator);
@@ -82,10 +84,10 @@ void PbrShaderAttributes::writeValuesToJson(
 std::string PbrShaderAttributes::getObjectInfoHeaderInternal() const {
   return "Direct Lights On,IBL On,Global Direct Light Intensity,Calc "
          "Missing Tangent Frame,Use Mikkelsen TBN Calc,Use Burley/Disney "
-         "Diffuse,Calc Clearcoat,Calc Spec Layer,Calc Anisotropy,BRDF LUT "
-         "Filename,Environment Map Filename,Scaling [Dir Diffuse|Dir Spec|IBL "
-         "Diffuse|IBL Spec],Tonemap Exposure,Map Material Txtrs to Linear,Map "
-         "IBL Txtrs to Linear,Map Output to SRGB,Global Gamma";
+         "Diffuse,Quality,Calc Clearcoat,Calc Spec Layer,Calc Anisotropy,BRDF "
+         "LUT Filename,Environment Map Filename,Scaling [Dir Diffuse|Dir "
+         "Spec|IBL Diffuse|IBL Spec],Tonemap Exposure,Map Material Txtrs to "
+         "Linear,Map IBL Txtrs to Linear,Map Output to SRGB,Global Gamma";
 }
 
 /**
@@ -98,11 +100,12 @@ std::string PbrShaderAttributes::getObjectInfoInternal() const {
       getAsString("direct_specular_scale"), getAsString("ibl_diffuse_scale"),
       getAsString("ibl_specular_scale"));
   return Cr::Utility::formatString(
-      "{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},",
+      "{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},",
       getAsString("enable_direct_lights"), getAsString("enable_ibl"),
       getAsString("direct_light_intensity"),
       getAsString("skip_missing_tbn_calc"), getAsString("use_mikkelsen_tbn"),
-      getAsString("use_burley_diffuse"), getAsString("skip_clearcoat_calc"),
+      getAsString("use_burley_diffuse"), getAsString("pbr_quality"),
+      getAsString("skip_clearcoat_calc"),
       getAsString("skip_specular_layer_calc"),
       getAsString("skip_anisotropy_layer_calc"),
       getAsString("ibl_blut_filename"), getAsString("ibl_envmap_filename"),
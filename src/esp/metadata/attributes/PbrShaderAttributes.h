@@ -201,6 +201,37 @@ class PbrShaderAttributes : public AbstractAttributes {
    */
   bool getUseBurleyDiffuse() const { return get<bool>("use_burley_diffuse"); }
 
+  /**
+   * @brief Set the quality tier of the shader, one of the keys of
+   * @ref PbrShaderQualityNamesMap. @ref PbrShaderQuality::Fast overrides the
+   * Burley diffuse and layer calculation settings.
+   */
+  void setPbrQuality(const std::string& quality) {
+    // force to lowercase before setting
+    const std::string qualityLC = Cr::Utility::String::lowercase(quality);
+    auto mapIter = PbrShaderQualityNamesMap.find(qualityLC);
+    ESP_CHECK(mapIter != PbrShaderQualityNamesMap.end(),
+              "Illegal PBR shader quality value"
+                  << quality << "attempted to be set in PbrShaderAttributes:"
+                  << getHandle() << ". Aborting.");
+    set("pbr_quality", qualityLC);
+  }
+
+  /**
+   * @brief Get the quality tier of the shader
+   */
+  PbrShaderQuality getPbrQuality() const {
+    const std::string val =
+        Cr::Utility::String::lowercase(get<std::string>("pbr_quality"));
+    auto mapIter = PbrShaderQualityNamesMap.find(val);
+    if (mapIter != PbrShaderQualityNamesMap.end()) {
+      return mapIter->second;
+    }
+    // This should never get to here. It would mean that this field was set
+    // to an invalid value somehow.
+    return PbrShaderQuality::Full;
+  }
+
   /**
    * @brief Set whether the clearcoat layer calculations should be skipped. If
    * true, disable calcs regardless of material setting. Note this will not
@@ -12,9 +12,11 @@ PhysicsManagerAttributes::PhysicsManagerAttributes(const std::string& handle)
     : AbstractAttributes("PhysicsManagerAttributes", handle) {
   setSimulator("bullet");
   setTimestep(0.008);
+  setMaxSubsteps(10000);
   setGravity({0, -9.8, 0});
   setFrictionCoefficient(0.4);
   setRestitutionCoefficient(0.1);
+  setNumCollisionThreads(1);
 }  // PhysicsManagerAttributes ctor
 
 void PhysicsManagerAttributes::writeValuesToJson(
@@ -22,9 +24,11 @@ void PhysicsManagerAttributes::writeValuesToJson(
     io::JsonAllocator& allocator) const {
   writeValueToJson("physics_simulator", jsonObj, allocator);
   writeValueToJson("timestep", jsonObj, allocator);
+  writeValueToJson("max_substeps", jsonObj, allocator);
   writeValueToJson("gravity", jsonObj, allocator);
   writeValueToJson("friction_coefficient", jsonObj, allocator);
   writeValueToJson("restitution_coefficient", jsonObj, allocator);
+  writeValueToJson("num_collision_threads", jsonObj, allocator);
 }  // PhysicsManagerAttributes::writeValuesToJson
 
 }  // namespace attributes
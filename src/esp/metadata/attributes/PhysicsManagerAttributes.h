@@ -45,11 +45,14 @@ class PhysicsManagerAttributes : public AbstractAttributes {
   double getTimestep() const { return get<double>("timestep"); }
 
   /**
-   * @brief Currently not supported.
+   * @brief Set the largest number of fixed timesteps a single physics step may
+   * take. Simulation time beyond that is dropped, so a stalled frame can't
+   * trigger an unbounded number of substeps. Must be positive.
    */
   void setMaxSubsteps(int maxSubsteps) { set("max_substeps", maxSubsteps); }
   /**
-   * @brief Currently not supported.
+   * @brief Get the largest number of fixed timesteps a single physics step may
+   * take.
    */
   int getMaxSubsteps() const { return get<int>("max_substeps"); }
 
@@ -73,6 +76,27 @@ class PhysicsManagerAttributes : public AbstractAttributes {
     return get<double>("restitution_coefficient");
   }
 
+  /**
+   * @brief Set the number of threads Bullet uses for collision detection.
+   *
+   * A value of 1, the default, keeps collision detection on the stepping
+   * thread. Other values dispatch the narrowphase of overlapping pairs across
+   * Bullet's task scheduler, with values <= 0 using all hardware threads.
+   * Only takes effect if Bullet was built with thread support, see the
+   * BUILD_WITH_BULLET_MULTITHREADING CMake option.
+   */
+  void setNumCollisionThreads(int numCollisionThreads) {
+    set("num_collision_threads", numCollisionThreads);
+  }
+
+  /**
+   * @brief Get the number of threads Bullet uses for collision detection. See
+   * @ref setNumCollisionThreads().
+   */
+  int getNumCollisionThreads() const {
+    return get<int>("num_collision_threads");
+  }
+
   /**
    * @brief Populate a json object with all the first-level values held in this
    * configuration.  Default is overridden to handle special cases for
@@ -89,7 +113,7 @@ class PhysicsManagerAttributes : public AbstractAttributes {
 
   std::string getObjectInfoHeaderInternal() const override {
     return "Simulator Type,Timestep,Max Substeps,Gravity XYZ,Friction "
-           "Coefficient,Restitution Coefficient,";
+           "Coefficient,Restitution Coefficient,Num Collision Threads,";
   }
 
   /**
@@ -98,10 +122,11 @@ class PhysicsManagerAttributes : public AbstractAttributes {
    */
   std::string getObjectInfoInternal() const override {
     return Cr::Utility::formatString(
-        "{},{},{},{},{},{}", getSimulator(), getAsString("timestep"),
+        "{},{},{},{},{},{},{}", getSimulator(), getAsString("timestep"),
         getAsString("max_substeps"), getAsString("gravity"),
         getAsString("friction_coefficient"),
-        getAsString("restitution_coefficient"));
+        getAsString("restitution_coefficient"),
+        getAsString("num_collision_threads"));
   }
 
  public:
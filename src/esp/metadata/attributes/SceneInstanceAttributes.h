@@ -52,7 +52,10 @@ class SceneObjectInstanceAttributes : public AbstractAttributes {
    * @brief Get the translation from the origin of the described
    * stage/object instance.
    */
-  Mn::Vector3 getTranslation() const { return get<Mn::Vector3>("translation"); }
+  Mn::Vector3 getTranslation() const {
+    static const core::config::ConfigKey key{"translation"};
+    return get<Mn::Vector3>(key);
+  }
 
   /**
    * @brief Set a value representing the mechanism used to create this scene
@@ -102,7 +105,10 @@ class SceneObjectInstanceAttributes : public AbstractAttributes {
   /**
    * @brief Get the rotation of the object
    */
-  Mn::Quaternion getRotation() const { return get<Mn::Quaternion>("rotation"); }
+  Mn::Quaternion getRotation() const {
+    static const core::config::ConfigKey key{"rotation"};
+    return get<Mn::Quaternion>(key);
+  }
 
   /**
    * @brief If not visible can add dynamic non-rendered object into a scene
@@ -168,7 +174,8 @@ class SceneObjectInstanceAttributes : public AbstractAttributes {
    * to be a float for consumption in instance creation
    */
   float getUniformScale() const {
-    return static_cast<float>(get<double>("uniform_scale"));
+    static const core::config::ConfigKey key{"uniform_scale"};
+    return static_cast<float>(get<double>(key));
   }
 
   /**
@@ -184,7 +191,8 @@ class SceneObjectInstanceAttributes : public AbstractAttributes {
    * instance.
    */
   Mn::Vector3 getNonUniformScale() const {
-    return get<Mn::Vector3>("non_uniform_scale");
+    static const core::config::ConfigKey key{"non_uniform_scale"};
+    return get<Mn::Vector3>(key);
   }
 
   /**
@@ -240,8 +240,9 @@ AOAttributesManager::preRegisterObjectFinalize(
 std::map<std::string, std::string>
 AOAttributesManager::getArticulatedObjectModelFilenames() const {
   std::map<std::string, std::string> articulatedObjPaths;
-  for (const auto& val : this->objectLibrary_) {
-    auto attr = this->getObjectByHandle(val.first);
+  for (const std::string& objectHandle :
+       this->getObjectHandlesBySubstring("", true, false)) {
+    auto attr = this->getObjectByHandle(objectHandle);
     auto key = attr->getSimplifiedHandle();
     auto urdf = attr->getURDFPath();
     articulatedObjPaths[key] = urdf;
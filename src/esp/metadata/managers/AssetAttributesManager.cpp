@@ -106,7 +106,7 @@ AssetAttributesManager::AssetAttributesManager()
     auto tmplt = AssetAttributesManager::createObject(elem.second, true);
     std::string tmpltHandle = tmplt->getHandle();
     defaultPrimAttributeHandles_[elem.second] = tmpltHandle;
-    this->undeletableObjectNames_.insert(std::move(tmpltHandle));
+    this->addUndeletableObjectName(tmpltHandle);
   }
 
   ESP_DEBUG() << "Built default primitive asset templates :"
@@ -213,6 +213,7 @@ class AssetAttributesManager
       return {};
     }
     std::string subStr = PrimitiveNames3DMap.at(primType);
+    auto lock = this->readLockLibrary();
     return this->getObjectHandlesBySubStringPerType(this->objectLibKeyByID_,
                                                     subStr, contains, true);
   }  // AssetAttributeManager::getTemplateHandlesByPrimType
@@ -358,6 +358,10 @@ std::vector<int> AttributesManager<T, Access>::loadAllFileBasedTemplates(
     std::string dir = Cr::Utility::Path::split(paths[0]).first();
     ESP_DEBUG() << "Loading" << paths.size() << "" << this->objectType_
                 << "templates found in" << dir;
+    // Read and parse all the files up front in parallel. Objects are still
+    // created and registered one after another below, so IDs are assigned in
+    // the order of paths.
+    this->preParseJSONFiles(paths);
     for (int i = 0; i < paths.size(); ++i) {
       auto attributesFilename = paths[i];
       ESP_VERY_VERBOSE()
@@ -370,11 +374,11 @@ std::vector<int> AttributesManager<T, Access>::loadAllFileBasedTemplates(
       }
       // save handles in list of defaults, so they are not removed, if desired.
       if (saveAsDefaults) {
-        std::string tmpltHandle = tmplt->getHandle();
-        this->undeletableObjectNames_.insert(std::move(tmpltHandle));
+        this->addUndeletableObjectName(tmplt->getHandle());
       }
       templateIndices[i] = tmplt->getID();
     }
+    this->clearPreParsedJSONFiles();
   }
   ESP_DEBUG(Mn::Debug::Flag::NoSpace)
       << "<" << this->objectType_
@@ -399,7 +403,15 @@ std::vector<int> AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt(
     ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
         << "Searching " << this->objectType_ << " library directory: `" << path
         << "` for `" << extType << "` files";
-    for (auto& file : *Dir::list(path, Dir::ListFlag::SortAscending)) {
+    std::vector<std::string> files;
+    if (io::JsonSnapshot* snapshot = io::JsonSnapshot::current()) {
+      files = *snapshot->listDirectory(path);
+    } else {
+      for (auto& file : *Dir::list(path, Dir::ListFlag::SortAscending)) {
+        files.emplace_back(file);
+      }
+    }
+    for (const std::string& file : files) {
       std::string absoluteSubfilePath = Dir::join(path, file);
       if (Cr::Utility::String::endsWith(absoluteSubfilePath, extType)) {
         paths.push_back(absoluteSubfilePath);
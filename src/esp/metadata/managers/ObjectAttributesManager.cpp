@@ -68,8 +68,7 @@ void ObjectAttributesManager::createDefaultPrimBasedAttributesTemplates() {
   for (const std::string& elem : lib) {
     auto tmplt = createPrimBasedAttributesTemplate(elem, true);
     // save handles in list of defaults, so they are not removed
-    std::string tmpltHandle = tmplt->getHandle();
-    this->undeletableObjectNames_.insert(std::move(tmpltHandle));
+    this->addUndeletableObjectName(tmplt->getHandle());
   }
 }  // ObjectAttributesManager::createDefaultPrimBasedAttributesTemplates
 
@@ -298,6 +297,7 @@ void ObjectAttributesManager::postRegisterObjectHandling(
     int objectTemplateID,
     const std::string& objectTemplateHandle) {
   if (mapToAddTo_ != nullptr) {
+    auto lock = this->writeLockLibrary();
     mapToAddTo_->emplace(objectTemplateID, objectTemplateHandle);
   }
 }  // ObjectAttributesManager::postRegisterObjectHandling
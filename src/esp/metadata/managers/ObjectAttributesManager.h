@@ -69,6 +69,7 @@ class ObjectAttributesManager
    * loaded from files.
    */
   int getNumFileTemplateObjects() const {
+    auto lock = this->readLockLibrary();
     return physicsFileObjTmpltLibByID_.size();
   }
 
@@ -80,6 +81,7 @@ class ObjectAttributesManager
    * attributes template, or empty string if none loaded
    */
   std::string getRandomFileTemplateHandle() const {
+    auto lock = this->readLockLibrary();
     return this->getRandomObjectHandlePerType(physicsFileObjTmpltLibByID_,
                                               "file-based ");
   }
@@ -99,6 +101,7 @@ class ObjectAttributesManager
       const std::string& subStr = "",
       bool contains = true,
       bool sorted = true) const {
+    auto lock = this->readLockLibrary();
     return this->getObjectHandlesBySubStringPerType(physicsFileObjTmpltLibByID_,
                                                     subStr, contains, sorted);
   }
@@ -111,6 +114,7 @@ class ObjectAttributesManager
    * describe primitives.
    */
   int getNumSynthTemplateObjects() const {
+    auto lock = this->readLockLibrary();
     return physicsSynthObjTmpltLibByID_.size();
   }
 
@@ -122,6 +126,7 @@ class ObjectAttributesManager
    * attributes template, or empty string if none loaded
    */
   std::string getRandomSynthTemplateHandle() const {
+    auto lock = this->readLockLibrary();
     return this->getRandomObjectHandlePerType(physicsSynthObjTmpltLibByID_,
                                               "synthesized ");
   }
@@ -141,6 +146,7 @@ class ObjectAttributesManager
       const std::string& subStr = "",
       bool contains = true,
       bool sorted = true) const {
+    auto lock = this->readLockLibrary();
     return this->getObjectHandlesBySubStringPerType(
         physicsSynthObjTmpltLibByID_, subStr, contains, sorted);
   }
@@ -201,6 +207,7 @@ class ObjectAttributesManager
   void deleteObjectInternalFinalize(
       int templateID,
       CORRADE_UNUSED const std::string& templateHandle) override {
+    auto lock = this->writeLockLibrary();
     physicsFileObjTmpltLibByID_.erase(templateID);
     physicsSynthObjTmpltLibByID_.erase(templateID);
   }
@@ -240,6 +247,7 @@ class ObjectAttributesManager
    * reset.
    */
   void resetFinalize() override {
+    auto lock = this->writeLockLibrary();
     physicsFileObjTmpltLibByID_.clear();
     physicsSynthObjTmpltLibByID_.clear();
   }
@@ -248,17 +256,20 @@ class ObjectAttributesManager
 
   // create a ref to the partition map of either prims or file-based objects to
   // place a ref to the object template being regsitered during registration.
+  // Only valid between pre- and post-registration of a single object, so
+  // registering from several threads at once isn't supported.
   std::unordered_map<int, std::string>* mapToAddTo_ = nullptr;
 
   /**
    * @brief Maps loaded object template IDs to the appropriate template
-   * handles
+   * handles. Guarded by the library lock like the library maps.
    */
   std::unordered_map<int, std::string> physicsFileObjTmpltLibByID_;
 
   /**
    * @brief Maps synthesized, primitive-based object template IDs to the
-   * appropriate template handles
+   * appropriate template handles. Guarded by the library lock like the library
+   * maps.
    */
   std::unordered_map<int, std::string> physicsSynthObjTmpltLibByID_;
 
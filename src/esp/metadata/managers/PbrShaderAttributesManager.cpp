@@ -90,6 +90,14 @@ void PbrShaderAttributesManager::setValsFromJSONDoc(
                                pbrShaderAttribs->setDirectSpecularScale(scale);
                              });
 
+  // quality tier of the shader, which may override the settings below
+  this->setEnumStringFromJsonDoc(
+      jsonConfig, "pbr_quality", "PbrShaderQualityNamesMap", false,
+      attributes::PbrShaderQualityNamesMap,
+      [pbrShaderAttribs](const std::string& val) {
+        pbrShaderAttribs->setPbrQuality(val);
+      });
+
   ////////////////////////////
   // Material Layer calculation settings
 
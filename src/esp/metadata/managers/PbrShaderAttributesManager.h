@@ -71,11 +71,12 @@ class PbrShaderAttributesManager
    * to have IBL either on or off.
    */
   void setAllIBLEnabled(bool isIblEnabled) {
-    for (const auto& val : this->objectLibrary_) {
+    for (const std::string& objectHandle :
+         this->getObjectHandlesBySubstring("", true, false)) {
       // Don't change system default
-      if (val.first.find(ESP_DEFAULT_PBRSHADER_CONFIG_REL_PATH) ==
+      if (objectHandle.find(ESP_DEFAULT_PBRSHADER_CONFIG_REL_PATH) ==
           std::string::npos) {
-        this->getObjectByHandle(val.first)->setEnableIBL(isIblEnabled);
+        this->getObjectByHandle(objectHandle)->setEnableIBL(isIblEnabled);
       }
     }
   }  // PbrShaderAttributesManager::setAllIBLEnabled
@@ -85,12 +86,13 @@ class PbrShaderAttributesManager
    * to have Direct Ligthing either on or off.
    */
   void setAllDirectLightsEnabled(bool isDirLightEnabled) {
-    for (const auto& val : this->objectLibrary_) {
+    for (const std::string& objectHandle :
+         this->getObjectHandlesBySubstring("", true, false)) {
       // Don't change system default
-      if (val.first.find(ESP_DEFAULT_PBRSHADER_CONFIG_REL_PATH) ==
+      if (objectHandle.find(ESP_DEFAULT_PBRSHADER_CONFIG_REL_PATH) ==
           std::string::npos) {
-        this->getObjectByHandle(val.first)->setEnableDirectLighting(
-            isDirLightEnabled);
+        this->getObjectByHandle(objectHandle)
+            ->setEnableDirectLighting(isDirLightEnabled);
       }
     }
   }  // PbrShaderAttributesManager::setAllDirectLightsEnabled
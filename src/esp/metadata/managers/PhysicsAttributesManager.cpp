@@ -67,6 +67,13 @@ void PhysicsAttributesManager::setValsFromJSONDoc(
             restitution_coefficient);
       });
 
+  // load the number of collision detection threads
+  io::jsonIntoSetter<int>(
+      jsonConfig, "num_collision_threads",
+      [physicsManagerAttributes](int num_collision_threads) {
+        physicsManagerAttributes->setNumCollisionThreads(num_collision_threads);
+      });
+
   // load world gravity
   io::jsonIntoConstSetter<Magnum::Vector3>(
       jsonConfig, "gravity",
@@ -67,8 +67,9 @@ class SceneDatasetAttributesManager
    */
   void setCurrPhysicsManagerAttributesHandle(const std::string& handle) {
     physicsManagerAttributesHandle_ = handle;
-    for (const auto& val : this->objectLibrary_) {
-      this->getObjectByHandle(val.first)->setPhysicsManagerHandle(handle);
+    for (const std::string& objectHandle :
+         this->getObjectHandlesBySubstring("", true, false)) {
+      this->getObjectByHandle(objectHandle)->setPhysicsManagerHandle(handle);
     }
   }  // SceneDatasetAttributesManager::setCurrPhysicsManagerAttributesHandle
 
@@ -87,9 +88,10 @@ class SceneDatasetAttributesManager
    */
   void setDefaultPbrShaderAttributesHandle(const std::string& pbrHandle) {
     defaultPbrShaderAttributesHandle_ = pbrHandle;
-    for (const auto& val : this->objectLibrary_) {
-      this->getObjectByHandle(val.first)->setDefaultPbrShaderAttrHandle(
-          pbrHandle);
+    for (const std::string& objectHandle :
+         this->getObjectHandlesBySubstring("", true, false)) {
+      this->getObjectByHandle(objectHandle)
+          ->setDefaultPbrShaderAttrHandle(pbrHandle);
     }
   }  // SceneDatasetAttributesManager::setDefaultPbrShaderAttributesHandle
 
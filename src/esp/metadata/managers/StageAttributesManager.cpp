@@ -42,8 +42,7 @@ void StageAttributesManager::createDefaultPrimBasedAttributesTemplates() {
   // based on default
   auto tmplt = this->postCreateRegister(
       StageAttributesManager::initNewObjectInternal("NONE", false), true);
-  std::string tmpltHandle = tmplt->getHandle();
-  this->undeletableObjectNames_.insert(std::move(tmpltHandle));
+  this->addUndeletableObjectName(tmplt->getHandle());
 }  // StageAttributesManager::createDefaultPrimBasedAttributesTemplates
 
 core::managedContainers::ManagedObjectPreregistration
@@ -8,6 +8,9 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include <cmath>
+#include <limits>
+
 #include "esp/core/Esp.h"
 #include "esp/geo/Geo.h"
 
@@ -255,9 +258,119 @@ GreedyGeodesicFollowerImpl::findPath(const Mn::Quaternion& currentRot,
   return findPath({currentRot, currentPos}, end);
 }
 
+bool GreedyGeodesicFollowerImpl::updateGoalField(const Mn::Vector3& end) {
+  if (hasGoalField_ && goalFieldEnd_ == end)
+    return true;
+
+  goalField_.setRequestedEnds({cast<vec3f>(end)});
+  hasGoalField_ = pathfinder_->buildGoalDistanceField(goalField_);
+  goalFieldEnd_ = end;
+  return hasGoalField_;
+}
+
+std::vector<GreedyGeodesicFollowerImpl::CODES>
+GreedyGeodesicFollowerImpl::findPathWithGoalField(const core::RigidState& start,
+                                                  const Mn::Vector3& end,
+                                                  const bool allowSliding) {
+  constexpr int maxActions = 5e3;
+  // same tolerance the agent's move actuations use to detect collisions
+  constexpr float collisionEps = 1e-5f;
+  if (!updateGoalField(end))
+    return {};
+
+  Mn::Vector3 position = start.translation;
+  Mn::Quaternion rotation = start.rotation;
+  float geodesicDistance =
+      pathfinder_->getGoalDistance(goalField_, cast<vec3f>(position));
+
+  std::vector<CODES> actions;
+  while (actions.size() < maxActions) {
+    if (geodesicDistance == std::numeric_limits<float>::infinity())
+      return {};
+
+    if (geodesicDistance < goalDist_) {
+      actions.emplace_back(CODES::STOP);
+      return actions;
+    }
+
+    // Same primitives and reward as nextBestPrimAlong(), with the heading
+    // after n turns computed directly. turns > 0 are left, < 0 right.
+    float bestReward = -collisionCost_;
+    int bestTurns = 0;
+    bool foundPrim = false;
+    Mn::Vector3 bestPosition;
+    float bestGeodesicDistance = 0;
+    for (int n = 0; n * turnAmount_ < M_PI; ++n) {
+      for (const int turns : {n, -n}) {
+        if (turns == -n && n == 0)
+          continue;
+
+        const Mn::Quaternion primRotation =
+            rotation * Mn::Quaternion::rotation(Mn::Rad(turns * turnAmount_),
+                                                Mn::Vector3::yAxis());
+        const Mn::Vector3 target =
+            position + float(forwardAmount_) * primRotation.transformVector(
+                                                   -Mn::Vector3::zAxis());
+        const Mn::Vector3 newPosition =
+            allowSliding ? pathfinder_->tryStep(position, target)
+                         : pathfinder_->tryStepNoSliding(position, target);
+
+        const bool didCollide =
+            (newPosition - position).length() + collisionEps < forwardAmount_;
+        const float geoDistAfter =
+            pathfinder_->getGoalDistance(goalField_, cast<vec3f>(newPosition));
+        const float distToObsAfter = pathfinder_->distanceToClosestObstacle(
+            cast<vec3f>(newPosition), 1.1 * closeToObsThreshold_);
+
+        const float reward =
+            (geodesicDistance - geoDistAfter) / forwardAmount_ +
+            (-0.0125f * n - (didCollide ? collisionCost_ : 0.0f) -
+             (distToObsAfter < closeToObsThreshold_ ? 0.05f : 0.0f));
+        if (reward > bestReward) {
+          bestReward = reward;
+          bestTurns = turns;
+          bestPosition = newPosition;
+          bestGeodesicDistance = geoDistAfter;
+          foundPrim = true;
+        }
+      }
+
+      // If reward is within 99% of max (1.0), call it good enough and exit
+      constexpr float goodEnoughRewardThresh = 0.99f;
+      if (bestReward > goodEnoughRewardThresh)
+        break;
+    }
+
+    if (!foundPrim)
+      return {};
+
+    actions.insert(actions.end(), std::abs(bestTurns),
+                   bestTurns > 0 ? CODES::LEFT : CODES::RIGHT);
+    actions.emplace_back(CODES::FORWARD);
+    rotation = rotation * Mn::Quaternion::rotation(
+                              Mn::Rad(bestTurns * turnAmount_),
+                              Mn::Vector3::yAxis());
+    position = bestPosition;
+    geodesicDistance = bestGeodesicDistance;
+  }
+
+  return {};
+}
+
+std::vector<GreedyGeodesicFollowerImpl::CODES>
+GreedyGeodesicFollowerImpl::findPathWithGoalField(
+    const Mn::Quaternion& startRot,
+    const Mn::Vector3& startPos,
+    const Mn::Vector3& end,
+    const bool allowSliding) {
+  return findPathWithGoalField(core::RigidState{startRot, startPos}, end,
+                               allowSliding);
+}
+
 void GreedyGeodesicFollowerImpl::reset() {
   actions_.clear();
   thrashingActions_.clear();
+  hasGoalField_ = false;
 }
 
 }  // namespace nav
@@ -112,6 +112,36 @@ class GreedyGeodesicFollowerImpl {
   std::vector<CODES> findPath(const core::RigidState& start,
                               const Magnum::Vector3& end);
 
+  /**
+   * @brief Same as @ref findPath, but plans without simulating the actions
+   *
+   * Geodesic distances come from a distance field toward @p end built once
+   * with @ref PathFinder::buildGoalDistanceField instead of a path search for
+   * every candidate, and turns are applied in closed form as rotations about
+   * the Y axis by the turn amount. Forward steps are filtered through
+   * @ref PathFinder::tryStep directly, so the move functions passed to the
+   * constructor are not used. This is much faster for generating oracle
+   * trajectories, but assumes the default "move_forward", "turn_left" and
+   * "turn_right" actuations.
+   *
+   * The field is kept for further calls with the same @p end until @ref reset
+   * is called, which must also be done after the NavMesh changes.
+   *
+   * @param[in] start The starting state
+   * @param[in] end The end location of the path
+   * @param[in] allowSliding Whether forward steps slide along walls, as
+   * configured for the simulator
+   */
+  std::vector<CODES> findPathWithGoalField(const core::RigidState& start,
+                                           const Magnum::Vector3& end,
+                                           bool allowSliding = true);
+
+  /** @overload */
+  std::vector<CODES> findPathWithGoalField(const Magnum::Quaternion& startRot,
+                                           const Magnum::Vector3& startPos,
+                                           const Magnum::Vector3& end,
+                                           bool allowSliding = true);
+
   /**
    * @brief Reset the planner.
    *
@@ -141,6 +171,11 @@ class GreedyGeodesicFollowerImpl {
   ShortestPath geoDistPath_;
   float geoDist(const Magnum::Vector3& start, const Magnum::Vector3& end);
 
+  MultiGoalShortestPath goalField_;
+  Magnum::Vector3 goalFieldEnd_;
+  bool hasGoalField_ = false;
+  bool updateGoalField(const Magnum::Vector3& end);
+
   struct TryStepResult {
     float postGeodesicDistance, postDistanceToClosestObstacle;
     bool didCollide;
@@ -3,9 +3,16 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PathFinder.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <functional>
+#include <mutex>
 #include <numeric>
+#include <queue>
+#include <random>
 #include <stack>
+#include <thread>
 #include <unordered_map>
 
 #include <Magnum/Magnum.h>
@@ -14,6 +21,7 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Path.h>
 
@@ -24,8 +32,18 @@
 #include <limits>
 #include <utility>
 
+#ifdef CORRADE_TARGET_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/core/Hash.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/Random.h"
 
 #include "DetourCommon.h"
 #include "DetourNavMesh.h"
@@ -103,6 +121,19 @@ struct MultiGoalShortestPath::Impl {
 
   std::vector<float> minTheoreticalDist;
   vec3f prevRequestedStart = vec3f::Zero();
+
+  //! Distance-to-goal field over the NavMesh polygons, see
+  //! PathFinder::buildGoalDistanceField. Empty unless built.
+  struct GoalDistanceField {
+    //! PathFinder::Impl::navQueryToken_ of the NavMesh the field was
+    //! computed for, 0 if not built
+    uint64_t navMeshToken = 0;
+    //! Per polygon distance to the closest goal from the entry point
+    std::vector<float> dist;
+    std::vector<vec3f> entry;
+    //! Snapped goal points of polygons which contain goals
+    std::unordered_map<int, std::vector<vec3f>> goalsInPoly;
+  } goalField;
 };
 
 MultiGoalShortestPath::MultiGoalShortestPath()
@@ -113,6 +144,7 @@ void MultiGoalShortestPath::setRequestedEnds(
   pimpl_->endRefs.clear();
   pimpl_->pathEnds.clear();
   pimpl_->requestedEnds = newEnds;
+  pimpl_->goalField = {};
 
   pimpl_->minTheoreticalDist.assign(newEnds.size(), 0);
 }
@@ -165,6 +197,9 @@ inline ushort orFlag(ushort curFlags, ushort flag) {
 // Takes O(npolys) to construct
 class IslandSystem {
  public:
+  //! Empty island system, to be restored with @ref read
+  IslandSystem() = default;
+
   IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter) {
     std::vector<vec3f> islandVerts;
 
@@ -186,20 +221,7 @@ class IslandSystem {
           uint32_t newIslandId = islandRadius_.size();
           expandFrom(navMesh, filter, newIslandId, startRef, islandVerts);
 
-          // The radius is calculated as the max deviation from the mean for all
-          // points in the island
-          vec3f centroid = vec3f::Zero();
-          for (auto& v : islandVerts) {
-            centroid += v;
-          }
-          centroid /= islandVerts.size();
-
-          float maxRadius = 0.0;
-          for (auto& v : islandVerts) {
-            maxRadius = std::max(maxRadius, (v - centroid).norm());
-          }
-
-          islandRadius_.emplace_back(maxRadius);
+          addIslandGeometry(islandVerts);
         }
       }
     }
@@ -255,6 +277,23 @@ class IslandSystem {
     return islandRadius_.size();
   }
 
+  //! All cached per-island properties
+  std::vector<IslandStatistics> statistics() const {
+    std::vector<IslandStatistics> stats(islandRadius_.size());
+    for (uint32_t i = 0; i < stats.size(); ++i) {
+      const auto area = islandsToArea_.find(i);
+      const auto polys = islandsToPolys_.find(i);
+      stats[i].area = area != islandsToArea_.end() ? area->second : 0.0f;
+      stats[i].radius = islandRadius_[i];
+      stats[i].centroid = islandCentroid_[i];
+      stats[i].boundsMin = islandBounds_[i].first;
+      stats[i].boundsMax = islandBounds_[i].second;
+      stats[i].numPolys =
+          polys != islandsToPolys_.end() ? polys->second.size() : 0;
+    }
+    return stats;
+  }
+
   /**
    * @brief Sets a specified poly flag for all polys specified by the
    * islandIndex.
@@ -396,6 +435,23 @@ class IslandSystem {
   //! return the island for a navmesh polygon
   inline int getPolyIsland(dtPolyRef polyRef) { return polyToIsland_[polyRef]; }
 
+  //! return the island for a navmesh polygon, ID_UNDEFINED if it has none.
+  //! Unlike getPolyIsland, safe to call concurrently.
+  inline int findPolyIsland(dtPolyRef polyRef) const {
+    auto itRef = polyToIsland_.find(polyRef);
+    if (itRef == polyToIsland_.end())
+      return ID_UNDEFINED;
+    return itRef->second;
+  }
+
+  //! Write the islands, their areas and radii as a .navmesh file section.
+  bool write(FILE* fp) const;
+
+  //! Restore islands from a section written by @ref write. Returns false if
+  //! the section is missing or doesn't match the polys of navMesh.
+  bool read(const dtNavMesh* navMesh,
+            Cr::Containers::ArrayView<const char> data);
+
  private:
   //! map islands to area for quick query
   std::unordered_map<uint32_t, float> islandsToArea_;
@@ -404,6 +460,33 @@ class IslandSystem {
   //! map polygons to their island for quick look-up
   std::unordered_map<dtPolyRef, uint32_t> polyToIsland_;
   std::vector<float> islandRadius_;
+  std::vector<vec3f> islandCentroid_;
+  std::vector<std::pair<vec3f, vec3f>> islandBounds_;
+
+  //! Append the radius, centroid and bounds of the next island, given the
+  //! vertices of its polygons
+  void addIslandGeometry(const std::vector<vec3f>& islandVerts) {
+    // The radius is calculated as the max deviation from the mean for all
+    // points in the island
+    vec3f centroid = vec3f::Zero();
+    vec3f bmin = vec3f::Constant(std::numeric_limits<float>::max());
+    vec3f bmax = vec3f::Constant(-std::numeric_limits<float>::max());
+    for (auto& v : islandVerts) {
+      centroid += v;
+      bmin = bmin.cwiseMin(v);
+      bmax = bmax.cwiseMax(v);
+    }
+    centroid /= islandVerts.size();
+
+    float maxRadius = 0.0;
+    for (auto& v : islandVerts) {
+      maxRadius = std::max(maxRadius, (v - centroid).norm());
+    }
+
+    islandRadius_.emplace_back(maxRadius);
+    islandCentroid_.emplace_back(centroid);
+    islandBounds_.emplace_back(bmin, bmax);
+  }
 
   void expandFrom(const dtNavMesh* navMesh,
                   const dtQueryFilter* filter,
@@ -457,6 +540,494 @@ class IslandSystem {
     }
   }
 };
+
+// Dense, flattened view of the NavMesh polygon adjacency graph. Polygons are
+// indexed contiguously across tiles and each walkable polygon stores its
+// centroid and the midpoints of the portals to its walkable neighbours, which
+// is the same cost model Detour's A* uses for intermediate nodes.
+// Takes O(npolys) to construct
+class PolyGraph {
+ public:
+  struct Edge {
+    int to;
+    vec3f portal;
+  };
+
+  PolyGraph(const dtNavMesh* navMesh, const dtQueryFilter* filter)
+      : navMesh_{navMesh} {
+    tileBase_.assign(navMesh->getMaxTiles(), ID_UNDEFINED);
+    int numPolys = 0;
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+      tileBase_[iTile] = numPolys;
+      numPolys += tile->header->polyCount;
+    }
+
+    refs_.assign(numPolys, 0);
+    walkable_.assign(numPolys, false);
+    centroids_.assign(numPolys, vec3f::Zero());
+    edgeOffsets_.assign(numPolys + 1, 0);
+
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const int index = tileBase_[iTile] + jPoly;
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+        refs_[index] = ref;
+        walkable_[index] = filter->passFilter(ref, tile, poly);
+
+        for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+          centroids_[index] += Eigen::Map<const vec3f>(
+              &tile->verts[static_cast<size_t>(poly->verts[iVert]) * 3]);
+        }
+        centroids_[index] /= poly->vertCount;
+
+        if (walkable_[index]) {
+          for (unsigned int iLink = poly->firstLink; iLink != DT_NULL_LINK;
+               iLink = tile->links[iLink].next) {
+            const dtLink& link = tile->links[iLink];
+            const dtMeshTile* neighbourTile = nullptr;
+            const dtPoly* neighbourPoly = nullptr;
+            navMesh->getTileAndPolyByRefUnsafe(link.ref, &neighbourTile,
+                                               &neighbourPoly);
+            if (!filter->passFilter(link.ref, neighbourTile, neighbourPoly))
+              continue;
+            edges_.push_back(
+                {polyIndex(link.ref), portalMidpoint(tile, poly, link)});
+          }
+        }
+        edgeOffsets_[index + 1] = edges_.size();
+      }
+    }
+
+    // identifies the NavMesh the graph was built from, see checksum()
+    core::Fnv1aHash hash;
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+      hash.addWord(iTile);
+      hash.add(tile->verts, sizeof(float) * 3 * tile->header->vertCount);
+    }
+    hash.add(refs_.data(), refs_.size() * sizeof(dtPolyRef));
+    for (int i = 0; i < numPolys; ++i) {
+      hash.addWord(walkable_[i]);
+    }
+    hash.add(centroids_.data(), centroids_.size() * sizeof(vec3f));
+    hash.add(edgeOffsets_.data(), edgeOffsets_.size() * sizeof(size_t));
+    hash.add(edges_.data(), edges_.size() * sizeof(Edge));
+    checksum_ = hash.value();
+  }
+
+  int numPolys() const { return refs_.size(); }
+
+  //! Hash of the tile vertices, polygon refs and connectivity
+  uint64_t checksum() const { return checksum_; }
+
+  dtPolyRef polyRef(int index) const { return refs_[index]; }
+
+  //! Dense index of a polygon or ID_UNDEFINED if the ref is invalid.
+  int polyIndex(dtPolyRef ref) const {
+    unsigned int salt = 0, iTile = 0, iPoly = 0;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    if (ref == 0 || iTile >= tileBase_.size() ||
+        tileBase_[iTile] == ID_UNDEFINED) {
+      return ID_UNDEFINED;
+    }
+    return tileBase_[iTile] + iPoly;
+  }
+
+  bool isWalkable(int index) const { return walkable_[index]; }
+
+  const vec3f& centroid(int index) const { return centroids_[index]; }
+
+  Cr::Containers::ArrayView<const Edge> edges(int index) const {
+    return {edges_.data() + edgeOffsets_[index],
+            edgeOffsets_[index + 1] - edgeOffsets_[index]};
+  }
+
+  /**
+   * @brief Multi-source Dijkstra over the polygon graph.
+   *
+   * @param[in] sources Pairs of (poly index, source position), all at
+   * distance 0.
+   * @param[out] dist Distance from the closest source to the entry point of
+   * each polygon, inf if unreachable.
+   * @param[out] entry The point at which the shortest path enters each
+   * polygon (a portal midpoint or the source position).
+   * @param[out] parent The previous polygon on the shortest path towards the
+   * sources or ID_UNDEFINED. Optional.
+   * @param[in] stopAt Called for each settled polygon, the search terminates
+   * once it returns true.
+   *
+   * @return The polygon on which the search was stopped or ID_UNDEFINED.
+   */
+  template <typename StopFn>
+  int dijkstra(const std::vector<std::pair<int, vec3f>>& sources,
+               std::vector<float>& dist,
+               std::vector<vec3f>& entry,
+               std::vector<int>* parent,
+               StopFn&& stopAt) const {
+    dist.assign(numPolys(), std::numeric_limits<float>::infinity());
+    entry.resize(numPolys());
+    if (parent) {
+      parent->assign(numPolys(), ID_UNDEFINED);
+    }
+
+    typedef std::pair<float, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                        std::greater<QueueEntry>>
+        queue;
+    for (const auto& source : sources) {
+      if (source.first == ID_UNDEFINED || !walkable_[source.first])
+        continue;
+      dist[source.first] = 0;
+      entry[source.first] = source.second;
+      queue.emplace(0.0f, source.first);
+    }
+
+    while (!queue.empty()) {
+      const QueueEntry top = queue.top();
+      queue.pop();
+      const int current = top.second;
+      // stale entry, the poly was already settled with a shorter distance
+      if (top.first > dist[current])
+        continue;
+      if (stopAt(current))
+        return current;
+
+      for (const Edge& edge : edges(current)) {
+        const float newDist =
+            dist[current] + (edge.portal - entry[current]).norm();
+        if (newDist < dist[edge.to]) {
+          dist[edge.to] = newDist;
+          entry[edge.to] = edge.portal;
+          if (parent) {
+            (*parent)[edge.to] = current;
+          }
+          queue.emplace(newDist, edge.to);
+        }
+      }
+    }
+    return ID_UNDEFINED;
+  }
+
+ private:
+  // Same portal computation as dtNavMeshQuery::getPortalPoints
+  static vec3f portalMidpoint(const dtMeshTile* tile,
+                              const dtPoly* poly,
+                              const dtLink& link) {
+    const vec3f va = Eigen::Map<const vec3f>(
+        &tile->verts[static_cast<size_t>(poly->verts[link.edge]) * 3]);
+    const vec3f vb = Eigen::Map<const vec3f>(
+        &tile->verts[static_cast<size_t>(
+                         poly->verts[(link.edge + 1) % poly->vertCount]) *
+                     3]);
+    // portals on tile borders may only span part of the edge
+    if (link.side != 0xff && (link.bmin != 0 || link.bmax != 255)) {
+      const float s = 1.0f / 255.0f;
+      const vec3f left = va + (vb - va) * (link.bmin * s);
+      const vec3f right = va + (vb - va) * (link.bmax * s);
+      return 0.5f * (left + right);
+    }
+    return 0.5f * (va + vb);
+  }
+
+  const dtNavMesh* navMesh_;
+  //! First dense index of each tile, ID_UNDEFINED for empty tiles
+  std::vector<int> tileBase_;
+  std::vector<dtPolyRef> refs_;
+  std::vector<bool> walkable_;
+  std::vector<vec3f> centroids_;
+  //! CSR adjacency: edges of poly i are edges_[edgeOffsets_[i]..[i + 1])
+  std::vector<size_t> edgeOffsets_;
+  std::vector<Edge> edges_;
+  uint64_t checksum_ = 0;
+};
+
+// Landmark (ALT) distance table over the polygon graph. Stores the distance
+// from each landmark polygon centroid to every polygon centroid. If the memory
+// budget allows a landmark for every polygon the table is all-pairs and
+// queries are O(1), otherwise they are O(number of landmarks) and return
+// lower/upper bounds from the triangle inequality.
+class DistanceOracle {
+ public:
+  DistanceOracle() = default;
+
+  DistanceOracle(const PolyGraph& graph,
+                 std::size_t maxMemoryBytes,
+                 int numThreads) {
+    numPolys_ = graph.numPolys();
+    navMeshChecksum_ = graph.checksum();
+    std::vector<int> walkablePolys;
+    for (int i = 0; i < numPolys_; ++i) {
+      if (graph.isWalkable(i))
+        walkablePolys.push_back(i);
+    }
+    const std::size_t rowBytes =
+        std::max<std::size_t>(numPolys_, 1) * sizeof(float);
+    if (walkablePolys.empty())
+      return;
+    const int numLandmarks = static_cast<int>(
+        std::min<std::size_t>(walkablePolys.size(),
+                              std::max<std::size_t>(maxMemoryBytes / rowBytes,
+                                                    1)));
+
+    table_.resize(static_cast<std::size_t>(numLandmarks) * numPolys_);
+    rowOfPoly_.assign(numPolys_, ID_UNDEFINED);
+
+    if (numLandmarks == static_cast<int>(walkablePolys.size())) {
+      // all-pairs: rows are independent so compute them in parallel
+      allPairs_ = true;
+      landmarks_ = std::move(walkablePolys);
+      core::parallelFor(landmarks_.size(), numThreads,
+                        [&](std::size_t row, int) {
+                          computeRow(graph, row, nullptr);
+                        });
+    } else {
+      // greedy farthest-point landmark selection: each new landmark is the
+      // polygon farthest from all previous landmarks. Unreachable polygons
+      // are infinitely far, so every island gets a landmark first.
+      std::vector<float> minDist(numPolys_,
+                                 std::numeric_limits<float>::infinity());
+      int next = walkablePolys.front();
+      for (int row = 0; row < numLandmarks; ++row) {
+        landmarks_.push_back(next);
+        computeRow(graph, row, &minDist);
+        float farthest = -1.0f;
+        for (int poly : walkablePolys) {
+          if (minDist[poly] > farthest) {
+            farthest = minDist[poly];
+            next = poly;
+          }
+        }
+      }
+    }
+
+    for (std::size_t row = 0; row < landmarks_.size(); ++row) {
+      rowOfPoly_[landmarks_[row]] = static_cast<int>(row);
+    }
+  }
+
+  bool isAllPairs() const { return allPairs_; }
+
+  int numLandmarks() const { return landmarks_.size(); }
+
+  std::size_t memoryBytes() const {
+    return table_.size() * sizeof(float) + landmarks_.size() * sizeof(int) +
+           rowOfPoly_.size() * sizeof(int);
+  }
+
+  /**
+   * @brief Bounds on the centroid to centroid distance of two polygons.
+   *
+   * @return (lower, upper), upper is inf if no landmark reaches both.
+   */
+  std::pair<float, float> bounds(int polyA, int polyB) const {
+    // direct lookup when either polygon is a landmark
+    const int rowA = rowOfPoly_[polyA];
+    const int rowB = rowOfPoly_[polyB];
+    if (rowA != ID_UNDEFINED || rowB != ID_UNDEFINED) {
+      const float d = rowA != ID_UNDEFINED ? at(rowA, polyB) : at(rowB, polyA);
+      return {d, d};
+    }
+
+    float lower = 0;
+    float upper = std::numeric_limits<float>::infinity();
+    for (std::size_t row = 0; row < landmarks_.size(); ++row) {
+      const float da = at(row, polyA);
+      const float db = at(row, polyB);
+      if (std::isinf(da) || std::isinf(db))
+        continue;
+      lower = std::max(lower, std::abs(da - db));
+      upper = std::min(upper, da + db);
+    }
+    return {lower, upper};
+  }
+
+  bool save(const std::string& path) const;
+  bool load(const std::string& path, const PolyGraph& graph);
+
+ private:
+  float at(std::size_t row, int poly) const {
+    return table_[row * numPolys_ + poly];
+  }
+
+  void computeRow(const PolyGraph& graph,
+                  std::size_t row,
+                  std::vector<float>* minDist) {
+    const int landmark = landmarks_[row];
+    std::vector<float> dist;
+    std::vector<vec3f> entry;
+    graph.dijkstra({{landmark, graph.centroid(landmark)}}, dist, entry,
+                   nullptr, [](int) { return false; });
+    float* out = table_.data() + row * numPolys_;
+    for (int i = 0; i < numPolys_; ++i) {
+      // distance to the centroid rather than the entry point so queries can
+      // bound the error by the query point's distance to the centroid
+      out[i] = dist[i] + (std::isinf(dist[i])
+                              ? 0.0f
+                              : (graph.centroid(i) - entry[i]).norm());
+      if (minDist) {
+        (*minDist)[i] = std::min((*minDist)[i], out[i]);
+      }
+    }
+  }
+
+  int numPolys_ = 0;
+  //! PolyGraph::checksum() of the NavMesh the oracle was computed for
+  uint64_t navMeshChecksum_ = 0;
+  bool allPairs_ = false;
+  std::vector<int> landmarks_;
+  //! The table row of each landmark polygon, ID_UNDEFINED otherwise
+  std::vector<int> rowOfPoly_;
+  //! numLandmarks x numPolys distances
+  std::vector<float> table_;
+};
+
+// Area weighted sampler over the detail triangles of a subset of the NavMesh
+// polys. Points are uniformly distributed over the XZ projection of the polys,
+// the same distribution dtNavMeshQuery::findRandomPoint() samples from, but
+// drawing a point is a binary search instead of a pass over all polys.
+class AreaSampler {
+ public:
+  //! Sample from the polys passing filter for which includePoly is true and
+  //! whose detail triangles overlap the XZ bounds, if given
+  AreaSampler(const dtNavMesh* navMesh,
+              const dtQueryFilter* filter,
+              const std::function<bool(dtPolyRef)>& includePoly,
+              const std::pair<vec3f, vec3f>* bounds = nullptr);
+
+  bool empty() const { return triangles_.empty(); }
+
+  vec3f sample(core::Random& rng) const {
+    const double r = rng.uniform_float_01() * cdf_.back();
+    const std::size_t index = std::min<std::size_t>(
+        std::upper_bound(cdf_.begin(), cdf_.end(), r) - cdf_.begin(),
+        triangles_.size() - 1);
+    const Triangle& tri = triangles_[index];
+    float u = rng.uniform_float_01();
+    float v = rng.uniform_float_01();
+    if (u + v > 1.0f) {
+      u = 1.0f - u;
+      v = 1.0f - v;
+    }
+    return tri.v[0] + u * (tri.v[1] - tri.v[0]) + v * (tri.v[2] - tri.v[0]);
+  }
+
+ private:
+  struct Triangle {
+    vec3f v[3];
+  };
+  std::vector<Triangle> triangles_;
+  //! Cumulative XZ area of triangles_
+  std::vector<double> cdf_;
+};
+
+// Distance to the closest NavMesh boundary sampled on a regular XZ grid. Every
+// NavMesh layer crossing a grid point, such as each floor of a building, gets
+// its own sample, so the field is 2.5D. Queried by bilinear interpolation of
+// the samples of the four grid points around a position on the layer closest
+// to its height.
+class ObstacleDistanceField {
+ public:
+  struct Sample {
+    float height;
+    float distance;
+  };
+
+  //! pointSamples are the samples of each grid point, row-major with X
+  //! changing fastest
+  ObstacleDistanceField(const vec3f& origin,
+                        float cellSize,
+                        int sizeX,
+                        int sizeZ,
+                        float maxRadius,
+                        const std::vector<std::vector<Sample>>& pointSamples)
+      : origin_{origin},
+        cellSize_{cellSize},
+        sizeX_{sizeX},
+        sizeZ_{sizeZ},
+        maxRadius_{maxRadius} {
+    CORRADE_INTERNAL_ASSERT(sizeX_ >= 2 && sizeZ_ >= 2 &&
+                            pointSamples.size() ==
+                                std::size_t(sizeX_) * std::size_t(sizeZ_));
+    offsets_.reserve(pointSamples.size() + 1);
+    offsets_.push_back(0);
+    for (const std::vector<Sample>& samples : pointSamples) {
+      samples_.insert(samples_.end(), samples.begin(), samples.end());
+      offsets_.push_back(static_cast<uint32_t>(samples_.size()));
+    }
+  }
+
+  float maxRadius() const { return maxRadius_; }
+
+  std::size_t memoryBytes() const {
+    return offsets_.size() * sizeof(uint32_t) +
+           samples_.size() * sizeof(Sample);
+  }
+
+  //! False if the position is outside of the grid or any of the four grid
+  //! points around it has no layer within heightTolerance, e.g. next to a
+  //! wall, where the caller is expected to do an exact search instead
+  bool lookup(const vec3f& pt, float heightTolerance, float& distance) const {
+    const float fx = (pt[0] - origin_[0]) / cellSize_;
+    const float fz = (pt[2] - origin_[2]) / cellSize_;
+    // also rejects NaNs
+    if (!(fx >= 0.0f && fz >= 0.0f && fx <= float(sizeX_ - 1) &&
+          fz <= float(sizeZ_ - 1)))
+      return false;
+    const int x = std::min(int(fx), sizeX_ - 2);
+    const int z = std::min(int(fz), sizeZ_ - 2);
+    const float tx = fx - float(x);
+    const float tz = fz - float(z);
+
+    float d00 = 0.0f, d10 = 0.0f, d01 = 0.0f, d11 = 0.0f;
+    if (!sampleAt(x, z, pt[1], heightTolerance, d00) ||
+        !sampleAt(x + 1, z, pt[1], heightTolerance, d10) ||
+        !sampleAt(x, z + 1, pt[1], heightTolerance, d01) ||
+        !sampleAt(x + 1, z + 1, pt[1], heightTolerance, d11))
+      return false;
+    distance = (1.0f - tz) * ((1.0f - tx) * d00 + tx * d10) +
+               tz * ((1.0f - tx) * d01 + tx * d11);
+    return true;
+  }
+
+ private:
+  bool sampleAt(int x,
+                int z,
+                float height,
+                float heightTolerance,
+                float& distance) const {
+    const std::size_t point = std::size_t(z) * sizeX_ + x;
+    bool found = false;
+    float closest = heightTolerance;
+    for (uint32_t i = offsets_[point]; i != offsets_[point + 1]; ++i) {
+      const float dy = std::abs(samples_[i].height - height);
+      if (dy <= closest) {
+        closest = dy;
+        distance = samples_[i].distance;
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  vec3f origin_;
+  float cellSize_;
+  int sizeX_;
+  int sizeZ_;
+  float maxRadius_;
+  //! Samples of grid point i are samples_[offsets_[i]] to
+  //! samples_[offsets_[i + 1]]
+  std::vector<uint32_t> offsets_;
+  std::vector<Sample> samples_;
+};
 }  // namespace impl
 
 struct PathFinder::Impl {
@@ -472,8 +1043,48 @@ struct PathFinder::Impl {
              const float* bmax);
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
+  bool rebuildTiles(const NavMeshSettings& bs,
+                    const esp::assets::MeshData& mesh,
+                    const std::vector<std::pair<vec3f, vec3f>>& regions);
+
+  void setBuildTiling(int tileSize, int numThreads) {
+    buildTileSize_ = tileSize;
+    buildNumThreads_ = numThreads;
+  }
+
+  int getBuildTileSize() const { return buildTileSize_; }
+
+  bool setObstacleDistanceField(float metersPerCell,
+                                float maxRadius,
+                                int numThreads) {
+    obstacleFieldCellSize_ = metersPerCell;
+    obstacleFieldMaxRadius_ = maxRadius;
+    obstacleFieldNumThreads_ = numThreads;
+    obstacleField_ = nullptr;
+    if (metersPerCell <= 0.0f || !isLoaded())
+      return false;
+    return buildObstacleDistanceField();
+  }
+
+  bool hasObstacleDistanceField() const { return obstacleField_ != nullptr; }
+
   vec3f getRandomNavigablePoint(int maxTries,
                                 int islandIndex /*= ID_UNDEFINED*/);
+  std::vector<vec3f> getRandomNavigablePoints(
+      int numPoints,
+      int islandIndex,
+      const Cr::Containers::Optional<uint32_t>& seed,
+      int numThreads);
+
+  std::vector<vec3f> getRandomNavigablePointsAroundSphere(
+      const vec3f& circleCenter,
+      float radius,
+      int numPoints,
+      int maxTries,
+      int islandIndex,
+      const Cr::Containers::Optional<uint32_t>& seed,
+      int numThreads);
+
   vec3f getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
                                             float radius,
                                             int maxTries,
@@ -486,27 +1097,84 @@ struct PathFinder::Impl {
   bool findPath(ShortestPath& path);
   bool findPath(MultiGoalShortestPath& path);
 
+  int findPaths(Cr::Containers::ArrayView<ShortestPath> paths, int numThreads);
+  std::vector<float> getGeodesicDistances(const std::vector<vec3f>& starts,
+                                          const std::vector<vec3f>& ends,
+                                          int numThreads);
+
+  bool buildDistanceOracle(std::size_t maxMemoryBytes, int numThreads);
+  bool hasDistanceOracle() const { return distanceOracle_ != nullptr; }
+  float getOracleDistance(const vec3f& a, const vec3f& b);
+  std::pair<float, float> getOracleDistanceBounds(const vec3f& a,
+                                                  const vec3f& b) const;
+  bool saveDistanceOracle(const std::string& path) const;
+  bool loadDistanceOracle(const std::string& path);
+
+  bool buildGoalDistanceField(MultiGoalShortestPath& path);
+  float getGoalDistance(const MultiGoalShortestPath& path,
+                        const vec3f& pt) const;
+
   template <typename T>
   T tryStep(const T& start, const T& end, bool allowSliding);
 
+  void trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                Cr::Containers::ArrayView<const vec3f> ends,
+                Cr::Containers::ArrayView<vec3f> stepped,
+                Cr::Containers::ArrayView<uint64_t> polyRefs,
+                bool allowSliding,
+                int numThreads);
+
   template <typename T>
   T snapPoint(const T& pt, int islandIndex = ID_UNDEFINED);
 
   template <typename T>
   int getIsland(const T& pt) const;
 
+  void snapPoints(Cr::Containers::ArrayView<const vec3f> points,
+                  Cr::Containers::ArrayView<vec3f> snapped,
+                  int islandIndex,
+                  int numThreads);
+
+  void getIslands(Cr::Containers::ArrayView<const vec3f> points,
+                  Cr::Containers::ArrayView<int> islands,
+                  int numThreads);
+
+  void areNavigable(Cr::Containers::ArrayView<const vec3f> points,
+                    Cr::Containers::ArrayView<bool> navigable,
+                    float maxYDelta,
+                    int numThreads);
+
   bool loadNavMesh(const std::string& path);
 
+  bool loadNavMeshMapped(const std::string& path);
+
   bool saveNavMesh(const std::string& path);
 
   bool isLoaded() const { return navMesh_ != nullptr; };
 
+  std::size_t getNavMeshByteSize() const {
+    if (!navMesh_) {
+      return 0;
+    }
+    const dtNavMesh* navMesh = navMesh_.get();
+    std::size_t size = 0;
+    for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+      const dtMeshTile* tile = navMesh->getTile(i);
+      if (tile->header) {
+        size += tile->dataSize;
+      }
+    }
+    return size;
+  }
+
   float getNavigableArea(int islandIndex /*= ID_UNDEFINED*/) const {
     return islandSystem_->getNavigableArea(islandIndex);
   };
 
   int numIslands();
 
+  std::vector<IslandStatistics> islandStatistics() const;
+
   void seed(uint32_t newSeed);
 
   float islandRadius(const vec3f& pt) const;
@@ -522,14 +1190,26 @@ struct PathFinder::Impl {
 
   std::pair<vec3f, vec3f> bounds() const { return bounds_; };
 
-  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownView(float metersPerPixel, float height, float eps) const;
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
+      float metersPerPixel,
+      float height,
+      float eps,
+      bool rasterize,
+      int numThreads);
 
-  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownIslandView(float metersPerPixel, float height, float eps) const;
+  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> getTopDownIslandView(
+      float metersPerPixel,
+      float height,
+      float eps,
+      bool rasterize,
+      int numThreads);
 
   assets::MeshData::ptr getNavMeshData(int islandIndex /*= ID_UNDEFINED*/);
 
+  std::vector<uint64_t> getNavMeshTileRevisions() const;
+
+  assets::MeshData::ptr getNavMeshTileData(int tileIndex) const;
+
   Cr::Containers::Optional<NavMeshSettings> getNavMeshSettings() const {
     return navMeshSettings_;
   }
@@ -542,10 +1222,45 @@ struct PathFinder::Impl {
     void operator()(dtNavMeshQuery* query) { dtFreeNavMeshQuery(query); }
   };
 
+  //! File mapping referenced in place by the tiles of navMesh_ when loaded
+  //! by loadNavMeshMapped(). Declared first so it outlives navMesh_.
+  Cr::Containers::Array<char> mappedNavMesh_;
   std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh_ = nullptr;
   std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> navQuery_ = nullptr;
+  //! Additional queries for worker threads of batched methods; worker 0 uses
+  //! navQuery_. Allocated on demand. Reset with navQuery_.
+  std::vector<std::unique_ptr<dtNavMeshQuery, NavQueryDeleter>> workerQueries_;
+  //! Queries for the threads calling the thread safe query methods, see
+  //! threadQuery(). Allocated on demand. Reset with navQuery_.
+  mutable std::unordered_map<std::thread::id,
+                             std::unique_ptr<dtNavMeshQuery, NavQueryDeleter>>
+      threadQueries_;
+  mutable std::mutex threadQueriesMutex_;
+  //! Unique across all instances, changed whenever navQuery_ is reset so
+  //! that per-thread caches of threadQueries_ entries and data derived from
+  //! the NavMesh outside of this class (e.g. goal distance fields) get
+  //! invalidated.
+  uint64_t navQueryToken_ = 0;
+  //! Guards the lazy construction of polyGraph_.
+  std::mutex polyGraphMutex_;
   std::unique_ptr<dtQueryFilter> filter_ = nullptr;
   std::unique_ptr<impl::IslandSystem> islandSystem_ = nullptr;
+  //! Generated when queried. Reset with navQuery_.
+  std::unique_ptr<impl::PolyGraph> polyGraph_ = nullptr;
+  //! Built on request. Reset with navQuery_.
+  std::unique_ptr<impl::DistanceOracle> distanceOracle_ = nullptr;
+  //! Rebuilt with navQuery_ if obstacleFieldCellSize_ is positive.
+  std::unique_ptr<impl::ObstacleDistanceField> obstacleField_ = nullptr;
+  float obstacleFieldCellSize_ = 0.0f;
+  float obstacleFieldMaxRadius_ = 2.0f;
+  int obstacleFieldNumThreads_ = 0;
+  //! Per island area samplers for batched random points, ID_UNDEFINED for
+  //! the whole NavMesh. Generated when queried. Reset with navQuery_.
+  std::unordered_map<int, std::unique_ptr<impl::AreaSampler>> areaSamplers_;
+  //! Revision of the tile in each tile slot, 0 for empty slots. Drawn from a
+  //! process-wide counter, so equal revisions mean the same tile data even
+  //! across PathFinder instances.
+  std::vector<uint64_t> tileRevisions_;
 
   //! Holds triangulated geom/topo. Generated when queried. Reset with
   //! navQuery_.
@@ -554,19 +1269,128 @@ struct PathFinder::Impl {
 
   std::pair<vec3f, vec3f> bounds_;
 
-  bool initNavQuery();
+  //! Reset the query and all data derived from the NavMesh. Islands are
+  //! recomputed unless islandSystem restored from a file is passed.
+  //! changedTiles lists the tile slots replaced since the last call, nullptr
+  //! if the whole NavMesh is new
+  bool initNavQuery(std::unique_ptr<impl::IslandSystem> islandSystem = nullptr,
+                    const std::vector<int>* changedTiles = nullptr);
+
+  bool buildObstacleDistanceField();
+
+  //! Tile edge length in cells for build(), <= 0 for a single tile
+  int buildTileSize_ = 0;
+  int buildNumThreads_ = 0;
+
+  //! Build the tiles of a multi-tile NavMesh in parallel.
+  bool buildTiled(const NavMeshSettings& bs,
+                  const rcConfig& baseCfg,
+                  const float* verts,
+                  int nverts,
+                  const int* tris,
+                  int ntris,
+                  dtNavMesh& navMesh,
+                  int& numVerts,
+                  int& numPolys);
+
+  const impl::PolyGraph& polyGraph();
+
+  //! Make sure a query exists for each of numWorkers workers. Not thread safe.
+  bool initWorkerQueries(int numWorkers);
+
+  //! Exclude (or stop excluding) the polys not on islandIndex from queries
+  //! using filter_. No-op for ID_UNDEFINED.
+  void excludeOffIslandPolys(int islandIndex, bool exclude);
+
+  bool isNavigableWithQuery(const vec3f& pt,
+                            float maxYDelta,
+                            const dtNavMeshQuery* query) const;
+
+  //! Sample coordinates of the cells of a top-down map
+  struct TopDownGrid {
+    std::vector<float> xs;
+    std::vector<float> zs;
+  };
+
+  TopDownGrid topDownGrid(float metersPerPixel) const;
+
+  //! Call func(row, col, point, query) for every cell of a top-down map,
+  //! rows in parallel
+  template <typename F>
+  void sampleTopDown(const TopDownGrid& grid,
+                     float height,
+                     int numThreads,
+                     F&& func);
+
+  //! Nearest walkable poly (0 if none) and its vertical distance for every
+  //! cell of a top-down map, found by rasterizing the poly detail meshes
+  void rasterizeTopDown(const TopDownGrid& grid,
+                        float height,
+                        int numThreads,
+                        std::vector<dtPolyRef>& cellPolys,
+                        std::vector<float>& cellDeltas) const;
+
+  //! The query of the calling thread, allocated on first use. Lets the read
+  //! only query methods run concurrently from several threads.
+  dtNavMeshQuery* threadQuery() const;
+
+  //! Nearest poly on an island to pt, using the same metric as
+  //! dtNavMeshQuery::findNearestPoly(). Doesn't touch the poly flags, unlike
+  //! excludeOffIslandPolys().
+  template <typename T>
+  std::tuple<dtStatus, dtPolyRef, vec3f> projectToIsland(
+      const T& pt,
+      int islandIndex,
+      const dtNavMeshQuery* query) const;
+
+  //! Whether polyRef is a usable start poly for a point known to be on the
+  //! NavMesh, e.g. the result of a previous step. Gives the point on the poly.
+  bool startOnPoly(const vec3f& start,
+                   dtPolyRef polyRef,
+                   const dtNavMeshQuery* query,
+                   vec3f& pathStart) const;
+
+  //! Implementation of tryStep(). polyRef is the poly of start if known (0
+  //! otherwise) and is set to the poly of the returned point, 0 if none.
+  vec3f tryStepWithQuery(const vec3f& start,
+                         const vec3f& end,
+                         bool allowSliding,
+                         const dtNavMeshQuery* query,
+                         dtPolyRef& polyRef) const;
+
+  //! The query to be used by a given worker of a batched method.
+  dtNavMeshQuery* workerQuery(int workerIndex) {
+    return workerIndex == 0 ? navQuery_.get()
+                            : workerQueries_[workerIndex - 1].get();
+  }
+
+  //! Single goal path search using the specified query. Does not modify any
+  //! shared state, so it is safe to call concurrently with distinct queries.
+  bool findPathWithQuery(ShortestPath& path, dtNavMeshQuery* query) const;
+
+  //! Same as @ref findPathWithQuery but only computes the distance, from a
+  //! straight path kept on the stack instead of a point list. Inf if there's
+  //! no path.
+  float findDistanceWithQuery(const vec3f& start,
+                              const vec3f& end,
+                              dtNavMeshQuery* query) const;
 
   Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-  findPathInternal(const vec3f& start,
+  findPathInternal(dtNavMeshQuery* query,
+                   const vec3f& start,
                    dtPolyRef startRef,
                    const vec3f& pathStart,
                    const vec3f& end,
                    dtPolyRef endRef,
-                   const vec3f& pathEnd);
+                   const vec3f& pathEnd) const;
 
   bool findPathSetup(MultiGoalShortestPath& path,
                      dtPolyRef& startRef,
                      vec3f& pathStart);
+
+  bool findPathMultiTarget(MultiGoalShortestPath& path,
+                           dtPolyRef startRef,
+                           const vec3f& pathStart);
 };
 
 namespace {
@@ -606,21 +1430,24 @@ PathFinder::Impl::Impl() {
   filter_->setExcludeFlags(0);
 }
 
-bool PathFinder::Impl::build(const NavMeshSettings& bs,
-                             const float* verts,
-                             const int nverts,
-                             const int* tris,
-                             const int ntris,
-                             const float* bmin,
-                             const float* bmax) {
-  Workspace ws;
-  rcContext ctx;
+namespace {
+//! Detour data for one NavMesh tile. data is nullptr for empty tiles.
+struct NavMeshTileData {
+  unsigned char* data = nullptr;
+  int dataSize = 0;
+  int numVerts = 0;
+  int numPolys = 0;
+};
 
-  //
-  // Step 1. Initialize build config.
-  //
+//! The indices of a MeshData as the signed ones Recast takes, without copying
+//! them. Both have the same layout for meshes with less than 2^31 vertices.
+const int* recastIndices(const esp::assets::MeshData& mesh) {
+  return reinterpret_cast<const int*>(mesh.ibo.data());
+}
 
-  // Init build configuration from GUI
+//! Recast build configuration derived from the NavMesh settings. Bounds,
+//! grid size and tiling are set by the caller.
+rcConfig makeBuildConfig(const NavMeshSettings& bs) {
   rcConfig cfg{};
   memset(&cfg, 0, sizeof(cfg));
   cfg.cs = bs.cellSize;
@@ -639,15 +1466,29 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   cfg.detailSampleDist =
       bs.detailSampleDist < 0.9f ? 0 : bs.cellSize * bs.detailSampleDist;
   cfg.detailSampleMaxError = bs.cellHeight * bs.detailSampleMaxError;
+  return cfg;
+}
 
-  // Set the area where the navigation will be build.
-  // Here the bounds of the input mesh are used, but the
-  // area could be specified by an user defined box, etc.
-  rcVcopy(cfg.bmin, bmin);
-  rcVcopy(cfg.bmax, bmax);
-  rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-  ESP_DEBUG() << "Building navmesh with" << cfg.width << "x" << cfg.height
-              << "cells";
+/**
+ * @brief Run the Recast pipeline on a triangle soup and create Detour data for
+ * a single tile.
+ *
+ * Uses its own rcContext and workspace, so several tiles can be built
+ * concurrently. Empty tiles succeed with out.data == nullptr unless
+ * allowEmpty is false.
+ */
+bool buildTileNavMeshData(const NavMeshSettings& bs,
+                          const rcConfig& cfg,
+                          const float* verts,
+                          const int nverts,
+                          const int* tris,
+                          const int ntris,
+                          const int tileX,
+                          const int tileY,
+                          const bool allowEmpty,
+                          NavMeshTileData& out) {
+  Workspace ws;
+  rcContext ctx;
 
   //
   // Step 2. Rasterize input polygon soup.
@@ -771,7 +1612,7 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
   // Partition the walkable surface into simple regions without holes.
-  if (!rcBuildRegions(&ctx, *ws.chf, 0, cfg.minRegionArea,
+  if (!rcBuildRegions(&ctx, *ws.chf, cfg.borderSize, cfg.minRegionArea,
                       cfg.mergeRegionArea)) {
     ESP_ERROR() << "Could not build watershed regions";
     return false;
@@ -835,82 +1676,85 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   // ws.pmesh. See duDebugDrawPolyMesh or dtCreateNavMeshData as examples how to
   // access the data.
 
+  if (ws.pmesh->npolys == 0 && allowEmpty) {
+    return true;
+  }
+
   //
-  // (Optional) Step 8. Create Detour data from Recast poly mesh.
+  // Step 8. Create Detour data from Recast poly mesh.
   //
 
-  // The GUI may allow more max points per polygon than Detour can handle.
-  // Only build the detour navmesh if we do not exceed the limit.
-  if (cfg.maxVertsPerPoly <= DT_VERTS_PER_POLYGON) {
-    unsigned char* navData = nullptr;
-    int navDataSize = 0;
-
-    // Update poly flags from areas.
-    for (int i = 0; i < ws.pmesh->npolys; ++i) {
-      if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
-        ws.pmesh->areas[i] = POLYAREA_GROUND;
-      }
-      if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK;
-      } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
-      }
+  // Update poly flags from areas.
+  for (int i = 0; i < ws.pmesh->npolys; ++i) {
+    if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
+      ws.pmesh->areas[i] = POLYAREA_GROUND;
     }
-
-    dtNavMeshCreateParams params{};
-    memset(&params, 0, sizeof(params));
-    params.verts = ws.pmesh->verts;
-    params.vertCount = ws.pmesh->nverts;
-    params.polys = ws.pmesh->polys;
-    params.polyAreas = ws.pmesh->areas;
-    params.polyFlags = ws.pmesh->flags;
-    params.polyCount = ws.pmesh->npolys;
-    params.nvp = ws.pmesh->nvp;
-    params.detailMeshes = ws.dmesh->meshes;
-    params.detailVerts = ws.dmesh->verts;
-    params.detailVertsCount = ws.dmesh->nverts;
-    params.detailTris = ws.dmesh->tris;
-    params.detailTriCount = ws.dmesh->ntris;
-    // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
-    // params.offMeshConRad = geom->getOffMeshConnectionRads();
-    // params.offMeshConDir = geom->getOffMeshConnectionDirs();
-    // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
-    // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
-    // params.offMeshConUserID = geom->getOffMeshConnectionId();
-    // params.offMeshConCount = geom->getOffMeshConnectionCount();
-    params.walkableHeight = bs.agentHeight;
-    params.walkableRadius = bs.agentRadius;
-    params.walkableClimb = bs.agentMaxClimb;
-    rcVcopy(params.bmin, ws.pmesh->bmin);
-    rcVcopy(params.bmax, ws.pmesh->bmax);
-    params.cs = cfg.cs;
-    params.ch = cfg.ch;
-    params.buildBvTree = true;
-
-    if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
-      ESP_ERROR() << "Could not build Detour navmesh";
-      return false;
+    if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK;
+    } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
     }
+  }
 
-    navMesh_.reset(dtAllocNavMesh());
-    if (!navMesh_) {
-      dtFree(navData);
-      ESP_ERROR() << "Could not allocate Detour navmesh";
-      return false;
-    }
+  dtNavMeshCreateParams params{};
+  memset(&params, 0, sizeof(params));
+  params.verts = ws.pmesh->verts;
+  params.vertCount = ws.pmesh->nverts;
+  params.polys = ws.pmesh->polys;
+  params.polyAreas = ws.pmesh->areas;
+  params.polyFlags = ws.pmesh->flags;
+  params.polyCount = ws.pmesh->npolys;
+  params.nvp = ws.pmesh->nvp;
+  params.detailMeshes = ws.dmesh->meshes;
+  params.detailVerts = ws.dmesh->verts;
+  params.detailVertsCount = ws.dmesh->nverts;
+  params.detailTris = ws.dmesh->tris;
+  params.detailTriCount = ws.dmesh->ntris;
+  // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
+  // params.offMeshConRad = geom->getOffMeshConnectionRads();
+  // params.offMeshConDir = geom->getOffMeshConnectionDirs();
+  // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
+  // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
+  // params.offMeshConUserID = geom->getOffMeshConnectionId();
+  // params.offMeshConCount = geom->getOffMeshConnectionCount();
+  params.walkableHeight = bs.agentHeight;
+  params.walkableRadius = bs.agentRadius;
+  params.walkableClimb = bs.agentMaxClimb;
+  params.tileX = tileX;
+  params.tileY = tileY;
+  params.tileLayer = 0;
+  rcVcopy(params.bmin, ws.pmesh->bmin);
+  rcVcopy(params.bmax, ws.pmesh->bmax);
+  params.cs = cfg.cs;
+  params.ch = cfg.ch;
+  params.buildBvTree = true;
+
+  if (!dtCreateNavMeshData(&params, &out.data, &out.dataSize)) {
+    ESP_ERROR() << "Could not build Detour navmesh";
+    return false;
+  }
+  out.numVerts = ws.pmesh->nverts;
+  out.numPolys = ws.pmesh->npolys;
+  return true;
+}
+}  // namespace
 
-    dtStatus status = 0;
-    status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
-    if (dtStatusFailed(status)) {
-      dtFree(navData);
-      ESP_ERROR() << "Could not init Detour navmesh";
-      return false;
-    }
-    if (!initNavQuery()) {
-      return false;
-    }
-    navMeshSettings_ = {bs};
-  } else {
+bool PathFinder::Impl::build(const NavMeshSettings& bs,
+                             const float* verts,
+                             const int nverts,
+                             const int* tris,
+                             const int ntris,
+                             const float* bmin,
+                             const float* bmax) {
+  //
+  // Step 1. Initialize build config.
+  //
+
+  rcConfig cfg = makeBuildConfig(bs);
+
+  // The GUI may allow more max points per polygon than Detour can handle.
+  // Only build the detour navmesh if we do not exceed the limit.
+  if (cfg.maxVertsPerPoly > DT_VERTS_PER_POLYGON) {
     ESP_ERROR() << "cfg.maxVertsPerPoly(" << cfg.maxVertsPerPoly
                 << ") > DT_VERTS_PER_POLYGON(" << DT_VERTS_PER_POLYGON
                 << "), so cannot build the Detour NavMesh. Aborting NavMesh "
@@ -918,17 +1762,436 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
 
-  bounds_ = std::make_pair(vec3f(bmin), vec3f(bmax));
-
-  ESP_DEBUG() << "Created navmesh with" << ws.pmesh->nverts << "vertices"
-              << ws.pmesh->npolys << "polygons";
+  // Set the area where the navigation will be build.
+  // Here the bounds of the input mesh are used, but the
+  // area could be specified by an user defined box, etc.
+  rcVcopy(cfg.bmin, bmin);
+  rcVcopy(cfg.bmax, bmax);
+  rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
-  return true;
-}
+  std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh{dtAllocNavMesh()};
+  if (!navMesh) {
+    ESP_ERROR() << "Could not allocate Detour navmesh";
+    return false;
+  }
 
-bool PathFinder::Impl::initNavQuery() {
-  // if we are reinitializing the NavQuery, then also reset the MeshData
+  int numVerts = 0;
+  int numPolys = 0;
+  if (buildTileSize_ <= 0) {
+    ESP_DEBUG() << "Building navmesh with" << cfg.width << "x" << cfg.height
+                << "cells";
+    NavMeshTileData tile;
+    if (!buildTileNavMeshData(bs, cfg, verts, nverts, tris, ntris, 0, 0,
+                              /*allowEmpty=*/false, tile)) {
+      return false;
+    }
+
+    dtStatus status =
+        navMesh->init(tile.data, tile.dataSize, DT_TILE_FREE_DATA);
+    if (dtStatusFailed(status)) {
+      dtFree(tile.data);
+      ESP_ERROR() << "Could not init Detour navmesh";
+      return false;
+    }
+    numVerts = tile.numVerts;
+    numPolys = tile.numPolys;
+  } else if (!buildTiled(bs, cfg, verts, nverts, tris, ntris, *navMesh,
+                         numVerts, numPolys)) {
+    return false;
+  }
+
+  navMesh_ = std::move(navMesh);
+  mappedNavMesh_ = nullptr;
+  if (!initNavQuery()) {
+    return false;
+  }
+  navMeshSettings_ = {bs};
+
+  bounds_ = std::make_pair(vec3f(bmin), vec3f(bmax));
+
+  ESP_DEBUG() << "Created navmesh with" << numVerts << "vertices" << numPolys
+              << "polygons";
+
+  return true;
+}
+
+namespace {
+//! Layout of the tiles of a multi-tile NavMesh on the XZ plane.
+struct TileGrid {
+  //! Recast config for each tile, including the border
+  rcConfig cfg;
+  float orig[3];
+  float tileWorldSize;
+  int tilesX;
+  int tilesZ;
+
+  float borderWorldSize() const { return cfg.borderSize * cfg.cs; }
+
+  int tileCoord(float v, int axis) const {
+    const int numTiles = axis == 0 ? tilesX : tilesZ;
+    const int t =
+        static_cast<int>(std::floor((v - orig[axis]) / tileWorldSize));
+    return std::max(0, std::min(t, numTiles - 1));
+  }
+};
+
+//! Tiled rcConfig for the given base config and tile size.
+rcConfig makeTileConfig(const rcConfig& baseCfg, const int tileSize) {
+  // Tiles overlap their neighbours by a border so that erosion and region
+  // partitioning produce matching edges on both sides.
+  rcConfig cfg = baseCfg;
+  cfg.tileSize = tileSize;
+  cfg.borderSize = cfg.walkableRadius + 3;
+  cfg.width = cfg.tileSize + cfg.borderSize * 2;
+  cfg.height = cfg.tileSize + cfg.borderSize * 2;
+  return cfg;
+}
+
+/**
+ * @brief Rasterize and build a set of tiles of a grid in parallel.
+ *
+ * Each worker has its own Recast context and workspace. Tiles without any
+ * overlapping triangles or walkable area are left empty.
+ */
+bool buildNavMeshTiles(const NavMeshSettings& bs,
+                       const TileGrid& grid,
+                       const float* verts,
+                       const int nverts,
+                       const int* tris,
+                       const int ntris,
+                       const std::vector<std::pair<int, int>>& tileCoords,
+                       const int numThreads,
+                       std::vector<NavMeshTileData>& tiles) {
+  std::vector<int> slotOfTile(grid.tilesX * grid.tilesZ, ID_UNDEFINED);
+  for (std::size_t i = 0; i < tileCoords.size(); ++i) {
+    slotOfTile[tileCoords[i].second * grid.tilesX + tileCoords[i].first] = i;
+  }
+
+  // Bin triangles into all requested tiles their XZ bounds (plus border)
+  // overlap.
+  const float border = grid.borderWorldSize();
+  std::vector<std::vector<int>> tileTris(tileCoords.size());
+  for (int t = 0; t < ntris; ++t) {
+    float triMin[3], triMax[3];
+    rcVcopy(triMin, &verts[tris[t * 3] * 3]);
+    rcVcopy(triMax, triMin);
+    for (int k = 1; k < 3; ++k) {
+      rcVmin(triMin, &verts[tris[t * 3 + k] * 3]);
+      rcVmax(triMax, &verts[tris[t * 3 + k] * 3]);
+    }
+    const int x0 = grid.tileCoord(triMin[0] - border, 0);
+    const int x1 = grid.tileCoord(triMax[0] + border, 0);
+    const int z0 = grid.tileCoord(triMin[2] - border, 2);
+    const int z1 = grid.tileCoord(triMax[2] + border, 2);
+    for (int z = z0; z <= z1; ++z) {
+      for (int x = x0; x <= x1; ++x) {
+        const int slot = slotOfTile[z * grid.tilesX + x];
+        if (slot != ID_UNDEFINED) {
+          tileTris[slot].push_back(t);
+        }
+      }
+    }
+  }
+
+  tiles.assign(tileCoords.size(), {});
+  std::atomic<bool> failed{false};
+  core::parallelFor(tiles.size(), numThreads, [&](std::size_t i, int) {
+    if (tileTris[i].empty() || failed)
+      return;
+    const int x = tileCoords[i].first;
+    const int z = tileCoords[i].second;
+
+    rcConfig tileCfg = grid.cfg;
+    tileCfg.bmin[0] = grid.orig[0] + x * grid.tileWorldSize - border;
+    tileCfg.bmin[2] = grid.orig[2] + z * grid.tileWorldSize - border;
+    tileCfg.bmax[0] = grid.orig[0] + (x + 1) * grid.tileWorldSize + border;
+    tileCfg.bmax[2] = grid.orig[2] + (z + 1) * grid.tileWorldSize + border;
+
+    std::vector<int> tileIndices;
+    tileIndices.reserve(tileTris[i].size() * 3);
+    for (int t : tileTris[i]) {
+      tileIndices.insert(tileIndices.end(), &tris[t * 3], &tris[t * 3 + 3]);
+    }
+    if (!buildTileNavMeshData(bs, tileCfg, verts, nverts, tileIndices.data(),
+                              tileTris[i].size(), x, z,
+                              /*allowEmpty=*/true, tiles[i])) {
+      failed = true;
+    }
+  });
+
+  if (failed) {
+    for (NavMeshTileData& tile : tiles) {
+      dtFree(tile.data);
+      tile = {};
+    }
+    return false;
+  }
+  return true;
+}
+
+//! Add built tiles to a NavMesh, freeing the data of tiles that fail.
+//! dtNavMesh::addTile isn't thread safe, so this is done serially.
+bool addNavMeshTiles(dtNavMesh& navMesh,
+                     std::vector<NavMeshTileData>& tiles,
+                     int& numVerts,
+                     int& numPolys) {
+  bool success = true;
+  for (NavMeshTileData& tile : tiles) {
+    if (!tile.data)
+      continue;
+    if (success &&
+        dtStatusSucceed(navMesh.addTile(tile.data, tile.dataSize,
+                                        DT_TILE_FREE_DATA, 0, nullptr))) {
+      numVerts += tile.numVerts;
+      numPolys += tile.numPolys;
+      continue;
+    }
+    dtFree(tile.data);
+    if (success) {
+      ESP_ERROR() << "Could not add tile to Detour navmesh";
+      success = false;
+    }
+  }
+  return success;
+}
+
+//! Frees all tiles and fails if one has more polys than the NavMesh can
+//! address, those would get refs aliasing the polys of other tiles.
+bool checkTilePolyBudget(std::vector<NavMeshTileData>& tiles, int maxPolys) {
+  for (const NavMeshTileData& tile : tiles) {
+    if (tile.numPolys > maxPolys) {
+      ESP_ERROR() << "A tile has" << tile.numPolys
+                  << "polygons, but the tile layout leaves room for at most"
+                  << maxPolys
+                  << "per tile. Use a larger tile size with setBuildTiling().";
+      for (NavMeshTileData& freed : tiles) {
+        dtFree(freed.data);
+        freed.data = nullptr;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool PathFinder::Impl::buildTiled(const NavMeshSettings& bs,
+                                  const rcConfig& baseCfg,
+                                  const float* verts,
+                                  const int nverts,
+                                  const int* tris,
+                                  const int ntris,
+                                  dtNavMesh& navMesh,
+                                  int& numVerts,
+                                  int& numPolys) {
+  TileGrid grid{};
+  grid.cfg = makeTileConfig(baseCfg, buildTileSize_);
+  rcVcopy(grid.orig, baseCfg.bmin);
+  grid.tileWorldSize = buildTileSize_ * baseCfg.cs;
+  grid.tilesX = (baseCfg.width + buildTileSize_ - 1) / buildTileSize_;
+  grid.tilesZ = (baseCfg.height + buildTileSize_ - 1) / buildTileSize_;
+  ESP_DEBUG() << "Building tiled navmesh with" << baseCfg.width << "x"
+              << baseCfg.height << "cells in" << grid.tilesX << "x"
+              << grid.tilesZ << "tiles";
+
+  // Detour encodes tile and poly ids in 22 bits of the 32 bit poly ref, the
+  // remaining bits are the salt. Leave at least 8 bits for the polys of each
+  // tile.
+  constexpr int MaxTileBits = 14;
+  if (grid.tilesX * grid.tilesZ > (1 << MaxTileBits)) {
+    int minTileSize = buildTileSize_;
+    while (((baseCfg.width + minTileSize - 1) / minTileSize) *
+               ((baseCfg.height + minTileSize - 1) / minTileSize) >
+           (1 << MaxTileBits)) {
+      ++minTileSize;
+    }
+    ESP_ERROR() << "A tile size of" << buildTileSize_ << "needs"
+                << grid.tilesX << "x" << grid.tilesZ
+                << "tiles, but Detour supports at most" << (1 << MaxTileBits)
+                << "tiles in a NavMesh. Use a tile size of at least"
+                << minTileSize << "with setBuildTiling().";
+    return false;
+  }
+  const int tileBits =
+      static_cast<int>(dtIlog2(dtNextPow2(grid.tilesX * grid.tilesZ)));
+  const int polyBits = 22 - tileBits;
+
+  dtNavMeshParams navParams{};
+  rcVcopy(navParams.orig, baseCfg.bmin);
+  navParams.tileWidth = grid.tileWorldSize;
+  navParams.tileHeight = grid.tileWorldSize;
+  navParams.maxTiles = 1 << tileBits;
+  navParams.maxPolys = 1 << polyBits;
+  if (dtStatusFailed(navMesh.init(&navParams))) {
+    ESP_ERROR() << "Could not init tiled Detour navmesh";
+    return false;
+  }
+
+  std::vector<std::pair<int, int>> tileCoords;
+  tileCoords.reserve(grid.tilesX * grid.tilesZ);
+  for (int z = 0; z < grid.tilesZ; ++z) {
+    for (int x = 0; x < grid.tilesX; ++x) {
+      tileCoords.emplace_back(x, z);
+    }
+  }
+
+  std::vector<NavMeshTileData> tiles;
+  if (!buildNavMeshTiles(bs, grid, verts, nverts, tris, ntris, tileCoords,
+                         buildNumThreads_, tiles)) {
+    return false;
+  }
+  if (!checkTilePolyBudget(tiles, navParams.maxPolys)) {
+    return false;
+  }
+  numVerts = 0;
+  numPolys = 0;
+  return addNavMeshTiles(navMesh, tiles, numVerts, numPolys);
+}
+
+bool PathFinder::Impl::rebuildTiles(
+    const NavMeshSettings& bs,
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  if (!isLoaded() || !navMeshSettings_ || *navMeshSettings_ != bs) {
+    ESP_DEBUG() << "No NavMesh with matching settings, can't rebuild tiles.";
+    return false;
+  }
+  const dtNavMeshParams* navParams = navMesh_->getParams();
+  if (navMesh_->getMaxTiles() <= 1 || navParams->tileWidth <= 0) {
+    ESP_DEBUG() << "NavMesh isn't tiled, can't rebuild tiles.";
+    return false;
+  }
+
+  // Reconstruct the tile grid of the existing NavMesh
+  rcConfig baseCfg = makeBuildConfig(bs);
+  const int tileSize =
+      static_cast<int>(std::round(navParams->tileWidth / baseCfg.cs));
+  TileGrid grid{};
+  grid.cfg = makeTileConfig(baseCfg, tileSize);
+  rcVcopy(grid.orig, navParams->orig);
+  grid.tileWorldSize = navParams->tileWidth;
+  // same rounding as rcCalcGridSize in the original build
+  const int width = static_cast<int>(
+      (bounds_.second[0] - grid.orig[0]) / baseCfg.cs + 0.5f);
+  const int height = static_cast<int>(
+      (bounds_.second[2] - grid.orig[2]) / baseCfg.cs + 0.5f);
+  grid.tilesX = (width + tileSize - 1) / tileSize;
+  grid.tilesZ = (height + tileSize - 1) / tileSize;
+
+  if (mesh.vbo.empty() || mesh.ibo.empty()) {
+    ESP_ERROR() << "Can't rebuild tiles from an empty mesh.";
+    return false;
+  }
+  const int numVerts = mesh.vbo.size();
+  const int numIndices = mesh.ibo.size();
+  vec3f bmin = bounds_.first;
+  vec3f bmax = bounds_.second;
+  for (const vec3f& p : mesh.vbo) {
+    bmin = bmin.cwiseMin(p);
+    bmax = bmax.cwiseMax(p);
+  }
+  grid.cfg.bmin[1] = bmin[1];
+  grid.cfg.bmax[1] = bmax[1];
+
+  // A change also affects the neighbouring tiles whose border overlaps it
+  const float border = grid.borderWorldSize();
+  std::vector<bool> dirty(grid.tilesX * grid.tilesZ, false);
+  std::vector<std::pair<int, int>> tileCoords;
+  for (const auto& region : regions) {
+    const int x0 = grid.tileCoord(region.first[0] - border, 0);
+    const int x1 = grid.tileCoord(region.second[0] + border, 0);
+    const int z0 = grid.tileCoord(region.first[2] - border, 2);
+    const int z1 = grid.tileCoord(region.second[2] + border, 2);
+    for (int z = z0; z <= z1; ++z) {
+      for (int x = x0; x <= x1; ++x) {
+        if (!dirty[z * grid.tilesX + x]) {
+          dirty[z * grid.tilesX + x] = true;
+          tileCoords.emplace_back(x, z);
+        }
+      }
+    }
+  }
+  if (tileCoords.empty()) {
+    return true;
+  }
+  ESP_DEBUG() << "Rebuilding" << tileCoords.size() << "of"
+              << grid.tilesX * grid.tilesZ << "navmesh tiles";
+
+  std::vector<NavMeshTileData> tiles;
+  if (!buildNavMeshTiles(bs, grid, mesh.vbo[0].data(), numVerts,
+                         recastIndices(mesh), numIndices / 3, tileCoords,
+                         buildNumThreads_, tiles)) {
+    return false;
+  }
+  if (!checkTilePolyBudget(tiles, navParams->maxPolys)) {
+    return false;
+  }
+
+  // swap the new tiles into the live NavMesh
+  std::vector<int> changedTiles;
+  for (const auto& coord : tileCoords) {
+    const dtMeshTile* tile =
+        navMesh_->getTileAt(coord.first, coord.second, /*layer=*/0);
+    if (tile) {
+      const dtTileRef ref = navMesh_->getTileRef(tile);
+      changedTiles.push_back(navMesh_->decodePolyIdTile(ref));
+      navMesh_->removeTile(ref, nullptr, nullptr);
+    }
+  }
+  int numNewVerts = 0;
+  int numNewPolys = 0;
+  if (!addNavMeshTiles(*navMesh_, tiles, numNewVerts, numNewPolys)) {
+    return false;
+  }
+  for (const auto& coord : tileCoords) {
+    const dtMeshTile* tile =
+        navMesh_->getTileAt(coord.first, coord.second, /*layer=*/0);
+    if (tile) {
+      changedTiles.push_back(
+          navMesh_->decodePolyIdTile(navMesh_->getTileRef(tile)));
+    }
+  }
+
+  bounds_ = std::make_pair(bmin.cwiseMin(bounds_.first),
+                           bmax.cwiseMax(bounds_.second));
+  // islands, areas and other derived data depend on all tiles
+  return initNavQuery(nullptr, &changedTiles);
+}
+
+bool PathFinder::Impl::initNavQuery(
+    std::unique_ptr<impl::IslandSystem> islandSystem,
+    const std::vector<int>* changedTiles) {
+  // if we are reinitializing the NavQuery, then also reset the MeshData
   islandMeshData_.clear();
+  workerQueries_.clear();
+  polyGraph_ = nullptr;
+  distanceOracle_ = nullptr;
+  obstacleField_ = nullptr;
+  areaSamplers_.clear();
+
+  static std::atomic<uint64_t> nextTileRevision{1};
+  const uint64_t revision = nextTileRevision++;
+  const int maxTiles = navMesh_->getMaxTiles();
+  if (!changedTiles || tileRevisions_.size() != std::size_t(maxTiles)) {
+    tileRevisions_.assign(maxTiles, 0);
+    for (int i = 0; i < maxTiles; ++i) {
+      if (const_cast<const dtNavMesh*>(navMesh_.get())->getTile(i)->header)
+        tileRevisions_[i] = revision;
+    }
+  } else {
+    for (const int i : *changedTiles) {
+      tileRevisions_[i] =
+          const_cast<const dtNavMesh*>(navMesh_.get())->getTile(i)->header
+              ? revision
+              : 0;
+    }
+  }
+  {
+    static std::atomic<uint64_t> nextNavQueryToken{1};
+    std::lock_guard<std::mutex> lock{threadQueriesMutex_};
+    threadQueries_.clear();
+    navQueryToken_ = nextNavQueryToken++;
+  }
 
   navQuery_.reset(dtAllocNavMeshQuery());
   dtStatus status = navQuery_->init(navMesh_.get(), 2048);
@@ -937,15 +2200,152 @@ bool PathFinder::Impl::initNavQuery() {
     return false;
   }
 
-  islandSystem_ =
-      std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  if (islandSystem) {
+    // persisted islands were saved after zero area polys were disabled in the
+    // tile data and already include the areas
+    islandSystem_ = std::move(islandSystem);
+  } else {
+    islandSystem_ =
+        std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
 
-  // Added as we also need to remove these on navmesh recomputation
-  islandSystem_->removeZeroAreaPolys(navMesh_.get());
+    // Added as we also need to remove these on navmesh recomputation
+    islandSystem_->removeZeroAreaPolys(navMesh_.get());
+  }
+
+  // a failure only leaves the queries without the field
+  if (obstacleFieldCellSize_ > 0.0f) {
+    buildObstacleDistanceField();
+  }
 
   return true;
 }
 
+bool PathFinder::Impl::buildObstacleDistanceField() {
+  obstacleField_ = nullptr;
+
+  // bounds_ isn't updated yet when called from initNavQuery()
+  vec3f bmin = vec3f::Constant(std::numeric_limits<float>::max());
+  vec3f bmax = vec3f::Constant(-std::numeric_limits<float>::max());
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+    const dtMeshTile* tile = navMesh->getTile(i);
+    if (!tile->header)
+      continue;
+    bmin = bmin.cwiseMin(Eigen::Map<const vec3f>{tile->header->bmin});
+    bmax = bmax.cwiseMax(Eigen::Map<const vec3f>{tile->header->bmax});
+  }
+  if (!(bmin[0] <= bmax[0])) {
+    ESP_ERROR() << "The NavMesh has no tiles, can't build an obstacle "
+                   "distance field.";
+    return false;
+  }
+
+  const float cellSize = obstacleFieldCellSize_;
+  const float maxRadius = obstacleFieldMaxRadius_;
+  const int sizeX =
+      std::max(2, int(std::ceil((bmax[0] - bmin[0]) / cellSize)) + 1);
+  const int sizeZ =
+      std::max(2, int(std::ceil((bmax[2] - bmin[2]) / cellSize)) + 1);
+  std::vector<std::vector<impl::ObstacleDistanceField::Sample>> pointSamples(
+      std::size_t(sizeX) * std::size_t(sizeZ));
+
+  const int numThreads =
+      core::resolveNumThreads(obstacleFieldNumThreads_, sizeZ);
+  if (!initWorkerQueries(numThreads)) {
+    return false;
+  }
+
+  // a vertical column through each grid point, spanning all layers
+  const vec3f halfExtents{0.01f * cellSize, 0.5f * (bmax[1] - bmin[1]) + 1.0f,
+                          0.01f * cellSize};
+  core::parallelFor(sizeZ, numThreads, [&](std::size_t z, int worker) {
+    dtNavMeshQuery* query = workerQuery(worker);
+    constexpr int MaxPolys = 64;
+    dtPolyRef polys[MaxPolys];
+    for (int x = 0; x != sizeX; ++x) {
+      const vec3f center{bmin[0] + x * cellSize, 0.5f * (bmin[1] + bmax[1]),
+                         bmin[2] + z * cellSize};
+      int numPolys = 0;
+      query->queryPolygons(center.data(), halfExtents.data(), filter_.get(),
+                           polys, &numPolys, MaxPolys);
+      std::vector<impl::ObstacleDistanceField::Sample>& samples =
+          pointSamples[z * sizeX + x];
+      for (int i = 0; i < numPolys; ++i) {
+        vec3f pos = center;
+        // fails if the grid point is outside of the polygon
+        if (dtStatusFailed(
+                query->getPolyHeight(polys[i], pos.data(), &pos[1])))
+          continue;
+        // a grid point on an edge is in both polygons sharing it
+        if (std::any_of(samples.begin(), samples.end(),
+                        [&](const impl::ObstacleDistanceField::Sample& s) {
+                          return std::abs(s.height - pos[1]) < 0.01f;
+                        }))
+          continue;
+        float distance = maxRadius;
+        vec3f hitPos, hitNormal;
+        query->findDistanceToWall(polys[i], pos.data(), maxRadius,
+                                  filter_.get(), &distance, hitPos.data(),
+                                  hitNormal.data());
+        samples.push_back({pos[1], distance});
+      }
+    }
+  });
+
+  obstacleField_ = std::make_unique<impl::ObstacleDistanceField>(
+      bmin, cellSize, sizeX, sizeZ, maxRadius, pointSamples);
+  ESP_DEBUG() << "Built obstacle distance field of" << sizeX << "x" << sizeZ
+              << "points using" << obstacleField_->memoryBytes() << "bytes";
+  return true;
+}
+
+const impl::PolyGraph& PathFinder::Impl::polyGraph() {
+  // built after removeZeroAreaPolys so disabled polys are excluded
+  std::lock_guard<std::mutex> lock{polyGraphMutex_};
+  if (!polyGraph_) {
+    polyGraph_ =
+        std::make_unique<impl::PolyGraph>(navMesh_.get(), filter_.get());
+  }
+  return *polyGraph_;
+}
+
+dtNavMeshQuery* PathFinder::Impl::threadQuery() const {
+  // remember the last query of this thread to skip the lock when the same
+  // PathFinder is queried repeatedly
+  thread_local uint64_t cachedToken = 0;
+  thread_local dtNavMeshQuery* cachedQuery = nullptr;
+  if (cachedToken == navQueryToken_)
+    return cachedQuery;
+
+  std::lock_guard<std::mutex> lock{threadQueriesMutex_};
+  auto& query = threadQueries_[std::this_thread::get_id()];
+  if (!query) {
+    std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> newQuery{
+        dtAllocNavMeshQuery()};
+    ESP_CHECK(newQuery &&
+                  !dtStatusFailed(newQuery->init(navMesh_.get(), 2048)),
+              "PathFinder: could not init Detour navmesh query for thread");
+    query = std::move(newQuery);
+  }
+  cachedToken = navQueryToken_;
+  cachedQuery = query.get();
+  return cachedQuery;
+}
+
+bool PathFinder::Impl::initWorkerQueries(const int numWorkers) {
+  while (static_cast<int>(workerQueries_.size()) + 1 < numWorkers) {
+    std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> query{
+        dtAllocNavMeshQuery()};
+    if (!query || dtStatusFailed(query->init(navMesh_.get(), 2048))) {
+      ESP_ERROR() << "Could not init Detour navmesh query for worker"
+                  << workerQueries_.size() + 1;
+      return false;
+    }
+    workerQueries_.emplace_back(std::move(query));
+  }
+  return true;
+}
+
 bool PathFinder::Impl::build(const NavMeshSettings& bs,
                              const esp::assets::MeshData& mesh) {
   const int numVerts = mesh.vbo.size();
@@ -960,15 +2360,8 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     bmax = bmax.cwiseMax(p);
   }
 
-  int* indices = new int[numIndices];
-  for (int i = 0; i < numIndices; ++i) {
-    indices[i] = static_cast<int>(mesh.ibo[i]);
-  }
-
-  const bool success = build(bs, mesh.vbo[0].data(), numVerts, indices,
-                             numIndices / 3, bmin.data(), bmax.data());
-  delete[] indices;
-  return success;
+  return build(bs, mesh.vbo[0].data(), numVerts, recastIndices(mesh),
+               numIndices / 3, bmin.data(), bmax.data());
 }
 
 namespace {
@@ -987,6 +2380,34 @@ struct NavMeshTileHeader {
   int dataSize;
 };
 
+// Optional section following the tiles, ignored by older loaders
+const int ISLANDSECTION_MAGIC = 'I' << 24 | 'S' << 16 | 'L' << 8 | 'D';
+// Version 1 lacks the centroids and bounds, they're recomputed on load
+const int ISLANDSECTION_VERSION = 2;
+
+struct IslandSectionHeader {
+  int magic;
+  int version;
+  int polyRefSize;
+  int numIslands;
+  float totalArea;
+};
+
+struct IslandRecordV1 {
+  float radius;
+  float area;
+  int numPolys;
+};
+
+struct IslandRecord {
+  float radius;
+  float area;
+  int numPolys;
+  float centroid[3];
+  float bmin[3];
+  float bmax[3];
+};
+
 struct Triangle {
   std::vector<vec3f> v;
   Triangle() { v.resize(3); }
@@ -1081,11 +2502,140 @@ void impl::IslandSystem::removeZeroAreaPolys(dtNavMesh* navMesh) {
   islandsToArea_[ID_UNDEFINED] = totalArea;
 }
 
+bool impl::IslandSystem::write(FILE* fp) const {
+  IslandSectionHeader header{};
+  header.magic = ISLANDSECTION_MAGIC;
+  header.version = ISLANDSECTION_VERSION;
+  header.polyRefSize = sizeof(dtPolyRef);
+  header.numIslands = islandRadius_.size();
+  const auto totalArea = islandsToArea_.find(ID_UNDEFINED);
+  header.totalArea =
+      totalArea != islandsToArea_.end() ? totalArea->second : 0.0f;
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+  for (uint32_t i = 0; ok && i < islandRadius_.size(); ++i) {
+    const auto polys = islandsToPolys_.find(i);
+    const auto area = islandsToArea_.find(i);
+    IslandRecord record{};
+    record.radius = islandRadius_[i];
+    record.area = area != islandsToArea_.end() ? area->second : 0.0f;
+    record.numPolys =
+        polys != islandsToPolys_.end() ? polys->second.size() : 0;
+    Eigen::Map<vec3f>{record.centroid} = islandCentroid_[i];
+    Eigen::Map<vec3f>{record.bmin} = islandBounds_[i].first;
+    Eigen::Map<vec3f>{record.bmax} = islandBounds_[i].second;
+    ok = fwrite(&record, sizeof(record), 1, fp) == 1;
+    if (ok && record.numPolys > 0) {
+      ok = fwrite(polys->second.data(), sizeof(dtPolyRef), record.numPolys,
+                  fp) == static_cast<std::size_t>(record.numPolys);
+    }
+  }
+  return ok;
+}
+
+bool impl::IslandSystem::read(const dtNavMesh* navMesh,
+                              Cr::Containers::ArrayView<const char> data) {
+  std::size_t offset = 0;
+  auto take = [&](void* dst, std::size_t size) {
+    if (size > data.size() - offset)
+      return false;
+    memcpy(dst, data.data() + offset, size);
+    offset += size;
+    return true;
+  };
+
+  IslandSectionHeader header{};
+  if (!take(&header, sizeof(header)) || header.magic != ISLANDSECTION_MAGIC ||
+      (header.version != ISLANDSECTION_VERSION && header.version != 1) ||
+      header.polyRefSize != sizeof(dtPolyRef) || header.numIslands < 0) {
+    return false;
+  }
+  const bool hasGeometry = header.version >= 2;
+
+  std::vector<vec3f> islandVerts;
+  for (int i = 0; i < header.numIslands; ++i) {
+    IslandRecord record{};
+    bool recordOk;
+    if (hasGeometry) {
+      recordOk = take(&record, sizeof(record));
+    } else {
+      IslandRecordV1 recordV1{};
+      recordOk = take(&recordV1, sizeof(recordV1));
+      record.radius = recordV1.radius;
+      record.area = recordV1.area;
+      record.numPolys = recordV1.numPolys;
+    }
+    if (!recordOk || record.numPolys < 0 ||
+        static_cast<std::size_t>(record.numPolys) * sizeof(dtPolyRef) >
+            data.size() - offset) {
+      return false;
+    }
+    std::vector<dtPolyRef>& polys = islandsToPolys_[i];
+    polys.resize(record.numPolys);
+    take(polys.data(), polys.size() * sizeof(dtPolyRef));
+    for (const dtPolyRef ref : polys) {
+      if (!navMesh->isValidPolyRef(ref) ||
+          !polyToIsland_.emplace(ref, i).second) {
+        return false;
+      }
+    }
+    if (hasGeometry) {
+      islandRadius_.emplace_back(record.radius);
+      islandCentroid_.emplace_back(Eigen::Map<const vec3f>{record.centroid});
+      islandBounds_.emplace_back(Eigen::Map<const vec3f>{record.bmin},
+                                 Eigen::Map<const vec3f>{record.bmax});
+    } else {
+      islandVerts.clear();
+      for (const dtPolyRef ref : polys) {
+        const dtMeshTile* tile = nullptr;
+        const dtPoly* poly = nullptr;
+        navMesh->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+        for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+          islandVerts.emplace_back(Eigen::Map<const vec3f>(
+              &tile->verts[static_cast<size_t>(poly->verts[iVert]) * 3]));
+        }
+      }
+      if (islandVerts.empty()) {
+        return false;
+      }
+      addIslandGeometry(islandVerts);
+      islandRadius_.back() = record.radius;
+    }
+    islandsToArea_[i] = record.area;
+  }
+  islandsToArea_[ID_UNDEFINED] = header.totalArea;
+  return true;
+}
+
+namespace {
+//! Islands persisted after the tiles of a .navmesh file, or nullptr if there
+//! are none or they don't match the loaded tiles.
+std::unique_ptr<impl::IslandSystem> readIslandSection(
+    const dtNavMesh* navMesh,
+    Cr::Containers::ArrayView<const char> data) {
+  if (data.isEmpty())
+    return nullptr;
+  auto islandSystem = std::make_unique<impl::IslandSystem>();
+  if (!islandSystem->read(navMesh, data)) {
+    ESP_DEBUG() << "Island data in navmesh file is invalid, recomputing";
+    return nullptr;
+  }
+  return islandSystem;
+}
+}  // namespace
+
 int PathFinder::Impl::numIslands() {
   return islandSystem_->numIslands();
 }
 
+std::vector<IslandStatistics> PathFinder::Impl::islandStatistics() const {
+  if (!islandSystem_)
+    return {};
+  return islandSystem_->statistics();
+}
+
 bool PathFinder::Impl::loadNavMesh(const std::string& path) {
+  ESP_TRACE_SCOPE("loadNavMesh");
   FILE* fp = fopen(path.c_str(), "rb");
   if (!fp)
     return false;
@@ -1163,12 +2713,136 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     }
   }
 
+  // optional island section following the tiles
+  std::vector<char> islandData;
+  char buffer[4096];
+  for (std::size_t n; (n = fread(buffer, 1, sizeof(buffer), fp)) > 0;) {
+    islandData.insert(islandData.end(), buffer, buffer + n);
+  }
   fclose(fp);
 
   navMesh_.reset(mesh);
+  mappedNavMesh_ = nullptr;
+  bounds_ = std::make_pair(bmin, bmax);
+
+  return initNavQuery(readIslandSection(
+      navMesh_.get(), {islandData.data(), islandData.size()}));
+}
+
+#ifdef CORRADE_TARGET_UNIX
+namespace {
+void unmapFile(char* data, std::size_t size) {
+  munmap(data, size);
+}
+
+//! Map a whole file privately. Pages are shared with other processes mapping
+//! the same file until written, which copies only the written pages.
+Cr::Containers::Array<char> mapFileCopyOnWrite(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return nullptr;
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return nullptr;
+  return Cr::Containers::Array<char>{static_cast<char*>(data),
+                                     static_cast<std::size_t>(st.st_size),
+                                     unmapFile};
+}
+}  // namespace
+#endif
+
+bool PathFinder::Impl::loadNavMeshMapped(const std::string& path) {
+  ESP_TRACE_SCOPE("loadNavMeshMapped");
+#ifndef CORRADE_TARGET_UNIX
+  ESP_DEBUG() << "Memory mapped files aren't supported on this platform, "
+                 "loading a copy of the navmesh";
+  return loadNavMesh(path);
+#else
+  Cr::Containers::Array<char> file = mapFileCopyOnWrite(path);
+  if (!file)
+    return false;
+
+  std::size_t offset = 0;
+  auto read = [&](void* dst, std::size_t size) {
+    if (offset + size > file.size())
+      return false;
+    memcpy(dst, file.data() + offset, size);
+    offset += size;
+    return true;
+  };
+
+  NavMeshSetHeader header{};
+  if (!read(&header, sizeof(NavMeshSetHeader)) ||
+      header.magic != NAVMESHSET_MAGIC || header.version < 1 ||
+      header.version > NAVMESHSET_VERSION) {
+    return false;
+  }
+
+  NavMeshSettings settings{};
+  if (header.version >= 2) {
+    if (!read(&settings, sizeof(NavMeshSettings)))
+      return false;
+  } else {
+    ESP_DEBUG()
+        << "NavMeshSettings aren't present, guessing that they are the default";
+  }
+
+  std::unique_ptr<dtNavMesh, NavMeshDeleter> mesh{dtAllocNavMesh()};
+  if (!mesh || dtStatusFailed(mesh->init(&header.params)))
+    return false;
+
+  vec3f bmin, bmax;
+  for (int i = 0; i < header.numTiles; ++i) {
+    NavMeshTileHeader tileHeader{};
+    if (!read(&tileHeader, sizeof(tileHeader)))
+      return false;
+
+    if ((tileHeader.tileRef == 0u) || (tileHeader.dataSize == 0))
+      break;
+    if (offset + tileHeader.dataSize > file.size())
+      return false;
+
+    // Detour reads the tile in place, so it has to be suitably aligned. Tile
+    // data sizes are padded to 4 bytes, so this only fails for corrupt files.
+    unsigned char* data =
+        reinterpret_cast<unsigned char*>(file.data() + offset);
+    if (reinterpret_cast<std::uintptr_t>(data) % 4 != 0) {
+      ESP_ERROR() << "Misaligned tile data in" << path;
+      return false;
+    }
+    offset += tileHeader.dataSize;
+
+    // no DT_TILE_FREE_DATA, the tile data is owned by the mapping
+    if (dtStatusFailed(mesh->addTile(data, tileHeader.dataSize, 0,
+                                     tileHeader.tileRef, nullptr))) {
+      return false;
+    }
+    const dtMeshTile* tile = mesh->getTileByRef(tileHeader.tileRef);
+    if (i == 0) {
+      bmin = vec3f(tile->header->bmin);
+      bmax = vec3f(tile->header->bmax);
+    } else {
+      bmin = bmin.array().min(Eigen::Array3f{tile->header->bmin});
+      bmax = bmax.array().max(Eigen::Array3f{tile->header->bmax});
+    }
+  }
+
+  // release the previous mesh before the mapping it may reference
+  navMesh_ = std::move(mesh);
+  mappedNavMesh_ = std::move(file);
+  navMeshSettings_ = {settings};
   bounds_ = std::make_pair(bmin, bmax);
 
-  return initNavQuery();
+  return initNavQuery(
+      readIslandSection(navMesh_.get(), mappedNavMesh_.exceptPrefix(offset)));
+#endif
 }
 
 bool PathFinder::Impl::saveNavMesh(const std::string& path) {
@@ -1214,11 +2888,266 @@ bool PathFinder::Impl::saveNavMesh(const std::string& path) {
     fwrite(tile->data, tile->dataSize, 1, fp);
   }
 
+  const bool islandsWritten = islandSystem_->write(fp);
   fclose(fp);
+  if (!islandsWritten) {
+    ESP_ERROR() << "Could not write navmesh islands to" << path;
+    return false;
+  }
 
   return true;
 }
 
+namespace {
+const int DISTANCEORACLE_MAGIC = 'D' << 24 | 'O' << 16 | 'R' << 8 | 'C';
+const int DISTANCEORACLE_VERSION = 2;
+
+struct DistanceOracleHeader {
+  int magic;
+  int version;
+  int numPolys;
+  int numLandmarks;
+  int allPairs;
+  int reserved;
+  uint64_t navMeshChecksum;
+};
+}  // namespace
+
+bool impl::DistanceOracle::save(const std::string& path) const {
+  FILE* fp = fopen(path.c_str(), "wb");
+  if (!fp)
+    return false;
+
+  DistanceOracleHeader header{};
+  header.magic = DISTANCEORACLE_MAGIC;
+  header.version = DISTANCEORACLE_VERSION;
+  header.numPolys = numPolys_;
+  header.numLandmarks = landmarks_.size();
+  header.allPairs = allPairs_;
+  header.navMeshChecksum = navMeshChecksum_;
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  ok = ok && fwrite(landmarks_.data(), sizeof(int), landmarks_.size(), fp) ==
+                 landmarks_.size();
+  ok = ok && fwrite(table_.data(), sizeof(float), table_.size(), fp) ==
+                 table_.size();
+
+  fclose(fp);
+  return ok;
+}
+
+bool impl::DistanceOracle::load(const std::string& path,
+                                const PolyGraph& graph) {
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp)
+    return false;
+
+  DistanceOracleHeader header{};
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      header.magic != DISTANCEORACLE_MAGIC ||
+      header.version != DISTANCEORACLE_VERSION ||
+      header.numPolys != graph.numPolys() || header.numLandmarks < 0) {
+    fclose(fp);
+    return false;
+  }
+  // same polygon count but different tiles, e.g. after updateTiles()
+  if (header.navMeshChecksum != graph.checksum()) {
+    ESP_ERROR() << "The distance oracle in" << path
+                << "was computed for a different NavMesh";
+    fclose(fp);
+    return false;
+  }
+
+  numPolys_ = header.numPolys;
+  navMeshChecksum_ = header.navMeshChecksum;
+  allPairs_ = header.allPairs != 0;
+  landmarks_.resize(header.numLandmarks);
+  table_.resize(static_cast<std::size_t>(header.numLandmarks) * numPolys_);
+  bool ok = fread(landmarks_.data(), sizeof(int), landmarks_.size(), fp) ==
+            landmarks_.size();
+  ok = ok &&
+       fread(table_.data(), sizeof(float), table_.size(), fp) == table_.size();
+  fclose(fp);
+
+  rowOfPoly_.assign(numPolys_, ID_UNDEFINED);
+  for (std::size_t row = 0; ok && row < landmarks_.size(); ++row) {
+    if (landmarks_[row] < 0 || landmarks_[row] >= numPolys_) {
+      ok = false;
+      break;
+    }
+    rowOfPoly_[landmarks_[row]] = static_cast<int>(row);
+  }
+  return ok;
+}
+
+bool PathFinder::Impl::buildDistanceOracle(const std::size_t maxMemoryBytes,
+                                           const int numThreads) {
+  if (!isLoaded()) {
+    ESP_ERROR() << "No NavMesh loaded, can't build a distance oracle.";
+    return false;
+  }
+  distanceOracle_ = std::make_unique<impl::DistanceOracle>(
+      polyGraph(), maxMemoryBytes, numThreads);
+  ESP_DEBUG() << "Built distance oracle with"
+              << distanceOracle_->numLandmarks() << "landmarks over"
+              << polyGraph_->numPolys() << "polygons using"
+              << distanceOracle_->memoryBytes() << "bytes";
+  return distanceOracle_->numLandmarks() > 0;
+}
+
+std::pair<float, float> PathFinder::Impl::getOracleDistanceBounds(
+    const vec3f& a,
+    const vec3f& b) const {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  if (!distanceOracle_) {
+    ESP_ERROR() << "No distance oracle built or loaded.";
+    return {inf, inf};
+  }
+
+  dtStatus status = 0;
+  dtPolyRef refA = 0, refB = 0;
+  vec3f ptA, ptB;
+  std::tie(status, refA, ptA) =
+      projectToPoly(a, threadQuery(), filter_.get());
+  if (status != DT_SUCCESS || refA == 0)
+    return {inf, inf};
+  std::tie(status, refB, ptB) =
+      projectToPoly(b, threadQuery(), filter_.get());
+  if (status != DT_SUCCESS || refB == 0)
+    return {inf, inf};
+  if (!islandSystem_->hasConnection(refA, refB))
+    return {inf, inf};
+
+  // polygons are convex, so a straight line is the shortest path within one
+  const float euclid = (ptA - ptB).norm();
+  const int polyA = polyGraph_->polyIndex(refA);
+  const int polyB = polyGraph_->polyIndex(refB);
+  if (polyA == polyB)
+    return {euclid, euclid};
+
+  // the table stores centroid distances, correct for the offset of the query
+  // points from their polygon centroids
+  const float offset = (ptA - polyGraph_->centroid(polyA)).norm() +
+                       (ptB - polyGraph_->centroid(polyB)).norm();
+  const std::pair<float, float> bounds =
+      distanceOracle_->bounds(polyA, polyB);
+  return {std::max(euclid, bounds.first - offset), bounds.second + offset};
+}
+
+float PathFinder::Impl::getOracleDistance(const vec3f& a, const vec3f& b) {
+  const float distance = getOracleDistanceBounds(a, b).second;
+  if (std::isinf(distance) && distanceOracle_) {
+    // no landmark covers both points, fall back to an exact search
+    ShortestPath path;
+    path.requestedStart = a;
+    path.requestedEnd = b;
+    findPath(path);
+    return path.geodesicDistance;
+  }
+  return distance;
+}
+
+bool PathFinder::Impl::saveDistanceOracle(const std::string& path) const {
+  if (!distanceOracle_) {
+    ESP_ERROR() << "No distance oracle built or loaded, nothing to save.";
+    return false;
+  }
+  return distanceOracle_->save(path);
+}
+
+bool PathFinder::Impl::loadDistanceOracle(const std::string& path) {
+  if (!isLoaded())
+    return false;
+  auto oracle = std::make_unique<impl::DistanceOracle>();
+  if (!oracle->load(path, polyGraph())) {
+    ESP_ERROR() << "Could not load a distance oracle matching the current "
+                   "NavMesh from"
+                << path;
+    return false;
+  }
+  distanceOracle_ = std::move(oracle);
+  return true;
+}
+
+bool PathFinder::Impl::buildGoalDistanceField(MultiGoalShortestPath& path) {
+  auto& field = path.pimpl_->goalField;
+  field = {};
+  if (!isLoaded()) {
+    ESP_ERROR() << "No NavMesh loaded, can't build a goal distance field.";
+    return false;
+  }
+
+  const impl::PolyGraph& graph = polyGraph();
+  std::vector<std::pair<int, vec3f>> sources;
+  for (const auto& rqEnd : path.getRequestedEnds()) {
+    dtStatus status = 0;
+    dtPolyRef endRef = 0;
+    vec3f pathEnd;
+    std::tie(status, endRef, pathEnd) =
+        projectToPoly(rqEnd, navQuery_.get(), filter_.get());
+    if (status != DT_SUCCESS || endRef == 0) {
+      ESP_DEBUG() << "Can't project end-point to navmesh, skipping: " << rqEnd;
+      continue;
+    }
+    const int polyIndex = graph.polyIndex(endRef);
+    sources.emplace_back(polyIndex, pathEnd);
+    field.goalsInPoly[polyIndex].push_back(pathEnd);
+  }
+  if (sources.empty()) {
+    ESP_DEBUG() << "Can't project any end-points to navmesh.";
+    field = {};
+    return false;
+  }
+
+  graph.dijkstra(sources, field.dist, field.entry, nullptr,
+                 [](int) { return false; });
+  field.navMeshToken = navQueryToken_;
+  return true;
+}
+
+float PathFinder::Impl::getGoalDistance(const MultiGoalShortestPath& path,
+                                        const vec3f& pt) const {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  const auto& field = path.pimpl_->goalField;
+  if (field.navMeshToken == 0 || field.navMeshToken != navQueryToken_) {
+    ESP_ERROR() << "No goal distance field built for the current NavMesh, "
+                   "call buildGoalDistanceField() first.";
+    return inf;
+  }
+
+  dtStatus status = 0;
+  dtPolyRef ptRef = 0;
+  vec3f polyPt;
+  std::tie(status, ptRef, polyPt) =
+      projectToPoly(pt, threadQuery(), filter_.get());
+  if (status != DT_SUCCESS || ptRef == 0)
+    return inf;
+
+  const int polyIndex = polyGraph_->polyIndex(ptRef);
+  float distance = inf;
+  // goals on the same (convex) polygon are reachable in a straight line
+  auto goalsIt = field.goalsInPoly.find(polyIndex);
+  if (goalsIt != field.goalsInPoly.end()) {
+    for (const vec3f& goal : goalsIt->second) {
+      distance = std::min(distance, (polyPt - goal).norm());
+    }
+  }
+  if (!std::isinf(field.dist[polyIndex])) {
+    distance = std::min(distance, field.dist[polyIndex] +
+                                      (polyPt - field.entry[polyIndex]).norm());
+  }
+  // interpolate through the portals to the neighbours, which is tighter when
+  // the point is closer to a different portal than the one the field used
+  for (const impl::PolyGraph::Edge& edge : polyGraph_->edges(polyIndex)) {
+    if (std::isinf(field.dist[edge.to]))
+      continue;
+    const float viaPortal = field.dist[edge.to] +
+                            (field.entry[edge.to] - edge.portal).norm() +
+                            (polyPt - edge.portal).norm();
+    distance = std::min(distance, viaPortal);
+  }
+  return distance;
+}
+
 void PathFinder::Impl::seed(uint32_t newSeed) {
   // TODO: this should be using core::Random instead, but passing function
   // to navQuery_->findRandomPoint needs to be figured out first
@@ -1392,6 +3321,174 @@ vec3f PathFinder::Impl::getRandomNavigablePointAroundSphere(
   return pt;
 }
 
+impl::AreaSampler::AreaSampler(
+    const dtNavMesh* navMesh,
+    const dtQueryFilter* filter,
+    const std::function<bool(dtPolyRef)>& includePoly,
+    const std::pair<vec3f, vec3f>* bounds) {
+  double totalArea = 0.0;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    if (bounds && (tile->header->bmin[0] > bounds->second[0] ||
+                   tile->header->bmin[2] > bounds->second[2] ||
+                   tile->header->bmax[0] < bounds->first[0] ||
+                   tile->header->bmax[2] < bounds->first[2]))
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          !filter->passFilter(ref, tile, poly) || !includePoly(ref))
+        continue;
+
+      for (const nav::Triangle& tri : getPolygonTriangles(poly, tile)) {
+        if (bounds) {
+          const vec3f triMin = tri.v[0].cwiseMin(tri.v[1]).cwiseMin(tri.v[2]);
+          const vec3f triMax = tri.v[0].cwiseMax(tri.v[1]).cwiseMax(tri.v[2]);
+          if (triMin[0] > bounds->second[0] || triMin[2] > bounds->second[2] ||
+              triMax[0] < bounds->first[0] || triMax[2] < bounds->first[2])
+            continue;
+        }
+        const vec3f e1 = tri.v[1] - tri.v[0];
+        const vec3f e2 = tri.v[2] - tri.v[0];
+        const float area = 0.5f * std::abs(e1[0] * e2[2] - e2[0] * e1[2]);
+        if (area <= 0.0f)
+          continue;
+        totalArea += area;
+        triangles_.push_back({{tri.v[0], tri.v[1], tri.v[2]}});
+        cdf_.push_back(totalArea);
+      }
+    }
+  }
+}
+
+namespace {
+//! Call func(index, rng) for numSamples samples in parallel. Samples are
+//! drawn in fixed size chunks with a stream per chunk seeded from seed, so
+//! results are reproducible independent of the number of threads.
+template <typename F>
+void sampleInChunks(const std::size_t numSamples,
+                    const uint32_t seed,
+                    const int numThreads,
+                    F&& func) {
+  constexpr std::size_t ChunkSize = 1024;
+  const std::size_t numChunks = (numSamples + ChunkSize - 1) / ChunkSize;
+  core::parallelFor(numChunks, numThreads, [&](std::size_t chunk, int) {
+    std::seed_seq seq{seed, static_cast<uint32_t>(chunk)};
+    uint32_t chunkSeed = 0;
+    seq.generate(&chunkSeed, &chunkSeed + 1);
+    core::Random rng{chunkSeed};
+    const std::size_t end = std::min(numSamples, (chunk + 1) * ChunkSize);
+    for (std::size_t i = chunk * ChunkSize; i < end; ++i) {
+      func(i, rng);
+    }
+  });
+}
+}  // namespace
+
+std::vector<vec3f> PathFinder::Impl::getRandomNavigablePoints(
+    const int numPoints,
+    const int islandIndex,
+    const Cr::Containers::Optional<uint32_t>& seed,
+    const int numThreads) {
+  islandSystem_->assertValidIsland(islandIndex);
+  ESP_CHECK(numPoints >= 0, "PathFinder::getRandomNavigablePoints(): got"
+                                << numPoints << "points");
+  if (getNavigableArea(islandIndex) <= 0.0)
+    throw std::runtime_error(
+        "NavMesh has no navigable area, this indicates an issue with the "
+        "NavMesh");
+
+  auto sampler = areaSamplers_.find(islandIndex);
+  if (sampler == areaSamplers_.end()) {
+    auto onIsland = [&](dtPolyRef ref) {
+      return islandIndex == ID_UNDEFINED ||
+             islandSystem_->findPolyIsland(ref) == islandIndex;
+    };
+    sampler = areaSamplers_
+                  .emplace(islandIndex, std::make_unique<impl::AreaSampler>(
+                                            navMesh_.get(), filter_.get(),
+                                            onIsland))
+                  .first;
+  }
+
+  std::vector<vec3f> points(numPoints,
+                            vec3f::Constant(Mn::Constants::nan()));
+  if (sampler->second->empty()) {
+    ESP_ERROR() << "Failed to getRandomNavigablePoints. No polygon with area "
+                   "found";
+    return points;
+  }
+  // without an explicit seed draw one from the generator set by seed()
+  const uint32_t baseSeed = seed ? *seed : static_cast<uint32_t>(rand());
+  const impl::AreaSampler& areaSampler = *sampler->second;
+  sampleInChunks(points.size(), baseSeed, numThreads,
+                 [&](std::size_t i, core::Random& rng) {
+                   points[i] = areaSampler.sample(rng);
+                 });
+  return points;
+}
+
+std::vector<vec3f> PathFinder::Impl::getRandomNavigablePointsAroundSphere(
+    const vec3f& circleCenter,
+    const float radius,
+    const int numPoints,
+    const int maxTries,
+    const int islandIndex,
+    const Cr::Containers::Optional<uint32_t>& seed,
+    const int numThreads) {
+  islandSystem_->assertValidIsland(islandIndex);
+  ESP_CHECK(numPoints >= 0,
+            "PathFinder::getRandomNavigablePointsAroundSphere(): got"
+                << numPoints << "points");
+  if (getNavigableArea(islandIndex) <= 0.0)
+    throw std::runtime_error(
+        "NavMesh has no navigable area, this indicates an issue with the "
+        "NavMesh");
+
+  // only the triangles overlapping the sphere's bounds, so rejection is rare
+  const std::pair<vec3f, vec3f> sphereBounds{
+      circleCenter - vec3f::Constant(radius),
+      circleCenter + vec3f::Constant(radius)};
+  auto onIsland = [&](dtPolyRef ref) {
+    return islandIndex == ID_UNDEFINED ||
+           islandSystem_->findPolyIsland(ref) == islandIndex;
+  };
+  const impl::AreaSampler sampler{navMesh_.get(), filter_.get(), onIsland,
+                                  &sphereBounds};
+
+  std::vector<vec3f> points(numPoints,
+                            vec3f::Constant(Mn::Constants::nan()));
+  if (sampler.empty()) {
+    ESP_ERROR() << "Failed to getRandomNavigablePointsAroundSphere. No "
+                   "polygon found within radius";
+    return points;
+  }
+  const uint32_t baseSeed = seed ? *seed : static_cast<uint32_t>(rand());
+  std::atomic<int> numFailed{0};
+  sampleInChunks(points.size(), baseSeed, numThreads,
+                 [&](std::size_t i, core::Random& rng) {
+                   for (int j = 0; j < maxTries; ++j) {
+                     const vec3f pt = sampler.sample(rng);
+                     if ((pt - circleCenter).norm() <= radius) {
+                       points[i] = pt;
+                       return;
+                     }
+                   }
+                   ++numFailed;
+                 });
+  if (numFailed > 0) {
+    ESP_ERROR() << "Failed to sample" << numFailed << "of" << numPoints
+                << "points in getRandomNavigablePointsAroundSphere. Try "
+                   "increasing max tries if the navmesh is fine but just "
+                   "hard to sample from";
+  }
+  return points;
+}
+
 namespace {
 float pathLength(const std::vector<vec3f>& points) {
   CORRADE_INTERNAL_ASSERT(points.size() > 0);
@@ -1408,6 +3505,7 @@ float pathLength(const std::vector<vec3f>& points) {
 }  // namespace
 
 bool PathFinder::Impl::findPath(ShortestPath& path) {
+  ESP_TRACE_SCOPE("findPath");
   MultiGoalShortestPath tmp;
   tmp.requestedStart = path.requestedStart;
   tmp.setRequestedEnds({path.requestedEnd});
@@ -1420,12 +3518,13 @@ bool PathFinder::Impl::findPath(ShortestPath& path) {
 }
 
 Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-PathFinder::Impl::findPathInternal(const vec3f& start,
+PathFinder::Impl::findPathInternal(dtNavMeshQuery* query,
+                                   const vec3f& start,
                                    dtPolyRef startRef,
                                    const vec3f& pathStart,
                                    const vec3f& end,
                                    dtPolyRef endRef,
-                                   const vec3f& pathEnd) {
+                                   const vec3f& pathEnd) const {
   // check if trivial path (start is same as end) and early return
   if (pathStart.isApprox(pathEnd)) {
     return std::make_tuple(0.0f, std::vector<vec3f>{pathStart, pathEnd});
@@ -1441,17 +3540,17 @@ PathFinder::Impl::findPathInternal(const vec3f& start,
 
   int numPolys = 0;
   dtStatus status =
-      navQuery_->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
-                          filter_.get(), polys, &numPolys, MAX_POLYS);
+      query->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
+                      filter_.get(), polys, &numPolys, MAX_POLYS);
   if (status != DT_SUCCESS || numPolys == 0) {
     return Cr::Containers::NullOpt;
   }
 
   int numPoints = 0;
   std::vector<vec3f> points(MAX_POLYS);
-  status = navQuery_->findStraightPath(start.data(), end.data(), polys,
-                                       numPolys, points[0].data(), nullptr,
-                                       nullptr, &numPoints, MAX_POLYS);
+  status = query->findStraightPath(start.data(), end.data(), polys, numPolys,
+                                   points[0].data(), nullptr, nullptr,
+                                   &numPoints, MAX_POLYS);
   if (status != DT_SUCCESS || numPoints == 0) {
     return Corrade::Containers::NullOpt;
   }
@@ -1471,9 +3570,10 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
   path.points.clear();
 
   // find nearest polys and path
+  const dtNavMeshQuery* query = threadQuery();
   dtStatus status = 0;
   std::tie(status, startRef, pathStart) =
-      projectToPoly(path.requestedStart, navQuery_.get(), filter_.get());
+      projectToPoly(path.requestedStart, query, filter_.get());
 
   if (status != DT_SUCCESS || startRef == 0) {
     return false;
@@ -1487,7 +3587,7 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
     dtPolyRef endRef = 0;
     vec3f pathEnd;
     std::tie(status, endRef, pathEnd) =
-        projectToPoly(rqEnd, navQuery_.get(), filter_.get());
+        projectToPoly(rqEnd, query, filter_.get());
 
     if (status != DT_SUCCESS || endRef == 0) {
       path.pimpl_->endIsValid.emplace_back(false);
@@ -1500,85 +3600,325 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
     path.pimpl_->endRefs.emplace_back(endRef);
     path.pimpl_->pathEnds.emplace_back(pathEnd);
   }
-  if (numValidPoints == 0) {
-    ESP_DEBUG() << "Early abort, can't project any points to navmesh.";
+  if (numValidPoints == 0) {
+    ESP_DEBUG() << "Early abort, can't project any points to navmesh.";
+    return false;
+  }
+
+  return true;
+}
+
+bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
+  ESP_TRACE_SCOPE("findMultiGoalPath");
+  dtPolyRef startRef = 0;
+  vec3f pathStart;
+  if (!findPathSetup(path, startRef, pathStart))
+    return false;
+
+  if (path.useMultiTargetSearch)
+    return findPathMultiTarget(path, startRef, pathStart);
+
+  if (path.pimpl_->requestedEnds.size() > 1) {
+    // Bound the minimum distance any point could be from the start by either
+    // how close it use to be minus how much we moved from the last search point
+    // or just the L2 distance.
+
+    ShortestPath prevPath;
+    prevPath.requestedStart = path.requestedStart;
+    prevPath.requestedEnd = path.pimpl_->prevRequestedStart;
+    findPath(prevPath);
+    const float movedAmount = prevPath.geodesicDistance;
+
+    for (int i = 0; i < path.pimpl_->requestedEnds.size(); ++i) {
+      path.pimpl_->minTheoreticalDist[i] = std::max(
+          path.pimpl_->minTheoreticalDist[i] - movedAmount,
+          (path.pimpl_->requestedEnds[i] - path.requestedStart).norm());
+    }
+
+    path.pimpl_->prevRequestedStart = path.requestedStart;
+  }
+
+  // Explore possible goal points by their minimum theoretical distance.
+  std::vector<size_t> ordering(path.pimpl_->requestedEnds.size());
+  std::iota(ordering.begin(), ordering.end(), 0);
+  std::sort(ordering.begin(), ordering.end(),
+            [&path](const size_t a, const size_t b) -> bool {
+              return path.pimpl_->minTheoreticalDist[a] <
+                     path.pimpl_->minTheoreticalDist[b];
+            });
+
+  for (size_t i : ordering) {
+    if (!path.pimpl_->endIsValid[i])
+      continue;
+
+    if (path.pimpl_->minTheoreticalDist[i] > path.geodesicDistance)
+      continue;
+
+    const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+        findResult =
+            findPathInternal(threadQuery(), path.requestedStart, startRef,
+                             pathStart,
+                             path.pimpl_->requestedEnds[i],
+                             path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i]);
+
+    if (findResult && std::get<0>(*findResult) < path.geodesicDistance) {
+      path.pimpl_->minTheoreticalDist[i] = std::get<0>(*findResult);
+      path.geodesicDistance = std::get<0>(*findResult);
+      path.points = std::get<1>(*findResult);
+      path.closestEndPointIndex = i;
+    }
+  }
+
+  return path.geodesicDistance < std::numeric_limits<float>::infinity();
+}
+
+bool PathFinder::Impl::findPathMultiTarget(MultiGoalShortestPath& path,
+                                           const dtPolyRef startRef,
+                                           const vec3f& pathStart) {
+  const impl::PolyGraph& graph = polyGraph();
+  const auto& pathImpl = *path.pimpl_;
+
+  std::unordered_map<int, std::vector<int>> goalsInPoly;
+  for (int i = 0; i < pathImpl.requestedEnds.size(); ++i) {
+    if (pathImpl.endIsValid[i])
+      goalsInPoly[graph.polyIndex(pathImpl.endRefs[i])].push_back(i);
+  }
+
+  // A goal inside a settled polygon is reached at the polygon's distance plus
+  // the straight line from its entry point. Once the next polygon to settle
+  // is farther than the best goal so far, no unsettled goal can be closer.
+  float bestDist = std::numeric_limits<float>::infinity();
+  int bestGoal = ID_UNDEFINED;
+  int bestPoly = ID_UNDEFINED;
+  std::vector<float> dist;
+  std::vector<vec3f> entry;
+  std::vector<int> parent;
+  graph.dijkstra({{graph.polyIndex(startRef), pathStart}}, dist, entry,
+                 &parent, [&](int poly) {
+                   if (dist[poly] >= bestDist)
+                     return true;
+                   auto goalsIt = goalsInPoly.find(poly);
+                   if (goalsIt != goalsInPoly.end()) {
+                     for (int goal : goalsIt->second) {
+                       const float d =
+                           dist[poly] +
+                           (pathImpl.pathEnds[goal] - entry[poly]).norm();
+                       if (d < bestDist) {
+                         bestDist = d;
+                         bestGoal = goal;
+                         bestPoly = poly;
+                       }
+                     }
+                   }
+                   return false;
+                 });
+  if (bestGoal == ID_UNDEFINED)
+    return false;
+
+  // walk the parents back to the start to get the polygon corridor
+  std::vector<dtPolyRef> corridor;
+  for (int poly = bestPoly; poly != ID_UNDEFINED; poly = parent[poly]) {
+    corridor.push_back(graph.polyRef(poly));
+  }
+  std::reverse(corridor.begin(), corridor.end());
+
+  const vec3f& end = pathImpl.requestedEnds[bestGoal];
+  if (pathStart.isApprox(pathImpl.pathEnds[bestGoal])) {
+    path.points = {pathStart, pathImpl.pathEnds[bestGoal]};
+    path.geodesicDistance = 0;
+    path.closestEndPointIndex = bestGoal;
+    return true;
+  }
+
+  int numPoints = 0;
+  std::vector<vec3f> points(corridor.size() + 2);
+  dtStatus status = threadQuery()->findStraightPath(
+      path.requestedStart.data(), end.data(), corridor.data(), corridor.size(),
+      points[0].data(), nullptr, nullptr, &numPoints, points.size());
+  if (status != DT_SUCCESS || numPoints == 0)
+    return false;
+  points.resize(numPoints);
+
+  path.geodesicDistance = pathLength(points);
+  path.points = std::move(points);
+  path.closestEndPointIndex = bestGoal;
+  return true;
+}
+
+bool PathFinder::Impl::findPathWithQuery(ShortestPath& path,
+                                         dtNavMeshQuery* query) const {
+  path.geodesicDistance = std::numeric_limits<float>::infinity();
+  path.points.clear();
+
+  dtStatus status = 0;
+  dtPolyRef startRef = 0;
+  vec3f pathStart;
+  std::tie(status, startRef, pathStart) =
+      projectToPoly(path.requestedStart, query, filter_.get());
+  if (status != DT_SUCCESS || startRef == 0) {
+    return false;
+  }
+
+  dtPolyRef endRef = 0;
+  vec3f pathEnd;
+  std::tie(status, endRef, pathEnd) =
+      projectToPoly(path.requestedEnd, query, filter_.get());
+  if (status != DT_SUCCESS || endRef == 0) {
+    return false;
+  }
+
+  Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>> findResult =
+      findPathInternal(query, path.requestedStart, startRef, pathStart,
+                       path.requestedEnd, endRef, pathEnd);
+  if (!findResult) {
     return false;
   }
 
+  path.geodesicDistance = std::get<0>(*findResult);
+  path.points = std::move(std::get<1>(*findResult));
   return true;
 }
 
-bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
+float PathFinder::Impl::findDistanceWithQuery(const vec3f& start,
+                                              const vec3f& end,
+                                              dtNavMeshQuery* query) const {
+  constexpr float NoPath = std::numeric_limits<float>::infinity();
+  dtStatus status = 0;
   dtPolyRef startRef = 0;
   vec3f pathStart;
-  if (!findPathSetup(path, startRef, pathStart))
-    return false;
-
-  if (path.pimpl_->requestedEnds.size() > 1) {
-    // Bound the minimum distance any point could be from the start by either
-    // how close it use to be minus how much we moved from the last search point
-    // or just the L2 distance.
-
-    ShortestPath prevPath;
-    prevPath.requestedStart = path.requestedStart;
-    prevPath.requestedEnd = path.pimpl_->prevRequestedStart;
-    findPath(prevPath);
-    const float movedAmount = prevPath.geodesicDistance;
-
-    for (int i = 0; i < path.pimpl_->requestedEnds.size(); ++i) {
-      path.pimpl_->minTheoreticalDist[i] = std::max(
-          path.pimpl_->minTheoreticalDist[i] - movedAmount,
-          (path.pimpl_->requestedEnds[i] - path.requestedStart).norm());
-    }
+  std::tie(status, startRef, pathStart) =
+      projectToPoly(start, query, filter_.get());
+  if (status != DT_SUCCESS || startRef == 0) {
+    return NoPath;
+  }
+  dtPolyRef endRef = 0;
+  vec3f pathEnd;
+  std::tie(status, endRef, pathEnd) = projectToPoly(end, query, filter_.get());
+  if (status != DT_SUCCESS || endRef == 0) {
+    return NoPath;
+  }
 
-    path.pimpl_->prevRequestedStart = path.requestedStart;
+  // same steps as findPathInternal()
+  if (pathStart.isApprox(pathEnd)) {
+    return 0.0f;
+  }
+  if (!islandSystem_->hasConnection(startRef, endRef)) {
+    return NoPath;
   }
 
-  // Explore possible goal points by their minimum theoretical distance.
-  std::vector<size_t> ordering(path.pimpl_->requestedEnds.size());
-  std::iota(ordering.begin(), ordering.end(), 0);
-  std::sort(ordering.begin(), ordering.end(),
-            [&path](const size_t a, const size_t b) -> bool {
-              return path.pimpl_->minTheoreticalDist[a] <
-                     path.pimpl_->minTheoreticalDist[b];
-            });
+  constexpr int MAX_POLYS = 256;
+  dtPolyRef polys[MAX_POLYS];
+  int numPolys = 0;
+  status = query->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
+                           filter_.get(), polys, &numPolys, MAX_POLYS);
+  if (status != DT_SUCCESS || numPolys == 0) {
+    return NoPath;
+  }
 
-  for (size_t i : ordering) {
-    if (!path.pimpl_->endIsValid[i])
-      continue;
+  float points[3 * MAX_POLYS];
+  int numPoints = 0;
+  status = query->findStraightPath(start.data(), end.data(), polys, numPolys,
+                                   points, nullptr, nullptr, &numPoints,
+                                   MAX_POLYS);
+  if (status != DT_SUCCESS || numPoints == 0) {
+    return NoPath;
+  }
 
-    if (path.pimpl_->minTheoreticalDist[i] > path.geodesicDistance)
-      continue;
+  float length = 0.0f;
+  for (int i = 1; i < numPoints; ++i) {
+    length += (Eigen::Map<const vec3f>{points + 3 * i} -
+               Eigen::Map<const vec3f>{points + 3 * (i - 1)})
+                  .norm();
+  }
+  return length;
+}
 
-    const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-        findResult =
-            findPathInternal(path.requestedStart, startRef, pathStart,
-                             path.pimpl_->requestedEnds[i],
-                             path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i]);
+int PathFinder::Impl::findPaths(Cr::Containers::ArrayView<ShortestPath> paths,
+                                int numThreads) {
+  ESP_TRACE_SCOPE("findPaths");
+  numThreads = core::resolveNumThreads(numThreads, paths.size());
+  if (!initWorkerQueries(numThreads)) {
+    return 0;
+  }
 
-    if (findResult && std::get<0>(*findResult) < path.geodesicDistance) {
-      path.pimpl_->minTheoreticalDist[i] = std::get<0>(*findResult);
-      path.geodesicDistance = std::get<0>(*findResult);
-      path.points = std::get<1>(*findResult);
-      path.closestEndPointIndex = i;
+  std::atomic<int> numFound{0};
+  core::parallelFor(paths.size(), numThreads, [&](std::size_t i, int worker) {
+    if (findPathWithQuery(paths[i], workerQuery(worker))) {
+      ++numFound;
     }
+  });
+  return numFound;
+}
+
+std::vector<float> PathFinder::Impl::getGeodesicDistances(
+    const std::vector<vec3f>& starts,
+    const std::vector<vec3f>& ends,
+    int numThreads) {
+  ESP_CHECK(starts.size() == ends.size(),
+            "PathFinder::getGeodesicDistances(): got"
+                << starts.size() << "starts but" << ends.size() << "ends");
+  std::vector<float> distances(starts.size(),
+                               std::numeric_limits<float>::infinity());
+
+  numThreads = core::resolveNumThreads(numThreads, starts.size());
+  if (!initWorkerQueries(numThreads)) {
+    return distances;
   }
 
-  return path.geodesicDistance < std::numeric_limits<float>::infinity();
+  core::parallelFor(starts.size(), numThreads, [&](std::size_t i, int worker) {
+    distances[i] =
+        findDistanceWithQuery(starts[i], ends[i], workerQuery(worker));
+  });
+  return distances;
 }
 
 template <typename T>
 T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
+  ESP_TRACE_SCOPE("tryStep");
+  dtPolyRef polyRef = 0;
+  return T{tryStepWithQuery(Eigen::Map<const vec3f>{start.data()},
+                            Eigen::Map<const vec3f>{end.data()}, allowSliding,
+                            threadQuery(), polyRef)};
+}
+
+bool PathFinder::Impl::startOnPoly(const vec3f& start,
+                                   const dtPolyRef polyRef,
+                                   const dtNavMeshQuery* query,
+                                   vec3f& pathStart) const {
+  if (polyRef == 0 || !query->isValidPolyRef(polyRef, filter_.get()))
+    return false;
+  bool posOverPoly = false;
+  if (dtStatusFailed(query->closestPointOnPoly(
+          polyRef, start.data(), pathStart.data(), &posOverPoly))) {
+    return false;
+  }
+  // the point was moved off the poly since it was cached (e.g. the agent was
+  // teleported), fall back to a full search
+  const dtMeshTile* tile = nullptr;
+  const dtPoly* poly = nullptr;
+  navMesh_->getTileAndPolyByRefUnsafe(polyRef, &tile, &poly);
+  return posOverPoly &&
+         std::abs(start[1] - pathStart[1]) <= tile->header->walkableClimb;
+}
+
+vec3f PathFinder::Impl::tryStepWithQuery(const vec3f& start,
+                                         const vec3f& end,
+                                         const bool allowSliding,
+                                         const dtNavMeshQuery* query,
+                                         dtPolyRef& polyRef) const {
   static const int MAX_POLYS = 256;
   dtPolyRef polys[MAX_POLYS];
 
-  dtStatus startStatus = 0, endStatus = 0;
-  dtPolyRef startRef = 0, endRef = 0;
+  dtStatus startStatus = DT_SUCCESS, endStatus = 0;
+  dtPolyRef startRef = polyRef, endRef = 0;
   vec3f pathStart;
-  std::tie(startStatus, startRef, pathStart) =
-      projectToPoly(start, navQuery_.get(), filter_.get());
+  if (!startOnPoly(start, startRef, query, pathStart)) {
+    std::tie(startStatus, startRef, pathStart) =
+        projectToPoly(start, query, filter_.get());
+  }
   std::tie(endStatus, endRef, std::ignore) =
-      projectToPoly(end, navQuery_.get(), filter_.get());
+      projectToPoly(end, query, filter_.get());
+  polyRef = dtStatusFailed(startStatus) ? 0 : startRef;
 
   if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
     return start;
@@ -1590,9 +3930,9 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
 
   vec3f endPoint;
   int numPolys = 0;
-  navQuery_->moveAlongSurface(startRef, pathStart.data(), end.data(),
-                              filter_.get(), endPoint.data(), polys, &numPolys,
-                              MAX_POLYS, allowSliding);
+  query->moveAlongSurface(startRef, pathStart.data(), end.data(),
+                          filter_.get(), endPoint.data(), polys, &numPolys,
+                          MAX_POLYS, allowSliding);
   // If there isn't any possible path between start and end, just return
   // start, that is cleanest
   if (numPolys == 0) {
@@ -1607,7 +3947,7 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
   // surface at the endPoint and set its height to that.
   // Note, this will never fail as endPoint is always within in the poly
   // polys[numPolys - 1]
-  navQuery_->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
+  query->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
 
   // Hack to deal with infinitely thin walls in recast allowing you to
   // transition between two different connected components
@@ -1615,7 +3955,7 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
   // is in the same connected component as the startRef according to
   // findNearestPoly
   std::tie(std::ignore, endRef, std::ignore) =
-      projectToPoly(endPoint, navQuery_.get(), filter_.get());
+      projectToPoly(endPoint, query, filter_.get());
   if (!this->islandSystem_->hasConnection(startRef, endRef)) {
     // There isn't a connection!  This happens when endPoint is on an edge
     // shared between two different connected components (aka infinitely thin
@@ -1638,32 +3978,54 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
     const vec3f nudgeDir = (polyCenter - endPoint).normalized();
     // And nudge the point towards the center by a little tiny bit :)
     endPoint = endPoint + nudgeDistance * nudgeDir;
+    endRef = polys[numPolys - 1];
   }
 
-  return T{std::move(endPoint)};
+  polyRef = endRef;
+  return endPoint;
 }
 
-template <typename T>
-T PathFinder::Impl::snapPoint(const T& pt, int islandIndex /*=ID_UNDEFINED*/) {
-  islandSystem_->assertValidIsland(islandIndex);
+void PathFinder::Impl::trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                                Cr::Containers::ArrayView<const vec3f> ends,
+                                Cr::Containers::ArrayView<vec3f> stepped,
+                                Cr::Containers::ArrayView<uint64_t> polyRefs,
+                                const bool allowSliding,
+                                int numThreads) {
+  ESP_CHECK(starts.size() == ends.size() && starts.size() == stepped.size(),
+            "PathFinder::trySteps(): got" << starts.size() << "starts,"
+                                          << ends.size() << "ends and"
+                                          << stepped.size() << "outputs");
+  ESP_CHECK(polyRefs.isEmpty() || polyRefs.size() == starts.size(),
+            "PathFinder::trySteps(): got" << polyRefs.size()
+                                          << "poly refs for" << starts.size()
+                                          << "starts");
+  numThreads = core::resolveNumThreads(numThreads, starts.size());
+  if (!initWorkerQueries(numThreads)) {
+    std::copy(starts.begin(), starts.end(), stepped.begin());
+    return;
+  }
 
-  // If this query should be island specific
-  if (islandIndex != ID_UNDEFINED) {
+  core::parallelFor(starts.size(), numThreads, [&](std::size_t i, int worker) {
+    dtPolyRef polyRef = polyRefs.isEmpty() ? 0 : polyRefs[i];
+    stepped[i] = tryStepWithQuery(starts[i], ends[i], allowSliding,
+                                  workerQuery(worker), polyRef);
+    if (!polyRefs.isEmpty())
+      polyRefs[i] = polyRef;
+  });
+}
+
+void PathFinder::Impl::excludeOffIslandPolys(const int islandIndex,
+                                             const bool exclude) {
+  if (islandIndex == ID_UNDEFINED)
+    return;
+  if (exclude) {
     // set the poly flag to identify polys not on the target island
     islandSystem_->setPolyFlagForIsland(
         navMesh_.get(), PolyFlags::POLYFLAGS_OFF_ISLAND, islandIndex,
         /*setFlag=*/true, /*invert=*/true);
     filter_->setExcludeFlags(filter_->getExcludeFlags() |
                              PolyFlags::POLYFLAGS_OFF_ISLAND);
-  }
-
-  dtStatus status = 0;
-  vec3f projectedPt;
-  std::tie(status, std::ignore, projectedPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-
-  // Clean up if this query was island specific
-  if (islandIndex != ID_UNDEFINED) {
+  } else {
     // reset the poly flag identifing polys off the target island
     islandSystem_->setPolyFlagForIsland(
         navMesh_.get(), PolyFlags::POLYFLAGS_OFF_ISLAND, islandIndex,
@@ -1671,6 +4033,66 @@ T PathFinder::Impl::snapPoint(const T& pt, int islandIndex /*=ID_UNDEFINED*/) {
     filter_->setExcludeFlags(filter_->getExcludeFlags() &
                              ~PolyFlags::POLYFLAGS_OFF_ISLAND);
   }
+}
+
+template <typename T>
+std::tuple<dtStatus, dtPolyRef, vec3f> PathFinder::Impl::projectToIsland(
+    const T& pt,
+    const int islandIndex,
+    const dtNavMeshQuery* query) const {
+  if (islandIndex == ID_UNDEFINED)
+    return projectToPoly(pt, query, filter_.get());
+
+  // same search box as projectToPoly()
+  constexpr float polyPickExt[3] = {2, 4, 2};
+  constexpr int MAX_POLYS = 512;
+  dtPolyRef polys[MAX_POLYS];
+  int numPolys = 0;
+  query->queryPolygons(pt.data(), polyPickExt, filter_.get(), polys,
+                       &numPolys, MAX_POLYS);
+
+  dtPolyRef nearestRef = 0;
+  vec3f nearestPt = vec3f::Constant(Mn::Constants::nan());
+  float nearestDistSqr = std::numeric_limits<float>::max();
+  for (int i = 0; i < numPolys; ++i) {
+    if (islandSystem_->findPolyIsland(polys[i]) != islandIndex)
+      continue;
+    vec3f closestPt;
+    bool posOverPoly = false;
+    query->closestPointOnPoly(polys[i], pt.data(), closestPt.data(),
+                              &posOverPoly);
+
+    // if the point is directly over a poly and closer than climb height,
+    // favor that instead of a straight line nearest point, like
+    // findNearestPoly() does
+    const vec3f diff = Eigen::Map<const vec3f>{pt.data()} - closestPt;
+    float distSqr = diff.squaredNorm();
+    if (posOverPoly) {
+      const dtMeshTile* tile = nullptr;
+      const dtPoly* poly = nullptr;
+      navMesh_->getTileAndPolyByRefUnsafe(polys[i], &tile, &poly);
+      const float d = std::abs(diff[1]) - tile->header->walkableClimb;
+      distSqr = d > 0 ? d * d : 0;
+    }
+    if (distSqr < nearestDistSqr) {
+      nearestDistSqr = distSqr;
+      nearestRef = polys[i];
+      nearestPt = closestPt;
+    }
+  }
+
+  return std::make_tuple(nearestRef ? DT_SUCCESS : DT_FAILURE, nearestRef,
+                         nearestPt);
+}
+
+template <typename T>
+T PathFinder::Impl::snapPoint(const T& pt, int islandIndex /*=ID_UNDEFINED*/) {
+  islandSystem_->assertValidIsland(islandIndex);
+
+  dtStatus status = 0;
+  vec3f projectedPt;
+  std::tie(status, std::ignore, projectedPt) =
+      projectToIsland(pt, islandIndex, threadQuery());
 
   if (dtStatusSucceed(status)) {
     return T{std::move(projectedPt)};
@@ -1678,20 +4100,72 @@ T PathFinder::Impl::snapPoint(const T& pt, int islandIndex /*=ID_UNDEFINED*/) {
   return {Mn::Constants::nan(), Mn::Constants::nan(), Mn::Constants::nan()};
 }
 
+void PathFinder::Impl::snapPoints(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<vec3f> snapped,
+    const int islandIndex,
+    int numThreads) {
+  ESP_CHECK(points.size() == snapped.size(),
+            "PathFinder::snapPoints(): got" << points.size() << "points but"
+                                            << snapped.size() << "outputs");
+  islandSystem_->assertValidIsland(islandIndex);
+  numThreads = core::resolveNumThreads(numThreads, points.size());
+  if (!initWorkerQueries(numThreads)) {
+    for (vec3f& pt : snapped) {
+      pt = vec3f::Constant(Mn::Constants::nan());
+    }
+    return;
+  }
+
+  core::parallelFor(points.size(), numThreads, [&](std::size_t i, int worker) {
+    dtStatus status = 0;
+    vec3f projectedPt;
+    std::tie(status, std::ignore, projectedPt) =
+        projectToIsland(points[i], islandIndex, workerQuery(worker));
+    snapped[i] = dtStatusSucceed(status)
+                     ? projectedPt
+                     : vec3f::Constant(Mn::Constants::nan());
+  });
+}
+
 template <typename T>
 int PathFinder::Impl::getIsland(const T& pt) const {
   dtStatus status = 0;
   vec3f projectedPt;
   dtPolyRef polyRef = 0;
   std::tie(status, polyRef, projectedPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, threadQuery(), filter_.get());
 
   if (dtStatusSucceed(status)) {
-    return islandSystem_->getPolyIsland(polyRef);
+    return islandSystem_->findPolyIsland(polyRef);
   }
   return ID_UNDEFINED;
 }
 
+void PathFinder::Impl::getIslands(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<int> islands,
+    int numThreads) {
+  ESP_CHECK(points.size() == islands.size(),
+            "PathFinder::getIslands(): got" << points.size() << "points but"
+                                            << islands.size() << "outputs");
+  numThreads = core::resolveNumThreads(numThreads, points.size());
+  if (!initWorkerQueries(numThreads)) {
+    std::fill(islands.begin(), islands.end(), ID_UNDEFINED);
+    return;
+  }
+
+  core::parallelFor(points.size(), numThreads, [&](std::size_t i, int worker) {
+    dtStatus status = 0;
+    dtPolyRef polyRef = 0;
+    std::tie(status, polyRef, std::ignore) =
+        projectToPoly(points[i], workerQuery(worker), filter_.get());
+    islands[i] = dtStatusSucceed(status)
+                     ? islandSystem_->findPolyIsland(polyRef)
+                     : ID_UNDEFINED;
+  });
+}
+
 float PathFinder::Impl::islandRadius(int islandIndex) const {
   return islandSystem_->islandRadius(islandIndex);
 }
@@ -1700,7 +4174,7 @@ float PathFinder::Impl::islandRadius(const vec3f& pt) const {
   dtPolyRef ptRef = 0;
   dtStatus status = 0;
   std::tie(status, ptRef, std::ignore) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, threadQuery(), filter_.get());
   if (status != DT_SUCCESS || ptRef == 0) {
     return 0.0;
   }
@@ -1710,36 +4184,74 @@ float PathFinder::Impl::islandRadius(const vec3f& pt) const {
 float PathFinder::Impl::distanceToClosestObstacle(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
+  // same height tolerance as the default of isNavigable()
+  constexpr float ObstacleFieldHeightTolerance = 0.5f;
+  float distance = 0.0f;
+  if (obstacleField_ &&
+      obstacleField_->lookup(pt, ObstacleFieldHeightTolerance, distance)) {
+    // the field saturates at its radius, beyond it only a search can tell
+    if (distance < obstacleField_->maxRadius() ||
+        maxSearchRadius <= obstacleField_->maxRadius())
+      return std::min(distance, maxSearchRadius);
+  }
   return closestObstacleSurfacePoint(pt, maxSearchRadius).hitDist;
 }
 
 HitRecord PathFinder::Impl::closestObstacleSurfacePoint(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
+  const dtNavMeshQuery* query = threadQuery();
   dtPolyRef ptRef = 0;
   dtStatus status = 0;
   vec3f polyPt;
   std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, query, filter_.get());
   if (status != DT_SUCCESS || ptRef == 0) {
     return {vec3f(0, 0, 0), vec3f(0, 0, 0),
             std::numeric_limits<float>::infinity()};
   }
   vec3f hitPos, hitNormal;
   float hitDist = Mn::Constants::nan();
-  navQuery_->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
-                                filter_.get(), &hitDist, hitPos.data(),
-                                hitNormal.data());
+  query->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
+                            filter_.get(), &hitDist, hitPos.data(),
+                            hitNormal.data());
   return {std::move(hitPos), std::move(hitNormal), hitDist};
 }
 
 bool PathFinder::Impl::isNavigable(const vec3f& pt,
                                    const float maxYDelta /*= 0.5*/) const {
+  return isNavigableWithQuery(pt, maxYDelta, threadQuery());
+}
+
+void PathFinder::Impl::areNavigable(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<bool> navigable,
+    const float maxYDelta,
+    int numThreads) {
+  ESP_CHECK(points.size() == navigable.size(),
+            "PathFinder::areNavigable(): got" << points.size() << "points but"
+                                              << navigable.size()
+                                              << "outputs");
+  numThreads = core::resolveNumThreads(numThreads, points.size());
+  if (!initWorkerQueries(numThreads)) {
+    std::fill(navigable.begin(), navigable.end(), false);
+    return;
+  }
+
+  core::parallelFor(points.size(), numThreads, [&](std::size_t i, int worker) {
+    navigable[i] = isNavigableWithQuery(points[i], maxYDelta,
+                                        workerQuery(worker));
+  });
+}
+
+bool PathFinder::Impl::isNavigableWithQuery(
+    const vec3f& pt,
+    const float maxYDelta,
+    const dtNavMeshQuery* query) const {
   dtPolyRef ptRef = 0;
   dtStatus status = 0;
   vec3f polyPt;
-  std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+  std::tie(status, ptRef, polyPt) = projectToPoly(pt, query, filter_.get());
 
   if (status != DT_SUCCESS || ptRef == 0)
     return false;
@@ -1753,11 +4265,10 @@ bool PathFinder::Impl::isNavigable(const vec3f& pt,
 }
 
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
+typedef Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> MatrixXi;
 
-Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-PathFinder::Impl::getTopDownView(const float metersPerPixel,
-                                 const float height,
-                                 const float eps) const {
+PathFinder::Impl::TopDownGrid PathFinder::Impl::topDownGrid(
+    const float metersPerPixel) const {
   std::pair<vec3f, vec3f> mapBounds = bounds();
   vec3f bound1 = std::move(mapBounds.first);
   vec3f bound2 = std::move(mapBounds.second);
@@ -1766,62 +4277,259 @@ PathFinder::Impl::getTopDownView(const float metersPerPixel,
   float zspan = std::abs(bound1[2] - bound2[2]);
   int xResolution = xspan / metersPerPixel;
   int zResolution = zspan / metersPerPixel;
-  float startx = fmin(bound1[0], bound2[0]);
-  float startz = fmin(bound1[2], bound2[2]);
-  MatrixXb topdownMap(zResolution, xResolution);
-
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; ++h) {
-    for (int w = 0; w < xResolution; ++w) {
-      vec3f point = vec3f(curx, height, curz);
-      topdownMap(h, w) = isNavigable(point, eps);
-      curx = curx + metersPerPixel;
-    }
+
+  // accumulate the coordinates instead of multiplying to sample exactly the
+  // same points as maps generated by earlier versions
+  TopDownGrid grid;
+  grid.xs.resize(xResolution);
+  grid.zs.resize(zResolution);
+  float curx = fmin(bound1[0], bound2[0]);
+  for (float& x : grid.xs) {
+    x = curx;
+    curx = curx + metersPerPixel;
+  }
+  float curz = fmin(bound1[2], bound2[2]);
+  for (float& z : grid.zs) {
+    z = curz;
     curz = curz + metersPerPixel;
-    curx = startx;
   }
+  return grid;
+}
 
-  return topdownMap;
+template <typename F>
+void PathFinder::Impl::sampleTopDown(const TopDownGrid& grid,
+                                     const float height,
+                                     int numThreads,
+                                     F&& func) {
+  numThreads = core::resolveNumThreads(numThreads, grid.zs.size());
+  // fall back to the main query if worker queries can't be allocated
+  if (!initWorkerQueries(numThreads)) {
+    numThreads = 1;
+  }
+  core::parallelFor(grid.zs.size(), numThreads, [&](std::size_t h, int worker) {
+    const dtNavMeshQuery* query = workerQuery(worker);
+    for (std::size_t w = 0; w < grid.xs.size(); ++w) {
+      func(h, w, vec3f(grid.xs[w], height, grid.zs[h]), query);
+    }
+  });
 }
 
-typedef Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> MatrixXi;
+void PathFinder::Impl::rasterizeTopDown(const TopDownGrid& grid,
+                                        const float height,
+                                        const int numThreads,
+                                        std::vector<dtPolyRef>& cellPolys,
+                                        std::vector<float>& cellDeltas) const {
+  const std::size_t numCols = grid.xs.size();
+  const std::size_t numRows = grid.zs.size();
+  cellPolys.assign(numRows * numCols, 0);
+  cellDeltas.assign(numRows * numCols, std::numeric_limits<float>::infinity());
+  if (numRows == 0 || numCols == 0)
+    return;
+
+  // vertical half extent of the findNearestPoly() search box in projectToPoly
+  constexpr float maxDelta = 4.0f;
+
+  struct RasterTriangle {
+    vec3f v[3];
+    dtPolyRef ref;
+    float climb;
+  };
+  std::vector<RasterTriangle> triangles;
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          !filter_->passFilter(ref, tile, poly))
+        continue;
+      for (const Triangle& tri : getPolygonTriangles(poly, tile)) {
+        const float minY = std::min({tri.v[0][1], tri.v[1][1], tri.v[2][1]});
+        const float maxY = std::max({tri.v[0][1], tri.v[1][1], tri.v[2][1]});
+        if (minY > height + maxDelta || maxY < height - maxDelta)
+          continue;
+        triangles.push_back(
+            {{tri.v[0], tri.v[1], tri.v[2]}, ref, tile->header->walkableClimb});
+      }
+    }
+  }
+
+  const float metersPerPixel =
+      numCols > 1 ? grid.xs[1] - grid.xs[0]
+                  : (numRows > 1 ? grid.zs[1] - grid.zs[0] : 1.0f);
+  // first sample at or after v, conservatively widened by one cell since the
+  // sample coordinates are accumulated
+  auto firstSample = [&](const std::vector<float>& samples, float v) {
+    const int i = static_cast<int>(
+        std::ceil((v - samples.front()) / metersPerPixel));
+    return std::max(0, std::min(i - 1, static_cast<int>(samples.size())));
+  };
+
+  // Rasterize bands of rows in parallel. Each band only writes its own cells.
+  const int numBands = std::min<std::size_t>(
+      numRows, core::resolveNumThreads(numThreads, numRows) * 4);
+  core::parallelFor(numBands, numThreads, [&](std::size_t band, int) {
+    const int rowBegin = numRows * band / numBands;
+    const int rowEnd = numRows * (band + 1) / numBands;
+    for (const RasterTriangle& tri : triangles) {
+      const float minZ = std::min({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+      const float maxZ = std::max({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+      if (maxZ < grid.zs[rowBegin] || minZ > grid.zs[rowEnd - 1])
+        continue;
+      const float minX = std::min({tri.v[0][0], tri.v[1][0], tri.v[2][0]});
+      const float maxX = std::max({tri.v[0][0], tri.v[1][0], tri.v[2][0]});
+
+      // barycentric setup in the XZ plane
+      const float e1x = tri.v[1][0] - tri.v[0][0];
+      const float e1z = tri.v[1][2] - tri.v[0][2];
+      const float e2x = tri.v[2][0] - tri.v[0][0];
+      const float e2z = tri.v[2][2] - tri.v[0][2];
+      const float denom = e1x * e2z - e2x * e1z;
+      if (std::abs(denom) < 1e-12f)
+        continue;
+      // inclusive edges so that cells on shared edges are covered
+      constexpr float edgeEps = 1e-4f;
+
+      const int rowFirst = std::max(rowBegin, firstSample(grid.zs, minZ));
+      const int colFirst = firstSample(grid.xs, minX);
+      for (int h = rowFirst; h < rowEnd && grid.zs[h] <= maxZ; ++h) {
+        for (std::size_t w = colFirst; w < numCols && grid.xs[w] <= maxX;
+             ++w) {
+          const float px = grid.xs[w] - tri.v[0][0];
+          const float pz = grid.zs[h] - tri.v[0][2];
+          const float u = (px * e2z - e2x * pz) / denom;
+          const float v = (e1x * pz - px * e1z) / denom;
+          if (u < -edgeEps || v < -edgeEps || u + v > 1.0f + edgeEps)
+            continue;
+
+          const float y = tri.v[0][1] + u * (tri.v[1][1] - tri.v[0][1]) +
+                          v * (tri.v[2][1] - tri.v[0][1]);
+          const float delta = std::abs(y - height);
+          if (delta > maxDelta)
+            continue;
+          // Same metric findNearestPoly() uses for points over a poly: all
+          // polys within climb height are equally near. Break those ties by
+          // the actual height difference.
+          const std::size_t cell = h * numCols + w;
+          const float dist = std::max(delta - tri.climb, 0.0f);
+          const float cellDist = std::max(cellDeltas[cell] - tri.climb, 0.0f);
+          if (cellPolys[cell] == 0 || dist < cellDist ||
+              (dist == cellDist && delta < cellDeltas[cell])) {
+            cellPolys[cell] = tri.ref;
+            cellDeltas[cell] = delta;
+          }
+        }
+      }
+    }
+  });
+}
+
+MatrixXb PathFinder::Impl::getTopDownView(const float metersPerPixel,
+                                          const float height,
+                                          const float eps,
+                                          const bool rasterize,
+                                          const int numThreads) {
+  const TopDownGrid grid = topDownGrid(metersPerPixel);
+  MatrixXb topdownMap(grid.zs.size(), grid.xs.size());
+
+  if (rasterize) {
+    std::vector<dtPolyRef> cellPolys;
+    std::vector<float> cellDeltas;
+    rasterizeTopDown(grid, height, numThreads, cellPolys, cellDeltas);
+    for (int h = 0; h < topdownMap.rows(); ++h) {
+      for (int w = 0; w < topdownMap.cols(); ++w) {
+        const std::size_t cell = h * grid.xs.size() + w;
+        topdownMap(h, w) = cellPolys[cell] != 0 && cellDeltas[cell] <= eps;
+      }
+    }
+    return topdownMap;
+  }
+
+  sampleTopDown(grid, height, numThreads,
+                [&](int h, int w, const vec3f& point,
+                    const dtNavMeshQuery* query) {
+                  topdownMap(h, w) = isNavigableWithQuery(point, eps, query);
+                });
+  return topdownMap;
+}
 
 MatrixXi PathFinder::Impl::getTopDownIslandView(const float metersPerPixel,
                                                 const float height,
-                                                const float eps) const {
-  std::pair<vec3f, vec3f> mapBounds = bounds();
-  vec3f bound1 = std::move(mapBounds.first);
-  vec3f bound2 = std::move(mapBounds.second);
-
-  float xspan = std::abs(bound1[0] - bound2[0]);
-  float zspan = std::abs(bound1[2] - bound2[2]);
-  int xResolution = xspan / metersPerPixel;
-  int zResolution = zspan / metersPerPixel;
-  float startx = fmin(bound1[0], bound2[0]);
-  float startz = fmin(bound1[2], bound2[2]);
-  MatrixXi topdownMap(zResolution, xResolution);
-
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; ++h) {
-    for (int w = 0; w < xResolution; ++w) {
-      vec3f point = vec3f(curx, height, curz);
-      if (isNavigable(point, eps)) {
-        // get the island
-        topdownMap(h, w) = getIsland(point);
-      } else {
-        topdownMap(h, w) = -1;
+                                                const float eps,
+                                                const bool rasterize,
+                                                const int numThreads) {
+  const TopDownGrid grid = topDownGrid(metersPerPixel);
+  MatrixXi topdownMap(grid.zs.size(), grid.xs.size());
+
+  if (rasterize) {
+    std::vector<dtPolyRef> cellPolys;
+    std::vector<float> cellDeltas;
+    rasterizeTopDown(grid, height, numThreads, cellPolys, cellDeltas);
+    for (int h = 0; h < topdownMap.rows(); ++h) {
+      for (int w = 0; w < topdownMap.cols(); ++w) {
+        const std::size_t cell = h * grid.xs.size() + w;
+        topdownMap(h, w) = cellPolys[cell] != 0 && cellDeltas[cell] <= eps
+                               ? islandSystem_->findPolyIsland(cellPolys[cell])
+                               : -1;
       }
-      curx = curx + metersPerPixel;
     }
-    curz = curz + metersPerPixel;
-    curx = startx;
+    return topdownMap;
   }
 
+  sampleTopDown(
+      grid, height, numThreads,
+      [&](int h, int w, const vec3f& point, const dtNavMeshQuery* query) {
+        if (isNavigableWithQuery(point, eps, query)) {
+          // get the island
+          dtPolyRef polyRef = 0;
+          std::tie(std::ignore, polyRef, std::ignore) =
+              projectToPoly(point, query, filter_.get());
+          topdownMap(h, w) = islandSystem_->findPolyIsland(polyRef);
+        } else {
+          topdownMap(h, w) = -1;
+        }
+      });
   return topdownMap;
 }
 
+std::vector<uint64_t> PathFinder::Impl::getNavMeshTileRevisions() const {
+  if (!isLoaded())
+    return {};
+  return tileRevisions_;
+}
+
+assets::MeshData::ptr PathFinder::Impl::getNavMeshTileData(
+    const int tileIndex) const {
+  if (!isLoaded())
+    return nullptr;
+  ESP_CHECK(tileIndex >= 0 && tileIndex < navMesh_->getMaxTiles(),
+            "PathFinder::getNavMeshTileData(): tile index"
+                << tileIndex << "out of range for" << navMesh_->getMaxTiles()
+                << "tile slots");
+  const dtMeshTile* tile =
+      const_cast<const dtNavMesh*>(navMesh_.get())->getTile(tileIndex);
+  if (!tile->header)
+    return nullptr;
+
+  assets::MeshData::ptr meshData = assets::MeshData::create();
+  for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+    const dtPoly* poly = &tile->polys[jPoly];
+    // off-mesh connections have no detail mesh
+    if (poly->getType() != DT_POLYTYPE_GROUND)
+      continue;
+    for (auto& tri : getPolygonTriangles(poly, tile)) {
+      for (int k = 0; k < 3; ++k) {
+        meshData->vbo.push_back(tri.v[k]);
+        meshData->ibo.push_back(meshData->vbo.size() - 1);
+      }
+    }
+  }
+  return meshData;
+}
+
 assets::MeshData::ptr PathFinder::Impl::getNavMeshData(
     int islandIndex /*= ID_UNDEFINED*/) {
   islandSystem_->assertValidIsland(islandIndex);
@@ -1889,11 +4597,48 @@ bool PathFinder::build(const NavMeshSettings& bs,
   return pimpl_->build(bs, mesh);
 }
 
+void PathFinder::setBuildTiling(const int tileSize, const int numThreads) {
+  pimpl_->setBuildTiling(tileSize, numThreads);
+}
+
+int PathFinder::getBuildTileSize() const {
+  return pimpl_->getBuildTileSize();
+}
+
+bool PathFinder::rebuildTiles(
+    const NavMeshSettings& bs,
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  return pimpl_->rebuildTiles(bs, mesh, regions);
+}
+
 vec3f PathFinder::getRandomNavigablePoint(const int maxTries /*= 10*/,
                                           int islandIndex /*= ID_UNDEFINED*/) {
   return pimpl_->getRandomNavigablePoint(maxTries, islandIndex);
 }
 
+std::vector<vec3f> PathFinder::getRandomNavigablePoints(
+    const int numPoints,
+    const int islandIndex,
+    const Cr::Containers::Optional<uint32_t>& seed,
+    const int numThreads) {
+  return pimpl_->getRandomNavigablePoints(numPoints, islandIndex, seed,
+                                          numThreads);
+}
+
+std::vector<vec3f> PathFinder::getRandomNavigablePointsAroundSphere(
+    const vec3f& circleCenter,
+    const float radius,
+    const int numPoints,
+    const int maxTries,
+    const int islandIndex,
+    const Cr::Containers::Optional<uint32_t>& seed,
+    const int numThreads) {
+  return pimpl_->getRandomNavigablePointsAroundSphere(
+      circleCenter, radius, numPoints, maxTries, islandIndex, seed,
+      numThreads);
+}
+
 vec3f PathFinder::getRandomNavigablePointAroundSphere(
     const vec3f& circleCenter,
     const float radius,
@@ -1911,6 +4656,54 @@ bool PathFinder::findPath(MultiGoalShortestPath& path) {
   return pimpl_->findPath(path);
 }
 
+int PathFinder::findPaths(Cr::Containers::ArrayView<ShortestPath> paths,
+                          const int numThreads) {
+  return pimpl_->findPaths(paths, numThreads);
+}
+
+std::vector<float> PathFinder::getGeodesicDistances(
+    const std::vector<vec3f>& starts,
+    const std::vector<vec3f>& ends,
+    const int numThreads) {
+  return pimpl_->getGeodesicDistances(starts, ends, numThreads);
+}
+
+bool PathFinder::buildDistanceOracle(const std::size_t maxMemoryBytes,
+                                     const int numThreads) {
+  return pimpl_->buildDistanceOracle(maxMemoryBytes, numThreads);
+}
+
+bool PathFinder::hasDistanceOracle() const {
+  return pimpl_->hasDistanceOracle();
+}
+
+float PathFinder::getOracleDistance(const vec3f& a, const vec3f& b) {
+  return pimpl_->getOracleDistance(a, b);
+}
+
+std::pair<float, float> PathFinder::getOracleDistanceBounds(
+    const vec3f& a,
+    const vec3f& b) const {
+  return pimpl_->getOracleDistanceBounds(a, b);
+}
+
+bool PathFinder::saveDistanceOracle(const std::string& path) const {
+  return pimpl_->saveDistanceOracle(path);
+}
+
+bool PathFinder::loadDistanceOracle(const std::string& path) {
+  return pimpl_->loadDistanceOracle(path);
+}
+
+bool PathFinder::buildGoalDistanceField(MultiGoalShortestPath& path) {
+  return pimpl_->buildGoalDistanceField(path);
+}
+
+float PathFinder::getGoalDistance(const MultiGoalShortestPath& path,
+                                  const vec3f& pt) const {
+  return pimpl_->getGoalDistance(path, pt);
+}
+
 template vec3f PathFinder::tryStep<vec3f>(const vec3f&, const vec3f&);
 template Mn::Vector3 PathFinder::tryStep<Mn::Vector3>(const Mn::Vector3&,
                                                       const Mn::Vector3&);
@@ -1930,6 +4723,15 @@ T PathFinder::tryStepNoSliding(const T& start, const T& end) {
   return pimpl_->tryStep(start, end, /*allowSliding=*/false);
 }
 
+void PathFinder::trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                          Cr::Containers::ArrayView<const vec3f> ends,
+                          Cr::Containers::ArrayView<vec3f> stepped,
+                          Cr::Containers::ArrayView<uint64_t> polyRefs,
+                          const bool allowSliding,
+                          const int numThreads) {
+  pimpl_->trySteps(starts, ends, stepped, polyRefs, allowSliding, numThreads);
+}
+
 template vec3f PathFinder::snapPoint<vec3f>(const vec3f& pt, int islandIndex);
 template Mn::Vector3 PathFinder::snapPoint<Mn::Vector3>(const Mn::Vector3& pt,
                                                         int islandIndex);
@@ -1947,10 +4749,34 @@ int PathFinder::getIsland(const T& pt) {
   return pimpl_->getIsland(pt);
 }
 
+void PathFinder::snapPoints(Cr::Containers::ArrayView<const vec3f> points,
+                            Cr::Containers::ArrayView<vec3f> snapped,
+                            const int islandIndex,
+                            const int numThreads) {
+  pimpl_->snapPoints(points, snapped, islandIndex, numThreads);
+}
+
+void PathFinder::getIslands(Cr::Containers::ArrayView<const vec3f> points,
+                            Cr::Containers::ArrayView<int> islands,
+                            const int numThreads) {
+  pimpl_->getIslands(points, islands, numThreads);
+}
+
+void PathFinder::areNavigable(Cr::Containers::ArrayView<const vec3f> points,
+                              Cr::Containers::ArrayView<bool> navigable,
+                              const float maxYDelta,
+                              const int numThreads) {
+  pimpl_->areNavigable(points, navigable, maxYDelta, numThreads);
+}
+
 bool PathFinder::loadNavMesh(const std::string& path) {
   return pimpl_->loadNavMesh(path);
 }
 
+bool PathFinder::loadNavMeshMapped(const std::string& path) {
+  return pimpl_->loadNavMeshMapped(path);
+}
+
 bool PathFinder::saveNavMesh(const std::string& path) {
   return pimpl_->saveNavMesh(path);
 }
@@ -1959,6 +4785,10 @@ bool PathFinder::isLoaded() const {
   return pimpl_->isLoaded();
 }
 
+std::size_t PathFinder::getNavMeshByteSize() const {
+  return pimpl_->getNavMeshByteSize();
+}
+
 void PathFinder::seed(uint32_t newSeed) {
   return pimpl_->seed(newSeed);
 }
@@ -1975,6 +4805,21 @@ int PathFinder::numIslands() const {
   return pimpl_->numIslands();
 }
 
+std::vector<IslandStatistics> PathFinder::islandStatistics() const {
+  return pimpl_->islandStatistics();
+}
+
+bool PathFinder::setObstacleDistanceField(const float metersPerCell,
+                                          const float maxRadius,
+                                          const int numThreads) {
+  return pimpl_->setObstacleDistanceField(metersPerCell, maxRadius,
+                                          numThreads);
+}
+
+bool PathFinder::hasObstacleDistanceField() const {
+  return pimpl_->hasObstacleDistanceField();
+}
+
 float PathFinder::distanceToClosestObstacle(const vec3f& pt,
                                             const float maxSearchRadius) const {
   return pimpl_->distanceToClosestObstacle(pt, maxSearchRadius);
@@ -2001,15 +4846,30 @@ std::pair<vec3f, vec3f> PathFinder::bounds() const {
 Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> PathFinder::getTopDownView(
     const float metersPerPixel,
     const float height,
-    const float eps) {
-  return pimpl_->getTopDownView(metersPerPixel, height, eps);
+    const float eps,
+    const bool rasterize,
+    const int numThreads) {
+  return pimpl_->getTopDownView(metersPerPixel, height, eps, rasterize,
+                                numThreads);
 }
 
 Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
 PathFinder::getTopDownIslandView(const float metersPerPixel,
                                  const float height,
-                                 const float eps) {
-  return pimpl_->getTopDownIslandView(metersPerPixel, height, eps);
+                                 const float eps,
+                                 const bool rasterize,
+                                 const int numThreads) {
+  return pimpl_->getTopDownIslandView(metersPerPixel, height, eps, rasterize,
+                                      numThreads);
+}
+
+std::vector<uint64_t> PathFinder::getNavMeshTileRevisions() const {
+  return pimpl_->getNavMeshTileRevisions();
+}
+
+assets::MeshData::ptr PathFinder::getNavMeshTileData(
+    const int tileIndex) const {
+  return pimpl_->getNavMeshTileData(tileIndex);
 }
 
 assets::MeshData::ptr PathFinder::getNavMeshData(
@@ -5,8 +5,11 @@
 #ifndef ESP_NAV_PATHFINDER_H_
 #define ESP_NAV_PATHFINDER_H_
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "esp/core/Esp.h"
@@ -36,6 +39,26 @@ struct HitRecord {
   float hitDist{};
 };
 
+/**
+ * @brief Precomputed properties of a NavMesh island, see @ref
+ * PathFinder::islandStatistics.
+ */
+struct IslandStatistics {
+  //! Walkable area of the island's polygons.
+  float area{};
+  //! Max distance of the island's polygon vertices from their mean, same as
+  //! @ref PathFinder::islandRadius.
+  float radius{};
+  //! Mean of the island's polygon vertices.
+  vec3f centroid;
+  //! Minimum corner of the axis aligned bounding box of the island.
+  vec3f boundsMin;
+  //! Maximum corner of the axis aligned bounding box of the island.
+  vec3f boundsMax;
+  //! Number of polygons in the island.
+  int numPolys{};
+};
+
 /**
  * @brief Struct for shortest path finding. Used in conjunction with @ref
  * PathFinder.findPath
@@ -113,6 +136,19 @@ struct MultiGoalShortestPath {
    */
   int closestEndPointIndex{};
 
+  /**
+   * @brief Use a single multi-target search instead of one search per end
+   * point.
+   *
+   * When enabled, @ref PathFinder.findPath runs one Dijkstra search from the
+   * start over the NavMesh polygon graph that terminates once the closest end
+   * point is settled, and then string-pulls the resulting corridor. This is
+   * much faster for large numbers of end points, but the closest end point is
+   * chosen by polygon portal distance, so in rare near-tie cases it can differ
+   * from the one found by exhaustive search.
+   */
+  bool useMultiTargetSearch{false};
+
   friend class PathFinder;
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(MultiGoalShortestPath)
@@ -328,6 +364,15 @@ bool operator!=(const NavMeshSettings& a, const NavMeshSettings& b);
  * surfaces of solid voxels where the cylinder would sit without intersection or
  * overhanging and respecting configured constraints such as maximum climbable
  * slope and step-height.
+ *
+ * The read-only queries @ref findPath, @ref tryStep, @ref tryStepNoSliding,
+ * @ref snapPoint, @ref getIsland, @ref isNavigable, @ref islandRadius, @ref
+ * distanceToClosestObstacle and @ref closestObstacleSurfacePoint can be called
+ * concurrently from several threads sharing one PathFinder, each thread gets
+ * its own Detour query on first use. All other methods, including the batched
+ * ones which parallelize internally, random point sampling and anything that
+ * builds, loads or modifies the NavMesh, must not run concurrently with any
+ * other call.
  */
 class PathFinder {
  public:
@@ -372,6 +417,55 @@ class PathFinder {
    */
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
+  /**
+   * @brief Configure tiled NavMesh construction for subsequent @ref build
+   * calls.
+   *
+   * With a tile size > 0, the navigable region is split into square tiles
+   * which are rasterized and built in parallel and then joined into one
+   * multi-tile Detour NavMesh. The @ref NavMeshSettings and the format
+   * written by @ref saveNavMesh are unchanged. Smaller tiles parallelize
+   * better but add polygon edges at tile borders.
+   *
+   * Detour addresses tiles and their polygons with 22 bits, so a NavMesh
+   * has at most 16384 tiles and fewer tiles leave room for more polygons per
+   * tile. @ref build fails with an error naming the minimum tile size if
+   * the tile size is too small for the scene.
+   *
+   * @param tileSize Tile edge length in cells (voxels of
+   * @ref NavMeshSettings.cellSize). <= 0 (default) builds a single tile.
+   * @param numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   */
+  void setBuildTiling(int tileSize, int numThreads = 0);
+
+  /**
+   * @brief The tile edge length in cells used by @ref build, <= 0 for a
+   * single-tile NavMesh.
+   */
+  int getBuildTileSize() const;
+
+  /**
+   * @brief Rebuild only the tiles of a tiled NavMesh affected by local scene
+   * changes and swap them into the loaded NavMesh.
+   *
+   * Requires a NavMesh built with @ref setBuildTiling and the same settings
+   * as @p bs. Tiles whose bounds (plus the erosion border) overlap any of @p
+   * regions are rebuilt from @p mesh, all other tiles are kept. Regions
+   * outside the original build bounds are clamped to the tile grid.
+   *
+   * @param bs Parameters for the NavMesh, must match the loaded NavMesh.
+   * @param mesh The full joined mesh of the updated scene.
+   * @param regions World space (min, max) bounds of the changed geometry,
+   * e.g. the old and new bounds of moved objects.
+   *
+   * @return Whether the tiles were rebuilt. On failure callers should fall
+   * back to a full @ref build.
+   */
+  bool rebuildTiles(const NavMeshSettings& bs,
+                    const esp::assets::MeshData& mesh,
+                    const std::vector<std::pair<vec3f, vec3f>>& regions);
+
   /**
    * @brief Returns a random navigable point.
    *
@@ -411,6 +505,64 @@ class PathFinder {
                                             int maxTries = 10,
                                             int islandIndex = ID_UNDEFINED);
 
+  /**
+   * @brief Returns a batch of random navigable points.
+   *
+   * Points are distributed uniformly over the navigable area like those of
+   * @ref getRandomNavigablePoint, but are drawn from an area-weighted table
+   * of the NavMesh triangles that is computed once per island, without
+   * rejection sampling.
+   *
+   *  @param[in] numPoints The number of points to sample.
+   *  @param[in] islandIndex Optionally specify the island from which to
+   * sample the points. Default -1 queries the full navmesh.
+   *  @param[in] seed Seed for the samples. The result only depends on the
+   * seed, not on @p numThreads. If not set, a seed is drawn from the
+   * generator set by @ref seed.
+   *  @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   *
+   * @return The sampled points.
+   */
+  std::vector<vec3f> getRandomNavigablePoints(
+      int numPoints,
+      int islandIndex = ID_UNDEFINED,
+      const Corrade::Containers::Optional<uint32_t>& seed =
+          Corrade::Containers::NullOpt,
+      int numThreads = 0);
+
+  /**
+   * @brief Returns a batch of random navigable points within a specified
+   * radius about a given point.
+   *
+   * Batched version of @ref getRandomNavigablePointAroundSphere sampling from
+   * the NavMesh triangles overlapping the sphere's bounds, see @ref
+   * getRandomNavigablePoints.
+   *
+   *  @param[in] circleCenter The center of the spherical sample region.
+   *  @param[in] radius The spherical sample radius.
+   *  @param[in] numPoints The number of points to sample.
+   *  @param[in] maxTries The maximum number of samples drawn per point before
+   * giving up on the point.
+   *  @param[in] islandIndex Optionally specify the island from which to
+   * sample the points. Default -1 queries the full navmesh.
+   *  @param[in] seed Seed for the samples. See @ref getRandomNavigablePoints.
+   *  @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   *
+   * @return The sampled points, `{NAN, NAN, NAN}` for points that couldn't be
+   * sampled.
+   */
+  std::vector<vec3f> getRandomNavigablePointsAroundSphere(
+      const vec3f& circleCenter,
+      float radius,
+      int numPoints,
+      int maxTries = 10,
+      int islandIndex = ID_UNDEFINED,
+      const Corrade::Containers::Optional<uint32_t>& seed =
+          Corrade::Containers::NullOpt,
+      int numThreads = 0);
+
   /**
    * @brief Finds the shortest path between two points on the navigation mesh
    *
@@ -444,6 +596,159 @@ class PathFinder {
    */
   bool findPath(MultiGoalShortestPath& path);
 
+  /**
+   * @brief Finds the shortest paths for a batch of start/end pairs in parallel.
+   *
+   * Equivalent to calling @ref findPath(ShortestPath&) on each element, but
+   * queries are distributed across worker threads, each with its own Detour
+   * query object, so throughput scales with the number of cores.
+   *
+   * Must not be called concurrently with methods that modify the NavMesh or
+   * its poly flags (e.g. island-specific sampling or snapping).
+   *
+   * @param[inout] paths The @ref ShortestPath structures to populate.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   *
+   * @return The number of paths for which a path exists.
+   */
+  int findPaths(Corrade::Containers::ArrayView<ShortestPath> paths,
+                int numThreads = 0);
+
+  /**
+   * @brief Computes the geodesic distances for a batch of start/end pairs in
+   * parallel.
+   *
+   * Same as @ref findPaths but only the distances are returned, avoiding the
+   * allocation of per-path point lists.
+   *
+   * @param[in] starts The starting points.
+   * @param[in] ends The ending points. Must have the same size as @p starts.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   *
+   * @return The geodesic distance for each pair. Will be inf for pairs with no
+   * path.
+   */
+  std::vector<float> getGeodesicDistances(const std::vector<vec3f>& starts,
+                                          const std::vector<vec3f>& ends,
+                                          int numThreads = 0);
+
+  /**
+   * @brief Precompute a geodesic distance oracle for the loaded NavMesh.
+   *
+   * Runs Dijkstra over the NavMesh polygon graph from a set of landmark
+   * polygons and stores the distance from each landmark to every polygon.
+   * If @p maxMemoryBytes allows a landmark for every walkable polygon, the
+   * table is all-pairs and @ref getOracleDistance is O(1). Otherwise
+   * landmarks are chosen by farthest-point sampling and queries cost
+   * O(number of landmarks) and return triangle inequality bounds.
+   *
+   * Distances are measured along polygon portal midpoints (the same cost model
+   * Detour uses), so they slightly overestimate the exact @ref findPath
+   * distance.
+   *
+   * The oracle is discarded when a NavMesh is loaded or built.
+   *
+   * @param[in] maxMemoryBytes Memory budget for the distance table.
+   * @param[in] numThreads The number of worker threads used for all-pairs
+   * construction. Values <= 0 use the hardware concurrency.
+   *
+   * @return Whether or not construction was successful.
+   */
+  bool buildDistanceOracle(std::size_t maxMemoryBytes = 64 * 1024 * 1024,
+                           int numThreads = 0);
+
+  /**
+   * @return If a distance oracle was built or loaded for the current NavMesh.
+   */
+  bool hasDistanceOracle() const;
+
+  /**
+   * @brief Approximate geodesic distance between two points from the
+   * precomputed oracle.
+   *
+   * Returns the upper bound of @ref getOracleDistanceBounds, falling back to
+   * @ref findPath if no landmark reaches both points. This is an
+   * approximation even for an all-pairs oracle: the table stores the
+   * distance between polygon centroids, and the offsets of the query points
+   * from the centroids are added to it. The result never undercuts the
+   * exact @ref findPath distance but may overestimate it. Use @ref findPath
+   * where exact distances are needed.
+   *
+   * @return The approximate distance, an upper bound. Will be inf if no path
+   * exists.
+   */
+  float getOracleDistance(const vec3f& a, const vec3f& b);
+
+  /**
+   * @brief Lower and upper bounds on the geodesic distance between two points
+   * from the precomputed oracle.
+   *
+   * @return The (lower, upper) bounds. Both are inf if the points are not
+   * connected or no oracle exists.
+   */
+  std::pair<float, float> getOracleDistanceBounds(const vec3f& a,
+                                                  const vec3f& b) const;
+
+  /**
+   * @brief Saves the distance oracle for later loading by @ref
+   * loadDistanceOracle.
+   *
+   * Intended to be stored alongside the ``.navmesh`` file, e.g. as
+   * ``<scene>.navmesh.oracle``.
+   *
+   * @return Whether or not the oracle was successfully saved
+   */
+  bool saveDistanceOracle(const std::string& path) const;
+
+  /**
+   * @brief Loads a distance oracle saved by @ref saveDistanceOracle.
+   *
+   * Fails if the oracle was computed for a different NavMesh. The file
+   * stores a checksum of the tile vertices, polygon refs and connectivity
+   * of the NavMesh it was built for, and the checksum has to match the
+   * current one.
+   *
+   * @return Whether or not the oracle was successfully loaded
+   */
+  bool loadDistanceOracle(const std::string& path);
+
+  /**
+   * @brief Precompute a geodesic distance-to-goal field for the requested end
+   * points of a @ref MultiGoalShortestPath.
+   *
+   * Runs a single multi-source Dijkstra over the NavMesh polygon graph from
+   * all goals and stores the per-polygon distance in @p path. Afterwards @ref
+   * getGoalDistance answers distance queries toward the goal set with a
+   * @ref snapPoint - like polygon lookup instead of a full path search, which
+   * is useful when repeatedly querying a fixed goal set (e.g. every step of an
+   * episode).
+   *
+   * The field is discarded by @ref MultiGoalShortestPath.setRequestedEnds and
+   * becomes invalid when a new NavMesh is loaded or built.
+   *
+   * @param[inout] path The goal set. The start point is ignored.
+   *
+   * @return Whether or not any goal could be projected to the NavMesh.
+   */
+  bool buildGoalDistanceField(MultiGoalShortestPath& path);
+
+  /**
+   * @brief Approximate geodesic distance from a point to the closest goal of
+   * a field built by @ref buildGoalDistanceField.
+   *
+   * The point is snapped to the NavMesh and the distance is interpolated from
+   * the field values at the entry points and portals of its polygon.
+   * Distances follow polygon portals like Detour's search, so they may
+   * slightly overestimate the exact @ref findPath distance.
+   *
+   * @return The distance, inf if no goal is reachable or no valid field was
+   * built.
+   */
+  float getGoalDistance(const MultiGoalShortestPath& path,
+                        const vec3f& pt) const;
+
   /**
    * @brief Attempts to move from @ref start to @ref end and returns the
    * navigable point closest to @ref end that is feasibly reachable from @ref
@@ -463,6 +768,34 @@ class PathFinder {
   template <typename T>
   T tryStepNoSliding(const T& start, const T& end);
 
+  /**
+   * @brief Step a batch of agents in parallel.
+   *
+   * Same as @ref tryStep (or @ref tryStepNoSliding) for each start / end pair.
+   * When the NavMesh poly of a start is already known, e.g. because it is the
+   * result of the previous step, the nearest poly search for it is skipped.
+   *
+   * @param[in] starts The starting locations.
+   * @param[in] ends The desired end locations. Must have the same size as @p
+   * starts.
+   * @param[out] stepped The found end locations. Must have the same size as
+   * @p starts.
+   * @param[in,out] polyRefs Optional opaque poly handles, one per start. A
+   * value of 0 means unknown. On return each holds the poly of the
+   * corresponding @p stepped point, so passing the same array back on the
+   * next step reuses them. Handles that are stale or don't lie under their
+   * start are ignored. Pass an empty view to always search.
+   * @param[in] allowSliding Whether to slide along walls as @ref tryStep does.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   */
+  void trySteps(Corrade::Containers::ArrayView<const vec3f> starts,
+                Corrade::Containers::ArrayView<const vec3f> ends,
+                Corrade::Containers::ArrayView<vec3f> stepped,
+                Corrade::Containers::ArrayView<uint64_t> polyRefs = nullptr,
+                bool allowSliding = true,
+                int numThreads = 0);
+
   /**
    * @brief Snaps a point to the navigation mesh.
    *
@@ -476,6 +809,23 @@ class PathFinder {
   template <typename T>
   T snapPoint(const T& pt, int islandIndex = ID_UNDEFINED);
 
+  /**
+   * @brief Snap a batch of points to the navigation mesh in parallel.
+   *
+   * Same as @ref snapPoint for each point.
+   *
+   * @param[in] points The points to snap.
+   * @param[out] snapped The snapped points, `{NAN, NAN, NAN}` where snapping
+   * failed. Must have the same size as @p points.
+   * @param[in] islandIndex Optionally specify the island to snap to.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   */
+  void snapPoints(Corrade::Containers::ArrayView<const vec3f> points,
+                  Corrade::Containers::ArrayView<vec3f> snapped,
+                  int islandIndex = ID_UNDEFINED,
+                  int numThreads = 0);
+
   /**
    * @brief Identifies the island closest to a point.
    *
@@ -494,10 +844,27 @@ class PathFinder {
   template <typename T>
   int getIsland(const T& pt);
 
+  /**
+   * @brief Query the islands of a batch of points in parallel.
+   *
+   * Same as @ref getIsland for each point.
+   *
+   * @param[in] points The points to query.
+   * @param[out] islands The island for each point or ID_UNDEFINED (-1) if
+   * failed. Must have the same size as @p points.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   */
+  void getIslands(Corrade::Containers::ArrayView<const vec3f> points,
+                  Corrade::Containers::ArrayView<int> islands,
+                  int numThreads = 0);
+
   /**
    * @brief Loads a navigation meshed saved by @ref saveNavMesh
    *
-   * Also imports serialized @ref NavMeshSettings if available.
+   * Also imports serialized @ref NavMeshSettings if available. If the file
+   * contains persisted islands they are restored instead of recomputing the
+   * connected components, island areas and radii.
    *
    * @param[in] path The saved navigation mesh file, generally has extension
    * ``.navmesh``
@@ -506,10 +873,29 @@ class PathFinder {
    */
   bool loadNavMesh(const std::string& path);
 
+  /**
+   * @brief Loads a navigation mesh saved by @ref saveNavMesh by memory
+   * mapping the file instead of copying its tiles.
+   *
+   * The tiles reference the file contents in place. The mapping is private
+   * and copy-on-write: pages Detour doesn't modify (vertices, detail meshes,
+   * bounding volume trees) stay shared with every other process mapping the
+   * same file, only pages holding polygon links and flags get copied on
+   * load. The file must not be modified while it is loaded. Falls back to
+   * @ref loadNavMesh on platforms without memory mapping.
+   *
+   * @param[in] path The saved navigation mesh file, generally has extension
+   * ``.navmesh``
+   *
+   * @return Whether or not the navmesh was successfully loaded
+   */
+  bool loadNavMeshMapped(const std::string& path);
+
   /**
    * @brief Saves a navigation mesh to later be loaded by @ref loadNavMesh
    *
-   * Also serializes @ref NavMeshSettings into the file.
+   * Also serializes @ref NavMeshSettings into the file, and the islands in an
+   * optional section after the tiles which older versions ignore.
    *
    * @param[in] path The name of the file, generally has extension ``.navmesh``
    *
@@ -522,6 +908,12 @@ class PathFinder {
    */
   bool isLoaded() const;
 
+  /**
+   * @return Size of the tiles of the loaded navigation mesh in bytes, 0 if
+   * none is loaded.
+   */
+  std::size_t getNavMeshByteSize() const;
+
   /**
    * @brief Seed the pathfinder.  Useful for @ref getRandomNavigablePoint
    *
@@ -561,6 +953,45 @@ class PathFinder {
    */
   int numIslands() const;
 
+  /**
+   * @brief Returns the precomputed properties of all connected components,
+   * indexed by island. Computed once per NavMesh and persisted in .navmesh
+   * files, so this is the cheap way to query many islands.
+   *
+   * @return One entry per island, empty if no NavMesh is loaded.
+   */
+  std::vector<IslandStatistics> islandStatistics() const;
+
+  /**
+   * @brief Precompute the distances to the closest obstacle on a grid, now
+   * and whenever a NavMesh is loaded or built.
+   *
+   * The distances are sampled by @ref closestObstacleSurfacePoint at every
+   * @p metersPerCell in X and Z, separately for each NavMesh layer crossing a
+   * grid point. Afterwards @ref distanceToClosestObstacle interpolates
+   * between the four grid points around the queried point, which is exact at
+   * the grid points and approximate in between. It falls back to the exact
+   * search next to obstacles and holes, where some of the four grid points
+   * are not on the NavMesh, if the point is not within 0.5 of a layer
+   * height, and if both the field and the query reach @p maxRadius.
+   *
+   * @param[in] metersPerCell The grid spacing. Values <= 0 discard the field
+   * and stop building it.
+   * @param[in] maxRadius The search radius the field is sampled with.
+   * @param[in] numThreads The number of worker threads used for the
+   * construction. Values <= 0 use the hardware concurrency.
+   *
+   * @return Whether a field was built for the current NavMesh.
+   */
+  bool setObstacleDistanceField(float metersPerCell,
+                                float maxRadius = 2.0f,
+                                int numThreads = 0);
+
+  /**
+   * @return If an obstacle distance field was built for the current NavMesh.
+   */
+  bool hasObstacleDistanceField() const;
+
   /**
    * @brief Finds the distance to the closest non-navigable location
    *
@@ -569,6 +1000,9 @@ class PathFinder {
    *
    * @return The distance to the closest non-navigable location or @ref
    * maxSearchRadius if all locations within @ref maxSearchRadius are navigable
+   *
+   * Interpolated from the field of @ref setObstacleDistanceField if there is
+   * one.
    */
   float distanceToClosestObstacle(const vec3f& pt,
                                   float maxSearchRadius = 2.0) const;
@@ -595,6 +1029,23 @@ class PathFinder {
    */
   bool isNavigable(const vec3f& pt, float maxYDelta = 0.5) const;
 
+  /**
+   * @brief Check a batch of points for navigability in parallel.
+   *
+   * Same as @ref isNavigable for each point.
+   *
+   * @param[in] points The points to check.
+   * @param[out] navigable Whether each point is navigable. Must have the same
+   * size as @p points.
+   * @param[in] maxYDelta The maximum y displacement. See @ref isNavigable.
+   * @param[in] numThreads The number of worker threads. Values <= 0 use the
+   * hardware concurrency.
+   */
+  void areNavigable(Corrade::Containers::ArrayView<const vec3f> points,
+                    Corrade::Containers::ArrayView<bool> navigable,
+                    float maxYDelta = 0.5,
+                    int numThreads = 0);
+
   /**
    * Compute and return the total area of all NavMesh polygons.
    *
@@ -624,11 +1075,21 @@ class PathFinder {
    * @param height The vertical height of the 2D slice.
    * @param eps Sets allowable epsilon meter Y offsets from the configured
    * height value.
+   * @param rasterize If true, rasterize the NavMesh polygon detail meshes into
+   * the grid instead of querying the NavMesh for every cell. Much faster for
+   * large maps, and the result matches the per-cell queries except for cells
+   * within a few millimeters of polygon boundaries.
+   * @param numThreads The number of worker threads processing rows. Values <=
+   * 0 use the hardware concurrency.
    *
    * @return The 2D grid marking cells as navigable or not.
    */
-  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownView(float metersPerPixel, float height, float eps = 0.5);
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
+      float metersPerPixel,
+      float height,
+      float eps = 0.5,
+      bool rasterize = false,
+      int numThreads = 0);
 
   /**
    * @brief Get a 2D grid marking island index for navigable cells and -1 for
@@ -641,11 +1102,19 @@ class PathFinder {
    * @param height The vertical height of the 2D slice.
    * @param eps Sets allowable epsilon meter Y offsets from the configured
    * height value.
+   * @param rasterize If true, rasterize the NavMesh polygons into the grid
+   * instead of querying the NavMesh for every cell. See @ref getTopDownView.
+   * @param numThreads The number of worker threads processing rows. Values <=
+   * 0 use the hardware concurrency.
    *
    * @return The 2D grid marking cell islands or -1 for not navigable.
    */
-  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownIslandView(float metersPerPixel, float height, float eps = 0.5);
+  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> getTopDownIslandView(
+      float metersPerPixel,
+      float height,
+      float eps = 0.5,
+      bool rasterize = false,
+      int numThreads = 0);
 
   /**
    * @brief Returns a MeshData object containing triangulated NavMesh polys.
@@ -663,6 +1132,34 @@ class PathFinder {
   std::shared_ptr<assets::MeshData> getNavMeshData(
       int islandIndex = ID_UNDEFINED);
 
+  /**
+   * @brief Returns the revision of the tile in each NavMesh tile slot.
+   *
+   * Empty slots have revision 0. A slot gets a new revision whenever its tile
+   * is replaced, by loading or building a NavMesh or by @ref rebuildTiles.
+   * Revisions are unique across all PathFinder instances, so comparing them
+   * with the ones from an earlier call tells which tiles changed in between,
+   * even if a different PathFinder was queried then.
+   *
+   * @return One revision per tile slot, empty if the PathFinder is not
+   * loaded.
+   */
+  std::vector<uint64_t> getNavMeshTileRevisions() const;
+
+  /**
+   * @brief Returns a MeshData object containing the triangulated polys of a
+   * single NavMesh tile, in the same layout as @ref getNavMeshData.
+   *
+   * Unlike @ref getNavMeshData, the result isn't cached.
+   *
+   * @param[in] tileIndex Index of the tile slot, see
+   * @ref getNavMeshTileRevisions.
+   *
+   * @return The triangulated tile polys or nullptr if the slot is empty or the
+   * PathFinder is not loaded.
+   */
+  std::shared_ptr<assets::MeshData> getNavMeshTileData(int tileIndex) const;
+
   /**
    * @brief Return the settings for the current NavMesh.
    */
@@ -11,6 +11,8 @@
  * JointMotorType, struct @ref JointMotorSettings
  */
 
+#include <Corrade/Containers/StridedArrayView.h>
+
 #include "RigidBase.h"
 #include "esp/core/Esp.h"
 #include "esp/metadata/URDFParser.h"
@@ -510,6 +512,81 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
    */
   virtual std::vector<float> getJointPositions() { return {}; }
 
+  /**
+   * @brief Get the number of degrees of freedom, which is the size of the
+   * joint force and velocity arrays.
+   */
+  virtual int getNumDoFs() const { return 0; }
+
+  /**
+   * @brief Get the number of joint position values, which is the size of the
+   * joint position array. Differs from @ref getNumDoFs() if the object has
+   * spherical joints.
+   */
+  virtual int getNumJointPositions() const { return 0; }
+
+  /**
+   * @brief Copy current forces/torques for all joints into a caller-provided
+   * view, without allocating.
+   *
+   * @param[out] forces Receives the joint forces/torques indexed by degrees of
+   * freedom. Expected to have @ref getNumDoFs() elements.
+   */
+  virtual void getJointForcesInto(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<float> forces) {}
+
+  /**
+   * @brief Set forces/torques for all joints from a caller-provided view.
+   *
+   * @param forces The desired joint forces/torques indexed by degrees of
+   * freedom. Expected to have @ref getNumDoFs() elements.
+   */
+  virtual void setJointForcesFrom(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          forces) {}
+
+  /**
+   * @brief Copy current velocities for all joints into a caller-provided
+   * view, without allocating.
+   *
+   * @param[out] vels Receives the joint velocities indexed by degrees of
+   * freedom. Expected to have @ref getNumDoFs() elements.
+   */
+  virtual void getJointVelocitiesInto(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<float> vels) {}
+
+  /**
+   * @brief Set velocities for all joints from a caller-provided view.
+   *
+   * @param vels The desired joint velocities indexed by degrees of freedom.
+   * Expected to have @ref getNumDoFs() elements.
+   */
+  virtual void setJointVelocitiesFrom(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          vels) {}
+
+  /**
+   * @brief Copy current positions for all joints into a caller-provided view,
+   * without allocating. See @ref getJointPositions() for the layout.
+   *
+   * @param[out] positions Receives the joint positions. Expected to have
+   * @ref getNumJointPositions() elements.
+   */
+  virtual void getJointPositionsInto(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<float> positions) {
+  }
+
+  /**
+   * @brief Set positions for all joints from a caller-provided view. See
+   * @ref setJointPositions() for the layout.
+   *
+   * @param positions The desired joint positions. Expected to have
+   * @ref getNumJointPositions() elements.
+   */
+  virtual void setJointPositionsFrom(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          positions) {}
+
   /**
    * @brief Get the torques on each joint
    *
@@ -819,6 +896,35 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
     ESP_ERROR() << "ERROR,SHOULD NOT BE CALLED WITHOUT BULLET";
   }
 
+  /**
+   * @brief Update the position targets, velocity targets and max impulses of
+   * all motors of this object from full length state arrays in one call.
+   *
+   * Position targets are indexed by joint position and velocity targets and
+   * max impulses by degree of freedom, each motor reading the values of its
+   * joint. The max impulse of a motor is taken from the first degree of
+   * freedom of its joint. An empty view leaves the corresponding setting of
+   * all motors unchanged, values for joints without motors are ignored.
+   *
+   * Note: No base implementation. See @ref BulletArticulatedObject.
+   *
+   * @param positionTargets Joint position targets, expected to be empty or
+   * have @ref getNumJointPositions() elements.
+   * @param velocityTargets Joint velocity targets, expected to be empty or
+   * have @ref getNumDoFs() elements.
+   * @param maxImpulses Motor max impulses, expected to be empty or have
+   * @ref getNumDoFs() elements.
+   */
+  virtual void setJointMotorTargetsFrom(
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          positionTargets,
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          velocityTargets,
+      CORRADE_UNUSED Corrade::Containers::StridedArrayView1D<const float>
+          maxImpulses) {
+    ESP_ERROR() << "ERROR,SHOULD NOT BE CALLED WITHOUT BULLET";
+  }
+
   //=========== END - Joint Motor API ===========
 
   //! map PhysicsManager objectId to local multibody linkId
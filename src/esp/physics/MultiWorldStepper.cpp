@@ -0,0 +1,29 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MultiWorldStepper.h"
+
+#include "PhysicsManager.h"
+
+namespace esp {
+namespace physics {
+
+MultiWorldStepper::MultiWorldStepper(int numThreads)
+    : threadPool_{numThreads} {}
+
+std::vector<double> MultiWorldStepper::stepWorlds(
+    const std::vector<PhysicsManager*>& worlds,
+    const double dt) {
+  std::vector<double> worldTimes(worlds.size(), NO_TIME);
+  threadPool_.parallelFor(worlds.size(), [&](std::size_t i, int) {
+    if (PhysicsManager* const world = worlds[i]) {
+      world->stepPhysics(dt);
+      worldTimes[i] = world->getWorldTime();
+    }
+  });
+  return worldTimes;
+}
+
+}  // namespace physics
+}  // namespace esp
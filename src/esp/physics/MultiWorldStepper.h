@@ -0,0 +1,71 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_MULTIWORLDSTEPPER_H_
+#define ESP_PHYSICS_MULTIWORLDSTEPPER_H_
+
+/** @file
+ * @brief Class @ref esp::physics::MultiWorldStepper
+ */
+
+#include <vector>
+
+#include "esp/core/Esp.h"
+#include "esp/core/ThreadPool.h"
+
+namespace esp {
+namespace physics {
+
+class PhysicsManager;
+
+/**
+ * @brief Steps several independent physics worlds concurrently.
+ *
+ * Each @ref PhysicsManager owns its own dynamics world, so worlds of different
+ * simulators in the same process can be stepped at the same time. The stepper
+ * keeps a @ref core::ThreadPool that's shared by all worlds and reused for
+ * every step. @ref stepWorlds() returns only once all worlds are stepped, so
+ * afterwards the state of every world is consistent and can be read from the
+ * calling thread.
+ *
+ * The worlds must not share any objects and must not be accessed from other
+ * threads while they're being stepped. Use
+ * @ref esp::sim::Simulator::stepWorlds() to step whole simulators, which
+ * additionally handles the deferred scene node updates.
+ */
+class MultiWorldStepper {
+ public:
+  /**
+   * @brief Constructor
+   * @param numThreads The number of threads stepping the worlds, including the
+   * calling thread. Values <= 0 select the hardware concurrency of the
+   * machine.
+   */
+  explicit MultiWorldStepper(int numThreads = 0);
+
+  /** @brief Number of threads stepping the worlds */
+  int numThreads() const { return threadPool_.numThreads(); }
+
+  /**
+   * @brief Step all @p worlds by @p dt
+   *
+   * Calls @ref PhysicsManager::stepPhysics() on every world, distributed over
+   * the thread pool, and waits for all of them to finish. Null entries are
+   * skipped.
+   * @return The world time of each of @p worlds after the step, or
+   * @ref esp::NO_TIME for null entries.
+   */
+  std::vector<double> stepWorlds(const std::vector<PhysicsManager*>& worlds,
+                                 double dt);
+
+  ESP_SMART_POINTERS(MultiWorldStepper)
+
+ private:
+  core::ThreadPool threadPool_;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_MULTIWORLDSTEPPER_H_
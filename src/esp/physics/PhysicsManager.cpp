@@ -5,9 +5,14 @@
 #include "PhysicsManager.h"
 #include <Magnum/Math/Range.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <utility>
 #include "esp/assets/CollisionMeshData.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
 #include "esp/metadata/managers/AOAttributesManager.h"
 #include "esp/metadata/managers/ObjectAttributesManager.h"
 #include "esp/metadata/managers/PhysicsAttributesManager.h"
@@ -15,6 +20,9 @@
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/sim/Simulator.h"
+
+namespace Cr = Corrade;
+
 namespace esp {
 namespace physics {
 
@@ -38,6 +46,7 @@ bool PhysicsManager::initPhysics(scene::SceneNode* node) {
 
   // Copy over relevant configuration
   fixedTimeStep_ = physicsManagerAttributes_->getTimestep();
+  setMaxSubsteps(physicsManagerAttributes_->getMaxSubsteps());
 
   //! Create new scene node and set up any physics-related variables
   // Overridden by specific physics-library-based class
@@ -142,6 +151,89 @@ int PhysicsManager::addObjectInstance(
            "aborted.";
     return ID_UNDEFINED;
   }
+  applyObjectInstanceAttributes(objAttributes, objInstAttributes);
+
+  return addObjectAndSaveAttributes(objAttributes, drawables, attachmentNode,
+                                    lightSetup, defaultCOMCorrection,
+                                    objInstAttributes);
+
+}  // PhysicsManager::addObjectInstance
+
+std::vector<int> PhysicsManager::addObjectInstances(
+    const std::vector<
+        esp::metadata::attributes::SceneObjectInstanceAttributes::cptr>&
+        objInstAttributes,
+    const std::vector<std::string>& attributesHandles,
+    bool defaultCOMCorrection,
+    DrawableGroup* drawables,
+    scene::SceneNode* attachmentNode,
+    const std::string& lightSetup) {
+  CORRADE_ASSERT(objInstAttributes.size() == attributesHandles.size(),
+                 "PhysicsManager::addObjectInstances : Expected one attributes "
+                 "handle per object instance but got"
+                     << attributesHandles.size() << "for"
+                     << objInstAttributes.size() << "instances.",
+                 {});
+  std::vector<int> objIDs(objInstAttributes.size(), ID_UNDEFINED);
+  if (objInstAttributes.empty()) {
+    return objIDs;
+  }
+  // acquire the context and drawable group once for the whole batch
+  if ((drawables == nullptr) && (simulator_ != nullptr)) {
+    simulator_->getRenderGLContext();
+    drawables = &simulator_->getDrawableGroup();
+  }
+
+  // resolve every distinct template, and instantiate its assets, up front.
+  // Templates that cannot be used map to nullptr.
+  auto objAttrMgr = resourceManager_.getObjectAttributesManager();
+  std::unordered_map<std::string,
+                     esp::metadata::attributes::ObjectAttributes::ptr>
+      templates;
+  for (std::size_t i = 0; i < attributesHandles.size(); ++i) {
+    const std::string& attributesHandle = attributesHandles[i];
+    if (templates.count(attributesHandle) > 0) {
+      continue;
+    }
+    auto objAttributes = objAttrMgr->getObjectCopyByHandle(attributesHandle);
+    if (!objAttributes) {
+      ESP_ERROR(Mn::Debug::Flag::NoSpace)
+          << "Missing/improperly configured ObjectAttributes '"
+          << attributesHandle << "', whose handle contains '"
+          << objInstAttributes[i]->getHandle()
+          << "' as specified in object instance attributes, so "
+             "addObjectInstances aborted for all of its instances.";
+    } else if (!resourceManager_.instantiateAssetsOnDemand(objAttributes)) {
+      ESP_ERROR() << "ResourceManager::instantiateAssetsOnDemand "
+                     "unsuccessful, so addObjectInstances aborted for all "
+                     "instances of `"
+                  << attributesHandle << "`.";
+      objAttributes = nullptr;
+    }
+    templates.emplace(attributesHandle, std::move(objAttributes));
+  }
+
+  for (std::size_t i = 0; i < objInstAttributes.size(); ++i) {
+    const auto& objTemplate = templates.at(attributesHandles[i]);
+    if (!objTemplate) {
+      continue;
+    }
+    // each instance edits its own copy of the shared template
+    auto objAttributes =
+        esp::metadata::attributes::ObjectAttributes::create(*objTemplate);
+    applyObjectInstanceAttributes(objAttributes, objInstAttributes[i]);
+    objIDs[i] = addObjectAndSaveAttributes(
+        objAttributes, drawables, attachmentNode, lightSetup,
+        defaultCOMCorrection, objInstAttributes[i]);
+  }
+  addObjectInstancesFinalize();
+  return objIDs;
+}  // PhysicsManager::addObjectInstances
+
+void PhysicsManager::applyObjectInstanceAttributes(
+    const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
+    const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+        objInstAttributes) const {
   // check if an object is being set to be not visible for a particular
   // instance.
   int visSet = objInstAttributes->getIsInstanceVisible();
@@ -177,12 +269,7 @@ int PhysicsManager::addObjectInstance(
   // set scaled mass
   objAttributes->setMass(objAttributes->getMass() *
                          objInstAttributes->getMassScale());
-
-  return addObjectAndSaveAttributes(objAttributes, drawables, attachmentNode,
-                                    lightSetup, defaultCOMCorrection,
-                                    objInstAttributes);
-
-}  // PhysicsManager::addObjectInstance
+}  // PhysicsManager::applyObjectInstanceAttributes
 
 int PhysicsManager::addObjectAndSaveAttributes(
     const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
@@ -593,6 +680,340 @@ void PhysicsManager::buildCurrentStateSceneAttributes(
 
 }  // PhysicsManager::buildCurrentStateSceneAttributes
 
+PhysicsStateSnapshot PhysicsManager::captureStateSnapshot() const {
+  PhysicsStateSnapshot snapshot;
+  snapshot.worldTime = worldTime_;
+  snapshot.rigidObjects.reserve(existingObjects_.size());
+  for (const auto& item : existingObjects_) {
+    const RigidObject& obj = *item.second;
+    snapshot.rigidObjects.push_back(
+        {item.first, obj.getTranslation(), obj.getRotation(),
+         obj.getMotionType(), obj.getLinearVelocity(),
+         obj.getAngularVelocity(), obj.isActive()});
+  }
+  snapshot.articulatedObjects.reserve(existingArticulatedObjects_.size());
+  for (const auto& item : existingArticulatedObjects_) {
+    ArticulatedObject& ao = *item.second;
+    snapshot.articulatedObjects.push_back(
+        {item.first, ao.getTranslation(), ao.getRotation(),
+         ao.getMotionType(), ao.getRootLinearVelocity(),
+         ao.getRootAngularVelocity(), ao.getJointPositions(),
+         ao.getJointVelocities(), ao.isActive()});
+  }
+  return snapshot;
+}  // PhysicsManager::captureStateSnapshot
+
+bool PhysicsManager::restoreStateSnapshot(
+    const PhysicsStateSnapshot& snapshot) {
+  // remove the objects added since the capture, both lists are sorted by ID
+  std::vector<int> addedObjectIds;
+  auto rigidIter = snapshot.rigidObjects.begin();
+  for (const auto& item : existingObjects_) {
+    while (rigidIter != snapshot.rigidObjects.end() &&
+           rigidIter->objectId < item.first) {
+      ++rigidIter;
+    }
+    if (rigidIter == snapshot.rigidObjects.end() ||
+        rigidIter->objectId != item.first) {
+      addedObjectIds.push_back(item.first);
+    }
+  }
+  for (const int objectId : addedObjectIds) {
+    removeObject(objectId);
+  }
+  addedObjectIds.clear();
+  auto aoIter = snapshot.articulatedObjects.begin();
+  for (const auto& item : existingArticulatedObjects_) {
+    while (aoIter != snapshot.articulatedObjects.end() &&
+           aoIter->objectId < item.first) {
+      ++aoIter;
+    }
+    if (aoIter == snapshot.articulatedObjects.end() ||
+        aoIter->objectId != item.first) {
+      addedObjectIds.push_back(item.first);
+    }
+  }
+  for (const int objectId : addedObjectIds) {
+    removeArticulatedObject(objectId);
+  }
+
+  bool restoredAll = true;
+  for (const PhysicsStateSnapshot::RigidObjectState& state :
+       snapshot.rigidObjects) {
+    auto objIter = existingObjects_.find(state.objectId);
+    if (objIter == existingObjects_.end()) {
+      ESP_WARNING() << "Rigid object" << state.objectId
+                    << "was removed since the snapshot, skipping it.";
+      restoredAll = false;
+      continue;
+    }
+    RigidObject& obj = *objIter->second;
+    // the motion type first, as kinematic objects ignore velocities
+    if (obj.getMotionType() != state.motionType) {
+      obj.setMotionType(state.motionType);
+    }
+    obj.setTranslation(state.translation);
+    obj.setRotation(state.rotation);
+    obj.setLinearVelocity(state.linearVelocity);
+    obj.setAngularVelocity(state.angularVelocity);
+    obj.setActive(state.isActive);
+  }
+  for (const PhysicsStateSnapshot::ArticulatedObjectState& state :
+       snapshot.articulatedObjects) {
+    auto existingIter = existingArticulatedObjects_.find(state.objectId);
+    if (existingIter == existingArticulatedObjects_.end()) {
+      ESP_WARNING() << "Articulated object" << state.objectId
+                    << "was removed since the snapshot, skipping it.";
+      restoredAll = false;
+      continue;
+    }
+    ArticulatedObject& ao = *existingIter->second;
+    if (ao.getMotionType() != state.motionType) {
+      ao.setMotionType(state.motionType);
+    }
+    ao.setTranslation(state.translation);
+    ao.setRotation(state.rotation);
+    ao.setJointPositions(state.jointPositions);
+    ao.setJointVelocities(state.jointVelocities);
+    ao.setRootLinearVelocity(state.rootLinearVelocity);
+    ao.setRootAngularVelocity(state.rootAngularVelocity);
+    ao.setActive(state.isActive);
+  }
+  worldTime_ = snapshot.worldTime;
+  return restoredAll;
+}  // PhysicsManager::restoreStateSnapshot
+
+namespace {
+// Bump when the layout below changes
+constexpr uint32_t PhysicsStateVersion = 1;
+
+// The blob is the header, followed by the rigid object records, the
+// articulated object records each followed by its joint positions and
+// velocities, and the constraint records. All record sizes are multiples of
+// 4, so the joint floats are aligned.
+struct PhysicsStateHeader {
+  uint32_t version;
+  uint32_t numRigidObjects;
+  uint32_t numArticulatedObjects;
+  uint32_t numConstraints;
+  double worldTime;
+};
+
+struct PhysicsStateRigidObject {
+  int32_t objectId;
+  uint32_t motionType;
+  uint32_t isActive;
+  Mn::Vector3 translation;
+  Mn::Quaternion rotation;
+  Mn::Vector3 linearVelocity;
+  Mn::Vector3 angularVelocity;
+};
+
+struct PhysicsStateArticulatedObject {
+  int32_t objectId;
+  uint32_t motionType;
+  uint32_t isActive;
+  uint32_t numJointPositions;
+  uint32_t numDoFs;
+  Mn::Vector3 translation;
+  Mn::Quaternion rotation;
+  Mn::Vector3 rootLinearVelocity;
+  Mn::Vector3 rootAngularVelocity;
+};
+
+struct PhysicsStateConstraint {
+  int32_t constraintId;
+  double maxImpulse;
+  Mn::Vector3 pivotA, pivotB;
+  Mn::Matrix3x3 frameA, frameB;
+};
+
+template <class T>
+void writeState(char*& out, const T& value) {
+  std::memcpy(out, &value, sizeof(T));
+  out += sizeof(T);
+}
+
+// returns false if there's not enough data left
+template <class T>
+bool readState(Cr::Containers::ArrayView<const char>& in, T& value) {
+  if (in.size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, in.data(), sizeof(T));
+  in = in.exceptPrefix(sizeof(T));
+  return true;
+}
+}  // namespace
+
+void PhysicsManager::saveState(std::vector<char>& state) const {
+  std::size_t size = sizeof(PhysicsStateHeader) +
+                     existingObjects_.size() * sizeof(PhysicsStateRigidObject) +
+                     rigidConstraintSettings_.size() *
+                         sizeof(PhysicsStateConstraint);
+  for (const auto& item : existingArticulatedObjects_) {
+    size += sizeof(PhysicsStateArticulatedObject) +
+            (item.second->getNumJointPositions() +
+             item.second->getNumDoFs()) *
+                sizeof(float);
+  }
+  state.resize(size);
+
+  char* out = state.data();
+  writeState(out, PhysicsStateHeader{
+                      PhysicsStateVersion, uint32_t(existingObjects_.size()),
+                      uint32_t(existingArticulatedObjects_.size()),
+                      uint32_t(rigidConstraintSettings_.size()), worldTime_});
+  for (const auto& item : existingObjects_) {
+    const RigidObject& obj = *item.second;
+    writeState(out, PhysicsStateRigidObject{
+                        item.first, uint32_t(obj.getMotionType()),
+                        obj.isActive(), obj.getTranslation(), obj.getRotation(),
+                        obj.getLinearVelocity(), obj.getAngularVelocity()});
+  }
+  for (const auto& item : existingArticulatedObjects_) {
+    ArticulatedObject& ao = *item.second;
+    const int numJointPositions = ao.getNumJointPositions();
+    const int numDoFs = ao.getNumDoFs();
+    writeState(out,
+               PhysicsStateArticulatedObject{
+                   item.first, uint32_t(ao.getMotionType()), ao.isActive(),
+                   uint32_t(numJointPositions), uint32_t(numDoFs),
+                   ao.getTranslation(), ao.getRotation(),
+                   ao.getRootLinearVelocity(), ao.getRootAngularVelocity()});
+    float* const joints = reinterpret_cast<float*>(out);
+    ao.getJointPositionsInto(
+        Cr::Containers::arrayView(joints, numJointPositions));
+    ao.getJointVelocitiesInto(
+        Cr::Containers::arrayView(joints + numJointPositions, numDoFs));
+    out += (numJointPositions + numDoFs) * sizeof(float);
+  }
+  for (const auto& item : rigidConstraintSettings_) {
+    const RigidConstraintSettings& settings = item.second;
+    writeState(out, PhysicsStateConstraint{
+                        item.first, settings.maxImpulse, settings.pivotA,
+                        settings.pivotB, settings.frameA, settings.frameB});
+  }
+  CORRADE_INTERNAL_ASSERT(out == state.data() + state.size());
+}  // PhysicsManager::saveState
+
+bool PhysicsManager::restoreState(Cr::Containers::ArrayView<const char> state) {
+  // validate everything before changing anything
+  Cr::Containers::ArrayView<const char> in = state;
+  PhysicsStateHeader header;
+  if (!readState(in, header) || header.version != PhysicsStateVersion ||
+      header.numRigidObjects != existingObjects_.size() ||
+      header.numArticulatedObjects != existingArticulatedObjects_.size() ||
+      header.numConstraints != rigidConstraintSettings_.size()) {
+    ESP_ERROR() << "The state doesn't match the objects of the world.";
+    return false;
+  }
+  const char* const rigidBegin = in.data();
+  PhysicsStateRigidObject rigid;
+  for (const auto& item : existingObjects_) {
+    if (!readState(in, rigid) || rigid.objectId != item.first) {
+      ESP_ERROR() << "The state doesn't match the rigid objects of the world.";
+      return false;
+    }
+  }
+  const char* const aoBegin = in.data();
+  PhysicsStateArticulatedObject ao;
+  for (const auto& item : existingArticulatedObjects_) {
+    if (!readState(in, ao) || ao.objectId != item.first ||
+        int(ao.numJointPositions) != item.second->getNumJointPositions() ||
+        int(ao.numDoFs) != item.second->getNumDoFs() ||
+        in.size() < (ao.numJointPositions + ao.numDoFs) * sizeof(float)) {
+      ESP_ERROR()
+          << "The state doesn't match the articulated objects of the world.";
+      return false;
+    }
+    in = in.exceptPrefix((ao.numJointPositions + ao.numDoFs) * sizeof(float));
+  }
+  const char* const constraintBegin = in.data();
+  PhysicsStateConstraint constraint;
+  for (std::size_t i = 0; i != header.numConstraints; ++i) {
+    if (!readState(in, constraint) ||
+        rigidConstraintSettings_.count(constraint.constraintId) == 0) {
+      ESP_ERROR() << "The state doesn't match the constraints of the world.";
+      return false;
+    }
+  }
+  if (!in.isEmpty()) {
+    ESP_ERROR() << "The state has" << in.size() << "unexpected trailing bytes.";
+    return false;
+  }
+
+  in = state.exceptPrefix(rigidBegin - state.data());
+  for (const auto& item : existingObjects_) {
+    readState(in, rigid);
+    RigidObject& obj = *item.second;
+    // the motion type first, as kinematic objects ignore velocities
+    if (obj.getMotionType() != MotionType(rigid.motionType)) {
+      obj.setMotionType(MotionType(rigid.motionType));
+    }
+    obj.setTranslation(rigid.translation);
+    obj.setRotation(rigid.rotation);
+    obj.setLinearVelocity(rigid.linearVelocity);
+    obj.setAngularVelocity(rigid.angularVelocity);
+    obj.setActive(rigid.isActive);
+  }
+  CORRADE_INTERNAL_ASSERT(in.data() == aoBegin);
+  for (const auto& item : existingArticulatedObjects_) {
+    readState(in, ao);
+    ArticulatedObject& obj = *item.second;
+    if (obj.getMotionType() != MotionType(ao.motionType)) {
+      obj.setMotionType(MotionType(ao.motionType));
+    }
+    obj.setTranslation(ao.translation);
+    obj.setRotation(ao.rotation);
+    const float* const joints = reinterpret_cast<const float*>(in.data());
+    obj.setJointPositionsFrom(
+        Cr::Containers::arrayView(joints, ao.numJointPositions));
+    obj.setJointVelocitiesFrom(
+        Cr::Containers::arrayView(joints + ao.numJointPositions, ao.numDoFs));
+    obj.setRootLinearVelocity(ao.rootLinearVelocity);
+    obj.setRootAngularVelocity(ao.rootAngularVelocity);
+    obj.setActive(ao.isActive);
+    in = in.exceptPrefix((ao.numJointPositions + ao.numDoFs) * sizeof(float));
+  }
+  CORRADE_INTERNAL_ASSERT(in.data() == constraintBegin);
+  for (std::size_t i = 0; i != header.numConstraints; ++i) {
+    readState(in, constraint);
+    RigidConstraintSettings settings =
+        rigidConstraintSettings_.at(constraint.constraintId);
+    // most constraints stay unchanged between saving and restoring
+    if (settings.maxImpulse != constraint.maxImpulse ||
+        settings.pivotA != constraint.pivotA ||
+        settings.pivotB != constraint.pivotB ||
+        settings.frameA != constraint.frameA ||
+        settings.frameB != constraint.frameB) {
+      settings.maxImpulse = constraint.maxImpulse;
+      settings.pivotA = constraint.pivotA;
+      settings.pivotB = constraint.pivotB;
+      settings.frameA = constraint.frameA;
+      settings.frameB = constraint.frameB;
+      updateRigidConstraint(constraint.constraintId, settings);
+    }
+  }
+  worldTime_ = header.worldTime;
+  return true;
+}  // PhysicsManager::restoreState
+
+namespace {
+// the tube can't follow a trajectory through repeated points
+std::vector<Mn::Vector3> dedupTrajectoryPoints(
+    const std::vector<Mn::Vector3>& pts) {
+  std::vector<Mn::Vector3> uniquePts;
+  uniquePts.push_back(pts[0]);
+  for (const auto& loc : pts) {
+    if (loc != uniquePts.back()) {
+      uniquePts.push_back(loc);
+    }
+  }
+  return uniquePts;
+}
+}  // namespace
+
 int PhysicsManager::addTrajectoryObject(const std::string& trajVisName,
                                         const std::vector<Mn::Vector3>& pts,
                                         const std::vector<Mn::Color3>& colorVec,
@@ -606,13 +1027,7 @@ int PhysicsManager::addTrajectoryObject(const std::string& trajVisName,
     simulator_->getRenderGLContext();
   }
   // 0. Deduplicate sequential points
-  std::vector<Magnum::Vector3> uniquePts;
-  uniquePts.push_back(pts[0]);
-  for (const auto& loc : pts) {
-    if (loc != uniquePts.back()) {
-      uniquePts.push_back(loc);
-    }
-  }
+  std::vector<Magnum::Vector3> uniquePts = dedupTrajectoryPoints(pts);
 
   // 1. create trajectory tube asset from points and save it
   bool success = resourceManager_.buildTrajectoryVisualization(
@@ -622,6 +1037,49 @@ int PhysicsManager::addTrajectoryObject(const std::string& trajVisName,
                 << trajVisName << "so addTrajectoryObject aborted.";
     return ID_UNDEFINED;
   }
+  return addTrajectoryObjectInternal(trajVisName, drawables);
+}  // PhysicsManager::addTrajectoryObject (vector of colors)
+
+int PhysicsManager::addTrajectoryObjects(
+    const std::string& trajVisName,
+    const std::vector<std::vector<Mn::Vector3>>& trajectories,
+    const std::vector<std::vector<Mn::Color3>>& colorVecs,
+    int numSegments,
+    float radius,
+    bool smooth,
+    int numInterp,
+    int numThreads,
+    DrawableGroup* drawables) {
+  if (simulator_ != nullptr) {
+    // acquire context if available
+    simulator_->getRenderGLContext();
+  }
+  // 0. Deduplicate sequential points of each trajectory
+  std::vector<std::vector<Mn::Vector3>> uniqueTrajectories;
+  uniqueTrajectories.reserve(trajectories.size());
+  for (const auto& pts : trajectories) {
+    if (pts.empty()) {
+      ESP_ERROR() << "Cannot build an empty trajectory for" << trajVisName
+                  << "so addTrajectoryObjects aborted.";
+      return ID_UNDEFINED;
+    }
+    uniqueTrajectories.push_back(dedupTrajectoryPoints(pts));
+  }
+
+  // 1. create one asset holding the tubes of all trajectories and save it
+  bool success = resourceManager_.buildTrajectoryVisualization(
+      trajVisName, uniqueTrajectories, colorVecs, numSegments, radius, smooth,
+      numInterp, numThreads);
+  if (!success) {
+    ESP_ERROR() << "Failed to create Trajectory visualization mesh for"
+                << trajVisName << "so addTrajectoryObjects aborted.";
+    return ID_UNDEFINED;
+  }
+  return addTrajectoryObjectInternal(trajVisName, drawables);
+}  // PhysicsManager::addTrajectoryObjects
+
+int PhysicsManager::addTrajectoryObjectInternal(const std::string& trajVisName,
+                                                DrawableGroup* drawables) {
   // 2. create object attributes for the trajectory
   auto objAttrMgr = resourceManager_.getObjectAttributesManager();
   auto trajObjAttr = objAttrMgr->createObject(trajVisName, false);
@@ -658,7 +1116,7 @@ int PhysicsManager::addTrajectoryObject(const std::string& trajVisName,
 
   return trajVisID;
 
-}  // PhysicsManager::addTrajectoryObject (vector of colors)
+}  // PhysicsManager::addTrajectoryObjectInternal
 
 esp::physics::ManagedRigidObject::ptr PhysicsManager::getRigidObjectWrapper() {
   return rigidObjectManager_->createObject("ManagedRigidObject");
@@ -765,6 +1223,32 @@ void PhysicsManager::setTimestep(double dt) {
   fixedTimeStep_ = dt;
 }
 
+void PhysicsManager::setMaxSubsteps(int maxSubsteps) {
+  ESP_CHECK(maxSubsteps > 0,
+            "PhysicsManager::setMaxSubsteps(): expected a positive substep "
+            "count but got"
+                << maxSubsteps);
+  maxSubsteps_ = maxSubsteps;
+}
+
+void PhysicsManager::recordSubsteps(int numSubstepsRequested,
+                                    int numSubstepsTaken) {
+  lastStepProfile_.numSubstepsRequested = numSubstepsRequested;
+  lastStepProfile_.numSubstepsTaken = numSubstepsTaken;
+  const int numDropped = numSubstepsRequested - numSubstepsTaken;
+  if (numDropped <= 0) {
+    return;
+  }
+  if (lastStepProfile_.numSubstepsDroppedTotal == 0) {
+    ESP_WARNING() << "Step required" << numSubstepsRequested
+                  << "substeps but max_substeps is" << maxSubsteps_
+                  << Mn::Debug::nospace << ", dropping" << numDropped
+                  << "substeps. Further drops are only counted in the step "
+                     "profile.";
+  }
+  lastStepProfile_.numSubstepsDroppedTotal += numDropped;
+}
+
 void PhysicsManager::setGravity(const Magnum::Vector3&) {
   // Can't do this for kinematic simulator
 }
@@ -774,6 +1258,7 @@ Magnum::Vector3 PhysicsManager::getGravity() const {
 }
 
 void PhysicsManager::stepPhysics(double dt) {
+  ESP_TRACE_SCOPE("stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -786,10 +1271,14 @@ void PhysicsManager::stepPhysics(double dt) {
     dt = fixedTimeStep_;
   }
 
+  const auto start = std::chrono::steady_clock::now();
+
   // handle in-between step times? Ideally dt is a multiple of
   // sceneMetaData_.timestep
   double targetTime = worldTime_ + dt;
-  while (worldTime_ < targetTime) {
+  const int numSubstepsRequested = int(std::ceil(dt / fixedTimeStep_));
+  int numSubstepsTaken = 0;
+  while (worldTime_ < targetTime && numSubstepsTaken < maxSubsteps_) {
     // per fixed-step operations can be added here
 
     // kinematic velocity control integration
@@ -801,6 +1290,69 @@ void PhysicsManager::stepPhysics(double dt) {
       }
     }
     worldTime_ += fixedTimeStep_;
+    ++numSubstepsTaken;
+  }
+
+  recordSubsteps(std::max(numSubstepsRequested, numSubstepsTaken),
+                 numSubstepsTaken);
+  lastStepProfile_.stepMs = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+}
+
+void PhysicsManager::castRays(
+    Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+    CORRADE_UNUSED double maxDistance,
+    Cr::Containers::ArrayView<RayHitInfo> closestHits,
+    CORRADE_UNUSED int numThreads) {
+  ESP_CHECK(closestHits.size() == rays.size(),
+            "PhysicsManager::castRays(): expected" << rays.size()
+                                                   << "hits but got"
+                                                   << closestHits.size());
+  ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                 "--bullet to use this feature.";
+  for (RayHitInfo& hit : closestHits) {
+    hit = RayHitInfo{};
+    hit.objectId = ID_UNDEFINED;
+    hit.rayDistance = -1.0;
+  }
+}
+
+void PhysicsManager::contactTestRigidObjectPoses(
+    CORRADE_UNUSED int physObjectID,
+    Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+    Cr::Containers::ArrayView<bool> inContact) {
+  ESP_CHECK(inContact.size() == poses.size(),
+            "PhysicsManager::contactTestRigidObjectPoses(): expected"
+                << poses.size() << "results but got" << inContact.size());
+  ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                 "--bullet to use this feature.";
+  for (bool& contact : inContact) {
+    contact = false;
+  }
+}
+
+void PhysicsManager::contactTestArticulatedObjectJointPositions(
+    CORRADE_UNUSED int physObjectID,
+    const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+    Cr::Containers::ArrayView<bool> inContact) {
+  ESP_CHECK(inContact.size() == jointPositions.size()[0],
+            "PhysicsManager::contactTestArticulatedObjectJointPositions(): "
+            "expected"
+                << jointPositions.size()[0] << "results but got"
+                << inContact.size());
+  ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                 "--bullet to use this feature.";
+  for (bool& contact : inContact) {
+    contact = false;
+  }
+}
+
+void PhysicsManager::setArticulatedObjectsJointPositions(
+    Cr::Containers::ArrayView<const int> objectIDs,
+    const Cr::Containers::StridedArrayView2D<const float>& positions) {
+  for (std::size_t i = 0; i != objectIDs.size(); ++i) {
+    getArticulatedObject(objectIDs[i]).setJointPositionsFrom(positions[i]);
   }
 }
 
@@ -812,11 +1364,16 @@ void PhysicsManager::deferNodesUpdate() {
 }
 
 void PhysicsManager::updateNodes() {
+  const auto start = std::chrono::steady_clock::now();
   for (auto& o : existingObjects_)
     o.second->updateNodes();
 
   for (auto& ao : existingArticulatedObjects_)
     ao.second->updateNodes();
+  lastStepProfile_.updateNodesMs =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start)
+          .count();
 }
 
 //! Profile function. In BulletPhysics stationary objects are
@@ -7,9 +7,13 @@
 
 /** @file
  * @brief Class @ref PhysicsManager, enum @ref
- * PhysicsManager::PhysicsSimulationLibrary
+ * PhysicsManager::PhysicsSimulationLibrary, struct @ref PhysicsStepProfile,
+ * @ref PhysicsStateSnapshot
  */
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -175,9 +179,98 @@ struct RigidConstraintSettings {
    */
   Mn::Matrix3x3 frameA{}, frameB{};
 
+  /** @brief Whether the constraint is applied. Toggling this through an
+   * update is cheaper than removing the constraint and creating it again.
+   */
+  bool enabled = true;
+
   ESP_SMART_POINTERS(RigidConstraintSettings)
 };  // struct RigidConstraintSettings
 
+/**
+ * @brief Substep counts and wall-clock timings of the most recent
+ * @ref PhysicsManager::stepPhysics() and @ref PhysicsManager::updateNodes()
+ * calls. All times are in milliseconds. Phases the physics implementation
+ * doesn't measure stay at zero.
+ */
+struct PhysicsStepProfile {
+  /** @brief Number of fixed substeps the requested step duration called for.
+   */
+  int numSubstepsRequested = 0;
+
+  /** @brief Number of fixed substeps taken, at most
+   * @ref PhysicsManager::getMaxSubsteps(). */
+  int numSubstepsTaken = 0;
+
+  /** @brief Substeps dropped because of the cap over the lifetime of the
+   * world. */
+  int numSubstepsDroppedTotal = 0;
+
+  /** @brief Total time spent in the step. */
+  double stepMs = 0.0;
+
+  /** @brief Time spent updating bounding boxes and finding overlapping pairs.
+   */
+  double broadphaseMs = 0.0;
+
+  /** @brief Time spent computing contacts of overlapping pairs. */
+  double narrowphaseMs = 0.0;
+
+  /** @brief Time spent solving contacts and constraints. */
+  double solverMs = 0.0;
+
+  /** @brief Time spent syncing the simulation state to the scene graph. */
+  double updateNodesMs = 0.0;
+
+  /** @brief Articulated objects whose scene graph sync was skipped because
+   * they are asleep and unchanged since their last sync. */
+  int numArticulatedObjectSyncsSkipped = 0;
+
+  ESP_SMART_POINTERS(PhysicsStepProfile)
+};  // struct PhysicsStepProfile
+
+/**
+ * @brief The state of the objects of a physical world, captured by @ref
+ * PhysicsManager::captureStateSnapshot() and put back in place by @ref
+ * PhysicsManager::restoreStateSnapshot().
+ */
+struct PhysicsStateSnapshot {
+  /** @brief State of a rigid object */
+  struct RigidObjectState {
+    int objectId;
+    Magnum::Vector3 translation;
+    Magnum::Quaternion rotation;
+    MotionType motionType;
+    Magnum::Vector3 linearVelocity;
+    Magnum::Vector3 angularVelocity;
+    bool isActive;
+  };
+
+  /** @brief State of an articulated object */
+  struct ArticulatedObjectState {
+    int objectId;
+    Magnum::Vector3 translation;
+    Magnum::Quaternion rotation;
+    MotionType motionType;
+    Magnum::Vector3 rootLinearVelocity;
+    Magnum::Vector3 rootAngularVelocity;
+    std::vector<float> jointPositions;
+    std::vector<float> jointVelocities;
+    bool isActive;
+  };
+
+  /** @brief World time when the state was captured */
+  double worldTime = 0.0;
+
+  /** @brief State of each rigid object, ordered by ID */
+  std::vector<RigidObjectState> rigidObjects;
+
+  /** @brief State of each articulated object, ordered by ID */
+  std::vector<ArticulatedObjectState> articulatedObjects;
+
+  ESP_SMART_POINTERS(PhysicsStateSnapshot)
+};  // struct PhysicsStateSnapshot
+
 class RigidObjectManager;
 class ArticulatedObjectManager;
 
@@ -319,6 +412,37 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
       scene::SceneNode* attachmentNode = nullptr,
       const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
 
+  /**
+   * @brief Instance and place a batch of physics objects, as @ref
+   * addObjectInstance does for each of them. Each distinct object attributes
+   * template is retrieved and has its assets instantiated only once, and
+   * dynamics-library-specific bookkeeping, such as rebuilding the collision
+   * broadphase, happens once after all objects have been added.
+   * @param objInstAttributes The attributes that describe the desired state
+   * of each object.
+   * @param attributesHandles The handle of the object attributes to use for
+   * each object, matching @p objInstAttributes.
+   * @param defaultCOMCorrection The default value of whether COM-based
+   * translation correction needs to occur.
+   * @param drawables Reference to the scene graph drawables group to enable
+   * rendering of the newly initialized objects. If nullptr, will attempt to
+   * query Simulator to retrieve a group.
+   * @param attachmentNode If supplied, attach the new physical objects to an
+   * existing SceneNode.
+   * @param lightSetup The string name of the desired lighting setup to use.
+   * @return the instanced objects' IDs, with @ref esp::ID_UNDEFINED for each
+   * object that failed to instance.
+   */
+  std::vector<int> addObjectInstances(
+      const std::vector<
+          esp::metadata::attributes::SceneObjectInstanceAttributes::cptr>&
+          objInstAttributes,
+      const std::vector<std::string>& attributesHandles,
+      bool defaultCOMCorrection = false,
+      DrawableGroup* drawables = nullptr,
+      scene::SceneNode* attachmentNode = nullptr,
+      const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
+
   /** @brief Instance a physical object from an object properties template in
    * the @ref esp::metadata::managers::ObjectAttributesManager.  This method
    * will query for a drawable group from simulator.
@@ -570,6 +694,12 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual void updateNodes();
 
+  /** @brief Substep counts and timings of the most recent @ref stepPhysics()
+   * and @ref updateNodes() calls. */
+  const PhysicsStepProfile& getLastStepProfile() const {
+    return lastStepProfile_;
+  }
+
   // =========== Global Setter functions ===========
 
   /** @brief Set the @ref fixedTimeStep_ of the physical world. See @ref
@@ -578,6 +708,13 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual void setTimestep(double dt);
 
+  /** @brief Set the @ref maxSubsteps_ of the physical world. See @ref
+   * stepPhysics.
+   * @param maxSubsteps The largest number of fixed substeps a single call to
+   * @ref stepPhysics may take. Must be positive.
+   */
+  void setMaxSubsteps(int maxSubsteps);
+
   /** @brief Set the gravity of the physical world if the world is dyanmic and
    * therefore has a notion of force. By default does nothing since the world is
    * kinematic. Exact implementations of gravity will depend on the specific
@@ -595,6 +732,11 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual double getTimestep() const { return fixedTimeStep_; }
 
+  /** @brief Get the @ref maxSubsteps_ of the physical world. See @ref
+   * stepPhysics.
+   */
+  int getMaxSubsteps() const { return maxSubsteps_; }
+
   /** @brief Get the current @ref worldTime_ of the physical world. See @ref
    * stepPhysics.
    * @return The amount of time, @ref worldTime_, by which the physical world
@@ -703,6 +845,45 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return false;
   }
 
+  /**
+   * @brief Check for each of a batch of poses whether a rigid object would be
+   * in contact with any other objects or the scene there.
+   *
+   * Meant for collision queries of sampling-based planners: only the
+   * broadphase and narrowphase are involved, the simulation state isn't
+   * stepped and the object is back at its current pose afterwards.
+   *
+   * Note: not implemented here in default PhysicsManager as there are no
+   * collision objects without a simulation implementation, nothing collides.
+   *
+   * @param physObjectID The ID of the rigid object.
+   * @param poses Root transformations of the object to test.
+   * @param[out] inContact Receives whether the object is in contact at each
+   * of @p poses, must have the same size.
+   */
+  virtual void contactTestRigidObjectPoses(
+      int physObjectID,
+      Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+      Cr::Containers::ArrayView<bool> inContact);
+
+  /**
+   * @brief Check for each of a batch of joint configurations whether an
+   * articulated object would be in contact with any other objects or the
+   * scene. See @ref contactTestRigidObjectPoses(), the object is back in its
+   * current configuration afterwards.
+   *
+   * @param physObjectID The ID of the articulated object.
+   * @param jointPositions One row for each configuration to test and one
+   * column for each joint position, see
+   * @ref ArticulatedObject::getJointPositions().
+   * @param[out] inContact Receives whether the object is in contact in each
+   * configuration, one for each row of @p jointPositions.
+   */
+  virtual void contactTestArticulatedObjectJointPositions(
+      int physObjectID,
+      const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+      Cr::Containers::ArrayView<bool> inContact);
+
   /**
    * @brief Perform discrete collision detection for the scene with the derived
    * PhysicsManager implementation. Not implemented for default @ref
@@ -742,6 +923,21 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual std::vector<ContactPointData> getContactPoints() const { return {}; }
 
+  /**
+   * @brief Query the contact points involving a single object from the most
+   * recent collision detection cache, in time proportional to the number of
+   * contacts of that object.
+   *
+   * Not implemented for default PhysicsManager implementation.
+   * @param objectId The object ID. The stage is @ref esp::RIGID_STAGE_ID.
+   * @return The contact points, each with @p objectId as either objectIdA or
+   * objectIdB.
+   */
+  virtual std::vector<ContactPointData> getObjectContactPoints(
+      CORRADE_UNUSED int objectId) const {
+    return {};
+  }
+
   /**
    * @brief Set the stage to collidable or not.
    *
@@ -807,6 +1003,47 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return results;
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world and write the closest
+   * hit of each into @p closestHits.
+   *
+   * Meant for sensors and samplers casting thousands of rays per step, the
+   * results go into caller-provided storage and the rays are distributed over
+   * @p numThreads threads. The collision world must not be modified while
+   * this runs. Rays that hit nothing or have zero length get an objectId of
+   * @ref esp::ID_UNDEFINED and a negative rayDistance.
+   *
+   * Note: not implemented here in default PhysicsManager as there are no
+   * collision objects without a simulation implementation, all rays miss.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param maxDistance The maximum distance along the ray directions to
+   * search. In units of ray length.
+   * @param closestHits Output, must have the same size as @p rays.
+   * @param numThreads The number of threads to use. Values <= 0 select the
+   * hardware concurrency of the machine.
+   */
+  virtual void castRays(Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+                        double maxDistance,
+                        Cr::Containers::ArrayView<RayHitInfo> closestHits,
+                        int numThreads = 1);
+
+  /**
+   * @brief Set the joint positions of multiple articulated objects at once.
+   *
+   * The objects are expected to exist and @p positions to have one row for
+   * each of @p objectIDs and a column for each of their joint positions,
+   * which @ref ArticulatedObjectManager::setJointPositions() checks. The
+   * default implementation sets them one object at a time.
+   *
+   * @param objectIDs The IDs of the articulated objects to modify.
+   * @param positions The desired joint positions.
+   */
+  virtual void setArticulatedObjectsJointPositions(
+      Cr::Containers::ArrayView<const int> objectIDs,
+      const Cr::Containers::StridedArrayView2D<const float>& positions);
+
   /**
    * @brief returns the wrapper manager for the currently created rigid
    * objects.
@@ -834,6 +1071,19 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return (existingObjects_.count(physObjectID) > 0);
   }
 
+  /**
+   * @brief Get an existing rigid object directly, bypassing its wrapper.
+   * Intended for batched access by @ref RigidObjectManager, which would
+   * otherwise create a wrapper per object.
+   * @param physObjectID Object ID to look up
+   * @return The rigid object, or nullptr if no rigid object exists with this
+   * id.
+   */
+  RigidObject* getRigidObject(const int physObjectID) const {
+    auto objIter = existingObjects_.find(physObjectID);
+    return objIter == existingObjects_.end() ? nullptr : objIter->second.get();
+  }
+
   /**
    * @brief Check if @p physObjectID represents an existing articulated object.
    * @param physObjectID Object ID to check
@@ -914,6 +1164,47 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
       const metadata::attributes::SceneInstanceAttributes::ptr&
           sceneInstanceAttrs) const;
 
+  /**
+   * @brief Capture the transformations, motion types, velocities and joint
+   * states of all rigid and articulated objects, along with the world time.
+   */
+  PhysicsStateSnapshot captureStateSnapshot() const;
+
+  /**
+   * @brief Put the objects back into the state captured by @ref
+   * captureStateSnapshot().
+   *
+   * Existing objects are updated in place, so neither their simulation bodies
+   * nor their drawables are recreated. Objects added since the capture are
+   * removed. Objects removed since can't be restored this way and are
+   * skipped with a warning, load the scene again for those.
+   * @return Whether all objects of @p snapshot were restored.
+   */
+  bool restoreStateSnapshot(const PhysicsStateSnapshot& snapshot);
+
+  /**
+   * @brief Write the state of the physical world to @p state as a compact
+   * binary blob, for branching rollouts with @ref restoreState().
+   *
+   * Contains the world time, the same per-object state as @ref
+   * captureStateSnapshot() and the pivots, frames and maximum impulses of the
+   * rigid constraints. @p state is resized to fit, so saving repeatedly into
+   * the same buffer allocates only when the world grows. The blob is only
+   * meant to be restored in the world that saved it.
+   */
+  void saveState(std::vector<char>& state) const;
+
+  /**
+   * @brief Put the physical world back into a @p state written by @ref
+   * saveState(), without allocating.
+   *
+   * Objects and constraints are updated in place. The world has to contain
+   * exactly the objects and constraints it had when saving, otherwise
+   * nothing is changed.
+   * @return Whether the state was restored.
+   */
+  bool restoreState(Corrade::Containers::ArrayView<const char> state);
+
   /**
    * @brief Compute a trajectory visualization for the passed points.
    * @param trajVisName The name to use for the trajectory visualization
@@ -939,6 +1230,37 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
                           bool smooth = false,
                           int numInterp = 10,
                           DrawableGroup* drawables = nullptr);
+
+  /**
+   * @brief Compute a single trajectory visualization object for all of the
+   * passed trajectories, drawn with one draw call.
+   * @param trajVisName The name to use for the trajectory visualization
+   * @param trajectories The points of each trajectory, in order
+   * @param colorVecs Array of colors for each trajectory tube. A single array
+   * is used for all tubes.
+   * @param numSegments The number of the segments around the circumference of
+   * the tubes. Must be greater than or equal to 3.
+   * @param radius The radius of the tubes.
+   * @param smooth Whether to smooth the points in the trajectories or not.
+   * @param numInterp The number of interpolations between each trajectory
+   * point, if smoothed
+   * @param numThreads The number of threads building the tube meshes, see
+   * @ref core::resolveNumThreads().
+   * @param drawables Reference to the scene graph drawables group to enable
+   * rendering of the newly initialized object. If nullptr, will attempt to
+   * query Simulator to retrieve a group.
+   * @return The ID of the object created for the visualization
+   */
+  int addTrajectoryObjects(
+      const std::string& trajVisName,
+      const std::vector<std::vector<Mn::Vector3>>& trajectories,
+      const std::vector<std::vector<Mn::Color3>>& colorVecs,
+      int numSegments = 3,
+      float radius = .001,
+      bool smooth = false,
+      int numInterp = 10,
+      int numThreads = 1,
+      DrawableGroup* drawables = nullptr);
   /**
    * @brief Remove a trajectory visualization by name.
    * @param trajVisName The name of the trajectory visualization to remove.
@@ -992,6 +1314,16 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    * @return the instanced object's ID, mapping to it in @ref
    * PhysicsManager::existingObjects_ if successful, or @ref esp::ID_UNDEFINED.
    */
+  /**
+   * @brief Apply the per-instance visibility, shader type, scale and mass
+   * overrides of @p objInstAttributes to @p objAttributes, a copy of the
+   * object's template.
+   */
+  void applyObjectInstanceAttributes(
+      const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
+      const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+          objInstAttributes) const;
+
   int addObjectAndSaveAttributes(
       const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes,
       DrawableGroup* drawables = nullptr,
@@ -1076,6 +1408,14 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return ID_UNDEFINED;
   }
 
+  /**
+   * @brief Internal use only. Add the object for the trajectory visualization
+   * asset named @p trajVisName, once the asset is built.
+   * @return The ID of the object created for the visualization
+   */
+  int addTrajectoryObjectInternal(const std::string& trajVisName,
+                                  DrawableGroup* drawables);
+
   /**
    * @brief Internal use only. Remove a trajectory object, its mesh, and all
    * references to it.
@@ -1183,6 +1523,12 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
   virtual bool addStageFinalize(
       const metadata::attributes::StageAttributes::ptr& initAttributes);
 
+  /**
+   * @brief Finalize the addition of a batch of objects by @ref
+   * addObjectInstances. Overidden by instancing class if physics is supported.
+   */
+  virtual void addObjectInstancesFinalize() {}
+
   /** @brief Create and initialize a @ref RigidObject, assign it an ID and
    * add it to existingObjects_ map keyed with newObjectID
    * @param newObjectID valid object ID for the new object
@@ -1296,6 +1642,20 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   double worldTime_ = 0.0;
 
+  /** @brief The largest number of fixed substeps a single @ref stepPhysics
+   * call takes. The remaining time of a longer step is dropped rather than
+   * simulated, so a stalled frame can't trigger an unbounded amount of work.
+   */
+  int maxSubsteps_ = 10000;
+
+  /** @brief See @ref getLastStepProfile. */
+  PhysicsStepProfile lastStepProfile_;
+
+  /** @brief Record the substep counts of a step in @ref lastStepProfile_ and
+   * warn the first time substeps get dropped.
+   */
+  void recordSubsteps(int numSubstepsRequested, int numSubstepsTaken);
+
  public:
   ESP_SMART_POINTERS(PhysicsManager)
 };  // class PhysicsManager
@@ -11,6 +11,7 @@
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Path.h>
 #include "esp/assets/ResourceManager.h"
+#include "esp/io/Io.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
 
 namespace Mn = Magnum;
@@ -19,15 +20,19 @@ namespace esp {
 namespace physics {
 
 bool URDFImporter::loadURDF(const std::string& urdfFilepath, bool forceReload) {
+  std::uint64_t modified = 0;
+  std::uint64_t size = 0;
+  if (!io::getFileStamp(urdfFilepath, modified, size) ||
+      Corrade::Utility::Path::isDirectory(urdfFilepath)) {
+    ESP_DEBUG() << "URDF File does not exist:" << urdfFilepath
+                << ". Aborting URDF parse/load.";
+    return false;
+  }
   auto modelCacheIter = modelCache_.find(urdfFilepath);
-  // if map not found or forcing reload
-  if ((modelCacheIter == modelCache_.end()) || forceReload) {
-    if (!Corrade::Utility::Path::exists(urdfFilepath) ||
-        Corrade::Utility::Path::isDirectory(urdfFilepath)) {
-      ESP_DEBUG() << "URDF File does not exist:" << urdfFilepath
-                  << ". Aborting URDF parse/load.";
-      return false;
-    }
+  // if map not found, source file changed or forcing reload
+  if ((modelCacheIter == modelCache_.end()) ||
+      (modelCacheIter->second.modified != modified) ||
+      (modelCacheIter->second.size != size) || forceReload) {
 
     // parse the URDF from file
     std::shared_ptr<metadata::URDF::Model> urdfModel;
@@ -48,10 +53,13 @@ bool URDFImporter::loadURDF(const std::string& urdfFilepath, bool forceReload) {
     }
 
     // register the new model and set to iterator
-    modelCacheIter = modelCache_.emplace(urdfFilepath, urdfModel).first;
+    modelCacheIter =
+        modelCache_
+            .emplace(urdfFilepath, CachedModel{urdfModel, modified, size})
+            .first;
   }
 
-  activeModel_ = modelCacheIter->second;
+  activeModel_ = modelCacheIter->second.model;
 
   return true;
 }
@@ -286,6 +294,12 @@ void URDFImporter::importURDFAssets(
         case metadata::URDF::GEOM_CAPSULE: {
           visualMeshInfo.type = esp::assets::AssetType::PRIMITIVE;
           auto assetMgr = resourceManager_.getAssetAttributesManager();
+          // a cached model already holds the handle of its capsule asset
+          if (!visual.m_geometry.m_meshFileName.empty() &&
+              assetMgr->getObjectLibHasHandle(
+                  visual.m_geometry.m_meshFileName)) {
+            break;
+          }
           auto capTemplate = assetMgr->getDefaultCapsuleTemplate(false);
           // proportions as suggested on magnum docs
           capTemplate->setHalfLength(0.5 * visual.m_geometry.m_capsuleHeight /
@@ -7,6 +7,8 @@
 #ifndef ESP_PHYSICS_URDFIMPORTER_H_
 #define ESP_PHYSICS_URDFIMPORTER_H_
 
+#include <cstdint>
+
 #include "esp/metadata/URDFParser.h"
 #include "esp/metadata/attributes/ArticulatedObjectAttributes.h"
 
@@ -51,7 +53,8 @@ class URDFImporter {
 
   virtual ~URDFImporter() = default;
   /**
-   * @brief Sets the activeModel_ for the importer. If new or forceReload, parse
+   * @brief Sets the activeModel_ for the importer. If new, changed on disk
+   * since cached or forceReload, parse
    * a URDF file and cache the resulting model. Note: when applying uniform
    * scaling to a 3D model consider scale^3 mass scaling to approximate uniform
    * density.
@@ -149,8 +152,16 @@ class URDFImporter {
 
   esp::assets::ResourceManager& resourceManager_;
 
-  //! cache parsed URDF models by filename
-  std::map<std::string, std::shared_ptr<metadata::URDF::Model>> modelCache_;
+  //! A parsed URDF model and the state of its source file when parsed.
+  struct CachedModel {
+    std::shared_ptr<metadata::URDF::Model> model;
+    std::uint64_t modified = 0;
+    std::uint64_t size = 0;
+  };
+
+  //! cache parsed URDF models by filename. Entries whose source file changed
+  //! on disk since they were parsed are reparsed on next load.
+  std::map<std::string, CachedModel> modelCache_;
 
   //! which model is being actively manipulated. Changed by calling
   //! loadURDF(filename).
@@ -5,9 +5,11 @@
 // Construction code adapted from Bullet3/examples/
 
 #include "BulletArticulatedObject.h"
+#include <Corrade/Containers/ArrayViewStl.h>
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletPhysicsManager.h"
 #include "BulletURDFImporter.h"
+#include "esp/core/Check.h"
 #include "esp/metadata/attributes/ArticulatedObjectAttributes.h"
 #include "esp/scene/SceneNode.h"
 
@@ -216,6 +218,18 @@ void BulletArticulatedObject::constructStaticRigidBaseObject() {
 
 void BulletArticulatedObject::updateNodes(bool force) {
   isDeferringUpdate_ = false;
+  const bool awake = btMultiBody_->isAwake();
+  if (!force && !awake) {
+    if (!nodesSyncPending_) {
+      // asleep and unchanged since the last sync
+      return;
+    }
+    // fell asleep or was updated kinematically since the last sync, the
+    // sleeping colliders need their final transforms too
+    force = true;
+  }
+  // sync once more after the multibody falls asleep
+  nodesSyncPending_ = awake;
   if (force || btMultiBody_->getBaseCollider()->isActive()) {
     setRotationScalingFromBulletTransform(btMultiBody_->getBaseWorldTransform(),
                                           &node());
@@ -386,6 +400,16 @@ void BulletArticulatedObject::addJointForces(const std::vector<float>& forces) {
 
 std::vector<float> BulletArticulatedObject::getJointForces() {
   std::vector<float> forces(btMultiBody_->getNumDofs());
+  getJointForcesInto(Cr::Containers::arrayView(forces));
+  return forces;
+}
+
+void BulletArticulatedObject::getJointForcesInto(
+    Cr::Containers::StridedArrayView1D<float> forces) {
+  ESP_CHECK(forces.size() == std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::getJointForcesInto(): expected"
+                << btMultiBody_->getNumDofs() << "elements but got"
+                << forces.size());
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofForces = btMultiBody_->getJointTorqueMultiDof(i);
@@ -394,7 +418,22 @@ std::vector<float> BulletArticulatedObject::getJointForces() {
       ++dofCount;
     }
   }
-  return forces;
+}
+
+void BulletArticulatedObject::setJointForcesFrom(
+    Cr::Containers::StridedArrayView1D<const float> forces) {
+  ESP_CHECK(forces.size() == std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::setJointForcesFrom(): expected"
+                << btMultiBody_->getNumDofs() << "elements but got"
+                << forces.size());
+  int dofCount = 0;
+  for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
+    btMultibodyLink& link = btMultiBody_->getLink(i);
+    for (int dof = 0; dof < link.m_dofCount; ++dof) {
+      link.m_jointTorque[dof] = forces[dofCount];
+      ++dofCount;
+    }
+  }
 }
 
 void BulletArticulatedObject::setJointVelocities(
@@ -418,6 +457,16 @@ void BulletArticulatedObject::setJointVelocities(
 
 std::vector<float> BulletArticulatedObject::getJointVelocities() {
   std::vector<float> vels(btMultiBody_->getNumDofs());
+  getJointVelocitiesInto(Cr::Containers::arrayView(vels));
+  return vels;
+}
+
+void BulletArticulatedObject::getJointVelocitiesInto(
+    Cr::Containers::StridedArrayView1D<float> vels) {
+  ESP_CHECK(vels.size() == std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::getJointVelocitiesInto(): expected"
+                << btMultiBody_->getNumDofs() << "elements but got"
+                << vels.size());
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofVels = btMultiBody_->getJointVelMultiDof(i);
@@ -426,7 +475,29 @@ std::vector<float> BulletArticulatedObject::getJointVelocities() {
       ++dofCount;
     }
   }
-  return vels;
+}
+
+void BulletArticulatedObject::setJointVelocitiesFrom(
+    Cr::Containers::StridedArrayView1D<const float> vels) {
+  ESP_CHECK(vels.size() == std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::setJointVelocitiesFrom(): expected"
+                << btMultiBody_->getNumDofs() << "elements but got"
+                << vels.size());
+  // setJointVelMultiDof() expects contiguous data, see
+  // setJointPositionsFrom()
+  int dofCount = 0;
+  for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
+    const int linkDofCount = btMultiBody_->getLink(i).m_dofCount;
+    if (linkDofCount > 0) {
+      btScalar linkVels[4];
+      CORRADE_INTERNAL_ASSERT(linkDofCount <= 4);
+      for (int dof = 0; dof < linkDofCount; ++dof) {
+        linkVels[dof] = vels[dofCount];
+        ++dofCount;
+      }
+      btMultiBody_->setJointVelMultiDof(i, linkVels);
+    }
+  }
 }
 
 void BulletArticulatedObject::setJointPositions(
@@ -453,6 +524,16 @@ void BulletArticulatedObject::setJointPositions(
 
 std::vector<float> BulletArticulatedObject::getJointPositions() {
   std::vector<float> positions(btMultiBody_->getNumPosVars());
+  getJointPositionsInto(Cr::Containers::arrayView(positions));
+  return positions;
+}
+
+void BulletArticulatedObject::getJointPositionsInto(
+    Cr::Containers::StridedArrayView1D<float> positions) {
+  ESP_CHECK(positions.size() == std::size_t(btMultiBody_->getNumPosVars()),
+            "BulletArticulatedObject::getJointPositionsInto(): expected"
+                << btMultiBody_->getNumPosVars() << "elements but got"
+                << positions.size());
   int posCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* linkPos = btMultiBody_->getJointPosMultiDof(i);
@@ -461,20 +542,57 @@ std::vector<float> BulletArticulatedObject::getJointPositions() {
       ++posCount;
     }
   }
-  return positions;
+}
+
+void BulletArticulatedObject::writeJointPositionsFrom(
+    Cr::Containers::StridedArrayView1D<const float> positions) {
+  ESP_CHECK(positions.size() == std::size_t(btMultiBody_->getNumPosVars()),
+            "BulletArticulatedObject::writeJointPositionsFrom(): expected"
+                << btMultiBody_->getNumPosVars() << "elements but got"
+                << positions.size());
+  // setJointPosMultiDof() expects contiguous data, which a strided view isn't
+  // guaranteed to be, so copy each link's positions to a scratch buffer
+  // first. No joint type has more position variables than the quaternion of
+  // a spherical joint.
+  int posCount = 0;
+  for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
+    const int posVarCount = btMultiBody_->getLink(i).m_posVarCount;
+    if (posVarCount > 0) {
+      btScalar linkPos[4];
+      CORRADE_INTERNAL_ASSERT(posVarCount <= 4);
+      for (int pos = 0; pos < posVarCount; ++pos) {
+        linkPos[pos] = positions[posCount];
+        ++posCount;
+      }
+      btMultiBody_->setJointPosMultiDof(i, linkPos);
+    }
+  }
+}
+
+void BulletArticulatedObject::setJointPositionsFrom(
+    Cr::Containers::StridedArrayView1D<const float> positions) {
+  writeJointPositionsFrom(positions);
+
+  // update the simulation state
+  updateKinematicState();
+}
+
+int BulletArticulatedObject::getNumDoFs() const {
+  return btMultiBody_->getNumDofs();
+}
+
+int BulletArticulatedObject::getNumJointPositions() const {
+  return btMultiBody_->getNumPosVars();
 }
 
 std::vector<float> BulletArticulatedObject::getJointMotorTorques(
     double fixedTimeStep) {
   std::vector<float> torques(btMultiBody_->getNumDofs());
-  for (auto& motor : jointMotors_) {
-    auto& settings = motor.second->settings;
-    if (settings.motorType == JointMotorType::SingleDof) {
-      auto& btMotor = articulatedJointMotors.at(motor.first);
-      btScalar impulse = btMotor->getAppliedImpulse(0);
+  for (const JointMotorBinding& binding : getJointMotorBindings()) {
+    if (binding.singleDofMotor) {
+      btScalar impulse = binding.singleDofMotor->getAppliedImpulse(0);
       float force = impulse / float(fixedTimeStep);
-      int link_dof = btMultiBody_->getLink(motor.second->index).m_dofOffset;
-      torques[link_dof] += force;
+      torques[binding.dofOffset] += force;
     } else {
       ESP_CHECK(
           false,
@@ -670,33 +788,39 @@ void BulletArticulatedObject::overrideCollisionGroup(CollisionGroup group) {
     ESP_WARNING() << "Overriding all link collision groups for an "
                      "ArticulatedObject with a STATIC base collision shape "
                      "defined. Only do this if you understand the risks.";
-    bWorld_->removeRigidBody(bFixedObjectRigidBody_.get());
-    bWorld_->addRigidBody(bFixedObjectRigidBody_.get(), collisionFilterGroup,
-                          collisionFilterMask);
+    BulletBase::setCollisionFilter(*bWorld_, *bFixedObjectRigidBody_,
+                                   collisionFilterGroup, collisionFilterMask);
   }
 
-  // override separate base link object group
-  auto* baseCollider = btMultiBody_->getBaseCollider();
-  bWorld_->removeCollisionObject(baseCollider);
-  bWorld_->addCollisionObject(baseCollider, collisionFilterGroup,
-                              collisionFilterMask);
+  // override separate base link object group, in place instead of
+  // re-inserting into the broadphase
+  BulletBase::setCollisionFilter(*bWorld_, *btMultiBody_->getBaseCollider(),
+                                 collisionFilterGroup, collisionFilterMask);
 
   // override link collision object groups
   for (int colIx = 0; colIx < btMultiBody_->getNumLinks(); ++colIx) {
-    auto* linkCollider = btMultiBody_->getLinkCollider(colIx);
-    bWorld_->removeCollisionObject(linkCollider);
-    bWorld_->addCollisionObject(linkCollider, collisionFilterGroup,
-                                collisionFilterMask);
+    BulletBase::setCollisionFilter(*bWorld_,
+                                   *btMultiBody_->getLinkCollider(colIx),
+                                   collisionFilterGroup, collisionFilterMask);
   }
 }
 
 void BulletArticulatedObject::updateKinematicState() {
+  updateKinematicTransforms();
+  updateKinematicAabbs();
+  updateKinematicNodes();
+}
+
+void BulletArticulatedObject::updateKinematicTransforms() {
   if (!isActive()) {
     // activate if not already active and kinematically updated
     setActive(true);
   }
   btMultiBody_->forwardKinematics(scratch_q_, scratch_m_);
   btMultiBody_->updateCollisionObjectWorldTransforms(scratch_q_, scratch_m_);
+}
+
+void BulletArticulatedObject::updateKinematicAabbs() {
   // Need to update the aabbs manually also for broadphase collision detection
   for (int linkIx = 0; linkIx < btMultiBody_->getNumLinks(); ++linkIx) {
     bWorld_->updateSingleAabb(btMultiBody_->getLinkCollider(linkIx));
@@ -705,9 +829,14 @@ void BulletArticulatedObject::updateKinematicState() {
   if (bFixedObjectRigidBody_) {
     bWorld_->updateSingleAabb(bFixedObjectRigidBody_.get());
   }
+}
+
+void BulletArticulatedObject::updateKinematicNodes() {
   // update visual shapes
   if (!isDeferringUpdate_) {
     updateNodes(true);
+  } else {
+    nodesSyncPending_ = true;
   }
 }
 
@@ -794,6 +923,35 @@ bool BulletArticulatedObject::contactTest() {
   return false;
 }  // contactTest
 
+void BulletArticulatedObject::contactTestJointPositions(
+    const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+    Cr::Containers::ArrayView<bool> inContact) {
+  ESP_CHECK(jointPositions.size()[1] ==
+                std::size_t(btMultiBody_->getNumPosVars()),
+            "BulletArticulatedObject::contactTestJointPositions(): expected"
+                << btMultiBody_->getNumPosVars() << "columns but got"
+                << jointPositions.size()[1]);
+  // other objects are tested against the link aabbs in the broadphase, but
+  // self-collisions need them updated
+  const bool updateAabbs = btMultiBody_->hasSelfCollision();
+  const std::vector<float> currentPositions = getJointPositions();
+  for (std::size_t i = 0; i != jointPositions.size()[0]; ++i) {
+    writeJointPositionsFrom(jointPositions[i]);
+    btMultiBody_->forwardKinematics(scratch_q_, scratch_m_);
+    btMultiBody_->updateCollisionObjectWorldTransforms(scratch_q_, scratch_m_);
+    if (updateAabbs) {
+      updateKinematicAabbs();
+    }
+    inContact[i] = contactTest();
+  }
+  writeJointPositionsFrom(Cr::Containers::arrayView(currentPositions));
+  btMultiBody_->forwardKinematics(scratch_q_, scratch_m_);
+  btMultiBody_->updateCollisionObjectWorldTransforms(scratch_q_, scratch_m_);
+  if (updateAabbs) {
+    updateKinematicAabbs();
+  }
+}  // contactTestJointPositions
+
 // ------------------------
 // Joint Motor API
 // ------------------------
@@ -881,6 +1039,7 @@ int BulletArticulatedObject::createJointMotor(
     articulatedSphericalJointMotors.emplace(
         nextJointMotorId_, std::move(btMotor));  // cache the Bullet structure
   }
+  jointMotorBindingsDirty_ = true;
   // force activation if motors are updated
   setActive(true);
   return nextJointMotorId_++;
@@ -908,6 +1067,7 @@ void BulletArticulatedObject::removeJointMotor(const int motorId) {
     }
   }
   jointMotors_.erase(jointMotorIter);
+  jointMotorBindingsDirty_ = true;
   // force activation if motors are updated
   btMultiBody_->wakeUp();
 }
@@ -954,52 +1114,115 @@ void BulletArticulatedObject::updateJointMotor(
 void BulletArticulatedObject::updateAllMotorTargets(
     const std::vector<float>& stateTargets,
     bool velocities) {
-  ESP_CHECK(stateTargets.size() == velocities ? btMultiBody_->getNumDofs()
-                                              : btMultiBody_->getNumPosVars(),
+  ESP_CHECK(stateTargets.size() ==
+                std::size_t(velocities ? btMultiBody_->getNumDofs()
+                                       : btMultiBody_->getNumPosVars()),
             "BulletArticulatedObject::updateAllMotorTargets - stateTargets "
             "size does not match object state size.");
 
-  for (auto& motor : jointMotors_) {
-    btMultibodyLink& btLink = btMultiBody_->getLink(motor.second->index);
-    int startIndex = velocities ? btLink.m_dofOffset : btLink.m_cfgOffset;
-    auto& settings = motor.second->settings;
-    if (settings.motorType == JointMotorType::SingleDof) {
-      auto& btMotor = articulatedJointMotors.at(motor.first);
-      if (velocities) {
-        settings.velocityTarget = double(stateTargets[startIndex]);
-        btMotor->setVelocityTarget(settings.velocityTarget,
-                                   settings.velocityGain);
-      } else {
-        // positions
-        settings.positionTarget = double(stateTargets[startIndex]);
-        btMotor->setPositionTarget(settings.positionTarget,
-                                   settings.positionGain);
+  if (velocities) {
+    setJointMotorTargetsFrom(nullptr, Cr::Containers::arrayView(stateTargets),
+                             nullptr);
+  } else {
+    setJointMotorTargetsFrom(Cr::Containers::arrayView(stateTargets), nullptr,
+                             nullptr);
+  }
+}
+
+void BulletArticulatedObject::setJointMotorTargetsFrom(
+    Cr::Containers::StridedArrayView1D<const float> positionTargets,
+    Cr::Containers::StridedArrayView1D<const float> velocityTargets,
+    Cr::Containers::StridedArrayView1D<const float> maxImpulses) {
+  ESP_CHECK(positionTargets.isEmpty() ||
+                positionTargets.size() ==
+                    std::size_t(btMultiBody_->getNumPosVars()),
+            "BulletArticulatedObject::setJointMotorTargetsFrom(): expected"
+                << btMultiBody_->getNumPosVars() << "position targets but got"
+                << positionTargets.size());
+  ESP_CHECK(velocityTargets.isEmpty() ||
+                velocityTargets.size() ==
+                    std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::setJointMotorTargetsFrom(): expected"
+                << btMultiBody_->getNumDofs() << "velocity targets but got"
+                << velocityTargets.size());
+  ESP_CHECK(maxImpulses.isEmpty() ||
+                maxImpulses.size() == std::size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::setJointMotorTargetsFrom(): expected"
+                << btMultiBody_->getNumDofs() << "max impulses but got"
+                << maxImpulses.size());
+
+  for (const JointMotorBinding& binding : getJointMotorBindings()) {
+    JointMotorSettings& settings = binding.motor->settings;
+    if (binding.singleDofMotor) {
+      btMultiBodyJointMotor& btMotor = *binding.singleDofMotor;
+      if (!positionTargets.isEmpty()) {
+        settings.positionTarget = double(positionTargets[binding.cfgOffset]);
+        btMotor.setPositionTarget(settings.positionTarget,
+                                  settings.positionGain);
+      }
+      if (!velocityTargets.isEmpty()) {
+        settings.velocityTarget = double(velocityTargets[binding.dofOffset]);
+        btMotor.setVelocityTarget(settings.velocityTarget,
+                                  settings.velocityGain);
+      }
+      if (!maxImpulses.isEmpty()) {
+        settings.maxImpulse = double(maxImpulses[binding.dofOffset]);
+        btMotor.setMaxAppliedImpulse(settings.maxImpulse);
       }
     } else {
       // JointMotorType::Spherical
-      if (velocities) {
-        settings.sphericalVelocityTarget = {stateTargets[startIndex],
-                                            stateTargets[startIndex + 1],
-                                            stateTargets[startIndex + 2]};
-        articulatedSphericalJointMotors.at(motor.first)
-            ->setVelocityTarget(btVector3(settings.sphericalVelocityTarget),
-                                settings.velocityGain);
-      } else {
-        // positions
+      btMultiBodySphericalJointMotor& btMotor = *binding.sphericalMotor;
+      if (!positionTargets.isEmpty()) {
+        const int i = binding.cfgOffset;
         settings.sphericalPositionTarget =
-            Mn::Quaternion(Mn::Vector3(stateTargets[startIndex],
-                                       stateTargets[startIndex + 1],
-                                       stateTargets[startIndex + 2]),
-                           stateTargets[startIndex + 3])
+            Mn::Quaternion(Mn::Vector3(positionTargets[i],
+                                       positionTargets[i + 1],
+                                       positionTargets[i + 2]),
+                           positionTargets[i + 3])
                 .normalized();
-        articulatedSphericalJointMotors.at(motor.first)
-            ->setPositionTarget(btQuaternion(settings.sphericalPositionTarget),
-                                settings.positionGain);
+        btMotor.setPositionTarget(
+            btQuaternion(settings.sphericalPositionTarget),
+            settings.positionGain);
+      }
+      if (!velocityTargets.isEmpty()) {
+        const int i = binding.dofOffset;
+        settings.sphericalVelocityTarget = {velocityTargets[i],
+                                            velocityTargets[i + 1],
+                                            velocityTargets[i + 2]};
+        btMotor.setVelocityTarget(btVector3(settings.sphericalVelocityTarget),
+                                  settings.velocityGain);
+      }
+      if (!maxImpulses.isEmpty()) {
+        settings.maxImpulse = double(maxImpulses[binding.dofOffset]);
+        btMotor.setMaxAppliedImpulse(settings.maxImpulse);
       }
     }
   }
   // force activation when motors are updated
   setActive(true);
+}  // BulletArticulatedObject::setJointMotorTargetsFrom
+
+const std::vector<BulletArticulatedObject::JointMotorBinding>&
+BulletArticulatedObject::getJointMotorBindings() {
+  if (!jointMotorBindingsDirty_) {
+    return jointMotorBindings_;
+  }
+  jointMotorBindings_.clear();
+  jointMotorBindings_.reserve(jointMotors_.size());
+  for (auto& motor : jointMotors_) {
+    const btMultibodyLink& btLink = btMultiBody_->getLink(motor.second->index);
+    JointMotorBinding binding{motor.second.get(), nullptr, nullptr,
+                              btLink.m_dofOffset, btLink.m_cfgOffset};
+    if (motor.second->settings.motorType == JointMotorType::SingleDof) {
+      binding.singleDofMotor = articulatedJointMotors.at(motor.first).get();
+    } else {
+      binding.sphericalMotor =
+          articulatedSphericalJointMotors.at(motor.first).get();
+    }
+    jointMotorBindings_.push_back(binding);
+  }
+  jointMotorBindingsDirty_ = false;
+  return jointMotorBindings_;
 }
 
 }  // namespace physics
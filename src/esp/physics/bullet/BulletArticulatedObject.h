@@ -113,6 +113,15 @@ class BulletArticulatedObject : public ArticulatedObject {
   //! update the SceneNode state to match the simulation state
   void updateNodes(bool force = false) override;
 
+  /**
+   * @brief Whether @ref updateNodes() has anything to sync. False if the
+   * multibody is asleep and its state hasn't been set since the last sync,
+   * in which case a non-forced @ref updateNodes() returns right away.
+   */
+  bool nodesNeedSync() const {
+    return nodesSyncPending_ || btMultiBody_->isAwake();
+  }
+
   /**
    * @brief Return a @ref
    * metadata::attributes::SceneAOInstanceAttributes reflecting the current
@@ -221,6 +230,98 @@ class BulletArticulatedObject : public ArticulatedObject {
    */
   std::vector<float> getJointPositions() override;
 
+  //! Get the number of degrees of freedom of the multibody.
+  int getNumDoFs() const override;
+
+  //! Get the number of joint position values of the multibody.
+  int getNumJointPositions() const override;
+
+  /**
+   * @brief Copy current forces/torques for all joints into a caller-provided
+   * view, without allocating.
+   *
+   * @param[out] forces Receives the joint forces/torques. Expected to have
+   * @ref getNumDoFs() elements.
+   */
+  void getJointForcesInto(
+      Corrade::Containers::StridedArrayView1D<float> forces) override;
+
+  /**
+   * @brief Set forces/torques for all joints from a caller-provided view.
+   *
+   * Bullet clears joint forces/torques with each simulation step.
+   *
+   * @param forces The desired joint forces/torques. Expected to have
+   * @ref getNumDoFs() elements.
+   */
+  void setJointForcesFrom(
+      Corrade::Containers::StridedArrayView1D<const float> forces) override;
+
+  /**
+   * @brief Copy current velocities for all joints into a caller-provided
+   * view, without allocating.
+   *
+   * @param[out] vels Receives the joint velocities. Expected to have
+   * @ref getNumDoFs() elements.
+   */
+  void getJointVelocitiesInto(
+      Corrade::Containers::StridedArrayView1D<float> vels) override;
+
+  /**
+   * @brief Set velocities for all joints from a caller-provided view.
+   *
+   * @param vels The desired joint velocities. Expected to have
+   * @ref getNumDoFs() elements.
+   */
+  void setJointVelocitiesFrom(
+      Corrade::Containers::StridedArrayView1D<const float> vels) override;
+
+  /**
+   * @brief Copy current positions for all joints into a caller-provided view,
+   * without allocating.
+   *
+   * @param[out] positions Receives the joint positions. Expected to have
+   * @ref getNumJointPositions() elements.
+   */
+  void getJointPositionsInto(
+      Corrade::Containers::StridedArrayView1D<float> positions) override;
+
+  /**
+   * @brief Set positions for all joints from a caller-provided view.
+   *
+   * @param positions The desired joint positions. Expected to have
+   * @ref getNumJointPositions() elements.
+   */
+  void setJointPositionsFrom(
+      Corrade::Containers::StridedArrayView1D<const float> positions) override;
+
+  /**
+   * @brief Set positions for all joints from a caller-provided view without
+   * updating the kinematic state.
+   *
+   * Used by @ref BulletPhysicsManager::setArticulatedObjectsJointPositions()
+   * to batch the kinematic updates of several objects. The caller is
+   * responsible for calling @ref updateKinematicTransforms(),
+   * @ref updateKinematicAabbs() and @ref updateKinematicNodes() afterwards.
+   *
+   * @param positions The desired joint positions. Expected to have
+   * @ref getNumJointPositions() elements.
+   */
+  void writeJointPositionsFrom(
+      Corrade::Containers::StridedArrayView1D<const float> positions);
+
+  //! Activates the object, performs forward kinematics and updates the world
+  //! transforms of the base and link collision objects.
+  void updateKinematicTransforms();
+
+  //! Updates the broadphase aabbs of the base and link collision objects
+  //! after @ref updateKinematicTransforms().
+  void updateKinematicAabbs();
+
+  //! Pushes the link transforms to their SceneNodes unless node updates are
+  //! deferred.
+  void updateKinematicNodes();
+
   /**
    * @brief Get the torques on each joint
    *
@@ -354,6 +455,22 @@ class BulletArticulatedObject : public ArticulatedObject {
    */
   bool contactTest() override;
 
+  /**
+   * @brief Run @ref contactTest() with the object in each of a batch of joint
+   * configurations, putting it back in its current configuration afterwards.
+   * Only the collision objects are moved, the object isn't activated and
+   * SceneNodes are left as they are.
+   *
+   * @param jointPositions One row for each configuration to test and one
+   * column for each joint position.
+   * @param[out] inContact Receives whether the object is in contact in each
+   * configuration, expected to have one element per row.
+   */
+  void contactTestJointPositions(
+      const Corrade::Containers::StridedArrayView2D<const float>&
+          jointPositions,
+      Corrade::Containers::ArrayView<bool> inContact);
+
   //! clamp current pose to joint limits
   void clampJointLimits() override;
 
@@ -424,6 +541,19 @@ class BulletArticulatedObject : public ArticulatedObject {
   void updateAllMotorTargets(const std::vector<float>& stateTargets,
                              bool velocities = false) override;
 
+  /**
+   * @brief Update the targets and max impulses of all motors of this object
+   * at once. See @ref ArticulatedObject::setJointMotorTargetsFrom.
+   *
+   * Writes directly to the Bullet motors through a list built when motors
+   * are created or removed, without a map lookup per motor.
+   */
+  void setJointMotorTargetsFrom(
+      Corrade::Containers::StridedArrayView1D<const float> positionTargets,
+      Corrade::Containers::StridedArrayView1D<const float> velocityTargets,
+      Corrade::Containers::StridedArrayView1D<const float> maxImpulses)
+      override;
+
   //============ END - Joint Motor Constraints =============
 
   /**
@@ -460,9 +590,32 @@ class BulletArticulatedObject : public ArticulatedObject {
   std::unordered_map<int, std::unique_ptr<btMultiBodySphericalJointMotor>>
       articulatedSphericalJointMotors;
 
+  //! A motor together with its Bullet motor and the state offsets of its
+  //! joint, for updating all motors without map lookups
+  struct JointMotorBinding {
+    JointMotor* motor;
+    //! nullptr for spherical motors
+    btMultiBodyJointMotor* singleDofMotor;
+    //! nullptr for single dof motors
+    btMultiBodySphericalJointMotor* sphericalMotor;
+    int dofOffset;
+    int cfgOffset;
+  };
+
+  //! Returns @ref jointMotorBindings_, rebuilding it if motors were created
+  //! or removed since
+  const std::vector<JointMotorBinding>& getJointMotorBindings();
+
+  //! All motors of the object, valid unless @ref jointMotorBindingsDirty_
+  std::vector<JointMotorBinding> jointMotorBindings_;
+  bool jointMotorBindingsDirty_ = true;
+
   //! maps local link id to parent joint's limit constraint
   std::unordered_map<int, JointLimitConstraintInfo> jointLimitConstraints_;
 
+  //! Whether the SceneNodes need a sync even if the multibody is asleep
+  bool nodesSyncPending_ = true;
+
   // scratch data structures for updateKinematicState
   btAlignedObjectArray<btQuaternion> scratch_q_;
   btAlignedObjectArray<btVector3> scratch_m_;
@@ -480,8 +633,9 @@ class BulletArticulatedObject : public ArticulatedObject {
   // compound parent collision shapes for the links
   std::map<int, std::unique_ptr<btCompoundShape>> linkCompoundShapes_;
 
-  // child mesh convex and primitive shapes for the link compound shapes
-  std::map<int, std::vector<std::unique_ptr<btCollisionShape>>>
+  // child mesh convex and primitive shapes for the link compound shapes. Mesh
+  // shapes are shared with other instances of the same model.
+  std::map<int, std::vector<std::shared_ptr<btCollisionShape>>>
       linkChildShapes_;
 
   // used to update raycast objectId checks (maps to link ids)
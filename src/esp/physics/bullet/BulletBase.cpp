@@ -72,5 +72,73 @@ void BulletBase::constructJoinedConvexShapeFromMeshes(
   }
 }
 
+namespace {
+// the default broadphase filter, no overlap filter callback is installed
+bool passesCollisionFilter(const btBroadphaseProxy& a,
+                           const btBroadphaseProxy& b) {
+  return (a.m_collisionFilterGroup & b.m_collisionFilterMask) &&
+         (b.m_collisionFilterGroup & a.m_collisionFilterMask);
+}
+
+// removes the pairs of a proxy no longer passing the filter
+struct RemoveFilteredPairsCallback : btOverlapCallback {
+  const btBroadphaseProxy* proxy;
+
+  bool processOverlap(btBroadphasePair& pair) override {
+    return (pair.m_pProxy0 == proxy || pair.m_pProxy1 == proxy) &&
+           !passesCollisionFilter(*pair.m_pProxy0, *pair.m_pProxy1);
+  }
+};
+
+// adds the pairs of a proxy with the proxies it overlaps, existing pairs are
+// kept as they are by the pair cache
+struct AddFilteredPairsCallback : btBroadphaseAabbCallback {
+  btBroadphaseProxy* proxy;
+  btOverlappingPairCache* pairCache;
+
+  bool process(const btBroadphaseProxy* other) override {
+    if (other != proxy && passesCollisionFilter(*proxy, *other)) {
+      pairCache->addOverlappingPair(proxy,
+                                    const_cast<btBroadphaseProxy*>(other));
+    }
+    return true;
+  }
+};
+}  // namespace
+
+bool BulletBase::setCollisionFilter(btCollisionWorld& world,
+                                    btCollisionObject& object,
+                                    int group,
+                                    int mask) {
+  btBroadphaseProxy* proxy = object.getBroadphaseHandle();
+  if (!proxy) {
+    return false;
+  }
+  const int oldGroup = proxy->m_collisionFilterGroup;
+  const int oldMask = proxy->m_collisionFilterMask;
+  if (oldGroup == group && oldMask == mask) {
+    return true;
+  }
+  proxy->m_collisionFilterGroup = group;
+  proxy->m_collisionFilterMask = mask;
+
+  btOverlappingPairCache* pairCache = world.getPairCache();
+  // a narrower filter can only drop pairs, a wider one only add them
+  if ((oldGroup & ~group) || (oldMask & ~mask)) {
+    RemoveFilteredPairsCallback removeCallback;
+    removeCallback.proxy = proxy;
+    pairCache->processAllOverlappingPairs(&removeCallback,
+                                          world.getDispatcher());
+  }
+  if ((group & ~oldGroup) || (mask & ~oldMask)) {
+    AddFilteredPairsCallback addCallback;
+    addCallback.proxy = proxy;
+    addCallback.pairCache = pairCache;
+    world.getBroadphase()->aabbTest(proxy->m_aabbMin, proxy->m_aabbMax,
+                                    addCallback);
+  }
+  return true;
+}
+
 }  // namespace physics
 }  // namespace esp
@@ -8,7 +8,11 @@
 #include <Magnum/BulletIntegration/MotionState.h>
 #include <btBulletDynamicsCommon.h>
 
+#include <map>
+#include <memory>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
@@ -39,6 +43,15 @@ struct SimulationContactResultCallback
    */
   SimulationContactResultCallback() = default;
 
+  /**
+   * @brief Skips the remaining candidates once a contact was found, only
+   * whether there is one matters.
+   */
+  bool needsCollision(btBroadphaseProxy* proxy0) const override {
+    return !bCollision &&
+           btCollisionWorld::ContactResultCallback::needsCollision(proxy0);
+  }
+
   /**
    * @brief Called when a contact is detected.
    *
@@ -60,6 +73,26 @@ struct SimulationContactResultCallback
   }
 };
 
+/**
+ * @brief Key of a @ref CollisionShapeCache entry: the collision asset handle,
+ * whether its meshes are joined into a single convex hull and the local
+ * scaling of the hulls.
+ */
+typedef std::tuple<std::string, bool, float, float, float>
+    CollisionShapeCacheKey;
+
+/**
+ * @brief Convex hulls built from collision assets, shared between objects
+ *
+ * Owned by @ref BulletPhysicsManager so that all instances of an object using
+ * the same collision asset at the same scale reference the same hulls instead
+ * of each building their own. The cached hulls are treated as immutable, an
+ * object modifying its hulls makes a private copy first.
+ */
+typedef std::map<CollisionShapeCacheKey,
+                 std::vector<std::shared_ptr<btConvexHullShape>>>
+    CollisionShapeCache;
+
 /**
  * @brief This class is intended to implement bullet-specific
  */
@@ -96,6 +129,14 @@ class BulletBase {
    */
   virtual Magnum::Range3D getCollisionShapeAabb() const = 0;
 
+  /**
+   * @brief Set the cache to share convex collision shapes through. Has to be
+   * called before the collision shape is constructed to have an effect.
+   */
+  void setCollisionShapeCache(std::shared_ptr<CollisionShapeCache> cache) {
+    collisionShapeCache_ = std::move(cache);
+  }
+
   /**
    * @brief Recursively construct a @ref btConvexHullShape for collision by
    * joining loaded mesh assets.
@@ -133,6 +174,24 @@ class BulletBase {
       btCompoundShape* bObjectShape,
       std::vector<std::unique_ptr<btConvexHullShape>>& bObjectConvexShapes);
 
+  /**
+   * @brief Change the collision filter group and mask of an object in place.
+   *
+   * Unlike removing the object from @p world and adding it back, keeps its
+   * broadphase proxy and the overlapping pairs still passing the new filter.
+   * Only the pairs of the object are touched: those failing the filter are
+   * removed and overlaps newly passing it are added.
+   * @param world The world the object is in.
+   * @param object The object to update.
+   * @param group The new collision filter group.
+   * @param mask The new collision filter mask.
+   * @return False if the object isn't in a world, nothing is changed then.
+   */
+  static bool setCollisionFilter(btCollisionWorld& world,
+                                 btCollisionObject& object,
+                                 int group,
+                                 int mask);
+
  protected:
   /** @brief A pointer to the Bullet world to which this object belongs. See
    * @ref btMultiBodyDynamicsWorld.*/
@@ -143,8 +202,12 @@ class BulletBase {
    */
   std::vector<std::unique_ptr<btRigidBody>> bStaticCollisionObjects_;
 
-  //! Object data: Composite convex collision shape
-  std::vector<std::unique_ptr<btConvexHullShape>> bObjectConvexShapes_;
+  //! Object data: Composite convex collision shape. Possibly shared with
+  //! other objects through @ref collisionShapeCache_.
+  std::vector<std::shared_ptr<btConvexHullShape>> bObjectConvexShapes_;
+
+  //! Cache of convex collision shapes shared with other objects, may be null
+  std::shared_ptr<CollisionShapeCache> collisionShapeCache_;
 
   //! list of @ref btCollisionShape for storing arbitrary collision shapes
   //! referenced within the @ref bObjectShape_.
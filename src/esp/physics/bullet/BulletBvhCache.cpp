@@ -0,0 +1,143 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletBvhCache.h"
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include <cstring>
+#include <utility>
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "LinearMath/btAlignedAllocator.h"
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Hash.h"
+#include "esp/core/Logging.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+constexpr char BvhCacheMagic[8]{'\x89', 'E', 'S', 'P', 'B', 'V', 'H', '\0'};
+
+struct BvhCacheHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t scalarSize;
+  std::uint64_t bvhSize;
+};
+
+// deSerializeInPlace() requires the buffer to be 16-byte aligned
+Cr::Containers::Array<char> allocateBvhStorage(std::size_t size) {
+  return Cr::Containers::Array<char>{
+      static_cast<char*>(btAlignedAlloc(size, 16)), size,
+      [](char* data, std::size_t) { btAlignedFree(data); }};
+}
+
+}  // namespace
+
+std::string bvhCacheFilename(const std::string& cacheDirectory,
+                             const std::string& collisionAssetFilename,
+                             const assets::CollisionMeshData& mesh,
+                             const Mn::Vector3& scaling) {
+  // everything the serialized BVH depends on
+  core::Fnv1aHash hash;
+  const std::uint32_t layout[]{BvhCacheVersion, sizeof(btScalar),
+                               sizeof(void*)};
+  hash.add(layout, sizeof(layout));
+  hash.add(scaling);
+  hash.add(mesh.positions.data(),
+           mesh.positions.size() * sizeof(Mn::Vector3));
+  hash.add(mesh.indices.data(),
+           mesh.indices.size() * sizeof(Mn::UnsignedInt));
+
+  return Cr::Utility::Path::join(
+      cacheDirectory,
+      Cr::Utility::formatString(
+          "{}.{}.bvh",
+          Cr::Utility::Path::split(collisionAssetFilename).second(),
+          core::hashHexString(hash.value())));
+}
+
+bool writeBvhCache(const std::string& filename, const btOptimizedBvh& bvh) {
+  const unsigned bvhSize = bvh.calculateSerializeBufferSize();
+  Cr::Containers::Array<char> serialized = allocateBvhStorage(bvhSize);
+  if (!bvh.serialize(serialized.data(), bvhSize, false)) {
+    ESP_WARNING() << "Unable to serialize the BVH for" << filename;
+    return false;
+  }
+
+  BvhCacheHeader header{};
+  std::memcpy(header.magic, BvhCacheMagic, sizeof(header.magic));
+  header.version = BvhCacheVersion;
+  header.scalarSize = sizeof(btScalar);
+  header.bvhSize = bvhSize;
+  std::string data;
+  data.reserve(sizeof(header) + bvhSize);
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  data.append(serialized.data(), bvhSize);
+
+  if (!core::writeFileAtomically(
+          filename,
+          Cr::Containers::ArrayView<const void>{data.data(), data.size()})) {
+    ESP_WARNING() << "Unable to write the BVH cache" << filename;
+    return false;
+  }
+  return true;
+}
+
+btOptimizedBvh* readBvhCache(const std::string& filename,
+                             Cr::Containers::Array<char>& storage) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return nullptr;
+  }
+  const Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    return nullptr;
+  }
+
+  BvhCacheHeader header;
+  bool valid = file->size() >= sizeof(header);
+  if (valid) {
+    std::memcpy(&header, file->data(), sizeof(header));
+    valid = std::memcmp(header.magic, BvhCacheMagic, sizeof(header.magic)) ==
+                0 &&
+            header.version == BvhCacheVersion &&
+            header.scalarSize == sizeof(btScalar) &&
+            header.bvhSize >= sizeof(btQuantizedBvh) &&
+            header.bvhSize == file->size() - sizeof(header);
+  }
+
+  btOptimizedBvh* bvh = nullptr;
+  if (valid) {
+    Cr::Containers::Array<char> bvhStorage =
+        allocateBvhStorage(header.bvhSize);
+    std::memcpy(bvhStorage.data(), file->data() + sizeof(header),
+                header.bvhSize);
+    // returns null if the buffer is smaller than the BVH it describes.
+    // btOptimizedBvh only adds functions to btQuantizedBvh, the cast is how
+    // Bullet's own demos load serialized BVHs.
+    bvh = static_cast<btOptimizedBvh*>(btOptimizedBvh::deSerializeInPlace(
+        bvhStorage.data(), header.bvhSize, false));
+    if (bvh) {
+      storage = std::move(bvhStorage);
+    }
+  }
+  if (!bvh) {
+    ESP_WARNING() << "Ignoring the invalid or outdated BVH cache" << filename;
+  }
+  return bvh;
+}
+
+}  // namespace physics
+}  // namespace esp
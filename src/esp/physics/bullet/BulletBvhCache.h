@@ -0,0 +1,72 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETBVHCACHE_H_
+#define ESP_PHYSICS_BULLET_BULLETBVHCACHE_H_
+
+/** @file
+ * @brief Serialized BVH files for stage collision meshes, see
+ * @ref esp::physics::readBvhCache()
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <string>
+
+#include "esp/assets/CollisionMeshData.h"
+
+class btOptimizedBvh;
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Version of the BVH cache files written by @ref writeBvhCache()
+ *
+ * Files with a different version are ignored by @ref readBvhCache().
+ */
+constexpr std::uint32_t BvhCacheVersion = 1;
+
+/**
+ * @brief Filename of the cached BVH of a stage collision mesh
+ * @param cacheDirectory Directory holding the cache files.
+ * @param collisionAssetFilename The collision asset the mesh is part of.
+ * @param mesh The collision mesh.
+ * @param scaling Scaling the BVH is built with.
+ *
+ * The file is keyed by a hash of the mesh vertices and indices, the scaling
+ * and the memory layout of the serialized BVH, so it's neither used for a
+ * changed asset nor by a Bullet build with a different scalar type.
+ */
+std::string bvhCacheFilename(const std::string& cacheDirectory,
+                             const std::string& collisionAssetFilename,
+                             const assets::CollisionMeshData& mesh,
+                             const Magnum::Vector3& scaling);
+
+/**
+ * @brief Write the quantized BVH of a triangle mesh shape to a cache file
+ *
+ * The file is written to a temporary file first and then moved into place,
+ * so a concurrent @ref readBvhCache() never sees a partially written file.
+ * @return Whether the file was written successfully
+ */
+bool writeBvhCache(const std::string& filename, const btOptimizedBvh& bvh);
+
+/**
+ * @brief Read a BVH cache file
+ * @param filename The file written by @ref writeBvhCache().
+ * @param[out] storage Memory the BVH is deserialized into in place. Has to
+ * outlive the returned BVH and any shape it's set on.
+ * @return The BVH, to be set on a shape with
+ * @ref btBvhTriangleMeshShape::setOptimizedBvh(), or @cpp nullptr @ce if the
+ * file doesn't exist or is invalid or outdated.
+ */
+btOptimizedBvh* readBvhCache(const std::string& filename,
+                             Corrade::Containers::Array<char>& storage);
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETBVHCACHE_H_
@@ -0,0 +1,250 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletConvexHullCache.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/BulletIntegration/Integration.h>
+
+#include <cstring>
+
+#include "BulletBase.h"
+#include "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#include "BulletCollision/CollisionShapes/btShapeHull.h"
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Hash.h"
+#include "esp/core/Logging.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+constexpr char ConvexHullCacheMagic[8]{'\x89', 'E', 'S', 'P',
+                                       'H', 'U', 'L', 'L'};
+
+// Reduce a hull to the vertices btShapeHull finds by sampling support
+// directions. Falls back to the original points for degenerate input.
+std::vector<Mn::Vector3> simplifyHull(const btConvexHullShape& shape) {
+  std::vector<Mn::Vector3> out;
+  btShapeHull hull{&shape};
+  if (shape.getNumPoints() > 3 && hull.buildHull(0.0) &&
+      hull.numVertices() > 3) {
+    out.reserve(hull.numVertices());
+    for (int i = 0; i < hull.numVertices(); ++i) {
+      out.emplace_back(hull.getVertexPointer()[i]);
+    }
+  } else {
+    out.reserve(shape.getNumPoints());
+    for (int i = 0; i < shape.getNumPoints(); ++i) {
+      out.emplace_back(shape.getUnscaledPoints()[i]);
+    }
+  }
+  return out;
+}
+
+void writeHull(Cr::Containers::Array<char>& out,
+               const std::vector<Mn::Vector3>& hull) {
+  const auto count = std::uint32_t(hull.size());
+  Cr::Containers::arrayAppend(
+      out, Cr::Containers::arrayView(reinterpret_cast<const char*>(&count),
+                                     sizeof(count)));
+  Cr::Containers::arrayAppend(
+      out, Cr::Containers::arrayView(
+               reinterpret_cast<const char*>(hull.data()),
+               hull.size() * sizeof(Mn::Vector3)));
+}
+
+class Reader {
+ public:
+  explicit Reader(Cr::Containers::ArrayView<const char> data) : data_{data} {}
+
+  bool failed() const { return failed_; }
+
+  template <class T>
+  T read() {
+    T value{};
+    if (failed_ || data_.size() - offset_ < sizeof(T)) {
+      failed_ = true;
+      return value;
+    }
+    std::memcpy(&value, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  std::vector<Mn::Vector3> readHull() {
+    const std::size_t count = read<std::uint32_t>();
+    if (failed_ || (data_.size() - offset_) / sizeof(Mn::Vector3) < count) {
+      failed_ = true;
+      return {};
+    }
+    std::vector<Mn::Vector3> hull(count);
+    std::memcpy(hull.data(), data_.data() + offset_,
+                count * sizeof(Mn::Vector3));
+    offset_ += count * sizeof(Mn::Vector3);
+    return hull;
+  }
+
+ private:
+  Cr::Containers::ArrayView<const char> data_;
+  std::size_t offset_ = 0;
+  bool failed_ = false;
+};
+
+std::unique_ptr<btConvexHullShape> makeShape(
+    const std::vector<Mn::Vector3>& hull) {
+  auto shape = std::make_unique<btConvexHullShape>();
+  for (const Mn::Vector3& point : hull) {
+    shape->addPoint(btVector3{point}, false);
+  }
+  shape->recalcLocalAabb();
+  return shape;
+}
+
+}  // namespace
+
+std::string convexHullCacheFilename(
+    const std::string& collisionAssetFilename) {
+  return collisionAssetFilename + ".hulls";
+}
+
+Cr::Containers::Optional<std::uint64_t> convexHullCacheSourceHash(
+    const std::string& collisionAssetFilename) {
+  const Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(collisionAssetFilename);
+  if (!file) {
+    return Cr::Containers::NullOpt;
+  }
+  core::Fnv1aHash hash;
+  hash.add(file->data(), file->size());
+  return hash.value();
+}
+
+ConvexHullCacheData computeConvexHulls(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root) {
+  ConvexHullCacheData data;
+
+  std::vector<std::unique_ptr<btConvexHullShape>> shapes;
+  BulletBase::constructConvexShapesFromMeshes(Mn::Matrix4{}, meshGroup, root,
+                                              nullptr, shapes);
+  data.hulls.reserve(shapes.size());
+  for (const auto& shape : shapes) {
+    data.hulls.push_back(simplifyHull(*shape));
+  }
+
+  btConvexHullShape joined;
+  BulletBase::constructJoinedConvexShapeFromMeshes(Mn::Matrix4{}, meshGroup,
+                                                   root, &joined);
+  joined.setMargin(0.0);
+  joined.recalcLocalAabb();
+  data.joinedHull = simplifyHull(joined);
+
+  return data;
+}
+
+bool writeConvexHullCache(const std::string& filename,
+                          const ConvexHullCacheData& data) {
+  Cr::Containers::Array<char> out;
+  Cr::Containers::arrayAppend(out,
+                              Cr::Containers::arrayView(ConvexHullCacheMagic));
+  const std::uint32_t header[]{ConvexHullCacheVersion,
+                               std::uint32_t(data.hulls.size())};
+  Cr::Containers::arrayAppend(
+      out, Cr::Containers::arrayView(reinterpret_cast<const char*>(header),
+                                     sizeof(header)));
+  Cr::Containers::arrayAppend(
+      out,
+      Cr::Containers::arrayView(
+          reinterpret_cast<const char*>(&data.sourceHash),
+          sizeof(data.sourceHash)));
+  for (const std::vector<Mn::Vector3>& hull : data.hulls) {
+    writeHull(out, hull);
+  }
+  writeHull(out, data.joinedHull);
+
+  return core::writeFileAtomically(filename, out);
+}
+
+Cr::Containers::Optional<ConvexHullCacheData> readConvexHullCache(
+    const std::string& filename) {
+  const Cr::Containers::Optional<Cr::Containers::Array<char>> file =
+      Cr::Utility::Path::read(filename);
+  if (!file) {
+    ESP_ERROR() << "Can't read convex hull cache" << filename;
+    return Cr::Containers::NullOpt;
+  }
+
+  if (file->size() < sizeof(ConvexHullCacheMagic) ||
+      std::memcmp(file->data(), ConvexHullCacheMagic,
+                  sizeof(ConvexHullCacheMagic)) != 0) {
+    ESP_ERROR() << filename << "is not a convex hull cache";
+    return Cr::Containers::NullOpt;
+  }
+
+  Reader reader{file->exceptPrefix(sizeof(ConvexHullCacheMagic))};
+  const auto version = reader.read<std::uint32_t>();
+  if (!reader.failed() && version != ConvexHullCacheVersion) {
+    ESP_ERROR() << "Convex hull cache" << filename << "has version" << version
+                << "but expected" << ConvexHullCacheVersion;
+    return Cr::Containers::NullOpt;
+  }
+
+  ConvexHullCacheData data;
+  const std::size_t hullCount = reader.read<std::uint32_t>();
+  data.sourceHash = reader.read<std::uint64_t>();
+  for (std::size_t i = 0; i != hullCount && !reader.failed(); ++i) {
+    data.hulls.push_back(reader.readHull());
+  }
+  data.joinedHull = reader.readHull();
+  if (reader.failed()) {
+    ESP_ERROR() << "Convex hull cache" << filename << "is truncated";
+    return Cr::Containers::NullOpt;
+  }
+
+  return data;
+}
+
+bool loadConvexShapesFromHullCache(
+    const std::string& collisionAssetFilename,
+    bool joinCollisionMeshes,
+    std::vector<std::unique_ptr<btConvexHullShape>>& shapes) {
+  const std::string filename = convexHullCacheFilename(collisionAssetFilename);
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+
+  Cr::Containers::Optional<ConvexHullCacheData> data =
+      readConvexHullCache(filename);
+  if (!data) {
+    ESP_WARNING() << "Ignoring unreadable convex hull cache" << filename;
+    return false;
+  }
+  const Cr::Containers::Optional<std::uint64_t> sourceHash =
+      convexHullCacheSourceHash(collisionAssetFilename);
+  if (!sourceHash || *sourceHash != data->sourceHash) {
+    ESP_WARNING() << "Ignoring convex hull cache" << filename
+                  << "as it's out of date with" << collisionAssetFilename;
+    return false;
+  }
+
+  if (joinCollisionMeshes) {
+    shapes.push_back(makeShape(data->joinedHull));
+  } else {
+    for (const std::vector<Mn::Vector3>& hull : data->hulls) {
+      shapes.push_back(makeShape(hull));
+    }
+  }
+  return true;
+}
+
+}  // namespace physics
+}  // namespace esp
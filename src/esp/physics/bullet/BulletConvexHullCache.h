@@ -0,0 +1,143 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETCONVEXHULLCACHE_H_
+#define ESP_PHYSICS_BULLET_BULLETCONVEXHULLCACHE_H_
+
+/** @file
+ * @brief Precomputed convex hull files for collision assets, see
+ * @ref esp::physics::ConvexHullCacheData
+ */
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esp/assets/CollisionMeshData.h"
+#include "esp/assets/MeshMetaData.h"
+
+class btConvexHullShape;
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Version of the convex hull cache files written by
+ * @ref writeConvexHullCache()
+ *
+ * Files with a different version are ignored by @ref readConvexHullCache().
+ */
+constexpr std::uint32_t ConvexHullCacheVersion = 2;
+
+/**
+ * @brief Precomputed convex hulls of a collision asset
+ *
+ * Computed offline by @ref computeConvexHulls(), e.g. with the
+ * `create_convex_hull_cache` task of the datatool, and stored next to the
+ * collision asset. @ref BulletRigidObject then builds its collision shapes
+ * from the simplified hull points instead of computing them from all mesh
+ * vertices on every load.
+ */
+struct ConvexHullCacheData {
+  /**
+   * @brief Hash of the collision asset file the hulls were computed from
+   *
+   * Used to detect a cache that's out of date with the asset, see
+   * @ref convexHullCacheSourceHash().
+   */
+  std::uint64_t sourceHash = 0;
+
+  /**
+   * @brief One hull for each mesh of the asset
+   *
+   * In object-local space and in the same order as the shapes created by
+   * @ref BulletBase::constructConvexShapesFromMeshes().
+   */
+  std::vector<std::vector<Magnum::Vector3>> hulls;
+
+  /**
+   * @brief Single hull of all meshes joined
+   *
+   * Same as the shape created by
+   * @ref BulletBase::constructJoinedConvexShapeFromMeshes().
+   */
+  std::vector<Magnum::Vector3> joinedHull;
+};
+
+/**
+ * @brief Filename of the convex hull cache of a collision asset
+ *
+ * The cache is stored next to the asset, with `.hulls` appended to its
+ * filename.
+ */
+std::string convexHullCacheFilename(const std::string& collisionAssetFilename);
+
+/**
+ * @brief Hash of the contents of a collision asset file
+ *
+ * Stored in @ref ConvexHullCacheData::sourceHash. Returns
+ * @ref Corrade::Containers::NullOpt if the file can't be read.
+ */
+Corrade::Containers::Optional<std::uint64_t> convexHullCacheSourceHash(
+    const std::string& collisionAssetFilename);
+
+/**
+ * @brief Compute simplified convex hulls of a collision asset
+ * @param meshGroup Collision mesh data of the asset.
+ * @param root Root of the asset's @ref assets::MeshTransformNode tree.
+ *
+ * The hulls are reduced with @ref btShapeHull to at most a few dozen
+ * vertices each, which makes collision detection against them cheaper than
+ * against hulls of all mesh vertices. @ref ConvexHullCacheData::sourceHash
+ * is left at zero.
+ */
+ConvexHullCacheData computeConvexHulls(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root);
+
+/**
+ * @brief Write a convex hull cache file
+ * @return Whether the file was written successfully
+ *
+ * The file is moved in place only once complete, see
+ * @ref core::writeFileAtomically().
+ */
+bool writeConvexHullCache(const std::string& filename,
+                          const ConvexHullCacheData& data);
+
+/**
+ * @brief Read a convex hull cache file
+ *
+ * Prints a message to the error output and returns
+ * @ref Corrade::Containers::NullOpt if the file can't be read, isn't a convex
+ * hull cache, has a different version or is truncated.
+ */
+Corrade::Containers::Optional<ConvexHullCacheData> readConvexHullCache(
+    const std::string& filename);
+
+/**
+ * @brief Create convex shapes of a collision asset from its hull cache
+ * @param collisionAssetFilename The collision asset.
+ * @param joinCollisionMeshes Whether to create a single shape of all meshes
+ * joined, or one shape for each mesh.
+ * @param[out] shapes Created shapes, unscaled and with default margin.
+ * @return Whether a cache was found and the shapes were created from it.
+ *
+ * Returns @cpp false @ce silently if the asset has no cache. If the cache
+ * is out of date with the asset or can't be read, prints a warning and returns
+ * @cpp false @ce as well, in which case the shapes should be computed from
+ * the meshes.
+ */
+bool loadConvexShapesFromHullCache(
+    const std::string& collisionAssetFilename,
+    bool joinCollisionMeshes,
+    std::vector<std::unique_ptr<btConvexHullShape>>& shapes);
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETCONVEXHULLCACHE_H_
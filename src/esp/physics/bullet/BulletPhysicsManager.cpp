@@ -7,13 +7,18 @@
 
 #include "BulletPhysicsManager.h"
 
+#include <chrono>
 #include <utility>
 #include "BulletArticulatedObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletRigidObject.h"
 #include "BulletURDFImporter.h"
+#include "LinearMath/btThreads.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
+#include "esp/core/ParallelFor.h"
 #include "esp/metadata/attributes/PhysicsManagerAttributes.h"
 #include "esp/physics/bullet/BulletRigidStage.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
@@ -24,6 +29,152 @@
 namespace esp {
 namespace physics {
 
+namespace {
+
+// Install Bullet's default task scheduler with numThreads threads (<= 0 for
+// all of them). The scheduler is process-wide, so the last physics manager
+// initialized decides the thread count. Returns false if Bullet wasn't built
+// with BULLET2_MULTITHREADING and thus has no task scheduler to offer.
+bool setupBulletTaskScheduler(int numThreads) {
+  static btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+  if (!scheduler) {
+    return false;
+  }
+  if (btGetTaskScheduler() != scheduler) {
+    btSetTaskScheduler(scheduler);
+  }
+  scheduler->setNumThreads(numThreads > 0 ? numThreads
+                                          : scheduler->getMaxNumThreads());
+  return true;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Accumulates the time spent in the collision detection and constraint solver
+// phases of each substep into a PhysicsStepProfile. Bullet's own profiler is
+// compiled out with BT_NO_PROFILE.
+class ProfiledMultiBodyDynamicsWorld : public btMultiBodyDynamicsWorld {
+ public:
+  ProfiledMultiBodyDynamicsWorld(btDispatcher* dispatcher,
+                                 btBroadphaseInterface* broadphase,
+                                 btMultiBodyConstraintSolver* solver,
+                                 btCollisionConfiguration* collisionConfig,
+                                 PhysicsStepProfile& profile)
+      : btMultiBodyDynamicsWorld{dispatcher, broadphase, solver,
+                                 collisionConfig},
+        profile_(profile) {}
+
+  // Time accumulated towards the next fixed substep
+  btScalar localTime() const { return m_localTime; }
+
+  // Same as btCollisionWorld::performDiscreteCollisionDetection(), with the
+  // broadphase and narrowphase timed separately
+  void performDiscreteCollisionDetection() override {
+    const auto start = std::chrono::steady_clock::now();
+    updateAabbs();
+    computeOverlappingPairs();
+    profile_.broadphaseMs += millisecondsSince(start);
+
+    const auto narrowphaseStart = std::chrono::steady_clock::now();
+    if (btDispatcher* dispatcher = getDispatcher()) {
+      dispatcher->dispatchAllCollisionPairs(
+          m_broadphasePairCache->getOverlappingPairCache(), getDispatchInfo(),
+          m_dispatcher1);
+    }
+    profile_.narrowphaseMs += millisecondsSince(narrowphaseStart);
+  }
+
+ protected:
+  void solveConstraints(btContactSolverInfo& solverInfo) override {
+    const auto start = std::chrono::steady_clock::now();
+    btMultiBodyDynamicsWorld::solveConstraints(solverInfo);
+    profile_.solverMs += millisecondsSince(start);
+  }
+
+ private:
+  PhysicsStepProfile& profile_;
+};
+
+// Casts a single ray against every broadphase leaf it passes through,
+// keeping the closest hit. btDbvt::rayTest() keeps its traversal stack local,
+// so unlike btCollisionWorld::rayTest() this only reads the world.
+struct ClosestRayTest : btDbvt::ICollide {
+  ClosestRayTest(const btVector3& rayFrom, const btVector3& rayTo)
+      : from{rayFrom}, to{rayTo}, callback{rayFrom, rayTo} {
+    fromTransform.setIdentity();
+    fromTransform.setOrigin(rayFrom);
+    toTransform.setIdentity();
+    toTransform.setOrigin(rayTo);
+  }
+
+  void Process(const btDbvtNode* leaf) {
+    // a hit at the ray origin can't be beaten
+    if (callback.m_closestHitFraction == btScalar(0.0)) {
+      return;
+    }
+    auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+    if (!callback.needsCollision(proxy)) {
+      return;
+    }
+    const auto* object =
+        static_cast<const btCollisionObject*>(proxy->m_clientObject);
+    btCollisionWorld::rayTestSingle(fromTransform, toTransform, object,
+                                    object->getCollisionShape(),
+                                    object->getWorldTransform(), callback);
+  }
+
+  btVector3 from, to;
+  btTransform fromTransform, toTransform;
+  btCollisionWorld::ClosestRayResultCallback callback;
+};
+
+template <class Key, class T>
+std::unique_ptr<T> takePooledConstraint(
+    std::multimap<Key, std::unique_ptr<T>>& pool,
+    const Key& key) {
+  auto pooledIter = pool.find(key);
+  if (pooledIter == pool.end()) {
+    return nullptr;
+  }
+  std::unique_ptr<T> constraint = std::move(pooledIter->second);
+  pool.erase(pooledIter);
+  return constraint;
+}
+
+// the objects are the first and third element of all pool keys
+template <class Key, class T>
+void erasePooledConstraints(std::multimap<Key, std::unique_ptr<T>>& pool,
+                            int objectId) {
+  for (auto pooledIter = pool.begin(); pooledIter != pool.end();) {
+    if (std::get<0>(pooledIter->first) == objectId ||
+        std::get<2>(pooledIter->first) == objectId) {
+      pooledIter = pool.erase(pooledIter);
+    } else {
+      ++pooledIter;
+    }
+  }
+}
+
+std::tuple<int, int, int, int> constraintPoolKey(
+    const RigidConstraintSettings& settings) {
+  return std::make_tuple(settings.objectIdA, settings.linkIdA,
+                         settings.objectIdB, settings.linkIdB);
+}
+
+std::tuple<int, int, int, int, float, float, float>
+articulatedP2PConstraintPoolKey(const RigidConstraintSettings& settings) {
+  return std::tuple_cat(constraintPoolKey(settings),
+                        std::make_tuple(settings.pivotA.x(),
+                                        settings.pivotA.y(),
+                                        settings.pivotA.z()));
+}
+
+}  // namespace
+
 BulletPhysicsManager::BulletPhysicsManager(
     assets::ResourceManager& _resourceManager,
     const metadata::attributes::PhysicsManagerAttributes::cptr&
@@ -35,10 +186,25 @@ BulletPhysicsManager::BulletPhysicsManager(
   if (_resourceManager.getCreateRenderer()) {
     debugDrawer_ = std::make_unique<Magnum::BulletIntegration::DebugDraw>();
   }
+  // shapes built from an evicted asset would be reused for a reload of it
+  assetEvictionCallbackId_ = _resourceManager.addAssetEvictionCallback(
+      [this](const std::string& filename) {
+        for (auto it = collisionShapeCache_->begin();
+             it != collisionShapeCache_->end();) {
+          if (std::get<0>(it->first) == filename) {
+            it = collisionShapeCache_->erase(it);
+          } else {
+            ++it;
+          }
+        }
+        static_cast<BulletURDFImporter*>(urdfImporter_.get())
+            ->evictMeshCollisionShapes(filename);
+      });
 }
 
 BulletPhysicsManager::~BulletPhysicsManager() {
   ESP_DEBUG() << "Deconstructing BulletPhysicsManager";
+  resourceManager_.removeAssetEvictionCallback(assetEvictionCallbackId_);
   existingObjects_.clear();
   existingArticulatedObjects_.clear();
   staticStageObject_.reset();
@@ -49,6 +215,7 @@ void BulletPhysicsManager::removeObject(const int objectId,
                                         bool deleteVisualNode) {
   removeObjectRigidConstraints(objectId);
   PhysicsManager::removeObject(objectId, deleteObjectNode, deleteVisualNode);
+  objectContactPointsValid_ = false;
 }
 
 void BulletPhysicsManager::removeArticulatedObject(int objectId) {
@@ -60,16 +227,33 @@ void BulletPhysicsManager::removeArticulatedObject(int objectId) {
 
   removeObjectRigidConstraints(objectId);
   PhysicsManager::removeArticulatedObject(objectId);
+  objectContactPointsValid_ = false;
 }
 
 bool BulletPhysicsManager::initPhysicsFinalize() {
   activePhysSimLib_ = PhysicsSimulationLibrary::Bullet;
 
+  const int numCollisionThreads =
+      physicsManagerAttributes_->getNumCollisionThreads();
+  if (numCollisionThreads != 1 &&
+      setupBulletTaskScheduler(numCollisionThreads)) {
+    bDispatcher_ =
+        std::make_unique<btCollisionDispatcherMt>(&bCollisionConfig_);
+  } else {
+    if (numCollisionThreads != 1) {
+      ESP_WARNING() << "Bullet was built without multithreading support, "
+                       "ignoring num_collision_threads ="
+                    << numCollisionThreads;
+    }
+    bDispatcher_ = std::make_unique<btCollisionDispatcher>(&bCollisionConfig_);
+  }
+
   //! We can potentially use other collision checking algorithms, by
   //! uncommenting the line below
-  // btGImpactCollisionAlgorithm::registerAlgorithm(&bDispatcher_);
-  bWorld_ = std::make_shared<btMultiBodyDynamicsWorld>(
-      &bDispatcher_, &bBroadphase_, &bSolver_, &bCollisionConfig_);
+  // btGImpactCollisionAlgorithm::registerAlgorithm(bDispatcher_.get());
+  bWorld_ = std::make_shared<ProfiledMultiBodyDynamicsWorld>(
+      bDispatcher_.get(), &bBroadphase_, &bSolver_, &bCollisionConfig_,
+      lastStepProfile_);
 
   if (debugDrawer_) {
     debugDrawer_->setMode(
@@ -101,6 +285,10 @@ bool BulletPhysicsManager::addStageFinalize(
   return sceneSuccess;
 }
 
+void BulletPhysicsManager::addObjectInstancesFinalize() {
+  bBroadphase_.optimize();
+}
+
 bool BulletPhysicsManager::makeAndAddRigidObject(
     int newObjectID,
     const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes,
@@ -108,6 +296,8 @@ bool BulletPhysicsManager::makeAndAddRigidObject(
   auto ptr = physics::BulletRigidObject::create(objectNode, newObjectID,
                                                 resourceManager_, bWorld_,
                                                 collisionObjToObjIds_);
+  ptr->setCollisionShapeCache(collisionShapeCache_);
+  ptr->setDeferredNodeUpdates(deferredNodeUpdates_);
   bool objSuccess = ptr->initialize(objectAttributes);
   if (objSuccess) {
     existingObjects_.emplace(newObjectID, std::move(ptr));
@@ -381,6 +571,7 @@ Magnum::Vector3 BulletPhysicsManager::getGravity() const {
 }
 
 void BulletPhysicsManager::stepPhysics(double dt) {
+  ESP_TRACE_SCOPE("stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -389,6 +580,11 @@ void BulletPhysicsManager::stepPhysics(double dt) {
     dt = fixedTimeStep_;
   }
 
+  const auto start = std::chrono::steady_clock::now();
+  lastStepProfile_.broadphaseMs = 0.0;
+  lastStepProfile_.narrowphaseMs = 0.0;
+  lastStepProfile_.solverMs = 0.0;
+
   // set specified control velocities
   for (auto& objectItr : existingObjects_) {
     VelocityControl::ptr velControl = objectItr.second->getVelocityControl();
@@ -431,11 +627,98 @@ void BulletPhysicsManager::stepPhysics(double dt) {
 
   // ==== Physics stepforward ======
   // NOTE: worldTime_ will always be a multiple of sceneMetaData_.timestep
+  // Bullet keeps the time left over after the last whole substep and drops
+  // substeps beyond maxSubsteps_, so compute how many were due beforehand
+  const int numSubStepsRequested = int(
+      (static_cast<ProfiledMultiBodyDynamicsWorld&>(*bWorld_).localTime() +
+       btScalar(dt)) /
+      btScalar(fixedTimeStep_));
   int numSubStepsTaken =
-      bWorld_->stepSimulation(dt, /*maxSubSteps*/ 10000, fixedTimeStep_);
+      bWorld_->stepSimulation(dt, maxSubsteps_, fixedTimeStep_);
   worldTime_ += numSubStepsTaken * fixedTimeStep_;
   recentNumSubStepsTaken_ = numSubStepsTaken;
   recentTimeStep_ = fixedTimeStep_;
+  objectContactPointsValid_ = false;
+
+  recordSubsteps(numSubStepsRequested, numSubStepsTaken);
+  lastStepProfile_.stepMs = millisecondsSince(start);
+}
+
+void BulletPhysicsManager::contactTestRigidObjectPoses(
+    int physObjectID,
+    Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+    Cr::Containers::ArrayView<bool> inContact) {
+  ESP_CHECK(inContact.size() == poses.size(),
+            "BulletPhysicsManager::contactTestRigidObjectPoses(): expected"
+                << poses.size() << "results but got" << inContact.size());
+  auto objIter = getRigidObjIteratorOrAssert(physObjectID);
+  static_cast<BulletRigidObject*>(objIter->second.get())
+      ->contactTestPoses(poses, inContact);
+}
+
+void BulletPhysicsManager::contactTestArticulatedObjectJointPositions(
+    int physObjectID,
+    const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+    Cr::Containers::ArrayView<bool> inContact) {
+  ESP_CHECK(inContact.size() == jointPositions.size()[0],
+            "BulletPhysicsManager::contactTestArticulatedObjectJointPositions()"
+            ": expected"
+                << jointPositions.size()[0] << "results but got"
+                << inContact.size());
+  static_cast<BulletArticulatedObject&>(getArticulatedObject(physObjectID))
+      .contactTestJointPositions(jointPositions, inContact);
+}
+
+void BulletPhysicsManager::setArticulatedObjectsJointPositions(
+    Cr::Containers::ArrayView<const int> objectIDs,
+    const Cr::Containers::StridedArrayView2D<const float>& positions) {
+  std::vector<BulletArticulatedObject*> objects;
+  objects.reserve(objectIDs.size());
+  for (std::size_t i = 0; i != objectIDs.size(); ++i) {
+    auto& object = static_cast<BulletArticulatedObject&>(
+        getArticulatedObject(objectIDs[i]));
+    object.writeJointPositionsFrom(positions[i]);
+    objects.push_back(&object);
+  }
+  for (BulletArticulatedObject* object : objects) {
+    object->updateKinematicTransforms();
+  }
+  for (BulletArticulatedObject* object : objects) {
+    object->updateKinematicAabbs();
+  }
+  for (BulletArticulatedObject* object : objects) {
+    object->updateKinematicNodes();
+  }
+}
+
+void BulletPhysicsManager::deferNodesUpdate() {
+  deferredNodeUpdates_->deferring = true;
+  for (auto& ao : existingArticulatedObjects_) {
+    ao.second->deferUpdate();
+  }
+}
+
+void BulletPhysicsManager::updateNodes() {
+  const auto start = std::chrono::steady_clock::now();
+  deferredNodeUpdates_->deferring = false;
+  for (const int objectId : deferredNodeUpdates_->objectIds) {
+    // the object may have been removed since
+    auto objectItr = existingObjects_.find(objectId);
+    if (objectItr != existingObjects_.end()) {
+      objectItr->second->updateNodes();
+    }
+  }
+  deferredNodeUpdates_->objectIds.clear();
+
+  int numSkipped = 0;
+  for (auto& ao : existingArticulatedObjects_) {
+    if (!static_cast<BulletArticulatedObject&>(*ao.second).nodesNeedSync()) {
+      ++numSkipped;
+    }
+    ao.second->updateNodes();
+  }
+  lastStepProfile_.numArticulatedObjectSyncsSkipped = numSkipped;
+  lastStepProfile_.updateNodesMs = millisecondsSince(start);
 }
 
 void BulletPhysicsManager::setStageFrictionCoefficient(
@@ -512,6 +795,55 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
   return results;
 }
 
+void BulletPhysicsManager::castRays(
+    Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+    double maxDistance,
+    Cr::Containers::ArrayView<RayHitInfo> closestHits,
+    int numThreads) {
+  ESP_CHECK(closestHits.size() == rays.size(),
+            "BulletPhysicsManager::castRays(): expected"
+                << rays.size() << "hits but got" << closestHits.size());
+
+  // the dynamic and the static broadphase tree
+  const btDbvtNode* const roots[]{bBroadphase_.m_sets[0].m_root,
+                                  bBroadphase_.m_sets[1].m_root};
+
+  core::parallelFor(rays.size(), numThreads, [&](std::size_t i, int) {
+    const esp::geo::Ray& ray = rays[i];
+    RayHitInfo& hit = closestHits[i];
+    hit = RayHitInfo{};
+    hit.objectId = ID_UNDEFINED;
+    hit.rayDistance = -1.0;
+    if (ray.direction.isZero()) {
+      return;
+    }
+
+    ClosestRayTest test{btVector3{ray.origin},
+                        btVector3{ray.origin + ray.direction * maxDistance}};
+    for (const btDbvtNode* root : roots) {
+      if (root) {
+        btDbvt::rayTest(root, test.from, test.to, test);
+      }
+    }
+    if (!test.callback.hasHit()) {
+      return;
+    }
+
+    hit.normal = Magnum::Vector3{test.callback.m_hitNormalWorld};
+    hit.point = Magnum::Vector3{test.callback.m_hitPointWorld};
+    hit.rayDistance =
+        static_cast<double>(test.callback.m_closestHitFraction) * maxDistance;
+    // default to RIGID_STAGE_ID for "scene collision" if we don't know which
+    // object was involved
+    hit.objectId = RIGID_STAGE_ID;
+    auto rawColObjIdIter =
+        collisionObjToObjIds_->find(test.callback.m_collisionObject);
+    if (rawColObjIdIter != collisionObjToObjIds_->end()) {
+      hit.objectId = rawColObjIdIter->second;
+    }
+  });
+}
+
 void BulletPhysicsManager::lookUpObjectIdAndLinkId(
     const btCollisionObject* colObj,
     int* objectId,
@@ -552,60 +884,102 @@ std::vector<ContactPointData> BulletPhysicsManager::getContactPoints() const {
   int numContactManifolds = dispatcher->getNumManifolds();
   contactPoints.reserve(numContactManifolds * 4);
   for (int i = 0; i < numContactManifolds; ++i) {
-    const btPersistentManifold* manifold =
-        dispatcher->getInternalManifoldPointer()[i];
-
-    int objectIdA = ID_UNDEFINED;
-    int objectIdB = ID_UNDEFINED;
-    int linkIndexA = -1;  // -1 if not a multibody
-    int linkIndexB = -1;
-
-    const btCollisionObject* colObj0 = manifold->getBody0();
-    const btCollisionObject* colObj1 = manifold->getBody1();
-
-    lookUpObjectIdAndLinkId(colObj0, &objectIdA, &linkIndexA);
-    lookUpObjectIdAndLinkId(colObj1, &objectIdB, &linkIndexB);
-
-    // logic copied from btSimulationIslandManager::buildIslands. We count
-    // manifolds as active only if related to non-sleeping bodies.
-    bool isActive = ((((colObj0) != nullptr) &&
-                      colObj0->getActivationState() != ISLAND_SLEEPING) ||
-                     (((colObj1) != nullptr) &&
-                      colObj1->getActivationState() != ISLAND_SLEEPING));
-
-    for (int p = 0; p < manifold->getNumContacts(); ++p) {
-      ContactPointData pt;
-      pt.objectIdA = objectIdA;
-      pt.objectIdB = objectIdB;
-      const btManifoldPoint& srcPt = manifold->getContactPoint(p);
-      pt.contactDistance = static_cast<double>(srcPt.getDistance());
-      pt.linkIndexA = linkIndexA;
-      pt.linkIndexB = linkIndexB;
-      pt.contactNormalOnBInWS = Mn::Vector3(srcPt.m_normalWorldOnB);
-      pt.positionOnAInWS = Mn::Vector3(srcPt.getPositionWorldOnA());
-      pt.positionOnBInWS = Mn::Vector3(srcPt.getPositionWorldOnB());
-
-      // convert impulses to forces w/ recent physics timestep
-      pt.normalForce =
-          static_cast<double>(srcPt.getAppliedImpulse()) / recentTimeStep_;
-
-      pt.linearFrictionForce1 =
-          static_cast<double>(srcPt.m_appliedImpulseLateral1) / recentTimeStep_;
-      pt.linearFrictionForce2 =
-          static_cast<double>(srcPt.m_appliedImpulseLateral2) / recentTimeStep_;
-
-      pt.linearFrictionDirection1 = Mn::Vector3(srcPt.m_lateralFrictionDir1);
-      pt.linearFrictionDirection2 = Mn::Vector3(srcPt.m_lateralFrictionDir2);
-
-      pt.isActive = isActive;
-
-      contactPoints.push_back(pt);
-    }
+    appendManifoldContactPoints(*dispatcher->getInternalManifoldPointer()[i],
+                                contactPoints);
   }
 
   return contactPoints;
 }
 
+std::vector<ContactPointData> BulletPhysicsManager::getObjectContactPoints(
+    const int objectId) const {
+  if (!objectContactPointsValid_) {
+    // keep the per-object vectors around so their memory gets reused
+    for (auto& entry : objectContactPoints_) {
+      entry.second.clear();
+    }
+    std::vector<ContactPointData> manifoldPoints;
+    auto* dispatcher = bWorld_->getDispatcher();
+    for (int i = 0; i < dispatcher->getNumManifolds(); ++i) {
+      manifoldPoints.clear();
+      appendManifoldContactPoints(*dispatcher->getInternalManifoldPointer()[i],
+                                  manifoldPoints);
+      if (manifoldPoints.empty()) {
+        continue;
+      }
+      const int objectIdA = manifoldPoints.front().objectIdA;
+      const int objectIdB = manifoldPoints.front().objectIdB;
+      auto& pointsA = objectContactPoints_[objectIdA];
+      pointsA.insert(pointsA.end(), manifoldPoints.begin(),
+                     manifoldPoints.end());
+      // self-collisions of articulated objects are listed just once
+      if (objectIdB != objectIdA) {
+        auto& pointsB = objectContactPoints_[objectIdB];
+        pointsB.insert(pointsB.end(), manifoldPoints.begin(),
+                       manifoldPoints.end());
+      }
+    }
+    objectContactPointsValid_ = true;
+  }
+
+  auto found = objectContactPoints_.find(objectId);
+  if (found == objectContactPoints_.end()) {
+    return {};
+  }
+  return found->second;
+}
+
+void BulletPhysicsManager::appendManifoldContactPoints(
+    const btPersistentManifold& manifold,
+    std::vector<ContactPointData>& contactPoints) const {
+  int objectIdA = ID_UNDEFINED;
+  int objectIdB = ID_UNDEFINED;
+  int linkIndexA = -1;  // -1 if not a multibody
+  int linkIndexB = -1;
+
+  const btCollisionObject* colObj0 = manifold.getBody0();
+  const btCollisionObject* colObj1 = manifold.getBody1();
+
+  lookUpObjectIdAndLinkId(colObj0, &objectIdA, &linkIndexA);
+  lookUpObjectIdAndLinkId(colObj1, &objectIdB, &linkIndexB);
+
+  // logic copied from btSimulationIslandManager::buildIslands. We count
+  // manifolds as active only if related to non-sleeping bodies.
+  bool isActive = ((((colObj0) != nullptr) &&
+                    colObj0->getActivationState() != ISLAND_SLEEPING) ||
+                   (((colObj1) != nullptr) &&
+                    colObj1->getActivationState() != ISLAND_SLEEPING));
+
+  for (int p = 0; p < manifold.getNumContacts(); ++p) {
+    ContactPointData pt;
+    pt.objectIdA = objectIdA;
+    pt.objectIdB = objectIdB;
+    const btManifoldPoint& srcPt = manifold.getContactPoint(p);
+    pt.contactDistance = static_cast<double>(srcPt.getDistance());
+    pt.linkIndexA = linkIndexA;
+    pt.linkIndexB = linkIndexB;
+    pt.contactNormalOnBInWS = Mn::Vector3(srcPt.m_normalWorldOnB);
+    pt.positionOnAInWS = Mn::Vector3(srcPt.getPositionWorldOnA());
+    pt.positionOnBInWS = Mn::Vector3(srcPt.getPositionWorldOnB());
+
+    // convert impulses to forces w/ recent physics timestep
+    pt.normalForce =
+        static_cast<double>(srcPt.getAppliedImpulse()) / recentTimeStep_;
+
+    pt.linearFrictionForce1 =
+        static_cast<double>(srcPt.m_appliedImpulseLateral1) / recentTimeStep_;
+    pt.linearFrictionForce2 =
+        static_cast<double>(srcPt.m_appliedImpulseLateral2) / recentTimeStep_;
+
+    pt.linearFrictionDirection1 = Mn::Vector3(srcPt.m_lateralFrictionDir1);
+    pt.linearFrictionDirection2 = Mn::Vector3(srcPt.m_lateralFrictionDir2);
+
+    pt.isActive = isActive;
+
+    contactPoints.push_back(pt);
+  }
+}
+
 //============ Rigid Constraints =============
 
 int BulletPhysicsManager::createRigidConstraint(
@@ -661,8 +1035,12 @@ int BulletPhysicsManager::createRigidConstraint(
     // construct a multibody constraint
     if (settings.constraintType == RigidConstraintType::PointToPoint) {
       // point to point constraint
-      std::unique_ptr<btMultiBodyPoint2Point> p2p;
-      if (mbB != nullptr) {
+      std::unique_ptr<btMultiBodyPoint2Point> p2p = takePooledConstraint(
+          articulatedP2PConstraintPool_,
+          articulatedP2PConstraintPoolKey(settings));
+      if (p2p) {
+        // reused from a removed constraint between the same links
+      } else if (mbB != nullptr) {
         // AO <-> AO constraint
         p2p = std::make_unique<btMultiBodyPoint2Point>(
             mbA, settings.linkIdA, mbB, settings.linkIdB,
@@ -673,12 +1051,18 @@ int BulletPhysicsManager::createRigidConstraint(
             mbA, settings.linkIdA, rbB, btVector3(settings.pivotA),
             btVector3(settings.pivotB));
       }
-      bWorld_->addMultiBodyConstraint(p2p.get());
+      if (settings.enabled) {
+        bWorld_->addMultiBodyConstraint(p2p.get());
+      }
       articulatedP2PConstraints_.emplace(nextConstraintId_, std::move(p2p));
     } else {
       // fixed constraint
-      std::unique_ptr<btMultiBodyFixedConstraint> fixedConstraint;
-      if (mbB != nullptr) {
+      std::unique_ptr<btMultiBodyFixedConstraint> fixedConstraint =
+          takePooledConstraint(articulatedFixedConstraintPool_,
+                               constraintPoolKey(settings));
+      if (fixedConstraint) {
+        // reused from a removed constraint between the same links
+      } else if (mbB != nullptr) {
         // AO <-> AO constraint
         fixedConstraint = std::make_unique<btMultiBodyFixedConstraint>(
             mbA, settings.linkIdA, mbB, settings.linkIdB,
@@ -691,7 +1075,9 @@ int BulletPhysicsManager::createRigidConstraint(
             btVector3(settings.pivotB), btMatrix3x3(settings.frameA),
             btMatrix3x3(settings.frameB));
       }
-      bWorld_->addMultiBodyConstraint(fixedConstraint.get());
+      if (settings.enabled) {
+        bWorld_->addMultiBodyConstraint(fixedConstraint.get());
+      }
       articulatedFixedConstraints_.emplace(nextConstraintId_,
                                            std::move(fixedConstraint));
     }
@@ -717,21 +1103,29 @@ int BulletPhysicsManager::createRigidConstraint(
     // construct a rigidbody constraint
     if (settings.constraintType == RigidConstraintType::PointToPoint) {
       // point to point
-      std::unique_ptr<btPoint2PointConstraint> p2p =
-          std::make_unique<btPoint2PointConstraint>(*rbA, *rbB,
-                                                    btVector3(settings.pivotA),
-                                                    btVector3(settings.pivotB));
+      std::unique_ptr<btPoint2PointConstraint> p2p = takePooledConstraint(
+          rigidP2PConstraintPool_, constraintPoolKey(settings));
+      if (!p2p) {
+        p2p = std::make_unique<btPoint2PointConstraint>(
+            *rbA, *rbB, btVector3(settings.pivotA), btVector3(settings.pivotB));
+      }
+      p2p->setEnabled(settings.enabled);
       bWorld_->addConstraint(p2p.get());
       rigidP2PConstraints_.emplace(nextConstraintId_, std::move(p2p));
     } else {
       // fixed
       std::unique_ptr<btFixedConstraint> fixedConstraint =
-          std::make_unique<btFixedConstraint>(
-              *rbA, *rbB,
-              btTransform(btMatrix3x3(settings.frameA),
-                          btVector3(settings.pivotA)),
-              btTransform(btMatrix3x3(settings.frameB),
-                          btVector3(settings.pivotB)));
+          takePooledConstraint(rigidFixedConstraintPool_,
+                               constraintPoolKey(settings));
+      if (!fixedConstraint) {
+        fixedConstraint = std::make_unique<btFixedConstraint>(
+            *rbA, *rbB,
+            btTransform(btMatrix3x3(settings.frameA),
+                        btVector3(settings.pivotA)),
+            btTransform(btMatrix3x3(settings.frameB),
+                        btVector3(settings.pivotB)));
+      }
+      fixedConstraint->setEnabled(settings.enabled);
       bWorld_->addConstraint(fixedConstraint.get());
       rigidFixedConstraints_.emplace(nextConstraintId_,
                                      std::move(fixedConstraint));
@@ -795,6 +1189,16 @@ void BulletPhysicsManager::updateRigidConstraint(
               "remove and create to update this parameter. ("
                   << settings.pivotA << " vs." << cachedSettings.pivotA << ")");
     // TODO: Either fix the Bullet API or do the add/remove for the user here.
+    if (settings.enabled != cachedSettings.enabled) {
+      // multibody constraints have no enabled flag
+      if (settings.enabled) {
+        bWorld_->addMultiBodyConstraint(
+            articulatedP2PConstraintIter->second.get());
+      } else {
+        bWorld_->removeMultiBodyConstraint(
+            articulatedP2PConstraintIter->second.get());
+      }
+    }
     articulatedP2PConstraintIter->second->setPivotInB(
         btVector3(settings.pivotB));
     articulatedP2PConstraintIter->second->setMaxAppliedImpulse(
@@ -803,6 +1207,7 @@ void BulletPhysicsManager::updateRigidConstraint(
     auto rigidP2PConstraintIter = rigidP2PConstraints_.find(constraintId);
 
     if (rigidP2PConstraintIter != rigidP2PConstraints_.end()) {
+      rigidP2PConstraintIter->second->setEnabled(settings.enabled);
       rigidP2PConstraintIter->second->m_setting.m_impulseClamp =
           settings.maxImpulse;
       rigidP2PConstraintIter->second->setPivotA(btVector3(settings.pivotA));
@@ -813,6 +1218,15 @@ void BulletPhysicsManager::updateRigidConstraint(
 
       if (articulatedFixedConstraintIter !=
           articulatedFixedConstraints_.end()) {
+        if (settings.enabled != cachedSettings.enabled) {
+          if (settings.enabled) {
+            bWorld_->addMultiBodyConstraint(
+                articulatedFixedConstraintIter->second.get());
+          } else {
+            bWorld_->removeMultiBodyConstraint(
+                articulatedFixedConstraintIter->second.get());
+          }
+        }
         articulatedFixedConstraintIter->second->setPivotInA(
             btVector3(settings.pivotA));
         articulatedFixedConstraintIter->second->setPivotInB(
@@ -827,6 +1241,7 @@ void BulletPhysicsManager::updateRigidConstraint(
         auto rigidFixedConstraintIter =
             rigidFixedConstraints_.find(constraintId);
         if (rigidFixedConstraintIter != rigidFixedConstraints_.end()) {
+          rigidFixedConstraintIter->second->setEnabled(settings.enabled);
           rigidFixedConstraintIter->second->setFrames(
               btTransform(btMatrix3x3(settings.frameA),
                           btVector3(settings.pivotA)),
@@ -850,34 +1265,58 @@ void BulletPhysicsManager::updateRigidConstraint(
 }
 
 void BulletPhysicsManager::removeRigidConstraint(int constraintId) {
+  auto rigidConstraintCacheIter = rigidConstraintSettings_.find(constraintId);
+  if (rigidConstraintCacheIter == rigidConstraintSettings_.end()) {
+    ESP_ERROR() << "No constraint with constraintId =" << constraintId;
+    return;
+  }
+  const RigidConstraintSettings& settings = rigidConstraintCacheIter->second;
+
+  // take the constraint out of the world and keep it for reuse
   auto articulatedP2PConstraintIter =
       articulatedP2PConstraints_.find(constraintId);
   if (articulatedP2PConstraintIter != articulatedP2PConstraints_.end()) {
-    bWorld_->removeMultiBodyConstraint(
-        articulatedP2PConstraintIter->second.get());
+    if (settings.enabled) {
+      bWorld_->removeMultiBodyConstraint(
+          articulatedP2PConstraintIter->second.get());
+    }
+    articulatedP2PConstraintPool_.emplace(
+        articulatedP2PConstraintPoolKey(settings),
+        std::move(articulatedP2PConstraintIter->second));
     articulatedP2PConstraints_.erase(articulatedP2PConstraintIter);
   } else {
     auto rigidP2PConstraintIter = rigidP2PConstraints_.find(constraintId);
     if (rigidP2PConstraintIter != rigidP2PConstraints_.end()) {
       bWorld_->removeConstraint(rigidP2PConstraintIter->second.get());
+      rigidP2PConstraintPool_.emplace(
+          constraintPoolKey(settings),
+          std::move(rigidP2PConstraintIter->second));
       rigidP2PConstraints_.erase(rigidP2PConstraintIter);
     } else {
       auto articulatedFixedConstraintIter =
           articulatedFixedConstraints_.find(constraintId);
       if (articulatedFixedConstraintIter !=
           articulatedFixedConstraints_.end()) {
-        bWorld_->removeMultiBodyConstraint(
-            articulatedFixedConstraintIter->second.get());
+        if (settings.enabled) {
+          bWorld_->removeMultiBodyConstraint(
+              articulatedFixedConstraintIter->second.get());
+        }
+        articulatedFixedConstraintPool_.emplace(
+            constraintPoolKey(settings),
+            std::move(articulatedFixedConstraintIter->second));
         articulatedFixedConstraints_.erase(articulatedFixedConstraintIter);
       } else {
         auto rigidFixedConstraintIter =
             rigidFixedConstraints_.find(constraintId);
         if (rigidFixedConstraintIter != rigidFixedConstraints_.end()) {
           bWorld_->removeConstraint(rigidFixedConstraintIter->second.get());
+          rigidFixedConstraintPool_.emplace(
+              constraintPoolKey(settings),
+              std::move(rigidFixedConstraintIter->second));
           rigidFixedConstraints_.erase(rigidFixedConstraintIter);
         } else {
-          ESP_ERROR() << "No constraint with constraintId =" << constraintId;
-          return;
+          // one of the maps should have the id if it has settings
+          CORRADE_INTERNAL_ASSERT_UNREACHABLE();
         }
       }
     }
@@ -912,6 +1351,13 @@ void BulletPhysicsManager::removeRigidConstraint(int constraintId) {
   }
 }
 
+void BulletPhysicsManager::erasePooledRigidConstraints(int objectId) {
+  erasePooledConstraints(articulatedP2PConstraintPool_, objectId);
+  erasePooledConstraints(articulatedFixedConstraintPool_, objectId);
+  erasePooledConstraints(rigidP2PConstraintPool_, objectId);
+  erasePooledConstraints(rigidFixedConstraintPool_, objectId);
+}
+
 void BulletPhysicsManager::instantiateSkinnedModel(
     const BulletArticulatedObject::ptr& ao,
     const esp::metadata::attributes::ArticulatedObjectAttributes::ptr&
@@ -14,6 +14,8 @@
 #include <Magnum/BulletIntegration/Integration.h>
 #include <Magnum/BulletIntegration/MotionState.h>
 #include <btBulletDynamicsCommon.h>
+#include <map>
+#include <tuple>
 
 #include "BulletDynamics/ConstraintSolver/btFixedConstraint.h"
 #include "BulletDynamics/ConstraintSolver/btPoint2PointConstraint.h"
@@ -168,6 +170,15 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   Magnum::Range3D getStageCollisionShapeAabb() const;
 
+  /**
+   * @brief Get the number of distinct convex collision shape sets cached
+   * for sharing between rigid objects. Each set corresponds to one
+   * combination of collision asset and scale. See @ref CollisionShapeCache.
+   */
+  std::size_t getCollisionShapeCacheSize() const {
+    return collisionShapeCache_->size();
+  }
+
   /** @brief Render the debugging visualizations provided by @ref
    * Magnum::BulletIntegration::DebugDraw. This draws wireframes for all
    * collision objects.
@@ -185,6 +196,20 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   std::vector<ContactPointData> getContactPoints() const override;
 
+  /**
+   * @brief Return ContactPointData objects describing the contacts of a
+   * single object from the most recent physics substep.
+   *
+   * The first query after a step or discrete collision detection walks all
+   * contact manifolds once and indexes their points by object ID, subsequent
+   * queries only copy the contacts of the queried object. Not thread-safe.
+   * @param objectId The object ID. The stage is @ref esp::RIGID_STAGE_ID.
+   * @return The contact points, each with @p objectId as either objectIdA or
+   * objectIdB.
+   */
+  std::vector<ContactPointData> getObjectContactPoints(
+      int objectId) const override;
+
   /**
    * @brief Cast a ray into the collision world and return a @ref RaycastResults
    * with hit information.
@@ -198,6 +223,51 @@ class BulletPhysicsManager : public PhysicsManager {
   RaycastResults castRay(const esp::geo::Ray& ray,
                          double maxDistance = 100.0) override;
 
+  /**
+   * @brief Cast a batch of rays into the collision world and write the closest
+   * hit of each into @p closestHits. See @ref PhysicsManager::castRays.
+   *
+   * Traverses the broadphase trees directly instead of going through
+   * @ref btCollisionWorld::rayTest, whose broadphase traversal isn't safe to
+   * run concurrently, so the rays can be cast from several threads.
+   */
+  void castRays(Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+                double maxDistance,
+                Cr::Containers::ArrayView<RayHitInfo> closestHits,
+                int numThreads = 1) override;
+
+  /**
+   * @brief Check for each of a batch of poses whether a rigid object would be
+   * in contact. See @ref PhysicsManager::contactTestRigidObjectPoses.
+   */
+  void contactTestRigidObjectPoses(
+      int physObjectID,
+      Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+      Cr::Containers::ArrayView<bool> inContact) override;
+
+  /**
+   * @brief Check for each of a batch of joint configurations whether an
+   * articulated object would be in contact. See
+   * @ref PhysicsManager::contactTestArticulatedObjectJointPositions.
+   */
+  void contactTestArticulatedObjectJointPositions(
+      int physObjectID,
+      const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+      Cr::Containers::ArrayView<bool> inContact) override;
+
+  /**
+   * @brief Set the joint positions of multiple articulated objects at once.
+   * See @ref PhysicsManager::setArticulatedObjectsJointPositions.
+   *
+   * Instead of a full kinematic update per object, runs forward kinematics
+   * for all of them in one pass, then updates all broadphase aabbs and
+   * finally the SceneNodes.
+   */
+  void setArticulatedObjectsJointPositions(
+      Cr::Containers::ArrayView<const int> objectIDs,
+      const Cr::Containers::StridedArrayView2D<const float>& positions)
+      override;
+
   /**
    * @brief Query the number of contact points that were active during the
    * collision detection check.
@@ -237,12 +307,27 @@ class BulletPhysicsManager : public PhysicsManager {
     return BulletCollisionHelper::get().getStepCollisionSummary(bWorld_.get());
   }
 
+  /**
+   * @brief Defers scene node updates of rigid objects through the shared
+   * @ref BulletDeferredNodeUpdates queue, so only objects Bullet actually
+   * moves are recorded. Articulated objects defer individually.
+   */
+  void deferNodesUpdate() override;
+
+  /**
+   * @brief Syncs the scene nodes of the rigid objects recorded since @ref
+   * deferNodesUpdate() and of all articulated objects. Sleeping rigid objects
+   * aren't visited.
+   */
+  void updateNodes() override;
+
   /**
    * @brief Perform discrete collision detection for the scene.
    */
   void performDiscreteCollisionDetection() override {
     bWorld_->getCollisionWorld()->performDiscreteCollisionDetection();
     recentNumSubStepsTaken_ = -1;  // TODO: handle this more gracefully
+    objectContactPointsValid_ = false;
   }
 
   //============ Rigid Constraints =============
@@ -269,6 +354,11 @@ class BulletPhysicsManager : public PhysicsManager {
   /**
    * @brief Remove a rigid constraint by id.
    *
+   * The Bullet constraint is kept in a pool and reused by the next
+   * @ref createRigidConstraint() between the same objects and links, so
+   * repeated grasps don't allocate. Pooled constraints are dropped with the
+   * objects they reference.
+   *
    * @param constraintId The id of the constraint to remove.
    */
   void removeRigidConstraint(int constraintId) override;
@@ -317,6 +407,25 @@ class BulletPhysicsManager : public PhysicsManager {
       rigidP2PConstraints_;
   std::unordered_map<int, std::unique_ptr<btFixedConstraint>>
       rigidFixedConstraints_;
+  //! the objects and links a pooled constraint connects: objectIdA, linkIdA,
+  //! objectIdB, linkIdB
+  typedef std::tuple<int, int, int, int> RigidConstraintPoolKey;
+  //! multibody P2P constraints can't change pivotA, so it's part of their key
+  typedef std::tuple<int, int, int, int, float, float, float>
+      ArticulatedP2PConstraintPoolKey;
+  //! removed constraints kept out of the world for reuse, see
+  //! @ref removeRigidConstraint()
+  std::multimap<ArticulatedP2PConstraintPoolKey,
+                std::unique_ptr<btMultiBodyPoint2Point>>
+      articulatedP2PConstraintPool_;
+  std::multimap<RigidConstraintPoolKey,
+                std::unique_ptr<btMultiBodyFixedConstraint>>
+      articulatedFixedConstraintPool_;
+  std::multimap<RigidConstraintPoolKey,
+                std::unique_ptr<btPoint2PointConstraint>>
+      rigidP2PConstraintPool_;
+  std::multimap<RigidConstraintPoolKey, std::unique_ptr<btFixedConstraint>>
+      rigidFixedConstraintPool_;
   //! when constraining objects to the global frame, a dummy object with 0 mass
   //! is required.
   std::unique_ptr<btRigidBody> globalFrameObject = nullptr;
@@ -358,6 +467,12 @@ class BulletPhysicsManager : public PhysicsManager {
   bool addStageFinalize(const metadata::attributes::StageAttributes::ptr&
                             initAttributes) override;
 
+  /**
+   * @brief Rebuild the broadphase trees once all objects of a batch have been
+   * inserted one by one, which leaves them unbalanced.
+   */
+  void addObjectInstancesFinalize() override;
+
   /** @brief Create and initialize an @ref RigidObject and add
    * it to existingObjects_ map keyed with newObjectID
    * @param newObjectID valid object ID for the new object
@@ -375,7 +490,10 @@ class BulletPhysicsManager : public PhysicsManager {
   btDefaultCollisionConfiguration bCollisionConfig_;
 
   btMultiBodyConstraintSolver bSolver_;
-  btCollisionDispatcher bDispatcher_{&bCollisionConfig_};
+  /** @brief Collision dispatcher of @ref bWorld_. A
+   * @ref btCollisionDispatcherMt if multithreaded collision detection is
+   * enabled, see @ref initPhysicsFinalize(). */
+  std::unique_ptr<btCollisionDispatcher> bDispatcher_;
 
   /** @brief A pointer to the Bullet world. See @ref btMultiBodyDynamicsWorld.*/
   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld_;
@@ -387,11 +505,32 @@ class BulletPhysicsManager : public PhysicsManager {
   std::shared_ptr<std::map<const btCollisionObject*, int>>
       collisionObjToObjIds_;
 
+  //! convex collision shapes shared by rigid objects using the same collision
+  //! asset at the same scale
+  std::shared_ptr<CollisionShapeCache> collisionShapeCache_ =
+      std::make_shared<CollisionShapeCache>();
+
+  //! drops the shapes of evicted assets from the caches, see
+  //! @ref assets::ResourceManager::addAssetEvictionCallback()
+  int assetEvictionCallbackId_ = 0;
+
+  //! rigid objects with motion state changes held back for updateNodes()
+  std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates_ =
+      std::make_shared<BulletDeferredNodeUpdates>();
+
   //! necessary to acquire forces from impulses
   double recentTimeStep_ = fixedTimeStep_;
   //! for recent call to stepPhysics
   int recentNumSubStepsTaken_ = -1;
 
+  //! contact points of the most recent collision detection by object ID,
+  //! built on demand by getObjectContactPoints()
+  mutable std::unordered_map<int, std::vector<ContactPointData>>
+      objectContactPoints_;
+
+  //! whether objectContactPoints_ matches the current contact manifolds
+  mutable bool objectContactPointsValid_ = false;
+
  private:
   /**
    * @brief Helper function for getting object and link unique ids from
@@ -407,6 +546,14 @@ class BulletPhysicsManager : public PhysicsManager {
                                int* objectId,
                                int* linkId) const;
 
+  /**
+   * @brief Helper function appending the points of a contact manifold to @p
+   * contactPoints as @ref ContactPointData.
+   */
+  void appendManifoldContactPoints(
+      const btPersistentManifold& manifold,
+      std::vector<ContactPointData>& contactPoints) const;
+
   /**
    * @brief Helper function for removing all rigid constraints referencing an
    * object.
@@ -416,13 +563,24 @@ class BulletPhysicsManager : public PhysicsManager {
   void removeObjectRigidConstraints(int objectId) {
     auto objConstraintIter = objectConstraints_.find(objectId);
     if (objConstraintIter != objectConstraints_.end()) {
-      for (auto c_id : objConstraintIter->second) {
+      // removeRigidConstraint() erases from the list being iterated
+      const std::vector<int> constraintIds = objConstraintIter->second;
+      for (auto c_id : constraintIds) {
         removeRigidConstraint(c_id);
       }
       objectConstraints_.erase(objectId);
     }
+    erasePooledRigidConstraints(objectId);
   };
 
+  /**
+   * @brief Destroy the pooled constraints referencing an object, see
+   * @ref removeRigidConstraint().
+   *
+   * @param objectId The unique id for the rigid or articulated object.
+   */
+  void erasePooledRigidConstraints(int objectId);
+
   /**
    * @brief Helper function for instantiating a skinned model associated to the
    * articulated object. The model bones are driven by parenting them to their
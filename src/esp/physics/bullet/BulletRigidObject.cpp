@@ -15,8 +15,10 @@
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletCollisionHelper.h"
+#include "BulletConvexHullCache.h"
 #include "BulletRigidObject.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Profiler.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
 
 //!  A Few considerations in construction
@@ -79,6 +81,7 @@ bool BulletRigidObject::finalizeObject_LibSpecific() {
 }  // finalizeObject_LibSpecifc
 
 bool BulletRigidObject::constructCollisionShape() {
+  ESP_PROFILE_SCOPE("createCollisionShapes");
   // get this object's creation template, appropriately cast
   auto tmpAttr = getInitializationAttributes();
 
@@ -118,40 +121,28 @@ bool BulletRigidObject::constructCollisionShape() {
     bObjectShape_->addChildShape(btTransform::getIdentity(),
                                  bGenericShapes_.back().get());
     bObjectShape_->recalculateLocalAabb();
+    bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
   } else {
-    // mesh collider
-    const std::vector<assets::CollisionMeshData>& meshGroup =
-        resMgr_.getCollisionMesh(collisionAssetHandle);
-    const assets::MeshMetaData& metaData =
-        resMgr_.getMeshMetaData(collisionAssetHandle);
-
+    // mesh collider. The compound is scaled while still empty and the scale
+    // is baked into the convex shapes instead, as
+    // btCompoundShape::setLocalScaling() would modify the possibly shared
+    // children.
+    bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
     if (!usingBBCollisionShape_) {
+      Mn::Vector3 scaling = tmpAttr->getScale();
       if (joinCollisionMeshes) {
-        bObjectConvexShapes_.emplace_back(
-            std::make_unique<btConvexHullShape>());
-        constructJoinedConvexShapeFromMeshes(Magnum::Matrix4{}, meshGroup,
-                                             metaData.root,
-                                             bObjectConvexShapes_.back().get());
-
-        // add the final object after joining meshes
-        bObjectConvexShapes_.back()->setLocalScaling(
-            btVector3(tmpAttr->getCollisionAssetSize()));
-        bObjectConvexShapes_.back()->setMargin(0.0);
-        bObjectConvexShapes_.back()->recalcLocalAabb();
-        bObjectShape_->addChildShape(btTransform::getIdentity(),
-                                     bObjectConvexShapes_.back().get());
-      } else {
-        constructConvexShapesFromMeshes(Magnum::Matrix4{}, meshGroup,
-                                        metaData.root, bObjectShape_.get(),
-                                        bObjectConvexShapes_);
+        scaling *= tmpAttr->getCollisionAssetSize();
+      }
+      constructConvexShapes(collisionAssetHandle, joinCollisionMeshes,
+                            scaling);
+      for (const auto& shape : bObjectConvexShapes_) {
+        bObjectShape_->addChildShape(btTransform::getIdentity(), shape.get());
       }
     }
   }  // if using prim collider else use mesh collider
 
   //! Set properties
   bObjectShape_->setMargin(margin);
-
-  bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
   bObjectShape_->recalculateLocalAabb();
 
   if (!originShift_.isZero()) {
@@ -162,6 +153,75 @@ bool BulletRigidObject::constructCollisionShape() {
   return true;
 }
 
+void BulletRigidObject::constructConvexShapes(
+    const std::string& collisionAssetHandle,
+    bool joinCollisionMeshes,
+    const Mn::Vector3& scaling) {
+  bObjectConvexShapes_.clear();
+
+  const CollisionShapeCacheKey key{collisionAssetHandle, joinCollisionMeshes,
+                                   scaling.x(), scaling.y(), scaling.z()};
+  if (collisionShapeCache_) {
+    auto found = collisionShapeCache_->find(key);
+    if (found != collisionShapeCache_->end()) {
+      bObjectConvexShapes_ = found->second;
+      return;
+    }
+  }
+
+  // prefer hulls precomputed offline over building them from all vertices
+  std::vector<std::unique_ptr<btConvexHullShape>> shapes;
+  if (!loadConvexShapesFromHullCache(collisionAssetHandle, joinCollisionMeshes,
+                                     shapes)) {
+    const std::vector<assets::CollisionMeshData>& meshGroup =
+        resMgr_.getCollisionMesh(collisionAssetHandle);
+    const assets::MeshMetaData& metaData =
+        resMgr_.getMeshMetaData(collisionAssetHandle);
+
+    if (joinCollisionMeshes) {
+      shapes.emplace_back(std::make_unique<btConvexHullShape>());
+      constructJoinedConvexShapeFromMeshes(Magnum::Matrix4{}, meshGroup,
+                                           metaData.root, shapes.back().get());
+    } else {
+      constructConvexShapesFromMeshes(Magnum::Matrix4{}, meshGroup,
+                                      metaData.root, nullptr, shapes);
+    }
+  }
+
+  for (auto& shape : shapes) {
+    shape->setLocalScaling(btVector3{scaling});
+    shape->setMargin(0.0);
+    shape->recalcLocalAabb();
+    bObjectConvexShapes_.emplace_back(std::move(shape));
+  }
+
+  if (collisionShapeCache_) {
+    collisionShapeCache_->emplace(key, bObjectConvexShapes_);
+  }
+}
+
+void BulletRigidObject::setMargin(const double margin) {
+  // the convex shapes may be shared with other objects through the collision
+  // shape cache, make a private copy of those before modifying them
+  btCompoundShapeChild* children = bObjectShape_->getChildList();
+  for (auto& shape : bObjectConvexShapes_) {
+    if (shape.use_count() > 1) {
+      std::shared_ptr<btConvexHullShape> copy =
+          std::make_unique<btConvexHullShape>(
+              &shape->getUnscaledPoints()->getX(), shape->getNumPoints());
+      copy->setLocalScaling(shape->getLocalScaling());
+      for (int i = 0; i < bObjectShape_->getNumChildShapes(); ++i) {
+        if (children[i].m_childShape == shape.get()) {
+          children[i].m_childShape = copy.get();
+        }
+      }
+      shape = std::move(copy);
+    }
+    shape->setMargin(margin);
+  }
+  bObjectShape_->setMargin(margin);
+}
+
 std::unique_ptr<btCollisionShape>
 BulletRigidObject::buildPrimitiveCollisionObject(int primTypeVal,
                                                  double halfLength) {
@@ -495,11 +555,29 @@ bool BulletRigidObject::contactTest() {
   return src.bCollision;
 }  // contactTest
 
+void BulletRigidObject::contactTestPoses(
+    Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+    Cr::Containers::ArrayView<bool> inContact) {
+  // contactTest() queries the broadphase with the aabb at the collision
+  // object's transform and skips the object's own proxy, so moving only the
+  // collision object is enough
+  const btTransform currentTransform = bObjectRigidBody_->getWorldTransform();
+  for (std::size_t i = 0; i != poses.size(); ++i) {
+    bObjectRigidBody_->setWorldTransform(btTransform{poses[i]});
+    inContact[i] = contactTest();
+  }
+  bObjectRigidBody_->setWorldTransform(currentTransform);
+}  // contactTestPoses
+
 void BulletRigidObject::overrideCollisionGroup(CollisionGroup group) {
-  if (!bObjectRigidBody_->isInWorld()) {
-    ESP_ERROR() << "Failed because "
-                   "the Bullet body hasn't yet been added to the Bullet world.";
+  // update the filter in place instead of re-inserting into the broadphase
+  if (setCollisionFilter(
+          *bWorld_, *bObjectRigidBody_, int(group),
+          int(uint32_t(CollisionGroupHelper::getMaskForGroup(group))))) {
+    return;
   }
+  ESP_ERROR() << "Failed because "
+                 "the Bullet body hasn't yet been added to the Bullet world.";
 
   bWorld_->removeRigidBody(bObjectRigidBody_.get());
   bWorld_->addRigidBody(bObjectRigidBody_.get(), int(group),
@@ -531,7 +609,12 @@ void BulletRigidObject::updateNodes(bool force) {
 }
 
 void BulletRigidObject::setWorldTransform(const btTransform& worldTrans) {
-  if (isDeferringUpdate_) {
+  if (deferredNodeUpdates_ && deferredNodeUpdates_->deferring) {
+    if (!deferredUpdate_) {
+      deferredNodeUpdates_->objectIds.push_back(objectId_);
+    }
+    deferredUpdate_ = {worldTrans};
+  } else if (isDeferringUpdate_) {
     deferredUpdate_ = {worldTrans};
   } else {
     MotionState::setWorldTransform(worldTrans);
@@ -6,7 +6,8 @@
 #define ESP_PHYSICS_BULLET_BULLETRIGIDOBJECT_H_
 
 /** @file
- * @brief Struct SimulationContactResultCallback, class @ref
+ * @brief Struct SimulationContactResultCallback, struct @ref
+ * esp::physics::BulletDeferredNodeUpdates, class @ref
  * esp::physics::BulletRigidObject
  */
 
@@ -16,6 +17,8 @@
 #include <Magnum/BulletIntegration/MotionState.h>
 #include <btBulletDynamicsCommon.h>
 
+#include <vector>
+
 #include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
 
 #include "esp/core/Esp.h"
@@ -27,6 +30,22 @@
 namespace esp {
 namespace physics {
 
+/**
+ * @brief Scene node updates deferred while a world is stepped, shared between
+ * a @ref BulletPhysicsManager and its @ref BulletRigidObject instances.
+ *
+ * Bullet only reports motion state changes of awake bodies, so recording the
+ * objects that received one lets the scene nodes be synced without visiting
+ * sleeping objects at all.
+ */
+struct BulletDeferredNodeUpdates {
+  /** @brief Whether motion state changes are currently being deferred */
+  bool deferring = false;
+
+  /** @brief IDs of the objects holding a deferred motion state change */
+  std::vector<int> objectIds;
+};
+
 /**
  * @brief An individual rigid object instance implementing an interface with
  * Bullet physics to enable dynamic objects. See @ref btRigidBody.
@@ -113,6 +132,16 @@ class BulletRigidObject : public BulletBase,
    */
   void updateNodes(bool force = false) override;
 
+  /**
+   * @brief Set the deferred node update queue this object reports motion
+   * state changes to. While the queue is deferring, changes are held back
+   * until @ref updateNodes() and the object ID is recorded in it once.
+   */
+  void setDeferredNodeUpdates(
+      std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates) {
+    deferredNodeUpdates_ = std::move(deferredNodeUpdates);
+  }
+
   /**
    * @brief Set the @ref MotionType of the object. The object can be set to @ref
    * MotionType::STATIC, @ref MotionType::KINEMATIC or @ref MotionType::DYNAMIC.
@@ -438,12 +467,7 @@ class BulletRigidObject : public BulletBase,
    * btCompoundShape::setMargin.
    * @param margin The new scalar collision margin of the object.
    */
-  void setMargin(const double margin) override {
-    for (std::size_t i = 0; i < bObjectConvexShapes_.size(); ++i) {
-      bObjectConvexShapes_[i]->setMargin(margin);
-    }
-    bObjectShape_->setMargin(margin);
-  }
+  void setMargin(const double margin) override;
 
   /** @brief Sets the object's collision shape to its bounding box.
    * Since the bounding hierarchy is not constructed when the object is
@@ -468,6 +492,20 @@ class BulletRigidObject : public BulletBase,
    */
   bool contactTest() override;
 
+  /**
+   * @brief Run @ref contactTest() with the object at each of a batch of
+   * poses, putting it back at its current pose afterwards. Only the
+   * collision object is moved, SceneNodes and broadphase aabbs are left as
+   * they are.
+   *
+   * @param poses Root transformations of the object to test.
+   * @param[out] inContact Receives whether the object is in contact at each
+   * of @p poses, expected to have the same size.
+   */
+  void contactTestPoses(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> poses,
+      Corrade::Containers::ArrayView<bool> inContact);
+
   /**
    * @brief Manually set the collision group for an object.
    * @param group The desired CollisionGroup for the object.
@@ -514,6 +552,19 @@ class BulletRigidObject : public BulletBase,
    */
   void shiftObjectCollisionShape(const Magnum::Vector3& shift);
 
+  /**
+   * @brief Fill @ref bObjectConvexShapes_ with convex shapes built from a
+   * collision asset, reusing cached ones from @ref collisionShapeCache_ if
+   * available.
+   * @param collisionAssetHandle The collision asset.
+   * @param joinCollisionMeshes Whether to join all meshes of the asset into a
+   * single convex shape.
+   * @param scaling Local scaling of the convex shapes.
+   */
+  void constructConvexShapes(const std::string& collisionAssetHandle,
+                             bool joinCollisionMeshes,
+                             const Magnum::Vector3& scaling);
+
   /**
    * @brief Iterate through all collision objects and active all objects sharing
    * a collision island tag with this object's collision shape.
@@ -544,6 +595,9 @@ class BulletRigidObject : public BulletBase,
   Corrade::Containers::Optional<btTransform> deferredUpdate_ =
       Corrade::Containers::NullOpt;
 
+  //! see setDeferredNodeUpdates()
+  std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates_;
+
   ESP_SMART_POINTERS(BulletRigidObject)
 };
 
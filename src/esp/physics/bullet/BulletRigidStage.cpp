@@ -12,9 +12,11 @@
 #include "BulletCollision/CollisionShapes/btConvexTriangleMeshShape.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
+#include "BulletBvhCache.h"
 #include "BulletCollisionHelper.h"
 #include "BulletRigidStage.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Profiler.h"
 #include "esp/physics/CollisionGroupHelper.h"
 
 namespace esp {
@@ -67,6 +69,7 @@ void BulletRigidStage::setCollidable(bool collidable) {
 
 void BulletRigidStage::constructAndAddCollisionObjects() {
   if (bStaticCollisionObjects_.empty()) {
+    ESP_PROFILE_SCOPE("createCollisionShapes");
     auto initAttr = PhysicsObjectBase::getInitializationAttributes<
         metadata::attributes::StageAttributes>();
     // construct the objects first time
@@ -116,8 +119,10 @@ void BulletRigidStage::constructBulletSceneFromMeshes(
     // SCENE: create a concave static mesh
     btIndexedMesh bulletMesh;
 
-    Corrade::Containers::ArrayView<Magnum::Vector3> v_data = mesh->positions;
-    Corrade::Containers::ArrayView<Magnum::UnsignedInt> ui_data = mesh->indices;
+    Corrade::Containers::ArrayView<const Magnum::Vector3> v_data =
+        mesh->positions;
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> ui_data =
+        mesh->indices;
 
     //! Configure Bullet Mesh
     //! This part is very likely to cause segfault, if done incorrectly
@@ -138,18 +143,38 @@ void BulletRigidStage::constructBulletSceneFromMeshes(
     //! Embed 3D mesh into bullet shape
     //! btBvhTriangleMeshShape is the most generic/slow choice
     //! which allows concavity if the object is static
+    //! The quantized bvh is built or loaded below, once the shape is scaled
     std::unique_ptr<btBvhTriangleMeshShape> meshShape =
         std::make_unique<btBvhTriangleMeshShape>(indexedVertexArray.get(),
-                                                 true);
+                                                 true, false);
     auto initAttr = PhysicsObjectBase::getInitializationAttributes<
         metadata::attributes::StageAttributes>();
     meshShape->setMargin(initAttr->getMargin());
-    meshShape->setLocalScaling(
-        btVector3{transformFromLocalToWorld
-                      .scaling()});  // scale is a property of the shape
-
-    // re-build the bvh after setting margin
-    meshShape->buildOptimizedBvh();
+    // scale is a property of the shape. Scale the mesh without the
+    // btBvhTriangleMeshShape override, which would build the bvh.
+    const Magnum::Vector3 scaling = transformFromLocalToWorld.scaling();
+    meshShape->btTriangleMeshShape::setLocalScaling(btVector3{scaling});
+
+    std::string bvhCacheFile;
+    if (!resMgr_.getCollisionBvhCacheDirectory().empty()) {
+      bvhCacheFile =
+          bvhCacheFilename(resMgr_.getCollisionBvhCacheDirectory(),
+                           initAttr->getCollisionAssetHandle(), *mesh, scaling);
+    }
+    Corrade::Containers::Array<char> bvhStorage;
+    btOptimizedBvh* cachedBvh = nullptr;
+    if (!bvhCacheFile.empty()) {
+      cachedBvh = readBvhCache(bvhCacheFile, bvhStorage);
+    }
+    if (cachedBvh) {
+      meshShape->setOptimizedBvh(cachedBvh, btVector3{scaling});
+      bStageBvhStorage_.emplace_back(std::move(bvhStorage));
+    } else {
+      meshShape->buildOptimizedBvh();
+      if (!bvhCacheFile.empty()) {
+        writeBvhCache(bvhCacheFile, *meshShape->getOptimizedBvh());
+      }
+    }
     // mass == 0 to indicate static. See isStaticObject assert below. See also
     // examples/MultiThreadedDemo/CommonRigidBodyMTBase.h
     btVector3 localInertia(0, 0, 0);
@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 #define ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 
+#include <Corrade/Containers/Array.h>
+
 #include "esp/physics/RigidStage.h"
 #include "esp/physics/bullet/BulletBase.h"
 
@@ -111,6 +113,10 @@ class BulletRigidStage : public BulletBase, public RigidStage {
   //! Stage data: Bullet triangular mesh vertices
   std::vector<std::unique_ptr<btTriangleIndexVertexArray>> bStageArrays_;
 
+  //! Stage data: memory of the bvhs loaded from the cache, see
+  //! @ref assets::ResourceManager::setCollisionBvhCacheDirectory()
+  std::vector<Corrade::Containers::Array<char>> bStageBvhStorage_;
+
   //! Stage data: Bullet triangular mesh shape
   std::vector<std::unique_ptr<btBvhTriangleMeshShape>> bStageShapes_;
 
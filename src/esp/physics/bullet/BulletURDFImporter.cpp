@@ -28,7 +28,7 @@ static float gUrdfDefaultCollisionMargin = 0.001;
 
 btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
     const metadata::URDF::CollisionShape* collision,
-    std::vector<std::unique_ptr<btCollisionShape>>& linkChildShapes) {
+    std::vector<std::shared_ptr<btCollisionShape>>& linkChildShapes) {
   ESP_VERY_VERBOSE() << "convertURDFToCollisionShape";
 
   btCollisionShape* shape = nullptr;
@@ -91,27 +91,41 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
       break;
     }
     case metadata::URDF::GEOM_MESH: {
-      const std::vector<assets::CollisionMeshData>& meshGroup =
-          resourceManager_.getCollisionMesh(
-              collision->m_geometry.m_meshFileName);
-      const assets::MeshMetaData& metaData = resourceManager_.getMeshMetaData(
-          collision->m_geometry.m_meshFileName);
-
-      auto compoundShape = std::make_unique<btCompoundShape>();
-      std::vector<std::unique_ptr<btConvexHullShape>> convexShapes;
-      esp::physics::BulletBase::constructConvexShapesFromMeshes(
-          Magnum::Matrix4{}, meshGroup, metaData.root, compoundShape.get(),
-          convexShapes);
-      // move ownership of convexes
-      for (auto& convex : convexShapes) {
-        linkChildShapes.emplace_back(std::move(convex));
+      const Mn::Vector3& meshScale = collision->m_geometry.m_meshScale;
+      const CollisionShapeCacheKey key{collision->m_geometry.m_meshFileName,
+                                       false, meshScale.x(), meshScale.y(),
+                                       meshScale.z()};
+      auto cached = meshCollisionShapes_.find(key);
+      // build the hulls only for the first link using this mesh at this
+      // scale, every later one references the same shapes
+      if (cached == meshCollisionShapes_.end()) {
+        const std::vector<assets::CollisionMeshData>& meshGroup =
+            resourceManager_.getCollisionMesh(
+                collision->m_geometry.m_meshFileName);
+        const assets::MeshMetaData& metaData =
+            resourceManager_.getMeshMetaData(
+                collision->m_geometry.m_meshFileName);
+
+        MeshCollisionShapes shapes;
+        shapes.compound = std::make_shared<btCompoundShape>();
+        std::vector<std::unique_ptr<btConvexHullShape>> convexShapes;
+        esp::physics::BulletBase::constructConvexShapesFromMeshes(
+            Magnum::Matrix4{}, meshGroup, metaData.root, shapes.compound.get(),
+            convexShapes);
+        for (auto& convex : convexShapes) {
+          shapes.hulls.emplace_back(std::move(convex));
+        }
+        shapes.compound->setLocalScaling(btVector3(meshScale));
+        shapes.compound->setMargin(gUrdfDefaultCollisionMargin);
+        shapes.compound->recalculateLocalAabb();
+        cached = meshCollisionShapes_.emplace(key, std::move(shapes)).first;
+      }
+      // share ownership of the shapes with the link
+      for (const auto& convex : cached->second.hulls) {
+        linkChildShapes.emplace_back(convex);
       }
-      compoundShape->setLocalScaling(
-          btVector3(collision->m_geometry.m_meshScale));
-      compoundShape->setMargin(gUrdfDefaultCollisionMargin);
-      compoundShape->recalculateLocalAabb();
-      shape = compoundShape.get();
-      linkChildShapes.emplace_back(std::move(compoundShape));
+      shape = cached->second.compound.get();
+      linkChildShapes.emplace_back(cached->second.compound);
     } break;  // mesh case
 
     default:
@@ -125,7 +139,7 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
 btCompoundShape* BulletURDFImporter::convertLinkCollisionShapes(
     int urdfLinkIndex,
     const btTransform& localInertiaFrame,
-    std::vector<std::unique_ptr<btCollisionShape>>& linkChildShapes) {
+    std::vector<std::shared_ptr<btCollisionShape>>& linkChildShapes) {
   // TODO: smart pointer
   btCompoundShape* compoundShape = new btCompoundShape();
 
@@ -275,6 +289,18 @@ void BulletURDFImporter::initURDFToBulletCache(
   }
 }
 
+void BulletURDFImporter::evictMeshCollisionShapes(
+    const std::string& meshFileName) {
+  for (auto it = meshCollisionShapes_.begin();
+       it != meshCollisionShapes_.end();) {
+    if (std::get<0>(it->first) == meshFileName) {
+      it = meshCollisionShapes_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void processContactParameters(
     const metadata::URDF::LinkContactInfo& contactInfo,
     btCollisionObject* col) {
@@ -310,7 +336,7 @@ void BulletURDFImporter::convertURDFToBullet(
     const Mn::Matrix4& parentTransformInWorldSpace,
     btMultiBodyDynamicsWorld* world1,
     std::map<int, std::unique_ptr<btCompoundShape>>& linkCompoundShapes,
-    std::map<int, std::vector<std::unique_ptr<btCollisionShape>>>&
+    std::map<int, std::vector<std::shared_ptr<btCollisionShape>>>&
         linkChildShapes) {
   int urdfLinkIndex = getRootLinkIndex();
 
@@ -354,7 +380,7 @@ Mn::Matrix4 BulletURDFImporter::convertURDFToBulletInternal(
     const Mn::Matrix4& parentTransformInWorldSpace,
     btMultiBodyDynamicsWorld* world1,
     std::map<int, std::unique_ptr<btCompoundShape>>& linkCompoundShapes,
-    std::map<int, std::vector<std::unique_ptr<btCollisionShape>>>&
+    std::map<int, std::vector<std::shared_ptr<btCollisionShape>>>&
         linkChildShapes,
     bool recursive) {
   ESP_VERY_VERBOSE() << "++++++++++++++++++++++++++++++++++++++";
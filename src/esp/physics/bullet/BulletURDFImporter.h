@@ -8,8 +8,11 @@
 #define ESP_PHYSICS_BULLET_BULLETURDFIMPORTER_H_
 
 #include <btBulletDynamicsCommon.h>
+#include <map>
+#include <memory>
 #include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
 #include "esp/physics/URDFImporter.h"
+#include "esp/physics/bullet/BulletBase.h"
 namespace esp {
 
 namespace physics {
@@ -97,7 +100,7 @@ class BulletURDFImporter : public URDFImporter {
       const Magnum::Matrix4& parentTransformInWorldSpace,
       btMultiBodyDynamicsWorld* world1,
       std::map<int, std::unique_ptr<btCompoundShape>>& linkCompoundShapes,
-      std::map<int, std::vector<std::unique_ptr<btCollisionShape>>>&
+      std::map<int, std::vector<std::shared_ptr<btCollisionShape>>>&
           linkChildShapes);
 
   //! The temporary Bullet multibody cache initialized by
@@ -110,6 +113,11 @@ class BulletURDFImporter : public URDFImporter {
                      int parentIndex,
                      std::vector<childParentIndex>& allIndices);
 
+  //! Drop the shared collision shapes built from a link collision mesh, so
+  //! they're built again from the mesh when it's next used. Links already
+  //! using them keep their references.
+  void evictMeshCollisionShapes(const std::string& meshFileName);
+
  protected:
   //! Traverse the kinematic chain recursively constructing the btMultiBody
   Magnum::Matrix4 convertURDFToBulletInternal(
@@ -117,7 +125,7 @@ class BulletURDFImporter : public URDFImporter {
       const Magnum::Matrix4& parentTransformInWorldSpace,
       btMultiBodyDynamicsWorld* world1,
       std::map<int, std::unique_ptr<btCompoundShape>>& linkCompoundShapes,
-      std::map<int, std::vector<std::unique_ptr<btCollisionShape>>>&
+      std::map<int, std::vector<std::shared_ptr<btCollisionShape>>>&
           linkChildShapes,
       bool recursive = false);
 
@@ -125,13 +133,13 @@ class BulletURDFImporter : public URDFImporter {
   //! metadata
   btCollisionShape* convertURDFToCollisionShape(
       const struct metadata::URDF::CollisionShape* collision,
-      std::vector<std::unique_ptr<btCollisionShape>>& linkChildShapes);
+      std::vector<std::shared_ptr<btCollisionShape>>& linkChildShapes);
 
   //! Construct all Bullet collision shapes for a link in the active URDF::Model
   btCompoundShape* convertLinkCollisionShapes(
       int linkIndex,
       const btTransform& localInertiaFrame,
-      std::vector<std::unique_ptr<btCollisionShape>>& linkChildShapes);
+      std::vector<std::shared_ptr<btCollisionShape>>& linkChildShapes);
 
   //! Get configured collision groups and masks for a link's collision shape
   int getCollisionGroupAndMask(int linkIndex,
@@ -144,6 +152,18 @@ class BulletURDFImporter : public URDFImporter {
   void computeParentIndices(URDFToBulletCached& bulletCache,
                             int urdfLinkIndex,
                             int urdfParentIndex);
+
+  //! The compound shape built from a link's collision mesh, with the convex
+  //! hulls it references.
+  struct MeshCollisionShapes {
+    std::shared_ptr<btCompoundShape> compound;
+    std::vector<std::shared_ptr<btConvexHullShape>> hulls;
+  };
+
+  //! Collision shapes built from link collision meshes, keyed by mesh and
+  //! scale, shared by every link of every articulated object instance using
+  //! that mesh at that scale. The shared shapes are treated as immutable.
+  std::map<CollisionShapeCacheKey, MeshCollisionShapes> meshCollisionShapes_;
 };
 
 void processContactParameters(
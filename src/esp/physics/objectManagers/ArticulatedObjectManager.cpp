@@ -4,6 +4,9 @@
 
 #include "ArticulatedObjectManager.h"
 
+#include "esp/core/Check.h"
+
+
 namespace esp {
 namespace physics {
 
@@ -74,5 +77,104 @@ ArticulatedObjectManager::addArticulatedObjectByID(
   return nullptr;
 }
 
+template <class F>
+void ArticulatedObjectManager::forEachArticulatedObject(
+    const char* funcName,
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    std::size_t rowCount,
+    std::size_t columnCount,
+    int (ArticulatedObject::*expectedColumnCount)() const,
+    F&& f) const {
+  ESP_CHECK(objectIDs.size() == rowCount,
+            "ArticulatedObjectManager::" << funcName << "(): got"
+                                         << objectIDs.size()
+                                         << "object IDs but" << rowCount
+                                         << "rows");
+  auto physMgr = this->getPhysicsManager();
+  ESP_CHECK(physMgr, "ArticulatedObjectManager::"
+                         << funcName << "(): physics manager no longer exists");
+  for (std::size_t i = 0; i != objectIDs.size(); ++i) {
+    ESP_CHECK(physMgr->isValidArticulatedObjectId(objectIDs[i]),
+              "ArticulatedObjectManager::"
+                  << funcName << "(): object ID" << objectIDs[i]
+                  << "is not an existing articulated object");
+    ArticulatedObject& object = physMgr->getArticulatedObject(objectIDs[i]);
+    const std::size_t expected = (object.*expectedColumnCount)();
+    ESP_CHECK(columnCount == expected,
+              "ArticulatedObjectManager::"
+                  << funcName << "(): object ID" << objectIDs[i] << "has"
+                  << expected << "values but got" << columnCount << "columns");
+    f(i, object);
+  }
+}  // ArticulatedObjectManager::forEachArticulatedObject
+
+void ArticulatedObjectManager::getJointPositions(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<float>& positions) const {
+  forEachArticulatedObject(
+      "getJointPositions", objectIDs, positions.size()[0],
+      positions.size()[1], &ArticulatedObject::getNumJointPositions,
+      [&](std::size_t i, ArticulatedObject& object) {
+        object.getJointPositionsInto(positions[i]);
+      });
+}  // ArticulatedObjectManager::getJointPositions
+
+void ArticulatedObjectManager::setJointPositions(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<const float>& positions) {
+  // validate all objects first, the physics manager then batches the
+  // kinematic updates
+  forEachArticulatedObject("setJointPositions", objectIDs, positions.size()[0],
+                           positions.size()[1],
+                           &ArticulatedObject::getNumJointPositions,
+                           [](std::size_t, ArticulatedObject&) {});
+  this->getPhysicsManager()->setArticulatedObjectsJointPositions(objectIDs,
+                                                                  positions);
+}  // ArticulatedObjectManager::setJointPositions
+
+void ArticulatedObjectManager::getJointVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<float>& velocities) const {
+  forEachArticulatedObject(
+      "getJointVelocities", objectIDs, velocities.size()[0],
+      velocities.size()[1], &ArticulatedObject::getNumDoFs,
+      [&](std::size_t i, ArticulatedObject& object) {
+        object.getJointVelocitiesInto(velocities[i]);
+      });
+}  // ArticulatedObjectManager::getJointVelocities
+
+void ArticulatedObjectManager::setJointVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<const float>& velocities) {
+  forEachArticulatedObject(
+      "setJointVelocities", objectIDs, velocities.size()[0],
+      velocities.size()[1], &ArticulatedObject::getNumDoFs,
+      [&](std::size_t i, ArticulatedObject& object) {
+        object.setJointVelocitiesFrom(velocities[i]);
+      });
+}  // ArticulatedObjectManager::setJointVelocities
+
+void ArticulatedObjectManager::getJointForces(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<float>& forces) const {
+  forEachArticulatedObject(
+      "getJointForces", objectIDs, forces.size()[0], forces.size()[1],
+      &ArticulatedObject::getNumDoFs,
+      [&](std::size_t i, ArticulatedObject& object) {
+        object.getJointForcesInto(forces[i]);
+      });
+}  // ArticulatedObjectManager::getJointForces
+
+void ArticulatedObjectManager::setJointForces(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    const Corrade::Containers::StridedArrayView2D<const float>& forces) {
+  forEachArticulatedObject(
+      "setJointForces", objectIDs, forces.size()[0], forces.size()[1],
+      &ArticulatedObject::getNumDoFs,
+      [&](std::size_t i, ArticulatedObject& object) {
+        object.setJointForcesFrom(forces[i]);
+      });
+}  // ArticulatedObjectManager::setJointForces
+
 }  // namespace physics
 }  // namespace esp
@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_ARTICULATEDOBJECTMANAGER_H
 #define ESP_PHYSICS_ARTICULATEDOBJECTMANAGER_H
 
+#include <Corrade/Containers/StridedArrayView.h>
+
 #include "PhysicsObjectBaseManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletArticulatedObject.h"
 #include "esp/physics/objectWrappers/ManagedArticulatedObject.h"
@@ -199,6 +201,69 @@ class ArticulatedObjectManager
     return objPtr;
   }
 
+  /**
+   * @brief Get the joint positions of multiple articulated objects at once.
+   *
+   * Copies the state of the underlying objects directly into a
+   * caller-provided buffer, without creating a wrapper or allocating a vector
+   * for each, so a vectorized controller can sync all objects in a single
+   * call. All objects are expected to have the same number of joint
+   * positions, such as multiple instances of the same robot.
+   * @param objectIDs The IDs of the objects to query.
+   * @param[out] positions Receives the joint positions, one row for each of
+   * @p objectIDs and one column for each joint position, see
+   * @ref ArticulatedObject::getJointPositions().
+   */
+  void getJointPositions(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<float>& positions) const;
+
+  /**
+   * @brief Set the joint positions of multiple articulated objects at once.
+   * @param objectIDs The IDs of the objects to modify.
+   * @param positions The desired joint positions, one row for each of
+   * @p objectIDs and one column for each joint position.
+   */
+  void setJointPositions(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<const float>& positions);
+
+  /**
+   * @brief Get the joint velocities of multiple articulated objects at once.
+   * See @ref getJointPositions(), the columns are indexed by degrees of
+   * freedom.
+   */
+  void getJointVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<float>& velocities) const;
+
+  /**
+   * @brief Set the joint velocities of multiple articulated objects at once.
+   * See @ref setJointPositions(), the columns are indexed by degrees of
+   * freedom.
+   */
+  void setJointVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<const float>& velocities);
+
+  /**
+   * @brief Get the joint forces/torques of multiple articulated objects at
+   * once. See @ref getJointPositions(), the columns are indexed by degrees of
+   * freedom.
+   */
+  void getJointForces(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<float>& forces) const;
+
+  /**
+   * @brief Set the joint forces/torques of multiple articulated objects at
+   * once. See @ref setJointPositions(), the columns are indexed by degrees of
+   * freedom.
+   */
+  void setJointForces(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      const Corrade::Containers::StridedArrayView2D<const float>& forces);
+
  protected:
   /**
    * @brief This method will remove articulated objects from physics manager.
@@ -220,6 +285,22 @@ class ArticulatedObjectManager
     }
   }  // deleteObjectInternalFinalize
 
+  /**
+   * @brief Resolve each of @p objectIDs to its underlying articulated object
+   * and call @p f with its index in @p objectIDs and the object. Throws if the
+   * physics manager is gone, if any ID isn't an existing articulated object,
+   * if @p rowCount doesn't match the number of IDs or if @p columnCount
+   * doesn't match the count returned by @p expectedColumnCount for an object.
+   */
+  template <class F>
+  void forEachArticulatedObject(
+      const char* funcName,
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      std::size_t rowCount,
+      std::size_t columnCount,
+      int (ArticulatedObject::*expectedColumnCount)() const,
+      F&& f) const;
+
  public:
   ESP_SMART_POINTERS(ArticulatedObjectManager)
 };  // class ArticulatedObjectManager
@@ -3,6 +3,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "RigidObjectManager.h"
+
+#include "esp/core/Check.h"
+
 namespace esp {
 namespace physics {
 
@@ -75,5 +78,150 @@ RigidObjectManager::removePhysObjectByHandle(const std::string& objectHandle,
   return nullptr;
 }  // RigidObjectManager::removeObjectByHandle
 
+template <class F>
+void RigidObjectManager::forEachRigidObject(
+    const char* funcName,
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    std::size_t valueCount,
+    F&& f) const {
+  ESP_CHECK(objectIDs.size() == valueCount,
+            "RigidObjectManager::" << funcName << "(): got" << objectIDs.size()
+                                   << "object IDs but" << valueCount
+                                   << "values");
+  auto physMgr = this->getPhysicsManager();
+  ESP_CHECK(physMgr, "RigidObjectManager::"
+                         << funcName << "(): physics manager no longer exists");
+  for (std::size_t i = 0; i != objectIDs.size(); ++i) {
+    RigidObject* object = physMgr->getRigidObject(objectIDs[i]);
+    ESP_CHECK(object, "RigidObjectManager::" << funcName << "(): object ID"
+                                             << objectIDs[i]
+                                             << "is not an existing rigid "
+                                                "object");
+    f(i, *object);
+  }
+}  // RigidObjectManager::forEachRigidObject
+
+void RigidObjectManager::getTranslations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> translations) const {
+  forEachRigidObject("getTranslations", objectIDs, translations.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       translations[i] = object.getTranslation();
+                     });
+}  // RigidObjectManager::getTranslations
+
+void RigidObjectManager::setTranslations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> translations) {
+  forEachRigidObject("setTranslations", objectIDs, translations.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       object.setTranslation(translations[i]);
+                     });
+}  // RigidObjectManager::setTranslations
+
+void RigidObjectManager::getRotations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Quaternion> rotations) const {
+  forEachRigidObject("getRotations", objectIDs, rotations.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       rotations[i] = object.getRotation();
+                     });
+}  // RigidObjectManager::getRotations
+
+void RigidObjectManager::setRotations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations) {
+  forEachRigidObject("setRotations", objectIDs, rotations.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       object.setRotation(rotations[i]);
+                     });
+}  // RigidObjectManager::setRotations
+
+void RigidObjectManager::getLinearVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> linearVelocities) const {
+  forEachRigidObject("getLinearVelocities", objectIDs, linearVelocities.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       linearVelocities[i] = object.getLinearVelocity();
+                     });
+}  // RigidObjectManager::getLinearVelocities
+
+void RigidObjectManager::setLinearVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> linearVelocities) {
+  forEachRigidObject("setLinearVelocities", objectIDs, linearVelocities.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       object.setLinearVelocity(linearVelocities[i]);
+                     });
+}  // RigidObjectManager::setLinearVelocities
+
+void RigidObjectManager::getAngularVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> angularVelocities) const {
+  forEachRigidObject("getAngularVelocities", objectIDs,
+                     angularVelocities.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       angularVelocities[i] = object.getAngularVelocity();
+                     });
+}  // RigidObjectManager::getAngularVelocities
+
+void RigidObjectManager::setAngularVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> angularVelocities) {
+  forEachRigidObject("setAngularVelocities", objectIDs,
+                     angularVelocities.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       object.setAngularVelocity(angularVelocities[i]);
+                     });
+}  // RigidObjectManager::setAngularVelocities
+
+void RigidObjectManager::getAwake(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<bool> awake) const {
+  forEachRigidObject("getAwake", objectIDs, awake.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       awake[i] = object.isActive();
+                     });
+}  // RigidObjectManager::getAwake
+
+void RigidObjectManager::setAwake(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const bool> awake) {
+  forEachRigidObject("setAwake", objectIDs, awake.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       object.setActive(awake[i]);
+                     });
+}  // RigidObjectManager::setAwake
+
+void RigidObjectManager::getStates(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> translations,
+    Corrade::Containers::ArrayView<Magnum::Quaternion> rotations,
+    Corrade::Containers::ArrayView<Magnum::Vector3> linearVelocities,
+    Corrade::Containers::ArrayView<Magnum::Vector3> angularVelocities,
+    Corrade::Containers::ArrayView<bool> awake) const {
+  ESP_CHECK(rotations.size() == translations.size() &&
+                linearVelocities.size() == translations.size() &&
+                angularVelocities.size() == translations.size() &&
+                awake.size() == translations.size(),
+            "RigidObjectManager::getStates(): expected all outputs to have "
+            "the same size");
+  forEachRigidObject("getStates", objectIDs, translations.size(),
+                     [&](std::size_t i, RigidObject& object) {
+                       translations[i] = object.getTranslation();
+                       rotations[i] = object.getRotation();
+                       linearVelocities[i] = object.getLinearVelocity();
+                       angularVelocities[i] = object.getAngularVelocity();
+                       awake[i] = object.isActive();
+                     });
+}  // RigidObjectManager::getStates
+
+std::vector<int> RigidObjectManager::getExistingObjectIDs() const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    return physMgr->getExistingObjectIDs();
+  }
+  return {};
+}  // RigidObjectManager::getExistingObjectIDs
+
 }  // namespace physics
 }  // namespace esp
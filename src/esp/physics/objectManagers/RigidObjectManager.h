@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_RIGIDOBJECTMANAGER_H
 #define ESP_PHYSICS_RIGIDOBJECTMANAGER_H
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "RigidBaseManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #include "esp/physics/objectWrappers/ManagedRigidObject.h"
@@ -137,6 +139,115 @@ class RigidObjectManager
       bool deleteObjectNode = true,
       bool deleteVisualNode = true);
 
+  /**
+   * @brief Get the translations of multiple rigid objects at once.
+   *
+   * Reads the state of the underlying objects directly, without creating a
+   * wrapper for each, so syncing the state of many objects every step is a
+   * single call.
+   * @param objectIDs The IDs of the objects to query.
+   * @param[out] translations Receives the translation of each object, in the
+   * order of @p objectIDs. Must be the same size as @p objectIDs.
+   */
+  void getTranslations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> translations) const;
+
+  /**
+   * @brief Set the translations of multiple rigid objects at once.
+   * @param objectIDs The IDs of the objects to modify.
+   * @param translations The new translation of each object, in the order of
+   * @p objectIDs. Must be the same size as @p objectIDs.
+   */
+  void setTranslations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> translations);
+
+  /**
+   * @brief Get the rotations of multiple rigid objects at once. See
+   * @ref getTranslations().
+   */
+  void getRotations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Quaternion> rotations) const;
+
+  /**
+   * @brief Set the rotations of multiple rigid objects at once. See
+   * @ref setTranslations().
+   */
+  void setRotations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations);
+
+  /**
+   * @brief Get the linear velocities of multiple rigid objects at once. See
+   * @ref getTranslations().
+   */
+  void getLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> linearVelocities) const;
+
+  /**
+   * @brief Set the linear velocities of multiple rigid objects at once. See
+   * @ref setTranslations().
+   */
+  void setLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> linearVelocities);
+
+  /**
+   * @brief Get the angular velocities of multiple rigid objects at once. See
+   * @ref getTranslations().
+   */
+  void getAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> angularVelocities) const;
+
+  /**
+   * @brief Set the angular velocities of multiple rigid objects at once. See
+   * @ref setTranslations().
+   */
+  void setAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> angularVelocities);
+
+  /**
+   * @brief Get whether multiple rigid objects are awake, i.e. actively
+   * simulated, at once. See @ref getTranslations().
+   */
+  void getAwake(Corrade::Containers::ArrayView<const int> objectIDs,
+                Corrade::Containers::ArrayView<bool> awake) const;
+
+  /**
+   * @brief Wake up or put to sleep multiple rigid objects at once. See
+   * @ref setTranslations().
+   */
+  void setAwake(Corrade::Containers::ArrayView<const int> objectIDs,
+                Corrade::Containers::ArrayView<const bool> awake);
+
+  /**
+   * @brief Get the whole state of multiple rigid objects at once
+   *
+   * Same as calling @ref getTranslations(), @ref getRotations(),
+   * @ref getLinearVelocities(), @ref getAngularVelocities() and
+   * @ref getAwake(), but resolves each object only once. All outputs must be
+   * the same size as @p objectIDs.
+   */
+  void getStates(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> translations,
+      Corrade::Containers::ArrayView<Magnum::Quaternion> rotations,
+      Corrade::Containers::ArrayView<Magnum::Vector3> linearVelocities,
+      Corrade::Containers::ArrayView<Magnum::Vector3> angularVelocities,
+      Corrade::Containers::ArrayView<bool> awake) const;
+
+  /**
+   * @brief Get the IDs of all existing rigid objects, to query the state of
+   * all of them with the batched getters. Empty if the physics manager no
+   * longer exists.
+   */
+  std::vector<int> getExistingObjectIDs() const;
+
  protected:
   /**
    * @brief This method will remove rigid objects from physics manager.  The
@@ -158,6 +269,18 @@ class RigidObjectManager
     }
   }  // deleteObjectInternalFinalize
 
+  /**
+   * @brief Resolve each of @p objectIDs to its underlying rigid object and
+   * call @p f with its index in @p objectIDs and the object. Throws if the
+   * physics manager is gone, if any ID isn't an existing rigid object or if
+   * @p valueCount doesn't match the number of IDs.
+   */
+  template <class F>
+  void forEachRigidObject(const char* funcName,
+                          Corrade::Containers::ArrayView<const int> objectIDs,
+                          std::size_t valueCount,
+                          F&& f) const;
+
  public:
   ESP_SMART_POINTERS(RigidObjectManager)
 };
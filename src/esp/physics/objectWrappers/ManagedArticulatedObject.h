@@ -5,6 +5,7 @@
 #ifndef ESP_PHYSICS_MANAGEDARTICULATEDOBJECT_H_
 #define ESP_PHYSICS_MANAGEDARTICULATEDOBJECT_H_
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include "ManagedPhysicsObjectBase.h"
 #include "esp/physics/ArticulatedObject.h"
 
@@ -319,6 +320,17 @@ class ManagedArticulatedObject
     }
   }
 
+  void setJointMotorTargets(const std::vector<float>& positionTargets,
+                            const std::vector<float>& velocityTargets,
+                            const std::vector<float>& maxImpulses) {
+    if (auto sp = getObjectReference()) {
+      sp->setJointMotorTargetsFrom(
+          Corrade::Containers::arrayView(positionTargets),
+          Corrade::Containers::arrayView(velocityTargets),
+          Corrade::Containers::arrayView(maxImpulses));
+    }
+  }
+
  protected:
   /**
    * @brief Retrieve a comma-separated string holding the header values for the
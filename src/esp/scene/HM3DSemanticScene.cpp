@@ -3,12 +3,13 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "HM3DSemanticScene.h"
+#include "SemanticHouseFile.h"
 #include "SemanticScene.h"
 
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/FormatStl.h>
-#include <fstream>
 #include <map>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 
 namespace Cr = Corrade;
@@ -23,18 +24,17 @@ bool SemanticScene::loadHM3DHouse(
   if (!checkFileExists(houseFilename, "loadHM3DHouse")) {
     return false;
   }
-  // open stream and determine house format version
-  std::ifstream ifs = std::ifstream(houseFilename);
-  std::string header;
-  std::getline(ifs, header);
-
-  if (header.find("HM3D Semantic Annotations") == std::string::npos) {
+  // open file and determine house format version
+  SemanticHouseFile file{houseFilename};
+  Cr::Containers::StringView header;
+  if (!file.isOpen() || !file.nextLine(header) ||
+      !header.contains("HM3D Semantic Annotations")) {
     ESP_ERROR() << "Unsupported HM3D House format header" << header
                 << "in file name" << houseFilename;
     return false;
   }
 
-  return buildHM3DHouse(ifs, scene, rotation);
+  return buildHM3DHouse(file, scene, rotation);
 }  // SemanticScene::loadHM3DHouse
 
 namespace {
@@ -90,7 +90,7 @@ void buildInstanceRegionCategory(
 
 }  // namespace
 
-bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
+bool SemanticScene::buildHM3DHouse(SemanticHouseFile& file,
                                    SemanticScene& scene,
                                    const quatf& /*rotation*/) {
   // temp constructs
@@ -101,9 +101,12 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
   buildInstanceRegionCategory(0, 0, "Unknown", -1, objInstance, regions,
                               categories);
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
+  // tokens and subtokens are views into the file, reused between lines
+  Cr::Containers::StringView line;
+  std::vector<Cr::Containers::StringView> tokens;
+  std::vector<Cr::Containers::StringView> subtokens;
+  while (file.nextLine(line)) {
+    if (line.isEmpty()) {
       continue;
     }
 
@@ -117,26 +120,25 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
     // idx 0 will be "<ID>,<color>,"
     // idx 1 will be "<category with possible commas>"
     // idx 2 will be ",<region ID>"
-    const std::vector<std::string> tokens =
-        Cr::Utility::String::splitWithoutEmptyParts(line, '"');
+    splitHouseLine(line, '"', tokens);
+    if (tokens.size() < 3) {
+      throw std::invalid_argument("Malformed HM3D annotation line: " +
+                                  std::string{line});
+    }
     // sub tokens are ID and color
-    const std::vector<std::string> subtokens =
-        Cr::Utility::String::splitWithoutEmptyParts(tokens[0], ',');
+    splitHouseLine(tokens[0], ',', subtokens);
+    if (subtokens.size() < 2) {
+      throw std::invalid_argument("Malformed HM3D annotation line: " +
+                                  std::string{line});
+    }
     // ID is integer
-    int instanceID = std::stoi(Cr::Utility::String::trim(subtokens[0]));
+    int instanceID = parseHouseInt(subtokens[0]);
     // semantic color is 2nd token, as hex string
-    const unsigned colorInt =
-        std::stoul(Cr::Utility::String::trim(subtokens[1]), nullptr, 16);
-    // convert a hex string containing 3 bytes to a vector3ub (represents a
-    // color)
-    Mn::Vector3ub colorVec = {uint8_t((colorInt >> 16) & 0xff),
-                              uint8_t((colorInt >> 8) & 0xff),
-                              uint8_t(colorInt & 0xff)};
+    const unsigned colorInt = parseHouseInt(subtokens[1], 16);
     // object category will possibly have commas
-    const std::string& objCategoryName = tokens[1];
+    const std::string objCategoryName = tokens[1];
     // room/region is always last token - get rid of first comma
-    int regionID =
-        std::stoi(Cr::Utility::String::trim(tokens[tokens.size() - 1], " ,"));
+    int regionID = parseHouseInt(tokens.back().trimmed(" ,"));
 
     buildInstanceRegionCategory(instanceID, colorInt, objCategoryName, regionID,
                                 objInstance, regions, categories);
@@ -180,10 +182,10 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
   // object instances
   scene.objects_.clear();
   scene.objects_.reserve(objInstance.size());
-  for (auto& item : objInstance) {
-    TempHM3DObject obj = item.second;
-    auto objPtr = std::make_shared<HM3DObjectInstance>(HM3DObjectInstance(
-        obj.objInstanceID, obj.objCatID, obj.objInstanceName, obj.colorInt));
+  for (const auto& item : objInstance) {
+    const TempHM3DObject& obj = item.second;
+    auto objPtr = std::make_shared<HM3DObjectInstance>(
+        obj.objInstanceID, obj.objCatID, obj.objInstanceName, obj.colorInt);
     objPtr->category_ = categories[obj.categoryName].category_;
     // set region
     objPtr->parentIndex_ = obj.region->index_;
@@ -234,6 +236,7 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
 
   // Not used for Hm3d currently
   scene.levels_.clear();
+  scene.buildRegionGrid();
   return true;
 
 }  // SemanticScene::buildHM3DHouse
@@ -3,12 +3,14 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Mp3dSemanticScene.h"
+#include "SemanticHouseFile.h"
 #include "SemanticScene.h"
 
+#include <Corrade/Containers/StringStl.h>
+
 #include <algorithm>
-#include <fstream>
 #include <map>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 
 namespace esp {
@@ -89,29 +91,29 @@ bool SemanticScene::loadMp3dHouse(
     return false;
   }
 
-  // open stream and determine house format version
-  std::ifstream ifs = std::ifstream(houseFilename);
-  std::string header;
-  std::getline(ifs, header);
-  if (header != "ASCII 1.1") {
+  // open file and determine house format version
+  SemanticHouseFile file{houseFilename};
+  Cr::Containers::StringView header;
+  if (!file.isOpen() || !file.nextLine(header) || header != "ASCII 1.1") {
     ESP_ERROR() << "Unsupported Mp3d House format header" << header
                 << "in file name" << houseFilename;
     return false;
   }
 
-  return buildMp3dHouse(ifs, scene, rotation);
+  return buildMp3dHouse(file, scene, rotation);
 }  // SemanticScene::loadMp3dHouse
 
-bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
+bool SemanticScene::buildMp3dHouse(SemanticHouseFile& file,
                                    SemanticScene& scene,
                                    const quatf& rotation) {
   const bool hasWorldRotation = !rotation.isApprox(quatf::Identity());
+  using Tokens = std::vector<Cr::Containers::StringView>;
 
-  auto getVec3f = [&](const std::vector<std::string>& tokens, int offset,
+  auto getVec3f = [&](const Tokens& tokens, int offset,
                       bool applyRotation = true) -> vec3f {
-    const float x = std::stof(tokens[offset]);
-    const float y = std::stof(tokens[offset + 1]);
-    const float z = std::stof(tokens[offset + 2]);
+    const float x = parseHouseFloat(tokens[offset]);
+    const float y = parseHouseFloat(tokens[offset + 1]);
+    const float z = parseHouseFloat(tokens[offset + 2]);
     vec3f p = vec3f(x, y, z);
     if (applyRotation && hasWorldRotation) {
       p = rotation * p;
@@ -119,8 +121,7 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
     return p;
   };
 
-  auto getBBox = [&](const std::vector<std::string>& tokens,
-                     int offset) -> box3f {
+  auto getBBox = [&](const Tokens& tokens, int offset) -> box3f {
     // Get the bounding box without rotating as rotating min/max is odd
     box3f sceneBox{getVec3f(tokens, offset, /*applyRotation=*/false),
                    getVec3f(tokens, offset + 3, /*applyRotation=*/false)};
@@ -136,7 +137,7 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
                  (worldCenter + worldHalfSizes).eval()};
   };
 
-  auto getOBB = [&](const std::vector<std::string>& tokens, int offset) {
+  auto getOBB = [&](const Tokens& tokens, int offset) {
     const vec3f center = getVec3f(tokens, offset);
 
     // Don't need to apply rotation here, it'll already be added in by getVec3f
@@ -156,39 +157,62 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
   scene.regions_.clear();
   scene.objects_.clear();
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
+  // tokens are views into the file, reused between lines
+  Cr::Containers::StringView line;
+  Tokens tokens;
+  // minimum token count of each record type that is read
+  auto requireTokens = [&](std::size_t count) {
+    if (tokens.size() < count) {
+      throw std::invalid_argument("Malformed Mp3d house line: " +
+                                  std::string{line});
+    }
+  };
+  while (file.nextLine(line)) {
+    if (line.isEmpty()) {
       continue;
     }
-    const std::vector<std::string> tokens =
-        Cr::Utility::String::splitWithoutEmptyParts(line, ' ');
-    switch (line[0]) {
+    // portals, panoramas, surfaces, vertices and images make up most of the
+    // file but aren't used, skip them without tokenizing
+    const char recordType = line[0];
+    if (recordType == 'P' || recordType == 'S' || recordType == 'V' ||
+        recordType == 'I') {
+      continue;
+    }
+    splitHouseLine(line, ' ', tokens);
+    switch (recordType) {
       case 'H': {  // house
         // H name label #images #panoramas #vertices #surfaces #segments
         //   #objects #categories #regions #portals #levels  0 0 0 0 0
         //   xlo ylo zlo xhi yhi zhi  0 0 0 0 0
+        requireTokens(24);
         scene.name_ = tokens[1];
         scene.label_ = tokens[2];
-        scene.elementCounts_["images"] = std::stoi(tokens[3]);
-        scene.elementCounts_["panoramas"] = std::stoi(tokens[4]);
-        scene.elementCounts_["vertices"] = std::stoi(tokens[5]);
-        scene.elementCounts_["surfaces"] = std::stoi(tokens[6]);
-        scene.elementCounts_["segments"] = std::stoi(tokens[7]);
-        scene.elementCounts_["objects"] = std::stoi(tokens[8]);
-        scene.elementCounts_["categories"] = std::stoi(tokens[9]);
-        scene.elementCounts_["regions"] = std::stoi(tokens[10]);
-        scene.elementCounts_["portals"] = std::stoi(tokens[11]);
-        scene.elementCounts_["levels"] = std::stoi(tokens[12]);
+        scene.elementCounts_["images"] = parseHouseInt(tokens[3]);
+        scene.elementCounts_["panoramas"] = parseHouseInt(tokens[4]);
+        scene.elementCounts_["vertices"] = parseHouseInt(tokens[5]);
+        scene.elementCounts_["surfaces"] = parseHouseInt(tokens[6]);
+        scene.elementCounts_["segments"] = parseHouseInt(tokens[7]);
+        scene.elementCounts_["objects"] = parseHouseInt(tokens[8]);
+        scene.elementCounts_["categories"] = parseHouseInt(tokens[9]);
+        scene.elementCounts_["regions"] = parseHouseInt(tokens[10]);
+        scene.elementCounts_["portals"] = parseHouseInt(tokens[11]);
+        scene.elementCounts_["levels"] = parseHouseInt(tokens[12]);
         scene.bbox_ = getBBox(tokens, 18);
+        // allocate the element lists up front
+        scene.objects_.reserve(scene.elementCounts_["objects"]);
+        scene.categories_.reserve(scene.elementCounts_["categories"]);
+        scene.regions_.reserve(scene.elementCounts_["regions"]);
+        scene.levels_.reserve(scene.elementCounts_["levels"]);
+        scene.segmentToObjectIndex_.reserve(scene.elementCounts_["segments"]);
         break;
       }
       case 'L': {  // level
         // L level_index #regions label  px py pz  xlo ylo zlo xhi yhi zhi  0 0
         //   0 0 0
+        requireTokens(13);
         scene.levels_.emplace_back(SemanticLevel::create());
         auto& level = scene.levels_.back();
-        level->index_ = std::stoi(tokens[1]);
+        level->index_ = parseHouseInt(tokens[1]);
         // NOTE tokens[2] is number of regions in level which we don't need
         level->labelCode_ = tokens[3];
         level->position_ = getVec3f(tokens, 4);
@@ -198,10 +222,11 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
       case 'R': {  // region
         // R region_index level_index 0 0 label  px py pz  xlo ylo zlo xhi yhi
         //   zhi height  0 0 0 0
+        requireTokens(15);
         scene.regions_.emplace_back(SemanticRegion::create());
         auto& region = scene.regions_.back();
-        region->index_ = std::stoi(tokens[1]);
-        region->parentIndex_ = std::stoi(tokens[2]);
+        region->index_ = parseHouseInt(tokens[1]);
+        region->parentIndex_ = parseHouseInt(tokens[2]);
         region->category_ = std::make_shared<Mp3dRegionCategory>(tokens[5][0]);
         region->position_ = getVec3f(tokens, 6);
         region->bbox_ = getBBox(tokens, 9);
@@ -211,55 +236,31 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         }
         break;
       }
-      // NOLINTNEXTLINE(bugprone-branch-clone)
-      case 'P': {  // portal or panorama
-        // P portal_index region0_index region1_index label  xlo ylo zlo xhi
-        //   yhi zhi  0 0 0 0
-        // P name  panorama_index region_index 0  px py pz  0 0 0 0 0
-        break;
-      }
-      // NOLINTNEXTLINE(bugprone-branch-clone)
-      case 'S': {  // surface
-        // S surface_index region_index 0 label px py pz  nx ny nz  xlo ylo
-        // zlo
-        //   xhi yhi zhi  0 0 0 0 0
-        break;
-      }
-      // NOLINTNEXTLINE(bugprone-branch-clone)
-      case 'V': {  // vertex
-        // V vertex_index surface_index label  px py pz  nx ny nz  0 0 0
-        break;
-      }
-      // NOLINTNEXTLINE(bugprone-branch-clone)
-      case 'I': {  // image
-        // I image_index panorama_index  name camera_index yaw_index e00 e01
-        //   e02 e03 e10 e11 e12 e13 e20 e21 e22 e23 e30 e31 e32 e33  i00 i01
-        //   i02  i10 i11 i12 i20 i21 i22  width height  px py pz  0 0 0 0 0
-        break;
-      }
       case 'C': {  // category
         // C category_index category_mapping_index category_mapping_name
         //   mpcat40_index mpcat40_name 0 0 0 0 0
+        requireTokens(6);
         scene.categories_.emplace_back(std::make_shared<Mp3dObjectCategory>());
         auto& category =
             static_cast<Mp3dObjectCategory&>(*scene.categories_.back());
-        category.index_ = std::stoi(tokens[1]);
-        category.categoryMappingIndex_ = std::stoi(tokens[2]);
+        category.index_ = parseHouseInt(tokens[1]);
+        category.categoryMappingIndex_ = parseHouseInt(tokens[2]);
         std::string catName = tokens[3];
         std::replace(catName.begin(), catName.end(), '#', ' ');
         category.categoryMappingName_ = catName;
-        category.mpcat40Index_ = std::stoi(tokens[4]);
+        category.mpcat40Index_ = parseHouseInt(tokens[4]);
         category.mpcat40Name_ = tokens[5];
         break;
       }
       case 'O': {  // object
         // O object_index region_index category_index px py pz  a0x a0y a0z
         //   a1x a1y a1z  r0 r1 r2 0 0 0 0 0 0 0 0
+        requireTokens(16);
         scene.objects_.emplace_back(SemanticObject::create());
         auto& object = scene.objects_.back();
-        object->index_ = std::stoi(tokens[1]);
-        object->parentIndex_ = std::stoi(tokens[2]);
-        int categoryIndex = std::stoi(tokens[3]);
+        object->index_ = parseHouseInt(tokens[1]);
+        object->parentIndex_ = parseHouseInt(tokens[2]);
+        int categoryIndex = parseHouseInt(tokens[3]);
         if (categoryIndex < 0) {  // no category
           object->category_ = std::make_shared<Mp3dObjectCategory>();
         } else {
@@ -275,8 +276,9 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
       case 'E': {  // segment
         // E segment_index object_index id area px py pz xlo ylo zlo xhi yhi
         // zhi 0 0 0 0 0
-        const int objectIndex = std::stoi(tokens[2]);
-        const int segmentId = std::stoi(tokens[3]);
+        requireTokens(4);
+        const int objectIndex = parseHouseInt(tokens[2]);
+        const int segmentId = parseHouseInt(tokens[3]);
         // NOTE: segmentId = regionIndex * 1000000 + segmentId
         scene.segmentToObjectIndex_[segmentId] = objectIndex;
         break;
@@ -287,6 +289,7 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
     }
   }
   scene.hasVertColors_ = true;
+  scene.buildRegionGrid();
   return true;
 
 }  // SemanticScene::buildMp3dHouse
@@ -38,5 +38,14 @@ bool SceneGraph::deleteDrawableGroup(const std::string& id) {
   return drawableGroups_.erase(id) != 0u;
 }
 
+void SceneGraph::deleteDrawables() {
+  for (auto& group : drawableGroups_) {
+    // deleting a drawable removes it from its group
+    while (!group.second.isEmpty()) {
+      delete &group.second[0];
+    }
+  }
+}
+
 }  // namespace scene
 }  // namespace esp
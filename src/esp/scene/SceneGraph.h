@@ -93,6 +93,15 @@ class SceneGraph {
    */
   bool deleteDrawableGroup(const std::string& id);
 
+  /**
+   * @brief Deletes the drawables of all @ref DrawableGroup "DrawableGroups",
+   * leaving the nodes in place
+   *
+   * Used to drop references to render assets of a scene graph that's no
+   * longer drawn before the assets are unloaded.
+   */
+  void deleteDrawables();
+
  protected:
   MagnumScene world_;
 
@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/Assert.h>
 
 #include "SceneGraph.h"
@@ -29,6 +30,7 @@ SceneNode::SceneNode()
 SceneNode::SceneNode(SceneNode& parent) : SceneNode() {
   MagnumObject::setParent(&parent);
   setId(parent.getId());
+  parent.markCumulativeBBDirty();
 }
 SceneNode::SceneNode(MagnumScene& parentNode) : SceneNode() {
   MagnumObject::setParent(&parentNode);
@@ -47,6 +49,11 @@ SceneNode::~SceneNode() {
     return;
   }
 
+  // the parent's bounding box loses this subtree
+  if (SceneNode* parentNode = parentSceneNode()) {
+    parentNode->markCumulativeBBDirty();
+  }
+
   // If parent node is not nullptr, update the sensorSuites stored in each
   // ancestor node in a bottom-up manner.
 
@@ -105,6 +112,12 @@ SceneNode& SceneNode::setParent(SceneNode* newParent) {
   // Update old ancestors' SubtreeSensorSuites
   removeSubtreeSensorsFromAncestors();
 
+  // Update old and new ancestors' cumulative bounding boxes
+  if (SceneNode* oldParent = parentSceneNode()) {
+    oldParent->markCumulativeBBDirty();
+  }
+  newParent->markCumulativeBBDirty();
+
   MagnumObject::setParent(newParent);
 
   // Update new ancestors'SubtreeSensorSuites
@@ -126,13 +139,13 @@ void SceneNode::addSensorToParentNodeSensorSuite() {
   // Get the first one, and if it is valid, add it to parent's nodeSensorSuite
   std::map<std::string, std::reference_wrapper<sensor::Sensor>>::iterator it =
       nodeSensorSuite_->getSensors().begin();
-  SceneNode* parentNode = dynamic_cast<SceneNode*>(this->parent());
+  SceneNode* parentNode = parentSceneNode();
   // SceneNode::addSensorToParentNodeSensorSuite() is only called when
   // constructing a sensor or setting the new parent of a node, so parentNode
   // should never be nullptr
   CORRADE_ASSERT(parentNode != nullptr,
-                 "SceneNode::addSensorToParentNodeSensorSuite(): Cannot cast "
-                 "the parent node to a SceneNode", );
+                 "SceneNode::addSensorToParentNodeSensorSuite(): The node has "
+                 "no parent SceneNode", );
   parentNode->getNodeSensorSuite().add(it->second);
 }
 
@@ -149,7 +162,7 @@ void SceneNode::removeSensorFromParentNodeSensorSuite() {
   // nodeSensorSuite
   std::map<std::string, std::reference_wrapper<sensor::Sensor>>::iterator it =
       nodeSensorSuite_->getSensors().begin();
-  SceneNode* parentNode = dynamic_cast<SceneNode*>(this->parent());
+  SceneNode* parentNode = parentSceneNode();
   // If parentNode has not been deconstructed, remove leaf node's sensor from
   // parentNode's nodeSensorSuite
   if (parentNode != nullptr) {
@@ -164,13 +177,10 @@ void SceneNode::addSubtreeSensorsToAncestors() {
     return;
   }
   for (const auto& entry : subtreeSensorSuite_->getSensors()) {
-    SceneNode* currentNode = this;
-    do {
-      currentNode = dynamic_cast<SceneNode*>(currentNode->parent());
-      if (currentNode != nullptr) {
-        currentNode->getSubtreeSensorSuite().add(entry.second);
-      }
-    } while ((currentNode != nullptr) && !SceneGraph::isRootNode(*currentNode));
+    for (SceneNode* currentNode = parentSceneNode(); currentNode != nullptr;
+         currentNode = currentNode->parentSceneNode()) {
+      currentNode->getSubtreeSensorSuite().add(entry.second);
+    }
   }
 }
 
@@ -181,34 +191,58 @@ void SceneNode::removeSubtreeSensorsFromAncestors() {
     return;
   }
   for (const auto& entry : subtreeSensorSuite_->getSensors()) {
-    SceneNode* currentNode = this;
-    do {
-      currentNode = dynamic_cast<SceneNode*>(currentNode->parent());
-      if (currentNode != nullptr) {
-        currentNode->getSubtreeSensorSuite().remove(entry.first);
-      }
-    } while ((currentNode != nullptr) && !SceneGraph::isRootNode(*currentNode));
+    for (SceneNode* currentNode = parentSceneNode(); currentNode != nullptr;
+         currentNode = currentNode->parentSceneNode()) {
+      currentNode->getSubtreeSensorSuite().remove(entry.first);
+    }
   }
 }
 
-//! @brief recursively compute the cumulative bounding box of this node's tree.
-const Mn::Range3D& SceneNode::computeCumulativeBB() {
-  // first copy from your precomputed mesh bb
-  cumulativeBB_ = Mn::Range3D(meshBB_);
-  auto* child = children().first();
+SceneNode* SceneNode::parentSceneNode() {
+  MagnumObject* parentObject = parent();
+  // the parent of the root node is the scene, which has no parent itself
+  if (!parentObject || !parentObject->parent()) {
+    return nullptr;
+  }
+  return static_cast<SceneNode*>(parentObject);
+}
 
-  while (child != nullptr) {
-    SceneNode* child_node = dynamic_cast<SceneNode*>(child);
-    if (child_node != nullptr) {
-      child_node->computeCumulativeBB();
+void SceneNode::markCumulativeBBDirty() {
+  // ancestors of a dirty node are dirty already, so stop at the first one
+  for (SceneNode* node = this; node && !node->cumulativeBBDirty_;
+       node = node->parentSceneNode()) {
+    node->cumulativeBBDirty_ = true;
+  }
+}
 
-      Mn::Range3D transformedBB = esp::geo::getTransformedBB(
-          child_node->cumulativeBB_, child_node->transformation());
+//! @brief compute the cumulative bounding box of this node's tree, recursing
+//! only into dirty subtrees.
+const Mn::Range3D& SceneNode::computeCumulativeBB() {
+  if (!cumulativeBBDirty_) {
+    return cumulativeBB_;
+  }
 
-      cumulativeBB_ = Mn::Math::join(cumulativeBB_, transformedBB);
-    }
-    child = child->nextSibling();
+  // first copy from your precomputed mesh bb
+  cumulativeBB_ = Mn::Range3D(meshBB_);
+  // moves of children with a dirty transformation aren't reported to
+  // markDirty(), so if there are any, this node has to stay dirty
+  bool staysDirty = false;
+  // the boxes of all children are transformed at once
+  std::vector<Mn::Range3D> childBBs;
+  std::vector<Mn::Matrix4> childTransformations;
+  for (MagnumObject& child : children()) {
+    SceneNode& child_node = static_cast<SceneNode&>(child);
+    childBBs.push_back(child_node.computeCumulativeBB());
+    child_node.cumulativeBBTransformation_ = child_node.transformation();
+    childTransformations.push_back(child_node.cumulativeBBTransformation_);
+    staysDirty = staysDirty || child_node.cumulativeBBDirty_ ||
+                 child_node.isDirty();
   }
+  geo::getTransformedBBs(childBBs, childTransformations, childBBs);
+  for (const Mn::Range3D& transformedBB : childBBs) {
+    cumulativeBB_ = Mn::Math::join(cumulativeBB_, transformedBB);
+  }
+  cumulativeBBDirty_ = staysDirty;
   return cumulativeBB_;
 }
 
@@ -218,6 +252,16 @@ void SceneNode::clean(const Magnum::Matrix4& absoluteTransformation) {
   absoluteTransformation_ = absoluteTransformation;
 }
 
+void SceneNode::markDirty() {
+  // also called for all descendants when an ancestor moves, of which only
+  // the ones whose own transformation changed affect their parent
+  SceneNode* parentNode = parentSceneNode();
+  if (parentNode && !parentNode->cumulativeBBDirty_ &&
+      transformation() != cumulativeBBTransformation_) {
+    parentNode->markCumulativeBBDirty();
+  }
+}
+
 Mn::Vector3 SceneNode::absoluteTranslation() const {
   if (isDirty())
     return absoluteTransformation().translation();
@@ -241,6 +285,24 @@ const Mn::Range3D& SceneNode::getAbsoluteAABB() const {
   }
 }
 
+void SceneNode::updateAbsoluteAABBs(
+    Cr::Containers::ArrayView<SceneNode* const> nodes) {
+  std::vector<SceneNode*> pending;
+  std::vector<Mn::Range3D> boxes;
+  std::vector<Mn::Matrix4> transformations;
+  for (SceneNode* node : nodes) {
+    if (!node->aabb_ && !node->worldCumulativeBB_) {
+      pending.push_back(node);
+      boxes.push_back(node->getCumulativeBB());
+      transformations.push_back(node->absoluteTransformation_);
+    }
+  }
+  geo::getTransformedBBs(boxes, transformations, boxes);
+  for (std::size_t i = 0; i != pending.size(); ++i) {
+    pending[i]->worldCumulativeBB_ = boxes[i];
+  }
+}
+
 void SceneNode::setSemanticIDVector(const std::vector<int>& _semanticIDs) {
   if (semanticIDs_.size() < _semanticIDs.size()) {
     semanticIDs_.resize(_semanticIDs.size());
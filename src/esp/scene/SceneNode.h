@@ -7,6 +7,7 @@
 
 #include <stack>
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Containers.h>
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/Math/Range.h>
@@ -216,16 +217,53 @@ class SceneNode : public MagnumObject,
 
   Magnum::Vector3 absoluteTranslation();
 
-  //! recursively compute the cumulative bounding box of the full scene graph
-  //! tree for which this node is the root
+  /**
+   * @brief Compute the cumulative bounding box of the full scene graph tree
+   * for which this node is the root
+   *
+   * Only recomputes the nodes whose cumulative bounding box is dirty, which
+   * are the ancestors of nodes whose mesh bounding box, children or
+   * transformation changed since the last computation, and reuses the
+   * bounding boxes of all other subtrees. Transformation changes are
+   * reported by the scene graph only once until the absolute transformation
+   * is cleaned, so the parents of nodes that aren't clean yet are recomputed
+   * by every call.
+   */
   const Magnum::Range3D& computeCumulativeBB();
 
+  /**
+   * @brief Whether the next @ref computeCumulativeBB() recomputes the
+   * cumulative bounding box of this node
+   */
+  bool isCumulativeBBDirty() const { return cumulativeBBDirty_; }
+
+  /**
+   * @brief Mark the cumulative bounding box of this node and its ancestors
+   * dirty
+   *
+   * Done automatically by @ref setMeshBB(), when children are added or
+   * removed and when the transformation of a child changes.
+   */
+  void markCumulativeBBDirty();
+
   //! return the local bounding box for meshes stored at this node
   const Magnum::Range3D& getMeshBB() const { return meshBB_; };
 
   //! return the global bounding box for the mesh stored at this node
   const Magnum::Range3D& getAbsoluteAABB() const;
 
+  /**
+   * @brief Compute the global bounding boxes of many nodes at once
+   *
+   * Transforms the cumulative bounding boxes of all @p nodes that don't have
+   * a valid @ref getAbsoluteAABB() yet with @ref geo::getTransformedBBs(),
+   * so the following @ref getAbsoluteAABB() calls only return them. Like
+   * @ref getAbsoluteAABB(), this uses the absolute transformations from the
+   * last @ref setClean() of each node.
+   */
+  static void updateAbsoluteAABBs(
+      Corrade::Containers::ArrayView<SceneNode* const> nodes);
+
   //! return the cumulative bounding box of the full scene graph tree for which
   //! this node is the root
   const Magnum::Range3D& getCumulativeBB() const { return cumulativeBB_; };
@@ -282,7 +320,10 @@ class SceneNode : public MagnumObject,
   void addSubtreeSensorsToAncestors();
 
   //! set local bounding box for meshes stored at this node
-  void setMeshBB(Magnum::Range3D meshBB) { meshBB_ = meshBB; };
+  void setMeshBB(Magnum::Range3D meshBB) {
+    meshBB_ = meshBB;
+    markCumulativeBBDirty();
+  };
 
   //! set the global bounding box for mesh stored in this node
   void setAbsoluteAABB(Magnum::Range3D aabb) { aabb_ = aabb; };
@@ -299,6 +340,10 @@ class SceneNode : public MagnumObject,
   friend class SceneGraph;
   explicit SceneNode(MagnumScene& parentNode);
 
+  // mirrors the world transformations it computes into
+  // absoluteTransformation_
+  friend class TransformStore;
+
   // Do not make the following constructor public!
   // This is only used for constructor delegation
   // creating a scene node "in the air" is not allowed.
@@ -309,6 +354,16 @@ class SceneNode : public MagnumObject,
 
   void clean(const Magnum::Matrix4& absoluteTransformation) override;
 
+  // marks the parent's cumulative bounding box dirty if the transformation
+  // changed since the parent last joined it
+  void markDirty() override;
+
+  // the parent SceneNode, nullptr for the root node. Nodes are only ever
+  // parented to SceneNodes or, for the root node, to the scene, as the
+  // constructors and setParent() take SceneNodes, so the children and
+  // parents of a node are cast to SceneNode without RTTI.
+  SceneNode* parentSceneNode();
+
   // the type of the attached object (e.g., sensor, agent etc.)
   SceneNodeType type_ = SceneNodeType::EMPTY;
   int id_ = ID_UNDEFINED;
@@ -323,6 +378,13 @@ class SceneNode : public MagnumObject,
   //! node is the root
   Magnum::Range3D cumulativeBB_ = {{0.0, 0.0, 0.0}, {1e5, 1e5, 1e5}};
 
+  //! whether cumulativeBB_ has to be recomputed. The ancestors of a dirty
+  //! node are dirty as well.
+  bool cumulativeBBDirty_ = true;
+
+  //! the transformation the parent's cumulativeBB_ was computed with
+  Magnum::Matrix4 cumulativeBBTransformation_;
+
   //! The cumulativeBB in world coordinates
   //! This is returned instead of aabb_ if that doesn't exist
   //! due to this being a node that is part of a dynamic object
@@ -0,0 +1,133 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticHouseFile.h"
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace scene {
+
+namespace {
+// Longest number token parsed, anything longer is not a number
+constexpr std::size_t MaxNumberTokenSize = 63;
+
+// Copy the trimmed token to a null-terminated buffer for strtol/strtof, as
+// the token is a view into the file contents
+const char* terminateToken(Cr::Containers::StringView token,
+                           char (&buffer)[MaxNumberTokenSize + 1]) {
+  token = token.trimmed();
+  if (token.isEmpty() || token.size() > MaxNumberTokenSize) {
+    throw std::invalid_argument("Not a number: " + std::string{token});
+  }
+  std::memcpy(buffer, token.data(), token.size());
+  buffer[token.size()] = '\0';
+  return buffer;
+}
+}  // namespace
+
+SemanticHouseFile::SemanticHouseFile(const std::string& filename) {
+#if defined(CORRADE_TARGET_UNIX) || \
+    (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+  // mapping fails for empty files, which are then read below
+  if (Cr::Containers::Optional<
+          Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+          mapped = Cr::Utility::Path::mapRead(filename)) {
+    mapped_ = *std::move(mapped);
+    remaining_ = {mapped_.data(), mapped_.size()};
+    isOpen_ = true;
+    return;
+  }
+#endif
+  if (Cr::Containers::Optional<Cr::Containers::Array<char>> read =
+          Cr::Utility::Path::read(filename)) {
+    read_ = *std::move(read);
+    remaining_ = {read_.data(), read_.size()};
+    isOpen_ = true;
+  }
+}
+
+bool SemanticHouseFile::nextLine(Cr::Containers::StringView& line) {
+  if (remaining_.isEmpty()) {
+    return false;
+  }
+  const char* begin = remaining_.data();
+  const char* end = static_cast<const char*>(
+      std::memchr(begin, '\n', remaining_.size()));
+  if (end == nullptr) {
+    line = remaining_;
+    remaining_ = {};
+  } else {
+    line = {begin, std::size_t(end - begin)};
+    remaining_ = remaining_.exceptPrefix(line.size() + 1);
+  }
+  // files written on Windows
+  if (line.hasSuffix('\r')) {
+    line = line.exceptSuffix(1);
+  }
+  return true;
+}
+
+std::size_t SemanticHouseFile::remainingLineCount() const {
+  if (remaining_.isEmpty()) {
+    return 0;
+  }
+  const std::size_t newlines =
+      std::count(remaining_.begin(), remaining_.end(), '\n');
+  return newlines + (remaining_.back() != '\n');
+}
+
+void splitHouseLine(Cr::Containers::StringView line,
+                    char delimiter,
+                    std::vector<Cr::Containers::StringView>& tokens) {
+  tokens.clear();
+  const char* const end = line.end();
+  const char* begin = line.begin();
+  for (const char* c = begin; c != end; ++c) {
+    if (*c == delimiter) {
+      if (c != begin) {
+        tokens.emplace_back(begin, std::size_t(c - begin));
+      }
+      begin = c + 1;
+    }
+  }
+  if (begin != end) {
+    tokens.emplace_back(begin, std::size_t(end - begin));
+  }
+}
+
+long parseHouseInt(Cr::Containers::StringView token, int base) {
+  char buffer[MaxNumberTokenSize + 1];
+  const char* begin = terminateToken(token, buffer);
+  char* end = nullptr;
+  errno = 0;
+  const long value = std::strtol(begin, &end, base);
+  if (end == begin || errno == ERANGE) {
+    throw std::invalid_argument("Not an integer: " + std::string{begin});
+  }
+  return value;
+}
+
+float parseHouseFloat(Cr::Containers::StringView token) {
+  char buffer[MaxNumberTokenSize + 1];
+  const char* begin = terminateToken(token, buffer);
+  char* end = nullptr;
+  const float value = std::strtof(begin, &end);
+  if (end == begin) {
+    throw std::invalid_argument("Not a float: " + std::string{begin});
+  }
+  return value;
+}
+
+}  // namespace scene
+}  // namespace esp
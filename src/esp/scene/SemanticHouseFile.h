@@ -0,0 +1,91 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SCENE_SEMANTICHOUSEFILE_H_
+#define ESP_SCENE_SEMANTICHOUSEFILE_H_
+
+/** @file
+ * @brief Class @ref esp::scene::SemanticHouseFile, allocation-free tokenizing
+ * of its lines
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Path.h>
+
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace scene {
+
+/**
+ * @brief Read-only contents of a line-based semantic house file, such as the
+ * HM3D `.txt` and Matterport3D `.house` annotations.
+ *
+ * The file is memory-mapped where the platform supports it and read in one go
+ * otherwise. Lines are returned as views into the contents, so parsing them
+ * doesn't copy or allocate.
+ */
+class SemanticHouseFile {
+ public:
+  /**
+   * @brief Map or read @p filename. Check @ref isOpen() for success.
+   */
+  explicit SemanticHouseFile(const std::string& filename);
+
+  /** @brief Whether the file was successfully mapped or read */
+  bool isOpen() const { return isOpen_; }
+
+  /**
+   * @brief Get the next line, without the line terminator.
+   * @return false if there are no lines left
+   */
+  bool nextLine(Corrade::Containers::StringView& line);
+
+  /** @brief Number of lines left to be returned by @ref nextLine() */
+  std::size_t remainingLineCount() const;
+
+ private:
+#if defined(CORRADE_TARGET_UNIX) || \
+    (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+  Corrade::Containers::Array<const char, Corrade::Utility::Path::MapDeleter>
+      mapped_;
+#endif
+  Corrade::Containers::Array<char> read_;
+  Corrade::Containers::StringView remaining_;
+  bool isOpen_ = false;
+};
+
+/**
+ * @brief Split @p line at @p delimiter into @p tokens, skipping empty parts.
+ *
+ * @p tokens is cleared first and meant to be reused between lines, so its
+ * capacity is allocated only once.
+ */
+void splitHouseLine(Corrade::Containers::StringView line,
+                    char delimiter,
+                    std::vector<Corrade::Containers::StringView>& tokens);
+
+/**
+ * @brief Parse an integer from @p token, ignoring surrounding whitespace.
+ * @param base The base of the number, as in std::strtol()
+ *
+ * Throws a std::invalid_argument if @p token is not a number, like std::stoi()
+ * which it replaces.
+ */
+long parseHouseInt(Corrade::Containers::StringView token, int base = 10);
+
+/**
+ * @brief Parse a float from @p token, ignoring surrounding whitespace.
+ *
+ * Throws a std::invalid_argument if @p token is not a number, like std::stof()
+ * which it replaces.
+ */
+float parseHouseFloat(Corrade::Containers::StringView token);
+
+}  // namespace scene
+}  // namespace esp
+
+#endif  // ESP_SCENE_SEMANTICHOUSEFILE_H_
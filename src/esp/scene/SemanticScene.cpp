@@ -7,15 +7,20 @@
 #include "GibsonSemanticScene.h"
 #include "Mp3dSemanticScene.h"
 #include "ReplicaSemanticScene.h"
+#include "SemanticHouseFile.h"
 
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 
-#include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <map>
-#include <sstream>
+#include <numeric>
 #include <string>
 
+#include "esp/core/ParallelFor.h"
 #include "esp/io/Io.h"
 #include "esp/io/Json.h"
 #include "esp/metadata/attributes/SemanticAttributes.h"
@@ -40,17 +45,9 @@ bool SemanticScene::
       try {
         // only returns false if file does not exist, or attempting to open it
         // fails
-        // open stream and determine house format version
+        // open file and determine house format version
         try {
-          std::ifstream ifs = std::ifstream(ssdFileName);
-          std::string header;
-          std::getline(ifs, header);
-          if (header.find("ASCII 1.1") != std::string::npos) {
-            loadSuccess = buildMp3dHouse(ifs, scene, rotation);
-          } else if (header.find("HM3D Semantic Annotations") !=
-                     std::string::npos) {
-            loadSuccess = buildHM3DHouse(ifs, scene, rotation);
-          }
+          loadSuccess = loadHouse(ssdFileName, scene, rotation);
         } catch (...) {
           loadSuccess = false;
         }
@@ -216,10 +213,50 @@ bool SemanticScene::
     ESP_DEBUG(Mn::Debug::Flag::NoSpace) << "Semantic attributes do not exist.";
   }  // if semanticAttrs exist or not
 
+  scene.buildRegionGrid();
   return loadSuccess;
 
 }  // SemanticScene::loadSemanticSceneDescriptor
 
+bool SemanticScene::loadHouse(const std::string& filename,
+                              SemanticScene& scene,
+                              const quatf& rotation) {
+  SemanticHouseFile file{filename};
+  Cr::Containers::StringView header;
+  if (!file.isOpen() || !file.nextLine(header)) {
+    return false;
+  }
+  if (header.contains("ASCII 1.1")) {
+    return buildMp3dHouse(file, scene, rotation);
+  }
+  if (header.contains("HM3D Semantic Annotations")) {
+    return buildHM3DHouse(file, scene, rotation);
+  }
+  return false;
+}  // SemanticScene::loadHouse
+
+std::vector<SemanticScene::ptr> SemanticScene::loadHouses(
+    const std::vector<std::string>& filenames,
+    int numThreads,
+    const quatf& rotation) {
+  std::vector<SemanticScene::ptr> scenes(filenames.size());
+  core::parallelFor(filenames.size(), numThreads, [&](std::size_t i, int) {
+    auto scene = SemanticScene::create();
+    bool loadSuccess = false;
+    try {
+      loadSuccess = loadHouse(filenames[i], *scene, rotation);
+    } catch (const std::exception& e) {
+      ESP_ERROR() << "Failed to parse" << filenames[i] << ":" << e.what();
+    }
+    if (loadSuccess) {
+      scenes[i] = std::move(scene);
+    } else {
+      ESP_WARNING() << "Unable to load the semantic house file" << filenames[i];
+    }
+  });
+  return scenes;
+}  // SemanticScene::loadHouses
+
 bool SemanticRegion::contains(const Mn::Vector3& pt) const {
   auto checkPt = [&](float x, float x0, float x1, float y, float y0,
                      float y1) -> bool {
@@ -290,8 +327,7 @@ CCSemanticObject::ptr buildCCSemanticObjForSetOfVerts(
   Mn::Vector3 center = .5f * (vertMax + vertMin);
   Mn::Vector3 dims = vertMax - vertMin;
 
-  auto obj =
-      std::make_shared<CCSemanticObject>(CCSemanticObject(colorInt, setOfIDXs));
+  auto obj = std::make_shared<CCSemanticObject>(colorInt, setOfIDXs);
   // set obj's bounding box
   obj->setObb(Mn::EigenIntegration::cast<esp::vec3f>(center),
               Mn::EigenIntegration::cast<esp::vec3f>(dims), quatf::Identity());
@@ -312,7 +348,7 @@ std::vector<int> getObjsIdxToIDMap(
     int semanticID = ssdObj.semanticID();
     // should not happen unless semantic ids are not sequential
     if (semanticIDToSSOBJidx.size() <= semanticID) {
-      semanticIDToSSOBJidx.resize(semanticID + 1);
+      semanticIDToSSOBJidx.resize(semanticID + 1, -1);
     }
     semanticIDToSSOBJidx[semanticID] = i;
   }
@@ -326,24 +362,27 @@ SemanticScene::buildCCBasedSemanticObjs(
     const std::vector<Mn::Vector3>& verts,
     const std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>&
         clrsToComponents,
-    const std::shared_ptr<SemanticScene>& semanticScene) {
+    const std::shared_ptr<SemanticScene>& semanticScene,
+    int numThreads) {
+  // flatten all CCs so their bboxes can be built in parallel
+  std::vector<std::pair<uint32_t, const std::set<uint32_t>*>> components;
+  for (const auto& elem : clrsToComponents) {
+    for (const std::set<uint32_t>& vertSet : elem.second) {
+      components.emplace_back(elem.first, &vertSet);
+    }
+  }
+  std::vector<CCSemanticObject::ptr> ccObjs(components.size());
+  core::parallelFor(components.size(), numThreads, [&](std::size_t i, int) {
+    ccObjs[i] = buildCCSemanticObjForSetOfVerts(components[i].first, verts,
+                                                *components[i].second);
+  });
+
   // build color-keyed map of lists of pairs of vert-count/bboxes
   std::unordered_map<uint32_t, std::vector<CCSemanticObject::ptr>>
       semanticCCObjsByVertTag(clrsToComponents.size());
-  for (const auto& elem : clrsToComponents) {
-    const uint32_t colorKey = elem.first;
-    const std::vector<std::set<uint32_t>>& vectorOfSets = elem.second;
-    auto findIter = semanticCCObjsByVertTag.find(colorKey);
-    if (findIter == semanticCCObjsByVertTag.end()) {
-      // not found already - initialize new entry
-      findIter = semanticCCObjsByVertTag
-                     .emplace(colorKey, std::vector<CCSemanticObject::ptr>{})
-                     .first;
-    }
-    for (const std::set<uint32_t>& vertSet : vectorOfSets) {
-      findIter->second.emplace_back(
-          buildCCSemanticObjForSetOfVerts(colorKey, verts, vertSet));
-    }
+  for (std::size_t i = 0; i < components.size(); ++i) {
+    semanticCCObjsByVertTag[components[i].first].emplace_back(
+        std::move(ccObjs[i]));
   }
 
   // only map to semantic ID if semanticScene exists, otherwise return map
@@ -380,7 +419,8 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
         clrsToComponents,
     const std::shared_ptr<SemanticScene>& semanticScene,
     float maxVolFraction,
-    const std::string& msgPrefix) {
+    const std::string& msgPrefix,
+    int numThreads) {
   // Semantic scene is required to map color annotations to semantic objects
   if (!semanticScene) {
     ESP_WARNING() << "Attempting to build CC-based semantic bboxes but no "
@@ -390,8 +430,8 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
   }
 
   // get map of semantic ID to vector of CCSemanticObjs.
-  const auto perIDMapOfCCSemanticObjs =
-      buildCCBasedSemanticObjs(verts, clrsToComponents, semanticScene);
+  const auto perIDMapOfCCSemanticObjs = buildCCBasedSemanticObjs(
+      verts, clrsToComponents, semanticScene, numThreads);
 
   // get all semantic objects
   const auto& ssdObjs = semanticScene->objects();
@@ -400,15 +440,12 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
   // doing this in case semanticIDs are not contiguous.
   std::vector<int> semanticIDToSSOBJidx = getObjsIdxToIDMap(ssdObjs);
 
-  std::vector<uint32_t> unMappedObjectIDXs;
-
-  std::multimap<float, std::shared_ptr<CCSemanticObject>> perSemanticObjCCs;
-  std::multimap<float, uint32_t> semanticObjVolToSetIDX;
-  for (int semanticID = 0; semanticID < semanticIDToSSOBJidx.size();
-       ++semanticID) {
+  // each semantic object's OBB is fit independently, so in parallel
+  std::vector<char> isUnmapped(semanticIDToSSOBJidx.size(), 0);
+  auto fitObjectOBB = [&](std::size_t semanticID, int) {
     // no index corresponds with given semantic ID
     if (semanticIDToSSOBJidx[semanticID] == -1) {
-      continue;
+      return;
     }
 
     uint32_t objIdx = semanticIDToSSOBJidx[semanticID];
@@ -423,16 +460,16 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
     if ((semanticCCsPerID == perIDMapOfCCSemanticObjs.end()) ||
         (semanticCCsPerID->second.empty())) {
       // keep a record of semantic IDs without any corresponding verts
-      unMappedObjectIDXs.emplace_back(objIdx);
+      isUnmapped[semanticID] = 1;
       // ESP_DEBUG() << "\n\t\t!!!!!!" << msgPrefix
       //             << "Note : Semantic Scene Annotation ID :" << objIdx
       //             << "is not present in the mesh - there are no vertices "
       //             << "with this annotation's color assigned to them; "
       //             << "therefore, this semantic object will have no BBox.";
-      continue;
+      return;
     }
 
-    std::vector<CCSemanticObject::ptr> vecOfCCSemanticObjs =
+    const std::vector<CCSemanticObject::ptr>& vecOfCCSemanticObjs =
         semanticCCsPerID->second;
     ESP_VERY_VERBOSE() << Cr::Utility::formatString(
         "{}Semantic CC vec size {} Displaying elements in decreasing order "
@@ -448,13 +485,10 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
     } else {
       // Multiple elements, use some fraction of CCs based on volume
       // build temp multimap keyed by volume
-      perSemanticObjCCs.clear();
-      semanticObjVolToSetIDX.clear();
-      for (uint32_t idx = 0; idx < vecOfCCSemanticObjs.size(); ++idx) {
-        const auto& CCObj = vecOfCCSemanticObjs[idx];
-        const float vol = CCObj->obb().volume();
-        perSemanticObjCCs.emplace(vol, CCObj);
-        semanticObjVolToSetIDX.emplace(vol, idx);
+      std::multimap<float, std::shared_ptr<CCSemanticObject>>
+          perSemanticObjCCs;
+      for (const auto& CCObj : vecOfCCSemanticObjs) {
+        perSemanticObjCCs.emplace(CCObj->obb().volume(), CCObj);
       }
       auto largestElement = perSemanticObjCCs.crbegin();
       // the OBB/AABB to use for the specified semantic object
@@ -514,8 +548,17 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
           "After setting from largest cc, obj {} volume :{}", ssdObj.id(),
           ssdObj.obb().volume());
     }
-  }  // for each semantic ID currently mapped to a vector of CCs
+  };  // fitObjectOBB
+  core::parallelFor(semanticIDToSSOBJidx.size(), numThreads, fitObjectOBB);
+
   // return listing of semantic object idxs that have no presence in the mesh
+  std::vector<uint32_t> unMappedObjectIDXs;
+  for (std::size_t semanticID = 0; semanticID < isUnmapped.size();
+       ++semanticID) {
+    if (isUnmapped[semanticID]) {
+      unMappedObjectIDXs.emplace_back(semanticIDToSSOBJidx[semanticID]);
+    }
+  }
   return unMappedObjectIDXs;
 }  // SemanticScene::buildSemanticOBBsFromCCs
 
@@ -598,17 +641,150 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBs(
   return unMappedObjectIDXs;
 }  // SemanticScene::buildSemanticOBBs
 
-std::vector<int> SemanticScene::getRegionsForPoint(
-    const Mn::Vector3& point) const {
-  std::vector<int> containingRegions;
-  for (int rix = 0; rix < regions_.size(); ++rix) {
+namespace {
+// bounds on the region grid resolution, a few cells per region beyond these
+// only cost memory
+constexpr int MaxRegionGridCells = 1 << 16;
+constexpr int MaxRegionGridSize = 1 << 10;
+}  // namespace
+
+void SemanticScene::buildRegionGrid() {
+  regionGrid_ = RegionGrid{};
+  regionGrid_.numRegions = regions_.size();
+
+  // x-z bounds of every region, regions without bounds can't contain points
+  std::vector<Mn::Range2D> regionBounds(regions_.size());
+  Mn::Range2D gridBounds;
+  bool hasBounds = false;
+  for (std::size_t rix = 0; rix < regions_.size(); ++rix) {
+    const box3f bbox = regions_[rix]->aabb();
+    if (bbox.isEmpty()) {
+      continue;
+    }
+    regionBounds[rix] = {{bbox.min().x(), bbox.min().z()},
+                         {bbox.max().x(), bbox.max().z()}};
+    gridBounds = hasBounds ? Mn::Math::join(gridBounds, regionBounds[rix])
+                           : regionBounds[rix];
+    hasBounds = true;
+  }
+  if (!hasBounds) {
+    return;
+  }
+
+  // aim for a few cells per region, so each cell overlaps only a few regions
+  const Mn::Vector2 extent =
+      Mn::Math::max(gridBounds.size(), Mn::Vector2{0.001f});
+  const float targetCells =
+      std::min(4.0f * regions_.size(), float(MaxRegionGridCells));
+  const float cellSize = std::sqrt(extent.product() / targetCells);
+  regionGrid_.size = Mn::Math::clamp(
+      Mn::Vector2i{Mn::Math::ceil(extent / cellSize)}, 1, MaxRegionGridSize);
+  regionGrid_.origin = gridBounds.min();
+  regionGrid_.cellSize = extent / Mn::Vector2{regionGrid_.size};
+
+  const auto cellRange = [&](const Mn::Range2D& bounds) {
+    const Mn::Vector2i min = Mn::Math::clamp(
+        Mn::Vector2i{Mn::Math::floor((bounds.min() - regionGrid_.origin) /
+                                     regionGrid_.cellSize)},
+        Mn::Vector2i{0}, regionGrid_.size - Mn::Vector2i{1});
+    const Mn::Vector2i max = Mn::Math::clamp(
+        Mn::Vector2i{Mn::Math::floor((bounds.max() - regionGrid_.origin) /
+                                     regionGrid_.cellSize)},
+        Mn::Vector2i{0}, regionGrid_.size - Mn::Vector2i{1});
+    return Mn::Range2Di{min, max};
+  };
+
+  // count the regions of each cell, then fill them in region order so every
+  // cell lists its regions in ascending order
+  std::vector<int>& offsets = regionGrid_.cellOffsets;
+  offsets.assign(regionGrid_.size.product() + 1, 0);
+  for (std::size_t rix = 0; rix < regions_.size(); ++rix) {
+    if (regions_[rix]->aabb().isEmpty()) {
+      continue;
+    }
+    const Mn::Range2Di cells = cellRange(regionBounds[rix]);
+    for (int z = cells.min().y(); z <= cells.max().y(); ++z) {
+      for (int x = cells.min().x(); x <= cells.max().x(); ++x) {
+        ++offsets[z * regionGrid_.size.x() + x + 1];
+      }
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  regionGrid_.cellRegions.resize(offsets.back());
+  std::vector<int> cursors{offsets.begin(), offsets.end() - 1};
+  for (std::size_t rix = 0; rix < regions_.size(); ++rix) {
+    if (regions_[rix]->aabb().isEmpty()) {
+      continue;
+    }
+    const Mn::Range2Di cells = cellRange(regionBounds[rix]);
+    for (int z = cells.min().y(); z <= cells.max().y(); ++z) {
+      for (int x = cells.min().x(); x <= cells.max().x(); ++x) {
+        regionGrid_.cellRegions[cursors[z * regionGrid_.size.x() + x]++] =
+            static_cast<int>(rix);
+      }
+    }
+  }
+}  // SemanticScene::buildRegionGrid
+
+void SemanticScene::appendRegionsForPoint(
+    const Mn::Vector3& point,
+    std::vector<int>& regionIndices) const {
+  // regions changed since the grid was built, test all of them
+  if (regionGrid_.numRegions != regions_.size()) {
+    for (int rix = 0; rix < regions_.size(); ++rix) {
+      if (regions_[rix]->contains(point)) {
+        regionIndices.push_back(rix);
+      }
+    }
+    return;
+  }
+  if (regionGrid_.cellOffsets.empty()) {
+    return;
+  }
+
+  // points outside of the grid are outside of every region's bounds
+  const Mn::Vector2 cell =
+      (Mn::Vector2{point.x(), point.z()} - regionGrid_.origin) /
+      regionGrid_.cellSize;
+  const Mn::Vector2 size{regionGrid_.size};
+  if (cell.x() < 0.0f || cell.y() < 0.0f || cell.x() > size.x() ||
+      cell.y() > size.y()) {
+    return;
+  }
+  const Mn::Vector2i cellIndex =
+      Mn::Math::min(Mn::Vector2i{cell}, regionGrid_.size - Mn::Vector2i{1});
+  const int cellId = cellIndex.y() * regionGrid_.size.x() + cellIndex.x();
+  for (int i = regionGrid_.cellOffsets[cellId];
+       i < regionGrid_.cellOffsets[cellId + 1]; ++i) {
+    const int rix = regionGrid_.cellRegions[i];
     if (regions_[rix]->contains(point)) {
-      containingRegions.push_back(rix);
+      regionIndices.push_back(rix);
     }
   }
+}  // SemanticScene::appendRegionsForPoint
+
+std::vector<int> SemanticScene::getRegionsForPoint(
+    const Mn::Vector3& point) const {
+  std::vector<int> containingRegions;
+  appendRegionsForPoint(point, containingRegions);
   return containingRegions;
 }  // SemanticScene::getRegionsForPoint
 
+geo::OBBTree SemanticScene::buildObjectOBBTree() const {
+  std::vector<geo::OBB> obbs;
+  std::vector<int> ids;
+  obbs.reserve(objects_.size());
+  ids.reserve(objects_.size());
+  for (std::size_t i = 0; i < objects_.size(); ++i) {
+    // some scene formats leave gaps for unused object IDs
+    if (objects_[i]) {
+      obbs.push_back(objects_[i]->obb());
+      ids.push_back(static_cast<int>(i));
+    }
+  }
+  return geo::OBBTree{obbs, ids};
+}  // SemanticScene::buildObjectOBBTree
+
 std::vector<std::pair<int, double>> SemanticScene::getWeightedRegionsForPoint(
     const Mn::Vector3& point) const {
   std::vector<int> containingRegions = getRegionsForPoint(point);
@@ -646,36 +822,24 @@ std::vector<std::pair<int, double>> SemanticScene::getWeightedRegionsForPoint(
 
 std::vector<std::pair<int, double>> SemanticScene::getRegionsForPoints(
     const std::vector<Mn::Vector3>& points) const {
-  // Weights for every point for every region
-  std::vector<std::vector<double>> regAreaWeightsForPoints;
-  regAreaWeightsForPoints.reserve(points.size());
-  for (int i = 0; i < points.size(); ++i) {
-    // Get this point's weighted regions
-    auto regWeightsForPoint = getWeightedRegionsForPoint(points[i]);
-    // Initialize all region weights to be 0
-    std::vector<double> allRegionWeights(regions_.size(), 0);
-    // Set the weight for the containing region with the smallest area (if
-    // nested regions) for this particular point.
-    // Set the vote for each region to be equal.
-    for (const std::pair<int, double>& regionWeight : regWeightsForPoint) {
-      allRegionWeights[regionWeight.first] = 1.0;
-    }
-    // Save this points region weight vector
-    regAreaWeightsForPoints.emplace_back(allRegionWeights);
+  std::vector<int> offsets;
+  std::vector<int> regionIndices;
+  getRegionsForPointsBatched(points, offsets, regionIndices);
+
+  // Every point votes equally for each region containing it, including all
+  // nested regions
+  std::vector<int> regionVotes(regions_.size(), 0);
+  for (int rix : regionIndices) {
+    ++regionVotes[rix];
   }
 
   std::vector<std::pair<int, double>> containingRegionWeights;
   // Will only have at max the number of regions in the scene
   containingRegionWeights.reserve(regions_.size());
   for (int rix = 0; rix < regions_.size(); ++rix) {
-    double containmentWeight = 0;
-    for (int i = 0; i < points.size(); ++i) {
-      std::vector<double> regWtsForPoint = regAreaWeightsForPoints[i];
-      containmentWeight += regWtsForPoint[rix];
-    }
-    if (containmentWeight > 0) {
-      containingRegionWeights.emplace_back(
-          std::pair<int, double>(rix, containmentWeight / points.size()));
+    if (regionVotes[rix] > 0) {
+      containingRegionWeights.emplace_back(std::pair<int, double>(
+          rix, double(regionVotes[rix]) / points.size()));
     }
   }
   // Free up unused capacity - every region probably does not contain a tested
@@ -687,5 +851,37 @@ std::vector<std::pair<int, double>> SemanticScene::getRegionsForPoints(
             });
   return containingRegionWeights;
 }  // SemanticScene::getRegionsForPoints
+
+void SemanticScene::getRegionsForPointsBatched(
+    const std::vector<Mn::Vector3>& points,
+    std::vector<int>& offsets,
+    std::vector<int>& regionIndices,
+    int numThreads) const {
+  // each chunk collects the regions of its points separately, which are then
+  // concatenated in point order
+  constexpr std::size_t PointsPerChunk = 1 << 12;
+  const std::size_t numChunks =
+      (points.size() + PointsPerChunk - 1) / PointsPerChunk;
+  std::vector<std::vector<int>> chunkRegionIndices(numChunks);
+  offsets.assign(points.size() + 1, 0);
+  core::parallelFor(numChunks, numThreads, [&](std::size_t chunk, int) {
+    std::vector<int>& chunkIndices = chunkRegionIndices[chunk];
+    const std::size_t end =
+        std::min(points.size(), (chunk + 1) * PointsPerChunk);
+    for (std::size_t i = chunk * PointsPerChunk; i != end; ++i) {
+      const std::size_t begin = chunkIndices.size();
+      appendRegionsForPoint(points[i], chunkIndices);
+      offsets[i + 1] = static_cast<int>(chunkIndices.size() - begin);
+    }
+  });
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  regionIndices.resize(offsets.back());
+  for (std::size_t chunk = 0; chunk != numChunks; ++chunk) {
+    std::copy(chunkRegionIndices[chunk].begin(),
+              chunkRegionIndices[chunk].end(),
+              regionIndices.begin() + offsets[chunk * PointsPerChunk]);
+  }
+}  // SemanticScene::getRegionsForPointsBatched
 }  // namespace scene
 }  // namespace esp
@@ -15,6 +15,7 @@
 
 #include "esp/core/Esp.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OBBTree.h"
 #include "esp/io/Json.h"
 
 namespace esp {
@@ -38,6 +39,7 @@ class SemanticCategory {
 };
 
 // forward declarations
+class SemanticHouseFile;
 class SemanticObject;
 
 // semantic object only used to represent characteristics of Connected
@@ -157,6 +159,40 @@ class SemanticScene {
       const quatf& rotation = quatf::FromTwoVectors(-vec3f::UnitZ(),
                                                     geo::ESP_GRAVITY));
 
+  /**
+   * @brief Attempt to load SemanticScene from a HM3D or Matterport3D dataset
+   * house format file, determining the format from the file header.
+   * @param filename the name of the semantic scene descriptor (house file) to
+   * attempt to load
+   * @param scene reference to sceneNode to assign semantic scene to
+   * @param rotation rotation to apply to semantic scene upon load (not used
+   * for HM3D)
+   * @return successfully loaded. False if the header is of neither format.
+   */
+  static bool loadHouse(const std::string& filename,
+                        SemanticScene& scene,
+                        const quatf& rotation =
+                            quatf::FromTwoVectors(-vec3f::UnitZ(),
+                                                  geo::ESP_GRAVITY));
+
+  /**
+   * @brief Load the SemanticScenes of a batch of HM3D or Matterport3D house
+   * files with @ref loadHouse(), distributed over @p numThreads threads. For
+   * dataset-wide preprocessing.
+   * @param filenames the names of the house files to load
+   * @param numThreads The number of threads to use. Values <= 0 select the
+   * hardware concurrency of the machine.
+   * @param rotation rotation to apply to each semantic scene upon load (not
+   * used for HM3D)
+   * @return The loaded scenes in the order of @p filenames, nullptr for the
+   * files that failed to load.
+   */
+  static std::vector<std::shared_ptr<SemanticScene>> loadHouses(
+      const std::vector<std::string>& filenames,
+      int numThreads = 1,
+      const quatf& rotation = quatf::FromTwoVectors(-vec3f::UnitZ(),
+                                                    geo::ESP_GRAVITY));
+
   /**
    * @brief Attempt to load SemanticScene from a Replica dataset house format
    * file
@@ -191,6 +227,8 @@ class SemanticScene {
    * "color" attribute specified by the key.  Each element in the vector is a
    * smart pointer to a @ref CCSemanticObject, being used to facilitate
    * collecting pertinent data.
+   * @param numThreads The number of threads building the CC bounding boxes,
+   * see @ref core::resolveNumThreads().
    */
   static std::unordered_map<uint32_t,
                             std::vector<std::shared_ptr<CCSemanticObject>>>
@@ -198,7 +236,8 @@ class SemanticScene {
       const std::vector<Mn::Vector3>& verts,
       const std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>&
           clrsToComponents,
-      const std::shared_ptr<SemanticScene>& semanticScene);
+      const std::shared_ptr<SemanticScene>& semanticScene,
+      int numThreads = 1);
 
   /**
    * @brief Build semantic OBBs based on presence of semantic IDs on vertices.
@@ -232,6 +271,8 @@ class SemanticScene {
    * @param maxVolFraction Fraction of maximum volume bbox CC to include in bbox
    * calc.
    * @param msgPrefix Debug message prefix, referencing caller.
+   * @param numThreads The number of threads fitting the CC bounding boxes and
+   * the per-object OBBs, see @ref core::resolveNumThreads().
    * @return vector of semantic object IDXs that have no vertex mapping/presence
    * in the source mesh.
    */
@@ -241,7 +282,8 @@ class SemanticScene {
           clrsToComponents,
       const std::shared_ptr<SemanticScene>& semanticScene,
       float maxVolFraction,
-      const std::string& msgPrefix);
+      const std::string& msgPrefix,
+      int numThreads = 1);
 
   /**
    * @brief Whether the source file assigns colors to verts for Semantic
@@ -292,6 +334,14 @@ class SemanticScene {
    */
   std::vector<int> getRegionsForPoint(const Mn::Vector3& point) const;
 
+  /**
+   * @brief Build a tree over the OBBs of all objects in this SemanticScene,
+   * for containment and closest object queries of many points.
+   * @return The tree, with the index of each object in @ref objects() as the
+   * ID of its OBB.
+   */
+  geo::OBBTree buildObjectOBBTree() const;
+
   /**
    * @brief Compute all the SemanticRegions that contain the passed point, and
    * return a vector of indices and weights for each region, where the weights
@@ -315,7 +365,41 @@ class SemanticScene {
   std::vector<std::pair<int, double>> getRegionsForPoints(
       const std::vector<Mn::Vector3>& points) const;
 
+  /**
+   * @brief Compute SemanticRegion containment for each of a batch of points,
+   * writing the indices of the containing regions into flat arrays.
+   *
+   * The regions containing point @p i are @p regionIndices from @p offsets[i]
+   * to @p offsets[i + 1], in the ascending order @ref getRegionsForPoint()
+   * returns them. Meant for metrics querying millions of points, which are
+   * distributed over @p numThreads threads.
+   * @param points The query points.
+   * @param offsets Output, resized to one more than the number of points.
+   * @param regionIndices Output, resized to the total number of containing
+   * regions over all points.
+   * @param numThreads The number of threads to use. Values <= 0 select the
+   * hardware concurrency of the machine.
+   */
+  void getRegionsForPointsBatched(const std::vector<Mn::Vector3>& points,
+                                  std::vector<int>& offsets,
+                                  std::vector<int>& regionIndices,
+                                  int numThreads = 1) const;
+
  protected:
+  /**
+   * @brief Build @ref regionGrid_ over the current @ref regions_. Called
+   * whenever a loader has finished building the regions.
+   */
+  void buildRegionGrid();
+
+  /**
+   * @brief Append the indices of all SemanticRegions which contain @p point
+   * to @p regionIndices, in ascending order. Only tests the regions whose
+   * bounds overlap the grid cell of the point.
+   */
+  void appendRegionsForPoint(const Mn::Vector3& point,
+                             std::vector<int>& regionIndices) const;
+
   /**
    * @brief Verify a requested file exists.
    * @param filename the file to attempt to load
@@ -334,31 +418,31 @@ class SemanticScene {
   }  // checkFileExists
 
   /**
-   * @brief Build the HM3D semantic data from the passed file stream.  File
-   * being streamed is expected to be appropriate format.
-   * @param ifs The opened file stream describing the HM3D semantic annotations.
+   * @brief Build the HM3D semantic data from the lines of the passed file
+   * following its header. File is expected to be appropriate format.
+   * @param file The opened file describing the HM3D semantic annotations.
    * @param scene reference to sceneNode to assign semantic scene to
    * @param rotation rotation to apply to semantic scene upon load (currently
    * not used for HM3D)
    * @return successfully built. Currently only returns true, but retaining
    * return value for future support.
    */
-  static bool buildHM3DHouse(std::ifstream& ifs,
+  static bool buildHM3DHouse(SemanticHouseFile& file,
                              SemanticScene& scene,
                              CORRADE_UNUSED const quatf& rotation =
                                  quatf::FromTwoVectors(-vec3f::UnitZ(),
                                                        geo::ESP_GRAVITY));
   /**
-   * @brief Build the mp3 semantic data from the passed file stream. File being
-   * streamed is expected to be appropriate format.
-   * @param ifs The opened file stream describing the Mp3d semantic annotations.
+   * @brief Build the mp3 semantic data from the lines of the passed file
+   * following its header. File is expected to be appropriate format.
+   * @param file The opened file describing the Mp3d semantic annotations.
    * @param scene reference to sceneNode to assign semantic scene to
    * @param rotation rotation to apply to semantic scene upon load.
    * @return successfully built. Currently only returns true, but retaining
    * return value for future support.
    */
   static bool buildMp3dHouse(
-      std::ifstream& ifs,
+      SemanticHouseFile& file,
       SemanticScene& scene,
       const quatf& rotation = quatf::FromTwoVectors(-vec3f::UnitZ(),
                                                     geo::ESP_GRAVITY));
@@ -433,6 +517,28 @@ class SemanticScene {
   std::unordered_map<uint32_t, std::pair<int, int>>
       semanticColorToIdAndRegion_{};
 
+  /**
+   * @brief Uniform grid over the x-z bounds of @ref regions_, so containment
+   * queries only test the regions overlapping the cell of the point instead
+   * of every region.
+   */
+  struct RegionGrid {
+    //! Minimum x-z corner of the grid
+    Mn::Vector2 origin;
+    //! Size of a cell along x and z
+    Mn::Vector2 cellSize{1.0f};
+    //! Number of cells along x and z
+    Mn::Vector2i size;
+    /**
+     * @brief The regions overlapping cell i are @ref cellRegions from
+     * cellOffsets[i] to cellOffsets[i + 1]. Empty if the grid isn't built.
+     */
+    std::vector<int> cellOffsets;
+    std::vector<int> cellRegions;
+    //! Size of @ref regions_ when the grid was built
+    std::size_t numRegions = 0;
+  } regionGrid_;
+
   ESP_SMART_POINTERS(SemanticScene)
 };
 
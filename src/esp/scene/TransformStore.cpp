@@ -0,0 +1,102 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TransformStore.h"
+
+#include <stack>
+#include <utility>
+
+#include "SceneNode.h"
+#include "esp/core/Profiler.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace scene {
+
+TransformStore::TransformStore(SceneNode& root) {
+  nodes_.push_back(&root);
+  rebuild();
+}
+
+void TransformStore::rebuild() {
+  SceneNode& rootNode = root();
+  nodes_.clear();
+  parents_.clear();
+  indices_.clear();
+
+  // pre-order, so every parent gets an index before its children
+  std::stack<std::pair<SceneNode*, int>> stack;
+  stack.emplace(&rootNode, -1);
+  do {
+    SceneNode* node = stack.top().first;
+    const int parent = stack.top().second;
+    stack.pop();
+    const int index = int(nodes_.size());
+    nodes_.push_back(node);
+    parents_.push_back(parent);
+    indices_.emplace(node, index);
+    for (MagnumObject& child : node->children()) {
+      stack.emplace(static_cast<SceneNode*>(&child), index);
+    }
+  } while (!stack.empty());
+
+  const std::size_t count = nodes_.size();
+  local_.resize(count);
+  world_.resize(count);
+  changed_.assign(count, 1);
+  for (std::size_t i = 0; i != count; ++i) {
+    local_[i] = nodes_[i]->transformation();
+  }
+  world_[0] = rootNode.absoluteTransformation();
+  for (std::size_t i = 1; i != count; ++i) {
+    world_[i] = world_[parents_[i]] * local_[i];
+  }
+  for (std::size_t i = 0; i != count; ++i) {
+    nodes_[i]->absoluteTransformation_ = world_[i];
+    nodes_[i]->worldCumulativeBB_ = Corrade::Containers::NullOpt;
+  }
+}
+
+std::size_t TransformStore::update() {
+  ESP_PROFILE_SCOPE("TransformStore::update");
+  const std::size_t count = nodes_.size();
+
+  // gather the local transformations, marking the ones that changed
+  const Mn::Matrix4 rootWorld = root().absoluteTransformation();
+  changed_[0] = rootWorld != world_[0];
+  world_[0] = rootWorld;
+  for (std::size_t i = 1; i != count; ++i) {
+    const Mn::Matrix4 local = nodes_[i]->transformation();
+    changed_[i] = local != local_[i];
+    local_[i] = local;
+  }
+
+  // a linear pass over the arrays, parents coming before their children
+  std::size_t changedCount = 0;
+  for (std::size_t i = 1; i != count; ++i) {
+    changed_[i] |= changed_[parents_[i]];
+    if (changed_[i]) {
+      world_[i] = world_[parents_[i]] * local_[i];
+    }
+  }
+
+  // mirror the changed world transformations into the nodes
+  for (std::size_t i = 0; i != count; ++i) {
+    if (changed_[i]) {
+      nodes_[i]->absoluteTransformation_ = world_[i];
+      nodes_[i]->worldCumulativeBB_ = Corrade::Containers::NullOpt;
+      ++changedCount;
+    }
+  }
+  return changedCount;
+}
+
+int TransformStore::indexOf(const SceneNode& node) const {
+  const auto found = indices_.find(&node);
+  return found == indices_.end() ? -1 : found->second;
+}
+
+}  // namespace scene
+}  // namespace esp
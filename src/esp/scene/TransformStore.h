@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SCENE_TRANSFORMSTORE_H_
+#define ESP_SCENE_TRANSFORMSTORE_H_
+
+/** @file
+ * @brief Class @ref esp::scene::TransformStore
+ */
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace scene {
+
+class SceneNode;
+
+/**
+ * @brief Contiguous structure-of-arrays copy of the transformations of a
+ * scene graph subtree
+ *
+ * Holds the nodes of a subtree in pre-order, so every parent comes before its
+ * children, with parent indices and local and world transformations in
+ * separate arrays. @ref update() gathers the local transformations and
+ * computes the world transformations in a single linear pass over the
+ * arrays, instead of the pointer chasing of per-node absolute transformation
+ * queries. Only the world transformations of nodes whose local
+ * transformation or parent changed are recomputed, see @ref changed().
+ *
+ * The world transformations are mirrored into the nodes, so
+ * @ref SceneNode::absoluteTranslation() const and
+ * @ref SceneNode::getAbsoluteAABB() see them without recomputing. The store
+ * references the nodes, so @ref rebuild() it after adding or removing nodes
+ * of the subtree and don't use it after the root is destroyed.
+ */
+class TransformStore {
+ public:
+  /**
+   * @brief Constructor
+   * @param root Root of the subtree to store
+   */
+  explicit TransformStore(SceneNode& root);
+
+  /** @brief Root of the stored subtree */
+  SceneNode& root() const { return *nodes_[0]; }
+
+  /** @brief Flatten the subtree again, after its structure changed */
+  void rebuild();
+
+  /**
+   * @brief Update the local and world transformations from the nodes
+   * @return Number of world transformations that changed
+   */
+  std::size_t update();
+
+  /** @brief Number of stored nodes */
+  std::size_t size() const { return nodes_.size(); }
+
+  /** @brief Index of @p node, -1 if it's not stored */
+  int indexOf(const SceneNode& node) const;
+
+  /** @brief Stored nodes, in pre-order */
+  const std::vector<SceneNode*>& nodes() const { return nodes_; }
+
+  /** @brief Parent index of each node, -1 for the root */
+  const std::vector<int>& parents() const { return parents_; }
+
+  /** @brief Local transformation of each node */
+  const std::vector<Magnum::Matrix4>& localTransformations() const {
+    return local_;
+  }
+
+  /** @brief World transformation of each node */
+  const std::vector<Magnum::Matrix4>& worldTransformations() const {
+    return world_;
+  }
+
+  /**
+   * @brief Whether the world transformation of each node changed by the last
+   * @ref update(), or since @ref rebuild() if none happened since
+   */
+  const std::vector<std::uint8_t>& changed() const { return changed_; }
+
+  ESP_SMART_POINTERS(TransformStore)
+
+ private:
+  std::vector<SceneNode*> nodes_;
+  std::vector<int> parents_;
+  std::vector<Magnum::Matrix4> local_;
+  std::vector<Magnum::Matrix4> world_;
+  std::vector<std::uint8_t> changed_;
+  std::unordered_map<const SceneNode*, int> indices_;
+};
+
+}  // namespace scene
+}  // namespace esp
+
+#endif  // ESP_SCENE_TRANSFORMSTORE_H_
@@ -2,16 +2,39 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "AudioSensor.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/ThreadPool.h"
 #include "esp/sim/Simulator.h"
 
+namespace Cr = Corrade;
+
 namespace esp {
 namespace sensor {
 
+#ifdef ESP_BUILD_WITH_AUDIO
+struct AudioMesh {
+  assets::MeshData::ptr mesh;
+  //! indices of the semantic mesh grouped by material category, empty for
+  //! the render mesh
+  std::vector<std::pair<std::string, std::vector<uint32_t>>> materialIndices;
+};
+
+namespace {
+
+std::mutex audioMeshCacheMutex;
+// weak, so the mesh of a scene is freed once no sensor uses it anymore
+std::unordered_map<std::string, std::weak_ptr<const AudioMesh>> audioMeshCache;
+
+}  // namespace
+#endif  // ESP_BUILD_WITH_AUDIO
+
 void CHECK_AUDIO_FLAG() {
 #ifndef ESP_BUILD_WITH_AUDIO
   CORRADE_ASSERT_UNREACHABLE(
@@ -74,9 +97,16 @@ AudioSensor::~AudioSensor() {
 #ifdef ESP_BUILD_WITH_AUDIO
 void AudioSensor::reset() {
   audioSimulator_ = nullptr;
+  batchSimulators_.clear();
+  batchMesh_ = nullptr;
   impulseResponse_.clear();
 }
 
+void AudioSensor::clearMeshCache() {
+  std::lock_guard<std::mutex> lock{audioMeshCacheMutex};
+  audioMeshCache.clear();
+}
+
 void AudioSensor::setAudioSourceTransform(const Magnum::Vector3& sourcePos) {
   ESP_DEBUG() << logHeader_
               << "Setting the audio source position : " << sourcePos << "]";
@@ -122,17 +152,13 @@ void AudioSensor::runSimulation(sim::Simulator& sim) {
                    "source at position : "
                 << lastSourcePos_;
 
-    if (audioSensorSpec_->acousticsConfig_.enableMaterials &&
-        sim.semanticSceneExists()) {
-      ESP_DEBUG() << logHeader_ << "Loading semantic scene";
-      loadSemanticMesh(sim);
-    } else {
-      // load the normal render mesh without any material info
-      ESP_DEBUG() << logHeader_
-                  << "Semantic scene does not exist or materials are disabled, "
-                     "will use default material";
-      loadMesh(sim);
+    sceneMesh_ = getAudioMesh(sim);
+    if (!sceneMesh_->materialIndices.empty()) {
+      loadAudioMaterials(*audioSimulator_);
+      // Once the mesh is loaded, the materials database can't change anymore
+      audioMaterialsJsonSet_ = audioMaterialsJSON_.size() > 0;
     }
+    uploadAudioMesh(*audioSimulator_, *sceneMesh_);
   }
 
   if (newSource_) {
@@ -148,7 +174,8 @@ void AudioSensor::runSimulation(sim::Simulator& sim) {
   }
 
   // Run the audio simulation
-  const std::string simFolder = getSimulationFolder();
+  const std::string simFolder =
+      audioSensorSpec_->inMemoryIR_ ? "" : getSimulationFolder();
   ESP_DEBUG() << "Running simulation, folder : " << simFolder;
   audioSimulator_->RunSimulation(simFolder);
 
@@ -171,6 +198,72 @@ void AudioSensor::setAudioMaterialsJSON(const std::string& jsonPath) {
   audioMaterialsJSON_ = jsonPath;
 }
 
+std::vector<std::vector<std::vector<float>>> AudioSensor::runSimulations(
+    sim::Simulator& sim,
+    const std::vector<SimulationRequest>& requests,
+    int numThreads) {
+  std::vector<std::vector<std::vector<float>>> impulseResponses(
+      requests.size());
+  if (requests.empty()) {
+    return impulseResponses;
+  }
+
+  numThreads = core::resolveNumThreads(numThreads, ~std::size_t{});
+  if (!threadPool_ || threadPool_->numThreads() != numThreads) {
+    threadPool_ = std::make_unique<core::ThreadPool>(numThreads);
+  }
+  // the worker simulators stay valid as long as the scene mesh is the same
+  std::shared_ptr<const AudioMesh> mesh = getAudioMesh(sim);
+  if (batchMesh_ != mesh) {
+    batchSimulators_.clear();
+    batchMesh_ = mesh;
+  }
+  batchSimulators_.resize(numThreads);
+  if (!mesh->materialIndices.empty()) {
+    audioMaterialsJsonSet_ = audioMaterialsJSON_.size() > 0;
+  }
+
+  ESP_DEBUG() << logHeader_ << "Running" << requests.size()
+              << "audio simulations on" << numThreads << "threads";
+  const std::string simFolder = getSimulationFolder() + "_batch";
+  threadPool_->parallelFor(requests.size(), [&](std::size_t i, int worker) {
+    std::unique_ptr<RLRAudioPropagation::Simulator>& simulator =
+        batchSimulators_[worker];
+    if (!simulator) {
+      simulator = std::make_unique<RLRAudioPropagation::Simulator>();
+      simulator->Configure(audioSensorSpec_->acousticsConfig_);
+      if (!mesh->materialIndices.empty()) {
+        loadAudioMaterials(*simulator);
+      }
+      uploadAudioMesh(*simulator, *mesh);
+    }
+
+    const SimulationRequest& request = requests[i];
+    simulator->AddSource(RLRAudioPropagation::Vector3f{
+        request.sourcePos[0], request.sourcePos[1], request.sourcePos[2]});
+    simulator->AddListener(
+        RLRAudioPropagation::Vector3f{request.agentPos[0], request.agentPos[1],
+                                      request.agentPos[2]},
+        RLRAudioPropagation::Quaternion{
+            request.agentRotQuat[0], request.agentRotQuat[1],
+            request.agentRotQuat[2], request.agentRotQuat[3]},
+        audioSensorSpec_->channelLayout_);
+    simulator->RunSimulation(simFolder + std::to_string(i));
+
+    const std::size_t channelCount = simulator->GetChannelCount();
+    const std::size_t sampleCount = simulator->GetSampleCount();
+    std::vector<std::vector<float>>& impulseResponse = impulseResponses[i];
+    impulseResponse.resize(channelCount);
+    for (std::size_t channelIndex = 0; channelIndex < channelCount;
+         ++channelIndex) {
+      const float* ir = simulator->GetImpulseResponseForChannel(channelIndex);
+      impulseResponse[channelIndex].assign(ir, ir + sampleCount);
+    }
+  });
+
+  return impulseResponses;
+}
+
 const std::vector<std::vector<float>>& AudioSensor::getIR() {
   if (impulseResponse_.empty()) {
     ObservationSpace obsSpace;
@@ -192,6 +285,23 @@ const std::vector<std::vector<float>>& AudioSensor::getIR() {
 
   return impulseResponse_;
 }
+
+void AudioSensor::readIR(Cr::Containers::ArrayView<float> out) {
+  CORRADE_ASSERT(audioSimulator_, "readIR : audioSimulator_ should exist", );
+  const std::size_t channelCount = audioSimulator_->GetChannelCount();
+  const std::size_t sampleCount = audioSimulator_->GetSampleCount();
+  CORRADE_ASSERT(out.size() == channelCount * sampleCount,
+                 "readIR : expected" << channelCount * sampleCount
+                                     << "floats but got" << out.size(), );
+
+  // IR samples are packed per channel
+  for (std::size_t channelIndex = 0; channelIndex < channelCount;
+       ++channelIndex) {
+    const float* ir =
+        audioSimulator_->GetImpulseResponseForChannel(channelIndex);
+    std::copy(ir, ir + sampleCount, out.data() + channelIndex * sampleCount);
+  }
+}
 #endif  // ESP_BUILD_WITH_AUDIO
 
 bool AudioSensor::getObservation(sim::Simulator&, Observation& obs) {
@@ -212,26 +322,19 @@ bool AudioSensor::getObservation(sim::Simulator&, Observation& obs) {
     return false;
   }
 
-  if (buffer_ == nullptr) {
+  // the sample count changes with the scene, reallocate if needed
+  if (buffer_ == nullptr || buffer_->shape != obsSpace.shape) {
     buffer_ = core::Buffer::create(obsSpace.shape, obsSpace.dataType);
   }
 
   obs.buffer = buffer_;
 
-  std::uint64_t bufIndex = 0;
-  const std::size_t sizeToCopy = sizeof(float) * obsSpace.shape[1];
   // write the simulation output to the observation buffer
-  // IR samples are packed per channel
-  for (std::size_t channelIndex = 0; channelIndex < obsSpace.shape[0];
-       ++channelIndex) {
-    const float* ir =
-        audioSimulator_->GetImpulseResponseForChannel(channelIndex);
-    // Copy the ir for the specific channel into the data buffer
-    memcpy(obs.buffer->data + bufIndex, ir, sizeToCopy);
-    bufIndex += sizeToCopy;
-  }
+  readIR(Cr::Containers::arrayCast<float>(
+      Cr::Containers::arrayView(obs.buffer->data)));
 
-  if (audioSensorSpec_->acousticsConfig_.writeIrToFile) {
+  if (audioSensorSpec_->acousticsConfig_.writeIrToFile &&
+      !audioSensorSpec_->inMemoryIR_) {
     writeIRFile(obs);
   }
 #endif  // ESP_BUILD_WITH_AUDIO
@@ -287,54 +390,54 @@ void AudioSensor::createAudioSimulator() {
   audioSimulator_ = std::make_unique<RLRAudioPropagation::Simulator>();
   lastAgentPos_ = {__FLT_MIN__, __FLT_MIN__, __FLT_MIN__};
 
-  audioSimulator_->Configure(audioSensorSpec_->acousticsConfig_);
+  RLRAudioPropagation::Configuration config =
+      audioSensorSpec_->acousticsConfig_;
+  if (audioSensorSpec_->inMemoryIR_) {
+    config.dumpWaveFiles = false;
+    config.writeIrToFile = false;
+  }
+  audioSimulator_->Configure(config);
 }
 
-void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
-  ESP_DEBUG() << logHeader_ << "Loading semantic mesh";
-
-  CORRADE_ASSERT(audioSimulator_,
-                 "loadSemanticMesh: audioSimulator_ should exist", );
+std::shared_ptr<const AudioMesh> AudioSensor::getAudioMesh(
+    sim::Simulator& sim) {
+  const bool useSemanticMesh =
+      audioSensorSpec_->acousticsConfig_.enableMaterials &&
+      sim.semanticSceneExists();
+  const std::string key = sim.getActiveSceneDatasetName() + ":" +
+                          sim.getCurSceneInstanceName() +
+                          (useSemanticMesh ? ":semantic" : ":render");
+
+  // hold the lock while building, so concurrent sensors build a scene once
+  std::lock_guard<std::mutex> lock{audioMeshCacheMutex};
+  std::weak_ptr<const AudioMesh>& cached = audioMeshCache[key];
+  if (std::shared_ptr<const AudioMesh> mesh = cached.lock()) {
+    ESP_DEBUG() << logHeader_ << "Reusing the prepared mesh of" << key;
+    return mesh;
+  }
 
-  // Load the audio materials JSON if it was set
-  if (!audioMaterialsJsonSet_ && audioMaterialsJSON_.size() > 0) {
-    auto errorCode =
-        audioSimulator_->LoadAudioMaterialJSON(audioMaterialsJSON_);
-    if (errorCode != RLRAudioPropagation::ErrorCodes::Success) {
-      ESP_ERROR() << "Audio material json could not be loaded. ErrorCode: "
-                  << static_cast<int>(errorCode)
-                  << ". Please check if the file exists and the format is "
-                     "correct. FilePath:"
-                  << audioMaterialsJSON_;
-      CORRADE_ASSERT(false, "", );
-    }
-    audioMaterialsJsonSet_ = true;
+  auto mesh = std::make_shared<AudioMesh>();
+  if (!useSemanticMesh) {
+    // the normal render mesh without any material info
+    ESP_DEBUG() << logHeader_
+                << "Semantic scene does not exist or materials are disabled, "
+                   "will use default material";
+    mesh->mesh = sim.getJoinedMesh(true);
+    cached = mesh;
+    return mesh;
   }
 
+  ESP_DEBUG() << logHeader_ << "Preparing semantic mesh";
   std::vector<std::uint16_t> objectIds;
-
-  sceneMesh_ = sim.getJoinedSemanticMesh(objectIds);
+  mesh->mesh = sim.getJoinedSemanticMesh(objectIds);
 
   std::shared_ptr<scene::SemanticScene> semanticScene = sim.getSemanticScene();
-
-  const std::vector<std::shared_ptr<scene::SemanticCategory>>& categories =
-      semanticScene->categories();
   const std::vector<std::shared_ptr<scene::SemanticObject>>& objects =
       semanticScene->objects();
 
-  RLRAudioPropagation::VertexData vertices;
-
-  vertices.vertices = sceneMesh_->vbo.data();
-  vertices.byteOffset = 0;
-  vertices.vertexCount = sceneMesh_->vbo.size();
-  vertices.vertexStride = 0;
-
-  // Send the vertex data
-  audioSimulator_->LoadMeshVertices(vertices);
-
   std::unordered_map<std::string, std::vector<uint32_t>> categoryNameToIndices;
 
-  auto& ibo = sceneMesh_->ibo;
+  const auto& ibo = mesh->mesh->ibo;
   for (std::size_t iboIdx = 0; iboIdx < ibo.size(); iboIdx += 3) {
     // For each index in the ibo
     //  get the object id
@@ -382,63 +485,81 @@ void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
     categoryNameToIndices[catToUse].push_back(ibo[iboIdx + 2]);
   }
 
-  std::size_t indicesLoaded = 0;
-  std::size_t totalIndicesLoaded = 0;
-
-  // Send indices by category
-  for (auto catToIndices : categoryNameToIndices) {
-    RLRAudioPropagation::IndexData indices;
-
-    indices.indices = catToIndices.second.data();
-    indices.byteOffset = 0;
-    indices.indexCount = catToIndices.second.size();
-
-    ++indicesLoaded;
-    const bool lastUpdate = (indicesLoaded == categoryNameToIndices.size());
-
-    ESP_DEBUG() << logHeader_ << "Vertex count : " << vertices.vertexCount
-                << ", Index count : " << indices.indexCount
-                << ", Material : " << catToIndices.first
-                << ", LastUpdate : " << lastUpdate;
-
-    // Send all indices for this particular category
-    audioSimulator_->LoadMeshIndices(indices, catToIndices.first);
-
-    totalIndicesLoaded += indices.indexCount;
+  std::size_t totalIndices = 0;
+  for (auto& catToIndices : categoryNameToIndices) {
+    totalIndices += catToIndices.second.size();
+    mesh->materialIndices.emplace_back(catToIndices.first,
+                                       std::move(catToIndices.second));
   }
 
-  if (totalIndicesLoaded != sceneMesh_->ibo.size()) {
-    ESP_ERROR() << logHeader_
-                << "totalIndicesLoaded != sceneMesh_->ibo.size() : ("
-                << totalIndicesLoaded << " != " << sceneMesh_->ibo.size()
-                << ")";
-    CORRADE_ASSERT(false, "totalIndicesLoaded != sceneMesh_->ibo.size()", );
+  if (totalIndices != ibo.size()) {
+    ESP_ERROR() << logHeader_ << "totalIndices != ibo.size() : ("
+                << totalIndices << " != " << ibo.size() << ")";
+    CORRADE_ASSERT(false, "totalIndices != ibo.size()", nullptr);
   }
 
-  audioSimulator_->UploadMesh();
+  cached = mesh;
+  return mesh;
 }
 
-void AudioSensor::loadMesh(sim::Simulator& sim) {
-  ESP_DEBUG() << logHeader_ << "Loading non-semantic mesh";
-  CORRADE_ASSERT(audioSimulator_, "loadMesh: audioSimulator_ should exist", );
-  sceneMesh_ = sim.getJoinedMesh(true);
+void AudioSensor::loadAudioMaterials(
+    RLRAudioPropagation::Simulator& simulator) {
+  // Load the audio materials JSON if it was set
+  if (audioMaterialsJSON_.size() > 0) {
+    auto errorCode = simulator.LoadAudioMaterialJSON(audioMaterialsJSON_);
+    if (errorCode != RLRAudioPropagation::ErrorCodes::Success) {
+      ESP_ERROR() << "Audio material json could not be loaded. ErrorCode: "
+                  << static_cast<int>(errorCode)
+                  << ". Please check if the file exists and the format is "
+                     "correct. FilePath:"
+                  << audioMaterialsJSON_;
+      CORRADE_ASSERT(false, "", );
+    }
+  }
+}
 
+void AudioSensor::uploadAudioMesh(RLRAudioPropagation::Simulator& simulator,
+                                  const AudioMesh& mesh) {
   RLRAudioPropagation::VertexData vertices;
 
-  vertices.vertices = sceneMesh_->vbo.data();
+  vertices.vertices = mesh.mesh->vbo.data();
   vertices.byteOffset = 0;
-  vertices.vertexCount = sceneMesh_->vbo.size();
+  vertices.vertexCount = mesh.mesh->vbo.size();
   vertices.vertexStride = 0;
 
-  RLRAudioPropagation::IndexData indices;
+  if (mesh.materialIndices.empty()) {
+    RLRAudioPropagation::IndexData indices;
+
+    indices.indices = mesh.mesh->ibo.data();
+    indices.byteOffset = 0;
+    indices.indexCount = mesh.mesh->ibo.size();
 
-  indices.indices = sceneMesh_->ibo.data();
-  indices.byteOffset = 0;
-  indices.indexCount = sceneMesh_->ibo.size();
+    ESP_DEBUG() << "Vertex count : " << vertices.vertexCount
+                << ", Index count : " << indices.indexCount;
+    simulator.LoadMeshData(vertices, indices);
+    return;
+  }
+
+  // Send the vertex data
+  simulator.LoadMeshVertices(vertices);
+
+  // Send indices by category
+  for (const auto& catToIndices : mesh.materialIndices) {
+    RLRAudioPropagation::IndexData indices;
+
+    indices.indices = catToIndices.second.data();
+    indices.byteOffset = 0;
+    indices.indexCount = catToIndices.second.size();
+
+    ESP_DEBUG() << logHeader_ << "Vertex count : " << vertices.vertexCount
+                << ", Index count : " << indices.indexCount
+                << ", Material : " << catToIndices.first;
+
+    // Send all indices for this particular category
+    simulator.LoadMeshIndices(indices, catToIndices.first);
+  }
 
-  ESP_DEBUG() << "Vertex count : " << vertices.vertexCount
-              << ", Index count : " << indices.indexCount;
-  audioSimulator_->LoadMeshData(vertices, indices);
+  simulator.UploadMesh();
 }
 
 std::string AudioSensor::getSimulationFolder() {
@@ -7,6 +7,8 @@
 #include <memory>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
 #include "esp/scene/SemanticScene.h"
@@ -22,8 +24,14 @@
 #define ESP_SENSOR_AUDIOSENSOR_H_
 
 namespace esp {
+namespace core {
+class ThreadPool;
+}  // namespace core
+
 namespace sensor {
 
+struct AudioMesh;
+
 struct AudioSensorSpec : public SensorSpec {
  public:
   AudioSensorSpec();
@@ -36,6 +44,9 @@ struct AudioSensorSpec : public SensorSpec {
   RLRAudioPropagation::Configuration acousticsConfig_;
   RLRAudioPropagation::ChannelLayout channelLayout_;
   std::string outputDirectory_;
+  // Keep the simulation output in memory only. No simulation folder, impulse
+  // response or wave files are written, regardless of acousticsConfig_.
+  bool inMemoryIR_ = false;
 #endif  // ESP_BUILD_WITH_AUDIO
 
  public:
@@ -94,6 +105,54 @@ class AudioSensor : public Sensor {
    * @brief Return the last impulse response.
    * */
   const std::vector<std::vector<float>>& getIR();
+
+  /**
+   * @brief Copy the last impulse response into @p out, channel after
+   * channel, without any intermediate allocation.
+   * @param out Channel count times sample count floats, see
+   * @ref getObservationSpace()
+   * */
+  void readIR(Corrade::Containers::ArrayView<float> out);
+
+  /**
+   * @brief Source and listener of one simulation run by @ref runSimulations()
+   * */
+  struct SimulationRequest {
+    Magnum::Vector3 sourcePos;
+    Magnum::Vector3 agentPos;
+    Magnum::Vector4 agentRotQuat;
+  };
+
+  /**
+   * @brief Compute the impulse responses of many source/listener pairs
+   * concurrently
+   *
+   * Each worker thread keeps its own RLRAudioPropagation simulator, configured
+   * from the spec and loaded with the scene mesh once, and reuses it for later
+   * batches. The acousticsConfig threadCount applies to each of them, so it
+   * should be lowered accordingly. Doesn't affect the state used by
+   * @ref runSimulation() and @ref getIR().
+   * @param sim The simulator holding the scene
+   * @param requests The source/listener pairs to simulate
+   * @param numThreads The number of worker threads, values <= 0 select the
+   * hardware concurrency of the machine
+   * @return The impulse response of each request, in the layout of
+   * @ref getIR()
+   * */
+  std::vector<std::vector<std::vector<float>>> runSimulations(
+      sim::Simulator& sim,
+      const std::vector<SimulationRequest>& requests,
+      int numThreads = 0);
+
+  /**
+   * @brief Drop the acoustic meshes prepared for the scenes, so the next
+   * simulation rebuilds them. Needed if the static geometry of a scene
+   * changes while its sensors are in use.
+   *
+   * The prepared mesh of a scene is shared by all audio sensors, also across
+   * simulators, and kept as long as one of them uses it.
+   * */
+  static void clearMeshCache();
 #endif  // ESP_BUILD_WITH_AUDIO
 
   // ------ Sensor class overrides ------
@@ -112,14 +171,23 @@ class AudioSensor : public Sensor {
   void createAudioSimulator();
 
   /**
-   * @brief Load the semantic mesh for the Simulator object
+   * @brief Get the acoustic mesh of the current scene, from the cache shared
+   * by all audio sensors if it was prepared already. The semantic mesh with
+   * its material categories is used if materials are enabled and the scene
+   * has semantics, the render mesh otherwise.
    * */
-  void loadSemanticMesh(sim::Simulator& sim);
+  std::shared_ptr<const AudioMesh> getAudioMesh(sim::Simulator& sim);
 
   /**
-   * @brief Load the non-sematic mesh for the Simulator object
+   * @brief Load the audio materials JSON, if set, into @p simulator
    * */
-  void loadMesh(sim::Simulator& sim);
+  void loadAudioMaterials(RLRAudioPropagation::Simulator& simulator);
+
+  /**
+   * @brief Upload @p mesh to @p simulator
+   * */
+  void uploadAudioMesh(RLRAudioPropagation::Simulator& simulator,
+                       const AudioMesh& mesh);
 
   /**
    * @brief Get the simulation folder path.
@@ -140,9 +208,16 @@ class AudioSensor : public Sensor {
 
 #ifdef ESP_BUILD_WITH_AUDIO
   std::unique_ptr<RLRAudioPropagation::Simulator> audioSimulator_ = nullptr;
+
+  //! simulators of the runSimulations() workers, one per thread
+  std::vector<std::unique_ptr<RLRAudioPropagation::Simulator>>
+      batchSimulators_;
+  std::unique_ptr<core::ThreadPool> threadPool_;
+  //! the mesh uploaded to batchSimulators_
+  std::shared_ptr<const AudioMesh> batchMesh_;
 #endif  // ESP_BUILD_WITH_AUDIO
 
-  esp::assets::MeshData::ptr sceneMesh_;
+  std::shared_ptr<const AudioMesh> sceneMesh_;
 
   //! track the number of simulations
   std::int32_t currentSimCount_ = -1;
@@ -10,6 +10,7 @@
 #include <cmath>
 
 #include "CameraSensor.h"
+#include "esp/gfx/Renderer.h"
 #include "esp/gfx_batch/DepthUnprojection.h"
 #include "esp/sim/Simulator.h"
 
@@ -128,18 +129,61 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
     return false;
   }
 
-  renderTarget().renderEnter();
-
   gfx::RenderCamera::Flags flags;
   if (sim.isFrustumCullingEnabled()) {
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
   }
+  if (drawsDepthAndObjectIdOnly()) {
+    flags |= gfx::RenderCamera::Flag::DepthAndObjectIdOnly;
+  } else if (sim.getRenderer()->flags() & gfx::Renderer::Flag::DepthPrePass) {
+    flags |= gfx::RenderCamera::Flag::DepthPrePass;
+  }
+
+  // TODO: check sim has semantic scene graph
+  const bool isSemantic = cameraSensorSpec_->sensorType == SensorType::Semantic;
+  const bool twoSceneGraphs =
+      isSemantic &&
+      (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph());
+  const auto debugLineRender = sim.getDebugLineRender();
+  const bool drawsDebugLines = cameraSensorSpec_->sensorType ==
+                                   SensorType::Color &&
+                               debugLineRender &&
+                               debugLineRender->hasPendingLines();
+
+  // Frames moving the sensor between scene graphs, drawing debug lines or
+  // getting new render target noise are always drawn, others only if
+  // anything they depend on changed
+  const bool skipUnchanged =
+      (sim.getRenderer()->flags() & gfx::Renderer::Flag::SkipUnchangedFrames) &&
+      !twoSceneGraphs && !drawsDebugLines &&
+      !visualSensorSpec_->renderTargetNoiseModel;
+  DrawnFrame frame{flags, renderCamera_->cameraMatrix(),
+                   renderCamera_->projectionMatrix(),
+                   sim.getLightSetupVersion(), 0};
+  drawSkipped_ = false;
+  if (skipUnchanged && lastDrawnFrame_ && !sharedTgt_ &&
+      lastDrawnFrame_->flags == frame.flags &&
+      lastDrawnFrame_->cameraMatrix == frame.cameraMatrix &&
+      lastDrawnFrame_->projectionMatrix == frame.projectionMatrix &&
+      lastDrawnFrame_->lightSetupVersion == frame.lightSetupVersion) {
+    // only now that the camera is known to be still, as this culls the scene
+    scene::SceneGraph& sceneGraph = isSemantic
+                                        ? sim.getActiveSemanticSceneGraph()
+                                        : sim.getActiveSceneGraph();
+    if (renderCamera_->drawSignature(sceneGraph, flags) ==
+        lastDrawnFrame_->drawSignature) {
+      drawSkipped_ = true;
+      return true;
+    }
+  }
+  observationRead_ = false;
 
-  if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
-    // TODO: check sim has semantic scene graph
-    bool twoSceneGraphs =
-        (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph());
+  // the observation comes from this sensor's own pass again
+  setSharedRenderTarget(nullptr);
 
+  renderTarget().renderEnter();
+
+  if (isSemantic) {
     if (twoSceneGraphs) {
       // Helper's constructor moves this camera to the semantic scene graph.
       // When helper goes out of scope, its destructor moves it back to main
@@ -163,7 +207,6 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
       renderTarget().tryDrawHbao();
 
       // include DebugLineRender in Color sensors
-      const auto debugLineRender = sim.getDebugLineRender();
       if (debugLineRender) {
         debugLineRender->flushLines(renderCamera_->cameraMatrix(),
                                     renderCamera_->projectionMatrix(),
@@ -174,6 +217,13 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
 
   renderTarget().renderExit();
 
+  if (skipUnchanged) {
+    frame.drawSignature = renderCamera_->getPreviousSceneDrawSignature();
+    lastDrawnFrame_ = frame;
+  } else {
+    lastDrawnFrame_ = Cr::Containers::NullOpt;
+  }
+
   return true;
 }
 
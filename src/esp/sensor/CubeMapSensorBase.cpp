@@ -102,9 +102,13 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
   }
 
   // in case the fisheye sensor resolution changed at runtime
+  int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
+                                cubeMapSensorBaseSpec_->cubemapSize);
+  if (cubeMapSensorBaseSpec_->cubemapSize == Cr::Containers::NullOpt) {
+    // texels finer than the observation samples are wasted
+    size = Mn::Math::clamp(observationCubemapSize(), 1, size);
+  }
   {
-    int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
-                                  cubeMapSensorBaseSpec_->cubemapSize);
     bool reset = cubeMap_->reset(size);
     if (reset) {
       cubeMapCamera_->setProjectionMatrix(size, cubeMapSensorBaseSpec_->near,
@@ -122,6 +126,7 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
 
   // generate the cubemap texture
   const char* defaultDrawableGroupName = "";
+  const Mn::UnsignedInt faces = observedCubemapFaces(size);
   if (cubeMapSensorBaseSpec_->sensorType == SensorType::Semantic) {
     bool twoSceneGraphs =
         (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph());
@@ -133,11 +138,11 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       VisualSensor::MoveSemanticSensorNodeHelper helper(*this, sim);
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     } else {
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
 
     if (twoSceneGraphs) {
@@ -149,11 +154,11 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       flags &= ~gfx::RenderCamera::Flag::ClearDepth;
       flags &= ~gfx::RenderCamera::Flag::ClearObjectId;
       cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
   } else {
     cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                              defaultDrawableGroupName, flags);
+                              defaultDrawableGroupName, flags, faces);
   }
 
   return true;
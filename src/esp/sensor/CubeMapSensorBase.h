@@ -7,6 +7,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
 #include "VisualSensor.h"
 #include "esp/core/Esp.h"
 #include "esp/gfx/CubeMap.h"
@@ -24,7 +25,9 @@ namespace sensor {
 
 struct CubeMapSensorBaseSpec : public VisualSensorSpec {
   /**
-   * @brief the size of the cubemap
+   * @brief the size of the cubemap. If not set, sized so a cubemap texel
+   * covers about the angle of an observation pixel, but at most the smaller
+   * side of the resolution.
    */
   Corrade::Containers::Optional<int> cubemapSize = Corrade::Containers::NullOpt;
 
@@ -89,6 +92,25 @@ class CubeMapSensorBase : public VisualSensor {
 
   virtual Magnum::ResourceKey getShaderKey() = 0;
 
+  /**
+   * @brief The cubemap size at which a texel at the center of a face covers
+   * about the same angle as the finest pixel of the observation. Used, capped
+   * by the smaller side of the resolution, unless the spec sets the size.
+   */
+  virtual int observationCubemapSize() const {
+    return Magnum::Math::min(cubeMapSensorBaseSpec_->resolution);
+  }
+
+  /**
+   * @brief Mask of the cubemap faces the observation samples when the faces
+   * are @p size texels wide, see @ref gfx::CubeMap::AllFaces. The other faces
+   * are not rendered.
+   */
+  virtual Magnum::UnsignedInt observedCubemapFaces(
+      CORRADE_UNUSED int size) const {
+    return gfx::CubeMap::AllFaces;
+  }
+
   template <typename T>
   Magnum::Resource<gfx::CubeMapShaderBase, T> getShader();
 
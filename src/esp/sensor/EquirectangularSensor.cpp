@@ -6,6 +6,7 @@
 
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Constants.h>
 #include "esp/gfx/EquirectangularShader.h"
 #include "esp/sim/Simulator.h"
 
@@ -49,6 +50,15 @@ bool EquirectangularSensor::drawObservation(sim::Simulator& sim) {
   return true;
 }
 
+int EquirectangularSensor::observationCubemapSize() const {
+  // a cubemap of size s has s / 2 texels per radian at the center of a face
+  const Mn::Vector2i& resolution = equirectangularSensorSpec_->resolution;
+  const float texelsPerRadian =
+      Mn::Math::max(float(resolution[1]) / Mn::Constants::tau(),
+                    float(resolution[0]) / Mn::Constants::pi());
+  return int(Mn::Math::ceil(2.0f * texelsPerRadian));
+}
+
 Mn::ResourceKey EquirectangularSensor::getShaderKey() {
   return Cr::Utility::formatString(
       EQUIRECTANGULAR_SHADER_KEY_TEMPLATE,
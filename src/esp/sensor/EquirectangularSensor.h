@@ -76,6 +76,13 @@ class EquirectangularSensor : public CubeMapSensorBase {
   EquirectangularSensorSpec::ptr equirectangularSensorSpec_ =
       std::dynamic_pointer_cast<EquirectangularSensorSpec>(spec_);
   Magnum::ResourceKey getShaderKey() override;
+
+  /**
+   * @brief Sized after the angle a pixel covers, the observation spans 360
+   * degrees along its width and 180 degrees along its height.
+   */
+  int observationCubemapSize() const override;
+
   ESP_SMART_POINTERS(EquirectangularSensor)
 };
 
@@ -55,6 +55,43 @@ Magnum::Vector2 computePrincipalPointOffset(const FisheyeSensorSpec& spec) {
   return Mn::Vector2{spec.resolution} * 0.5f;
 }
 
+namespace {
+
+/**
+ * @brief The normalized cubemap lookup direction of the pixel at @p coord,
+ * the same as doubleSphereCamera.frag computes, or NullOpt where the shader
+ * discards the pixel.
+ */
+Cr::Containers::Optional<Mn::Vector3> unprojectDoubleSphere(
+    const FisheyeSensorDoubleSphereSpec& spec,
+    const Mn::Vector2& coord) {
+  const Mn::Vector2 mxy =
+      (coord - computePrincipalPointOffset(spec)) / spec.focalLength;
+  const float r2 = Mn::Math::dot(mxy, mxy);
+  const float sq1 = 1.0f - (2.0f * spec.alpha - 1.0f) * r2;
+  if (sq1 < 0.0f) {
+    return Cr::Containers::NullOpt;
+  }
+  const float mz = (1.0f - spec.alpha * spec.alpha * r2) /
+                   (spec.alpha * Mn::Math::sqrt(sq1) + 1.0f - spec.alpha);
+  const float mz2 = mz * mz;
+  const float sq2 = mz2 + (1.0f - spec.xi * spec.xi) * r2;
+  if (sq2 < 0.0f) {
+    return Cr::Containers::NullOpt;
+  }
+  Mn::Vector3 ray = (mz * spec.xi + Mn::Math::sqrt(sq2)) / (mz2 + r2) *
+                        Mn::Vector3{mxy, mz} -
+                    Mn::Vector3::zAxis(spec.xi);
+  // the cubemap is left-handed
+  ray.z() = -ray.z();
+  if (ray.isZero()) {
+    return Cr::Containers::NullOpt;
+  }
+  return ray.normalized();
+}
+
+}  // namespace
+
 FisheyeSensor::FisheyeSensor(scene::SceneNode& cameraNode,
                              const FisheyeSensorSpec::ptr& spec)
     : CubeMapSensorBase(cameraNode, spec) {
@@ -80,6 +117,70 @@ Mn::ResourceKey FisheyeSensor::getShaderKey() {
           cubeMapShaderBaseFlags_));
 }
 
+int FisheyeSensor::observationCubemapSize() const {
+  // TODO: The other FisheyeSensorModelType
+  if (fisheyeSensorSpec_->fisheyeModelType !=
+      FisheyeSensorModelType::DoubleSphere) {
+    return CubeMapSensorBase::observationCubemapSize();
+  }
+  const auto& spec =
+      static_cast<const FisheyeSensorDoubleSphereSpec&>(*fisheyeSensorSpec_);
+  const Mn::Vector2 center = computePrincipalPointOffset(spec);
+  const auto ray = unprojectDoubleSphere(spec, center);
+  const auto rayX = unprojectDoubleSphere(spec, center + Mn::Vector2::xAxis());
+  const auto rayY = unprojectDoubleSphere(spec, center + Mn::Vector2::yAxis());
+  if (!ray || !rayX || !rayY) {
+    return CubeMapSensorBase::observationCubemapSize();
+  }
+  const float pixelAngle =
+      Mn::Math::min(float(Mn::Math::angle(*ray, *rayX)),
+                    float(Mn::Math::angle(*ray, *rayY)));
+  if (!(pixelAngle > 0.0f)) {
+    return CubeMapSensorBase::observationCubemapSize();
+  }
+  // a cubemap of size s has s / 2 texels per radian at the center of a face
+  return int(Mn::Math::ceil(2.0f / pixelAngle));
+}
+
+Mn::UnsignedInt FisheyeSensor::observedCubemapFaces(int size) const {
+  if (fisheyeSensorSpec_->fisheyeModelType !=
+      FisheyeSensorModelType::DoubleSphere) {
+    return gfx::CubeMap::AllFaces;
+  }
+  const auto& spec =
+      static_cast<const FisheyeSensorDoubleSphereSpec&>(*fisheyeSensorSpec_);
+  // fragment coordinates are in W x H, the resolution in H x W
+  const Mn::Vector2 viewport{
+      Mn::Vector2i{spec.resolution[1], spec.resolution[0]}};
+  constexpr int Samples = 32;
+  // a ray also uses a face whose edge is a few texels away, as filtering
+  // reads across the seams
+  const float margin = 1.0f - 4.0f / float(size);
+
+  Mn::UnsignedInt faces = 0;
+  for (int j = 0; j <= Samples; ++j) {
+    for (int i = 0; i <= Samples; ++i) {
+      const Mn::Vector2 coord =
+          Mn::Vector2{0.5f} + (viewport - Mn::Vector2{1.0f}) *
+                                  Mn::Vector2{float(i), float(j)} /
+                                  float(Samples);
+      const auto ray = unprojectDoubleSphere(spec, coord);
+      if (!ray) {
+        continue;
+      }
+      const float major = Mn::Math::max(Mn::Math::abs(*ray));
+      // faces are ordered +X, -X, +Y, -Y, +Z, -Z
+      for (int axis = 0; axis < 3; ++axis) {
+        const float c = (*ray)[axis];
+        if (Mn::Math::abs(c) >= major * margin) {
+          faces |= 1u << (2 * axis + (c < 0.0f ? 1 : 0));
+        }
+      }
+    }
+  }
+  return faces;
+}
+
 bool FisheyeSensor::drawObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
@@ -128,6 +128,18 @@ class FisheyeSensor : public CubeMapSensorBase {
       std::dynamic_pointer_cast<FisheyeSensorSpec>(spec_);
   Magnum::ResourceKey getShaderKey() override;
 
+  /**
+   * @brief Sized after the angle a pixel at the principal point covers, where
+   * the lens model samples most densely.
+   */
+  int observationCubemapSize() const override;
+
+  /**
+   * @brief The faces hit by the rays through a grid of pixels covering the
+   * observation, including faces within a few texels of such a ray.
+   */
+  Magnum::UnsignedInt observedCubemapFaces(int size) const override;
+
   ESP_SMART_POINTERS(FisheyeSensor)
 };
 
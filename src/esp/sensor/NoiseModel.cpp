@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "NoiseModel.h"
+
+#include "esp/gfx/RenderTarget.h"
+
+namespace esp {
+namespace sensor {
+
+RgbNoiseModel::RgbNoiseModel(Type type, unsigned int seed)
+    : type_{type}, seed_{seed} {}
+
+RgbNoiseModel::~RgbNoiseModel() = default;
+
+void RgbNoiseModel::apply(gfx::RenderTarget& target) {
+  if (!shader_) {
+    shader_ = std::make_unique<gfx::RgbNoiseShader>(type_);
+  }
+  (*shader_)
+      .setSeed(seed_, frame_++)
+      .setNormalNoise(intensityConstant, mean, sigma)
+      .setSaltAndPepper(amount, saltVsPepper)
+      .setPoissonLevels(levels);
+  target.applyRgbaNoise(*shader_);
+}
+
+}  // namespace sensor
+}  // namespace esp
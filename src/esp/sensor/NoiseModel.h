@@ -0,0 +1,110 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_NOISEMODEL_H_
+#define ESP_SENSOR_NOISEMODEL_H_
+
+#include <memory>
+
+#include "esp/core/Esp.h"
+#include "esp/gfx/RgbNoiseShader.h"
+#include "esp/sensor/Sensor.h"
+
+namespace esp {
+namespace gfx {
+class RenderTarget;
+}  // namespace gfx
+
+namespace sensor {
+
+/**
+ * @brief Noise applied to the render target of a visual sensor on the GPU,
+ * after the sensor was drawn and before its observation is read. Set through
+ * @ref VisualSensorSpec::renderTargetNoiseModel.
+ *
+ * Unlike the models in habitat_sim.sensors.noise_models, which run on the
+ * observation once it was read, this also covers observations that stay on
+ * the GPU.
+ */
+class NoiseModel {
+ public:
+  virtual ~NoiseModel() = default;
+
+  /**
+   * @brief Add the noise to @p target. Called by @ref
+   * gfx::RenderTarget::renderExit() with the GL context current.
+   */
+  virtual void apply(gfx::RenderTarget& target) = 0;
+
+  /**
+   * @brief Whether the model can be applied to sensors of type @p type
+   */
+  virtual bool isValidSensorType(SensorType type) const = 0;
+
+  ESP_SMART_POINTERS(NoiseModel)
+};
+
+/**
+ * @brief GPU counterpart of the Gaussian, salt and pepper, Poisson and
+ * speckle noise models for color sensors
+ *
+ * The noise of a frame only depends on the seed and the number of frames
+ * noised since the seed was set, so a sequence of observations can be
+ * reproduced by setting the same seed again.
+ */
+class RgbNoiseModel : public NoiseModel {
+ public:
+  using Type = gfx::RgbNoiseShader::Type;
+
+  explicit RgbNoiseModel(Type type, unsigned int seed = 0);
+  ~RgbNoiseModel() override;
+
+  Type type() const { return type_; }
+
+  /**
+   * @brief Set the seed and restart the frame count
+   */
+  void setSeed(unsigned int seed) {
+    seed_ = seed;
+    frame_ = 0;
+  }
+  unsigned int seed() const { return seed_; }
+
+  /**
+   * @brief Number of frames noised since the seed was set
+   */
+  unsigned int frame() const { return frame_; }
+
+  void apply(gfx::RenderTarget& target) override;
+
+  bool isValidSensorType(SensorType type) const override {
+    return type == SensorType::Color;
+  }
+
+  // Gaussian and speckle parameters
+  float intensityConstant = 0.2f;
+  float mean = 0.0f;
+  float sigma = 1.0f;
+
+  // salt and pepper parameters
+  float amount = 0.05f;
+  float saltVsPepper = 0.5f;
+
+  // Poisson parameters, the number of intensity levels per channel
+  float levels = 256.0f;
+
+  ESP_SMART_POINTERS(RgbNoiseModel)
+
+ private:
+  Type type_;
+  unsigned int seed_;
+  unsigned int frame_ = 0;
+  // created on first use, as it needs a GL context
+  std::unique_ptr<gfx::RgbNoiseShader> shader_;
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_NOISEMODEL_H_
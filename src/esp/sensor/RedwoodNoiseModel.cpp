@@ -92,5 +92,18 @@ void RedwoodNoiseModelGPUImpl::simulateFromGPU(const float* devDepth,
                         devNoisyDepth);
 }
 
+void RedwoodNoiseModelGPUImpl::simulateTilesFromGPU(const float* devDepth,
+                                                    const int tileRows,
+                                                    const int tileCols,
+                                                    const int tileCountRows,
+                                                    const int tileCountCols,
+                                                    float* devNoisyDepth) {
+  CudaDeviceContext ctx{gpuDeviceId_};
+  impl::simulateTilesFromGPU(maxThreadsPerBlock_, warpSize_, devDepth,
+                             tileRows, tileCols, tileCountRows, tileCountCols,
+                             devModel_, curandStates_, noiseMultiplier_,
+                             devNoisyDepth);
+}
+
 }  // namespace sensor
 }  // namespace esp
@@ -41,6 +41,54 @@ __device__ float undistort(const int _x,
     return z / f;
 }
 
+// Noisy depth of the pixel idx of an H x W image whose rows are rowStride
+// pixels apart
+__device__ float noisyPixel(const float* __restrict__ depth,
+                            const int rowStride,
+                            const int H,
+                            const int W,
+                            const int idx,
+                            curandState_t* curandState,
+                            const float* __restrict__ model,
+                            const float noiseMultiplier) {
+  const float ymax = H - 1;
+  const float xmax = W - 1;
+  // Shuffle pixels
+  const int y = min(max((idx / W) + curand_normal(curandState) * 0.25f *
+                                        noiseMultiplier,
+                        0.0f),
+                    ymax) +
+                0.5f;
+  const int x = min(max((idx % W) + curand_normal(curandState) * 0.25f *
+                                        noiseMultiplier,
+                        0.0f),
+                    xmax) +
+                0.5f;
+
+  // downsample
+  const float d = depth[(y - y % 2) * rowStride + x - x % 2];
+  // If depth is greater than 10m, the sensor will just return a zero
+  if (d >= 10.0f) {
+    return 0.0f;
+  }
+  // Distortion
+  // The noise model was originally made for a 640x480 sensor,
+  // so re-map our arbitrarily sized sensor to that size!
+  const float undistorted_d =
+      undistort(static_cast<float>(x) / xmax * 639.0f + 0.5f,
+                static_cast<float>(y) / ymax * 479.0f + 0.5f, d, model);
+
+  // quantization and high freq noise
+  if (undistorted_d == 0.0f) {
+    return 0.0f;
+  }
+  const float denom =
+      round((35.130f / static_cast<double>(undistorted_d) +
+             curand_normal(curandState) * 0.027778f * noiseMultiplier) *
+            8.0f);
+  return denom > 1e-5 ? (35.130f * 8.0f / denom) : 0.0f;
+}
+
 __global__ void redwoodNoiseModelKernel(const float* __restrict__ depth,
                                         const int H,
                                         const int W,
@@ -53,50 +101,43 @@ __global__ void redwoodNoiseModelKernel(const float* __restrict__ depth,
 
   curandState_t curandState = states[ID];
 
-  const float ymax = H - 1;
-  const float xmax = W - 1;
   for (int idx = ID; idx < H * W; idx += STRIDE) {
-    // Shuffle pixels
-    const int y = min(max((idx / W) + curand_normal(&curandState) * 0.25f *
-                                          noiseMultiplier,
-                          0.0f),
-                      ymax) +
-                  0.5f;
-    const int x = min(max((idx % W) + curand_normal(&curandState) * 0.25f *
-                                          noiseMultiplier,
-                          0.0f),
-                      xmax) +
-                  0.5f;
-
-    // downsample
-    const float d = depth[(y - y % 2) * W + x - x % 2];
-    // If depth is greater than 10m, the sensor will just return a zero
-    if (d >= 10.0f) {
-      noisyDepth[idx] = 0.0f;
-    } else {
-      // Distortion
-      // The noise model was originally made for a 640x480 sensor,
-      // so re-map our arbitrarily sized sensor to that size!
-      const float undistorted_d =
-          undistort(static_cast<float>(x) / xmax * 639.0f + 0.5f,
-                    static_cast<float>(y) / ymax * 479.0f + 0.5f, d, model);
-
-      // quantization and high freq noise
-      if (undistorted_d == 0.0f) {
-        noisyDepth[idx] = 0.0f;
-      } else {
-        const float denom =
-            round((35.130f / static_cast<double>(undistorted_d) +
-                   curand_normal(&curandState) * 0.027778f * noiseMultiplier) *
-                  8.0f);
-        noisyDepth[idx] = denom > 1e-5 ? (35.130f * 8.0f / denom) : 0.0f;
-      }
-    }
+    noisyDepth[idx] = noisyPixel(depth, W, H, W, idx, &curandState, model,
+                                 noiseMultiplier);
   }
 
   states[ID] = curandState;
 }
 
+// One row of blocks per tile of a tileCountX tiles wide grid of H x W tiles,
+// each tile with its own range of random states
+__global__ void redwoodNoiseModelTilesKernel(
+    const float* __restrict__ depth,
+    const int H,
+    const int W,
+    const int tileCountX,
+    curandState_t* __restrict__ states,
+    const float* __restrict__ model,
+    const float noiseMultiplier,
+    float* __restrict__ noisyDepth) {
+  const int ID = blockIdx.x * blockDim.x + threadIdx.x;
+  const int STRIDE = gridDim.x * blockDim.x;
+  const int tile = blockIdx.y;
+  const int rowStride = tileCountX * W;
+  const int tileOffset =
+      (tile / tileCountX) * H * rowStride + (tile % tileCountX) * W;
+
+  curandState_t curandState = states[tile * STRIDE + ID];
+
+  for (int idx = ID; idx < H * W; idx += STRIDE) {
+    noisyDepth[tileOffset + (idx / W) * rowStride + idx % W] =
+        noisyPixel(depth + tileOffset, rowStride, H, W, idx, &curandState,
+                   model, noiseMultiplier);
+  }
+
+  states[tile * STRIDE + ID] = curandState;
+}
+
 __global__ void curandStatesSetupKernel(curandState_t* states,
                                         int seed,
                                         int n) {
@@ -171,6 +212,31 @@ void simulateFromGPU(const int maxThreadsPerBlock,
       devNoisyDepth);
 }
 
+void simulateTilesFromGPU(const int maxThreadsPerBlock,
+                          const int warpSize,
+                          const float* __restrict__ devDepth,
+                          const int H,
+                          const int W,
+                          const int tileCountY,
+                          const int tileCountX,
+                          const float* __restrict__ devModel,
+                          CurandStates* curandStates,
+                          const float noiseMultiplier,
+                          float* __restrict__ devNoisyDepth) {
+  const int totalConcurrency = std::ceil(static_cast<float>(H * W) / 4.0f);
+  const int nThreads =
+      std::min(std::max(roundToNearestMultiple(totalConcurrency, warpSize), 1),
+               maxThreadsPerBlock);
+  const int nBlocks =
+      std::ceil(static_cast<float>(totalConcurrency) / nThreads);
+  const int nTiles = tileCountY * tileCountX;
+
+  curandStates->alloc(nTiles * nBlocks * nThreads, maxThreadsPerBlock);
+  redwoodNoiseModelTilesKernel<<<dim3(nBlocks, nTiles), nThreads>>>(
+      devDepth, H, W, tileCountX, curandStates->devStates, devModel,
+      noiseMultiplier, devNoisyDepth);
+}
+
 void simulateFromCPU(const int maxThreadsPerBlock,
                      const int warpSize,
                      const float* __restrict__ depth,
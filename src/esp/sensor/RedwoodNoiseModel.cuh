@@ -34,6 +34,18 @@ void simulateFromGPU(const int maxThreadsPerBlock,
                      CurandStates* curandStates,
                      const float noiseMultiplier,
                      float* __restrict__ devNoisyDepth);
+
+void simulateTilesFromGPU(const int maxThreadsPerBlock,
+                          const int warpSize,
+                          const float* __restrict__ devDepth,
+                          const int H,
+                          const int W,
+                          const int tileCountY,
+                          const int tileCountX,
+                          const float* __restrict__ devModel,
+                          CurandStates* curandStates,
+                          const float noiseMultiplier,
+                          float* __restrict__ devNoisyDepth);
 }  // namespace impl
 }  // namespace sensor
 }  // namespace esp
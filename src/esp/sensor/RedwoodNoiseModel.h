@@ -75,6 +75,30 @@ struct RedwoodNoiseModelGPUImpl {
                        const int cols,
                        float* devNoisyDepth);
 
+  /**
+   * @brief Similar to @ref simulateFromGPU() but for a grid of equally sized
+   * depth images tiled into one buffer, such as the depth buffer of a batch
+   * renderer. All tiles are processed by a single kernel launch, each tile
+   * drawing from its own random states, which persist across calls.
+   *
+   * @param[in] devDepth        Device pointer to the clean depth of all tiles
+   *                            Assumed to be a contiguous array in row-major
+   *                            order, @p tileRows * @p tileCountRows rows of
+   *                            @p tileCols * @p tileCountCols columns
+   * @param[in] tileRows        The number of rows in one tile
+   * @param[in] tileCols        The number of columns in one tile
+   * @param[in] tileCountRows   The number of rows of tiles
+   * @param[in] tileCountCols   The number of columns of tiles
+   * @param[out] devNoisyDepth  Device pointer to the memory to write the noisy
+   *                            depth, with the same layout as @p devDepth
+   */
+  void simulateTilesFromGPU(const float* devDepth,
+                            const int tileRows,
+                            const int tileCols,
+                            const int tileCountRows,
+                            const int tileCountCols,
+                            float* devNoisyDepth);
+
   ~RedwoodNoiseModelGPUImpl();
 
  private:
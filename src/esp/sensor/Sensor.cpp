@@ -14,7 +14,8 @@ namespace sensor {
 bool SensorSpec::operator==(const SensorSpec& a) const {
   return uuid == a.uuid && sensorType == a.sensorType &&
          sensorSubType == a.sensorSubType && position == a.position &&
-         orientation == a.orientation && noiseModel == a.noiseModel;
+         orientation == a.orientation && noiseModel == a.noiseModel &&
+         updatePeriod == a.updatePeriod;
 }
 
 bool SensorSpec::operator!=(const SensorSpec& a) const {
@@ -40,6 +41,9 @@ void SensorSpec::sanityCheck() const {
                  "SensorSpec::sanityCheck(): orientation is illegal", );
   CORRADE_ASSERT(!noiseModel.empty(),
                  "SensorSpec::sanityCheck(): noiseModel is unitialized", );
+  CORRADE_ASSERT(updatePeriod > 0,
+                 "SensorSpec::sanityCheck(): updatePeriod" << updatePeriod
+                                                           << "is illegal", );
 }
 
 Sensor::Sensor(scene::SceneNode& node, SensorSpec::ptr spec)
@@ -81,6 +85,20 @@ void Sensor::setTransformationFromSpec() {
   node().rotateZ(Magnum::Rad(spec_->orientation[2]));
 }
 
+bool Sensor::advanceUpdateSchedule() {
+  if (stepsSinceUpdate_ == 0 || stepsSinceUpdate_ >= spec_->updatePeriod) {
+    stepsSinceUpdate_ = 1;
+    return true;
+  }
+  ++stepsSinceUpdate_;
+  return false;
+}
+
+bool Sensor::getCachedObservation(Observation& obs) {
+  obs.buffer = buffer_;
+  return buffer_ != nullptr;
+}
+
 SensorSuite::SensorSuite(scene::SceneNode& node)
     : Magnum::SceneGraph::AbstractFeature3D{node} {}
 
@@ -60,6 +60,10 @@ struct SensorSpec {
   Magnum::Vector3 position = {0, 1.5, 0};
   Magnum::Vector3 orientation = {0, 0, 0};
   std::string noiseModel = "None";
+  // Update the observation once every updatePeriod calls of
+  // Simulator::getAgentObservations, the calls in between return the
+  // observation of the last update
+  int updatePeriod = 1;
   SensorSpec() = default;
   virtual ~SensorSpec() = default;
   virtual bool isVisualSensorSpec() const { return false; }
@@ -153,9 +157,32 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual bool displayObservation(sim::Simulator& sim) = 0;
 
+  /**
+   * @brief Advance the update schedule given by @ref SensorSpec::updatePeriod
+   * by one step. The first step after construction or @ref
+   * resetUpdateSchedule is always due.
+   * @return Whether the sensor has to update its observation in this step
+   */
+  bool advanceUpdateSchedule();
+
+  /**
+   * @brief Make the next @ref advanceUpdateSchedule step due, e.g. after the
+   * scene changed
+   */
+  void resetUpdateSchedule() { stepsSinceUpdate_ = 0; }
+
+  /**
+   * @brief Fill @p obs with the observation of the last update, without
+   * drawing or reading anything
+   * @return Whether there is an observation
+   */
+  virtual bool getCachedObservation(Observation& obs);
+
  protected:
   SensorSpec::ptr spec_ = nullptr;
   core::Buffer::ptr buffer_ = nullptr;
+  // steps of the update schedule since the last update, 0 if none yet
+  int stepsSinceUpdate_ = 0;
 
   ESP_SMART_POINTERS(Sensor)
 };
@@ -5,9 +5,14 @@
 #include "VisualSensor.h"
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/PixelStorage.h>
 
 #include <utility>
 
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
 #include "esp/core/Utility.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/sim/Simulator.h"
@@ -41,6 +46,47 @@ void VisualSensorSpec::sanityCheck() const {
         "VisualSensorSpec::sanityCheck(): sensorType must be Depth if "
         "noiseModel is Redwood", );
   }
+  CORRADE_ASSERT(
+      !renderTargetNoiseModel ||
+          renderTargetNoiseModel->isValidSensorType(sensorType),
+      "VisualSensorSpec::sanityCheck(): renderTargetNoiseModel can't be "
+      "applied to this sensorType", );
+  switch (observationFormat) {
+    case ObservationFormat::Default:
+      break;
+    case ObservationFormat::RGB8:
+      CORRADE_ASSERT(sensorType == SensorType::Color,
+                     "VisualSensorSpec::sanityCheck(): sensorType must be "
+                     "Color if observationFormat is RGB8", );
+      break;
+    case ObservationFormat::DepthHalf:
+    case ObservationFormat::DepthUnorm16:
+      CORRADE_ASSERT(sensorType == SensorType::Depth,
+                     "VisualSensorSpec::sanityCheck(): sensorType must be "
+                     "Depth if observationFormat is DepthHalf or "
+                     "DepthUnorm16", );
+      break;
+    case ObservationFormat::SemanticUnsignedShort:
+      CORRADE_ASSERT(sensorType == SensorType::Semantic,
+                     "VisualSensorSpec::sanityCheck(): sensorType must be "
+                     "Semantic if observationFormat is "
+                     "SemanticUnsignedShort", );
+      break;
+  }
+  CORRADE_ASSERT(
+      !gpu2gpuTransfer || observationFormat == ObservationFormat::Default,
+      "VisualSensorSpec::sanityCheck(): gpu2gpuTransfer requires the Default "
+      "observationFormat", );
+  CORRADE_ASSERT(
+      downsampleLevels >= 0,
+      "VisualSensorSpec::sanityCheck(): the value of the downsampleLevels "
+      "which is"
+          << downsampleLevels << "is illegal", );
+  CORRADE_ASSERT(!downsampleLevels ||
+                     (observationFormat == ObservationFormat::Default &&
+                      !gpu2gpuTransfer),
+                 "VisualSensorSpec::sanityCheck(): downsampleLevels require "
+                 "the Default observationFormat and no gpu2gpuTransfer", );
   CORRADE_ASSERT(resolution[0] > 0 && resolution[1] > 0,
                  "VisualSensorSpec::sanityCheck(): resolution height and "
                  "width must be greater than 0", );
@@ -56,7 +102,10 @@ void VisualSensorSpec::sanityCheck() const {
 bool VisualSensorSpec::operator==(const VisualSensorSpec& a) const {
   return SensorSpec::operator==(a) && resolution == a.resolution &&
          channels == a.channels && gpu2gpuTransfer == a.gpu2gpuTransfer &&
-         far == a.far && near == a.near && a.clearColor == clearColor;
+         far == a.far && near == a.near && a.clearColor == clearColor &&
+         renderTargetNoiseModel == a.renderTargetNoiseModel &&
+         observationFormat == a.observationFormat &&
+         downsampleLevels == a.downsampleLevels;
 }
 
 VisualSensor::VisualSensor(scene::SceneNode& node, VisualSensorSpec::ptr spec)
@@ -72,6 +121,19 @@ void VisualSensor::bindRenderTarget(gfx::RenderTarget::uptr&& tgt) {
     throw std::runtime_error("RenderTarget is not the correct size");
 
   tgt_ = std::move(tgt);
+  resetObservationCache();
+}
+
+gfx::RenderTarget::uptr VisualSensor::releaseRenderTarget() {
+  resetObservationCache();
+  return std::move(tgt_);
+}
+
+bool VisualSensor::drawsDepthAndObjectIdOnly() const {
+  const SensorType type = visualSensorSpec_->sensorType;
+  return hasRenderTarget() &&
+         (type == SensorType::Depth || type == SensorType::Semantic) &&
+         !(tgt_->flags() & gfx::RenderTarget::Flag::RgbaAttachment);
 }
 
 bool VisualSensor::displayObservation(sim::Simulator& sim) {
@@ -89,15 +151,65 @@ bool VisualSensor::getObservationSpace(ObservationSpace& space) {
                  static_cast<size_t>(visualSensorSpec_->resolution[1]),
                  static_cast<size_t>(visualSensorSpec_->channels)};
   space.dataType = core::DataType::DT_UINT8;
+  switch (visualSensorSpec_->observationFormat) {
+    case ObservationFormat::Default:
+      if (visualSensorSpec_->sensorType == SensorType::Semantic) {
+        space.dataType = core::DataType::DT_UINT32;
+      } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
+        space.dataType = core::DataType::DT_FLOAT;
+      }
+      break;
+    case ObservationFormat::RGB8:
+      space.shape[2] = 3;
+      break;
+    case ObservationFormat::DepthHalf:
+      space.dataType = core::DataType::DT_FLOAT16;
+      break;
+    case ObservationFormat::DepthUnorm16:
+    case ObservationFormat::SemanticUnsignedShort:
+      space.dataType = core::DataType::DT_UINT16;
+      break;
+  }
+  return true;
+}
+
+Mn::PixelFormat VisualSensor::observationPixelFormat() const {
+  switch (visualSensorSpec_->observationFormat) {
+    case ObservationFormat::Default:
+      break;
+    case ObservationFormat::RGB8:
+      return Mn::PixelFormat::RGB8Unorm;
+    case ObservationFormat::DepthHalf:
+      return Mn::PixelFormat::R16F;
+    case ObservationFormat::DepthUnorm16:
+      return Mn::PixelFormat::R16Unorm;
+    case ObservationFormat::SemanticUnsignedShort:
+      return Mn::PixelFormat::R16UI;
+  }
   if (visualSensorSpec_->sensorType == SensorType::Semantic) {
-    space.dataType = core::DataType::DT_UINT32;
+    return Mn::PixelFormat::R32UI;
   } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
-    space.dataType = core::DataType::DT_FLOAT;
+    return Mn::PixelFormat::R32F;
   }
-  return true;
+  return Mn::PixelFormat::RGBA8Unorm;
 }
 
-void VisualSensor::readObservation(Observation& obs) {
+namespace {
+// rows of the 16-bit and RGB formats aren't necessarily four-byte aligned
+const Mn::PixelStorage ObservationStorage = Mn::PixelStorage{}.setAlignment(1);
+
+// rendering result the observations of a sensor type are read from
+gfx::RenderTarget::ReadSource observationReadSource(SensorType type) {
+  if (type == SensorType::Semantic) {
+    return gfx::RenderTarget::ReadSource::ObjectId;
+  } else if (type == SensorType::Depth) {
+    return gfx::RenderTarget::ReadSource::Depth;
+  }
+  return gfx::RenderTarget::ReadSource::Rgba;
+}
+}  // namespace
+
+void VisualSensor::prepareObservationBuffer(Observation& obs) {
   // Make sure we have memory
   if (buffer_ == nullptr) {
     // TODO: check if our sensor was resized and resize our buffer if needed
@@ -106,24 +218,153 @@ void VisualSensor::readObservation(Observation& obs) {
     buffer_ = core::Buffer::create(space.shape, space.dataType);
   }
   obs.buffer = buffer_;
+}
+
+Mn::MutableImageView2D VisualSensor::observationView(Observation& obs) {
+  prepareObservationBuffer(obs);
+  return {ObservationStorage, observationPixelFormat(), framebufferSize(),
+          obs.buffer->data};
+}
+
+Mn::MutableImageView2D VisualSensor::downsampledObservationView(
+    int level,
+    Observation& obs) {
+  if (level == 0) {
+    return observationView(obs);
+  }
+  if (downsampledBuffers_.size() < std::size_t(level)) {
+    downsampledBuffers_.resize(level);
+  }
+  core::Buffer::ptr& buffer = downsampledBuffers_[level - 1];
+  const Mn::Vector2i size = downsampledFramebufferSize(level);
+  if (buffer == nullptr) {
+    ObservationSpace space;
+    getObservationSpace(space);
+    // the shape is height x width
+    space.shape[0] = size.y();
+    space.shape[1] = size.x();
+    buffer = core::Buffer::create(space.shape, space.dataType);
+  }
+  obs.buffer = buffer;
+  return {ObservationStorage, observationPixelFormat(), size,
+          obs.buffer->data};
+}
+
+void VisualSensor::setObservationBuffer(
+    Cr::Containers::ArrayView<uint8_t> data) {
+#ifdef ESP_BUILD_WITH_CUDA
+  gpuObservationBuffer_ = nullptr;
+#endif
+  observationRead_ = false;
+  if (data.isEmpty()) {
+    // allocated again on the next read
+    buffer_ = nullptr;
+    return;
+  }
+  ObservationSpace space;
+  getObservationSpace(space);
+  buffer_ = core::Buffer::create(data, space.shape, space.dataType);
+}
+
+#ifdef ESP_BUILD_WITH_CUDA
+void VisualSensor::setObservationGpuBuffer(void* devPtr) {
+  gpuObservationBuffer_ = devPtr;
+  observationRead_ = false;
+}
+
+VisualSensor::GpuObservation VisualSensor::readObservationGpu() {
+  ObservationSpace space;
+  getObservationSpace(space);
+  std::size_t bytes = core::getDataTypeByteSize(space.dataType);
+  for (const std::size_t extent : space.shape) {
+    bytes *= extent;
+  }
+  // views of older observations keep their memory alive through data
+  if (!ownedGpuObservation_.data || ownedGpuObservationBytes_ != bytes) {
+    void* devPtr = nullptr;
+    cudaGetDevice(&ownedGpuObservation_.device);
+    ESP_CHECK(cudaMalloc(&devPtr, bytes) == cudaSuccess,
+              "VisualSensor::readObservationGpu(): can't allocate"
+                  << bytes << "bytes of CUDA memory");
+    ownedGpuObservation_.data =
+        std::shared_ptr<void>{devPtr, [](void* ptr) { cudaFree(ptr); }};
+    ownedGpuObservationBytes_ = bytes;
+  }
+  readObservationIntoGpu(ownedGpuObservation_.data.get());
+  return ownedGpuObservation_;
+}
+
+void VisualSensor::readObservationIntoGpu(void* devPtr) {
+  gfx::RenderTarget& tgt = observationRenderTarget();
+  if (visualSensorSpec_->sensorType == SensorType::Semantic) {
+    tgt.readFrameObjectIdGPU(static_cast<int32_t*>(devPtr));
+  } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
+    tgt.readFrameDepthGPU(static_cast<float*>(devPtr));
+  } else {
+    tgt.readFrameRgbaGPU(static_cast<uint8_t*>(devPtr));
+  }
+}
+#endif
+
+void VisualSensor::readObservation(Observation& obs) {
+#ifdef ESP_BUILD_WITH_CUDA
+  if (gpuObservationBuffer_) {
+    obs.buffer = nullptr;
+    readObservationIntoGpu(gpuObservationBuffer_);
+    return;
+  }
+#endif
+
+  gfx::RenderTarget& tgt = observationRenderTarget();
+  prepareObservationBuffer(obs);
+  const Mn::MutableImageView2D view{ObservationStorage,
+                                    observationPixelFormat(),
+                                    tgt.framebufferSize(), obs.buffer->data};
 
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
   if (visualSensorSpec_->sensorType == SensorType::Semantic) {
-    renderTarget().readFrameObjectId(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32UI, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    tgt.readFrameObjectId(view);
   } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
-    renderTarget().readFrameDepth(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32F, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    tgt.readFrameDepth(view);
   } else {
-    renderTarget().readFrameRgba(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::RGBA8Unorm, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    tgt.readFrameRgba(view);
   }
 }
 
+void VisualSensor::readDownsampledObservation(int level, Observation& obs) {
+  if (level == 0) {
+    readObservation(obs);
+    return;
+  }
+  observationRenderTarget().readFrameDownsampled(
+      observationReadSource(visualSensorSpec_->sensorType), level,
+      downsampledObservationView(level, obs));
+}
+
+VisualSensor::AsyncObservation VisualSensor::readObservationAsync() {
+  gfx::RenderTarget& tgt = observationRenderTarget();
+  const SensorType type = visualSensorSpec_->sensorType;
+  const gfx::RenderTarget::AsyncRead read =
+      tgt.readFrameAsync(observationReadSource(type), observationPixelFormat());
+  return {&tgt, read.id};
+}
+
+bool VisualSensor::finishReadObservation(const AsyncObservation& handle,
+                                         Observation& obs) {
+  if (!handle.target || !handle.readId) {
+    return false;
+  }
+  prepareObservationBuffer(obs);
+  const SensorType type = visualSensorSpec_->sensorType;
+  handle.target->finishReadFrameAsync(
+      {observationReadSource(type), handle.readId},
+      Mn::MutableImageView2D{ObservationStorage, observationPixelFormat(),
+                             handle.target->framebufferSize(),
+                             obs.buffer->data});
+  return true;
+}
+
 bool VisualSensor::getObservation(sim::Simulator& sim, Observation& obs) {
   // TODO: check if sensor is valid?
   // TODO: have different classes for the different types of sensors
@@ -132,8 +373,21 @@ bool VisualSensor::getObservation(sim::Simulator& sim, Observation& obs) {
     return false;
 
   drawObservation(sim);
+  // an unchanged frame is still in the buffer from the last read
+  if (drawSkipped_ && observationRead_ && getCachedObservation(obs)) {
+    return true;
+  }
   readObservation(obs);
+  observationRead_ = true;
+
+  return true;
+}
 
+bool VisualSensor::getCachedObservation(Observation& obs) {
+  if (!hasRenderTarget()) {
+    return false;
+  }
+  obs.buffer = buffer_;
   return true;
 }
 
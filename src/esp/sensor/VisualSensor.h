@@ -6,13 +6,19 @@
 #define ESP_SENSOR_VISUALSENSOR_H_
 
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/Math/Angle.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 #include "esp/core/Check.h"
 #include "esp/core/Esp.h"
 
 #include "esp/gfx/RenderCamera.h"
+#include "esp/sensor/NoiseModel.h"
 #include "esp/sensor/Sensor.h"
 
 namespace Mn = Magnum;
@@ -33,6 +39,35 @@ using Mn::Math::Literals::operator""_degf;
  */
 using SemanticSensorTarget = esp::scene::SceneNodeSemanticDataIDX;
 
+/**
+ * @brief Format the observations of a visual sensor are read as. The
+ * conversion happens on the GPU, before the readback.
+ */
+enum class ObservationFormat : uint8_t {
+  /**
+   * RGBA8 color, 32-bit float depth, 32-bit unsigned semantic IDs
+   */
+  Default,
+  /**
+   * RGB8 color without alpha. Color sensors only.
+   */
+  RGB8,
+  /**
+   * 16-bit float depth. Depth sensors only.
+   */
+  DepthHalf,
+  /**
+   * 16-bit unsigned normalized depth, with 1 at the far plane. Depth sensors
+   * only.
+   */
+  DepthUnorm16,
+  /**
+   * 16-bit unsigned semantic IDs, which then need to fit into 16 bits.
+   * Semantic sensors only.
+   */
+  SemanticUnsignedShort,
+};
+
 struct VisualSensorSpec : public SensorSpec {
   /**
    * @brief height x width
@@ -65,6 +100,35 @@ struct VisualSensorSpec : public SensorSpec {
    */
   SemanticSensorTarget semanticTarget = SemanticSensorTarget::SEMANTIC_ID;
 
+  /**
+   * @brief format the observations are read as. Only @ref
+   * ObservationFormat::Default is supported with @ref gpu2gpuTransfer.
+   */
+  ObservationFormat observationFormat = ObservationFormat::Default;
+
+  /**
+   * @brief noise applied on the GPU to the render target before the
+   * observation is read, none if nullptr. Independent of @ref noiseModel,
+   * which is applied to the observation afterwards.
+   */
+  NoiseModel::ptr renderTargetNoiseModel = nullptr;
+
+  /**
+   * @brief number of additional observations downsampled on the GPU from the
+   * rendered one, each at half the resolution of the previous, see @ref
+   * VisualSensor::readDownsampledObservation. Requires the Default @ref
+   * observationFormat and no @ref gpu2gpuTransfer.
+   */
+  int downsampleLevels = 0;
+
+  /**
+   * @brief uuid of the observation downsampled @p level times, as returned by
+   * @ref sim::Simulator::getAgentObservations
+   */
+  std::string downsampledUuid(int level) const {
+    return uuid + "_level" + std::to_string(level);
+  }
+
   VisualSensorSpec();
   void sanityCheck() const override;
   bool isVisualSensorSpec() const override { return true; }
@@ -118,6 +182,20 @@ class VisualSensor : public Sensor {
    */
   void bindRenderTarget(std::unique_ptr<gfx::RenderTarget>&& tgt);
 
+  /**
+   * @brief Unbinds the RenderTarget from the sensor and gives up its ownership
+   * to the caller
+   */
+  std::unique_ptr<gfx::RenderTarget> releaseRenderTarget();
+
+  /**
+   * @brief Whether the sensor can be drawn with @ref
+   * gfx::RenderCamera::Flag::DepthAndObjectIdOnly, which is the case for
+   * depth and semantic sensors with a render target that has no color
+   * attachment
+   */
+  bool drawsDepthAndObjectIdOnly() const;
+
   /**
    * @brief Returns a reference to the sensors render target
    */
@@ -127,6 +205,24 @@ class VisualSensor : public Sensor {
     return *tgt_;
   }
 
+  /**
+   * @brief Returns the render target the observation of this sensor is read
+   * from. This is the sensor's own render target, unless its last observation
+   * was drawn into the render target of another sensor, see @ref
+   * setSharedRenderTarget.
+   */
+  gfx::RenderTarget& observationRenderTarget() {
+    return sharedTgt_ ? *sharedTgt_ : renderTarget();
+  }
+
+  /**
+   * @brief Read the observations of this sensor from @p tgt, which holds a
+   * pass drawn for another, co-located sensor. Pass nullptr to read from the
+   * sensor's own render target again; drawing the sensor's own observation
+   * does so too. @p tgt must outlive its use by this sensor.
+   */
+  void setSharedRenderTarget(gfx::RenderTarget* tgt) { sharedTgt_ = tgt; }
+
   /**
    * @brief Draw an observation to the frame buffer using simulator's renderer
    * @return true if success, otherwise false (e.g., frame buffer is not set)
@@ -142,6 +238,113 @@ class VisualSensor : public Sensor {
    */
   virtual void readObservation(Observation& obs);
 
+  /**
+   * @brief Make @ref readObservation write into @p data, preallocated host
+   * memory owned by the caller (e.g. a pinned tensor of a trainer), instead of
+   * a buffer allocated by the sensor
+   *
+   * @p data has to fit the observation described by @ref getObservationSpace
+   * and stay alive while it's used. Pass an empty view to go back to a buffer
+   * owned by the sensor.
+   */
+  void setObservationBuffer(Corrade::Containers::ArrayView<uint8_t> data);
+
+#ifdef ESP_BUILD_WITH_CUDA
+  /**
+   * @brief Make @ref readObservation write into CUDA memory owned by the
+   * caller, through @ref gfx::RenderTarget::readFrameRgbaGPU and friends
+   *
+   * @p devPtr has to fit the observation described by @ref
+   * getObservationSpace and be on the device of the OpenGL context. The
+   * @ref Observation::buffer is null then. Pass nullptr to read into host
+   * memory again.
+   */
+  void setObservationGpuBuffer(void* devPtr);
+
+  /** @brief Observation read into CUDA memory owned by the sensor */
+  struct GpuObservation {
+    /** @brief The memory, freed once neither the sensor nor a view uses it */
+    std::shared_ptr<void> data;
+    /** @brief CUDA device of the memory */
+    int device = 0;
+  };
+
+  /**
+   * @brief Read the observation into CUDA memory owned by the sensor
+   *
+   * The memory holds the observation described by @ref getObservationSpace,
+   * with the bottom row first, and is allocated on the current CUDA device on
+   * first use. Later reads overwrite it, only a changed observation size
+   * allocates new memory, so keep @ref GpuObservation::data to export views
+   * of it without copies. Requires the Default @ref
+   * VisualSensorSpec::observationFormat.
+   */
+  GpuObservation readObservationGpu();
+#endif
+
+  /**
+   * @brief Pixel format the observations of this sensor are read as, see
+   * @ref VisualSensorSpec::observationFormat
+   */
+  Mn::PixelFormat observationPixelFormat() const;
+
+  /**
+   * @brief Point @p obs to the observation buffer, allocating it if needed
+   * @return A view on the buffer the observations of this sensor are read
+   * into
+   */
+  Mn::MutableImageView2D observationView(Observation& obs);
+
+  /**
+   * @brief Size of the observation downsampled @p level times as a [W, H]
+   * Vector2i, see @ref gfx::RenderTarget::downsampledSize
+   */
+  Magnum::Vector2i downsampledFramebufferSize(int level) const {
+    return Mn::Math::max(framebufferSize() >> level, Mn::Vector2i{1});
+  }
+
+  /**
+   * @brief Point @p obs to the buffer of the observation downsampled @p level
+   * times, allocating it if needed. Level 0 is the same as @ref
+   * observationView.
+   * @return A view on the buffer
+   */
+  Mn::MutableImageView2D downsampledObservationView(int level,
+                                                    Observation& obs);
+
+  /**
+   * @brief Read the observation that was rendered by the simulator,
+   * downsampled @p level times on the GPU, see @ref
+   * gfx::RenderTarget::readFrameDownsampled. Level 0 is the same as @ref
+   * readObservation. No noise model is applied to higher levels.
+   */
+  void readDownsampledObservation(int level, Observation& obs);
+
+  /**
+   * @brief Handle of an observation read started by @ref readObservationAsync
+   */
+  struct AsyncObservation {
+    //! The render target the observation is read from
+    gfx::RenderTarget* target = nullptr;
+    //! Id of the read on @ref target, see @ref gfx::RenderTarget::AsyncRead
+    std::uint64_t readId = 0;
+  };
+
+  /**
+   * @brief Start reading the observation that was rendered by the simulator
+   * without waiting for the GPU, see @ref gfx::RenderTarget::readFrameAsync.
+   * The simulator can step and draw the next observation meanwhile.
+   * @return A handle to pass to @ref finishReadObservation
+   */
+  AsyncObservation readObservationAsync();
+
+  /**
+   * @brief Wait for the read started by @p handle and store the observation in
+   * @p obs
+   * @return false if @p handle is not valid
+   */
+  bool finishReadObservation(const AsyncObservation& handle, Observation& obs);
+
   /*
    * @brief Display next observation from Simulator on default frame buffer
    * @brief Draws an observation to the frame buffer using simulator's renderer,
@@ -154,6 +357,42 @@ class VisualSensor : public Sensor {
    */
   bool getObservation(sim::Simulator& sim, Observation& obs) override;
 
+  /**
+   * @brief Fill @p obs with the observation of the last update. Like @ref
+   * readObservation, leaves the buffer null for sensors reading into CUDA
+   * memory, which then still holds the last observation.
+   */
+  bool getCachedObservation(Observation& obs) override;
+
+  /**
+   * @brief Whether the last @ref drawObservation() skipped drawing because
+   * nothing the sensor sees changed since the frame before
+   *
+   * Camera sensors skip unchanged frames with @ref
+   * gfx::Renderer::Flag::SkipUnchangedFrames, @ref getObservation() then
+   * returns the last observation without reading it again. A frame is
+   * unchanged if the camera transformation and projection, the draw flags,
+   * the @ref sim::Simulator::getLightSetupVersion() and the ids and
+   * transformations of the drawables passing culling in all drawable groups,
+   * including the joint transformations of skinned ones, are the same. Changed
+   * materials, textures, semantic ids or light setup keys of individual
+   * drawables aren't detected, call @ref resetObservationCache() after those.
+   * Sensors with a @ref VisualSensorSpec::renderTargetNoiseModel never skip,
+   * as every frame gets new noise.
+   */
+  bool isObservationUnchanged() const { return drawSkipped_; }
+
+  /**
+   * @brief Make the next @ref drawObservation() draw even if nothing changed
+   *
+   * Needed as well after drawing into the render target in other ways, such
+   * as with @ref gfx::Renderer::enqueueAsyncDrawJob.
+   */
+  void resetObservationCache() {
+    lastDrawnFrame_ = Cr::Containers::NullOpt;
+    drawSkipped_ = false;
+  }
+
   /**
    * @brief Updates ObservationSpace space with spaceType, shape, and dataType
    * of this sensor. The information in space is later used to resize the
@@ -225,7 +464,38 @@ class VisualSensor : public Sensor {
    */
   Mn::Deg hfov_ = 90.0_degf;
 
+  //! Makes sure the observation buffer exists and points @p obs to it
+  void prepareObservationBuffer(Observation& obs);
+
+  //! What the last drawn frame depended on, see isObservationUnchanged()
+  struct DrawnFrame {
+    gfx::RenderCamera::Flags flags;
+    Mn::Matrix4 cameraMatrix;
+    Mn::Matrix4 projectionMatrix;
+    std::uint64_t lightSetupVersion = 0;
+    std::uint64_t drawSignature = 0;
+  };
+  Cr::Containers::Optional<DrawnFrame> lastDrawnFrame_;
+  //! whether the last drawObservation() skipped drawing
+  bool drawSkipped_ = false;
+  //! whether buffer_ holds the observation of the last drawn frame
+  bool observationRead_ = false;
+
   std::unique_ptr<gfx::RenderTarget> tgt_;
+  //! render target of another sensor the observation is read from, if any
+  gfx::RenderTarget* sharedTgt_ = nullptr;
+#ifdef ESP_BUILD_WITH_CUDA
+  //! CUDA memory of the caller observations are read into, if any
+  void* gpuObservationBuffer_ = nullptr;
+  //! CUDA memory owned by the sensor, see readObservationGpu()
+  GpuObservation ownedGpuObservation_;
+  std::size_t ownedGpuObservationBytes_ = 0;
+
+  //! Reads the observation into CUDA memory at @p devPtr
+  void readObservationIntoGpu(void* devPtr);
+#endif
+  //! buffers of the downsampled observations, starting with level 1
+  std::vector<core::Buffer::ptr> downsampledBuffers_;
   VisualSensorSpec::ptr visualSensorSpec_ =
       std::dynamic_pointer_cast<VisualSensorSpec>(spec_);
 
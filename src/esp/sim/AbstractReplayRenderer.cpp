@@ -4,6 +4,10 @@
 
 #include "AbstractReplayRenderer.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
+
+#include "esp/core/ParallelFor.h"
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 
 namespace esp {
@@ -46,6 +50,14 @@ unsigned AbstractReplayRenderer::environmentCount() const {
   return doEnvironmentCount();
 }
 
+unsigned AbstractReplayRenderer::sensorCount() const {
+  return doSensorCount();
+}
+
+unsigned AbstractReplayRenderer::doSensorCount() const {
+  return 1;
+}
+
 Mn::Vector2i AbstractReplayRenderer::sensorSize(unsigned envIndex) {
   CORRADE_INTERNAL_ASSERT(envIndex < doEnvironmentCount());
   return doSensorSize(envIndex);
@@ -73,6 +85,40 @@ void AbstractReplayRenderer::setEnvironmentKeyframeUnwrapped(
       esp::gfx::replay::Player::keyframeFromStringUnwrapped(serKeyframe));
 }
 
+void AbstractReplayRenderer::setEnvironmentKeyframes(
+    const std::vector<std::string>& serKeyframes,
+    int numThreads) {
+  ESP_CHECK(serKeyframes.size() == doEnvironmentCount(),
+            "ReplayRenderer::setEnvironmentKeyframes(): expected"
+                << doEnvironmentCount() << "keyframes but got"
+                << serKeyframes.size());
+
+  // Parsing is independent for each keyframe and is where most of the time
+  // goes
+  std::vector<esp::gfx::replay::Keyframe> keyframes(serKeyframes.size());
+  core::parallelFor(serKeyframes.size(), numThreads, [&](std::size_t i, int) {
+    keyframes[i] =
+        esp::gfx::replay::Player::keyframeFromString(serKeyframes[i]);
+  });
+
+  for (unsigned envIndex = 0; envIndex != keyframes.size(); ++envIndex) {
+    doPlayerFor(envIndex).setSingleKeyframe(std::move(keyframes[envIndex]));
+  }
+}
+
+int AbstractReplayRenderer::setEnvironmentKeyframesFromRingBuffer(
+    unsigned envIndex,
+    esp::gfx::replay::KeyframeRingBuffer& ringBuffer) {
+  CORRADE_INTERNAL_ASSERT(envIndex < doEnvironmentCount());
+  int count = 0;
+  while (Cr::Containers::Optional<esp::gfx::replay::Keyframe> keyframe =
+             ringBuffer.pop()) {
+    doPlayerFor(envIndex).setSingleKeyframe(std::move(*keyframe));
+    ++count;
+  }
+  return count;
+}
+
 void AbstractReplayRenderer::setSensorTransform(unsigned envIndex,
                                                 const std::string& sensorName,
                                                 const Mn::Matrix4& transform) {
@@ -80,6 +126,15 @@ void AbstractReplayRenderer::setSensorTransform(unsigned envIndex,
   return doSetSensorTransform(envIndex, sensorName, transform);
 }
 
+void AbstractReplayRenderer::setSensorTransforms(
+    Cr::Containers::ArrayView<const Mn::Matrix4> transforms) {
+  const std::size_t sensorCount = doEnvironmentCount() * doSensorCount();
+  ESP_CHECK(transforms.size() == sensorCount,
+            "ReplayRenderer::setSensorTransforms(): expected"
+                << sensorCount << "transforms but got" << transforms.size());
+  return doSetSensorTransforms(transforms);
+}
+
 void AbstractReplayRenderer::setSensorTransformsFromKeyframe(
     unsigned envIndex,
     const std::string& prefix) {
@@ -94,16 +149,17 @@ void AbstractReplayRenderer::setSensorTransformsFromKeyframe(
 void AbstractReplayRenderer::render(
     Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
     Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
+  const std::size_t imageCount = doEnvironmentCount() * doSensorCount();
   if (colorImageViews.size() > 0) {
-    ESP_CHECK(colorImageViews.size() == doEnvironmentCount(),
+    ESP_CHECK(colorImageViews.size() == imageCount,
               "ReplayRenderer::render(): expected"
-                  << doEnvironmentCount() << "color image views but got"
+                  << imageCount << "color image views but got"
                   << colorImageViews.size());
   }
   if (depthImageViews.size() > 0) {
-    ESP_CHECK(depthImageViews.size() == doEnvironmentCount(),
+    ESP_CHECK(depthImageViews.size() == imageCount,
               "ReplayRenderer::render(): expected"
-                  << doEnvironmentCount() << "depth image views but got"
+                  << imageCount << "depth image views but got"
                   << depthImageViews.size());
   }
   return doRender(colorImageViews, depthImageViews);
@@ -124,6 +180,11 @@ const void* AbstractReplayRenderer::getCudaDepthBufferDevicePointer() {
   return nullptr;
 }
 
+const void* AbstractReplayRenderer::getCudaSemanticBufferDevicePointer() {
+  ESP_ERROR() << "CUDA device pointer only available with the batch renderer.";
+  return nullptr;
+}
+
 std::shared_ptr<esp::gfx::DebugLineRender>
 AbstractReplayRenderer::getDebugLineRender(unsigned envIndex) {
   ESP_CHECK(envIndex == 0, "getDebugLineRender is only available for env 0");
@@ -141,6 +202,54 @@ esp::geo::Ray AbstractReplayRenderer::unproject(
   return doUnproject(envIndex, viewportPosition);
 }
 
+std::vector<esp::geo::Ray> AbstractReplayRenderer::unproject(
+    const std::vector<unsigned>& envIndices,
+    const std::vector<Mn::Vector2i>& viewportPositions) {
+  ESP_CHECK(envIndices.size() == viewportPositions.size(),
+            "ReplayRenderer::unproject(): expected"
+                << envIndices.size() << "viewport positions but got"
+                << viewportPositions.size());
+  std::vector<esp::geo::Ray> rays;
+  rays.reserve(envIndices.size());
+  for (std::size_t i = 0; i != envIndices.size(); ++i) {
+    checkEnvIndex(envIndices[i]);
+    rays.push_back(doUnproject(envIndices[i], viewportPositions[i]));
+  }
+  return rays;
+}
+
+std::vector<ReplayRendererPickResult> AbstractReplayRenderer::pick(
+    const std::vector<unsigned>& envIndices,
+    const std::vector<Mn::Vector2i>& viewportPositions) {
+  ESP_CHECK(envIndices.size() == viewportPositions.size(),
+            "ReplayRenderer::pick(): expected"
+                << envIndices.size() << "viewport positions but got"
+                << viewportPositions.size());
+  for (std::size_t i = 0; i != envIndices.size(); ++i) {
+    checkEnvIndex(envIndices[i]);
+    const Mn::Vector2i size = doSensorSize(envIndices[i]);
+    ESP_CHECK((viewportPositions[i] >= Mn::Vector2i{}).all() &&
+                  (viewportPositions[i] < size).all(),
+              "ReplayRenderer::pick(): position"
+                  << viewportPositions[i] << "out of range for a sensor of size"
+                  << size);
+  }
+
+  std::vector<ReplayRendererPickResult> results(envIndices.size());
+  if (!doPick(envIndices, viewportPositions, results)) {
+    return {};
+  }
+  return results;
+}
+
+bool AbstractReplayRenderer::doPick(
+    Cr::Containers::ArrayView<const unsigned>,
+    Cr::Containers::ArrayView<const Mn::Vector2i>,
+    Cr::Containers::ArrayView<ReplayRendererPickResult>) {
+  ESP_ERROR() << "Picking only available with the batch renderer.";
+  return false;
+}
+
 void AbstractReplayRenderer::checkEnvIndex(unsigned envIndex) {
   ESP_CHECK(envIndex < doEnvironmentCount(),
             "envIndex " << envIndex << " is out of range");
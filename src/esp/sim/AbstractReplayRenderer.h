@@ -12,6 +12,7 @@ namespace esp {
 
 namespace gfx {
 namespace replay {
+class KeyframeRingBuffer;
 class Player;
 }
 }  // namespace gfx
@@ -57,6 +58,31 @@ class ReplayRendererConfiguration {
 
   bool enableFrustumCulling = true;
 
+  /**
+   * @brief Store mesh positions, normals and texture coordinates in 16-bit
+   * formats
+   *
+   * Cuts the GPU memory and vertex bandwidth of the meshes, which adds up
+   * with many environments per GPU.
+   */
+  bool quantizeMeshes = false;
+
+  /**
+   * @brief Render semantic IDs of the replay instances
+   *
+   * Supported only by the batch renderer, retrieve the output with
+   * @ref AbstractReplayRenderer::getCudaSemanticBufferDevicePointer().
+   */
+  bool enableSemanticOutput = false;
+
+  /**
+   * @brief Max count of skinned joints per environment
+   *
+   * Used by the batch renderer to pose skinned instances referencing a rig.
+   * Set to @cpp 0 @ce to disable skinning.
+   */
+  unsigned maxJointCount = 256;
+
   bool enableHBAO = false;
 
   std::vector<std::shared_ptr<sensor::SensorSpec>> sensorSpecifications;
@@ -64,6 +90,19 @@ class ReplayRendererConfiguration {
   ESP_SMART_POINTERS(ReplayRendererConfiguration)
 };
 
+/**
+ * @brief Result of a single query of @ref AbstractReplayRenderer::pick()
+ */
+struct ReplayRendererPickResult {
+  /** @brief Semantic ID of the instance drawn at the pixel, 0 if none */
+  unsigned objectId = 0;
+
+  /**
+   * @brief Camera-space depth at the pixel, 0 if nothing was drawn there
+   */
+  float depth = 0.0f;
+};
+
 class AbstractReplayRenderer {
  public:
   static Magnum::Vector2i environmentGridSize(int environmentCount);
@@ -76,7 +115,16 @@ class AbstractReplayRenderer {
 
   unsigned environmentCount() const;
 
-  // Assumes there's just one sensor per env
+  /**
+   * @brief Count of sensors rendered for each environment
+   *
+   * Always @cpp 1 @ce for the classic renderer. The batch renderer renders
+   * all of @ref ReplayRendererConfiguration::sensorSpecifications, sharing
+   * the transformations of the environment among them.
+   */
+  unsigned sensorCount() const;
+
+  // All sensors of an env are assumed to have the same size
   Magnum::Vector2i sensorSize(unsigned envIndex);
 
   void clearEnvironment(unsigned envIndex);
@@ -88,10 +136,52 @@ class AbstractReplayRenderer {
       unsigned envIndex,
       Corrade::Containers::StringView serKeyframe);
 
+  /**
+   * @brief Set keyframes of all environments at once
+   * @param serKeyframes  Wrapped JSON keyframe for each environment, same as
+   *    passed to @ref setEnvironmentKeyframe(). The size is expected to be
+   *    @ref environmentCount().
+   * @param numThreads    Number of threads used for parsing, values <= 0
+   *    select the hardware concurrency
+   *
+   * Equivalent to calling @ref setEnvironmentKeyframe() for each
+   * environment, but the keyframes are parsed in parallel. Applying them to
+   * the environments stays serialized, as it may load assets and access the
+   * GPU context.
+   */
+  void setEnvironmentKeyframes(const std::vector<std::string>& serKeyframes,
+                               int numThreads = 0);
+
+  /**
+   * @brief Apply keyframes of an environment from a shared-memory ring buffer
+   * @return Number of keyframes applied
+   *
+   * Pops keyframes pushed by a @ref esp::gfx::replay::Recorder in another
+   * process until the buffer is empty and applies them in order, the same as
+   * passing each to @ref setEnvironmentKeyframe(). Avoids JSON parsing
+   * entirely, as the keyframes are transported in the binary keyframe format.
+   */
+  int setEnvironmentKeyframesFromRingBuffer(
+      unsigned envIndex,
+      esp::gfx::replay::KeyframeRingBuffer& ringBuffer);
+
   void setSensorTransform(unsigned envIndex,
                           const std::string& sensorName,
                           const Magnum::Matrix4& transform);
 
+  /**
+   * @brief Set the transforms of all sensors of all environments at once
+   *
+   * Expects one transform per environment and sensor, with the transforms of
+   * all sensors of an environment next to each other in the order of
+   * @ref ReplayRendererConfiguration::sensorSpecifications, same as the
+   * images in @ref render(). Saves a call per sensor compared to
+   * @ref setSensorTransform(), and the batch renderer updates all cameras in
+   * a single pass.
+   */
+  void setSensorTransforms(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transforms);
+
   // You must have done Recorder::addUserTransformToKeyframe(prefix +
   // sensorName, ...) for every sensor in
   // ReplayRendererConfiguration::sensorSpecifications, for the specified
@@ -100,7 +190,10 @@ class AbstractReplayRenderer {
                                        const std::string& prefix);
 
   // Renders into the specified CPU-resident image view arrays (one image per
-  // environment). Waits for the render to finish.
+  // environment and sensor, with images of all sensors of an environment
+  // next to each other in the order of
+  // ReplayRendererConfiguration::sensorSpecifications). Waits for the render
+  // to finish.
   void render(Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
                   colorImageViews,
               Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
@@ -115,6 +208,10 @@ class AbstractReplayRenderer {
   // Retrieve the depth buffer as a CUDA device pointer. */
   virtual const void* getCudaDepthBufferDevicePointer();
 
+  // Retrieve the semantic ID buffer as a CUDA device pointer. Requires
+  // ReplayRendererConfiguration::enableSemanticOutput.
+  virtual const void* getCudaSemanticBufferDevicePointer();
+
   std::shared_ptr<esp::gfx::DebugLineRender> getDebugLineRender(
       unsigned envIndex);
 
@@ -129,6 +226,36 @@ class AbstractReplayRenderer {
   esp::geo::Ray unproject(unsigned envIndex,
                           const Magnum::Vector2i& viewportPosition);
 
+  /**
+   * @brief Unproject many 2D viewport points at once
+   * @param envIndices        Environment of each point
+   * @param viewportPositions Points on the viewport of the environment,
+   *    same size as @p envIndices
+   *
+   * Equivalent to calling @ref unproject(unsigned, const Magnum::Vector2i&)
+   * for each point, without the per-call overhead of the Python bindings.
+   */
+  std::vector<esp::geo::Ray> unproject(
+      const std::vector<unsigned>& envIndices,
+      const std::vector<Magnum::Vector2i>& viewportPositions);
+
+  /**
+   * @brief Pick the objects and depths at many viewport points at once
+   * @param envIndices        Environment of each point
+   * @param viewportPositions Points on the viewport of the environment
+   *    ([0,width), [0,height)), same size as @p envIndices
+   *
+   * Uses the output of the last @ref render(). Pixels of all queries are
+   * read back from the GPU in a single transfer instead of one per query.
+   * With several sensors per environment, the first sensor is picked from.
+   * Supported only by the batch renderer with
+   * @ref ReplayRendererConfiguration::enableSemanticOutput enabled, returns
+   * an empty vector otherwise.
+   */
+  std::vector<ReplayRendererPickResult> pick(
+      const std::vector<unsigned>& envIndices,
+      const std::vector<Magnum::Vector2i>& viewportPositions);
+
  protected:
   void checkEnvIndex(unsigned envIndex);
 
@@ -148,6 +275,9 @@ class AbstractReplayRenderer {
 
   virtual unsigned doEnvironmentCount() const = 0;
 
+  /* Default implementation returns 1 */
+  virtual unsigned doSensorCount() const;
+
   /* Retrieves a player instance for given environment. Used by
      setSensorTransformsFromKeyframe(). The envIndex is guaranteed to be in
      bounds. */
@@ -161,11 +291,17 @@ class AbstractReplayRenderer {
                                     const std::string& sensorName,
                                     const Magnum::Matrix4& transform) = 0;
 
+  /* transforms.size() is guaranteed to be same as doEnvironmentCount()
+     multiplied by doSensorCount() */
+  virtual void doSetSensorTransforms(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transforms) = 0;
+
   /* envIndex is guaranteed to be in bounds */
   virtual void doSetSensorTransformsFromKeyframe(unsigned envIndex,
                                                  const std::string& prefix) = 0;
 
-  /* imageViews.size() is guaranteed to be same as doEnvironmentCount() */
+  /* imageViews.size() is guaranteed to be same as doEnvironmentCount()
+     multiplied by doSensorCount() */
   virtual void doRender(
       Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
           colorImageViews,
@@ -177,6 +313,14 @@ class AbstractReplayRenderer {
   virtual esp::geo::Ray doUnproject(unsigned envIndex,
                                     const Mn::Vector2i& viewportPosition) = 0;
 
+  /* The views are guaranteed to have the same size, indices to be in bounds
+     and positions inside the sensor. Default implementation prints an error
+     and returns false. */
+  virtual bool doPick(
+      Corrade::Containers::ArrayView<const unsigned> envIndices,
+      Corrade::Containers::ArrayView<const Magnum::Vector2i> viewportPositions,
+      Corrade::Containers::ArrayView<ReplayRendererPickResult> results);
+
   ESP_SMART_POINTERS(AbstractReplayRenderer)
 };
 
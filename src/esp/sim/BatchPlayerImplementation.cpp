@@ -6,8 +6,12 @@
 
 #include <esp/gfx_batch/Renderer.h>
 
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StringStl.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace {
 bool isSupportedRenderAsset(const Corrade::Containers::StringView& filepath) {
   // Primitives aren't directly supported in the Magnum batch renderer. See
@@ -71,33 +75,105 @@ BatchPlayerImplementation::loadAndCreateRenderAssetInstance(
     CORRADE_INTERNAL_ASSERT(renderer_.hasNodeHierarchy(creation.filepath));
   }
 
-  return reinterpret_cast<gfx::replay::NodeHandle>(
-      renderer_.addNodeHierarchy(
-          sceneId_, creation.filepath,
-          /* Baking the initial scaling and coordinate frame into the
-             transformation */
-          Mn::Matrix4::scaling(creation.scale ? *creation.scale
-                                              : Mn::Vector3{1.0f}) *
-              Mn::Matrix4::from(
-                  Mn::Quaternion{assetInfo.frame.rotationFrameToWorld()}
-                      .toMatrix(),
-                  {}))
-      /* Returning incremented by 1 because 0 (nullptr) is treated as an
-         error */
-      + 1);
+  /* Baking the initial scaling and coordinate frame into the
+     transformation */
+  const Mn::Matrix4 bakeTransformation =
+      Mn::Matrix4::scaling(creation.scale ? *creation.scale
+                                          : Mn::Vector3{1.0f}) *
+      Mn::Matrix4::from(
+          Mn::Quaternion{assetInfo.frame.rotationFrameToWorld()}.toMatrix(),
+          {});
+
+  /* Reuse the hierarchy of a deleted instance of the same asset if there's
+     one, otherwise add a new one */
+  std::size_t node;  // NOLINT
+  std::vector<std::pair<Mn::Matrix4, std::size_t>>& pooled =
+      pooledNodes_[creation.filepath];
+  const auto found = std::find_if(
+      pooled.rbegin(), pooled.rend(),
+      [&](const std::pair<Mn::Matrix4, std::size_t>& pooledNode) {
+        return pooledNode.first == bakeTransformation;
+      });
+  if (found != pooled.rend()) {
+    node = found->second;
+    pooled.erase(std::next(found).base());
+    renderer_.transformations(sceneId_)[node] = Mn::Matrix4{};
+    renderer_.objectIds(sceneId_)[node] = 0;
+  } else {
+    node = renderer_.addNodeHierarchy(sceneId_, creation.filepath,
+                                      bakeTransformation);
+  }
+  liveNodes_[node] = PooledAsset{creation.filepath, bakeTransformation};
+
+  // Skinned instances get posed by the rig they reference, matching the rig
+  // bones to the skin joints by name
+  if (creation.rigId != ID_UNDEFINED) {
+    const auto found = rigs_.find(creation.rigId);
+    if (found == rigs_.end()) {
+      ESP_WARNING() << "Rig" << creation.rigId << "for" << creation.filepath
+                    << "not found, drawing it in its bind pose";
+    } else if (!renderer_.maxJointCount()) {
+      ESP_WARNING() << "Skinning is disabled in the batch renderer, drawing"
+                    << creation.filepath << "in its bind pose";
+    } else {
+      RigNode rigNode{node, {}};
+      rigNode.jointIds.reserve(found->second.boneNames.size());
+      for (const std::string& boneName : found->second.boneNames) {
+        rigNode.jointIds.push_back(
+            renderer_.jointId(creation.filepath, boneName));
+      }
+      found->second.nodes.push_back(std::move(rigNode));
+    }
+  }
+
+  // Returning incremented by 1 because 0 (nullptr) is treated as an error
+  return reinterpret_cast<gfx::replay::NodeHandle>(node + 1);
+}
+
+std::size_t BatchPlayerImplementation::pooledNodeCount() const {
+  std::size_t count = 0;
+  for (const auto& pooled : pooledNodes_) {
+    count += pooled.second.size();
+  }
+  return count;
+}
+
+void BatchPlayerImplementation::poolNode(const std::size_t node) {
+  const auto found = liveNodes_.find(node);
+  CORRADE_INTERNAL_ASSERT(found != liveNodes_.end());
+  // the batch renderer can't remove nodes, a zero scale hides the hierarchy
+  // until it's reused
+  renderer_.transformations(sceneId_)[node] = Mn::Matrix4{Mn::Math::ZeroInit};
+  pooledNodes_[found->second.filepath].emplace_back(
+      found->second.bakeTransformation, node);
+  liveNodes_.erase(found);
 }
 
 void BatchPlayerImplementation::deleteAssetInstance(
     const gfx::replay::NodeHandle node) {
-  // TODO actually remove from the scene instead of setting a zero scale
-  renderer_.transformations(sceneId_)[reinterpret_cast<std::size_t>(node) - 1] =
-      Mn::Matrix4{Mn::Math::ZeroInit};
+  const std::size_t nodeId = reinterpret_cast<std::size_t>(node) - 1;
+  poolNode(nodeId);
+  for (auto& rig : rigs_) {
+    auto& nodes = rig.second.nodes;
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(),
+                               [&](const RigNode& rigNode) {
+                                 return rigNode.node == nodeId;
+                               }),
+                nodes.end());
+  }
 }
 
 void BatchPlayerImplementation::deleteAssetInstances(
     const std::unordered_map<gfx::replay::RenderAssetInstanceKey,
                              gfx::replay::NodeHandle>&) {
-  renderer_.clear(sceneId_);
+  // keep the hierarchies for the next episode instead of clearing the scene
+  while (!liveNodes_.empty()) {
+    poolNode(liveNodes_.begin()->first);
+  }
+  renderer_.clearLights(sceneId_);
+  for (auto& rig : rigs_) {
+    rig.second.nodes.clear();
+  }
 }
 
 void BatchPlayerImplementation::setNodeTransform(
@@ -121,6 +197,35 @@ Mn::Matrix4 BatchPlayerImplementation::hackGetNodeTransform(
       sceneId_)[reinterpret_cast<std::size_t>(node) - 1];
 }
 
+void BatchPlayerImplementation::setNodeSemanticId(
+    const gfx::replay::NodeHandle node,
+    const unsigned id) {
+  // the IDs are only rendered with RendererFlag::ObjectId, but storing them
+  // is cheap so not checking that here
+  renderer_.objectIds(sceneId_)[reinterpret_cast<std::size_t>(node) - 1] = id;
+}
+
+void BatchPlayerImplementation::setNodeStates(
+    const Corrade::Containers::ArrayView<const gfx::replay::NodeHandle> nodes,
+    const Corrade::Containers::StridedArrayView1D<
+        const gfx::replay::RenderAssetInstanceState>& states) {
+  // write straight into the scene arrays instead of a virtual call per node
+  const Corrade::Containers::StridedArrayView1D<Mn::Matrix4> transformations =
+      renderer_.transformations(sceneId_);
+  const Corrade::Containers::StridedArrayView1D<Mn::UnsignedInt> objectIds =
+      renderer_.objectIds(sceneId_);
+  for (std::size_t i = 0; i != nodes.size(); ++i) {
+    if (!nodes[i]) {
+      continue;
+    }
+    const std::size_t nodeId = reinterpret_cast<std::size_t>(nodes[i]) - 1;
+    const gfx::replay::Transform& transform = states[i].absTransform;
+    transformations[nodeId] =
+        Mn::Matrix4::from(transform.rotation.toMatrix(), transform.translation);
+    objectIds[nodeId] = states[i].semanticId;
+  }
+}
+
 void BatchPlayerImplementation::changeLightSetup(
     const esp::gfx::LightSetup& lights) {
   if (!renderer_.maxLightCount()) {
@@ -135,7 +240,11 @@ void BatchPlayerImplementation::changeLightSetup(
     const gfx::LightInfo& light = lights[i];
     CORRADE_INTERNAL_ASSERT(light.model == gfx::LightPositionModel::Global);
 
-    const std::size_t nodeId = renderer_.addEmptyNode(sceneId_);
+    // the light nodes of earlier setups are reused, as nodes can't be removed
+    if (i == lightNodes_.size()) {
+      lightNodes_.push_back(renderer_.addEmptyNode(sceneId_));
+    }
+    const std::size_t nodeId = lightNodes_[i];
 
     std::size_t lightId;  // NOLINT
     if (light.vector.w()) {
@@ -167,19 +276,44 @@ void BatchPlayerImplementation::changeLightSetup(
 }
 
 void BatchPlayerImplementation::createRigInstance(
-    int,
-    const std::vector<std::string>&) {
-  // Not implemented.
+    int rigId,
+    const std::vector<std::string>& boneNames) {
+  ESP_CHECK(rigs_.find(rigId) == rigs_.end(),
+            "A rig instance with the specified ID already exists.");
+  rigs_[rigId] = Rig{boneNames, {}};
 }
 
-void BatchPlayerImplementation::deleteRigInstance(int) {
-  // Not implemented.
+void BatchPlayerImplementation::deleteRigInstance(int rigId) {
+  rigs_.erase(rigId);
 }
 
 void BatchPlayerImplementation::setRigPose(
-    int,
-    const std::vector<gfx::replay::Transform>&) {
-  // Not implemented.
+    int rigId,
+    const std::vector<gfx::replay::Transform>& pose) {
+  const auto found = rigs_.find(rigId);
+  if (found == rigs_.end()) {
+    return;
+  }
+
+  // The pose is in world space, the joint transformations are relative to
+  // the top-level node of each skinned instance, which is updated from the
+  // same keyframe before the rig poses
+  for (const RigNode& rigNode : found->second.nodes) {
+    const Mn::Matrix4 invNodeTransform =
+        renderer_.transformations(sceneId_)[rigNode.node].inverted();
+    Corrade::Containers::StridedArrayView1D<Mn::Matrix4> joints =
+        renderer_.jointTransformations(sceneId_, rigNode.node);
+    const std::size_t boneCount =
+        std::min(pose.size(), rigNode.jointIds.size());
+    for (std::size_t i = 0; i != boneCount; ++i) {
+      if (rigNode.jointIds[i] == -1) {
+        continue;
+      }
+      joints[rigNode.jointIds[i]] =
+          invNodeTransform * Mn::Matrix4::from(pose[i].rotation.toMatrix(),
+                                               pose[i].translation);
+    }
+  }
 }
 }  // namespace sim
 }  // namespace esp
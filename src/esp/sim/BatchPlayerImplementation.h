@@ -7,18 +7,40 @@
 
 #include <esp/gfx/replay/Player.h>
 
+#include <Magnum/Math/Matrix4.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace esp {
 namespace gfx_batch {
 class Renderer;
 }
 namespace sim {
 
+/**
+ * @brief @ref gfx::replay::Player backend drawing with a
+ * @ref gfx_batch::Renderer scene
+ *
+ * The batch renderer can't remove nodes from a scene, so deleted instances are
+ * hidden with a zero transformation and their node hierarchies are pooled.
+ * Instances of the same asset created later, also after the player is cleared
+ * for a new episode, reuse them instead of adding new hierarchies.
+ */
 class BatchPlayerImplementation
     : public gfx::replay::AbstractPlayerImplementation {
  public:
   BatchPlayerImplementation(gfx_batch::Renderer& renderer,
                             Mn::UnsignedInt sceneId);
 
+  /**
+   * @brief Number of pooled node hierarchies of deleted instances, waiting to
+   * be reused
+   */
+  std::size_t pooledNodeCount() const;
+
  private:
   gfx::replay::NodeHandle loadAndCreateRenderAssetInstance(
       const esp::assets::AssetInfo& assetInfo,
@@ -26,6 +48,8 @@ class BatchPlayerImplementation
 
   void deleteAssetInstance(gfx::replay::NodeHandle node) override;
 
+  bool canDeleteAssetInstance() const override { return true; }
+
   void deleteAssetInstances(
       const std::unordered_map<gfx::replay::RenderAssetInstanceKey,
                                gfx::replay::NodeHandle>&) override;
@@ -39,6 +63,13 @@ class BatchPlayerImplementation
 
   Mn::Matrix4 hackGetNodeTransform(gfx::replay::NodeHandle node) const override;
 
+  void setNodeSemanticId(gfx::replay::NodeHandle node, unsigned id) override;
+
+  void setNodeStates(
+      Corrade::Containers::ArrayView<const gfx::replay::NodeHandle> nodes,
+      const Corrade::Containers::StridedArrayView1D<
+          const gfx::replay::RenderAssetInstanceState>& states) override;
+
   void changeLightSetup(const esp::gfx::LightSetup& lights) override;
 
   void createRigInstance(int, const std::vector<std::string>&) override;
@@ -47,8 +78,38 @@ class BatchPlayerImplementation
 
   void setRigPose(int, const std::vector<gfx::replay::Transform>&) override;
 
+  // hide the node of a live instance and put it into the pool
+  void poolNode(std::size_t node);
+
   gfx_batch::Renderer& renderer_;
   Mn::UnsignedInt sceneId_;
+
+  // asset of a node hierarchy and the transformation baked into it, which
+  // both have to match for the hierarchy to be reused
+  struct PooledAsset {
+    std::string filepath;
+    Mn::Matrix4 bakeTransformation;
+  };
+  // top-level nodes of live instances
+  std::unordered_map<std::size_t, PooledAsset> liveNodes_;
+  // top-level nodes of deleted instances, per asset filepath
+  std::unordered_map<std::string,
+                     std::vector<std::pair<Mn::Matrix4, std::size_t>>>
+      pooledNodes_;
+  // nodes the lights are attached to, reused by changeLightSetup()
+  std::vector<std::size_t> lightNodes_;
+
+  // skinned hierarchy posed by a rig, with the joint ID of each rig bone or
+  // -1 if the skin doesn't have such joint
+  struct RigNode {
+    std::size_t node;
+    std::vector<int> jointIds;
+  };
+  struct Rig {
+    std::vector<std::string> boneNames;
+    std::vector<RigNode> nodes;
+  };
+  std::unordered_map<int, Rig> rigs_;
 };
 }  // namespace sim
 }  // namespace esp
@@ -6,37 +6,82 @@
 
 #include <esp/gfx_batch/DepthUnprojection.h>
 #include <esp/sim/BatchPlayerImplementation.h>
+#include "esp/core/Profiler.h"
 #include "esp/sensor/CameraSensor.h"
 
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Magnum/GL/AbstractFramebuffer.h>
 #include <Magnum/GL/Context.h>
+#include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
+
+#include <chrono>
 
 namespace esp {
 namespace sim {
 
 using namespace Mn::Math::Literals;  // NOLINT
 
+namespace {
+
+// Record the finished GPU draw durations of earlier frames and measure the
+// upcoming draw if GPU timers are enabled in the global profiler
+void profileGpuDraw(gfx_batch::Renderer& renderer) {
+  core::Profiler& profiler = core::Profiler::global();
+  while (const auto duration = renderer.takeGpuDrawDuration()) {
+    profiler.recordDuration("gpuDraw", std::chrono::nanoseconds{*duration});
+  }
+  renderer.setGpuTimerEnabled(profiler.isEnabled() &&
+                              profiler.isGpuTimersEnabled());
+}
+
+}  // namespace
+
 BatchReplayRenderer::BatchReplayRenderer(
     const ReplayRendererConfiguration& cfg,
-    gfx_batch::RendererConfiguration&& batchRendererConfiguration) {
+    gfx_batch::RendererConfiguration&& batchRendererConfiguration,
+    gfx_batch::RendererStandaloneConfiguration&& standaloneConfiguration) {
   if (Magnum::GL::Context::hasCurrent()) {
     flextGLInit(Magnum::GL::Context::current());  // TODO: Avoid globals
                                                   // duplications across SOs.
   }
-  CORRADE_ASSERT(cfg.sensorSpecifications.size() == 1,
-                 "BatchReplayRenderer: expecting exactly one sensor", );
-  const auto& sensor = static_cast<esp::sensor::CameraSensorSpec&>(
+  CORRADE_ASSERT(!cfg.sensorSpecifications.empty(),
+                 "BatchReplayRenderer: expecting at least one sensor", );
+  const auto& firstSensor = static_cast<esp::sensor::CameraSensorSpec&>(
       *cfg.sensorSpecifications.front());
+  for (const auto& spec : cfg.sensorSpecifications) {
+    const auto& sensor = static_cast<esp::sensor::CameraSensorSpec&>(*spec);
+    CORRADE_ASSERT(sensor.resolution == firstSensor.resolution,
+                   "BatchReplayRenderer: expecting all sensors to have the "
+                   "same resolution", );
+    arrayAppend(sensors_, SensorRecord{sensor.uuid, sensor.projectionMatrix()});
+  }
 
-  batchRendererConfiguration.setTileSizeCount(
-      Mn::Vector2i{sensor.resolution}.flipped(),
-      environmentGridSize(cfg.numEnvironments));
+  // Each sensor is a view of the environment's scene, rendered to a tile
+  // next to the other sensors of the same environment. The scene
+  // transformations are calculated and uploaded once for all of them.
+  const Mn::Vector2i environmentGrid =
+      environmentGridSize(cfg.numEnvironments);
+  batchRendererConfiguration
+      .setTileSizeCount(
+          Mn::Vector2i{firstSensor.resolution}.flipped(),
+          {environmentGrid.x() * int(sensors_.size()), environmentGrid.y()})
+      .setViewCount(sensors_.size());
+  if (cfg.enableFrustumCulling)
+    batchRendererConfiguration.addFlags(
+        gfx_batch::RendererFlag::FrustumCulling);
+  if (cfg.enableSemanticOutput)
+    batchRendererConfiguration.addFlags(gfx_batch::RendererFlag::ObjectId);
+  if (cfg.quantizeMeshes)
+    batchRendererConfiguration.addFlags(
+        gfx_batch::RendererFlag::QuantizeVertices);
+  batchRendererConfiguration.setMaxJointCount(cfg.maxJointCount);
   if ((standalone_ = cfg.standalone))
-    renderer_.emplace<gfx_batch::RendererStandalone>(
-        batchRendererConfiguration,
-        gfx_batch::RendererStandaloneConfiguration{});
+    renderer_.emplace<gfx_batch::RendererStandalone>(batchRendererConfiguration,
+                                                     standaloneConfiguration);
   else {
     CORRADE_ASSERT(Mn::GL::Context::hasCurrent(),
                    "BatchReplayRenderer: expecting a current GL context if a "
@@ -44,9 +89,6 @@ BatchReplayRenderer::BatchReplayRenderer(
     renderer_.emplace<gfx_batch::Renderer>(batchRendererConfiguration);
   }
 
-  theOnlySensorName_ = sensor.uuid;
-  theOnlySensorProjection_ = sensor.projectionMatrix();
-
   for (Mn::UnsignedInt i = 0; i != cfg.numEnvironments; ++i) {
     arrayAppend(
         envs_, EnvironmentRecord{
@@ -78,6 +120,10 @@ unsigned BatchReplayRenderer::doEnvironmentCount() const {
   return envs_.size();
 }
 
+unsigned BatchReplayRenderer::doSensorCount() const {
+  return sensors_.size();
+}
+
 Mn::Vector2i BatchReplayRenderer::doSensorSize(
     unsigned /* all environments have the same size */
 ) {
@@ -90,27 +136,55 @@ gfx::replay::Player& BatchReplayRenderer::doPlayerFor(unsigned envIndex) {
 
 void BatchReplayRenderer::doSetSensorTransform(
     unsigned envIndex,
-    // TODO assumes there's just one sensor per env
-    const std::string&,
+    const std::string& sensorName,
     const Mn::Matrix4& transform) {
-  renderer_->updateCamera(envIndex, theOnlySensorProjection_,
+  // With a single sensor the name isn't checked, for backwards compatibility
+  unsigned sensorIndex = 0;
+  if (sensors_.size() != 1) {
+    while (sensorIndex != sensors_.size() &&
+           sensors_[sensorIndex].name != sensorName)
+      ++sensorIndex;
+    ESP_CHECK(sensorIndex != sensors_.size(),
+              "setSensorTransform: unknown sensor \"" << sensorName << "\".");
+  }
+  renderer_->updateCamera(envIndex, sensorIndex,
+                          sensors_[sensorIndex].projection,
                           transform.inverted());
 }
 
+void BatchReplayRenderer::doSetSensorTransforms(
+    Cr::Containers::ArrayView<const Mn::Matrix4> transforms) {
+  // Tiles are ordered by environment and then by sensor, same as the
+  // transforms
+  Cr::Containers::Array<Mn::Matrix4> projections{Cr::NoInit,
+                                                 transforms.size()};
+  Cr::Containers::Array<Mn::Matrix4> views{Cr::NoInit, transforms.size()};
+  for (std::size_t i = 0; i != transforms.size(); ++i) {
+    projections[i] = sensors_[i % sensors_.size()].projection;
+    views[i] = transforms[i].inverted();
+  }
+  renderer_->updateCameras(projections, views);
+}
+
 void BatchReplayRenderer::doSetSensorTransformsFromKeyframe(
     unsigned envIndex,
     const std::string& prefix) {
   auto& env = envs_[envIndex];
-  std::string userName = prefix + theOnlySensorName_;
-  Mn::Vector3 translation;
-  Mn::Quaternion rotation;
-  bool found = env.player_.getUserTransform(userName, &translation, &rotation);
-  ESP_CHECK(found,
-            "setSensorTransformsFromKeyframe: couldn't find user transform \""
-                << userName << "\" for environment " << envIndex << ".");
-  renderer_->updateCamera(
-      envIndex, theOnlySensorProjection_,
-      Mn::Matrix4::from(rotation.toMatrix(), translation).inverted());
+  for (unsigned sensorIndex = 0; sensorIndex != sensors_.size();
+       ++sensorIndex) {
+    const SensorRecord& sensor = sensors_[sensorIndex];
+    std::string userName = prefix + sensor.name;
+    Mn::Vector3 translation;
+    Mn::Quaternion rotation;
+    bool found =
+        env.player_.getUserTransform(userName, &translation, &rotation);
+    ESP_CHECK(found,
+              "setSensorTransformsFromKeyframe: couldn't find user transform \""
+                  << userName << "\" for environment " << envIndex << ".");
+    renderer_->updateCamera(
+        envIndex, sensorIndex, sensor.projection,
+        Mn::Matrix4::from(rotation.toMatrix(), translation).inverted());
+  }
 }
 
 void BatchReplayRenderer::doRender(
@@ -120,30 +194,36 @@ void BatchReplayRenderer::doRender(
                  "BatchReplayRenderer::render(): can use this function only "
                  "with a standalone renderer", );
   auto& standalone = static_cast<gfx_batch::RendererStandalone&>(*renderer_);
+  profileGpuDraw(standalone);
   standalone.draw();
 
   // todo: integrate debugLineRender_->flushLines
   CORRADE_INTERNAL_ASSERT(!debugLineRender_);
 
-  for (int envIndex = 0; envIndex != envs_.size(); ++envIndex) {
+  // Tiles and images are both ordered by environment and then by sensor
+  const unsigned sensorCount = sensors_.size();
+  for (unsigned tileIndex = 0; tileIndex != envs_.size() * sensorCount;
+       ++tileIndex) {
     const auto rectangle = Mn::Range2Di::fromSize(
         renderer_->tileSize() *
-            Mn::Vector2i{envIndex % renderer_->tileCount().x(),
-                         envIndex / renderer_->tileCount().x()},
+            Mn::Vector2i(tileIndex % renderer_->tileCount().x(),
+                         tileIndex / renderer_->tileCount().x()),
         renderer_->tileSize());
 
     if (colorImageViews.size() > 0) {
-      standalone.colorImageInto(rectangle, colorImageViews[envIndex]);
+      standalone.colorImageInto(rectangle, colorImageViews[tileIndex]);
     }
     if (depthImageViews.size() > 0) {
       Mn::MutableImageView2D depthBufferView{
-          standalone.depthFramebufferFormat(), depthImageViews[envIndex].size(),
-          depthImageViews[envIndex].data()};
+          standalone.depthFramebufferFormat(),
+          depthImageViews[tileIndex].size(), depthImageViews[tileIndex].data()};
       standalone.depthImageInto(rectangle, depthBufferView);
 
       // TODO: Add GPU depth unprojection support.
-      gfx_batch::unprojectDepth(renderer_->cameraDepthUnprojection(envIndex),
-                                depthBufferView.pixels<Mn::Float>());
+      gfx_batch::unprojectDepth(
+          renderer_->cameraDepthUnprojection(tileIndex / sensorCount,
+                                             tileIndex % sensorCount),
+          depthBufferView.pixels<Mn::Float>());
     }
   }
 }
@@ -154,6 +234,7 @@ void BatchReplayRenderer::doRender(
                  "BatchReplayRenderer::render(): can't use this function with "
                  "a standalone renderer", );
 
+  profileGpuDraw(*renderer_);
   renderer_->draw(framebuffer);
 
   if (debugLineRender_) {
@@ -164,16 +245,108 @@ void BatchReplayRenderer::doRender(
   }
 }
 
+void BatchReplayRenderer::makeContextCurrent() {
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::makeContextCurrent(): can use this "
+                 "function only with a standalone renderer", );
+  static_cast<gfx_batch::RendererStandalone&>(*renderer_).makeContextCurrent();
+}
+
+void BatchReplayRenderer::releaseContext() {
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::releaseContext(): can use this function "
+                 "only with a standalone renderer", );
+  static_cast<gfx_batch::RendererStandalone&>(*renderer_).releaseContext();
+}
+
 esp::geo::Ray BatchReplayRenderer::doUnproject(
-    CORRADE_UNUSED unsigned envIndex,
+    unsigned envIndex,
     const Mn::Vector2i& viewportPosition) {
-  // temp stub implementation: produce a placeholder ray that varies with
-  // viewportPosition
-  return esp::geo::Ray(
-      {static_cast<float>(viewportPosition.x()) / renderer_->tileSize().x(),
-       0.5f,
-       static_cast<float>(viewportPosition.y()) / renderer_->tileSize().y()},
-      {0.f, -1.f, 0.f});
+  // same convention as gfx::RenderCamera::unproject(), with the viewport Y
+  // going down and the ray pointing to the far plane
+  const Mn::Vector2i tileSize = renderer_->tileSize();
+  const Mn::Vector2i viewPosition{viewportPosition.x(),
+                                  tileSize.y() - viewportPosition.y() - 1};
+  const Mn::Vector3 normalizedPosition{
+      2.0f * Mn::Vector2{viewPosition} / Mn::Vector2{tileSize} -
+          Mn::Vector2{1.0f},
+      1.0f};
+
+  const Mn::Matrix4 projectionView = renderer_->camera(envIndex);
+  const Mn::Matrix4 view =
+      renderer_->cameraProjection(envIndex).inverted() * projectionView;
+  const Mn::Vector3 origin = view.inverted().translation();
+  return esp::geo::Ray{
+      origin,
+      (projectionView.inverted().transformPoint(normalizedPosition) - origin)
+          .normalized()};
+}
+
+bool BatchReplayRenderer::doPick(
+    Cr::Containers::ArrayView<const unsigned> envIndices,
+    Cr::Containers::ArrayView<const Mn::Vector2i> viewportPositions,
+    Cr::Containers::ArrayView<ReplayRendererPickResult> results) {
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::pick(): can use this function only "
+                 "with a standalone renderer",
+                 false);
+  if (!(renderer_->flags() & gfx_batch::RendererFlag::ObjectId)) {
+    ESP_ERROR() << "Semantic output is not enabled, set "
+                   "ReplayRendererConfiguration::enableSemanticOutput.";
+    return false;
+  }
+  if (envIndices.isEmpty()) {
+    return true;
+  }
+  auto& standalone = static_cast<gfx_batch::RendererStandalone&>(*renderer_);
+
+  // Framebuffer pixel of each query, in the tile of the first sensor of its
+  // environment, and a rectangle covering all of them so everything gets
+  // read back at once
+  const Mn::Vector2i tileSize = renderer_->tileSize();
+  const Mn::Int tileCountX = renderer_->tileCount().x();
+  Cr::Containers::Array<Mn::Vector2i> pixels{Cr::NoInit, envIndices.size()};
+  Mn::Range2Di rectangle;
+  for (std::size_t i = 0; i != envIndices.size(); ++i) {
+    const Mn::Int tileIndex = Mn::Int(envIndices[i] * sensors_.size());
+    pixels[i] = tileSize * Mn::Vector2i{tileIndex % tileCountX,
+                                        tileIndex / tileCountX} +
+                Mn::Vector2i{viewportPositions[i].x(),
+                             tileSize.y() - viewportPositions[i].y() - 1};
+    const Mn::Range2Di pixel{pixels[i], pixels[i] + Mn::Vector2i{1}};
+    rectangle = i == 0 ? pixel : Mn::Math::join(rectangle, pixel);
+  }
+
+  Mn::Image2D objectIds{
+      standalone.objectIdFramebufferFormat(), rectangle.size(),
+      Cr::Containers::Array<char>{
+          Cr::NoInit, std::size_t(rectangle.size().product()) *
+                          Mn::pixelFormatSize(
+                              standalone.objectIdFramebufferFormat())}};
+  standalone.objectIdImageInto(rectangle, objectIds);
+  Mn::Image2D depth{
+      standalone.depthFramebufferFormat(), rectangle.size(),
+      Cr::Containers::Array<char>{
+          Cr::NoInit,
+          std::size_t(rectangle.size().product()) *
+              Mn::pixelFormatSize(standalone.depthFramebufferFormat())}};
+  standalone.depthImageInto(rectangle, depth);
+
+  const Cr::Containers::StridedArrayView2D<const Mn::UnsignedInt>
+      objectIdPixels = objectIds.pixels<Mn::UnsignedInt>();
+  const Cr::Containers::StridedArrayView2D<const Mn::Float> depthPixels =
+      depth.pixels<Mn::Float>();
+  for (std::size_t i = 0; i != envIndices.size(); ++i) {
+    const Mn::Vector2i position = pixels[i] - rectangle.min();
+    results[i].objectId = objectIdPixels[position.y()][position.x()];
+    Mn::Float pixelDepth = depthPixels[position.y()][position.x()];
+    gfx_batch::unprojectDepth(
+        renderer_->cameraDepthUnprojection(envIndices[i]),
+        Cr::Containers::StridedArrayView2D<Mn::Float>{
+            Cr::Containers::arrayView(&pixelDepth, 1), {1, 1}});
+    results[i].depth = pixelDepth;
+  }
+  return true;
 }
 
 const void* BatchReplayRenderer::getCudaColorBufferDevicePointer() {
@@ -207,5 +380,25 @@ const void* BatchReplayRenderer::getCudaDepthBufferDevicePointer() {
   return nullptr;
 #endif
 }
+
+const void* BatchReplayRenderer::getCudaSemanticBufferDevicePointer() {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "ReplayBatchRenderer::getCudaSemanticBufferDevicePointer(): "
+                 "can use this function only with a standalone renderer",
+                 nullptr);
+  if (!(renderer_->flags() & gfx_batch::RendererFlag::ObjectId)) {
+    ESP_ERROR() << "Semantic output is not enabled, set "
+                   "ReplayRendererConfiguration::enableSemanticOutput.";
+    return nullptr;
+  }
+  return static_cast<gfx_batch::RendererStandalone&>(*renderer_)
+      .objectIdCudaBufferDevicePointer();
+#else
+  ESP_ERROR() << "Failed to retrieve device pointer because CUDA is not "
+                 "available in this build.";
+  return nullptr;
+#endif
+}
 }  // namespace sim
 }  // namespace esp
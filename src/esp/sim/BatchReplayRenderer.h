@@ -20,7 +20,9 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
   explicit BatchReplayRenderer(
       const ReplayRendererConfiguration& cfg,
       gfx_batch::RendererConfiguration&& batchRendererConfiguration =
-          gfx_batch::RendererConfiguration{});
+          gfx_batch::RendererConfiguration{},
+      gfx_batch::RendererStandaloneConfiguration&& standaloneConfiguration =
+          gfx_batch::RendererStandaloneConfiguration{});
 
   ~BatchReplayRenderer() override;
 
@@ -28,7 +30,23 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
 
   const void* getCudaDepthBufferDevicePointer() override;
 
+  const void* getCudaSemanticBufferDevicePointer() override;
+
+  /**
+   * @brief Make the GPU context of the standalone renderer current on the
+   * calling thread, see @ref gfx_batch::RendererStandalone::makeContextCurrent
+   */
+  void makeContextCurrent();
+
+  /**
+   * @brief Release the GPU context of the standalone renderer from the calling
+   * thread
+   */
+  void releaseContext();
+
  private:
+  friend class ShardedBatchReplayRenderer;
+
   void doClose() override;
 
   void doCloseImpl();
@@ -37,6 +55,8 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
 
   unsigned doEnvironmentCount() const override;
 
+  unsigned doSensorCount() const override;
+
   Magnum::Vector2i doSensorSize(unsigned envIndex) override;
 
   esp::gfx::replay::Player& doPlayerFor(unsigned envIndex) override;
@@ -45,6 +65,10 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
                             const std::string& sensorName,
                             const Mn::Matrix4& transform) override;
 
+  void doSetSensorTransforms(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transforms)
+      override;
+
   void doSetSensorTransformsFromKeyframe(unsigned envIndex,
                                          const std::string& prefix) override;
 
@@ -58,6 +82,12 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
   esp::geo::Ray doUnproject(unsigned envIndex,
                             const Mn::Vector2i& viewportPosition) override;
 
+  bool doPick(
+      Corrade::Containers::ArrayView<const unsigned> envIndices,
+      Corrade::Containers::ArrayView<const Magnum::Vector2i> viewportPositions,
+      Corrade::Containers::ArrayView<ReplayRendererPickResult> results)
+      override;
+
   /* If standalone_ is true, renderer_ contains a RendererStandalone. Has to be
      before the EnvironmentRecord array because Player calls
      gfx_batch::Renderer::clear() on destruction. */
@@ -72,8 +102,13 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
   };
   Corrade::Containers::Array<EnvironmentRecord> envs_;
 
-  Corrade::Containers::String theOnlySensorName_;
-  Mn::Matrix4 theOnlySensorProjection_;
+  // Each sensor is a view of all environments, in the order of
+  // ReplayRendererConfiguration::sensorSpecifications
+  struct SensorRecord {
+    Corrade::Containers::String name;
+    Mn::Matrix4 projection;
+  };
+  Corrade::Containers::Array<SensorRecord> sensors_;
 
   ESP_SMART_POINTERS(BatchReplayRenderer)
 };
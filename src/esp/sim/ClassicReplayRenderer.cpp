@@ -7,14 +7,30 @@
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/metadata/MetadataMediator.h"
+#include "esp/nav/PathFinder.h"
 #include "esp/sensor/SensorFactory.h"
 
+#include <Corrade/Utility/FormatStl.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/ImageView.h>
 
 namespace esp {
 namespace sim {
 
+namespace {
+
+// instances with the same key are interchangeable
+std::string sharedInstanceKey(
+    const assets::RenderAssetInstanceCreationInfo& creation) {
+  const Mn::Vector3 scale =
+      creation.scale ? *creation.scale : Mn::Vector3{1.0f};
+  return Cr::Utility::formatString(
+      "{}|{}|{}|{} {} {}", creation.filepath, unsigned(creation.flags),
+      creation.lightSetupKey, scale.x(), scale.y(), scale.z());
+}
+
+}  // namespace
+
 ClassicReplayRenderer::ClassicReplayRenderer(
     const ReplayRendererConfiguration& cfg) {
   if (Magnum::GL::Context::hasCurrent()) {
@@ -28,6 +44,7 @@ ClassicReplayRenderer::ClassicReplayRenderer(
   auto metadataMediator = metadata::MetadataMediator::create(simConfig);
   resourceManager_ =
       std::make_unique<assets::ResourceManager>(std::move(metadataMediator));
+  resourceManager_->setQuantizeMeshes(cfg.quantizeMeshes);
 
   // hack to get ReplicaCAD non-baked stages to render correctly
   resourceManager_->getShaderManager().setFallback(
@@ -48,6 +65,16 @@ ClassicReplayRenderer::ClassicReplayRenderer(
       return self_.loadAndCreateRenderAssetInstance(envIdx_, assetInfo,
                                                     creation);
     }
+    void deleteAssetInstance(gfx::replay::NodeHandle node) override {
+      self_.deleteAssetInstance(envIdx_, node);
+    }
+    void deleteAssetInstances(
+        const std::unordered_map<gfx::replay::RenderAssetInstanceKey,
+                                 gfx::replay::NodeHandle>& instances) override {
+      for (const auto& pair : instances) {
+        self_.deleteAssetInstance(envIdx_, pair.second);
+      }
+    }
     void changeLightSetup(const gfx::LightSetup& lights) override {
       return self_.resourceManager_->setLightSetup(lights);
     }
@@ -118,6 +145,13 @@ ClassicReplayRenderer::ClassicReplayRenderer(
     envs_.push_back(std::move(e));
   }
 
+  // static instances, i.e. stages, are created once here for all environments
+  // instead of in each of their scene graphs
+  sharedSceneID_ = sceneManager_->initSceneGraph();
+  sharedSemanticSceneID_ = cfg.forceSeparateSemanticSceneGraph
+                               ? sceneManager_->initSceneGraph()
+                               : sharedSceneID_;
+
   // OpenGL context and renderer
   {
     if (config_.standalone) {
@@ -181,7 +215,10 @@ void ClassicReplayRenderer::doClose() {
 }
 
 void ClassicReplayRenderer::doCloseImpl() {
+  // deletes the overlay nodes, the scene graphs are still alive
+  navMeshOverlays_.clear();
   for (int envIdx = 0; envIdx < envs_.size(); ++envIdx) {
+    delete envs_[envIdx].navMeshNode_;
     envs_[envIdx].player_.close();
     auto& sensorMap = envs_[envIdx].sensorMap_;
     for (auto& sensorPair : sensorMap) {
@@ -190,6 +227,9 @@ void ClassicReplayRenderer::doCloseImpl() {
     envs_[envIdx].sensorMap_.clear();
   }
   envs_.clear();
+  // closing the players released all references to the shared instances
+  CORRADE_INTERNAL_ASSERT(sharedInstances_.empty());
+  sharedInstanceKeys_.clear();
   resourceManager_.reset();
   renderer_.reset();
   context_.reset();
@@ -229,6 +269,16 @@ void ClassicReplayRenderer::doSetSensorTransform(unsigned envIndex,
   sensor.node().setTransformation(transform);
 }
 
+void ClassicReplayRenderer::doSetSensorTransforms(
+    Cr::Containers::ArrayView<const Mn::Matrix4> transforms) {
+  const unsigned sensorCount = this->sensorCount();
+  for (unsigned i = 0; i != transforms.size(); ++i) {
+    doSetSensorTransform(
+        i / sensorCount,
+        config_.sensorSpecifications[i % sensorCount]->uuid, transforms[i]);
+  }
+}
+
 void ClassicReplayRenderer::doSetSensorTransformsFromKeyframe(
     unsigned envIndex,
     const std::string& prefix) {
@@ -286,6 +336,7 @@ void ClassicReplayRenderer::doRender(
 
       if (imageViews.size() > 0) {
         renderer_->enqueueAsyncDrawJob(visualSensor, sceneGraph,
+                                       getSharedSceneGraph(),
                                        imageViews[envIndex], flags);
       }
 #else
@@ -321,6 +372,8 @@ void ClassicReplayRenderer::doRender(
     auto& sceneGraph = getSceneGraph(envIndex);
 
     renderer_->draw(*visualSensor.getRenderCamera(), sceneGraph, flags);
+    renderer_->draw(*visualSensor.getRenderCamera(), getSharedSceneGraph(),
+                    flags);
 
     if (visualSensor.specification()->sensorType == sensor::SensorType::Color) {
       // include HBAO in Color sensors (only if enabled for render target)
@@ -374,6 +427,48 @@ esp::geo::Ray ClassicReplayRenderer::doUnproject(
                                                    /*normalized*/ true);
 }
 
+void ClassicReplayRenderer::setNavMeshVisualization(
+    unsigned envIndex,
+    const nav::PathFinder* pathFinder) {
+  ESP_CHECK(envIndex < envs_.size(),
+            "ClassicReplayRenderer::setNavMeshVisualization(): index"
+                << envIndex << "out of range for" << envs_.size()
+                << "environments");
+  auto& env = envs_[envIndex];
+  if (pathFinder && !pathFinder->isLoaded()) {
+    pathFinder = nullptr;
+  }
+
+  // stop showing a different NavMesh, dropping its overlay if no other
+  // environment shows it
+  if (env.navMeshNode_ && env.navMeshPathFinder_ != pathFinder) {
+    auto found = navMeshOverlays_.find(env.navMeshPathFinder_);
+    CORRADE_INTERNAL_ASSERT(found != navMeshOverlays_.end());
+    found->second->detach(*env.navMeshNode_);
+    if (found->second->attachmentCount() == 0) {
+      navMeshOverlays_.erase(found);
+    }
+    delete env.navMeshNode_;
+    env.navMeshNode_ = nullptr;
+    env.navMeshPathFinder_ = nullptr;
+  }
+  if (!pathFinder) {
+    return;
+  }
+
+  std::unique_ptr<NavMeshOverlay>& overlay = navMeshOverlays_[pathFinder];
+  if (!overlay) {
+    overlay = std::make_unique<NavMeshOverlay>(*resourceManager_);
+  }
+  overlay->update(*pathFinder);
+  if (!env.navMeshNode_) {
+    auto& sceneGraph = getSceneGraph(envIndex);
+    env.navMeshNode_ = &sceneGraph.getRootNode().createChild();
+    overlay->attach(*env.navMeshNode_, sceneGraph.getDrawables());
+    env.navMeshPathFinder_ = pathFinder;
+  }
+}
+
 esp::scene::SceneGraph& ClassicReplayRenderer::getSceneGraph(
     unsigned envIndex) {
   CORRADE_INTERNAL_ASSERT(envIndex < envs_.size());
@@ -390,6 +485,14 @@ esp::scene::SceneGraph& ClassicReplayRenderer::getSemanticSceneGraph(
                                           : env.semanticSceneID_);
 }
 
+esp::scene::SceneGraph& ClassicReplayRenderer::getSharedSceneGraph() {
+  return sceneManager_->getSceneGraph(sharedSceneID_);
+}
+
+esp::scene::SceneGraph& ClassicReplayRenderer::getSharedSemanticSceneGraph() {
+  return sceneManager_->getSceneGraph(sharedSemanticSceneID_);
+}
+
 gfx::replay::NodeHandle ClassicReplayRenderer::loadAndCreateRenderAssetInstance(
     unsigned envIndex,
     const assets::AssetInfo& assetInfo,
@@ -397,7 +500,32 @@ gfx::replay::NodeHandle ClassicReplayRenderer::loadAndCreateRenderAssetInstance(
   // Note this pattern of passing the scene manager and two scene ids to
   // resource manager. This is similar to ResourceManager::loadStage.
   CORRADE_INTERNAL_ASSERT(envIndex >= 0 && envIndex < envs_.size());
-  const auto& env = envs_[envIndex];
+  auto& env = envs_[envIndex];
+
+  // Static instances are shared by all environments, which saves their nodes,
+  // drawables and culling bounds for every environment but the first. An
+  // environment creating the same static instance twice gets its own copy for
+  // the second one.
+  if (creation.isStatic() && creation.rigId == ID_UNDEFINED) {
+    std::string key = sharedInstanceKey(creation);
+    auto found = sharedInstances_.find(key);
+    if (found == sharedInstances_.end()) {
+      std::vector<int> sharedIDs{sharedSceneID_, sharedSemanticSceneID_};
+      auto* node = resourceManager_->loadAndCreateRenderAssetInstance(
+          assetInfo, creation, sceneManager_.get(), sharedIDs);
+      if (node) {
+        sharedInstanceKeys_.emplace(node, key);
+        sharedInstances_.emplace(std::move(key), SharedInstance{node, 1});
+        env.sharedInstances_.insert(node);
+      }
+      return reinterpret_cast<gfx::replay::NodeHandle>(node);
+    }
+    if (env.sharedInstances_.insert(found->second.node).second) {
+      ++found->second.referenceCount;
+      return reinterpret_cast<gfx::replay::NodeHandle>(found->second.node);
+    }
+  }
+
   // perf todo: avoid dynamic mem alloc
   std::vector<int> tempIDs{env.sceneID_, env.semanticSceneID_};
   auto* node = resourceManager_->loadAndCreateRenderAssetInstance(
@@ -405,5 +533,24 @@ gfx::replay::NodeHandle ClassicReplayRenderer::loadAndCreateRenderAssetInstance(
   return reinterpret_cast<gfx::replay::NodeHandle>(node);
 }
 
+void ClassicReplayRenderer::deleteAssetInstance(
+    unsigned envIndex,
+    const gfx::replay::NodeHandle handle) {
+  CORRADE_INTERNAL_ASSERT(envIndex < envs_.size());
+  auto* node = reinterpret_cast<scene::SceneNode*>(handle);
+  if (envs_[envIndex].sharedInstances_.erase(node)) {
+    const auto key = sharedInstanceKeys_.find(node);
+    CORRADE_INTERNAL_ASSERT(key != sharedInstanceKeys_.end());
+    const auto shared = sharedInstances_.find(key->second);
+    CORRADE_INTERNAL_ASSERT(shared != sharedInstances_.end());
+    // other environments still draw it
+    if (--shared->second.referenceCount != 0)
+      return;
+    sharedInstances_.erase(shared);
+    sharedInstanceKeys_.erase(key);
+  }
+  delete node;
+}
+
 }  // namespace sim
 }  // namespace esp
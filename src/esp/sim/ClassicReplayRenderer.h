@@ -5,10 +5,14 @@
 #ifndef ESP_SIM_CLASSICBATCHRENDERER_H_
 #define ESP_SIM_CLASSICBATCHRENDERER_H_
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/sim/AbstractReplayRenderer.h"
+#include "esp/sim/NavMeshOverlay.h"
 
 namespace esp {
 namespace assets {
@@ -17,6 +21,9 @@ class ResourceManager;
 namespace gfx {
 class Renderer;
 }
+namespace nav {
+class PathFinder;
+}
 }  // namespace esp
 
 namespace esp {
@@ -38,6 +45,12 @@ class ClassicReplayRenderer : public AbstractReplayRenderer {
     esp::scene::SceneNode* sensorParentNode_ = nullptr;
     std::map<std::string, std::reference_wrapper<esp::sensor::Sensor>>
         sensorMap_;
+    // shared static instances referenced by this environment
+    std::unordered_set<const esp::scene::SceneNode*> sharedInstances_;
+    // NavMesh shown in this environment and the node its overlay is attached
+    // to, see setNavMeshVisualization()
+    const nav::PathFinder* navMeshPathFinder_ = nullptr;
+    esp::scene::SceneNode* navMeshNode_ = nullptr;
   };
 
   explicit ClassicReplayRenderer(const ReplayRendererConfiguration& cfg);
@@ -51,6 +64,42 @@ class ClassicReplayRenderer : public AbstractReplayRenderer {
   esp::scene::SceneGraph& getSceneGraph(unsigned envIndex);
   esp::scene::SceneGraph& getSemanticSceneGraph(unsigned envIndex);
 
+  /**
+   * @brief Scene graph of the static instances shared by all environments
+   *
+   * Instances created with
+   * @ref assets::RenderAssetInstanceCreationInfo::Flag::IsStatic, i.e. stages,
+   * are created just once for all environments that load the same asset with
+   * the same creation parameters, and drawn with the sensor of each of them.
+   * The per-environment scene graphs returned by @ref getSceneGraph() contain
+   * only the dynamic instances. As static instances are never moved, they're
+   * assumed to be placed the same in all environments.
+   */
+  esp::scene::SceneGraph& getSharedSceneGraph();
+
+  /**
+   * @brief Semantic scene graph of the static instances shared by all
+   * environments
+   *
+   * Same as @ref getSharedSceneGraph() unless
+   * @ref ReplayRendererConfiguration::forceSeparateSemanticSceneGraph is set.
+   */
+  esp::scene::SceneGraph& getSharedSemanticSceneGraph();
+
+  /** @brief Count of static instances shared by the environments */
+  std::size_t sharedInstanceCount() const { return sharedInstances_.size(); }
+
+  /**
+   * @brief Show the NavMesh of @p pathFinder in an environment
+   *
+   * Replays don't record the NavMesh, so it's supplied by the caller.
+   * Environments showing the same PathFinder share one @ref NavMeshOverlay.
+   * Call again after the NavMesh changed to upload just the changed tiles.
+   * Passing nullptr or an unloaded PathFinder hides the NavMesh.
+   */
+  void setNavMeshVisualization(unsigned envIndex,
+                               const nav::PathFinder* pathFinder);
+
   esp::scene::SceneNode* getEnvironmentSensorParentNode(
       unsigned envIndex) const;
   std::map<std::string, std::reference_wrapper<esp::sensor::Sensor>>&
@@ -74,6 +123,10 @@ class ClassicReplayRenderer : public AbstractReplayRenderer {
                             const std::string& sensorName,
                             const Mn::Matrix4& transform) override;
 
+  void doSetSensorTransforms(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transforms)
+      override;
+
   void doSetSensorTransformsFromKeyframe(unsigned envIndex,
                                          const std::string& prefix) override;
 
@@ -89,10 +142,30 @@ class ClassicReplayRenderer : public AbstractReplayRenderer {
       const assets::AssetInfo& assetInfo,
       const assets::RenderAssetInstanceCreationInfo& creation);
 
+  void deleteAssetInstance(unsigned envIndex, gfx::replay::NodeHandle node);
+
+  struct SharedInstance {
+    esp::scene::SceneNode* node;
+    // count of environments referencing the instance
+    unsigned referenceCount;
+  };
+
   std::vector<EnvironmentRecord> envs_;
 
+  int sharedSceneID_ = ID_UNDEFINED;
+  int sharedSemanticSceneID_ = ID_UNDEFINED;
+  // shared static instances, keyed by the asset and the creation parameters
+  std::unordered_map<std::string, SharedInstance> sharedInstances_;
+  std::unordered_map<const esp::scene::SceneNode*, std::string>
+      sharedInstanceKeys_;
+
   std::unique_ptr<assets::ResourceManager> resourceManager_;
 
+  // overlays of the NavMeshes shown in any environment, they own primitives
+  // of resourceManager_
+  std::unordered_map<const nav::PathFinder*, std::unique_ptr<NavMeshOverlay>>
+      navMeshOverlays_;
+
   scene::SceneManager::uptr sceneManager_ = nullptr;
 
   gfx::WindowlessContext::uptr context_ = nullptr;
@@ -0,0 +1,145 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "NavMeshOverlay.h"
+
+#include <Corrade/Utility/Assert.h>
+
+#include <algorithm>
+
+#include "esp/assets/MeshData.h"
+#include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
+#include "esp/nav/PathFinder.h"
+#include "esp/scene/SceneNode.h"
+
+namespace esp {
+namespace sim {
+
+NavMeshOverlay::NavMeshOverlay(assets::ResourceManager& resourceManager)
+    : resourceManager_{resourceManager} {}
+
+NavMeshOverlay::~NavMeshOverlay() {
+  while (!attachments_.empty()) {
+    detach(*attachments_.back().parent);
+  }
+  for (std::size_t i = 0; i != tiles_.size(); ++i) {
+    releaseTile(i);
+  }
+}
+
+int NavMeshOverlay::update(const nav::PathFinder& pathFinder) {
+  const std::vector<std::uint64_t> revisions =
+      pathFinder.getNavMeshTileRevisions();
+
+  // slots beyond the new tile count are gone
+  for (std::size_t i = revisions.size(); i < tiles_.size(); ++i) {
+    for (Attachment& attachment : attachments_) {
+      delete attachment.tileNodes[i];
+    }
+    releaseTile(i);
+  }
+  tiles_.resize(revisions.size());
+  for (Attachment& attachment : attachments_) {
+    attachment.tileNodes.resize(revisions.size(), nullptr);
+  }
+
+  int uploaded = 0;
+  for (std::size_t i = 0; i != revisions.size(); ++i) {
+    Tile& tile = tiles_[i];
+    if (tile.revision == revisions[i]) {
+      continue;
+    }
+    for (Attachment& attachment : attachments_) {
+      delete attachment.tileNodes[i];
+      attachment.tileNodes[i] = nullptr;
+    }
+    releaseTile(i);
+    tile.revision = revisions[i];
+    if (revisions[i] == 0) {
+      continue;
+    }
+
+    const assets::MeshData::ptr meshData =
+        pathFinder.getNavMeshTileData(static_cast<int>(i));
+    if (meshData) {
+      tile.primitiveId = resourceManager_.createNavMeshVisualizationPrimitive(
+          *meshData, &tile.bounds);
+    }
+    if (tile.primitiveId != ID_UNDEFINED) {
+      ++uploaded;
+      for (Attachment& attachment : attachments_) {
+        attachTile(attachment, i);
+      }
+    }
+  }
+
+  if (uploaded) {
+    for (Attachment& attachment : attachments_) {
+      attachment.parent->computeCumulativeBB();
+    }
+  }
+  return uploaded;
+}
+
+void NavMeshOverlay::attach(scene::SceneNode& parent,
+                            gfx::DrawableGroup& drawables) {
+  ESP_CHECK(std::none_of(attachments_.begin(), attachments_.end(),
+                         [&](const Attachment& attachment) {
+                           return attachment.parent == &parent;
+                         }),
+            "NavMeshOverlay::attach(): already attached to this node");
+  attachments_.push_back({&parent, &drawables, {}});
+  Attachment& attachment = attachments_.back();
+  attachment.tileNodes.resize(tiles_.size(), nullptr);
+  for (std::size_t i = 0; i != tiles_.size(); ++i) {
+    attachTile(attachment, i);
+  }
+  parent.computeCumulativeBB();
+}
+
+void NavMeshOverlay::detach(scene::SceneNode& parent, const bool deleteNodes) {
+  auto found = std::find_if(attachments_.begin(), attachments_.end(),
+                            [&](const Attachment& attachment) {
+                              return attachment.parent == &parent;
+                            });
+  if (found == attachments_.end()) {
+    return;
+  }
+  if (deleteNodes) {
+    for (scene::SceneNode* node : found->tileNodes) {
+      delete node;
+    }
+  }
+  attachments_.erase(found);
+}
+
+std::size_t NavMeshOverlay::tileMeshCount() const {
+  return std::count_if(tiles_.begin(), tiles_.end(), [](const Tile& tile) {
+    return tile.primitiveId != ID_UNDEFINED;
+  });
+}
+
+void NavMeshOverlay::attachTile(Attachment& attachment, const std::size_t tile) {
+  CORRADE_INTERNAL_ASSERT(attachment.tileNodes[tile] == nullptr);
+  if (tiles_[tile].primitiveId == ID_UNDEFINED) {
+    return;
+  }
+  scene::SceneNode& node = attachment.parent->createChild();
+  resourceManager_.addPrimitiveToDrawables(tiles_[tile].primitiveId, node,
+                                           attachment.drawables);
+  node.setMeshBB(tiles_[tile].bounds);
+  attachment.tileNodes[tile] = &node;
+}
+
+void NavMeshOverlay::releaseTile(const std::size_t tile) {
+  if (tiles_[tile].primitiveId != ID_UNDEFINED) {
+    resourceManager_.removePrimitiveMesh(tiles_[tile].primitiveId);
+    tiles_[tile].primitiveId = ID_UNDEFINED;
+  }
+  tiles_[tile].revision = 0;
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,119 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_NAVMESHOVERLAY_H_
+#define ESP_SIM_NAVMESHOVERLAY_H_
+
+#include <Magnum/Math/Range.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace assets {
+class ResourceManager;
+}
+namespace gfx {
+class DrawableGroup;
+}
+namespace nav {
+class PathFinder;
+}
+namespace scene {
+class SceneNode;
+}
+namespace sim {
+
+/**
+ * @brief Line visualization of a NavMesh that is kept on the GPU
+ *
+ * Holds one line mesh per NavMesh tile, keyed by the tile revisions of
+ * @ref nav::PathFinder::getNavMeshTileRevisions(). An @ref update() after
+ * @ref nav::PathFinder::rebuildTiles() re-uploads just the replaced tiles,
+ * and the meshes stay cached while the overlay isn't attached anywhere, so
+ * toggling the visualization doesn't rebuild anything. The same overlay can
+ * be attached to several scene graphs, such as the environments of a
+ * @ref ClassicReplayRenderer, sharing the meshes.
+ */
+class NavMeshOverlay {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * The meshes are owned by @p resourceManager as primitives, which has to
+   * outlive the overlay.
+   */
+  explicit NavMeshOverlay(assets::ResourceManager& resourceManager);
+
+  /** @brief Destructor. Detaches from all nodes and releases the meshes. */
+  ~NavMeshOverlay();
+
+  NavMeshOverlay(const NavMeshOverlay&) = delete;
+  NavMeshOverlay& operator=(const NavMeshOverlay&) = delete;
+
+  /**
+   * @brief Bring the meshes up to date with the NavMesh of @p pathFinder
+   * @return Count of tile meshes uploaded
+   *
+   * Only tiles whose revision differs from the last update are uploaded and
+   * replaced in all attached nodes. An unloaded @p pathFinder clears the
+   * overlay.
+   */
+  int update(const nav::PathFinder& pathFinder);
+
+  /**
+   * @brief Draw the overlay as children of @p parent in @p drawables
+   *
+   * Expects that the overlay isn't attached to @p parent yet. The children
+   * are owned by @p parent; if it gets deleted first, call @ref detach() with
+   * it before the next @ref update().
+   */
+  void attach(scene::SceneNode& parent, gfx::DrawableGroup& drawables);
+
+  /**
+   * @brief Stop drawing the overlay under @p parent
+   *
+   * Deletes the children created by @ref attach() unless @p deleteNodes is
+   * false, which is for parents already being destroyed. Does nothing if the
+   * overlay isn't attached to @p parent.
+   */
+  void detach(scene::SceneNode& parent, bool deleteNodes = true);
+
+  /** @brief Count of nodes the overlay is attached to */
+  std::size_t attachmentCount() const { return attachments_.size(); }
+
+  /** @brief Count of tiles with a mesh */
+  std::size_t tileMeshCount() const;
+
+ private:
+  struct Tile {
+    std::uint64_t revision = 0;
+    int primitiveId = ID_UNDEFINED;
+    Magnum::Range3D bounds;
+  };
+
+  struct Attachment {
+    scene::SceneNode* parent;
+    gfx::DrawableGroup* drawables;
+    // child of parent drawing each tile, nullptr for tiles without a mesh
+    std::vector<scene::SceneNode*> tileNodes;
+  };
+
+  void attachTile(Attachment& attachment, std::size_t tile);
+
+  void releaseTile(std::size_t tile);
+
+  assets::ResourceManager& resourceManager_;
+  std::vector<Tile> tiles_;
+  std::vector<Attachment> attachments_;
+
+  ESP_SMART_POINTERS(NavMeshOverlay)
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_NAVMESHOVERLAY_H_
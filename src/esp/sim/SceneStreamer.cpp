@@ -0,0 +1,112 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SceneStreamer.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sim {
+
+SceneStreamer::SceneStreamer(const float cellSize) : cellSize_{cellSize} {
+  CORRADE_ASSERT(cellSize > 0.0f,
+                 "SceneStreamer: expected a positive cell size, got"
+                     << cellSize, );
+}
+
+std::int64_t SceneStreamer::cellKey(const Mn::Vector2i& coordinates) {
+  return std::int64_t(
+      (std::uint64_t(std::uint32_t(coordinates.x())) << 32) |
+      std::uint32_t(coordinates.y()));
+}
+
+std::size_t SceneStreamer::addInstance(const Mn::Vector3& position) {
+  const Mn::Vector2i coordinates{Mn::Math::floor(position.xz() / cellSize_)};
+  const std::int64_t key = cellKey(coordinates);
+  auto found = cellIndices_.find(key);
+  if (found == cellIndices_.end()) {
+    found = cellIndices_.emplace(key, cells_.size()).first;
+    cells_.emplace_back();
+    cells_.back().coordinates = coordinates;
+  }
+  const std::size_t instance = instanceCells_.size();
+  cells_[found->second].instances.push_back(instance);
+  instanceCells_.push_back(found->second);
+  return instance;
+}
+
+std::size_t SceneStreamer::loadedCellCount() const {
+  return std::count_if(cells_.begin(), cells_.end(), [](const Cell& cell) {
+    return cell.state == CellState::Loaded;
+  });
+}
+
+bool SceneStreamer::isLoaded(const std::size_t instance) const {
+  CORRADE_ASSERT(instance < instanceCells_.size(),
+                 "SceneStreamer::isLoaded(): index" << instance
+                                                    << "out of range for"
+                                                    << instanceCells_.size()
+                                                    << "instances",
+                 false);
+  return cells_[instanceCells_[instance]].state == CellState::Loaded;
+}
+
+float SceneStreamer::distance(const Cell& cell,
+                              const Mn::Vector3& viewer) const {
+  const Mn::Vector2 min = Mn::Vector2{cell.coordinates} * cellSize_;
+  const Mn::Vector2 max = min + Mn::Vector2{cellSize_};
+  const Mn::Vector2 closest = Mn::Math::clamp(viewer.xz(), min, max);
+  return (viewer.xz() - closest).length();
+}
+
+SceneStreamer::Update SceneStreamer::update(
+    const std::vector<Mn::Vector3>& viewers,
+    const float loadRadius) {
+  const float prefetchRadius = loadRadius + cellSize_;
+  const float unloadRadius = loadRadius + 2.0f * cellSize_;
+
+  Update result;
+  for (Cell& cell : cells_) {
+    float closest = std::numeric_limits<float>::infinity();
+    for (const Mn::Vector3& viewer : viewers) {
+      closest = Mn::Math::min(closest, distance(cell, viewer));
+    }
+
+    std::vector<std::size_t>* changed = nullptr;
+    if (cell.state != CellState::Loaded && closest <= loadRadius) {
+      cell.state = CellState::Loaded;
+      changed = &result.load;
+    } else if (cell.state == CellState::Unloaded && closest <= prefetchRadius) {
+      cell.state = CellState::Prefetched;
+      changed = &result.prefetch;
+    } else if (cell.state != CellState::Unloaded && closest > unloadRadius) {
+      // a prefetched cell going out of range is prefetched again on return
+      if (cell.state == CellState::Loaded) {
+        changed = &result.unload;
+      }
+      cell.state = CellState::Unloaded;
+    }
+    if (changed) {
+      changed->insert(changed->end(), cell.instances.begin(),
+                      cell.instances.end());
+    }
+  }
+  return result;
+}
+
+void SceneStreamer::clear() {
+  for (Cell& cell : cells_) {
+    cell.state = CellState::Unloaded;
+  }
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,117 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_SCENESTREAMER_H_
+#define ESP_SIM_SCENESTREAMER_H_
+
+/** @file
+ * @brief Class @ref esp::sim::SceneStreamer
+ */
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Spatial partition deciding which instances of a streamed scene are
+ * loaded.
+ *
+ * Instances are binned by their position into square cells of a grid on the
+ * horizontal XZ plane. Every @ref update() compares the cells to the viewer
+ * positions and reports the instances of cells that have to be loaded,
+ * unloaded or prefetched. A cell is loaded once any viewer is within the load
+ * radius of it and unloaded only once all viewers are more than two cells
+ * beyond it, so a viewer moving along a cell border doesn't make the cell
+ * load and unload every step. Cells one cell beyond the load radius are
+ * reported for prefetching so their assets are read before they're needed.
+ *
+ * The class only does the bookkeeping, loading and unloading the instances is
+ * up to the caller, see @ref Simulator::updateSceneStreaming().
+ */
+class SceneStreamer {
+ public:
+  /** @brief Instances to change the state of, returned by @ref update() */
+  struct Update {
+    /** @brief Instances of cells that came within the load radius */
+    std::vector<std::size_t> load;
+    /** @brief Instances of loaded cells all viewers went away from */
+    std::vector<std::size_t> unload;
+    /** @brief Instances of cells close to the load radius, reported once */
+    std::vector<std::size_t> prefetch;
+  };
+
+  /**
+   * @brief Constructor
+   * @param cellSize  Edge length of the grid cells, in meters. Expected to be
+   *    positive.
+   */
+  explicit SceneStreamer(float cellSize);
+
+  /** @brief Cell edge length */
+  float cellSize() const { return cellSize_; }
+
+  /**
+   * @brief Add an instance at @p position
+   * @return Index of the instance, counting from zero in the order added
+   *
+   * The instance starts unloaded.
+   */
+  std::size_t addInstance(const Magnum::Vector3& position);
+
+  /** @brief Number of added instances */
+  std::size_t instanceCount() const { return instanceCells_.size(); }
+
+  /** @brief Number of non-empty cells */
+  std::size_t cellCount() const { return cells_.size(); }
+
+  /** @brief Number of loaded cells */
+  std::size_t loadedCellCount() const;
+
+  /** @brief Whether the cell of instance @p instance is loaded */
+  bool isLoaded(std::size_t instance) const;
+
+  /**
+   * @brief Update the cell states for new viewer positions
+   * @param viewers     Positions of the viewers, e.g. the agents
+   * @param loadRadius  Cells closer than this to any viewer get loaded
+   *
+   * Instances of each cell are listed in the order they were added. Without
+   * any viewers all loaded cells are unloaded.
+   */
+  Update update(const std::vector<Magnum::Vector3>& viewers, float loadRadius);
+
+  /** @brief Mark all cells unloaded, e.g. once the scene is gone */
+  void clear();
+
+ private:
+  enum class CellState : Magnum::UnsignedByte { Unloaded, Prefetched, Loaded };
+
+  struct Cell {
+    Magnum::Vector2i coordinates;
+    std::vector<std::size_t> instances;
+    CellState state = CellState::Unloaded;
+  };
+
+  static std::int64_t cellKey(const Magnum::Vector2i& coordinates);
+
+  // distance on the XZ plane from viewer to the closest point of the cell
+  float distance(const Cell& cell, const Magnum::Vector3& viewer) const;
+
+  float cellSize_;
+  std::vector<Cell> cells_;
+  std::unordered_map<std::int64_t, std::size_t> cellIndices_;
+  std::vector<std::size_t> instanceCells_;
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_SCENESTREAMER_H_
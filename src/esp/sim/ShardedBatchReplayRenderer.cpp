@@ -0,0 +1,308 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ShardedBatchReplayRenderer.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/ImageView.h>
+
+#include "esp/core/Check.h"
+#include "esp/core/Logging.h"
+#include "esp/core/ParallelFor.h"
+
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#include "HelperCuda.h"
+#endif
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sim {
+
+ShardedBatchReplayRenderer::ShardedBatchReplayRenderer(
+    const ReplayRendererConfiguration& cfg,
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> cudaDevices,
+    const gfx_batch::RendererConfiguration& batchRendererConfiguration) {
+  ESP_CHECK(cfg.standalone,
+            "ShardedBatchReplayRenderer: the shards can only use standalone "
+            "renderers");
+  ESP_CHECK(!cudaDevices.isEmpty(),
+            "ShardedBatchReplayRenderer: expecting at least one CUDA device");
+  ESP_CHECK(cfg.numEnvironments >= int(cudaDevices.size()),
+            "ShardedBatchReplayRenderer: can't split" << cfg.numEnvironments
+                << "environments across" << cudaDevices.size() << "devices");
+
+  const unsigned shardCount = cudaDevices.size();
+  const unsigned minShardSize = cfg.numEnvironments / shardCount;
+  const unsigned numLargerShards = cfg.numEnvironments % shardCount;
+  unsigned environmentOffset = 0;
+  for (unsigned i = 0; i != shardCount; ++i) {
+    ReplayRendererConfiguration shardConfig = cfg;
+    shardConfig.numEnvironments = minShardSize + (i < numLargerShards ? 1 : 0);
+    shardConfig.gpuDeviceId = cudaDevices[i];
+
+    // the new renderer makes its context current on construction
+    arrayAppend(shards_,
+                Shard{Cr::Containers::Pointer<BatchReplayRenderer>{
+                          new BatchReplayRenderer{
+                              shardConfig,
+                              gfx_batch::RendererConfiguration{
+                                  batchRendererConfiguration},
+                              gfx_batch::RendererStandaloneConfiguration{}
+                                  .setCudaDevice(cudaDevices[i])}},
+                      cudaDevices[i], environmentOffset});
+    currentShard_ = i;
+    environmentOffset += shardConfig.numEnvironments;
+  }
+  environmentCount_ = environmentOffset;
+  sensorCount_ = cfg.sensorSpecifications.size();
+}
+
+ShardedBatchReplayRenderer::~ShardedBatchReplayRenderer() {
+  doClose();
+}
+
+Mn::UnsignedInt ShardedBatchReplayRenderer::shardCudaDevice(
+    const unsigned shard) const {
+  ESP_CHECK(shard < shards_.size(),
+            "ShardedBatchReplayRenderer: shard" << shard << "out of range for"
+                                                << shards_.size() << "shards");
+  return shards_[shard].cudaDevice;
+}
+
+unsigned ShardedBatchReplayRenderer::shardEnvironmentOffset(
+    const unsigned shard) const {
+  ESP_CHECK(shard < shards_.size(),
+            "ShardedBatchReplayRenderer: shard" << shard << "out of range for"
+                                                << shards_.size() << "shards");
+  return shards_[shard].environmentOffset;
+}
+
+unsigned ShardedBatchReplayRenderer::shardEnvironmentCount(
+    const unsigned shard) const {
+  ESP_CHECK(shard < shards_.size(),
+            "ShardedBatchReplayRenderer: shard" << shard << "out of range for"
+                                                << shards_.size() << "shards");
+  return shards_[shard].renderer->environmentCount();
+}
+
+BatchReplayRenderer& ShardedBatchReplayRenderer::useShard(
+    const unsigned shard) {
+  ESP_CHECK(shard < shards_.size(),
+            "ShardedBatchReplayRenderer: shard" << shard << "out of range for"
+                                                << shards_.size() << "shards");
+  if (currentShard_ != int(shard)) {
+    shards_[shard].renderer->makeContextCurrent();
+    currentShard_ = shard;
+  }
+  return *shards_[shard].renderer;
+}
+
+BatchReplayRenderer& ShardedBatchReplayRenderer::useShardFor(
+    unsigned& envIndex) {
+  // shards are few and ordered by their first environment
+  unsigned shard = shards_.size() - 1;
+  while (shards_[shard].environmentOffset > envIndex) {
+    --shard;
+  }
+  envIndex -= shards_[shard].environmentOffset;
+  return useShard(shard);
+}
+
+void ShardedBatchReplayRenderer::releaseCurrentShard() {
+  if (currentShard_ != -1) {
+    shards_[currentShard_].renderer->releaseContext();
+    currentShard_ = -1;
+  }
+}
+
+const void* ShardedBatchReplayRenderer::getCudaColorBufferDevicePointer(
+    const unsigned shard) {
+  BatchReplayRenderer& renderer = useShard(shard);
+#ifdef ESP_BUILD_WITH_CUDA
+  checkCudaErrors(cudaSetDevice(shards_[shard].cudaDevice));
+#endif
+  return renderer.getCudaColorBufferDevicePointer();
+}
+
+const void* ShardedBatchReplayRenderer::getCudaDepthBufferDevicePointer(
+    const unsigned shard) {
+  BatchReplayRenderer& renderer = useShard(shard);
+#ifdef ESP_BUILD_WITH_CUDA
+  checkCudaErrors(cudaSetDevice(shards_[shard].cudaDevice));
+#endif
+  return renderer.getCudaDepthBufferDevicePointer();
+}
+
+const void* ShardedBatchReplayRenderer::getCudaSemanticBufferDevicePointer(
+    const unsigned shard) {
+  BatchReplayRenderer& renderer = useShard(shard);
+#ifdef ESP_BUILD_WITH_CUDA
+  checkCudaErrors(cudaSetDevice(shards_[shard].cudaDevice));
+#endif
+  return renderer.getCudaSemanticBufferDevicePointer();
+}
+
+const void* ShardedBatchReplayRenderer::getCudaColorBufferDevicePointer() {
+  if (shards_.size() != 1) {
+    ESP_ERROR() << "The color buffer is split across" << shards_.size()
+                << "devices, retrieve the pointer of each shard instead.";
+    return nullptr;
+  }
+  return getCudaColorBufferDevicePointer(0);
+}
+
+const void* ShardedBatchReplayRenderer::getCudaDepthBufferDevicePointer() {
+  if (shards_.size() != 1) {
+    ESP_ERROR() << "The depth buffer is split across" << shards_.size()
+                << "devices, retrieve the pointer of each shard instead.";
+    return nullptr;
+  }
+  return getCudaDepthBufferDevicePointer(0);
+}
+
+const void* ShardedBatchReplayRenderer::getCudaSemanticBufferDevicePointer() {
+  if (shards_.size() != 1) {
+    ESP_ERROR() << "The semantic buffer is split across" << shards_.size()
+                << "devices, retrieve the pointer of each shard instead.";
+    return nullptr;
+  }
+  return getCudaSemanticBufferDevicePointer(0);
+}
+
+void ShardedBatchReplayRenderer::doClose() {
+  // the GL resources of each shard are destroyed with its context current
+  for (unsigned i = 0; i != shards_.size(); ++i) {
+    useShard(i).close();
+    currentShard_ = -1;
+  }
+  shards_ = {};
+  environmentCount_ = 0;
+}
+
+void ShardedBatchReplayRenderer::doPreloadFile(
+    Cr::Containers::StringView filename) {
+  for (unsigned i = 0; i != shards_.size(); ++i) {
+    useShard(i).preloadFile(filename);
+  }
+}
+
+unsigned ShardedBatchReplayRenderer::doEnvironmentCount() const {
+  return environmentCount_;
+}
+
+unsigned ShardedBatchReplayRenderer::doSensorCount() const {
+  return sensorCount_;
+}
+
+Mn::Vector2i ShardedBatchReplayRenderer::doSensorSize(unsigned envIndex) {
+  return useShardFor(envIndex).sensorSize(envIndex);
+}
+
+gfx::replay::Player& ShardedBatchReplayRenderer::doPlayerFor(
+    unsigned envIndex) {
+  return useShardFor(envIndex).doPlayerFor(envIndex);
+}
+
+void ShardedBatchReplayRenderer::doSetSensorTransform(
+    unsigned envIndex,
+    const std::string& sensorName,
+    const Mn::Matrix4& transform) {
+  useShardFor(envIndex).setSensorTransform(envIndex, sensorName, transform);
+}
+
+void ShardedBatchReplayRenderer::doSetSensorTransforms(
+    Cr::Containers::ArrayView<const Mn::Matrix4> transforms) {
+  // transforms of all sensors of an environment are next to each other
+  for (unsigned i = 0; i != shards_.size(); ++i) {
+    const unsigned first = shards_[i].environmentOffset * sensorCount_;
+    const unsigned last =
+        first + shards_[i].renderer->environmentCount() * sensorCount_;
+    useShard(i).setSensorTransforms(transforms.slice(first, last));
+  }
+}
+
+void ShardedBatchReplayRenderer::doSetSensorTransformsFromKeyframe(
+    unsigned envIndex,
+    const std::string& prefix) {
+  useShardFor(envIndex).setSensorTransformsFromKeyframe(envIndex, prefix);
+}
+
+void ShardedBatchReplayRenderer::doRender(
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
+  // each shard gets its context current on one of the worker threads
+  releaseCurrentShard();
+  core::parallelFor(
+      shards_.size(), shards_.size(), [&](std::size_t i, int) {
+        Shard& shard = shards_[i];
+        // images of all sensors of an environment are next to each other
+        const unsigned first = shard.environmentOffset * sensorCount_;
+        const unsigned last =
+            first + shard.renderer->environmentCount() * sensorCount_;
+        shard.renderer->makeContextCurrent();
+        shard.renderer->render(
+            colorImageViews.isEmpty() ? colorImageViews
+                                      : colorImageViews.slice(first, last),
+            depthImageViews.isEmpty() ? depthImageViews
+                                      : depthImageViews.slice(first, last));
+        shard.renderer->releaseContext();
+      });
+}
+
+void ShardedBatchReplayRenderer::doRender(Mn::GL::AbstractFramebuffer&) {
+  CORRADE_ASSERT_UNREACHABLE(
+      "ShardedBatchReplayRenderer::render(): can't render into a framebuffer, "
+      "the shards are standalone renderers", );
+}
+
+esp::geo::Ray ShardedBatchReplayRenderer::doUnproject(
+    unsigned envIndex,
+    const Mn::Vector2i& viewportPosition) {
+  return useShardFor(envIndex).unproject(envIndex, viewportPosition);
+}
+
+bool ShardedBatchReplayRenderer::doPick(
+    Cr::Containers::ArrayView<const unsigned> envIndices,
+    Cr::Containers::ArrayView<const Mn::Vector2i> viewportPositions,
+    Cr::Containers::ArrayView<ReplayRendererPickResult> results) {
+  // queries of each shard are picked together, with a single readback
+  Cr::Containers::Array<unsigned> shardEnvIndices;
+  Cr::Containers::Array<Mn::Vector2i> shardViewportPositions;
+  Cr::Containers::Array<std::size_t> shardQueries;
+  Cr::Containers::Array<ReplayRendererPickResult> shardResults;
+  for (unsigned shard = 0; shard != shards_.size(); ++shard) {
+    const unsigned first = shards_[shard].environmentOffset;
+    const unsigned last = first + shards_[shard].renderer->environmentCount();
+    arrayResize(shardEnvIndices, 0);
+    arrayResize(shardViewportPositions, 0);
+    arrayResize(shardQueries, 0);
+    for (std::size_t i = 0; i != envIndices.size(); ++i) {
+      if (envIndices[i] >= first && envIndices[i] < last) {
+        arrayAppend(shardEnvIndices, envIndices[i] - first);
+        arrayAppend(shardViewportPositions, viewportPositions[i]);
+        arrayAppend(shardQueries, i);
+      }
+    }
+    if (shardQueries.isEmpty()) {
+      continue;
+    }
+
+    arrayResize(shardResults, Cr::NoInit, shardQueries.size());
+    if (!useShard(shard).doPick(shardEnvIndices, shardViewportPositions,
+                                shardResults)) {
+      return false;
+    }
+    for (std::size_t i = 0; i != shardQueries.size(); ++i) {
+      results[shardQueries[i]] = shardResults[i];
+    }
+  }
+  return true;
+}
+
+}  // namespace sim
+}  // namespace esp
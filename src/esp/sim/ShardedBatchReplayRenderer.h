@@ -0,0 +1,173 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_SHARDEDBATCHREPLAYRENDERER_H_
+#define ESP_SIM_SHARDEDBATCHREPLAYRENDERER_H_
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pointer.h>
+
+#include "esp/sim/BatchReplayRenderer.h"
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Batch replay renderer with the environments sharded across GPUs
+ *
+ * Creates one standalone @ref BatchReplayRenderer per CUDA device, each
+ * drawing a contiguous range of the environments into its own tile grid
+ * (see @ref environmentGridSize). @ref render() draws and reads back all
+ * shards in parallel threads. Color and depth outputs of each shard are
+ * available on the device of the shard through @ref
+ * getCudaColorBufferDevicePointer(unsigned) and @ref
+ * getCudaDepthBufferDevicePointer(unsigned).
+ *
+ * Each shard has its own GPU context, the functions make the context of the
+ * shard they use current on the calling thread.
+ */
+class ShardedBatchReplayRenderer : public AbstractReplayRenderer {
+ public:
+  /**
+   * @brief Constructor
+   * @param cfg                         Configuration,
+   *    @ref ReplayRendererConfiguration::numEnvironments are split across
+   *    the shards and @ref ReplayRendererConfiguration::standalone is
+   *    expected to be set
+   * @param cudaDevices                 CUDA device of each shard. The same
+   *    device may be listed more than once.
+   * @param batchRendererConfiguration  Configuration of the renderer of each
+   *    shard, the tile size and count are set by each shard
+   *
+   * The environments are split as evenly as possible, the first shards get
+   * one more environment if the count isn't divisible by the shard count.
+   */
+  explicit ShardedBatchReplayRenderer(
+      const ReplayRendererConfiguration& cfg,
+      Corrade::Containers::ArrayView<const Magnum::UnsignedInt> cudaDevices,
+      const gfx_batch::RendererConfiguration& batchRendererConfiguration =
+          gfx_batch::RendererConfiguration{});
+
+  ~ShardedBatchReplayRenderer() override;
+
+  /** @brief Number of shards */
+  unsigned shardCount() const { return shards_.size(); }
+
+  /** @brief CUDA device of a shard */
+  Magnum::UnsignedInt shardCudaDevice(unsigned shard) const;
+
+  /** @brief Index of the first environment drawn by a shard */
+  unsigned shardEnvironmentOffset(unsigned shard) const;
+
+  /** @brief Number of environments drawn by a shard */
+  unsigned shardEnvironmentCount(unsigned shard) const;
+
+  /**
+   * @brief Color output of the last @ref render() of a shard as a CUDA
+   * device pointer on @ref shardCudaDevice(), see @ref
+   * gfx_batch::RendererStandalone::colorCudaBufferDevicePointer()
+   */
+  const void* getCudaColorBufferDevicePointer(unsigned shard);
+
+  /**
+   * @brief Depth output of the last @ref render() of a shard as a CUDA
+   * device pointer on @ref shardCudaDevice(), see @ref
+   * gfx_batch::RendererStandalone::depthCudaBufferDevicePointer()
+   */
+  const void* getCudaDepthBufferDevicePointer(unsigned shard);
+
+  /**
+   * @brief Semantic ID output of the last @ref render() of a shard as a CUDA
+   * device pointer on @ref shardCudaDevice(), see @ref
+   * gfx_batch::RendererStandalone::objectIdCudaBufferDevicePointer()
+   */
+  const void* getCudaSemanticBufferDevicePointer(unsigned shard);
+
+  /**
+   * @brief Color output of the only shard. Fails if there is more than one
+   * shard, use @ref getCudaColorBufferDevicePointer(unsigned) then.
+   */
+  const void* getCudaColorBufferDevicePointer() override;
+
+  /**
+   * @brief Depth output of the only shard. Fails if there is more than one
+   * shard, use @ref getCudaDepthBufferDevicePointer(unsigned) then.
+   */
+  const void* getCudaDepthBufferDevicePointer() override;
+
+  /**
+   * @brief Semantic ID output of the only shard. Fails if there is more than
+   * one shard, use @ref getCudaSemanticBufferDevicePointer(unsigned) then.
+   */
+  const void* getCudaSemanticBufferDevicePointer() override;
+
+ private:
+  void doClose() override;
+
+  void doPreloadFile(Corrade::Containers::StringView filename) override;
+
+  unsigned doEnvironmentCount() const override;
+
+  unsigned doSensorCount() const override;
+
+  Magnum::Vector2i doSensorSize(unsigned envIndex) override;
+
+  esp::gfx::replay::Player& doPlayerFor(unsigned envIndex) override;
+
+  void doSetSensorTransform(unsigned envIndex,
+                            const std::string& sensorName,
+                            const Mn::Matrix4& transform) override;
+
+  void doSetSensorTransforms(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transforms)
+      override;
+
+  void doSetSensorTransformsFromKeyframe(unsigned envIndex,
+                                         const std::string& prefix) override;
+
+  void doRender(Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+                    colorImageViews,
+                Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+                    depthImageViews) override;
+
+  void doRender(Magnum::GL::AbstractFramebuffer& framebuffer) override;
+
+  esp::geo::Ray doUnproject(unsigned envIndex,
+                            const Mn::Vector2i& viewportPosition) override;
+
+  bool doPick(
+      Corrade::Containers::ArrayView<const unsigned> envIndices,
+      Corrade::Containers::ArrayView<const Magnum::Vector2i> viewportPositions,
+      Corrade::Containers::ArrayView<ReplayRendererPickResult> results)
+      override;
+
+  // makes the context of a shard current on the calling thread and returns
+  // the shard
+  BatchReplayRenderer& useShard(unsigned shard);
+
+  // makes the context of the shard drawing an environment current and
+  // returns the shard, with envIndex changed to the index in the shard
+  BatchReplayRenderer& useShardFor(unsigned& envIndex);
+
+  void releaseCurrentShard();
+
+  struct Shard {
+    Corrade::Containers::Pointer<BatchReplayRenderer> renderer;
+    Magnum::UnsignedInt cudaDevice;
+    unsigned environmentOffset;
+  };
+  Corrade::Containers::Array<Shard> shards_;
+  unsigned environmentCount_ = 0;
+  unsigned sensorCount_ = 0;
+  // shard whose context is current on the calling thread, -1 if none
+  int currentShard_ = -1;
+
+  ESP_SMART_POINTERS(ShardedBatchReplayRenderer)
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif
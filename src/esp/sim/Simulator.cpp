@@ -4,10 +4,14 @@
 
 #include "Simulator.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
@@ -15,10 +19,16 @@
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Renderer.h>
 
+#include "esp/assets/MeshData.h"
+#include "esp/assets/SharedAssetPool.h"
+#include "esp/assets/SharedMemoryAssetStore.h"
 #include "esp/core/Esp.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/Profiler.h"
 #include "esp/gfx/CubeMapCamera.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/PbrDrawable.h"
+#include "esp/gfx/PbrShader.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/replay/Recorder.h"
@@ -31,6 +41,7 @@
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/scene/ObjectControls.h"
+#include "esp/scene/SemanticScene.h"
 #include "esp/sensor/CameraSensor.h"
 #include "esp/sensor/SensorFactory.h"
 #include "esp/sensor/VisualSensor.h"
@@ -46,6 +57,93 @@ using metadata::attributes::SceneObjectInstanceAttributes;
 using metadata::attributes::SemanticAttributes;
 using metadata::attributes::StageAttributes;
 
+namespace {
+// profiled phases of reconfigure() reported by getSceneLoadPerfStatValues(),
+// with the names of the stats
+constexpr const char* SceneLoadPerfStatSections[][2]{
+    {"reconfigure", "reconfigure ms"},
+    {"loadMetadata", "load metadata ms"},
+    {"importAsset", "import assets ms"},
+    {"uploadAsset", "upload assets ms"},
+    {"createCollisionShapes", "create collision shapes ms"},
+    {"loadNavMesh", "load navmesh ms"},
+    {"loadSemanticScene", "load semantic scene ms"}};
+
+// stores how long each phase ran during the lifetime of the instance, the
+// phases may run many times, e.g. once per asset
+class SceneLoadPerfStats {
+ public:
+  explicit SceneLoadPerfStats(std::vector<float>& values) : values_{values} {
+    const core::Profiler& profiler = core::Profiler::global();
+    if (!profiler.isEnabled()) {
+      return;
+    }
+    for (const auto& section : SceneLoadPerfStatSections) {
+      beginMs_.push_back(profiler.stats(section[0]).totalMs);
+    }
+  }
+
+  ~SceneLoadPerfStats() {
+    values_.assign(Cr::Containers::arraySize(SceneLoadPerfStatSections), 0.0f);
+    if (beginMs_.empty()) {
+      return;
+    }
+    const core::Profiler& profiler = core::Profiler::global();
+    for (std::size_t i = 0; i != values_.size(); ++i) {
+      const char* section = SceneLoadPerfStatSections[i][0];
+      values_[i] = float(profiler.stats(section).totalMs - beginMs_[i]);
+    }
+  }
+
+ private:
+  std::vector<float>& values_;
+  std::vector<double> beginMs_;
+};
+
+// estimated memory of a configuration tree, subconfigurations already in seen
+// are skipped so ones shared between copy-on-write templates count once
+std::size_t configurationByteSize(
+    const core::config::Configuration& config,
+    std::unordered_set<const core::config::Configuration*>& seen) {
+  if (!seen.insert(&config).second) {
+    return 0;
+  }
+  std::size_t size = sizeof(config);
+  const auto values = config.getValuesIterator();
+  for (auto it = values.first; it != values.second; ++it) {
+    size += sizeof(*it) + core::heapByteSize(it->first);
+    if (it->second.getType() == core::config::ConfigValType::String) {
+      size += core::heapByteSize(it->second.get<std::string>());
+    }
+  }
+  const auto subconfigs = config.getSubconfigIterator();
+  for (auto it = subconfigs.first; it != subconfigs.second; ++it) {
+    size += sizeof(*it) + core::heapByteSize(it->first) +
+            configurationByteSize(*it->second, seen);
+  }
+  return size;
+}
+
+template <class Manager>
+std::size_t attributesByteSize(
+    const std::shared_ptr<Manager>& manager,
+    std::unordered_set<const core::config::Configuration*>& seen) {
+  std::size_t size = 0;
+  if (!manager) {
+    return size;
+  }
+  for (const auto& attributes : manager->getObjectsByHandleSubstring()) {
+    size += configurationByteSize(*attributes.second, seen);
+  }
+  return size;
+}
+
+template <class T>
+std::size_t sharedVectorByteSize(const std::vector<std::shared_ptr<T>>& v) {
+  return v.capacity() * sizeof(std::shared_ptr<T>) + v.size() * sizeof(T);
+}
+}  // namespace
+
 Simulator::Simulator(const SimulatorConfiguration& cfg,
                      metadata::MetadataMediator::ptr _metadataMediator)
     : metadataMediator_{std::move(_metadataMediator)},
@@ -64,11 +162,15 @@ Simulator::~Simulator() {
 
 void Simulator::close(const bool destroy) {
   getRenderGLContext();
+  asyncObservationAgentId_ = ID_UNDEFINED;
+  asyncObservations_.clear();
 
   pathfinder_ = nullptr;
-  navMeshVisPrimID_ = esp::ID_UNDEFINED;
+  // releases its meshes, so has to go before the resource manager
+  navMeshOverlay_ = nullptr;
   navMeshVisNode_ = nullptr;
   agents_.clear();
+  agentPolyRefs_.clear();
 
   physicsManager_ = nullptr;
   curSceneInstanceAttributes_ = nullptr;
@@ -88,9 +190,15 @@ void Simulator::close(const bool destroy) {
 
   // Keeping the renderer and the context only matters when the
   // background renderer was initialized.
-  if (destroy || !renderer_->wasBackgroundRendererInitialized()) {
+  // A pooled context is always given back, reacquiring it is cheap.
+  if (destroy || contextPooled_ ||
+      !renderer_->wasBackgroundRendererInitialized()) {
     renderer_ = nullptr;
+    if (context_ && contextPooled_) {
+      gfx::WindowlessContext::releaseToPool(std::move(context_));
+    }
     context_ = nullptr;
+    contextPooled_ = false;
   }
 
   activeSceneID_ = ID_UNDEFINED;
@@ -103,6 +211,8 @@ void Simulator::close(const bool destroy) {
 }
 
 void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
+  const SceneLoadPerfStats sceneLoadPerfStats{sceneLoadPerfStatValues_};
+  ESP_PROFILE_SCOPE("reconfigure");
 // Fail early if physics is enabled in config but no bullet support is
 // installed.
 #ifndef ESP_BUILD_WITH_BULLET
@@ -115,10 +225,13 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 #endif
 
   // set metadata mediator's cfg  upon creation or reconfigure
-  if (!metadataMediator_) {
-    metadataMediator_ = metadata::MetadataMediator::create(cfg);
-  } else {
-    metadataMediator_->setSimulatorConfiguration(cfg);
+  {
+    ESP_PROFILE_SCOPE("loadMetadata");
+    if (!metadataMediator_) {
+      metadataMediator_ = metadata::MetadataMediator::create(cfg);
+    } else {
+      metadataMediator_->setSimulatorConfiguration(cfg);
+    }
   }
 
   // assign MM to RM on create or reconfigure
@@ -160,6 +273,33 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
     config_.requiresTextures = false;
   }
 
+  resourceManager_->setNumAssetDecodeThreads(config_.numAssetDecodeThreads);
+  resourceManager_->setAssetCacheBudget(config_.assetCacheBudget);
+  resourceManager_->setSemanticMeshCacheDirectory(
+      config_.semanticMeshCacheDirectory);
+  resourceManager_->setClusterSemanticMeshes(config_.clusterSemanticMeshes);
+  resourceManager_->setPackTextureArrays(config_.packTextureArrays);
+  resourceManager_->setOptimizeMeshes(config_.optimizeMeshes);
+  resourceManager_->setQuantizeMeshes(config_.quantizeMeshes);
+  resourceManager_->setOptimizedMeshCacheDirectory(
+      config_.optimizedMeshCacheDirectory);
+  resourceManager_->setIBLMapCacheDirectory(config_.iblMapCacheDirectory);
+  resourceManager_->setCollisionBvhCacheDirectory(
+      config_.collisionBvhCacheDirectory);
+  // an unchanged store keeps what it already mapped
+  const std::shared_ptr<assets::SharedMemoryAssetStore>& sharedMemoryStore =
+      resourceManager_->getSharedMemoryAssetStore();
+  if (config_.sharedAssetMemoryDirectory.empty()) {
+    resourceManager_->setSharedMemoryAssetStore(nullptr);
+  } else if (!sharedMemoryStore || sharedMemoryStore->directory() !=
+                                       config_.sharedAssetMemoryDirectory) {
+    resourceManager_->setSharedMemoryAssetStore(
+        assets::SharedMemoryAssetStore::create(
+            config_.sharedAssetMemoryDirectory));
+  }
+  gfx::PbrShader::setProgramBinaryCacheDirectory(
+      config_.shaderProgramCacheDirectory);
+
   if (requiresTextures_ == Cr::Containers::NullOpt) {
     requiresTextures_ = config_.requiresTextures;
     resourceManager_->setRequiresTextures(config_.requiresTextures);
@@ -176,8 +316,21 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
     /* When creating a viewer based app, there is no need to create a
     WindowlessContext since a (windowed) context already exists. */
     if (!context_ && !Magnum::GL::Context::hasCurrent()) {
-      context_ = gfx::WindowlessContext::create_unique(config_.gpuDeviceId);
+      if (config_.poolGlContexts) {
+        context_ = gfx::WindowlessContext::acquirePooled(
+            config_.gpuDeviceId, config_.shareGpuResources);
+        contextPooled_ = true;
+      } else {
+        context_ =
+            config_.shareGpuResources
+                ? gfx::WindowlessContext::createShared(config_.gpuDeviceId)
+                : gfx::WindowlessContext::create_unique(config_.gpuDeviceId);
+      }
     }
+    // resources can be shared only with contexts in the same share group
+    resourceManager_->setSharedAssetPool(
+        context_ && context_->isShared() ? assets::SharedAssetPool::global()
+                                         : nullptr);
 
     // reinitialize members
     if (!renderer_) {
@@ -199,6 +352,14 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
         flags |= gfx::Renderer::Flag::HorizonBasedAmbientOcclusion;
       }
 
+      if (config_.enableDepthPrePass) {
+        flags |= gfx::Renderer::Flag::DepthPrePass;
+      }
+
+      if (config_.skipUnchangedFrames) {
+        flags |= gfx::Renderer::Flag::SkipUnchangedFrames;
+      }
+
       renderer_ = gfx::Renderer::create(context_.get(), flags);
     }
 #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -239,8 +400,11 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   // This will retrieve, or construct, an appropriately configured scene
   // instance attributes, depending on what exists in the Scene Dataset library
   // for the current dataset.
-  curSceneInstanceAttributes_ =
-      metadataMediator_->getSceneInstanceAttributesByName(activeSceneName);
+  {
+    ESP_PROFILE_SCOPE("loadMetadata");
+    curSceneInstanceAttributes_ =
+        metadataMediator_->getSceneInstanceAttributesByName(activeSceneName);
+  }
 
   // check if attributes is null - should not happen
   ESP_CHECK(
@@ -268,8 +432,11 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
                      "maps to handle :"
                   << navmeshFileHandle;
     } else if (Cr::Utility::Path::exists(navmeshFileLoc)) {
+      ESP_PROFILE_SCOPE("loadNavMesh");
       ESP_DEBUG() << "Loading navmesh from" << navmeshFileLoc;
-      bool pfSuccess = pathfinder_->loadNavMesh(navmeshFileLoc);
+      bool pfSuccess = config_.mapNavMeshFile
+                           ? pathfinder_->loadNavMeshMapped(navmeshFileLoc)
+                           : pathfinder_->loadNavMesh(navmeshFileLoc);
       ESP_DEBUG() << (pfSuccess ? "Navmesh Loaded." : "Navmesh load error.");
     } else {
       ESP_WARNING(Mn::Debug::Flag::NoSpace)
@@ -290,6 +457,9 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
     recorder->onHideSceneGraph(sceneManager_->getSceneGraph(activeSceneID_));
   }
 
+  // assets loaded or instanced from here on are used by the new scene
+  resourceManager_->beginAssetCacheScene();
+
   // initialize scene graph CAREFUL! previous scene graph is not deleted!
   // TODO:
   // We need to make a design decision here:
@@ -339,7 +509,10 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
         << "` which did not reference any attributes";
   }
   // - Load semantic scene
-  resourceManager_->loadSemanticScene(semanticAttr, activeSceneName);
+  {
+    ESP_PROFILE_SCOPE("loadSemanticScene");
+    resourceManager_->loadSemanticScene(semanticAttr, activeSceneName);
+  }
 
   // 4. Specify frustumCulling based on value from config
   frustumCulling_ = config_.frustumCulling;
@@ -429,9 +602,32 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
         // TODO : reset may eventually have all the scene instantiation code so
         // that scenes can be reset
         reset();
+        // instance the streamed objects around the agents' start positions
+        updateSceneStreaming();
+      }
+    }
+  }
+
+  // The previous scene's instances and physics world are gone, so assets only
+  // it used can be unloaded if the cache is over budget. The previous scene
+  // graphs are kept though, so drop their drawables referencing the assets
+  // first.
+  if (resourceManager_->getAssetCacheBudget() != 0) {
+    // the navmesh visualization owns its drawables, which are in a previous
+    // scene graph now
+    if (navMeshVisNode_ != nullptr) {
+      navMeshOverlay_->detach(*navMeshVisNode_);
+      delete navMeshVisNode_;
+      navMeshVisNode_ = nullptr;
+    }
+    for (int sceneID = 0; sceneID != int(sceneManager_->getSceneGraphCount());
+         ++sceneID) {
+      if (sceneID != activeSceneID_ && sceneID != activeSemanticSceneID_) {
+        sceneManager_->getSceneGraph(sceneID).deleteDrawables();
       }
     }
   }
+  resourceManager_->evictUnusedAssets();
 
   return success;
 }  // Simulator::createSceneInstance
@@ -603,6 +799,12 @@ bool Simulator::instanceStageForSceneAttributes(
 bool Simulator::instanceObjectsForSceneAttributes(
     const metadata::attributes::SceneInstanceAttributes::cptr&
         curSceneInstanceAttributes_) {
+  // Objects streamed into the previous scene went away with it
+  sceneStreamer_ = nullptr;
+  streamedObjectInstances_.clear();
+  streamedObjectHandles_.clear();
+  streamedObjectIds_.clear();
+
   // Load object instances as specified by Scene Instance Attributes.
   // Get copies of all instances of objects described in scene
   const std::vector<SceneObjectInstanceAttributes::cptr> objectInstances =
@@ -617,8 +819,10 @@ bool Simulator::instanceObjectsForSceneAttributes(
       (curSceneInstanceAttributes_->getTranslationOrigin() ==
        metadata::attributes::SceneInstanceTranslationOrigin::AssetLocal);
 
-  // Iterate through instances, create object and implement initial
-  // transformation.
+  // Resolve the handles of all instances, then create all objects and
+  // implement their initial transformations as a single batch.
+  std::vector<std::string> objAttrFullHandles;
+  objAttrFullHandles.reserve(objectInstances.size());
   for (const auto& objInst : objectInstances) {
     // check if attributes is null - should not happen
     ESP_CHECK(
@@ -639,14 +843,92 @@ bool Simulator::instanceObjectsForSceneAttributes(
                   ":{} failed due to object instance configuration handle '{}' "
                   "being empty or unknown. Aborting",
                   config_.activeSceneName, objInst->getHandle()));
-    // objID =
-    physicsManager_->addObjectInstance(
-        objInst, objAttrFullHandle, defaultCOMCorrection, &getDrawableGroup(),
-        attachmentNode, config_.sceneLightSetupKey);
+    objAttrFullHandles.emplace_back(objAttrFullHandle);
   }  // for each object attributes
+
+  // When streaming, objects are instanced cell by cell by
+  // updateSceneStreaming() once the agents are placed
+  if (config_.sceneStreamingCellSize > 0.0f) {
+    sceneStreamer_ =
+        std::make_unique<SceneStreamer>(config_.sceneStreamingCellSize);
+    for (const auto& objInst : objectInstances) {
+      sceneStreamer_->addInstance(objInst->getTranslation());
+    }
+    streamedObjectInstances_ = objectInstances;
+    streamedObjectHandles_ = std::move(objAttrFullHandles);
+    streamedObjectIds_.assign(objectInstances.size(), ID_UNDEFINED);
+    streamedObjectCOMCorrection_ = defaultCOMCorrection;
+    ESP_DEBUG() << "Streaming" << objectInstances.size()
+                << "object instances in" << sceneStreamer_->cellCount()
+                << "cells";
+    return true;
+  }
+
+  // objIDs =
+  physicsManager_->addObjectInstances(
+      objectInstances, objAttrFullHandles, defaultCOMCorrection,
+      &getDrawableGroup(), attachmentNode, config_.sceneLightSetupKey);
   return true;
 }  // Simulator::instanceObjectsForSceneAttributes()
 
+void Simulator::updateSceneStreaming() {
+  if (!sceneStreamer_ || physicsManager_ == nullptr) {
+    return;
+  }
+  ESP_PROFILE_SCOPE("updateSceneStreaming");
+
+  std::vector<Mn::Vector3> viewers;
+  viewers.reserve(agents_.size());
+  for (const auto& agent : agents_) {
+    viewers.push_back(agent->node().absoluteTranslation());
+  }
+  const SceneStreamer::Update update =
+      sceneStreamer_->update(viewers, config_.sceneStreamingRadius);
+
+  // objects the user removed in the meantime are skipped
+  for (const std::size_t instance : update.unload) {
+    if (physicsManager_->isValidRigidObjectId(streamedObjectIds_[instance])) {
+      physicsManager_->removeObject(streamedObjectIds_[instance]);
+    }
+    streamedObjectIds_[instance] = ID_UNDEFINED;
+  }
+
+  if (!update.load.empty()) {
+    std::vector<SceneObjectInstanceAttributes::cptr> objectInstances;
+    std::vector<std::string> objAttrFullHandles;
+    objectInstances.reserve(update.load.size());
+    objAttrFullHandles.reserve(update.load.size());
+    for (const std::size_t instance : update.load) {
+      objectInstances.push_back(streamedObjectInstances_[instance]);
+      objAttrFullHandles.push_back(streamedObjectHandles_[instance]);
+    }
+    const std::vector<int> objIds = physicsManager_->addObjectInstances(
+        objectInstances, objAttrFullHandles, streamedObjectCOMCorrection_,
+        &getDrawableGroup(), nullptr, config_.sceneLightSetupKey);
+    for (std::size_t i = 0; i != update.load.size(); ++i) {
+      streamedObjectIds_[update.load[i]] = objIds[i];
+    }
+  }
+
+  // the prefetch is only started once the loads above are done, as loading
+  // a render asset waits for a running prefetch
+  if (!update.prefetch.empty()) {
+    const auto& objAttrMgr = metadataMediator_->getObjectAttributesManager();
+    std::vector<std::string> filepaths;
+    for (const std::size_t instance : update.prefetch) {
+      const auto objAttr =
+          objAttrMgr->getObjectByHandle(streamedObjectHandles_[instance]);
+      if (objAttr) {
+        filepaths.push_back(objAttr->getRenderAssetHandle());
+      }
+    }
+    std::sort(filepaths.begin(), filepaths.end());
+    filepaths.erase(std::unique(filepaths.begin(), filepaths.end()),
+                    filepaths.end());
+    prefetchRenderAssets(filepaths);
+  }
+}  // Simulator::updateSceneStreaming()
+
 bool Simulator::instanceArticulatedObjectsForSceneAttributes(
     const metadata::attributes::SceneInstanceAttributes::cptr&
         curSceneInstanceAttributes_) {
@@ -705,6 +987,42 @@ void Simulator::reset() {
   resourceManager_->setLightSetup(gfx::getDefaultLights());
 }  // Simulator::reset()
 
+SimulatorStateSnapshot Simulator::captureStateSnapshot() const {
+  SimulatorStateSnapshot snapshot;
+  if (physicsManager_ != nullptr) {
+    snapshot.physics = physicsManager_->captureStateSnapshot();
+  }
+  snapshot.agents.reserve(agents_.size());
+  auto state = agent::AgentState::create();
+  for (const auto& agent : agents_) {
+    agent->getState(state);
+    snapshot.agents.push_back(*state);
+  }
+  return snapshot;
+}  // Simulator::captureStateSnapshot
+
+bool Simulator::restoreStateSnapshot(const SimulatorStateSnapshot& snapshot) {
+  ESP_CHECK(!asyncAgentObservationsInFlight(),
+            "Simulator::restoreStateSnapshot(): call "
+            "finishAsyncAgentObservations() first");
+  bool restoredAll = true;
+  if (physicsManager_ != nullptr) {
+    restoredAll = physicsManager_->restoreStateSnapshot(snapshot.physics);
+  }
+  if (snapshot.agents.size() != agents_.size()) {
+    ESP_WARNING() << "The snapshot has" << snapshot.agents.size()
+                  << "agents but the simulator" << agents_.size()
+                  << ", restoring only the first ones.";
+    restoredAll = false;
+  }
+  const std::size_t numAgents =
+      std::min(snapshot.agents.size(), agents_.size());
+  for (std::size_t i = 0; i != numAgents; ++i) {
+    agents_[i]->setState(snapshot.agents[i]);
+  }
+  return restoredAll;
+}  // Simulator::restoreStateSnapshot
+
 metadata::attributes::SceneInstanceAttributes::ptr
 Simulator::buildCurrentStateSceneAttributes() const {
   // 1. Get SceneInstanceAttributes copy corresponding to initial scene setup
@@ -833,18 +1151,56 @@ void Simulator::reconfigureReplayManager(bool enableGfxReplaySave) {
 // === Physics Simulator Functions ===
 
 double Simulator::stepWorld(const double dt) {
+  ESP_PROFILE_SCOPE("stepWorld");
+  updateSceneStreaming();
   if (physicsManager_ != nullptr) {
     physicsManager_->deferNodesUpdate();
-    physicsManager_->stepPhysics(dt);
+    {
+      ESP_PROFILE_SCOPE("stepPhysics");
+      physicsManager_->stepPhysics(dt);
+    }
     if (renderer_) {
       renderer_->waitSceneGraph();
     }
 
+    ESP_PROFILE_SCOPE("updateNodes");
     physicsManager_->updateNodes();
   }
   return getWorldTime();
 }
 
+std::vector<double> Simulator::stepWorlds(
+    const std::vector<Simulator*>& simulators,
+    physics::MultiWorldStepper& stepper,
+    const double dt) {
+  ESP_PROFILE_SCOPE("stepWorlds");
+  std::vector<physics::PhysicsManager*> worlds(simulators.size(), nullptr);
+  for (std::size_t i = 0; i != simulators.size(); ++i) {
+    if (simulators[i] && simulators[i]->physicsManager_ != nullptr) {
+      simulators[i]->updateSceneStreaming();
+      worlds[i] = simulators[i]->physicsManager_.get();
+      worlds[i]->deferNodesUpdate();
+    }
+  }
+
+  std::vector<double> worldTimes;
+  {
+    ESP_PROFILE_SCOPE("stepPhysics");
+    worldTimes = stepper.stepWorlds(worlds, dt);
+  }
+
+  ESP_PROFILE_SCOPE("updateNodes");
+  for (std::size_t i = 0; i != simulators.size(); ++i) {
+    if (worlds[i]) {
+      if (simulators[i]->renderer_) {
+        simulators[i]->renderer_->waitSceneGraph();
+      }
+      worlds[i]->updateNodes();
+    }
+  }
+  return worldTimes;
+}
+
 // get the simulated world time (0 if no physics enabled)
 double Simulator::getWorldTime() {
   if (physicsManager_ != nullptr) {
@@ -878,13 +1234,50 @@ bool Simulator::recomputeNavMesh(nav::PathFinder& pathfinder,
   return true;
 }
 
+bool Simulator::recomputeNavMeshRegions(
+    nav::PathFinder& pathfinder,
+    const nav::NavMeshSettings& navMeshSettings,
+    const std::vector<Mn::Range3D>& dirtyRegions) {
+  assets::MeshData::ptr joinedMesh =
+      getJoinedMesh(navMeshSettings.includeStaticObjects);
+
+  std::vector<std::pair<vec3f, vec3f>> regions;
+  regions.reserve(dirtyRegions.size());
+  for (const Mn::Range3D& region : dirtyRegions) {
+    regions.emplace_back(Mn::EigenIntegration::cast<vec3f>(region.min()),
+                         Mn::EigenIntegration::cast<vec3f>(region.max()));
+  }
+
+  if (!pathfinder.rebuildTiles(navMeshSettings, *joinedMesh, regions)) {
+    ESP_DEBUG() << "Incremental navmesh update failed, rebuilding all tiles";
+    if (!pathfinder.build(navMeshSettings, *joinedMesh)) {
+      ESP_ERROR() << "Failed to build navmesh";
+      return false;
+    }
+  }
+
+  if (&pathfinder == pathfinder_.get()) {
+    resetNavMeshVisIfActive();
+  }
+
+  ESP_DEBUG() << "navmesh update successful";
+  return true;
+}
+
 assets::MeshData::ptr Simulator::getJoinedMesh(
     const bool includeStaticObjects) {
-  assets::MeshData::ptr joinedMesh = assets::MeshData::create();
+  // The parts reference the collision meshes of the stage and objects
+  // directly, only the joined result is a copy
+  std::vector<assets::MeshJoinPart> parts;
+  const auto addPart = [&](const std::string& meshHandle,
+                           const Mn::Matrix4& transform) {
+    resourceManager_->appendCollisionMeshJoinParts(parts, meshHandle,
+                                                   transform);
+  };
+
   auto stageInitAttrs = physicsManager_->getStageInitAttributes();
   if (stageInitAttrs != nullptr) {
-    joinedMesh = resourceManager_->createJoinedCollisionMesh(
-        stageInitAttrs->getRenderAssetHandle());
+    addPart(stageInitAttrs->getRenderAssetHandle(), Mn::Matrix4{});
   }
 
   // add STATIC collision objects
@@ -899,22 +1292,18 @@ assets::MeshData::ptr Simulator::getJoinedMesh(
     // collect mesh components from all objects and then merge them.
     // Each mesh component could be duplicated multiple times w/ different
     // transforms.
-    std::map<std::string,
-             std::vector<Eigen::Transform<float, 3, Eigen::Affine>>>
-        meshComponentStates;
+    std::map<std::string, std::vector<Mn::Matrix4>> meshComponentStates;
     auto rigidObjMgr = getRigidObjectManager();
     // collect RigidObject mesh components
     for (auto objectID : physicsManager_->getExistingObjectIDs()) {
       auto objWrapper = rigidObjMgr->getObjectCopyByID(objectID);
       if (objWrapper->getMotionType() == physics::MotionType::STATIC) {
-        auto objectTransform = Magnum::EigenIntegration::cast<
-            Eigen::Transform<float, 3, Eigen::Affine>>(
-            physicsManager_->getObjectVisualSceneNode(objectID)
-                .absoluteTransformationMatrix());
         const metadata::attributes::ObjectAttributes::cptr
             initializationTemplate = objWrapper->getInitializationAttributes();
-        objectTransform.scale(Magnum::EigenIntegration::cast<vec3f>(
-            initializationTemplate->getScale()));
+        const Mn::Matrix4 objectTransform =
+            physicsManager_->getObjectVisualSceneNode(objectID)
+                .absoluteTransformationMatrix() *
+            Mn::Matrix4::scaling(initializationTemplate->getScale());
         std::string meshHandle =
             initializationTemplate->getCollisionAssetHandle();
         if (meshHandle.empty()) {
@@ -938,35 +1327,24 @@ assets::MeshData::ptr Simulator::getJoinedMesh(
                       .getLink(linkIx)
                       .visualAttachments_;
           for (auto& visualAttachment : visualAttachments) {
-            auto objectTransform = Magnum::EigenIntegration::cast<
-                Eigen::Transform<float, 3, Eigen::Affine>>(
+            meshComponentStates[visualAttachment.second].push_back(
                 visualAttachment.first->absoluteTransformationMatrix());
-            std::string meshHandle = visualAttachment.second;
-            meshComponentStates[meshHandle].push_back(objectTransform);
           }
         }
       }
     }
 
-    // merge mesh components into the final mesh
     for (auto& meshComponent : meshComponentStates) {
-      assets::MeshData::uptr joinedObjectMesh =
-          resourceManager_->createJoinedCollisionMesh(meshComponent.first);
       for (auto& meshTransform : meshComponent.second) {
-        int prevNumIndices = joinedMesh->ibo.size();
-        int prevNumVerts = joinedMesh->vbo.size();
-        joinedMesh->ibo.resize(prevNumIndices + joinedObjectMesh->ibo.size());
-        for (size_t ix = 0; ix < joinedObjectMesh->ibo.size(); ++ix) {
-          joinedMesh->ibo[ix + prevNumIndices] =
-              joinedObjectMesh->ibo[ix] + prevNumVerts;
-        }
-        joinedMesh->vbo.reserve(joinedObjectMesh->vbo.size() + prevNumVerts);
-        for (auto& vert : joinedObjectMesh->vbo) {
-          joinedMesh->vbo.push_back(meshTransform * vert);
-        }
+        addPart(meshComponent.first, meshTransform);
       }
     }
   }
+
+  // grow the joined mesh once and transform the parts in parallel
+  assets::MeshData::ptr joinedMesh = assets::MeshData::create();
+  assets::joinMeshParts(*joinedMesh, parts);
+
   ESP_CHECK(joinedMesh->vbo.size() > 0,
             "::recomputeNavMesh: "
             "Unable to compute a navmesh upon a non-existent mesh - "
@@ -991,34 +1369,35 @@ assets::MeshData::ptr Simulator::getJoinedSemanticMesh(
 bool Simulator::setNavMeshVisualization(bool visualize) {
   getRenderGLContext();
 
-  // clean-up the NavMesh visualization if necessary
+  // clean-up the NavMesh visualization if necessary. The overlay keeps its
+  // meshes for the next time it's enabled.
   if (!visualize && navMeshVisNode_ != nullptr) {
+    navMeshOverlay_->detach(*navMeshVisNode_);
     delete navMeshVisNode_;
     navMeshVisNode_ = nullptr;
-    if (navMeshVisPrimID_ != ID_UNDEFINED)
-      resourceManager_->removePrimitiveMesh(navMeshVisPrimID_);
-    navMeshVisPrimID_ = ID_UNDEFINED;
   }
 
-  // Create new visualization asset and SceneNode
+  // Attach the visualization to a new SceneNode, uploading just the tiles
+  // that changed since it was last shown
   if (visualize && pathfinder_ != nullptr && navMeshVisNode_ == nullptr &&
       pathfinder_->isLoaded()) {
-    auto& sceneGraph = sceneManager_->getSceneGraph(activeSceneID_);
-    auto& rootNode = sceneGraph.getRootNode();
-    auto& drawables = sceneGraph.getDrawables();
-    navMeshVisNode_ = &rootNode.createChild();
-    navMeshVisPrimID_ = resourceManager_->loadNavMeshVisualization(
-        *pathfinder_, navMeshVisNode_, &drawables);
-    if (navMeshVisPrimID_ == ID_UNDEFINED) {
+    if (!navMeshOverlay_) {
+      navMeshOverlay_ = std::make_unique<NavMeshOverlay>(*resourceManager_);
+    }
+    navMeshOverlay_->update(*pathfinder_);
+    if (navMeshOverlay_->tileMeshCount() == 0) {
       ESP_ERROR() << "Failed to load navmesh visualization.";
-      delete navMeshVisNode_;
+    } else {
+      auto& sceneGraph = sceneManager_->getSceneGraph(activeSceneID_);
+      navMeshVisNode_ = &sceneGraph.getRootNode().createChild();
+      navMeshOverlay_->attach(*navMeshVisNode_, sceneGraph.getDrawables());
     }
   }
   return isNavMeshVisualizationActive();
 }
 
 bool Simulator::isNavMeshVisualizationActive() {
-  return (navMeshVisNode_ != nullptr && navMeshVisPrimID_ != ID_UNDEFINED);
+  return navMeshVisNode_ != nullptr;
 }
 
 // Agents
@@ -1034,6 +1413,79 @@ void Simulator::sampleRandomAgentState(agent::AgentState& agentState) {
   }
 }
 
+std::vector<agent::AgentState> Simulator::sampleRandomAgentStates(
+    const int numStates,
+    const float minIslandArea,
+    const float minObstacleDistance,
+    const int islandIndex,
+    const int maxTries,
+    const int numThreads) {
+  std::vector<agent::AgentState> states;
+  if (!pathfinder_->isLoaded()) {
+    ESP_ERROR() << "No loaded PathFinder, aborting sampleRandomAgentStates.";
+    return states;
+  }
+  states.reserve(std::max(numStates, 0));
+
+  // island areas are looked up once instead of per sample
+  std::vector<float> islandAreas;
+  if (minIslandArea > 0.0f) {
+    islandAreas.resize(pathfinder_->numIslands());
+    for (int i = 0; i != int(islandAreas.size()); ++i) {
+      islandAreas[i] = pathfinder_->getNavigableArea(i);
+    }
+  }
+
+  std::vector<int> islands;
+  std::vector<char> accepted;
+  for (int round = 0; round < std::max(maxTries, 1); ++round) {
+    const int numMissing = numStates - int(states.size());
+    if (numMissing <= 0) {
+      break;
+    }
+    const std::vector<vec3f> points = pathfinder_->getRandomNavigablePoints(
+        numMissing, islandIndex, random_->uniform_uint(), numThreads);
+    if (!islandAreas.empty()) {
+      islands.resize(points.size());
+      pathfinder_->getIslands(Cr::Containers::arrayView(points),
+                              Cr::Containers::arrayView(islands), numThreads);
+    }
+    accepted.assign(points.size(), 0);
+    core::parallelFor(
+        points.size(), numThreads, [&](const std::size_t i, int /*worker*/) {
+          if (!points[i].allFinite()) {
+            return;
+          }
+          if (!islandAreas.empty() &&
+              (islands[i] == ID_UNDEFINED ||
+               islandAreas[islands[i]] < minIslandArea)) {
+            return;
+          }
+          if (minObstacleDistance > 0.0f &&
+              pathfinder_->distanceToClosestObstacle(
+                  points[i], minObstacleDistance) < minObstacleDistance) {
+            return;
+          }
+          accepted[i] = 1;
+        });
+
+    // rotations are drawn serially so the result doesn't depend on the
+    // number of threads
+    for (std::size_t i = 0; i != points.size(); ++i) {
+      if (!accepted[i]) {
+        continue;
+      }
+      agent::AgentState state;
+      state.position = points[i];
+      const float randomAngleRad = random_->uniform_float_01() * M_PI;
+      state.rotation =
+          quatf(Eigen::AngleAxisf(randomAngleRad, vec3f::UnitY())).coeffs();
+      states.push_back(state);
+    }
+  }
+  return states;
+}
+
 esp::physics::ManagedArticulatedObject::ptr
 Simulator::queryArticulatedObjWrapper(int objID) const {
   if (!sceneHasPhysics()) {
@@ -1110,6 +1562,61 @@ agent::Agent::ptr Simulator::addAgent(
   return addAgent(agentConfig, getActiveSceneGraph().getRootNode());
 }
 
+std::vector<bool> Simulator::actAgents(const std::vector<int>& actionIndices) {
+  ESP_CHECK(actionIndices.size() == agents_.size(),
+            "Simulator::actAgents(): expected" << agents_.size()
+                << "action indices but got" << actionIndices.size());
+  std::vector<bool> performed(agents_.size(), false);
+  // agents performing body actions, with their positions before and after
+  // the unfiltered moves
+  std::vector<std::size_t> movedAgents;
+  std::vector<vec3f> starts;
+  std::vector<vec3f> ends;
+  for (std::size_t i = 0; i != agents_.size(); ++i) {
+    const agent::ActionSpec::ptr actionSpec =
+        agents_[i]->getActionSpec(actionIndices[i]);
+    if (!actionSpec) {
+      continue;
+    }
+    performed[i] = true;
+    if (agent::Agent::BodyActions.find(actionSpec->name) ==
+        agent::Agent::BodyActions.end()) {
+      agents_[i]->act(actionIndices[i]);
+      continue;
+    }
+    scene::SceneNode& node = agents_[i]->node();
+    movedAgents.push_back(i);
+    starts.push_back(Mn::EigenIntegration::cast<vec3f>(
+        node.absoluteTransformation().translation()));
+    agents_[i]->getControls()->action(node, actionSpec->name,
+                                      actionSpec->actuation.at("amount"),
+                                      /*applyFilter=*/false);
+    ends.push_back(Mn::EigenIntegration::cast<vec3f>(
+        node.absoluteTransformation().translation()));
+  }
+  if (movedAgents.empty() || !pathfinder_->isLoaded()) {
+    return performed;
+  }
+
+  agentPolyRefs_.resize(agents_.size(), 0);
+  std::vector<uint64_t> polyRefs(movedAgents.size());
+  for (std::size_t j = 0; j != movedAgents.size(); ++j) {
+    polyRefs[j] = agentPolyRefs_[movedAgents[j]];
+  }
+  std::vector<vec3f> stepped(movedAgents.size());
+  pathfinder_->trySteps(Cr::Containers::arrayView(starts),
+                        Cr::Containers::arrayView(ends),
+                        Cr::Containers::arrayView(stepped),
+                        Cr::Containers::arrayView(polyRefs),
+                        config_.allowSliding);
+  for (std::size_t j = 0; j != movedAgents.size(); ++j) {
+    agentPolyRefs_[movedAgents[j]] = polyRefs[j];
+    agents_[movedAgents[j]]->node().translate(
+        Mn::Vector3{vec3f(stepped[j] - ends[j])});
+  }
+  return performed;
+}
+
 agent::Agent::ptr Simulator::getAgent(const int agentId) {
   CORRADE_INTERNAL_ASSERT(0 <= agentId && agentId < agents_.size());
   return agents_[agentId];
@@ -1208,15 +1715,293 @@ bool Simulator::getAgentObservation(const int agentId,
   return false;
 }
 
+namespace {
+// whether two camera sensors see the exact same image and can thus be drawn
+// in one pass
+bool canShareRenderPass(sensor::CameraSensor& a, sensor::CameraSensor& b) {
+  return a.node().scene() == b.node().scene() &&
+         a.framebufferSize() == b.framebufferSize() &&
+         a.getProjectionMatrix() == b.getProjectionMatrix() &&
+         a.specification()->clearColor == b.specification()->clearColor &&
+         a.node().absoluteTransformationMatrix() ==
+             b.node().absoluteTransformationMatrix();
+}
+
+// add the downsampled observations of a visual sensor, read from its render
+// target if read is set or the ones of the last read otherwise
+void addDownsampledObservations(
+    sensor::VisualSensor& visualSensor,
+    bool read,
+    std::map<std::string, sensor::Observation>& observations) {
+  const sensor::VisualSensorSpec& spec = *visualSensor.specification();
+  for (int level = 1; level <= spec.downsampleLevels; ++level) {
+    sensor::Observation obs;
+    if (read) {
+      visualSensor.readDownsampledObservation(level, obs);
+    } else {
+      visualSensor.downsampledObservationView(level, obs);
+    }
+    observations[spec.downsampledUuid(level)] = obs;
+  }
+}
+}  // namespace
+
+int Simulator::drawAgentObservations(const int agentId) {
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag == nullptr) {
+    return 0;
+  }
+
+  std::vector<sensor::VisualSensor*> visualSensors;
+  for (auto& s : ag->getSubtreeSensors()) {
+    if (s.second.get().isVisualSensor()) {
+      visualSensors.push_back(
+          static_cast<sensor::VisualSensor*>(&s.second.get()));
+    }
+  }
+  return drawVisualSensorObservations(visualSensors);
+}
+
+int Simulator::drawVisualSensorObservations(
+    const std::vector<sensor::VisualSensor*>& visualSensors) {
+  // groups of sensors drawn in one pass, the first one of each group is the
+  // one that is drawn
+  std::vector<std::vector<sensor::CameraSensor*>> groups;
+  int numPasses = 0;
+  const bool oneSceneGraph =
+      semanticSceneGraphExists() &&
+      &getActiveSemanticSceneGraph() == &getActiveSceneGraph();
+  const bool pendingLines =
+      debugLineRender_ && debugLineRender_->hasPendingLines();
+  for (sensor::VisualSensor* visualSensor : visualSensors) {
+    auto* camera = dynamic_cast<sensor::CameraSensor*>(visualSensor);
+    const sensor::SensorType type = visualSensor->specification()->sensorType;
+    const bool canShare =
+        config_.enableSharedSensorRendering && camera &&
+        camera->hasRenderTarget() &&
+        (type == sensor::SensorType::Depth ||
+         (type == sensor::SensorType::Color && !config_.enableHBAO &&
+          !pendingLines) ||
+         (type == sensor::SensorType::Semantic && oneSceneGraph));
+    if (!canShare) {
+      if (visualSensor->drawObservation(*this)) {
+        ++numPasses;
+      }
+      continue;
+    }
+
+    bool added = false;
+    for (auto& group : groups) {
+      if (!canShareRenderPass(*group.front(), *camera)) {
+        continue;
+      }
+      // the semantic sensor draws the pass, as its camera decides which ids
+      // end up in the object id attachment
+      if (type == sensor::SensorType::Semantic) {
+        if (group.front()->specification()->sensorType ==
+            sensor::SensorType::Semantic) {
+          continue;
+        }
+        group.insert(group.begin(), camera);
+      } else {
+        group.push_back(camera);
+      }
+      added = true;
+      break;
+    }
+    if (!added) {
+      groups.push_back({camera});
+    }
+  }
+
+  for (auto& group : groups) {
+    sensor::CameraSensor& leader = *group.front();
+    if (group.size() > 1) {
+      constexpr gfx::RenderTarget::Flags allAttachments =
+          gfx::RenderTarget::Flag::RgbaAttachment |
+          gfx::RenderTarget::Flag::DepthTextureAttachment |
+          gfx::RenderTarget::Flag::ObjectIdAttachment;
+      if ((leader.renderTarget().flags() & allAttachments) != allAttachments) {
+        renderer_->bindRenderTarget(leader,
+                                    gfx::Renderer::Flag::AllAttachments);
+      }
+    }
+    if (!leader.drawObservation(*this)) {
+      continue;
+    }
+    ++numPasses;
+    for (std::size_t i = 1; i < group.size(); ++i) {
+      group[i]->setSharedRenderTarget(&leader.renderTarget());
+    }
+  }
+  return numPasses;
+}
+
 int Simulator::getAgentObservations(
     const int agentId,
     std::map<std::string, sensor::Observation>& observations) {
   observations.clear();
   agent::Agent::ptr ag = getAgent(agentId);
   if (ag != nullptr) {
+    // sensors not due in their update schedule return their last observation
+    std::vector<std::pair<const std::string*, sensor::Sensor*>> dueSensors;
+    std::vector<sensor::VisualSensor*> dueVisualSensors;
+    for (auto& s : ag->getSubtreeSensors()) {
+      sensor::Sensor& sensor = s.second.get();
+      if (!sensor.advanceUpdateSchedule()) {
+        sensor::Observation obs;
+        if (sensor.getCachedObservation(obs)) {
+          observations[s.first] = obs;
+          if (sensor.isVisualSensor()) {
+            addDownsampledObservations(
+                static_cast<sensor::VisualSensor&>(sensor), false,
+                observations);
+          }
+        }
+        continue;
+      }
+      dueSensors.emplace_back(&s.first, &sensor);
+      if (sensor.isVisualSensor()) {
+        dueVisualSensors.push_back(static_cast<sensor::VisualSensor*>(&sensor));
+      }
+    }
+
+    if (config_.enableSharedSensorRendering) {
+      drawVisualSensorObservations(dueVisualSensors);
+    }
+    for (auto& s : dueSensors) {
+      sensor::Observation obs;
+      sensor::Sensor& sensor = *s.second;
+      if (config_.enableSharedSensorRendering && sensor.isVisualSensor()) {
+        auto& visualSensor = static_cast<sensor::VisualSensor&>(sensor);
+        if (!visualSensor.hasRenderTarget()) {
+          continue;
+        }
+        visualSensor.readObservation(obs);
+        observations[*s.first] = obs;
+        addDownsampledObservations(visualSensor, true, observations);
+      } else if (sensor.getObservation(*this, obs)) {
+        observations[*s.first] = obs;
+        if (sensor.isVisualSensor()) {
+          addDownsampledObservations(static_cast<sensor::VisualSensor&>(sensor),
+                                     true, observations);
+        }
+      }
+    }
+  }
+  return observations.size();
+}
+
+int Simulator::startAsyncAgentObservations(const int agentId) {
+  ESP_CHECK(!asyncAgentObservationsInFlight(),
+            "Simulator::startAsyncAgentObservations(): observations of agent"
+                << asyncObservationAgentId_
+                << "are still in flight, call "
+                   "finishAsyncAgentObservations() first");
+  asyncObservations_.clear();
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag == nullptr) {
+    return 0;
+  }
+
+#ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
+  std::vector<std::pair<std::string, sensor::VisualSensor*>> asyncSensors;
+  for (auto& s : ag->getSubtreeSensors()) {
+    sensor::Sensor& sensor = s.second.get();
+    if (!renderer_ || !sensor.isVisualSensor() ||
+        !static_cast<sensor::VisualSensor&>(sensor).hasRenderTarget()) {
+      continue;
+    }
+    auto& visualSensor = static_cast<sensor::VisualSensor&>(sensor);
+    const sensor::SensorSubType subType =
+        visualSensor.specification()->sensorSubType;
+    if (subType != sensor::SensorSubType::Pinhole &&
+        subType != sensor::SensorSubType::Orthographic) {
+      continue;
+    }
+    ESP_CHECK(visualSensor.specification()->sensorType !=
+                      sensor::SensorType::Semantic ||
+                  (semanticSceneGraphExists() &&
+                   &getActiveSemanticSceneGraph() == &getActiveSceneGraph()),
+              "Simulator::startAsyncAgentObservations(): semantic sensor"
+                  << s.first
+                  << "can't be drawn asynchronously with a separate semantic "
+                     "scene graph");
+    // drawn past drawObservation(), so the next draw can't be skipped
+    visualSensor.resetObservationCache();
+    asyncSensors.emplace_back(s.first, &visualSensor);
+  }
+
+  // the others are drawn now, before the context goes to the thread
+  getRenderGLContext();
+  for (auto& s : ag->getSubtreeSensors()) {
+    sensor::Observation obs;
+    sensor::Sensor& sensor = s.second.get();
+    if (sensor.isVisualSensor() &&
+        std::none_of(asyncSensors.begin(), asyncSensors.end(),
+                     [&](const auto& a) { return a.second == &sensor; }) &&
+        sensor.getObservation(*this, obs)) {
+      asyncObservations_[s.first] = obs;
+    }
+  }
+
+  gfx::RenderCamera::Flags flags;
+  if (isFrustumCullingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::FrustumCulling;
+  }
+  for (auto& s : asyncSensors) {
+    sensor::Observation& obs = asyncObservations_[s.first];
+    gfx::RenderCamera::Flags sensorFlags = flags;
+    if (s.second->drawsDepthAndObjectIdOnly()) {
+      sensorFlags |= gfx::RenderCamera::Flag::DepthAndObjectIdOnly;
+    }
+    renderer_->enqueueAsyncDrawJob(*s.second, getActiveSceneGraph(),
+                                   s.second->observationView(obs), sensorFlags);
+  }
+  asyncObservationAgentId_ = agentId;
+
+  const int numJobs = asyncSensors.size();
+  if (numJobs != 0) {
+    renderer_->snapshotDrawJobs();
+    renderer_->startDrawJobs();
+  }
+  return numJobs;
+#else
+  // no background thread, the visual observations are drawn right away
+  asyncObservationAgentId_ = agentId;
+  for (auto& s : ag->getSubtreeSensors()) {
+    sensor::Observation obs;
+    sensor::Sensor& sensor = s.second.get();
+    if (sensor.isVisualSensor() && sensor.getObservation(*this, obs)) {
+      asyncObservations_[s.first] = obs;
+    }
+  }
+  return 0;
+#endif
+}
+
+int Simulator::finishAsyncAgentObservations(
+    std::map<std::string, sensor::Observation>& observations) {
+  ESP_CHECK(asyncAgentObservationsInFlight(),
+            "Simulator::finishAsyncAgentObservations(): no observations were "
+            "started by startAsyncAgentObservations()");
+  const int agentId = asyncObservationAgentId_;
+  asyncObservationAgentId_ = ID_UNDEFINED;
+#ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
+  if (renderer_ && renderer_->wasBackgroundRendererInitialized()) {
+    renderer_->waitDrawJobs();
+  }
+#endif
+
+  observations = std::move(asyncObservations_);
+  asyncObservations_.clear();
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag != nullptr) {
+    // non-visual sensors observe the state after the physics steps
     for (auto& s : ag->getSubtreeSensors()) {
       sensor::Observation obs;
-      if (s.second.get().getObservation(*this, obs)) {
+      sensor::Sensor& sensor = s.second.get();
+      if (!sensor.isVisualSensor() && sensor.getObservation(*this, obs)) {
         observations[s.first] = obs;
       }
     }
@@ -1250,14 +2035,84 @@ int Simulator::getAgentObservationSpaces(
   return spaces.size();
 }
 
+namespace {
+// profiled sections reported by getRuntimePerfStatValues(), with the names of
+// the stats
+constexpr const char* PerfStatSections[][2]{
+    {"stepWorld", "step world ms"},
+    {"stepPhysics", "step physics ms"},
+    {"updateNodes", "update nodes ms"},
+    {"cull", "cull ms"},
+    {"draw", "draw ms"},
+    {"readback", "readback ms"},
+    {"replayRecording", "replay recording ms"},
+    {"gpuDraw", "gpu draw ms"},
+    {"gpuHbao", "gpu hbao ms"},
+    {"gpuCubeMapFace", "gpu cube map face ms"},
+    {"gpuReadback", "gpu readback ms"}};
+}  // namespace
+
+std::vector<std::string> Simulator::getSceneLoadPerfStatNames() {
+  std::vector<std::string> names;
+  for (const auto& section : SceneLoadPerfStatSections) {
+    names.emplace_back(section[1]);
+  }
+  return names;
+}
+
+MemoryReport Simulator::getMemoryReport() const {
+  MemoryReport report;
+  const assets::ResourceManager::AssetMemoryUsage assets =
+      resourceManager_->getAssetMemoryUsage();
+  report.meshes = assets.meshes;
+  report.textures = assets.textures;
+  report.collisionMeshes = assets.collisionMeshes;
+  report.semanticScene = assets.semanticMeshes;
+
+  if (const auto semanticScene = resourceManager_->getSemanticScene()) {
+    report.semanticScene.cpuBytes +=
+        sizeof(scene::SemanticScene) +
+        sharedVectorByteSize(semanticScene->categories()) +
+        sharedVectorByteSize(semanticScene->levels()) +
+        sharedVectorByteSize(semanticScene->regions()) +
+        sharedVectorByteSize(semanticScene->objects());
+  }
+
+  if (pathfinder_) {
+    report.navMesh.cpuBytes = pathfinder_->getNavMeshByteSize();
+  }
+
+  if (const auto recorder = gfxReplayMgr_->getRecorder()) {
+    report.replayKeyframes.cpuBytes = recorder->getKeyframesByteSize();
+  }
+
+  std::unordered_set<const core::config::Configuration*> seen;
+  metadata::MetadataMediator& mm = *metadataMediator_;
+  report.attributes.cpuBytes =
+      attributesByteSize(mm.getAssetAttributesManager(), seen) +
+      attributesByteSize(mm.getLightLayoutAttributesManager(), seen) +
+      attributesByteSize(mm.getAOAttributesManager(), seen) +
+      attributesByteSize(mm.getObjectAttributesManager(), seen) +
+      attributesByteSize(mm.getPhysicsAttributesManager(), seen) +
+      attributesByteSize(mm.getPbrShaderAttributesManager(), seen) +
+      attributesByteSize(mm.getSceneInstanceAttributesManager(), seen) +
+      attributesByteSize(mm.getSemanticAttributesManager(), seen) +
+      attributesByteSize(mm.getStageAttributesManager(), seen);
+  return report;
+}
+
 std::vector<std::string> Simulator::getRuntimePerfStatNames() {
-  return {"num rigid",
-          "num active rigid",
-          "num artic",
-          "num active overlaps",
-          "num active contacts",
-          "num drawables",
-          "num faces"};
+  std::vector<std::string> names{"num rigid",
+                                 "num active rigid",
+                                 "num artic",
+                                 "num active overlaps",
+                                 "num active contacts",
+                                 "num drawables",
+                                 "num faces"};
+  for (const auto& section : PerfStatSections) {
+    names.emplace_back(section[1]);
+  }
+  return names;
 }
 
 std::vector<float> Simulator::getRuntimePerfStatValues() {
@@ -1276,9 +2131,22 @@ std::vector<float> Simulator::getRuntimePerfStatValues() {
       physicsManager_->getNumActiveContactPoints());
   runtimePerfStatValues_.push_back(drawableCount);
   runtimePerfStatValues_.push_back(drawableNumFaces);
+  const core::Profiler& profiler = core::Profiler::global();
+  for (const auto& section : PerfStatSections) {
+    runtimePerfStatValues_.push_back(profiler.stats(section[0]).meanMs);
+  }
 
   return runtimePerfStatValues_;
 }
 
+void Simulator::setProfilingEnabled(const bool enabled,
+                                    const bool keepTrace,
+                                    const bool gpuTimers) {
+  core::Profiler& profiler = core::Profiler::global();
+  profiler.setEnabled(enabled);
+  profiler.setTraceEnabled(enabled && keepTrace);
+  profiler.setGpuTimersEnabled(enabled && gpuTimers);
+}
+
 }  // namespace sim
 }  // namespace esp
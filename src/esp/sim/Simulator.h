@@ -11,17 +11,21 @@
 #include "esp/agent/Agent.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/core/Esp.h"
+#include "esp/core/MemoryUsage.h"
 #include "esp/core/Random.h"
 #include "esp/gfx/DebugLineRender.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/nav/PathFinder.h"
+#include "esp/physics/MultiWorldStepper.h"
 #include "esp/physics/PhysicsManager.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
 #include "esp/sensor/Sensor.h"
 
+#include "NavMeshOverlay.h"
+#include "SceneStreamer.h"
 #include "SimulatorConfiguration.h"
 
 namespace esp {
@@ -33,6 +37,9 @@ class ActionSpacePathFinder;
 namespace scene {
 class SemanticScene;
 }  // namespace scene
+namespace sensor {
+class VisualSensor;
+}  // namespace sensor
 namespace gfx {
 class Renderer;
 namespace replay {
@@ -43,6 +50,65 @@ class ReplayManager;
 
 namespace esp {
 namespace sim {
+
+/**
+ * @brief State of a simulator captured by @ref
+ * Simulator::captureStateSnapshot()
+ */
+struct SimulatorStateSnapshot {
+  /** @brief State of the physical world, empty without physics */
+  physics::PhysicsStateSnapshot physics;
+
+  /** @brief State of each agent, in the order they were added */
+  std::vector<agent::AgentState> agents;
+
+  ESP_SMART_POINTERS(SimulatorStateSnapshot)
+};
+
+/**
+ * @brief Estimated memory held by a simulator, per subsystem, as returned by
+ * @ref Simulator::getMemoryReport()
+ */
+struct MemoryReport {
+  /** @brief Render meshes, except for semantic meshes */
+  core::MemoryUsage meshes;
+
+  /** @brief Textures */
+  core::MemoryUsage textures;
+
+  /** @brief Mesh data copied for building collision shapes */
+  core::MemoryUsage collisionMeshes;
+
+  /** @brief Tiles of the navigation mesh */
+  core::MemoryUsage navMesh;
+
+  /** @brief Semantic meshes and the semantic scene annotations */
+  core::MemoryUsage semanticScene;
+
+  /** @brief Keyframes held by the gfx-replay recorder */
+  core::MemoryUsage replayKeyframes;
+
+  /**
+   * @brief Attribute templates of the active dataset, subconfigurations shared
+   * between templates counted once
+   */
+  core::MemoryUsage attributes;
+
+  /** @brief Sum of all subsystems */
+  core::MemoryUsage total() const {
+    core::MemoryUsage sum = meshes;
+    sum += textures;
+    sum += collisionMeshes;
+    sum += navMesh;
+    sum += semanticScene;
+    sum += replayKeyframes;
+    sum += attributes;
+    return sum;
+  }
+
+  ESP_SMART_POINTERS(MemoryReport)
+};
+
 class Simulator {
  public:
   explicit Simulator(
@@ -275,6 +341,49 @@ class Simulator {
    */
   bool saveCurrentSceneInstance(bool overwrite = false) const;
 
+  /**
+   * @brief Capture the state of the objects and agents, to return to it later
+   * with @ref restoreStateSnapshot(). See @ref
+   * esp::physics::PhysicsManager::captureStateSnapshot.
+   */
+  SimulatorStateSnapshot captureStateSnapshot() const;
+
+  /**
+   * @brief Put the objects and agents back into the state captured by @ref
+   * captureStateSnapshot(), e.g. to start another episode in the same scene.
+   *
+   * Unlike @ref reconfigure(), this doesn't create the scene instance again
+   * but updates the existing objects in place, removing the ones added since
+   * the capture. See @ref esp::physics::PhysicsManager::restoreStateSnapshot.
+   * @return Whether all objects and agents of @p snapshot were restored.
+   */
+  bool restoreStateSnapshot(const SimulatorStateSnapshot& snapshot);
+
+  /**
+   * @brief Write the state of the physical world to @p state as a compact
+   * binary blob. Cleared without physics. See @ref
+   * esp::physics::PhysicsManager::saveState.
+   */
+  void savePhysicsState(std::vector<char>& state) const {
+    if (physicsManager_ == nullptr) {
+      state.clear();
+      return;
+    }
+    physicsManager_->saveState(state);
+  }
+
+  /**
+   * @brief Put the physical world back into a @p state written by @ref
+   * savePhysicsState(). See @ref esp::physics::PhysicsManager::restoreState.
+   * @return Whether the state was restored.
+   */
+  bool restorePhysicsState(Cr::Containers::ArrayView<const char> state) {
+    if (physicsManager_ == nullptr) {
+      return state.isEmpty();
+    }
+    return physicsManager_->restoreState(state);
+  }
+
   /**
    * @brief Get the IDs of the physics objects instanced in a physical scene.
    * See @ref esp::physics::PhysicsManager::getExistingObjectIDs.
@@ -323,6 +432,47 @@ class Simulator {
     return false;
   }
 
+  /**
+   * @brief Check for each of a batch of poses whether a rigid object would be
+   * in contact with the collision world there. See
+   * @ref esp::physics::PhysicsManager::contactTestRigidObjectPoses.
+   *
+   * Note: physics must be enabled, otherwise nothing collides.
+   */
+  void contactTestRigidObjectPoses(
+      int objectID,
+      Cr::Containers::ArrayView<const Mn::Matrix4> poses,
+      Cr::Containers::ArrayView<bool> inContact) {
+    if (sceneHasPhysics()) {
+      physicsManager_->contactTestRigidObjectPoses(objectID, poses, inContact);
+      return;
+    }
+    for (bool& contact : inContact) {
+      contact = false;
+    }
+  }
+
+  /**
+   * @brief Check for each of a batch of joint configurations whether an
+   * articulated object would be in contact with the collision world. See
+   * @ref esp::physics::PhysicsManager::contactTestArticulatedObjectJointPositions.
+   *
+   * Note: physics must be enabled, otherwise nothing collides.
+   */
+  void contactTestArticulatedObjectJointPositions(
+      int objectID,
+      const Cr::Containers::StridedArrayView2D<const float>& jointPositions,
+      Cr::Containers::ArrayView<bool> inContact) {
+    if (sceneHasPhysics()) {
+      physicsManager_->contactTestArticulatedObjectJointPositions(
+          objectID, jointPositions, inContact);
+      return;
+    }
+    for (bool& contact : inContact) {
+      contact = false;
+    }
+  }
+
   /**
    * @brief Perform discrete collision detection for the scene.
    */
@@ -340,6 +490,19 @@ class Simulator {
     return physicsManager_->getContactPoints();
   }
 
+  /**
+   * @brief Query physics simulation implementation for contact point data of
+   * a single object from the most recent collision detection cache. See
+   * @ref esp::physics::PhysicsManager::getObjectContactPoints.
+   *
+   * @return a vector with each entry corresponding to a single contact point
+   * involving @p objectId.
+   */
+  std::vector<esp::physics::ContactPointData> getPhysicsObjectContactPoints(
+      int objectId) {
+    return physicsManager_->getObjectContactPoints(objectId);
+  }
+
   /**
    * @brief Query the number of contact points that were active during the
    * collision detection check.
@@ -364,6 +527,17 @@ class Simulator {
     return physicsManager_->getStepCollisionSummary();
   }
 
+  /**
+   * @brief Substep counts and per-phase timings of the last physics step. See
+   * @ref esp::physics::PhysicsManager::getLastStepProfile.
+   */
+  esp::physics::PhysicsStepProfile getPhysicsStepProfile() const {
+    if (physicsManager_ == nullptr) {
+      return {};
+    }
+    return physicsManager_->getLastStepProfile();
+  }
+
   /**
    * @brief Set the stage to collidable or not.
    */
@@ -428,6 +602,29 @@ class Simulator {
     return esp::physics::RaycastResults();
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world and write the closest
+   * hit of each into @p closestHits. See
+   * @ref esp::physics::PhysicsManager::castRays.
+   *
+   * Note: A default @ref physics::PhysicsManager has no collision world, so
+   * physics must be enabled for this feature. Without physics all rays miss.
+   */
+  void castRays(Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+                double maxDistance,
+                Cr::Containers::ArrayView<esp::physics::RayHitInfo> closestHits,
+                int numThreads = 1) {
+    if (sceneHasPhysics()) {
+      physicsManager_->castRays(rays, maxDistance, closestHits, numThreads);
+      return;
+    }
+    for (esp::physics::RayHitInfo& hit : closestHits) {
+      hit = esp::physics::RayHitInfo{};
+      hit.objectId = ID_UNDEFINED;
+      hit.rayDistance = -1.0;
+    }
+  }
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -441,6 +638,25 @@ class Simulator {
    */
   double stepWorld(double dt = 1.0 / 60.0);
 
+  /**
+   * @brief Step the physical worlds of several simulators concurrently.
+   *
+   * Same as calling @ref stepWorld on each of @p simulators, except that the
+   * physics of all of them are stepped in parallel on the thread pool of
+   * @p stepper, see @ref esp::physics::MultiWorldStepper. The scene nodes of
+   * all simulators are updated once stepping is done. The simulators must be
+   * distinct and must not be accessed from other threads during the call.
+   * @param simulators The simulators to step. Simulators without physics are
+   * skipped.
+   * @param stepper The stepper whose threads step the worlds.
+   * @param dt The desired amount of time to advance each physical world.
+   * @return The new world time of each simulator after stepping.
+   */
+  static std::vector<double> stepWorlds(
+      const std::vector<Simulator*>& simulators,
+      physics::MultiWorldStepper& stepper,
+      double dt = 1.0 / 60.0);
+
   /**
    * @brief Get the current time in the simulated world. This is always 0 if no
    * @ref esp::physics::PhysicsManager is initialized. See @ref stepWorld. See
@@ -508,6 +724,25 @@ class Simulator {
   bool recomputeNavMesh(nav::PathFinder& pathfinder,
                         const nav::NavMeshSettings& navMeshSettings);
 
+  /**
+   * @brief Update the navmesh of the referenced @ref nav::PathFinder after
+   * local scene changes by rebuilding only the tiles overlapping the changed
+   * regions.
+   *
+   * Requires a tiled navmesh (see @ref nav::PathFinder::setBuildTiling) built
+   * with the same settings, otherwise falls back to @ref recomputeNavMesh.
+   * @param pathfinder The pathfinder object whose navmesh will be updated.
+   * @param navMeshSettings The @ref nav::NavMeshSettings instance used to
+   * build the current navmesh.
+   * @param dirtyRegions World space bounds of the changed geometry, e.g. the
+   * cumulative bounding boxes of moved objects before and after the move.
+   * @return Whether or not the navmesh update succeeded.
+   */
+  bool recomputeNavMeshRegions(
+      nav::PathFinder& pathfinder,
+      const nav::NavMeshSettings& navMeshSettings,
+      const std::vector<Mn::Range3D>& dirtyRegions);
+
   /**
    * @brief Get the joined mesh data for all objects in the scene
    * @param includeStaticObjects flag to include static objects
@@ -574,6 +809,40 @@ class Simulator {
     }
     return ID_UNDEFINED;
   }
+
+  /**
+   * @brief Compute a single trajectory visualization for all of the passed
+   * trajectories, drawn with one draw call.
+   * @param trajVisName The name to use for the trajectory visualization
+   * @param trajectories The points of each trajectory, in order
+   * @param colorVecs Array of colors for each trajectory tube. A single array
+   * is used for all tubes.
+   * @param numSegments The number of the segments around the circumference of
+   * the tubes. Must be greater than or equal to 3.
+   * @param radius The radius of the tubes.
+   * @param smooth Whether to smooth the points in the trajectories or not.
+   * @param numInterp The number of interpolations between each trajectory
+   * point, if smoothed
+   * @param numThreads The number of threads building the tube meshes, see
+   * @ref core::resolveNumThreads().
+   * @return The ID of the object created for the visualization
+   */
+  int addTrajectoryObjects(
+      const std::string& trajVisName,
+      const std::vector<std::vector<Mn::Vector3>>& trajectories,
+      const std::vector<std::vector<Mn::Color3>>& colorVecs,
+      int numSegments = 3,
+      float radius = .001,
+      bool smooth = false,
+      int numInterp = 10,
+      int numThreads = 1) {
+    if (sceneHasPhysics()) {
+      return physicsManager_->addTrajectoryObjects(
+          trajVisName, trajectories, colorVecs, numSegments, radius, smooth,
+          numInterp, numThreads);
+    }
+    return ID_UNDEFINED;
+  }
   /**
    * @brief Remove a trajectory visualization by name.
    * @param trajVisName The name of the trajectory visualization to remove.
@@ -605,6 +874,50 @@ class Simulator {
                              scene::SceneNode& agentParentNode);
   agent::Agent::ptr addAgent(const agent::AgentConfiguration& agentConfig);
 
+  /**
+   * @brief Perform one action with every agent in a single call
+   * @param actionIndices   Index of the action of each agent, one per agent,
+   *    see @ref agent::Agent::getActionNames(). Agents with a negative index
+   *    don't act.
+   * @return Whether each agent performed its action, false for agents that
+   *    didn't act or got an index out of range
+   *
+   * Same as @ref agent::Agent::act() for each agent, except that the moves
+   * of all body actions are filtered against the navmesh with a single @ref
+   * nav::PathFinder::trySteps() call instead of a
+   * @ref nav::PathFinder::tryStep() per agent. The NavMesh poly each agent
+   * ends up on is kept for its next step, so the nearest poly search is
+   * usually skipped.
+   */
+  std::vector<bool> actAgents(const std::vector<int>& actionIndices);
+
+  /**
+   * @brief Sample a batch of random agent states on the navmesh
+   * @param numStates           Number of states to sample
+   * @param minIslandArea       Reject positions on navmesh islands with less
+   *    navigable area, see @ref nav::PathFinder::getNavigableArea()
+   * @param minObstacleDistance Reject positions closer to an obstacle, see
+   *    @ref nav::PathFinder::distanceToClosestObstacle()
+   * @param islandIndex         Optionally sample from this island only
+   * @param maxTries            Rounds of resampling the rejected states
+   * @param numThreads          Number of threads sampling the positions and
+   *    evaluating the filters. Values <= 0 use the hardware concurrency.
+   * @return The sampled states, fewer than @p numStates if too many samples
+   *    were rejected within @p maxTries rounds
+   *
+   * Batched version of @ref sampleRandomAgentState() drawing the positions
+   * with @ref nav::PathFinder::getRandomNavigablePoints(). The positions and
+   * rotations only depend on the seed of the simulator, not on
+   * @p numThreads.
+   */
+  std::vector<agent::AgentState> sampleRandomAgentStates(
+      int numStates,
+      float minIslandArea = 0.0f,
+      float minObstacleDistance = 0.0f,
+      int islandIndex = ID_UNDEFINED,
+      int maxTries = 10,
+      int numThreads = 0);
+
   /**
    * @brief Initialize sensor and attach to sceneNode of a particular object
    * @param objectId    Id of the object to which a sensor will be initialized
@@ -678,13 +991,74 @@ class Simulator {
 
   bool visualizeObservation(int agentId, const std::string& sensorId);
 
+  /**
+   * @brief draw the observations of all visual sensors of an agent to the
+   * frame buffers stored in the sensors.
+   *
+   * If @ref SimulatorConfiguration::enableSharedSensorRendering is set, camera
+   * sensors sharing a pose, projection matrix, resolution, clear color and
+   * scene graph are drawn in a single pass into the render target of one of
+   * them, which gets all attachments (see @ref
+   * gfx::Renderer::Flag::AllAttachments), and the others read their
+   * observations from it (see @ref
+   * sensor::VisualSensor::observationRenderTarget). At most one semantic
+   * target is drawn per pass; semantic sensors rendering a separate semantic
+   * scene graph, and color sensors when HBAO is enabled or debug lines are
+   * pending, are always drawn on their own.
+   * @param agentId    Id of the agent whose sensors are drawn
+   * @return The number of passes drawn
+   */
+  int drawAgentObservations(int agentId);
+
   bool getAgentObservation(int agentId,
                            const std::string& sensorId,
                            sensor::Observation& observation);
+  /**
+   * @brief get the observations of all sensors of an agent. Visual sensors are
+   * drawn via @ref drawAgentObservations if @ref
+   * SimulatorConfiguration::enableSharedSensorRendering is set.
+   *
+   * Only sensors due in their @ref sensor::SensorSpec::updatePeriod schedule
+   * are drawn, the others return the observation of their last update (see
+   * @ref sensor::Sensor::getCachedObservation).
+   * @return The number of observations
+   */
   int getAgentObservations(
       int agentId,
       std::map<std::string, sensor::Observation>& observations);
 
+  /**
+   * @brief Start drawing the observations of the visual sensors of an agent on
+   * the background render thread, pipelined with physics.
+   *
+   * The scene state the sensors see is captured before returning (see @ref
+   * gfx::Renderer::snapshotDrawJobs), so e.g. @ref stepWorld can run on the
+   * calling thread while the frame is rendered. Sensors that can't be drawn in
+   * the background (neither pinhole nor orthographic) are drawn right away.
+   * Objects and sensors may not be added or removed until @ref
+   * finishAsyncAgentObservations is called. Requires the background renderer.
+   * @param agentId    Id of the agent whose sensors are drawn
+   * @return The number of sensors drawn in the background
+   */
+  int startAsyncAgentObservations(int agentId);
+
+  /**
+   * @brief Wait for the observations started by @ref
+   * startAsyncAgentObservations and get the observations of all sensors of the
+   * agent.
+   * @return The number of observations
+   */
+  int finishAsyncAgentObservations(
+      std::map<std::string, sensor::Observation>& observations);
+
+  /**
+   * @brief Whether observations started by @ref startAsyncAgentObservations
+   * are yet to be finished.
+   */
+  bool asyncAgentObservationsInFlight() const {
+    return asyncObservationAgentId_ != ID_UNDEFINED;
+  }
+
   bool getAgentObservationSpace(int agentId,
                                 const std::string& sensorId,
                                 sensor::ObservationSpace& space);
@@ -739,6 +1113,50 @@ class Simulator {
     resourceManager_->setLightSetup(std::move(lightSetup), key);
   }
 
+  /**
+   * @brief Number of light setup changes so far, see @ref
+   * assets::ResourceManager::lightSetupVersion.
+   */
+  std::uint64_t getLightSetupVersion() const {
+    return resourceManager_->lightSetupVersion();
+  }
+
+  /**
+   * @brief Start reading and decoding the given render asset files in the
+   * background, so that loading them with a later @ref reconfigure() or object
+   * instantiation is faster. See @ref assets::ResourceManager::prefetchAssets.
+   *
+   * @param filepaths Render asset files of e.g. the next scene's stage and
+   * objects.
+   */
+  void prefetchRenderAssets(const std::vector<std::string>& filepaths) {
+    std::vector<assets::AssetInfo> assetInfos;
+    assetInfos.reserve(filepaths.size());
+    for (const std::string& filepath : filepaths) {
+      assetInfos.push_back({assets::AssetType::UNKNOWN, filepath});
+    }
+    resourceManager_->prefetchAssets(assetInfos);
+  }
+
+  /**
+   * @brief Load and unload the object instances of a streamed scene based on
+   * the current agent positions.
+   *
+   * Does nothing unless @ref SimulatorConfiguration::sceneStreamingCellSize
+   * is positive. Object instances of the scene are then partitioned into a
+   * grid of cells, see @ref SceneStreamer, and only cells within @ref
+   * SimulatorConfiguration::sceneStreamingRadius of an agent are instanced.
+   * Render assets of cells just beyond the radius are prefetched in the
+   * background, see @ref prefetchRenderAssets, and objects of cells the
+   * agents moved away from are removed. Called when the scene is created and
+   * by @ref stepWorld, call it directly to stream without stepping physics.
+   *
+   * Objects of a cell get new IDs every time the cell is loaded again, and a
+   * streamed object the user removed stays removed only until its cell is
+   * unloaded.
+   */
+  void updateSceneStreaming();
+
   //============= Object Rigid Constraint API =============
 
   /**
@@ -825,6 +1243,17 @@ class Simulator {
       const assets::AssetInfo& assetInfo,
       const assets::RenderAssetInstanceCreationInfo& creation);
 
+  /**
+   * @brief Estimate how much CPU and GPU memory the loaded scene takes, per
+   * subsystem.
+   *
+   * Sizes are computed from the element counts and capacities of the held
+   * containers, not measured, and don't include allocator overhead or memory
+   * internal to Bullet, Recast or the GL driver. Assets in a shared pool are
+   * counted in every simulator that uses them.
+   */
+  MemoryReport getMemoryReport() const;
+
   /**
    * @brief Runtime perf stats are various scalars helpful for troubleshooting
    * runtime perf.
@@ -840,14 +1269,71 @@ class Simulator {
    *
    * @return a vector of stat values. Stat values generally change after every
    * physics step. See also getRuntimePerfStatNames.
+   *
+   * The timing stats are the mean durations in milliseconds of the profiled
+   * sections over the rolling window of @ref esp::core::Profiler::global(),
+   * and stay zero unless @ref setProfilingEnabled() was called. The GPU
+   * durations additionally need its @p gpuTimers and lag a frame or two
+   * behind.
    */
   std::vector<float> getRuntimePerfStatValues();
 
+  /**
+   * @brief Scene load perf stats break the duration of the last @ref
+   * reconfigure() down into its phases.
+   *
+   * @return A vector of stat names; this is constant so it can be called once
+   * at startup. See also getSceneLoadPerfStatValues.
+   */
+  std::vector<std::string> getSceneLoadPerfStatNames();
+
+  /**
+   * @brief Scene load perf stats break the duration of the last @ref
+   * reconfigure() down into its phases.
+   *
+   * @return a vector of stat values in milliseconds: the whole reconfigure,
+   * then the summed durations of metadata parsing, asset import, GPU upload,
+   * collision shape construction, navmesh loading and semantic scene loading
+   * in it. The GPU upload is part of the asset import, the rest of the
+   * phases don't overlap. See also getSceneLoadPerfStatNames.
+   *
+   * The values stay zero unless @ref setProfilingEnabled() was called before
+   * the reconfigure, or before creating the simulator for the first one.
+   */
+  std::vector<float> getSceneLoadPerfStatValues() const {
+    return sceneLoadPerfStatValues_;
+  }
+
+  /**
+   * @brief Enable timing of physics stepping, scene node updates, culling,
+   * drawing, readback, replay recording and the scene load phases in @ref
+   * esp::core::Profiler::global()
+   * @param enabled     Whether to time the sections
+   * @param keepTrace   Whether to also keep every sample for @ref
+   *    esp::core::Profiler::writeChromeTrace()
+   * @param gpuTimers   Whether to also measure the GPU durations of drawing,
+   *    HBAO, cube map faces and readback with GL timer queries, see @ref
+   *    esp::core::Profiler::setGpuTimersEnabled()
+   *
+   * The profiler is shared by all simulators in the process.
+   */
+  void setProfilingEnabled(bool enabled,
+                           bool keepTrace = false,
+                           bool gpuTimers = false);
+
  protected:
   Simulator() = default;
 
   /**
-   * @brief if Navmesh visualization is active, reset the visualization.
+   * @brief Draw @p visualSensors as described in @ref drawAgentObservations
+   * @return The number of passes drawn
+   */
+  int drawVisualSensorObservations(
+      const std::vector<sensor::VisualSensor*>& visualSensors);
+
+  /**
+   * @brief if Navmesh visualization is active, reset the visualization,
+   * re-uploading only the NavMesh tiles that changed.
    */
   void resetNavMeshVisIfActive() {
     if (isNavMeshVisualizationActive()) {
@@ -939,6 +1425,8 @@ class Simulator {
   void reconfigureReplayManager(bool enableGfxReplaySave);
 
   gfx::WindowlessContext::uptr context_ = nullptr;
+  // whether context_ came from the context pool and goes back there on close
+  bool contextPooled_ = false;
   std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
   // CANNOT make the specification of resourceManager_ above the context_!
   // Because when deconstructing the resourceManager_, it needs
@@ -971,6 +1459,16 @@ class Simulator {
 
   std::vector<int> sceneID_;
 
+  //! Scene streaming state, see @ref updateSceneStreaming(). Empty unless
+  //! streaming is enabled.
+  std::unique_ptr<SceneStreamer> sceneStreamer_;
+  std::vector<metadata::attributes::SceneObjectInstanceAttributes::cptr>
+      streamedObjectInstances_;
+  std::vector<std::string> streamedObjectHandles_;
+  // ID of each streamed instance, ID_UNDEFINED if not loaded
+  std::vector<int> streamedObjectIds_;
+  bool streamedObjectCOMCorrection_ = false;
+
   std::shared_ptr<physics::PhysicsManager> physicsManager_ = nullptr;
 
   std::shared_ptr<esp::gfx::replay::ReplayManager> gfxReplayMgr_;
@@ -979,6 +1477,9 @@ class Simulator {
   SimulatorConfiguration config_;
 
   std::vector<agent::Agent::ptr> agents_;
+  // NavMesh poly of each agent after its last move in actAgents(), 0 if
+  // unknown
+  std::vector<uint64_t> agentPolyRefs_;
 
   nav::PathFinder::ptr pathfinder_;
   // state indicating frustum culling is enabled or not
@@ -993,7 +1494,7 @@ class Simulator {
   bool frustumCulling_ = true;
 
   //! NavMesh visualization variables
-  int navMeshVisPrimID_ = esp::ID_UNDEFINED;
+  std::unique_ptr<NavMeshOverlay> navMeshOverlay_;
   esp::scene::SceneNode* navMeshVisNode_ = nullptr;
 
   /**
@@ -1007,6 +1508,14 @@ class Simulator {
 
   std::vector<float> runtimePerfStatValues_;
 
+  std::vector<float> sceneLoadPerfStatValues_;
+
+  //! agent whose observations are being drawn in the background, if any
+  int asyncObservationAgentId_ = ID_UNDEFINED;
+  //! observations being drawn in the background or drawn right away by @ref
+  //! startAsyncAgentObservations
+  std::map<std::string, sensor::Observation> asyncObservations_;
+
   ESP_SMART_POINTERS(Simulator)
 };
 
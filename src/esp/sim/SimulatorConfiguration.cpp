@@ -20,6 +20,21 @@ bool operator==(const SimulatorConfiguration& a,
          a.forceSeparateSemanticSceneGraph ==
              b.forceSeparateSemanticSceneGraph &&
          a.requiresTextures == b.requiresTextures &&
+         a.numAssetDecodeThreads == b.numAssetDecodeThreads &&
+         a.assetCacheBudget == b.assetCacheBudget &&
+         a.shareGpuResources == b.shareGpuResources &&
+         a.poolGlContexts == b.poolGlContexts &&
+         a.semanticMeshCacheDirectory == b.semanticMeshCacheDirectory &&
+         a.clusterSemanticMeshes == b.clusterSemanticMeshes &&
+         a.packTextureArrays == b.packTextureArrays &&
+         a.optimizeMeshes == b.optimizeMeshes &&
+         a.quantizeMeshes == b.quantizeMeshes &&
+         a.optimizedMeshCacheDirectory == b.optimizedMeshCacheDirectory &&
+         a.iblMapCacheDirectory == b.iblMapCacheDirectory &&
+         a.collisionBvhCacheDirectory == b.collisionBvhCacheDirectory &&
+         a.sharedAssetMemoryDirectory == b.sharedAssetMemoryDirectory &&
+         a.shaderProgramCacheDirectory == b.shaderProgramCacheDirectory &&
+         a.metadataCacheDirectory == b.metadataCacheDirectory &&
          a.leaveContextWithBackgroundRenderer ==
              b.leaveContextWithBackgroundRenderer &&
          a.useSemanticTexturesIfFound == b.useSemanticTexturesIfFound &&
@@ -27,7 +42,14 @@ bool operator==(const SimulatorConfiguration& a,
          a.physicsConfigFile == b.physicsConfigFile &&
          a.overrideSceneLightDefaults == b.overrideSceneLightDefaults &&
          a.sceneLightSetupKey == b.sceneLightSetupKey &&
-         a.enableHBAO == b.enableHBAO && a.navMeshSettings == b.navMeshSettings;
+         a.enableHBAO == b.enableHBAO &&
+         a.enableDepthPrePass == b.enableDepthPrePass &&
+         a.navMeshSettings == b.navMeshSettings &&
+         a.mapNavMeshFile == b.mapNavMeshFile &&
+         a.enableSharedSensorRendering == b.enableSharedSensorRendering &&
+         a.skipUnchangedFrames == b.skipUnchangedFrames &&
+         a.sceneStreamingCellSize == b.sceneStreamingCellSize &&
+         a.sceneStreamingRadius == b.sceneStreamingRadius;
 }
 
 bool operator!=(const SimulatorConfiguration& a,
@@ -64,6 +64,121 @@ struct SimulatorConfiguration {
    */
   bool requiresTextures = true;
 
+  /**
+   * @brief Number of threads decoding texture images while loading render
+   * assets. Values <= 0 select the hardware concurrency of the machine, 1
+   * decodes on the calling thread only.
+   */
+  int numAssetDecodeThreads = 0;
+
+  /**
+   * @brief Memory budget in bytes for render assets kept loaded across scene
+   * switches. When exceeded after a scene is created, the least recently used
+   * assets the scene doesn't use are unloaded. 0 keeps every asset loaded
+   * until @ref esp::sim::Simulator::close().
+   */
+  std::size_t assetCacheBudget = 0;
+
+  /**
+   * @brief Create the GL context in a process-wide share group and share the
+   * GPU resources of render assets with all other simulators in the process
+   * doing the same, instead of uploading a copy per simulator. Supported only
+   * for windowless contexts on desktop GL.
+   */
+  bool shareGpuResources = false;
+
+  /**
+   * @brief Take the windowless GL context from a process-wide pool and give it
+   * back on @ref Simulator::close(), so simulators created again later in the
+   * process reuse it instead of creating a new one. See
+   * @ref esp::gfx::WindowlessContext::acquirePooled().
+   */
+  bool poolGlContexts = false;
+
+  /**
+   * @brief Existing directory caching the semantic meshes built from
+   * vertex-annotated semantic assets, so later loads of the same asset skip
+   * building them. Empty disables the cache.
+   */
+  std::string semanticMeshCacheDirectory;
+
+  /**
+   * @brief Draw each vertex-annotated semantic mesh with a single drawable,
+   * culling clusters of its triangles, instead of partitioning it into a mesh
+   * per semantic region. See
+   * @ref esp::assets::ResourceManager::setClusterSemanticMeshes().
+   */
+  bool clusterSemanticMeshes = false;
+
+  /**
+   * @brief Pack the base color, metallic-roughness, normal and emissive
+   * textures of materials rendered with the PBR shader into texture arrays
+   * sharing size, format and sampler state. Not used together with
+   * @ref shareGpuResources.
+   */
+  bool packTextureArrays = false;
+
+  /**
+   * @brief Merge duplicate vertices and reorder the triangles and vertices of
+   * render asset meshes for the GPU vertex caches when importing them.
+   */
+  bool optimizeMeshes = false;
+
+  /**
+   * @brief Store the positions, normals and texture coordinates of render
+   * asset meshes in 16-bit formats, cutting their GPU memory and vertex
+   * bandwidth.
+   */
+  bool quantizeMeshes = false;
+
+  /**
+   * @brief Existing directory caching the meshes optimized with
+   * @ref optimizeMeshes, so later loads of the same asset read them instead of
+   * optimizing them again. Empty disables the cache.
+   */
+  std::string optimizedMeshCacheDirectory;
+
+  /**
+   * @brief Existing directory caching the irradiance and prefiltered
+   * environment maps computed for image based lighting, so later loads of the
+   * same environment map, also in other processes, read them instead of
+   * computing them. Empty disables the cache.
+   */
+  std::string iblMapCacheDirectory;
+
+  /**
+   * @brief Existing directory caching the BVHs of stage collision meshes, so
+   * later loads of the same stage, also in other processes, read them instead
+   * of building them. Empty disables the cache.
+   */
+  std::string collisionBvhCacheDirectory;
+
+  /**
+   * @brief Directory on a memory-backed file system, e.g. under `/dev/shm`,
+   * through which all processes on a node share a single read-only copy of
+   * the collision data of the scenes they load. Created if it doesn't exist,
+   * never cleaned up. Empty disables sharing. See
+   * @ref esp::assets::SharedMemoryAssetStore.
+   */
+  std::string sharedAssetMemoryDirectory;
+
+  /**
+   * @brief Existing directory caching the linked PBR shader programs, so
+   * later processes on the same GL driver load them instead of compiling
+   * them. Empty disables the cache. Applies to all simulators in the process,
+   * see @ref esp::gfx::PbrShader::setProgramBinaryCacheDirectory().
+   */
+  std::string shaderProgramCacheDirectory;
+
+  /**
+   * @brief Existing directory holding snapshots of the JSON files and
+   * directory listings read while loading scene datasets, so later processes
+   * loading the same dataset read a single file instead of walking the
+   * dataset. Outdated entries are refreshed automatically. Empty disables the
+   * snapshots.
+   */
+  std::string metadataCacheDirectory;
+
   /**
    * @brief Leave the context with the background thread after finishing draw
    * jobs. This will improve performance as transferring the OpenGL context back
@@ -103,12 +218,55 @@ struct SimulatorConfiguration {
    */
   nav::NavMeshSettings::ptr navMeshSettings = nullptr;
 
+  /**
+   * @brief Memory map the scene's .navmesh file instead of copying it,
+   * sharing the tile data across all processes loading the same file. See
+   * @ref nav::PathFinder::loadNavMeshMapped.
+   */
+  bool mapNavMeshFile = false;
+
   /**
    * @brief Enable HBAO visual effect that adds soft shadows to corners and
    * crevices.
    */
   bool enableHBAO = false;
 
+  /**
+   * @brief Draw a depth-only pre-pass before the color pass of color sensors,
+   * so the full shaders run only once per pixel. See @ref
+   * gfx::Renderer::Flag::DepthPrePass.
+   */
+  bool enableDepthPrePass = false;
+
+  /**
+   * @brief Draw co-located camera sensors of an agent that share their
+   * projection, resolution and clear color in a single pass, see @ref
+   * Simulator::drawAgentObservations.
+   */
+  bool enableSharedSensorRendering = false;
+
+  /**
+   * @brief Return the previous observation of camera sensors without drawing
+   * or reading it again when nothing they see changed, see @ref
+   * gfx::Renderer::Flag::SkipUnchangedFrames.
+   */
+  bool skipUnchangedFrames = false;
+
+  /**
+   * @brief Edge length of the grid cells the scene's object instances are
+   * streamed in, in meters. If positive, only the object instances of cells
+   * within @ref sceneStreamingRadius of an agent are instanced, see @ref
+   * Simulator::updateSceneStreaming. @cpp 0.0f @ce instances all objects when
+   * the scene is created.
+   */
+  float sceneStreamingCellSize = 0.0f;
+
+  /**
+   * @brief Distance from an agent within which the cells of a streamed scene
+   * are loaded, see @ref sceneStreamingCellSize.
+   */
+  float sceneStreamingRadius = 20.0f;
+
   ESP_SMART_POINTERS(SimulatorConfiguration)
 };
 
@@ -0,0 +1,121 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "VectorSimulator.h"
+
+#include "esp/core/Check.h"
+#include "esp/metadata/MetadataMediator.h"
+
+namespace esp {
+namespace sim {
+
+namespace {
+std::vector<SimulatorConfiguration> seededConfigurations(
+    const SimulatorConfiguration& cfg,
+    const std::size_t numEnvironments) {
+  std::vector<SimulatorConfiguration> cfgs(numEnvironments, cfg);
+  for (std::size_t i = 0; i != numEnvironments; ++i) {
+    cfgs[i].randomSeed = cfg.randomSeed + i;
+  }
+  return cfgs;
+}
+}  // namespace
+
+VectorSimulator::VectorSimulator(
+    const std::vector<SimulatorConfiguration>& cfgs,
+    const int numThreads)
+    : stepper_{numThreads} {
+  ESP_CHECK(!cfgs.empty(),
+            "VectorSimulator: expecting at least one environment");
+  for (const SimulatorConfiguration& cfg : cfgs) {
+    ESP_CHECK(cfg.sceneDatasetConfigFile == cfgs[0].sceneDatasetConfigFile &&
+                  cfg.physicsConfigFile == cfgs[0].physicsConfigFile,
+              "VectorSimulator: all environments have to use the same scene "
+              "dataset and physics configuration");
+  }
+
+  metadata::MetadataMediator::ptr metadataMediator =
+      metadata::MetadataMediator::create(cfgs[0]);
+  environments_.reserve(cfgs.size());
+  environmentPointers_.reserve(cfgs.size());
+  for (const SimulatorConfiguration& cfg : cfgs) {
+    SimulatorConfiguration envCfg = cfg;
+    envCfg.shareGpuResources = envCfg.createRenderer;
+    environments_.push_back(
+        Simulator::create_unique(envCfg, metadataMediator));
+    environmentPointers_.push_back(environments_.back().get());
+  }
+}
+
+VectorSimulator::VectorSimulator(const SimulatorConfiguration& cfg,
+                                 const std::size_t numEnvironments,
+                                 const int numThreads)
+    : VectorSimulator{seededConfigurations(cfg, numEnvironments), numThreads} {
+}
+
+VectorSimulator::~VectorSimulator() = default;
+
+Simulator& VectorSimulator::environment(const std::size_t envIndex) {
+  ESP_CHECK(envIndex < environments_.size(),
+            "VectorSimulator::environment(): index"
+                << envIndex << "out of range for" << environments_.size()
+                << "environments");
+  return *environments_[envIndex];
+}
+
+std::vector<agent::Agent::ptr> VectorSimulator::addAgents(
+    const agent::AgentConfiguration& agentConfig) {
+  std::vector<agent::Agent::ptr> agents;
+  agents.reserve(environments_.size());
+  for (Simulator::uptr& env : environments_) {
+    agents.push_back(env->addAgent(agentConfig));
+  }
+  return agents;
+}
+
+void VectorSimulator::reset() {
+  for (Simulator::uptr& env : environments_) {
+    env->reset();
+  }
+}
+
+std::vector<double> VectorSimulator::step(
+    const std::vector<std::string>& actions,
+    const int agentId,
+    const double dt) {
+  ESP_CHECK(actions.size() == environments_.size(),
+            "VectorSimulator::step(): expected" << environments_.size()
+                << "actions but got" << actions.size());
+  // moving the agents is cheap next to stepping physics, so it's done here
+  // instead of on the stepper threads
+  for (std::size_t i = 0; i != environments_.size(); ++i) {
+    if (!actions[i].empty()) {
+      environments_[i]->getAgent(agentId)->act(actions[i]);
+    }
+  }
+  return Simulator::stepWorlds(environmentPointers_, stepper_, dt);
+}
+
+int VectorSimulator::getObservations(
+    const int agentId,
+    std::vector<std::map<std::string, sensor::Observation>>& observations) {
+  observations.resize(environments_.size());
+  for (Simulator::uptr& env : environments_) {
+    env->startAsyncAgentObservations(agentId);
+  }
+  int numObservations = 0;
+  for (std::size_t i = 0; i != environments_.size(); ++i) {
+    numObservations +=
+        environments_[i]->finishAsyncAgentObservations(observations[i]);
+  }
+  return numObservations;
+}
+
+void VectorSimulator::close() {
+  environmentPointers_.clear();
+  environments_.clear();
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,137 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_VECTORSIMULATOR_H_
+#define ESP_SIM_VECTORSIMULATOR_H_
+
+/** @file
+ * @brief Class @ref esp::sim::VectorSimulator
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "esp/agent/Agent.h"
+#include "esp/core/Esp.h"
+#include "esp/physics/MultiWorldStepper.h"
+#include "esp/sensor/Sensor.h"
+#include "esp/sim/Simulator.h"
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Several environments stepped and observed as a batch in one process
+ *
+ * Each environment is a @ref Simulator with its own scene graph, physics world
+ * and agents. All of them share one @ref metadata::MetadataMediator and, with
+ * a renderer, the GPU resources of their render assets (see @ref
+ * SimulatorConfiguration::shareGpuResources), so a scene used by several
+ * environments is loaded and uploaded once instead of once per process.
+ *
+ * @ref step() applies an action to the agent of every environment and steps
+ * all physics worlds on a thread pool, @ref getObservations() draws the
+ * sensors of all environments at once, each on the background render thread
+ * of its environment if the background renderer is built.
+ */
+class VectorSimulator {
+ public:
+  /**
+   * @brief Constructor
+   * @param cfgs        Configuration of each environment. All of them have to
+   *    use the same scene dataset and physics configuration,
+   *    @ref SimulatorConfiguration::shareGpuResources is enabled for all
+   *    environments creating a renderer.
+   * @param numThreads  The number of threads stepping the physics worlds,
+   *    including the calling thread. Values <= 0 select the hardware
+   *    concurrency of the machine.
+   */
+  explicit VectorSimulator(const std::vector<SimulatorConfiguration>& cfgs,
+                           int numThreads = 0);
+
+  /**
+   * @brief Construct @p numEnvironments environments from the same @p cfg
+   *
+   * Environment @f$ i @f$ is seeded with
+   * @ref SimulatorConfiguration::randomSeed + @f$ i @f$, so the environments
+   * don't all sample the same agent states.
+   */
+  explicit VectorSimulator(const SimulatorConfiguration& cfg,
+                           std::size_t numEnvironments,
+                           int numThreads = 0);
+
+  ~VectorSimulator();
+
+  /** @brief Number of environments */
+  std::size_t numEnvironments() const { return environments_.size(); }
+
+  /** @brief Number of threads stepping the physics worlds */
+  int numThreads() const { return stepper_.numThreads(); }
+
+  /** @brief The simulator of an environment */
+  Simulator& environment(std::size_t envIndex);
+
+  /**
+   * @brief Add an agent with @p agentConfig to every environment
+   * @return The agent added to each environment
+   */
+  std::vector<agent::Agent::ptr> addAgents(
+      const agent::AgentConfiguration& agentConfig);
+
+  /** @brief Reset all environments, see @ref Simulator::reset() */
+  void reset();
+
+  /**
+   * @brief Step all environments
+   * @param actions   The action performed by the agent @p agentId of each
+   *    environment, one per environment. Empty names and actions the agent
+   *    doesn't have are skipped.
+   * @param agentId   Id of the agent acting in every environment
+   * @param dt        The desired amount of time to advance the physical
+   *    worlds, see @ref Simulator::stepWorlds()
+   * @return The new world time of each environment, @ref esp::NO_TIME for
+   *    environments without physics
+   *
+   * The actions are all applied before the physics worlds are stepped
+   * concurrently.
+   */
+  std::vector<double> step(const std::vector<std::string>& actions,
+                           int agentId = 0,
+                           double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Get the observations of all sensors of the agent @p agentId of
+   * every environment
+   * @param agentId       Id of the agent whose sensors are drawn
+   * @param observations  Filled with the observations of each environment,
+   *    resized to @ref numEnvironments()
+   * @return The number of observations of all environments
+   *
+   * The drawing of all environments is started before waiting for any of
+   * them, see @ref Simulator::startAsyncAgentObservations(). As there, the
+   * semantic sensors of environments with a separate semantic scene graph
+   * can't be drawn this way, use @ref Simulator::getAgentObservations() on
+   * the @ref environment() then.
+   */
+  int getObservations(
+      int agentId,
+      std::vector<std::map<std::string, sensor::Observation>>& observations);
+
+  /** @brief Close and destroy all environments */
+  void close();
+
+  ESP_SMART_POINTERS(VectorSimulator)
+
+ private:
+  std::vector<Simulator::uptr> environments_;
+  // all environments, for Simulator::stepWorlds()
+  std::vector<Simulator*> environmentPointers_;
+  physics::MultiWorldStepper stepper_;
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_VECTORSIMULATOR_H_
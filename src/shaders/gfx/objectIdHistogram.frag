@@ -0,0 +1,13 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+
+// ------------ output -----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_COLOR)
+out highp float pixelCount;
+
+// ------------ shader -----------------------
+void main() {
+  pixelCount = 1.0;
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+precision highp int;
+
+// Draws one point per pixel of the object ID texture, onto the texel of the
+// bin of its ID. With additive blending the bin texture counts the pixels.
+
+// ------------ uniform ----------------------
+uniform highp usampler2D ObjectIdTexture;
+uniform highp uint BinCount;
+uniform highp int BinsPerRow;
+uniform highp vec2 BinTextureSize;
+
+// ------------ shader -----------------------
+void main() {
+  ivec2 size = textureSize(ObjectIdTexture, 0);
+  ivec2 pixel = ivec2(gl_VertexID % size.x, gl_VertexID / size.x);
+  highp uint id = texelFetch(ObjectIdTexture, pixel, 0).r;
+  if (id >= BinCount) {
+    // outside of the clip volume, IDs past the last bin aren't counted
+    gl_Position = vec4(2.0, 2.0, 0.0, 1.0);
+  } else {
+    ivec2 bin = ivec2(int(id) % BinsPerRow, int(id) / BinsPerRow);
+    gl_Position =
+        vec4((vec2(bin) + vec2(0.5)) / BinTextureSize * 2.0 - vec2(1.0), 0.0,
+             1.0);
+  }
+  gl_PointSize = 1.0;
+}
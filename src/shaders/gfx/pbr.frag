@@ -33,7 +33,15 @@ void main() {
   // compute contribution of each light using the microfacet model
   // the following part of the code is inspired by the Phong.frag in Magnum
   // library (https://magnum.graphics/)
+#if defined(CLUSTERED_LIGHTING)
+  // only the lights influencing the cluster of this fragment
+  uvec2 lightCluster = lightClusterOfFragment();
+  for (uint iClusterLight = lightCluster.x;
+       iClusterLight < lightCluster.x + lightCluster.y; ++iClusterLight) {
+    int iLight = int(texelFetch(uLightClusterIndices, int(iClusterLight)).r);
+#else
   for (int iLight = 0; iLight < LIGHT_COUNT; ++iLight) {
+#endif
     // Build a light info for this light
     LightInfo l;
     if (!buildLightInfoFromLightIdx(iLight, pbrInfo, l)) {
@@ -216,7 +224,11 @@ void main() {
 #endif  // MAP_OUTPUT_TO_SRGB
 
 #if defined(OBJECT_ID)
-  fragmentObjectId = uObjectId;
+  fragmentObjectId =
+#if defined(INSTANCED_OBJECT_ID)
+      interpolatedInstanceObjectId +
+#endif
+      uObjectId;
 #endif
 
 // PBR equation debug
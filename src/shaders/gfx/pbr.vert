@@ -19,6 +19,17 @@ layout(location = ATTRIBUTE_LOCATION_TANGENT4) in highp vec4 vertexTangent;
 layout(location = ATTRIBUTE_LOCATION_COLOR) in highp vec4 vertexColor;
 #endif
 
+#ifdef INSTANCED_OBJECT_ID
+layout(location = ATTRIBUTE_LOCATION_OBJECT_ID) in highp uint instanceObjectId;
+#endif
+
+#ifdef INSTANCED_TRANSFORMATION
+layout(location = ATTRIBUTE_LOCATION_TRANSFORMATION_MATRIX) in highp mat4
+    instancedTransformationMatrix;
+layout(location = ATTRIBUTE_LOCATION_NORMAL_MATRIX) in highp mat3
+    instancedNormalMatrix;
+#endif
+
 #ifdef JOINT_COUNT
 #if PER_VERTEX_JOINT_COUNT
 layout(location = ATTRIBUTE_LOCATION_WEIGHTS) in mediump vec4 weights;
@@ -56,6 +67,9 @@ out highp vec3 biTangent;
 #ifdef VERTEX_COLOR
 out highp vec4 interpolatedVertexColor;
 #endif
+#ifdef INSTANCED_OBJECT_ID
+flat out highp uint interpolatedInstanceObjectId;
+#endif
 // ------------ uniform ----------------------
 uniform highp mat4 uViewMatrix;
 uniform highp mat3 uNormalMatrix;  // inverse transpose of 3x3 model matrix, NOT
@@ -116,13 +130,22 @@ void main() {
   //------------ end skin support
 
   vec4 vertexWorldPosition = uModelMatrix *
+#ifdef INSTANCED_TRANSFORMATION
+                             instancedTransformationMatrix *
+#endif
 #ifdef JOINT_COUNT
                              skinMatrix *
 #endif
                              vertexPosition;
 
+#ifdef INSTANCED_TRANSFORMATION
+  highp mat3 normalMatrix = uNormalMatrix * instancedNormalMatrix;
+#else
+  highp mat3 normalMatrix = uNormalMatrix;
+#endif
+
   position = vertexWorldPosition.xyz;
-  normal = normalize(uNormalMatrix * vertexNormal);
+  normal = normalize(normalMatrix * vertexNormal);
 #if defined(TEXTURED)
   texCoord =
 #if defined(TEXTURE_TRANSFORMATION)
@@ -133,7 +156,7 @@ void main() {
 #endif  // TEXTURED
 
 #if defined(NORMAL_TEXTURE) && defined(PRECOMPUTED_TANGENT)
-  tangent = normalize(uNormalMatrix * vec3(vertexTangent));
+  tangent = normalize(normalMatrix * vec3(vertexTangent));
   // Gram–Schmidt
   tangent = normalize(tangent - dot(tangent, normal) * normal);
   biTangent = normalize(cross(normal, tangent) * vertexTangent.w);
@@ -145,6 +168,9 @@ void main() {
   /* Vertex colors, if enabled */
   interpolatedVertexColor = vertexColor;
 #endif
+#ifdef INSTANCED_OBJECT_ID
+  interpolatedInstanceObjectId = instanceObjectId;
+#endif
 
   gl_Position = uProjectionMatrix * uViewMatrix * vertexWorldPosition;
 }
@@ -99,6 +99,21 @@ bool buildLightInfoFromLightIdx(int iLight, PBRData pbrInfo, out LightInfo l) {
   return true;
 }  // buildLightInfoFromLightIdx
 
+#if defined(CLUSTERED_LIGHTING)
+// Offset into uLightClusterIndices and count of the lights of the cluster
+// this fragment is in
+uvec2 lightClusterOfFragment() {
+  float depth = dot(uClusterDepthPlane, vec4(position, 1.0));
+  int slice = clamp(
+      int(log(max(depth, EPSILON)) * uClusterScale.z + uClusterScale.w), 0,
+      CLUSTER_DEPTH_SLICES - 1);
+  ivec2 tile = clamp(ivec2(gl_FragCoord.xy * uClusterScale.xy), ivec2(0),
+                     ivec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+  int cluster = (slice * CLUSTER_TILES_Y + tile.y) * CLUSTER_TILES_X + tile.x;
+  return texelFetch(uLightClusters, cluster).rg;
+}  // lightClusterOfFragment
+#endif  // CLUSTERED_LIGHTING
+
 #if defined(ANISOTROPY_LAYER)
 
 // Configure a light-dependent AnisotropyDirectLight object
@@ -211,12 +226,19 @@ vec3 computeIBLSpecular(float roughness,
   vec2 brdfSamplePt =
       clamp(vec2(n_dot_v, 1.0 - roughness), vec2(0.0, 0.0), vec2(1.0, 1.0));
   vec3 brdf = texture(uBrdfLUT, brdfSamplePt).rgb;
+#if defined(FAST_IBL_SPECULAR)
+  // The irradiance map approximates the prefiltered map at full roughness,
+  // and is small enough to stay in the texture cache
+  vec4 IBLSpecIrradiance =
+      calcFinalIrradiance(getDiffIrradiance(reflectionDir));
+#else
   // LOD roughness scaled by mip levels -1
   float lod = roughness * float(uPrefilteredMapMipLevels - 1u);
   // Query the IBL specular irradiance from the appropriatte cubemap using the
   // specified reflection direction and lod
   vec4 IBLSpecIrradiance =
       calcFinalIrradiance(getSpecIrradiance(reflectionDir, lod));
+#endif  // FAST_IBL_SPECULAR
 
   return (specularReflectance * brdf.x + brdf.y) * IBLSpecIrradiance.rgb;
 }  // computeIBLSpecular
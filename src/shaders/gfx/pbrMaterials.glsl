@@ -114,8 +114,9 @@ PBRData buildPBRData() {
 
 #if defined(NORMAL_TEXTURE) && !defined(SKIP_CALC_NORMAL_TEXTURE)
   // normal is now in the camera space
-  pbrInfo.n = getNormalFromNormalMap(texture(uNormalTexture, texCoord).xyz,
-                                     uNormalTextureScale, pbrInfo.TBN);
+  pbrInfo.n = getNormalFromNormalMap(
+      sampleCoreTexture(uNormalTexture, uTextureLayers.z, texCoord).xyz,
+      uNormalTextureScale, pbrInfo.TBN);
 #else
   pbrInfo.n = normalize(normal);
   // This means backface culling is disabled,
@@ -158,9 +159,11 @@ PBRData buildPBRData() {
 #if defined(BASECOLOR_TEXTURE)
 
 #if defined(MAP_MAT_TXTRS_TO_LINEAR)
-  pbrInfo.baseColor *= sRGBToLinear(texture(uBaseColorTexture, texCoord));
+  pbrInfo.baseColor *= sRGBToLinear(
+      sampleCoreTexture(uBaseColorTexture, uTextureLayers.x, texCoord));
 #else
-  pbrInfo.baseColor *= texture(uBaseColorTexture, texCoord);
+  pbrInfo.baseColor *=
+      sampleCoreTexture(uBaseColorTexture, uTextureLayers.x, texCoord);
 #endif  // MAP_MAT_TXTRS_TO_LINEAR
 #endif  // BASECOLOR_TEXTURE
 
@@ -168,10 +171,11 @@ PBRData buildPBRData() {
 #if defined(EMISSIVE_TEXTURE)
 
 #if defined(MAP_MAT_TXTRS_TO_LINEAR)
-  pbrInfo.emissiveColor *=
-      sRGBToLinear(texture(uEmissiveTexture, texCoord).rgb);
+  pbrInfo.emissiveColor *= sRGBToLinear(
+      sampleCoreTexture(uEmissiveTexture, uTextureLayers.w, texCoord).rgb);
 #else
-  pbrInfo.emissiveColor *= texture(uEmissiveTexture, texCoord).rgb;
+  pbrInfo.emissiveColor *=
+      sampleCoreTexture(uEmissiveTexture, uTextureLayers.w, texCoord).rgb;
 
 #endif  // MAP_MAT_TXTRS_TO_LINEAR
 #endif  // EMISSIVE_TEXTURE
@@ -182,7 +186,8 @@ PBRData buildPBRData() {
   pbrInfo.metallic = uMaterial.metallic;
 #if defined(NONE_ROUGHNESS_METALLIC_TEXTURE)
   vec3 RoughnessMetallicSample =
-      texture(uMetallicRoughnessTexture, texCoord).rgb;
+      sampleCoreTexture(uMetallicRoughnessTexture, uTextureLayers.y, texCoord)
+          .rgb;
 
   pbrInfo.perceivedRoughness *= RoughnessMetallicSample.g;
   pbrInfo.metallic *= RoughnessMetallicSample.b;
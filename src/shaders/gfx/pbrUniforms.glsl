@@ -19,6 +19,9 @@ in highp vec3 biTangent;
 #ifdef VERTEX_COLOR
 in highp vec4 interpolatedVertexColor;
 #endif
+#ifdef INSTANCED_OBJECT_ID
+flat in highp uint interpolatedInstanceObjectId;
+#endif
 // -------------- uniforms ----------------
 #if defined(OBJECT_ID)
 uniform highp uint uObjectId;
@@ -54,20 +57,32 @@ uniform int uPbrDebugDisplay;
 // MaterialData defined in pbrStructs.glsl
 uniform MaterialData uMaterial;
 
+// The core material textures are either separate 2D textures or layers of
+// texture arrays, in which case uTextureLayers holds the layers of the base
+// color, metallic-roughness, normal and emissive textures.
+#if defined(TEXTURE_ARRAYS)
+#define CORE_TEXTURE_SAMPLER sampler2DArray
+#define sampleCoreTexture(txtr, layer, uv) texture(txtr, vec3(uv, float(layer)))
+uniform highp uvec4 uTextureLayers;
+#else
+#define CORE_TEXTURE_SAMPLER sampler2D
+#define sampleCoreTexture(txtr, layer, uv) texture(txtr, uv)
+#endif
+
 #if defined(BASECOLOR_TEXTURE)
-uniform sampler2D uBaseColorTexture;
+uniform CORE_TEXTURE_SAMPLER uBaseColorTexture;
 #endif
 #if defined(NONE_ROUGHNESS_METALLIC_TEXTURE)
-uniform sampler2D uMetallicRoughnessTexture;
+uniform CORE_TEXTURE_SAMPLER uMetallicRoughnessTexture;
 #endif
 #if defined(NORMAL_TEXTURE)
 uniform float uNormalTextureScale;
-uniform sampler2D uNormalTexture;
+uniform CORE_TEXTURE_SAMPLER uNormalTexture;
 #endif
 // TODO: separate occlusion texture
 // (if it is not packed with metallicRoughness texture)
 #if defined(EMISSIVE_TEXTURE)
-uniform sampler2D uEmissiveTexture;
+uniform CORE_TEXTURE_SAMPLER uEmissiveTexture;
 #endif
 
 #if defined(CLEAR_COAT)
@@ -147,6 +162,18 @@ uniform vec4 uLightDirections[LIGHT_COUNT];
 // Config driven overall direct lighting intensity
 uniform float uDirectLightIntensity;
 
+#if defined(CLUSTERED_LIGHTING)
+// offset into uLightClusterIndices and light count of each cluster
+uniform highp usamplerBuffer uLightClusters;
+// indices of the lights of all clusters
+uniform highp usamplerBuffer uLightClusterIndices;
+// dot product with the world position gives the view depth
+uniform highp vec4 uClusterDepthPlane;
+// .xy scales gl_FragCoord to the tile, .z and .w are the scale and bias of
+// the log view depth giving the depth slice
+uniform highp vec4 uClusterScale;
+#endif  // CLUSTERED_LIGHTING
+
 #endif  // DIRECT_LIGHTING
 
 #if defined(IMAGE_BASED_LIGHTING)
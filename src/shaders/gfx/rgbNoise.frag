@@ -0,0 +1,101 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+
+// ------------ uniform ----------------------
+uniform highp sampler2D SourceTexture;
+uniform highp uint Seed;
+uniform highp uint Frame;
+
+#if defined(GAUSSIAN) || defined(SPECKLE)
+uniform highp float IntensityConstant;
+uniform highp float Mean;
+uniform highp float Sigma;
+#endif
+
+#if defined(SALT_AND_PEPPER)
+uniform highp float Amount;
+uniform highp float SaltVsPepper;
+#endif
+
+#if defined(POISSON)
+uniform highp float Levels;
+#endif
+
+// ------------ output -----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_COLOR)
+out highp vec4 fragmentColor;
+
+// ------------ shader -----------------------
+// PCG hash, see Jarzynski and Olano: Hash Functions for GPU Rendering, JCGT
+// 2020
+highp uint pcgHash(highp uint v) {
+  highp uint state = v * 747796405u + 2891336453u;
+  highp uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+// uniform in [0, 1)
+highp float uniformRandom(inout highp uint state) {
+  state = pcgHash(state);
+  return float(state >> 8u) * (1.0 / 16777216.0);
+}
+
+// standard normal, Box-Muller
+highp float normalRandom(inout highp uint state) {
+  const highp float TAU = 6.283185307179586;
+  highp float u1 = 1.0 - uniformRandom(state);
+  highp float u2 = uniformRandom(state);
+  return sqrt(-2.0 * log(u1)) * cos(TAU * u2);
+}
+
+#if defined(POISSON)
+highp float poissonRandom(highp float lambda, inout highp uint state) {
+  // normal approximation where the inversion below would take long
+  if (lambda > 30.0) {
+    return max(floor(lambda + sqrt(lambda) * normalRandom(state) + 0.5), 0.0);
+  }
+  highp float limit = exp(-lambda);
+  highp float product = uniformRandom(state);
+  highp float k = 0.0;
+  while (product > limit) {
+    product *= uniformRandom(state);
+    k += 1.0;
+  }
+  return k;
+}
+#endif
+
+void main(void) {
+  highp ivec2 pixel = ivec2(gl_FragCoord.xy);
+  highp vec4 color = texelFetch(SourceTexture, pixel, 0);
+  // same sequence for the same seed, frame and pixel
+  highp uint state =
+      pcgHash(uint(pixel.x) ^ pcgHash(uint(pixel.y) ^
+                                      pcgHash(Frame ^ pcgHash(Seed))));
+
+  highp vec3 noisy;
+  for (int i = 0; i < 3; ++i) {
+#if defined(GAUSSIAN)
+    noisy[i] = color[i] +
+               (normalRandom(state) * Sigma + Mean) * IntensityConstant;
+#elif defined(SPECKLE)
+    noisy[i] = color[i] + color[i] * (normalRandom(state) * Sigma + Mean) *
+                              IntensityConstant;
+#elif defined(SALT_AND_PEPPER)
+    highp float u = uniformRandom(state);
+    if (u < Amount * SaltVsPepper) {
+      noisy[i] = 1.0;
+    } else if (u < Amount) {
+      noisy[i] = 0.0;
+    } else {
+      noisy[i] = color[i];
+    }
+#elif defined(POISSON)
+    noisy[i] = poissonRandom(color[i] * Levels, state) / Levels;
+#endif
+  }
+
+  fragmentColor = vec4(clamp(noisy, 0.0, 1.0), color.a);
+}
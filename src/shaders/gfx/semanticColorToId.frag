@@ -0,0 +1,52 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+precision highp int;
+
+// Looks the color of each pixel up in the table of semantic colors, sorted by
+// color, and outputs the semantic ID of the color or 0 if it isn't in the
+// table.
+
+// ------------ uniform ----------------------
+uniform highp sampler2D ColorTexture;
+uniform highp usampler2D ColorTable;
+uniform highp int ColorCount;
+uniform highp int ColorsPerRow;
+
+// ------------ output -----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_ID)
+out highp uint semanticId;
+
+// ------------ shader -----------------------
+highp uvec2 tableEntry(highp int i) {
+  return texelFetch(ColorTable, ivec2(i % ColorsPerRow, i / ColorsPerRow), 0)
+      .rg;
+}
+
+void main() {
+  // same packing as geo::getValueAsUInt()
+  highp uvec3 rgb = uvec3(
+      texelFetch(ColorTexture, ivec2(gl_FragCoord.xy), 0).rgb * 255.0 + 0.5);
+  highp uint color = (rgb.r << 16) | (rgb.g << 8) | rgb.b;
+
+  // first entry not less than the color
+  highp int first = 0;
+  highp int last = ColorCount;
+  while (first < last) {
+    highp int middle = (first + last) / 2;
+    if (tableEntry(middle).r < color) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+
+  semanticId = 0u;
+  if (first < ColorCount) {
+    highp uvec2 entry = tableEntry(first);
+    if (entry.r == color) {
+      semanticId = entry.g;
+    }
+  }
+}
@@ -1,16 +1,38 @@
 #ifdef UNPROJECT_EXISTING_DEPTH
 uniform highp sampler2D depthTexture;
+#ifdef UNPROJECT_TO_POINTS
+uniform highp mat4 inverseProjectionMatrix;
+#else
 uniform highp vec2 depthUnprojection;
+#endif
 
 in highp vec2 textureCoordinates;
 #else
 in highp float depth;
 #endif
 
+#ifdef UNPROJECT_TO_POINTS
+out highp vec4 point;
+#else
 out highp float originalDepth;
+#endif
 
 void main() {
-  #ifdef UNPROJECT_EXISTING_DEPTH
+  #ifdef UNPROJECT_TO_POINTS
+  /* The texture may span more than the current viewport (such as with tiled
+     rendering), while the texture coordinates are relative to the viewport.
+     Fetch the pixel at the window position directly instead. */
+  highp float depth = texelFetch(depthTexture, ivec2(gl_FragCoord.xy), 0).r;
+  highp vec4 unprojected = inverseProjectionMatrix*
+    vec4(textureCoordinates*2.0 - vec2(1.0), depth*2.0 - 1.0, 1.0);
+  point =
+    #ifndef NO_FAR_PLANE_PATCHING
+    /* Same as below, points on the far plane are all zeros, which makes
+       them distinguishable by the last component */
+    depth == 1.0 ? vec4(0.0) :
+    #endif
+    vec4(unprojected.xyz/unprojected.w, 1.0);
+  #elif defined(UNPROJECT_EXISTING_DEPTH)
   highp float depth = texture(depthTexture, textureCoordinates).r;
   originalDepth =
     #ifndef NO_FAR_PLANE_PATCHING
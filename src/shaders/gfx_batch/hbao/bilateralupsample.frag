@@ -0,0 +1,58 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+precision highp float;
+
+uniform float uGaussSharpness;
+
+// AO and linear depth at the reduced resolution the AO was computed at
+uniform sampler2D uTexSource;
+uniform sampler2D uTexReducedLinearDepth;
+// Linear depth at the output resolution
+uniform sampler2D uTexLinearDepth;
+
+in vec2 texCoord;
+
+out vec4 out_Color;
+
+//-------------------------------------------------------------------------
+
+void main() {
+  float center_d = texture(uTexLinearDepth, texCoord).x;
+
+  ivec2 reducedSize = textureSize(uTexSource, 0);
+  vec2 reducedPos = texCoord * vec2(reducedSize) - 0.5;
+  ivec2 base = ivec2(floor(reducedPos));
+  vec2 f = reducedPos - vec2(base);
+
+  float c_total = 0.0;
+  float w_total = 0.0;
+  float nearest_c = 0.0;
+  float nearest_ddiff = -1.0;
+
+  // The four reduced-resolution texels around this pixel, weighted
+  // bilinearly and by how close their depth is to the depth of this pixel
+  for (int y = 0; y != 2; ++y) {
+    for (int x = 0; x != 2; ++x) {
+      ivec2 pos = clamp(base + ivec2(x, y), ivec2(0), reducedSize - 1);
+      float c = texelFetch(uTexSource, pos, 0).x;
+      float d = texelFetch(uTexReducedLinearDepth, pos, 0).x;
+
+      float bilinear = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
+      float ddiff = (d - center_d) * uGaussSharpness;
+      float w = bilinear * exp2(-ddiff * ddiff);
+      c_total += c * w;
+      w_total += w;
+
+      if (nearest_ddiff < 0.0 || abs(ddiff) < nearest_ddiff) {
+        nearest_ddiff = abs(ddiff);
+        nearest_c = c;
+      }
+    }
+  }
+
+  // If none of the texels is at a similar depth, such as on thin features
+  // the reduced depth doesn't have, take the one closest in depth
+  out_Color = vec4(w_total > 1.0e-4 ? c_total / w_total : nearest_c);
+}
@@ -11,6 +11,10 @@ precision highp float;
 // idx 3 : 1 == perspective, 0 == orthographic
 uniform vec4 uClipInfo;
 
+// Offset of the first input pixel, nonzero when processing a single tile of a
+// larger input
+uniform ivec2 uInputOffset;
+
 #ifdef DEPTHLINEARIZE_MSAA
 uniform int uSampleIndex;
 uniform sampler2DMS uInputTexture;
@@ -37,9 +41,11 @@ float reconstructCSZ(float depth, vec4 clipInfo) {
 void main() {
 #ifdef DEPTHLINEARIZE_MSAA
   float depth =
-      texelFetch(uInputTexture, ivec2(gl_FragCoord.xy), uSampleIndex).x;
+      texelFetch(uInputTexture, ivec2(gl_FragCoord.xy) + uInputOffset,
+                 uSampleIndex).x;
 #else
-  float depth = texelFetch(uInputTexture, ivec2(gl_FragCoord.xy), 0).x;
+  float depth =
+      texelFetch(uInputTexture, ivec2(gl_FragCoord.xy) + uInputOffset, 0).x;
 #endif
 
   out_Color = reconstructCSZ(depth, uClipInfo);
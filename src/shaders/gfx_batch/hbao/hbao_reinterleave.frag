@@ -6,12 +6,16 @@ precision highp float;
 precision highp sampler2DArray;
 uniform sampler2DArray uTexResultsArray;
 
+// Offset of the output viewport, nonzero when drawing directly into a single
+// tile of a larger output
+uniform ivec2 uOutputOffset;
+
 out vec4 out_Color;
 
 //----------------------------------------------------------------------------------
 
 void main() {
-  ivec2 FullResPos = ivec2(gl_FragCoord.xy);
+  ivec2 FullResPos = ivec2(gl_FragCoord.xy) - uOutputOffset;
   ivec2 Offset = FullResPos & 3;
   int SliceId = Offset.y * 4 + Offset.x;
   ivec2 QuarterResPos = FullResPos >> 2;
@@ -0,0 +1,122 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "esp/core/AsyncLogSink.h"
+#include "esp/core/Logging.h"
+
+#include <sstream>
+
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+
+namespace Cr = Corrade;
+
+namespace esp {
+
+namespace sim {
+namespace test {
+namespace {
+void debug(const Cr::Containers::StringView statement) {
+  ESP_DEBUG() << statement;
+}
+void warning(const Cr::Containers::StringView statement) {
+  ESP_WARNING() << statement;
+}
+}  // namespace
+}  // namespace test
+}  // namespace sim
+
+namespace gfx {
+namespace test {
+namespace {
+void debug(const Cr::Containers::StringView statement) {
+  ESP_DEBUG() << statement;
+}
+void warning(const Cr::Containers::StringView statement) {
+  ESP_WARNING() << statement;
+}
+}  // namespace
+}  // namespace test
+}  // namespace gfx
+}  // namespace esp
+namespace {
+
+std::size_t countOccurrences(const std::string& text,
+                             const std::string& substring) {
+  std::size_t count = 0;
+  for (std::size_t pos = text.find(substring); pos != std::string::npos;
+       pos = text.find(substring, pos + substring.size())) {
+    ++count;
+  }
+  return count;
+}
+
+struct AsyncLogSinkTest : Cr::TestSuite::Tester {
+  explicit AsyncLogSinkTest();
+
+  void asyncSinkTest();
+};
+
+AsyncLogSinkTest::AsyncLogSinkTest() {
+  addTests({&AsyncLogSinkTest::asyncSinkTest});
+}
+
+void AsyncLogSinkTest::asyncSinkTest() {
+  esp::logging::LoggingContext ctx{"verbose"};
+
+  std::ostringstream out;
+  Cr::Utility::Debug debugCapture{&out};
+  Cr::Utility::Warning warnCapture{&out};
+
+  // long enough that nothing gets written before an explicit flush
+  auto* sink = new esp::logging::AsyncLogSink{std::chrono::seconds{60}};
+  ctx.setAsyncSink(Cr::Containers::Pointer<esp::logging::AsyncLogSink>{sink});
+  CORRADE_COMPARE(ctx.asyncSink(), sink);
+
+  esp::sim::test::warning("WarningSim");
+  CORRADE_COMPARE(out.str(), "");
+  sink->flush();
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "[Warning]:[Sim] AsyncLogSinkTest.cpp(27)::warning : WarningSim\n"));
+  out.str("");
+
+  // repeats of a message are counted instead of written
+  for (int i = 0; i < 5; ++i) {
+    esp::gfx::test::warning("Repeated");
+  }
+  sink->flush();
+  CORRADE_COMPARE(countOccurrences(out.str(), "Repeated"), 1);
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "[Gfx] previous message repeated 4 more times\n"));
+  CORRADE_COMPARE(sink->suppressedMessageCount(), 4);
+  out.str("");
+
+  // the rate limit applies to its subsystem only
+  sink->setDuplicateSuppression(false);
+  sink->setRateLimit(esp::logging::Subsystem::sim, 2.0f);
+  for (int i = 0; i < 10; ++i) {
+    esp::sim::test::debug("Throttled");
+    esp::gfx::test::debug("Unthrottled");
+  }
+  sink->flush();
+  CORRADE_COMPARE(countOccurrences(out.str(), "Throttled"), 2);
+  CORRADE_COMPARE(countOccurrences(out.str(), "Unthrottled"), 10);
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "[Sim] 8 messages dropped by the logging rate limit\n"));
+  CORRADE_COMPARE(sink->droppedMessageCount(), 8);
+  out.str("");
+
+  // without the sink, statements are written right away again
+  ctx.setAsyncSink(nullptr);
+  CORRADE_VERIFY(!ctx.asyncSink());
+  esp::sim::test::debug("DebugSim");
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "[Debug]:[Sim] AsyncLogSinkTest.cpp(24)::debug : DebugSim\n"));
+}
+
+}  // namespace
+CORRADE_TEST_MAIN(AsyncLogSinkTest)
@@ -367,6 +367,8 @@ void AttributesConfigsTest::testPhysicsAttrVals(
   CORRADE_COMPARE(physMgrAttr->getSimulator(), "bullet_test");
   CORRADE_COMPARE(physMgrAttr->getFrictionCoefficient(), 1.4);
   CORRADE_COMPARE(physMgrAttr->getRestitutionCoefficient(), 1.1);
+  CORRADE_COMPARE(physMgrAttr->getNumCollisionThreads(), 4);
+  CORRADE_COMPARE(physMgrAttr->getMaxSubsteps(), 20);
   // test physics manager attributes-level user config vals
   testUserDefinedConfigVals(
       physMgrAttr->getUserConfiguration(), 4, "pm defined string", true, 15,
@@ -386,9 +388,11 @@ void AttributesConfigsTest::testPhysicsJSONLoad() {
   const std::string& jsonString = R"({
   "physics_simulator": "bullet_test",
   "timestep": 1.0,
+  "max_substeps": 20,
   "gravity": [1,2,3],
   "friction_coefficient": 1.4,
   "restitution_coefficient": 1.1,
+  "num_collision_threads": 4,
   "user_defined" : {
       "user_str_array" : ["test_00", "test_01", "test_02", "test_03"],
       "user_string" : "pm defined string",
@@ -462,6 +466,8 @@ void AttributesConfigsTest::testPbrShaderAttrVals(
   CORRADE_VERIFY(pbrShaderAttr->getUseDirectLightTonemap());
   CORRADE_VERIFY(!pbrShaderAttr->getUseIBLTonemap());
   CORRADE_VERIFY(!pbrShaderAttr->getUseBurleyDiffuse());
+  CORRADE_VERIFY(pbrShaderAttr->getPbrQuality() ==
+                 esp::metadata::attributes::PbrShaderQuality::Fast);
 
   // verify the layer skipping is present
   CORRADE_VERIFY(pbrShaderAttr->getSkipCalcClearcoatLayer());
@@ -511,6 +517,7 @@ void AttributesConfigsTest::testPbrShaderAttrJSONLoad() {
   "use_direct_tonemap": true,
   "use_ibl_tonemap": false,
   "use_burley_diffuse": false,
+  "pbr_quality": "fast",
   "skip_clearcoat_calc": true,
   "skip_specular_layer_calc": true,
   "skip_anisotropy_layer_calc": true,
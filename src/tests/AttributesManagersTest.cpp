@@ -4,7 +4,9 @@
 
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/metadata/managers/AOAttributesManager.h"
@@ -230,6 +232,12 @@ struct AttributesManagersTest : Cr::TestSuite::Tester {
    */
   void testPrimitiveBasedObjectAttributes();
 
+  /**
+   * @brief Test that templates can be queried from several threads while
+   * another thread registers new ones.
+   */
+  void testConcurrentReadsDuringRegistration();
+
   // test member vars
 
   esp::logging::LoggingContext loggingContext_;
@@ -275,6 +283,7 @@ AttributesManagersTest::AttributesManagersTest() {
       &AttributesManagersTest::testLightLayoutAttributesManager,
       &AttributesManagersTest::testPrimitiveAssetAttributes,
       &AttributesManagersTest::testPrimitiveBasedObjectAttributes,
+      &AttributesManagersTest::testConcurrentReadsDuringRegistration,
   });
 }
 
@@ -437,11 +446,22 @@ void AttributesManagersTest::testRemoveAllButDefault(std::shared_ptr<T> mgr,
     CORRADE_VERIFY(attrTemplate2);
   }
 
+  // indexed and scanning searches agree, ignoring case
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("TEMPLATEHANDLE_3").size(),
+                  1);
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("newtemplatehandle_").size(),
+                  numToAdd);
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("_", true).size() +
+                      mgr->getObjectHandlesBySubstring("_", false).size(),
+                  mgr->getNumObjects());
+  CORRADE_VERIFY(mgr->getObjectHandlesBySubstring("no_such_handle").empty());
+
   // now delete all templates that
   auto removedNamedTemplates =
       mgr->removeObjectsBySubstring("newTemplateHandle_", true);
   // verify that the number removed == the number added
   CORRADE_COMPARE(removedNamedTemplates.size(), numToAdd);
+  CORRADE_VERIFY(mgr->getObjectHandlesBySubstring("TemplateHandle_").empty());
 
   // re-add templates
   for (auto& tmplt : removedNamedTemplates) {
@@ -1045,6 +1065,63 @@ void AttributesManagersTest::testPrimitiveBasedObjectAttributes() {
 
 }  // AttributesManagersTest::testPrimitiveBasedObjectAttributes test
 
+void AttributesManagersTest::testConcurrentReadsDuringRegistration() {
+  const std::vector<std::string> existingHandles =
+      objectAttributesManager_->getObjectHandlesBySubstring();
+  CORRADE_VERIFY(!existingHandles.empty());
+  const int numObjectsBefore = objectAttributesManager_->getNumObjects();
+
+  constexpr int numReaders = 4;
+  constexpr int numRegistrations = 200;
+  std::atomic<bool> done{false};
+  std::atomic<int> failedReads{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < numReaders; ++r) {
+    readers.emplace_back([&, r]() {
+      std::size_t i = r;
+      while (!done) {
+        const std::string& handle =
+            existingHandles[i++ % existingHandles.size()];
+        if (!objectAttributesManager_->getObjectLibHasHandle(handle) ||
+            !objectAttributesManager_->getObjectByHandle(handle) ||
+            objectAttributesManager_->getObjectIDByHandle(handle) ==
+                esp::ID_UNDEFINED) {
+          ++failedReads;
+        }
+        objectAttributesManager_->getObjectHandlesBySubstring("concurrent");
+        objectAttributesManager_->getSynthTemplateHandlesBySubstring(
+            "concurrent");
+        objectAttributesManager_->getFileTemplateHandlesBySubstring(
+            "concurrent");
+      }
+    });
+  }
+
+  // registrations replace library entries while the readers look them up
+  const auto source =
+      objectAttributesManager_->getObjectCopyByHandle(existingHandles[0]);
+  for (int i = 0; i < numRegistrations; ++i) {
+    auto copy = ObjectAttributes::create(*source);
+    CORRADE_VERIFY(objectAttributesManager_->registerObject(
+                       copy, "concurrent_" + std::to_string(i)) !=
+                   esp::ID_UNDEFINED);
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  CORRADE_COMPARE(failedReads, 0);
+  CORRADE_COMPARE(objectAttributesManager_->getNumObjects(),
+                  numObjectsBefore + numRegistrations);
+  CORRADE_COMPARE(
+      objectAttributesManager_->getObjectHandlesBySubstring("concurrent_")
+          .size(),
+      numRegistrations);
+  objectAttributesManager_->removeObjectsBySubstring("concurrent_");
+  CORRADE_COMPARE(objectAttributesManager_->getNumObjects(), numObjectsBefore);
+}  // AttributesManagersTest::testConcurrentReadsDuringRegistration
+
 }  // namespace
 
 CORRADE_TEST_MAIN(AttributesManagersTest)
@@ -10,6 +10,7 @@
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
 #include "esp/metadata/managers/ObjectAttributesManager.h"
+#include "esp/nav/PathFinder.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/sensor/CameraSensor.h"
@@ -17,6 +18,7 @@
 #include "esp/sim/AbstractReplayRenderer.h"
 #include "esp/sim/BatchReplayRenderer.h"
 #include "esp/sim/ClassicReplayRenderer.h"
+#include "esp/sim/ShardedBatchReplayRenderer.h"
 #include "esp/sim/Simulator.h"
 
 #include <esp/gfx_batch/RendererStandalone.h>
@@ -51,6 +53,10 @@ struct BatchReplayRendererTest : Cr::TestSuite::Tester {
   void testIntegration();
   void testUnproject();
   void testBatchPlayerDeletion();
+  void testMultipleSensors();
+  void testPick();
+  void testClassicSharedStaticInstances();
+  void testClassicNavMeshVisualization();
   void testArticulatedObject();
   void testClose();
 
@@ -157,6 +163,21 @@ const struct {
        return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
            new esp::sim::BatchReplayRenderer{configuration}};
      }},
+    // both shards on the same device, to be testable on a single-GPU machine
+    {"rgb - sharded batch", TestFlag::Color,
+     [](const ReplayRendererConfiguration& configuration) {
+       const Mn::UnsignedInt cudaDevices[]{0, 0};
+       return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
+           new esp::sim::ShardedBatchReplayRenderer{configuration,
+                                                    cudaDevices}};
+     }},
+    {"depth - sharded batch", TestFlag::Depth,
+     [](const ReplayRendererConfiguration& configuration) {
+       const Mn::UnsignedInt cudaDevices[]{0, 0};
+       return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
+           new esp::sim::ShardedBatchReplayRenderer{configuration,
+                                                    cudaDevices}};
+     }},
 };
 
 const struct {
@@ -195,7 +216,11 @@ BatchReplayRendererTest::BatchReplayRendererTest() {
   addInstancedTests({&BatchReplayRendererTest::testIntegration},
                     Cr::Containers::arraySize(TestIntegrationData));
 
-  addTests({&BatchReplayRendererTest::testBatchPlayerDeletion});
+  addTests({&BatchReplayRendererTest::testBatchPlayerDeletion,
+            &BatchReplayRendererTest::testMultipleSensors,
+            &BatchReplayRendererTest::testPick,
+            &BatchReplayRendererTest::testClassicSharedStaticInstances,
+            &BatchReplayRendererTest::testClassicNavMeshVisualization});
 
 #ifdef ESP_BUILD_WITH_BULLET
   addInstancedTests({&BatchReplayRendererTest::testArticulatedObject},
@@ -253,6 +278,17 @@ void BatchReplayRendererTest::testUnproject() {
     ray = renderer->unproject(envIndex, {0, h - 1});
     CORRADE_COMPARE(Mn::Vector3(ray.direction),
                     Mn::Vector3(-0.51449, -0.68599, -0.51450));
+
+    // the batched variant gives the same rays
+    const std::vector<esp::geo::Ray> rays =
+        renderer->unproject({envIndex, envIndex}, {{0, 0}, {w - 1, 0}});
+    CORRADE_COMPARE(rays.size(), 2);
+    CORRADE_COMPARE(Mn::Vector3(rays[0].origin),
+                    Mn::Vector3(pinholeCameraSpec->position));
+    CORRADE_COMPARE(Mn::Vector3(rays[0].direction),
+                    Mn::Vector3(-0.51544, 0.68457, -0.51544));
+    CORRADE_COMPARE(Mn::Vector3(rays[1].direction),
+                    Mn::Vector3(0.513467, 0.68551, -0.51615));
   }
 }
 
@@ -346,8 +382,10 @@ void BatchReplayRendererTest::testIntegration() {
       }
     }
 
+    // parse the keyframes in parallel, the output should be the same as with
+    // setEnvironmentKeyframe() for each
+    renderer->setEnvironmentKeyframes(serKeyframes, 2);
     for (int envIndex = 0; envIndex < numEnvs; envIndex++) {
-      renderer->setEnvironmentKeyframe(envIndex, serKeyframes[envIndex]);
       renderer->setSensorTransformsFromKeyframe(envIndex, userPrefix);
     }
 
@@ -376,6 +414,24 @@ void BatchReplayRendererTest::testIntegration() {
       }
     }
 
+    if (auto* sharded = dynamic_cast<esp::sim::ShardedBatchReplayRenderer*>(
+            renderer.get())) {
+      CORRADE_COMPARE(sharded->shardCount(), 2);
+      CORRADE_COMPARE(sharded->shardEnvironmentOffset(1), numEnvs / 2);
+      CORRADE_COMPARE(sharded->shardEnvironmentCount(1), numEnvs / 2);
+      for (unsigned shard = 0; shard != sharded->shardCount(); ++shard) {
+        CORRADE_ITERATION(shard);
+#ifdef ESP_BUILD_WITH_CUDA
+        CORRADE_VERIFY(sharded->getCudaColorBufferDevicePointer(shard));
+        CORRADE_VERIFY(sharded->getCudaDepthBufferDevicePointer(shard));
+#else
+        CORRADE_VERIFY(!sharded->getCudaColorBufferDevicePointer(shard));
+        CORRADE_VERIFY(!sharded->getCudaDepthBufferDevicePointer(shard));
+#endif
+      }
+    }
+
+    // the sharded renderer has no single buffer for all environments
     const auto colorPtr = renderer->getCudaColorBufferDevicePointer();
     const auto depthPtr = renderer->getCudaDepthBufferDevicePointer();
     bool isBatchRenderer =
@@ -476,17 +532,249 @@ void BatchReplayRendererTest::testBatchPlayerDeletion() {
     CORRADE_COMPARE(renderer.transformations(0)[1 * transformsPerInstance],
                     Mn::Matrix4::translation(Mn::Vector3(0.0f, 1.0f, 0.0f)));
 
-    // Frame 2
+    // Frame 1, deleted instances are hidden and kept for reuse
     player.setKeyframeIndex(1);
     CORRADE_COMPARE(renderer.transformations(0).size(),
-                    1 * transformsPerInstance);
+                    2 * transformsPerInstance);
     CORRADE_COMPARE(renderer.transformations(0)[0],
+                    Mn::Matrix4{Mn::Math::ZeroInit});
+    CORRADE_COMPARE(renderer.transformations(0)[1 * transformsPerInstance],
                     Mn::Matrix4::translation(Mn::Vector3(0.0f, 1.0f, 0.0f)));
+    CORRADE_COMPARE(batchPlayer->pooledNodeCount(), 1);
 
     // Frame 2
     player.setKeyframeIndex(2);
-    CORRADE_COMPARE(renderer.transformations(0).size(), 0);
+    CORRADE_COMPARE(renderer.transformations(0).size(),
+                    2 * transformsPerInstance);
+    CORRADE_COMPARE(renderer.transformations(0)[1 * transformsPerInstance],
+                    Mn::Matrix4{Mn::Math::ZeroInit});
+    CORRADE_COMPARE(batchPlayer->pooledNodeCount(), 2);
+
+    // Seeking back clears the frame, the instances of frame 0 reuse the
+    // pooled hierarchies instead of adding new ones
+    player.setKeyframeIndex(0);
+    CORRADE_COMPARE(renderer.transformations(0).size(),
+                    2 * transformsPerInstance);
+    CORRADE_COMPARE(batchPlayer->pooledNodeCount(), 0);
+    for (std::size_t i = 0; i != 2; ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_VERIFY(renderer.transformations(0)[i * transformsPerInstance] !=
+                     Mn::Matrix4{Mn::Math::ZeroInit});
+    }
+  }
+}
+
+// test several sensors rendering the same environment
+void BatchReplayRendererTest::testMultipleSensors() {
+  const std::string assetPath =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb");
+  const auto assetInfo = esp::assets::AssetInfo::fromPath(assetPath);
+  auto creationInfo = esp::assets::RenderAssetInstanceCreationInfo();
+  creationInfo.filepath = assetPath;
+  creationInfo.flags |=
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+
+  std::string serKeyframe;
+  {
+    SimulatorConfiguration simConfig{};
+    simConfig.enableGfxReplaySave = true;
+    simConfig.createRenderer = false;
+    auto sim = Simulator::create_unique(simConfig);
+    auto& recorder = *sim->getGfxReplayManager()->getRecorder();
+    CORRADE_VERIFY(
+        sim->loadAndCreateRenderAssetInstance(assetInfo, creationInfo));
+    serKeyframe = recorder.keyframeToString(recorder.extractKeyframe());
+  }
+
+  constexpr int numEnvs = 2;
+  ReplayRendererConfiguration batchRendererConfig;
+  batchRendererConfig.sensorSpecifications = {
+      getDefaultSensorSpecs("left", esp::sensor::SensorType::Color),
+      getDefaultSensorSpecs("right", esp::sensor::SensorType::Color)};
+  batchRendererConfig.numEnvironments = numEnvs;
+  esp::sim::BatchReplayRenderer renderer{batchRendererConfig};
+  CORRADE_COMPARE(renderer.sensorCount(), 2);
+
+  // one image for each sensor of each environment
+  std::vector<std::vector<char>> colorBuffers(numEnvs * 2);
+  std::vector<Mn::MutableImageView2D> colorImageViews;
+  for (std::size_t i = 0; i != colorBuffers.size(); ++i) {
+    const Mn::Vector2i size = renderer.sensorSize(i / 2);
+    colorImageViews.emplace_back(
+        getRGBView(size.x(), size.y(), colorBuffers[i]));
   }
+
+  const Mn::Matrix4 lookingAtSphere = Mn::Matrix4::translation({0, 0, 5.0f});
+  const Mn::Matrix4 lookingAway =
+      lookingAtSphere * Mn::Matrix4::rotationY(Mn::Deg(180.0f));
+  for (int envIndex = 0; envIndex != numEnvs; ++envIndex) {
+    renderer.setEnvironmentKeyframe(envIndex, serKeyframe);
+    renderer.setSensorTransform(envIndex, "left", lookingAtSphere);
+  }
+  renderer.setSensorTransform(0, "right", lookingAtSphere);
+  renderer.setSensorTransform(1, "right", lookingAway);
+  renderer.render(colorImageViews, {});
+
+  // images are ordered by environment and then by sensor
+  CORRADE_COMPARE_AS(Mn::ImageView2D{colorImageViews[0]},
+                     Mn::ImageView2D{colorImageViews[1]},
+                     Mn::DebugTools::CompareImage);
+  CORRADE_COMPARE_AS(Mn::ImageView2D{colorImageViews[0]},
+                     Mn::ImageView2D{colorImageViews[2]},
+                     Mn::DebugTools::CompareImage);
+  CORRADE_VERIFY(colorBuffers[2] != colorBuffers[3]);
+}
+
+// test picking object IDs and depths of many environments at once
+void BatchReplayRendererTest::testPick() {
+  const std::string assetPath =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb");
+  const auto assetInfo = esp::assets::AssetInfo::fromPath(assetPath);
+  auto creationInfo = esp::assets::RenderAssetInstanceCreationInfo();
+  creationInfo.filepath = assetPath;
+  creationInfo.flags |=
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+
+  std::string serKeyframe;
+  {
+    SimulatorConfiguration simConfig{};
+    simConfig.enableGfxReplaySave = true;
+    simConfig.createRenderer = false;
+    auto sim = Simulator::create_unique(simConfig);
+    auto& recorder = *sim->getGfxReplayManager()->getRecorder();
+    auto* sphere =
+        sim->loadAndCreateRenderAssetInstance(assetInfo, creationInfo);
+    CORRADE_VERIFY(sphere);
+    sphere->setSemanticId(7);
+    serKeyframe = recorder.keyframeToString(recorder.extractKeyframe());
+  }
+
+  constexpr int numEnvs = 2;
+  ReplayRendererConfiguration batchRendererConfig;
+  batchRendererConfig.sensorSpecifications =
+      getDefaultSensorSpecs(TestFlag::Color);
+  batchRendererConfig.numEnvironments = numEnvs;
+  batchRendererConfig.enableSemanticOutput = true;
+  esp::sim::BatchReplayRenderer renderer{batchRendererConfig};
+
+  const Mn::Matrix4 lookingAtSphere = Mn::Matrix4::translation({0, 0, 5.0f});
+  for (int envIndex = 0; envIndex != numEnvs; ++envIndex) {
+    renderer.setEnvironmentKeyframe(envIndex, serKeyframe);
+  }
+  renderer.setSensorTransform(0, "rgb", lookingAtSphere);
+  renderer.setSensorTransform(
+      1, "rgb", lookingAtSphere * Mn::Matrix4::rotationY(Mn::Deg(180.0f)));
+  renderer.render({}, {});
+
+  const Mn::Vector2i center = renderer.sensorSize(0) / 2;
+  const std::vector<esp::sim::ReplayRendererPickResult> results =
+      renderer.pick({0, 1, 0}, {center, center, center});
+  CORRADE_COMPARE(results.size(), 3);
+  CORRADE_COMPARE(results[0].objectId, 7);
+  CORRADE_COMPARE_AS(results[0].depth, 0.0f,
+                     Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE_AS(results[0].depth, 5.0f, Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE(results[1].objectId, 0);
+  CORRADE_COMPARE(results[1].depth, 0.0f);
+  // the same pixel queried twice gives the same result
+  CORRADE_COMPARE(results[2].objectId, results[0].objectId);
+  CORRADE_COMPARE(results[2].depth, results[0].depth);
+}
+
+// test static instances being shared by the environments of the classic
+// renderer
+void BatchReplayRendererTest::testClassicSharedStaticInstances() {
+  const std::string assetPath =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb");
+  const auto assetInfo = esp::assets::AssetInfo::fromPath(assetPath);
+  auto creationInfo = esp::assets::RenderAssetInstanceCreationInfo();
+  creationInfo.filepath = assetPath;
+  creationInfo.flags |=
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+  creationInfo.flags |=
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsSemantic;
+  auto staticCreationInfo = creationInfo;
+  staticCreationInfo.flags |=
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsStatic;
+
+  std::string serKeyframe;
+  {
+    SimulatorConfiguration simConfig{};
+    simConfig.enableGfxReplaySave = true;
+    simConfig.createRenderer = false;
+    auto sim = Simulator::create_unique(simConfig);
+    auto& recorder = *sim->getGfxReplayManager()->getRecorder();
+    CORRADE_VERIFY(
+        sim->loadAndCreateRenderAssetInstance(assetInfo, staticCreationInfo));
+    CORRADE_VERIFY(
+        sim->loadAndCreateRenderAssetInstance(assetInfo, creationInfo));
+    serKeyframe = recorder.keyframeToString(recorder.extractKeyframe());
+  }
+
+  constexpr int numEnvs = 2;
+  ReplayRendererConfiguration batchRendererConfig;
+  batchRendererConfig.sensorSpecifications =
+      getDefaultSensorSpecs(TestFlag::Color);
+  batchRendererConfig.numEnvironments = numEnvs;
+  esp::sim::ClassicReplayRenderer renderer{batchRendererConfig};
+  for (int envIndex = 0; envIndex != numEnvs; ++envIndex) {
+    renderer.setEnvironmentKeyframe(envIndex, serKeyframe);
+  }
+
+  // the environments contain just the dynamic sphere, the static one is
+  // created once for both
+  const std::size_t sphereDrawableCount =
+      renderer.getSceneGraph(0).getDrawables().size();
+  CORRADE_VERIFY(sphereDrawableCount);
+  CORRADE_COMPARE(renderer.getSceneGraph(1).getDrawables().size(),
+                  sphereDrawableCount);
+  CORRADE_COMPARE(renderer.sharedInstanceCount(), 1);
+  CORRADE_COMPARE(renderer.getSharedSceneGraph().getDrawables().size(),
+                  sphereDrawableCount);
+
+  // the shared instance stays until no environment references it
+  renderer.clearEnvironment(0);
+  CORRADE_COMPARE(renderer.getSceneGraph(0).getDrawables().size(), 0);
+  CORRADE_COMPARE(renderer.sharedInstanceCount(), 1);
+  CORRADE_COMPARE(renderer.getSharedSceneGraph().getDrawables().size(),
+                  sphereDrawableCount);
+  renderer.clearEnvironment(1);
+  CORRADE_COMPARE(renderer.sharedInstanceCount(), 0);
+  CORRADE_COMPARE(renderer.getSharedSceneGraph().getDrawables().size(), 0);
+}
+
+void BatchReplayRendererTest::testClassicNavMeshVisualization() {
+  esp::nav::PathFinder pathFinder;
+  CORRADE_VERIFY(pathFinder.loadNavMesh(Cr::Utility::Path::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh")));
+
+  constexpr int numEnvs = 2;
+  ReplayRendererConfiguration batchRendererConfig;
+  batchRendererConfig.sensorSpecifications =
+      getDefaultSensorSpecs(TestFlag::Color);
+  batchRendererConfig.numEnvironments = numEnvs;
+  esp::sim::ClassicReplayRenderer renderer{batchRendererConfig};
+
+  // one drawable per NavMesh tile, the meshes are shared by the environments
+  renderer.setNavMeshVisualization(0, &pathFinder);
+  const std::size_t tileDrawableCount =
+      renderer.getSceneGraph(0).getDrawables().size();
+  CORRADE_VERIFY(tileDrawableCount);
+  renderer.setNavMeshVisualization(1, &pathFinder);
+  CORRADE_COMPARE(renderer.getSceneGraph(1).getDrawables().size(),
+                  tileDrawableCount);
+
+  // refreshing an unchanged NavMesh doesn't duplicate anything
+  renderer.setNavMeshVisualization(0, &pathFinder);
+  CORRADE_COMPARE(renderer.getSceneGraph(0).getDrawables().size(),
+                  tileDrawableCount);
+
+  renderer.setNavMeshVisualization(0, nullptr);
+  CORRADE_COMPARE(renderer.getSceneGraph(0).getDrawables().size(), 0);
+  CORRADE_COMPARE(renderer.getSceneGraph(1).getDrawables().size(),
+                  tileDrawableCount);
+  renderer.setNavMeshVisualization(1, nullptr);
+  CORRADE_COMPARE(renderer.getSceneGraph(1).getDrawables().size(), 0);
 }
 
 void BatchReplayRendererTest::testArticulatedObject() {
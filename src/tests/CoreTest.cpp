@@ -2,10 +2,28 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include "esp/core/AtomicFile.h"
+#include "esp/core/Buffer.h"
 #include "esp/core/Configuration.h"
 #include "esp/core/Esp.h"
+#include "esp/core/Hash.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/ThreadPool.h"
+#include "esp/core/Tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "configure.h"
 
 using namespace esp::core::config;
 namespace Cr = Corrade;
@@ -35,6 +53,54 @@ struct CoreTest : Cr::TestSuite::Tester {
    */
   void TestConfigurationSubconfigFind();
 
+  /**
+   * @brief Test that copies share subconfigs until one side edits them.
+   */
+  void TestConfigurationCopyOnWrite();
+
+  /**
+   * @brief Test value lookup, insertion and removal by string and by
+   * precomputed key in the flat value storage.
+   */
+  void TestConfigurationKeys();
+
+  /**
+   * @brief Test that string values are interned, so copies share storage and
+   * equal strings compare equal.
+   */
+  void TestConfigurationInternedStrings();
+
+  /**
+   * @brief Test that buffer memory is recycled through the pool, zeroed, and
+   * freed once the pool is full.
+   */
+  void TestBufferPool();
+
+  /**
+   * @brief Test that a ThreadPool runs every item exactly once across
+   * repeated calls and propagates exceptions.
+   */
+  void TestThreadPool();
+
+  /**
+   * @brief Test that a Profiler computes section statistics over its rolling
+   * window and records nothing while disabled.
+   */
+  void TestProfiler();
+
+  /**
+   * @brief Test that trace spans of all threads are kept, also after their
+   * thread exits, until cleared.
+   */
+  void TestTracing();
+
+  /**
+   * @brief Test that the FNV-1a hash matches the reference values and its
+   * hexadecimal formatting.
+   */
+  void TestHash();
+  void TestWriteFileAtomically();
+
   esp::logging::LoggingContext loggingContext_;
 };  // struct CoreTest
 
@@ -42,6 +108,15 @@ CoreTest::CoreTest() {
   addTests({
       &CoreTest::TestConfiguration,
       &CoreTest::TestConfigurationSubconfigFind,
+      &CoreTest::TestConfigurationCopyOnWrite,
+      &CoreTest::TestConfigurationKeys,
+      &CoreTest::TestConfigurationInternedStrings,
+      &CoreTest::TestBufferPool,
+      &CoreTest::TestThreadPool,
+      &CoreTest::TestProfiler,
+      &CoreTest::TestTracing,
+      &CoreTest::TestHash,
+      &CoreTest::TestWriteFileAtomically,
   });
 }
 
@@ -329,6 +404,345 @@ void CoreTest::TestConfigurationSubconfigFind() {
 
 }  // CoreTest::TestConfigurationSubconfigFind test
 
+void CoreTest::TestConfigurationCopyOnWrite() {
+  Configuration::ptr cfg = Configuration::create();
+  cfg->editSubconfig<Configuration>("edited")->set("value", 1);
+  cfg->editSubconfig<Configuration>("untouched")->set("value", 2);
+  cfg->editSubconfig<Configuration>("edited")
+      ->editSubconfig<Configuration>("nested")
+      ->set("value", 3);
+
+  Configuration::ptr copy = Configuration::create(*cfg);
+  // nothing is copied until written to
+  CORRADE_VERIFY(copy->getSubconfigView("edited") ==
+                 cfg->getSubconfigView("edited"));
+  CORRADE_VERIFY(copy->getSubconfigView("untouched") ==
+                 cfg->getSubconfigView("untouched"));
+
+  copy->editSubconfig<Configuration>("edited")->set("value", 10);
+  CORRADE_VERIFY(copy->getSubconfigView("edited") !=
+                 cfg->getSubconfigView("edited"));
+  CORRADE_COMPARE(copy->getSubconfigView("edited")->get<int>("value"), 10);
+  CORRADE_COMPARE(cfg->getSubconfigView("edited")->get<int>("value"), 1);
+  // siblings and children of the edited subconfig stay shared
+  CORRADE_VERIFY(copy->getSubconfigView("untouched") ==
+                 cfg->getSubconfigView("untouched"));
+  CORRADE_VERIFY(
+      copy->getSubconfigView("edited")->getSubconfigView("nested") ==
+      cfg->getSubconfigView("edited")->getSubconfigView("nested"));
+
+  // writes to the source are not seen by the copy either
+  cfg->editSubconfig<Configuration>("untouched")->set("value", 20);
+  CORRADE_COMPARE(cfg->getSubconfigView("untouched")->get<int>("value"), 20);
+  CORRADE_COMPARE(copy->getSubconfigView("untouched")->get<int>("value"), 2);
+  cfg->editSubconfig<Configuration>("edited")
+      ->editSubconfig<Configuration>("nested")
+      ->set("value", 30);
+  CORRADE_COMPARE(copy->getSubconfigView("edited")
+                      ->getSubconfigView("nested")
+                      ->get<int>("value"),
+                  3);
+
+  // once all copies are gone, the source writes in place again
+  copy = Configuration::create(*cfg);
+  copy = nullptr;
+  const Configuration* edited = cfg->getSubconfigView("edited").get();
+  cfg->editSubconfig<Configuration>("edited")->set("value", 100);
+  CORRADE_VERIFY(cfg->getSubconfigView("edited").get() == edited);
+  CORRADE_COMPARE(cfg->getSubconfigView("edited")->get<int>("value"), 100);
+}  // CoreTest::TestConfigurationCopyOnWrite test
+
+void CoreTest::TestConfigurationKeys() {
+  using esp::core::config::ConfigKey;
+  Configuration cfg;
+  for (int i = 0; i < 100; ++i) {
+    cfg.set(Cr::Utility::formatString("key_{}", i), i);
+  }
+  const ConfigKey key42{"key_42"};
+  cfg.set(key42, 420);
+  CORRADE_COMPARE(cfg.getNumValues(), 100);
+  CORRADE_VERIFY(cfg.hasValue(key42));
+  CORRADE_COMPARE(cfg.get<int>(key42), 420);
+  CORRADE_COMPARE(cfg.get<int>("key_42"), 420);
+  CORRADE_COMPARE(cfg.get<int>(ConfigKey{"key_99"}), 99);
+  CORRADE_VERIFY(!cfg.hasValue(ConfigKey{"key_100"}));
+
+  // removal returns the removed value and keeps the others reachable
+  CORRADE_COMPARE(cfg.remove<int>("key_42"), 420);
+  CORRADE_VERIFY(!cfg.hasValue(key42));
+  CORRADE_COMPARE(cfg.remove("key_7").get<int>(), 7);
+  CORRADE_COMPARE(cfg.getNumValues(), 98);
+  int sum = 0;
+  auto valIterPair = cfg.getValuesIterator();
+  for (auto valIter = valIterPair.first; valIter != valIterPair.second;
+       ++valIter) {
+    CORRADE_COMPARE(cfg.get<int>(valIter->first), valIter->second.get<int>());
+    sum += valIter->second.get<int>();
+  }
+  CORRADE_COMPARE(sum, 99 * 100 / 2 - 42 - 7);
+}  // CoreTest::TestConfigurationKeys test
+
+void CoreTest::TestConfigurationInternedStrings() {
+  const std::size_t numInternedBefore = getNumInternedConfigStrings();
+  ConfigValue a;
+  a.set(std::string{"interned_test_handle"});
+  CORRADE_COMPARE(getNumInternedConfigStrings(), numInternedBefore + 1);
+
+  // setting an equal string reuses the interned copy
+  ConfigValue b;
+  b.set(std::string{"interned_test_handle"});
+  CORRADE_COMPARE(getNumInternedConfigStrings(), numInternedBefore + 1);
+  CORRADE_COMPARE(&a.get<std::string>(), &b.get<std::string>());
+  CORRADE_VERIFY(a == b);
+
+  // copies and moves share the string
+  ConfigValue copy{a};
+  CORRADE_COMPARE(&copy.get<std::string>(), &a.get<std::string>());
+  ConfigValue moved{std::move(copy)};
+  CORRADE_COMPARE(&moved.get<std::string>(), &a.get<std::string>());
+  CORRADE_COMPARE(moved.get<std::string>(), "interned_test_handle");
+
+  // the interned string outlives the values referencing it
+  const std::string* interned = &a.get<std::string>();
+  a.set(std::string{"interned_test_other"});
+  b.set(1);
+  CORRADE_COMPARE(*interned, "interned_test_handle");
+  CORRADE_VERIFY(a != moved);
+  CORRADE_COMPARE(a.get<std::string>(), "interned_test_other");
+
+  // Configuration copies share the string as well
+  Configuration cfg;
+  cfg.set("handle", "interned_test_handle");
+  Configuration cfgCopy{cfg};
+  CORRADE_COMPARE(&cfg.get("handle").get<std::string>(), interned);
+  CORRADE_COMPARE(&cfgCopy.get("handle").get<std::string>(), interned);
+  CORRADE_COMPARE(getNumInternedConfigStrings(), numInternedBefore + 2);
+}  // CoreTest::TestConfigurationInternedStrings test
+
+void CoreTest::TestBufferPool() {
+  using esp::core::Buffer;
+  using esp::core::DataType;
+  Buffer::releasePooledMemory();
+  CORRADE_COMPARE(Buffer::pooledBytes(), 0);
+
+  const uint8_t* memory = nullptr;
+  {
+    Buffer buffer{{4, 8}, DataType::DT_FLOAT};
+    CORRADE_COMPARE(buffer.data.size(), 4 * 8 * sizeof(float));
+    memory = buffer.data.data();
+    buffer.data[5] = 0xff;
+  }
+  // the memory went back to the pool
+  CORRADE_COMPARE(Buffer::pooledBytes(), 4 * 8 * sizeof(float));
+
+  {
+    // a buffer of the same byte size gets the same memory, zeroed
+    Buffer buffer{{8, 16}, DataType::DT_UINT8};
+    CORRADE_COMPARE(buffer.data.data(), memory);
+    CORRADE_COMPARE(buffer.data[5], 0);
+    CORRADE_COMPARE(Buffer::pooledBytes(), 0);
+  }
+
+  // nothing is kept once pooling is disabled
+  Buffer::setMaxPooledBytes(0);
+  CORRADE_COMPARE(Buffer::pooledBytes(), 0);
+  { Buffer buffer{{16}, DataType::DT_UINT32}; }
+  CORRADE_COMPARE(Buffer::pooledBytes(), 0);
+  Buffer::setMaxPooledBytes(size_t{256} * 1024 * 1024);
+}  // CoreTest::TestBufferPool test
+
+void CoreTest::TestThreadPool() {
+  esp::core::ThreadPool pool{4};
+  CORRADE_COMPARE(pool.numThreads(), 4);
+
+  // the workers are reused, make sure every call sees all of its items
+  for (std::size_t numItems : {0, 1, 3, 100, 1000}) {
+    std::vector<std::atomic<int>> counts(numItems);
+    std::atomic<bool> validWorkers{true};
+    pool.parallelFor(numItems, [&](std::size_t i, int worker) {
+      ++counts[i];
+      if (worker < 0 || worker >= 4) {
+        validWorkers = false;
+      }
+    });
+    CORRADE_VERIFY(validWorkers);
+    for (std::size_t i = 0; i != numItems; ++i) {
+      CORRADE_COMPARE(counts[i].load(), 1);
+    }
+  }
+
+  // the first exception is rethrown on the calling thread, and the pool is
+  // still usable afterwards
+  bool thrown = false;
+  try {
+    pool.parallelFor(100, [](std::size_t i, int) {
+      if (i == 50) {
+        throw std::runtime_error{"item failed"};
+      }
+    });
+  } catch (const std::runtime_error& e) {
+    thrown = true;
+    CORRADE_COMPARE(std::string{e.what()}, "item failed");
+  }
+  CORRADE_VERIFY(thrown);
+
+  std::atomic<int> total{0};
+  pool.parallelFor(10, [&](std::size_t, int) { ++total; });
+  CORRADE_COMPARE(total.load(), 10);
+
+  // a single-threaded pool runs everything on the calling thread
+  esp::core::ThreadPool serialPool{1};
+  CORRADE_COMPARE(serialPool.numThreads(), 1);
+  serialPool.parallelFor(5, [&](std::size_t, int worker) {
+    CORRADE_COMPARE(worker, 0);
+  });
+}  // CoreTest::TestThreadPool test
+
+void CoreTest::TestProfiler() {
+  using esp::core::Profiler;
+  Profiler profiler{4};
+  const Profiler::Clock::time_point begin{};
+
+  // disabled by default
+  profiler.record("section", begin, begin + std::chrono::milliseconds{1});
+  CORRADE_COMPARE(profiler.stats("section").totalCount, 0);
+
+  // only the last 4 of 1, 2, ... 6 ms are in the window
+  profiler.setEnabled(true);
+  for (int ms = 1; ms <= 6; ++ms) {
+    profiler.record("section", begin, begin + std::chrono::milliseconds{ms});
+  }
+  esp::core::ProfileSectionStats stats = profiler.stats("section");
+  CORRADE_COMPARE(stats.totalCount, 6);
+  CORRADE_COMPARE(stats.windowCount, 4);
+  CORRADE_COMPARE(stats.totalMs, 21.0);
+  CORRADE_COMPARE(stats.minMs, 3.0);
+  CORRADE_COMPARE(stats.maxMs, 6.0);
+  CORRADE_COMPARE(stats.meanMs, 4.5);
+  CORRADE_COMPARE(stats.p50Ms, 4.0);
+  CORRADE_COMPARE(stats.p99Ms, 6.0);
+  // 3 and 4 ms fall into [2048, 4096) us, 5 and 6 ms into [4096, 8192) us
+  CORRADE_COMPARE(stats.histogram[12], 2);
+  CORRADE_COMPARE(stats.histogram[13], 2);
+
+  CORRADE_COMPARE(profiler.stats().size(), 1);
+  CORRADE_COMPARE(profiler.stats("unknown").windowCount, 0);
+  CORRADE_COMPARE(profiler.traceEventCount(), 0);
+
+  // trace events are capped
+  profiler.setTraceEnabled(true, 2);
+  for (int i = 0; i != 3; ++i) {
+    esp::core::ScopedProfile scope{"scoped", profiler};
+  }
+  CORRADE_COMPARE(profiler.stats("scoped").totalCount, 3);
+  CORRADE_COMPARE(profiler.traceEventCount(), 2);
+
+  // durations measured elsewhere, such as on the GPU, aren't trace events
+  profiler.recordDuration("gpu", std::chrono::microseconds{1500});
+  CORRADE_COMPARE(profiler.stats("gpu").meanMs, 1.5);
+  CORRADE_COMPARE(profiler.traceEventCount(), 2);
+
+  profiler.clear();
+  CORRADE_VERIFY(profiler.stats().empty());
+  CORRADE_COMPARE(profiler.traceEventCount(), 0);
+}  // CoreTest::TestProfiler test
+
+void CoreTest::TestTracing() {
+  namespace logging = esp::logging;
+  logging::clearTrace();
+  CORRADE_COMPARE(logging::traceSpanCount(), 0);
+
+  for (int i = 0; i != 3; ++i) {
+    logging::TraceSpan span{"span", "Core"};
+  }
+  std::thread{[] {
+    const logging::TraceClock::time_point begin = logging::TraceClock::now();
+    logging::recordTraceSpan("thread", "Core", begin, begin);
+  }}.join();
+  CORRADE_COMPARE(logging::traceSpanCount(), 4);
+
+  logging::clearTrace();
+  CORRADE_COMPARE(logging::traceSpanCount(), 0);
+  logging::recordTraceSpan("after", "Core", logging::TraceClock::now(),
+                           logging::TraceClock::now());
+  CORRADE_COMPARE(logging::traceSpanCount(), 1);
+}  // CoreTest::TestTracing test
+
+void CoreTest::TestHash() {
+  using esp::core::Fnv1aHash;
+  // reference values of 64-bit FNV-1a
+  CORRADE_COMPARE(Fnv1aHash{}.value(), 0xcbf29ce484222325ull);
+  Fnv1aHash a;
+  a.add("a", 1);
+  CORRADE_COMPARE(a.value(), 0xaf63dc4c8601ec8cull);
+  CORRADE_COMPARE(esp::core::hashHexString(a.value()), "af63dc4c8601ec8c");
+  CORRADE_COMPARE(esp::core::hashHexString(0x1234), "0000000000001234");
+
+  // hashing incrementally or at once gives the same value
+  Fnv1aHash incremental;
+  incremental.add("ab", 2);
+  incremental.add("c", 1);
+  Fnv1aHash whole;
+  whole.add("abc", 3);
+  CORRADE_COMPARE(incremental.value(), whole.value());
+
+  // terminated strings don't hash like their concatenation
+  Fnv1aHash split;
+  split.addString("ab");
+  split.addString("c");
+  Fnv1aHash joined;
+  joined.addString("a");
+  joined.addString("bc");
+  CORRADE_VERIFY(split.value() != joined.value());
+}  // CoreTest::TestHash test
+
+void CoreTest::TestWriteFileAtomically() {
+  namespace Path = Cr::Utility::Path;
+  const std::string directory =
+      Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, "CoreTestAtomicFile");
+  CORRADE_VERIFY(Path::make(directory));
+  const std::string filename = Path::join(directory, "file.bin");
+
+  // concurrent writers each move a complete file in place, no temporary file
+  // is left behind and the result is one of the written contents
+  std::vector<std::thread> writers;
+  std::atomic<int> written{0};
+  for (char c = 'a'; c != 'e'; ++c) {
+    writers.emplace_back([&filename, &written, c]() {
+      const std::string data(4096, c);
+      if (esp::core::writeFileAtomically(
+              filename, Cr::Containers::ArrayView<const void>{data.data(),
+                                                              data.size()})) {
+        ++written;
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  CORRADE_COMPARE(written.load(), 4);
+  Cr::Containers::Optional<Cr::Containers::String> contents =
+      Path::readString(filename);
+  CORRADE_VERIFY(contents);
+  CORRADE_COMPARE(contents->size(), 4096);
+  CORRADE_COMPARE(
+      std::count(contents->begin(), contents->end(), contents->front()), 4096);
+  const auto files = Path::list(
+      directory,
+      Path::ListFlag::SkipDirectories | Path::ListFlag::SkipDotAndDotDot);
+  CORRADE_VERIFY(files);
+  CORRADE_COMPARE(files->size(), 1);
+
+  // a failed write leaves nothing behind
+  const std::string missing = Path::join(directory, "missing/file.bin");
+  CORRADE_VERIFY(!esp::core::writeFileAtomically(
+      missing, Cr::Containers::ArrayView<const void>{"x", 1}));
+  CORRADE_VERIFY(!Path::exists(missing));
+
+  CORRADE_VERIFY(Path::remove(filename));
+  CORRADE_VERIFY(Path::remove(directory));
+}  // CoreTest::TestWriteFileAtomically test
+
 }  // namespace
 
 CORRADE_TEST_MAIN(CoreTest)
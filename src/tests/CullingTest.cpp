@@ -2,18 +2,31 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 //
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/GL/SampleQuery.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/LightClusters.h"
+#include "esp/gfx/ObjectIdHistogram.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
@@ -34,6 +47,16 @@ using Magnum::Math::Literals::operator""_degf;
 // on GCC and Clang, the following namespace causes useful warnings to be
 // printed when you have accidentally unused variables or functions in the test
 namespace {
+// copies of the scene's drawables and the number of culling threads
+const struct {
+  const char* name;
+  std::size_t copies;
+  int numThreads;
+} CullingBenchmarkData[]{{"5k drawables, 1 thread", 1000, 1},
+                         {"5k drawables, 4 threads", 1000, 4},
+                         {"100k drawables, 1 thread", 20000, 1},
+                         {"100k drawables, 4 threads", 20000, 4}};
+
 struct CullingTest : Cr::TestSuite::Tester {
   explicit CullingTest();
 
@@ -43,6 +66,18 @@ struct CullingTest : Cr::TestSuite::Tester {
   // tests
   void computeAbsoluteAABB();
   void frustumCulling();
+  void frustumCullingThreaded();
+  void frustumCullingHierarchical();
+  void sortByDrawState();
+  void drawInstanced();
+  void drawDepthAndObjectIdOnly();
+  void objectIdHistogram();
+  void lightClusters();
+
+  void benchmarkCulling();
+
+  // camera of the frustumCulling test, looking at the 5 boxes scene
+  esp::gfx::RenderCamera& setupCamera(esp::scene::SceneGraph& sceneGraph);
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -54,8 +89,18 @@ struct CullingTest : Cr::TestSuite::Tester {
 CullingTest::CullingTest() {
   // clang-format off
   addTests({&CullingTest::computeAbsoluteAABB,
-            &CullingTest::frustumCulling});
+            &CullingTest::frustumCulling,
+            &CullingTest::frustumCullingThreaded,
+            &CullingTest::frustumCullingHierarchical,
+            &CullingTest::sortByDrawState,
+            &CullingTest::drawInstanced,
+            &CullingTest::drawDepthAndObjectIdOnly,
+            &CullingTest::objectIdHistogram,
+            &CullingTest::lightClusters});
   // clang-format on
+
+  addInstancedBenchmarks({&CullingTest::benchmarkCulling}, 10,
+                         Cr::Containers::arraySize(CullingBenchmarkData));
 }
 
 int CullingTest::setupTests() {
@@ -275,6 +320,408 @@ void CullingTest::frustumCulling() {
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
 }
+esp::gfx::RenderCamera& CullingTest::setupCamera(
+    esp::scene::SceneGraph& sceneGraph) {
+  esp::scene::SceneNode& cameraNode =
+      sceneGraph.getRootNode().createChild().createChild();
+  esp::gfx::RenderCamera& renderCamera = *(new esp::gfx::RenderCamera(
+      cameraNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID));
+  renderCamera.setProjectionMatrix(800, 600, 0.01f, 100.0f, 39.6_degf);
+  cameraNode.translate({7.3589f, -6.9258f, 4.9583f});
+  const Mn::Vector3 axis{0.773, 0.334, 0.539};
+  cameraNode.rotate(Mn::Math::Deg<float>(77.4f), axis.normalized());
+  return renderCamera;
+}
+
+void CullingTest::frustumCullingThreaded() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  // enough copies of the drawables to be split across several threads
+  const auto single = renderCamera.drawableTransformations(drawables);
+  esp::gfx::RenderCamera::DrawableTransforms drawableTransforms;
+  for (int i = 0; i < 2000; ++i) {
+    drawableTransforms.insert(drawableTransforms.end(), single.begin(),
+                              single.end());
+  }
+  auto threadedTransforms = drawableTransforms;
+
+  const size_t numVisible = renderCamera.cull(drawableTransforms);
+  renderCamera.setCullingNumThreads(4);
+  const size_t numVisibleThreaded = renderCamera.cull(threadedTransforms);
+
+  // box 3 is culled, the order of the visible ones is kept
+  CORRADE_COMPARE(numVisible, 4 * 2000);
+  CORRADE_COMPARE(numVisibleThreaded, numVisible);
+  for (size_t i = 0; i < numVisible; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(std::addressof(drawableTransforms[i].first.get()) ==
+                   std::addressof(threadedTransforms[i].first.get()));
+  }
+}
+
+void CullingTest::frustumCullingHierarchical() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  auto cull = [&](bool hierarchical) {
+    auto drawableTransforms = renderCamera.drawableTransformations(drawables);
+    renderCamera.setHierarchicalCullingEnabled(hierarchical);
+    drawableTransforms.erase(
+        drawableTransforms.begin() + renderCamera.cull(drawableTransforms),
+        drawableTransforms.end());
+    std::vector<const Mn::SceneGraph::Drawable3D*> visible;
+    for (const auto& drawableTransform : drawableTransforms) {
+      visible.push_back(&drawableTransform.first.get());
+    }
+    return visible;
+  };
+
+  // look around, the hierarchy is built once and reused for all views
+  for (int i = 0; i < 8; ++i) {
+    CORRADE_ITERATION(i);
+    const auto visible = cull(false);
+    CORRADE_VERIFY(cull(true) == visible);
+    renderCamera.node().rotateY(Mn::Math::Deg<float>(45.0f));
+  }
+
+  // moving a box refits the hierarchy
+  auto& node = static_cast<esp::scene::SceneNode&>(drawables[1].object());
+  node.translate({0.0f, 0.0f, 50.0f});
+  node.setAbsoluteAABB(
+      Mn::Range3D{node.getAbsoluteAABB()}.translated({0.0f, 0.0f, 50.0f}));
+  for (int i = 0; i < 8; ++i) {
+    CORRADE_ITERATION(i);
+    const auto visible = cull(false);
+    CORRADE_VERIFY(cull(true) == visible);
+    renderCamera.node().rotateY(Mn::Math::Deg<float>(45.0f));
+  }
+}
+
+void CullingTest::sortByDrawState() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  // interleave copies of the scene so that no two consecutive drawables share
+  // a mesh
+  const auto single = renderCamera.drawableTransformations(drawables);
+  esp::gfx::RenderCamera::DrawableTransforms all;
+  for (int i = 0; i < 3; ++i) {
+    all.insert(all.end(), single.begin(), single.end());
+  }
+
+  auto unsorted = all;
+  renderCamera.filterTransforms(unsorted);
+  const size_t numUnsortedChanges = renderCamera.getPreviousNumStateChanges();
+  CORRADE_COMPARE(renderCamera.getPreviousNumStateChangesSaved(), 0);
+
+  auto sorted = all;
+  renderCamera.filterTransforms(sorted,
+                                esp::gfx::RenderCamera::Flag::SortByDrawState);
+  CORRADE_COMPARE(sorted.size(), all.size());
+  CORRADE_COMPARE(renderCamera.getPreviousNumStateChanges() +
+                      renderCamera.getPreviousNumStateChangesSaved(),
+                  numUnsortedChanges);
+
+  // the same drawables are drawn, with each mesh drawn back to back
+  std::vector<const Mn::SceneGraph::Drawable3D*> drawnUnsorted, drawnSorted;
+  for (std::size_t i = 0; i < all.size(); ++i) {
+    drawnUnsorted.push_back(&unsorted[i].first.get());
+    drawnSorted.push_back(&sorted[i].first.get());
+  }
+  std::vector<const Mn::GL::Mesh*> meshes;
+  for (const auto* drawable : drawnSorted) {
+    const Mn::GL::Mesh* mesh =
+        &static_cast<const esp::gfx::Drawable*>(drawable)->getMesh();
+    if (meshes.empty() || meshes.back() != mesh) {
+      CORRADE_VERIFY(std::find(meshes.begin(), meshes.end(), mesh) ==
+                     meshes.end());
+      meshes.push_back(mesh);
+    }
+  }
+  if (meshes.size() > 1) {
+    CORRADE_COMPARE_AS(renderCamera.getPreviousNumStateChangesSaved(), 0,
+                       Cr::TestSuite::Compare::Greater);
+  }
+  std::sort(drawnUnsorted.begin(), drawnUnsorted.end());
+  std::sort(drawnSorted.begin(), drawnSorted.end());
+  CORRADE_VERIFY(drawnSorted == drawnUnsorted);
+}
+
+void CullingTest::drawInstanced() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  // copies of the scene drawn on top of each other share mesh and material
+  const auto single = renderCamera.drawableTransformations(drawables);
+  esp::gfx::RenderCamera::DrawableTransforms all;
+  for (int i = 0; i < 3; ++i) {
+    all.insert(all.end(), single.begin(), single.end());
+  }
+
+  const Mn::Vector2i frameBufferSize{800, 600};
+  esp::gfx::RenderTarget::uptr target = esp::gfx::RenderTarget::create_unique(
+      frameBufferSize, esp::gfx_batch::calculateDepthUnprojection(
+                           renderCamera.projectionMatrix()));
+  auto render = [&](esp::gfx::RenderCamera::Flags flags) {
+    auto drawableTransforms = all;
+    renderCamera.filterTransforms(drawableTransforms, flags);
+    target->renderEnter();
+    renderCamera.draw(drawableTransforms, flags);
+    target->renderExit();
+    const std::size_t size = 4 * frameBufferSize.product();
+    Mn::Image2D image{Mn::PixelFormat::RGBA8Unorm, frameBufferSize,
+                      Cr::Containers::Array<char>{Cr::ValueInit, size}};
+    target->readFrameRgba(image);
+    return image;
+  };
+
+  Mn::Image2D expected = render({});
+  CORRADE_COMPARE(renderCamera.getPreviousNumDrawCalls(), all.size());
+
+  Mn::Image2D actual = render(esp::gfx::RenderCamera::Flag::SortByDrawState |
+                              esp::gfx::RenderCamera::Flag::UseInstancing);
+  CORRADE_COMPARE_AS(renderCamera.getPreviousNumDrawCalls(), all.size(),
+                     Cr::TestSuite::Compare::LessOrEqual);
+  const auto& first = static_cast<esp::gfx::Drawable&>(single[0].first.get());
+  if (first.getDrawableType() == esp::gfx::DrawableType::Pbr) {
+    CORRADE_COMPARE_AS(renderCamera.getPreviousNumDrawCalls(), all.size(),
+                       Cr::TestSuite::Compare::Less);
+  }
+
+  // instancing doesn't change the image beyond floating point differences
+  const auto expectedPixels = expected.data();
+  const auto actualPixels = actual.data();
+  std::size_t numDifferent = 0;
+  for (std::size_t i = 0; i < expectedPixels.size(); ++i) {
+    numDifferent += std::abs(int(expectedPixels[i]) - int(actualPixels[i])) > 2;
+  }
+  CORRADE_COMPARE_AS(numDifferent, expectedPixels.size() / 1000,
+                     Cr::TestSuite::Compare::LessOrEqual);
+}
+
+void CullingTest::drawDepthAndObjectIdOnly() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  const Mn::Vector2i frameBufferSize{800, 600};
+  esp::gfx::RenderTarget::uptr target = esp::gfx::RenderTarget::create_unique(
+      frameBufferSize,
+      esp::gfx_batch::calculateDepthUnprojection(
+          renderCamera.projectionMatrix()),
+      nullptr,
+      esp::gfx::RenderTarget::Flag::ObjectIdAttachment |
+          esp::gfx::RenderTarget::Flag::DepthTextureAttachment);
+  auto render = [&](esp::gfx::RenderCamera::Flags flags, Mn::Image2D& depth,
+                    Mn::Image2D& objectId) {
+    auto drawableTransforms = renderCamera.drawableTransformations(drawables);
+    target->renderEnter();
+    renderCamera.draw(drawableTransforms, flags);
+    target->renderExit();
+    target->readFrameDepth(depth);
+    target->readFrameObjectId(objectId);
+  };
+  // both formats have four bytes per pixel
+  const std::size_t size = 4 * frameBufferSize.product();
+  auto image = [&](Mn::PixelFormat format) {
+    return Mn::Image2D{format, frameBufferSize,
+                       Cr::Containers::Array<char>{Cr::ValueInit, size}};
+  };
+
+  Mn::Image2D expectedDepth = image(Mn::PixelFormat::R32F);
+  Mn::Image2D expectedObjectId = image(Mn::PixelFormat::R32UI);
+  render({}, expectedDepth, expectedObjectId);
+
+  Mn::Image2D actualDepth = image(Mn::PixelFormat::R32F);
+  Mn::Image2D actualObjectId = image(Mn::PixelFormat::R32UI);
+  render(esp::gfx::RenderCamera::Flag::DepthAndObjectIdOnly, actualDepth,
+         actualObjectId);
+  CORRADE_COMPARE(renderCamera.getPreviousNumDrawCalls(),
+                  renderCamera.drawableTransformations(drawables).size());
+
+  // the same geometry is rasterized, so only floating point differences in
+  // depth are expected and object IDs match exactly
+  const auto expectedDepths =
+      Cr::Containers::arrayCast<const float>(expectedDepth.data());
+  const auto actualDepths =
+      Cr::Containers::arrayCast<const float>(actualDepth.data());
+  std::size_t numDifferent = 0;
+  for (std::size_t i = 0; i < expectedDepths.size(); ++i) {
+    numDifferent += std::abs(expectedDepths[i] - actualDepths[i]) > 1.0e-3f;
+  }
+  CORRADE_COMPARE_AS(numDifferent, expectedDepths.size() / 1000,
+                     Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_VERIFY(std::equal(expectedObjectId.data().begin(),
+                            expectedObjectId.data().end(),
+                            actualObjectId.data().begin()));
+}
+
+void CullingTest::objectIdHistogram() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+
+  // give the boxes the IDs 1 to 4, 0 is the background
+  constexpr Mn::UnsignedInt maxObjectId = 4;
+  for (std::size_t i = 0; i < drawables.size(); ++i) {
+    static_cast<esp::gfx::Drawable&>(drawables[i])
+        .getSceneNode()
+        .setSemanticId(int(i % maxObjectId) + 1);
+  }
+
+  const Mn::Vector2i frameBufferSize{800, 600};
+  esp::gfx::RenderTarget::uptr target = esp::gfx::RenderTarget::create_unique(
+      frameBufferSize,
+      esp::gfx_batch::calculateDepthUnprojection(
+          renderCamera.projectionMatrix()),
+      nullptr, esp::gfx::RenderTarget::Flag::ObjectIdAttachment);
+  auto drawableTransforms = renderCamera.drawableTransformations(drawables);
+  target->renderEnter();
+  renderCamera.draw(drawableTransforms, {});
+  target->renderExit();
+
+  // reference counts from the object IDs read back to the CPU
+  Mn::Image2D objectId{
+      Mn::PixelFormat::R32UI, frameBufferSize,
+      Cr::Containers::Array<char>{Cr::ValueInit,
+                                  4 * std::size_t(frameBufferSize.product())}};
+  target->readFrameObjectId(objectId);
+  std::vector<Mn::UnsignedInt> expected(maxObjectId + 1);
+  for (const Mn::UnsignedInt id :
+       Cr::Containers::arrayCast<const Mn::UnsignedInt>(objectId.data())) {
+    CORRADE_COMPARE_AS(id, maxObjectId, Cr::TestSuite::Compare::LessOrEqual);
+    ++expected[id];
+  }
+  // IDs below and from the bin count of the partial histogram are in view
+  CORRADE_VERIFY(expected[1] + expected[2] > 0);
+  CORRADE_VERIFY(expected[3] + expected[4] > 0);
+
+  // the blend and depth state of the caller is kept
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
+  Mn::GL::Renderer::setBlendFunction(
+      Mn::GL::Renderer::BlendFunction::SourceAlpha,
+      Mn::GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+
+  esp::gfx::ObjectIdHistogram all{maxObjectId + 1};
+  CORRADE_COMPARE(all.binCount(), maxObjectId + 1);
+  CORRADE_COMPARE_AS(all.compute(*target), expected,
+                     Cr::TestSuite::Compare::Container);
+
+  CORRADE_VERIFY(glIsEnabled(GL_BLEND));
+  CORRADE_VERIFY(!glIsEnabled(GL_DEPTH_TEST));
+  GLint blendSource, blendDestination;
+  glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource);
+  glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination);
+  CORRADE_COMPARE(blendSource, GL_SRC_ALPHA);
+  CORRADE_COMPARE(blendDestination, GL_ONE_MINUS_SRC_ALPHA);
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::Blending);
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
+
+  // IDs from the bin count on are not counted, and don't spill into the
+  // counted bins
+  esp::gfx::ObjectIdHistogram partial{3};
+  CORRADE_COMPARE_AS(partial.compute(*target),
+                     (std::vector<Mn::UnsignedInt>{expected.begin(),
+                                                   expected.begin() + 3}),
+                     Cr::TestSuite::Compare::Container);
+}
+
+void CullingTest::lightClusters() {
+  using esp::gfx::LightClusters;
+  // with an identity camera, the global lights are in view space
+  const esp::gfx::LightSetup lights{
+      {{0.0f, -1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}},
+      // in front of the camera, with a range of 1.6
+      {{0.0f, 0.0f, -5.0f, 1.0f}, {0.01f, 0.0f, 0.0f}},
+      // behind the camera
+      {{0.0f, 0.0f, 5.0f, 1.0f}, {0.01f, 0.0f, 0.0f}}};
+  CORRADE_COMPARE(LightClusters::lightRange(lights[0]),
+                  Mn::Constants::inf());
+  CORRADE_COMPARE(LightClusters::lightRange(lights[1]), 1.6f);
+  CORRADE_VERIFY(!LightClusters::isClusteringUseful(lights));
+
+  auto contains = [](const LightClusters& clusters, Mn::UnsignedInt cluster,
+                     Mn::UnsignedInt light) {
+    const Mn::Vector2ui range = clusters.clusters()[cluster];
+    const auto begin = clusters.lightIndices().begin() + range[0];
+    return std::find(begin, begin + range[1], light) != begin + range[1];
+  };
+
+  LightClusters clusters;
+  clusters.build(lights, Mn::Matrix4{},
+                 Mn::Matrix4::perspectiveProjection(90.0_degf, 16.0f / 9.0f,
+                                                    0.1f, 100.0f));
+  CORRADE_COMPARE(clusters.clusters().size(), LightClusters::ClusterCount);
+  CORRADE_COMPARE(clusters.lightRanges().size(), 3);
+  CORRADE_COMPARE(clusters.depthPlane(),
+                  (Mn::Vector4{0.0f, 0.0f, -1.0f, 0.0f}));
+  for (Mn::UnsignedInt i = 0; i != LightClusters::ClusterCount; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(contains(clusters, i, 0));
+    CORRADE_VERIFY(!contains(clusters, i, 2));
+  }
+
+  // the cluster of the light center, in the screen center at depth 5, has the
+  // point light, a corner cluster far away doesn't
+  const Mn::Vector2 sliceScaleBias = clusters.sliceScaleBias();
+  const Mn::UnsignedInt slice =
+      Mn::UnsignedInt(std::log(5.0f) * sliceScaleBias.x() + sliceScaleBias.y());
+  CORRADE_VERIFY(contains(
+      clusters,
+      LightClusters::clusterIndex(LightClusters::TilesX / 2,
+                                  LightClusters::TilesY / 2, slice),
+      1));
+  CORRADE_VERIFY(!contains(
+      clusters,
+      LightClusters::clusterIndex(0, 0, LightClusters::DepthSlices - 1), 1));
+  CORRADE_VERIFY(
+      !contains(clusters, LightClusters::clusterIndex(0, 0, slice), 1));
+
+  // without a perspective projection, all lights are in a single cluster
+  clusters.build(lights, Mn::Matrix4{},
+                 Mn::Matrix4::orthographicProjection({2.0f, 2.0f}, 0.1f,
+                                                     100.0f));
+  CORRADE_COMPARE(clusters.clusters().size(), 1);
+  CORRADE_COMPARE(clusters.clusters()[0], (Mn::Vector2ui{0, 3}));
+  CORRADE_COMPARE(clusters.lightIndices().size(), 3);
+}
+
+void CullingTest::benchmarkCulling() {
+  auto&& data = CullingBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+  esp::gfx::RenderCamera& renderCamera = setupCamera(sceneGraph);
+  renderCamera.setCullingNumThreads(data.numThreads);
+
+  const auto single = renderCamera.drawableTransformations(drawables);
+  esp::gfx::RenderCamera::DrawableTransforms all;
+  for (std::size_t i = 0; i < data.copies; ++i) {
+    all.insert(all.end(), single.begin(), single.end());
+  }
+
+  size_t numVisible = 0;
+  auto drawableTransforms = all;
+  CORRADE_BENCHMARK(10) {
+    drawableTransforms = all;
+    numVisible += renderCamera.cull(drawableTransforms);
+  }
+  CORRADE_VERIFY(numVisible > 0);
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(CullingTest)
@@ -2,8 +2,13 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/Primitives/Cube.h>
@@ -11,11 +16,14 @@
 #include <Magnum/Trade/MeshData.h>
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/PbrShader.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/scene/SceneManager.h"
 
+#include <algorithm>
+
 #include "configure.h"
 
 namespace Cr = Corrade;
@@ -33,6 +41,7 @@ struct DrawableTest : Cr::TestSuite::Tester {
   explicit DrawableTest();
   // tests
   void addRemoveDrawables();
+  void pbrProgramBinaryCache();
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -54,7 +63,8 @@ DrawableTest::DrawableTest() {
   auto MM = MetadataMediator::create(cfg);
   resourceManager_ = std::make_unique<ResourceManager>(MM);
   //clang-format off
-  addTests({&DrawableTest::addRemoveDrawables});
+  addTests({&DrawableTest::addRemoveDrawables,
+            &DrawableTest::pbrProgramBinaryCache});
   //clang-format on
   auto stageAttributesMgr = MM->getStageAttributesManager();
   std::string stageFile =
@@ -147,6 +157,82 @@ void DrawableTest::addRemoveDrawables() {
   CORRADE_VERIFY(!drawableGroup_->hasDrawable(dr->getDrawableId()));
 }
 
+void DrawableTest::pbrProgramBinaryCache() {
+#ifdef MAGNUM_TARGET_GLES
+  CORRADE_SKIP("Program binaries are cached only on desktop GL");
+#else
+  if (!Mn::GL::Context::current()
+           .isExtensionSupported<Mn::GL::Extensions::ARB::get_program_binary>())
+    CORRADE_SKIP("ARB_get_program_binary is not supported");
+
+  const std::string directory =
+      Cr::Utility::Path::join(TEST_ASSETS, "pbr_program_cache");
+  CORRADE_VERIFY(Cr::Utility::Path::make(directory));
+  esp::gfx::PbrShader::setProgramBinaryCacheDirectory(directory);
+
+  // names of the cached programs, in creation order
+  std::vector<std::string> programs;
+  const auto create = [&](const esp::gfx::PbrShader::Configuration& config) {
+    esp::gfx::PbrShader shader{config};
+    CORRADE_VERIFY(shader.id());
+    Cr::Containers::Optional<Cr::Containers::Array<Cr::Containers::String>>
+        files = Cr::Utility::Path::list(
+            directory, Cr::Utility::Path::ListFlag::SkipDirectories |
+                           Cr::Utility::Path::ListFlag::SkipDotAndDotDot);
+    CORRADE_VERIFY(files);
+    for (const Cr::Containers::String& file : *files) {
+      if (std::find(programs.begin(), programs.end(), file) == programs.end())
+        programs.emplace_back(file);
+    }
+  };
+
+  using Flag = esp::gfx::PbrShader::Flag;
+  const auto textured =
+      esp::gfx::PbrShader::Configuration{}
+          .setFlags(Flag::BaseColorTexture | Flag::DirectLighting)
+          .setLightCount(1);
+  const auto untextured = esp::gfx::PbrShader::Configuration{}
+                              .setFlags(Flag::DirectLighting)
+                              .setLightCount(1);
+  const auto twoLights =
+      esp::gfx::PbrShader::Configuration{}
+          .setFlags(Flag::BaseColorTexture | Flag::DirectLighting)
+          .setLightCount(2);
+
+  // every variant gets its own program, the same variant reuses it
+  create(textured);
+  create(untextured);
+  create(twoLights);
+  CORRADE_COMPARE(programs.size(), 3);
+  create(textured);
+  CORRADE_COMPARE(programs.size(), 3);
+
+  // a program of another variant under the same name, as with a hash
+  // collision, isn't loaded but replaced by the right one
+  const std::string texturedFile =
+      Cr::Utility::Path::join(directory, programs[0]);
+  const std::string untexturedFile =
+      Cr::Utility::Path::join(directory, programs[1]);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> untexturedData =
+      Cr::Utility::Path::read(untexturedFile);
+  CORRADE_VERIFY(untexturedData);
+  CORRADE_VERIFY(Cr::Utility::Path::copy(untexturedFile, texturedFile));
+  create(textured);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> texturedData =
+      Cr::Utility::Path::read(texturedFile);
+  CORRADE_VERIFY(texturedData);
+  CORRADE_VERIFY(texturedData->size() != untexturedData->size() ||
+                 !std::equal(texturedData->begin(), texturedData->end(),
+                             untexturedData->begin()));
+
+  esp::gfx::PbrShader::setProgramBinaryCacheDirectory({});
+  for (const std::string& program : programs) {
+    Cr::Utility::Path::remove(Cr::Utility::Path::join(directory, program));
+  }
+  Cr::Utility::Path::remove(directory);
+#endif
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(DrawableTest)
@@ -8,10 +8,15 @@
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Trade/MeshData.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "esp/core/Utility.h"
 #include "esp/geo/CoordinateFrame.h"
 #include "esp/geo/Geo.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OBBTree.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -26,12 +31,21 @@ struct GeoTest : Cr::TestSuite::Tester {
   explicit GeoTest();
   // tests
   void aabb();
+  void aabbBatch();
   void obbConstruction();
   void obbFunctions();
+  void obbBatch();
+  void obbTree();
   void coordinateFrame();
+  void trajectoryTubes();
+  void trajectoryTubeBuilder();
+  void connectedComponentsByColor();
   // benchmarks
   void getTransformedBB_standard();
   void getTransformedBB();
+  void getTransformedBBs();
+  void findCCsByGivenColor_setAdjList();
+  void findCCsByGivenColor_csrAdjList();
   // standard method
   // transform the 8 corners, and extract the min and max
   Mn::Range3D getTransformedBB_standard(const Mn::Range3D& range,
@@ -44,19 +58,52 @@ struct GeoTest : Cr::TestSuite::Tester {
   const unsigned int iterations_ = 10;
   Mn::Range3D box_{Mn::Vector3{-10.0f, -10.0f, -10.0f},
                    Mn::Vector3{10.0f, 10.0f, 10.0f}};
+
+  // triangulated grid with blocks of colored verts, for the CC tests
+  const int gridSize_ = 256;
+  std::vector<uint32_t> gridIndices_;
+  std::vector<Mn::Color3ub> gridColors_;
   esp::logging::LoggingContext loggingContext_;
 };
 
 GeoTest::GeoTest() {
   // clang-format off
   addTests({&GeoTest::aabb,
+            &GeoTest::aabbBatch,
             &GeoTest::obbConstruction,
             &GeoTest::obbFunctions,
-            &GeoTest::coordinateFrame});
+            &GeoTest::obbBatch,
+            &GeoTest::obbTree,
+            &GeoTest::coordinateFrame,
+            &GeoTest::trajectoryTubes,
+            &GeoTest::trajectoryTubeBuilder,
+            &GeoTest::connectedComponentsByColor});
   addBenchmarks({&GeoTest::getTransformedBB_standard,
-                 &GeoTest::getTransformedBB}, 10);
+                 &GeoTest::getTransformedBB,
+                 &GeoTest::getTransformedBBs}, 10);
+  addBenchmarks({&GeoTest::findCCsByGivenColor_setAdjList,
+                 &GeoTest::findCCsByGivenColor_csrAdjList}, 5);
   // clang-format on
 
+  // Two triangles per grid cell, verts colored in 8x8 blocks of three colors
+  // with some scattered verts of a fourth one
+  const Mn::Color3ub colors[]{
+      {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255}};
+  for (int y = 0; y != gridSize_; ++y) {
+    for (int x = 0; x != gridSize_; ++x) {
+      const int colorIdx =
+          (x * 7 + y * 13) % 17 == 0 ? 3 : (x / 8 + y / 8) % 3;
+      gridColors_.push_back(colors[colorIdx]);
+      if (x + 1 == gridSize_ || y + 1 == gridSize_) {
+        continue;
+      }
+      const uint32_t v = y * gridSize_ + x;
+      gridIndices_.insert(gridIndices_.end(),
+                          {v, v + 1, v + gridSize_, v + 1,
+                           v + gridSize_ + 1, v + gridSize_});
+    }
+  }
+
   // Generate N transformations (random positions and orientations)
   xforms_.reserve(numCases_);
   for (unsigned int iTransform = 0; iTransform < numCases_; ++iTransform) {
@@ -106,6 +153,34 @@ void GeoTest::getTransformedBB() {
   }
 }
 
+void GeoTest::getTransformedBBs() {
+  const std::vector<Mn::Range3D> boxes(xforms_.size(), box_);
+  std::vector<Mn::Range3D> aabbs(xforms_.size());
+  CORRADE_BENCHMARK(iterations_) {
+    esp::geo::getTransformedBBs(boxes, xforms_, aabbs);
+  }
+}
+
+void GeoTest::findCCsByGivenColor_setAdjList() {
+  std::size_t numColors = 0;
+  CORRADE_BENCHMARK(1) {
+    const std::vector<std::set<uint32_t>> adjList =
+        buildAdjList(gridColors_.size(), gridIndices_);
+    numColors = findCCsByGivenColor(adjList, gridColors_).size();
+  }
+  CORRADE_COMPARE(numColors, 4);
+}
+
+void GeoTest::findCCsByGivenColor_csrAdjList() {
+  std::size_t numColors = 0;
+  CORRADE_BENCHMARK(1) {
+    const CsrAdjList adjList =
+        buildCsrAdjList(gridColors_.size(), gridIndices_);
+    numColors = findCCsByGivenColor(adjList, gridColors_).size();
+  }
+  CORRADE_COMPARE(numColors, 4);
+}
+
 void GeoTest::aabb() {
   // compute aabb for each box using standard method and library method
   // respectively.
@@ -122,6 +197,28 @@ void GeoTest::aabb() {
   }
 }
 
+void GeoTest::aabbBatch() {
+  // the batched version should match the single-box one for boxes of
+  // different sizes, also when transforming in place
+  std::vector<Mn::Range3D> boxes;
+  for (std::size_t i = 0; i != xforms_.size(); ++i) {
+    boxes.push_back(Mn::Range3D::fromCenter(Mn::Vector3{i % 7 - 3.0f},
+                                            Mn::Vector3{1.0f + i % 5}));
+  }
+  std::vector<Mn::Range3D> aabbs = boxes;
+  esp::geo::getTransformedBBs(aabbs, xforms_, aabbs);
+
+  for (std::size_t i = 0; i != xforms_.size(); ++i) {
+    Mn::Range3D aabbControl = esp::geo::getTransformedBB(boxes[i], xforms_[i]);
+
+    float eps = 1e-3f;
+    CORRADE_COMPARE_WITH(aabbs[i].min(), aabbControl.min(),
+                         Cr::TestSuite::Compare::around(Mn::Vector3{eps}));
+    CORRADE_COMPARE_WITH(aabbs[i].max(), aabbControl.max(),
+                         Cr::TestSuite::Compare::around(Mn::Vector3{eps}));
+  }
+}
+
 void GeoTest::obbConstruction() {
   OBB obb1;
   const vec3f center(0, 0, 0);
@@ -166,6 +263,165 @@ void GeoTest::obbFunctions() {
   CORRADE_COMPARE_AS(obb2.distance(vec3f(-10, -5, 2)), 1, float);
 }
 
+void GeoTest::obbBatch() {
+  const quatf rot1 = quatf::FromTwoVectors(vec3f::UnitY(), vec3f::UnitZ());
+  OBB obb2(vec3f(1, 2, 3), vec3f(20, 2, 10), rot1);
+  std::vector<vec3f> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back(vec3f::Random() * 15.0f);
+  }
+
+  const std::vector<bool> contained = obb2.contains(points);
+  const std::vector<float> distances = obb2.distance(points);
+  const std::vector<vec3f> closest = obb2.closestPoint(points);
+  CORRADE_COMPARE(contained.size(), points.size());
+  CORRADE_COMPARE(distances.size(), points.size());
+  CORRADE_COMPARE(closest.size(), points.size());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(bool(contained[i]), obb2.contains(points[i]));
+    CORRADE_COMPARE_WITH(distances[i], obb2.distance(points[i]),
+                         Cr::TestSuite::Compare::around(1e-4f));
+    CORRADE_VERIFY(closest[i].isApprox(obb2.closestPoint(points[i])));
+  }
+}
+
+void GeoTest::obbTree() {
+  std::vector<OBB> obbs;
+  for (int i = 0; i < 200; ++i) {
+    const vec3f center = vec3f::Random() * 50.0f;
+    const vec3f dimensions = vec3f::Random().cwiseAbs() * 10.0f;
+    obbs.emplace_back(center, dimensions + vec3f::Ones(),
+                      quatf::UnitRandom());
+  }
+  std::vector<int> ids(obbs.size());
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    ids[i] = 1000 + static_cast<int>(i);
+  }
+  const OBBTree tree{obbs, ids};
+  CORRADE_COMPARE(tree.size(), obbs.size());
+
+  std::vector<vec3f> points;
+  for (int i = 0; i < 500; ++i) {
+    points.push_back(vec3f::Random() * 60.0f);
+  }
+  // every OBB has one query point inside
+  for (const OBB& obb : obbs) {
+    points.push_back(obb.center());
+  }
+
+  std::vector<float> distances;
+  const std::vector<int> closest = tree.closest(points, &distances);
+  const std::vector<std::vector<int>> containing = tree.containing(points);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    // compare against testing every OBB
+    std::vector<int> expectedContaining;
+    float expectedDistance = std::numeric_limits<float>::infinity();
+    for (std::size_t j = 0; j < obbs.size(); ++j) {
+      if (obbs[j].contains(points[i])) {
+        expectedContaining.push_back(ids[j]);
+      }
+      expectedDistance =
+          std::min(expectedDistance, obbs[j].distance(points[i]));
+    }
+    std::vector<int> actualContaining = containing[i];
+    std::sort(actualContaining.begin(), actualContaining.end());
+    CORRADE_COMPARE(actualContaining, expectedContaining);
+    CORRADE_COMPARE(distances[i], expectedDistance);
+    CORRADE_COMPARE(obbs[closest[i] - 1000].distance(points[i]),
+                    expectedDistance);
+  }
+
+  // an empty tree has no closest OBB
+  float distance = 0.0f;
+  CORRADE_COMPARE(
+      OBBTree{std::vector<OBB>{}}.closest(vec3f::Zero(), &distance),
+      ID_UNDEFINED);
+  CORRADE_COMPARE(distance, std::numeric_limits<float>::infinity());
+}
+
+void GeoTest::trajectoryTubes() {
+  const std::vector<std::vector<Mn::Vector3>> trajectories{
+      {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.5f}},
+      {{2.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 3.0f}},
+      {{0.0f, 1.0f, 0.0f},
+       {0.0f, 2.0f, 1.0f},
+       {1.0f, 3.0f, 1.0f},
+       {2.0f, 2.0f, 2.0f}}};
+  const std::vector<Mn::Color3> colors{{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+  const Mn::Trade::MeshData tubes = buildTrajectoryTubesSolid(
+      trajectories, {colors}, 6, 0.1f, true, 5, ColorSpace::HSV, 2);
+
+  // the same as concatenating the separately built tubes
+  std::vector<Mn::Vector3> expectedPositions;
+  std::vector<Mn::UnsignedInt> expectedIndices;
+  for (const auto& pts : trajectories) {
+    const Mn::Trade::MeshData tube =
+        buildTrajectoryTubeSolid(pts, colors, 6, 0.1f, true, 5);
+    const Mn::UnsignedInt offset = expectedPositions.size();
+    for (const Mn::Vector3& position : tube.positions3DAsArray()) {
+      expectedPositions.push_back(position);
+    }
+    for (const Mn::UnsignedInt index : tube.indicesAsArray()) {
+      expectedIndices.push_back(index + offset);
+    }
+  }
+  const auto positions = tubes.positions3DAsArray();
+  const auto indices = tubes.indicesAsArray();
+  CORRADE_COMPARE(std::vector<Mn::Vector3>(positions.begin(), positions.end()),
+                  expectedPositions);
+  CORRADE_COMPARE(
+      std::vector<Mn::UnsignedInt>(indices.begin(), indices.end()),
+      expectedIndices);
+}
+
+void GeoTest::trajectoryTubeBuilder() {
+  std::vector<Mn::Vector3> pts;
+  for (int i = 0; i < 12; ++i) {
+    pts.emplace_back(i * 0.5f, std::sin(i * 0.7f), std::cos(i * 0.3f));
+  }
+  const Mn::Color3 color{0.2f, 0.8f, 0.4f};
+
+  for (const bool smooth : {false, true}) {
+    CORRADE_ITERATION(smooth);
+    TrajectoryTubeBuilder builder{color, 8, 0.05f, smooth, 4};
+    std::size_t ringCount = 0;
+    // append the points a few at a time, with a repeated point
+    for (std::size_t i = 0; i < pts.size(); i += 3) {
+      std::vector<Mn::Vector3> chunk(pts.begin() + i,
+                                     pts.begin() + std::min(i + 3, pts.size()));
+      chunk.push_back(chunk.back());
+      builder.append(chunk);
+      ringCount += builder.regeneratedRingCount();
+    }
+    CORRADE_COMPARE(builder.pointCount(), pts.size());
+
+    // only the tail got regenerated, so fewer rings than rebuilding the tube
+    // after each append
+    const std::size_t trajSize = smooth ? (pts.size() - 1) * 4 : pts.size();
+    CORRADE_COMPARE_AS(ringCount, 2 * trajSize, Cr::TestSuite::Compare::Less);
+
+    const Mn::Trade::MeshData expected =
+        buildTrajectoryTubeSolid(pts, {color}, 8, 0.05f, smooth, 4);
+    const Mn::Trade::MeshData actual = builder.mesh();
+    CORRADE_COMPARE(actual.vertexCount(), expected.vertexCount());
+    const auto expectedPositions = expected.positions3DAsArray();
+    const auto actualPositions = actual.positions3DAsArray();
+    const auto expectedNormals = expected.normalsAsArray();
+    const auto actualNormals = actual.normalsAsArray();
+    const auto expectedColors = expected.colorsAsArray();
+    const auto actualColors = actual.colorsAsArray();
+    for (std::size_t i = 0; i < expected.vertexCount(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(actualPositions[i], expectedPositions[i]);
+      CORRADE_COMPARE(actualNormals[i], expectedNormals[i]);
+      CORRADE_COMPARE(actualColors[i], expectedColors[i]);
+    }
+    CORRADE_COMPARE(actual.indexCount(), expected.indexCount());
+  }
+}
+
 void GeoTest::coordinateFrame() {
   const vec3f origin(1, -2, 3);
   const vec3f up(0, 0, 1);
@@ -203,4 +459,33 @@ void GeoTest::coordinateFrame() {
 
 }  // namespace
 
+void GeoTest::connectedComponentsByColor() {
+  const std::vector<std::set<uint32_t>> setAdjList =
+      buildAdjList(gridColors_.size(), gridIndices_);
+  const CsrAdjList csrAdjList =
+      buildCsrAdjList(gridColors_.size(), gridIndices_);
+
+  // same neighbors in both representations
+  CORRADE_COMPARE(csrAdjList.numVerts(), setAdjList.size());
+  for (std::size_t vIDX = 0; vIDX != setAdjList.size(); ++vIDX) {
+    const std::vector<uint32_t> neighbors(
+        csrAdjList.neighbors.begin() + csrAdjList.offsets[vIDX],
+        csrAdjList.neighbors.begin() + csrAdjList.offsets[vIDX + 1]);
+    CORRADE_COMPARE(neighbors, std::vector<uint32_t>(setAdjList[vIDX].begin(),
+                                                     setAdjList[vIDX].end()));
+  }
+
+  // same components, in the same order
+  const auto setCCs = findCCsByGivenColor(setAdjList, gridColors_);
+  const auto csrCCs = findCCsByGivenColor(csrAdjList, gridColors_);
+  CORRADE_COMPARE(csrCCs.size(), 4);
+  CORRADE_COMPARE(csrCCs.size(), setCCs.size());
+  for (const auto& colorCCs : setCCs) {
+    CORRADE_ITERATION(colorCCs.first);
+    auto found = csrCCs.find(colorCCs.first);
+    CORRADE_VERIFY(found != csrCCs.end());
+    CORRADE_VERIFY(found->second == colorCCs.second);
+  }
+}
+
 CORRADE_TEST_MAIN(GeoTest)
@@ -109,8 +109,12 @@ struct GfxBatchHbaoTest : Mn::GL::OpenGLTester {
    * @param data The pertinent test data for the test
    * @param filename The name of the validation file to test against
    * @param proj The projection matrix this test consumes
+   * @param tileCount If not 1, the image is split into this many tiles, all
+   * using the same projection
    */
-  void benchmarkHBAOData(const TestDataType& data, Mn::Matrix4 projMatrix);
+  void benchmarkHBAOData(const TestDataType& data,
+                         Mn::Matrix4 projMatrix,
+                         const Mn::Vector2i& tileCount = Mn::Vector2i{1});
   /**
    * @brief Benchmark the synthesis of the HBAO effect in a
    * perspective-projection environment.
@@ -122,6 +126,13 @@ struct GfxBatchHbaoTest : Mn::GL::OpenGLTester {
    * orthographic-projection environment.
    */
   void benchmarkOrthographic();
+
+  /**
+   * @brief Benchmark the synthesis of the HBAO effect on a grid of tiles of
+   * the same total size as the other benchmarks, each with its own
+   * perspective projection.
+   */
+  void benchmarkTiled();
 };
 
 /**
@@ -251,6 +262,29 @@ TestDataType BenchData[]{
          .setUseLayeredGeometryShader(true)
          .setUseSpecialBlur(true),
      1.0f, 0.1f},
+    {"classic, half resolution", "hbao-classic",
+     esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}.setResolutionDivisor(2)},
+    {"classic, quarter resolution", "hbao-classic",
+     esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}.setResolutionDivisor(4)},
+    {"cache-aware, half resolution", "hbao-cache",
+     esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}.setResolutionDivisor(2)},
+    {"cache-aware, quarter resolution", "hbao-cache",
+     esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}.setResolutionDivisor(4)},
+    {"cache-aware, half resolution, AO special blur", "hbao-cache-sblur",
+     esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}
+         .setResolutionDivisor(2)
+         .setUseSpecialBlur(true),
+     1.0f, 0.1f},
+    {"cache-aware, half resolution, layered with geometry shader",
+     "hbao-cache-geom", esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}
+         .setResolutionDivisor(2)
+         .setUseLayeredGeometryShader(true)},
 };
 
 const struct {
@@ -275,7 +309,8 @@ GfxBatchHbaoTest::GfxBatchHbaoTest() {
                     Cr::Containers::arraySize(TestData));
 
   addInstancedBenchmarks({&GfxBatchHbaoTest::benchmarkPerspective,
-                          &GfxBatchHbaoTest::benchmarkOrthographic},
+                          &GfxBatchHbaoTest::benchmarkOrthographic,
+                          &GfxBatchHbaoTest::benchmarkTiled},
                          5, Cr::Containers::arraySize(BenchData),
                          BenchmarkType::GpuTime);
 }
@@ -544,7 +579,8 @@ void GfxBatchHbaoTest::testPerspectiveFlipped() {
 }  // GfxBatchHbaoTest::testPerspective()
 
 void GfxBatchHbaoTest::benchmarkHBAOData(const TestDataType& data,
-                                         Mn::Matrix4 projMatrix) {
+                                         Mn::Matrix4 projMatrix,
+                                         const Mn::Vector2i& tileCount) {
   if ((data.config.flags() & esp::gfx_batch::HbaoFlag::LayeredImageLoadStore) &&
       !(
 #ifdef MAGNUM_TARGET_GLES
@@ -592,6 +628,31 @@ void GfxBatchHbaoTest::benchmarkHBAOData(const TestDataType& data,
 
   MAGNUM_VERIFY_NO_GL_ERROR();
 
+  if (tileCount != Mn::Vector2i{1}) {
+    const Mn::Vector2i tileSize = BenchImageSize / tileCount;
+    Cr::Containers::Array<Mn::Matrix4> projections{
+        Cr::DirectInit, std::size_t(tileCount.product()), projMatrix};
+    esp::gfx_batch::Hbao hbao{
+        esp::gfx_batch::HbaoConfiguration{data.config}.setSize(tileSize)};
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    // Call once to compile the shaders
+    hbao.drawEffect(projections, tileCount, data.algType, inputDepthTexture,
+                    output);
+
+    CORRADE_BENCHMARK(16) {
+      hbao.drawEffect(projections, tileCount, data.algType, inputDepthTexture,
+                      output);
+    }
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    CORRADE_COMPARE_WITH(
+        output.read({{}, BenchImageSize}, {Mn::PixelFormat::RGBA8Unorm}),
+        resultImage,
+        (Mn::DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+    return;
+  }
+
   esp::gfx_batch::Hbao hbao{
       esp::gfx_batch::HbaoConfiguration{data.config}.setSize(BenchImageSize)};
   MAGNUM_VERIFY_NO_GL_ERROR();
@@ -630,6 +691,15 @@ void GfxBatchHbaoTest::benchmarkOrthographic() {
   benchmarkHBAOData(data, orthographicData.projection);
 }  // GfxBatchHbaoTest::benchmarkPerspective()
 
+void GfxBatchHbaoTest::benchmarkTiled() {
+  auto&& data = BenchData[testCaseInstanceId()];
+  setTestCaseDescription(Cr::Utility::format("{}, tiled.", data.name));
+
+  // The benchmark image is four times the test size in each direction, so
+  // each tile has the test size and the perspective aspect ratio matches
+  benchmarkHBAOData(data, perspectiveData.projection, Mn::Vector2i{4});
+}  // GfxBatchHbaoTest::benchmarkTiled()
+
 }  // namespace
 
 CORRADE_TEST_MAIN(GfxBatchHbaoTest)
@@ -2,11 +2,15 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <sstream>
+
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/File.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/GL/OpenGLTester.h> /* just for MAGNUM_VERIFY_NO_GL_ERROR() */
@@ -30,6 +34,7 @@
 #include <Magnum/Trade/TextureData.h>
 
 #include <esp/gfx_batch/DepthUnprojection.h>
+#include <esp/gfx_batch/MeshQuantization.h>
 #include "Corrade/TestSuite/Compare/Numeric.h"
 #include "esp/gfx_batch/RendererStandalone.h"
 
@@ -64,12 +69,22 @@ struct GfxBatchRendererTest : Cr::TestSuite::Tester {
   void renderNoFileAdded();
   void multipleScenes();
   void clearScene();
+  void setTileSizeCount();
+  void bulkUpdate();
+  void gpuMemoryBudget();
+  void frustumCulling();
+  void levelsOfDetail();
+  void quantizeMesh();
+  void quantizeVertices();
+  void objectId();
+  void skinningUnskinnedFile();
 
   void lights();
   void clearLights();
 
   void imageInto();
   void depthUnprojection();
+  void pointCloud();
   void cudaInterop();
 };
 
@@ -288,15 +303,28 @@ GfxBatchRendererTest::GfxBatchRendererTest() {
 
   addInstancedTests({&GfxBatchRendererTest::multipleMeshes,
                      &GfxBatchRendererTest::multipleScenes,
-                     &GfxBatchRendererTest::clearScene},
+                     &GfxBatchRendererTest::clearScene,
+                     &GfxBatchRendererTest::setTileSizeCount,
+                     &GfxBatchRendererTest::frustumCulling,
+                     &GfxBatchRendererTest::levelsOfDetail},
+      Cr::Containers::arraySize(FileData));
+
+  addTests({&GfxBatchRendererTest::quantizeMesh});
+
+  addInstancedTests({&GfxBatchRendererTest::quantizeVertices},
       Cr::Containers::arraySize(FileData));
 
   addInstancedTests({&GfxBatchRendererTest::lights},
       Cr::Containers::arraySize(LightData));
 
-  addTests({&GfxBatchRendererTest::clearLights,
+  addTests({&GfxBatchRendererTest::bulkUpdate,
+            &GfxBatchRendererTest::gpuMemoryBudget,
+            &GfxBatchRendererTest::objectId,
+            &GfxBatchRendererTest::skinningUnskinnedFile,
+            &GfxBatchRendererTest::clearLights,
             &GfxBatchRendererTest::imageInto,
             &GfxBatchRendererTest::depthUnprojection,
+            &GfxBatchRendererTest::pointCloud,
             &GfxBatchRendererTest::cudaInterop});
   // clang-format on
 }
@@ -1905,6 +1933,608 @@ void GfxBatchRendererTest::clearScene() {
                                           data.meanThreshold}));
 }
 
+void GfxBatchRendererTest::setTileSizeCount() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  /* Start with a single differently-sized tile */
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({32, 32}, {1, 1}),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  /* Populate scene 0 like in multipleScenes() */
+  const auto identity = Mn::Matrix4{Mn::Math::IdentityInit};
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "four squares"), 0);
+  renderer.updateCamera(
+      0, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.draw();
+  CORRADE_COMPARE(renderer.colorImage().size(), (Mn::Vector2i{32, 32}));
+
+  /* Growing keeps scene 0 and the files, the other scenes are empty */
+  renderer.setTileSizeCount({64, 48}, {2, 2});
+  CORRADE_COMPARE(renderer.tileSize(), (Mn::Vector2i{64, 48}));
+  CORRADE_COMPARE(renderer.tileCount(), (Mn::Vector2i{2, 2}));
+  CORRADE_COMPARE(renderer.sceneCount(), 4);
+  CORRADE_COMPARE(renderer.sceneStats(0).nodeCount, 5);
+  CORRADE_COMPARE(renderer.sceneStats(1).nodeCount, 0);
+  CORRADE_COMPARE(renderer.sceneStats(3).nodeCount, 0);
+
+  /* Populate the rest like in multipleScenes(), without adding any file */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "circle"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 2);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(3, "triangle"), 0);
+
+  renderer.updateCamera(
+      1, identity, Mn::Matrix4::translation({0.0f, 0.5f, 1.0f}).inverted());
+  renderer.transformations(1)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+  renderer.transformations(1)[2] =
+      Mn::Matrix4::translation({-0.5f, 1.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.updateCamera(
+      3, identity, Mn::Matrix4::translation({0.0f, -0.5f, 1.0f}).inverted());
+  renderer.transformations(3)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_WITH(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleScenes.png"),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+
+  /* Shrinking discards the scenes past the new count */
+  renderer.setTileSizeCount({64, 48}, {2, 1});
+  CORRADE_COMPARE(renderer.sceneCount(), 2);
+  CORRADE_COMPARE(renderer.sceneStats(0).nodeCount, 5);
+  CORRADE_COMPARE(renderer.sceneStats(1).nodeCount, 4);
+
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(renderer.colorImage().size(), (Mn::Vector2i{128, 48}));
+}
+
+void GfxBatchRendererTest::frustumCulling() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({64, 48}, {2, 2})
+          .setFlags(esp::gfx_batch::RendererFlag::FrustumCulling),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  /* Same setup as in multipleScenes() */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "four squares"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "circle"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 2);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(3, "triangle"), 0);
+
+  const auto identity = Mn::Matrix4{Mn::Math::IdentityInit};
+  renderer.updateCamera(
+      0, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.transformations(0)[0] = Mn::Matrix4::translation({0.0f, 0.0f, 0.0f});
+
+  renderer.updateCamera(
+      1, identity, Mn::Matrix4::translation({0.0f, 0.5f, 1.0f}).inverted());
+  renderer.transformations(1)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+  renderer.transformations(1)[2] =
+      Mn::Matrix4::translation({-0.5f, 1.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.updateCamera(
+      3, identity, Mn::Matrix4::translation({0.0f, -0.5f, 1.0f}).inverted());
+  renderer.transformations(3)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  /* Everything is at least partially visible, so the output is the same as
+     without culling */
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  for (Mn::UnsignedInt i = 0; i != renderer.sceneCount(); ++i) {
+    CORRADE_ITERATION(i);
+    esp::gfx_batch::SceneStats stats = renderer.sceneStats(i);
+    CORRADE_COMPARE(stats.culledDrawCount, 0);
+    CORRADE_COMPARE(stats.visibleDrawCount, stats.drawCount);
+  }
+  CORRADE_COMPARE_WITH(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleScenes.png"),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+
+  /* Moving the circle far to the side and the triangle behind the camera
+     culls them */
+  renderer.transformations(1)[0] =
+      Mn::Matrix4::translation({10.0f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+  renderer.transformations(3)[0] = Mn::Matrix4::translation({0.0f, 0.0f, 5.0f});
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  esp::gfx_batch::SceneStats stats1 = renderer.sceneStats(1);
+  CORRADE_COMPARE(stats1.culledDrawCount, 1);
+  CORRADE_COMPARE(stats1.visibleDrawCount, 1);
+  esp::gfx_batch::SceneStats stats3 = renderer.sceneStats(3);
+  CORRADE_COMPARE(stats3.culledDrawCount, 1);
+  CORRADE_COMPARE(stats3.visibleDrawCount, 0);
+  CORRADE_COMPARE(renderer.sceneStats(0).culledDrawCount, 0);
+}
+
+void GfxBatchRendererTest::quantizeMesh() {
+  Mn::Trade::MeshData sphere = Mn::Primitives::uvSphereSolid(
+      8, 16,
+      Mn::Primitives::UVSphereFlag::TextureCoordinates |
+          Mn::Primitives::UVSphereFlag::Tangents);
+  /* Off-center and scaled to verify the dequantization isn't just identity */
+  Mn::MeshTools::transformPointsInPlace(
+      Mn::Matrix4::translation({3.0f, -1.0f, 0.5f}) *
+          Mn::Matrix4::scaling({2.0f, 0.5f, 1.0f}),
+      sphere.mutableAttribute<Mn::Vector3>(
+          Mn::Trade::MeshAttribute::Position));
+  const Cr::Containers::Array<Mn::Vector3> positions =
+      sphere.positions3DAsArray();
+  const Cr::Containers::Array<Mn::Vector3> normals = sphere.normalsAsArray();
+  const Cr::Containers::Array<Mn::Vector2> textureCoordinates =
+      sphere.textureCoordinates2DAsArray();
+  const Cr::Containers::Array<Mn::UnsignedInt> indices =
+      sphere.indicesAsArray();
+
+  Mn::Matrix4 dequantization;
+  Mn::Trade::MeshData quantized =
+      esp::gfx_batch::quantizeMesh(std::move(sphere), dequantization);
+  CORRADE_COMPARE(quantized.attributeFormat(Mn::Trade::MeshAttribute::Position),
+                  Mn::VertexFormat::Vector3sNormalized);
+  CORRADE_COMPARE(quantized.attributeFormat(Mn::Trade::MeshAttribute::Normal),
+                  Mn::VertexFormat::Vector3sNormalized);
+  CORRADE_COMPARE(quantized.attributeFormat(Mn::Trade::MeshAttribute::Tangent),
+                  Mn::VertexFormat::Vector4sNormalized);
+  CORRADE_COMPARE(
+      quantized.attributeFormat(Mn::Trade::MeshAttribute::TextureCoordinates),
+      Mn::VertexFormat::Vector2usNormalized);
+  CORRADE_COMPARE(quantized.attributeStride(0) % 4, 0);
+  CORRADE_COMPARE_AS(quantized.indicesAsArray(), indices,
+                     Cr::TestSuite::Compare::Container);
+  /* The scale is uniform, the largest half extent */
+  CORRADE_COMPARE(dequantization.scaling(), Mn::Vector3{2.0f});
+  CORRADE_COMPARE(dequantization.translation(),
+                  (Mn::Vector3{3.0f, -1.0f, 0.5f}));
+
+  Cr::Containers::Array<Mn::Vector3> dequantizedPositions =
+      quantized.positions3DAsArray();
+  Mn::MeshTools::transformPointsInPlace(dequantization, dequantizedPositions);
+  const Cr::Containers::Array<Mn::Vector3> quantizedNormals =
+      quantized.normalsAsArray();
+  const Cr::Containers::Array<Mn::Vector2> quantizedTextureCoordinates =
+      quantized.textureCoordinates2DAsArray();
+  for (std::size_t i = 0; i != positions.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE_WITH(dequantizedPositions[i], positions[i],
+                         Cr::TestSuite::Compare::around(Mn::Vector3{1.0e-4f}));
+    CORRADE_COMPARE_WITH(quantizedNormals[i], normals[i],
+                         Cr::TestSuite::Compare::around(Mn::Vector3{1.0e-4f}));
+    CORRADE_COMPARE_WITH(quantizedTextureCoordinates[i], textureCoordinates[i],
+                         Cr::TestSuite::Compare::around(Mn::Vector2{1.0e-4f}));
+  }
+
+  /* Meshes with 2D positions are passed through unchanged */
+  Mn::Matrix4 dequantization2D = Mn::Matrix4::translation({1.0f, 2.0f, 3.0f});
+  Mn::Trade::MeshData circle = esp::gfx_batch::quantizeMesh(
+      Mn::Primitives::circle2DSolid(8), dequantization2D);
+  CORRADE_COMPARE(dequantization2D, Mn::Matrix4{});
+  CORRADE_COMPARE(circle.attributeFormat(Mn::Trade::MeshAttribute::Position),
+                  Mn::VertexFormat::Vector2);
+}
+
+void GfxBatchRendererTest::quantizeVertices() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({64, 48}, {2, 2})
+          .setFlags(esp::gfx_batch::RendererFlag::FrustumCulling|
+                    esp::gfx_batch::RendererFlag::QuantizeVertices),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  /* Same setup as in multipleScenes(), the output should be the same apart
+     from rounding at triangle edges */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "four squares"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "circle"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 2);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(3, "triangle"), 0);
+
+  const auto identity = Mn::Matrix4{Mn::Math::IdentityInit};
+  renderer.updateCamera(
+      0, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.transformations(0)[0] = Mn::Matrix4::translation({0.0f, 0.0f, 0.0f});
+
+  renderer.updateCamera(
+      1, identity, Mn::Matrix4::translation({0.0f, 0.5f, 1.0f}).inverted());
+  renderer.transformations(1)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+  renderer.transformations(1)[2] =
+      Mn::Matrix4::translation({-0.5f, 1.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.updateCamera(
+      3, identity, Mn::Matrix4::translation({0.0f, -0.5f, 1.0f}).inverted());
+  renderer.transformations(3)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  /* The bounds are in the quantized space as well, so nothing gets culled */
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  for (Mn::UnsignedInt i = 0; i != renderer.sceneCount(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(renderer.sceneStats(i).culledDrawCount, 0);
+  }
+  CORRADE_COMPARE_WITH(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleScenes.png"),
+      (Mn::DebugTools::CompareImageToFile{
+          Mn::Math::max(data.maxThreshold, 64.0f),
+          Mn::Math::max(data.meanThreshold, 0.25f)}));
+}
+
+void GfxBatchRendererTest::levelsOfDetail() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({64, 48}, {2, 1}),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  /* Unknown names and self-references are rejected */
+  {
+    std::ostringstream out;
+    Cr::Utility::Error redirectError{&out};
+    CORRADE_VERIFY(
+        !renderer.addNodeHierarchyLod("square", "nonexistent", 0.5f));
+    CORRADE_VERIFY(
+        !renderer.addNodeHierarchyLod("nonexistent", "square", 0.5f));
+    CORRADE_VERIFY(!renderer.addNodeHierarchyLod("square", "square", 0.5f));
+    CORRADE_COMPARE(out.str(),
+                    "Renderer::addNodeHierarchyLod(): name nonexistent not "
+                    "found\n"
+                    "Renderer::addNodeHierarchyLod(): name nonexistent not "
+                    "found\n"
+                    "Renderer::addNodeHierarchyLod(): can't use square as its "
+                    "own level of detail\n");
+  }
+
+  /* The circle is drawn instead of the square if it's small enough, the
+     triangle if it's even smaller. Added in the opposite order to verify
+     they get sorted. */
+  CORRADE_VERIFY(renderer.addNodeHierarchyLod("square", "triangle", 0.05f));
+  CORRADE_VERIFY(renderer.addNodeHierarchyLod("square", "circle", 0.5f));
+
+  /* The square and both levels are under the top-level node, shifting the ID
+     of the next hierarchy */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "triangle"), 4);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 0);
+
+  const auto identity = Mn::Matrix4{Mn::Math::IdentityInit};
+  renderer.updateCamera(
+      0, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.updateCamera(
+      1, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.transformations(1)[0] = Mn::Matrix4::scaling(Mn::Vector3{0.1f});
+
+  /* A full-size square in the first scene, the circle level in the second */
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  esp::gfx_batch::SceneStats stats0 = renderer.sceneStats(0);
+  CORRADE_COMPARE(stats0.drawCount, 4);
+  CORRADE_COMPARE(stats0.inactiveLodDrawCount, 2);
+  CORRADE_COMPARE(stats0.visibleDrawCount, 2);
+  esp::gfx_batch::SceneStats stats1 = renderer.sceneStats(1);
+  CORRADE_COMPARE(stats1.drawCount, 3);
+  CORRADE_COMPARE(stats1.inactiveLodDrawCount, 2);
+  CORRADE_COMPARE(stats1.visibleDrawCount, 1);
+
+  /* Scaling the square down in the first scene selects the triangle level,
+     the other hierarchy isn't affected */
+  renderer.transformations(0)[0] = Mn::Matrix4::scaling(Mn::Vector3{0.01f});
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(renderer.sceneStats(0).inactiveLodDrawCount, 2);
+  CORRADE_COMPARE(renderer.sceneStats(0).visibleDrawCount, 2);
+
+  /* Clearing the scene removes the levels as well */
+  renderer.clear(0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "triangle"), 0);
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(renderer.sceneStats(0).inactiveLodDrawCount, 0);
+  CORRADE_COMPARE(renderer.sceneStats(0).visibleDrawCount, 1);
+}
+
+void GfxBatchRendererTest::bulkUpdate() {
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {2, 2}),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+
+  /* Same result as calling updateCamera() for each scene */
+  Mn::Matrix4 projections[4];
+  Mn::Matrix4 views[4];
+  for (std::size_t i = 0; i != 4; ++i) {
+    projections[i] = Mn::Matrix4::perspectiveProjection(
+        Mn::Deg(30.0f + 10.0f * i), 4.0f / 3.0f, 0.1f, 10.0f);
+    views[i] =
+        Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f + i)).inverted();
+  }
+  renderer.updateCameras(projections, views);
+  for (Mn::UnsignedInt i = 0; i != 4; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(renderer.camera(i), projections[i] * views[i]);
+    CORRADE_COMPARE(renderer.cameraProjection(i), projections[i]);
+    CORRADE_COMPARE(renderer.cameraDepthUnprojection(i),
+                    esp::gfx_batch::calculateDepthUnprojection(projections[i]));
+  }
+
+  /* Nodes in several scenes updated in a single call, the rest untouched */
+  CORRADE_COMPARE(renderer.addEmptyNode(0), 0);
+  CORRADE_COMPARE(renderer.addEmptyNode(0), 1);
+  CORRADE_COMPARE(renderer.addEmptyNode(2), 0);
+  CORRADE_COMPARE(renderer.addEmptyNode(3), 0);
+  const Mn::UnsignedInt sceneIds[]{2, 0, 3};
+  const Mn::UnsignedInt nodeIds[]{0, 1, 0};
+  const Mn::Matrix4 transformations[]{
+      Mn::Matrix4::translation(Mn::Vector3::xAxis(1.0f)),
+      Mn::Matrix4::scaling(Mn::Vector3{2.0f}),
+      Mn::Matrix4::rotationZ(45.0_degf)};
+  renderer.updateTransformations(sceneIds, nodeIds, transformations);
+  CORRADE_COMPARE(renderer.transformations(0)[0], Mn::Matrix4{});
+  CORRADE_COMPARE(renderer.transformations(0)[1], transformations[1]);
+  CORRADE_COMPARE(renderer.transformations(2)[0], transformations[0]);
+  CORRADE_COMPARE(renderer.transformations(3)[0], transformations[2]);
+}
+
+void GfxBatchRendererTest::objectId() {
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {2, 1})
+          .setFlags(esp::gfx_batch::RendererFlag::ObjectId),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.objectIdFramebufferFormat(),
+                  Mn::PixelFormat::R32UI);
+
+  /* Mostly the same as singleMesh(), with the square in both scenes */
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+  for (Mn::UnsignedInt i = 0; i != renderer.sceneCount(); ++i)
+    renderer.updateCamera(
+        i,
+        Mn::Matrix4::orthographicProjection(
+            2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f}, 0.1f, 10.0f),
+        Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+
+  /* The ID is taken from the top-level node, an empty node before it doesn't
+     affect anything */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  CORRADE_COMPARE(renderer.addEmptyNode(1), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 1);
+  CORRADE_COMPARE(renderer.objectIds(0).size(),
+                  renderer.transformations(0).size());
+  renderer.transformations(0)[0] = Mn::Matrix4::scaling(Mn::Vector3{0.8f});
+  renderer.transformations(1)[1] = Mn::Matrix4::scaling(Mn::Vector3{0.8f});
+  renderer.objectIds(0)[0] = 37;
+  renderer.objectIds(1)[0] = 12;
+  renderer.objectIds(1)[1] = 5;
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  Mn::Image2D image = renderer.objectIdImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(image.size(), (Mn::Vector2i{256, 96}));
+  CORRADE_COMPARE(image.format(), Mn::PixelFormat::R32UI);
+  Cr::Containers::StridedArrayView2D<const Mn::UnsignedInt> pixels =
+      image.pixels<Mn::UnsignedInt>();
+  CORRADE_COMPARE(pixels[48][64], 37);
+  CORRADE_COMPARE(pixels[48][128 + 64], 5);
+  /* The background is cleared to zero */
+  CORRADE_COMPARE(pixels[0][0], 0);
+  CORRADE_COMPARE(pixels[0][128], 0);
+
+  /* Reading a subrectangle and changing the ID */
+  renderer.objectIds(0)[0] = 1;
+  renderer.draw();
+  Mn::UnsignedInt data[4];
+  renderer.objectIdImageInto(
+      {{63, 47}, {65, 49}},
+      Mn::MutableImageView2D{Mn::PixelFormat::R32UI, {2, 2}, data});
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  for (Mn::UnsignedInt id : data)
+    CORRADE_COMPARE(id, 1);
+}
+
+void GfxBatchRendererTest::skinningUnskinnedFile() {
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1})
+          .setMaxJointCount(16),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.maxJointCount(), 16);
+
+  /* Files without skins render the same with skinning enabled, and their
+     hierarchies have no joints */
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+  CORRADE_COMPARE(renderer.jointId("square", "square"), -1);
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  renderer.transformations(0)[0] = Mn::Matrix4::scaling(Mn::Vector3{0.8f});
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_AS(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(TEST_ASSETS,
+                              "screenshots/GfxBatchRendererTestSingleMesh.png"),
+      Mn::DebugTools::CompareImageToFile);
+}
+
+void GfxBatchRendererTest::gpuMemoryBudget() {
+  /* A budget of a single byte evicts everything not used in a frame */
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({64, 48}, {2, 2})
+          .setGpuMemoryBudget(1),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.gpuMemoryBudget(), 1);
+
+  /* Same files as the "multiple files" case in multipleScenes() */
+  CORRADE_VERIFY(renderer.addFile(Cr::Utility::Path::join(
+      {TEST_ASSETS, "scenes", "batch-square-circle-triangle.gltf"})));
+  CORRADE_VERIFY(renderer.addFile(Cr::Utility::Path::join(
+      {TEST_ASSETS, "scenes", "batch-four-squares.gltf"})));
+
+  /* Nothing has been drawn yet, so nothing got evicted */
+  esp::gfx_batch::ResidencyStats stats = renderer.residencyStats();
+  CORRADE_COMPARE(stats.gpuMemoryBudget, 1);
+  CORRADE_COMPARE(stats.meshCount, 2);
+  CORRADE_COMPARE(stats.residentMeshCount, 2);
+  CORRADE_COMPARE(stats.residentTextureCount, stats.textureCount);
+  CORRADE_COMPARE(stats.evictedCount, 0);
+
+  /* Drawing just the four squares evicts the other file */
+  const auto identity = Mn::Matrix4{Mn::Math::IdentityInit};
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "four squares"), 0);
+  renderer.updateCamera(
+      0, identity, Mn::Matrix4::translation({0.0f, 0.0f, 1.0f}).inverted());
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  stats = renderer.residencyStats();
+  CORRADE_COMPARE(stats.residentMeshCount, 1);
+  CORRADE_COMPARE_AS(stats.residentTextureCount, stats.textureCount,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE_AS(stats.evictedCount, 0,
+                     Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE(stats.streamedCount, 0);
+  /* The budget is exceeded by what the scene uses */
+  CORRADE_COMPARE_AS(stats.residentSize, 1, Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE(renderer.sceneStats(0).meshCount, 1);
+  CORRADE_COMPARE_AS(renderer.sceneStats(0).residentSize, 0,
+                     Cr::TestSuite::Compare::Greater);
+
+  /* Populating the rest like in multipleScenes() streams the evicted data
+     back in, with the output matching */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "circle"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(1, "square"), 2);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(3, "triangle"), 0);
+
+  renderer.updateCamera(
+      1, identity, Mn::Matrix4::translation({0.0f, 0.5f, 1.0f}).inverted());
+  renderer.transformations(1)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+  renderer.transformations(1)[2] =
+      Mn::Matrix4::translation({-0.5f, 1.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.updateCamera(
+      3, identity, Mn::Matrix4::translation({0.0f, -0.5f, 1.0f}).inverted());
+  renderer.transformations(3)[0] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.5f});
+
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  stats = renderer.residencyStats();
+  CORRADE_COMPARE(stats.residentMeshCount, 2);
+  CORRADE_COMPARE(stats.residentTextureCount, stats.textureCount);
+  CORRADE_COMPARE(stats.streamedCount, stats.evictedCount);
+  CORRADE_COMPARE_WITH(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleScenes.png"),
+      (Mn::DebugTools::CompareImageToFile{}));
+
+  /* Clearing the scenes makes the data evictable again */
+  renderer.clear(1);
+  renderer.clear(3);
+  renderer.draw();
+  CORRADE_COMPARE(renderer.residencyStats().residentMeshCount, 1);
+  CORRADE_COMPARE(renderer.sceneStats(1).residentSize, 0);
+}
+
 void GfxBatchRendererTest::lights() {
   auto&& data = LightData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -2245,6 +2875,86 @@ void GfxBatchRendererTest::depthUnprojection() {
   CORRADE_COMPARE(depth.pixels<Mn::Float>()[96][96], 0.0f);
 }
 
+void GfxBatchRendererTest::pointCloud() {
+  constexpr Mn::Vector2i tileCount{2, 2};
+  constexpr Mn::Vector2i tileSize(64, 64);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount(tileSize, tileCount),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.pointCloudFramebufferFormat(),
+                  Mn::PixelFormat::RGBA32F);
+
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+
+  /* Same as depthUnprojection(), except that the last scene uses a different
+     projection to verify each tile is unprojected with its own */
+  const Mn::Matrix4 projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.001f, 10.0f);
+  const Mn::Matrix4 orthographic =
+      Mn::Matrix4::orthographicProjection({2.0f, 2.0f}, 0.1f, 10.0f);
+  renderer.updateCamera(
+      0, projection,
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(2.5f)).inverted());
+  renderer.updateCamera(
+      1, projection,
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(5.0f)).inverted());
+  renderer.updateCamera(
+      2, projection,
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(20.0f)).inverted());
+  renderer.updateCamera(
+      3, orthographic,
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(7.5f)).inverted());
+  CORRADE_COMPARE(renderer.cameraProjection(3), orthographic);
+  for (int i = 0; i < tileCount.product(); ++i) {
+    CORRADE_COMPARE(renderer.addNodeHierarchy(i, "square"), 0);
+  }
+
+  renderer.draw();
+  Mn::Image2D image = renderer.pointCloudImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(image.size(), tileSize * tileCount);
+  CORRADE_COMPARE(image.format(), Mn::PixelFormat::RGBA32F);
+  Cr::Containers::StridedArrayView2D<const Mn::Vector4> points =
+      image.pixels<Mn::Vector4>();
+
+  /* The center pixels are on the plane, in front of the camera */
+  const Mn::Vector4 point0 = points[32][32];
+  const Mn::Vector4 point1 = points[32][96];
+  const Mn::Vector4 point3 = points[96][96];
+  CORRADE_COMPARE_WITH(point0.z(), -2.5f,
+                       Corrade::TestSuite::Compare::around(0.01f));
+  CORRADE_COMPARE_WITH(point1.z(), -5.0f,
+                       Corrade::TestSuite::Compare::around(0.01f));
+  CORRADE_COMPARE_WITH(point3.z(), -7.5f,
+                       Corrade::TestSuite::Compare::around(0.01f));
+  CORRADE_COMPARE(point0.w(), 1.0f);
+  CORRADE_COMPARE(point1.w(), 1.0f);
+  CORRADE_COMPARE(point3.w(), 1.0f);
+  /* The X and Y coordinates are close to the optical axis, with the offset
+     of the pixel center growing with distance for the perspective
+     projection */
+  CORRADE_COMPARE_WITH(point0.x(), 0.0f,
+                       Corrade::TestSuite::Compare::around(0.1f));
+  CORRADE_COMPARE_WITH(point0.y(), 0.0f,
+                       Corrade::TestSuite::Compare::around(0.1f));
+  CORRADE_VERIFY(point1.x() > point0.x());
+  /* A pixel off the center of the orthographic tile is offset by exactly the
+     pixel size, independently of the distance */
+  CORRADE_COMPARE(points[96][97].x() - point3.x(), 2.0f / tileSize.x());
+  CORRADE_COMPARE_WITH(points[96][97].z(), -7.5f,
+                       Corrade::TestSuite::Compare::around(0.01f));
+
+  /* The plane in scene 2 is beyond the far plane, the points are zero */
+  CORRADE_COMPARE(points[96][32], Mn::Vector4{});
+}
+
 void GfxBatchRendererTest::cudaInterop() {
 #ifndef ESP_BUILD_WITH_CUDA
   CORRADE_SKIP("ESP_BUILD_WITH_CUDA is not enabled");
@@ -16,6 +16,8 @@
 #include "esp/gfx/LightSetup.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/KeyframeBinary.h"
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
@@ -26,8 +28,14 @@
 #include "esp/sim/Simulator.h"
 
 #include <fstream>
+#include <map>
+#include <sstream>
 #include <string>
 
+#ifdef CORRADE_TARGET_UNIX
+#include <unistd.h>
+#endif
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -56,6 +64,13 @@ struct GfxReplayTest : Cr::TestSuite::Tester {
   void testLightIntegration();
   void testSkinningIntegration();
   void testDecimalPlaces();
+  void testBinaryFormat();
+  void testStreaming();
+  void testPlayerSeek();
+  void testRecorderDirtyTracking();
+  void testKeyframeRingBuffer();
+
+  void benchmarkCreateDeleteChurn();
 
   esp::logging::LoggingContext loggingContext;
 
@@ -80,7 +95,14 @@ GfxReplayTest::GfxReplayTest() {
       &GfxReplayTest::testLightIntegration,
       &GfxReplayTest::testSkinningIntegration,
       &GfxReplayTest::testDecimalPlaces,
+      &GfxReplayTest::testBinaryFormat,
+      &GfxReplayTest::testStreaming,
+      &GfxReplayTest::testPlayerSeek,
+      &GfxReplayTest::testRecorderDirtyTracking,
+      &GfxReplayTest::testKeyframeRingBuffer,
   });
+
+  addBenchmarks({&GfxReplayTest::benchmarkCreateDeleteChurn}, 10);
 }  // ctor
 
 // Manipulate the scene and save some keyframes using replay::Recorder
@@ -787,6 +809,462 @@ void GfxReplayTest::testDecimalPlaces() {
   }
 }
 
+// round-trip keyframes through the binary format, both directly and
+// through the Player
+void GfxReplayTest::testBinaryFormat() {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::RenderAssetInstanceState;
+  using esp::gfx::replay::Transform;
+
+  const Mn::Quaternion rotationA = Mn::Quaternion::rotation(
+      Mn::Deg(45.f), Mn::Vector3(1.f, 1.f, 0.f).normalized());
+  const Mn::Quaternion rotationB =
+      Mn::Quaternion::rotation(Mn::Deg(-30.f), Mn::Vector3::yAxis());
+
+  std::vector<Keyframe> keyframes(3);
+  {
+    Keyframe& keyframe = keyframes[0];
+    esp::assets::AssetInfo info;
+    info.filepath = "box.glb";
+    info.virtualUnitToMeters = 0.5f;
+    info.forceFlatShading = false;
+    info.overridePhongMaterial = esp::assets::PhongMaterialColor{};
+    info.overridePhongMaterial->diffuseColor = Mn::Color4{0.25f, 0.5f, 1.f};
+    keyframe.loads.push_back(info);
+
+    esp::assets::RenderAssetInstanceCreationInfo::Flags flags;
+    flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+    flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsSemantic;
+    keyframe.creations.emplace_back(
+        3, esp::assets::RenderAssetInstanceCreationInfo{
+               "box.glb", Mn::Vector3{2.f}, flags, "lights"});
+    keyframe.creations.emplace_back(
+        7, esp::assets::RenderAssetInstanceCreationInfo{
+               "box.glb", Cr::Containers::NullOpt, flags, "", 1});
+    keyframe.rigCreations.push_back({1, {"root", "arm", "hand"}});
+    keyframe.stateUpdates.emplace_back(
+        3, RenderAssetInstanceState{{{1.f, 2.f, 3.f}, rotationA}, 4});
+    keyframe.stateUpdates.emplace_back(
+        7, RenderAssetInstanceState{{{-1.f, 0.f, 5.f}, rotationB}, 1});
+    keyframe.lights.push_back(
+        {{1.f, 2.f, 3.f, 1.f}, {0.5f, 0.5f, 1.f}, LightPositionModel::Camera});
+    keyframe.lightsChanged = true;
+  }
+  {
+    // only the translation of instance 3 changes
+    Keyframe& keyframe = keyframes[1];
+    keyframe.stateUpdates.emplace_back(
+        3, RenderAssetInstanceState{{{1.f, 2.5f, 3.f}, rotationA}, 4});
+    keyframe.rigUpdates.push_back(
+        {1, {Transform{{}, rotationA}, Transform{{0.f, 1.f, 0.f}, rotationB},
+             Transform{{0.f, 2.f, 0.f}, {}}}});
+    keyframe.userTransforms["camera"] = Transform{{0.f, 1.5f, 0.f}, rotationB};
+  }
+  {
+    Keyframe& keyframe = keyframes[2];
+    keyframe.deletions.push_back(7);
+    keyframe.stateUpdates.emplace_back(
+        3, RenderAssetInstanceState{{{1.f, 2.5f, 3.f}, rotationB}, 5});
+  }
+
+  const Cr::Containers::Array<char> data =
+      esp::gfx::replay::writeKeyframesToBinary(keyframes);
+  CORRADE_VERIFY(esp::gfx::replay::isBinaryKeyframeData(data));
+
+  const std::vector<Keyframe> out =
+      esp::gfx::replay::readKeyframesFromBinary(data);
+  CORRADE_COMPARE(out.size(), 3);
+
+  CORRADE_COMPARE(out[0].loads.size(), 1);
+  CORRADE_VERIFY(out[0].loads[0] == keyframes[0].loads[0]);
+  CORRADE_COMPARE(out[0].creations.size(), 2);
+  CORRADE_COMPARE(out[0].creations[0].first, 3);
+  CORRADE_COMPARE(out[0].creations[0].second.filepath, "box.glb");
+  CORRADE_VERIFY(out[0].creations[0].second.scale);
+  CORRADE_COMPARE(*out[0].creations[0].second.scale, Mn::Vector3{2.f});
+  CORRADE_VERIFY(out[0].creations[0].second.isRGBD());
+  CORRADE_VERIFY(out[0].creations[0].second.isSemantic());
+  CORRADE_VERIFY(!out[0].creations[0].second.isStatic());
+  CORRADE_COMPARE(out[0].creations[0].second.lightSetupKey, "lights");
+  CORRADE_COMPARE(out[0].creations[1].first, 7);
+  CORRADE_VERIFY(!out[0].creations[1].second.scale);
+  CORRADE_COMPARE(out[0].creations[1].second.rigId, 1);
+  CORRADE_COMPARE(out[0].rigCreations.size(), 1);
+  CORRADE_COMPARE(out[0].rigCreations[0].boneNames.size(), 3);
+  CORRADE_COMPARE(out[0].rigCreations[0].boneNames[2], "hand");
+  CORRADE_COMPARE(out[0].lights.size(), 1);
+  CORRADE_VERIFY(out[0].lights[0] == keyframes[0].lights[0]);
+  CORRADE_VERIFY(out[0].lightsChanged);
+  CORRADE_VERIFY(!out[1].lightsChanged);
+
+  // states are reconstructed from the deltas, rotations are quantized
+  for (std::size_t i = 0; i != keyframes.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(out[i].stateUpdates.size(),
+                    keyframes[i].stateUpdates.size());
+    for (std::size_t j = 0; j != keyframes[i].stateUpdates.size(); ++j) {
+      const auto& expected = keyframes[i].stateUpdates[j];
+      const auto& actual = out[i].stateUpdates[j];
+      CORRADE_COMPARE(actual.first, expected.first);
+      CORRADE_COMPARE(actual.second.semanticId, expected.second.semanticId);
+      CORRADE_COMPARE(actual.second.absTransform.translation,
+                      expected.second.absTransform.translation);
+      CORRADE_COMPARE_WITH(
+          (actual.second.absTransform.rotation.vector() -
+           expected.second.absTransform.rotation.vector())
+              .length(),
+          0.0f, Cr::TestSuite::Compare::around(1.0e-4f));
+      CORRADE_VERIFY(actual.second.absTransform.rotation.isNormalized());
+    }
+  }
+
+  CORRADE_COMPARE(out[1].rigUpdates.size(), 1);
+  CORRADE_COMPARE(out[1].rigUpdates[0].pose.size(), 3);
+  CORRADE_COMPARE(out[1].rigUpdates[0].pose[1].translation,
+                  (Mn::Vector3{0.f, 1.f, 0.f}));
+  CORRADE_COMPARE(out[1].userTransforms.size(), 1);
+  CORRADE_COMPARE(out[1].userTransforms.at("camera").translation,
+                  (Mn::Vector3{0.f, 1.5f, 0.f}));
+  CORRADE_COMPARE(out[2].deletions.size(), 1);
+  CORRADE_COMPARE(out[2].deletions[0], 7);
+
+  // truncated data is rejected
+  {
+    std::ostringstream err;
+    Mn::Error redirectError{&err};
+    CORRADE_COMPARE(esp::gfx::replay::readKeyframesFromBinary(
+                        data.exceptSuffix(1))
+                        .size(),
+                    0);
+  }
+
+  // the player detects the format
+  const auto testFilepath =
+      Cr::Utility::Path::join(DATA_DIR, "./gfx_replay_test.bin");
+  CORRADE_VERIFY(Cr::Utility::Path::write(testFilepath, data));
+  esp::gfx::replay::Player player{
+      std::make_shared<DummySceneGraphPlayerImplementation>()};
+  player.readKeyframesFromFile(testFilepath);
+  CORRADE_COMPARE(player.getNumKeyframes(), 3);
+
+  bool success = Corrade::Utility::Path::remove(testFilepath);
+  if (!success) {
+    ESP_WARNING() << "Unable to remove temporary test binary file"
+                  << testFilepath;
+  }
+}
+
+// stream keyframes to a file and check they're all there, and that
+// keyframes saved after streaming stopped are still playable on their own
+void GfxReplayTest::testStreaming() {
+  const auto testFilepath =
+      Cr::Utility::Path::join(DATA_DIR, "./gfx_replay_stream_test.json");
+
+  esp::gfx::replay::Recorder recorder;
+  esp::assets::AssetInfo info;
+  info.filepath = "streamed_asset.glb";
+  recorder.onLoadRenderAsset(info);
+  recorder.saveKeyframe();
+
+  // already saved keyframes get streamed too, a queue of one makes sure
+  // saveKeyframe() waits for the writer
+  recorder.startStreamingToFile(testFilepath, 1);
+  CORRADE_VERIFY(recorder.isStreaming());
+  CORRADE_VERIFY(recorder.debugGetSavedKeyframes().empty());
+  for (int i = 0; i != 20; ++i) {
+    recorder.addUserTransformToKeyframe(
+        "camera", Mn::Vector3(float(i), 0.f, 0.f), Mn::Quaternion{});
+    recorder.saveKeyframe();
+    CORRADE_VERIFY(recorder.debugGetSavedKeyframes().empty());
+  }
+  CORRADE_COMPARE(
+      recorder.getLatestKeyframe().userTransforms.at("camera").translation,
+      (Mn::Vector3{19.f, 0.f, 0.f}));
+  recorder.stopStreaming();
+  CORRADE_VERIFY(!recorder.isStreaming());
+
+  esp::gfx::replay::Player player{
+      std::make_shared<DummySceneGraphPlayerImplementation>()};
+  player.readKeyframesFromFile(testFilepath);
+  CORRADE_COMPARE(player.getNumKeyframes(), 21);
+
+  // the load got consolidated into the new keyframes
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes().size(), 1);
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes()[0].loads.size(), 1);
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes()[0].loads[0].filepath,
+                  "streamed_asset.glb");
+
+  bool success = Corrade::Utility::Path::remove(testFilepath);
+  if (!success) {
+    ESP_WARNING() << "Unable to remove temporary test JSON file"
+                  << testFilepath;
+  }
+}
+
+// Tracks instance translations in a map and counts applied transforms
+class CountingPlayerImplementation
+    : public esp::gfx::replay::AbstractPlayerImplementation {
+ public:
+  std::map<std::size_t, Mn::Vector3> translations;
+  int transformCount = 0;
+
+ private:
+  esp::gfx::replay::NodeHandle loadAndCreateRenderAssetInstance(
+      const esp::assets::AssetInfo&,
+      const esp::assets::RenderAssetInstanceCreationInfo&) override {
+    translations[++lastHandle_] = {};
+    return reinterpret_cast<esp::gfx::replay::NodeHandle>(lastHandle_);
+  }
+  void deleteAssetInstance(esp::gfx::replay::NodeHandle node) override {
+    translations.erase(reinterpret_cast<std::size_t>(node));
+  }
+  void deleteAssetInstances(
+      const std::unordered_map<esp::gfx::replay::RenderAssetInstanceKey,
+                               esp::gfx::replay::NodeHandle>&) override {
+    translations.clear();
+  }
+  void setNodeTransform(esp::gfx::replay::NodeHandle node,
+                        const Mn::Vector3& translation,
+                        const Mn::Quaternion&) override {
+    translations[reinterpret_cast<std::size_t>(node)] = translation;
+    ++transformCount;
+  }
+  void setNodeTransform(esp::gfx::replay::NodeHandle node,
+                        const Mn::Matrix4& transform) override {
+    translations[reinterpret_cast<std::size_t>(node)] =
+        transform.translation();
+    ++transformCount;
+  }
+  Mn::Matrix4 hackGetNodeTransform(
+      esp::gfx::replay::NodeHandle node) const override {
+    return Mn::Matrix4::translation(
+        translations.at(reinterpret_cast<std::size_t>(node)));
+  }
+
+  std::size_t lastHandle_ = 0;
+};
+
+// seeking through checkpoints gives the same state as applying all keyframes
+void GfxReplayTest::testPlayerSeek() {
+  esp::assets::AssetInfo info;
+  info.filepath = "box.glb";
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+
+  // instance 0 lives for the whole replay and moves every frame, instance 1
+  // lives from frame 10 to 119
+  std::vector<esp::gfx::replay::Keyframe> keyframes(250);
+  keyframes[0].loads.push_back(info);
+  keyframes[0].creations.emplace_back(0, creation);
+  keyframes[10].creations.emplace_back(1, creation);
+  keyframes[10].stateUpdates.emplace_back(
+      1, esp::gfx::replay::RenderAssetInstanceState{
+             {Mn::Vector3{-1.f}, Mn::Quaternion{}}, 0});
+  keyframes[120].deletions.push_back(1);
+  for (int i = 0; i != int(keyframes.size()); ++i) {
+    keyframes[i].stateUpdates.emplace_back(
+        0, esp::gfx::replay::RenderAssetInstanceState{
+               {Mn::Vector3{float(i), 0.f, 0.f}, Mn::Quaternion{}}, 0});
+  }
+
+  auto implementation = std::make_shared<CountingPlayerImplementation>();
+  esp::gfx::replay::Player player{implementation};
+  player.setCheckpointInterval(50);
+  CORRADE_COMPARE(player.getCheckpointInterval(), 50);
+  player.debugSetKeyframes(std::move(keyframes));
+
+  // instance translations sorted by x, to not depend on handle values
+  const auto sortedTranslations = [&]() {
+    std::vector<float> out;
+    for (const auto& pair : implementation->translations)
+      out.push_back(pair.second.x());
+    std::sort(out.begin(), out.end());
+    return out;
+  };
+
+  // the first seek applies every keyframe to build the checkpoints, the next
+  // ones start from a checkpoint
+  player.setKeyframeIndex(230);
+  CORRADE_COMPARE(sortedTranslations(), (std::vector<float>{230.f}));
+
+  implementation->transformCount = 0;
+  player.setKeyframeIndex(60);
+  CORRADE_COMPARE(player.getKeyframeIndex(), 60);
+  CORRADE_COMPARE(sortedTranslations(), (std::vector<float>{-1.f, 60.f}));
+  // checkpoint at 50 with two instances, then 10 keyframes
+  CORRADE_COMPARE(implementation->transformCount, 2 + 10);
+
+  implementation->transformCount = 0;
+  player.setKeyframeIndex(61);
+  CORRADE_COMPARE(sortedTranslations(), (std::vector<float>{-1.f, 61.f}));
+  CORRADE_COMPARE(implementation->transformCount, 1);
+
+  implementation->transformCount = 0;
+  player.setKeyframeIndex(249);
+  CORRADE_COMPARE(sortedTranslations(), (std::vector<float>{249.f}));
+  // checkpoint at 200 with one instance, then 49 keyframes
+  CORRADE_COMPARE(implementation->transformCount, 1 + 49);
+
+  // disabling checkpoints goes back to applying everything from the start
+  player.setCheckpointInterval(0);
+  implementation->transformCount = 0;
+  player.setKeyframeIndex(130);
+  CORRADE_COMPARE(sortedTranslations(), (std::vector<float>{130.f}));
+  CORRADE_COMPARE_AS(implementation->transformCount, 130,
+                     Cr::TestSuite::Compare::Greater);
+}
+
+// only instances whose transformation or semantic ID changed get updated
+void GfxReplayTest::testRecorderDirtyTracking() {
+  // the recorder has to outlive the scene, which notifies it about deletions
+  esp::gfx::replay::Recorder recorder;
+  SceneManager sceneManager;
+  auto& sceneGraph = sceneManager.getSceneGraph(sceneManager.initSceneGraph());
+  auto& parent = sceneGraph.getRootNode().createChild();
+  auto& a = parent.createChild();
+  auto& b = sceneGraph.getRootNode().createChild();
+
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+  recorder.onCreateRenderAssetInstance(&a, creation);
+  recorder.onCreateRenderAssetInstance(&b, creation);
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+
+  // first keyframe has both, second none
+  recorder.saveKeyframe();
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[0].stateUpdates.size(), 2);
+  CORRADE_COMPARE(keyframes[1].stateUpdates.size(), 0);
+
+  // moving the parent updates the child
+  parent.translate(Mn::Vector3(1.f, 0.f, 0.f));
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[2].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[2].stateUpdates[0].second.absTransform.translation,
+                  (Mn::Vector3{1.f, 0.f, 0.f}));
+
+  // a moved node that ends up in the same place produces no update
+  b.translate(Mn::Vector3(1.f, 0.f, 0.f));
+  b.translate(Mn::Vector3(-1.f, 0.f, 0.f));
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[3].stateUpdates.size(), 0);
+
+  // semantic ID changes are picked up as well
+  b.setSemanticId(3);
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[4].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[4].stateUpdates[0].second.semanticId, 3);
+
+  // moving the child again after it got cleaned is still noticed
+  a.translate(Mn::Vector3(0.f, 2.f, 0.f));
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[5].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[5].stateUpdates[0].second.absTransform.translation,
+                  (Mn::Vector3{1.f, 2.f, 0.f}));
+}
+
+// push keyframes through a ring buffer opened a second time, as a renderer
+// process would, until it's full and then again wrapping around its end
+void GfxReplayTest::testKeyframeRingBuffer() {
+#ifndef CORRADE_TARGET_UNIX
+  CORRADE_SKIP("Shared memory is only supported on Unix");
+#else
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::KeyframeRingBuffer;
+
+  const std::string name =
+      "/habitat-GfxReplayTest-" + std::to_string(getpid());
+  KeyframeRingBuffer producer{name, 512};
+  KeyframeRingBuffer::ptr consumer = KeyframeRingBuffer::open(name);
+  CORRADE_VERIFY(producer.isOwner());
+  CORRADE_VERIFY(!consumer->isOwner());
+  CORRADE_COMPARE(consumer->capacity(), 512);
+  CORRADE_VERIFY(!consumer->pop());
+
+  const auto makeKeyframe = [](int i) {
+    Keyframe keyframe;
+    keyframe.stateUpdates.emplace_back(
+        i, esp::gfx::replay::RenderAssetInstanceState{
+               {Mn::Vector3{float(i), 0.f, 0.f}, Mn::Quaternion{}}, i});
+    keyframe.userTransforms["camera"] =
+        esp::gfx::replay::Transform{{0.f, float(i), 0.f}, {}};
+    return keyframe;
+  };
+
+  int pushed = 0;
+  while (producer.push(makeKeyframe(pushed)))
+    ++pushed;
+  CORRADE_VERIFY(pushed > 1);
+  CORRADE_VERIFY(consumer->usedSize() <= consumer->capacity());
+
+  // popping only some makes room for more, which wrap around
+  for (int i = 0; i != pushed / 2; ++i) {
+    Cr::Containers::Optional<Keyframe> keyframe = consumer->pop();
+    CORRADE_VERIFY(keyframe);
+    CORRADE_COMPARE(keyframe->stateUpdates.size(), 1);
+    CORRADE_COMPARE(keyframe->stateUpdates[0].first, i);
+  }
+  int next = pushed;
+  while (producer.push(makeKeyframe(next)))
+    ++next;
+  CORRADE_VERIFY(next > pushed);
+
+  auto implementation = std::make_shared<CountingPlayerImplementation>();
+  esp::gfx::replay::Player player{implementation};
+  CORRADE_COMPARE(player.appendKeyframesFromRingBuffer(*consumer),
+                  next - pushed / 2);
+  CORRADE_COMPARE(consumer->usedSize(), 0);
+  const std::vector<Keyframe>& keyframes = player.debugGetKeyframes();
+  for (int i = 0; i != int(keyframes.size()); ++i) {
+    CORRADE_ITERATION(i);
+    const int expected = pushed / 2 + i;
+    CORRADE_COMPARE(keyframes[i].stateUpdates.size(), 1);
+    CORRADE_COMPARE(keyframes[i].stateUpdates[0].first, expected);
+    CORRADE_COMPARE(keyframes[i].stateUpdates[0].second.semanticId, expected);
+    CORRADE_COMPARE(keyframes[i].userTransforms.at("camera").translation,
+                    (Mn::Vector3{0.f, float(expected), 0.f}));
+  }
+
+  // a keyframe larger than the whole buffer never fits
+  Keyframe large;
+  for (int i = 0; i != 64; ++i)
+    large.userTransforms["transform" + std::to_string(i)] = {};
+  CORRADE_VERIFY(!producer.push(large));
+  CORRADE_COMPARE(consumer->usedSize(), 0);
+#endif
+}
+
+// create and delete many instances, deleting in creation order which is the
+// worst case for a linear lookup
+void GfxReplayTest::benchmarkCreateDeleteChurn() {
+  constexpr int InstanceCount = 5000;
+
+  esp::gfx::replay::Recorder recorder;
+  SceneManager sceneManager;
+  auto& sceneGraph = sceneManager.getSceneGraph(sceneManager.initSceneGraph());
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+  std::vector<esp::scene::SceneNode*> nodes(InstanceCount);
+
+  CORRADE_BENCHMARK(1) {
+    for (auto& node : nodes) {
+      node = &sceneGraph.getRootNode().createChild();
+      recorder.onCreateRenderAssetInstance(node, creation);
+    }
+    // save in between so the deletions don't cancel out with the creations
+    recorder.saveKeyframe();
+    for (auto* node : nodes) {
+      delete node;
+    }
+    recorder.saveKeyframe();
+  }
+
+  CORRADE_VERIFY(!recorder.debugGetSavedKeyframes().empty());
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes().back().deletions.size(),
+                  InstanceCount);
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(GfxReplayTest)
@@ -5,18 +5,23 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Path.h>
+#include <rapidjson/stringbuffer.h>
 
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/core/Esp.h"
 #include "esp/io/Io.h"
 #include "esp/io/Json.h"
 #include "esp/io/JsonAllTypes.h"
+#include "esp/io/JsonSnapshot.h"
+#include "esp/io/JsonWriter.h"
 #include "esp/metadata/URDFParser.h"
 #include "esp/metadata/attributes/ArticulatedObjectAttributes.h"
 #include "esp/metadata/attributes/ObjectAttributes.h"
 
 #include "configure.h"
 
+#include <algorithm>
+
 namespace Cr = Corrade;
 
 using esp::metadata::attributes::ArticulatedObjectAttributes;
@@ -30,10 +35,13 @@ struct IOTest : Cr::TestSuite::Tester {
   void testEllipsisFilter();
   void parseURDF();
   void testJson();
+  void testJsonSnapshot();
+  void testJsonArrayElements();
   void testJsonBuiltinTypes();
   void testJsonStlTypes();
   void testJsonMagnumTypes();
   void testJsonEspTypes();
+  void testJsonKeyframeWriter();
 
   void testJsonUserType();
 
@@ -52,10 +60,11 @@ struct IOTest : Cr::TestSuite::Tester {
 
 IOTest::IOTest() {
   addTests({&IOTest::fileReplaceExtTest, &IOTest::testEllipsisFilter,
-            &IOTest::parseURDF, &IOTest::testJson,
-            &IOTest::testJsonBuiltinTypes, &IOTest::testJsonStlTypes,
+            &IOTest::parseURDF, &IOTest::testJson, &IOTest::testJsonSnapshot,
+            &IOTest::testJsonArrayElements, &IOTest::testJsonBuiltinTypes,
+            &IOTest::testJsonStlTypes,
             &IOTest::testJsonMagnumTypes, &IOTest::testJsonEspTypes,
-            &IOTest::testJsonUserType});
+            &IOTest::testJsonKeyframeWriter, &IOTest::testJsonUserType});
 }
 
 void IOTest::fileReplaceExtTest() {
@@ -259,6 +268,95 @@ void IOTest::testJson() {
   CORRADE_COMPARE(attributes->getRenderAssetHandle(), "banana.glb");
 }
 
+void IOTest::testJsonSnapshot() {
+  namespace Path = Corrade::Utility::Path;
+  const std::string dir =
+      Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, "json_snapshot_test");
+  CORRADE_VERIFY(Path::make(dir));
+  const std::string jsonFile = Path::join(dir, "config.json");
+  // outside of dir, writing it would change the listing of dir
+  const std::string snapshotFile =
+      Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, "json_snapshot_test.snapshot");
+  Path::remove(snapshotFile);
+  CORRADE_VERIFY(Path::writeString(jsonFile, "{\"test\":[1,2,3,4]}"));
+
+  // recording reads through to the files
+  {
+    esp::io::JsonSnapshot snapshot;
+    CORRADE_VERIFY(!snapshot.load(snapshotFile));
+    auto listing = snapshot.listDirectory(dir);
+    CORRADE_VERIFY(listing);
+    CORRADE_VERIFY(std::find(listing->begin(), listing->end(),
+                             "config.json") != listing->end());
+    CORRADE_COMPARE(
+        esp::io::jsonToString(snapshot.parseJsonFile(jsonFile)),
+        "{\"test\":[1,2,3,4]}");
+    CORRADE_VERIFY(snapshot.isDirty());
+    CORRADE_VERIFY(snapshot.save(snapshotFile));
+    CORRADE_VERIFY(!snapshot.isDirty());
+  }
+
+  // an unchanged tree is served entirely from the snapshot
+  {
+    esp::io::JsonSnapshot snapshot;
+    CORRADE_VERIFY(snapshot.load(snapshotFile));
+    CORRADE_COMPARE(snapshot.size(), 2);
+    CORRADE_COMPARE(
+        esp::io::jsonToString(snapshot.parseJsonFile(jsonFile)),
+        "{\"test\":[1,2,3,4]}");
+    CORRADE_VERIFY(snapshot.listDirectory(dir));
+    CORRADE_VERIFY(!snapshot.isDirty());
+  }
+
+  // a changed file is dropped on load and read again
+  CORRADE_VERIFY(Path::writeString(jsonFile, "{\"test\":[5]}"));
+  {
+    esp::io::JsonSnapshot snapshot;
+    CORRADE_VERIFY(snapshot.load(snapshotFile));
+    CORRADE_COMPARE(snapshot.size(), 1);
+    CORRADE_VERIFY(snapshot.isDirty());
+    CORRADE_COMPARE(
+        esp::io::jsonToString(snapshot.parseJsonFile(jsonFile)),
+        "{\"test\":[5]}");
+  }
+
+  Path::remove(snapshotFile);
+  Path::remove(jsonFile);
+}
+
+void IOTest::testJsonArrayElements() {
+  using Cr::Containers::StringView;
+  std::vector<StringView> elements;
+
+  // elements of the requested member only, nested values kept whole
+  const StringView json =
+      "{\"other\": [{\"a\": 1}], \"frames\": [{\"a\": [1, {}]}, [2, 3], "
+      "{}], \"after\": 4}";
+  CORRADE_VERIFY(esp::io::findJsonArrayElements(json, "frames", elements));
+  CORRADE_COMPARE(elements.size(), 3);
+  CORRADE_COMPARE(elements[0], "{\"a\": [1, {}]}");
+  CORRADE_COMPARE(elements[1], "[2, 3]");
+  CORRADE_COMPARE(elements[2], "{}");
+  esp::io::JsonDocument d =
+      esp::io::parseJsonString({elements[0].data(), elements[0].size()});
+  CORRADE_VERIFY(d.IsObject());
+
+  // empty array
+  CORRADE_VERIFY(esp::io::findJsonArrayElements("{\"frames\": []}", "frames",
+                                                elements));
+  CORRADE_VERIFY(elements.empty());
+
+  // missing member, member that isn't an array, scalar elements and invalid
+  // text are all rejected
+  CORRADE_VERIFY(!esp::io::findJsonArrayElements(json, "missing", elements));
+  CORRADE_VERIFY(!esp::io::findJsonArrayElements(json, "after", elements));
+  CORRADE_VERIFY(!esp::io::findJsonArrayElements("{\"frames\": [{}, 1]}",
+                                                 "frames", elements));
+  CORRADE_VERIFY(elements.empty());
+  CORRADE_VERIFY(!esp::io::findJsonArrayElements("{\"frames\": [{}",
+                                                 "frames", elements));
+}
+
 // Serialize/deserialize the 7 rapidjson builtin types using
 // esp::io::addMember/esp::io::readMember and assert equality.
 void IOTest::testJsonBuiltinTypes() {
@@ -446,6 +544,48 @@ void IOTest::testJsonEspTypes() {
   }
 }
 
+// Write a keyframe directly and through its document and compare the output.
+void IOTest::testJsonKeyframeWriter() {
+  esp::gfx::replay::Transform transform{
+      Magnum::Vector3(1.f, 2.f, 3.f),
+      Magnum::Quaternion::rotation(Magnum::Rad{1.f},
+                                   Magnum::Vector3(0.f, 1.f, 0.f))};
+  esp::gfx::replay::Keyframe keyframe;
+  keyframe.creations.emplace_back(
+      3, esp::assets::RenderAssetInstanceCreationInfo(
+             "test_filepath", Magnum::Vector3(1.f, 2.f, 3.f),
+             esp::assets::RenderAssetInstanceCreationInfo::Flags(),
+             "test_light_setup"));
+  keyframe.rigCreations.push_back({5, {"bone0", "bone1"}});
+  keyframe.deletions = {1, 2};
+  keyframe.stateUpdates.emplace_back(
+      3, esp::gfx::replay::RenderAssetInstanceState{transform, 4});
+  keyframe.rigUpdates.push_back({5, {transform, transform}});
+  keyframe.userTransforms["a"] = transform;
+  keyframe.userTransforms["b"] = transform;
+  keyframe.lightsChanged = true;
+
+  auto write = [](const esp::gfx::replay::Keyframe& frame, bool direct) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+    writer.SetMaxDecimalPlaces(3);
+    rapidjson::Document d;
+    if (direct) {
+      esp::io::writeJson(writer, frame, d.GetAllocator());
+    } else {
+      esp::io::toJsonValue(frame, d.GetAllocator()).Accept(writer);
+    }
+    return std::string{buffer.GetString(), buffer.GetSize()};
+  };
+  CORRADE_COMPARE(write(keyframe, true), write(keyframe, false));
+
+  // empty keyframes and lights changing to none
+  keyframe = {};
+  CORRADE_COMPARE(write(keyframe, true), "{}");
+  keyframe.lightsChanged = true;
+  CORRADE_COMPARE(write(keyframe, true), write(keyframe, false));
+}
+
 namespace {
 // some test structs for JsonUserTypeTest below
 struct MyNestedStruct {
@@ -19,12 +19,15 @@ struct Mp3dTest : Cr::TestSuite::Tester {
   explicit Mp3dTest();
 
   void testLoad();
+  void testLoadHouses();
+  void testLoadHM3DHouse();
 
   esp::logging::LoggingContext loggingContext;
 };  // struct Mp3Test
 
 Mp3dTest::Mp3dTest() {
-  addTests({&Mp3dTest::testLoad});
+  addTests({&Mp3dTest::testLoad, &Mp3dTest::testLoadHouses,
+            &Mp3dTest::testLoadHM3DHouse});
 }  // Mp3dTest ctor
 
 void Mp3dTest::testLoad() {
@@ -73,6 +76,69 @@ void Mp3dTest::testLoad() {
   }      // per level
 }
 
+void Mp3dTest::testLoadHouses() {
+  const std::string filename = Cr::Utility::Path::join(
+      SCENE_DATASETS, "mp3d/17DRP5sb8fy/17DRP5sb8fy.house");
+  if (!Cr::Utility::Path::exists(filename)) {
+    CORRADE_SKIP("MP3D dataset not found.");
+  }
+  esp::scene::SemanticScene expected;
+  CORRADE_VERIFY(esp::scene::SemanticScene::loadMp3dHouse(filename, expected));
+
+  // the same house loaded in parallel, files that fail to load give nullptr
+  const std::vector<std::string> filenames{filename, "nonexistent.house",
+                                           filename};
+  const auto houses = esp::scene::SemanticScene::loadHouses(filenames, 2);
+  CORRADE_COMPARE(houses.size(), 3);
+  CORRADE_VERIFY(!houses[1]);
+  for (std::size_t i : {0, 2}) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(houses[i]);
+    const esp::scene::SemanticScene& house = *houses[i];
+    CORRADE_COMPARE(house.categories().size(), expected.categories().size());
+    CORRADE_COMPARE(house.levels().size(), expected.levels().size());
+    CORRADE_COMPARE(house.regions().size(), expected.regions().size());
+    CORRADE_COMPARE(house.objects().size(), expected.objects().size());
+    CORRADE_COMPARE(house.getSemanticIndexMap().size(),
+                    expected.getSemanticIndexMap().size());
+    CORRADE_COMPARE(Mn::Range3D{house.aabb()}, Mn::Range3D{expected.aabb()});
+  }
+}
+
+void Mp3dTest::testLoadHM3DHouse() {
+  namespace Path = Cr::Utility::Path;
+  const std::string dir =
+      Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, "hm3d_house_test");
+  CORRADE_VERIFY(Path::make(dir));
+  const std::string filename = Path::join(dir, "test.semantic.txt");
+  // category names may contain commas, line endings may be Windows ones
+  CORRADE_VERIFY(Path::writeString(filename,
+                                   "HM3D Semantic Annotations\n"
+                                   "1,FF0000,\"chair\",0\n"
+                                   "2,00FF00,\"table, small\",1\r\n"
+                                   "\n"
+                                   "3,0000FF,\"chair\",1"));
+
+  esp::scene::SemanticScene house;
+  CORRADE_VERIFY(esp::scene::SemanticScene::loadHM3DHouse(filename, house));
+  // the unknown object and three annotated ones
+  CORRADE_COMPARE(house.objects().size(), 4);
+  // the regions of the unknown object and the two annotated ones
+  CORRADE_COMPARE(house.regions().size(), 3);
+  CORRADE_COMPARE(house.categories().size(), 3);
+  const auto& object = *house.objects()[2];
+  CORRADE_COMPARE(object.semanticID(), 2);
+  CORRADE_COMPARE(object.category()->name(), "table, small");
+  CORRADE_COMPARE(object.getColor(), (Mn::Vector3ub{0, 255, 0}));
+  CORRADE_COMPARE(object.region()->getIndex(), 1);
+
+  // loadHouses() picks the format from the header
+  const auto houses = esp::scene::SemanticScene::loadHouses({filename});
+  CORRADE_COMPARE(houses.size(), 1);
+  CORRADE_VERIFY(houses[0]);
+  CORRADE_COMPARE(houses[0]->objects().size(), 4);
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(Mp3dTest)
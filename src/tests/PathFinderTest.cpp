@@ -2,7 +2,10 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 
@@ -14,6 +17,10 @@
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector3.h>
 
+#include <cmath>
+#include <functional>
+#include <thread>
+
 #include "configure.h"
 
 namespace Cr = Corrade;
@@ -28,8 +35,11 @@ const std::string skokloster =
 constexpr struct {
   const char* name;
   bool cache;
-} MultiGoalBenchMarkData[]{{"path to closest of 1000", false},
-                           {"cached path to closest of 1000", true}};
+  bool multiTarget;
+} MultiGoalBenchMarkData[]{
+    {"path to closest of 1000", false, false},
+    {"cached path to closest of 1000", true, false},
+    {"multi-target search to closest of 1000", false, true}};
 
 struct PathFinderTest : Cr::TestSuite::Tester {
   explicit PathFinderTest();
@@ -37,8 +47,21 @@ struct PathFinderTest : Cr::TestSuite::Tester {
   void bounds();
   void tryStepNoSliding();
   void multiGoalPath();
+  void batchedPaths();
+  void distanceOracle();
+  void goalDistanceField();
+  void multiTargetSearch();
+  void mappedLoad();
+  void persistedIslands();
+  void batchedPointQueries();
+  void topDownViewRasterized();
+  void batchedRandomPoints();
+  void concurrentQueries();
+  void batchedSteps();
+  void obstacleDistanceField();
 
   void benchmarkSingleGoal();
+  void benchmarkBatchedPaths();
   void benchmarkMultiGoal();
 
   void testCaching();
@@ -50,10 +73,20 @@ struct PathFinderTest : Cr::TestSuite::Tester {
 
 PathFinderTest::PathFinderTest() {
   addTests({&PathFinderTest::bounds, &PathFinderTest::tryStepNoSliding,
-            &PathFinderTest::multiGoalPath, &PathFinderTest::testCaching,
+            &PathFinderTest::multiGoalPath, &PathFinderTest::batchedPaths,
+            &PathFinderTest::distanceOracle, &PathFinderTest::goalDistanceField,
+            &PathFinderTest::multiTargetSearch, &PathFinderTest::mappedLoad,
+            &PathFinderTest::persistedIslands,
+            &PathFinderTest::batchedPointQueries,
+            &PathFinderTest::topDownViewRasterized,
+            &PathFinderTest::batchedRandomPoints,
+            &PathFinderTest::concurrentQueries, &PathFinderTest::batchedSteps,
+            &PathFinderTest::obstacleDistanceField,
+            &PathFinderTest::testCaching,
             &PathFinderTest::navMeshSettingsTestJSON});
 
   addBenchmarks({&PathFinderTest::benchmarkSingleGoal}, 1000);
+  addBenchmarks({&PathFinderTest::benchmarkBatchedPaths}, 10);
   addInstancedBenchmarks({&PathFinderTest::benchmarkMultiGoal}, 100,
                          Cr::Containers::arraySize(MultiGoalBenchMarkData));
 }
@@ -135,6 +168,566 @@ void PathFinderTest::multiGoalPath() {
   }
 }
 
+void PathFinderTest::batchedPaths() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::nav::ShortestPath> paths(500);
+  std::vector<esp::vec3f> starts, ends;
+  for (auto& path : paths) {
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+    starts.push_back(path.requestedStart);
+    ends.push_back(path.requestedEnd);
+  }
+
+  const int numFound = pathFinder.findPaths(paths, 4);
+  const std::vector<float> distances =
+      pathFinder.getGeodesicDistances(starts, ends, 4);
+  CORRADE_COMPARE(distances.size(), paths.size());
+
+  // results must match the serial queries exactly
+  int expectedFound = 0;
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    CORRADE_ITERATION(i);
+    esp::nav::ShortestPath serialPath;
+    serialPath.requestedStart = starts[i];
+    serialPath.requestedEnd = ends[i];
+    if (pathFinder.findPath(serialPath)) {
+      ++expectedFound;
+    }
+    CORRADE_COMPARE(paths[i].geodesicDistance, serialPath.geodesicDistance);
+    CORRADE_COMPARE(paths[i].points.size(), serialPath.points.size());
+    CORRADE_COMPARE(distances[i], serialPath.geodesicDistance);
+  }
+  CORRADE_COMPARE(numFound, expectedFound);
+}
+
+void PathFinderTest::distanceOracle() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  // a small budget forces landmark mode, a large one all-pairs
+  for (const std::size_t budget :
+       {std::size_t{1} << 16, std::size_t{1} << 30}) {
+    CORRADE_ITERATION(budget);
+    CORRADE_VERIFY(pathFinder.buildDistanceOracle(budget));
+    CORRADE_VERIFY(pathFinder.hasDistanceOracle());
+
+    for (int i = 0; i < 100; ++i) {
+      esp::nav::ShortestPath path;
+      path.requestedStart = pathFinder.getRandomNavigablePoint();
+      path.requestedEnd = pathFinder.getRandomNavigablePoint();
+      const bool found = pathFinder.findPath(path);
+
+      const std::pair<float, float> bounds = pathFinder.getOracleDistanceBounds(
+          path.requestedStart, path.requestedEnd);
+      if (!found) {
+        CORRADE_VERIFY(std::isinf(bounds.first));
+        continue;
+      }
+      // the portal-midpoint paths are never shorter than the exact path
+      CORRADE_COMPARE_AS(bounds.second, path.geodesicDistance - 1e-3f,
+                         Cr::TestSuite::Compare::GreaterOrEqual);
+      CORRADE_COMPARE_AS(bounds.first, bounds.second + 1e-3f,
+                         Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+
+  // round trip through a file
+  const std::string oraclePath =
+      Cr::Utility::Path::join(TEST_ASSETS, "test_distance_oracle.oracle");
+  CORRADE_VERIFY(pathFinder.saveDistanceOracle(oraclePath));
+  const esp::vec3f a = pathFinder.getRandomNavigablePoint();
+  const esp::vec3f b = pathFinder.getRandomNavigablePoint();
+  const float expected = pathFinder.getOracleDistance(a, b);
+
+  esp::nav::PathFinder reloaded;
+  reloaded.loadNavMesh(skokloster);
+  CORRADE_VERIFY(!reloaded.hasDistanceOracle());
+  CORRADE_VERIFY(reloaded.loadDistanceOracle(oraclePath));
+  CORRADE_COMPARE(reloaded.getOracleDistance(a, b), expected);
+
+  // an oracle with the right polygon count but for a different NavMesh is
+  // rejected, simulated by changing the stored NavMesh checksum
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(oraclePath);
+  CORRADE_VERIFY(data);
+  // after magic, version, numPolys, numLandmarks, allPairs and reserved
+  (*data)[6 * sizeof(int)] ^= 1;
+  CORRADE_VERIFY(Cr::Utility::Path::write(oraclePath, *data));
+  esp::nav::PathFinder mismatched;
+  mismatched.loadNavMesh(skokloster);
+  CORRADE_VERIFY(!mismatched.loadDistanceOracle(oraclePath));
+  CORRADE_VERIFY(!mismatched.hasDistanceOracle());
+  Cr::Utility::Path::remove(oraclePath);
+}
+
+void PathFinderTest::goalDistanceField() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  esp::nav::MultiGoalShortestPath goals;
+  std::vector<esp::vec3f> rqEnds;
+  for (int i = 0; i < 10; ++i) {
+    rqEnds.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+  goals.setRequestedEnds(rqEnds);
+  CORRADE_VERIFY(pathFinder.buildGoalDistanceField(goals));
+
+  for (int i = 0; i < 200; ++i) {
+    CORRADE_ITERATION(i);
+    goals.requestedStart = pathFinder.getRandomNavigablePoint();
+    const bool found = pathFinder.findPath(goals);
+    const float fieldDistance =
+        pathFinder.getGoalDistance(goals, goals.requestedStart);
+    if (!found) {
+      CORRADE_VERIFY(std::isinf(fieldDistance));
+      continue;
+    }
+    // the field follows portal midpoints, so it never undercuts the exact
+    // path but should stay close to it
+    CORRADE_COMPARE_AS(fieldDistance, goals.geodesicDistance - 1e-3f,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(fieldDistance, goals.geodesicDistance * 1.5f + 1.0f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+
+  // the field is valid only for the NavMesh it was built on, even if
+  // another PathFinder loads the same NavMesh
+  {
+    esp::nav::PathFinder other;
+    other.loadNavMesh(skokloster);
+    CORRADE_VERIFY(std::isinf(other.getGoalDistance(goals, rqEnds[1])));
+  }
+  // and reloading the NavMesh in the same PathFinder invalidates it too
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(std::isinf(pathFinder.getGoalDistance(goals, rqEnds[1])));
+  CORRADE_VERIFY(pathFinder.buildGoalDistanceField(goals));
+  CORRADE_VERIFY(!std::isinf(pathFinder.getGoalDistance(goals, rqEnds[0])));
+
+  // changing the goals invalidates the field
+  goals.setRequestedEnds({rqEnds[0]});
+  CORRADE_VERIFY(std::isinf(pathFinder.getGoalDistance(goals, rqEnds[1])));
+}
+
+void PathFinderTest::multiTargetSearch() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  for (int i = 0; i < 200; ++i) {
+    CORRADE_ITERATION(i);
+    std::vector<esp::vec3f> rqEnds;
+    for (int j = 0; j < 50; ++j) {
+      rqEnds.emplace_back(pathFinder.getRandomNavigablePoint());
+    }
+
+    esp::nav::MultiGoalShortestPath exhaustive;
+    exhaustive.requestedStart = pathFinder.getRandomNavigablePoint();
+    exhaustive.setRequestedEnds(rqEnds);
+    const bool found = pathFinder.findPath(exhaustive);
+
+    esp::nav::MultiGoalShortestPath multiTarget;
+    multiTarget.requestedStart = exhaustive.requestedStart;
+    multiTarget.setRequestedEnds(rqEnds);
+    multiTarget.useMultiTargetSearch = true;
+    CORRADE_COMPARE(pathFinder.findPath(multiTarget), found);
+    if (!found)
+      continue;
+
+    CORRADE_VERIFY(multiTarget.closestEndPointIndex >= 0);
+    CORRADE_VERIFY(!multiTarget.points.empty());
+    // can never beat the exhaustive search
+    CORRADE_COMPARE_AS(multiTarget.geodesicDistance,
+                       exhaustive.geodesicDistance - 1e-3f,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+
+    // and the reported path ends at the reported end point
+    CORRADE_COMPARE_AS(
+        (multiTarget.points.back() - rqEnds[multiTarget.closestEndPointIndex])
+            .norm(),
+        1e-2f, Cr::TestSuite::Compare::Less);
+  }
+}
+
+void PathFinderTest::mappedLoad() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  esp::nav::PathFinder mappedPathFinder;
+  CORRADE_VERIFY(mappedPathFinder.loadNavMeshMapped(skokloster));
+  CORRADE_VERIFY(mappedPathFinder.isLoaded());
+  CORRADE_COMPARE(Mn::Vector3{mappedPathFinder.bounds().first},
+                  Mn::Vector3{pathFinder.bounds().first});
+  CORRADE_COMPARE(Mn::Vector3{mappedPathFinder.bounds().second},
+                  Mn::Vector3{pathFinder.bounds().second});
+  CORRADE_COMPARE(mappedPathFinder.numIslands(), pathFinder.numIslands());
+  CORRADE_COMPARE(mappedPathFinder.getNavigableArea(),
+                  pathFinder.getNavigableArea());
+  CORRADE_VERIFY(mappedPathFinder.getNavMeshSettings() ==
+                 pathFinder.getNavMeshSettings());
+
+  pathFinder.seed(0);
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    esp::nav::ShortestPath path;
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+    esp::nav::ShortestPath mappedPath = path;
+    pathFinder.findPath(path);
+    mappedPathFinder.findPath(mappedPath);
+    CORRADE_COMPARE(mappedPath.geodesicDistance, path.geodesicDistance);
+  }
+
+  // replacing the mapped navmesh releases the mapping
+  CORRADE_VERIFY(mappedPathFinder.loadNavMesh(skokloster));
+  CORRADE_COMPARE(mappedPathFinder.numIslands(), pathFinder.numIslands());
+  CORRADE_VERIFY(!mappedPathFinder.loadNavMeshMapped("nonexistent.navmesh"));
+}
+
+void PathFinderTest::persistedIslands() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  const std::string navmeshFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "islands_test.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(navmeshFile));
+
+  esp::nav::PathFinder reloaded;
+  CORRADE_VERIFY(reloaded.loadNavMesh(navmeshFile));
+  esp::nav::PathFinder mapped;
+  CORRADE_VERIFY(mapped.loadNavMeshMapped(navmeshFile));
+  Cr::Utility::Path::remove(navmeshFile);
+
+  const std::vector<esp::nav::IslandStatistics> stats =
+      pathFinder.islandStatistics();
+  CORRADE_COMPARE(stats.size(), pathFinder.numIslands());
+  for (int i = 0; i < pathFinder.numIslands(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(stats[i].area, pathFinder.getNavigableArea(i));
+    CORRADE_COMPARE(stats[i].radius, pathFinder.islandRadius(i));
+    CORRADE_VERIFY(stats[i].numPolys > 0);
+    CORRADE_VERIFY((stats[i].boundsMin.array() <= stats[i].centroid.array() &&
+                    stats[i].centroid.array() <= stats[i].boundsMax.array())
+                       .all());
+  }
+
+  for (esp::nav::PathFinder* loaded : {&reloaded, &mapped}) {
+    CORRADE_COMPARE(loaded->numIslands(), pathFinder.numIslands());
+    CORRADE_COMPARE(loaded->getNavigableArea(), pathFinder.getNavigableArea());
+    const std::vector<esp::nav::IslandStatistics> loadedStats =
+        loaded->islandStatistics();
+    for (int i = 0; i < pathFinder.numIslands(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(loaded->getNavigableArea(i),
+                      pathFinder.getNavigableArea(i));
+      CORRADE_COMPARE(loaded->islandRadius(i), pathFinder.islandRadius(i));
+      CORRADE_COMPARE(loadedStats[i].numPolys, stats[i].numPolys);
+      CORRADE_COMPARE(Mn::Vector3{loadedStats[i].centroid},
+                      Mn::Vector3{stats[i].centroid});
+      CORRADE_COMPARE(Mn::Vector3{loadedStats[i].boundsMin},
+                      Mn::Vector3{stats[i].boundsMin});
+      CORRADE_COMPARE(Mn::Vector3{loadedStats[i].boundsMax},
+                      Mn::Vector3{stats[i].boundsMax});
+    }
+
+    pathFinder.seed(0);
+    for (int i = 0; i < 100; ++i) {
+      CORRADE_ITERATION(i);
+      const esp::vec3f pt = pathFinder.getRandomNavigablePoint();
+      CORRADE_COMPARE(loaded->getIsland(pt), pathFinder.getIsland(pt));
+    }
+  }
+}
+
+void PathFinderTest::batchedPointQueries() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < 500; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint() +
+                        esp::vec3f::Random());
+  }
+
+  std::vector<esp::vec3f> snapped(points.size());
+  std::vector<esp::vec3f> islandSnapped(points.size());
+  std::vector<int> islands(points.size());
+  Cr::Containers::Array<bool> navigable{points.size()};
+  pathFinder.snapPoints(points, snapped, esp::ID_UNDEFINED, 4);
+  pathFinder.snapPoints(points, islandSnapped, 0, 4);
+  pathFinder.getIslands(points, islands, 4);
+  pathFinder.areNavigable(points, navigable, 0.5, 4);
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    // failed snaps are NaN in both
+    const esp::vec3f single = pathFinder.snapPoint(points[i]);
+    const esp::vec3f islandSingle = pathFinder.snapPoint(points[i], 0);
+    CORRADE_COMPARE(std::isnan(snapped[i][0]), std::isnan(single[0]));
+    if (!std::isnan(single[0])) {
+      CORRADE_COMPARE(Mn::Vector3{snapped[i]}, Mn::Vector3{single});
+    }
+    CORRADE_COMPARE(std::isnan(islandSnapped[i][0]),
+                    std::isnan(islandSingle[0]));
+    if (!std::isnan(islandSingle[0])) {
+      CORRADE_COMPARE(Mn::Vector3{islandSnapped[i]},
+                      Mn::Vector3{islandSingle});
+    }
+    CORRADE_COMPARE(islands[i], pathFinder.getIsland(points[i]));
+    CORRADE_COMPARE(navigable[i], pathFinder.isNavigable(points[i]));
+  }
+}
+
+void PathFinderTest::topDownViewRasterized() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  const float height = pathFinder.bounds().first[1];
+
+  // threaded sampling is exactly the same as sampling on a single thread
+  const auto sampled = pathFinder.getTopDownView(0.1, height, 0.5, false, 1);
+  const auto sampledThreaded =
+      pathFinder.getTopDownView(0.1, height, 0.5, false, 4);
+  CORRADE_VERIFY(sampled == sampledThreaded);
+
+  // rasterizing only differs at polygon boundaries
+  const auto rasterized = pathFinder.getTopDownView(0.1, height, 0.5, true, 4);
+  CORRADE_COMPARE(rasterized.rows(), sampled.rows());
+  CORRADE_COMPARE(rasterized.cols(), sampled.cols());
+  CORRADE_VERIFY(sampled.count() > 0);
+  const int mismatches = (rasterized.array() != sampled.array()).count();
+  CORRADE_COMPARE_AS(mismatches, int(sampled.size() / 200),
+                     Cr::TestSuite::Compare::LessOrEqual);
+
+  const auto islands = pathFinder.getTopDownIslandView(0.1, height, 0.5, false);
+  const auto rasterizedIslands =
+      pathFinder.getTopDownIslandView(0.1, height, 0.5, true);
+  const int islandMismatches =
+      (rasterizedIslands.array() != islands.array()).count();
+  CORRADE_COMPARE_AS(islandMismatches, int(islands.size() / 200),
+                     Cr::TestSuite::Compare::LessOrEqual);
+}
+
+void PathFinderTest::batchedRandomPoints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  // reproducible for a seed regardless of the thread count
+  const std::vector<esp::vec3f> points =
+      pathFinder.getRandomNavigablePoints(5000, esp::ID_UNDEFINED, 7u, 1);
+  const std::vector<esp::vec3f> threadedPoints =
+      pathFinder.getRandomNavigablePoints(5000, esp::ID_UNDEFINED, 7u, 4);
+  CORRADE_COMPARE(points.size(), std::size_t{5000});
+  CORRADE_VERIFY(points == threadedPoints);
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(
+                     5000, esp::ID_UNDEFINED, 8u) != points);
+
+  // area weighted: islands are hit in proportion to their area
+  std::vector<int> islands(points.size());
+  pathFinder.getIslands(points, islands);
+  int numOnLargest = 0;
+  int largest = 0;
+  for (int i = 0; i < pathFinder.numIslands(); ++i) {
+    if (pathFinder.getNavigableArea(i) > pathFinder.getNavigableArea(largest))
+      largest = i;
+  }
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(pathFinder.isNavigable(points[i]));
+    numOnLargest += islands[i] == largest;
+  }
+  const float expectedFraction =
+      pathFinder.getNavigableArea(largest) / pathFinder.getNavigableArea();
+  CORRADE_COMPARE_WITH(float(numOnLargest) / points.size(), expectedFraction,
+                       Cr::TestSuite::Compare::around(0.03f));
+
+  // island restricted
+  for (const esp::vec3f& pt :
+       pathFinder.getRandomNavigablePoints(500, largest, 3u)) {
+    CORRADE_COMPARE(pathFinder.getIsland(pt), largest);
+  }
+
+  // around a sphere
+  const esp::vec3f center = points.front();
+  for (const esp::vec3f& pt : pathFinder.getRandomNavigablePointsAroundSphere(
+           center, 1.5f, 500, 100, esp::ID_UNDEFINED, 3u)) {
+    CORRADE_VERIFY(!std::isnan(pt[0]));
+    CORRADE_COMPARE_AS((pt - center).norm(), 1.5f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+    CORRADE_VERIFY(pathFinder.isNavigable(pt));
+  }
+}
+
+void PathFinderTest::concurrentQueries() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  struct Result {
+    float geodesicDistance;
+    esp::vec3f stepped;
+    esp::vec3f snapped;
+    float obstacleDistance;
+  };
+  std::vector<std::pair<esp::vec3f, esp::vec3f>> queries;
+  for (int i = 0; i < 200; ++i) {
+    queries.emplace_back(pathFinder.getRandomNavigablePoint(),
+                         pathFinder.getRandomNavigablePoint());
+  }
+  auto run = [&](std::vector<Result>& results) {
+    results.resize(queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+      esp::nav::ShortestPath path;
+      path.requestedStart = queries[i].first;
+      path.requestedEnd = queries[i].second;
+      pathFinder.findPath(path);
+      const esp::vec3f stepTarget =
+          queries[i].first +
+          0.25f * (queries[i].second - queries[i].first).normalized();
+      results[i] = {path.geodesicDistance,
+                    pathFinder.tryStep(queries[i].first, stepTarget),
+                    pathFinder.snapPoint(queries[i].second, 0),
+                    pathFinder.distanceToClosestObstacle(queries[i].first)};
+    }
+  };
+
+  std::vector<Result> expected;
+  run(expected);
+
+  // the CORRADE_ macros aren't thread safe, compare after joining
+  std::vector<std::vector<Result>> threadResults(4);
+  std::vector<std::thread> threads;
+  for (auto& results : threadResults) {
+    threads.emplace_back(run, std::ref(results));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& results : threadResults) {
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(results[i].geodesicDistance,
+                      expected[i].geodesicDistance);
+      CORRADE_COMPARE(Mn::Vector3{results[i].stepped},
+                      Mn::Vector3{expected[i].stepped});
+      CORRADE_COMPARE(std::isnan(results[i].snapped[0]),
+                      std::isnan(expected[i].snapped[0]));
+      if (!std::isnan(expected[i].snapped[0])) {
+        CORRADE_COMPARE(Mn::Vector3{results[i].snapped},
+                        Mn::Vector3{expected[i].snapped});
+      }
+      CORRADE_COMPARE(results[i].obstacleDistance,
+                      expected[i].obstacleDistance);
+    }
+  }
+}
+
+void PathFinderTest::batchedSteps() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> starts, headings;
+  for (int i = 0; i < 200; ++i) {
+    starts.push_back(pathFinder.getRandomNavigablePoint());
+    esp::vec3f heading = esp::vec3f::Random();
+    heading[1] = 0;
+    headings.push_back(0.25f * heading.normalized());
+  }
+
+  // walk every agent a few steps, reusing the polys of the previous step
+  std::vector<esp::vec3f> positions = starts;
+  std::vector<esp::vec3f> cachedPositions = starts;
+  std::vector<esp::vec3f> ends(starts.size());
+  std::vector<esp::vec3f> stepped(starts.size());
+  std::vector<uint64_t> polyRefs(starts.size(), 0);
+  for (int step = 0; step < 10; ++step) {
+    CORRADE_ITERATION(step);
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      ends[i] = positions[i] + headings[i];
+    }
+    pathFinder.trySteps(positions, ends, stepped, nullptr, true, 4);
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      CORRADE_COMPARE(Mn::Vector3{stepped[i]},
+                      Mn::Vector3{pathFinder.tryStep(positions[i], ends[i])});
+    }
+    positions = stepped;
+
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      ends[i] = cachedPositions[i] + headings[i];
+    }
+    pathFinder.trySteps(cachedPositions, ends, stepped, polyRefs, true, 4);
+    cachedPositions = stepped;
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      CORRADE_VERIFY(polyRefs[i] != 0);
+    }
+  }
+
+  // a known start poly may only differ from searching it on poly boundaries
+  for (std::size_t i = 0; i < starts.size(); ++i) {
+    CORRADE_COMPARE_AS((positions[i] - cachedPositions[i]).norm(), 1.0e-3f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+}
+
+void PathFinderTest::obstacleDistanceField() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> points;
+  std::vector<float> expected;
+  for (int i = 0; i < 200; ++i) {
+    points.push_back(pathFinder.getRandomNavigablePoint());
+    expected.push_back(pathFinder.distanceToClosestObstacle(points.back()));
+  }
+
+  constexpr float cellSize = 0.1f;
+  CORRADE_VERIFY(pathFinder.setObstacleDistanceField(cellSize, 2.0f, 4));
+  CORRADE_VERIFY(pathFinder.hasObstacleDistanceField());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    // the distance changes by at most the distance between the grid points
+    const float distance = pathFinder.distanceToClosestObstacle(points[i]);
+    CORRADE_COMPARE_AS(std::abs(distance - expected[i]), cellSize,
+                       Cr::TestSuite::Compare::LessOrEqual);
+    // a smaller radius clamps, a larger one searches past the field
+    CORRADE_COMPARE_AS(pathFinder.distanceToClosestObstacle(points[i], 0.5f),
+                       0.5f, Cr::TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(
+        std::abs(pathFinder.distanceToClosestObstacle(points[i], 4.0f) -
+                 pathFinder.closestObstacleSurfacePoint(points[i], 4.0f)
+                     .hitDist),
+        cellSize, Cr::TestSuite::Compare::LessOrEqual);
+  }
+
+  // rebuilt for every NavMesh until disabled
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.hasObstacleDistanceField());
+  CORRADE_VERIFY(!pathFinder.setObstacleDistanceField(0.0f));
+  CORRADE_VERIFY(!pathFinder.hasObstacleDistanceField());
+  CORRADE_COMPARE(pathFinder.distanceToClosestObstacle(points[0]),
+                  expected[0]);
+}
+
 void PathFinderTest::testCaching() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
@@ -182,6 +775,24 @@ void PathFinderTest::benchmarkSingleGoal() {
   CORRADE_VERIFY(status);
 }
 
+void PathFinderTest::benchmarkBatchedPaths() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < 1000; ++i) {
+    starts.emplace_back(pathFinder.getRandomNavigablePoint());
+    ends.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  std::vector<float> distances;
+  CORRADE_BENCHMARK(1) {
+    distances = pathFinder.getGeodesicDistances(starts, ends);
+  };
+  CORRADE_COMPARE(distances.size(), starts.size());
+}
+
 void PathFinderTest::benchmarkMultiGoal() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
@@ -201,6 +812,7 @@ void PathFinderTest::benchmarkMultiGoal() {
     rqEnds.emplace_back(pathFinder.getRandomNavigablePoint());
   }
   path.setRequestedEnds(rqEnds);
+  path.useMultiTargetSearch = data.multiTarget;
 
   if (data.cache) {
     pathFinder.findPath(path);
@@ -2,9 +2,12 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/Math/FunctionsBatch.h>
 #include <string>
 
 #include "esp/sim/Simulator.h"
@@ -16,6 +19,7 @@
 #include "esp/physics/PhysicsManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #ifdef ESP_BUILD_WITH_BULLET
+#include "esp/physics/bullet/BulletConvexHullCache.h"
 #include "esp/physics/bullet/BulletPhysicsManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #endif
@@ -144,11 +148,19 @@ struct PhysicsTest : Cr::TestSuite::Tester {
   void testCollisionBoundingBox();
   void testDiscreteContactTest();
   void testBulletCompoundShapeMargins();
+  void testSharedCollisionShapes();
+  void testConvexHullCache();
+  void testStageBvhCache();
+  void testEvictedAssetReload();
   void testConfigurableScaling();
   void testVelocityControl();
+  void testBatchedObjectState();
+  void testAddObjectInstances();
+  void testSubstepCap();
   void testSceneNodeAttachment();
   void testMotionTypes();
   void testNumActiveContactPoints();
+  void testDeferredNodeUpdates();
   void testRemoveSleepingSupport();
   /////
 
@@ -180,12 +192,20 @@ PhysicsTest::PhysicsTest() {
           &PhysicsTest::testCollisionBoundingBox,
           &PhysicsTest::testDiscreteContactTest,
           &PhysicsTest::testBulletCompoundShapeMargins,
+          &PhysicsTest::testSharedCollisionShapes,
+          &PhysicsTest::testConvexHullCache,
+          &PhysicsTest::testStageBvhCache,
+          &PhysicsTest::testEvictedAssetReload,
           &PhysicsTest::testMotionTypes,
           &PhysicsTest::testRemoveSleepingSupport,
           &PhysicsTest::testNumActiveContactPoints,
+          &PhysicsTest::testDeferredNodeUpdates,
 #endif
           &PhysicsTest::testConfigurableScaling,
           &PhysicsTest::testVelocityControl,
+          &PhysicsTest::testBatchedObjectState,
+          &PhysicsTest::testAddObjectInstances,
+          &PhysicsTest::testSubstepCap,
           &PhysicsTest::testSceneNodeAttachment},
       Cr::Containers::arraySize(RendererEnabledData));
 }
@@ -492,6 +512,268 @@ void PhysicsTest::testBulletCompoundShapeMargins() {
   }
 }  // PhysicsTest::testBulletCompoundShapeMargins
 
+void PhysicsTest::testSharedCollisionShapes() {
+  // test that instances of the same collision asset at the same scale share
+  // convex shapes, and that modifying one instance doesn't affect the others
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+  initStage(objectFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    ObjectAttributes::ptr ObjectAttributes = ObjectAttributes::create();
+    ObjectAttributes->setRenderAssetHandle(objectFile);
+    ObjectAttributes->setMargin(0.0);
+
+    auto objectAttributesManager =
+        metadataMediator_->getObjectAttributesManager();
+    objectAttributesManager->registerObject(ObjectAttributes, objectFile);
+
+    ObjectAttributes::ptr objectTemplate =
+        objectAttributesManager->getObjectCopyByHandle(objectFile);
+
+    auto* drawables = &sceneManager_->getSceneGraph(sceneID_).getDrawables();
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 0);
+
+    const Magnum::Range3D groundTruth({-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0});
+    auto objectWrapper0 = makeObjectGetWrapper(objectFile, drawables);
+    auto objectWrapper1 = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(objectWrapper0);
+    CORRADE_VERIFY(objectWrapper1);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 1);
+    CORRADE_COMPARE(objectWrapper0->getCollisionShapeAabb(), groundTruth);
+    CORRADE_COMPARE(objectWrapper1->getCollisionShapeAabb(), groundTruth);
+
+    // changing the margin of one instance doesn't leak into the shared
+    // shapes used by new instances
+    objectWrapper0->setMargin(0.5);
+    auto objectWrapper2 = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(objectWrapper2);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 1);
+    CORRADE_COMPARE(objectWrapper2->getCollisionShapeAabb(), groundTruth);
+
+    // a different scale needs different shapes
+    objectTemplate->setScale({2.0, 2.0, 2.0});
+    objectAttributesManager->registerObject(objectTemplate);
+    auto objectWrapper3 = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(objectWrapper3);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 2);
+    CORRADE_COMPARE(objectWrapper3->getCollisionShapeAabb(),
+                    Magnum::Range3D({-2.0, -2.0, -2.0}, {2.0, 2.0, 2.0}));
+  }
+}  // PhysicsTest::testSharedCollisionShapes
+
+void PhysicsTest::testConvexHullCache() {
+  // test that hulls computed offline are used in place of the collision mesh
+  // if present next to the asset and not out of date
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+  std::string cachedObjectFile =
+      Cr::Utility::Path::join(dataDir, "hull_cache_test_box.glb");
+  std::string cacheFile =
+      esp::physics::convexHullCacheFilename(cachedObjectFile);
+  CORRADE_VERIFY(Cr::Utility::Path::copy(objectFile, cachedObjectFile));
+
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+  initStage(objectFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    auto objectAttributesManager =
+        metadataMediator_->getObjectAttributesManager();
+    auto* drawables = &sceneManager_->getSceneGraph(sceneID_).getDrawables();
+
+    // hulls computed from the loaded collision mesh match its bounds
+    auto objectWrapper = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(objectWrapper);
+    const esp::physics::ConvexHullCacheData computed =
+        esp::physics::computeConvexHulls(
+            resourceManager_->getCollisionMesh(objectFile),
+            resourceManager_->getMeshMetaData(objectFile).root);
+    CORRADE_VERIFY(!computed.hulls.empty());
+    const std::pair<Magnum::Vector3, Magnum::Vector3> bounds =
+        Magnum::Math::minmax(Cr::Containers::arrayView(
+            computed.joinedHull.data(), computed.joinedHull.size()));
+    CORRADE_COMPARE(bounds.first, Magnum::Vector3{-1.0f});
+    CORRADE_COMPARE(bounds.second, Magnum::Vector3{1.0f});
+
+    // a cache with hulls of half the size, with the hash of the asset file
+    // off by one so it's treated as out of date
+    esp::physics::ConvexHullCacheData data;
+    for (float x : {-0.5f, 0.5f}) {
+      for (float y : {-0.5f, 0.5f}) {
+        for (float z : {-0.5f, 0.5f}) {
+          data.joinedHull.emplace_back(x, y, z);
+        }
+      }
+    }
+    data.hulls.push_back(data.joinedHull);
+    data.sourceHash =
+        *esp::physics::convexHullCacheSourceHash(cachedObjectFile) + 1;
+    CORRADE_VERIFY(esp::physics::writeConvexHullCache(cacheFile, data));
+
+    ObjectAttributes::ptr objectTemplate = ObjectAttributes::create();
+    objectTemplate->setRenderAssetHandle(cachedObjectFile);
+    objectTemplate->setMargin(0.0);
+    objectAttributesManager->registerObject(objectTemplate, cachedObjectFile);
+    objectTemplate =
+        objectAttributesManager->getObjectCopyByHandle(cachedObjectFile);
+
+    auto staleWrapper = makeObjectGetWrapper(cachedObjectFile, drawables);
+    CORRADE_VERIFY(staleWrapper);
+    CORRADE_COMPARE(staleWrapper->getCollisionShapeAabb(),
+                    Magnum::Range3D({-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}));
+
+    // an up-to-date cache is used. Use a different scale so the shapes
+    // created above aren't reused.
+    data.sourceHash -= 1;
+    CORRADE_VERIFY(esp::physics::writeConvexHullCache(cacheFile, data));
+    objectTemplate->setScale({2.0, 2.0, 2.0});
+    objectAttributesManager->registerObject(objectTemplate);
+    auto cachedWrapper = makeObjectGetWrapper(cachedObjectFile, drawables);
+    CORRADE_VERIFY(cachedWrapper);
+    CORRADE_COMPARE(cachedWrapper->getCollisionShapeAabb(),
+                    Magnum::Range3D({-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}));
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cachedObjectFile));
+  if (Cr::Utility::Path::exists(cacheFile)) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFile));
+  }
+}  // PhysicsTest::testConvexHullCache
+
+void PhysicsTest::testStageBvhCache() {
+  // test that stage bvhs are written to the cache directory on the first load
+  // and read back on later ones, and that invalid cache files are ignored
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/simple_room.glb");
+  std::string cacheDir =
+      Cr::Utility::Path::join(dataDir, "stage_bvh_cache_test");
+  CORRADE_VERIFY(Cr::Utility::Path::make(cacheDir));
+  const auto listCache = [&]() {
+    std::vector<std::string> files;
+    for (auto& file : *Cr::Utility::Path::list(
+             cacheDir, Cr::Utility::Path::ListFlag::SkipDirectories |
+                           Cr::Utility::Path::ListFlag::SkipDotAndDotDot)) {
+      files.emplace_back(Cr::Utility::Path::join(cacheDir, file));
+    }
+    return files;
+  };
+
+  Magnum::Range3D builtAabb;
+  esp::physics::RaycastResults builtHits;
+  // built and written, read from the cache, built again from garbage
+  for (int load = 0; load != 3; ++load) {
+    CORRADE_ITERATION(load);
+    resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+    resourceManager_->setCollisionBvhCacheDirectory(cacheDir);
+    initStage(stageFile);
+    if (physicsManager_->getPhysicsSimulationLibrary() !=
+        PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+      break;
+    }
+
+    auto* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    const Magnum::Range3D aabb = bPhysManager->getStageCollisionShapeAabb();
+    esp::physics::RaycastResults hits = physicsManager_->castRay(
+        esp::geo::Ray{aabb.center(), {0.0, -1.0, 0.0}});
+    CORRADE_VERIFY(hits.hasHits());
+    if (load == 0) {
+      builtAabb = aabb;
+      builtHits = hits;
+    } else {
+      CORRADE_COMPARE(aabb, builtAabb);
+      CORRADE_COMPARE(hits.hits.size(), builtHits.hits.size());
+      CORRADE_COMPARE(hits.hits[0].rayDistance, builtHits.hits[0].rayDistance);
+    }
+
+    const std::vector<std::string> cacheFiles = listCache();
+    CORRADE_VERIFY(!cacheFiles.empty());
+    if (load == 1) {
+      for (const std::string& file : cacheFiles) {
+        CORRADE_VERIFY(Cr::Utility::Path::write(
+            file, Cr::Containers::arrayView("not a bvh")));
+      }
+    }
+  }
+
+  for (const std::string& file : listCache()) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(file));
+  }
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheDir));
+}  // PhysicsTest::testStageBvhCache
+
+void PhysicsTest::testEvictedAssetReload() {
+  // test that objects created from an asset reloaded after it got evicted
+  // from the render asset cache use collision shapes built from the reloaded
+  // asset, not ones cached for the evicted one
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/simple_room.glb");
+  std::string boxFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+  std::string sphereFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/sphere.glb");
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "evicted_asset_test.glb");
+  CORRADE_VERIFY(Cr::Utility::Path::copy(boxFile, objectFile));
+
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+  initStage(stageFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    ObjectAttributes::ptr objectAttributes = ObjectAttributes::create();
+    objectAttributes->setRenderAssetHandle(objectFile);
+    objectAttributes->setMargin(0.0);
+    metadataMediator_->getObjectAttributesManager()->registerObject(
+        objectAttributes, objectFile);
+
+    auto* drawables = &sceneManager_->getSceneGraph(sceneID_).getDrawables();
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+
+    auto objectWrapper = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(objectWrapper);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 1);
+    CORRADE_COMPARE(objectWrapper->getCollisionShapeAabb(),
+                    Magnum::Range3D({-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}));
+
+    // once its instances are gone, the object asset is evicted in the next
+    // cache scene, the stage is still in use so it's pinned
+    rigidObjectManager_->removeAllObjects();
+    resourceManager_->setAssetPinned(stageFile, true);
+    resourceManager_->setAssetCacheBudget(1);
+    resourceManager_->beginAssetCacheScene();
+    CORRADE_COMPARE(resourceManager_->evictUnusedAssets(), 1);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 0);
+
+    // the file is reloaded with its new contents for a new object
+    CORRADE_VERIFY(Cr::Utility::Path::copy(sphereFile, objectFile));
+    auto reloadedWrapper = makeObjectGetWrapper(objectFile, drawables);
+    CORRADE_VERIFY(reloadedWrapper);
+    CORRADE_COMPARE(bPhysManager->getCollisionShapeCacheSize(), 1);
+    CORRADE_COMPARE(
+        reloadedWrapper->getCollisionShapeAabb(),
+        Magnum::Range3D({-0.25, -0.25, -0.25}, {0.25, 0.25, 0.25}));
+
+    // and simulates
+    reloadedWrapper->setTranslation({0.0, 2.0, 0.0});
+    physicsManager_->stepPhysics(0.1);
+    CORRADE_VERIFY(reloadedWrapper->getTranslation().y() < 2.0f);
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(objectFile));
+}  // PhysicsTest::testEvictedAssetReload
+
 void PhysicsTest::testMotionTypes() {
   // test setting motion types and expected simulation behaviors
 
@@ -750,6 +1032,19 @@ void PhysicsTest::testNumActiveContactPoints() {
     CORRADE_COMPARE_AS(totalNormalForce - 9.8, 3.0e-4,
                        Cr::TestSuite::Compare::LessOrEqual);
 
+    // the per-object query sees the same contacts from either side
+    const int cubeId = objWrapper0->getID();
+    auto cubeContactPoints = physicsManager_->getObjectContactPoints(cubeId);
+    CORRADE_COMPARE(cubeContactPoints.size(), allContactPoints.size());
+    for (std::size_t i = 0; i != cubeContactPoints.size(); ++i) {
+      CORRADE_COMPARE(cubeContactPoints[i].objectIdA, cubeId);
+      CORRADE_COMPARE(cubeContactPoints[i].positionOnAInWS,
+                      allContactPoints[i].positionOnAInWS);
+    }
+    CORRADE_COMPARE(
+        physicsManager_->getObjectContactPoints(esp::RIGID_STAGE_ID).size(), 4);
+    CORRADE_VERIFY(physicsManager_->getObjectContactPoints(cubeId + 1).empty());
+
     // continue simulation until the cube is stable and sleeping
     while (physicsManager_->getWorldTime() < 4.0) {
       physicsManager_->stepPhysics(0.1);
@@ -759,9 +1054,53 @@ void PhysicsTest::testNumActiveContactPoints() {
     // no active contact points at end
     CORRADE_COMPARE(physicsManager_->getNumActiveContactPoints(), 0);
     CORRADE_COMPARE(physicsManager_->getNumActiveOverlappingPairs(), 0);
+
+    // removing the cube drops its cached contacts
+    CORRADE_COMPARE(physicsManager_->getObjectContactPoints(cubeId).size(), 4);
+    physicsManager_->removeObject(cubeId);
+    CORRADE_VERIFY(physicsManager_->getObjectContactPoints(cubeId).empty());
   }
 }  // PhysicsTest::testNumActiveContactPoints
 
+void PhysicsTest::testDeferredNodeUpdates() {
+  // while deferred, stepping doesn't touch scene nodes and the following
+  // updateNodes() syncs exactly the objects that moved
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+  initStage(stageFile);
+
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  auto falling = makeObjectGetWrapper(objectFile, &drawables);
+  auto removed = makeObjectGetWrapper(objectFile, &drawables);
+  CORRADE_VERIFY(falling);
+  CORRADE_VERIFY(removed);
+  const Magnum::Vector3 start{0.0, 3.0, 0.0};
+  falling->setTranslation(start);
+  removed->setTranslation({3.0, 3.0, 0.0});
+
+  physicsManager_->deferNodesUpdate();
+  for (int i = 0; i < 10; ++i) {
+    physicsManager_->stepPhysics(1.0 / 60.0);
+  }
+  CORRADE_COMPARE(falling->getTranslation(), start);
+  CORRADE_COMPARE(
+      falling->getSceneNode()->absoluteTransformation().translation(), start);
+
+  // a pending update of a removed object is skipped
+  physicsManager_->removeObject(removed->getID());
+  physicsManager_->updateNodes();
+  const Magnum::Vector3 synced = falling->getTranslation();
+  CORRADE_COMPARE_AS(synced.y(), start.y(), Cr::TestSuite::Compare::Less);
+
+  // without deferral the nodes follow every step directly
+  physicsManager_->stepPhysics(1.0 / 60.0);
+  CORRADE_COMPARE_AS(falling->getTranslation().y(), synced.y(),
+                     Cr::TestSuite::Compare::Less);
+}
 #endif
 
 void PhysicsTest::testConfigurableScaling() {
@@ -984,6 +1323,167 @@ void PhysicsTest::testVelocityControl() {
                      Cr::TestSuite::Compare::LessOrEqual);
 }  // PhysicsTest::testVelocityControl
 
+void PhysicsTest::testSubstepCap() {
+  // a step far longer than the substep cap allows only advances the world by
+  // the capped number of substeps and reports the rest as dropped
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+  initStage(stageFile);
+
+  constexpr int maxSubsteps = 10;
+  physicsManager_->setMaxSubsteps(maxSubsteps);
+  CORRADE_COMPARE(physicsManager_->getMaxSubsteps(), maxSubsteps);
+  const double timestep = physicsManager_->getTimestep();
+
+  physicsManager_->stepPhysics(100 * timestep);
+  physicsManager_->updateNodes();
+  const esp::physics::PhysicsStepProfile& profile =
+      physicsManager_->getLastStepProfile();
+  CORRADE_COMPARE_AS(profile.numSubstepsRequested, maxSubsteps,
+                     Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE(profile.numSubstepsTaken, maxSubsteps);
+  CORRADE_COMPARE(profile.numSubstepsDroppedTotal,
+                  profile.numSubstepsRequested - maxSubsteps);
+  CORRADE_COMPARE(physicsManager_->getWorldTime(), maxSubsteps * timestep);
+  CORRADE_COMPARE_AS(profile.stepMs, 0.0,
+                     Cr::TestSuite::Compare::GreaterOrEqual);
+  CORRADE_COMPARE_AS(profile.stepMs,
+                     profile.broadphaseMs + profile.narrowphaseMs +
+                         profile.solverMs,
+                     Cr::TestSuite::Compare::GreaterOrEqual);
+
+  // a step within the cap doesn't drop anything further
+  const int numDropped = profile.numSubstepsDroppedTotal;
+  physicsManager_->stepPhysics(timestep);
+  CORRADE_COMPARE(profile.numSubstepsTaken, 1);
+  CORRADE_COMPARE(profile.numSubstepsDroppedTotal, numDropped);
+  CORRADE_COMPARE(physicsManager_->getWorldTime(),
+                  (maxSubsteps + 1) * timestep);
+}
+
+void PhysicsTest::testBatchedObjectState() {
+  // test getting and setting the state of multiple objects in a single call
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+
+  initStage(stageFile);
+
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+
+  std::vector<int> objectIds;
+  for (int i = 0; i < 3; ++i) {
+    auto objectWrapper = makeObjectGetWrapper(objectFile, &drawables);
+    CORRADE_VERIFY(objectWrapper);
+    objectIds.push_back(objectWrapper->getID());
+  }
+
+  const Magnum::Vector3 translations[]{
+      {1.0, 2.0, 3.0}, {-1.0, 0.5, 0}, {0, 4.0, -2.0}};
+  const Magnum::Quaternion rotations[]{
+      Magnum::Quaternion::rotation(Magnum::Deg(90.0), Magnum::Vector3::yAxis()),
+      Magnum::Quaternion{},
+      Magnum::Quaternion::rotation(Magnum::Deg(45.0),
+                                   Magnum::Vector3::xAxis())};
+  rigidObjectManager_->setTranslations(objectIds, translations);
+  rigidObjectManager_->setRotations(objectIds, rotations);
+
+  // the batched setters act on the same objects as the wrappers do
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    auto objectWrapper = rigidObjectManager_->getObjectCopyByID(objectIds[i]);
+    CORRADE_COMPARE(objectWrapper->getTranslation(), translations[i]);
+    CORRADE_COMPARE(objectWrapper->getRotation(), rotations[i]);
+  }
+
+  // query in a different order than the objects were created in
+  const int reversedIds[]{objectIds[2], objectIds[1], objectIds[0]};
+  Magnum::Vector3 queriedTranslations[3];
+  Magnum::Quaternion queriedRotations[3];
+  rigidObjectManager_->getTranslations(reversedIds, queriedTranslations);
+  rigidObjectManager_->getRotations(reversedIds, queriedRotations);
+  for (std::size_t i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(queriedTranslations[i], translations[2 - i]);
+    CORRADE_COMPARE(queriedRotations[i], rotations[2 - i]);
+  }
+
+  const Magnum::Vector3 linearVelocities[]{
+      {1.0, 0, 0}, {0, 1.0, 0}, {0, 0, 1.0}};
+  const Magnum::Vector3 angularVelocities[]{
+      {0, 0, 1.0}, {1.0, 0, 0}, {0, 1.0, 0}};
+  rigidObjectManager_->setLinearVelocities(objectIds, linearVelocities);
+  rigidObjectManager_->setAngularVelocities(objectIds, angularVelocities);
+  Magnum::Vector3 queriedLinearVelocities[3];
+  Magnum::Vector3 queriedAngularVelocities[3];
+  rigidObjectManager_->getLinearVelocities(objectIds, queriedLinearVelocities);
+  rigidObjectManager_->getAngularVelocities(objectIds,
+                                            queriedAngularVelocities);
+  for (std::size_t i = 0; i != 3; ++i) {
+#ifdef ESP_BUILD_WITH_BULLET
+    if (physicsManager_->getPhysicsSimulationLibrary() ==
+        PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+      CORRADE_COMPARE(queriedLinearVelocities[i], linearVelocities[i]);
+      CORRADE_COMPARE(queriedAngularVelocities[i], angularVelocities[i]);
+      continue;
+    }
+#endif
+    // default kinematics always 0 velocity when queried
+    CORRADE_COMPARE(queriedLinearVelocities[i], Magnum::Vector3{});
+    CORRADE_COMPARE(queriedAngularVelocities[i], Magnum::Vector3{});
+  }
+}  // PhysicsTest::testBatchedObjectState
+
+void PhysicsTest::testAddObjectInstances() {
+  // test instancing several objects from scene instance attributes at once
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+
+  initStage(stageFile);
+
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  const std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+  auto sceneInstanceAttrMgr =
+      metadataMediator_->getSceneInstanceAttributesManager();
+
+  const Magnum::Vector3 translations[]{
+      {1.0, 2.0, 3.0}, {-1.0, 0.5, 0}, {0, 4.0, -2.0}};
+  std::vector<esp::metadata::attributes::SceneObjectInstanceAttributes::cptr>
+      instances;
+  std::vector<std::string> handles;
+  for (int i = 0; i < 3; ++i) {
+    auto instance =
+        sceneInstanceAttrMgr->createEmptyInstanceAttributes(cubeHandle);
+    instance->setTranslation(translations[i]);
+    instance->setUniformScale(i + 1.0);
+    instances.emplace_back(instance);
+    // an unknown template only fails its own instance
+    handles.emplace_back(i == 1 ? "no_such_object" : cubeHandle);
+  }
+
+  std::vector<int> objectIds = physicsManager_->addObjectInstances(
+      instances, handles, false, &drawables);
+  CORRADE_COMPARE(objectIds.size(), 3);
+  CORRADE_COMPARE(objectIds[1], esp::ID_UNDEFINED);
+  CORRADE_COMPARE(physicsManager_->getNumRigidObjects(), 2);
+  for (int i : {0, 2}) {
+    CORRADE_ITERATION(i);
+    auto objectWrapper = rigidObjectManager_->getObjectCopyByID(objectIds[i]);
+    CORRADE_VERIFY(objectWrapper);
+    CORRADE_COMPARE(objectWrapper->getTranslation(), translations[i]);
+    CORRADE_COMPARE(objectWrapper->getInitializationAttributes()->getScale(),
+                    Magnum::Vector3{i + 1.0f});
+  }
+}  // PhysicsTest::testAddObjectInstances
+
 void PhysicsTest::testSceneNodeAttachment() {
   // test attaching/detaching existing SceneNode to/from physical simulation
 
@@ -2,6 +2,12 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 
@@ -9,6 +15,7 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Vector3.h>
 
 #include "configure.h"
@@ -17,6 +24,8 @@
 #include "esp/sim/Simulator.h"
 
 #include "esp/assets/GenericSemanticMeshData.h"
+#include "esp/assets/ResourceManager.h"
+#include "esp/metadata/MetadataMediator.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -30,11 +39,70 @@ const std::string replicaRoom0 =
 const std::string replicaCAD =
     Cr::Utility::Path::join(SCENE_DATASETS, "replicaCAD");
 
+// write a small binary PLY with unused vertex properties, per-vertex object
+// IDs and a face property, so the reader has to skip data. The vertices are
+// offset by height along Z.
+bool writePly(const std::string& filename, bool quads, float height = 0.0f) {
+  std::string data =
+      "ply\nformat binary_little_endian 1.0\ncomment test\n"
+      "element vertex 4\nproperty float x\nproperty float y\n"
+      "property float z\nproperty float quality\nproperty uchar red\n"
+      "property uchar green\nproperty uchar blue\nproperty uchar alpha\n"
+      "property ushort object_id\n";
+  data += Cr::Utility::formatString(
+      "element face {}\nproperty list uchar int vertex_indices\n"
+      "property uchar flags\nend_header\n",
+      quads ? 1 : 2);
+  const auto append = [&](const auto value) {
+    char bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    data.append(bytes, sizeof(value));
+  };
+  for (int i = 0; i != 4; ++i) {
+    append(float(i % 2));
+    append(float(i / 2));
+    append(0.5f * i + height);
+    append(1.0f);
+    append(Mn::UnsignedByte(40 * i));
+    append(Mn::UnsignedByte(255 - 40 * i));
+    append(Mn::UnsignedByte(i % 2 ? 200 : 20));
+    append(Mn::UnsignedByte(255));
+    append(Mn::UnsignedShort(i / 2 + 1));
+  }
+  if (quads) {
+    append(Mn::UnsignedByte(4));
+    for (const int index : {0, 1, 3, 2}) {
+      append(index);
+    }
+    append(Mn::UnsignedByte(0));
+  } else {
+    for (const Mn::Vector3i& triangle :
+         {Mn::Vector3i{0, 1, 3}, Mn::Vector3i{0, 3, 2}}) {
+      append(Mn::UnsignedByte(3));
+      for (std::size_t i = 0; i != 3; ++i) {
+        append(triangle[i]);
+      }
+      append(Mn::UnsignedByte(0));
+    }
+  }
+  return Cr::Utility::Path::write(
+      filename,
+      Cr::Containers::ArrayView<const char>{data.data(), data.size()});
+}
+
 struct ReplicaSceneTest : Cr::TestSuite::Tester {
   explicit ReplicaSceneTest();
 
   void testSemanticSceneOBB();
 
+  void testSemanticMeshClusters();
+
+  void testSemanticMeshFromBinaryPly();
+
+  void testSemanticMeshCache();
+
+  void testSemanticMeshCacheOBBs();
+
   void testSemanticSceneLoading();
 
   void testSemanticSceneDescriptorReplicaCAD();
@@ -44,6 +112,10 @@ struct ReplicaSceneTest : Cr::TestSuite::Tester {
 
 ReplicaSceneTest::ReplicaSceneTest() {
   addTests({&ReplicaSceneTest::testSemanticSceneOBB,
+            &ReplicaSceneTest::testSemanticMeshClusters,
+            &ReplicaSceneTest::testSemanticMeshFromBinaryPly,
+            &ReplicaSceneTest::testSemanticMeshCache,
+            &ReplicaSceneTest::testSemanticMeshCacheOBBs,
             &ReplicaSceneTest::testSemanticSceneLoading,
 
 #ifdef ESP_BUILD_WITH_BULLET
@@ -122,6 +194,302 @@ void ReplicaSceneTest::testSemanticSceneOBB() {
   }
 }  // ReplicaSceneTest::testSemanticSceneOBB()
 
+void ReplicaSceneTest::testSemanticMeshClusters() {
+  const std::string semanticFilename =
+      Cr::Utility::Path::join(replicaRoom0, "mesh_semantic.ply");
+  if (!Cr::Utility::Path::exists(semanticFilename)) {
+    CORRADE_SKIP("Replica dataset not found at '" + replicaRoom0 +
+                 "'\nSkipping test");
+  }
+
+#ifndef MAGNUM_BUILD_STATIC
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+#else
+  // avoid using plugins that might depend on different library versions
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager{
+      "nonexistent"};
+#endif
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer;
+  CORRADE_INTERNAL_ASSERT(importer =
+                              manager.loadAndInstantiate("StanfordImporter"));
+  Cr::Containers::Optional<Mn::Trade::MeshData> meshData;
+  CORRADE_VERIFY(importer->openFile(semanticFilename) &&
+                 (meshData = importer->mesh(0)));
+
+  std::vector<Magnum::Vector3ub> dummyColormap;
+  std::unique_ptr<GenericSemanticMeshData> semanticMesh =
+      GenericSemanticMeshData::buildSemanticMeshData(
+          *meshData, semanticFilename, dummyColormap, false);
+  CORRADE_VERIFY(semanticMesh);
+  CORRADE_VERIFY(!semanticMesh->getMeshClusters());
+
+  // triangles as sorted index triplets, to compare them regardless of order
+  const auto sortedTriangles = [](const std::vector<uint32_t>& ibo) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (std::size_t i = 0; i + 2 < ibo.size(); i += 3) {
+      triangles.push_back({ibo[i], ibo[i + 1], ibo[i + 2]});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  };
+  const auto trianglesBefore =
+      sortedTriangles(semanticMesh->getIndexBufferObjectCPU());
+
+  semanticMesh->clusterTriangles(64);
+  const auto& vbo = semanticMesh->getVertexBufferObjectCPU();
+  const auto& ibo = semanticMesh->getIndexBufferObjectCPU();
+  CORRADE_VERIFY(sortedTriangles(ibo) == trianglesBefore);
+
+  // the clusters cover the index buffer in order and bound their vertices
+  const auto& clusters = semanticMesh->getMeshClusters();
+  CORRADE_VERIFY(clusters);
+  CORRADE_COMPARE(clusters->size(), (ibo.size() / 3 + 63) / 64);
+  std::size_t indexOffset = 0;
+  for (const esp::gfx::MeshCluster& cluster : *clusters) {
+    CORRADE_ITERATION(indexOffset);
+    CORRADE_COMPARE(std::size_t(cluster.indexOffset), indexOffset);
+    for (std::size_t i = cluster.indexOffset;
+         i != cluster.indexOffset + cluster.indexCount; ++i) {
+      CORRADE_VERIFY((cluster.aabb.min() <= vbo[ibo[i]]).all());
+      CORRADE_VERIFY((vbo[ibo[i]] <= cluster.aabb.max()).all());
+    }
+    indexOffset += cluster.indexCount;
+  }
+  CORRADE_COMPARE(indexOffset, ibo.size());
+}  // ReplicaSceneTest::testSemanticMeshClusters()
+
+void ReplicaSceneTest::testSemanticMeshFromBinaryPly() {
+#ifndef MAGNUM_BUILD_STATIC
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+#else
+  // avoid using plugins that might depend on different library versions
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager{
+      "nonexistent"};
+#endif
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer;
+  CORRADE_INTERNAL_ASSERT(importer =
+                              manager.loadAndInstantiate("StanfordImporter"));
+
+  const std::string filename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-triangles.ply");
+  CORRADE_VERIFY(writePly(filename, false));
+
+  // decoded directly, the result matches the importer path
+  std::vector<Magnum::Vector3ub> plyColormap;
+  std::unique_ptr<GenericSemanticMeshData> plyMesh =
+      GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+          filename, Mn::Matrix4{}, plyColormap);
+  CORRADE_VERIFY(plyMesh);
+
+  Cr::Containers::Optional<Mn::Trade::MeshData> meshData;
+  CORRADE_VERIFY(importer->openFile(filename) &&
+                 (meshData = importer->mesh(0)));
+  std::vector<Magnum::Vector3ub> importedColormap;
+  std::unique_ptr<GenericSemanticMeshData> importedMesh =
+      GenericSemanticMeshData::buildSemanticMeshData(
+          *meshData, "semantic-triangles.ply", importedColormap, false);
+  CORRADE_VERIFY(importedMesh);
+
+  const auto& vbo = plyMesh->getVertexBufferObjectCPU();
+  CORRADE_COMPARE(vbo.size(), std::size_t{4});
+  CORRADE_COMPARE(importedMesh->getVertexBufferObjectCPU().size(), vbo.size());
+  for (std::size_t i = 0; i != vbo.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(vbo[i], importedMesh->getVertexBufferObjectCPU()[i]);
+  }
+  CORRADE_VERIFY(plyMesh->getColorBufferObjectCPU() ==
+                 importedMesh->getColorBufferObjectCPU());
+  CORRADE_VERIFY(plyMesh->getIndexBufferObjectCPU() ==
+                 importedMesh->getIndexBufferObjectCPU());
+  CORRADE_VERIFY(plyMesh->getObjectIdsBufferObjectCPU() ==
+                 importedMesh->getObjectIdsBufferObjectCPU());
+  CORRADE_VERIFY(plyColormap == importedColormap);
+  CORRADE_VERIFY(plyMesh->meshCanBePartitioned());
+
+  // quads are left to the importer
+  const std::string quadFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-quad.ply");
+  CORRADE_VERIFY(writePly(quadFilename, true));
+  CORRADE_VERIFY(!GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+      quadFilename, Mn::Matrix4{}, plyColormap));
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(filename));
+  CORRADE_VERIFY(Cr::Utility::Path::remove(quadFilename));
+}  // ReplicaSceneTest::testSemanticMeshFromBinaryPly()
+
+void ReplicaSceneTest::testSemanticMeshCache() {
+  const std::string directory = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semanticMeshCache");
+  const auto listDirectory = [&directory]() {
+    std::vector<std::string> files;
+    if (const Cr::Containers::Optional<
+            Cr::Containers::Array<Cr::Containers::String>>
+            list = Cr::Utility::Path::list(
+                directory, Cr::Utility::Path::ListFlag::SkipDotAndDotDot)) {
+      for (const Cr::Containers::String& file : *list) {
+        files.emplace_back(Cr::Utility::Path::join(directory, file));
+      }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  };
+  const auto removeDirectory = [&]() {
+    for (const std::string& file : listDirectory()) {
+      Cr::Utility::Path::remove(file);
+    }
+    Cr::Utility::Path::remove(directory);
+  };
+  removeDirectory();
+  CORRADE_VERIFY(Cr::Utility::Path::make(directory));
+
+  // loads the semantic mesh in a new resource manager, returns the cache
+  // files existing afterwards
+  esp::sim::SimulatorConfiguration cfg;
+  cfg.createRenderer = false;
+  const auto load = [&](const std::string& filename) {
+    esp::assets::ResourceManager resourceManager{
+        esp::metadata::MetadataMediator::create(cfg)};
+    resourceManager.setSemanticMeshCacheDirectory(directory);
+    esp::assets::AssetInfo info;
+    info.type = esp::assets::AssetType::INSTANCE_MESH;
+    info.filepath = filename;
+    CORRADE_VERIFY(resourceManager.loadRenderAsset(info));
+    return listDirectory();
+  };
+  const auto read = [](const std::string& filename) {
+    Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(filename);
+    return data ? std::string{data->data(), data->size()} : std::string{};
+  };
+
+  const std::string filename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-cached.ply");
+  const std::string otherFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-other.ply");
+  CORRADE_VERIFY(writePly(filename, false));
+  CORRADE_VERIFY(writePly(otherFilename, false, 1.0f));
+
+  // each load of a new mesh writes a cache file
+  const std::vector<std::string> first = load(filename);
+  CORRADE_COMPARE(first.size(), 1);
+  const std::string cacheFilename = first[0];
+  std::vector<std::string> files = load(otherFilename);
+  CORRADE_COMPARE(files.size(), 2);
+  const std::string otherCacheFilename =
+      files[0] == cacheFilename ? files[1] : files[0];
+
+  // a second load of the same file is served from its cache file, which is
+  // neither rebuilt nor written again. Checked by substituting the cached
+  // data of the other mesh.
+  const std::string otherCached = read(otherCacheFilename);
+  CORRADE_VERIFY(!otherCached.empty());
+  CORRADE_VERIFY(read(cacheFilename) != otherCached);
+  CORRADE_VERIFY(Cr::Utility::Path::copy(otherCacheFilename, cacheFilename));
+  files = load(filename);
+  CORRADE_COMPARE(files.size(), 2);
+  CORRADE_COMPARE(read(cacheFilename), otherCached);
+
+  // changed contents of the same file miss the cache
+  CORRADE_VERIFY(writePly(filename, false, 2.0f));
+  files = load(filename);
+  CORRADE_COMPARE(files.size(), 3);
+  for (const std::string& file : files) {
+    if (file != cacheFilename && file != otherCacheFilename) {
+      CORRADE_VERIFY(read(file) != otherCached);
+    }
+  }
+
+  removeDirectory();
+  CORRADE_VERIFY(Cr::Utility::Path::remove(filename));
+  CORRADE_VERIFY(Cr::Utility::Path::remove(otherFilename));
+}  // ReplicaSceneTest::testSemanticMeshCache()
+
+void ReplicaSceneTest::testSemanticMeshCacheOBBs() {
+  // an HM3D SSD with an object for each vertex color of the mesh written by
+  // writePly() and one object that isn't present in the mesh, so vertex-based
+  // semantic bboxes are built
+  const std::string ssdFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-obbs.txt");
+  const std::string filename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-obbs.ply");
+  const std::string cacheFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "semantic-obbs.semanticmesh");
+  const std::string ssd =
+      "HM3D Semantic Annotations\n"
+      "1,00FF14,\"wall\",0\n"
+      "2,28D7C8,\"floor\",0\n"
+      "3,50AF14,\"chair\",1\n"
+      "4,7887C8,\"table\",1\n"
+      "5,FFFFFF,\"lamp\",1\n";
+  CORRADE_VERIFY(Cr::Utility::Path::write(
+      ssdFilename,
+      Cr::Containers::ArrayView<const char>{ssd.data(), ssd.size()}));
+  CORRADE_VERIFY(writePly(filename, false));
+
+  const auto loadSSD = [&ssdFilename]() {
+    auto semanticScene = esp::scene::SemanticScene::create();
+    CORRADE_VERIFY(esp::scene::SemanticScene::loadHM3DHouse(ssdFilename,
+                                                            *semanticScene));
+    CORRADE_VERIFY(semanticScene->buildBBoxFromVertColors());
+    return semanticScene;
+  };
+  const auto compareOBBs = [](const esp::scene::SemanticScene& actual,
+                              const esp::scene::SemanticScene& expected) {
+    CORRADE_COMPARE(actual.objects().size(), expected.objects().size());
+    for (std::size_t i = 0; i != expected.objects().size(); ++i) {
+      CORRADE_ITERATION(i);
+      const esp::geo::OBB actualOBB = actual.objects()[i]->obb();
+      const esp::geo::OBB expectedOBB = expected.objects()[i]->obb();
+      CORRADE_COMPARE(actual.objects()[i]->getColorAsInt(),
+                      expected.objects()[i]->getColorAsInt());
+      CORRADE_COMPARE(
+          Mn::EigenIntegration::cast<Mn::Vector3>(actualOBB.center()),
+          Mn::EigenIntegration::cast<Mn::Vector3>(expectedOBB.center()));
+      CORRADE_COMPARE(
+          Mn::EigenIntegration::cast<Mn::Vector3>(actualOBB.halfExtents()),
+          Mn::EigenIntegration::cast<Mn::Vector3>(expectedOBB.halfExtents()));
+      CORRADE_VERIFY(
+          actualOBB.rotation().isApprox(expectedOBB.rotation(), 1.0e-5f));
+    }
+  };
+
+  // the bboxes built serially, each object covers a single vertex
+  auto serialScene = loadSSD();
+  std::vector<Mn::Vector3ub> colorMap;
+  std::unique_ptr<GenericSemanticMeshData> serialMesh =
+      GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+          filename, Mn::Matrix4{}, colorMap, serialScene, 1);
+  CORRADE_VERIFY(serialMesh);
+  for (std::size_t i = 0; i != 4; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(Mn::EigenIntegration::cast<Mn::Vector3>(
+                        serialScene->objects()[i + 1]->obb().center()),
+                    serialMesh->getVertexBufferObjectCPU()[i]);
+  }
+
+  // built in parallel they're the same
+  auto parallelScene = loadSSD();
+  std::unique_ptr<GenericSemanticMeshData> mesh =
+      GenericSemanticMeshData::buildSemanticMeshDataFromPly(
+          filename, Mn::Matrix4{}, colorMap, parallelScene, 4);
+  CORRADE_VERIFY(mesh);
+  compareOBBs(*parallelScene, *serialScene);
+
+  // and loaded from the cache into a freshly loaded SSD as well
+  CORRADE_VERIFY(mesh->saveToCache(cacheFilename, colorMap, parallelScene));
+  auto cachedScene = loadSSD();
+  std::vector<Mn::Vector3ub> cachedColorMap;
+  CORRADE_VERIFY(GenericSemanticMeshData::loadFromCache(
+      cacheFilename, "semantic-obbs.ply", cachedColorMap, cachedScene, 4));
+  CORRADE_VERIFY(cachedColorMap == colorMap);
+  compareOBBs(*cachedScene, *serialScene);
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(ssdFilename));
+  CORRADE_VERIFY(Cr::Utility::Path::remove(filename));
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+}  // ReplicaSceneTest::testSemanticMeshCacheOBBs()
+
 void ReplicaSceneTest::testSemanticSceneLoading() {
   if (!Cr::Utility::Path::exists(replicaRoom0)) {
     CORRADE_SKIP("Replica dataset not found at '" + replicaRoom0 +
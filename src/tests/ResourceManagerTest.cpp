@@ -5,17 +5,33 @@
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/MeshTools/Duplicate.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Primitives/Cube.h>
 #include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <algorithm>
+#include <array>
 #include <string>
+#include <vector>
 
+#include "esp/assets/GenericMeshData.h"
 #include "esp/assets/MeshData.h"
+#include "esp/assets/MeshOptimization.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/assets/SharedMemoryAssetStore.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/metadata/MetadataMediator.h"
@@ -42,6 +58,14 @@ struct ResourceManagerTest : Cr::TestSuite::Tester {
 
   void testShaderTypeSpecification();
 
+  void optimizeMeshForRendering();
+
+  void releaseRenderOnlyData();
+
+  void shareCollisionMeshes();
+
+  void packTextureArrays();
+
   esp::logging::LoggingContext loggingContext;
 };  // struct ResourceManagerTest
 ResourceManagerTest::ResourceManagerTest() {
@@ -49,6 +73,10 @@ ResourceManagerTest::ResourceManagerTest() {
       &ResourceManagerTest::createJoinedCollisionMesh,
       &ResourceManagerTest::loadAndCreateRenderAssetInstance,
       &ResourceManagerTest::testShaderTypeSpecification,
+      &ResourceManagerTest::optimizeMeshForRendering,
+      &ResourceManagerTest::releaseRenderOnlyData,
+      &ResourceManagerTest::shareCollisionMeshes,
+      &ResourceManagerTest::packTextureArrays,
   });
 }
 
@@ -112,6 +140,20 @@ void ResourceManagerTest::createJoinedCollisionMesh() {
                           16, 17, 18, 16, 18, 19, 20, 21, 22, 20, 22, 23}),
                      Cr::TestSuite::Compare::Container);
 
+  // joining parts referencing the collision data gives the same mesh, here
+  // translated
+  std::vector<esp::assets::MeshJoinPart> parts;
+  resourceManager.appendCollisionMeshJoinParts(
+      parts, boxFile, Mn::Matrix4::translation({0.0f, 2.0f, 0.0f}));
+  CORRADE_COMPARE(parts.size(), 6);
+  esp::assets::MeshData joinedParts;
+  esp::assets::joinMeshParts(joinedParts, parts);
+  CORRADE_COMPARE_AS(Cr::Containers::arrayView(joinedParts.ibo),
+                     Cr::Containers::arrayView(joinedBox->ibo),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(joinedParts.vbo.size(), joinedBox->vbo.size());
+  CORRADE_COMPARE(joinedParts.vbo[0].x(), joinedBox->vbo[0].x());
+  CORRADE_COMPARE(joinedParts.vbo[0].y(), joinedBox->vbo[0].y() + 2.0f);
 }  // namespace Test
 
 // Load and create a render asset instance and assert success
@@ -252,6 +294,320 @@ void ResourceManagerTest::testShaderTypeSpecification() {
 
 }  // ResourceManagerTest::testFlatShaderTypeSpecification
 
+// Triangles of a mesh as sorted position triples, independent of the order
+// of the triangles and vertices
+std::vector<std::array<float, 9>> sortedTriangles(
+    const Mn::Trade::MeshData& mesh) {
+  const Cr::Containers::Array<Mn::Vector3> positions =
+      mesh.positions3DAsArray();
+  Cr::Containers::Array<Mn::UnsignedInt> indices;
+  if (mesh.isIndexed()) {
+    indices = mesh.indicesAsArray();
+  } else {
+    indices = Cr::Containers::Array<Mn::UnsignedInt>{mesh.vertexCount()};
+    for (Mn::UnsignedInt i = 0; i != indices.size(); ++i) {
+      indices[i] = i;
+    }
+  }
+  std::vector<std::array<float, 9>> triangles(indices.size() / 3);
+  for (std::size_t i = 0; i != triangles.size(); ++i) {
+    for (std::size_t j = 0; j != 3; ++j) {
+      const Mn::Vector3& position = positions[indices[3 * i + j]];
+      for (std::size_t k = 0; k != 3; ++k) {
+        triangles[i][3 * j + k] = position[k];
+      }
+    }
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+void ResourceManagerTest::optimizeMeshForRendering() {
+  // a cube with every triangle having its own vertices, 24 of the 36 unique
+  Mn::Trade::MeshData cube =
+      Mn::MeshTools::duplicate(Mn::Primitives::cubeSolid());
+  CORRADE_COMPARE(cube.vertexCount(), 36);
+  const std::vector<std::array<float, 9>> expectedTriangles =
+      sortedTriangles(cube);
+
+  Mn::Trade::MeshData optimized =
+      esp::assets::optimizeMeshForRendering(std::move(cube));
+  CORRADE_VERIFY(optimized.isIndexed());
+  CORRADE_COMPARE(optimized.indexType(), Mn::MeshIndexType::UnsignedInt);
+  CORRADE_COMPARE(optimized.indexCount(), 36);
+  CORRADE_COMPARE(optimized.vertexCount(), 24);
+  CORRADE_VERIFY(optimized.hasAttribute(Mn::Trade::MeshAttribute::Normal));
+  CORRADE_VERIFY(sortedTriangles(optimized) == expectedTriangles);
+
+  // vertices are in the order the triangles first use them
+  Mn::UnsignedInt nextVertex = 0;
+  for (const Mn::UnsignedInt index :
+       optimized.indices<Mn::UnsignedInt>().asContiguous()) {
+    CORRADE_VERIFY(index <= nextVertex);
+    if (index == nextVertex) {
+      ++nextVertex;
+    }
+  }
+  CORRADE_COMPARE(nextVertex, 24);
+
+  // the optimized mesh survives a round trip through the cache file
+  const std::string filename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "optimizedCube.mesh");
+  CORRADE_VERIFY(esp::assets::saveOptimizedMesh(filename, optimized));
+  Cr::Containers::Optional<Mn::Trade::MeshData> loaded =
+      esp::assets::loadOptimizedMesh(filename);
+  Cr::Utility::Path::remove(filename);
+  CORRADE_VERIFY(loaded);
+  CORRADE_COMPARE(loaded->vertexCount(), 24);
+  CORRADE_COMPARE(loaded->attributeCount(), optimized.attributeCount());
+  CORRADE_COMPARE_AS(loaded->indicesAsArray(), optimized.indicesAsArray(),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(loaded->positions3DAsArray(),
+                     optimized.positions3DAsArray(),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(loaded->normalsAsArray(), optimized.normalsAsArray(),
+                     Cr::TestSuite::Compare::Container);
+
+  // a missing file isn't loaded
+  CORRADE_VERIFY(!esp::assets::loadOptimizedMesh(filename));
+}  // ResourceManagerTest::optimizeMeshForRendering
+
+void ResourceManagerTest::releaseRenderOnlyData() {
+  // a cube with positions, normals and 16-bit indices
+  Mn::Trade::MeshData cube = Mn::Primitives::cubeSolid();
+  CORRADE_VERIFY(cube.hasAttribute(Mn::Trade::MeshAttribute::Normal));
+  const Cr::Containers::Array<Mn::Vector3> expectedPositions =
+      cube.positions3DAsArray();
+  const Cr::Containers::Array<Mn::UnsignedInt> expectedIndices =
+      cube.indicesAsArray();
+
+  esp::assets::GenericMeshData meshData;
+  meshData.setMeshData(std::move(cube));
+  meshData.releaseRenderOnlyData();
+
+  const Cr::Containers::Optional<Mn::Trade::MeshData>& released =
+      meshData.getMeshData();
+  CORRADE_VERIFY(released);
+  CORRADE_COMPARE(released->attributeCount(), 1);
+  CORRADE_VERIFY(released->hasAttribute(Mn::Trade::MeshAttribute::Position));
+  CORRADE_COMPARE(released->indexType(), Mn::MeshIndexType::UnsignedInt);
+  CORRADE_COMPARE_AS(released->positions3DAsArray(), expectedPositions,
+                     Cr::TestSuite::Compare::Container);
+
+  // the collision data references the remaining mesh data
+  esp::assets::CollisionMeshData& collision = meshData.getCollisionMeshData();
+  CORRADE_COMPARE(static_cast<const void*>(collision.positions.data()),
+                  released->attribute<Mn::Vector3>(
+                      Mn::Trade::MeshAttribute::Position).data());
+  CORRADE_COMPARE_AS(
+      Cr::Containers::ArrayView<const Mn::UnsignedInt>{collision.indices},
+      Cr::Containers::arrayView(expectedIndices),
+                     Cr::TestSuite::Compare::Container);
+}  // ResourceManagerTest::releaseRenderOnlyData
+
+void ResourceManagerTest::shareCollisionMeshes() {
+  const std::string directory = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "sharedAssetMemory");
+  const auto removeDirectory = [&directory]() {
+    if (const Cr::Containers::Optional<
+            Cr::Containers::Array<Cr::Containers::String>>
+            files = Cr::Utility::Path::list(
+                directory, Cr::Utility::Path::ListFlag::SkipDotAndDotDot)) {
+      for (const Cr::Containers::String& file : *files) {
+        Cr::Utility::Path::remove(Cr::Utility::Path::join(directory, file));
+      }
+    }
+    Cr::Utility::Path::remove(directory);
+  };
+  removeDirectory();
+
+  Mn::Trade::MeshData cube = Mn::Primitives::cubeSolid();
+  const Cr::Containers::Array<Mn::Vector3> expectedPositions =
+      cube.positions3DAsArray();
+  const Cr::Containers::Array<Mn::UnsignedInt> expectedIndices =
+      cube.indicesAsArray();
+
+  // one mesh still with its render data, one only with collision data
+  esp::assets::GenericMeshData rendered;
+  rendered.setMeshData(Mn::Primitives::cubeSolid());
+  esp::assets::GenericMeshData released;
+  released.setMeshData(std::move(cube));
+  released.releaseRenderOnlyData();
+  CORRADE_VERIFY(rendered.getCollisionMemoryUsage() > 0);
+
+  auto store = esp::assets::SharedMemoryAssetStore::create(directory);
+  CORRADE_VERIFY(store->shareCollisionMeshes({&rendered, &released}));
+  CORRADE_COMPARE(rendered.getCollisionMemoryUsage(), 0);
+  CORRADE_VERIFY(store->mappedByteSize() > 0);
+
+  for (esp::assets::GenericMeshData* mesh : {&rendered, &released}) {
+    const esp::assets::CollisionMeshData& collision =
+        mesh->getCollisionMeshData();
+    CORRADE_COMPARE_AS(collision.positions,
+                       Cr::Containers::arrayView(expectedPositions),
+                       Cr::TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(collision.indices,
+                       Cr::Containers::arrayView(expectedIndices),
+                       Cr::TestSuite::Compare::Container);
+  }
+  // the render data is kept, the collision-only mesh data references the
+  // shared memory
+  CORRADE_VERIFY(rendered.getMeshData()->hasAttribute(
+      Mn::Trade::MeshAttribute::Normal));
+  CORRADE_COMPARE(released.getMeshData()
+                      ->attribute<Mn::Vector3>(
+                          Mn::Trade::MeshAttribute::Position)
+                      .data(),
+                  static_cast<const void*>(
+                      released.getCollisionMeshData().positions.data()));
+  CORRADE_COMPARE(released.getMemoryUsage().cpuBytes, 0);
+
+  // another process with the same data maps the block instead of writing it
+  esp::assets::GenericMeshData other;
+  other.setMeshData(Mn::Primitives::cubeSolid());
+  other.releaseRenderOnlyData();
+  auto otherStore = esp::assets::SharedMemoryAssetStore::create(directory);
+  CORRADE_VERIFY(otherStore->shareCollisionMeshes({&other}));
+  CORRADE_COMPARE_AS(other.getCollisionMeshData().positions,
+                     Cr::Containers::arrayView(expectedPositions),
+                     Cr::TestSuite::Compare::Container);
+
+  // blocks are found by key, missing ones aren't
+  const char data[]{'a', 'b', 'c'};
+  CORRADE_VERIFY(!store->find("block"));
+  CORRADE_VERIFY(store->publish("block", data));
+  const auto block = otherStore->find("block");
+  CORRADE_VERIFY(block);
+  CORRADE_COMPARE_AS(Cr::Containers::ArrayView<const char>{*block},
+                     Cr::Containers::arrayView(data),
+                     Cr::TestSuite::Compare::Container);
+
+  removeDirectory();
+}  // ResourceManagerTest::shareCollisionMeshes
+
+// Material IDs of a transform tree in node order
+void collectMaterialIDs(const esp::assets::MeshTransformNode& node,
+                        std::vector<std::string>& matIDs) {
+  if (!Cr::Utility::String::trim(node.materialID).empty()) {
+    matIDs.push_back(node.materialID);
+  }
+  for (const auto& child : node.children) {
+    collectMaterialIDs(child, matIDs);
+  }
+}
+
+void ResourceManagerTest::packTextureArrays() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  // five textured quads: two PBR materials with textures of their own, one
+  // sharing its texture with a flat material and one sampling its texture in
+  // a clear coat layer as well
+  const std::string assetFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/texture_arrays.gltf");
+  const Mn::Vector2i size{160, 32};
+
+  Mn::Image2D renders[2]{
+      {Mn::PixelFormat::RGBA8Unorm, size,
+       Cr::Containers::Array<char>{Cr::ValueInit,
+                                   4 * std::size_t(size.product())}},
+      {Mn::PixelFormat::RGBA8Unorm, size,
+       Cr::Containers::Array<char>{Cr::ValueInit,
+                                   4 * std::size_t(size.product())}}};
+  for (const bool pack : {false, true}) {
+    CORRADE_ITERATION(pack);
+    // must declare these in this order due to avoid deallocation errors
+    auto MM = MetadataMediator::create();
+    ResourceManager resourceManager(MM);
+    resourceManager.setPackTextureArrays(pack);
+    SceneManager sceneManager_;
+    int sceneID = sceneManager_.initSceneGraph();
+    auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
+
+    const esp::assets::AssetInfo info =
+        esp::assets::AssetInfo::fromPath(assetFile);
+    esp::assets::RenderAssetInstanceCreationInfo creation(
+        assetFile, Corrade::Containers::NullOpt,
+        esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD, "");
+    std::vector<int> tempIDs{sceneID, esp::ID_UNDEFINED};
+    CORRADE_VERIFY(resourceManager.loadAndCreateRenderAssetInstance(
+        info, creation, &sceneManager_, tempIDs));
+
+    std::vector<std::string> matIDs;
+    collectMaterialIDs(resourceManager.getMeshMetaData(assetFile).root,
+                       matIDs);
+    CORRADE_COMPARE(matIDs.size(), 5);
+    auto& shaderManager = resourceManager.getShaderManager();
+    auto material = [&](std::size_t i) {
+      return shaderManager.get<Mn::Trade::MaterialData>(matIDs[i]);
+    };
+
+    // only the materials whose textures aren't sampled by anything else
+    // reference texture arrays, and then instead of the 2D textures
+    for (std::size_t i : {0, 4}) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(material(i)->hasAttribute("baseColorTextureArrayPointer"),
+                      pack);
+      CORRADE_COMPARE(material(i)->hasAttribute("baseColorTextureArrayLayer"),
+                      pack);
+      CORRADE_COMPARE(material(i)->hasAttribute("baseColorTexturePointer"),
+                      !pack);
+    }
+    if (pack) {
+      // both are layers of the same array
+      CORRADE_COMPARE(
+          material(0)->attribute<Mn::GL::Texture2DArray*>(
+              "baseColorTextureArrayPointer"),
+          material(4)->attribute<Mn::GL::Texture2DArray*>(
+              "baseColorTextureArrayPointer"));
+      CORRADE_VERIFY(
+          material(0)->attribute<Mn::UnsignedInt>(
+              "baseColorTextureArrayLayer") !=
+          material(4)->attribute<Mn::UnsignedInt>(
+              "baseColorTextureArrayLayer"));
+    }
+    for (std::size_t i : {1, 2, 3}) {
+      CORRADE_ITERATION(i);
+      CORRADE_VERIFY(
+          !material(i)->hasAttribute("baseColorTextureArrayPointer"));
+      CORRADE_VERIFY(material(i)->hasAttribute("baseColorTexturePointer"));
+    }
+
+    esp::gfx::RenderCamera& camera = *(new esp::gfx::RenderCamera(
+        sceneGraph.getRootNode().createChild(),
+        esp::scene::SceneNodeSemanticDataIDX::SEMANTIC_ID, {0.0f, 0.0f, 4.0f},
+        {}, Mn::Vector3::yAxis()));
+    camera.setOrthoProjectionMatrix(size.x(), size.y(), 0.01f, 10.0f, 0.8f);
+    esp::gfx::RenderTarget target{
+        size, {}, nullptr, esp::gfx::RenderTarget::Flag::RgbaAttachment};
+    auto drawableTransforms =
+        camera.drawableTransformations(sceneGraph.getDrawables());
+    target.renderEnter();
+    camera.draw(drawableTransforms, {});
+    target.renderExit();
+    target.readFrameRgba(renders[pack]);
+  }
+
+  // sampling the layers gives the same image as the 2D textures
+  const auto expected = renders[0].pixels<Mn::Color4ub>();
+  const auto actual = renders[1].pixels<Mn::Color4ub>();
+  std::size_t numDrawn = 0;
+  std::size_t numDifferent = 0;
+  for (std::size_t y = 0; y != expected.size()[0]; ++y) {
+    for (std::size_t x = 0; x != expected.size()[1]; ++x) {
+      numDrawn += expected[y][x] != Mn::Color4ub{};
+      numDifferent +=
+          (Mn::Math::abs(Mn::Vector4i{expected[y][x]} -
+                         Mn::Vector4i{actual[y][x]}) > Mn::Vector4i{1})
+              .any();
+    }
+  }
+  CORRADE_VERIFY(numDrawn > 0);
+  CORRADE_COMPARE(numDifferent, 0);
+}  // ResourceManagerTest::packTextureArrays
+
 }  // namespace
 
 CORRADE_TEST_MAIN(ResourceManagerTest)
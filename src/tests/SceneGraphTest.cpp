@@ -5,15 +5,23 @@
 #include <Corrade/TestSuite/Tester.h>
 
 #include "esp/scene/SceneGraph.h"
+#include "esp/scene/TransformStore.h"
 
 using esp::gfx::DrawableGroup;
 using esp::scene::SceneGraph;
+using esp::scene::SceneNode;
+using esp::scene::TransformStore;
+using Magnum::Matrix4;
+using Magnum::Vector3;
+using Magnum::Range3D;
 
 namespace {
 struct SceneGraphTest : Cr::TestSuite::Tester {
   explicit SceneGraphTest();
   void testGetDrawableGroup();
   void testDeleteDrawableGroup();
+  void testCumulativeBB();
+  void testTransformStore();
   esp::logging::LoggingContext loggingContext_;
   size_t numInitialGroups;
   SceneGraph g;
@@ -22,7 +30,9 @@ struct SceneGraphTest : Cr::TestSuite::Tester {
 SceneGraphTest::SceneGraphTest() {
   numInitialGroups = g.getDrawableGroups().size();
   addTests({&SceneGraphTest::testGetDrawableGroup,
-            &SceneGraphTest::testDeleteDrawableGroup});
+            &SceneGraphTest::testDeleteDrawableGroup,
+            &SceneGraphTest::testCumulativeBB,
+            &SceneGraphTest::testTransformStore});
 }
 
 void SceneGraphTest::testGetDrawableGroup() {
@@ -41,6 +51,99 @@ void SceneGraphTest::testDeleteDrawableGroup() {
   CORRADE_COMPARE(g.getDrawableGroups().size(), numInitialGroups);
   CORRADE_VERIFY(g.getDrawableGroup(groupName) == nullptr);
 }
+
+void SceneGraphTest::testCumulativeBB() {
+  SceneGraph graph;
+  SceneNode& root = graph.getRootNode();
+  SceneNode& a = root.createChild();
+  SceneNode& b = a.createChild();
+  SceneNode& c = root.createChild();
+  b.setMeshBB({{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}});
+  c.setMeshBB({{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}});
+  CORRADE_COMPARE(root.computeCumulativeBB(),
+                  Range3D({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}));
+
+  // moves are only reported for nodes with a clean transformation, until
+  // then their parents stay dirty
+  CORRADE_VERIFY(root.isCumulativeBBDirty());
+  b.absoluteTranslation();
+  c.absoluteTranslation();
+  root.computeCumulativeBB();
+  CORRADE_VERIFY(!root.isCumulativeBBDirty());
+  CORRADE_VERIFY(!a.isCumulativeBBDirty());
+  CORRADE_VERIFY(!b.isCumulativeBBDirty());
+  CORRADE_VERIFY(!c.isCumulativeBBDirty());
+
+  // moving a node dirties only its ancestors
+  b.translate({2.0f, 0.0f, 0.0f});
+  CORRADE_VERIFY(root.isCumulativeBBDirty());
+  CORRADE_VERIFY(a.isCumulativeBBDirty());
+  CORRADE_VERIFY(!b.isCumulativeBBDirty());
+  CORRADE_VERIFY(!c.isCumulativeBBDirty());
+  b.absoluteTranslation();
+  CORRADE_COMPARE(root.computeCumulativeBB(),
+                  Range3D({-1.0f, -1.0f, -1.0f}, {3.0f, 1.0f, 1.0f}));
+  CORRADE_VERIFY(!root.isCumulativeBBDirty());
+
+  // so does changing a mesh bounding box
+  c.setMeshBB({{0.0f, 0.0f, 0.0f}, {5.0f, 1.0f, 1.0f}});
+  CORRADE_VERIFY(root.isCumulativeBBDirty());
+  CORRADE_VERIFY(!a.isCumulativeBBDirty());
+  CORRADE_COMPARE(root.computeCumulativeBB(),
+                  Range3D({-1.0f, -1.0f, -1.0f}, {5.0f, 1.0f, 1.0f}));
+
+  // and adding a child
+  SceneNode& d = a.createChild();
+  d.setMeshBB({{0.0f, -4.0f, 0.0f}, {1.0f, 0.0f, 1.0f}});
+  d.absoluteTranslation();
+  CORRADE_VERIFY(a.isCumulativeBBDirty());
+  CORRADE_COMPARE(root.computeCumulativeBB(),
+                  Range3D({-1.0f, -4.0f, -1.0f}, {5.0f, 1.0f, 1.0f}));
+}
+
+void SceneGraphTest::testTransformStore() {
+  SceneGraph graph;
+  SceneNode& root = graph.getRootNode();
+  SceneNode& a = root.createChild();
+  SceneNode& b = a.createChild();
+  SceneNode& c = root.createChild();
+  a.translate({1.0f, 0.0f, 0.0f});
+  b.translate({0.0f, 2.0f, 0.0f});
+  c.translate({0.0f, 0.0f, 3.0f});
+
+  TransformStore store{root};
+  CORRADE_COMPARE(store.size(), 4);
+  CORRADE_COMPARE(store.indexOf(root), 0);
+  // parents come before their children
+  for (std::size_t i = 1; i != store.size(); ++i) {
+    CORRADE_VERIFY(store.parents()[i] >= 0);
+    CORRADE_VERIFY(std::size_t(store.parents()[i]) < i);
+  }
+  CORRADE_COMPARE(store.parents()[store.indexOf(b)], store.indexOf(a));
+  CORRADE_COMPARE(store.worldTransformations()[store.indexOf(b)],
+                  Matrix4::translation({1.0f, 2.0f, 0.0f}));
+
+  // nothing moved
+  CORRADE_COMPARE(store.update(), 0);
+
+  // moving a updates a and b, but not c
+  a.translate({1.0f, 0.0f, 0.0f});
+  CORRADE_COMPARE(store.update(), 2);
+  CORRADE_VERIFY(store.changed()[store.indexOf(b)]);
+  CORRADE_VERIFY(!store.changed()[store.indexOf(c)]);
+  CORRADE_COMPARE(store.worldTransformations()[store.indexOf(b)],
+                  Matrix4::translation({2.0f, 2.0f, 0.0f}));
+  CORRADE_COMPARE(store.worldTransformations()[store.indexOf(b)],
+                  b.absoluteTransformation());
+
+  // new nodes are picked up by a rebuild
+  SceneNode& d = b.createChild();
+  CORRADE_COMPARE(store.indexOf(d), -1);
+  store.rebuild();
+  CORRADE_COMPARE(store.size(), 5);
+  CORRADE_COMPARE(store.worldTransformations()[store.indexOf(d)].translation(),
+                  (Vector3{2.0f, 2.0f, 0.0f}));
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(SceneGraphTest)
@@ -28,6 +28,12 @@ struct SemanticTest : Cr::TestSuite::Tester {
    */
   void TestRegionCreation();
 
+  /**
+   * @brief This test will validate batched region containment queries
+   * against the per-point ones.
+   */
+  void TestRegionsForPointsBatched();
+
   esp::logging::LoggingContext loggingContext_;
 
   //
@@ -48,7 +54,8 @@ SemanticTest::SemanticTest() {
   semanticAttr_ = MM->getSemanticAttributesManager()->createObject(
       semanticConfigFile, true);
 
-  addTests({&SemanticTest::TestRegionCreation});
+  addTests({&SemanticTest::TestRegionCreation,
+            &SemanticTest::TestRegionsForPointsBatched});
 }
 
 void SemanticTest::TestRegionCreation() {
@@ -127,6 +134,53 @@ void SemanticTest::TestRegionCreation() {
 
 }  // namespace
 
+void SemanticTest::TestRegionsForPointsBatched() {
+  std::shared_ptr<esp::scene::SemanticScene> semanticScene =
+      esp::scene::SemanticScene::create();
+
+  esp::scene::SemanticScene::loadSemanticSceneDescriptor(semanticAttr_,
+                                                         *semanticScene);
+  const auto& regions = semanticScene->regions();
+  CORRADE_COMPARE(regions.size(), 2);
+
+  // A grid of points covering both regions and beyond them
+  std::vector<Mn::Vector3> points;
+  for (float x = -30.0f; x <= 30.0f; x += 0.75f) {
+    for (float y = -3.0f; y <= 3.0f; y += 1.5f) {
+      for (float z = -12.0f; z <= 12.0f; z += 0.75f) {
+        points.emplace_back(x, y, z);
+      }
+    }
+  }
+
+  for (int numThreads : {1, 4}) {
+    CORRADE_ITERATION(numThreads);
+    std::vector<int> offsets;
+    std::vector<int> regionIndices;
+    semanticScene->getRegionsForPointsBatched(points, offsets, regionIndices,
+                                              numThreads);
+    CORRADE_COMPARE(offsets.size(), points.size() + 1);
+    CORRADE_COMPARE(offsets.front(), 0);
+    CORRADE_COMPARE(std::size_t(offsets.back()), regionIndices.size());
+    CORRADE_VERIFY(!regionIndices.empty());
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      CORRADE_ITERATION(i);
+      // Containment is the same as testing every region
+      std::vector<int> expected;
+      for (int rix = 0; rix < regions.size(); ++rix) {
+        if (regions[rix]->contains(points[i])) {
+          expected.push_back(rix);
+        }
+      }
+      const std::vector<int> actual{regionIndices.begin() + offsets[i],
+                                    regionIndices.begin() + offsets[i + 1]};
+      CORRADE_VERIFY(actual == expected);
+      CORRADE_VERIFY(semanticScene->getRegionsForPoint(points[i]) == actual);
+    }
+  }
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SemanticTest)
@@ -0,0 +1,386 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/PixelFormat.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "esp/agent/Agent.h"
+#include "esp/core/Profiler.h"
+#include "esp/gfx/replay/Recorder.h"
+#include "esp/gfx/replay/ReplayManager.h"
+#include "esp/metadata/managers/ObjectAttributesManager.h"
+#include "esp/physics/objectManagers/RigidObjectManager.h"
+#include "esp/sensor/CameraSensor.h"
+#include "esp/sim/BatchReplayRenderer.h"
+#include "esp/sim/Simulator.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::agent::AgentConfiguration;
+using esp::sensor::CameraSensorSpec;
+using esp::sensor::Observation;
+using esp::sensor::SensorType;
+using esp::sim::ReplayRendererConfiguration;
+using esp::sim::Simulator;
+using esp::sim::SimulatorConfiguration;
+
+/* End-to-end throughput of the common training workloads, each benchmark
+   iteration being one environment step including the observations. The
+   reported time per iteration converts to steps per second as 1e9 / ns, for
+   the batch replay benchmarks multiply by the environment count. Actions and
+   object motion come from fixed seeds, so runs are comparable between
+   revisions on the same machine. The scene load benchmarks measure creating a
+   simulator for each of the datasets, and print how the time splits into
+   the phases of Simulator::getSceneLoadPerfStatValues(). Benchmarks with data
+   that isn't downloaded are skipped. */
+
+namespace {
+
+const std::string vangogh = Cr::Utility::Path::join(
+    SCENE_DATASETS, "habitat-test-scenes/van-gogh-room.glb");
+const std::string mp3dScene = Cr::Utility::Path::join(
+    SCENE_DATASETS, "mp3d_example/17DRP5sb8fy/17DRP5sb8fy.glb");
+const std::string replicaCadDataset = Cr::Utility::Path::join(
+    DATA_DIR,
+    "replica_cad/replicaCAD.scene_dataset_config.json");
+const std::string physicsConfigFile =
+    Cr::Utility::Path::join(TEST_ASSETS, "testing.physics_config.json");
+
+// the steps measured per benchmark run
+constexpr int StepCount = 50;
+
+// keyframes recorded for the batch replay benchmark, the first one creating
+// the instances
+constexpr int KeyframeCount = StepCount + 1;
+
+// datasets are relative to DATA_DIR, scenes without a dataset to
+// SCENE_DATASETS
+const struct {
+  const char* name;
+  const char* sceneDataset;
+  const char* scene;
+} SceneLoadData[]{
+    {"van Gogh room", nullptr, "habitat-test-scenes/van-gogh-room.glb"},
+    {"Skokloster castle", nullptr, "habitat-test-scenes/skokloster-castle.glb"},
+    {"apartment 1", nullptr, "habitat-test-scenes/apartment_1.glb"},
+    {"MP3D example", nullptr, "mp3d_example/17DRP5sb8fy/17DRP5sb8fy.glb"},
+    {"ReplicaCAD apt_0", "replica_cad/replicaCAD.scene_dataset_config.json",
+     "apt_0"},
+};
+
+const struct {
+  const char* name;
+  unsigned numEnvironments;
+} BatchReplayData[]{
+    {"64 environments", 64},
+    {"256 environments", 256},
+    {"1024 environments", 1024},
+};
+
+struct SimBenchmarkTest : Cr::TestSuite::Tester {
+  explicit SimBenchmarkTest();
+
+  void pointNavRgbd();
+  void objectNavSemantic();
+  void rearrangePhysics();
+  void batchReplay();
+  void sceneLoad();
+
+  // steps the first agent of simulator with random actions, drawing its
+  // sensors after each
+  void benchmarkAgentSteps(Simulator& simulator);
+
+  // delta keyframes of donuts moving around the van Gogh room
+  const std::vector<std::string>& batchKeyframes();
+
+  std::vector<std::string> batchKeyframes_;
+
+  esp::logging::LoggingContext loggingContext_;
+};
+
+SimBenchmarkTest::SimBenchmarkTest() {
+  // clang-format off
+  addBenchmarks({&SimBenchmarkTest::pointNavRgbd,
+                 &SimBenchmarkTest::objectNavSemantic,
+                 &SimBenchmarkTest::rearrangePhysics}, 3);
+  // clang-format on
+  addInstancedBenchmarks({&SimBenchmarkTest::batchReplay}, 2,
+                         Cr::Containers::arraySize(BatchReplayData));
+  addInstancedBenchmarks({&SimBenchmarkTest::sceneLoad}, 3,
+                         Cr::Containers::arraySize(SceneLoadData));
+}
+
+esp::sensor::SensorSpec::ptr cameraSpec(const std::string& uuid,
+                                        const SensorType type,
+                                        const int resolution) {
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = uuid;
+  spec->sensorType = type;
+  spec->position = {0.0f, 1.5f, 0.0f};
+  spec->resolution = {resolution, resolution};
+  return spec;
+}
+
+void SimBenchmarkTest::benchmarkAgentSteps(Simulator& simulator) {
+  const char* const actions[]{"moveForward", "turnLeft", "turnRight"};
+  std::mt19937 rng{0};
+  std::uniform_int_distribution<int> action{0, 2};
+  auto agent = simulator.getAgent(0);
+  std::map<std::string, Observation> observations;
+
+  // the first draw compiles shaders and uploads textures
+  simulator.getAgentObservations(0, observations);
+
+  CORRADE_BENCHMARK(StepCount) {
+    agent->act(actions[action(rng)]);
+    simulator.getAgentObservations(0, observations);
+  }
+}
+
+void SimBenchmarkTest::pointNavRgbd() {
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  simConfig.randomSeed = 0;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {
+      cameraSpec("rgb", SensorType::Color, 256),
+      cameraSpec("depth", SensorType::Depth, 256)};
+  simulator->addAgent(agentConfig);
+
+  benchmarkAgentSteps(*simulator);
+}
+
+void SimBenchmarkTest::objectNavSemantic() {
+  if (!Cr::Utility::Path::exists(mp3dScene)) {
+    CORRADE_SKIP("MP3D example scene not found at" << mp3dScene);
+  }
+
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = mp3dScene;
+  simConfig.randomSeed = 0;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {
+      cameraSpec("rgb", SensorType::Color, 256),
+      cameraSpec("depth", SensorType::Depth, 256),
+      cameraSpec("semantic", SensorType::Semantic, 256)};
+  simulator->addAgent(agentConfig);
+
+  benchmarkAgentSteps(*simulator);
+}
+
+void SimBenchmarkTest::rearrangePhysics() {
+#ifndef ESP_BUILD_WITH_BULLET
+  CORRADE_SKIP("Bullet physics not enabled");
+#else
+  if (!Cr::Utility::Path::exists(replicaCadDataset)) {
+    CORRADE_SKIP("ReplicaCAD dataset not found at" << replicaCadDataset);
+  }
+
+  SimulatorConfiguration simConfig{};
+  simConfig.sceneDatasetConfigFile = replicaCadDataset;
+  simConfig.activeSceneName = "apt_0";
+  simConfig.enablePhysics = true;
+  simConfig.randomSeed = 0;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {
+      cameraSpec("rgb", SensorType::Color, 128),
+      cameraSpec("depth", SensorType::Depth, 128)};
+  simulator->addAgent(agentConfig);
+
+  // wake everything up so the steps simulate the whole scene, with the
+  // objects at seeded random velocities
+  auto rigidObjectManager = simulator->getRigidObjectManager();
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> velocity{-0.5f, 0.5f};
+  for (const int id : rigidObjectManager->getExistingObjectIDs()) {
+    auto object = rigidObjectManager->getObjectByID(id);
+    if (object->getMotionType() != esp::physics::MotionType::DYNAMIC) {
+      continue;
+    }
+    object->setLinearVelocity({velocity(rng), velocity(rng), velocity(rng)});
+    object->setActive(true);
+  }
+
+  std::map<std::string, Observation> observations;
+  simulator->getAgentObservations(0, observations);
+
+  CORRADE_BENCHMARK(StepCount) {
+    simulator->stepWorld(1.0 / 60.0);
+    simulator->getAgentObservations(0, observations);
+  }
+#endif
+}
+
+const std::vector<std::string>& SimBenchmarkTest::batchKeyframes() {
+  if (!batchKeyframes_.empty()) {
+    return batchKeyframes_;
+  }
+
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  simConfig.enableGfxReplaySave = true;
+  simConfig.createRenderer = false;
+  simConfig.physicsConfigFile = physicsConfigFile;
+  auto sim = Simulator::create_unique(simConfig);
+
+  auto objAttrMgr = sim->getObjectAttributesManager();
+  objAttrMgr->loadAllJSONConfigsFromPath(
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/donut"), true);
+  const auto handles = objAttrMgr->getObjectHandlesBySubstring("donut");
+  CORRADE_INTERNAL_ASSERT(!handles.empty());
+
+  std::vector<esp::physics::ManagedRigidObject::ptr> objects;
+  for (int i = 0; i != 8; ++i) {
+    objects.push_back(
+        sim->getRigidObjectManager()->addBulletObjectByHandle(handles[0]));
+  }
+
+  // move the donuts kinematically, every keyframe after the first carries
+  // only the changed transformations
+  auto& recorder = *sim->getGfxReplayManager()->getRecorder();
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> offset{-0.05f, 0.05f};
+  for (int frame = 0; frame != KeyframeCount; ++frame) {
+    for (std::size_t i = 0; i != objects.size(); ++i) {
+      const Mn::Vector3 start{1.5f, 0.5f + 0.2f * i, -1.0f + 0.3f * i};
+      objects[i]->setTranslation(
+          start + Mn::Vector3{offset(rng), offset(rng), offset(rng)} * frame);
+      objects[i]->setRotation(Mn::Quaternion::rotation(
+          Mn::Deg(10.0f * frame + 30.0f * i), Mn::Vector3::yAxis()));
+    }
+    batchKeyframes_.push_back(
+        recorder.keyframeToString(recorder.extractKeyframe()));
+  }
+  return batchKeyframes_;
+}
+
+void SimBenchmarkTest::batchReplay() {
+  auto&& data = BatchReplayData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  const std::vector<std::string>& keyframes = batchKeyframes();
+
+  // the batch renderer produces both color and depth of each sensor
+  ReplayRendererConfiguration config;
+  config.sensorSpecifications = {cameraSpec("rgb", SensorType::Color, 64)};
+  config.numEnvironments = data.numEnvironments;
+  esp::sim::BatchReplayRenderer renderer{config};
+
+  std::vector<std::vector<char>> colorBuffers(data.numEnvironments);
+  std::vector<std::vector<char>> depthBuffers(data.numEnvironments);
+  std::vector<Mn::MutableImageView2D> colorViews;
+  std::vector<Mn::MutableImageView2D> depthViews;
+  for (unsigned envIndex = 0; envIndex != data.numEnvironments; ++envIndex) {
+    const Mn::Vector2i size = renderer.sensorSize(envIndex);
+    colorBuffers[envIndex].resize(std::size_t(size.product()) * 4);
+    depthBuffers[envIndex].resize(std::size_t(size.product()) * 4);
+    colorViews.emplace_back(Mn::PixelFormat::RGBA8Unorm, size,
+                            colorBuffers[envIndex]);
+    depthViews.emplace_back(Mn::PixelFormat::R32F, size,
+                            depthBuffers[envIndex]);
+  }
+
+  // the same motion in every environment, seen from a different camera
+  // orbiting the room center in each
+  const auto sensorTransform = [&](unsigned envIndex, int step) {
+    const Mn::Float angle =
+        360.0f * envIndex / data.numEnvironments + 2.0f * step;
+    return Mn::Matrix4::translation({1.0f, 1.3f, 0.0f}) *
+           Mn::Matrix4::rotationY(Mn::Deg(angle)) *
+           Mn::Matrix4::translation({0.0f, 0.0f, 2.5f});
+  };
+
+  // creating the instances and the first draw isn't measured
+  renderer.setEnvironmentKeyframes(
+      std::vector<std::string>(data.numEnvironments, keyframes[0]));
+  for (unsigned envIndex = 0; envIndex != data.numEnvironments; ++envIndex) {
+    renderer.setSensorTransform(envIndex, "rgb", sensorTransform(envIndex, 0));
+  }
+  renderer.render(colorViews, depthViews);
+
+  std::vector<std::string> stepKeyframes(data.numEnvironments);
+  int step = 1;
+  CORRADE_BENCHMARK(StepCount) {
+    for (std::string& keyframe : stepKeyframes) {
+      keyframe = keyframes[step];
+    }
+    renderer.setEnvironmentKeyframes(stepKeyframes);
+    for (unsigned envIndex = 0; envIndex != data.numEnvironments;
+         ++envIndex) {
+      renderer.setSensorTransform(envIndex, "rgb",
+                                  sensorTransform(envIndex, step));
+    }
+    renderer.render(colorViews, depthViews);
+    ++step;
+  }
+}
+
+void SimBenchmarkTest::sceneLoad() {
+  auto&& data = SceneLoadData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  SimulatorConfiguration simConfig{};
+  std::string requiredFile;
+  if (data.sceneDataset) {
+    simConfig.sceneDatasetConfigFile =
+        Cr::Utility::Path::join(DATA_DIR, data.sceneDataset);
+    simConfig.activeSceneName = data.scene;
+    requiredFile = simConfig.sceneDatasetConfigFile;
+  } else {
+    simConfig.activeSceneName =
+        Cr::Utility::Path::join(SCENE_DATASETS, data.scene);
+    requiredFile = simConfig.activeSceneName;
+  }
+  if (!Cr::Utility::Path::exists(requiredFile)) {
+    CORRADE_SKIP(requiredFile << "not found");
+  }
+#ifdef ESP_BUILD_WITH_BULLET
+  simConfig.enablePhysics = true;
+#endif
+  simConfig.physicsConfigFile = physicsConfigFile;
+
+  esp::core::Profiler& profiler = esp::core::Profiler::global();
+  const bool profilerWasEnabled = profiler.isEnabled();
+  profiler.setEnabled(true);
+  Simulator::uptr simulator;
+  CORRADE_BENCHMARK(1) {
+    simulator = Simulator::create_unique(simConfig);
+  }
+  profiler.setEnabled(profilerWasEnabled);
+
+  const std::vector<std::string> names =
+      simulator->getSceneLoadPerfStatNames();
+  const std::vector<float> values = simulator->getSceneLoadPerfStatValues();
+  CORRADE_COMPARE(values.size(), names.size());
+  std::string breakdown;
+  for (std::size_t i = 0; i != names.size(); ++i) {
+    breakdown +=
+        Cr::Utility::formatString("\n    {}: {:.1f}", names[i], values[i]);
+  }
+  CORRADE_INFO("Scene load breakdown:" << breakdown);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(SimBenchmarkTest)
@@ -2,7 +2,9 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -11,18 +13,29 @@
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/PixelFormat.h>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "esp/assets/Asset.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/Renderer.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/physics/RigidObject.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/NoiseModel.h"
 #include "esp/sim/Simulator.h"
+#include "esp/sim/VectorSimulator.h"
 
 #include "configure.h"
 
@@ -46,8 +59,10 @@ using esp::sensor::Observation;
 using esp::sensor::ObservationSpace;
 using esp::sensor::ObservationSpaceType;
 using esp::sensor::SensorType;
+using esp::sim::SceneStreamer;
 using esp::sim::Simulator;
 using esp::sim::SimulatorConfiguration;
+using esp::sim::VectorSimulator;
 
 namespace {
 using namespace Magnum::Math::Literals;
@@ -148,14 +163,39 @@ struct SimTest : Cr::TestSuite::Tester {
   void updateObjectLightSetupRGBAObservation();
   void multipleLightingSetupsRGBAObservation();
   void recomputeNavmeshWithStaticObjects();
+  void recomputeNavmeshTiled();
+  void recomputeNavmeshRegions();
   void loadingObjectTemplates();
   void buildingPrimAssetObjectTemplates();
   void addObjectByHandle();
   void addObjectInvertedScale();
   void addSensorToObject();
+  void sharedSensorRendering();
+  void depthPrePass();
+  void skipUnchangedFrames();
+  void asyncReadObservation();
+  void externalObservationBuffer();
+  void renderTargetPool();
+  void renderTargetNoiseModel();
+  void reducedObservationFormats();
+  void asyncAgentObservations();
+  void asyncDrawJobFences();
+  void sensorUpdatePeriod();
+  void downsampledObservations();
+  void vectorSimulator();
+  void pooledGlContexts();
+  void sceneStreamer();
   void createMagnumRenderingOff();
   void getRuntimePerfStats();
+  void getMemoryReport();
+  void actAgentsBatched();
+  void sampleRandomAgentStatesBatched();
   void testArticulatedObjectSkinned();
+  void testArticulatedObjectBatchedJointState();
+  void stepWorldsConcurrently();
+  void restoreStateSnapshot();
+  void physicsStateRollouts();
+  void castRaysBatched();
 
   esp::logging::LoggingContext loggingContext_;
   // TODO: remove outlier pixels from image and lower maxThreshold
@@ -195,18 +235,43 @@ SimTest::SimTest() {
             &SimTest::updateObjectLightSetupRGBAObservation,
             &SimTest::multipleLightingSetupsRGBAObservation,
             &SimTest::recomputeNavmeshWithStaticObjects,
+            &SimTest::recomputeNavmeshTiled,
+            &SimTest::recomputeNavmeshRegions,
             &SimTest::loadingObjectTemplates,
             &SimTest::buildingPrimAssetObjectTemplates,
             &SimTest::addObjectByHandle,
             &SimTest::addObjectInvertedScale,
             &SimTest::addSensorToObject,
             &SimTest::getRuntimePerfStats,
+            &SimTest::getMemoryReport,
+            &SimTest::actAgentsBatched,
+            &SimTest::sampleRandomAgentStatesBatched,
 #ifdef ESP_BUILD_WITH_BULLET
             &SimTest::createMagnumRenderingOff,
-            &SimTest::testArticulatedObjectSkinned
+            &SimTest::testArticulatedObjectSkinned,
+            &SimTest::testArticulatedObjectBatchedJointState,
+            &SimTest::stepWorldsConcurrently,
+            &SimTest::restoreStateSnapshot,
+            &SimTest::physicsStateRollouts,
+            &SimTest::castRaysBatched
 #endif
             }, Cr::Containers::arraySize(SimulatorBuilder) );
   // clang-format on
+  addTests({&SimTest::sharedSensorRendering,
+            &SimTest::depthPrePass,
+            &SimTest::skipUnchangedFrames,
+            &SimTest::asyncReadObservation,
+            &SimTest::externalObservationBuffer,
+            &SimTest::renderTargetPool,
+            &SimTest::renderTargetNoiseModel,
+            &SimTest::reducedObservationFormats,
+            &SimTest::asyncAgentObservations,
+            &SimTest::asyncDrawJobFences,
+            &SimTest::sensorUpdatePeriod,
+            &SimTest::downsampledObservations,
+            &SimTest::vectorSimulator,
+            &SimTest::pooledGlContexts,
+            &SimTest::sceneStreamer});
 }
 void SimTest::basic() {
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
@@ -524,6 +589,94 @@ void SimTest::recomputeNavmeshWithStaticObjects() {
       simulator->getPathFinder()->isNavigable(randomNavPoint + offset, 0.2));
 }
 
+void SimTest::recomputeNavmeshTiled() {
+  ESP_DEBUG() << "Starting Test : recomputeNavmeshTiled";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, skokloster, true, esp::NO_LIGHT_KEY);
+  PathFinder::ptr pathfinder = simulator->getPathFinder();
+
+  esp::nav::NavMeshSettings navMeshSettings;
+  navMeshSettings.setDefaults();
+  CORRADE_VERIFY(simulator->recomputeNavMesh(*pathfinder, navMeshSettings));
+  const float singleTileArea = pathfinder->getNavigableArea();
+
+  pathfinder->setBuildTiling(64, 4);
+  CORRADE_COMPARE(pathfinder->getBuildTileSize(), 64);
+  CORRADE_VERIFY(simulator->recomputeNavMesh(*pathfinder, navMeshSettings));
+  const float tiledArea = pathfinder->getNavigableArea();
+
+  // tile borders slightly change the tessellation but not the navigable area
+  CORRADE_COMPARE_WITH(tiledArea, singleTileArea,
+                       Cr::TestSuite::Compare::around(0.02f * singleTileArea));
+
+  // tiled navmeshes round trip through the same file format
+  const std::string navmeshFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "tiled_test.navmesh");
+  CORRADE_VERIFY(pathfinder->saveNavMesh(navmeshFile));
+  PathFinder reloaded;
+  CORRADE_VERIFY(reloaded.loadNavMesh(navmeshFile));
+  CORRADE_COMPARE(reloaded.getNavigableArea(), tiledArea);
+  CORRADE_COMPARE(reloaded.numIslands(), pathfinder->numIslands());
+  Cr::Utility::Path::remove(navmeshFile);
+
+  // single cell tiles exceed the tile budget of Detour, the build fails up
+  // front and keeps the current NavMesh
+  pathfinder->setBuildTiling(1, 4);
+  CORRADE_VERIFY(!simulator->recomputeNavMesh(*pathfinder, navMeshSettings));
+  CORRADE_VERIFY(pathfinder->isLoaded());
+  CORRADE_COMPARE(pathfinder->getNavigableArea(), tiledArea);
+}
+
+void SimTest::recomputeNavmeshRegions() {
+  ESP_DEBUG() << "Starting Test : recomputeNavmeshRegions";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, skokloster, true, esp::NO_LIGHT_KEY);
+  auto objectAttribsMgr = simulator->getObjectAttributesManager();
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  PathFinder::ptr pathfinder = simulator->getPathFinder();
+
+  // settings must stay the same for tiles to be rebuilt in place
+  esp::nav::NavMeshSettings navMeshSettings;
+  navMeshSettings.setDefaults();
+  navMeshSettings.includeStaticObjects = true;
+  pathfinder->setBuildTiling(64, 4);
+  CORRADE_VERIFY(simulator->recomputeNavMesh(*pathfinder, navMeshSettings));
+
+  esp::vec3f randomNavPoint = pathfinder->getRandomNavigablePoint();
+  while (pathfinder->distanceToClosestObstacle(randomNavPoint) < 1.0 ||
+         randomNavPoint[1] > 1.0) {
+    randomNavPoint = pathfinder->getRandomNavigablePoint();
+  }
+
+  auto objs = objectAttribsMgr->getObjectHandlesBySubstring("nested_box");
+  auto obj = rigidObjMgr->addObjectByHandle(objs[0]);
+  obj->setTranslation(Magnum::Vector3{randomNavPoint});
+  obj->setMotionType(esp::physics::MotionType::STATIC);
+  CORRADE_VERIFY(pathfinder->isNavigable(randomNavPoint, 0.1));
+
+  // only the tiles around the object are rebuilt
+  const Magnum::Range3D dirty = Magnum::Range3D::fromCenter(
+      Magnum::Vector3{randomNavPoint}, Magnum::Vector3{1.0f});
+  CORRADE_VERIFY(simulator->recomputeNavMeshRegions(*pathfinder,
+                                                    navMeshSettings, {dirty}));
+  CORRADE_VERIFY(!pathfinder->isNavigable(randomNavPoint, 0.1));
+
+  // the update matches a full rebuild of the changed scene
+  const float incrementalArea = pathfinder->getNavigableArea();
+  CORRADE_VERIFY(simulator->recomputeNavMesh(*pathfinder, navMeshSettings));
+  CORRADE_COMPARE_WITH(
+      incrementalArea, pathfinder->getNavigableArea(),
+      Cr::TestSuite::Compare::around(0.01f * incrementalArea));
+
+  // removing the object again restores the navigable area
+  rigidObjMgr->removePhysObjectByHandle(obj->getHandle());
+  CORRADE_VERIFY(simulator->recomputeNavMeshRegions(*pathfinder,
+                                                    navMeshSettings, {dirty}));
+  CORRADE_VERIFY(pathfinder->isNavigable(randomNavPoint, 0.1));
+}
+
 void SimTest::loadingObjectTemplates() {
   ESP_DEBUG() << "Starting Test : loadingObjectTemplates";
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
@@ -836,6 +989,897 @@ void SimTest::addSensorToObject() {
       (Mn::DebugTools::CompareImageToFile{maxThreshold, 0.75f}));
 }
 
+void SimTest::sharedSensorRendering() {
+  ESP_DEBUG() << "Starting Test : sharedSensorRendering";
+  // color, depth and semantic sensors at the same pose, with the same
+  // projection
+  std::vector<esp::sensor::SensorSpec::ptr> sensorSpecs;
+  for (const SensorType type :
+       {SensorType::Color, SensorType::Depth, SensorType::Semantic}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    sensorSpecs.push_back(spec);
+  }
+
+  struct Result {
+    int numPasses;
+    int numObservations;
+    std::vector<Cr::Containers::Array<uint8_t>> data;
+  };
+  auto render = [&](bool shared) {
+    SimulatorConfiguration simConfig{};
+    simConfig.activeSceneName = vangogh;
+    simConfig.enableSharedSensorRendering = shared;
+    auto simulator = Simulator::create_unique(simConfig);
+    AgentConfiguration agentConfig{};
+    agentConfig.sensorSpecifications = sensorSpecs;
+    simulator->addAgent(agentConfig);
+
+    Result result;
+    result.numPasses = simulator->drawAgentObservations(0);
+    std::map<std::string, Observation> observations;
+    result.numObservations =
+        simulator->getAgentObservations(0, observations);
+    for (const auto& spec : sensorSpecs) {
+      const auto& data = observations[spec->uuid].buffer->data;
+      result.data.emplace_back(Cr::NoInit, data.size());
+      Cr::Utility::copy(data, result.data.back());
+    }
+    return result;
+  };
+
+  const Result separate = render(false);
+  const Result shared = render(true);
+  CORRADE_COMPARE(separate.numPasses, 3);
+  CORRADE_COMPARE(shared.numPasses, 1);
+  CORRADE_COMPARE(separate.numObservations, 3);
+  CORRADE_COMPARE(shared.numObservations, 3);
+
+  // all observations are read from the single pass, and are identical to
+  // the ones drawn separately
+  for (std::size_t i = 0; i != sensorSpecs.size(); ++i) {
+    CORRADE_ITERATION(sensorSpecs[i]->uuid);
+    CORRADE_COMPARE_AS(shared.data[i], separate.data[i],
+                       Cr::TestSuite::Compare::Container);
+  }
+}
+
+void SimTest::depthPrePass() {
+  ESP_DEBUG() << "Starting Test : depthPrePass";
+  std::vector<esp::sensor::SensorSpec::ptr> sensorSpecs;
+  for (const SensorType type : {SensorType::Color, SensorType::Depth}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    sensorSpecs.push_back(spec);
+  }
+
+  auto render = [&](bool depthPrePass) {
+    SimulatorConfiguration simConfig{};
+    simConfig.activeSceneName = vangogh;
+    simConfig.enableDepthPrePass = depthPrePass;
+    auto simulator = Simulator::create_unique(simConfig);
+    CORRADE_COMPARE(
+        bool(simulator->getRenderer()->flags() &
+             esp::gfx::Renderer::Flag::DepthPrePass),
+        depthPrePass);
+    AgentConfiguration agentConfig{};
+    agentConfig.sensorSpecifications = sensorSpecs;
+    simulator->addAgent(agentConfig);
+
+    std::map<std::string, Observation> observations;
+    CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+    std::vector<Cr::Containers::Array<uint8_t>> result;
+    for (const auto& spec : sensorSpecs) {
+      const auto& data = observations[spec->uuid].buffer->data;
+      result.emplace_back(Cr::NoInit, data.size());
+      Cr::Utility::copy(data, result.back());
+    }
+    return result;
+  };
+
+  const auto reference = render(false);
+  const auto prePass = render(true);
+
+  // depth sensors don't use the pre-pass, their output is unchanged
+  CORRADE_COMPARE_AS(prePass[1], reference[1],
+                     Cr::TestSuite::Compare::Container);
+
+  // the color pass shades the same surfaces, only pixels where surfaces are
+  // nearly coplanar may resolve differently
+  CORRADE_COMPARE(prePass[0].size(), reference[0].size());
+  std::size_t numDifferent = 0;
+  for (std::size_t i = 0; i != reference[0].size(); ++i) {
+    if (std::abs(int(prePass[0][i]) - int(reference[0][i])) > 2) {
+      ++numDifferent;
+    }
+  }
+  CORRADE_COMPARE_AS(numDifferent, reference[0].size() / 100,
+                     Cr::TestSuite::Compare::LessOrEqual);
+}
+
+void SimTest::skipUnchangedFrames() {
+  ESP_DEBUG() << "Starting Test : skipUnchangedFrames";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  simConfig.skipUnchangedFrames = true;
+  auto simulator = Simulator::create_unique(simConfig);
+  CORRADE_VERIFY(simulator->getRenderer()->flags() &
+                 esp::gfx::Renderer::Flag::SkipUnchangedFrames);
+
+  AgentConfiguration agentConfig{};
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = "camera";
+  spec->resolution = {64, 64};
+  agentConfig.sensorSpecifications.push_back(spec);
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensors().at("camera").get());
+
+  std::map<std::string, Observation> observations;
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  const esp::core::Buffer::ptr first = observations["camera"].buffer;
+  Cr::Containers::Array<uint8_t> reference{Cr::NoInit, first->data.size()};
+  Cr::Utility::copy(first->data, reference);
+
+  // nothing changed, the last observation is returned as-is
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(sensor.isObservationUnchanged());
+  CORRADE_COMPARE_AS(observations["camera"].buffer->data, reference,
+                     Cr::TestSuite::Compare::Container);
+
+  // an object behind the camera is culled, so the frame is still unchanged
+  const Mn::Vector3 agentPosition = agent->node().absoluteTranslation();
+  auto obj = simulator->getRigidObjectManager()->addObjectByHandle(
+      Cr::Utility::Path::join(TEST_ASSETS,
+                              "objects/nested_box.object_config.json"));
+  CORRADE_VERIFY(obj);
+  obj->setTranslation(agentPosition + Mn::Vector3{0.0f, 1.5f, 5.0f});
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(sensor.isObservationUnchanged());
+
+  // moving it in front of the camera is drawn
+  obj->setTranslation(agentPosition + Mn::Vector3{0.0f, 1.5f, -1.0f});
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(sensor.isObservationUnchanged());
+
+  // drawables outside of the default group are tracked as well
+  auto& sceneGraph = simulator->getActiveSceneGraph();
+  esp::gfx::DrawableGroup* extraDrawables =
+      sceneGraph.createDrawableGroup("skipUnchangedFrames");
+  CORRADE_VERIFY(extraDrawables);
+  const std::vector<esp::scene::SceneNode*> visualNodes =
+      obj->getVisualSceneNodes();
+  std::vector<esp::gfx::Drawable*> objDrawables;
+  for (std::size_t i = 0; i != simulator->getDrawableGroup().size(); ++i) {
+    auto& drawable =
+        static_cast<esp::gfx::Drawable&>(simulator->getDrawableGroup()[i]);
+    if (std::find(visualNodes.begin(), visualNodes.end(),
+                  &drawable.getSceneNode()) != visualNodes.end()) {
+      objDrawables.push_back(&drawable);
+    }
+  }
+  CORRADE_VERIFY(!objDrawables.empty());
+  for (esp::gfx::Drawable* drawable : objDrawables) {
+    simulator->getDrawableGroup().remove(*drawable);
+    extraDrawables->add(*drawable);
+  }
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  obj->setTranslation(agentPosition + Mn::Vector3{0.2f, 1.5f, -1.0f});
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(sensor.isObservationUnchanged());
+
+  // so are a new light setup and a moved camera
+  simulator->setLightSetup(lightSetup1);
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  agent->node().translate({0.1f, 0.0f, 0.0f});
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+
+  // and anything after an explicit reset
+  sensor.resetObservationCache();
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+
+  // render target noise is new in every frame, so nothing is skipped
+  spec->renderTargetNoiseModel = esp::sensor::RgbNoiseModel::create(
+      esp::sensor::RgbNoiseModel::Type::Gaussian, 7);
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  Cr::Utility::copy(observations["camera"].buffer->data, reference);
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 1);
+  CORRADE_VERIFY(!sensor.isObservationUnchanged());
+  CORRADE_VERIFY(!std::equal(reference.begin(), reference.end(),
+                             observations["camera"].buffer->data.begin()));
+}
+
+void SimTest::asyncReadObservation() {
+  ESP_DEBUG() << "Starting Test : asyncReadObservation";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  for (const SensorType type :
+       {SensorType::Color, SensorType::Depth, SensorType::Semantic}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+
+  for (const auto& spec : agentConfig.sensorSpecifications) {
+    CORRADE_ITERATION(spec->uuid);
+    auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get(spec->uuid));
+
+    Observation observation;
+    CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+    Cr::Containers::Array<uint8_t> expected{Cr::NoInit,
+                                            observation.buffer->data.size()};
+    Cr::Utility::copy(observation.buffer->data, expected);
+
+    // more reads in flight than there are pixel buffers, drawing a frame
+    // after each of them
+    std::vector<esp::sensor::VisualSensor::AsyncObservation> reads;
+    for (std::size_t i = 0;
+         i != esp::gfx::RenderTarget::AsyncReadBufferCount + 1; ++i) {
+      CORRADE_VERIFY(sensor.drawObservation(*simulator));
+      reads.push_back(sensor.readObservationAsync());
+    }
+    CORRADE_VERIFY(
+        !sensor.finishReadObservation(
+            esp::sensor::VisualSensor::AsyncObservation{}, observation));
+
+    // the oldest read was invalidated, the others give the same observation
+    for (std::size_t i = 1; i != reads.size(); ++i) {
+      CORRADE_ITERATION(i);
+      for (uint8_t& byte : observation.buffer->data) {
+        byte = 0;
+      }
+      CORRADE_VERIFY(sensor.finishReadObservation(reads[i], observation));
+      CORRADE_COMPARE_AS(observation.buffer->data, expected,
+                         Cr::TestSuite::Compare::Container);
+    }
+  }
+}
+
+void SimTest::externalObservationBuffer() {
+  ESP_DEBUG() << "Starting Test : externalObservationBuffer";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  auto spec = CameraSensorSpec::create();
+  spec->position = {1.0f, 1.5f, 1.0f};
+  spec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {spec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get(spec->uuid));
+
+  Observation observation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  Cr::Containers::Array<uint8_t> expected{Cr::NoInit,
+                                          observation.buffer->data.size()};
+  Cr::Utility::copy(observation.buffer->data, expected);
+
+  // the observation is written into memory owned by the caller
+  Cr::Containers::Array<uint8_t> external{Cr::ValueInit, expected.size()};
+  sensor.setObservationBuffer(external);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE(observation.buffer->data.data(), external.data());
+  CORRADE_COMPARE_AS(external, expected, Cr::TestSuite::Compare::Container);
+
+  // and into a buffer of the sensor again once reset
+  sensor.setObservationBuffer(nullptr);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_VERIFY(observation.buffer->data.data() != external.data());
+  CORRADE_COMPARE_AS(observation.buffer->data, expected,
+                     Cr::TestSuite::Compare::Container);
+}
+
+void SimTest::renderTargetPool() {
+  ESP_DEBUG() << "Starting Test : renderTargetPool";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+  esp::gfx::Renderer& renderer = *simulator->getRenderer();
+
+  auto spec = CameraSensorSpec::create();
+  spec->position = {1.0f, 1.5f, 1.0f};
+  spec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {spec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get(spec->uuid));
+
+  Observation observation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  Cr::Containers::Array<uint8_t> expected{Cr::NoInit,
+                                          observation.buffer->data.size()};
+  Cr::Utility::copy(observation.buffer->data, expected);
+  esp::gfx::RenderTarget* const original = &sensor.renderTarget();
+  CORRADE_COMPARE(renderer.pooledRenderTargetCount(), 0);
+
+  // binding the same size again keeps the render target
+  renderer.bindRenderTarget(sensor);
+  CORRADE_COMPARE(&sensor.renderTarget(), original);
+  CORRADE_COMPARE(renderer.pooledRenderTargetCount(), 0);
+
+  // a different size gets a new one, the original is kept for reuse
+  sensor.setResolution(64, 96);
+  renderer.bindRenderTarget(sensor);
+  CORRADE_COMPARE(sensor.renderTarget().framebufferSize(),
+                  (Mn::Vector2i{96, 64}));
+  CORRADE_COMPARE(renderer.pooledRenderTargetCount(), 1);
+
+  // and switching back reuses it and renders the same
+  sensor.setResolution(128, 128);
+  renderer.bindRenderTarget(sensor);
+  CORRADE_COMPARE(&sensor.renderTarget(), original);
+  CORRADE_COMPARE(renderer.pooledRenderTargetCount(), 1);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE_AS(observation.buffer->data, expected,
+                     Cr::TestSuite::Compare::Container);
+
+  renderer.clearRenderTargetPool();
+  CORRADE_COMPARE(renderer.pooledRenderTargetCount(), 0);
+}
+
+void SimTest::renderTargetNoiseModel() {
+  ESP_DEBUG() << "Starting Test : renderTargetNoiseModel";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  auto noiseModel = esp::sensor::RgbNoiseModel::create(
+      esp::sensor::RgbNoiseModel::Type::Gaussian, 7);
+  auto spec = CameraSensorSpec::create();
+  spec->position = {1.0f, 1.5f, 1.0f};
+  spec->resolution = {128, 128};
+  spec->renderTargetNoiseModel = noiseModel;
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {spec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get(spec->uuid));
+
+  Observation observation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE(noiseModel->frame(), 1);
+  Cr::Containers::Array<uint8_t> noisy{Cr::NoInit,
+                                       observation.buffer->data.size()};
+  Cr::Utility::copy(observation.buffer->data, noisy);
+
+  // the same seed gives the same noise
+  noiseModel->setSeed(7);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE_AS(observation.buffer->data, noisy,
+                     Cr::TestSuite::Compare::Container);
+
+  // the next frame gets different noise
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_VERIFY(!std::equal(noisy.begin(), noisy.end(),
+                             observation.buffer->data.begin()));
+
+  // and the clean image differs from the noisy one
+  spec->renderTargetNoiseModel = nullptr;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_VERIFY(!std::equal(noisy.begin(), noisy.end(),
+                             observation.buffer->data.begin()));
+  CORRADE_COMPARE(noiseModel->frame(), 2);
+}
+
+void SimTest::reducedObservationFormats() {
+  ESP_DEBUG() << "Starting Test : reducedObservationFormats";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  // pairs of co-located sensors reading the default and the reduced format
+  const struct {
+    SensorType type;
+    esp::sensor::ObservationFormat format;
+  } formats[]{
+      {SensorType::Color, esp::sensor::ObservationFormat::RGB8},
+      {SensorType::Depth, esp::sensor::ObservationFormat::DepthHalf},
+      {SensorType::Depth, esp::sensor::ObservationFormat::DepthUnorm16},
+      {SensorType::Semantic,
+       esp::sensor::ObservationFormat::SemanticUnsignedShort},
+  };
+  AgentConfiguration agentConfig{};
+  for (std::size_t i = 0; i != Cr::Containers::arraySize(formats); ++i) {
+    for (const bool reduced : {false, true}) {
+      auto spec = CameraSensorSpec::create();
+      spec->uuid = "camera" + std::to_string(i) + (reduced ? "reduced" : "");
+      spec->sensorType = formats[i].type;
+      spec->position = {1.0f, 1.5f, 1.0f};
+      spec->resolution = {97, 131};
+      spec->far = 10.0f;
+      if (reduced) {
+        spec->observationFormat = formats[i].format;
+      }
+      agentConfig.sensorSpecifications.push_back(spec);
+    }
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+
+  for (std::size_t i = 0; i != Cr::Containers::arraySize(formats); ++i) {
+    CORRADE_ITERATION(i);
+    auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get("camera" + std::to_string(i)));
+    auto& reducedSensor = static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get("camera" + std::to_string(i) +
+                                           "reduced"));
+    Observation observation;
+    Observation reducedObservation;
+    CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+    CORRADE_VERIFY(
+        reducedSensor.getObservation(*simulator, reducedObservation));
+
+    ObservationSpace space;
+    CORRADE_VERIFY(reducedSensor.getObservationSpace(space));
+    CORRADE_COMPARE(reducedObservation.buffer->shape, space.shape);
+    const std::size_t pixelCount = 97 * 131;
+
+    switch (formats[i].format) {
+      case esp::sensor::ObservationFormat::RGB8: {
+        const auto rgba = Cr::Containers::arrayCast<const Mn::Color4ub>(
+            observation.buffer->data);
+        const auto rgb = Cr::Containers::arrayCast<const Mn::Color3ub>(
+            reducedObservation.buffer->data);
+        CORRADE_COMPARE(rgb.size(), pixelCount);
+        for (std::size_t j = 0; j != pixelCount; ++j) {
+          CORRADE_COMPARE(rgb[j], rgba[j].rgb());
+        }
+      } break;
+      case esp::sensor::ObservationFormat::DepthHalf:
+      case esp::sensor::ObservationFormat::DepthUnorm16: {
+        const auto depth = Cr::Containers::arrayCast<const Mn::Float>(
+            observation.buffer->data);
+        const auto reduced = Cr::Containers::arrayCast<const Mn::UnsignedShort>(
+            reducedObservation.buffer->data);
+        CORRADE_COMPARE(reduced.size(), pixelCount);
+        for (std::size_t j = 0; j != pixelCount; ++j) {
+          const Mn::Float unpacked =
+              formats[i].format == esp::sensor::ObservationFormat::DepthHalf
+                  ? Mn::Math::unpackHalf(reduced[j])
+                  : Mn::Math::unpack<Mn::Float>(reduced[j]) * 10.0f;
+          CORRADE_COMPARE_WITH(unpacked, depth[j],
+                               Cr::TestSuite::Compare::around(
+                                   depth[j] * 0.001f + 0.001f));
+        }
+      } break;
+      case esp::sensor::ObservationFormat::SemanticUnsignedShort: {
+        const auto ids = Cr::Containers::arrayCast<const Mn::UnsignedInt>(
+            observation.buffer->data);
+        const auto reduced = Cr::Containers::arrayCast<const Mn::UnsignedShort>(
+            reducedObservation.buffer->data);
+        CORRADE_COMPARE(reduced.size(), pixelCount);
+        for (std::size_t j = 0; j != pixelCount; ++j) {
+          if (ids[j] <= 0xffff) {
+            CORRADE_COMPARE(reduced[j], ids[j]);
+          }
+        }
+      } break;
+      case esp::sensor::ObservationFormat::Default:
+        CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    }
+  }
+}
+
+void SimTest::asyncAgentObservations() {
+  ESP_DEBUG() << "Starting Test : asyncAgentObservations";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  for (const SensorType type : {SensorType::Color, SensorType::Depth}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+
+  auto copyObservations =
+      [&](const std::map<std::string, Observation>& observations) {
+        std::vector<Cr::Containers::Array<uint8_t>> data;
+        for (const auto& spec : agentConfig.sensorSpecifications) {
+          const auto& buffer = observations.at(spec->uuid).buffer->data;
+          data.emplace_back(Cr::NoInit, buffer.size());
+          Cr::Utility::copy(buffer, data.back());
+        }
+        return data;
+      };
+
+  std::map<std::string, Observation> observations;
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+  const std::vector<Cr::Containers::Array<uint8_t>> expected =
+      copyObservations(observations);
+
+  simulator->startAsyncAgentObservations(0);
+  CORRADE_VERIFY(simulator->asyncAgentObservationsInFlight());
+  // moving the agent while the frame is drawn doesn't change what it sees
+  agent->node().translate({0.0f, 0.0f, 1.0f});
+  simulator->stepWorld();
+  CORRADE_COMPARE(simulator->finishAsyncAgentObservations(observations), 2);
+  CORRADE_VERIFY(!simulator->asyncAgentObservationsInFlight());
+  const std::vector<Cr::Containers::Array<uint8_t>> pipelined =
+      copyObservations(observations);
+  for (std::size_t i = 0; i != expected.size(); ++i) {
+    CORRADE_ITERATION(agentConfig.sensorSpecifications[i]->uuid);
+    CORRADE_COMPARE_AS(pipelined[i], expected[i],
+                       Cr::TestSuite::Compare::Container);
+  }
+
+  // the next frame sees the new pose
+  simulator->startAsyncAgentObservations(0);
+  CORRADE_COMPARE(simulator->finishAsyncAgentObservations(observations), 2);
+  const std::vector<Cr::Containers::Array<uint8_t>> moved =
+      copyObservations(observations);
+  CORRADE_VERIFY(!std::equal(moved[0].begin(), moved[0].end(),
+                             expected[0].begin(), expected[0].end()));
+}
+
+void SimTest::asyncDrawJobFences() {
+#ifndef ESP_BUILD_WITH_BACKGROUND_RENDERER
+  CORRADE_SKIP("Built without the background renderer");
+#else
+  ESP_DEBUG() << "Starting Test : asyncDrawJobFences";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  for (const SensorType type : {SensorType::Color, SensorType::Depth}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  esp::gfx::Renderer& renderer = *simulator->getRenderer();
+
+  std::vector<Observation> observations(2);
+  std::vector<Cr::Containers::Array<uint8_t>> expected;
+  for (std::size_t i = 0; i != observations.size(); ++i) {
+    auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get(
+            agentConfig.sensorSpecifications[i]->uuid));
+    CORRADE_VERIFY(sensor.getObservation(*simulator, observations[i]));
+    expected.emplace_back(Cr::NoInit, observations[i].buffer->data.size());
+    Cr::Utility::copy(observations[i].buffer->data, expected.back());
+  }
+
+  // both sensors are drawn in one frame, in the order they were enqueued
+  std::vector<Mn::MutableImageView2D> views;
+  for (std::size_t i = 0; i != observations.size(); ++i) {
+    auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get(
+            agentConfig.sensorSpecifications[i]->uuid));
+    views.push_back(sensor.observationView(observations[i]));
+    for (uint8_t& byte : observations[i].buffer->data) {
+      byte = 0;
+    }
+    CORRADE_COMPARE(renderer.enqueueAsyncDrawJob(
+                        sensor, simulator->getActiveSceneGraph(), views.back()),
+                    int(i));
+  }
+  renderer.snapshotDrawJobs();
+  renderer.startDrawJobs();
+
+  // the color observation is complete on its own
+  renderer.waitDrawJob(0);
+  CORRADE_VERIFY(renderer.isDrawJobDone(0));
+  CORRADE_COMPARE_AS(observations[0].buffer->data, expected[0],
+                     Cr::TestSuite::Compare::Container);
+
+  renderer.waitDrawJobs();
+  CORRADE_VERIFY(renderer.isDrawJobDone(1));
+  CORRADE_COMPARE_AS(observations[1].buffer->data, expected[1],
+                     Cr::TestSuite::Compare::Container);
+#endif
+}
+
+void SimTest::sensorUpdatePeriod() {
+  ESP_DEBUG() << "Starting Test : sensorUpdatePeriod";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  for (const int updatePeriod : {1, 3}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(updatePeriod);
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {128, 128};
+    spec->updatePeriod = updatePeriod;
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+
+  std::map<std::string, Observation> observations;
+  auto copyObservation = [&](const std::string& uuid) {
+    const auto& buffer = observations.at(uuid).buffer->data;
+    Cr::Containers::Array<uint8_t> data{Cr::NoInit, buffer.size()};
+    Cr::Utility::copy(buffer, data);
+    return data;
+  };
+  auto changed = [&](const std::string& uuid,
+                     const Cr::Containers::Array<uint8_t>& previous) {
+    const auto& buffer = observations.at(uuid).buffer->data;
+    return !std::equal(buffer.begin(), buffer.end(), previous.begin(),
+                       previous.end());
+  };
+
+  // all sensors are due in the first call
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+  Cr::Containers::Array<uint8_t> every = copyObservation("camera1");
+  Cr::Containers::Array<uint8_t> third = copyObservation("camera3");
+
+  // the second and third call return the first observation of camera3
+  for (int call : {2, 3}) {
+    CORRADE_ITERATION(call);
+    agent->node().translate({0.0f, 0.0f, 0.5f});
+    CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+    CORRADE_VERIFY(changed("camera1", every));
+    CORRADE_VERIFY(!changed("camera3", third));
+    every = copyObservation("camera1");
+  }
+
+  // the fourth call updates it again
+  agent->node().translate({0.0f, 0.0f, 0.5f});
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+  CORRADE_VERIFY(changed("camera3", third));
+  third = copyObservation("camera3");
+
+  // and so does the next one after a reset of its schedule
+  agent->node().translate({0.0f, 0.0f, 0.5f});
+  agent->getSubtreeSensors().at("camera3").get().resetUpdateSchedule();
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 2);
+  CORRADE_VERIFY(changed("camera3", third));
+}
+
+void SimTest::downsampledObservations() {
+  ESP_DEBUG() << "Starting Test : downsampledObservations";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  auto simulator = Simulator::create_unique(simConfig);
+
+  AgentConfiguration agentConfig{};
+  for (const SensorType type : {SensorType::Color, SensorType::Depth}) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "camera" + std::to_string(int(type));
+    spec->sensorType = type;
+    spec->position = {1.0f, 1.5f, 1.0f};
+    spec->resolution = {96, 128};
+    spec->downsampleLevels = 2;
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  simulator->addAgent(agentConfig);
+
+  std::map<std::string, Observation> observations;
+  CORRADE_COMPARE(simulator->getAgentObservations(0, observations), 6);
+
+  const std::string color = "camera" + std::to_string(int(SensorType::Color));
+  const std::string depth = "camera" + std::to_string(int(SensorType::Depth));
+  CORRADE_COMPARE(observations.at(color + "_level1").buffer->shape,
+                  (std::vector<size_t>{48, 64, 4}));
+  CORRADE_COMPARE(observations.at(color + "_level2").buffer->shape,
+                  (std::vector<size_t>{24, 32, 4}));
+  CORRADE_COMPARE(observations.at(depth + "_level2").buffer->shape,
+                  (std::vector<size_t>{24, 32, 1}));
+
+  // color averages 2x2 blocks of the level above
+  {
+    const auto full = Cr::Containers::arrayCast<const Mn::Color4ub>(
+        observations.at(color).buffer->data);
+    const auto half = Cr::Containers::arrayCast<const Mn::Color4ub>(
+        observations.at(color + "_level1").buffer->data);
+    for (std::size_t y = 0; y != 48; ++y) {
+      for (std::size_t x = 0; x != 64; ++x) {
+        Mn::Vector4 sum;
+        for (std::size_t i : {0, 1}) {
+          for (std::size_t j : {0, 1}) {
+            sum += Mn::Vector4{full[(2 * y + i) * 128 + 2 * x + j]};
+          }
+        }
+        const Mn::Vector4 average = sum / 4.0f;
+        const Mn::Vector4 downsampled{half[y * 64 + x]};
+        CORRADE_ITERATION(x << y);
+        CORRADE_COMPARE_AS((Mn::Math::abs(downsampled - average)).max(), 1.5f,
+                           Cr::TestSuite::Compare::LessOrEqual);
+      }
+    }
+  }
+
+  // depth picks one value of each block instead
+  {
+    const auto full = Cr::Containers::arrayCast<const Mn::Float>(
+        observations.at(depth).buffer->data);
+    const auto half = Cr::Containers::arrayCast<const Mn::Float>(
+        observations.at(depth + "_level1").buffer->data);
+    for (std::size_t y = 0; y != 48; ++y) {
+      for (std::size_t x = 0; x != 64; ++x) {
+        bool found = false;
+        for (std::size_t i : {0, 1}) {
+          for (std::size_t j : {0, 1}) {
+            found |= full[(2 * y + i) * 128 + 2 * x + j] == half[y * 64 + x];
+          }
+        }
+        CORRADE_ITERATION(x << y);
+        CORRADE_VERIFY(found);
+      }
+    }
+  }
+}
+
+void SimTest::pooledGlContexts() {
+  ESP_DEBUG() << "Starting Test : pooledGlContexts";
+  esp::gfx::WindowlessContext::clearPool();
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  simConfig.poolGlContexts = true;
+
+  AgentConfiguration agentConfig{};
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = "camera";
+  spec->resolution = {64, 64};
+  agentConfig.sensorSpecifications.push_back(spec);
+
+  std::map<std::string, Observation> first;
+  {
+    auto simulator = Simulator::create_unique(simConfig);
+    simulator->addAgent(agentConfig);
+    CORRADE_COMPARE(simulator->getAgentObservations(0, first), 1);
+  }
+  // the context went back to the pool instead of being destroyed
+  CORRADE_COMPARE(esp::gfx::WindowlessContext::pooledContextCount(), 1);
+
+  // a new simulator takes it again and renders the same
+  {
+    auto simulator = Simulator::create_unique(simConfig);
+    CORRADE_COMPARE(esp::gfx::WindowlessContext::pooledContextCount(), 0);
+    simulator->addAgent(agentConfig);
+    std::map<std::string, Observation> second;
+    CORRADE_COMPARE(simulator->getAgentObservations(0, second), 1);
+    CORRADE_COMPARE_AS(second.at("camera").buffer->data,
+                       first.at("camera").buffer->data,
+                       Cr::TestSuite::Compare::Container);
+
+    // closing without destroying gives it back as well
+    simulator->close(false);
+    CORRADE_COMPARE(esp::gfx::WindowlessContext::pooledContextCount(), 1);
+  }
+  esp::gfx::WindowlessContext::clearPool();
+  CORRADE_COMPARE(esp::gfx::WindowlessContext::pooledContextCount(), 0);
+}
+
+void SimTest::sceneStreamer() {
+  ESP_DEBUG() << "Starting Test : sceneStreamer";
+  SceneStreamer streamer{2.0f};
+  // two instances in cell (0, 0), one in (4, 0), one in (-2, 0)
+  CORRADE_COMPARE(streamer.addInstance({1.0f, 0.0f, 1.0f}), 0);
+  CORRADE_COMPARE(streamer.addInstance({1.5f, 5.0f, 0.5f}), 1);
+  CORRADE_COMPARE(streamer.addInstance({9.0f, 0.0f, 1.0f}), 2);
+  CORRADE_COMPARE(streamer.addInstance({-3.0f, 0.0f, 1.0f}), 3);
+  CORRADE_COMPARE(streamer.instanceCount(), 4);
+  CORRADE_COMPARE(streamer.cellCount(), 3);
+  CORRADE_VERIFY(!streamer.isLoaded(0));
+
+  // the viewer's own cell gets loaded, the cell one cell beyond the radius
+  // prefetched
+  SceneStreamer::Update update = streamer.update({{1.0f, 0.0f, 1.0f}}, 1.0f);
+  CORRADE_COMPARE_AS(update.load, (std::vector<std::size_t>{0, 1}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(update.prefetch, (std::vector<std::size_t>{3}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_VERIFY(update.unload.empty());
+  CORRADE_VERIFY(streamer.isLoaded(1));
+  CORRADE_VERIFY(!streamer.isLoaded(3));
+
+  // nothing changed, nothing reported again
+  update = streamer.update({{1.0f, 0.0f, 1.0f}}, 1.0f);
+  CORRADE_VERIFY(update.load.empty());
+  CORRADE_VERIFY(update.prefetch.empty());
+  CORRADE_VERIFY(update.unload.empty());
+
+  // moving far away loads the new cell and unloads the old one
+  update = streamer.update({{9.0f, 0.0f, 1.0f}}, 1.0f);
+  CORRADE_COMPARE_AS(update.load, (std::vector<std::size_t>{2}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(update.unload, (std::vector<std::size_t>{0, 1}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(streamer.loadedCellCount(), 1);
+
+  // stepping just out of the load radius keeps the cell loaded
+  update = streamer.update({{6.0f, 0.0f, 1.0f}}, 1.0f);
+  CORRADE_VERIFY(update.unload.empty());
+  CORRADE_VERIFY(streamer.isLoaded(2));
+
+  // two viewers keep both of their cells loaded
+  update = streamer.update({{6.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}}, 1.0f);
+  CORRADE_COMPARE_AS(update.load, (std::vector<std::size_t>{0, 1}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(streamer.loadedCellCount(), 2);
+
+  // without viewers everything is unloaded
+  update = streamer.update({}, 1.0f);
+  CORRADE_COMPARE_AS(update.unload, (std::vector<std::size_t>{0, 1, 2}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(streamer.loadedCellCount(), 0);
+}
+
+void SimTest::vectorSimulator() {
+  ESP_DEBUG() << "Starting Test : vectorSimulator";
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = vangogh;
+  VectorSimulator vectorSim{simConfig, 3, 2};
+  CORRADE_COMPARE(vectorSim.numEnvironments(), 3);
+  CORRADE_COMPARE(vectorSim.numThreads(), 2);
+
+  AgentConfiguration agentConfig{};
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = "camera";
+  spec->position = {1.0f, 1.5f, 1.0f};
+  spec->resolution = {128, 128};
+  agentConfig.sensorSpecifications.push_back(spec);
+  const std::vector<Agent::ptr> agents = vectorSim.addAgents(agentConfig);
+  CORRADE_COMPARE(agents.size(), 3);
+  AgentState state;
+  for (const Agent::ptr& agent : agents) {
+    agent->setState(state);
+  }
+
+  // a standalone simulator not sharing anything is the reference
+  auto reference = Simulator::create_unique(simConfig);
+  reference->addAgent(agentConfig)->setState(state);
+  reference->getAgent(0)->act("moveForward");
+  std::map<std::string, Observation> expected;
+  CORRADE_COMPARE(reference->getAgentObservations(0, expected), 1);
+
+  vectorSim.step({"moveForward", "", "turnLeft"});
+  std::vector<std::map<std::string, Observation>> observations;
+  CORRADE_COMPARE(vectorSim.getObservations(0, observations), 3);
+  CORRADE_COMPARE(observations.size(), 3);
+  const auto& expectedData = expected.at("camera").buffer->data;
+  CORRADE_COMPARE_AS(observations[0].at("camera").buffer->data, expectedData,
+                     Cr::TestSuite::Compare::Container);
+  // the other agents didn't move the same way, so they see something else
+  for (std::size_t i : {1, 2}) {
+    CORRADE_ITERATION(i);
+    const auto& data = observations[i].at("camera").buffer->data;
+    CORRADE_VERIFY(!std::equal(data.begin(), data.end(), expectedData.begin(),
+                               expectedData.end()));
+  }
+
+  vectorSim.close();
+  CORRADE_COMPARE(vectorSim.numEnvironments(), 0);
+}
+
 void SimTest::createMagnumRenderingOff() {
   ESP_DEBUG() << "Starting Test : createMagnumRenderingOff";
 
@@ -930,6 +1974,84 @@ void SimTest::createMagnumRenderingOff() {
   CORRADE_VERIFY(!cameraSensor.getObservation(*simulator, observation));
 }
 
+void SimTest::actAgentsBatched() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  AgentConfiguration agentConfig{};
+  Agent::ptr first = simulator->addAgent(agentConfig);
+  Agent::ptr second = simulator->addAgent(agentConfig);
+  const std::vector<std::string> names = first->getActionNames();
+  const int moveForward =
+      std::find(names.begin(), names.end(), "moveForward") - names.begin();
+  const int turnLeft =
+      std::find(names.begin(), names.end(), "turnLeft") - names.begin();
+  CORRADE_VERIFY(moveForward < int(names.size()));
+  CORRADE_VERIFY(turnLeft < int(names.size()));
+
+  // the second agent retraces the batched moves of the first one with act(),
+  // walking into walls to exercise the sliding as well
+  auto firstState = AgentState::create();
+  auto secondState = AgentState::create();
+  first->getState(firstState);
+  second->setState(*firstState);
+  for (int i = 0; i != 40; ++i) {
+    const int action = i % 8 == 7 ? turnLeft : moveForward;
+    const std::vector<bool> performed =
+        simulator->actAgents({action, esp::ID_UNDEFINED});
+    CORRADE_COMPARE(performed, (std::vector<bool>{true, false}));
+    CORRADE_VERIFY(second->act(names[action]));
+
+    first->getState(firstState);
+    second->getState(secondState);
+    CORRADE_VERIFY(firstState->position.isApprox(secondState->position));
+    CORRADE_VERIFY(firstState->rotation.isApprox(secondState->rotation));
+  }
+
+  // out of range indices are skipped
+  CORRADE_COMPARE(simulator->actAgents({int(names.size()), 0}),
+                  (std::vector<bool>{false, true}));
+  CORRADE_VERIFY(!first->act(int(names.size())));
+}
+
+void SimTest::sampleRandomAgentStatesBatched() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+  PathFinder::ptr pathfinder = simulator->getPathFinder();
+  CORRADE_VERIFY(pathfinder->isLoaded());
+
+  simulator->seed(7);
+  const std::vector<AgentState> states =
+      simulator->sampleRandomAgentStates(64, 0.5f, 0.2f, esp::ID_UNDEFINED,
+                                         20, 4);
+  CORRADE_COMPARE(states.size(), 64);
+  for (const AgentState& state : states) {
+    CORRADE_VERIFY(pathfinder->isNavigable(state.position));
+    CORRADE_COMPARE_AS(pathfinder->distanceToClosestObstacle(state.position),
+                       0.2f, Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(pathfinder->getNavigableArea(
+                           pathfinder->getIsland(state.position)),
+                       0.5f, Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(esp::quatf(state.rotation.data()).norm(), 1.0f);
+  }
+
+  // the result only depends on the seed
+  simulator->seed(7);
+  const std::vector<AgentState> serialStates =
+      simulator->sampleRandomAgentStates(64, 0.5f, 0.2f, esp::ID_UNDEFINED,
+                                         20, 1);
+  CORRADE_COMPARE(serialStates.size(), states.size());
+  for (std::size_t i = 0; i != states.size(); ++i) {
+    CORRADE_COMPARE(serialStates[i].position, states[i].position);
+    CORRADE_COMPARE(serialStates[i].rotation, states[i].rotation);
+  }
+
+  // filters no point passes leave the batch empty
+  CORRADE_VERIFY(simulator->sampleRandomAgentStates(8, 1.0e6f).empty());
+}
+
 void SimTest::getRuntimePerfStats() {
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -979,6 +2101,41 @@ void SimTest::getRuntimePerfStats() {
   CORRADE_COMPARE(statValues[drawFacesIdx], 0);
 }
 
+void SimTest::getMemoryReport() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  const esp::sim::MemoryReport report = simulator->getMemoryReport();
+  CORRADE_VERIFY(report.meshes.cpuBytes > 0);
+  CORRADE_VERIFY(report.attributes.cpuBytes > 0);
+  CORRADE_COMPARE(report.replayKeyframes.cpuBytes, 0);
+
+  const esp::core::MemoryUsage total = report.total();
+  CORRADE_COMPARE(total.cpuBytes,
+                  report.meshes.cpuBytes + report.textures.cpuBytes +
+                      report.collisionMeshes.cpuBytes +
+                      report.navMesh.cpuBytes +
+                      report.semanticScene.cpuBytes +
+                      report.replayKeyframes.cpuBytes +
+                      report.attributes.cpuBytes);
+  CORRADE_COMPARE(total.gpuBytes,
+                  report.meshes.gpuBytes + report.textures.gpuBytes +
+                      report.collisionMeshes.gpuBytes +
+                      report.navMesh.gpuBytes +
+                      report.semanticScene.gpuBytes +
+                      report.replayKeyframes.gpuBytes +
+                      report.attributes.gpuBytes);
+
+  // adding an object loads its render mesh
+  auto objAttrMgr = simulator->getObjectAttributesManager();
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  auto objs = objAttrMgr->getObjectHandlesBySubstring("nested_box");
+  CORRADE_VERIFY(rigidObjMgr->addObjectByHandle(objs[0]));
+  CORRADE_VERIFY(simulator->getMemoryReport().meshes.cpuBytes >=
+                 report.meshes.cpuBytes);
+}
+
 void SimTest::testArticulatedObjectSkinned() {
   ESP_DEBUG() << "Starting Test : testArticulatedObjectSkinned";
 
@@ -1038,6 +2195,281 @@ void SimTest::testArticulatedObjectSkinned() {
 
 }  // SimTest::testArticulatedObjectSkinned
 
+void SimTest::testArticulatedObjectBatchedJointState() {
+  ESP_DEBUG() << "Starting Test : testArticulatedObjectBatchedJointState";
+
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, "NONE", true, esp::NO_LIGHT_KEY);
+
+  const std::string urdfFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "urdf/prim_chain.urdf");
+
+  auto aoManager = simulator->getArticulatedObjectManager();
+
+  // the chain has two revolute joints, so two positions and two DoFs
+  std::vector<int> aoIds;
+  for (int i = 0; i < 3; ++i) {
+    auto ao = aoManager->addArticulatedObjectFromURDF(urdfFile);
+    CORRADE_VERIFY(ao);
+    CORRADE_COMPARE(ao->getJointPositions().size(), 2);
+    aoIds.push_back(ao->getID());
+  }
+
+  // write through a view that skips every third float, to verify the
+  // buffers don't need to be contiguous
+  float buffer[9]{0.1f, 0.2f, -1.0f, 0.3f, 0.4f, -1.0f, 0.5f, 0.6f, -1.0f};
+  const Cr::Containers::StridedArrayView2D<float> values{
+      Cr::Containers::arrayView(buffer), {3, 2}, {12, 4}};
+
+  aoManager->setJointPositions(aoIds, values);
+  for (std::size_t i = 0; i != aoIds.size(); ++i) {
+    auto ao = aoManager->getObjectCopyByID(aoIds[i]);
+    CORRADE_COMPARE_AS(ao->getJointPositions(),
+                       (std::vector<float>{values[i][0], values[i][1]}),
+                       Cr::TestSuite::Compare::Container);
+  }
+
+  // query in a different order than the objects were created in
+  const int reversedIds[]{aoIds[2], aoIds[1], aoIds[0]};
+  float queried[3][2];
+  const Cr::Containers::StridedArrayView2D<float> queriedView{
+      Cr::Containers::arrayView(&queried[0][0], 6), {3, 2}};
+  aoManager->getJointPositions(reversedIds, queriedView);
+  for (std::size_t i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(queried[i][0], values[2 - i][0]);
+    CORRADE_COMPARE(queried[i][1], values[2 - i][1]);
+  }
+
+  aoManager->setJointVelocities(aoIds, values);
+  aoManager->getJointVelocities(reversedIds, queriedView);
+  for (std::size_t i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(queried[i][0], values[2 - i][0]);
+    CORRADE_COMPARE(queried[i][1], values[2 - i][1]);
+  }
+
+  aoManager->setJointForces(aoIds, values);
+  aoManager->getJointForces(reversedIds, queriedView);
+  for (std::size_t i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(queried[i][0], values[2 - i][0]);
+    CORRADE_COMPARE(queried[i][1], values[2 - i][1]);
+  }
+
+  // the filler values in the strided buffer are untouched
+  CORRADE_COMPARE(buffer[2], -1.0f);
+  CORRADE_COMPARE(buffer[5], -1.0f);
+
+  aoManager->removeAllObjects();
+}  // SimTest::testArticulatedObjectBatchedJointState
+
+void SimTest::stepWorldsConcurrently() {
+  ESP_DEBUG() << "Starting Test : stepWorldsConcurrently";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  const auto objHandle = Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json");
+
+  // the last simulator is stepped on its own as a reference
+  std::vector<Simulator::uptr> simulators;
+  std::vector<Simulator*> concurrent;
+  std::vector<int> objIds;
+  for (int i = 0; i < 4; ++i) {
+    simulators.push_back(
+        data.creator(*this, planeStage, false, esp::NO_LIGHT_KEY));
+    auto obj = simulators.back()->getRigidObjectManager()->addObjectByHandle(
+        objHandle);
+    CORRADE_VERIFY(obj);
+    obj->setTranslation({0.0f, 2.0f, 0.0f});
+    objIds.push_back(obj->getID());
+    if (i != 3) {
+      concurrent.push_back(simulators.back().get());
+    }
+  }
+
+  esp::physics::MultiWorldStepper stepper{3};
+  CORRADE_COMPARE(stepper.numThreads(), 3);
+
+  std::vector<double> worldTimes;
+  for (int step = 0; step < 30; ++step) {
+    worldTimes = Simulator::stepWorlds(concurrent, stepper, 1.0 / 60.0);
+    simulators[3]->stepWorld(1.0 / 60.0);
+  }
+
+  // the worlds are independent and identical, so they have to end up in the
+  // same state as the one stepped serially
+  const double referenceTime = simulators[3]->getWorldTime();
+  CORRADE_VERIFY(referenceTime > 0.0);
+  const Mn::Vector3 reference = simulators[3]
+                                    ->getRigidObjectManager()
+                                    ->getObjectCopyByID(objIds[3])
+                                    ->getTranslation();
+  CORRADE_VERIFY(reference.y() < 2.0f);
+  CORRADE_COMPARE(worldTimes.size(), concurrent.size());
+  for (std::size_t i = 0; i != concurrent.size(); ++i) {
+    CORRADE_COMPARE(worldTimes[i], referenceTime);
+    CORRADE_COMPARE(concurrent[i]
+                        ->getRigidObjectManager()
+                        ->getObjectCopyByID(objIds[i])
+                        ->getTranslation(),
+                    reference);
+  }
+}  // SimTest::stepWorldsConcurrently
+
+void SimTest::restoreStateSnapshot() {
+  ESP_DEBUG() << "Starting Test : restoreStateSnapshot";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto simulator = data.creator(*this, planeStage, false, esp::NO_LIGHT_KEY);
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  const auto objHandle = Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json");
+  auto obj = rigidObjMgr->addObjectByHandle(objHandle);
+  CORRADE_VERIFY(obj);
+  obj->setTranslation({0.0f, 2.0f, 0.0f});
+  simulator->addAgent(AgentConfiguration{});
+  AgentState agentState;
+  agentState.position = {1.0f, 0.0f, 2.0f};
+  simulator->getAgent(0)->setState(agentState);
+
+  const esp::sim::SimulatorStateSnapshot snapshot =
+      simulator->captureStateSnapshot();
+  CORRADE_COMPARE(snapshot.physics.rigidObjects.size(), 1);
+  CORRADE_COMPARE(snapshot.agents.size(), 1);
+
+  // run an episode, moving things around and adding an object
+  for (int step = 0; step < 30; ++step) {
+    simulator->stepWorld(1.0 / 60.0);
+  }
+  simulator->getAgent(0)->act("moveForward");
+  CORRADE_VERIFY(obj->getTranslation().y() < 2.0f);
+  auto added = rigidObjMgr->addObjectByHandle(objHandle);
+  CORRADE_VERIFY(added);
+  const int addedId = added->getID();
+  CORRADE_COMPARE(rigidObjMgr->getNumObjects(), 2);
+
+  CORRADE_VERIFY(simulator->restoreStateSnapshot(snapshot));
+  CORRADE_COMPARE(simulator->getWorldTime(), snapshot.physics.worldTime);
+  // the original object is updated in place, the added one is gone
+  CORRADE_COMPARE(rigidObjMgr->getNumObjects(), 1);
+  CORRADE_VERIFY(!rigidObjMgr->getObjectCopyByID(addedId));
+  CORRADE_COMPARE(obj->getTranslation(), Mn::Vector3(0.0f, 2.0f, 0.0f));
+  CORRADE_COMPARE(obj->getLinearVelocity(), Mn::Vector3{});
+  auto restoredAgentState = AgentState::create();
+  simulator->getAgent(0)->getState(restoredAgentState);
+  CORRADE_COMPARE(Mn::Vector3{restoredAgentState->position},
+                  Mn::Vector3(1.0f, 0.0f, 2.0f));
+
+  // stepping again reproduces the episode
+  for (int step = 0; step < 30; ++step) {
+    simulator->stepWorld(1.0 / 60.0);
+  }
+  CORRADE_VERIFY(obj->getTranslation().y() < 2.0f);
+}  // SimTest::restoreStateSnapshot
+
+void SimTest::physicsStateRollouts() {
+  ESP_DEBUG() << "Starting Test : physicsStateRollouts";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto simulator = data.creator(*this, planeStage, false, esp::NO_LIGHT_KEY);
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  auto obj = rigidObjMgr->addObjectByHandle(Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json"));
+  CORRADE_VERIFY(obj);
+  obj->setTranslation({0.0f, 2.0f, 0.0f});
+
+  std::vector<char> state;
+  simulator->savePhysicsState(state);
+  CORRADE_VERIFY(!state.empty());
+
+  // every rollout from the saved state falls the same way
+  const double startTime = simulator->getWorldTime();
+  Mn::Vector3 firstRollout;
+  for (int rollout = 0; rollout < 3; ++rollout) {
+    CORRADE_ITERATION(rollout);
+    CORRADE_VERIFY(simulator->restorePhysicsState(
+        Cr::Containers::arrayView(state.data(), state.size())));
+    CORRADE_COMPARE(simulator->getWorldTime(), startTime);
+    for (int step = 0; step < 20; ++step) {
+      simulator->stepWorld(1.0 / 60.0);
+    }
+    if (rollout == 0) {
+      firstRollout = obj->getTranslation();
+      CORRADE_VERIFY(firstRollout.y() < 2.0f);
+    } else {
+      CORRADE_COMPARE(obj->getTranslation(), firstRollout);
+    }
+    // saving into a buffer of the right size keeps it
+    std::vector<char> branch = state;
+    const char* const branchData = branch.data();
+    simulator->savePhysicsState(branch);
+    CORRADE_COMPARE(branch.size(), state.size());
+    CORRADE_VERIFY(branch.data() == branchData);
+  }
+
+  // a world with other objects doesn't accept the state
+  CORRADE_VERIFY(rigidObjMgr->addObjectByHandle(Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json")));
+  CORRADE_VERIFY(!simulator->restorePhysicsState(
+      Cr::Containers::arrayView(state.data(), state.size())));
+}  // SimTest::physicsStateRollouts
+
+void SimTest::castRaysBatched() {
+  ESP_DEBUG() << "Starting Test : castRaysBatched";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, planeStage, false, esp::NO_LIGHT_KEY);
+
+  auto obj = simulator->getRigidObjectManager()->addObjectByHandle("cubeSolid");
+  CORRADE_VERIFY(obj);
+  obj->setTranslation({0.0f, 1.0f, 0.0f});
+  simulator->performDiscreteCollisionDetection();
+
+  // a grid of rays down onto the cube and the plane around it, plus one
+  // pointing away from everything and a degenerate one
+  std::vector<esp::geo::Ray> rays;
+  for (int x = -4; x <= 4; ++x) {
+    for (int z = -4; z <= 4; ++z) {
+      rays.emplace_back(Mn::Vector3{x * 0.1f, 5.0f, z * 0.1f},
+                        Mn::Vector3{0.0f, -1.0f, 0.0f});
+    }
+  }
+  rays.emplace_back(Mn::Vector3{0.0f, 5.0f, 0.0f},
+                    Mn::Vector3{0.0f, 1.0f, 0.0f});
+  rays.emplace_back(Mn::Vector3{0.0f, 5.0f, 0.0f}, Mn::Vector3{});
+
+  std::vector<esp::physics::RayHitInfo> hits(rays.size());
+  simulator->castRays(rays, 100.0, hits, 4);
+
+  // every ray must report the closest hit castRay() finds
+  int cubeHits = 0;
+  for (std::size_t i = 0; i != rays.size() - 1; ++i) {
+    CORRADE_ITERATION(i);
+    const auto expected = simulator->castRay(rays[i], 100.0);
+    if (!expected.hasHits()) {
+      CORRADE_COMPARE(hits[i].objectId, esp::ID_UNDEFINED);
+      CORRADE_COMPARE_AS(hits[i].rayDistance, 0.0,
+                         Cr::TestSuite::Compare::Less);
+      continue;
+    }
+    CORRADE_COMPARE(hits[i].objectId, expected.hits[0].objectId);
+    CORRADE_COMPARE_WITH(hits[i].rayDistance, expected.hits[0].rayDistance,
+                         Cr::TestSuite::Compare::around(1.0e-4));
+    CORRADE_COMPARE_AS((hits[i].point - expected.hits[0].point).length(),
+                       1.0e-4f, Cr::TestSuite::Compare::Less);
+    if (hits[i].objectId == obj->getID()) {
+      ++cubeHits;
+    }
+  }
+  CORRADE_VERIFY(cubeHits > 0);
+  CORRADE_COMPARE(hits[rays.size() - 2].objectId, esp::ID_UNDEFINED);
+  CORRADE_COMPARE(hits.back().objectId, esp::ID_UNDEFINED);
+  CORRADE_COMPARE_AS(hits.back().rayDistance, 0.0,
+                     Cr::TestSuite::Compare::Less);
+}  // SimTest::castRaysBatched
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SimTest)
@@ -2,9 +2,18 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <chrono>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/String.h>
 
 #include "SceneLoader.h"
 
@@ -13,9 +22,40 @@
 
 #include "Mp3dInstanceMeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/core/ParallelFor.h"
+#include "esp/core/configure.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/scene/SemanticScene.h"
 
+#ifdef ESP_BUILD_WITH_BULLET
+#include <Corrade/Utility/Path.h>
+
+#include "esp/assets/ResourceManager.h"
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/physics/bullet/BulletConvexHullCache.h"
+#include "esp/sensor/CameraSensor.h"
+#include "esp/sim/Simulator.h"
+#endif
+
+#ifdef ESP_BUILD_BASIS_COMPRESSOR
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/PluginManager/PluginMetadata.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+
+#include "esp/assets/ResourceManager.h"
+#endif
+
 using esp::assets::AssetInfo;
 using esp::assets::MeshData;
 using esp::assets::Mp3dInstanceMeshData;
@@ -24,8 +64,9 @@ using esp::nav::NavMeshSettings;
 using esp::nav::PathFinder;
 using esp::scene::SemanticScene;
 
-int createNavMesh(const std::string& meshFile, const std::string& navmeshFile) {
-  SceneLoader loader;
+int createNavMesh(SceneLoader& loader,
+                  const std::string& meshFile,
+                  const std::string& navmeshFile) {
   const AssetInfo info = AssetInfo::fromPath(meshFile);
   const MeshData mesh = loader.load(info);
   NavMeshSettings bs;
@@ -154,32 +195,451 @@ int createMp3dSemanticMesh(const std::string& plyFile,
   return 0;
 }
 
-int main(int argc, char** argv) {
-  if (argc < 4) {
+#ifdef ESP_BUILD_WITH_BULLET
+int createConvexHullCache(const std::string& assetFile,
+                          const std::string& cacheFile) {
+  esp::sim::SimulatorConfiguration cfg;
+  cfg.createRenderer = false;
+  auto metadataMediator = esp::metadata::MetadataMediator::create(cfg);
+  esp::assets::ResourceManager resourceManager{metadataMediator};
+  resourceManager.setRequiresTextures(false);
+
+  // load the collision meshes the same way as when instancing an object
+  auto objectAttributes =
+      metadataMediator->getObjectAttributesManager()->createObject(assetFile,
+                                                                   false);
+  if (!objectAttributes ||
+      objectAttributes->getCollisionAssetIsPrimitive() ||
+      !resourceManager.instantiateAssetsOnDemand(objectAttributes)) {
+    ESP_ERROR() << "Failed to load collision meshes of" << assetFile;
+    return 1;
+  }
+  const std::string collisionAssetHandle =
+      objectAttributes->getCollisionAssetHandle();
+
+  esp::physics::ConvexHullCacheData data = esp::physics::computeConvexHulls(
+      resourceManager.getCollisionMesh(collisionAssetHandle),
+      resourceManager.getMeshMetaData(collisionAssetHandle).root);
+  data.sourceHash =
+      *esp::physics::convexHullCacheSourceHash(collisionAssetHandle);
+  if (!esp::physics::writeConvexHullCache(cacheFile, data)) {
+    ESP_ERROR() << "Failed to save convex hull cache" << cacheFile;
+    return 2;
+  }
+
+  if (cacheFile !=
+      esp::physics::convexHullCacheFilename(collisionAssetHandle)) {
+    ESP_WARNING() << "The cache will be used at runtime only if saved as"
+                  << esp::physics::convexHullCacheFilename(
+                         collisionAssetHandle);
+  }
+  return 0;
+}
+#endif
+
+#ifdef ESP_BUILD_BASIS_COMPRESSOR
+int precookAsset(const std::string& assetFile, const std::string& outputFile) {
+  namespace Cr = Corrade;
+  namespace Mn = Magnum;
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      importerManager.loadAndInstantiate("AnySceneImporter");
+  if (!importer || !importer->openFile(assetFile)) {
+    ESP_ERROR() << "Failed to open" << assetFile;
+    return 1;
+  }
+
+  // Generate full mip chains, and keep the images Y up so they can be
+  // transcoded at load time to formats that can't be Y-flipped, such as BC7
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter>
+      imageConverterManager;
+  Cr::PluginManager::PluginMetadata* const basisMetadata =
+      imageConverterManager.metadata("BasisImageConverter");
+  if (!basisMetadata) {
+    ESP_ERROR() << "BasisImageConverter plugin not found";
+    return 1;
+  }
+  basisMetadata->configuration().setValue("mip_gen", true);
+  basisMetadata->configuration().setValue("y_flip", false);
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractSceneConverter>
+      converterManager;
+  converterManager.registerExternalManager(imageConverterManager);
+  Cr::Containers::Pointer<Mn::Trade::AbstractSceneConverter> converter =
+      converterManager.loadAndInstantiate("GltfSceneConverter");
+  if (!converter) {
+    ESP_ERROR() << "GltfSceneConverter plugin not found";
+    return 1;
+  }
+  converter->configuration().setValue("imageConverter",
+                                      "BasisKtxImageConverter");
+  converter->configuration().setValue("bundleImages", true);
+  if (!converter->beginFile(outputFile)) {
+    ESP_ERROR() << "Failed to start writing" << outputFile;
+    return 2;
+  }
+
+  // Images, textures, materials and meshes are added in their original order
+  // so references between them and from the scenes stay valid
+  for (Mn::UnsignedInt i = 0; i != importer->image2DCount(); ++i) {
+    // only the base level, the converter generates the rest
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+        importer->image2D(i);
+    if (!image || image->isCompressed() ||
+        !converter->add(*image, importer->image2DName(i))) {
+      ESP_ERROR() << "Failed to convert image" << i
+                  << "(already GPU-compressed images aren't supported)";
+      return 2;
+    }
+  }
+  for (Mn::UnsignedInt i = 0; i != importer->textureCount(); ++i) {
+    Cr::Containers::Optional<Mn::Trade::TextureData> texture =
+        importer->texture(i);
+    if (!texture || !converter->add(*texture, importer->textureName(i))) {
+      ESP_ERROR() << "Failed to convert texture" << i;
+      return 2;
+    }
+  }
+  for (Mn::UnsignedInt i = 0; i != importer->materialCount(); ++i) {
+    Cr::Containers::Optional<Mn::Trade::MaterialData> material =
+        importer->material(i);
+    if (!material || !converter->add(*material, importer->materialName(i))) {
+      ESP_ERROR() << "Failed to convert material" << i;
+      return 2;
+    }
+  }
+  for (Mn::UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+    // the same layout GenericMeshData::setMeshData() produces, so loading
+    // doesn't need to copy the data again
+    Cr::Containers::Optional<Mn::Trade::MeshData> mesh = importer->mesh(i);
+    if (!mesh || !converter->add(Mn::MeshTools::interleave(*std::move(mesh)),
+                                 importer->meshName(i))) {
+      ESP_ERROR() << "Failed to convert mesh" << i;
+      return 2;
+    }
+  }
+  for (Mn::UnsignedLong i = 0; i != importer->objectCount(); ++i) {
+    converter->setObjectName(i, importer->objectName(i));
+  }
+  for (Mn::UnsignedInt i = 0; i != importer->sceneCount(); ++i) {
+    Cr::Containers::Optional<Mn::Trade::SceneData> scene = importer->scene(i);
+    if (!scene || !converter->add(*scene, importer->sceneName(i))) {
+      ESP_ERROR() << "Failed to convert scene" << i;
+      return 2;
+    }
+  }
+  if (importer->defaultScene() != -1) {
+    converter->setDefaultScene(importer->defaultScene());
+  }
+
+  if (!converter->endFile()) {
+    ESP_ERROR() << "Failed to save precooked asset" << outputFile;
+    return 2;
+  }
+  if (outputFile !=
+      esp::assets::ResourceManager::precookedAssetFilename(assetFile)) {
+    ESP_WARNING() << "The asset will be used at runtime only if saved as"
+                  << esp::assets::ResourceManager::precookedAssetFilename(
+                         assetFile);
+  }
+  return 0;
+}
+#endif
+
+// Runs the task args[0] with the rest of args as its files. Returns the exit
+// code of the task, 64 for wrong usage and -1 for an unrecognized task.
+int runTask(const std::vector<std::string>& args, SceneLoader& loader) {
+  if (args.size() < 3) {
     std::cout << "Usage: Datatool task input_file output_file" << std::endl;
     return 64;
   }
-  const std::string task = argv[1];
+  const std::string& task = args[0];
   if (task == "create_navmesh") {
-    createNavMesh(argv[2], argv[3]);
+    return createNavMesh(loader, args[1], args[2]);
   } else if (task == "create_mp3d_semantic_mesh") {
-    if (argc < 5) {
+    if (args.size() < 4) {
       std::cout << "Usage: Datatool create_mp3d_semantic_mesh input_ply "
                    "input_house output_mesh"
                 << std::endl;
       return 64;
     }
-    createMp3dSemanticMesh(argv[2], argv[3], argv[4]);
+    return createMp3dSemanticMesh(args[1], args[2], args[3]);
   } else if (task == "create_gibson_semantic_mesh") {
-    if (argc < 5) {
+    if (args.size() < 4) {
       std::cout << "Usage: Datatool create_gibson_semantic_mesh input_obj "
                    "input_ids output_mesh"
                 << std::endl;
       return 64;
     }
-    createGibsonSemanticMesh(argv[2], argv[3], argv[4]);
-  } else {
-    ESP_ERROR() << "Unrecognized task" << task;
+    return createGibsonSemanticMesh(args[1], args[2], args[3]);
+#ifdef ESP_BUILD_WITH_BULLET
+  } else if (task == "create_convex_hull_cache") {
+    return createConvexHullCache(args[1], args[2]);
+#endif
+#ifdef ESP_BUILD_BASIS_COMPRESSOR
+  } else if (task == "precook_asset") {
+    return precookAsset(args[1], args[2]);
+#endif
+  }
+  ESP_ERROR() << "Unrecognized task" << task;
+  return -1;
+}
+
+namespace {
+
+// Outcome of one task of a batch, see printTaskReports()
+struct TaskReport {
+  std::string command;
+  int result = 0;
+  double seconds = 0.0;
+};
+
+double secondsSince(const std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       begin)
+      .count();
+}
+
+// Prints the timing and exit code of each task, returns 1 if any failed
+int printTaskReports(const std::vector<TaskReport>& reports,
+                     const double seconds,
+                     const int threadCount) {
+  std::size_t failed = 0;
+  for (const TaskReport& report : reports) {
+    if (report.result != 0) {
+      ++failed;
+      std::cout << Corrade::Utility::format("FAILED ({}) {:.2f} s: {}",
+                                            report.result, report.seconds,
+                                            report.command)
+                << std::endl;
+    } else {
+      std::cout << Corrade::Utility::format("ok {:.2f} s: {}", report.seconds,
+                                            report.command)
+                << std::endl;
+    }
+  }
+  std::cout << Corrade::Utility::format(
+                   "{} of {} tasks failed, {:.2f} s total on {} threads",
+                   failed, reports.size(), seconds, threadCount)
+            << std::endl;
+  return failed ? 1 : 0;
+}
+
+}  // namespace
+
+// Runs the tasks listed in a manifest, one per line with the same arguments
+// as on the command line, e.g. `create_navmesh scene.glb scene.navmesh`.
+// Empty lines and lines starting with # are skipped. The tasks run on a pool
+// of worker threads, each reusing its importers across the tasks it runs.
+int runBatch(const std::string& manifestFile, const int numThreads) {
+  std::ifstream manifest(manifestFile);
+  if (!manifest) {
+    ESP_ERROR() << "Failed to open manifest" << manifestFile;
+    return 1;
+  }
+  std::vector<std::vector<std::string>> jobs;
+  std::vector<TaskReport> reports;
+  std::string line;
+  while (std::getline(manifest, line)) {
+    std::vector<std::string> args =
+        Corrade::Utility::String::splitWithoutEmptyParts(line);
+    if (!args.empty() && args[0][0] != '#') {
+      reports.push_back({Corrade::Utility::String::join(args, ' ')});
+      jobs.push_back(std::move(args));
+    }
+  }
+
+  const int workerCount = esp::core::resolveNumThreads(numThreads, jobs.size());
+  // plugin managers register into a global plugin registry, so they're
+  // created upfront instead of concurrently in the workers
+  std::vector<std::unique_ptr<SceneLoader>> loaders;
+  for (int i = 0; i != workerCount; ++i) {
+    loaders.push_back(std::make_unique<SceneLoader>());
+  }
+  const auto batchBegin = std::chrono::steady_clock::now();
+  esp::core::parallelFor(
+      jobs.size(), workerCount, [&](const std::size_t job, const int worker) {
+        const auto begin = std::chrono::steady_clock::now();
+        reports[job].result = runTask(jobs[job], *loaders[worker]);
+        reports[job].seconds = secondsSince(begin);
+      });
+  return printTaskReports(reports, secondsSince(batchBegin), workerCount);
+}
+
+#ifdef ESP_BUILD_WITH_BULLET
+// Loads a navmesh and saves it again, which adds the island section to files
+// saved before it existed. The tiles are written back unchanged.
+int persistNavMeshIslands(const std::string& navmeshFile) {
+  PathFinder pf;
+  if (!pf.loadNavMesh(navmeshFile)) {
+    ESP_ERROR() << "Failed to load navmesh" << navmeshFile;
+    return 1;
+  }
+  if (!pf.saveNavMesh(navmeshFile)) {
+    ESP_ERROR() << "Failed to save navmesh" << navmeshFile;
+    return 2;
+  }
+  return 0;
+}
+
+// Builds the caches a scene dataset otherwise fills on its first load, into
+// subdirectories of cacheDir. The asset caches don't depend on each other and
+// are built on numThreads threads first, then every scene is loaded and
+// rendered once on a single GL context, filling the metadata, semantic mesh,
+// optimized mesh, IBL map, shader program and, with physics enabled, stage
+// collision BVH caches. To use them, the workers have to set the same cache
+// directories and optimizeMeshes in their SimulatorConfiguration.
+int precomputeCaches(const std::string& datasetConfig,
+                     const std::string& cacheDir,
+                     const int numThreads) {
+  namespace Path = Corrade::Utility::Path;
+  esp::sim::SimulatorConfiguration cfg;
+  cfg.sceneDatasetConfigFile = datasetConfig;
+  cfg.optimizeMeshes = true;
+  cfg.enablePhysics = true;
+  cfg.metadataCacheDirectory = Path::join(cacheDir, "metadata");
+  cfg.semanticMeshCacheDirectory = Path::join(cacheDir, "semantic_meshes");
+  cfg.optimizedMeshCacheDirectory = Path::join(cacheDir, "optimized_meshes");
+  cfg.iblMapCacheDirectory = Path::join(cacheDir, "ibl_maps");
+  cfg.shaderProgramCacheDirectory = Path::join(cacheDir, "shader_programs");
+  cfg.collisionBvhCacheDirectory = Path::join(cacheDir, "collision_bvhs");
+  for (const std::string& directory :
+       {cfg.metadataCacheDirectory, cfg.semanticMeshCacheDirectory,
+        cfg.optimizedMeshCacheDirectory, cfg.iblMapCacheDirectory,
+        cfg.shaderProgramCacheDirectory, cfg.collisionBvhCacheDirectory}) {
+    if (!Path::make(directory)) {
+      ESP_ERROR() << "Failed to create cache directory" << directory;
+      return 1;
+    }
+  }
+
+  // loading the dataset writes its metadata snapshot
+  auto metadataMediator = esp::metadata::MetadataMediator::create(cfg);
+
+  std::vector<TaskReport> reports;
+  std::vector<std::function<int()>> jobs;
+  std::set<std::string> renderAssets;
+  for (const auto& entry : metadataMediator->getObjectAttributesManager()
+                               ->getObjectsByHandleSubstring()) {
+    const auto& attributes = entry.second;
+    const std::string collisionAsset = attributes->getCollisionAssetHandle();
+    if (!attributes->getCollisionAssetIsPrimitive() &&
+        !collisionAsset.empty()) {
+      reports.push_back({"create_convex_hull_cache " + entry.first});
+      jobs.emplace_back([file = entry.first, collisionAsset]() {
+        return createConvexHullCache(
+            file, esp::physics::convexHullCacheFilename(collisionAsset));
+      });
+    }
+    if (!attributes->getRenderAssetIsPrimitive() &&
+        !attributes->getRenderAssetHandle().empty()) {
+      renderAssets.insert(attributes->getRenderAssetHandle());
+    }
+  }
+  for (const auto& entry : metadataMediator->getStageAttributesManager()
+                               ->getObjectsByHandleSubstring()) {
+    if (!entry.second->getRenderAssetIsPrimitive() &&
+        !entry.second->getRenderAssetHandle().empty()) {
+      renderAssets.insert(entry.second->getRenderAssetHandle());
+    }
+  }
+#ifdef ESP_BUILD_BASIS_COMPRESSOR
+  for (const std::string& asset : renderAssets) {
+    const std::string precooked =
+        esp::assets::ResourceManager::precookedAssetFilename(asset);
+    if (!Path::exists(precooked)) {
+      reports.push_back({"precook_asset " + asset});
+      jobs.emplace_back(
+          [asset, precooked]() { return precookAsset(asset, precooked); });
+    }
+  }
+#endif
+  for (const auto& entry : metadataMediator->getActiveNavmeshMap()) {
+    reports.push_back({"persist_navmesh_islands " + entry.second});
+    jobs.emplace_back(
+        [file = entry.second]() { return persistNavMeshIslands(file); });
+  }
+
+  const int workerCount = esp::core::resolveNumThreads(numThreads, jobs.size());
+  const auto batchBegin = std::chrono::steady_clock::now();
+  esp::core::parallelFor(jobs.size(), workerCount,
+                         [&](const std::size_t job, int) {
+                           const auto begin = std::chrono::steady_clock::now();
+                           reports[job].result = jobs[job]();
+                           reports[job].seconds = secondsSince(begin);
+                         });
+
+  // the scenes are loaded after precooking, so the optimized meshes are
+  // cached for the precooked assets the workers are going to load
+  std::vector<std::string> scenes =
+      metadataMediator->getSceneInstanceAttributesManager()
+          ->getObjectHandlesBySubstring();
+  if (scenes.empty()) {
+    scenes = metadataMediator->getStageAttributesManager()
+                 ->getObjectHandlesBySubstring();
+  }
+  esp::agent::AgentConfiguration agentConfig;
+  {
+    auto cameraSpec = esp::sensor::CameraSensorSpec::create();
+    cameraSpec->sensorType = esp::sensor::SensorType::Color;
+    cameraSpec->uuid = "rgba";
+    agentConfig.sensorSpecifications = {cameraSpec};
+  }
+  std::unique_ptr<esp::sim::Simulator> simulator;
+  for (const std::string& scene : scenes) {
+    const auto begin = std::chrono::steady_clock::now();
+    cfg.activeSceneName = scene;
+    if (!simulator) {
+      simulator = std::make_unique<esp::sim::Simulator>(cfg, metadataMediator);
+    } else {
+      simulator->close(false);
+      simulator->reconfigure(cfg);
+    }
+    simulator->addAgent(agentConfig);
+    // drawing compiles the shaders the scene needs
+    const bool drawn = simulator->drawObservation(0, "rgba");
+    reports.push_back({"load_scene " + scene, drawn ? 0 : 1,
+                       secondsSince(begin)});
+  }
+
+  return printTaskReports(reports, secondsSince(batchBegin), workerCount);
+}
+#endif
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "Usage: Datatool task input_file output_file\n"
+                 "       Datatool batch manifest_file [num_threads]\n"
+                 "       Datatool precompute_caches dataset_config cache_dir "
+                 "[num_threads]"
+              << std::endl;
+    return 64;
+  }
+  const std::string task = argv[1];
+  if (task == "batch") {
+    return runBatch(argv[2], argc > 3 ? std::stoi(argv[3]) : 0);
+  }
+#ifdef ESP_BUILD_WITH_BULLET
+  if (task == "precompute_caches") {
+    if (argc < 4) {
+      std::cout << "Usage: Datatool precompute_caches dataset_config "
+                   "cache_dir [num_threads]"
+                << std::endl;
+      return 64;
+    }
+    return precomputeCaches(argv[2], argv[3],
+                            argc > 4 ? std::stoi(argv[4]) : 0);
+  }
+#endif
+
+  SceneLoader loader;
+  const int result =
+      runTask(std::vector<std::string>{argv + 1, argv + argc}, loader);
+  if (result == 64) {
+    return 64;
+  }
+  if (result == -1) {
     return 1;
   }
 
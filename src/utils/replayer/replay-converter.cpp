@@ -0,0 +1,95 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include "esp/gfx/replay/KeyframeBinary.h"
+#include "esp/io/Json.h"
+#include "esp/io/JsonAllTypes.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+using namespace Cr::Containers::Literals;
+
+int main(int argc, char** argv) {
+  Cr::Utility::Arguments args;
+  args.addArgument("input")
+      .setHelp("input", "gfx-replay file to convert")
+      .addArgument("output")
+      .setHelp("output", "converted output file")
+      .addBooleanOption("pretty")
+      .setHelp("pretty", "use pretty-printing when writing JSON")
+      .addOption("max-decimal-places", "-1")
+      .setHelp("max-decimal-places",
+               "precision of floats when writing JSON, -1 for full precision")
+      .setGlobalHelp(R"(
+Converts a gfx-replay file between the JSON and the binary keyframe format.
+The input format is detected from the file contents, the output is written in
+the other format.
+
+Binary files store rotations quantized to 16-bit integers, so converting JSON
+to binary and back may not reproduce the original file exactly.
+)"_s.trimmed())
+      .parse(argc, argv);
+
+  esp::logging::LoggingContext loggingContext;
+
+  const std::string input = args.value("input");
+  const std::string output = args.value("output");
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(input);
+  if (!data) {
+    Mn::Error{} << "Can't read" << input;
+    return 1;
+  }
+
+  if (esp::gfx::replay::isBinaryKeyframeData(*data)) {
+    const std::vector<esp::gfx::replay::Keyframe> keyframes =
+        esp::gfx::replay::readKeyframesFromBinary(*data);
+    if (keyframes.empty()) {
+      Mn::Error{} << "No keyframes found in" << input;
+      return 2;
+    }
+
+    rapidjson::Document d(rapidjson::kObjectType);
+    esp::io::addMember(d, "keyframes", keyframes, d.GetAllocator());
+    if (!esp::io::writeJsonToFile(d, output, args.isSet("pretty"),
+                                  args.value<int>("max-decimal-places"))) {
+      Mn::Error{} << "Can't write" << output;
+      return 3;
+    }
+
+    Mn::Debug{} << "Converted" << keyframes.size()
+                << "keyframes from binary to JSON";
+    return 0;
+  }
+
+  std::vector<esp::gfx::replay::Keyframe> keyframes;
+  try {
+    const auto d =
+        esp::io::parseJsonString(std::string{data->data(), data->size()});
+    esp::io::readMember(d, "keyframes", keyframes);
+  } catch (...) {
+    Mn::Error{} << "Can't parse" << input;
+    return 2;
+  }
+  if (keyframes.empty()) {
+    Mn::Error{} << "No keyframes found in" << input;
+    return 2;
+  }
+
+  if (!Cr::Utility::Path::write(
+          output, esp::gfx::replay::writeKeyframesToBinary(keyframes))) {
+    Mn::Error{} << "Can't write" << output;
+    return 3;
+  }
+
+  Mn::Debug{} << "Converted" << keyframes.size()
+              << "keyframes from JSON to binary";
+  return 0;
+}
@@ -1,12 +1,25 @@
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Json.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
+#include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
 #include <Magnum/Platform/GlfwApplication.h>
 
+#include <chrono>
+
+#include "esp/core/Profiler.h"
 #include "esp/sensor/CameraSensor.h"
 #include "esp/sim/BatchReplayRenderer.h"
 #include "esp/sim/ClassicReplayRenderer.h"
@@ -18,6 +31,34 @@ namespace Mn = Magnum;
 using namespace Cr::Containers::Literals;
 using namespace Mn::Math::Literals;
 
+/* Free video memory in kB as reported by the NVX_gpu_memory_info or
+   ATI_meminfo extensions, -1 if neither is supported */
+Mn::Long availableVideoMemory() {
+#ifndef MAGNUM_TARGET_GLES
+  bool nvx = false;
+  bool ati = false;
+  for (const auto& extension :
+       Mn::GL::Context::current().extensionStrings()) {
+    const Cr::Containers::StringView name{extension};
+    nvx = nvx || name == "GL_NVX_gpu_memory_info"_s;
+    ati = ati || name == "GL_ATI_meminfo"_s;
+  }
+  /* GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX */
+  if (nvx) {
+    GLint available{};
+    glGetIntegerv(0x9049, &available);
+    return available;
+  }
+  /* GL_TEXTURE_FREE_MEMORY_ATI, the first value is the total free memory */
+  if (ati) {
+    GLint available[4]{};
+    glGetIntegerv(0x87FC, available);
+    return available[0];
+  }
+#endif
+  return -1;
+}
+
 class Replayer : public Mn::Platform::Application {
  public:
   explicit Replayer(const Arguments& arguments);
@@ -25,6 +66,20 @@ class Replayer : public Mn::Platform::Application {
  private:
   void drawEvent() override;
   void mousePressEvent(MouseEvent& event) override;
+  void printRenderStageStatistics();
+
+  Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> createRenderer(
+      bool classic,
+      std::size_t environmentCount,
+      const Mn::Vector2i& sensorSize) const;
+  /* Sets the next keyframe and sensor transform of each environment, playing
+     the files in a round-robin fashion if there are more environments than
+     files */
+  void setEnvironmentKeyframes(esp::sim::AbstractReplayRenderer& renderer,
+                               std::size_t environmentCount,
+                               std::size_t frameIndex,
+                               bool repeat) const;
+  void runScalingSweep(const Cr::Utility::Arguments& args) const;
 
   esp::logging::LoggingContext loggingContext_;
 
@@ -37,12 +92,16 @@ class Replayer : public Mn::Platform::Application {
 
   Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> replayRenderer_;
 
+  Cr::Containers::Array<Cr::Containers::String> preloadFiles_;
+  Mn::UnsignedInt maxLightCount_ = 0;
+
   std::size_t maxFrameCount_ = 0;
   std::size_t frameIndex_ = 0;
   bool paused_ = false;
   bool once_ = false;
 
   Mn::DebugTools::FrameProfilerGL profiler_;
+  std::size_t profiledFrameCount_ = 0;
 };
 
 Replayer::Replayer(const Arguments& arguments)
@@ -65,6 +124,17 @@ Replayer::Replayer(const Arguments& arguments)
                "run through the replay just once instead of repeating forever, "
                "useful for benchmarking the renderer without the gfx-replay "
                "parsing overhead")
+      .addBooleanOption("sweep")
+      .setHelp("sweep",
+               "measure the batch and classic renderers over a range of "
+               "environment counts and sizes, print the results and exit")
+      .addOption("sweep-environment-counts", "1 4 16 64")
+      .setHelp("sweep-environment-counts", "environment counts to sweep over",
+               "\"N...\"")
+      .addOption("sweep-sizes", "128x96 256x192 512x384")
+      .setHelp("sweep-sizes", "environment sizes to sweep over", "\"XxY...\"")
+      .addOption("sweep-frames", "200")
+      .setHelp("sweep-frames", "frames to measure for each configuration")
       .addSkippedPrefix("magnum", "engine-specific options")
       .setGlobalHelp(R"(
 Plays back one or more gfx-replay JSON files, optionally using a set of
@@ -87,14 +157,29 @@ Default rendering is flat-shaded. Set --max-light-count to a value higher than
 materials marked as Flat will be rendered flat-shaded even with lights present.
 
 For simple profiling, the --profile option will print GPU, CPU and total frame
-time to the console. It includes the JSON parsing overhead as well, to
-benchmark just the renderer itself use --once and wait until all animations
-settle down.
+time to the console, together with GPU durations of the individual render
+stages where the GL context supports timer queries. It includes the JSON
+parsing overhead as well, to benchmark just the renderer itself use --once and
+wait until all animations settle down.
+
+To pick batch sizes for a particular GPU, --sweep renders offscreen with the
+batch and the classic renderer for every combination of
+--sweep-environment-counts and --sweep-sizes, playing the JSON files
+round-robin if there are more environments than files. For each it prints a CSV
+row with the frames per second, the mean GPU frame time and the video memory
+taken by the renderer, the last only if the driver exposes
+NVX_gpu_memory_info or ATI_meminfo. The memory is the drop in free video
+memory, so other applications using the GPU at the same time skew it.
 )"_s.trimmed())
       .parse(arguments.argc, arguments.argv);
 
   once_ = args.isSet("once");
   const std::size_t fileCount = args.arrayValueCount("json");
+  maxLightCount_ = args.value<Mn::UnsignedInt>("max-light-count");
+  for (std::size_t i = 0, iMax = args.arrayValueCount("preload"); i != iMax;
+       ++i)
+    arrayAppend(preloadFiles_, Cr::Containers::String{args.arrayValue<
+                                   Cr::Containers::StringView>("preload", i)});
 
   create(Configuration{}
              .setSize(args.value<Mn::Vector2i>("size") *
@@ -136,6 +221,12 @@ settle down.
         maxFrameCount_, fileKeyframeOffsets_[i + 1] - fileKeyframeOffsets_[i]);
   }
 
+  if (args.isSet("sweep")) {
+    runScalingSweep(args);
+    exit();
+    return;
+  }
+
   Mn::Debug{} << "Playing" << maxFrameCount_ << "frames from" << fileCount
               << "files";
   /* If we're repeating forever there's no max frame count after which the
@@ -143,54 +234,203 @@ settle down.
   if (!once_)
     maxFrameCount_ = ~std::size_t{};
 
-  std::string sensorName = "my_rgb";
-  std::string userPrefix = "sensor_";
-
-  std::vector<esp::sensor::SensorSpec::ptr> sensorSpecifications;
-  {
-    auto pinholeCameraSpec = esp::sensor::CameraSensorSpec::create();
-    pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
-    pinholeCameraSpec->sensorType = esp::sensor::SensorType::Color;
-    pinholeCameraSpec->position = {0.0f, 0.f, 0.0f};
-    /* Account for DPI scaling, i.e. take the actual framebuffer resolution
-       divided by the environment grid size instead of the resolution specified
-       in the arguments */
-    pinholeCameraSpec->resolution = {
-        (framebufferSize() /
-         esp::sim::AbstractReplayRenderer::environmentGridSize(fileCount))
-            .flipped()};
-    pinholeCameraSpec->uuid = sensorName;
-    sensorSpecifications = {pinholeCameraSpec};
+  /* Account for DPI scaling, i.e. take the actual framebuffer resolution
+     divided by the environment grid size instead of the resolution specified
+     in the arguments */
+  replayRenderer_ = createRenderer(
+      args.isSet("classic"), fileCount,
+      framebufferSize() /
+          esp::sim::AbstractReplayRenderer::environmentGridSize(fileCount));
+
+  profiler_ = Mn::DebugTools::FrameProfilerGL{
+      Mn::DebugTools::FrameProfilerGL::Value::FrameTime |
+          Mn::DebugTools::FrameProfilerGL::Value::CpuDuration |
+          Mn::DebugTools::FrameProfilerGL::Value::GpuDuration,
+      50};
+  if (args.isSet("profile")) {
+    esp::core::Profiler& stageProfiler = esp::core::Profiler::global();
+    stageProfiler.setEnabled(true);
+    stageProfiler.setGpuTimersEnabled(true);
+  } else {
+    profiler_.disable();
   }
+}
+
+Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>
+Replayer::createRenderer(const bool classic,
+                         const std::size_t environmentCount,
+                         const Mn::Vector2i& sensorSize) const {
+  // We're going to be lazy and only set up one sensor per env.
+  auto pinholeCameraSpec = esp::sensor::CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = esp::sensor::SensorType::Color;
+  pinholeCameraSpec->position = {0.0f, 0.f, 0.0f};
+  pinholeCameraSpec->resolution = {sensorSize.flipped()};
+  pinholeCameraSpec->uuid = "my_rgb";
 
   esp::sim::ReplayRendererConfiguration rendererConfig;
-  rendererConfig.sensorSpecifications = std::move(sensorSpecifications);
-  rendererConfig.numEnvironments = fileCount;
+  rendererConfig.sensorSpecifications = {pinholeCameraSpec};
+  rendererConfig.numEnvironments = environmentCount;
   rendererConfig.standalone = false;
   esp::gfx_batch::RendererConfiguration batchRendererConfig;
-  batchRendererConfig.setMaxLightCount(
-      args.value<Mn::UnsignedInt>("max-light-count"));
-  if (args.isSet("classic"))
-    replayRenderer_.emplace<esp::sim::ClassicReplayRenderer>(rendererConfig);
+  batchRendererConfig.setMaxLightCount(maxLightCount_);
+
+  Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> renderer;
+  if (classic)
+    renderer.emplace<esp::sim::ClassicReplayRenderer>(rendererConfig);
   else
-    replayRenderer_.emplace<esp::sim::BatchReplayRenderer>(
+    renderer.emplace<esp::sim::BatchReplayRenderer>(
         rendererConfig, std::move(batchRendererConfig));
 
-  for (std::size_t i = 0, iMax = args.arrayValueCount("preload"); i != iMax;
-       ++i)
-    replayRenderer_->preloadFile(args.arrayValue("preload", i));
+  for (const Cr::Containers::String& file : preloadFiles_)
+    renderer->preloadFile(file);
+  return renderer;
+}
 
-  // We're going to be lazy and only set up one buffer/imageView per env, on the
-  // assumption that there's only one sensor.
-  CORRADE_INTERNAL_ASSERT(rendererConfig.sensorSpecifications.size() == 1);
+void Replayer::setEnvironmentKeyframes(
+    esp::sim::AbstractReplayRenderer& renderer,
+    const std::size_t environmentCount,
+    const std::size_t frameIndex,
+    const bool repeat) const {
+  for (std::size_t envIndex = 0; envIndex < environmentCount; ++envIndex) {
+    const std::size_t fileIndex = envIndex % jsonFiles_.size();
+    const Cr::Containers::ArrayView<const Cr::Containers::StringView>
+        keyframesForEnvironment =
+            keyframes_.slice(fileKeyframeOffsets_[fileIndex],
+                             fileKeyframeOffsets_[fileIndex + 1]);
+    /* Beware, we can't set arbitrary keyframes, as they are usually
+       generated. We must set them exactly in order, or clear and start
+       over. */
+    const std::size_t environmentFrameIndex =
+        repeat ? frameIndex % keyframesForEnvironment.size() : frameIndex;
+    if (frameIndex != 0 && environmentFrameIndex == 0)
+      renderer.clearEnvironment(envIndex);
+    if (environmentFrameIndex < keyframesForEnvironment.size()) {
+      renderer.setEnvironmentKeyframeUnwrapped(
+          envIndex, keyframesForEnvironment[environmentFrameIndex]);
+    }
 
-  profiler_ = Mn::DebugTools::FrameProfilerGL{
-      Mn::DebugTools::FrameProfilerGL::Value::FrameTime |
-          Mn::DebugTools::FrameProfilerGL::Value::CpuDuration |
-          Mn::DebugTools::FrameProfilerGL::Value::GpuDuration,
-      50};
-  if (!args.isSet("profile"))
-    profiler_.disable();
+    const auto eyePos = Mn::Vector3(-1.5f, 1.75f - (float)envIndex * 0.1f,
+                                    -0.5f + (float)envIndex * 0.5f);
+    Mn::Matrix4 transform = Mn::Matrix4::lookAt(
+        eyePos,
+        eyePos + Mn::Vector3(2.f - (float)environmentFrameIndex * 0.002f,
+                             -0.5f, 1.f),
+        {0.f, 1.f, 0.f});
+    renderer.setSensorTransform(envIndex, "my_rgb", transform);
+  }
+}
+
+void Replayer::runScalingSweep(const Cr::Utility::Arguments& args) const {
+  if (jsonFiles_.isEmpty())
+    Mn::Fatal{} << "At least one JSON file is needed for the sweep";
+
+  std::vector<std::size_t> environmentCounts;
+  for (const std::string& count : Cr::Utility::String::splitWithoutEmptyParts(
+           args.value("sweep-environment-counts")))
+    environmentCounts.push_back(std::stoul(count));
+  std::vector<Mn::Vector2i> sizes;
+  for (const std::string& size : Cr::Utility::String::splitWithoutEmptyParts(
+           args.value("sweep-sizes"))) {
+    const std::vector<std::string> xy = Cr::Utility::String::split(size, 'x');
+    if (xy.size() != 2)
+      Mn::Fatal{} << "Invalid sweep size" << size << Mn::Debug::nospace
+                  << ", expected XxY";
+    sizes.emplace_back(std::stoi(xy[0]), std::stoi(xy[1]));
+  }
+  const auto frameCount = args.value<std::size_t>("sweep-frames");
+  /* Frames rendered before measuring, to not include the initial asset
+     loading and shader compilation. The profiler reports GPU durations a few
+     frames late, so render those extra as well. */
+  constexpr std::size_t WarmupFrameCount = 10;
+  constexpr std::size_t GpuLatencyFrameCount = 4;
+
+  Mn::Debug{} << "Sweeping on" << Mn::GL::Context::current().rendererString();
+  Mn::Debug{} << "renderer,environments,size,fps,gpu_ms,vram_mb";
+  for (const bool classic : {false, true}) {
+    for (const std::size_t environmentCount : environmentCounts) {
+      for (const Mn::Vector2i& size : sizes) {
+        Mn::GL::Renderer::finish();
+        const Mn::Long availableBefore = availableVideoMemory();
+
+        Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> renderer =
+            createRenderer(classic, environmentCount, size);
+        const Mn::Vector2i framebufferSize =
+            size * esp::sim::AbstractReplayRenderer::environmentGridSize(
+                       environmentCount);
+        Mn::GL::Renderbuffer color;
+        Mn::GL::Renderbuffer depth;
+        color.setStorage(Mn::GL::RenderbufferFormat::RGBA8, framebufferSize);
+        depth.setStorage(Mn::GL::RenderbufferFormat::DepthComponent24,
+                         framebufferSize);
+        Mn::GL::Framebuffer framebuffer{{{}, framebufferSize}};
+        framebuffer
+            .attachRenderbuffer(Mn::GL::Framebuffer::ColorAttachment{0}, color)
+            .attachRenderbuffer(Mn::GL::Framebuffer::BufferAttachment::Depth,
+                                depth);
+
+        std::size_t frameIndex = 0;
+        const auto renderFrame = [&]() {
+          framebuffer.clear(Mn::GL::FramebufferClear::Color |
+                            Mn::GL::FramebufferClear::Depth);
+          setEnvironmentKeyframes(*renderer, environmentCount, frameIndex++,
+                                  true);
+          renderer->render(framebuffer);
+        };
+        for (std::size_t i = 0; i != WarmupFrameCount; ++i)
+          renderFrame();
+        Mn::GL::Renderer::finish();
+
+        Mn::DebugTools::FrameProfilerGL profiler{
+            Mn::DebugTools::FrameProfilerGL::Value::GpuDuration, frameCount};
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != frameCount + GpuLatencyFrameCount; ++i) {
+          profiler.beginFrame();
+          renderFrame();
+          profiler.endFrame();
+        }
+        Mn::GL::Renderer::finish();
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - begin;
+
+        const Mn::Long availableAfter = availableVideoMemory();
+        const double fps =
+            double(frameCount + GpuLatencyFrameCount) / elapsed.count();
+        const std::string gpuMs =
+            profiler.isMeasurementAvailable(
+                Mn::DebugTools::FrameProfilerGL::Value::GpuDuration)
+                ? Cr::Utility::format("{:.3f}",
+                                      profiler.gpuDurationMean() / 1.0e6)
+                : "n/a";
+        const std::string vramMb =
+            availableBefore >= 0 && availableAfter >= 0
+                ? Cr::Utility::format(
+                      "{:.1f}", double(availableBefore - availableAfter) /
+                                    1024.0)
+                : "n/a";
+        Mn::Debug{} << Cr::Utility::format(
+            "{},{},{}x{},{:.1f},{},{}", classic ? "classic" : "batch",
+            environmentCount, size.x(), size.y(), fps, gpuMs, vramMb);
+      }
+    }
+  }
+}
+
+void Replayer::printRenderStageStatistics() {
+  /* Same period as FrameProfilerGL::printStatistics(10) */
+  if (++profiledFrameCount_ % 10 != 0)
+    return;
+
+  const esp::core::Profiler& stageProfiler = esp::core::Profiler::global();
+  for (const char* section :
+       {"gpuDraw", "gpuHbao", "gpuCubeMapFace", "gpuReadback"}) {
+    const esp::core::ProfileSectionStats stats = stageProfiler.stats(section);
+    if (!stats.windowCount)
+      continue;
+    Mn::Debug{} << " " << section << "mean"
+                << Cr::Utility::format("{:.2f}", stats.meanMs) << "ms, p95"
+                << Cr::Utility::format("{:.2f}", stats.p95Ms) << "ms";
+  }
 }
 
 void Replayer::drawEvent() {
@@ -200,33 +440,8 @@ void Replayer::drawEvent() {
   profiler_.beginFrame();
 
   if (!paused_) {
-    for (std::size_t envIndex = 0; envIndex < jsonFiles_.size(); ++envIndex) {
-      const Cr::Containers::ArrayView<const Cr::Containers::StringView>
-          keyframesForEnvironment =
-              keyframes_.slice(fileKeyframeOffsets_[envIndex],
-                               fileKeyframeOffsets_[envIndex + 1]);
-      /* Beware, we can't set arbitrary keyframes, as they are usually
-         generated. We must set them exactly in order, or clear and start
-         over. */
-      const std::size_t environmentFrameIndex =
-          once_ ? frameIndex_ : frameIndex_ % keyframesForEnvironment.size();
-      if (frameIndex_ != 0 && environmentFrameIndex == 0)
-        replayRenderer_->clearEnvironment(envIndex);
-      if (environmentFrameIndex < keyframesForEnvironment.size()) {
-        replayRenderer_->setEnvironmentKeyframeUnwrapped(
-            envIndex, keyframesForEnvironment[environmentFrameIndex]);
-      }
-
-      const auto eyePos = Mn::Vector3(-1.5f, 1.75f - (float)envIndex * 0.1f,
-                                      -0.5f + (float)envIndex * 0.5f);
-      Mn::Matrix4 transform = Mn::Matrix4::lookAt(
-          eyePos,
-          eyePos + Mn::Vector3(2.f - (float)environmentFrameIndex * 0.002f,
-                               -0.5f, 1.f),
-          {0.f, 1.f, 0.f});
-      replayRenderer_->setSensorTransform(envIndex, "my_rgb", transform);
-    }
-
+    setEnvironmentKeyframes(*replayRenderer_, jsonFiles_.size(), frameIndex_,
+                            !once_);
     ++frameIndex_;
   }
 
@@ -234,6 +449,8 @@ void Replayer::drawEvent() {
 
   profiler_.endFrame();
   profiler_.printStatistics(10);
+  if (profiler_.isEnabled())
+    printRenderStageStatistics();
 
   /* Stop redrawing if we're playing just once once and we reached all frames.
      Also don't waste the CPU if we're paused and the profiler isn't
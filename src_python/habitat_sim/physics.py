@@ -15,7 +15,9 @@ from habitat_sim._ext.habitat_sim_bindings import (
     ManagedBulletRigidObject,
     ManagedRigidObject,
     MotionType,
+    MultiWorldStepper,
     PhysicsSimulationLibrary,
+    PhysicsStepProfile,
     RaycastResults,
     RayHitInfo,
     RigidConstraintSettings,
@@ -44,4 +46,6 @@ __all__ = [
     "JointMotorType",
     "RigidConstraintType",
     "RigidConstraintSettings",
+    "MultiWorldStepper",
+    "PhysicsStepProfile",
 ]
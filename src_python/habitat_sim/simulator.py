@@ -28,17 +28,33 @@ except ImportError:
 import habitat_sim.errors
 from habitat_sim.agent.agent import Agent, AgentConfiguration, AgentState
 from habitat_sim.bindings import cuda_enabled
+from habitat_sim.gfx import RenderTarget
 from habitat_sim.logging import LoggingContext, logger
 from habitat_sim.metadata import MetadataMediator
 from habitat_sim.nav import GreedyGeodesicFollower
 from habitat_sim.sensor import SensorSpec, SensorType
-from habitat_sim.sensors.noise_models import make_sensor_noise_model
+from habitat_sim.sensors.noise_models import (
+    NoSensorNoiseModel,
+    make_sensor_noise_model,
+)
 from habitat_sim.sim import SimulatorBackend, SimulatorConfiguration
 from habitat_sim.utils.common import quat_from_angle_axis
 
 # TODO maybe clean up types with TypeVars
 ObservationDict = Dict[str, Union[bool, np.ndarray, "Tensor"]]
 
+# numpy dtypes of the pixel formats visual observations are read as, see
+# VisualSensorSpec.observation_format
+_OBSERVATION_DTYPES = {
+    mn.PixelFormat.RGBA8_UNORM: np.uint8,
+    mn.PixelFormat.RGB8_UNORM: np.uint8,
+    mn.PixelFormat.R32F: np.float32,
+    mn.PixelFormat.R16F: np.float16,
+    mn.PixelFormat.R16_UNORM: np.uint16,
+    mn.PixelFormat.R32UI: np.uint32,
+    mn.PixelFormat.R16UI: np.uint16,
+}
+
 
 @attr.s(auto_attribs=True, slots=True)
 class Configuration:
@@ -277,6 +293,22 @@ class Simulator(SimulatorBackend):
         agent._add_sensor(sensor_spec)
         self._update_simulator_sensors(sensor_spec.uuid, agent_id=agent_id)
 
+    def set_sensor_output_buffer(
+        self,
+        sensor_uuid: str,
+        buffer: Union[ndarray, "Tensor"],
+        agent_id: Optional[int] = None,
+    ) -> None:
+        r"""Read the observations of a sensor directly into a preallocated
+        buffer owned by the caller, see Sensor.set_output_buffer.
+
+        The buffer stays registered until the sensor is reinitialized, e.g. by
+        reconfigure.
+        """
+        if agent_id is None:
+            agent_id = self._default_agent_id
+        self.__sensors[agent_id][sensor_uuid].set_output_buffer(buffer)
+
     def get_agent(self, agent_id: int) -> Agent:
         return self.agents[agent_id]
 
@@ -317,6 +349,8 @@ class Simulator(SimulatorBackend):
             for sensor in agent_sensorsuite.values():
                 sensor._draw_observation_async()
 
+        # the scene can change as soon as its state is captured
+        self.renderer.snapshot_draw_jobs()
         self.renderer.start_draw_jobs()
         self.step_physics(dt)
 
@@ -339,6 +373,8 @@ class Simulator(SimulatorBackend):
             for sensor in agent_sensorsuite.values():
                 sensor._draw_observation_async()
 
+        # the scene can change as soon as its state is captured
+        self.renderer.snapshot_draw_jobs()
         self.renderer.start_draw_jobs()
 
     def get_sensor_observations_async_finish(
@@ -363,6 +399,9 @@ class Simulator(SimulatorBackend):
             return_single = False
 
         self.renderer.wait_draw_jobs()
+        for agent_id in agent_ids:
+            for sensor in self.__sensors[agent_id].values():
+                sensor._async_draw_job = None
         # As backport. All Dicts are ordered in Python >= 3.7
         observations: Dict[int, Dict[str, Union[ndarray, "Tensor"]]] = OrderedDict()
         for agent_id in agent_ids:
@@ -375,6 +414,24 @@ class Simulator(SimulatorBackend):
             return next(iter(observations.values()))
         return observations
 
+    def get_sensor_observation_async(
+        self, sensor_uuid: str, agent_id: int = 0
+    ) -> Union[ndarray, "Tensor"]:
+        r"""Wait for the observation of a single sensor of the async render
+        started by start_async_render_and_step_physics or start_async_render,
+        while the sensors after it are still being drawn and read back.
+
+        get_sensor_observations_async_finish still has to be called to end the
+        frame.
+        """
+        assert not self.config.enable_batch_renderer
+
+        if self._async_draw_agent_ids is None:
+            raise RuntimeError(
+                "get_sensor_observation_async was called before calling start_async_render_and_step_physics."
+            )
+        return self.__sensors[agent_id][sensor_uuid]._get_observation_async()
+
     @overload
     def get_sensor_observations(self, agent_ids: int = 0) -> ObservationDict:
         ...
@@ -397,12 +454,28 @@ class Simulator(SimulatorBackend):
         # As backport. All Dicts are ordered in Python >= 3.7.
         observations: Dict[int, ObservationDict] = OrderedDict()
 
+        # Sensors not due in their update_period schedule return the
+        # observation of their last update.
+        due: Dict[int, Dict[str, bool]] = {
+            agent_id: {
+                sensor_uuid: sensor._advance_update_schedule()
+                for sensor_uuid, sensor in self.__sensors[agent_id].items()
+            }
+            for agent_id in agent_ids
+        }
+
         # Draw observations (for classic non-batched renderer).
         if not self.config.enable_batch_renderer:
             for agent_id in agent_ids:
+                if self.config.sim_cfg.enable_shared_sensor_rendering:
+                    # Co-located camera sensors are drawn in a single pass.
+                    if any(due[agent_id].values()):
+                        super().draw_agent_observations(agent_id)
+                    continue
                 agent_sensorsuite = self.__sensors[agent_id]
-                for _sensor_uuid, sensor in agent_sensorsuite.items():
-                    sensor.draw_observation()
+                for sensor_uuid, sensor in agent_sensorsuite.items():
+                    if due[agent_id][sensor_uuid]:
+                        sensor.draw_observation()
         else:
             # The batch renderer draws observations from external code.
             # Sensors are only used as data containers.
@@ -412,7 +485,11 @@ class Simulator(SimulatorBackend):
         for agent_id in agent_ids:
             agent_observations: ObservationDict = {}
             for sensor_uuid, sensor in self.__sensors[agent_id].items():
-                agent_observations[sensor_uuid] = sensor.get_observation()
+                if due[agent_id][sensor_uuid]:
+                    sensor._last_observation = sensor.get_observation()
+                    sensor._last_downsampled = sensor._get_downsampled_observations()
+                agent_observations[sensor_uuid] = sensor._last_observation
+                agent_observations.update(sensor._last_downsampled)
             observations[agent_id] = agent_observations
 
         if return_single:
@@ -547,6 +624,18 @@ class Sensor:
         self._sensor_object = self._agent._sensors[sensor_id]
 
         self._spec = self._sensor_object.specification()
+        # Whether observations are read into a buffer owned by the caller.
+        self._has_output_buffer = False
+        # Index of the async draw job of the started frame, if any.
+        self._async_draw_job: Optional[int] = None
+        # Observation of the last update_period update, if any.
+        self._last_observation: Union[ndarray, "Tensor", None] = None
+        # Last observation read from the render target, before noise.
+        self._raw_observation: Union[ndarray, "Tensor", None] = None
+        # Downsampled observations of the last update, by uuid.
+        self._last_downsampled: Dict[str, ndarray] = {}
+        # Buffers the downsampled observations are read into, from level 1.
+        self._downsampled_buffers: List[ndarray] = []
 
         # When using the batch renderer, no memory is allocated here.
         if not self._sim.config.enable_batch_renderer:
@@ -582,37 +671,28 @@ class Sensor:
                     resolution[0], resolution[1], 4, dtype=torch.uint8, device=device
                 )
         else:
-            size = self._sensor_object.framebuffer_size
-            if self._spec.sensor_type == SensorType.SEMANTIC:
+            pixel_format = self._sensor_object.observation_pixel_format
+            dtype = _OBSERVATION_DTYPES[pixel_format]
+            if self._spec.sensor_type in (SensorType.SEMANTIC, SensorType.DEPTH):
                 self._buffer = np.empty(
                     (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.uint32,
-                )
-                self.view = mn.MutableImageView2D(
-                    mn.PixelFormat.R32UI, size, self._buffer
-                )
-            elif self._spec.sensor_type == SensorType.DEPTH:
-                self._buffer = np.empty(
-                    (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.float32,
-                )
-                self.view = mn.MutableImageView2D(
-                    mn.PixelFormat.R32F, size, self._buffer
+                    dtype=dtype,
                 )
             else:
+                channels = (
+                    3
+                    if pixel_format == mn.PixelFormat.RGB8_UNORM
+                    else self._spec.channels
+                )
                 self._buffer = np.empty(
                     (
                         self._spec.resolution[0],
                         self._spec.resolution[1],
-                        self._spec.channels,
+                        channels,
                     ),
-                    dtype=np.uint8,
-                )
-                self.view = mn.MutableImageView2D(
-                    mn.PixelFormat.RGBA8_UNORM,
-                    size,
-                    self._buffer.reshape(self._spec.resolution[0], -1),
+                    dtype=dtype,
                 )
+            self._create_view()
 
         noise_model_kwargs = self._spec.noise_model_kwargs
         self._noise_model = make_sensor_noise_model(
@@ -625,6 +705,75 @@ class Sensor:
             self._spec.noise_model, self._spec.uuid
         )
 
+    def _advance_update_schedule(self) -> bool:
+        r"""
+        Advance the update_period schedule by one step, return whether the
+        observation has to be updated in this step.
+        """
+        if self._last_observation is None:
+            self._sensor_object.reset_update_schedule()
+        return self._sensor_object.advance_update_schedule()
+
+    def _create_view(self) -> None:
+        r"""
+        Create the image view observations are read into from the CPU buffer.
+        """
+        size = self._sensor_object.framebuffer_size
+        # rows of the 16-bit and RGB formats aren't necessarily 4-byte aligned
+        storage = mn.PixelStorage()
+        storage.alignment = 1
+        self.view = mn.MutableImageView2D(
+            storage,
+            self._sensor_object.observation_pixel_format,
+            size,
+            self._buffer.reshape(self._spec.resolution[0], -1),
+        )
+
+    def set_output_buffer(self, buffer: Union[ndarray, "Tensor"]) -> None:
+        r"""
+        Read the observations of this sensor directly into ``buffer``, a
+        preallocated array owned by the caller, instead of one allocated by the
+        sensor, so that no copy is needed to hand them over.
+
+        ``buffer`` must be contiguous and have the shape and dtype of the
+        sensor's own buffer. It's a CUDA torch tensor on the simulator's GPU if
+        the sensor uses gpu2gpu_transfer, and a numpy array otherwise. The
+        rows land in it bottom to top, as OpenGL reads them. Without a noise
+        model, the observations returned by the simulator are then flipped
+        views of it rather than copies (a flipped tensor with
+        gpu2gpu_transfer), valid until the next observation is read.
+        """
+        assert not self._sim.config.enable_batch_renderer
+        assert self._spec.sensor_type != SensorType.AUDIO
+        if tuple(buffer.shape) != tuple(self._buffer.shape):
+            raise ValueError(
+                f"Output buffer of shape {tuple(buffer.shape)} given for a sensor with observations of shape {tuple(self._buffer.shape)}"
+            )
+        if buffer.dtype != self._buffer.dtype:
+            raise ValueError(
+                f"Output buffer of dtype {buffer.dtype} given for a sensor with observations of dtype {self._buffer.dtype}"
+            )
+        if self._spec.gpu2gpu_transfer:
+            if (
+                not buffer.is_cuda  # type: ignore[union-attr]
+                or buffer.device != self._buffer.device  # type: ignore[union-attr]
+                or not buffer.is_contiguous()  # type: ignore[union-attr]
+            ):
+                raise ValueError(
+                    "Output buffer must be a contiguous CUDA tensor on the simulator's GPU"
+                )
+            self._buffer = buffer
+        else:
+            flags = buffer.flags  # type: ignore[union-attr]
+            if not flags["C_CONTIGUOUS"] or not flags["WRITEABLE"]:
+                raise ValueError(
+                    "Output buffer must be a writeable, C-contiguous array"
+                )
+            self._buffer = buffer
+            self._create_view()
+        self._has_output_buffer = True
+        self._raw_observation = None
+
     def draw_observation(self) -> None:
         # Batch rendering happens elsewhere.
         assert not self._sim.config.enable_batch_renderer
@@ -703,7 +852,9 @@ class Sensor:
         if self._sim.frustum_culling:
             render_flags |= habitat_sim.gfx.Camera.Flags.FRUSTUM_CULLING
 
-        self._sim.renderer.enqueue_async_draw_job(
+        # drawn past the sensor, so the next draw can't be skipped
+        self._sensor_object.reset_observation_cache()
+        self._async_draw_job = self._sim.renderer.enqueue_async_draw_job(
             self._sensor_object, scene, self.view, render_flags
         )
 
@@ -716,9 +867,16 @@ class Sensor:
             return None
 
         assert self._sim.renderer is not None
-        tgt = self._sensor_object.render_target
+        tgt = self._sensor_object.observation_render_target
 
-        if self._spec.gpu2gpu_transfer:
+        if (
+            self._sensor_object.is_observation_unchanged
+            and self._raw_observation is not None
+        ):
+            # nothing the sensor sees changed since the last read, see
+            # SimulatorConfiguration.skip_unchanged_frames
+            obs = self._raw_observation
+        elif self._spec.gpu2gpu_transfer:
             with torch.cuda.device(self._buffer.device):  # type: ignore[attr-defined, union-attr]
                 if self._spec.sensor_type == SensorType.SEMANTIC:
                     tgt.read_frame_object_id_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
@@ -737,12 +895,60 @@ class Sensor:
                 tgt.read_frame_rgba(self.view)
 
             obs = np.flip(self._buffer, axis=0)
+        self._raw_observation = obs
 
+        if self._has_output_buffer and isinstance(
+            self._noise_model, NoSensorNoiseModel
+        ):
+            # The caller owns the buffer, no need to guard it with a copy.
+            return obs
         return self._noise_model(obs)
 
+    def _get_downsampled_observations(self) -> Dict[str, ndarray]:
+        r"""
+        Read the observations downsampled on the GPU, see
+        VisualSensorSpec.downsample_levels. No noise model is applied.
+        """
+        if (
+            self._spec.sensor_type == SensorType.AUDIO
+            or self._sim.config.enable_batch_renderer
+            or not self._spec.downsample_levels
+        ):
+            return {}
+
+        if self._spec.sensor_type == SensorType.SEMANTIC:
+            source = RenderTarget.ReadSource.OBJECT_ID
+        elif self._spec.sensor_type == SensorType.DEPTH:
+            source = RenderTarget.ReadSource.DEPTH
+        else:
+            source = RenderTarget.ReadSource.RGBA
+        pixel_format = self._sensor_object.observation_pixel_format
+        tgt = self._sensor_object.observation_render_target
+
+        storage = mn.PixelStorage()
+        storage.alignment = 1
+        observations: Dict[str, ndarray] = {}
+        for level in range(1, self._spec.downsample_levels + 1):
+            size = self._sensor_object.downsampled_framebuffer_size(level)
+            if len(self._downsampled_buffers) < level:
+                shape = (size[1], size[0]) + self._buffer.shape[2:]
+                self._downsampled_buffers.append(
+                    np.empty(shape, dtype=_OBSERVATION_DTYPES[pixel_format])
+                )
+            buffer = self._downsampled_buffers[level - 1]
+            view = mn.MutableImageView2D(
+                storage, pixel_format, size, buffer.reshape(size[1], -1)
+            )
+            tgt.read_frame_downsampled(source, level, view)
+            observations[self._spec.downsampled_uuid(level)] = np.flip(buffer, axis=0)
+        return observations
+
     def _get_observation_async(self) -> Union[ndarray, "Tensor"]:
         if self._spec.sensor_type == SensorType.AUDIO:
             return self._get_audio_observation()
+        if self._async_draw_job is not None:
+            # The other sensors of the frame may still be drawn.
+            self._sim.renderer.wait_draw_job(self._async_draw_job)
         if self._spec.gpu2gpu_transfer:
             obs = self._buffer.flip(0)  # type: ignore[union-attr]
         else:
@@ -763,6 +969,8 @@ class Sensor:
 
         # run the simulation
         audio_sensor.runSimulation(self._sim)
+        if self._spec.inMemoryIR:
+            return audio_sensor.getIRArray()
         obs = audio_sensor.getIR()
         return obs
 
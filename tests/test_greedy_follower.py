@@ -188,3 +188,69 @@ def test_greedy_follower(test_navmesh, move_filter_fn, action_noise, pbar):
 
     if not test_all:
         assert test_spl / NUM_TESTS >= ACCEPTABLE_SPLS[(move_filter_fn, action_noise)]
+
+
+@pytest.mark.parametrize("test_navmesh", test_navmeshes)
+@pytest.mark.parametrize("move_filter_fn", ["try_step", "try_step_no_sliding"])
+def test_greedy_follower_goal_field(test_navmesh, move_filter_fn):
+    if not osp.exists(test_navmesh):
+        pytest.skip(f"{test_navmesh} not found")
+
+    pathfinder = habitat_sim.PathFinder()
+    pathfinder.load_nav_mesh(test_navmesh)
+    assert pathfinder.is_loaded
+    pathfinder.seed(0)
+
+    scene_graph = habitat_sim.SceneGraph()
+    agent = habitat_sim.Agent(scene_graph.get_root_node().create_child())
+    agent.controls.move_filter_fn = getattr(pathfinder, move_filter_fn)
+    agent.agent_config.action_space["turn_left"].actuation.amount = TURN_DEGREE
+    agent.agent_config.action_space["turn_right"].actuation.amount = TURN_DEGREE
+
+    follower = habitat_sim.GreedyGeodesicFollower(
+        pathfinder,
+        agent,
+        forward_key="move_forward",
+        left_key="turn_left",
+        right_key="turn_right",
+    )
+
+    test_spl = 0.0
+    for _ in range(NUM_TESTS):
+        state = habitat_sim.AgentState()
+        while True:
+            state.position = pathfinder.get_random_navigable_point()
+            goal_pos = pathfinder.get_random_navigable_point()
+            path = habitat_sim.ShortestPath()
+            path.requested_start = state.position
+            path.requested_end = goal_pos
+
+            if pathfinder.find_path(path) and path.geodesic_distance > 2.0:
+                break
+
+        agent.state = state
+        gt_geo = path.geodesic_distance
+        try:
+            action_list = follower.find_path_with_goal_field(
+                goal_pos, allow_sliding=move_filter_fn == "try_step"
+            )
+        except habitat_sim.errors.GreedyFollowerError:
+            action_list = [None]
+
+        # the planned actions have to hold up when actually simulated
+        agent_distance = 0.0
+        last_xyz = state.position
+        for next_action in action_list:
+            if next_action is None:
+                break
+            agent.act(next_action)
+            agent_distance += float(np.linalg.norm(last_xyz - agent.state.position))
+            last_xyz = agent.state.position
+
+        path.requested_start = agent.state.position
+        pathfinder.find_path(path)
+
+        failed = path.geodesic_distance > follower.forward_spec.amount
+        test_spl += float(not failed) * gt_geo / max(gt_geo, agent_distance)
+
+    assert test_spl / NUM_TESTS >= ACCEPTABLE_SPLS[(move_filter_fn, False)]
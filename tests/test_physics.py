@@ -763,6 +763,16 @@ def test_collision_groups():
             assert cube_obj1.contact_test()
             assert cube_obj2.contact_test()
 
+            # batched pose queries match contact_test and leave the pose alone
+            in_contact = sim.contact_test_object_poses(
+                cube_obj1.object_id,
+                np.array([[1.2, 0.0, 4.6], [1.2, 100.0, 4.6]]),
+                np.array([[0.0, 0.0, 0.0, 1.0], [0.0, 0.0, 0.0, 1.0]]),
+            )
+            assert in_contact.tolist() == [True, False]
+            assert cube_obj1.translation == mn.Vector3(1.2, 0.0, 4.6)
+            assert cube_obj1.contact_test()
+
             # NOTE: trying to set the object's MotionType to its current type won't change the collision group
             cube_obj2.motion_type = habitat_sim.physics.MotionType.DYNAMIC
             assert cube_obj1.contact_test()
@@ -1515,9 +1525,13 @@ def test_articulated_object_joint_motors(test_asset):
         # set zero position gains and non-zero velocity target
         new_vel_target = np.ones(len(robot.joint_velocities)) * 0.5
         robot.update_all_motor_targets(new_vel_target, velocities=True)
+        robot.set_joint_motor_targets(
+            max_impulses=np.full(len(robot.joint_velocities), 9000.0)
+        )
 
         for motor_id in robot.existing_joint_motor_ids:
             joint_motor_settings = robot.get_joint_motor_settings(motor_id)
+            assert joint_motor_settings.max_impulse == 9000.0
             # first check that velocity target update is reflected in settings
             if (
                 joint_motor_settings.motor_type
@@ -1693,9 +1707,16 @@ def test_rigid_constraints():
 
         assert cube_obj.translation[1] > -1.0
         assert cube_obj_2.translation[1] > -1.0
-        # remove the constraint
+        # disable the constraints, then remove them
+        constraint_settings.enabled = False
+        constraint_settings_2.enabled = False
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        sim.update_rigid_constraint(constraint_id_2, constraint_settings_2)
+        assert not sim.get_rigid_constraint_settings(constraint_id).enabled
         sim.remove_rigid_constraint(constraint_id)
         sim.remove_rigid_constraint(constraint_id_2)
+        constraint_settings.enabled = True
+        constraint_settings_2.enabled = True
         observations += simulate(sim, 2.0, produce_debug_video)
         # cubes should fall and separate
         assert cube_obj.translation[1] < -1.0
@@ -1995,6 +2016,182 @@ def test_rigid_constraints():
             )
 
 
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_rigid_constraint_disable():
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        obj_template_mgr = sim.get_object_template_manager()
+        art_obj_mgr = sim.get_articulated_object_manager()
+        rigid_obj_mgr = sim.get_rigid_object_manager()
+
+        # dangle a cube from its corner at the origin
+        cube_prim_handle = obj_template_mgr.get_template_handles("cubeSolid")[0]
+        cube_obj = rigid_obj_mgr.add_object_by_template_handle(cube_prim_handle)
+        constraint_settings = habitat_sim.physics.RigidConstraintSettings()
+        constraint_settings.object_id_a = cube_obj.object_id
+        constraint_settings.pivot_a = cube_obj.collision_shape_aabb.front_top_left
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        assert constraint_id >= 0
+        simulate(sim, 1.0, False)
+        global_pivot_pos = cube_obj.root_scene_node.transformation.transform_point(
+            constraint_settings.pivot_a
+        )
+        assert np.allclose(global_pivot_pos, np.zeros(3), atol=1.0e-4)
+
+        # a disabled constraint no longer holds the cube
+        constraint_settings.enabled = False
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        assert not sim.get_rigid_constraint_settings(constraint_id).enabled
+        simulate(sim, 1.0, False)
+        assert cube_obj.translation[1] < -1.0
+        sim.remove_rigid_constraint(constraint_id)
+        rigid_obj_mgr.remove_object_by_id(cube_obj.object_id)
+
+        # hang a humanoid from the origin by its wrist
+        robot_file = "data/test_assets/urdf/amass_male.urdf"
+        robot = art_obj_mgr.add_articulated_object_from_urdf(
+            filepath=robot_file, fixed_base=False
+        )
+        assert robot.is_alive
+        joint_motor_settings = habitat_sim.physics.JointMotorSettings()
+        joint_motor_settings.position_gain = 0.5
+        robot.create_all_motors(joint_motor_settings)
+        constraint_settings = habitat_sim.physics.RigidConstraintSettings()
+        constraint_settings.object_id_a = robot.object_id
+        constraint_settings.link_id_a = 9  # lwrist
+        constraint_settings.max_impulse = 10000000
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        assert constraint_id >= 0
+        simulate(sim, 4.0, False)
+        global_connect_a = robot.get_link_scene_node(
+            constraint_settings.link_id_a
+        ).transformation.transform_point(constraint_settings.pivot_a)
+        assert np.allclose(global_connect_a, constraint_settings.pivot_b, atol=0.04)
+
+        # multibody constraints are disabled by taking them out of the world
+        assert robot.translation[1] > -2
+        constraint_settings.enabled = False
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        assert not sim.get_rigid_constraint_settings(constraint_id).enabled
+        simulate(sim, 1.0, False)
+        assert robot.translation[1] < -3
+        sim.remove_rigid_constraint(constraint_id)
+
+
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_rigid_constraint_reuse():
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        obj_template_mgr = sim.get_object_template_manager()
+        art_obj_mgr = sim.get_articulated_object_manager()
+        rigid_obj_mgr = sim.get_rigid_object_manager()
+
+        def pivot_distance(obj, link_id, settings):
+            if link_id is None:
+                node = obj.root_scene_node
+            else:
+                node = obj.get_link_scene_node(link_id)
+            global_pivot_pos = node.transformation.transform_point(settings.pivot_a)
+            return (global_pivot_pos - settings.pivot_b).length()
+
+        # dangle a cube from its corner at the origin
+        cube_prim_handle = obj_template_mgr.get_template_handles("cubeSolid")[0]
+        cube_obj = rigid_obj_mgr.add_object_by_template_handle(cube_prim_handle)
+        constraint_settings = habitat_sim.physics.RigidConstraintSettings()
+        constraint_settings.object_id_a = cube_obj.object_id
+        constraint_settings.pivot_a = cube_obj.collision_shape_aabb.front_top_left
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        simulate(sim, 1.0, False)
+        assert pivot_distance(cube_obj, None, constraint_settings) < 1.0e-4
+        hanging_translation = cube_obj.translation
+        hanging_rotation = cube_obj.rotation
+
+        # disable the constraint and let the cube fall, then put the cube back
+        # and enable the constraint again, it holds the cube as before
+        constraint_settings.enabled = False
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        simulate(sim, 1.0, False)
+        assert cube_obj.translation[1] < -1.0
+        cube_obj.translation = hanging_translation
+        cube_obj.rotation = hanging_rotation
+        cube_obj.linear_velocity = mn.Vector3()
+        cube_obj.angular_velocity = mn.Vector3()
+        constraint_settings.enabled = True
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        assert sim.get_rigid_constraint_settings(constraint_id).enabled
+        simulate(sim, 1.0, False)
+        assert pivot_distance(cube_obj, None, constraint_settings) < 1.0e-3
+        assert cube_obj.translation[1] > -1.0
+
+        # a constraint re-created between the same objects reuses the removed
+        # one from the pool, it has to use the new settings
+        sim.remove_rigid_constraint(constraint_id)
+        constraint_settings.pivot_b = mn.Vector3(0.0, -0.5, 0.0)
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        assert constraint_id >= 0
+        queried_settings = sim.get_rigid_constraint_settings(constraint_id)
+        assert queried_settings.pivot_b == constraint_settings.pivot_b
+        assert queried_settings.enabled
+        simulate(sim, 2.0, False)
+        assert pivot_distance(cube_obj, None, constraint_settings) < 1.0e-3
+
+        # a constraint disabled when it was removed is enabled when re-created
+        constraint_settings.enabled = False
+        sim.update_rigid_constraint(constraint_id, constraint_settings)
+        sim.remove_rigid_constraint(constraint_id)
+        constraint_settings.enabled = True
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        simulate(sim, 1.0, False)
+        assert pivot_distance(cube_obj, None, constraint_settings) < 1.0e-3
+        sim.remove_rigid_constraint(constraint_id)
+        rigid_obj_mgr.remove_object_by_id(cube_obj.object_id)
+
+        # the same for a multibody constraint hanging a humanoid by its wrist
+        robot_file = "data/test_assets/urdf/amass_male.urdf"
+        robot = art_obj_mgr.add_articulated_object_from_urdf(
+            filepath=robot_file, fixed_base=False
+        )
+        joint_motor_settings = habitat_sim.physics.JointMotorSettings()
+        joint_motor_settings.position_gain = 0.5
+        robot.create_all_motors(joint_motor_settings)
+        constraint_settings = habitat_sim.physics.RigidConstraintSettings()
+        constraint_settings.object_id_a = robot.object_id
+        constraint_settings.link_id_a = 9  # lwrist
+        constraint_settings.max_impulse = 10000000
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        simulate(sim, 4.0, False)
+        assert pivot_distance(robot, 9, constraint_settings) < 0.04
+
+        sim.remove_rigid_constraint(constraint_id)
+        constraint_settings.pivot_b = mn.Vector3(0.0, 0.5, 0.0)
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        assert constraint_id >= 0
+        simulate(sim, 4.0, False)
+        assert pivot_distance(robot, 9, constraint_settings) < 0.04
+
+        # a different pivot on the link can't reuse the pooled constraint
+        sim.remove_rigid_constraint(constraint_id)
+        constraint_settings.pivot_a = mn.Vector3(0.02, 0.0, 0.0)
+        constraint_id = sim.create_rigid_constraint(constraint_settings)
+        assert constraint_id >= 0
+        simulate(sim, 4.0, False)
+        assert pivot_distance(robot, 9, constraint_settings) < 0.04
+
+
 @pytest.mark.skipif(
     not osp.exists("data/scene_datasets/habitat-test-scenes/apartment_1.glb"),
     reason="Requires the habitat-test-scenes",
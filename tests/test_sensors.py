@@ -363,3 +363,25 @@ def test_rgba_noise(scene_and_dataset, model_name, make_cfg_settings):
         assert np.linalg.norm(
             obs["color_sensor"].astype(float) - gt.astype(float)
         ) > 1.5e-2 * np.linalg.norm(gt.astype(float)), "Incorrect color_sensor output"
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("sensor_type", all_base_sensor_types[:2])
+def test_sensor_output_buffer(sensor_type, make_cfg_settings):
+    scene = _non_semantic_scenes[1][0]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["scene"] = scene
+    with habitat_sim.Simulator(make_cfg(make_cfg_settings)) as sim:
+        expected = sim.get_sensor_observations()[sensor_type].copy()
+
+        # observations are read straight into the buffer owned by the caller
+        buffer = np.zeros_like(expected)
+        sim.set_sensor_output_buffer(sensor_type, buffer)
+        obs = sim.get_sensor_observations()[sensor_type]
+        assert np.shares_memory(obs, buffer)
+        assert np.array_equal(obs, expected)
+
+        with pytest.raises(ValueError):
+            sim.set_sensor_output_buffer(sensor_type, np.zeros_like(buffer[1:]))
@@ -5,6 +5,7 @@
 import math
 
 import hypothesis
+import numpy as np
 import pytest
 from hypothesis import strategies as st
 
@@ -40,3 +41,22 @@ def test_snap_point(nudge, test_data):
     hypothesis.assume(not math.isnan(proj_pt[0]))
 
     assert pf.is_navigable(proj_pt), "{} -> {} not navigable!".format(pt, proj_pt)
+
+
+def test_bulk_point_queries(test_data):
+    pf, start_pt = test_data
+
+    rng = np.random.default_rng(0)
+    offsets = rng.uniform([-10, -2.5, -10], [10, 2.5, 10], (1000, 3))
+    pts = (start_pt + offsets).astype(np.float32)
+
+    snapped = pf.snap_points(pts, num_threads=4)
+    navigable = pf.are_navigable(pts, num_threads=4)
+    islands = pf.get_islands(pts, num_threads=4)
+    assert snapped.shape == (1000, 3)
+    assert navigable.shape == islands.shape == (1000,)
+
+    for i, pt in enumerate(pts):
+        np.testing.assert_array_equal(snapped[i], pf.snap_point(pt))
+        assert navigable[i] == pf.is_navigable(pt)
+        assert islands[i] == pf.get_island(pt)